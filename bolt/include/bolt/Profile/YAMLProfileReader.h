@@ -9,8 +9,10 @@
 #ifndef BOLT_PROFILE_YAML_PROFILE_READER_H
 #define BOLT_PROFILE_YAML_PROFILE_READER_H
 
+#include "bolt/Core/MCPlusBuilder.h"
 #include "bolt/Profile/ProfileReaderBase.h"
 #include "bolt/Profile/ProfileYAMLMapping.h"
+#include <mutex>
 #include <unordered_set>
 
 namespace llvm {
@@ -69,13 +71,20 @@ private:
   /// BinaryFunction pointers indexed by YamlBP functions.
   std::vector<BinaryFunction *> ProfileBFs;
 
+  /// Protects the stale matching stats of BinaryContext, as the profiles of
+  /// functions are parsed in parallel.
+  std::mutex StatsMutex;
+
   /// Populate \p Function profile with the one supplied in YAML format.
+  /// Annotations are created with the allocator \p AllocId.
   bool parseFunctionProfile(BinaryFunction &Function,
-                            const yaml::bolt::BinaryFunctionProfile &YamlBF);
+                            const yaml::bolt::BinaryFunctionProfile &YamlBF,
+                            MCPlusBuilder::AllocatorIdTy AllocId);
 
   /// Infer function profile from stale data (collected on older binaries).
   bool inferStaleProfile(BinaryFunction &Function,
-                         const yaml::bolt::BinaryFunctionProfile &YamlBF);
+                         const yaml::bolt::BinaryFunctionProfile &YamlBF,
+                         MCPlusBuilder::AllocatorIdTy AllocId);
 
   /// Initialize maps for profile matching.
   void buildNameMaps(BinaryContext &BC);
@@ -8,6 +8,7 @@
 
 #include "bolt/Core/DebugNames.h"
 #include "bolt/Core/BinaryContext.h"
+#include "bolt/Core/ParallelUtilities.h"
 #include "llvm/DebugInfo/DWARF/DWARFExpression.h"
 #include "llvm/DebugInfo/DWARF/DWARFTypeUnit.h"
 #include "llvm/Support/EndianStream.h"
@@ -401,15 +402,30 @@ void DWARF5AcceleratorTable::finalize() {
 
   // Sort the contents of the buckets by hash value so that hash collisions end
   // up together. Stable sort makes testing easier and doesn't cost much more.
-  for (HashList &Bucket : Buckets) {
-    llvm::stable_sort(Bucket, [](const HashData *LHS, const HashData *RHS) {
-      return LHS->HashValue < RHS->HashValue;
-    });
-    for (HashData *H : Bucket)
-      llvm::stable_sort(H->Values, [](const BOLTDWARF5AccelTableData *LHS,
-                                      const BOLTDWARF5AccelTableData *RHS) {
-        return LHS->getDieOffset() < RHS->getDieOffset();
+  // Buckets are independent, so ranges of them are sorted in parallel.
+  auto sortBuckets = [&](size_t Begin, size_t End) {
+    for (size_t I = Begin; I < End; ++I) {
+      HashList &Bucket = Buckets[I];
+      llvm::stable_sort(Bucket, [](const HashData *LHS, const HashData *RHS) {
+        return LHS->HashValue < RHS->HashValue;
       });
+      for (HashData *H : Bucket)
+        llvm::stable_sort(H->Values, [](const BOLTDWARF5AccelTableData *LHS,
+                                        const BOLTDWARF5AccelTableData *RHS) {
+          return LHS->getDieOffset() < RHS->getDieOffset();
+        });
+    }
+  };
+  constexpr size_t BucketsPerTask = 4096;
+  if (opts::NoThreads || Buckets.size() <= BucketsPerTask) {
+    sortBuckets(0, Buckets.size());
+  } else {
+    // Only wait for these tasks, not for everything else in the shared pool.
+    ThreadPoolTaskGroup TaskGroup(ParallelUtilities::getThreadPool());
+    for (size_t I = 0; I < Buckets.size(); I += BucketsPerTask)
+      TaskGroup.async(sortBuckets, I,
+                      std::min(I + BucketsPerTask, Buckets.size()));
+    TaskGroup.wait();
   }
 
   CUIndexForm = DIEInteger::BestForm(/*IsSigned*/ false, CUList.size() - 1);
@@ -15,8 +15,13 @@
 #include "bolt/Core/ParallelUtilities.h"
 #include "bolt/Passes/ReorderAlgorithm.h"
 #include "bolt/Passes/ReorderFunctions.h"
+#include "llvm/ADT/BitVector.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/xxhash.h"
+#include "llvm/Transforms/Utils/CodeLayout.h"
 #include <atomic>
+#include <fstream>
 #include <mutex>
 #include <numeric>
 #include <vector>
@@ -82,6 +87,13 @@ bool isHotTextMover(const BinaryFunction &Function) {
   return false;
 }
 
+static cl::opt<std::string> BlockLayoutCache(
+    "block-layout-cache",
+    cl::desc("file keeping the block layouts of functions between runs. The "
+             "layout of a function is reused if neither its code nor the shape "
+             "of its profile changed since the run which wrote the file"),
+    cl::value_desc("filename"), cl::cat(BoltOptCategory));
+
 static cl::opt<bool> MinBranchClusters(
     "min-branch-clusters",
     cl::desc("use a modified clustering algorithm geared towards minimizing "
@@ -384,6 +396,121 @@ bool ReorderBasicBlocks::shouldOptimize(const BinaryFunction &BF) const {
   return BinaryFunctionPass::shouldOptimize(BF);
 }
 
+/// Block layouts kept between runs with -block-layout-cache. The key is made
+/// of the hash of the function code and of a hash of its profile, and the
+/// layout is the order of the blocks given by their index in the function.
+using LayoutCacheKey = std::pair<uint64_t, uint64_t>;
+using LayoutCacheType = DenseMap<LayoutCacheKey, SmallVector<uint32_t, 0>>;
+
+/// Compute the key of \p BF in the layout cache. Only the bit width of the
+/// execution counts goes into the key, so that a layout survives the small
+/// variations between the profiles of two runs while a change in the hotness
+/// of a path invalidates it. The options of the layout algorithms are part of
+/// the key as well.
+static LayoutCacheKey getLayoutCacheKey(const BinaryFunction &BF) {
+  SmallVector<uint64_t, 0> Profile;
+  Profile.push_back(opts::ReorderBlocks);
+  Profile.push_back(opts::MinBranchClusters);
+  Profile.push_back(opts::TSPThreshold);
+  Profile.push_back(codelayout::getExtTspParamsHash());
+  auto addCount = [&](uint64_t Count) {
+    Profile.push_back(Count == BinaryBasicBlock::COUNT_NO_PROFILE
+                          ? ~0ULL
+                          : Log2_64_Ceil(Count + 1));
+  };
+  for (const BinaryBasicBlock &BB : BF) {
+    addCount(BB.getKnownExecutionCount());
+    for (const BinaryBasicBlock::BinaryBranchInfo &BI : BB.branch_info())
+      addCount(BI.Count);
+  }
+  const uint64_t ProfileHash = llvm::xxh3_64bits(ArrayRef<uint8_t>(
+      reinterpret_cast<const uint8_t *>(Profile.data()),
+      Profile.size() * sizeof(uint64_t)));
+  return {BF.computeHash(/*UseDFS=*/true), ProfileHash};
+}
+
+/// Read the layouts written by a previous run. A missing file is not an
+/// error, as there is nothing to reuse on the first run.
+static void readLayoutCache(LayoutCacheType &Cache) {
+  std::ifstream CacheFile(opts::BlockLayoutCache, std::ios::in);
+  std::string Line;
+  while (CacheFile && std::getline(CacheFile, Line)) {
+    SmallVector<StringRef, 0> Fields;
+    StringRef(Line).split(Fields, ' ', -1, /*KeepEmpty=*/false);
+    LayoutCacheKey Key;
+    if (Fields.size() < 3 || Fields[0].getAsInteger(16, Key.first) ||
+        Fields[1].getAsInteger(16, Key.second))
+      continue;
+    SmallVector<uint32_t, 0> &Order = Cache[Key];
+    for (StringRef Field : llvm::drop_begin(Fields, 2)) {
+      uint32_t Index;
+      if (Field.getAsInteger(10, Index)) {
+        Cache.erase(Key);
+        break;
+      }
+      Order.push_back(Index);
+    }
+  }
+}
+
+/// Write the layouts to a temporary file which then replaces the cache, so
+/// that an interrupted run or a concurrent one never leaves a partial cache.
+static void writeLayoutCache(BinaryContext &BC, const LayoutCacheType &Cache) {
+  auto warn = [&](const Twine &Reason) {
+    BC.errs() << "BOLT-WARNING: block layout cache " << opts::BlockLayoutCache
+              << " cannot be written: " << Reason << '\n';
+  };
+  int FD;
+  SmallString<128> TempPath;
+  if (std::error_code EC = sys::fs::createUniqueFile(
+          opts::BlockLayoutCache + ".tmp%%%%%%", FD, TempPath)) {
+    warn(EC.message());
+    return;
+  }
+  {
+    raw_fd_ostream CacheFile(FD, /*shouldClose=*/true);
+    for (const auto &[Key, Order] : Cache) {
+      CacheFile << Twine::utohexstr(Key.first) << ' '
+                << Twine::utohexstr(Key.second);
+      for (uint32_t Index : Order)
+        CacheFile << ' ' << Index;
+      CacheFile << '\n';
+    }
+    CacheFile.close();
+    if (CacheFile.has_error()) {
+      warn(CacheFile.error().message());
+      CacheFile.clear_error();
+      sys::fs::remove(TempPath);
+      return;
+    }
+  }
+  if (std::error_code EC = sys::fs::rename(TempPath, opts::BlockLayoutCache)) {
+    warn(EC.message());
+    sys::fs::remove(TempPath);
+  }
+}
+
+/// Apply the cached \p Order to \p BF. Returns std::nullopt if the order
+/// doesn't fit the function, otherwise whether the layout was changed.
+static std::optional<bool> applyCachedLayout(BinaryFunction &BF,
+                                             ArrayRef<uint32_t> Order) {
+  SmallVector<BinaryBasicBlock *, 0> Blocks(BF.size());
+  for (BinaryBasicBlock &BB : BF)
+    Blocks[BB.getIndex()] = &BB;
+  if (Order.size() != Blocks.size() || Order.front() != 0)
+    return std::nullopt;
+
+  BitVector Seen(Blocks.size());
+  BinaryFunction::BasicBlockOrderType NewLayout;
+  for (uint32_t Index : Order) {
+    if (Index >= Blocks.size() || Seen[Index])
+      return std::nullopt;
+    Seen.set(Index);
+    NewLayout.push_back(Blocks[Index]);
+  }
+  return BF.getLayout().update(NewLayout);
+}
+
 Error ReorderBasicBlocks::runOnFunctions(BinaryContext &BC) {
   if (opts::ReorderBlocks == ReorderBasicBlocks::LT_NONE)
     return Error::success();
@@ -392,13 +519,50 @@ Error ReorderBasicBlocks::runOnFunctions(BinaryContext &BC) {
   std::mutex FunctionEditDistanceMutex;
   DenseMap<const BinaryFunction *, uint64_t> FunctionEditDistance;
 
+  // The reversed and shuffled layouts are meant for testing and are not
+  // worth caching.
+  const bool UseLayoutCache =
+      !opts::BlockLayoutCache.empty() &&
+      opts::ReorderBlocks != ReorderBasicBlocks::LT_REVERSE &&
+      opts::ReorderBlocks != ReorderBasicBlocks::LT_OPTIMIZE_SHUFFLE;
+  LayoutCacheType OldLayoutCache;
+  LayoutCacheType NewLayoutCache;
+  std::mutex LayoutCacheMutex;
+  std::atomic_uint64_t CachedFuncCount(0);
+  if (UseLayoutCache)
+    readLayoutCache(OldLayoutCache);
+
   ParallelUtilities::WorkFuncTy WorkFun = [&](BinaryFunction &BF) {
     SmallVector<const BinaryBasicBlock *, 0> OldBlockOrder;
     if (opts::PrintFuncStat > 0)
       llvm::copy(BF.getLayout().blocks(), std::back_inserter(OldBlockOrder));
 
-    const bool LayoutChanged =
-        modifyFunctionLayout(BF, opts::ReorderBlocks, opts::MinBranchClusters);
+    std::optional<LayoutCacheKey> CacheKey;
+    std::optional<bool> CachedLayoutChanged;
+    if (UseLayoutCache && BF.size() && BF.hasValidProfile()) {
+      CacheKey = getLayoutCacheKey(BF);
+      auto It = OldLayoutCache.find(*CacheKey);
+      if (It != OldLayoutCache.end())
+        CachedLayoutChanged = applyCachedLayout(BF, It->second);
+    }
+
+    bool LayoutChanged;
+    if (CachedLayoutChanged) {
+      CachedFuncCount.fetch_add(1, std::memory_order_relaxed);
+      LayoutChanged = *CachedLayoutChanged;
+    } else {
+      LayoutChanged = modifyFunctionLayout(BF, opts::ReorderBlocks,
+                                           opts::MinBranchClusters);
+    }
+
+    if (CacheKey) {
+      SmallVector<uint32_t, 0> Order;
+      for (const BinaryBasicBlock *BB : BF.getLayout().blocks())
+        Order.push_back(BB->getIndex());
+      std::lock_guard<std::mutex> Lock(LayoutCacheMutex);
+      NewLayoutCache[*CacheKey] = std::move(Order);
+    }
+
     if (LayoutChanged) {
       ModifiedFuncCount.fetch_add(1, std::memory_order_relaxed);
       if (opts::PrintFuncStat > 0) {
@@ -428,6 +592,13 @@ Error ReorderBasicBlocks::runOnFunctions(BinaryContext &BC) {
                    100.0 * ModifiedFuncCount.load(std::memory_order_relaxed) /
                        BC.getBinaryFunctions().size());
 
+  if (UseLayoutCache) {
+    BC.outs() << "BOLT-INFO: reused cached block layout of "
+              << CachedFuncCount.load(std::memory_order_relaxed)
+              << " functions\n";
+    writeLayoutCache(BC, NewLayoutCache);
+  }
+
   if (opts::PrintFuncStat > 0) {
     raw_ostream &OS = BC.outs();
     // Copy all the values into vector in order to sort them
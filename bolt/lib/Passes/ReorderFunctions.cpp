@@ -30,6 +30,8 @@ extern cl::opt<uint32_t> RandomSeed;
 
 extern size_t padFunction(const bolt::BinaryFunction &Function);
 
+extern cl::opt<bool> HotText;
+
 extern cl::opt<bolt::ReorderFunctions::ReorderType> ReorderFunctions;
 cl::opt<bolt::ReorderFunctions::ReorderType> ReorderFunctions(
     "reorder-functions",
@@ -143,6 +145,31 @@ void ReorderFunctions::reorder(BinaryContext &BC,
   printStats(BC, Clusters, FuncAddr);
 }
 
+/// Report how the ordered functions fill the pages of the hot text, which
+/// -hugify remaps to huge pages. A last page that is nearly empty costs a whole
+/// TLB entry for little code, so trimming or growing the hot set slightly may
+/// save a page.
+static void printHotTextPageUsage(BinaryContext &BC,
+                                  std::map<uint64_t, BinaryFunction> &BFs) {
+  uint64_t HotSize = 0;
+  for (const BinaryFunction &BF : llvm::make_second_range(BFs)) {
+    if (!BF.hasValidIndex())
+      continue;
+    HotSize += BF.isSplit() ? BF.estimateHotSize() : BF.estimateSize();
+  }
+  if (!HotSize)
+    return;
+
+  const uint64_t NumPages = divideCeil(HotSize, BC.PageAlign);
+  const uint64_t LastPageSize = HotSize - (NumPages - 1) * BC.PageAlign;
+  BC.outs() << "BOLT-INFO: ordered functions take about " << HotSize
+            << " bytes of hot text in " << NumPages << " page"
+            << (NumPages == 1 ? "" : "s") << " of 0x"
+            << Twine::utohexstr(BC.PageAlign) << " bytes"
+            << format(", the last one %.1f%% full\n",
+                      100.0 * LastPageSize / BC.PageAlign);
+}
+
 void ReorderFunctions::printStats(BinaryContext &BC,
                                   const std::vector<Cluster> &Clusters,
                                   const std::vector<uint64_t> &FuncAddr) {
@@ -445,6 +472,9 @@ Error ReorderFunctions::runOnFunctions(BinaryContext &BC) {
 
   BC.HasFinalizedFunctionOrder = true;
 
+  if (opts::HotText)
+    printHotTextPageUsage(BC, BFs);
+
   std::unique_ptr<std::ofstream> FuncsFile;
   if (!opts::GenerateFunctionOrderFile.empty()) {
     FuncsFile = std::make_unique<std::ofstream>(opts::GenerateFunctionOrderFile,
@@ -1395,6 +1395,11 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
   // LBRs are stored in reverse execution order. NextPC refers to the next
   // recorded executed PC.
   uint64_t NextPC = opts::UseEventPC ? Sample.PC : 0;
+  // Look up the functions containing the addresses of each entry only once.
+  // NextPC is the source of the previous entry, so its function is carried
+  // over from the previous iteration.
+  const BinaryFunction *NextPCFunc =
+      NextPC ? getBinaryFunctionContainingAddress(NextPC) : nullptr;
   uint32_t NumEntry = 0;
   for (const LBREntry &LBR : Sample.LBR) {
     ++NumEntry;
@@ -1406,12 +1411,14 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
     // chronological order)
     if (NeedsSkylakeFix && NumEntry <= 2)
       continue;
+    const BinaryFunction *FromFunc =
+        getBinaryFunctionContainingAddress(LBR.From);
+    const BinaryFunction *ToFunc = getBinaryFunctionContainingAddress(LBR.To);
     if (NextPC) {
       // Record fall-through trace.
       const uint64_t TraceFrom = LBR.To;
       const uint64_t TraceTo = NextPC;
-      const BinaryFunction *TraceBF =
-          getBinaryFunctionContainingAddress(TraceFrom);
+      const BinaryFunction *TraceBF = ToFunc;
       if (TraceBF && TraceBF->containsAddress(TraceTo)) {
         FTInfo &Info = FallthroughLBRs[Trace(TraceFrom, TraceTo)];
         if (TraceBF->containsAddress(LBR.From))
@@ -1419,9 +1426,8 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
         else
           ++Info.ExternCount;
       } else {
-        const BinaryFunction *ToFunc =
-            getBinaryFunctionContainingAddress(TraceTo);
-        if (TraceBF && ToFunc) {
+        const BinaryFunction *TraceToFunc = NextPCFunc;
+        if (TraceBF && TraceToFunc) {
           LLVM_DEBUG({
             dbgs() << "Invalid trace starting in " << TraceBF->getPrintName()
                    << formatv(" @ {0:x}", TraceFrom - TraceBF->getAddress())
@@ -1435,9 +1441,10 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
                    << formatv(" @ {0:x}",
                               TraceFrom - (TraceBF ? TraceBF->getAddress() : 0))
                    << " and ending in "
-                   << (ToFunc ? ToFunc->getPrintName() : "None")
+                   << (TraceToFunc ? TraceToFunc->getPrintName() : "None")
                    << formatv(" @ {0:x}\n",
-                              TraceTo - (ToFunc ? ToFunc->getAddress() : 0));
+                              TraceTo - (TraceToFunc ? TraceToFunc->getAddress()
+                                                     : 0));
           });
           ++NumLongRangeTraces;
         }
@@ -1445,9 +1452,10 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
       ++NumTraces;
     }
     NextPC = LBR.From;
+    NextPCFunc = FromFunc;
 
-    uint64_t From = getBinaryFunctionContainingAddress(LBR.From) ? LBR.From : 0;
-    uint64_t To = getBinaryFunctionContainingAddress(LBR.To) ? LBR.To : 0;
+    uint64_t From = FromFunc ? LBR.From : 0;
+    uint64_t To = ToFunc ? LBR.To : 0;
     if (!From && !To)
       continue;
     BranchInfo &Info = BranchLBRs[Trace(From, To)];
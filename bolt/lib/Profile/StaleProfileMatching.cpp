@@ -387,7 +387,8 @@ createFlowFunction(const BinaryFunction::BasicBlockOrderType &BlockOrder) {
 /// of the basic blocks in the binary, the count is "matched" to the block.
 /// Similarly, if both the source and the target of a count in the profile are
 /// matched to a jump in the binary, the count is recorded in CFG.
-void matchWeightsByHashes(BinaryContext &BC,
+/// The matching stats of the function are added to \p Stats.
+void matchWeightsByHashes(BinaryContext::BinaryStats &Stats,
                           const BinaryFunction::BasicBlockOrderType &BlockOrder,
                           const yaml::bolt::BinaryFunctionProfile &YamlBF,
                           FlowFunction &Func) {
@@ -428,14 +429,14 @@ void matchWeightsByHashes(BinaryContext &BC,
                         << "\n");
       // Update matching stats accounting for the matched block.
       if (Matcher.isHighConfidenceMatch(BinHash, YamlHash)) {
-        ++BC.Stats.NumMatchedBlocks;
-        BC.Stats.MatchedSampleCount += YamlBB.ExecCount;
+        ++Stats.NumMatchedBlocks;
+        Stats.MatchedSampleCount += YamlBB.ExecCount;
         LLVM_DEBUG(dbgs() << "  exact match\n");
       } else {
         LLVM_DEBUG(dbgs() << "  loose match\n");
       }
       if (YamlBB.NumInstructions == BB->size())
-        ++BC.Stats.NumStaleBlocksWithEqualIcount;
+        ++Stats.NumStaleBlocksWithEqualIcount;
     } else {
       LLVM_DEBUG(
           dbgs() << "Couldn't match yaml block (bid = " << YamlBB.Index << ")"
@@ -443,8 +444,8 @@ void matchWeightsByHashes(BinaryContext &BC,
     }
 
     // Update matching stats.
-    ++BC.Stats.NumStaleBlocks;
-    BC.Stats.StaleSampleCount += YamlBB.ExecCount;
+    ++Stats.NumStaleBlocks;
+    Stats.StaleSampleCount += YamlBB.ExecCount;
   }
 
   // Match jumps from the profile to the jumps from CFG
@@ -611,7 +612,7 @@ void applyInference(FlowFunction &Func) {
 /// the binary function.
 void assignProfile(BinaryFunction &BF,
                    const BinaryFunction::BasicBlockOrderType &BlockOrder,
-                   FlowFunction &Func) {
+                   FlowFunction &Func, MCPlusBuilder::AllocatorIdTy AllocId) {
   BinaryContext &BC = BF.getBinaryContext();
 
   assert(Func.Blocks.size() == BlockOrder.size() + 1);
@@ -656,7 +657,7 @@ void assignProfile(BinaryFunction &BF,
       // Do not add zero-count annotations
       if (Count == 0)
         return;
-      BC.MIB->addAnnotation(Instr, Name, Count);
+      BC.MIB->addAnnotation(Instr, Name, Count, AllocId);
     };
 
     for (MCInst &Instr : *BB) {
@@ -670,7 +671,7 @@ void assignProfile(BinaryFunction &BF,
 
       if (BC.MIB->isIndirectCall(Instr) || BC.MIB->isIndirectBranch(Instr)) {
         auto &ICSP = BC.MIB->getOrCreateAnnotationAs<IndirectCallSiteProfile>(
-            Instr, "CallProfile");
+            Instr, "CallProfile", AllocId);
         if (!ICSP.empty()) {
           // Try to evenly distribute the counts among the call sites
           const uint64_t TotalCount = Block.Flow;
@@ -704,7 +705,8 @@ void assignProfile(BinaryFunction &BF,
 }
 
 bool YAMLProfileReader::inferStaleProfile(
-    BinaryFunction &BF, const yaml::bolt::BinaryFunctionProfile &YamlBF) {
+    BinaryFunction &BF, const yaml::bolt::BinaryFunctionProfile &YamlBF,
+    MCPlusBuilder::AllocatorIdTy AllocId) {
   if (!BF.hasCFG())
     return false;
 
@@ -721,7 +723,18 @@ bool YAMLProfileReader::inferStaleProfile(
   FlowFunction Func = createFlowFunction(BlockOrder);
 
   // Match as many block/jump counts from the stale profile as possible
-  matchWeightsByHashes(BF.getBinaryContext(), BlockOrder, YamlBF, Func);
+  BinaryContext::BinaryStats Stats;
+  matchWeightsByHashes(Stats, BlockOrder, YamlBF, Func);
+  {
+    BinaryContext::BinaryStats &TotalStats = BF.getBinaryContext().Stats;
+    std::lock_guard<std::mutex> Lock(StatsMutex);
+    TotalStats.NumStaleBlocks += Stats.NumStaleBlocks;
+    TotalStats.NumMatchedBlocks += Stats.NumMatchedBlocks;
+    TotalStats.StaleSampleCount += Stats.StaleSampleCount;
+    TotalStats.MatchedSampleCount += Stats.MatchedSampleCount;
+    TotalStats.NumStaleBlocksWithEqualIcount +=
+        Stats.NumStaleBlocksWithEqualIcount;
+  }
 
   // Adjust the flow function by marking unreachable blocks Unlikely so that
   // they don't get any counts assigned.
@@ -735,7 +748,7 @@ bool YAMLProfileReader::inferStaleProfile(
   applyInference(Func);
 
   // Collect inferred counts and update function annotations.
-  assignProfile(BF, BlockOrder, Func);
+  assignProfile(BF, BlockOrder, Func, AllocId);
 
   // As of now, we always mark the binary function having "correct" profile.
   // In the future, we may discard the results for instances with poor inference
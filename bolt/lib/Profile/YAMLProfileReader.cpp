@@ -9,6 +9,7 @@
 #include "bolt/Profile/YAMLProfileReader.h"
 #include "bolt/Core/BinaryBasicBlock.h"
 #include "bolt/Core/BinaryFunction.h"
+#include "bolt/Core/ParallelUtilities.h"
 #include "bolt/Passes/MCF.h"
 #include "bolt/Profile/ProfileYAMLMapping.h"
 #include "bolt/Utils/Utils.h"
@@ -79,7 +80,8 @@ bool YAMLProfileReader::hasLocalsWithFileName() const {
 }
 
 bool YAMLProfileReader::parseFunctionProfile(
-    BinaryFunction &BF, const yaml::bolt::BinaryFunctionProfile &YamlBF) {
+    BinaryFunction &BF, const yaml::bolt::BinaryFunctionProfile &YamlBF,
+    MCPlusBuilder::AllocatorIdTy AllocId) {
   BinaryContext &BC = BF.getBinaryContext();
 
   const bool IsDFSOrder = YamlBP.Header.IsDFSOrder;
@@ -195,12 +197,12 @@ bool YAMLProfileReader::parseFunctionProfile(
                    << " in function " << BF << '\n';
           return;
         }
-        BC.MIB->addAnnotation(*Instr, Name, Count);
+        BC.MIB->addAnnotation(*Instr, Name, Count, AllocId);
       };
 
       if (BC.MIB->isIndirectCall(*Instr) || BC.MIB->isIndirectBranch(*Instr)) {
         auto &CSP = BC.MIB->getOrCreateAnnotationAs<IndirectCallSiteProfile>(
-            *Instr, "CallProfile");
+            *Instr, "CallProfile", AllocId);
         CSP.emplace_back(CalleeSymbol, YamlCSI.Count, YamlCSI.Mispreds);
       } else if (BC.MIB->getConditionalTailCall(*Instr)) {
         setAnnotation("CTCTakenCount", YamlCSI.Count);
@@ -252,10 +254,12 @@ bool YAMLProfileReader::parseFunctionProfile(
              << MismatchedCalls << " calls, and " << MismatchedEdges
              << " edges in profile did not match function " << BF << '\n';
 
-    if (YamlBF.NumBasicBlocks != BF.size())
+    if (YamlBF.NumBasicBlocks != BF.size()) {
+      std::lock_guard<std::mutex> Lock(StatsMutex);
       ++BC.Stats.NumStaleFuncsWithEqualBlockCount;
+    }
 
-    if (opts::InferStaleProfile && inferStaleProfile(BF, YamlBF))
+    if (opts::InferStaleProfile && inferStaleProfile(BF, YamlBF, AllocId))
       ProfileMatched = true;
   }
   if (ProfileMatched)
@@ -410,6 +414,8 @@ Error YAMLProfileReader::readProfile(BinaryContext &BC) {
   NormalizeByCalls = usesEvent("branches");
 
   uint64_t NumUnused = 0;
+  DenseMap<const BinaryFunction *, const yaml::bolt::BinaryFunctionProfile *>
+      FunctionProfiles;
   for (yaml::bolt::BinaryFunctionProfile &YamlBF : YamlBP.Functions) {
     if (YamlBF.Id >= YamlProfileToFunction.size()) {
       // Such profile was ignored.
@@ -417,11 +423,24 @@ Error YAMLProfileReader::readProfile(BinaryContext &BC) {
       continue;
     }
     if (BinaryFunction *BF = YamlProfileToFunction[YamlBF.Id])
-      parseFunctionProfile(*BF, YamlBF);
+      FunctionProfiles[BF] = &YamlBF;
     else
       ++NumUnused;
   }
 
+  // A function is matched to at most one profile, so profiles are parsed, and
+  // stale ones inferred, for all the functions in parallel.
+  ParallelUtilities::WorkFuncWithAllocTy WorkFun =
+      [&](BinaryFunction &BF, MCPlusBuilder::AllocatorIdTy AllocId) {
+        parseFunctionProfile(BF, *FunctionProfiles.lookup(&BF), AllocId);
+      };
+  ParallelUtilities::PredicateTy SkipFunc = [&](const BinaryFunction &BF) {
+    return !FunctionProfiles.count(&BF);
+  };
+  ParallelUtilities::runOnEachFunctionWithUniqueAllocId(
+      BC, ParallelUtilities::SchedulingPolicy::SP_BB_LINEAR, WorkFun, SkipFunc,
+      "parseFunctionProfile");
+
   BC.setNumUnusedProfiledObjects(NumUnused);
 
   return Error::success();
@@ -365,6 +365,14 @@ static cl::opt<unsigned> BatchSize(
         "better performance, but more memory usage. Default value is 1."),
     cl::Hidden, cl::init(1), cl::cat(BoltCategory));
 
+static cl::opt<unsigned> BatchMaxSize(
+    "cu-processing-batch-max-size",
+    cl::desc("Limits the batches of CUs without cross CU references to this "
+             "many bytes of input .debug_info, so that a large "
+             "--cu-processing-batch-size doesn't make memory usage unbounded. "
+             "0 means no limit. Default value is 64MB."),
+    cl::Hidden, cl::init(64 << 20), cl::cat(BoltCategory));
+
 static cl::opt<bool> AlwaysConvertToRanges(
     "always-convert-to-ranges",
     cl::desc("This option is for testing purposes only. It forces BOLT to "
@@ -635,6 +643,7 @@ using CUPartitionVector = std::vector<DWARFUnitVec>;
 static CUPartitionVector partitionCUs(DWARFContext &DwCtx) {
   CUPartitionVector Vec(2);
   unsigned Counter = 0;
+  uint64_t BatchBytes = 0;
   const DWARFDebugAbbrev *Abbr = DwCtx.getDebugAbbrev();
   for (std::unique_ptr<DWARFUnit> &CU : DwCtx.compile_units()) {
     Expected<const DWARFAbbreviationDeclarationSet *> AbbrDeclSet =
@@ -659,10 +668,16 @@ static CUPartitionVector partitionCUs(DWARFContext &DwCtx) {
       Vec[0].push_back(CU.get());
     } else {
       ++Counter;
+      BatchBytes += CU->getLength();
       Vec.back().push_back(CU.get());
     }
-    if (Counter % opts::BatchSize == 0 && !Vec.back().empty())
+    if (!Vec.back().empty() &&
+        (Counter % opts::BatchSize == 0 ||
+         (opts::BatchMaxSize && BatchBytes >= opts::BatchMaxSize))) {
       Vec.push_back({});
+      Counter = 0;
+      BatchBytes = 0;
+    }
   }
   return Vec;
 }
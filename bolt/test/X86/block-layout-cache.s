@@ -0,0 +1,57 @@
+## Check that -block-layout-cache reuses the block layouts written by a
+## previous run, and that changing an ext-tsp option lays the functions out
+## again.
+
+# REQUIRES: system-linux
+
+# RUN: llvm-mc -filetype=obj -triple x86_64-unknown-unknown %s -o %t.o
+# RUN: link_fdata %s %t.o %t.fdata
+# RUN: llvm-strip --strip-unneeded %t.o
+# RUN: %clang %cflags -no-pie %t.o -o %t.exe -Wl,-q
+# RUN: rm -f %t.cache
+# RUN: llvm-bolt %t.exe -o %t.out --data %t.fdata --reorder-blocks=ext-tsp \
+# RUN:   --block-layout-cache=%t.cache | FileCheck %s --check-prefix=MISS
+# RUN: llvm-bolt %t.exe -o %t.out --data %t.fdata --reorder-blocks=ext-tsp \
+# RUN:   --block-layout-cache=%t.cache | FileCheck %s --check-prefix=HIT
+# RUN: llvm-bolt %t.exe -o %t.out --data %t.fdata --reorder-blocks=ext-tsp \
+# RUN:   --ext-tsp-forward-distance=64 --block-layout-cache=%t.cache \
+# RUN:   | FileCheck %s --check-prefix=MISS
+
+## The cache is replaced as a whole, no temporary file is left behind.
+# RUN: not ls %t.cache.tmp*
+
+# MISS: BOLT-INFO: reused cached block layout of 0 functions
+# HIT: BOLT-INFO: reused cached block layout of {{[1-9]}} functions
+
+  .text
+  .globl foo
+  .type foo, @function
+foo:
+  testl %edi, %edi
+.Lbr:
+  jne .Lhot
+# FDATA: 1 foo #.Lbr# 1 foo #.Lhot# 0 1000
+  movl $0x1, %eax
+  retq
+.Lhot:
+  movl $0x2, %eax
+  retq
+  .size foo, .-foo
+
+  .globl main
+  .type main, @function
+main:
+  movl $0x1, %edi
+.Lcall:
+  callq foo
+# FDATA: 1 main #.Lcall# 1 foo 0 0 1000
+  testl %eax, %eax
+.Lbr2:
+  je .Lzero
+# FDATA: 1 main #.Lbr2# 1 main #.Lzero# 0 1000
+  xorl %eax, %eax
+  retq
+.Lzero:
+  movl $0x3, %eax
+  retq
+  .size main, .-main
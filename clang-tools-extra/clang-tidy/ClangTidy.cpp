@@ -28,6 +28,7 @@
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/FrontendDiagnostic.h"
 #include "clang/Frontend/MultiplexConsumer.h"
+#include "clang/Frontend/PrecompiledPreamble.h"
 #include "clang/Frontend/TextDiagnosticPrinter.h"
 #include "clang/Lex/PPCallbacks.h"
 #include "clang/Lex/Preprocessor.h"
@@ -338,6 +339,104 @@ private:
   std::vector<std::unique_ptr<ClangTidyCheck>> Checks;
 };
 
+/// Restricts the AST traversal of the wrapped consumer to the declarations
+/// parsed for the current translation unit, i.e. it skips the declarations
+/// deserialized from a shared preamble.
+class ParsedDeclsConsumer : public MultiplexConsumer {
+public:
+  ParsedDeclsConsumer(std::vector<std::unique_ptr<ASTConsumer>> Consumers)
+      : MultiplexConsumer(std::move(Consumers)) {}
+
+  bool HandleTopLevelDecl(DeclGroupRef DG) override {
+    TopLevelDecls.insert(TopLevelDecls.end(), DG.begin(), DG.end());
+    return MultiplexConsumer::HandleTopLevelDecl(DG);
+  }
+
+  void HandleTranslationUnit(ASTContext &Ctx) override {
+    Ctx.setTraversalScope(TopLevelDecls);
+    MultiplexConsumer::HandleTranslationUnit(Ctx);
+  }
+
+private:
+  std::vector<Decl *> TopLevelDecls;
+};
+
+/// Precompiled preambles shared between the translation units checked by one
+/// runClangTidy() call. Main files that start with the same preamble and are
+/// compiled with the same options only parse that preamble once.
+class SharedPreambles {
+public:
+  /// Makes \p Invocation use a shared preamble for its main file, building the
+  /// preamble first if there is no reusable one. Leaves \p Invocation alone if
+  /// the main file has no preamble or the preamble could not be built.
+  void addPreamble(CompilerInvocation &Invocation, FileManager &Files,
+                   std::shared_ptr<PCHContainerOperations> PCHContainerOps) {
+    const FrontendOptions &FrontendOpts = Invocation.getFrontendOpts();
+    if (FrontendOpts.Inputs.size() != 1 || !FrontendOpts.Inputs[0].isFile())
+      return;
+    StringRef MainFile = FrontendOpts.Inputs[0].getFile();
+    IntrusiveRefCntPtr<llvm::vfs::FileSystem> VFS =
+        Files.getVirtualFileSystemPtr();
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buffer =
+        VFS->getBufferForFile(MainFile);
+    if (!Buffer)
+      return;
+    PreambleBounds Bounds =
+        ComputePreambleBounds(Invocation.getLangOpts(), **Buffer,
+                              /*MaxLines=*/0);
+    if (Bounds.Size == 0)
+      return;
+
+    StringRef PreambleContent = (*Buffer)->getBuffer().take_front(Bounds.Size);
+    std::unique_ptr<PrecompiledPreamble> &Preamble =
+        Preambles[getKey(Invocation, MainFile, PreambleContent)];
+    if (Preamble && !Preamble->CanReuse(Invocation,
+                                        (*Buffer)->getMemBufferRef(), Bounds,
+                                        *VFS))
+      Preamble.reset();
+    if (!Preamble) {
+      // Diagnostics for the preamble are not reported: a translation unit
+      // whose preamble has errors is checked without a shared preamble.
+      IntrusiveRefCntPtr<DiagnosticsEngine> Diags =
+          CompilerInstance::createDiagnostics(&Invocation.getDiagnosticOpts(),
+                                              new IgnoringDiagConsumer());
+      PreambleCallbacks Callbacks;
+      llvm::ErrorOr<PrecompiledPreamble> Built = PrecompiledPreamble::Build(
+          Invocation, Buffer->get(), Bounds, *Diags, VFS,
+          std::move(PCHContainerOps), /*StoreInMemory=*/false,
+          /*StoragePath=*/StringRef(), Callbacks);
+      if (!Built || Diags->hasErrorOccurred())
+        return;
+      Preamble = std::make_unique<PrecompiledPreamble>(std::move(*Built));
+    }
+    // The compiler instance takes ownership of the remapped main file buffer.
+    Preamble->AddImplicitPreamble(Invocation, VFS, Buffer->release());
+  }
+
+private:
+  /// Preambles can only be shared between main files in the same directory,
+  /// as that is where quoted includes are looked up first, and between
+  /// compile commands that only differ in the input and output files.
+  static std::string getKey(const CompilerInvocation &Invocation,
+                            StringRef MainFile, StringRef PreambleContent) {
+    CompilerInvocation KeyInvocation(Invocation);
+    KeyInvocation.getFrontendOpts().Inputs.clear();
+    KeyInvocation.getFrontendOpts().OutputFile.clear();
+    KeyInvocation.getCodeGenOpts().MainFileName.clear();
+    std::string Key;
+    for (const std::string &Arg : KeyInvocation.getCC1CommandLine()) {
+      Key += Arg;
+      Key += '\0';
+    }
+    Key += llvm::sys::path::parent_path(MainFile);
+    Key += '\0';
+    Key += PreambleContent;
+    return Key;
+  }
+
+  llvm::StringMap<std::unique_ptr<PrecompiledPreamble>> Preambles;
+};
+
 } // namespace
 
 ClangTidyASTConsumerFactory::ClangTidyASTConsumerFactory(
@@ -530,7 +629,7 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
              ArrayRef<std::string> InputFiles,
              llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
              bool ApplyAnyFix, bool EnableCheckProfile,
-             llvm::StringRef StoreCheckProfile) {
+             llvm::StringRef StoreCheckProfile, bool SharePreambles) {
   ClangTool Tool(Compilations, InputFiles,
                  std::make_shared<PCHContainerOperations>(), BaseFS);
 
@@ -566,10 +665,14 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
   class ActionFactory : public FrontendActionFactory {
   public:
     ActionFactory(ClangTidyContext &Context,
-                  IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS)
-        : ConsumerFactory(Context, std::move(BaseFS)) {}
+                  IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
+                  bool SharePreambles)
+        : ConsumerFactory(Context, std::move(BaseFS)),
+          Preambles(SharePreambles ? std::make_unique<SharedPreambles>()
+                                   : nullptr) {}
     std::unique_ptr<FrontendAction> create() override {
-      return std::make_unique<Action>(&ConsumerFactory);
+      return std::make_unique<Action>(&ConsumerFactory,
+                                      /*OnlyParsedDecls=*/Preambles != nullptr);
     }
 
     bool runInvocation(std::shared_ptr<CompilerInvocation> Invocation,
@@ -578,6 +681,8 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
                        DiagnosticConsumer *DiagConsumer) override {
       // Explicitly ask to define __clang_analyzer__ macro.
       Invocation->getPreprocessorOpts().SetUpStaticAnalyzer = true;
+      if (Preambles)
+        Preambles->addPreamble(*Invocation, *Files, PCHContainerOps);
       return FrontendActionFactory::runInvocation(
           Invocation, Files, PCHContainerOps, DiagConsumer);
     }
@@ -585,20 +690,29 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
   private:
     class Action : public ASTFrontendAction {
     public:
-      Action(ClangTidyASTConsumerFactory *Factory) : Factory(Factory) {}
+      Action(ClangTidyASTConsumerFactory *Factory, bool OnlyParsedDecls)
+          : Factory(Factory), OnlyParsedDecls(OnlyParsedDecls) {}
       std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance &Compiler,
                                                      StringRef File) override {
-        return Factory->createASTConsumer(Compiler, File);
+        std::unique_ptr<ASTConsumer> Consumer =
+            Factory->createASTConsumer(Compiler, File);
+        if (!OnlyParsedDecls)
+          return Consumer;
+        std::vector<std::unique_ptr<ASTConsumer>> Consumers;
+        Consumers.push_back(std::move(Consumer));
+        return std::make_unique<ParsedDeclsConsumer>(std::move(Consumers));
       }
 
     private:
       ClangTidyASTConsumerFactory *Factory;
+      bool OnlyParsedDecls;
     };
 
     ClangTidyASTConsumerFactory ConsumerFactory;
+    std::unique_ptr<SharedPreambles> Preambles;
   };
 
-  ActionFactory Factory(Context, std::move(BaseFS));
+  ActionFactory Factory(Context, std::move(BaseFS), SharePreambles);
   Tool.run(&Factory);
   return DiagConsumer.take();
 }
@@ -253,6 +253,19 @@ these per-TU profiles are instead stored as JSON.
                                               cl::value_desc("prefix"),
                                               cl::cat(ClangTidyCategory));
 
+static cl::opt<bool> SharePreambles("share-preambles", desc(R"(
+Build a precompiled preamble for the includes at
+the start of each file and reuse it for other
+files in the same directory that start with the
+same includes and use the same compile flags.
+Checks then only see the declarations after the
+preamble, preprocessor-based checks do not see
+the preamble, and compiler diagnostics from the
+preamble are not reported.
+)"),
+                                    cl::init(false),
+                                    cl::cat(ClangTidyCategory));
+
 /// This option allows enabling the experimental alpha checkers from the static
 /// analyzer. This option is set to false and not visible in help, because it is
 /// highly not recommended for users.
@@ -654,7 +667,7 @@ int clangTidyMain(int argc, const char **argv) {
                            EnableModuleHeadersParsing);
   std::vector<ClangTidyError> Errors =
       runClangTidy(Context, OptionsParser->getCompilations(), PathList, BaseFS,
-                   FixNotes, EnableCheckProfile, ProfilePrefix);
+                   FixNotes, EnableCheckProfile, ProfilePrefix, SharePreambles);
   bool FoundErrors = llvm::any_of(Errors, [](const ClangTidyError &E) {
     return E.DiagLevel == ClangTidyError::Error;
   });
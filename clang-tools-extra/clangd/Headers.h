@@ -153,6 +153,13 @@ public:
   // Return all transitively reachable files.
   llvm::ArrayRef<std::string> allHeaders() const { return RealPathNames; }
 
+  // Makes a structure collected for a preamble describe another main file that
+  // starts with the same preamble.
+  void rebindMainFile(llvm::StringRef RealPath) {
+    MainFileEntry = nullptr;
+    RealPathNames.front() = RealPath.str();
+  }
+
   // Returns includes inside the main file with the given spelling.
   // Spelling should include brackets or quotes, e.g. <foo>.
   llvm::SmallVector<const Inclusion *>
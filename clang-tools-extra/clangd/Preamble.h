@@ -93,7 +93,9 @@ private:
 /// As we must avoid re-parsing the preamble, any information that can only
 /// be obtained during parsing must be eagerly captured and stored here.
 struct PreambleData {
-  PreambleData(PrecompiledPreamble Preamble) : Preamble(std::move(Preamble)) {}
+  PreambleData(PrecompiledPreamble Preamble)
+      : Preamble(std::make_shared<const PrecompiledPreamble>(
+            std::move(Preamble))) {}
 
   // Version of the ParseInputs this preamble was built from.
   std::string Version;
@@ -102,7 +104,9 @@ struct PreambleData {
   // crashes when deserializing preamble, this enables consumers to use the
   // same target (without reparsing CompileCommand).
   std::shared_ptr<TargetOptions> TargetOpts = nullptr;
-  PrecompiledPreamble Preamble;
+  // The PCH. Files with identical preambles may share it, see
+  // TUScheduler::Options::SharePreambles; all other fields belong to one file.
+  std::shared_ptr<const PrecompiledPreamble> Preamble;
   std::vector<Diag> Diags;
   // Processes like code completions and go-to-definitions will need #include
   // information, and their compile action skips preamble range.
@@ -65,7 +65,9 @@
 #include "support/Trace.h"
 #include "clang/Basic/Stack.h"
 #include "clang/Frontend/CompilerInvocation.h"
+#include "clang/Lex/Lexer.h"
 #include "clang/Tooling/CompilationDatabase.h"
+#include "clang/Tooling/Inclusions/HeaderAnalysis.h"
 #include "llvm/ADT/FunctionExtras.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/ScopeExit.h"
@@ -151,34 +153,48 @@ std::optional<llvm::StringRef> TUScheduler::getFileBeingProcessedInContext() {
 class TUScheduler::ASTCache {
 public:
   using Key = const ASTWorker *;
+  using Duration = DebouncePolicy::clock::duration;
 
-  ASTCache(unsigned MaxRetainedASTs) : MaxRetainedASTs(MaxRetainedASTs) {}
+  ASTCache(const ASTRetentionPolicy &Policy)
+      : MaxRetainedASTs(Policy.MaxRetainedASTs),
+        MaxRetainedBytes(Policy.MaxRetainedBytes) {}
 
   /// Returns result of getUsedBytes() for the AST cached by \p K.
   /// If no AST is cached, 0 is returned.
   std::size_t getUsedBytes(Key K) {
     std::lock_guard<std::mutex> Lock(Mut);
     auto It = findByKey(K);
-    if (It == LRU.end() || !It->second)
+    if (It == LRU.end())
       return 0;
-    return It->second->getUsedBytes();
+    return It->Bytes;
   }
 
-  /// Store the value in the pool, possibly removing the last used AST.
+  /// Store the value in the pool, possibly removing less valuable ASTs.
   /// The value should not be in the pool when this function is called.
-  void put(Key K, std::unique_ptr<ParsedAST> V) {
-    std::unique_lock<std::mutex> Lock(Mut);
-    assert(findByKey(K) == LRU.end());
-
-    LRU.insert(LRU.begin(), {K, std::move(V)});
-    if (LRU.size() <= MaxRetainedASTs)
-      return;
-    // We're past the limit, remove the last element.
-    std::unique_ptr<ParsedAST> ForCleanup = std::move(LRU.back().second);
-    LRU.pop_back();
-    // Run the expensive destructor outside the lock.
-    Lock.unlock();
-    ForCleanup.reset();
+  /// \p RebuildCost is the time it took to build the AST, and makes it less
+  /// likely to be evicted when the cache is over its memory budget.
+  void put(Key K, std::unique_ptr<ParsedAST> V, Duration RebuildCost = {}) {
+    // Computing the size walks the AST, do it before taking the lock.
+    std::size_t Bytes = V ? V->getUsedBytes() : 0;
+    std::vector<std::unique_ptr<ParsedAST>> ForCleanup;
+    {
+      std::lock_guard<std::mutex> Lock(Mut);
+      assert(findByKey(K) == LRU.end());
+
+      LRU.insert(LRU.begin(), {K, std::move(V), Bytes, RebuildCost});
+      UsedBytes += Bytes;
+      // We're past the limit, remove the last element.
+      while (LRU.size() > MaxRetainedASTs)
+        ForCleanup.push_back(evict(LRU.end() - 1));
+      // Over the memory budget: evict the ASTs that are cheapest to rebuild
+      // relative to how recently they were used. The AST we just stored is
+      // kept, there is no point in parsing a file and dropping it right away.
+      while (MaxRetainedBytes && UsedBytes > MaxRetainedBytes &&
+             LRU.size() > 1)
+        ForCleanup.push_back(evict(pickVictim()));
+    }
+    // Run the expensive destructors outside the lock.
+    ForCleanup.clear();
   }
 
   /// Returns the cached value for \p K, or std::nullopt if the value is not in
@@ -197,8 +213,7 @@ public:
     }
     if (AccessMetric)
       AccessMetric->record(1, "hit");
-    std::unique_ptr<ParsedAST> V = std::move(Existing->second);
-    LRU.erase(Existing);
+    std::unique_ptr<ParsedAST> V = evict(Existing);
     // GCC 4.8 fails to compile `return V;`, as it tries to call the copy
     // constructor of unique_ptr, so we call the move ctor explicitly to avoid
     // this miscompile.
@@ -206,17 +221,57 @@ public:
   }
 
 private:
-  using KVPair = std::pair<Key, std::unique_ptr<ParsedAST>>;
+  struct Entry {
+    Key K;
+    std::unique_ptr<ParsedAST> AST;
+    std::size_t Bytes;
+    Duration RebuildCost;
+  };
+
+  std::vector<Entry>::iterator findByKey(Key K) {
+    return llvm::find_if(LRU, [K](const Entry &E) { return E.K == K; });
+  }
+
+  /// Removes \p It from the cache and returns its AST.
+  std::unique_ptr<ParsedAST> evict(std::vector<Entry>::iterator It) {
+    std::unique_ptr<ParsedAST> V = std::move(It->AST);
+    UsedBytes -= It->Bytes;
+    LRU.erase(It);
+    return V;
+  }
+
+  /// Picks the entry to evict when over the memory budget, never the most
+  /// recently used one. An entry's value is its rebuild cost discounted by how
+  /// long ago it was used, so with equal costs this is the LRU entry.
+  std::vector<Entry>::iterator pickVictim() {
+    assert(LRU.size() > 1);
+    auto Victim = LRU.end() - 1;
+    double VictimValue = value(*Victim, LRU.size() - 1);
+    for (size_t I = LRU.size() - 2; I > 0; --I) {
+      double Value = value(LRU[I], I);
+      if (Value < VictimValue) {
+        Victim = LRU.begin() + I;
+        VictimValue = Value;
+      }
+    }
+    return Victim;
+  }
 
-  std::vector<KVPair>::iterator findByKey(Key K) {
-    return llvm::find_if(LRU, [K](const KVPair &P) { return P.first == K; });
+  static double value(const Entry &E, size_t Age) {
+    // Count at least a millisecond, so that recency decides for cheap ASTs.
+    double CostMs = std::max(
+        1.0, std::chrono::duration<double, std::milli>(E.RebuildCost).count());
+    return CostMs / Age;
   }
 
   std::mutex Mut;
   unsigned MaxRetainedASTs;
+  std::size_t MaxRetainedBytes;
   /// Items sorted in LRU order, i.e. first item is the most recently accessed
   /// one.
-  std::vector<KVPair> LRU; /* GUARDED_BY(Mut) */
+  std::vector<Entry> LRU; /* GUARDED_BY(Mut) */
+  /// Sum of Bytes in LRU.
+  std::size_t UsedBytes = 0; /* GUARDED_BY(Mut) */
 };
 
 /// A map from header files to an opened "proxy" file that includes them.
@@ -343,6 +398,142 @@ public:
   }
 };
 
+/// Lets open files that start with the same preamble share one PreambleData.
+///
+/// Preambles are keyed by the preamble text, the directory of the main file
+/// (quoted includes are looked up there first) and the compile command with
+/// the main file name masked out. A hit is still checked with CanReuse(), so a
+/// header that changed since the preamble was built is noticed.
+///
+/// Only the PCH is shared. Each file gets its own PreambleData, with the
+/// version, compile command and include structure rebound to that file, so
+/// that the usual compatibility checks and header-to-includer mapping work.
+///
+/// Only preambles that don't depend on the identity of their main file are
+/// shared: ones without diagnostics, and whose preamble section holds nothing
+/// but include directives. Pragmas, macros and IWYU pragma comments record
+/// state against the main file that built the preamble.
+///
+/// Only weak references are kept, so a shared preamble is freed together with
+/// the last file that uses it and the cache never holds memory on its own.
+///
+/// All methods are threadsafe; they are called from the preamble threads.
+class TUScheduler::SharedPreambleCache {
+public:
+  /// Returns a preamble for \p FileName with \p Inputs and \p CI that shares
+  /// the PCH built for another file, or null.
+  std::shared_ptr<const PreambleData> get(PathRef FileName,
+                                          const ParseInputs &Inputs,
+                                          const CompilerInvocation &CI) {
+    std::shared_ptr<const PreambleData> Donor;
+    {
+      std::lock_guard<std::mutex> Lock(Mu);
+      auto It = Preambles.find(key(FileName, Inputs, CI));
+      if (It == Preambles.end())
+        return nullptr;
+      Donor = It->second.lock();
+    }
+    if (!Donor)
+      return nullptr;
+    auto ContentsBuffer =
+        llvm::MemoryBuffer::getMemBuffer(Inputs.Contents, FileName);
+    auto Bounds = ComputePreambleBounds(CI.getLangOpts(), *ContentsBuffer, 0);
+    auto VFS = Inputs.TFS->view(Inputs.CompileCommand.Directory);
+    if (!Donor->Preamble->CanReuse(CI, *ContentsBuffer, Bounds, *VFS))
+      return nullptr;
+    // The preamble sections are identical, so the offsets recorded for the
+    // donor are valid for this file; only its identity has to change.
+    auto Result = std::make_shared<PreambleData>(*Donor);
+    Result->Version = Inputs.Version;
+    Result->CompileCommand = Inputs.CompileCommand;
+    Result->Includes.rebindMainFile(FileName);
+    return Result;
+  }
+
+  /// Makes \p Preamble, just built for \p FileName, available to other files.
+  void put(PathRef FileName, const ParseInputs &Inputs,
+           const CompilerInvocation &CI,
+           const std::shared_ptr<const PreambleData> &Preamble) {
+    if (!Preamble->Diags.empty() ||
+        !onlyIncludes(preambleText(FileName, Inputs, CI), CI.getLangOpts()))
+      return;
+    std::string Key = key(FileName, Inputs, CI);
+    std::lock_guard<std::mutex> Lock(Mu);
+    for (auto It = Preambles.begin(); It != Preambles.end();) {
+      auto Next = std::next(It);
+      if (It->second.expired())
+        Preambles.erase(It);
+      It = Next;
+    }
+    Preambles[Key] = Preamble;
+  }
+
+private:
+  /// Returns true if \p Text only holds include directives and comments that
+  /// are not IWYU pragmas.
+  static bool onlyIncludes(llvm::StringRef Text, const LangOptions &LangOpts) {
+    Lexer Lex(SourceLocation(), LangOpts, Text.begin(), Text.begin(),
+              Text.end());
+    Lex.SetCommentRetentionState(true);
+    bool InInclude = false;
+    Token Tok;
+    while (true) {
+      Lex.LexFromRawLexer(Tok);
+      if (Tok.is(tok::eof))
+        return true;
+      if (Tok.is(tok::comment)) {
+        const char *Start = Lex.getBufferLocation() - Tok.getLength();
+        if (tooling::parseIWYUPragma(Start))
+          return false;
+        continue;
+      }
+      if (!Tok.isAtStartOfLine()) {
+        // The header name and anything else on the line of an include.
+        if (!InInclude)
+          return false;
+        continue;
+      }
+      InInclude = false;
+      if (Tok.isNot(tok::hash))
+        return false;
+      Lex.LexFromRawLexer(Tok);
+      if (Tok.isNot(tok::raw_identifier))
+        return false;
+      llvm::StringRef Directive = Tok.getRawIdentifier();
+      if (Directive != "include" && Directive != "include_next" &&
+          Directive != "import")
+        return false;
+      InInclude = true;
+    }
+  }
+
+  static llvm::StringRef preambleText(PathRef FileName,
+                                      const ParseInputs &Inputs,
+                                      const CompilerInvocation &CI) {
+    auto ContentsBuffer =
+        llvm::MemoryBuffer::getMemBuffer(Inputs.Contents, FileName);
+    auto Bounds = ComputePreambleBounds(CI.getLangOpts(), *ContentsBuffer, 0);
+    return llvm::StringRef(Inputs.Contents).take_front(Bounds.Size);
+  }
+
+  static std::string key(PathRef FileName, const ParseInputs &Inputs,
+                         const CompilerInvocation &CI) {
+    const tooling::CompileCommand &Cmd = Inputs.CompileCommand;
+    std::string Key;
+    llvm::raw_string_ostream OS(Key);
+    OS << llvm::sys::path::parent_path(FileName) << '\0' << Cmd.Directory
+       << '\0';
+    for (const std::string &Arg : Cmd.CommandLine)
+      OS << (Arg == Cmd.Filename ? "<main-file>" : llvm::StringRef(Arg))
+         << '\0';
+    OS << preambleText(FileName, Inputs, CI);
+    return Key;
+  }
+
+  std::mutex Mu;
+  llvm::StringMap<std::weak_ptr<const PreambleData>> Preambles;
+};
+
 namespace {
 
 bool isReliable(const tooling::CompileCommand &Cmd) {
@@ -428,11 +619,12 @@ public:
                  bool StorePreambleInMemory, bool RunSync,
                  PreambleThrottler *Throttler, SynchronizedTUStatus &Status,
                  TUScheduler::HeaderIncluderCache &HeaderIncluders,
+                 TUScheduler::SharedPreambleCache *SharedPreambles,
                  ASTWorker &AW)
       : FileName(FileName), Callbacks(Callbacks),
         StoreInMemory(StorePreambleInMemory), RunSync(RunSync),
         Throttler(Throttler), Status(Status), ASTPeer(AW),
-        HeaderIncluders(HeaderIncluders) {}
+        HeaderIncluders(HeaderIncluders), SharedPreambles(SharedPreambles) {}
 
   /// It isn't guaranteed that each requested version will be built. If there
   /// are multiple update requests while building a preamble, only the last one
@@ -586,6 +778,8 @@ private:
   SynchronizedTUStatus &Status;
   ASTWorker &ASTPeer;
   TUScheduler::HeaderIncluderCache &HeaderIncluders;
+  /// Null unless preambles are shared between files.
+  TUScheduler::SharedPreambleCache *SharedPreambles;
 };
 
 class ASTWorkerHandle;
@@ -605,6 +799,7 @@ class ASTWorker {
   ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
             TUScheduler::ASTCache &LRUCache,
             TUScheduler::HeaderIncluderCache &HeaderIncluders,
+            TUScheduler::SharedPreambleCache *SharedPreambles,
             Semaphore &Barrier, bool RunSync, const TUScheduler::Options &Opts,
             ParsingCallbacks &Callbacks);
 
@@ -618,6 +813,7 @@ public:
   create(PathRef FileName, const GlobalCompilationDatabase &CDB,
          TUScheduler::ASTCache &IdleASTs,
          TUScheduler::HeaderIncluderCache &HeaderIncluders,
+         TUScheduler::SharedPreambleCache *SharedPreambles,
          AsyncTaskRunner *Tasks, Semaphore &Barrier,
          const TUScheduler::Options &Opts, ParsingCallbacks &Callbacks);
   ~ASTWorker();
@@ -732,6 +928,9 @@ private:
   /// Times of recent AST rebuilds, used for UpdateDebounce computation.
   llvm::SmallVector<DebouncePolicy::clock::duration>
       RebuildTimes; /* GUARDED_BY(Mutex) */
+  /// Time it took to build the last AST, used as its cost in IdleASTs.
+  /// Only accessed by the worker thread.
+  DebouncePolicy::clock::duration LastASTBuildTime{};
   /// Set to true to signal run() to finish processing.
   bool Done;                              /* GUARDED_BY(Mutex) */
   std::deque<Request> Requests;           /* GUARDED_BY(Mutex) */
@@ -811,12 +1010,13 @@ ASTWorkerHandle
 ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
                   TUScheduler::ASTCache &IdleASTs,
                   TUScheduler::HeaderIncluderCache &HeaderIncluders,
+                  TUScheduler::SharedPreambleCache *SharedPreambles,
                   AsyncTaskRunner *Tasks, Semaphore &Barrier,
                   const TUScheduler::Options &Opts,
                   ParsingCallbacks &Callbacks) {
-  std::shared_ptr<ASTWorker> Worker(
-      new ASTWorker(FileName, CDB, IdleASTs, HeaderIncluders, Barrier,
-                    /*RunSync=*/!Tasks, Opts, Callbacks));
+  std::shared_ptr<ASTWorker> Worker(new ASTWorker(
+      FileName, CDB, IdleASTs, HeaderIncluders, SharedPreambles, Barrier,
+      /*RunSync=*/!Tasks, Opts, Callbacks));
   if (Tasks) {
     Tasks->runAsync("ASTWorker:" + llvm::sys::path::filename(FileName),
                     [Worker]() { Worker->run(); });
@@ -830,6 +1030,7 @@ ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
 ASTWorker::ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
                      TUScheduler::ASTCache &LRUCache,
                      TUScheduler::HeaderIncluderCache &HeaderIncluders,
+                     TUScheduler::SharedPreambleCache *SharedPreambles,
                      Semaphore &Barrier, bool RunSync,
                      const TUScheduler::Options &Opts,
                      ParsingCallbacks &Callbacks)
@@ -838,7 +1039,8 @@ ASTWorker::ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
       ContextProvider(Opts.ContextProvider), CDB(CDB), Callbacks(Callbacks),
       Barrier(Barrier), Done(false), Status(FileName, Callbacks),
       PreamblePeer(FileName, Callbacks, Opts.StorePreamblesInMemory, RunSync,
-                   Opts.PreambleThrottler, Status, HeaderIncluders, *this) {
+                   Opts.PreambleThrottler, Status, HeaderIncluders,
+                   SharedPreambles, *this) {
   // Set a fallback command because compile command can be accessed before
   // `Inputs` is initialized. Other fields are only used after initialization
   // from client inputs.
@@ -991,16 +1193,19 @@ void ASTWorker::runWithAST(
       // return a compatible preamble as ASTWorker::update blocks.
       std::optional<ParsedAST> NewAST;
       if (Invocation) {
+        auto RebuildStartTime = DebouncePolicy::clock::now();
         NewAST = ParsedAST::build(FileName, FileInputs, std::move(Invocation),
                                   CompilerInvocationDiagConsumer.take(),
                                   getPossiblyStalePreamble());
+        LastASTBuildTime = DebouncePolicy::clock::now() - RebuildStartTime;
         ++ASTBuildCount;
       }
       AST = NewAST ? std::make_unique<ParsedAST>(std::move(*NewAST)) : nullptr;
     }
     // Make sure we put the AST back into the LRU cache.
-    auto _ = llvm::make_scope_exit(
-        [&AST, this]() { IdleASTs.put(this, std::move(*AST)); });
+    auto _ = llvm::make_scope_exit([&AST, this]() {
+      IdleASTs.put(this, std::move(*AST), LastASTBuildTime);
+    });
     // Run the user-provided action.
     if (!*AST)
       return Action(error(llvm::errc::invalid_argument, "invalid AST"));
@@ -1075,6 +1280,19 @@ void PreambleThread::build(Request Req) {
          FileName, Inputs.Version, LatestBuild->Version);
   }
 
+  if (SharedPreambles && !Inputs.ForceRebuild) {
+    if (auto Shared = SharedPreambles->get(FileName, Inputs, *Req.CI)) {
+      vlog("Using preamble shared by another file for {0} version {1}",
+           FileName, Inputs.Version);
+      LatestBuild = std::move(Shared);
+      if (isReliable(Inputs.CompileCommand))
+        HeaderIncluders.update(FileName, LatestBuild->Includes.allHeaders());
+      // Keep the PCH available while any of the files using it is open.
+      SharedPreambles->put(FileName, Inputs, *Req.CI, LatestBuild);
+      return;
+    }
+  }
+
   ThreadCrashReporter ScopedReporter([&Inputs]() {
     llvm::errs() << "Signalled while building preamble\n";
     crashDumpParseInputs(llvm::errs(), Inputs);
@@ -1095,6 +1313,8 @@ void PreambleThread::build(Request Req) {
   reportPreambleBuild(Stats, IsFirstPreamble);
   if (isReliable(LatestBuild->CompileCommand))
     HeaderIncluders.update(FileName, LatestBuild->Includes.allHeaders());
+  if (SharedPreambles)
+    SharedPreambles->put(FileName, Inputs, *Req.CI, LatestBuild);
 }
 
 void ASTWorker::updatePreamble(std::unique_ptr<CompilerInvocation> CI,
@@ -1210,6 +1430,7 @@ void ASTWorker::generateDiagnostics(
     std::optional<ParsedAST> NewAST = ParsedAST::build(
         FileName, Inputs, std::move(Invocation), CIDiags, *LatestPreamble);
     auto RebuildDuration = DebouncePolicy::clock::now() - RebuildStartTime;
+    LastASTBuildTime = RebuildDuration;
     ++ASTBuildCount;
     // Try to record the AST-build time, to inform future update debouncing.
     // This is best-effort only: if the lock is held, don't bother.
@@ -1260,7 +1481,7 @@ void ASTWorker::generateDiagnostics(
   // queue can't reuse the AST.
   if (InputsAreLatest) {
     RanASTCallback = *AST != nullptr;
-    IdleASTs.put(this, std::move(*AST));
+    IdleASTs.put(this, std::move(*AST), LastASTBuildTime);
   }
 }
 
@@ -1291,7 +1512,7 @@ TUScheduler::FileStats ASTWorker::stats() const {
   // only, so this should be fine.
   Result.UsedBytesAST = IdleASTs.getUsedBytes(this);
   if (auto Preamble = getPossiblyStalePreamble())
-    Result.UsedBytesPreamble = Preamble->Preamble.getSize();
+    Result.UsedBytesPreamble = Preamble->Preamble->getSize();
   return Result;
 }
 
@@ -1631,9 +1852,11 @@ TUScheduler::TUScheduler(const GlobalCompilationDatabase &CDB,
       Callbacks(Callbacks ? std::move(Callbacks)
                           : std::make_unique<ParsingCallbacks>()),
       Barrier(Opts.AsyncThreadsCount), QuickRunBarrier(Opts.AsyncThreadsCount),
-      IdleASTs(
-          std::make_unique<ASTCache>(Opts.RetentionPolicy.MaxRetainedASTs)),
-      HeaderIncluders(std::make_unique<HeaderIncluderCache>()) {
+      IdleASTs(std::make_unique<ASTCache>(Opts.RetentionPolicy)),
+      HeaderIncluders(std::make_unique<HeaderIncluderCache>()),
+      SharedPreambles(Opts.SharePreambles
+                          ? std::make_unique<SharedPreambleCache>()
+                          : nullptr) {
   // Avoid null checks everywhere.
   if (!Opts.ContextProvider) {
     this->Opts.ContextProvider = [](llvm::StringRef) {
@@ -1675,7 +1898,7 @@ bool TUScheduler::update(PathRef File, ParseInputs Inputs,
   if (!FD) {
     // Create a new worker to process the AST-related tasks.
     ASTWorkerHandle Worker = ASTWorker::create(
-        File, CDB, *IdleASTs, *HeaderIncluders,
+        File, CDB, *IdleASTs, *HeaderIncluders, SharedPreambles.get(),
         WorkerThreads ? &*WorkerThreads : nullptr, Barrier, Opts, *Callbacks);
     FD = std::unique_ptr<FileData>(
         new FileData{Inputs.Contents, std::move(Worker)});
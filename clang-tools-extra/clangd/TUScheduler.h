@@ -64,6 +64,10 @@ struct ASTRetentionPolicy {
   /// Maximum number of ASTs to be retained in memory when there are no pending
   /// requests for them.
   unsigned MaxRetainedASTs = 3;
+  /// If non-zero, ASTs are also evicted while the retained ones use more than
+  /// this many bytes. ASTs that were expensive to build are kept longer.
+  /// The most recently used AST is always retained.
+  size_t MaxRetainedBytes = 0;
 };
 
 /// Clangd may wait after an update to see if another one comes along.
@@ -222,6 +226,11 @@ public:
     /// Cache (large) preamble data in RAM rather than temporary files on disk.
     bool StorePreamblesInMemory = false;
 
+    /// Let files with identical preambles (same text, directory and compile
+    /// flags) share a single PCH instead of building one each. Only preambles
+    /// that consist of include directives are shared.
+    bool SharePreambles = false;
+
     /// Time to wait after an update to see if another one comes along.
     /// This tries to ensure we rebuild once the user stops typing.
     DebouncePolicy UpdateDebounce;
@@ -345,6 +354,8 @@ public:
   class ASTCache;
   /// Tracks headers included by open files, to get known-good compile commands.
   class HeaderIncluderCache;
+  /// Tracks preambles that other open files may reuse.
+  class SharedPreambleCache;
 
   // The file being built/processed in the current thread. This is a hack in
   // order to get the file name into the index implementations. Do not depend on
@@ -368,6 +379,7 @@ private:
   llvm::StringMap<std::unique_ptr<FileData>> Files;
   std::unique_ptr<ASTCache> IdleASTs;
   std::unique_ptr<HeaderIncluderCache> HeaderIncluders;
+  std::unique_ptr<SharedPreambleCache> SharedPreambles; // may be nullptr
   // std::nullopt when running tasks synchronously and non-std::nullopt when
   // running tasks asynchronously.
   std::optional<AsyncTaskRunner> PreambleTasks;
@@ -8,6 +8,8 @@
 
 #include "../index/Serialization.h"
 #include "../index/dex/Dex.h"
+#include "../index/dex/Iterator.h"
+#include "../index/dex/PostingList.h"
 #include "benchmark/benchmark.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -91,6 +93,28 @@ static void dexQueries(benchmark::State &State) {
 }
 BENCHMARK(dexQueries);
 
+// Intersects a dense posting list with a sparse one, which is the shape of
+// most trigram queries: advanceTo() skips many chunks of the dense list and
+// decompresses only the ones that may contain a match.
+static void dexPostingListIntersection(benchmark::State &State) {
+  constexpr dex::DocID NumDocs = 1 << 22;
+  std::vector<dex::DocID> Dense, Sparse;
+  for (dex::DocID ID = 0; ID < NumDocs; ID += 3)
+    Dense.push_back(ID);
+  for (dex::DocID ID = 0; ID < NumDocs; ID += State.range(0))
+    Sparse.push_back(ID);
+  const dex::PostingList DenseList(Dense), SparseList(Sparse);
+  const dex::Corpus Corpus(NumDocs);
+  for (auto _ : State) {
+    std::vector<std::unique_ptr<dex::Iterator>> Children;
+    Children.push_back(DenseList.iterator());
+    Children.push_back(SparseList.iterator());
+    auto And = Corpus.intersect(std::move(Children));
+    benchmark::DoNotOptimize(dex::consume(*And));
+  }
+}
+BENCHMARK(dexPostingListIntersection)->Arg(7)->Arg(101)->Arg(10007);
+
 static void dexBuild(benchmark::State &State) {
   for (auto _ : State)
     buildDex();
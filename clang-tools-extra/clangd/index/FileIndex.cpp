@@ -299,14 +299,19 @@ FileSymbols::buildIndex(IndexType Type, DuplicateHandling DuplicateHandle,
   std::vector<Symbol> SymsStorage;
   switch (DuplicateHandle) {
   case DuplicateHandling::Merge: {
-    llvm::DenseMap<SymbolID, Symbol> Merged;
+    // Merge straight into SymsStorage, so that each merged symbol exists only
+    // once while the index is built.
+    llvm::DenseMap<SymbolID, size_t> Merged;
     for (const auto &Slab : SymbolSlabs) {
       for (const auto &Sym : *Slab) {
         assert(Sym.References == 0 &&
                "Symbol with non-zero references sent to FileSymbols");
-        auto I = Merged.try_emplace(Sym.ID, Sym);
-        if (!I.second)
-          I.first->second = mergeSymbol(I.first->second, Sym);
+        auto I = Merged.try_emplace(Sym.ID, SymsStorage.size());
+        if (I.second)
+          SymsStorage.push_back(Sym);
+        else
+          SymsStorage[I.first->second] =
+              mergeSymbol(SymsStorage[I.first->second], Sym);
       }
     }
     for (const RefSlab *Refs : MainFileRefs)
@@ -315,13 +320,11 @@ FileSymbols::buildIndex(IndexType Type, DuplicateHandling DuplicateHandle,
         // This might happen while background-index is still running.
         if (It == Merged.end())
           continue;
-        It->getSecond().References += Sym.second.size();
+        SymsStorage[It->second].References += Sym.second.size();
       }
-    SymsStorage.reserve(Merged.size());
-    for (auto &Sym : Merged) {
-      SymsStorage.push_back(std::move(Sym.second));
-      AllSymbols.push_back(&SymsStorage.back());
-    }
+    AllSymbols.reserve(SymsStorage.size());
+    for (const Symbol &Sym : SymsStorage)
+      AllSymbols.push_back(&Sym);
     break;
   }
   case DuplicateHandling::PickOne: {
@@ -340,24 +343,37 @@ FileSymbols::buildIndex(IndexType Type, DuplicateHandling DuplicateHandle,
   std::vector<Ref> RefsStorage; // Contiguous ranges for each SymbolID.
   llvm::DenseMap<SymbolID, llvm::ArrayRef<Ref>> AllRefs;
   {
-    llvm::DenseMap<SymbolID, llvm::SmallVector<Ref, 4>> MergedRefs;
+    // Size each symbol's range first, so that the refs are copied once,
+    // straight into their final place, instead of through per-symbol buffers.
+    // Maps each symbol to the [begin, end) range of its refs in RefsStorage.
+    llvm::DenseMap<SymbolID, std::pair<size_t, size_t>> Ranges;
     size_t Count = 0;
     for (const auto &RefSlab : RefSlabs)
       for (const auto &Sym : *RefSlab) {
-        MergedRefs[Sym.first].append(Sym.second.begin(), Sym.second.end());
+        Ranges[Sym.first].second += Sym.second.size();
         Count += Sym.second.size();
       }
-    RefsStorage.reserve(Count);
-    AllRefs.reserve(MergedRefs.size());
-    for (auto &Sym : MergedRefs) {
-      auto &SymRefs = Sym.second;
+    RefsStorage.resize(Count);
+    size_t Next = 0;
+    for (auto &SymAndRange : Ranges) {
+      size_t Size = SymAndRange.second.second;
+      SymAndRange.second = {Next, Next};
+      Next += Size;
+    }
+    for (const auto &RefSlab : RefSlabs)
+      for (const auto &Sym : *RefSlab) {
+        size_t &End = Ranges.find(Sym.first)->second.second;
+        llvm::copy(Sym.second, RefsStorage.begin() + End);
+        End += Sym.second.size();
+      }
+    AllRefs.reserve(Ranges.size());
+    for (const auto &SymAndRange : Ranges) {
+      auto [Begin, End] = SymAndRange.second;
+      llvm::MutableArrayRef<Ref> SymRefs(RefsStorage.data() + Begin,
+                                         End - Begin);
       // Sorting isn't required, but yields more stable results over rebuilds.
       llvm::sort(SymRefs);
-      llvm::copy(SymRefs, back_inserter(RefsStorage));
-      AllRefs.try_emplace(
-          Sym.first,
-          llvm::ArrayRef<Ref>(&RefsStorage[RefsStorage.size() - SymRefs.size()],
-                              SymRefs.size()));
+      AllRefs.try_emplace(SymAndRange.first, SymRefs);
     }
   }
 
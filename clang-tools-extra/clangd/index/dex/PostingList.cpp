@@ -25,7 +25,7 @@ public:
   explicit ChunkIterator(const Token *Tok, llvm::ArrayRef<Chunk> Chunks)
       : Tok(Tok), Chunks(Chunks), CurrentChunk(Chunks.begin()) {
     if (!Chunks.empty()) {
-      DecompressedChunk = CurrentChunk->decompress();
+      CurrentChunk->decompress(DecompressedChunk);
       CurrentID = DecompressedChunk.begin();
     }
   }
@@ -93,19 +93,31 @@ private:
     ++CurrentChunk;
     if (CurrentChunk == Chunks.end()) // Reached the end of PostingList.
       return;
-    DecompressedChunk = CurrentChunk->decompress();
+    CurrentChunk->decompress(DecompressedChunk);
     CurrentID = DecompressedChunk.begin();
   }
 
   /// Advances CurrentChunk to the chunk which might contain ID.
+  ///
+  /// Intersections mostly advance to nearby chunks, so this gallops forward
+  /// with doubling steps before binary searching the last step. The cost is
+  /// logarithmic in the distance moved rather than in the number of chunks
+  /// left.
   void advanceToChunk(DocID ID) {
     if ((CurrentChunk != Chunks.end() - 1) &&
         ((CurrentChunk + 1)->Head <= ID)) {
-      CurrentChunk =
-          std::partition_point(CurrentChunk + 1, Chunks.end(),
-                               [&](const Chunk &C) { return C.Head < ID; });
+      size_t Remaining = Chunks.end() - CurrentChunk;
+      size_t Low = 1, Step = 1;
+      while (Low + Step < Remaining && CurrentChunk[Low + Step].Head <= ID) {
+        Low += Step;
+        Step *= 2;
+      }
+      CurrentChunk = std::partition_point(
+          CurrentChunk + Low + 1,
+          CurrentChunk + std::min(Low + Step, Remaining),
+          [&](const Chunk &C) { return C.Head < ID; });
       --CurrentChunk;
-      DecompressedChunk = CurrentChunk->decompress();
+      CurrentChunk->decompress(DecompressedChunk);
       CurrentID = DecompressedChunk.begin();
     }
   }
@@ -181,38 +193,36 @@ std::vector<Chunk> encodeStream(llvm::ArrayRef<DocID> Documents) {
   return std::vector<Chunk>(Result); // no move, shrink-to-fit
 }
 
-/// Reads variable length DocID from the buffer and updates the buffer size. If
-/// the stream is terminated, return std::nullopt.
-std::optional<DocID> readVByte(llvm::ArrayRef<uint8_t> &Bytes) {
-  if (Bytes.front() == 0 || Bytes.empty())
-    return std::nullopt;
-  DocID Result = 0;
-  bool HasNextByte = true;
-  for (size_t Length = 0; HasNextByte && !Bytes.empty(); ++Length) {
-    assert(Length <= 5 && "Malformed VByte encoding sequence.");
-    // Write meaningful bits to the correct place in the document decoding.
-    Result |= (Bytes.front() & 0x7f) << (BitsPerEncodingByte * Length);
-    if ((Bytes.front() & 0x80) == 0)
-      HasNextByte = false;
-    Bytes = Bytes.drop_front();
-  }
-  return Result;
-}
-
 } // namespace
 
 llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Chunk::decompress() const {
-  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Result{Head};
-  llvm::ArrayRef<uint8_t> Bytes(Payload);
-  DocID Delta;
-  for (DocID Current = Head; !Bytes.empty(); Current += Delta) {
-    auto MaybeDelta = readVByte(Bytes);
-    if (!MaybeDelta)
-      break;
-    Delta = *MaybeDelta;
-    Result.push_back(Current + Delta);
+  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Result;
+  decompress(Result);
+  return Result;
+}
+
+void Chunk::decompress(llvm::SmallVectorImpl<DocID> &Out) const {
+  Out.clear();
+  Out.push_back(Head);
+  DocID Current = Head;
+  const uint8_t *Byte = Payload.begin();
+  const uint8_t *End = Payload.end();
+  // A zero byte terminates the stream: deltas are positive, so no encoding
+  // starts with one. encodeVByte never splits an encoding across the end of
+  // the payload, so a continuation bit is always followed by another byte.
+  while (Byte != End && *Byte != 0) {
+    DocID Delta = 0;
+    unsigned Shift = 0;
+    uint8_t Encoding;
+    do {
+      assert(Byte != End && Shift < 35 && "Malformed VByte encoding sequence.");
+      Encoding = *Byte++;
+      Delta |= DocID(Encoding & 0x7f) << Shift;
+      Shift += BitsPerEncodingByte;
+    } while (Encoding & 0x80);
+    Current += Delta;
+    Out.push_back(Current);
   }
-  return llvm::SmallVector<DocID, Chunk::PayloadSize + 1>{Result};
 }
 
 PostingList::PostingList(llvm::ArrayRef<DocID> Documents)
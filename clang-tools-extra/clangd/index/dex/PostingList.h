@@ -44,6 +44,9 @@ struct Chunk {
   static constexpr size_t PayloadSize = 32 - sizeof(DocID);
 
   llvm::SmallVector<DocID, PayloadSize + 1> decompress() const;
+  /// Decompresses the chunk into \p Out, replacing its contents. This avoids
+  /// allocating and copying a new buffer for each chunk.
+  void decompress(llvm::SmallVectorImpl<DocID> &Out) const;
 
   /// The first element of decompressed Chunk.
   DocID Head;
@@ -12,16 +12,21 @@
 #include "Feature.h"
 #include "Service.grpc.pb.h"
 #include "index/Index.h"
+#include "index/Symbol.h"
 #include "marshalling/Marshalling.h"
 #include "support/Logger.h"
 #include "support/Trace.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Error.h"
 
 #include <atomic>
 #include <chrono>
+#include <list>
 #include <memory>
+#include <mutex>
 
 namespace clang {
 namespace clangd {
@@ -44,6 +49,82 @@ llvm::StringRef toString(const grpc_connectivity_state &State) {
   llvm_unreachable("Not a valid grpc_connectivity_state.");
 }
 
+/// Keeps recently fetched symbols, so that the lookups issued by hover, xrefs
+/// and completion for the same few symbols don't each cost a round trip.
+/// Entries expire after a while, as the server reloads its index periodically.
+class SymbolLRU {
+public:
+  SymbolLRU(size_t Capacity, std::chrono::seconds MaxAge)
+      : Capacity(Capacity), MaxAge(MaxAge) {}
+
+  /// Calls \p Callback for every cached symbol in \p IDs and returns the IDs
+  /// that were not found.
+  llvm::DenseSet<SymbolID>
+  lookup(const llvm::DenseSet<SymbolID> &IDs,
+         llvm::function_ref<void(const clangd::Symbol &)> Callback) {
+    llvm::DenseSet<SymbolID> Missing;
+    auto Now = std::chrono::steady_clock::now();
+    std::vector<std::pair<std::shared_ptr<SymbolSlab>, const Symbol *>> Hits;
+    {
+      std::lock_guard<std::mutex> Lock(Mu);
+      for (const SymbolID &ID : IDs) {
+        auto It = Index.find(ID);
+        if (It == Index.end()) {
+          Missing.insert(ID);
+          continue;
+        }
+        if (Now - It->second->Added > MaxAge) {
+          Entries.erase(It->second);
+          Index.erase(It);
+          Missing.insert(ID);
+          continue;
+        }
+        Entries.splice(Entries.begin(), Entries, It->second);
+        Hits.emplace_back(It->second->Storage, It->second->Sym);
+      }
+    }
+    // Don't run the callback under the lock, the slabs keep it alive.
+    for (const auto &Hit : Hits)
+      Callback(*Hit.second);
+    return Missing;
+  }
+
+  void insert(SymbolSlab Symbols) {
+    auto Storage = std::make_shared<SymbolSlab>(std::move(Symbols));
+    auto Now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> Lock(Mu);
+    for (const Symbol &Sym : *Storage) {
+      auto It = Index.find(Sym.ID);
+      if (It != Index.end()) {
+        Entries.erase(It->second);
+        Index.erase(It);
+      }
+      Entries.push_front({Sym.ID, Storage, &Sym, Now});
+      Index[Sym.ID] = Entries.begin();
+    }
+    while (Entries.size() > Capacity) {
+      Index.erase(Entries.back().ID);
+      Entries.pop_back();
+    }
+  }
+
+private:
+  struct Entry {
+    SymbolID ID;
+    // Shared by all symbols received in the same reply.
+    std::shared_ptr<SymbolSlab> Storage;
+    const Symbol *Sym;
+    std::chrono::steady_clock::time_point Added;
+  };
+
+  const size_t Capacity;
+  const std::chrono::seconds MaxAge;
+  std::mutex Mu;
+  /// Most recently used first.
+  std::list<Entry> Entries;
+  llvm::DenseMap<SymbolID, std::list<Entry>::iterator> Index;
+};
+
 class IndexClient : public clangd::SymbolIndex {
   void updateConnectionStatus() const {
     auto NewStatus = Channel->GetState(/*try_to_connect=*/false);
@@ -123,14 +204,25 @@ public:
         ConnectionStatus(Channel->GetState(/*try_to_connect=*/true)),
         ProtobufMarshaller(new Marshaller(/*RemoteIndexRoot=*/"",
                                           /*LocalIndexRoot=*/ProjectRoot)),
-        DeadlineWaitingTime(DeadlineTime) {
+        DeadlineWaitingTime(DeadlineTime),
+        RecentSymbols(/*Capacity=*/1000, /*MaxAge=*/std::chrono::minutes(5)) {
     assert(!ProjectRoot.empty());
   }
 
   void lookup(const clangd::LookupRequest &Request,
               llvm::function_ref<void(const clangd::Symbol &)> Callback)
       const override {
-    streamRPC(Request, &remote::v1::SymbolIndex::Stub::Lookup, Callback);
+    clangd::LookupRequest Missing = Request;
+    Missing.IDs = RecentSymbols.lookup(Request.IDs, Callback);
+    if (Missing.IDs.empty())
+      return;
+    SymbolSlab::Builder Received;
+    streamRPC(Missing, &remote::v1::SymbolIndex::Stub::Lookup,
+              [&](const clangd::Symbol &Sym) {
+                Callback(Sym);
+                Received.insert(Sym);
+              });
+    RecentSymbols.insert(std::move(Received).build());
   }
 
   bool fuzzyFind(const clangd::FuzzyFindRequest &Request,
@@ -178,6 +270,7 @@ private:
   std::unique_ptr<Marshaller> ProtobufMarshaller;
   // Each request will be terminated if it takes too long.
   std::chrono::milliseconds DeadlineWaitingTime;
+  mutable SymbolLRU RecentSymbols;
 };
 
 } // namespace
@@ -513,6 +513,24 @@ opt<bool> PreambleParseForwardingFunctions{
     init(ParseOptions().PreambleParseForwardingFunctions),
 };
 
+opt<bool> SharePreambles{
+    "experimental-share-preambles",
+    cat(Misc),
+    desc("Share one preamble between open files that start with the same "
+         "includes and use the same compile flags"),
+    Hidden,
+    init(ClangdServer::Options().SharePreambles),
+};
+
+opt<unsigned> RetainedASTMemoryLimit{
+    "retained-ast-memory-limit",
+    cat(Misc),
+    desc("Maximum memory in MB used by ASTs of idle files kept for reuse. "
+         "0 means no limit besides the number of ASTs"),
+    Hidden,
+    init(0),
+};
+
 #if defined(__GLIBC__) && CLANGD_MALLOC_TRIM
 opt<bool> EnableMallocTrim{
     "malloc-trim",
@@ -871,6 +889,9 @@ clangd accepts flags on the commandline, and in the CLANGD_FLAGS environment var
     Opts.StorePreamblesInMemory = false;
     break;
   }
+  Opts.SharePreambles = SharePreambles;
+  Opts.RetentionPolicy.MaxRetainedBytes =
+      size_t(RetainedASTMemoryLimit) * 1024 * 1024;
   if (!ResourceDir.empty())
     Opts.ResourceDir = ResourceDir;
   Opts.BuildDynamicSymbolIndex = true;
@@ -86,7 +86,7 @@ collectPatchedIncludes(llvm::StringRef ModifiedContents,
   // behaviour.
   auto Bounds = Lexer::ComputePreamble(ModifiedContents, CI->getLangOpts());
   auto Clang =
-      prepareCompilerInstance(std::move(CI), &BaselinePreamble->Preamble,
+      prepareCompilerInstance(std::move(CI), BaselinePreamble->Preamble.get(),
                               llvm::MemoryBuffer::getMemBufferCopy(
                                   ModifiedContents.slice(0, Bounds.Size).str()),
                               PI.TFS->view(PI.CompileCommand.Directory), Diags);
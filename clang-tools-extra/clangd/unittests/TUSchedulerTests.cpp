@@ -49,6 +49,7 @@ namespace clang {
 namespace clangd {
 namespace {
 
+using ::testing::_;
 using ::testing::AllOf;
 using ::testing::AnyOf;
 using ::testing::Contains;
@@ -643,6 +644,25 @@ TEST_F(TUSchedulerTests, EvictedAST) {
               UnorderedElementsAre(Foo, AnyOf(Bar, Baz)));
 }
 
+TEST_F(TUSchedulerTests, EvictedASTOverMemoryBudget) {
+  auto Opts = optsForTest();
+  Opts.AsyncThreadsCount = 1;
+  Opts.RetentionPolicy.MaxRetainedASTs = 10;
+  // Any AST is over this budget, so only the latest one can be retained.
+  Opts.RetentionPolicy.MaxRetainedBytes = 1;
+  TUScheduler S(CDB, Opts);
+
+  auto Foo = testPath("foo.cpp");
+  auto Bar = testPath("bar.cpp");
+  updateWithCallback(S, Foo, "int a;", WantDiagnostics::Yes, [] {});
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(60)));
+  EXPECT_THAT(S.getFilesWithCachedAST(), UnorderedElementsAre(Foo));
+
+  updateWithCallback(S, Bar, "int b;", WantDiagnostics::Yes, [] {});
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(60)));
+  EXPECT_THAT(S.getFilesWithCachedAST(), UnorderedElementsAre(Bar));
+}
+
 // We send "empty" changes to TUScheduler when we think some external event
 // *might* have invalidated current state (e.g. a header was edited).
 // Verify that this doesn't evict our cache entries.
@@ -693,7 +713,7 @@ TEST_F(TUSchedulerTests, EmptyPreamble) {
       [&](Expected<InputsAndPreamble> Preamble) {
         // We expect to get a non-empty preamble.
         EXPECT_GT(
-            cantFail(std::move(Preamble)).Preamble->Preamble.getBounds().Size,
+            cantFail(std::move(Preamble)).Preamble->Preamble->getBounds().Size,
             0u);
       });
   // Wait while the preamble is being built.
@@ -708,11 +728,105 @@ TEST_F(TUSchedulerTests, EmptyPreamble) {
       [&](Expected<InputsAndPreamble> Preamble) {
         // We expect to get an empty preamble.
         EXPECT_EQ(
-            cantFail(std::move(Preamble)).Preamble->Preamble.getBounds().Size,
+            cantFail(std::move(Preamble)).Preamble->Preamble->getBounds().Size,
             0u);
       });
 }
 
+TEST_F(TUSchedulerTests, SharedPreambles) {
+  auto Opts = optsForTest();
+  Opts.SharePreambles = true;
+  TUScheduler S(CDB, Opts, captureDiags());
+
+  auto Foo = testPath("foo.cpp");
+  auto Bar = testPath("bar.cpp");
+  auto Baz = testPath("sub/baz.cpp");
+  auto Header = testPath("foo.h");
+  FS.Files[Header] = "void foo();";
+  FS.Files[testPath("sub/foo.h")] = "void foo();";
+  auto GetPreamble = [&](PathRef File) {
+    std::shared_ptr<const PreambleData> Result;
+    S.runWithPreamble("getPreamble", File, TUScheduler::Stale,
+                      [&](Expected<InputsAndPreamble> Preamble) {
+                        auto *P = cantFail(std::move(Preamble)).Preamble;
+                        // Keep the per-file data alive for the checks below.
+                        if (P)
+                          Result = std::shared_ptr<const PreambleData>(
+                              std::make_shared<PreambleData>(*P));
+                      });
+    EXPECT_TRUE(S.blockUntilIdle(timeoutSeconds(60)));
+    return Result;
+  };
+
+  S.update(Foo, getInputs(Foo, "#include \"foo.h\"\nint x;"),
+           WantDiagnostics::Auto);
+  auto FooPreamble = GetPreamble(Foo);
+  ASSERT_TRUE(FooPreamble);
+
+  // Same preamble text, directory and flags: the PCH is shared, but the
+  // preamble describes bar.cpp.
+  std::vector<Diag> BarDiags;
+  auto BarInputs = getInputs(Bar, "#include \"foo.h\"\nint y = undeclared;");
+  BarInputs.Version = "bar-1";
+  updateWithDiags(S, Bar, BarInputs, WantDiagnostics::Yes,
+                  [&](std::vector<Diag> Diags) { BarDiags = std::move(Diags); });
+  auto BarPreamble = GetPreamble(Bar);
+  ASSERT_TRUE(BarPreamble);
+  EXPECT_EQ(BarPreamble->Preamble, FooPreamble->Preamble);
+  EXPECT_EQ(BarPreamble->Version, "bar-1");
+  EXPECT_EQ(BarPreamble->CompileCommand.Filename, Bar);
+  EXPECT_EQ(BarPreamble->Includes.getRealPath(IncludeStructure::MainFileID),
+            Bar);
+  EXPECT_EQ(S.fileStats().lookup(Bar).PreambleBuilds, 1u);
+
+  // Diagnostics and includes of bar.cpp refer to bar.cpp itself.
+  EXPECT_THAT(BarDiags,
+              ElementsAre(AllOf(
+                  Field(&Diag::Message,
+                        "use of undeclared identifier 'undeclared'"),
+                  Field(&Diag::File, Bar), Field(&Diag::InsideMainFile, true),
+                  Field(&Diag::Range, Range{{1, 8}, {1, 18}}))));
+  S.runWithAST("includes", Bar, [&](Expected<InputsAndAST> AST) {
+    auto &Includes = cantFail(std::move(AST)).AST.getIncludeStructure();
+    ASSERT_THAT(Includes.MainFileIncludes, SizeIs(1));
+    EXPECT_EQ(Includes.MainFileIncludes[0].Resolved, Header);
+    EXPECT_EQ(Includes.MainFileIncludes[0].HashLine, 0);
+    EXPECT_THAT(Includes.includeDepth(),
+                UnorderedElementsAre(Pair(IncludeStructure::MainFileID, 0u),
+                                     Pair(_, 1u)));
+  });
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(60)));
+
+  // Editing bar.cpp after the preamble section keeps using the shared PCH.
+  S.update(Bar, getInputs(Bar, "#include \"foo.h\"\nint y = 1;"),
+           WantDiagnostics::Auto);
+  EXPECT_EQ(GetPreamble(Bar)->Preamble, FooPreamble->Preamble);
+  EXPECT_EQ(S.fileStats().lookup(Bar).PreambleBuilds, 1u);
+
+  // "foo.h" may resolve to a different file from another directory.
+  S.update(Baz, getInputs(Baz, "#include \"foo.h\"\nint z;"),
+           WantDiagnostics::Auto);
+  EXPECT_NE(GetPreamble(Baz)->Preamble, FooPreamble->Preamble);
+
+  // Preambles with anything but includes are not shared.
+  auto Qux = testPath("qux.cpp");
+  auto Quux = testPath("quux.cpp");
+  S.update(Qux, getInputs(Qux, "#pragma once\n#include \"foo.h\"\nint a;"),
+           WantDiagnostics::Auto);
+  S.update(Quux,
+           getInputs(Quux, "#pragma once\n#include \"foo.h\"\nint b;"),
+           WantDiagnostics::Auto);
+  EXPECT_NE(GetPreamble(Quux)->Preamble, GetPreamble(Qux)->Preamble);
+
+  // Changing the header invalidates the shared preamble.
+  FS.Files[Header] = "void foo(); void bar();";
+  FS.Timestamps[Header] = time_t(1);
+  S.remove(Bar);
+  S.update(Bar, getInputs(Bar, "#include \"foo.h\"\nint y;"),
+           WantDiagnostics::Auto);
+  EXPECT_NE(GetPreamble(Bar)->Preamble, FooPreamble->Preamble);
+}
+
 TEST_F(TUSchedulerTests, ASTSignalsSmokeTests) {
   TUScheduler S(CDB, optsForTest());
   auto Foo = testPath("foo.cpp");
@@ -0,0 +1,49 @@
+// RUN: rm -rf %t
+// RUN: split-file %s %t
+// RUN: clang-tidy --share-preambles -checks='-*,modernize-use-nullptr' \
+// RUN:   %t/a.cpp %t/b.cpp %t/c.cpp -- -std=c++11 -I%t 2>&1 \
+// RUN:   | FileCheck %s -implicit-check-not='{{warning|error}}:'
+//
+// The same files give the same warnings without a shared preamble.
+// RUN: clang-tidy -checks='-*,modernize-use-nullptr' \
+// RUN:   %t/a.cpp %t/b.cpp %t/c.cpp -- -std=c++11 -I%t 2>&1 \
+// RUN:   | FileCheck %s -implicit-check-not='{{warning|error}}:'
+
+// a.cpp and b.cpp share the preamble built for a.cpp; c.cpp starts with
+// different includes and gets its own. The declarations and macros of the
+// preamble must still be visible in each main file.
+// CHECK-DAG: a.cpp:4:15: warning: use nullptr [modernize-use-nullptr]
+// CHECK-DAG: b.cpp:4:15: warning: use nullptr [modernize-use-nullptr]
+// CHECK-DAG: c.cpp:5:15: warning: use nullptr [modernize-use-nullptr]
+
+//--- common.h
+#define POINTER int *
+struct Common { int X; };
+
+//--- other.h
+struct Other { int Y; };
+
+//--- a.cpp
+#include "common.h"
+
+void a(Common &C) {
+  POINTER P = 0;
+  C.X = 1;
+}
+
+//--- b.cpp
+#include "common.h"
+
+void b(Common &C) {
+  POINTER Q = 0;
+  C.X = 2;
+}
+
+//--- c.cpp
+#include "common.h"
+#include "other.h"
+
+void c(Common &C, Other &O) {
+  POINTER R = 0;
+  C.X = O.Y;
+}
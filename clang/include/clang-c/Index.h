@@ -34,7 +34,7 @@
  * compatible, thus CINDEX_VERSION_MAJOR is expected to remain stable.
  */
 #define CINDEX_VERSION_MAJOR 0
-#define CINDEX_VERSION_MINOR 64
+#define CINDEX_VERSION_MINOR 65
 
 #define CINDEX_VERSION_ENCODE(major, minor) (((major)*10000) + ((minor)*1))
 
@@ -912,6 +912,57 @@ CINDEX_LINKAGE enum CXErrorCode clang_parseTranslationUnit2FullArgv(
     struct CXUnsavedFile *unsaved_files, unsigned num_unsaved_files,
     unsigned options, CXTranslationUnit *out_TU);
 
+/**
+ * Parse several translation units concurrently.
+ *
+ * Each translation unit is parsed like with
+ * \c clang_parseTranslationUnit2FullArgv(), but up to \c num_threads of them
+ * are parsed at the same time on worker threads. This is safe as long as no
+ * other thread uses \c CIdx or the translation units being created until the
+ * function returns.
+ *
+ * \param CIdx The index object with which the translation units will be
+ * associated.
+ *
+ * \param num_translation_units The number of translation units to parse; the
+ * size of \p source_filenames, \p command_line_args,
+ * \p num_command_line_args, \p out_TUs and \p out_errors.
+ *
+ * \param source_filenames The source file of each translation unit. Entries
+ * may be NULL, see \c clang_parseTranslationUnit2FullArgv().
+ *
+ * \param command_line_args The full command line of each translation unit,
+ * including argv[0].
+ *
+ * \param num_command_line_args The number of arguments of each command line.
+ *
+ * \param unsaved_files The files that have not yet been saved to disk, shared
+ * by all translation units.
+ *
+ * \param num_unsaved_files The number of unsaved file entries.
+ *
+ * \param options A bitmask of options that affects how the translation units
+ * are managed, see \c CXTranslationUnit_Flags.
+ *
+ * \param num_threads The maximum number of translation units parsed at a
+ * time. Zero means one per hardware thread.
+ *
+ * \param[out] out_TUs Receives the translation units, with NULL for the ones
+ * that failed to parse.
+ *
+ * \param[out] out_errors Receives the error code of each translation unit.
+ *
+ * \returns CXError_Success if all translation units were parsed, otherwise
+ * the error code of the first one that failed, or CXError_InvalidArguments.
+ */
+CINDEX_LINKAGE enum CXErrorCode clang_parseTranslationUnits(
+    CXIndex CIdx, unsigned num_translation_units,
+    const char *const *source_filenames,
+    const char *const *const *command_line_args,
+    const int *num_command_line_args, struct CXUnsavedFile *unsaved_files,
+    unsigned num_unsaved_files, unsigned options, unsigned num_threads,
+    CXTranslationUnit *out_TUs, enum CXErrorCode *out_errors);
+
 /**
  * Flags that control how translation units are saved.
  *
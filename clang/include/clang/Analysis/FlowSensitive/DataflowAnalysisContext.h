@@ -183,6 +183,9 @@ public:
   /// included in `Constraints` to provide contextually-accurate results, e.g.
   /// if any definitions or relationships of the values in `Constraints` have
   /// been stored in flow conditions.
+  ///
+  /// Results are cached, so repeating a query does not invoke the solver again
+  /// unless it previously timed out.
   Solver::Result querySolver(llvm::SetVector<const Formula *> Constraints);
 
   /// Returns the fields of `Type`, limited to the set of fields modeled by this
@@ -255,6 +258,10 @@ private:
   std::unique_ptr<Solver> OwnedSolver;
   std::unique_ptr<Arena> A;
 
+  // Solver results for previous queries, keyed by the conjunction of their
+  // constraints.
+  llvm::DenseMap<const Formula *, Solver::Result> SolverResults;
+
   // Maps from program declarations and statements to storage locations that are
   // assigned to them. These assignments are global (aggregated across all basic
   // blocks) and are used to produce stable storage locations when the same
@@ -132,6 +132,9 @@ class Compilation {
   /// Whether to keep temporary files regardless of -save-temps.
   bool ForceKeepTempFiles = false;
 
+  /// The maximum number of independent jobs to run concurrently (-j).
+  unsigned ParallelJobs = 1;
+
 public:
   Compilation(const Driver &D, const ToolChain &DefaultToolChain,
               llvm::opt::InputArgList *Args,
@@ -236,6 +239,10 @@ public:
     PostCallback = CB;
   }
 
+  /// Set the maximum number of independent jobs ExecuteJobs may run at once.
+  void setParallelJobs(unsigned N) { ParallelJobs = N; }
+  unsigned getParallelJobs() const { return ParallelJobs; }
+
   /// Returns the sysroot path.
   StringRef getSysRoot() const;
 
@@ -303,6 +310,13 @@ public:
                       const JobAction *JA,
                       bool IssueErrors = false) const;
 
+  /// LogCommand - Print the command line for \p C if -v or CC_PRINT_OPTIONS
+  /// asked for it.
+  ///
+  /// \return Non-zero if the log file could not be opened, in which case
+  /// \p FailingCommand is set to \p C.
+  int LogCommand(const Command &C, const Command *&FailingCommand) const;
+
   /// ExecuteCommand - Execute an actual command.
   ///
   /// \param FailingCommand - For non-zero results, this will be set to the
@@ -324,6 +338,14 @@ public:
               SmallVectorImpl<std::pair<int, const Command *>> &FailingCommands,
               bool LogOnly = false) const;
 
+  /// ExecuteJobsInParallel - Execute \p Jobs on up to ParallelJobs threads,
+  /// starting each job once the jobs producing its inputs have finished. The
+  /// output of each job is buffered and replayed in job order so the result
+  /// is the same as running them sequentially.
+  void ExecuteJobsInParallel(
+      const JobList &Jobs,
+      SmallVectorImpl<std::pair<int, const Command *>> &FailingCommands) const;
+
   /// initCompilationForDiagnostics - Remove stale state and suppress output
   /// so compilation can be reexecuted to generate additional diagnostic
   /// information (e.g., preprocessed source(s)).
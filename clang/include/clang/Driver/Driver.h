@@ -829,6 +829,11 @@ bool isOptimizationLevelFast(const llvm::opt::ArgList &Args);
 /// \return True if the argument combination will end up generating remarks.
 bool willEmitRemarks(const llvm::opt::ArgList &Args);
 
+/// \return True if an input of type \p InputTy should get a reduced BMI,
+/// i.e. it is a C++20 named module unit and either -fmodules-reduced-bmi was
+/// given, or neither -fno-modules-reduced-bmi nor --precompile was.
+bool willEmitReducedBMI(const llvm::opt::ArgList &Args, types::ID InputTy);
+
 /// Returns the driver mode option's value, i.e. `X` in `--driver-mode=X`. If \p
 /// Args doesn't mention one explicitly, tries to deduce from `ProgName`.
 /// Returns empty on failure.
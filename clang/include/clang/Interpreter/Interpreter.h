@@ -52,6 +52,18 @@ public:
 
   void SetTargetTriple(std::string TT) { TargetTriple = TT; }
 
+  /// Make the compiler instances created by CreateCpp() start from the
+  /// declarations of the C++ header \p Header. The header is precompiled into
+  /// \p PCHPath with the builder's arguments if that file is missing or older
+  /// than \p Header, so that later sessions only need to load the PCH.
+  ///
+  /// Only the modification time of \p Header is compared; remove \p PCHPath
+  /// when a header that \p Header includes changes.
+  void SetPrelude(llvm::StringRef Header, llvm::StringRef PCHPath) {
+    PreludeHeader = Header.str();
+    PreludePCH = PCHPath.str();
+  }
+
   // General C++
   llvm::Expected<std::unique_ptr<CompilerInstance>> CreateCpp();
 
@@ -70,9 +82,15 @@ private:
 
   llvm::Expected<std::unique_ptr<CompilerInstance>> createCuda(bool device);
 
+  llvm::Error buildPrelude(std::string TT,
+                           std::vector<const char *> ClangArgv) const;
+
   std::vector<const char *> UserArgs;
   std::optional<std::string> TargetTriple;
 
+  std::string PreludeHeader;
+  std::string PreludePCH;
+
   llvm::StringRef OffloadArch;
   llvm::StringRef CudaSDKPath;
 };
@@ -9634,6 +9634,52 @@ public:
       bool PartialOverloading = false,
       llvm::function_ref<bool()> CheckNonDependent = [] { return false; });
 
+  /// A failed substitution of deduced template arguments into the
+  /// declaration of a function template. These are remembered so that
+  /// deduction against the same template with the same arguments can fail
+  /// without performing the substitution again.
+  struct FailedDeductionSubstitution : llvm::FoldingSetNode {
+    FailedDeductionSubstitution(const FunctionTemplateDecl *Template,
+                                ArrayRef<TemplateArgument> Args,
+                                unsigned DeclGeneration,
+                                unsigned ModuleGeneration)
+        : Template(Template), Args(Args), DeclGeneration(DeclGeneration),
+          ModuleGeneration(ModuleGeneration) {}
+
+    const FunctionTemplateDecl *Template;
+    /// The canonical template arguments. These are owned by the ASTContext.
+    ArrayRef<TemplateArgument> Args;
+    /// The values of Sema::DeclarationGeneration and of the visible module
+    /// set's generation when the failure was recorded. The entry is stale
+    /// once either of them has changed.
+    unsigned DeclGeneration;
+    unsigned ModuleGeneration;
+    /// The diagnostic that explains the failure, if any.
+    std::optional<PartialDiagnosticAt> Diag;
+
+    void Profile(llvm::FoldingSetNodeID &ID, const ASTContext &C) {
+      Profile(ID, C, Template, Args);
+    }
+    static void Profile(llvm::FoldingSetNodeID &ID, const ASTContext &C,
+                        const FunctionTemplateDecl *Template,
+                        ArrayRef<TemplateArgument> Args);
+  };
+
+  /// Failed substitutions of deduced template arguments, see
+  /// FailedDeductionSubstitution.
+  llvm::ContextualFoldingSet<FailedDeductionSubstitution, const ASTContext &>
+      FailedDeductionSubstitutions;
+
+  /// Incremented whenever a declaration that could change the outcome of a
+  /// template argument substitution becomes visible, a class is completed, or
+  /// a function body, variable initializer or default member initializer is
+  /// attached to a declaration that is already visible.
+  unsigned DeclarationGeneration = 0;
+
+  /// Statistics about FailedDeductionSubstitutions, see PrintStats().
+  unsigned NumDeductionSubstitutionCacheHits = 0;
+  unsigned NumDeductionSubstitutionCacheMisses = 0;
+
   TemplateDeductionResult DeduceTemplateArguments(
       FunctionTemplateDecl *FunctionTemplate,
       TemplateArgumentListInfo *ExplicitTemplateArgs, ArrayRef<Expr *> Args,
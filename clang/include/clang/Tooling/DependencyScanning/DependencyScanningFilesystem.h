@@ -220,9 +220,21 @@ public:
   CacheShard &getShardForFilename(StringRef Filename) const;
   CacheShard &getShardForUID(llvm::sys::fs::UniqueID UID) const;
 
+  /// Sets the directory in which scanned directive tokens are persisted, so
+  /// that they can be reused by other scanning processes. Entries are keyed by
+  /// a hash of the file contents. An empty path disables persistence.
+  void setDirectivesCachePath(StringRef Path) {
+    DirectivesCachePath = Path.str();
+  }
+
+  /// Returns the directory used to persist directive tokens, or an empty
+  /// string if they are not persisted.
+  StringRef getDirectivesCachePath() const { return DirectivesCachePath; }
+
 private:
   std::unique_ptr<CacheShard[]> CacheShards;
   unsigned NumShards;
+  std::string DirectivesCachePath;
 };
 
 /// This class is a local cache, that caches the 'stat' and 'open' calls to the
@@ -22,6 +22,7 @@
 #include "clang/Analysis/FlowSensitive/Value.h"
 #include "llvm/ADT/SetOperations.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FileSystem.h"
@@ -33,6 +34,12 @@
 #include <utility>
 #include <vector>
 
+#define DEBUG_TYPE "dataflow"
+
+STATISTIC(NumSolverQueries, "Number of satisfiability queries");
+STATISTIC(NumSolverQueryCacheHits,
+          "Number of satisfiability queries answered from the cache");
+
 static llvm::cl::opt<std::string> DataflowLog(
     "dataflow-log", llvm::cl::Hidden, llvm::cl::ValueOptional,
     llvm::cl::desc("Emit log of dataflow analysis. With no arg, writes textual "
@@ -170,7 +177,26 @@ DataflowAnalysisContext::joinFlowConditions(Atom FirstToken,
 
 Solver::Result DataflowAnalysisContext::querySolver(
     llvm::SetVector<const Formula *> Constraints) {
-  return S.solve(Constraints.getArrayRef());
+  ++NumSolverQueries;
+  // Formulas are interned, so the conjunction of the constraints, built in a
+  // canonical order, identifies the query.
+  llvm::SmallVector<const Formula *> Sorted(Constraints.begin(),
+                                            Constraints.end());
+  llvm::sort(Sorted);
+  const Formula *Query = &arena().makeLiteral(true);
+  for (const Formula *F : Sorted)
+    Query = &arena().makeAnd(*Query, *F);
+  if (auto It = SolverResults.find(Query); It != SolverResults.end()) {
+    ++NumSolverQueryCacheHits;
+    return It->second;
+  }
+
+  Solver::Result Result = S.solve(Constraints.getArrayRef());
+  // Whether the solver times out depends on its remaining budget rather than
+  // on the query alone.
+  if (Result.getStatus() != Solver::Result::Status::TimedOut)
+    SolverResults.try_emplace(Query, Result);
+  return Result;
 }
 
 bool DataflowAnalysisContext::flowConditionImplies(Atom Token,
@@ -25,6 +25,15 @@
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Statistic.h"
+
+#define DEBUG_TYPE "dataflow"
+
+STATISTIC(NumSolverCalls, "Number of non-trivial calls to the SAT solver");
+STATISTIC(NumSolverIterations,
+          "Number of iterations spent in the main loop of the SAT solver");
+STATISTIC(NumSolverTimeouts,
+          "Number of SAT solver calls that exhausted the work limit");
 
 
 namespace clang {
@@ -787,7 +796,11 @@ Solver::Result
 WatchedLiteralsSolver::solve(llvm::ArrayRef<const Formula *> Vals) {
   if (Vals.empty())
     return Solver::Result::Satisfiable({{}});
+  ++NumSolverCalls;
   auto [Res, Iterations] = WatchedLiteralsSolverImpl(Vals).solve(MaxIterations);
+  NumSolverIterations += MaxIterations - Iterations;
+  if (Res.getStatus() == Solver::Result::Status::TimedOut)
+    ++NumSolverTimeouts;
   MaxIterations = Iterations;
   return Res;
 }
@@ -2799,26 +2799,66 @@ llvm::Value *CodeGenFunction::FormX86ResolverCondition(
   return Condition;
 }
 
+static void CreateMultiVersionResolverTailCall(llvm::Function *Resolver,
+                                               CGBuilderTy &Builder,
+                                               llvm::Value *Callee) {
+  llvm::SmallVector<llvm::Value *, 10> Args(
+      llvm::make_pointer_range(Resolver->args()));
+
+  llvm::CallInst *Result =
+      Builder.CreateCall(Resolver->getFunctionType(), Callee, Args);
+  Result->setTailCallKind(llvm::CallInst::TCK_MustTail);
+
+  if (Resolver->getReturnType()->isVoidTy())
+    Builder.CreateRetVoid();
+  else
+    Builder.CreateRet(Result);
+}
+
 static void CreateMultiVersionResolverReturn(CodeGenModule &CGM,
                                              llvm::Function *Resolver,
                                              CGBuilderTy &Builder,
                                              llvm::Function *FuncToReturn,
-                                             bool SupportsIFunc) {
+                                             bool SupportsIFunc,
+                                             llvm::GlobalVariable *Cache) {
   if (SupportsIFunc) {
     Builder.CreateRet(FuncToReturn);
     return;
   }
 
-  llvm::SmallVector<llvm::Value *, 10> Args(
-      llvm::make_pointer_range(Resolver->args()));
+  if (Cache)
+    Builder
+        .CreateAlignedStore(FuncToReturn, Cache, CGM.getPointerAlign())
+        ->setAtomic(llvm::AtomicOrdering::Monotonic);
 
-  llvm::CallInst *Result = Builder.CreateCall(FuncToReturn, Args);
-  Result->setTailCallKind(llvm::CallInst::TCK_MustTail);
+  CreateMultiVersionResolverTailCall(Resolver, Builder, FuncToReturn);
+}
 
-  if (Resolver->getReturnType()->isVoidTy())
-    Builder.CreateRetVoid();
-  else
-    Builder.CreateRet(Result);
+/// Without IFUNC support the resolver runs on every call of the multiversioned
+/// function, so remember the version it selected in a variable private to the
+/// resolver. Emits the check of that variable at the start of the resolver and
+/// leaves the builder in the block doing the selection.
+llvm::GlobalVariable *
+CodeGenFunction::EmitMultiVersionResolverCache(llvm::Function *Resolver) {
+  llvm::PointerType *PtrTy = Resolver->getType();
+  auto *Cache = new llvm::GlobalVariable(
+      CGM.getModule(), PtrTy, /*isConstant=*/false,
+      llvm::GlobalValue::InternalLinkage, llvm::ConstantPointerNull::get(PtrTy),
+      Resolver->getName() + ".cache");
+  Cache->setAlignment(CGM.getPointerAlign().getAsAlign());
+
+  llvm::LoadInst *Cached =
+      Builder.CreateAlignedLoad(PtrTy, Cache, CGM.getPointerAlign());
+  Cached->setAtomic(llvm::AtomicOrdering::Monotonic);
+  llvm::BasicBlock *CachedBlock = createBasicBlock("resolver_cached", Resolver);
+  llvm::BasicBlock *SelectBlock = createBasicBlock("resolver_select", Resolver);
+  Builder.CreateCondBr(Builder.CreateIsNotNull(Cached), CachedBlock,
+                       SelectBlock);
+
+  Builder.SetInsertPoint(CachedBlock);
+  CreateMultiVersionResolverTailCall(Resolver, Builder, Cached);
+  Builder.SetInsertPoint(SelectBlock);
+  return Cache;
 }
 
 void CodeGenFunction::EmitMultiVersionResolver(
@@ -2859,7 +2899,7 @@ void CodeGenFunction::EmitAArch64MultiVersionResolver(
     // The 'default' or 'all features enabled' case.
     if (!Condition) {
       CreateMultiVersionResolverReturn(CGM, Resolver, Builder, RO.Function,
-                                       SupportsIFunc);
+                                       SupportsIFunc, /*Cache=*/nullptr);
       return;
     }
 
@@ -2873,7 +2913,7 @@ void CodeGenFunction::EmitAArch64MultiVersionResolver(
     llvm::BasicBlock *RetBlock = createBasicBlock("resolver_return", Resolver);
     CGBuilderTy RetBuilder(*this, RetBlock);
     CreateMultiVersionResolverReturn(CGM, Resolver, RetBuilder, RO.Function,
-                                     SupportsIFunc);
+                                     SupportsIFunc, /*Cache=*/nullptr);
     CurBlock = createBasicBlock("resolver_else", Resolver);
     Builder.CreateCondBr(Condition, RetBlock, CurBlock);
   }
@@ -2895,6 +2935,11 @@ void CodeGenFunction::EmitX86MultiVersionResolver(
   // Main function's basic block.
   llvm::BasicBlock *CurBlock = createBasicBlock("resolver_entry", Resolver);
   Builder.SetInsertPoint(CurBlock);
+  llvm::GlobalVariable *Cache = nullptr;
+  if (!SupportsIFunc) {
+    Cache = EmitMultiVersionResolverCache(Resolver);
+    CurBlock = Builder.GetInsertBlock();
+  }
   EmitX86CpuInit();
 
   for (const MultiVersionResolverOption &RO : Options) {
@@ -2906,14 +2951,14 @@ void CodeGenFunction::EmitX86MultiVersionResolver(
       assert(&RO == Options.end() - 1 &&
              "Default or Generic case must be last");
       CreateMultiVersionResolverReturn(CGM, Resolver, Builder, RO.Function,
-                                       SupportsIFunc);
+                                       SupportsIFunc, Cache);
       return;
     }
 
     llvm::BasicBlock *RetBlock = createBasicBlock("resolver_return", Resolver);
     CGBuilderTy RetBuilder(*this, RetBlock);
     CreateMultiVersionResolverReturn(CGM, Resolver, RetBuilder, RO.Function,
-                                     SupportsIFunc);
+                                     SupportsIFunc, Cache);
     CurBlock = createBasicBlock("resolver_else", Resolver);
     Builder.CreateCondBr(Condition, RetBlock, CurBlock);
   }
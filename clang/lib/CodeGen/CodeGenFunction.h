@@ -5238,6 +5238,8 @@ public:
                                   ArrayRef<MultiVersionResolverOption> Options);
 
 private:
+  llvm::GlobalVariable *EmitMultiVersionResolverCache(llvm::Function *Resolver);
+
   QualType getVarArgType(const Expr *Arg);
 
   void EmitDeclMetadata();
@@ -15,15 +15,25 @@
 #include "clang/Driver/Options.h"
 #include "clang/Driver/ToolChain.h"
 #include "clang/Driver/Util.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Option/ArgList.h"
 #include "llvm/Option/OptSpecifier.h"
 #include "llvm/Option/Option.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/TargetParser/Triple.h"
 #include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <system_error>
 #include <utility>
@@ -160,9 +170,8 @@ bool Compilation::CleanupFileMap(const ArgStringMap &Files,
   return Success;
 }
 
-int Compilation::ExecuteCommand(const Command &C,
-                                const Command *&FailingCommand,
-                                bool LogOnly) const {
+int Compilation::LogCommand(const Command &C,
+                            const Command *&FailingCommand) const {
   if ((getDriver().CCPrintOptions ||
        getArgs().hasArg(options::OPT_v)) && !getDriver().CCGenDiagnostics) {
     raw_ostream *OS = &llvm::errs();
@@ -190,6 +199,14 @@ int Compilation::ExecuteCommand(const Command &C,
 
     C.Print(*OS, "\n", /*Quote=*/getDriver().CCPrintOptions);
   }
+  return 0;
+}
+
+int Compilation::ExecuteCommand(const Command &C,
+                                const Command *&FailingCommand,
+                                bool LogOnly) const {
+  if (int Res = LogCommand(C, FailingCommand))
+    return Res;
 
   if (LogOnly)
     return 0;
@@ -242,6 +259,11 @@ static bool InputsOk(const Command &C,
 void Compilation::ExecuteJobs(const JobList &Jobs,
                               FailingCommandList &FailingCommands,
                               bool LogOnly) const {
+  if (ParallelJobs > 1 && Jobs.size() > 1 && !LogOnly && !ForDiagnostics &&
+      !TheDriver.IsCLMode() && Redirects.empty() &&
+      llvm::llvm_is_multithreaded())
+    return ExecuteJobsInParallel(Jobs, FailingCommands);
+
   // According to UNIX standard, driver need to continue compiling all the
   // inputs on the command line even one of them failed.
   // In all but CLMode, execute all the jobs unless the necessary inputs for the
@@ -259,6 +281,163 @@ void Compilation::ExecuteJobs(const JobList &Jobs,
   }
 }
 
+/// Print the contents of the captured output file \p Path to \p OS and remove
+/// it.
+static void replayCapturedOutput(StringRef Path, raw_ostream &OS) {
+  if (Path.empty())
+    return;
+  if (auto Buf = llvm::MemoryBuffer::getFile(Path))
+    OS << (*Buf)->getBuffer();
+  OS.flush();
+  llvm::sys::fs::remove(Path);
+}
+
+void Compilation::ExecuteJobsInParallel(
+    const JobList &Jobs, FailingCommandList &FailingCommands) const {
+  struct JobState {
+    const Command *Cmd = nullptr;
+    /// Indices of earlier jobs that produce the inputs of this one.
+    SmallVector<unsigned, 4> Deps;
+    /// Files capturing the stdout and stderr of the job.
+    SmallString<128> OutFile, ErrFile;
+    std::string Error;
+    int Res = 0;
+    bool ExecutionFailed = false;
+    bool Started = false;
+    bool Skipped = false;
+    bool Done = false;
+    bool Recorded = false;
+  };
+
+  SmallVector<JobState, 16> States(Jobs.size());
+  llvm::DenseMap<const Action *, unsigned> JobForAction;
+  llvm::StringMap<unsigned> JobForOutput;
+  unsigned Idx = 0;
+  for (const Command &Job : Jobs) {
+    JobState &State = States[Idx];
+    State.Cmd = &Job;
+
+    // A job depends on every earlier job whose action feeds into its own, or
+    // whose output file it reads.
+    llvm::SmallPtrSet<const Action *, 16> Visited;
+    SmallVector<const Action *, 16> Worklist(Job.getSource().input_begin(),
+                                             Job.getSource().input_end());
+    while (!Worklist.empty()) {
+      const Action *A = Worklist.pop_back_val();
+      if (!Visited.insert(A).second)
+        continue;
+      auto It = JobForAction.find(A);
+      if (It != JobForAction.end()) {
+        State.Deps.push_back(It->second);
+        continue;
+      }
+      Worklist.append(A->input_begin(), A->input_end());
+    }
+    for (const InputInfo &II : Job.getInputInfos()) {
+      if (!II.isFilename())
+        continue;
+      auto It = JobForOutput.find(II.getFilename());
+      if (It != JobForOutput.end())
+        State.Deps.push_back(It->second);
+    }
+
+    JobForAction.try_emplace(&Job.getSource(), Idx);
+    for (const std::string &Output : Job.getOutputFilenames())
+      JobForOutput[Output] = Idx;
+    ++Idx;
+  }
+
+  std::mutex Mutex;
+  std::condition_variable JobFinished;
+  llvm::DefaultThreadPool Pool(llvm::hardware_concurrency(ParallelJobs));
+
+  // Failures seen so far, in completion order. Only used to decide whether a
+  // job still has to run; FailingCommands is filled in job order.
+  SmallVector<std::pair<int, const Command *>, 4> Failures;
+  unsigned NextToReport = 0;
+
+  std::unique_lock<std::mutex> Lock(Mutex);
+  while (NextToReport != States.size()) {
+    for (JobState &State : States)
+      if (State.Done && !State.Recorded) {
+        State.Recorded = true;
+        if (State.Res || State.ExecutionFailed)
+          Failures.push_back(std::make_pair(State.Res, State.Cmd));
+      }
+
+    // Start every job whose dependencies have finished. Dependencies always
+    // precede the job, so one pass in order sees any job skipped earlier in
+    // the same pass.
+    for (JobState &State : States) {
+      if (State.Started ||
+          !llvm::all_of(State.Deps,
+                        [&](unsigned D) { return States[D].Done; }))
+        continue;
+      State.Started = true;
+      if (!InputsOk(*State.Cmd, Failures)) {
+        State.Skipped = State.Done = State.Recorded = true;
+        continue;
+      }
+
+      // Capture the output so it can be replayed in job order. If no
+      // temporary file can be created the job writes straight through.
+      if (llvm::sys::fs::createTemporaryFile("clang-job", "out",
+                                             State.OutFile))
+        State.OutFile.clear();
+      if (llvm::sys::fs::createTemporaryFile("clang-job", "err",
+                                             State.ErrFile))
+        State.ErrFile.clear();
+
+      Pool.async([&State, &Mutex, &JobFinished] {
+        std::optional<StringRef> Redirects[] = {
+            std::nullopt,
+            State.OutFile.empty() ? std::nullopt
+                                  : std::optional<StringRef>(State.OutFile),
+            State.ErrFile.empty() ? std::nullopt
+                                  : std::optional<StringRef>(State.ErrFile)};
+        std::string Error;
+        bool ExecutionFailed = false;
+        int Res = State.Cmd->Execute(Redirects, &Error, &ExecutionFailed);
+
+        std::lock_guard<std::mutex> Guard(Mutex);
+        State.Res = Res;
+        State.Error = std::move(Error);
+        State.ExecutionFailed = ExecutionFailed;
+        State.Done = true;
+        JobFinished.notify_one();
+      });
+    }
+
+    // Report finished jobs in order, as the sequential driver would.
+    for (; NextToReport != States.size() && States[NextToReport].Done;
+         ++NextToReport) {
+      JobState &State = States[NextToReport];
+      if (State.Skipped)
+        continue;
+      const Command &C = *State.Cmd;
+      const Command *FailingCommand = nullptr;
+      int LogRes = LogCommand(C, FailingCommand);
+      replayCapturedOutput(State.OutFile, llvm::outs());
+      replayCapturedOutput(State.ErrFile, llvm::errs());
+
+      if (PostCallback)
+        PostCallback(C, State.Res);
+      if (!State.Error.empty()) {
+        assert(State.Res && "Error string set with 0 result code!");
+        getDriver().Diag(diag::err_drv_command_failure) << State.Error;
+      }
+      int Res = State.ExecutionFailed ? 1 : State.Res;
+      if (LogRes && !Res)
+        Res = LogRes;
+      if (Res)
+        FailingCommands.push_back(std::make_pair(Res, &C));
+    }
+
+    if (NextToReport != States.size())
+      JobFinished.wait(Lock);
+  }
+}
+
 void Compilation::initCompilationForDiagnostics() {
   ForDiagnostics = true;
 
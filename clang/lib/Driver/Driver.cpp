@@ -4757,11 +4757,13 @@ Action *Driver::ConstructPhaseAction(
     if (Args.hasArg(options::OPT_extract_api))
       return C.MakeAction<ExtractAPIJobAction>(Input, types::TY_API_INFO);
 
-    // With 'fexperimental-modules-reduced-bmi', we don't want to run the
-    // precompile phase unless the user specified '--precompile'. In the case
-    // the '--precompile' flag is enabled, we will try to emit the reduced BMI
-    // as a by product in GenerateModuleInterfaceAction.
-    if (Args.hasArg(options::OPT_modules_reduced_bmi) &&
+    // With reduced BMIs (the default for named module units), we don't want
+    // to run the precompile phase unless the user specified '--precompile'.
+    // The reduced BMI is emitted as a by product of the compilation to the
+    // object file. In the case the '--precompile' flag is enabled, we will try
+    // to emit the reduced BMI as a by product in
+    // GenerateModuleInterfaceAction.
+    if (willEmitReducedBMI(Args, Input->getType()) &&
         !Args.getLastArg(options::OPT__precompile))
       return Input;
 
@@ -4942,6 +4944,15 @@ void Driver::BuildJobs(Compilation &C) const {
     for (auto &J : C.getJobs())
       J.InProcess = false;
 
+  if (const Arg *A = C.getArgs().getLastArg(options::OPT_j)) {
+    unsigned NumJobs;
+    if (StringRef(A->getValue()).getAsInteger(10, NumJobs) || NumJobs == 0)
+      Diag(diag::err_drv_invalid_int_value)
+          << A->getAsString(C.getArgs()) << A->getValue();
+    else
+      C.setParallelJobs(NumJobs);
+  }
+
   if (CCPrintProcessStats) {
     C.setPostCallback([=](const Command &Cmd, int Res) {
       std::optional<llvm::sys::ProcessStatistics> ProcStat =
@@ -5928,7 +5939,8 @@ const char *Driver::GetNamedOutputPath(Compilation &C, const JobAction &JA,
   // `-fmodule-output`.
   if (!AtTopLevel && isa<PrecompileJobAction>(JA) &&
       JA.getType() == types::TY_ModuleFile && SpecifiedModuleOutput) {
-    assert(!C.getArgs().hasArg(options::OPT_modules_reduced_bmi));
+    assert(!willEmitReducedBMI(C.getArgs(), JA.getInputs()[0]->getType()) &&
+           "reduced BMIs are not produced by a separate precompile job");
     return GetModuleOutputPath(C, JA, BaseInput);
   }
 
@@ -6679,6 +6691,16 @@ bool clang::driver::willEmitRemarks(const ArgList &Args) {
   return false;
 }
 
+bool clang::driver::willEmitReducedBMI(const ArgList &Args, types::ID InputTy) {
+  if (InputTy != types::TY_CXXModule && InputTy != types::TY_PP_CXXModule)
+    return false;
+  // Unless asked otherwise, only the one-phase compilation model emits a
+  // reduced BMI. With '--precompile' the full BMI is the requested output.
+  return Args.hasFlag(options::OPT_fmodules_reduced_bmi,
+                      options::OPT_fno_modules_reduced_bmi,
+                      !Args.hasArg(options::OPT__precompile));
+}
+
 llvm::StringRef clang::driver::getDriverMode(StringRef ProgName,
                                              ArrayRef<const char *> Args) {
   static StringRef OptName =
@@ -3971,6 +3971,11 @@ static bool RenderModulesOptions(Compilation &C, const Driver &D,
                       options::OPT_fmodules_validate_once_per_build_session);
     }
 
+    if (!Args.hasFlag(options::OPT_fmodules_force_validate_user_headers,
+                      options::OPT_fno_modules_force_validate_user_headers,
+                      true))
+      CmdArgs.push_back("-fno-modules-force-validate-user-headers");
+
     if (Args.hasFlag(options::OPT_fmodules_validate_system_headers,
                      options::OPT_fno_modules_validate_system_headers,
                      ImplicitModules))
@@ -3982,6 +3987,8 @@ static bool RenderModulesOptions(Compilation &C, const Driver &D,
     Args.ClaimAllArgs(options::OPT_fbuild_session_timestamp);
     Args.ClaimAllArgs(options::OPT_fbuild_session_file);
     Args.ClaimAllArgs(options::OPT_fmodules_validate_once_per_build_session);
+    Args.ClaimAllArgs(options::OPT_fmodules_force_validate_user_headers);
+    Args.ClaimAllArgs(options::OPT_fno_modules_force_validate_user_headers);
     Args.ClaimAllArgs(options::OPT_fmodules_validate_system_headers);
     Args.ClaimAllArgs(options::OPT_fno_modules_validate_system_headers);
     Args.ClaimAllArgs(options::OPT_fmodules_disable_diagnostic_validation);
@@ -3991,10 +3998,12 @@ static bool RenderModulesOptions(Compilation &C, const Driver &D,
   // module fragment.
   CmdArgs.push_back("-fskip-odr-check-in-gmf");
 
-  if (Args.hasArg(options::OPT_modules_reduced_bmi) &&
-      (Input.getType() == driver::types::TY_CXXModule ||
-       Input.getType() == driver::types::TY_PP_CXXModule)) {
-    CmdArgs.push_back("-fexperimental-modules-reduced-bmi");
+  // The reduced BMI is a by product of generating code or of '--precompile',
+  // there is nothing to emit it from with '-fsyntax-only' or '-E'.
+  if (willEmitReducedBMI(Args, Input.getType()) &&
+      Output.getType() != types::TY_Nothing &&
+      Output.getType() != types::TY_PP_CXXModule) {
+    CmdArgs.push_back("-fmodules-reduced-bmi");
 
     if (Args.hasArg(options::OPT_fmodule_output_EQ))
       Args.AddLastArg(CmdArgs, options::OPT_fmodule_output_EQ);
@@ -4004,10 +4013,21 @@ static bool RenderModulesOptions(Compilation &C, const Driver &D,
           getCXX20NamedModuleOutputPath(Args, Input.getBaseInput())));
   }
 
-  // Noop if we see '-fexperimental-modules-reduced-bmi' with other translation
-  // units than module units. This is more user friendly to allow end uers to
+  // -fexperimental-modules-reduced-bmi is a deprecated spelling of
+  // -fmodules-reduced-bmi.
+  for (const Arg *A : Args.filtered(options::OPT_fmodules_reduced_bmi))
+    if (A->getAlias() &&
+        A->getAlias()->getOption().matches(
+            options::OPT_experimental_modules_reduced_bmi))
+      D.Diag(diag::warn_drv_deprecated_arg)
+          << A->getAlias()->getAsString(Args) << /*hasReplacement=*/true
+          << "-fmodules-reduced-bmi";
+
+  // Noop if we see '-f[no-]modules-reduced-bmi' with other translation units
+  // than module units. This is more user friendly to allow end uers to
   // enable this feature without asking for help from build systems.
-  Args.ClaimAllArgs(options::OPT_modules_reduced_bmi);
+  Args.ClaimAllArgs(options::OPT_fmodules_reduced_bmi);
+  Args.ClaimAllArgs(options::OPT_fno_modules_reduced_bmi);
 
   // We need to include the case the input file is a module file here.
   // Since the default compilation model for C++ module interface unit will
@@ -5536,6 +5556,12 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
           Triple.getArch() != llvm::Triple::aarch64_be)
         D.Diag(diag::err_drv_unsupported_opt_for_target)
             << Name << Triple.getArchName();
+    } else if (Name == "LLVMlibc") {
+      if (Triple.getArch() != llvm::Triple::x86_64 &&
+          Triple.getArch() != llvm::Triple::aarch64 &&
+          Triple.getArch() != llvm::Triple::aarch64_be)
+        D.Diag(diag::err_drv_unsupported_opt_for_target)
+            << Name << Triple.getArchName();
     }
     A->render(Args, CmdArgs);
   }
@@ -6742,6 +6768,7 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
   if (const char *Name = C.getTimeTraceFile(&JA)) {
     CmdArgs.push_back(Args.MakeArgString("-ftime-trace=" + Twine(Name)));
     Args.AddLastArg(CmdArgs, options::OPT_ftime_trace_granularity_EQ);
+    Args.AddLastArg(CmdArgs, options::OPT_ftime_trace_streaming);
   }
 
   if (Arg *A = Args.getLastArg(options::OPT_ftrapv_handler_EQ)) {
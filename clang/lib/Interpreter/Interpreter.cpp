@@ -30,6 +30,7 @@
 #include "clang/Driver/Options.h"
 #include "clang/Driver/Tool.h"
 #include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendActions.h"
 #include "clang/Frontend/TextDiagnosticBuffer.h"
 #include "clang/Interpreter/Interpreter.h"
 #include "clang/Interpreter/Value.h"
@@ -40,6 +41,7 @@
 #include "llvm/IR/Module.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/TargetParser/Host.h"
 using namespace clang;
@@ -186,7 +188,45 @@ IncrementalCompilerBuilder::CreateCpp() {
   Argv.insert(Argv.end(), UserArgs.begin(), UserArgs.end());
 
   std::string TT = TargetTriple ? *TargetTriple : llvm::sys::getProcessTriple();
-  return IncrementalCompilerBuilder::create(TT, Argv);
+  if (PreludeHeader.empty())
+    return IncrementalCompilerBuilder::create(TT, Argv);
+
+  if (llvm::Error Err = buildPrelude(TT, Argv))
+    return std::move(Err);
+  auto CI = IncrementalCompilerBuilder::create(TT, Argv);
+  if (CI)
+    (*CI)->getPreprocessorOpts().ImplicitPCHInclude = PreludePCH;
+  return CI;
+}
+
+llvm::Error IncrementalCompilerBuilder::buildPrelude(
+    std::string TT, std::vector<const char *> ClangArgv) const {
+  llvm::sys::fs::file_status HeaderStatus, PCHStatus;
+  if (std::error_code EC = llvm::sys::fs::status(PreludeHeader, HeaderStatus))
+    return llvm::createStringError(EC, "Cannot open prelude '%s'",
+                                   PreludeHeader.c_str());
+  if (!llvm::sys::fs::status(PreludePCH, PCHStatus) &&
+      PCHStatus.getLastModificationTime() >=
+          HeaderStatus.getLastModificationTime())
+    return llvm::Error::success();
+
+  // Precompile the prelude with the same arguments, including
+  // -fincremental-extensions, as the instance that is going to load it.
+  auto CI = IncrementalCompilerBuilder::create(TT, ClangArgv);
+  if (!CI)
+    return CI.takeError();
+  FrontendOptions &FrontendOpts = (*CI)->getFrontendOpts();
+  FrontendOpts.Inputs.clear();
+  FrontendOpts.Inputs.emplace_back(PreludeHeader,
+                                   InputKind(Language::CXX).getHeader());
+  FrontendOpts.OutputFile = PreludePCH;
+  FrontendOpts.ProgramAction = frontend::GeneratePCH;
+  GeneratePCHAction Act;
+  if (!(*CI)->ExecuteAction(Act))
+    return llvm::createStringError(llvm::errc::invalid_argument,
+                                   "Failed to precompile prelude '%s'",
+                                   PreludeHeader.c_str());
+  return llvm::Error::success();
 }
 
 llvm::Expected<std::unique_ptr<CompilerInstance>>
@@ -47,6 +47,10 @@
 #include <tuple>
 #include <utility>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #ifdef __SSE4_2__
 #include <nmmintrin.h>
 #endif
@@ -2579,6 +2583,32 @@ bool Lexer::SkipLineComment(Token &Result, const char *CurPtr,
 
   char C;
   while (true) {
+#ifdef __SSE2__
+    // Skip over runs of plain ASCII sixteen bytes at a time, stopping at the
+    // first byte the scalar loop below would stop at.
+    if (CurPtr + 16 <= BufferEnd) {
+      const char *ChunkStart = CurPtr;
+      const __m128i Newlines = _mm_set1_epi8('\n');
+      const __m128i CarriageReturns = _mm_set1_epi8('\r');
+      const __m128i Nuls = _mm_setzero_si128();
+      while (CurPtr + 16 <= BufferEnd) {
+        __m128i Chunk = _mm_loadu_si128((const __m128i *)CurPtr);
+        unsigned Mask =
+            _mm_movemask_epi8(Chunk) | // Non-ASCII bytes have the top bit set.
+            _mm_movemask_epi8(_mm_cmpeq_epi8(Chunk, Newlines)) |
+            _mm_movemask_epi8(_mm_cmpeq_epi8(Chunk, CarriageReturns)) |
+            _mm_movemask_epi8(_mm_cmpeq_epi8(Chunk, Nuls));
+        if (Mask) {
+          CurPtr += llvm::countr_zero(Mask);
+          break;
+        }
+        CurPtr += 16;
+      }
+      if (CurPtr != ChunkStart)
+        UnicodeDecodingAlreadyDiagnosed = false;
+    }
+#endif
+
     C = *CurPtr;
     // Skip over characters in the fast loop.
     while (isASCII(C) && C != 0 &&   // Potentially EOF.
@@ -2817,9 +2847,7 @@ static bool isEndOfBlockCommentWithEscapedNewLine(const char *CurPtr, Lexer *L,
   return true;
 }
 
-#ifdef __SSE2__
-#include <emmintrin.h>
-#elif __ALTIVEC__
+#if !defined(__SSE2__) && __ALTIVEC__
 #include <altivec.h>
 #undef bool
 #endif
@@ -221,7 +221,8 @@ Sema::Sema(Preprocessor &pp, ASTContext &ctxt, ASTConsumer &consumer,
       StdSourceLocationImplDecl(nullptr), CXXTypeInfoDecl(nullptr),
       GlobalNewDeleteDeclared(false), DisableTypoCorrection(false),
       TyposCorrected(0), IsBuildingRecoveryCallExpr(false), NumSFINAEErrors(0),
-      AccessCheckingSFINAE(false), CurrentInstantiationScope(nullptr),
+      AccessCheckingSFINAE(false), FailedDeductionSubstitutions(Context),
+      CurrentInstantiationScope(nullptr),
       InNonInstantiationSFINAEContext(false), NonInstantiationEntries(0),
       ArgumentPackSubstitutionIndex(-1), SatisfactionCache(Context),
       NSNumberDecl(nullptr), NSValueDecl(nullptr), NSStringDecl(nullptr),
@@ -499,6 +500,14 @@ Sema::~Sema() {
   for (auto *Node : Satisfactions)
     delete Node;
 
+  // Delete cached deduction failures.
+  std::vector<FailedDeductionSubstitution *> FailedSubstitutions;
+  FailedSubstitutions.reserve(FailedDeductionSubstitutions.size());
+  for (auto &Node : FailedDeductionSubstitutions)
+    FailedSubstitutions.push_back(&Node);
+  for (auto *Node : FailedSubstitutions)
+    delete Node;
+
   threadSafety::threadSafetyCleanup(ThreadSafetyDeclCache);
 
   // Destroys data sharing attributes stack for OpenMP
@@ -574,6 +583,10 @@ void Sema::addExternalSource(ExternalSemaSource *E) {
 void Sema::PrintStats() const {
   llvm::errs() << "\n*** Semantic Analysis Stats:\n";
   llvm::errs() << NumSFINAEErrors << " SFINAE diagnostics trapped.\n";
+  llvm::errs() << NumDeductionSubstitutionCacheHits << '/'
+               << (NumDeductionSubstitutionCacheHits +
+                   NumDeductionSubstitutionCacheMisses)
+               << " failed template argument substitutions reused.\n";
 
   BumpAlloc.PrintStats();
   AnalysisWarnings.PrintStats();
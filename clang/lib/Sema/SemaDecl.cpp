@@ -1532,6 +1532,11 @@ void Sema::PushOnScopeChains(NamedDecl *D, Scope *S, bool AddToContext) {
   if (AddToContext)
     CurContext->addDecl(D);
 
+  // A new non-local declaration may change the outcome of template argument
+  // substitutions that failed before; see FailedDeductionSubstitution.
+  if (!D->getDeclContext()->isFunctionOrMethod())
+    ++DeclarationGeneration;
+
   // Out-of-line definitions shouldn't be pushed into scope in C++, unless they
   // are function-local declarations.
   if (getLangOpts().CPlusPlus && D->isOutOfLine() && !S->getFnParent())
@@ -13504,6 +13509,10 @@ void Sema::checkNonTrivialCUnion(QualType QT, SourceLocation Loc,
 /// declaration dcl. If DirectInit is true, this is C++ direct
 /// initialization rather than copy initialization.
 void Sema::AddInitializerToDecl(Decl *RealDecl, Expr *Init, bool DirectInit) {
+  // The initializer may make a constant usable or deduce a type that failed
+  // template argument substitutions depended on.
+  ++DeclarationGeneration;
+
   // If there is no declaration, there was an error parsing it.  Just ignore
   // the initializer.
   if (!RealDecl) {
@@ -16104,6 +16113,11 @@ Decl *Sema::ActOnFinishFunctionBody(Decl *dcl, Stmt *Body,
   FunctionScopeInfo *FSI = getCurFunction();
   FunctionDecl *FD = dcl ? dcl->getAsFunction() : nullptr;
 
+  // A definition may make a constexpr function usable in constant expressions
+  // or deduce its return type, so failed template argument substitutions may
+  // succeed now.
+  ++DeclarationGeneration;
+
   if (FSI->UsesFPIntrin && FD && !FD->hasAttr<StrictFPAttr>())
     FD->addAttr(StrictFPAttr::CreateImplicit(Context));
 
@@ -18402,6 +18416,10 @@ void Sema::ActOnTagFinishDefinition(Scope *S, Decl *TagD,
   TagDecl *Tag = cast<TagDecl>(TagD);
   Tag->setBraceRange(BraceRange);
 
+  // Completing a type may change the outcome of template argument
+  // substitutions that failed before.
+  ++DeclarationGeneration;
+
   // Make sure we "complete" the definition even it is invalid.
   if (Tag->isBeingDefined()) {
     assert(Tag->isInvalidDecl() && "We should already have completed it");
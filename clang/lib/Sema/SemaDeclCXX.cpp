@@ -4250,6 +4250,10 @@ void Sema::ActOnFinishCXXInClassMemberInitializer(Decl *D,
   // Pop the notional constructor scope we created earlier.
   PopFunctionScopeInfo(nullptr, D);
 
+  // Default member initializers are parsed after the class is complete, and
+  // change what its constructors can be used for.
+  ++DeclarationGeneration;
+
   FieldDecl *FD = dyn_cast<FieldDecl>(D);
   assert((isa<MSPropertyDecl>(D) || FD->getInClassInitStyle() != ICIS_NoInit) &&
          "must set init style when field is created");
@@ -7019,6 +7023,10 @@ void Sema::CheckCompletedCXXClass(Scope *S, CXXRecordDecl *Record) {
   if (!Record)
     return;
 
+  // Template argument substitutions that failed while the class was
+  // incomplete may succeed now.
+  ++DeclarationGeneration;
+
   if (Record->isAbstract() && !Record->isInvalidDecl()) {
     AbstractUsageInfo Info(*this, Record);
     CheckAbstractClassUsage(Info, Record);
@@ -52,6 +52,7 @@
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/TimeProfiler.h"
 #include <algorithm>
 #include <cassert>
 #include <optional>
@@ -3726,6 +3727,15 @@ static TemplateDeductionResult instantiateExplicitSpecifierDeferred(
   return TemplateDeductionResult::Success;
 }
 
+void Sema::FailedDeductionSubstitution::Profile(
+    llvm::FoldingSetNodeID &ID, const ASTContext &C,
+    const FunctionTemplateDecl *Template, ArrayRef<TemplateArgument> Args) {
+  ID.AddPointer(Template->getCanonicalDecl());
+  ID.AddInteger(Args.size());
+  for (const TemplateArgument &Arg : Args)
+    Arg.Profile(ID, C);
+}
+
 /// Finish template argument deduction for a function template,
 /// checking the deduced template arguments for completeness and forming
 /// the function template specialization.
@@ -3810,8 +3820,74 @@ TemplateDeductionResult Sema::FinishTemplateArgumentDeduction(
   MultiLevelTemplateArgumentList SubstArgs(
       FunctionTemplate, CanonicalDeducedArgumentList->asArray(),
       /*Final=*/false);
-  Specialization = cast_or_null<FunctionDecl>(
-      SubstDecl(FD, Owner, SubstArgs));
+
+  // Whether substituting into the declaration fails only depends on the
+  // template, the canonical template arguments and the declarations that are
+  // visible at this point. Remember failures so that overload resolution
+  // retrying the same candidate with the same arguments does not substitute
+  // again. Templates that can see function-local or dependent declarations
+  // are excluded, as is code completion.
+  bool CanCacheFailure =
+      !PartialOverloading && ArgumentPackSubstitutionIndex == -1 &&
+      !FD->getParentFunctionOrMethod() &&
+      !FunctionTemplate->getDeclContext()->isDependentContext();
+  llvm::FoldingSetNodeID FailedID;
+  void *InsertPos = nullptr;
+  FailedDeductionSubstitution *Failed = nullptr;
+  if (CanCacheFailure) {
+    FailedDeductionSubstitution::Profile(
+        FailedID, Context, FunctionTemplate,
+        CanonicalDeducedArgumentList->asArray());
+    Failed = FailedDeductionSubstitutions.FindNodeOrInsertPos(FailedID,
+                                                              InsertPos);
+    if (Failed && Failed->DeclGeneration == DeclarationGeneration &&
+        Failed->ModuleGeneration == VisibleModules.getGeneration()) {
+      llvm::TimeTraceScope TimeScope("DeductionSubstitutionCacheHit");
+      ++NumDeductionSubstitutionCacheHits;
+      if (Failed->Diag)
+        Info.addSFINAEDiagnostic(Failed->Diag->first, Failed->Diag->second);
+      Specialization = nullptr;
+      return TemplateDeductionResult::SubstitutionFailure;
+    }
+  }
+
+  unsigned NumErrorsBefore = getDiagnostics().getNumErrors();
+  {
+    std::optional<llvm::TimeTraceScope> TimeScope;
+    if (CanCacheFailure) {
+      TimeScope.emplace("DeductionSubstitutionCacheMiss");
+      ++NumDeductionSubstitutionCacheMisses;
+    }
+    Specialization =
+        cast_or_null<FunctionDecl>(SubstDecl(FD, Owner, SubstArgs));
+  }
+
+  if (CanCacheFailure) {
+    // Only remember failures caused by SFINAE errors in the immediate
+    // context, without any hard errors along the way.
+    if (!Specialization && Trap.hasErrorOccurred() &&
+        getDiagnostics().getNumErrors() == NumErrorsBefore) {
+      if (!Failed) {
+        Failed = new FailedDeductionSubstitution(
+            FunctionTemplate->getCanonicalDecl(),
+            CanonicalDeducedArgumentList->asArray(), DeclarationGeneration,
+            VisibleModules.getGeneration());
+        // Note that entries are deleted in Sema's destructor.
+        FailedDeductionSubstitutions.InsertNode(Failed, InsertPos);
+      } else {
+        Failed->DeclGeneration = DeclarationGeneration;
+        Failed->ModuleGeneration = VisibleModules.getGeneration();
+      }
+      Failed->Diag.reset();
+      if (Info.hasSFINAEDiagnostic())
+        Failed->Diag = Info.peekSFINAEDiagnostic();
+    } else if (Failed) {
+      // A stale entry that no longer fails (or not in the same way).
+      FailedDeductionSubstitutions.RemoveNode(Failed);
+      delete Failed;
+    }
+  }
+
   if (!Specialization || Specialization->isInvalidDecl())
     return TemplateDeductionResult::SubstitutionFailure;
 
@@ -2868,13 +2868,14 @@ ASTReader::ReadControlBlock(ModuleFile &F,
 
         // If we are reading a module, we will create a verification timestamp,
         // so we verify all input files.  Otherwise, verify only user input
-        // files.
+        // files. A module already validated in this build session only needs
+        // its user input files checked, and none at all unless that is forced.
 
         unsigned N = ValidateSystemInputs ? NumInputs : NumUserInputs;
         if (HSOpts.ModulesValidateOncePerBuildSession &&
             F.InputFilesValidationTimestamp > HSOpts.BuildSessionTimestamp &&
             F.Kind == MK_ImplicitModule)
-          N = NumUserInputs;
+          N = HSOpts.ModulesForceValidateUserHeaders ? NumUserInputs : 0;
 
         for (unsigned I = 0; I < N; ++I) {
           InputFile IF = getInputFile(F, I+1, Complain);
@@ -280,6 +280,14 @@ RegionBindingsRef RegionBindingsRef::addBinding(BindingKey K, SVal V) const {
   const MemRegion *Base = K.getBaseRegion();
 
   const ClusterBindings *ExistingCluster = lookup(Base);
+
+  // Rebinding a key to the value it already has would copy the paths to the
+  // binding in both the cluster and the region map, for an equal store.
+  if (ExistingCluster)
+    if (const SVal *Existing = ExistingCluster->lookup(K))
+      if (*Existing == V)
+        return *this;
+
   ClusterBindings Cluster =
       (ExistingCluster ? *ExistingCluster : CBFactory->getEmptyMap());
 
@@ -309,7 +317,7 @@ const SVal *RegionBindingsRef::lookup(const MemRegion *R,
 RegionBindingsRef RegionBindingsRef::removeBinding(BindingKey K) {
   const MemRegion *Base = K.getBaseRegion();
   const ClusterBindings *Cluster = lookup(Base);
-  if (!Cluster)
+  if (!Cluster || !Cluster->lookup(K))
     return *this;
 
   ClusterBindings NewCluster = CBFactory->remove(*Cluster, K);
@@ -953,6 +961,11 @@ RegionStoreManager::removeSubRegionBindings(RegionBindingsConstRef B,
   collectSubRegionBindings(Bindings, svalBuilder, *Cluster, Top, TopKey,
                            /*IncludeAllDefaultBindings=*/false);
 
+  // Nothing overlaps; keep the bindings instead of copying the path to the
+  // cluster.
+  if (Bindings.empty() && !TopKey.hasSymbolicOffset())
+    return B;
+
   ClusterBindingsRef Result(*Cluster, CBFactory);
   for (BindingKey Key : llvm::make_first_range(Bindings))
     Result = Result.remove(Key);
@@ -2386,13 +2399,21 @@ RegionStoreManager::bind(RegionBindingsConstRef B, Loc L, SVal V) {
   assert((!isa<CXXThisRegion>(R) || !B.lookup(R)) &&
          "'this' pointer is not an l-value and is not assignable");
 
-  // Clear out bindings that may overlap with this binding.
-  RegionBindingsRef NewB = removeSubRegionBindings(B, cast<SubRegion>(R));
-
   // LazyCompoundVals should be always bound as 'default' bindings.
   auto KeyKind = isa<nonloc::LazyCompoundVal>(V) ? BindingKey::Default
                                                  : BindingKey::Direct;
-  return NewB.addBinding(BindingKey::Make(R, KeyKind), V);
+  BindingKey Key = BindingKey::Make(R, KeyKind);
+
+  // Storing the value that a base region already holds, and nothing else,
+  // does not change the store. Don't tear down and rebuild its cluster.
+  if (!Key.hasSymbolicOffset() && Key.getRegion() == R)
+    if (const ClusterBindings *Cluster = B.lookup(R))
+      if (Cluster->getHeight() == 1 && *Cluster->begin() == BindingPair(Key, V))
+        return B;
+
+  // Clear out bindings that may overlap with this binding.
+  RegionBindingsRef NewB = removeSubRegionBindings(B, cast<SubRegion>(R));
+  return NewB.addBinding(Key, V);
 }
 
 RegionBindingsRef
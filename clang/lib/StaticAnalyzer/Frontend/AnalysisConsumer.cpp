@@ -454,6 +454,13 @@ void AnalysisConsumer::HandleDeclsCallGraph(const unsigned LocalTUDeclsSize) {
   SetOfConstDecls Visited;
   SetOfConstDecls VisitedAsTopLevel;
   llvm::ReversePostOrderTraversal<clang::CallGraph*> RPOT(&CG);
+  // Which callees get inlined is only known after analyzing their callers, and
+  // the callers may belong to another shard. So when sharding, the "do not
+  // reanalyze previously inlined function" heuristic is disabled, as with
+  // -analyzer-inlining-mode=all: every function is analyzed as top-level with
+  // full inlining, whatever its shard and whatever the shard count.
+  bool IsSharded = Opts.ShardCount > 1;
+  unsigned NodeIndex = 0;
   for (auto &N : RPOT) {
     NumFunctionTopLevel++;
 
@@ -463,6 +470,12 @@ void AnalysisConsumer::HandleDeclsCallGraph(const unsigned LocalTUDeclsSize) {
     if (!D)
       continue;
 
+    // When sharding, only analyze the functions of our shard. The traversal
+    // order only depends on the translation unit, so every invocation agrees
+    // on which shard a function belongs to.
+    if (IsSharded && NodeIndex++ % Opts.ShardCount != Opts.ShardIndex)
+      continue;
+
     // Skip the functions which have been processed already or previously
     // inlined.
     if (shouldSkipFunction(D, Visited, VisitedAsTopLevel))
@@ -484,7 +497,9 @@ void AnalysisConsumer::HandleDeclsCallGraph(const unsigned LocalTUDeclsSize) {
     SetOfConstDecls VisitedCallees;
 
     HandleCode(D, AM_Path, getInliningModeForFunction(D, Visited),
-               (Mgr->options.InliningMode == All ? nullptr : &VisitedCallees));
+               (Mgr->options.InliningMode == All || IsSharded
+                    ? nullptr
+                    : &VisitedCallees));
 
     // Add the visited callees to the global visited set.
     for (const Decl *Callee : VisitedCallees)
@@ -529,11 +544,19 @@ void AnalysisConsumer::runAnalysisOnTranslationUnit(ASTContext &C) {
   BugReporter BR(*Mgr);
   const TranslationUnitDecl *TU = C.getTranslationUnitDecl();
   BR.setAnalysisEntryPoint(TU);
-  if (SyntaxCheckTimer)
-    SyntaxCheckTimer->startTimer();
-  checkerMgr->runCheckersOnASTDecl(TU, *Mgr, BR);
-  if (SyntaxCheckTimer)
-    SyntaxCheckTimer->stopTimer();
+
+  // When the top-level functions are split into shards, everything that is
+  // not a path-sensitive analysis of a top-level function runs in the first
+  // shard only, so that its reports are not duplicated.
+  bool IsFirstShard = Opts.ShardCount <= 1 || Opts.ShardIndex == 0;
+
+  if (IsFirstShard) {
+    if (SyntaxCheckTimer)
+      SyntaxCheckTimer->startTimer();
+    checkerMgr->runCheckersOnASTDecl(TU, *Mgr, BR);
+    if (SyntaxCheckTimer)
+      SyntaxCheckTimer->stopTimer();
+  }
 
   // Run the AST-only checks using the order in which functions are defined.
   // If inlining is not turned on, use the simplest function order for path
@@ -550,15 +573,18 @@ void AnalysisConsumer::runAnalysisOnTranslationUnit(ASTContext &C) {
   // random access.  By doing so, we automatically compensate for iterators
   // possibly being invalidated, although this is a bit slower.
   const unsigned LocalTUDeclsSize = LocalTUDecls.size();
-  for (unsigned i = 0 ; i < LocalTUDeclsSize ; ++i) {
-    TraverseDecl(LocalTUDecls[i]);
+  if (IsFirstShard) {
+    for (unsigned i = 0 ; i < LocalTUDeclsSize ; ++i) {
+      TraverseDecl(LocalTUDecls[i]);
+    }
   }
 
   if (Mgr->shouldInlineCall())
     HandleDeclsCallGraph(LocalTUDeclsSize);
 
   // After all decls handled, run checkers on the entire TranslationUnit.
-  checkerMgr->runCheckersOnEndOfTranslationUnit(TU, *Mgr, BR);
+  if (IsFirstShard)
+    checkerMgr->runCheckersOnEndOfTranslationUnit(TU, *Mgr, BR);
 
   BR.FlushReports();
   RecVisitorBR = nullptr;
@@ -7,15 +7,139 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
+#include "clang/Basic/TokenKinds.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/Threading.h"
+#include "llvm/Support/xxhash.h"
 #include <optional>
 
 using namespace clang;
 using namespace tooling;
 using namespace dependencies;
 
+// Persisted directive tokens are stored one file per distinct file contents,
+// named after the hash and size of the contents. All fields are little-endian:
+//
+//   uint32 Magic, uint32 Version, uint64 ContentHash, uint64 ContentSize,
+//   uint32 NumTokens, uint32 NumDirectives,
+//   NumTokens * { uint32 Offset, uint32 Length, uint16 Kind, uint16 Flags },
+//   NumDirectives * { uint32 Kind, uint32 NumTokens }
+static constexpr uint32_t PersistedDirectivesMagic = 0x44445343; // "CSDD"
+static constexpr uint32_t PersistedDirectivesVersion = 1;
+static constexpr size_t PersistedDirectivesHeaderSize = 32;
+static constexpr size_t PersistedTokenSize = 12;
+static constexpr size_t PersistedDirectiveSize = 8;
+
+static std::string getPersistedDirectivesPath(StringRef CachePath,
+                                              uint64_t Hash, size_t Size) {
+  SmallString<256> Path(CachePath);
+  llvm::sys::path::append(Path, llvm::utohexstr(Hash, /*LowerCase=*/true) +
+                                    "-" + Twine(Size) + ".directives");
+  return std::string(Path);
+}
+
+/// Loads directive tokens for \p Source persisted by an earlier scan. Returns
+/// false if there is no entry or it doesn't match \p Source.
+static bool readPersistedDirectives(
+    StringRef CachePath, StringRef Source, uint64_t Hash,
+    SmallVectorImpl<dependency_directives_scan::Token> &Tokens,
+    SmallVectorImpl<dependency_directives_scan::Directive> &Directives) {
+  auto MaybeBuffer = llvm::MemoryBuffer::getFile(
+      getPersistedDirectivesPath(CachePath, Hash, Source.size()),
+      /*IsText=*/false, /*RequiresNullTerminator=*/false);
+  if (!MaybeBuffer)
+    return false;
+  StringRef Data = (*MaybeBuffer)->getBuffer();
+  if (Data.size() < PersistedDirectivesHeaderSize)
+    return false;
+
+  using namespace llvm::support;
+  const char *Ptr = Data.data();
+  if (endian::readNext<uint32_t, llvm::endianness::little>(Ptr) !=
+          PersistedDirectivesMagic ||
+      endian::readNext<uint32_t, llvm::endianness::little>(Ptr) !=
+          PersistedDirectivesVersion ||
+      endian::readNext<uint64_t, llvm::endianness::little>(Ptr) != Hash ||
+      endian::readNext<uint64_t, llvm::endianness::little>(Ptr) !=
+          Source.size())
+    return false;
+  uint32_t NumTokens = endian::readNext<uint32_t, llvm::endianness::little>(Ptr);
+  uint32_t NumDirectives =
+      endian::readNext<uint32_t, llvm::endianness::little>(Ptr);
+  if (Data.size() != PersistedDirectivesHeaderSize +
+                         uint64_t(NumTokens) * PersistedTokenSize +
+                         uint64_t(NumDirectives) * PersistedDirectiveSize)
+    return false;
+
+  Tokens.reserve(NumTokens);
+  for (uint32_t I = 0; I != NumTokens; ++I) {
+    uint32_t Offset = endian::readNext<uint32_t, llvm::endianness::little>(Ptr);
+    uint32_t Length = endian::readNext<uint32_t, llvm::endianness::little>(Ptr);
+    uint16_t Kind = endian::readNext<uint16_t, llvm::endianness::little>(Ptr);
+    uint16_t Flags = endian::readNext<uint16_t, llvm::endianness::little>(Ptr);
+    if (uint64_t(Offset) + Length > Source.size() || Kind >= tok::NUM_TOKENS)
+      return false;
+    Tokens.emplace_back(Offset, Length, tok::TokenKind(Kind), Flags);
+  }
+
+  // Directives refer to slices of Tokens, which must not grow from here on.
+  ArrayRef<dependency_directives_scan::Token> RemainingTokens = Tokens;
+  for (uint32_t I = 0; I != NumDirectives; ++I) {
+    uint32_t Kind = endian::readNext<uint32_t, llvm::endianness::little>(Ptr);
+    uint32_t Count = endian::readNext<uint32_t, llvm::endianness::little>(Ptr);
+    if (Kind > dependency_directives_scan::pp_eof ||
+        Count > RemainingTokens.size())
+      return false;
+    Directives.emplace_back(dependency_directives_scan::DirectiveKind(Kind),
+                            RemainingTokens.take_front(Count));
+    RemainingTokens = RemainingTokens.drop_front(Count);
+  }
+  return RemainingTokens.empty();
+}
+
+/// Persists the directive tokens scanned from \p Source. Failures are ignored;
+/// the next scan of the same contents simply misses the cache.
+static void writePersistedDirectives(
+    StringRef CachePath, StringRef Source, uint64_t Hash,
+    ArrayRef<dependency_directives_scan::Directive> Directives) {
+  if (llvm::sys::fs::create_directories(CachePath))
+    return;
+
+  uint32_t NumTokens = 0;
+  for (const dependency_directives_scan::Directive &D : Directives)
+    NumTokens += D.Tokens.size();
+
+  // Write to a temporary file that is renamed into place, so that concurrent
+  // scanners never observe a partially written entry.
+  llvm::consumeError(llvm::writeToOutput(
+      getPersistedDirectivesPath(CachePath, Hash, Source.size()),
+      [&](raw_ostream &OS) {
+        llvm::support::endian::Writer W(OS, llvm::endianness::little);
+        W.write<uint32_t>(PersistedDirectivesMagic);
+        W.write<uint32_t>(PersistedDirectivesVersion);
+        W.write<uint64_t>(Hash);
+        W.write<uint64_t>(Source.size());
+        W.write<uint32_t>(NumTokens);
+        W.write<uint32_t>(Directives.size());
+        for (const dependency_directives_scan::Directive &D : Directives)
+          for (const dependency_directives_scan::Token &T : D.Tokens) {
+            W.write<uint32_t>(T.Offset);
+            W.write<uint32_t>(T.Length);
+            W.write<uint16_t>(T.Kind);
+            W.write<uint16_t>(T.Flags);
+          }
+        for (const dependency_directives_scan::Directive &D : Directives) {
+          W.write<uint32_t>(D.Kind);
+          W.write<uint32_t>(D.Tokens.size());
+        }
+        return llvm::Error::success();
+      }));
+}
+
 llvm::ErrorOr<DependencyScanningWorkerFilesystem::TentativeEntry>
 DependencyScanningWorkerFilesystem::readFile(StringRef Filename) {
   // Load the file and its content from the file system.
@@ -62,10 +186,26 @@ bool DependencyScanningWorkerFilesystem::ensureDirectiveTokensArePopulated(
     return true;
 
   SmallVector<dependency_directives_scan::Directive, 64> Directives;
+  StringRef Source = Contents->Original->getBuffer();
+
+  // Reuse the directives persisted by an earlier scanning process, if any.
+  StringRef CachePath = SharedCache.getDirectivesCachePath();
+  uint64_t Hash = 0;
+  if (!CachePath.empty()) {
+    Hash = llvm::xxh3_64bits(Source);
+    if (readPersistedDirectives(CachePath, Source, Hash,
+                                Contents->DepDirectiveTokens, Directives)) {
+      Contents->DepDirectives.store(
+          new std::optional<DependencyDirectivesTy>(std::move(Directives)));
+      return true;
+    }
+    Contents->DepDirectiveTokens.clear();
+    Directives.clear();
+  }
+
   // Scan the file for preprocessor directives that might affect the
   // dependencies.
-  if (scanSourceForDependencyDirectives(Contents->Original->getBuffer(),
-                                        Contents->DepDirectiveTokens,
+  if (scanSourceForDependencyDirectives(Source, Contents->DepDirectiveTokens,
                                         Directives)) {
     Contents->DepDirectiveTokens.clear();
     // FIXME: Propagate the diagnostic if desired by the client.
@@ -73,6 +213,9 @@ bool DependencyScanningWorkerFilesystem::ensureDirectiveTokensArePopulated(
     return false;
   }
 
+  if (!CachePath.empty())
+    writePersistedDirectives(CachePath, Source, Hash, Directives);
+
   // This function performed double-checked locking using `DepDirectives`.
   // Assigning it must be the last thing this function does, otherwise other
   // threads may skip the critical section (`DepDirectives != nullptr`), leading
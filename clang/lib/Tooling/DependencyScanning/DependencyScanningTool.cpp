@@ -42,6 +42,8 @@ public:
   void handleDirectModuleDependency(ModuleID ID) override {}
   void handleContextHash(std::string Hash) override {}
 
+  ArrayRef<std::string> getDependencies() const { return Dependencies; }
+
   void printDependencies(std::string &S) {
     assert(Opts && "Handled dependency output options.");
 
@@ -71,7 +73,8 @@ protected:
 } // anonymous namespace
 
 llvm::Expected<std::string> DependencyScanningTool::getDependencyFile(
-    const std::vector<std::string> &CommandLine, StringRef CWD) {
+    const std::vector<std::string> &CommandLine, StringRef CWD,
+    std::vector<std::string> *FileDeps) {
   MakeDependencyPrinterConsumer Consumer;
   CallbackActionController Controller(nullptr);
   auto Result =
@@ -80,6 +83,8 @@ llvm::Expected<std::string> DependencyScanningTool::getDependencyFile(
     return std::move(Result);
   std::string Output;
   Consumer.printDependencies(Output);
+  if (FileDeps)
+    llvm::append_range(*FileDeps, Consumer.getDependencies());
   return Output;
 }
 
@@ -0,0 +1,55 @@
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode -analyzer-display-progress \
+// RUN:   -analyzer-config shard-count=2,shard-index=0 %s > %t.0 2>&1
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode -analyzer-display-progress \
+// RUN:   -analyzer-config shard-count=2,shard-index=1 %s > %t.1 2>&1
+// RUN: cat %t.0 %t.1 | FileCheck %s
+// RUN: cat %t.0 %t.1 | FileCheck %s --check-prefix=TOTAL
+// RUN: FileCheck %s --input-file=%t.0 --check-prefix=SHARD0
+// RUN: FileCheck %s --input-file=%t.1 --check-prefix=SHARD1
+//
+// The merged result does not depend on the shard count.
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode -analyzer-display-progress \
+// RUN:   -analyzer-config shard-count=3,shard-index=0 %s > %t.3.0 2>&1
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode -analyzer-display-progress \
+// RUN:   -analyzer-config shard-count=3,shard-index=1 %s > %t.3.1 2>&1
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode -analyzer-display-progress \
+// RUN:   -analyzer-config shard-count=3,shard-index=2 %s > %t.3.2 2>&1
+// RUN: cat %t.3.0 %t.3.1 %t.3.2 | FileCheck %s
+// RUN: cat %t.3.0 %t.3.1 %t.3.2 | FileCheck %s --check-prefix=TOTAL
+//
+// Without sharding, a function that was inlined into its caller is not
+// analyzed again as top-level.
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode -analyzer-display-progress \
+// RUN:   %s 2>&1 | FileCheck %s --check-prefix=UNSHARDED
+//
+// RUN: not %clang_analyze_cc1 -analyzer-checker=core \
+// RUN:   -analyzer-config shard-count=2,shard-index=2 %s 2>&1 | \
+// RUN:   FileCheck %s --check-prefix=INVALID
+
+// Every top-level function is analyzed in exactly one of the shards, including
+// the ones that are inlined into a caller, whichever shard the caller is in.
+// CHECK-DAG: ANALYZE (Path,  Inline_Regular): {{.*}} f1
+// CHECK-DAG: ANALYZE (Path,  Inline_Regular): {{.*}} f2
+// CHECK-DAG: ANALYZE (Path,  Inline_Regular): {{.*}} f3
+// CHECK-DAG: ANALYZE (Path,  Inline_Regular): {{.*}} f4
+// CHECK-DAG: ANALYZE (Path,  Inline_Regular): {{.*}} caller
+// CHECK-DAG: ANALYZE (Path,  Inline_Regular): {{.*}} callee
+// TOTAL-COUNT-6: ANALYZE (Path,
+// TOTAL-NOT: ANALYZE (Path,
+
+// UNSHARDED: ANALYZE (Path,  Inline_Regular): {{.*}} caller
+// UNSHARDED-NOT: ANALYZE (Path, {{.*}} callee
+
+// AST-based checks only run in the first shard.
+// SHARD0: ANALYZE (Syntax)
+// SHARD1-NOT: ANALYZE (Syntax)
+
+// INVALID: error: invalid input for analyzer-config option 'shard-index', that expects an unsigned less than 'shard-count' value
+
+void f1(void) {}
+void f2(void) {}
+void f3(void) {}
+void f4(void) {}
+
+int callee(int x) { return x + 1; }
+int caller(void) { return callee(1); }
@@ -0,0 +1,48 @@
+// Check that -server answers scan requests, reuses the results of unchanged
+// translation units and stops at a shutdown request.
+
+// RUN: rm -rf %t
+// RUN: split-file %s %t
+// RUN: sed -e "s|DIR|%/t|g" %t/cdb.json.template > %t/cdb.json
+// RUN: cat %t/requests.txt | clang-scan-deps -server -format=make -j 2 \
+// RUN:   -compilation-database %t/cdb.json | sed 's:\\\\\?:/:g' | FileCheck %s -DPREFIX=%/t
+
+// CHECK:      {"translation-units":[
+// CHECK-SAME: "dependencies":"{{.*}}a.o:{{.*}}[[PREFIX]]/a.c{{.*}}[[PREFIX]]/a.h
+// CHECK-SAME: "rescanned":true
+// CHECK-SAME: "dependencies":"{{.*}}b.o:{{.*}}[[PREFIX]]/b.c{{.*}}[[PREFIX]]/b.h
+// CHECK-SAME: "rescanned":true
+// CHECK-NEXT: {"error":"unknown request"}
+// CHECK-NEXT: {"translation-units":[
+// CHECK-SAME: "rescanned":false
+// CHECK-SAME: "rescanned":false
+// CHECK-NOT:  translation-units
+
+//--- cdb.json.template
+[
+  {
+    "directory": "DIR",
+    "command": "clang -c DIR/a.c -o DIR/a.o",
+    "file": "DIR/a.c"
+  },
+  {
+    "directory": "DIR",
+    "command": "clang -c DIR/b.c -o DIR/b.o",
+    "file": "DIR/b.c"
+  }
+]
+
+//--- requests.txt
+{"method":"scan"}
+{"method":"build"}
+{"method":"scan"}
+{"method":"shutdown"}
+{"method":"scan"}
+
+//--- a.h
+//--- a.c
+#include "a.h"
+
+//--- b.h
+//--- b.c
+#include "b.h"
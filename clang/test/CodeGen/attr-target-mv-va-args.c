@@ -49,6 +49,7 @@ int bar(void) {
 // IFUNC-MACHO: ret ptr @foo
 // IFUNC-MACHO: declare i32 @foo.arch_sandybridge(i32 noundef, ...)
 
+// NO-IFUNC: @foo.resolver.cache = internal global ptr null
 // NO-IFUNC: define dso_local i32 @foo.sse4.2(i32 noundef %i, ...)
 // NO-IFUNC: ret i32 0
 // NO-IFUNC: define dso_local i32 @foo.arch_ivybridge(i32 noundef %i, ...)
@@ -61,7 +62,16 @@ int bar(void) {
 
 // WINDOWS: define weak_odr dso_local i32 @foo.resolver(i32 %0, ...) comdat
 // NO-IFUNC-ELF: define weak_odr i32 @foo.resolver(i32 %0, ...) comdat
-// NO-IFUNC: musttail call i32 (i32, ...) @foo.arch_sandybridge
+// NO-IFUNC: %[[CACHED:.+]] = load atomic ptr, ptr @foo.resolver.cache monotonic, align 8
+// NO-IFUNC: %[[HAS_CACHED:.+]] = icmp ne ptr %[[CACHED]], null
+// NO-IFUNC: br i1 %[[HAS_CACHED]], label %resolver_cached, label %resolver_select
+// NO-IFUNC: resolver_cached:
+// NO-IFUNC-NEXT: %[[RET:.+]] = musttail call i32 (i32, ...) %[[CACHED]](i32 %0, ...)
+// NO-IFUNC-NEXT: ret i32 %[[RET]]
+// NO-IFUNC: resolver_select:
+// NO-IFUNC-NEXT: call void @__cpu_indicator_init()
+// NO-IFUNC: store atomic ptr @foo.arch_sandybridge, ptr @foo.resolver.cache monotonic, align 8
+// NO-IFUNC-NEXT: musttail call i32 (i32, ...) @foo.arch_sandybridge
 // NO-IFUNC: musttail call i32 (i32, ...) @foo.arch_ivybridge
 // NO-IFUNC: musttail call i32 (i32, ...) @foo.sse4.2
 // NO-IFUNC: musttail call i32 (i32, ...) @foo
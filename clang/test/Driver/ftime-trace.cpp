@@ -16,6 +16,15 @@
 // RUN: cat dir2/out.json \
 // RUN:   | %python -c 'import json, sys; json.dump(json.loads(sys.stdin.read()), sys.stdout, sort_keys=True, indent=2)' \
 // RUN:   | FileCheck %s
+// RUN: %clangxx -S -no-canonical-prefixes -ftime-trace=stream.json -ftime-trace-streaming -ftime-trace-granularity=0 -o out %s
+// RUN: cat stream.json \
+// RUN:   | %python -c 'import json, sys; json.dump(json.loads(sys.stdin.read()), sys.stdout, sort_keys=True, indent=2)' \
+// RUN:   | FileCheck %s
+// RUN: not %clangxx -S -no-canonical-prefixes -ftime-trace=missing/stream.json -ftime-trace-streaming -o out %s 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=STREAM-FAIL
+
+// STREAM-FAIL: warning: unable to stream time trace to 'missing/stream.json': {{.*}}; writing it at exit instead
+// STREAM-FAIL: error: unable to open output file 'missing/stream.json'
 
 // CHECK:      "beginningOfTime": {{[0-9]{16},}}
 // CHECK-NEXT: "traceEvents": [
@@ -37,6 +46,9 @@
 // RUN: %clang -### -c -ftime-trace -ftime-trace-granularity=0 -fintegrated-as d/a.cpp -o e/a.o 2>&1 | FileCheck %s --check-prefix=COMPILE1
 // COMPILE1: -cc1{{.*}} "-ftime-trace=e/a.json" "-ftime-trace-granularity=0"
 
+// RUN: %clang -### -c -ftime-trace -ftime-trace-granularity=0 -ftime-trace-streaming d/a.cpp -o e/a.o 2>&1 | FileCheck %s --check-prefix=STREAM
+// STREAM: -cc1{{.*}} "-ftime-trace=e/a.json" "-ftime-trace-granularity=0" "-ftime-trace-streaming"
+
 // RUN: %clang -### -c -ftime-trace -ftime-trace-granularity=0 d/a.cpp d/b.c -dumpdir f/ 2>&1 | FileCheck %s --check-prefix=COMPILE2
 // COMPILE2: -cc1{{.*}} "-ftime-trace=f/a.json" "-ftime-trace-granularity=0"
 // COMPILE2: -cc1{{.*}} "-ftime-trace=f/b.json" "-ftime-trace-granularity=0"
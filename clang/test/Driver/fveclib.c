@@ -5,6 +5,8 @@
 // RUN: %clang -### -c -fveclib=Darwin_libsystem_m %s 2>&1 | FileCheck -check-prefix CHECK-DARWIN_LIBSYSTEM_M %s
 // RUN: %clang -### -c --target=aarch64-none-none -fveclib=SLEEF %s 2>&1 | FileCheck -check-prefix CHECK-SLEEF %s
 // RUN: %clang -### -c --target=aarch64-none-none -fveclib=ArmPL %s 2>&1 | FileCheck -check-prefix CHECK-ARMPL %s
+// RUN: %clang -### -c --target=x86_64-none-none -fveclib=LLVMlibc %s 2>&1 | FileCheck -check-prefix CHECK-LLVMLIBC %s
+// RUN: %clang -### -c --target=aarch64-none-none -fveclib=LLVMlibc %s 2>&1 | FileCheck -check-prefix CHECK-LLVMLIBC %s
 // RUN: not %clang -c -fveclib=something %s 2>&1 | FileCheck -check-prefix CHECK-INVALID %s
 
 // CHECK-NOLIB: "-fveclib=none"
@@ -14,6 +16,7 @@
 // CHECK-DARWIN_LIBSYSTEM_M: "-fveclib=Darwin_libsystem_m"
 // CHECK-SLEEF: "-fveclib=SLEEF"
 // CHECK-ARMPL: "-fveclib=ArmPL"
+// CHECK-LLVMLIBC: "-fveclib=LLVMlibc"
 
 // CHECK-INVALID: error: invalid value 'something' in '-fveclib=something'
 
@@ -21,6 +24,7 @@
 // RUN: not %clang --target=x86-none-none -c -fveclib=ArmPL %s 2>&1 | FileCheck -check-prefix CHECK-ERROR %s
 // RUN: not %clang --target=aarch64-none-none -c -fveclib=LIBMVEC-X86 %s 2>&1 | FileCheck -check-prefix CHECK-ERROR %s
 // RUN: not %clang --target=aarch64-none-none -c -fveclib=SVML %s 2>&1 | FileCheck -check-prefix CHECK-ERROR %s
+// RUN: not %clang --target=x86-none-none -c -fveclib=LLVMlibc %s 2>&1 | FileCheck -check-prefix CHECK-ERROR %s
 // CHECK-ERROR: unsupported option {{.*}} for target
 
 // RUN: %clang -fveclib=Accelerate %s -target arm64-apple-ios8.0.0 -### 2>&1 | FileCheck --check-prefix=CHECK-LINK %s
@@ -49,3 +53,6 @@
 
 // RUN: %clang -### --target=aarch64-linux-gnu -fveclib=ArmPL -flto %s 2>&1 | FileCheck -check-prefix CHECK-LTO-ARMPL %s
 // CHECK-LTO-ARMPL: "-plugin-opt=-vector-library=ArmPL"
+
+// RUN: %clang -### --target=x86_64-unknown-linux-gnu -fveclib=LLVMlibc -flto %s 2>&1 | FileCheck -check-prefix CHECK-LTO-LLVMLIBC %s
+// CHECK-LTO-LLVMLIBC: "-plugin-opt=-vector-library=LLVMlibc"
@@ -27,17 +27,50 @@
 // RUN:     -o Hello.full.pcm -### 2>&1 | FileCheck Hello.cppm \
 // RUN:     --check-prefix=CHECK-EMIT-MODULE-INTERFACE
 //
-// RUN: %clang -std=c++20 Hello.cc -fexperimental-modules-reduced-bmi -Wall -Werror \
+// RUN: %clang -std=c++20 Hello.cc -fmodules-reduced-bmi -Wall -Werror \
 // RUN:     -c -o Hello.o -### 2>&1 | FileCheck Hello.cc
+//
+// RUN: %clang -std=c++20 Hello.cppm -fexperimental-modules-reduced-bmi -c \
+// RUN:     -o Hello.o -### 2>&1 | FileCheck Hello.cppm --check-prefix=CHECK-DEPRECATED
+//
+// RUN: %clang -std=c++20 Hello.cppm -fmodules-reduced-bmi -c -o Hello.o -### 2>&1 | \
+// RUN:     FileCheck Hello.cppm --check-prefix=CHECK-UNSPECIFIED
+//
+// Reduced BMIs are generated by default in the one-phase compilation model.
+// RUN: %clang -std=c++20 Hello.cppm -c -o Hello.o -### 2>&1 | \
+// RUN:     FileCheck Hello.cppm --check-prefix=CHECK-UNSPECIFIED
+//
+// RUN: %clang -std=c++20 Hello.cppm -fno-modules-reduced-bmi -c -o Hello.o \
+// RUN:     -### 2>&1 | FileCheck Hello.cppm --check-prefix=CHECK-FULL
+//
+// With '--precompile', the full BMI is generated unless asked otherwise.
+// RUN: %clang -std=c++20 Hello.cppm --precompile -o Hello.pcm -### 2>&1 | \
+// RUN:     FileCheck Hello.cppm --check-prefix=CHECK-PRECOMPILE-FULL
+//
+// RUN: %clang -std=c++20 Hello.cppm -fsyntax-only -### 2>&1 | \
+// RUN:     FileCheck Hello.cppm --check-prefix=CHECK-SYNTAX-ONLY
 
 //--- Hello.cppm
 export module Hello;
 
 // Test that we won't generate the emit-module-interface as 2 phase compilation model.
 // CHECK-NOT: -emit-module-interface
-// CHECK: "-fexperimental-modules-reduced-bmi"
+// CHECK: "-fmodules-reduced-bmi"
+
+// CHECK-UNSPECIFIED-NOT: -emit-module-interface
+// CHECK-UNSPECIFIED: "-fmodules-reduced-bmi"
+// CHECK-UNSPECIFIED-SAME: -fmodule-output=Hello.pcm
+
+// CHECK-FULL-NOT: "-fmodules-reduced-bmi"
+// CHECK-FULL: -emit-module-interface
+// CHECK-FULL-NOT: "-fmodules-reduced-bmi"
+
+// CHECK-PRECOMPILE-FULL: -emit-module-interface
+// CHECK-PRECOMPILE-FULL-NOT: "-fmodules-reduced-bmi"
+
+// CHECK-SYNTAX-ONLY-NOT: -fmodule-output=
 
-// CHECK-UNSPECIFIED: -fmodule-output=Hello.pcm
+// CHECK-DEPRECATED: warning: argument '-fexperimental-modules-reduced-bmi' is deprecated, use '-fmodules-reduced-bmi' instead
 
 // CHECK-NO-O: -fmodule-output=Hello.pcm
 // CHECK-ANOTHER-NAME: -fmodule-output=AnotherName.pcm
@@ -48,4 +81,4 @@ export module Hello;
 
 //--- Hello.cc
 
-// CHECK-NOT: "-fexperimental-modules-reduced-bmi"
+// CHECK-NOT: "-fmodules-reduced-bmi"
@@ -13,12 +13,13 @@
 // Tests that the .pcm file will be generated in the same directory with the specified
 // output and the name of the .pcm file should be the same with the input file.
 // RUN: %clang -std=c++20 %t/Hello.cppm -fmodule-output -c -o %t/output/Hello.o \
-// RUN:   -### 2>&1 | FileCheck %t/Hello.cppm
+// RUN:   -fno-modules-reduced-bmi -### 2>&1 | FileCheck %t/Hello.cppm
 //
 // Tests that the output file will be generated in the input directory if the output
 // file is not the corresponding object file.
 // RUN: %clang -std=c++20 %t/Hello.cppm %t/AnotherModule.cppm -fmodule-output -o \
-// RUN:   %t/output/a.out -### 2>&1 | FileCheck  %t/AnotherModule.cppm
+// RUN:   %t/output/a.out -fno-modules-reduced-bmi -### 2>&1 | \
+// RUN:   FileCheck  %t/AnotherModule.cppm
 //
 // Tests that clang will reject the command line if it specifies -fmodule-output with
 // multiple archs.
@@ -28,7 +29,8 @@
 // Tests that the .pcm file will be generated in the same path with the specified one
 // in the comamnd line.
 // RUN: %clang -std=c++20 %t/Hello.cppm -fmodule-output=%t/pcm/Hello.pcm -o %t/Hello.o \
-// RUN:   -c -### 2>&1 | FileCheck %t/Hello.cppm --check-prefix=CHECK-SPECIFIED
+// RUN:   -c -fno-modules-reduced-bmi -### 2>&1 | \
+// RUN:   FileCheck %t/Hello.cppm --check-prefix=CHECK-SPECIFIED
 //
 // RUN: %clang -std=c++20 %t/Hello.cppm -fmodule-output=%t/Hello.pcm -fmodule-output -c -fsyntax-only \
 // RUN:   -### 2>&1 | FileCheck %t/Hello.cppm --check-prefix=CHECK-NOT-USED
@@ -27,6 +27,14 @@
 // RUN: not %clang -fmodules -fmodules-validate-once-per-build-session -### %s 2>&1 | FileCheck -check-prefix=MODULES_VALIDATE_ONCE_ERR %s
 // MODULES_VALIDATE_ONCE_ERR: option '-fmodules-validate-once-per-build-session' requires '-fbuild-session-timestamp=<seconds since Epoch>' or '-fbuild-session-file=<file>'
 
+// RUN: %clang -fmodules -### %s 2>&1 | FileCheck -check-prefix=MODULES_FORCE_VALIDATE_USER_HEADERS_DEFAULT %s
+// MODULES_FORCE_VALIDATE_USER_HEADERS_DEFAULT-NOT: -fno-modules-force-validate-user-headers
+
+// RUN: %clang -fmodules -fno-modules-force-validate-user-headers -### %s 2>&1 | FileCheck -check-prefix=MODULES_NO_FORCE_VALIDATE_USER_HEADERS %s
+// MODULES_NO_FORCE_VALIDATE_USER_HEADERS: -fno-modules-force-validate-user-headers
+
+// RUN: %clang -fmodules -fno-modules-force-validate-user-headers -fmodules-force-validate-user-headers -### %s 2>&1 | FileCheck -check-prefix=MODULES_FORCE_VALIDATE_USER_HEADERS_DEFAULT %s
+
 // RUN: %clang -### %s 2>&1 | FileCheck -check-prefix=MODULES_VALIDATE_SYSTEM_HEADERS_DEFAULT %s
 // MODULES_VALIDATE_SYSTEM_HEADERS_DEFAULT-NOT: -fmodules-validate-system-headers
 
@@ -92,5 +100,8 @@
 // RUN: %clang -fno-modules -fmodules-validate-once-per-build-session -### %s 2>&1 | FileCheck -check-prefix=VALIDATE_ONCE_FLAG %s
 // VALIDATE_ONCE_FLAG-NOT: -fmodules-validate-once-per-build-session
 
+// RUN: %clang -fno-modules -fno-modules-force-validate-user-headers -### %s 2>&1 | FileCheck -check-prefix=FORCE_VALIDATE_USER_FLAG %s
+// FORCE_VALIDATE_USER_FLAG-NOT: -fno-modules-force-validate-user-headers
+
 // RUN: %clang -fno-modules -fmodules-validate-system-headers -### %s 2>&1 | FileCheck -check-prefix=VALIDATE_SYSTEM_FLAG %s
 // VALIDATE_SYSTEM_FLAG-NOT: -fmodules-validate-system-headers
@@ -0,0 +1,48 @@
+// Check that -j runs independent jobs in parallel but replays their output,
+// -v lines and failures in the order of a sequential run.
+
+// RUN: rm -rf %t && split-file %s %t && cd %t
+
+// RUN: %clang -j4 -fno-caret-diagnostics -c a.c b.c c.c 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=ORDER
+// RUN: ls a.o b.o c.o
+// ORDER:     a.c:1:2: warning: first
+// ORDER-NOT: warning:
+// ORDER:     b.c:1:2: warning: second
+// ORDER-NOT: warning:
+// ORDER:     c.c:1:2: warning: third
+
+// RUN: %clang -j 2 -v -fno-caret-diagnostics -c a.c b.c 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=VERBOSE
+// VERBOSE:     "-cc1"{{.*}} "a.c"
+// VERBOSE-NOT: "-cc1"
+// VERBOSE:     a.c:1:2: warning: first
+// VERBOSE:     "-cc1"{{.*}} "b.c"
+// VERBOSE:     b.c:1:2: warning: second
+
+// A failing job doesn't stop the independent ones, and the driver fails.
+// RUN: rm -f a.o c.o
+// RUN: not %clang -j4 -fno-caret-diagnostics -c a.c err.c c.c 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=FAIL
+// RUN: ls a.o c.o
+// RUN: not ls err.o
+// FAIL:     a.c:1:2: warning: first
+// FAIL:     err.c:1:2: error: broken
+// FAIL:     c.c:1:2: warning: third
+
+// Jobs that consume the output of earlier jobs wait for them.
+// RUN: rm -f a.o b.o
+// RUN: %clang -j4 -save-temps -Wno-#warnings -c a.c b.c
+// RUN: ls a.i a.bc a.s a.o b.i b.bc b.s b.o
+
+// RUN: not %clang -j0 -c a.c 2>&1 | FileCheck %s --check-prefix=INVALID
+// INVALID: error: invalid integral value '0' in '-j0'
+
+//--- a.c
+#warning first
+//--- b.c
+#warning second
+//--- c.c
+#warning third
+//--- err.c
+#error broken
@@ -27,6 +27,10 @@
 // RUN: cp %t/modules-cache/Bar.pcm %t/modules-to-compare/Bar-before.pcm
 // RUN: cp %t/modules-cache-user/Foo.pcm %t/modules-to-compare/Foo-before-user.pcm
 // RUN: cp %t/modules-cache-user/Bar.pcm %t/modules-to-compare/Bar-before-user.pcm
+// RUN: %clang_cc1 -cc1 -fmodules -fimplicit-module-maps -fdisable-module-hash -fmodules-cache-path=%t/modules-cache-user-noforce -fsyntax-only -I %t/Inputs -fmodules-validate-system-headers -fbuild-session-timestamp=1390000000 -fmodules-validate-once-per-build-session -fno-modules-force-validate-user-headers %s
+// RUN: ls -R %t/modules-cache-user-noforce | grep Foo.pcm.timestamp
+// RUN: cp %t/modules-cache-user-noforce/Foo.pcm %t/modules-to-compare/Foo-before-user-noforce.pcm
+// RUN: cp %t/modules-cache-user-noforce/Bar.pcm %t/modules-to-compare/Bar-before-user-noforce.pcm
 
 // ===
 // Use it, and make sure that we did not recompile it.
@@ -71,6 +75,13 @@
 // RUN: not diff %t/modules-to-compare/Foo-before-user.pcm %t/modules-to-compare/Foo-after-user.pcm
 // RUN: not diff %t/modules-to-compare/Bar-before-user.pcm %t/modules-to-compare/Bar-after-user.pcm
 
+// ===
+// Unless validation of user headers is not forced: then a module validated in
+// this build session is reused even though its user headers changed.
+// RUN: %clang_cc1 -cc1 -fmodules -fimplicit-module-maps -fdisable-module-hash -fmodules-cache-path=%t/modules-cache-user-noforce -fsyntax-only -I %t/Inputs -fmodules-validate-system-headers -fbuild-session-timestamp=1390000000 -fmodules-validate-once-per-build-session -fno-modules-force-validate-user-headers %s
+// RUN: diff %t/modules-to-compare/Foo-before-user-noforce.pcm %t/modules-cache-user-noforce/Foo.pcm
+// RUN: diff %t/modules-to-compare/Bar-before-user-noforce.pcm %t/modules-cache-user-noforce/Bar.pcm
+
 // ===
 // Recompile the module if the today's date is before 01 January 2100.
 // RUN: %clang_cc1 -cc1 -fmodules -fimplicit-module-maps -fdisable-module-hash -fmodules-cache-path=%t/modules-cache -fsyntax-only -isystem %t/Inputs -fmodules-validate-system-headers -fbuild-session-timestamp=4102441200 -fmodules-validate-once-per-build-session %s
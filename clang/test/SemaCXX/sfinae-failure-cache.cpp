@@ -0,0 +1,39 @@
+// RUN: %clang_cc1 -std=c++17 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -std=c++17 -fsyntax-only -print-stats %s 2>&1 | FileCheck %s
+
+// Failed substitutions into a function template declaration are remembered,
+// but must be retried once a later definition lets them succeed.
+
+// CHECK: {{[1-9][0-9]*}}/{{[0-9]+}} failed template argument substitutions reused.
+
+// expected-no-diagnostics
+
+template <bool B, class T = void> struct enable_if {};
+template <class T> struct enable_if<true, T> { using type = T; };
+
+struct S {
+  static constexpr int size(int);
+  static const int N;
+};
+
+template <class T>
+auto bySize(T) -> typename enable_if<S::size(T()) == 1, int>::type;
+char bySize(...);
+
+template <class T>
+auto byValue(T) -> typename enable_if<S::N + T() == 1, int>::type;
+char byValue(...);
+
+// Neither S::size nor S::N are usable in constant expressions yet, so
+// substitution fails and the fallbacks are picked. The second call reuses the
+// recorded failure.
+static_assert(sizeof(bySize(0)) == 1);
+static_assert(sizeof(bySize(0)) == 1);
+static_assert(sizeof(byValue(0)) == 1);
+static_assert(sizeof(byValue(0)) == 1);
+
+constexpr int S::size(int) { return 1; }
+const int S::N = 1;
+
+static_assert(sizeof(bySize(0)) == sizeof(int));
+static_assert(sizeof(byValue(0)) == sizeof(int));
@@ -42,6 +42,15 @@ static llvm::cl::list<std::string>
     ClangArgs("Xcc",
               llvm::cl::desc("Argument to pass to the CompilerInvocation"),
               llvm::cl::CommaSeparated);
+static llvm::cl::opt<std::string> OptPrelude(
+    "prelude",
+    llvm::cl::desc("C++ header to precompile and load before the first input"),
+    llvm::cl::value_desc("header"));
+static llvm::cl::opt<std::string> OptPreludePCH(
+    "prelude-pch",
+    llvm::cl::desc("Where to keep the precompiled --prelude header between "
+                   "sessions (default: <header>.pch)"),
+    llvm::cl::value_desc("file"));
 static llvm::cl::opt<bool> OptHostSupportsJit("host-supports-jit",
                                               llvm::cl::Hidden);
 static llvm::cl::list<std::string> OptInputs(llvm::cl::Positional,
@@ -167,6 +176,10 @@ int main(int argc, const char **argv) {
 
   clang::IncrementalCompilerBuilder CB;
   CB.SetCompilerArgs(ClangArgv);
+  if (!OptPrelude.empty())
+    CB.SetPrelude(OptPrelude, OptPreludePCH.empty()
+                                  ? std::string(OptPrelude + ".pch")
+                                  : std::string(OptPreludePCH));
 
   std::unique_ptr<clang::CompilerInstance> DeviceCI;
   if (CudaEnabled) {
@@ -28,6 +28,7 @@
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/TargetParser/Host.h"
+#include <cstdio>
 #include <mutex>
 #include <optional>
 #include <thread>
@@ -78,6 +79,7 @@ static ScanningOutputFormat Format = ScanningOutputFormat::Make;
 static ScanningOptimizations OptimizeArgs;
 static std::string ModuleFilesDir;
 static bool EagerLoadModules;
+static std::string DirectivesCachePath;
 static unsigned NumThreads = 0;
 static std::string CompilationDB;
 static std::string ModuleName;
@@ -86,6 +88,7 @@ static bool DeprecatedDriverCommand;
 static ResourceDirRecipeKind ResourceDirRecipe;
 static bool Verbose;
 static bool PrintTiming;
+static bool ServerMode;
 static std::vector<const char *> CommandLine;
 
 #ifndef NDEBUG
@@ -180,6 +183,10 @@ static void ParseArgs(int argc, char **argv) {
     OutputFileName = A->getValue();
 
   EagerLoadModules = Args.hasArg(OPT_eager_load_pcm);
+  ServerMode = Args.hasArg(OPT_server);
+
+  if (const llvm::opt::Arg *A = Args.getLastArg(OPT_directives_cache_path_EQ))
+    DirectivesCachePath = A->getValue();
 
   if (const llvm::opt::Arg *A = Args.getLastArg(OPT_j)) {
     StringRef S{A->getValue()};
@@ -781,6 +788,313 @@ getCompilationDatabase(int argc, char **argv, std::string &ErrorMessage) {
       FEOpts.Inputs[0].getFile(), OutputFile, CommandLine);
 }
 
+/// Rewrites a compilation database command line for scanning: keeps only the
+/// arguments before "--", makes the clang-cl output file explicit and adds a
+/// "-resource-dir" if requested.
+static tooling::CommandLineArguments
+adjustScanningCommandLine(const tooling::CommandLineArguments &Args,
+                          ResourceDirectoryCache &ResourceDirCache) {
+  std::string LastO;
+  bool HasResourceDir = false;
+  bool ClangCLMode = false;
+  auto FlagsEnd = llvm::find(Args, "--");
+  if (FlagsEnd != Args.begin()) {
+    ClangCLMode =
+        llvm::sys::path::stem(Args[0]).contains_insensitive("clang-cl") ||
+        llvm::is_contained(Args, "--driver-mode=cl");
+
+    // Reverse scan, starting at the end or at the element before "--".
+    auto R = std::make_reverse_iterator(FlagsEnd);
+    for (auto I = R, E = Args.rend(); I != E; ++I) {
+      StringRef Arg = *I;
+      if (ClangCLMode) {
+        // Ignore arguments that are preceded by "-Xclang".
+        if ((I + 1) != E && I[1] == "-Xclang")
+          continue;
+        if (LastO.empty()) {
+          // With clang-cl, the output obj file can be specified with
+          // "/opath", "/o path", "/Fopath", and the dash counterparts.
+          // Also, clang-cl adds ".obj" extension if none is found.
+          if ((Arg == "-o" || Arg == "/o") && I != R)
+            LastO = I[-1]; // Next argument (reverse iterator)
+          else if (Arg.starts_with("/Fo") || Arg.starts_with("-Fo"))
+            LastO = Arg.drop_front(3).str();
+          else if (Arg.starts_with("/o") || Arg.starts_with("-o"))
+            LastO = Arg.drop_front(2).str();
+
+          if (!LastO.empty() && !llvm::sys::path::has_extension(LastO))
+            LastO.append(".obj");
+        }
+      }
+      if (Arg == "-resource-dir")
+        HasResourceDir = true;
+    }
+  }
+  tooling::CommandLineArguments AdjustedArgs(Args.begin(), FlagsEnd);
+  // The clang-cl driver passes "-o -" to the frontend. Inject the real
+  // file here to ensure "-MT" can be deduced if need be.
+  if (ClangCLMode && !LastO.empty()) {
+    AdjustedArgs.push_back("/clang:-o");
+    AdjustedArgs.push_back("/clang:" + LastO);
+  }
+
+  if (!HasResourceDir && ResourceDirRecipe == RDRK_InvokeCompiler) {
+    StringRef ResourceDir = ResourceDirCache.findResourceDir(Args, ClangCLMode);
+    if (!ResourceDir.empty()) {
+      AdjustedArgs.push_back("-resource-dir");
+      AdjustedArgs.push_back(std::string(ResourceDir));
+    }
+  }
+  AdjustedArgs.insert(AdjustedArgs.end(), FlagsEnd, Args.end());
+  return AdjustedArgs;
+}
+
+namespace {
+/// The result of scanning one translation unit in server mode, together with
+/// the state of its inputs when it was scanned.
+struct ServerScanResult {
+  struct Input {
+    std::string Path;
+    llvm::sys::TimePoint<> ModTime;
+    uint64_t Size;
+  };
+
+  /// The dependency file, or the diagnostics if the scan failed.
+  std::string Output;
+  bool HadError = false;
+  std::vector<Input> Inputs;
+
+  /// Returns true if the result can be reused, i.e. the scan succeeded and
+  /// none of its inputs changed since.
+  bool isUpToDate() const {
+    if (HadError)
+      return false;
+    for (const Input &I : Inputs) {
+      llvm::sys::fs::file_status Status;
+      if (llvm::sys::fs::status(I.Path, Status) ||
+          Status.getLastModificationTime() != I.ModTime ||
+          Status.getSize() != I.Size)
+        return false;
+    }
+    return true;
+  }
+};
+} // end anonymous namespace
+
+/// Reads one line from stdin without the trailing newline. Returns false at
+/// the end of the input.
+static bool readLine(std::string &Line) {
+  Line.clear();
+  char Buf[4096];
+  while (std::fgets(Buf, sizeof(Buf), stdin)) {
+    Line += Buf;
+    if (Line.back() == '\n') {
+      Line.pop_back();
+      return true;
+    }
+  }
+  return !Line.empty();
+}
+
+static ServerScanResult scanForServer(DependencyScanningTool &Tool,
+                                      const tooling::CompileCommand &Input) {
+  ServerScanResult Result;
+  std::vector<std::string> FileDeps;
+  auto MaybeFile =
+      Tool.getDependencyFile(Input.CommandLine, Input.Directory, &FileDeps);
+  if (!MaybeFile) {
+    Result.HadError = true;
+    Result.Output = llvm::toString(MaybeFile.takeError());
+    return Result;
+  }
+  Result.Output = std::move(*MaybeFile);
+  for (const std::string &Dep : FileDeps) {
+    SmallString<256> Path(Dep);
+    llvm::sys::fs::make_absolute(Input.Directory, Path);
+    // Inputs that cannot be stat'ed now never compare equal later, so the
+    // translation unit is rescanned next time.
+    llvm::sys::fs::file_status Status;
+    if (llvm::sys::fs::status(Path, Status))
+      Result.Inputs.push_back({std::string(Path), {}, ~uint64_t(0)});
+    else
+      Result.Inputs.push_back({std::string(Path),
+                               Status.getLastModificationTime(),
+                               Status.getSize()});
+  }
+  return Result;
+}
+
+namespace {
+/// Answers the requests of -server mode. The scanning service and the results
+/// of previous scans are kept alive between requests, and stale translation
+/// units are scanned on a worker pool that also outlives the requests.
+class DependencyServer {
+public:
+  DependencyServer()
+      : Service(createService()),
+        Pool(llvm::hardware_concurrency(NumThreads)) {}
+
+  /// Handles one request line. Returns std::nullopt for a shutdown request,
+  /// and the reply otherwise.
+  std::optional<llvm::json::Value> handleRequest(StringRef Line);
+
+private:
+  static std::unique_ptr<DependencyScanningService> createService() {
+    auto Service = std::make_unique<DependencyScanningService>(
+        ScanMode, Format, OptimizeArgs, EagerLoadModules);
+    Service->getSharedCache().setDirectivesCachePath(DirectivesCachePath);
+    return Service;
+  }
+
+  /// Reloads the compilation database and returns its adjusted commands.
+  llvm::Expected<std::vector<tooling::CompileCommand>> loadInputs();
+
+  /// Scans the inputs at the given indices, spreading them over the pool.
+  void scanInputs(ArrayRef<tooling::CompileCommand> Inputs,
+                  ArrayRef<size_t> Indices,
+                  MutableArrayRef<ServerScanResult> Scanned);
+
+  llvm::json::Value handleScan();
+
+  std::unique_ptr<DependencyScanningService> Service;
+  ResourceDirectoryCache ResourceDirCache;
+  llvm::StringMap<ServerScanResult> Results;
+  llvm::DefaultThreadPool Pool;
+};
+} // end anonymous namespace
+
+std::optional<llvm::json::Value>
+DependencyServer::handleRequest(StringRef Line) {
+  llvm::Expected<llvm::json::Value> Request = llvm::json::parse(Line);
+  if (!Request)
+    return llvm::json::Object{{"error", llvm::toString(Request.takeError())}};
+  const llvm::json::Object *Obj = Request->getAsObject();
+  std::optional<StringRef> Method =
+      Obj ? Obj->getString("method") : std::nullopt;
+  if (Method && *Method == "shutdown")
+    return std::nullopt;
+  if (!Method || *Method != "scan")
+    return llvm::json::Object{{"error", "unknown request"}};
+  return handleScan();
+}
+
+llvm::Expected<std::vector<tooling::CompileCommand>>
+DependencyServer::loadInputs() {
+  std::string ErrorMessage;
+  std::unique_ptr<tooling::CompilationDatabase> DB =
+      tooling::JSONCompilationDatabase::loadFromFile(
+          CompilationDB, ErrorMessage,
+          tooling::JSONCommandLineSyntax::AutoDetect);
+  if (!DB)
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   ErrorMessage);
+  tooling::ArgumentsAdjustingCompilations Compilations(std::move(DB));
+  Compilations.appendArgumentsAdjuster(
+      [this](const tooling::CommandLineArguments &Args, StringRef FileName) {
+        return adjustScanningCommandLine(Args, ResourceDirCache);
+      });
+  return Compilations.getAllCompileCommands();
+}
+
+void DependencyServer::scanInputs(ArrayRef<tooling::CompileCommand> Inputs,
+                                  ArrayRef<size_t> Indices,
+                                  MutableArrayRef<ServerScanResult> Scanned) {
+  std::atomic<size_t> Next(0);
+  // Like the one-shot mode, every worker owns a tool and pulls translation
+  // units until none are left.
+  auto ScanningTask = [&] {
+    DependencyScanningTool WorkerTool(*Service);
+    for (size_t I = Next++; I < Indices.size(); I = Next++)
+      Scanned[I] = scanForServer(WorkerTool, Inputs[Indices[I]]);
+  };
+  if (Indices.size() <= 1) {
+    ScanningTask();
+    return;
+  }
+  unsigned NumWorkers =
+      std::min<size_t>(Pool.getMaxConcurrency(), Indices.size());
+  for (unsigned I = 0; I < NumWorkers; ++I)
+    Pool.async(ScanningTask);
+  Pool.wait();
+}
+
+llvm::json::Value DependencyServer::handleScan() {
+  llvm::Expected<std::vector<tooling::CompileCommand>> Inputs = loadInputs();
+  if (!Inputs)
+    return llvm::json::Object{{"error", llvm::toString(Inputs.takeError())}};
+
+  // A translation unit is keyed by its directory, file and command line, so
+  // that a changed command is scanned as a new translation unit.
+  std::vector<std::string> Keys;
+  std::vector<size_t> Stale;
+  bool InputsChanged = false;
+  for (size_t I = 0, E = Inputs->size(); I != E; ++I) {
+    const tooling::CompileCommand &Input = (*Inputs)[I];
+    std::string Key = Input.Directory + '\0' + Input.Filename;
+    for (const std::string &Arg : Input.CommandLine)
+      Key += '\0' + Arg;
+    auto It = Results.find(Key);
+    bool UpToDate = It != Results.end() && It->second.isUpToDate();
+    InputsChanged |= It != Results.end() && !UpToDate;
+    if (!UpToDate)
+      Stale.push_back(I);
+    Keys.push_back(std::move(Key));
+  }
+
+  // The service caches file contents and stat results for its lifetime, so
+  // once any known input changed it has to be replaced. Results of the
+  // translation units whose inputs are unchanged stay valid, and the
+  // persistent directives cache, if any, saves re-minimizing files.
+  if (InputsChanged)
+    Service = createService();
+
+  std::vector<ServerScanResult> Scanned(Stale.size());
+  scanInputs(*Inputs, Stale, Scanned);
+
+  llvm::StringMap<ServerScanResult> NewResults;
+  llvm::json::Array TUs;
+  for (size_t I = 0, S = 0, E = Inputs->size(); I != E; ++I) {
+    const tooling::CompileCommand &Input = (*Inputs)[I];
+    bool Rescanned = S < Stale.size() && Stale[S] == I;
+    ServerScanResult &Result = NewResults[Keys[I]];
+    Result = Rescanned ? std::move(Scanned[S++])
+                       : std::move(Results.find(Keys[I])->second);
+    TUs.push_back(llvm::json::Object{
+        {"file", Input.Filename},
+        {"directory", Input.Directory},
+        {Result.HadError ? "error" : "dependencies", Result.Output},
+        {"rescanned", Rescanned}});
+  }
+  // Forget translation units that are no longer in the database.
+  Results = std::move(NewResults);
+  return llvm::json::Object{{"translation-units", std::move(TUs)}};
+}
+
+/// Answers requests read from stdin, one JSON object per line, until the input
+/// ends or a {"method": "shutdown"} request arrives. A {"method": "scan"}
+/// request reloads the compilation database and replies with one line holding
+/// the make-format dependencies of every translation unit. Only translation
+/// units whose command line or inputs changed since their last scan are
+/// scanned again; the service is kept alive between requests.
+static int runServer() {
+  if (Format != ScanningOutputFormat::Make || CompilationDB.empty()) {
+    llvm::errs() << "clang-scan-deps: -server requires '-format=make' and "
+                    "'-compilation-database'\n";
+    return 1;
+  }
+
+  DependencyServer Server;
+  std::string Line;
+  while (readLine(Line)) {
+    std::optional<llvm::json::Value> Response = Server.handleRequest(Line);
+    if (!Response)
+      break;
+    llvm::outs() << *Response << '\n';
+    llvm::outs().flush();
+  }
+  return 0;
+}
+
 int clang_scan_deps_main(int argc, char **argv, const llvm::ToolContext &) {
   std::string ErrorMessage;
   std::unique_ptr<tooling::CompilationDatabase> Compilations =
@@ -792,6 +1106,9 @@ int clang_scan_deps_main(int argc, char **argv, const llvm::ToolContext &) {
 
   llvm::cl::PrintOptionValues();
 
+  if (ServerMode)
+    return runServer();
+
   // The command options are rewritten to run Clang in preprocessor only mode.
   auto AdjustingCompilations =
       std::make_unique<tooling::ArgumentsAdjustingCompilations>(
@@ -801,60 +1118,7 @@ int clang_scan_deps_main(int argc, char **argv, const llvm::ToolContext &) {
   AdjustingCompilations->appendArgumentsAdjuster(
       [&ResourceDirCache](const tooling::CommandLineArguments &Args,
                           StringRef FileName) {
-        std::string LastO;
-        bool HasResourceDir = false;
-        bool ClangCLMode = false;
-        auto FlagsEnd = llvm::find(Args, "--");
-        if (FlagsEnd != Args.begin()) {
-          ClangCLMode =
-              llvm::sys::path::stem(Args[0]).contains_insensitive("clang-cl") ||
-              llvm::is_contained(Args, "--driver-mode=cl");
-
-          // Reverse scan, starting at the end or at the element before "--".
-          auto R = std::make_reverse_iterator(FlagsEnd);
-          for (auto I = R, E = Args.rend(); I != E; ++I) {
-            StringRef Arg = *I;
-            if (ClangCLMode) {
-              // Ignore arguments that are preceded by "-Xclang".
-              if ((I + 1) != E && I[1] == "-Xclang")
-                continue;
-              if (LastO.empty()) {
-                // With clang-cl, the output obj file can be specified with
-                // "/opath", "/o path", "/Fopath", and the dash counterparts.
-                // Also, clang-cl adds ".obj" extension if none is found.
-                if ((Arg == "-o" || Arg == "/o") && I != R)
-                  LastO = I[-1]; // Next argument (reverse iterator)
-                else if (Arg.starts_with("/Fo") || Arg.starts_with("-Fo"))
-                  LastO = Arg.drop_front(3).str();
-                else if (Arg.starts_with("/o") || Arg.starts_with("-o"))
-                  LastO = Arg.drop_front(2).str();
-
-                if (!LastO.empty() && !llvm::sys::path::has_extension(LastO))
-                  LastO.append(".obj");
-              }
-            }
-            if (Arg == "-resource-dir")
-              HasResourceDir = true;
-          }
-        }
-        tooling::CommandLineArguments AdjustedArgs(Args.begin(), FlagsEnd);
-        // The clang-cl driver passes "-o -" to the frontend. Inject the real
-        // file here to ensure "-MT" can be deduced if need be.
-        if (ClangCLMode && !LastO.empty()) {
-          AdjustedArgs.push_back("/clang:-o");
-          AdjustedArgs.push_back("/clang:" + LastO);
-        }
-
-        if (!HasResourceDir && ResourceDirRecipe == RDRK_InvokeCompiler) {
-          StringRef ResourceDir =
-              ResourceDirCache.findResourceDir(Args, ClangCLMode);
-          if (!ResourceDir.empty()) {
-            AdjustedArgs.push_back("-resource-dir");
-            AdjustedArgs.push_back(std::string(ResourceDir));
-          }
-        }
-        AdjustedArgs.insert(AdjustedArgs.end(), FlagsEnd, Args.end());
-        return AdjustedArgs;
+        return adjustScanningCommandLine(Args, ResourceDirCache);
       });
 
   SharedStream Errs(llvm::errs());
@@ -985,6 +1249,7 @@ int clang_scan_deps_main(int argc, char **argv, const llvm::ToolContext &) {
 
   DependencyScanningService Service(ScanMode, Format, OptimizeArgs,
                                     EagerLoadModules);
+  Service.getSharedCache().setDirectivesCachePath(DirectivesCachePath);
 
   llvm::Timer T;
   T.startTimer();
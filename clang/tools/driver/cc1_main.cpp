@@ -226,6 +226,17 @@ int cc1_main(ArrayRef<const char *> Argv, const char *Argv0, void *MainAddr) {
     return 1;
   }
 
+  // If the trace can't be streamed, keep it in memory and write it at exit
+  // like without -ftime-trace-streaming.
+  if (llvm::timeTraceProfilerEnabled() &&
+      Clang->getFrontendOpts().TimeTraceStreaming) {
+    if (llvm::Error E = llvm::timeTraceProfilerStartStreaming(
+            Clang->getFrontendOpts().TimeTracePath))
+      Clang->getDiagnostics().Report(diag::warn_fe_time_trace_streaming_failure)
+          << Clang->getFrontendOpts().TimeTracePath
+          << llvm::toString(std::move(E));
+  }
+
   // Execute the frontend actions.
   {
     llvm::TimeTraceScope TimeScope("ExecuteCompiler");
@@ -237,7 +248,13 @@ int cc1_main(ArrayRef<const char *> Argv, const char *Argv0, void *MainAddr) {
   llvm::TimerGroup::printAll(llvm::errs());
   llvm::TimerGroup::clearAll();
 
-  if (llvm::timeTraceProfilerEnabled()) {
+  if (llvm::timeTraceProfilerStreaming()) {
+    if (llvm::Error E = llvm::timeTraceProfilerFinishStreaming())
+      Clang->getDiagnostics().Report(diag::err_fe_unable_to_open_output)
+          << Clang->getFrontendOpts().TimeTracePath
+          << llvm::toString(std::move(E));
+    llvm::timeTraceProfilerCleanup();
+  } else if (llvm::timeTraceProfilerEnabled()) {
     // It is possible that the compiler instance doesn't own a file manager here
     // if we're compiling a module unit. Since the file manager are owned by AST
     // when we're compiling a module unit. So the file manager may be invalid
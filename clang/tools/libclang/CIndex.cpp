@@ -57,6 +57,7 @@
 #include "llvm/Support/SaveAndRestore.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
@@ -4270,6 +4271,57 @@ enum CXErrorCode clang_parseTranslationUnit2FullArgv(
   return result;
 }
 
+enum CXErrorCode clang_parseTranslationUnits(
+    CXIndex CIdx, unsigned num_translation_units,
+    const char *const *source_filenames,
+    const char *const *const *command_line_args,
+    const int *num_command_line_args, struct CXUnsavedFile *unsaved_files,
+    unsigned num_unsaved_files, unsigned options, unsigned num_threads,
+    CXTranslationUnit *out_TUs, enum CXErrorCode *out_errors) {
+  if (!CIdx || !out_TUs || !out_errors ||
+      (num_translation_units &&
+       (!source_filenames || !command_line_args || !num_command_line_args)) ||
+      (num_unsaved_files && !unsaved_files))
+    return CXError_InvalidArguments;
+
+  for (unsigned I = 0; I != num_translation_units; ++I) {
+    out_TUs[I] = nullptr;
+    out_errors[I] = CXError_Failure;
+  }
+
+  // Each task parses a different translation unit into its own slots. CIndexer
+  // computes its resource and toolchain paths lazily on first use, so compute
+  // them here, before any worker starts; afterwards the workers only read the
+  // state shared through CIdx.
+  CIndexer *CXXIdx = static_cast<CIndexer *>(CIdx);
+  CXXIdx->getClangResourcesPath();
+  CXXIdx->getClangToolchainPath();
+
+  auto Parse = [&](unsigned I) {
+    out_errors[I] = clang_parseTranslationUnit2FullArgv(
+        CIdx, source_filenames[I], command_line_args[I],
+        num_command_line_args[I], unsaved_files, num_unsaved_files, options,
+        &out_TUs[I]);
+  };
+  unsigned NumThreads =
+      num_threads ? num_threads
+                  : llvm::hardware_concurrency().compute_thread_count();
+  if (NumThreads <= 1 || num_translation_units <= 1) {
+    for (unsigned I = 0; I != num_translation_units; ++I)
+      Parse(I);
+  } else {
+    llvm::DefaultThreadPool Pool(llvm::hardware_concurrency(NumThreads));
+    for (unsigned I = 0; I != num_translation_units; ++I)
+      Pool.async(Parse, I);
+    Pool.wait();
+  }
+
+  for (unsigned I = 0; I != num_translation_units; ++I)
+    if (out_errors[I] != CXError_Success)
+      return out_errors[I];
+  return CXError_Success;
+}
+
 CXString clang_Type_getObjCEncoding(CXType CT) {
   CXTranslationUnit tu = static_cast<CXTranslationUnit>(CT.data[1]);
   ASTContext &Ctx = getASTUnit(tu)->getASTContext();
@@ -123,6 +123,37 @@ TEST_F(DataflowAnalysisContextTest, JoinFlowConditions) {
   EXPECT_TRUE(Context.flowConditionImplies(FC3, C3));
 }
 
+TEST(DataflowAnalysisContextSolverTest, RepeatedQueriesAreCached) {
+  class CountingSolver : public WatchedLiteralsSolver {
+  public:
+    Result solve(llvm::ArrayRef<const Formula *> Vals) override {
+      ++Calls;
+      return WatchedLiteralsSolver::solve(Vals);
+    }
+    unsigned Calls = 0;
+  };
+
+  CountingSolver S;
+  DataflowAnalysisContext Context(S);
+  Arena &A = Context.arena();
+  Atom FC = A.makeFlowConditionToken();
+  auto &C = A.makeAtomRef(A.makeAtom());
+  auto &D = A.makeAtomRef(A.makeAtom());
+  Context.addFlowConditionConstraint(FC, C);
+
+  EXPECT_TRUE(Context.flowConditionImplies(FC, C));
+  EXPECT_EQ(S.Calls, 1u);
+  EXPECT_TRUE(Context.flowConditionImplies(FC, C));
+  EXPECT_EQ(S.Calls, 1u);
+
+  // Strengthening the flow condition changes the query, so the solver runs
+  // again and sees the new constraint.
+  EXPECT_FALSE(Context.flowConditionImplies(FC, D));
+  Context.addFlowConditionConstraint(FC, D);
+  EXPECT_TRUE(Context.flowConditionImplies(FC, D));
+  EXPECT_EQ(S.Calls, 3u);
+}
+
 TEST_F(DataflowAnalysisContextTest, EquivBoolVals) {
   auto &X = A.makeAtomRef(A.makeAtom());
   auto &Y = A.makeAtomRef(A.makeAtom());
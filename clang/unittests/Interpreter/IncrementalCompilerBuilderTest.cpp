@@ -11,6 +11,8 @@
 #include "clang/Interpreter/Interpreter.h"
 #include "clang/Lex/PreprocessorOptions.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -44,4 +46,25 @@ TEST(IncrementalCompilerBuilder, SetTargetTriple) {
   cleanupRemappedFileBuffers(*CI);
 }
 
+TEST(IncrementalCompilerBuilder, SetPrelude) {
+  int FD;
+  SmallString<128> Header;
+  ASSERT_FALSE(sys::fs::createTemporaryFile("prelude", "h", FD, Header));
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << "inline int prelude_value() { return 42; }\n";
+  }
+  std::string PCH = (Header + ".pch").str();
+
+  auto CB = clang::IncrementalCompilerBuilder();
+  CB.SetPrelude(Header, PCH);
+  auto CI = cantFail(CB.CreateCpp());
+  EXPECT_EQ(CI->getPreprocessorOpts().ImplicitPCHInclude, PCH);
+  EXPECT_TRUE(sys::fs::exists(PCH));
+  cleanupRemappedFileBuffers(*CI);
+
+  sys::fs::remove(PCH);
+  sys::fs::remove(Header);
+}
+
 } // end anonymous namespace
@@ -107,6 +107,52 @@ TEST(Store, VariableBind) {
       "void foo() { int x0, y0, z0, x1, y1; }"));
 }
 
+// Test that storing a value that is already bound does not create a new
+// store, while storing a different one does.
+class RebindConsumer : public StoreTestConsumer {
+  void performTest(const Decl *D) override {
+    StoreManager &SManager = Eng.getStoreManager();
+    SValBuilder &Builder = Eng.getSValBuilder();
+    MemRegionManager &MRManager = SManager.getRegionManager();
+    const ASTContext &ASTCtxt = Eng.getContext();
+
+    const auto *VDX = findDeclByName<VarDecl>(D, "x");
+    const auto *VDS = findDeclByName<VarDecl>(D, "s");
+    const auto *FDA = findDeclByName<FieldDecl>(D, "a");
+    ASSERT_TRUE(VDX && VDS && FDA);
+
+    const StackFrameContext *SFC =
+        Eng.getAnalysisDeclContextManager().getStackFrame(D);
+
+    Loc LX = loc::MemRegionVal(MRManager.getVarRegion(VDX, SFC));
+    Loc LA = loc::MemRegionVal(
+        MRManager.getFieldRegion(FDA, MRManager.getVarRegion(VDS, SFC)));
+
+    Store StInit = SManager.getInitialStore(SFC).getStore();
+    SVal Zero = Builder.makeZeroVal(ASTCtxt.IntTy);
+    SVal One = Builder.makeIntVal(1, ASTCtxt.IntTy);
+
+    Store StX0 = SManager.Bind(StInit, LX, Zero).getStore();
+    EXPECT_EQ(StX0, SManager.Bind(StX0, LX, Zero).getStore());
+    Store StX1 = SManager.Bind(StX0, LX, One).getStore();
+    EXPECT_NE(StX0, StX1);
+    EXPECT_EQ(One, SManager.getBinding(StX1, LX, ASTCtxt.IntTy));
+
+    Store StA0 = SManager.Bind(StInit, LA, Zero).getStore();
+    EXPECT_EQ(StA0, SManager.Bind(StA0, LA, Zero).getStore());
+    EXPECT_EQ(Zero, SManager.getBinding(StA0, LA, ASTCtxt.IntTy));
+  }
+
+public:
+  using StoreTestConsumer::StoreTestConsumer;
+};
+
+TEST(Store, Rebind) {
+  EXPECT_TRUE(tooling::runToolOnCode(
+      std::make_unique<TestAction<RebindConsumer>>(),
+      "void foo() { struct S { int a; } s; int x; }", "input.c"));
+}
+
 class LiteralCompoundConsumer : public StoreTestConsumer {
   void performTest(const Decl *D) override {
     StoreManager &SManager = Eng.getStoreManager();
@@ -8,7 +8,9 @@
 
 #include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace clang::tooling::dependencies;
@@ -174,3 +176,62 @@ TEST(DependencyScanningFilesystem, CacheStatOnExists) {
   EXPECT_EQ(InstrumentingFS->NumStatusCalls, 2u);
   EXPECT_EQ(InstrumentingFS->NumExistsCalls, 0u);
 }
+
+TEST(DependencyScanningFilesystem, PersistDirectiveTokens) {
+  llvm::SmallString<128> CacheDir;
+  ASSERT_FALSE(
+      llvm::sys::fs::createUniqueDirectory("scan-deps-directives", CacheDir));
+
+  auto InMemoryFS = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  InMemoryFS->setCurrentWorkingDirectory("/");
+  InMemoryFS->addFile("/header.h", 0,
+                      llvm::MemoryBuffer::getMemBuffer(
+                          "#ifndef HEADER_H\n#define HEADER_H\n"
+                          "#include \"other.h\"\nint x;\n#endif\n"));
+
+  auto Scan = [&](std::vector<std::pair<unsigned, unsigned>> &Result) {
+    DependencyScanningFilesystemSharedCache SharedCache;
+    SharedCache.setDirectivesCachePath(CacheDir);
+    DependencyScanningWorkerFilesystem DepFS(SharedCache, InMemoryFS);
+    auto Entry = DepFS.getOrCreateFileSystemEntry("/header.h");
+    ASSERT_TRUE(Entry);
+    ASSERT_TRUE(DepFS.ensureDirectiveTokensArePopulated(*Entry));
+    for (const auto &D : *Entry->getDirectiveTokens())
+      for (const auto &T : D.Tokens)
+        Result.push_back({D.Kind, T.Offset});
+  };
+
+  auto CountEntries = [&] {
+    std::error_code EC;
+    unsigned Count = 0;
+    for (llvm::sys::fs::directory_iterator I(CacheDir, EC), E; I != E && !EC;
+         I.increment(EC))
+      ++Count;
+    return Count;
+  };
+
+  std::vector<std::pair<unsigned, unsigned>> Scanned, Loaded;
+  Scan(Scanned);
+  EXPECT_FALSE(Scanned.empty());
+  EXPECT_EQ(CountEntries(), 1u);
+
+  // A fresh shared cache, as in a new process, reads the persisted entry.
+  Scan(Loaded);
+  EXPECT_EQ(Scanned, Loaded);
+  EXPECT_EQ(CountEntries(), 1u);
+
+  // A damaged entry is ignored and rewritten.
+  std::error_code EC;
+  llvm::sys::fs::directory_iterator I(CacheDir, EC);
+  ASSERT_FALSE(EC);
+  {
+    llvm::raw_fd_ostream OS(I->path(), EC);
+    ASSERT_FALSE(EC);
+    OS << "garbage";
+  }
+  Loaded.clear();
+  Scan(Loaded);
+  EXPECT_EQ(Scanned, Loaded);
+
+  llvm::sys::fs::remove_directories(CacheDir);
+}
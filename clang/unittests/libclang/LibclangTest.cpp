@@ -755,6 +755,37 @@ TEST_F(LibclangReparseTest, clang_parseTranslationUnit2FullArgv) {
   DisplayDiagnostics();
 }
 
+TEST_F(LibclangParseTest, clang_parseTranslationUnits) {
+  std::string Header = "header.h", Good = "good.cpp", Bad = "bad.cpp";
+  WriteFile(Header, "int f();\n");
+  WriteFile(Good, "#include \"header.h\"\nint x = f();\n");
+  WriteFile(Bad, "#include \"missing.h\"\n");
+
+  const char *Argv[] = {"clang"};
+  const char *Files[] = {Good.c_str(), Bad.c_str(), Good.c_str()};
+  const char *const *Args[] = {Argv, Argv, Argv};
+  int NumArgs[] = {1, 1, 1};
+  CXTranslationUnit TUs[3];
+  CXErrorCode Errors[3];
+  EXPECT_EQ(CXError_Success,
+            clang_parseTranslationUnits(Index, 3, Files, Args, NumArgs,
+                                        nullptr, 0, TUFlags,
+                                        /*num_threads=*/2, TUs, Errors));
+  for (unsigned I = 0; I != 3; ++I) {
+    EXPECT_EQ(CXError_Success, Errors[I]);
+    ASSERT_NE(nullptr, TUs[I]);
+  }
+  EXPECT_EQ(0U, clang_getNumDiagnostics(TUs[0]));
+  EXPECT_EQ(1U, clang_getNumDiagnostics(TUs[1]));
+  EXPECT_EQ(0U, clang_getNumDiagnostics(TUs[2]));
+  for (CXTranslationUnit TU : TUs)
+    clang_disposeTranslationUnit(TU);
+
+  EXPECT_EQ(CXError_InvalidArguments,
+            clang_parseTranslationUnits(Index, 3, nullptr, Args, NumArgs,
+                                        nullptr, 0, TUFlags, 0, TUs, Errors));
+}
+
 class LibclangPrintingPolicyTest : public LibclangParseTest {
 public:
   CXPrintingPolicy Policy = nullptr;
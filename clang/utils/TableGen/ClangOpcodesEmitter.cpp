@@ -34,7 +34,8 @@ private:
   /// The name is obtained by concatenating the name with the list of types.
   void EmitEnum(raw_ostream &OS, StringRef N, const Record *R);
 
-  /// Emits the switch case and the invocation in the interpreter.
+  /// Emits the switch case and the invocation in the interpreter, as well as
+  /// the entry in the dispatch table of the threaded interpreter.
   void EmitInterp(raw_ostream &OS, StringRef N, const Record *R);
 
   /// Emits the disassembler.
@@ -119,7 +120,7 @@ void ClangOpcodesEmitter::EmitInterp(raw_ostream &OS, StringRef N,
               bool ChangesPC = R->getValueAsBit("ChangesPC");
               const auto &Args = R->getValueAsListOfDefs("Args");
 
-              OS << "case OP_" << ID << ": {\n";
+              OS << "INTERP_CASE(OP_" << ID << ") {\n";
 
               if (CanReturn)
                 OS << "  bool DoReturn = (S.Current == StartFrame);\n";
@@ -162,10 +163,18 @@ void ClangOpcodesEmitter::EmitInterp(raw_ostream &OS, StringRef N,
                 OS << "    return true;\n";
               }
 
-              OS << "  continue;\n";
               OS << "}\n";
+              OS << "INTERP_NEXT();\n";
             });
   OS << "#endif\n";
+
+  // The dispatch table used by the threaded interpreter loop. Entries are in
+  // the same order as the opcode enum.
+  OS << "#ifdef GET_INTERP_DISPATCH\n";
+  Enumerate(R, N, [&OS](ArrayRef<const Record *>, const Twine &ID) {
+    OS << "&&L_OP_" << ID << ",\n";
+  });
+  OS << "#endif\n";
 }
 
 void ClangOpcodesEmitter::EmitDisasm(raw_ostream &OS, StringRef N,
@@ -239,8 +239,18 @@ struct QuarantineCallback {
         CHECK_EQ(old_chunk_state, CHUNK_QUARANTINE);
       }
 
-      PoisonShadow(m->Beg(), RoundUpTo(m->UsedSize(), ASAN_SHADOW_GRANULARITY),
-                   kAsanHeapLeftRedzoneMagic);
+      int lazy_size = flags()->lazy_recycle_poisoning_size;
+      if (lazy_size > 0 && m->UsedSize() >= static_cast<uptr>(lazy_size)) {
+        // Leave the freed memory poisoned as such, and only unpoison the first
+        // granule of the block. This makes Allocate() poison the whole block
+        // again in a single pass if it's reused, rather than poisoning the
+        // user memory here and once more in Allocate().
+        *(u8 *)MEM_TO_SHADOW(reinterpret_cast<uptr>(p)) = 0;
+      } else {
+        PoisonShadow(m->Beg(),
+                     RoundUpTo(m->UsedSize(), ASAN_SHADOW_GRANULARITY),
+                     kAsanHeapLeftRedzoneMagic);
+      }
     }
 
     // Statistics.
@@ -608,27 +618,29 @@ struct Allocator {
 
     m->SetAllocContext(t ? t->tid() : kMainTid, StackDepotPut(*stack));
 
-    if (!from_primary || *(u8 *)MEM_TO_SHADOW((uptr)allocated) == 0) {
+    if ((!from_primary || *(u8 *)MEM_TO_SHADOW((uptr)allocated) == 0) &&
+        CanPoisonMemory()) {
       // The allocator provides an unpoisoned chunk. This is possible for the
-      // secondary allocator, or if CanPoisonMemory() was false for some time,
-      // for example, due to flags()->start_disabled. Anyway, poison left and
-      // right of the block before using it for anything else.
-      uptr tail_beg = RoundUpTo(user_end, ASAN_SHADOW_GRANULARITY);
+      // secondary allocator, if CanPoisonMemory() was false for some time, for
+      // example, due to flags()->start_disabled, or if the chunk was recycled
+      // lazily (see QuarantineCallback::Recycle). Poison left and right of the
+      // block and unpoison the user memory in a single pass.
       uptr tail_end = alloc_beg + allocator.GetActuallyAllocatedSize(allocated);
-      PoisonShadow(alloc_beg, user_beg - alloc_beg, kAsanHeapLeftRedzoneMagic);
-      PoisonShadow(tail_beg, tail_end - tail_beg, kAsanHeapLeftRedzoneMagic);
-    }
-
-    uptr size_rounded_down_to_granularity =
-        RoundDownTo(size, ASAN_SHADOW_GRANULARITY);
-    // Unpoison the bulk of the memory region.
-    if (size_rounded_down_to_granularity)
-      PoisonShadow(user_beg, size_rounded_down_to_granularity, 0);
-    // Deal with the end of the region if size is not aligned to granularity.
-    if (size != size_rounded_down_to_granularity && CanPoisonMemory()) {
-      u8 *shadow =
-          (u8 *)MemToShadow(user_beg + size_rounded_down_to_granularity);
-      *shadow = fl.poison_partial ? (size & (ASAN_SHADOW_GRANULARITY - 1)) : 0;
+      FastPoisonShadowForChunk(alloc_beg, user_beg, size, tail_end,
+                               kAsanHeapLeftRedzoneMagic);
+    } else {
+      uptr size_rounded_down_to_granularity =
+          RoundDownTo(size, ASAN_SHADOW_GRANULARITY);
+      // Unpoison the bulk of the memory region.
+      if (size_rounded_down_to_granularity)
+        PoisonShadow(user_beg, size_rounded_down_to_granularity, 0);
+      // Deal with the end of the region if size is not aligned to granularity.
+      if (size != size_rounded_down_to_granularity && CanPoisonMemory()) {
+        u8 *shadow =
+            (u8 *)MemToShadow(user_beg + size_rounded_down_to_granularity);
+        *shadow =
+            fl.poison_partial ? (size & (ASAN_SHADOW_GRANULARITY - 1)) : 0;
+      }
     }
 
     AsanStats &thread_stats = GetCurrentThreadStats();
@@ -33,6 +33,25 @@ void PoisonShadowPartialRightRedzone(uptr addr,
                                      uptr redzone_size,
                                      u8 value);
 
+// Fills "size" bytes of shadow memory starting at "shadow" with "value".
+// Short ranges, which is what most heap chunks need, are written inline with
+// word sized stores rather than through a call to memset.
+ALWAYS_INLINE void FastFillShadow(uptr shadow, uptr size, u8 value) {
+  static constexpr uptr kMaxInlineFillSize = 256;
+  if (size > kMaxInlineFillSize) {
+    REAL(memset)((void *)shadow, value, size);
+    return;
+  }
+  uptr end = shadow + size;
+  uptr word = value * (~static_cast<uptr>(0) / 0xff);
+  for (; shadow < end && !IsAligned(shadow, sizeof(uptr)); shadow++)
+    *(u8 *)shadow = value;
+  for (; shadow + sizeof(uptr) <= end; shadow += sizeof(uptr))
+    *(uptr *)shadow = word;
+  for (; shadow < end; shadow++)
+    *(u8 *)shadow = value;
+}
+
 // Fast versions of PoisonShadow and PoisonShadowPartialRightRedzone that
 // assume that memory addresses are properly aligned. Use in
 // performance-critical code with care.
@@ -52,7 +71,7 @@ ALWAYS_INLINE void FastPoisonShadow(uptr aligned_beg, uptr aligned_size,
   // For now, just memset on Windows.
   if (value || SANITIZER_WINDOWS == 1 ||
       shadow_end - shadow_beg < common_flags()->clear_shadow_mmap_threshold) {
-    REAL(memset)((void*)shadow_beg, value, shadow_end - shadow_beg);
+    FastFillShadow(shadow_beg, shadow_end - shadow_beg, value);
   } else {
     uptr page_size = GetPageSizeCached();
     uptr page_beg = RoundUpTo(shadow_beg, page_size);
@@ -91,6 +110,35 @@ ALWAYS_INLINE void FastPoisonShadowPartialRightRedzone(
   }
 }
 
+// Poisons the shadow of a whole heap block in one pass: [block_beg, user_beg)
+// and everything after the user memory up to block_end get "redzone_value",
+// the user memory is made addressable, with a partially addressable last
+// granule if "user_size" is not a multiple of the granularity. block_beg,
+// user_beg and block_end must be aligned by granularity.
+ALWAYS_INLINE void FastPoisonShadowForChunk(uptr block_beg, uptr user_beg,
+                                            uptr user_size, uptr block_end,
+                                            u8 redzone_value) {
+  DCHECK(CanPoisonMemory());
+  FastFillShadow(MEM_TO_SHADOW(block_beg),
+                 (user_beg - block_beg) / ASAN_SHADOW_GRANULARITY,
+                 redzone_value);
+  uptr user_size_aligned = RoundDownTo(user_size, ASAN_SHADOW_GRANULARITY);
+  // This keeps the page remapping done for huge chunks by FastPoisonShadow.
+  if (user_size_aligned)
+    FastPoisonShadow(user_beg, user_size_aligned, 0);
+  uptr tail_beg = user_beg + user_size_aligned;
+  if (user_size != user_size_aligned) {
+    *(u8 *)MEM_TO_SHADOW(tail_beg) =
+        flags()->poison_partial ? (user_size & (ASAN_SHADOW_GRANULARITY - 1))
+                                : 0;
+    tail_beg += ASAN_SHADOW_GRANULARITY;
+  }
+  if (tail_beg < block_end)
+    FastFillShadow(MEM_TO_SHADOW(tail_beg),
+                   (block_end - tail_beg) / ASAN_SHADOW_GRANULARITY,
+                   redzone_value);
+}
+
 // Calls __sanitizer::ReleaseMemoryPagesToOS() on
 // [MemToShadow(p), MemToShadow(p+size)].
 void FlushUnneededASanShadowMemory(uptr p, uptr size);
@@ -8,6 +8,7 @@
 
 #include "CtxInstrProfiling.h"
 #include "sanitizer_common/sanitizer_allocator_internal.h"
+#include "sanitizer_common/sanitizer_atomic.h"
 #include "sanitizer_common/sanitizer_common.h"
 #include "sanitizer_common/sanitizer_dense_map.h"
 #include "sanitizer_common/sanitizer_libc.h"
@@ -27,6 +28,12 @@ __sanitizer::SpinMutex AllContextsMutex;
 SANITIZER_GUARDED_BY(AllContextsMutex)
 __sanitizer::Vector<ContextRoot *> AllContextRoots;
 
+// Sampled collection parameters, see __llvm_ctx_profile_set_sampling.
+__sanitizer::atomic_uint32_t SamplingPeriod = {1};
+__sanitizer::atomic_uint64_t MemoryBudget = {0};
+// Number of root entries this thread still skips before the next sampled one.
+__thread uint32_t SamplingCountdown = 0;
+
 // utility to taint a pointer by setting the LSB. There is an assumption
 // throughout that the addresses of contexts are even (really, they should be
 // align(8), but "even"-ness is the minimum assumption)
@@ -57,6 +64,24 @@ size_t getArenaAllocSize(size_t Needed) {
   return kBuffSize;
 }
 
+uint64_t getMemoryUse(const ContextRoot *Root) {
+  uint64_t Total = 0;
+  for (const auto *Mem = Root->FirstMemBlock; Mem; Mem = Mem->next())
+    Total += sizeof(Arena) + Mem->size();
+  return Total;
+}
+
+// Size of the subtree rooted at Node, without the subcontexts entered at most
+// Threshold times.
+uint64_t getSubtreeSize(const ContextNode &Node, uint64_t Threshold) {
+  uint64_t Total = Node.size();
+  for (uint32_t I = 0; I < Node.callsites_size(); ++I)
+    for (const auto *Sub = Node.subContexts()[I]; Sub; Sub = Sub->next())
+      if (Sub->entrycount() > Threshold)
+        Total += getSubtreeSize(*Sub, Threshold);
+  return Total;
+}
+
 // verify the structural integrity of the context
 bool validate(const ContextRoot *Root) {
   // all contexts should be laid out in some arena page. Go over each arena
@@ -152,14 +177,73 @@ void ContextNode::reset() {
       Next->reset();
 }
 
+// Copies the subtree rooted at Node to the arenas starting at Mem, skipping the
+// subcontexts entered at most Threshold times, and halving the counters.
+ContextNode *copyContextTree(ContextNode &Node, Arena *&Mem,
+                             uint64_t Threshold, ContextNode *Next) {
+  char *Place = Mem->tryBumpAllocate(Node.size());
+  if (!Place) {
+    Mem = Arena::allocateNewArena(getArenaAllocSize(Node.size()), Mem);
+    Place = Mem->tryBumpAllocate(Node.size());
+  }
+  auto *Copy = ContextNode::alloc(Place, Node.guid(), Node.counters_size(),
+                                  Node.callsites_size(), Next);
+  for (uint32_t I = 0; I < Node.counters_size(); ++I)
+    Copy->counters()[I] = Node.counters()[I] >> 1;
+  for (uint32_t I = 0; I < Node.callsites_size(); ++I) {
+    Copy->subContexts()[I] = nullptr;
+    for (auto *Sub = Node.subContexts()[I]; Sub; Sub = Sub->next())
+      if (Sub->entrycount() > Threshold)
+        Copy->subContexts()[I] =
+            copyContextTree(*Sub, Mem, Threshold, Copy->subContexts()[I]);
+  }
+  return Copy;
+}
+
+// Rebuilds the context tree of Root in new arenas, dropping the coldest
+// subtrees so that the result fits in half of the memory budget. Must be
+// called with Root->Taken held and when no context of the tree is in use, i.e.
+// when entering the root.
+void compactContextTree(ContextRoot *Root) {
+  const uint64_t Target =
+      __sanitizer::atomic_load_relaxed(&MemoryBudget) / 2;
+  Root->NeedsCompaction = false;
+  // The budget may have been lifted since the tree ran out of memory.
+  if (!Target)
+    return;
+  uint64_t Threshold = 0;
+  for (uint32_t Shift = 0;
+       Shift < 64 && getSubtreeSize(*Root->FirstNode, Threshold) > Target;
+       ++Shift)
+    Threshold = 1ULL << Shift;
+
+  auto *FirstMem = Arena::allocateNewArena(
+      getArenaAllocSize(getSubtreeSize(*Root->FirstNode, Threshold)));
+  auto *Mem = FirstMem;
+  auto *FirstNode = copyContextTree(*Root->FirstNode, Mem, Threshold, nullptr);
+  Arena::freeArenaList(Root->FirstMemBlock);
+  Root->FirstMemBlock = FirstMem;
+  Root->CurrentMem = Mem;
+  Root->FirstNode = FirstNode;
+}
+
 // If this is the first time we hit a callsite with this (Guid) particular
-// callee, we need to allocate.
+// callee, we need to allocate. Returns nullptr if that would go over the
+// memory budget.
 ContextNode *getCallsiteSlow(uint64_t Guid, ContextNode **InsertionPoint,
                              uint32_t NrCounters, uint32_t NrCallsites) {
   auto AllocSize = ContextNode::getAllocSize(NrCounters, NrCallsites);
-  auto *Mem = __llvm_ctx_profile_current_context_root->CurrentMem;
+  auto *Root = __llvm_ctx_profile_current_context_root;
+  auto *Mem = Root->CurrentMem;
   char *AllocPlace = Mem->tryBumpAllocate(AllocSize);
   if (!AllocPlace) {
+    const auto Budget = __sanitizer::atomic_load_relaxed(&MemoryBudget);
+    if (Budget && getMemoryUse(Root) + sizeof(Arena) +
+                          getArenaAllocSize(AllocSize) >
+                      Budget) {
+      Root->NeedsCompaction = true;
+      return nullptr;
+    }
     // if we failed to allocate on the current arena, allocate a new arena,
     // and place it on __llvm_ctx_profile_current_context_root->CurrentMem so we
     // find it from now on for other cases when we need to getCallsiteSlow.
@@ -218,6 +302,8 @@ ContextNode *__llvm_ctx_profile_get_context(void *Callee, GUID Guid,
   auto *Ret = Callsite ? Callsite
                        : getCallsiteSlow(Guid, CallsiteContext, NrCounters,
                                          NrCallsites);
+  if (!Ret)
+    return TheScratchContext;
   if (Ret->callsites_size() != NrCallsites ||
       Ret->counters_size() != NrCounters)
     __sanitizer::Printf("[ctxprof] Returned ctx differs from what's asked: "
@@ -249,10 +335,20 @@ void setupContext(ContextRoot *Root, GUID Guid, uint32_t NrCounters,
 ContextNode *__llvm_ctx_profile_start_context(
     ContextRoot *Root, GUID Guid, uint32_t Counters,
     uint32_t Callsites) SANITIZER_NO_THREAD_SAFETY_ANALYSIS {
+  // Skip the entries that aren't sampled.
+  if (SamplingCountdown > 0) {
+    --SamplingCountdown;
+    __llvm_ctx_profile_current_context_root = nullptr;
+    return TheScratchContext;
+  }
+  SamplingCountdown = __sanitizer::atomic_load_relaxed(&SamplingPeriod) - 1;
+
   if (!Root->FirstMemBlock) {
     setupContext(Root, Guid, Counters, Callsites);
   }
   if (Root->Taken.TryLock()) {
+    if (Root->NeedsCompaction)
+      compactContextTree(Root);
     __llvm_ctx_profile_current_context_root = Root;
     Root->FirstNode->onEntry();
     return Root->FirstNode;
@@ -306,6 +402,11 @@ bool __llvm_ctx_profile_fetch(
   return true;
 }
 
+void __llvm_ctx_profile_set_sampling(uint32_t Period, uint64_t MaxMemBytes) {
+  __sanitizer::atomic_store_relaxed(&SamplingPeriod, Period ? Period : 1);
+  __sanitizer::atomic_store_relaxed(&MemoryBudget, MaxMemBytes);
+}
+
 void __llvm_ctx_profile_free() {
   __sanitizer::GenericScopedLock<__sanitizer::SpinMutex> Lock(
       &AllContextsMutex);
@@ -142,6 +142,7 @@ public:
 
   GUID guid() const { return Guid; }
   ContextNode *next() { return Next; }
+  const ContextNode *next() const { return Next; }
 
   size_t size() const { return getAllocSize(NrCounters, NrCallsites); }
 
@@ -197,6 +198,11 @@ struct ContextRoot {
   // instrumentation lowering side because it is responsible for allocating and
   // zero-initializing ContextRoots.
   static_assert(sizeof(Taken) == 1);
+
+  // Set, with Taken held, when the memory budget (see
+  // __llvm_ctx_profile_set_sampling) prevented allocating a new context. The
+  // tree is then compacted the next time the root is entered.
+  bool NeedsCompaction = false;
 };
 
 /// This API is exposed for testing. See the APIs below about the contract with
@@ -248,6 +254,17 @@ __llvm_ctx_profile_get_context(void *Callee, __ctx_profile::GUID Guid,
 /// internal context tree structure.
 void __llvm_ctx_profile_start_collection();
 
+/// Configures sampled collection, meant for long running processes. Only one
+/// out of SamplingPeriod entries in a root, per thread, is profiled; the other
+/// ones get a scratch context. If MaxMemBytes isn't 0, the memory used by the
+/// context tree of each root is bounded by it (rounded up to the size of an
+/// arena). When a root runs out of memory, its tree is rebuilt without its
+/// coldest subtrees, and the counters of the remaining contexts are halved so
+/// that subtrees that stop being hot age out over time. The defaults, 1 and 0,
+/// profile every entry without any memory bound.
+void __llvm_ctx_profile_set_sampling(uint32_t SamplingPeriod,
+                                     uint64_t MaxMemBytes);
+
 /// Completely free allocated memory.
 void __llvm_ctx_profile_free();
 
@@ -873,6 +873,7 @@ int FuzzerDriver(int *argc, char ***argv, UserCallback Callback) {
   }
 
   Options.ForkCorpusGroups = Flags.fork_corpus_groups;
+  Options.ForkParallelMerge = Flags.fork_parallel_merge;
   if (Flags.fork)
     FuzzWithFork(F->GetMD().GetRand(), Options, Args, *Inputs, Flags.fork);
 
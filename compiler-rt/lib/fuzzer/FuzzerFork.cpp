@@ -76,6 +76,11 @@ struct FuzzJob {
   // Fuzzing Outputs.
   int ExitCode;
 
+  // Merge Outputs.
+  Stats JobStats;
+  std::vector<std::string> FilesToAdd;
+  std::set<uint32_t> NewFeatures, NewCov;
+
   ~FuzzJob() {
     RemoveFile(CFPath);
     RemoveFile(LogPath);
@@ -101,6 +106,11 @@ struct GlobalEnv {
   int Verbosity = 0;
   int Group = 0;
   int NumCorpuses = 8;
+  bool ParallelMerge = false;
+  int InterruptExitCode = 0;
+  // Guards Features and Cov against concurrent reads from the worker threads
+  // when ParallelMerge is set. Only the main thread modifies them.
+  std::mutex FeaturesMu;
 
   size_t NumTimeouts = 0;
   size_t NumOOMs = 0;
@@ -196,46 +206,81 @@ struct GlobalEnv {
     return Job;
   }
 
-  void RunOneMergeJob(FuzzJob *Job) {
-    auto Stats = ParseFinalStatsFromLog(Job->LogPath);
-    NumRuns += Stats.number_of_executed_units;
+  // Selects the inputs of a finished job that have features not seen so far
+  // and minimizes them with CrashResistantMerge. The results are stored in the
+  // job and the environment is left untouched, so with ParallelMerge this runs
+  // on the worker thread of the job, against a snapshot of the features.
+  void MergeJob(FuzzJob *Job) {
+    Job->JobStats = ParseFinalStatsFromLog(Job->LogPath);
 
     std::vector<SizedFile> TempFiles, MergeCandidates;
     // Read all newly created inputs and their feature sets.
     // Choose only those inputs that have new features.
     GetSizedFilesFromDir(Job->CorpusDir, &TempFiles);
     std::sort(TempFiles.begin(), TempFiles.end());
-    for (auto &F : TempFiles) {
-      auto FeatureFile = F.File;
-      FeatureFile.replace(0, Job->CorpusDir.size(), Job->FeaturesDir);
-      auto FeatureBytes = FileToVector(FeatureFile, 0, false);
-      assert((FeatureBytes.size() % sizeof(uint32_t)) == 0);
-      std::vector<uint32_t> NewFeatures(FeatureBytes.size() / sizeof(uint32_t));
-      memcpy(NewFeatures.data(), FeatureBytes.data(), FeatureBytes.size());
-      for (auto Ft : NewFeatures) {
-        if (!Features.count(Ft)) {
-          MergeCandidates.push_back(F);
-          break;
+    const std::set<uint32_t> *MergeFeatures = &Features, *MergeCov = &Cov;
+    std::set<uint32_t> FeaturesSnapshot, CovSnapshot;
+    {
+      std::lock_guard<std::mutex> Lock(FeaturesMu);
+      for (auto &F : TempFiles) {
+        auto FeatureFile = F.File;
+        FeatureFile.replace(0, Job->CorpusDir.size(), Job->FeaturesDir);
+        auto FeatureBytes = FileToVector(FeatureFile, 0, false);
+        assert((FeatureBytes.size() % sizeof(uint32_t)) == 0);
+        std::vector<uint32_t> NewFeatures(FeatureBytes.size() /
+                                          sizeof(uint32_t));
+        memcpy(NewFeatures.data(), FeatureBytes.data(), FeatureBytes.size());
+        for (auto Ft : NewFeatures) {
+          if (!Features.count(Ft)) {
+            MergeCandidates.push_back(F);
+            break;
+          }
         }
       }
+      if (ParallelMerge && !MergeCandidates.empty()) {
+        FeaturesSnapshot = Features;
+        CovSnapshot = Cov;
+        MergeFeatures = &FeaturesSnapshot;
+        MergeCov = &CovSnapshot;
+      }
     }
-    // if (!FilesToAdd.empty() || Job->ExitCode != 0)
-    Printf("#%zd: cov: %zd ft: %zd corp: %zd exec/s: %zd "
-           "oom/timeout/crash: %zd/%zd/%zd time: %zds job: %zd dft_time: %d\n",
-           NumRuns, Cov.size(), Features.size(), Files.size(),
-           Stats.average_exec_per_sec, NumOOMs, NumTimeouts, NumCrashes,
-           secondsSinceProcessStartUp(), Job->JobId, Job->DftTimeInSeconds);
 
     if (MergeCandidates.empty()) return;
 
-    std::vector<std::string> FilesToAdd;
-    std::set<uint32_t> NewFeatures, NewCov;
     bool IsSetCoverMerge =
         !Job->Cmd.getFlagValue("set_cover_merge").compare("1");
-    CrashResistantMerge(Args, {}, MergeCandidates, &FilesToAdd, Features,
-                        &NewFeatures, Cov, &NewCov, Job->CFPath, false,
-                        IsSetCoverMerge);
-    for (auto &Path : FilesToAdd) {
+    CrashResistantMerge(Args, {}, MergeCandidates, &Job->FilesToAdd,
+                        *MergeFeatures, &Job->NewFeatures, *MergeCov,
+                        &Job->NewCov, Job->CFPath, false, IsSetCoverMerge);
+  }
+
+  void RunOneMergeJob(FuzzJob *Job) {
+    if (!ParallelMerge)
+      MergeJob(Job);
+    NumRuns += Job->JobStats.number_of_executed_units;
+
+    // if (!FilesToAdd.empty() || Job->ExitCode != 0)
+    Printf("#%zd: cov: %zd ft: %zd corp: %zd exec/s: %zd "
+           "oom/timeout/crash: %zd/%zd/%zd time: %zds job: %zd dft_time: %d\n",
+           NumRuns, Cov.size(), Features.size(), Files.size(),
+           Job->JobStats.average_exec_per_sec, NumOOMs, NumTimeouts,
+           NumCrashes, secondsSinceProcessStartUp(), Job->JobId,
+           Job->DftTimeInSeconds);
+
+    if (Job->FilesToAdd.empty() && Job->NewFeatures.empty() &&
+        Job->NewCov.empty())
+      return;
+
+    // Jobs merged in parallel may have found the same features, only keep the
+    // inputs of the first one.
+    if (ParallelMerge &&
+        std::includes(Features.begin(), Features.end(),
+                      Job->NewFeatures.begin(), Job->NewFeatures.end()) &&
+        std::includes(Cov.begin(), Cov.end(), Job->NewCov.begin(),
+                      Job->NewCov.end()))
+      return;
+
+    for (auto &Path : Job->FilesToAdd) {
       auto U = FileToVector(Path);
       auto NewPath = DirPlusFile(MainCorpusDir, Hash(U));
       WriteToFile(U, NewPath);
@@ -250,9 +295,15 @@ struct GlobalEnv {
         Files.push_back(NewPath);
       }
     }
-    Features.insert(NewFeatures.begin(), NewFeatures.end());
-    Cov.insert(NewCov.begin(), NewCov.end());
-    for (auto Idx : NewCov)
+    std::vector<uint32_t> AddedCov;
+    {
+      std::lock_guard<std::mutex> Lock(FeaturesMu);
+      Features.insert(Job->NewFeatures.begin(), Job->NewFeatures.end());
+      for (auto Idx : Job->NewCov)
+        if (Cov.insert(Idx).second)
+          AddedCov.push_back(Idx);
+    }
+    for (auto Idx : AddedCov)
       if (auto *TE = TPC.PCTableEntryByIdx(Idx))
         if (TPC.PcIsFuncEntry(TE))
           PrintPC("  NEW_FUNC: %p %F %L\n", "",
@@ -300,10 +351,12 @@ struct JobQueue {
   }
 };
 
-void WorkerThread(JobQueue *FuzzQ, JobQueue *MergeQ) {
+void WorkerThread(GlobalEnv *Env, JobQueue *FuzzQ, JobQueue *MergeQ) {
   while (auto Job = FuzzQ->Pop()) {
     // Printf("WorkerThread: job %p\n", Job);
     Job->ExitCode = ExecuteCommand(Job->Cmd);
+    if (Env->ParallelMerge && Job->ExitCode != Env->InterruptExitCode)
+      Env->MergeJob(Job);
     MergeQ->Push(Job);
   }
 }
@@ -322,6 +375,8 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
   Env.ProcessStartTime = std::chrono::system_clock::now();
   Env.DataFlowBinary = Options.CollectDataFlow;
   Env.Group = Options.ForkCorpusGroups;
+  Env.ParallelMerge = Options.ForkParallelMerge;
+  Env.InterruptExitCode = Options.InterruptExitCode;
 
   std::vector<SizedFile> SeedFiles;
   for (auto &Dir : CorpusDirs)
@@ -377,7 +432,7 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
   size_t JobId = 1;
   std::vector<std::thread> Threads;
   for (int t = 0; t < NumJobs; t++) {
-    Threads.push_back(std::thread(WorkerThread, &FuzzQ, &MergeQ));
+    Threads.push_back(std::thread(WorkerThread, &Env, &FuzzQ, &MergeQ));
     FuzzQ.Push(Env.CreateNewJob(JobId++));
   }
 
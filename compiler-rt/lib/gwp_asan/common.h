@@ -56,6 +56,10 @@ static constexpr uint64_t kInvalidThreadID = UINT64_MAX;
 // implementation is platform-specific.
 uint64_t getThreadID();
 
+// Get a monotonic timestamp in nanoseconds. Note: This implementation is
+// platform-specific.
+uint64_t getMonotonicTimeNs();
+
 // This struct contains all the metadata recorded about a single allocation made
 // by GWP-ASan. If `AllocationMetadata.Addr` is zero, the metadata is non-valid.
 struct AllocationMetadata {
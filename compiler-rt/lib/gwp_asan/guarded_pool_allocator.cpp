@@ -36,6 +36,11 @@ uintptr_t getPageAddr(uintptr_t Ptr, uintptr_t PageSize) {
 }
 
 bool isPowerOfTwo(uintptr_t X) { return (X & (X - 1)) == 0; }
+
+// How far the adaptive sampling may lower the sampling frequency, and how often
+// it reconsiders the sample rate.
+constexpr uint32_t kMaxSampleRateScale = 64;
+constexpr uint64_t kSampleRateWindowNs = 100 * 1000 * 1000;
 } // anonymous namespace
 
 // Gets the singleton implementation of this class. Thread-compatible until
@@ -56,6 +61,8 @@ void GuardedPoolAllocator::init(const options::Options &Opts) {
   Check(Opts.SampleRate < (1 << 30), "GWP-ASan Error: SampleRate is >= 2^30.");
   Check(Opts.MaxSimultaneousAllocations >= 0,
         "GWP-ASan Error: MaxSimultaneousAllocations is < 0.");
+  Check(Opts.ProtectTimeBudgetPerMille >= 0,
+        "GWP-ASan Error: ProtectTimeBudgetPerMille is < 0.");
 
   SingletonPtr = this;
   Backtrace = Opts.Backtrace;
@@ -98,12 +105,16 @@ void GuardedPoolAllocator::init(const options::Options &Opts) {
   FreeSlots =
       reinterpret_cast<size_t *>(map(BytesRequired, kGwpAsanFreeSlotsName));
 
-  // Multiply the sample rate by 2 to give a good, fast approximation for (1 /
-  // SampleRate) chance of sampling.
-  if (Opts.SampleRate != 1)
-    AdjustedSampleRatePlusOne = static_cast<uint32_t>(Opts.SampleRate) * 2 + 1;
-  else
-    AdjustedSampleRatePlusOne = 2;
+  MinSampleRate = static_cast<uint32_t>(Opts.SampleRate);
+  MaxSampleRate = MinSampleRate;
+  ProtectTimeBudgetPerMille =
+      static_cast<uint32_t>(Opts.ProtectTimeBudgetPerMille);
+  if (ProtectTimeBudgetPerMille) {
+    uint64_t Max = static_cast<uint64_t>(MinSampleRate) * kMaxSampleRateScale;
+    MaxSampleRate = Max < (1 << 30) ? static_cast<uint32_t>(Max) : (1 << 30) - 1;
+    WindowStartNs = getMonotonicTimeNs();
+  }
+  setSampleRate(MinSampleRate);
 
   initPRNG();
   getThreadLocals()->NextSampleCounter =
@@ -118,6 +129,52 @@ void GuardedPoolAllocator::init(const options::Options &Opts) {
     installAtFork();
 }
 
+void GuardedPoolAllocator::setSampleRate(uint32_t Rate) {
+  CurrentSampleRate = Rate;
+  // Multiply the sample rate by 2 to give a good, fast approximation for (1 /
+  // SampleRate) chance of sampling.
+  __atomic_store_n(&AdjustedSampleRatePlusOne, Rate != 1 ? Rate * 2 + 1 : 2,
+                   __ATOMIC_RELAXED);
+}
+
+void GuardedPoolAllocator::recordProtectTime(uint64_t Start) {
+  __atomic_fetch_add(&ProtectTimeNs, getMonotonicTimeNs() - Start,
+                     __ATOMIC_RELAXED);
+}
+
+void GuardedPoolAllocator::adaptSampleRate() {
+  if (!ProtectTimeBudgetPerMille)
+    return;
+  const uint64_t Now = getMonotonicTimeNs();
+  const uint64_t Elapsed = Now - WindowStartNs;
+  if (Elapsed < kSampleRateWindowNs)
+    return;
+
+  const uint64_t TotalProtectNs =
+      __atomic_load_n(&ProtectTimeNs, __ATOMIC_RELAXED);
+  const uint64_t Spent = TotalProtectNs - WindowProtectTimeNs;
+  const uint64_t Budget = Elapsed / 1000 * ProtectTimeBudgetPerMille;
+  uint32_t Rate = CurrentSampleRate;
+  if (Spent > Budget)
+    Rate = Rate > MaxSampleRate / 2 ? MaxSampleRate : Rate * 2;
+  else if (Spent < Budget / 2)
+    Rate = Rate / 2 < MinSampleRate ? MinSampleRate : Rate / 2;
+  if (Rate != CurrentSampleRate)
+    setSampleRate(Rate);
+
+  WindowStartNs = Now;
+  WindowProtectTimeNs = TotalProtectNs;
+}
+
+void GuardedPoolAllocator::getStats(Stats *S) {
+  ScopedLock L(PoolMutex);
+  S->PoolOccupancy = NumSampledAllocations - FreeSlotsLength;
+  S->SamplesTaken = __atomic_load_n(&SamplesTaken, __ATOMIC_RELAXED);
+  S->SamplesDropped = __atomic_load_n(&SamplesDropped, __ATOMIC_RELAXED);
+  S->ProtectTimeNs = __atomic_load_n(&ProtectTimeNs, __ATOMIC_RELAXED);
+  S->CurrentSampleRate = CurrentSampleRate;
+}
+
 void GuardedPoolAllocator::disable() {
   PoolMutex.lock();
   BacktraceMutex.lock();
@@ -214,12 +271,12 @@ void *GuardedPoolAllocator::allocate(size_t Size, size_t Alignment) {
     Alignment = alignof(max_align_t);
 
   if (!isPowerOfTwo(Alignment) || Alignment > State.maximumAllocationSize() ||
-      Size > State.maximumAllocationSize())
-    return nullptr;
-
-  size_t BackingSize = getRequiredBackingSize(Size, Alignment, State.PageSize);
-  if (BackingSize > State.maximumAllocationSize())
+      Size > State.maximumAllocationSize() ||
+      getRequiredBackingSize(Size, Alignment, State.PageSize) >
+          State.maximumAllocationSize()) {
+    __atomic_fetch_add(&SamplesDropped, 1, __ATOMIC_RELAXED);
     return nullptr;
+  }
 
   // Protect against recursivity.
   if (getThreadLocals()->RecursiveGuard)
@@ -232,8 +289,11 @@ void *GuardedPoolAllocator::allocate(size_t Size, size_t Alignment) {
     Index = reserveSlot();
   }
 
-  if (Index == kInvalidSlotID)
+  if (Index == kInvalidSlotID) {
+    __atomic_fetch_add(&SamplesDropped, 1, __ATOMIC_RELAXED);
     return nullptr;
+  }
+  __atomic_fetch_add(&SamplesTaken, 1, __ATOMIC_RELAXED);
 
   uintptr_t SlotStart = State.slotToAddr(Index);
   AllocationMetadata *Meta = addrToMetadata(SlotStart);
@@ -253,9 +313,11 @@ void *GuardedPoolAllocator::allocate(size_t Size, size_t Alignment) {
   // page, we can improve overflow detection by leaving the unused pages as
   // unmapped.
   const size_t PageSize = State.PageSize;
+  const uint64_t ProtectStart = getMonotonicTimeNs();
   allocateInGuardedPool(
       reinterpret_cast<void *>(getPageAddr(UserPtr, PageSize)),
       roundUpTo(Size, PageSize));
+  recordProtectTime(ProtectStart);
 
   Meta->RecordAllocation(UserPtr, Size);
   {
@@ -362,12 +424,15 @@ void GuardedPoolAllocator::deallocate(void *Ptr) {
     }
   }
 
+  const uint64_t ProtectStart = getMonotonicTimeNs();
   deallocateInGuardedPool(reinterpret_cast<void *>(SlotStart),
                           State.maximumAllocationSize());
+  recordProtectTime(ProtectStart);
 
   // And finally, lock again to release the slot back into the pool.
   ScopedLock L(PoolMutex);
   freeSlot(Slot);
+  adaptSampleRate();
 }
 
 // Thread-compatible, protected by PoolMutex.
@@ -86,7 +86,8 @@ public:
     // UINT32_MAX.
     if (GWP_ASAN_UNLIKELY(getThreadLocals()->NextSampleCounter == 0))
       getThreadLocals()->NextSampleCounter =
-          ((getRandomUnsigned32() % (AdjustedSampleRatePlusOne - 1)) + 1) &
+          ((getRandomUnsigned32() % (getAdjustedSampleRatePlusOne() - 1)) +
+           1) &
           ThreadLocalPackedVariables::NextSampleCounterMask;
 
     return GWP_ASAN_UNLIKELY(--getThreadLocals()->NextSampleCounter == 0);
@@ -125,6 +126,24 @@ public:
   void preCrashReport(void *Ptr);
   void postCrashReportRecoverableOnly(void *Ptr);
 
+  // Counters describing the activity of the allocator, meant to be exported to
+  // monitoring. They are all zero if GWP-ASan is disabled.
+  struct Stats {
+    // Number of slots holding a live (or crashed) allocation.
+    size_t PoolOccupancy;
+    // Number of sampled allocations that were served from the pool.
+    uint64_t SamplesTaken;
+    // Number of sampled allocations that were passed back to the supporting
+    // allocator, because the pool was full or couldn't fit them.
+    uint64_t SamplesDropped;
+    // Time spent by all threads mapping and unmapping slots, in nanoseconds.
+    uint64_t ProtectTimeNs;
+    // Sample rate currently in use. Differs from the SampleRate option only
+    // when ProtectTimeBudgetPerMille is set.
+    uint32_t CurrentSampleRate;
+  };
+  void getStats(Stats *S);
+
   // Exposed as protected for testing.
 protected:
   // Returns the actual allocation size required to service an allocation with
@@ -202,6 +221,20 @@ private:
   // Install a pthread_atfork handler.
   void installAtFork();
 
+  GWP_ASAN_ALWAYS_INLINE uint32_t getAdjustedSampleRatePlusOne() const {
+    return __atomic_load_n(&AdjustedSampleRatePlusOne, __ATOMIC_RELAXED);
+  }
+  void setSampleRate(uint32_t Rate);
+
+  // Adds the time spent in the protection call that started at `Start` to
+  // ProtectTimeNs.
+  void recordProtectTime(uint64_t Start);
+
+  // With ProtectTimeBudgetPerMille, compares the time spent mapping and
+  // unmapping slots during the last window to the budget, and lowers or raises
+  // the sample rate accordingly. Must be called with PoolMutex held.
+  void adaptSampleRate();
+
   gwp_asan::AllocatorState State;
 
   // A mutex to protect the guarded slot and metadata pool for this class.
@@ -238,6 +271,22 @@ private:
   // the sample rate.
   uint32_t AdjustedSampleRatePlusOne = 0;
 
+  // Sample rate in effect, and the bounds within which adaptSampleRate() may
+  // move it.
+  uint32_t CurrentSampleRate = 0;
+  uint32_t MinSampleRate = 0;
+  uint32_t MaxSampleRate = 0;
+  uint32_t ProtectTimeBudgetPerMille = 0;
+  // Start of the current adaptive sampling window, and ProtectTimeNs at that
+  // point. Protected by PoolMutex.
+  uint64_t WindowStartNs = 0;
+  uint64_t WindowProtectTimeNs = 0;
+
+  // See Stats. Updated with relaxed atomics.
+  uint64_t SamplesTaken = 0;
+  uint64_t SamplesDropped = 0;
+  uint64_t ProtectTimeNs = 0;
+
   // Additional platform specific data structure for the guarded pool mapping.
   PlatformSpecificMapData GuardedPagePoolPlatformData = {};
 
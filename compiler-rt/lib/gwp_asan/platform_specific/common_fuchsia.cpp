@@ -8,8 +8,14 @@
 
 #include "gwp_asan/common.h"
 
+#include <zircon/syscalls.h>
+
 namespace gwp_asan {
 // This is only used for AllocationTrace.ThreadID and allocation traces are not
 // yet supported on Fuchsia.
 uint64_t getThreadID() { return kInvalidThreadID; }
+
+uint64_t getMonotonicTimeNs() {
+  return static_cast<uint64_t>(_zx_clock_get_monotonic());
+}
 } // namespace gwp_asan
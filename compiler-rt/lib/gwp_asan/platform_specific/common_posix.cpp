@@ -11,6 +11,7 @@
 #include <stdint.h>
 #include <sys/syscall.h> // IWYU pragma: keep
 // IWYU pragma: no_include <syscall.h>
+#include <time.h>
 #include <unistd.h>
 
 namespace gwp_asan {
@@ -23,4 +24,11 @@ uint64_t getThreadID() {
 #endif
 }
 
+uint64_t getMonotonicTimeNs() {
+  timespec TS;
+  clock_gettime(CLOCK_MONOTONIC, &TS);
+  return static_cast<uint64_t>(TS.tv_sec) * (1000ULL * 1000 * 1000) +
+         static_cast<uint64_t>(TS.tv_nsec);
+}
+
 } // namespace gwp_asan
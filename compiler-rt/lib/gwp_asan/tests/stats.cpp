@@ -0,0 +1,59 @@
+//===-- stats.cpp -----------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "gwp_asan/tests/harness.h"
+
+TEST_F(CustomGuardedPoolAllocator, StatsTrackPoolActivity) {
+  InitNumSlots(2);
+  gwp_asan::GuardedPoolAllocator::Stats S;
+  GPA.getStats(&S);
+  EXPECT_EQ(0u, S.PoolOccupancy);
+  EXPECT_EQ(0u, S.SamplesTaken);
+  EXPECT_EQ(0u, S.SamplesDropped);
+
+  void *Ptr1 = GPA.allocate(1);
+  void *Ptr2 = GPA.allocate(1);
+  ASSERT_NE(nullptr, Ptr1);
+  ASSERT_NE(nullptr, Ptr2);
+  EXPECT_EQ(nullptr, GPA.allocate(1));
+  GPA.getStats(&S);
+  EXPECT_EQ(2u, S.PoolOccupancy);
+  EXPECT_EQ(2u, S.SamplesTaken);
+  EXPECT_EQ(1u, S.SamplesDropped);
+
+  GPA.deallocate(Ptr1);
+  GPA.getStats(&S);
+  EXPECT_EQ(1u, S.PoolOccupancy);
+  EXPECT_GT(S.ProtectTimeNs, 0u);
+  GPA.deallocate(Ptr2);
+}
+
+TEST(GwpAsanStatsTest, SampleRateAdaptsToProtectTimeBudget) {
+  gwp_asan::GuardedPoolAllocator GPA;
+  gwp_asan::options::Options Opts;
+  Opts.setDefaults();
+  Opts.SampleRate = 100;
+  // With a budget this small, nothing but mapping and unmapping slots makes
+  // the allocator go over it as soon as a window ends.
+  Opts.ProtectTimeBudgetPerMille = 1;
+  Opts.InstallForkHandlers = gwp_asan::test::OnlyOnce();
+  GPA.init(Opts);
+
+  gwp_asan::GuardedPoolAllocator::Stats S;
+  GPA.getStats(&S);
+  EXPECT_EQ(100u, S.CurrentSampleRate);
+  for (unsigned I = 0; I < 1000000 && S.CurrentSampleRate == 100; ++I) {
+    void *Ptr = GPA.allocate(1);
+    ASSERT_NE(nullptr, Ptr);
+    GPA.deallocate(Ptr);
+    GPA.getStats(&S);
+  }
+  EXPECT_GT(S.CurrentSampleRate, 100u);
+  EXPECT_LE(S.CurrentSampleRate, 6400u);
+  GPA.uninitTestOnly();
+}
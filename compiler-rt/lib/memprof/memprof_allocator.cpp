@@ -122,9 +122,10 @@ struct ChunkHeader {
   // 3-rd 4 bytes
   u32 timestamp_ms;
   // 4-th 4 bytes
-  // Note only 1 bit is needed for this flag if we need space in the future for
-  // more fields.
-  u32 from_memalign;
+  // Note only 2 bits are used if we need space in the future for more fields.
+  u32 from_memalign : 1;
+  // Set if the allocation was picked by alloc_sample_rate and is profiled.
+  u32 sampled : 1;
   // 5-th and 6-th 4 bytes
   // The max size of an allocation is 2^40 (kMaxAllowedMallocSize), so this
   // could be shrunk to kMaxAllowedMallocBits if we need space in the future for
@@ -316,7 +317,7 @@ struct Allocator {
           Allocator *A = (Allocator *)alloc;
           MemprofChunk *m =
               A->GetMemprofChunk((void *)chunk, user_requested_size);
-          if (!m)
+          if (!m || !m->sampled)
             return;
           uptr user_beg = ((uptr)m) + kChunkHeaderSize;
           u64 c = GetShadowCount(user_beg, user_requested_size);
@@ -338,6 +339,17 @@ struct Allocator {
                                        : kMaxAllowedMallocSize;
   }
 
+  // Returns true if the next allocation on this thread should be profiled.
+  static bool ShouldSampleAllocation() {
+    static THREADLOCAL u32 rand_state;
+    const int rate = flags()->alloc_sample_rate;
+    if (rate <= 1)
+      return true;
+    if (UNLIKELY(!rand_state))
+      rand_state = static_cast<u32>(NanoTime()) ^ GetTid() ^ 1;
+    return RandN(&rand_state, rate) == 0;
+  }
+
   // -------------------- Allocation/Deallocation routines ---------------
   void *Allocate(uptr size, uptr alignment, BufferedStackTrace *stack,
                  AllocType alloc_type) {
@@ -408,9 +420,12 @@ struct Allocator {
     m->from_memalign = alloc_beg != chunk_beg;
     CHECK(size);
 
-    m->cpu_id = GetCpuId();
-    m->timestamp_ms = GetTimestamp();
-    m->alloc_context_id = StackDepotPut(*stack);
+    m->sampled = ShouldSampleAllocation();
+    if (m->sampled) {
+      m->cpu_id = GetCpuId();
+      m->timestamp_ms = GetTimestamp();
+      m->alloc_context_id = StackDepotPut(*stack);
+    }
 
     uptr size_rounded_down_to_granularity =
         RoundDownTo(size, SHADOW_GRANULARITY);
@@ -449,7 +464,7 @@ struct Allocator {
 
     u64 user_requested_size =
         atomic_exchange(&m->user_requested_size, 0, memory_order_acquire);
-    if (memprof_inited && atomic_load_relaxed(&constructed) &&
+    if (m->sampled && memprof_inited && atomic_load_relaxed(&constructed) &&
         !atomic_load_relaxed(&destructing)) {
       u64 c = GetShadowCount(p, user_requested_size);
       long curtime = GetTimestamp();
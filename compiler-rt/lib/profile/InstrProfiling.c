@@ -59,6 +59,8 @@ COMPILER_RT_VISIBILITY void __llvm_profile_reset_counters(void) {
   char ResetValue =
       (__llvm_profile_get_version() & VARIANT_MASK_BYTE_COVERAGE) ? 0xFF : 0;
   memset(I, ResetValue, E - I);
+  if (CounterShardsHook)
+    CounterShardsHook(/*Reset=*/1);
 
   I = __llvm_profile_begin_bitmap();
   E = __llvm_profile_end_bitmap();
@@ -197,6 +197,9 @@ COMPILER_RT_VISIBILITY extern uint32_t VPMaxNumValsPerSite;
 COMPILER_RT_VISIBILITY extern ValueProfNode *CurrentVNode;
 COMPILER_RT_VISIBILITY extern ValueProfNode *EndVNode;
 extern void (*VPMergeHook)(struct ValueProfData *, __llvm_profile_data *);
+/* Set once a thread gets a counter shard. Merges the counter shards into the
+ * counters section, or resets them if \p Reset is nonzero. */
+COMPILER_RT_VISIBILITY extern void (*CounterShardsHook)(int Reset);
 
 /*
  * Write binary ids into profiles if writer is given.
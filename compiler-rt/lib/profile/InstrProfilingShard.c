@@ -0,0 +1,145 @@
+/*===- InstrProfilingShard.c - Per-thread profile counter shards ----------===*\
+|*
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+|* See https://llvm.org/LICENSE.txt for license information.
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+|*
+\*===----------------------------------------------------------------------===*/
+
+/* With -instrprof-shard-counters, instrumented code updates a private copy of
+ * the counters section, found through a thread-local bias, instead of the
+ * shared counters. The shards are merged back into the counters section when
+ * the profile is written, and when their thread exits so that they can be
+ * reused by the next threads. */
+
+#if !defined(_WIN32)
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "InstrProfiling.h"
+#include "InstrProfilingInternal.h"
+#include "InstrProfilingPort.h"
+
+/* Offset from the counters section to the shard of the current thread, zero
+ * until the thread gets a shard. */
+COMPILER_RT_VISIBILITY __thread intptr_t
+    INSTR_PROF_PROFILE_COUNTER_SHARD_BIAS_VAR;
+
+typedef struct CounterShard {
+  struct CounterShard *Next;
+  char *Counters;
+  int InUse;
+} CounterShard;
+
+static pthread_mutex_t ShardLock = PTHREAD_MUTEX_INITIALIZER;
+static CounterShard *Shards;
+static pthread_key_t ShardKey;
+static pthread_once_t ShardKeyOnce = PTHREAD_ONCE_INIT;
+/* Set while allocating a shard, in case the allocator is instrumented. */
+static __thread int InShardInit;
+static int WarnedAllocFailure;
+
+static int isByteCoverage(void) {
+  return (__llvm_profile_get_version() & VARIANT_MASK_BYTE_COVERAGE) != 0;
+}
+
+static void resetShard(CounterShard *Shard) {
+  const char *Begin = __llvm_profile_begin_counters();
+  const char *End = __llvm_profile_end_counters();
+  memset(Shard->Counters, isByteCoverage() ? 0xFF : 0, End - Begin);
+}
+
+/* Adds the counts of a shard to the counters section and resets the shard.
+ * Updates made by the owner of the shard while this runs may be lost, like
+ * concurrent updates of the shared counters. */
+static void foldShard(CounterShard *Shard) {
+  char *Begin = __llvm_profile_begin_counters();
+  char *End = __llvm_profile_end_counters();
+  if (isByteCoverage()) {
+    /* A block is covered when its byte is zero in any of the copies. */
+    char *I, *S;
+    for (I = Begin, S = Shard->Counters; I < End; ++I, ++S)
+      *I &= *S;
+  } else {
+    uint64_t *I = (uint64_t *)Begin, *E = (uint64_t *)End;
+    uint64_t *S = (uint64_t *)Shard->Counters;
+    for (; I < E; ++I, ++S)
+      *I += *S;
+  }
+  resetShard(Shard);
+}
+
+static void releaseShard(void *Arg) {
+  CounterShard *Shard = (CounterShard *)Arg;
+  INSTR_PROF_PROFILE_COUNTER_SHARD_BIAS_VAR = 0;
+  pthread_mutex_lock(&ShardLock);
+  foldShard(Shard);
+  Shard->InUse = 0;
+  pthread_mutex_unlock(&ShardLock);
+}
+
+static void mergeOrResetShards(int Reset) {
+  CounterShard *Shard;
+  pthread_mutex_lock(&ShardLock);
+  for (Shard = Shards; Shard; Shard = Shard->Next) {
+    if (Reset)
+      resetShard(Shard);
+    else if (Shard->InUse)
+      foldShard(Shard);
+  }
+  pthread_mutex_unlock(&ShardLock);
+}
+
+static void createShardKey(void) {
+  pthread_key_create(&ShardKey, releaseShard);
+  CounterShardsHook = &mergeOrResetShards;
+}
+
+/* Called by instrumented code on function entry when the thread doesn't have
+ * a shard yet. Returns the new bias, or zero to keep using the shared counters
+ * if no shard can be allocated. */
+COMPILER_RT_VISIBILITY intptr_t INSTR_PROF_PROFILE_COUNTER_SHARD_INIT(void) {
+  char *Begin = __llvm_profile_begin_counters();
+  char *End = __llvm_profile_end_counters();
+  CounterShard *Shard;
+
+  if (InShardInit || Begin == End)
+    return 0;
+  InShardInit = 1;
+  pthread_once(&ShardKeyOnce, createShardKey);
+
+  pthread_mutex_lock(&ShardLock);
+  for (Shard = Shards; Shard; Shard = Shard->Next)
+    if (!Shard->InUse)
+      break;
+  if (!Shard) {
+    Shard = (CounterShard *)calloc(1, sizeof(CounterShard));
+    char *Counters = Shard ? (char *)malloc(End - Begin) : NULL;
+    if (!Counters) {
+      free(Shard);
+      pthread_mutex_unlock(&ShardLock);
+      InShardInit = 0;
+      if (!WarnedAllocFailure++)
+        PROF_WARN("%s\n", "failed to allocate a counter shard, using the shared "
+                          "counters for this thread");
+      return 0;
+    }
+    Shard->Counters = Counters;
+    resetShard(Shard);
+    Shard->Next = Shards;
+    Shards = Shard;
+  }
+  Shard->InUse = 1;
+  pthread_mutex_unlock(&ShardLock);
+
+  pthread_setspecific(ShardKey, Shard);
+  INSTR_PROF_PROFILE_COUNTER_SHARD_BIAS_VAR = Shard->Counters - Begin;
+  InShardInit = 0;
+  return INSTR_PROF_PROFILE_COUNTER_SHARD_BIAS_VAR;
+}
+
+#endif
@@ -35,10 +35,20 @@ struct StackDepotNode {
   }
   static uptr allocated();
   static hash_type hash(const args_type &args) {
-    MurMur2Hash64Builder H(args.size * sizeof(uptr));
-    for (uptr i = 0; i < args.size; i++) H.add(args.trace[i]);
-    H.add(args.tag);
-    return H.get();
+    // Hash even and odd frames in two independent lanes. This halves the
+    // length of the multiplication dependency chain, which dominates the cost
+    // of hashing deep traces.
+    MurMur2Hash64Builder H0(args.size * sizeof(uptr));
+    MurMur2Hash64Builder H1(args.tag);
+    uptr i = 0;
+    for (; i + 1 < args.size; i += 2) {
+      H0.add(args.trace[i]);
+      H1.add(args.trace[i + 1]);
+    }
+    if (i < args.size)
+      H0.add(args.trace[i]);
+    H0.add(H1.get());
+    return H0.get();
   }
   static bool is_valid(const args_type &args) {
     return args.size > 0 && args.trace;
@@ -74,10 +84,25 @@ uptr StackDepotNode::allocated() {
   return stackStore.Allocated() + useCounts.MemoryUsage();
 }
 
+// Returns the compression mode, as in compress_stack_depot, to use given the
+// current size of the depot.
+static int GetCompressionMode() {
+  int compress = common_flags()->compress_stack_depot;
+  if (compress)
+    return compress;
+  int threshold_mb = common_flags()->compress_stack_depot_threshold_mb;
+  if (threshold_mb <= 0 ||
+      stackStore.Allocated() <= (static_cast<uptr>(threshold_mb) << 20))
+    return 0;
+  // Memory pressure driven compression goes through the background thread and
+  // uses the stronger of the two algorithms.
+  return static_cast<int>(StackStore::Compression::LZW);
+}
+
 static void CompressStackStore() {
   u64 start = Verbosity() >= 1 ? MonotonicNanoTime() : 0;
-  uptr diff = stackStore.Pack(static_cast<StackStore::Compression>(
-      Abs(common_flags()->compress_stack_depot)));
+  uptr diff = stackStore.Pack(
+      static_cast<StackStore::Compression>(Abs(GetCompressionMode())));
   if (!diff)
     return;
   if (Verbosity() >= 1) {
@@ -124,7 +149,7 @@ class CompressThread {
 static CompressThread compress_thread;
 
 void CompressThread::NewWorkNotify() {
-  int compress = common_flags()->compress_stack_depot;
+  int compress = GetCompressionMode();
   if (!compress)
     return;
   if (compress > 0 /* for testing or debugging */) {
@@ -205,10 +230,21 @@ StackDepotNode::args_type StackDepotNode::load(u32 id) const {
 
 StackDepotStats StackDepotGetStats() { return theDepot.GetStats(); }
 
-u32 StackDepotPut(StackTrace stack) { return theDepot.Put(stack); }
+static StackTrace MaybeTruncate(StackTrace stack) {
+  if (!common_flags()->truncate_stack_depot)
+    return stack;
+  int max_size = common_flags()->malloc_context_size;
+  if (max_size <= 0 || stack.size <= static_cast<uptr>(max_size))
+    return stack;
+  return StackTrace(stack.trace, max_size, stack.tag);
+}
+
+u32 StackDepotPut(StackTrace stack) {
+  return theDepot.Put(MaybeTruncate(stack));
+}
 
 StackDepotHandle StackDepotPut_WithHandle(StackTrace stack) {
-  return StackDepotNode::get_handle(theDepot.Put(stack));
+  return StackDepotNode::get_handle(theDepot.Put(MaybeTruncate(stack)));
 }
 
 StackTrace StackDepotGet(u32 id) {
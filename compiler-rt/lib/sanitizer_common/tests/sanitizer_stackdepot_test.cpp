@@ -20,6 +20,7 @@
 #include <thread>
 
 #include "gtest/gtest.h"
+#include "sanitizer_common/sanitizer_flags.h"
 #include "sanitizer_common/sanitizer_internal_defs.h"
 #include "sanitizer_common/sanitizer_libc.h"
 
@@ -84,6 +85,30 @@ TEST_F(StackDepotTest, Several) {
   EXPECT_NE(i1, i2);
 }
 
+TEST_F(StackDepotTest, Truncate) {
+  CommonFlags old_flags;
+  old_flags.CopyFrom(*common_flags());
+  CommonFlags flags;
+  flags.CopyFrom(old_flags);
+  flags.truncate_stack_depot = true;
+  flags.malloc_context_size = 3;
+  OverrideCommonFlags(flags);
+
+  uptr array1[] = {1, 2, 3, 4, 10};
+  u32 i1 = StackDepotPut(StackTrace(array1, ARRAY_SIZE(array1)));
+  uptr array2[] = {1, 2, 3, 5, 11, 12};
+  u32 i2 = StackDepotPut(StackTrace(array2, ARRAY_SIZE(array2)));
+  uptr array3[] = {1, 2, 4};
+  u32 i3 = StackDepotPut(StackTrace(array3, ARRAY_SIZE(array3)));
+  EXPECT_EQ(i1, i2);
+  EXPECT_NE(i1, i3);
+  StackTrace stack = StackDepotGet(i2);
+  EXPECT_EQ(3u, stack.size);
+  EXPECT_EQ(0, internal_memcmp(stack.trace, array1, 3 * sizeof(uptr)));
+
+  OverrideCommonFlags(old_flags);
+}
+
 TEST_F(StackDepotTest, Print) {
   uptr array1[] = {0x111, 0x222, 0x333, 0x444, 0x777};
   StackTrace s1(array1, ARRAY_SIZE(array1));
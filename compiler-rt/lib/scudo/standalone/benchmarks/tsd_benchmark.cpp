@@ -0,0 +1,76 @@
+//===-- tsd_benchmark.cpp ---------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "allocator_config.h"
+#include "combined.h"
+#include "common.h"
+
+#include "benchmark/benchmark.h"
+
+#include <vector>
+
+// Compares the shared TSD registry with and without NUMA awareness, with many
+// threads allocating and freeing batches of blocks concurrently. On a single
+// node system both configurations are expected to behave the same.
+
+struct SharedConfig : scudo::DefaultConfig {
+  template <class A>
+  using TSDRegistryT = scudo::TSDRegistrySharedT<A, 32U, 32U>;
+};
+
+struct NumaSharedConfig : scudo::DefaultConfig {
+  template <class A>
+  using TSDRegistryT = scudo::TSDRegistrySharedT<A, 32U, 32U, true>;
+};
+
+template <typename Config> static scudo::Allocator<Config> *getAllocator() {
+  // The allocator is shared by all the threads of a benchmark, and is never
+  // torn down since threads of the following runs may still reference it.
+  static scudo::Allocator<Config> *A = [] {
+    auto *A = new scudo::Allocator<Config>;
+    A->init();
+    return A;
+  }();
+  return A;
+}
+
+template <typename Config>
+static void BM_malloc_free_threaded(benchmark::State &State) {
+  scudo::Allocator<Config> *Allocator = getAllocator<Config>();
+  const size_t NBytes = State.range(0);
+  constexpr size_t BatchSize = 64;
+  std::vector<void *> Ptrs(BatchSize);
+
+  for (auto _ : State) {
+    for (size_t I = 0; I < BatchSize; I++) {
+      Ptrs[I] = Allocator->allocate(NBytes, scudo::Chunk::Origin::Malloc);
+      // Touch the block so that remote memory accesses show up.
+      memset(Ptrs[I], 1, NBytes);
+    }
+    benchmark::DoNotOptimize(Ptrs.data());
+    for (size_t I = 0; I < BatchSize; I++)
+      Allocator->deallocate(Ptrs[I], scudo::Chunk::Origin::Malloc);
+  }
+
+  State.SetBytesProcessed(uint64_t(State.iterations()) * BatchSize *
+                          uint64_t(NBytes));
+}
+
+static const size_t MinSize = 16;
+static const size_t MaxSize = 16 * 1024;
+
+BENCHMARK_TEMPLATE(BM_malloc_free_threaded, SharedConfig)
+    ->Range(MinSize, MaxSize)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_malloc_free_threaded, NumaSharedConfig)
+    ->Range(MinSize, MaxSize)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
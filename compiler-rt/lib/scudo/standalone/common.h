@@ -148,6 +148,13 @@ inline uptr getPageSizeCached() {
 // Returns 0 if the number of CPUs could not be determined.
 u32 getNumberOfCPUs();
 
+// Returns 1 if the number of NUMA nodes could not be determined.
+u32 getNumberOfNumaNodes();
+
+// Returns the NUMA node of the CPU the calling thread is running on, or 0 if it
+// could not be determined.
+u32 getNumaNodeOfCurrentCPU();
+
 const char *getEnv(const char *Name);
 
 u64 getMonotonicTime();
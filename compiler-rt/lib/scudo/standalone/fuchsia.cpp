@@ -215,6 +215,10 @@ u64 getMonotonicTimeFast() { return _zx_clock_get_monotonic(); }
 
 u32 getNumberOfCPUs() { return _zx_system_get_num_cpus(); }
 
+u32 getNumberOfNumaNodes() { return 1U; }
+
+u32 getNumaNodeOfCurrentCPU() { return 0; }
+
 u32 getThreadID() { return 0; }
 
 bool getRandom(void *Buffer, uptr Length, UNUSED bool Blocking) {
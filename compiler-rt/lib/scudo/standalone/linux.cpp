@@ -167,6 +167,36 @@ u32 getNumberOfCPUs() {
   return static_cast<u32>(CPU_COUNT(&CPUs));
 }
 
+u32 getNumberOfNumaNodes() {
+  // The possible nodes are listed as ranges, eg: "0-1" or "0,2-3". Nodes are
+  // numbered from 0, so the count is the last one plus 1.
+  int Fd = open("/sys/devices/system/node/possible", O_RDONLY | O_CLOEXEC);
+  if (Fd < 0)
+    return 1U;
+  char Buffer[64];
+  const ssize_t Length = read(Fd, Buffer, sizeof(Buffer));
+  close(Fd);
+  if (Length <= 0)
+    return 1U;
+  u32 Last = 0, Current = 0;
+  for (ssize_t I = 0; I < Length; I++) {
+    if (Buffer[I] >= '0' && Buffer[I] <= '9') {
+      Current = Current * 10 + static_cast<u32>(Buffer[I] - '0');
+    } else {
+      Last = Max(Last, Current);
+      Current = 0;
+    }
+  }
+  return Max(Last, Current) + 1U;
+}
+
+u32 getNumaNodeOfCurrentCPU() {
+  unsigned CPU = 0, Node = 0;
+  if (syscall(SYS_getcpu, &CPU, &Node, nullptr) != 0)
+    return 0;
+  return static_cast<u32>(Node);
+}
+
 u32 getThreadID() {
 #if SCUDO_ANDROID
   return static_cast<u32>(gettid());
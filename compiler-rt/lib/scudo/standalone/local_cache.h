@@ -90,6 +90,9 @@ template <class SizeClassAllocator> struct SizeClassAllocatorLocalCache {
       while (PerClassArray[I].Count > 0)
         drain(&PerClassArray[I], I);
     }
+    // Blocks drained above may have been stashed by the primary rather than
+    // returned to its free lists.
+    Allocator->flushStashes(this);
     while (PerClassArray[BatchClassId].Count > 0)
       drain(&PerClassArray[BatchClassId], BatchClassId);
     DCHECK(isEmpty());
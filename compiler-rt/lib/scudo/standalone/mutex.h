@@ -92,6 +92,53 @@ private:
   void operator=(const ScopedLock &) = delete;
 };
 
+// Contention statistics of a HybridMutex. They are only updated while holding
+// the mutex they describe, which is also required to read them.
+struct MutexStats {
+  uptr Acquired = 0;
+  uptr Contended = 0;
+  u64 WaitNs = 0;
+  uptr HoldSamples = 0;
+  u64 HoldNs = 0;
+};
+
+// Like ScopedLock, but records how contended the mutex is. The time spent
+// waiting is only measured when the mutex can't be acquired right away, and
+// the time it is held only for one out of HoldSampleRate acquisitions, so that
+// the uncontended path stays cheap.
+class SCOPED_CAPABILITY ScopedProfiledLock {
+public:
+  static constexpr uptr HoldSampleRate = 64U;
+
+  ScopedProfiledLock(HybridMutex &M, MutexStats &S) ACQUIRE(M)
+      : Mutex(M), Stats(S) {
+    if (!Mutex.tryLock()) {
+      const u64 Start = getMonotonicTime();
+      Mutex.lock();
+      Stats.Contended++;
+      Stats.WaitNs += getMonotonicTime() - Start;
+    }
+    if ((Stats.Acquired++ % HoldSampleRate) == 0)
+      HoldStart = getMonotonicTime();
+  }
+
+  ~ScopedProfiledLock() RELEASE() {
+    if (HoldStart != 0) {
+      Stats.HoldSamples++;
+      Stats.HoldNs += getMonotonicTime() - HoldStart;
+    }
+    Mutex.unlock();
+  }
+
+private:
+  HybridMutex &Mutex;
+  MutexStats &Stats;
+  u64 HoldStart = 0;
+
+  ScopedProfiledLock(const ScopedProfiledLock &) = delete;
+  void operator=(const ScopedProfiledLock &) = delete;
+};
+
 } // namespace scudo
 
 #endif // SCUDO_MUTEX_H_
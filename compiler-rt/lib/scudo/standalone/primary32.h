@@ -246,6 +246,9 @@ public:
     pushBlocksImpl(C, ClassId, Sci, Array, Size, SameGroup);
   }
 
+  // There is no free list stash in the 32-bit primary.
+  void flushStashes(UNUSED CacheT *C) {}
+
   void disable() NO_THREAD_SAFETY_ANALYSIS {
     // The BatchClassId must be locked last since other classes can use it.
     for (sptr I = static_cast<sptr>(NumClasses) - 1; I >= 0; I--) {
@@ -64,6 +64,10 @@ public:
   static_assert(sizeof(BatchGroupT) <= sizeof(TransferBatchT),
                 "BatchGroupT uses the same class size as TransferBatchT");
 
+  static const u32 StashShards = Config::getFreeListStashShards();
+  // A shard holds up to two drains' worth of blocks of a local cache.
+  static const u16 StashCapacity = 2 * SizeClassMap::MaxNumCachedHint;
+
   static uptr getSizeByClassId(uptr ClassId) {
     return (ClassId == SizeClassMap::BatchClassId)
                ? roundUp(sizeof(TransferBatchT), 1U << CompactPtrScale)
@@ -163,6 +167,8 @@ public:
           MemMap.unmap(MemMap.getBase(), MemMap.getCapacity());
       }
       *Region = {};
+      for (u32 J = 0; J < StashShards; J++)
+        Stashes[I][J] = {};
     }
   }
 
@@ -221,8 +227,14 @@ public:
     RegionInfo *Region = getRegionInfo(ClassId);
     u16 PopCount = 0;
 
+    if (StashShards != 0U && ClassId != SizeClassMap::BatchClassId) {
+      PopCount = popBlocksFromStash(C, ClassId, ToArray, MaxBlockCount);
+      if (PopCount != 0U)
+        return PopCount;
+    }
+
     {
-      ScopedLock L(Region->FLLock);
+      ScopedProfiledLock L(Region->FLLock, Region->FLLockStats);
       PopCount = popBlocksImpl(C, ClassId, Region, ToArray, MaxBlockCount);
       if (PopCount != 0U)
         return PopCount;
@@ -238,9 +250,9 @@ public:
         // When two threads compete for `Region->MMLock`, we only want one of
         // them to call populateFreeListAndPopBatch(). To avoid both of them
         // doing that, always check the freelist before mapping new pages.
-        ScopedLock ML(Region->MMLock);
+        ScopedProfiledLock ML(Region->MMLock, Region->MMLockStats);
         {
-          ScopedLock FL(Region->FLLock);
+          ScopedProfiledLock FL(Region->FLLock, Region->FLLockStats);
           PopCount = popBlocksImpl(C, ClassId, Region, ToArray, MaxBlockCount);
           if (PopCount != 0U)
             return PopCount;
@@ -283,32 +295,35 @@ public:
       return;
     }
 
-    // TODO(chiahungduan): Consider not doing grouping if the group size is not
-    // greater than the block size with a certain scale.
+    if (StashShards != 0U && pushBlocksToStash(C, ClassId, Array, Size))
+      return;
 
-    bool SameGroup = true;
-    if (GroupSizeLog < RegionSizeLog) {
-      // Sort the blocks so that blocks belonging to the same group can be
-      // pushed together.
-      for (u32 I = 1; I < Size; ++I) {
-        if (compactPtrGroup(Array[I - 1]) != compactPtrGroup(Array[I]))
-          SameGroup = false;
-        CompactPtrT Cur = Array[I];
-        u32 J = I;
-        while (J > 0 && compactPtrGroup(Cur) < compactPtrGroup(Array[J - 1])) {
-          Array[J] = Array[J - 1];
-          --J;
+    pushBlocksToFreeList(C, ClassId, Region, Array, Size);
+  }
+
+  // Moves the blocks of all the stashes to the region free lists, so that they
+  // can be released to the OS. The caller is expected to drain the BatchClass
+  // blocks of its cache afterwards.
+  void flushStashes(CacheT *C) {
+    if (StashShards == 0U)
+      return;
+    for (uptr I = 0; I < NumClasses; I++) {
+      if (I == SizeClassMap::BatchClassId)
+        continue;
+      for (u32 J = 0; J < StashShards; J++) {
+        FreeListStash *Stash = &Stashes[I][J];
+        CompactPtrT Blocks[StashCapacity];
+        u16 Count;
+        {
+          ScopedLock L(Stash->Mutex);
+          Count = Stash->Count;
+          memcpy(Blocks, Stash->Blocks, Count * sizeof(CompactPtrT));
+          Stash->Count = 0;
         }
-        Array[J] = Cur;
+        if (Count != 0U)
+          pushBlocksToFreeList(C, I, getRegionInfo(I), Blocks, Count);
       }
     }
-
-    {
-      ScopedLock L(Region->FLLock);
-      pushBlocksImpl(C, ClassId, Region, Array, Size, SameGroup);
-      if (conditionVariableEnabled())
-        Region->FLLockCV.notifyAll(Region->FLLock);
-    }
   }
 
   void disable() NO_THREAD_SAFETY_ANALYSIS {
@@ -321,9 +336,15 @@ public:
     }
     getRegionInfo(SizeClassMap::BatchClassId)->MMLock.lock();
     getRegionInfo(SizeClassMap::BatchClassId)->FLLock.lock();
+    for (uptr I = 0; I < NumClasses; I++)
+      for (u32 J = 0; J < StashShards; J++)
+        Stashes[I][J].Mutex.lock();
   }
 
   void enable() NO_THREAD_SAFETY_ANALYSIS {
+    for (uptr I = 0; I < NumClasses; I++)
+      for (u32 J = 0; J < StashShards; J++)
+        Stashes[I][J].Mutex.unlock();
     getRegionInfo(SizeClassMap::BatchClassId)->FLLock.unlock();
     getRegionInfo(SizeClassMap::BatchClassId)->MMLock.unlock();
     for (uptr I = 0; I < NumClasses; I++) {
@@ -553,6 +574,11 @@ private:
     ReleaseToOsInfo ReleaseInfo GUARDED_BY(MMLock) = {};
     bool Exhausted GUARDED_BY(MMLock) = false;
     bool isPopulatingFreeList GUARDED_BY(FLLock) = false;
+    // These are only updated and read while holding the respective lock. They
+    // can't be marked as guarded since a reference to them is passed to
+    // ScopedProfiledLock before the lock is acquired.
+    MutexStats FLLockStats = {};
+    MutexStats MMLockStats = {};
   };
   struct RegionInfo : UnpaddedRegionInfo {
     char Padding[SCUDO_CACHE_LINE_SIZE -
@@ -738,6 +764,86 @@ private:
     BG->PushedBlocks += Size;
   }
 
+  // The free list stash is a small array of free blocks per size class and
+  // shard, in front of the region free list. It's only accessed with tryLock()
+  // and the lock is held for a copy, so threads exchanging blocks through it
+  // neither wait on each other nor contend on FLLock, and skip the grouping
+  // done in pushBlocksImpl(). Whenever a shard is busy, full or empty, the
+  // region free list is used instead.
+  struct alignas(SCUDO_CACHE_LINE_SIZE) FreeListStash {
+    HybridMutex Mutex;
+    u16 Count GUARDED_BY(Mutex) = 0;
+    CompactPtrT Blocks[StashCapacity] GUARDED_BY(Mutex) = {};
+  };
+
+  FreeListStash *getStash(CacheT *C, uptr ClassId) {
+    // Local caches are embedded in TSDs which may be laid out at regular
+    // intervals, so hash the address rather than using it directly.
+    const u64 Hash = static_cast<u64>(reinterpret_cast<uptr>(C) >> 4) *
+                     0x9E3779B97F4A7C15ULL;
+    return &Stashes[ClassId][(Hash >> 32) % StashShards];
+  }
+
+  bool pushBlocksToStash(CacheT *C, uptr ClassId, CompactPtrT *Array,
+                         u32 Size) {
+    FreeListStash *Stash = getStash(C, ClassId);
+    if (!Stash->Mutex.tryLock())
+      return false;
+    const bool Fits = Stash->Count + Size <= StashCapacity;
+    if (Fits) {
+      memcpy(&Stash->Blocks[Stash->Count], Array, Size * sizeof(CompactPtrT));
+      Stash->Count = static_cast<u16>(Stash->Count + Size);
+    }
+    Stash->Mutex.unlock();
+    return Fits;
+  }
+
+  u16 popBlocksFromStash(CacheT *C, uptr ClassId, CompactPtrT *ToArray,
+                         const u16 MaxBlockCount) {
+    FreeListStash *Stash = getStash(C, ClassId);
+    if (!Stash->Mutex.tryLock())
+      return 0U;
+    // Take the most recently pushed blocks, which are the most likely to still
+    // be in the CPU caches.
+    const u16 PopCount = Min(Stash->Count, MaxBlockCount);
+    Stash->Count = static_cast<u16>(Stash->Count - PopCount);
+    memcpy(ToArray, &Stash->Blocks[Stash->Count],
+           PopCount * sizeof(CompactPtrT));
+    Stash->Mutex.unlock();
+    return PopCount;
+  }
+
+  // Sorts the blocks by group and pushes them to the region free list.
+  void pushBlocksToFreeList(CacheT *C, uptr ClassId, RegionInfo *Region,
+                            CompactPtrT *Array, u32 Size) {
+    // TODO(chiahungduan): Consider not doing grouping if the group size is not
+    // greater than the block size with a certain scale.
+
+    bool SameGroup = true;
+    if (GroupSizeLog < RegionSizeLog) {
+      // Sort the blocks so that blocks belonging to the same group can be
+      // pushed together.
+      for (u32 I = 1; I < Size; ++I) {
+        if (compactPtrGroup(Array[I - 1]) != compactPtrGroup(Array[I]))
+          SameGroup = false;
+        CompactPtrT Cur = Array[I];
+        u32 J = I;
+        while (J > 0 && compactPtrGroup(Cur) < compactPtrGroup(Array[J - 1])) {
+          Array[J] = Array[J - 1];
+          --J;
+        }
+        Array[J] = Cur;
+      }
+    }
+
+    {
+      ScopedProfiledLock L(Region->FLLock, Region->FLLockStats);
+      pushBlocksImpl(C, ClassId, Region, Array, Size, SameGroup);
+      if (conditionVariableEnabled())
+        Region->FLLockCV.notifyAll(Region->FLLock);
+    }
+  }
+
   // Push the blocks to their batch group. The layout will be like,
   //
   // FreeListInfo.BlockList - > BG -> BG -> BG
@@ -1145,6 +1251,32 @@ private:
         Region->ReleaseInfo.LastReleasedBytes >> 10,
         RegionPushedBytesDelta >> 10, Region->RegionBeg,
         getRegionBaseByClassId(ClassId));
+    getLockStats(Str, "FLLock", Region->FLLockStats);
+    getLockStats(Str, "MMLock", Region->MMLockStats);
+    if (StashShards != 0U && ClassId != SizeClassMap::BatchClassId) {
+      uptr StashedBlocks = 0;
+      for (u32 I = 0; I < StashShards; I++) {
+        ScopedLock L(Stashes[ClassId][I].Mutex);
+        StashedBlocks += Stashes[ClassId][I].Count;
+      }
+      // Stashed blocks are accounted as in use above.
+      Str->append("      stashed: %zu in %u shards\n", StashedBlocks,
+                  StashShards);
+    }
+  }
+
+  static void getLockStats(ScopedString *Str, const char *Name,
+                           const MutexStats &Stats) {
+    if (Stats.Acquired == 0)
+      return;
+    const uptr AvgHoldNs =
+        Stats.HoldSamples == 0
+            ? 0
+            : static_cast<uptr>(Stats.HoldNs / Stats.HoldSamples);
+    Str->append("      %s: acquired: %zu contended: %zu waited: %zuus avg "
+                "held: %zuns\n",
+                Name, Stats.Acquired, Stats.Contended,
+                static_cast<uptr>(Stats.WaitNs / 1000), AvgHoldNs);
   }
 
   void getRegionFragmentationInfo(RegionInfo *Region, uptr ClassId,
@@ -1730,6 +1862,11 @@ private:
   uptr SmallerBlockReleasePageDelta = 0;
   atomic_s32 ReleaseToOsIntervalMs = {};
   alignas(SCUDO_CACHE_LINE_SIZE) RegionInfo RegionInfoArray[NumClasses];
+  // Kept out of RegionInfoArray so that the latter, which is copied by the
+  // crash handler, doesn't grow with the number of shards. Reduced to a single
+  // unused element when the stash is disabled.
+  FreeListStash Stashes[StashShards != 0U ? NumClasses : 1U]
+                       [StashShards != 0U ? StashShards : 1U];
 };
 
 } // namespace scudo
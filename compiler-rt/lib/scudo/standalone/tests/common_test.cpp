@@ -72,4 +72,10 @@ TEST(ScudoCommonTest, Zeros) {
   MemMap.unmap(MemMap.getBase(), Size);
 }
 
+TEST(ScudoCommonTest, NumaNodes) {
+  const u32 NumberOfNodes = getNumberOfNumaNodes();
+  EXPECT_GE(NumberOfNodes, 1U);
+  EXPECT_LT(getNumaNodeOfCurrentCPU(), NumberOfNodes);
+}
+
 } // namespace scudo
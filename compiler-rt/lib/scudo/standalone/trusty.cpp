@@ -103,6 +103,10 @@ u64 getMonotonicTimeFast() {
 
 u32 getNumberOfCPUs() { return 0; }
 
+u32 getNumberOfNumaNodes() { return 1U; }
+
+u32 getNumaNodeOfCurrentCPU() { return 0; }
+
 u32 getThreadID() { return 0; }
 
 bool getRandom(UNUSED void *Buffer, UNUSED uptr Length, UNUSED bool Blocking) {
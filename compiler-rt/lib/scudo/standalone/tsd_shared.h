@@ -24,9 +24,15 @@
 
 namespace scudo {
 
-template <class Allocator, u32 TSDsArraySize, u32 DefaultTSDCount>
+// When NumaAware is set, the TSDs are split into one contiguous group per NUMA
+// node, and a thread only picks TSDs from the group of the node it is running
+// on. This keeps the blocks cached in a TSD close to the threads using them,
+// rather than bouncing them between sockets.
+template <class Allocator, u32 TSDsArraySize, u32 DefaultTSDCount,
+          bool NumaAware = false>
 struct TSDRegistrySharedT {
-  using ThisT = TSDRegistrySharedT<Allocator, TSDsArraySize, DefaultTSDCount>;
+  using ThisT =
+      TSDRegistrySharedT<Allocator, TSDsArraySize, DefaultTSDCount, NumaAware>;
 
   struct ScopedTSD {
     ALWAYS_INLINE ScopedTSD(ThisT &TSDRegistry) {
@@ -52,6 +58,8 @@ struct TSDRegistrySharedT {
     Instance->init();
     for (u32 I = 0; I < TSDsArraySize; I++)
       TSDs[I].init(Instance);
+    if (NumaAware)
+      NumberOfNumaNodes = Max(getNumberOfNumaNodes(), 1U);
     const u32 NumberOfCPUs = getNumberOfCPUs();
     setNumberOfTSDs((NumberOfCPUs == 0) ? DefaultTSDCount
                                         : Min(NumberOfCPUs, DefaultTSDCount));
@@ -119,6 +127,9 @@ struct TSDRegistrySharedT {
 
     Str->append("Stats: SharedTSDs: %u available; total %u\n", NumberOfTSDs,
                 TSDsArraySize);
+    if (NumaAware)
+      Str->append("  NUMA nodes: %u; TSD groups: %u\n", NumberOfNumaNodes,
+                  Min(NumberOfNumaNodes, NumberOfTSDs));
     for (uptr I = 0; I < NumberOfTSDs; ++I) {
       TSDs[I].lock();
       // Theoretically, we want to mark TSD::lock()/TSD::unlock() with proper
@@ -200,11 +211,31 @@ private:
     *getTlsPtr() |= B;
   }
 
+  // Returns the range of TSDs, out of the first N ones, the current thread is
+  // allowed to pick from. Without NUMA awareness, or if there are not enough
+  // TSDs to give each node its own, this is the whole array.
+  void getTSDGroup(u32 N, u32 *Begin, u32 *Size) {
+    const u32 NumberOfGroups = NumaAware ? Min(NumberOfNumaNodes, N) : 1U;
+    if (NumberOfGroups <= 1U) {
+      *Begin = 0;
+      *Size = N;
+      return;
+    }
+    const u32 Group = getNumaNodeOfCurrentCPU() % NumberOfGroups;
+    const u32 GroupSize = N / NumberOfGroups;
+    *Begin = Group * GroupSize;
+    // The last group gets the remainder.
+    *Size = (Group == NumberOfGroups - 1) ? N - *Begin : GroupSize;
+  }
+
   NOINLINE void initThread(Allocator *Instance) NO_THREAD_SAFETY_ANALYSIS {
     initOnceMaybe(Instance);
-    // Initial context assignment is done in a plain round-robin fashion.
+    // Initial context assignment is done in a plain round-robin fashion,
+    // within the group of the current NUMA node if applicable.
+    u32 Begin, Size;
+    getTSDGroup(NumberOfTSDs, &Begin, &Size);
     const u32 Index = atomic_fetch_add(&CurrentIndex, 1U, memory_order_relaxed);
-    setCurrentTSD(&TSDs[Index % NumberOfTSDs]);
+    setCurrentTSD(&TSDs[Begin + Index % Size]);
     Instance->callPostInitCallback();
   }
 
@@ -216,12 +247,16 @@ private:
     // in the slow path, it means that tryLock failed, and as a result it's
     // very likely that said Precedence is non-zero.
     const u32 R = static_cast<u32>(CurrentTSD->getPrecedence());
-    u32 N, Inc;
+    u32 Begin, N, Inc;
     {
       ScopedLock L(MutexTSDs);
-      N = NumberOfTSDs;
+      // Since the thread may have migrated since its TSD was assigned, the
+      // group is recomputed here rather than derived from the current TSD.
+      getTSDGroup(NumberOfTSDs, &Begin, &N);
       DCHECK_NE(NumberOfCoPrimes, 0U);
-      Inc = CoPrimes[R % NumberOfCoPrimes];
+      // The coprimes are those of NumberOfTSDs, so they can only be used to
+      // walk the whole array. A group is walked linearly.
+      Inc = (N == NumberOfTSDs) ? CoPrimes[R % NumberOfCoPrimes] : 1U;
     }
     if (N > 1U) {
       u32 Index = R % N;
@@ -229,14 +264,15 @@ private:
       TSD<Allocator> *CandidateTSD = nullptr;
       // Go randomly through at most 4 contexts and find a candidate.
       for (u32 I = 0; I < Min(4U, N); I++) {
-        if (TSDs[Index].tryLock()) {
-          setCurrentTSD(&TSDs[Index]);
-          return &TSDs[Index];
+        TSD<Allocator> *T = &TSDs[Begin + Index];
+        if (T->tryLock()) {
+          setCurrentTSD(T);
+          return T;
         }
-        const uptr Precedence = TSDs[Index].getPrecedence();
+        const uptr Precedence = T->getPrecedence();
         // A 0 precedence here means another thread just locked this TSD.
         if (Precedence && Precedence < LowestPrecedence) {
-          CandidateTSD = &TSDs[Index];
+          CandidateTSD = T;
           LowestPrecedence = Precedence;
         }
         Index += Inc;
@@ -256,6 +292,7 @@ private:
 
   atomic_u32 CurrentIndex = {};
   u32 NumberOfTSDs GUARDED_BY(MutexTSDs) = 0;
+  u32 NumberOfNumaNodes = 1U;
   u32 NumberOfCoPrimes GUARDED_BY(MutexTSDs) = 0;
   u32 CoPrimes[TSDsArraySize] GUARDED_BY(MutexTSDs) = {};
   bool Initialized GUARDED_BY(Mutex) = false;
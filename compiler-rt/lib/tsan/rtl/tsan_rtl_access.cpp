@@ -168,6 +168,21 @@ NOINLINE void DoReportRace(ThreadState* thr, RawShadow* shadow_mem, Shadow cur,
     SlotLock(thr);
 }
 
+// Called when a read finds all the shadow slots taken by reads of other
+// threads, i.e. the location is read-shared, and one of them would have to be
+// evicted. With many threads reading the same location, storing every read
+// makes the threads fight over the shadow cache line. Only one out of
+// shared_read_store_rate such reads is stored; the others rely on the reads
+// already in the shadow to catch a racing write.
+ALWAYS_INLINE bool SkipSharedReadStore(ThreadState* thr) {
+  const int rate = flags()->shared_read_store_rate;
+  if (LIKELY(rate <= 1))
+    return false;
+  return atomic_load_relaxed(&thr->trace_pos) / sizeof(Event) %
+             static_cast<uptr>(rate) !=
+         0;
+}
+
 #if !TSAN_VECTORIZE
 ALWAYS_INLINE
 bool ContainsSameAccess(RawShadow* s, Shadow cur, int unused0, int unused1,
@@ -195,9 +210,12 @@ ALWAYS_INLINE
 bool CheckRaces(ThreadState* thr, RawShadow* shadow_mem, Shadow cur,
                 int unused0, int unused1, AccessType typ) {
   bool stored = false;
+  bool all_reads = !!(typ & kAccessRead);
   for (uptr idx = 0; idx < kShadowCnt; idx++) {
     RawShadow* sp = &shadow_mem[idx];
     Shadow old(LoadShadow(sp));
+    all_reads &= !!(static_cast<u32>(old.raw()) &
+                    static_cast<u32>(Shadow::kRodata));
     if (LIKELY(old.raw() == Shadow::kEmpty)) {
       if (!(typ & kAccessCheckOnly) && !stored)
         StoreShadow(sp, cur.raw());
@@ -224,6 +242,8 @@ bool CheckRaces(ThreadState* thr, RawShadow* shadow_mem, Shadow cur,
   // the current access info, so we are done.
   if (LIKELY(stored))
     return false;
+  if (all_reads && !(typ & kAccessCheckOnly) && SkipSharedReadStore(thr))
+    return false;
   // Choose a random candidate slot and replace it.
   uptr index =
       atomic_load_relaxed(&thr->trace_pos) / sizeof(Event) % kShadowCnt;
@@ -345,8 +365,18 @@ STORE : {
     const m128 empty = _mm_cmpeq_epi32(shadow, zero);
     const int empty_mask = _mm_movemask_epi8(empty);
     index = __builtin_ffs(empty_mask);
-    if (UNLIKELY(index == 0))
+    if (UNLIKELY(index == 0)) {
+      if (typ & kAccessRead) {
+        // Shadow::kRodata has only the read bit set.
+        const m128 read_mask =
+            _mm_set1_epi32(static_cast<u32>(Shadow::kRodata));
+        const m128 writes =
+            _mm_cmpeq_epi32(_mm_and_si128(shadow, read_mask), zero);
+        if (_mm_movemask_epi8(writes) == 0 && SkipSharedReadStore(thr))
+          return false;
+      }
       index = (atomic_load_relaxed(&thr->trace_pos) / 2) % 16;
+    }
   }
   StoreShadow(&shadow_mem[index / 4], cur.raw());
   // We could zero other slots determined by rewrite_mask.
@@ -17,6 +17,7 @@
 #include <future>
 #include <thread>
 #include <unistd.h>
+#include <vector>
 
 namespace __xray {
 namespace {
@@ -120,6 +121,33 @@ TEST(BufferQueueTest, Apply) {
   ASSERT_EQ(Count, 10);
 }
 
+TEST(BufferQueueTest, StreamingWaitsForDrain) {
+  bool Success = false;
+  BufferQueue Buffers(kSize, 2, Success, /*S=*/true);
+  ASSERT_TRUE(Success);
+  BufferQueue::Buffer B0, B1;
+  ASSERT_EQ(Buffers.getBuffer(B0), BufferQueue::ErrorCode::Ok);
+  ASSERT_EQ(Buffers.getBuffer(B1), BufferQueue::ErrorCode::Ok);
+  void *Data0 = B0.Data;
+  void *Data1 = B1.Data;
+  ASSERT_EQ(Buffers.releaseBuffer(B1), BufferQueue::ErrorCode::Ok);
+  ASSERT_EQ(Buffers.releaseBuffer(B0), BufferQueue::ErrorCode::Ok);
+
+  // Released buffers are not reused until they have been drained.
+  BufferQueue::Buffer B;
+  EXPECT_EQ(Buffers.getBuffer(B), BufferQueue::ErrorCode::NotEnoughMemory);
+
+  std::vector<void *> Drained;
+  size_t NumDrained = Buffers.drain(
+      [&](const BufferQueue::Buffer &D) { Drained.push_back(D.Data); });
+  EXPECT_EQ(NumDrained, 2u);
+  EXPECT_THAT(Drained, ::testing::ElementsAre(Data1, Data0));
+  EXPECT_EQ(Buffers.drain([](const BufferQueue::Buffer &) {}), 0u);
+
+  ASSERT_EQ(Buffers.getBuffer(B), BufferQueue::ErrorCode::Ok);
+  ASSERT_EQ(Buffers.releaseBuffer(B), BufferQueue::ErrorCode::Ok);
+}
+
 TEST(BufferQueueTest, GenerationalSupport) {
   bool Success = false;
   BufferQueue Buffers(kSize, 10, Success);
@@ -67,7 +67,7 @@ constexpr size_t kExtentsSize = sizeof(ExtentsPadded);
 
 } // namespace
 
-BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
+BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC, bool S) {
   SpinMutexLock Guard(&Mutex);
 
   if (!finalizing())
@@ -137,13 +137,16 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
   Next = Buffers;
   First = Buffers;
   LiveBuffers = 0;
+  Streaming = S;
+  NextToDrain = Buffers;
+  UndrainedBuffers = 0;
   atomic_store(&Finalizing, 0, memory_order_release);
   Success = true;
   return BufferQueue::ErrorCode::Ok;
 }
 
-BufferQueue::BufferQueue(size_t B, size_t N,
-                         bool &Success) XRAY_NEVER_INSTRUMENT
+BufferQueue::BufferQueue(size_t B, size_t N, bool &Success,
+                         bool S) XRAY_NEVER_INSTRUMENT
     : BufferSize(B),
       BufferCount(N),
       Mutex(),
@@ -154,8 +157,11 @@ BufferQueue::BufferQueue(size_t B, size_t N,
       Next(Buffers),
       First(Buffers),
       LiveBuffers(0),
+      Streaming(S),
+      NextToDrain(Buffers),
+      UndrainedBuffers(0),
       Generation{0} {
-  Success = init(B, N) == BufferQueue::ErrorCode::Ok;
+  Success = init(B, N, S) == BufferQueue::ErrorCode::Ok;
 }
 
 BufferQueue::ErrorCode BufferQueue::getBuffer(Buffer &Buf) {
@@ -165,7 +171,7 @@ BufferQueue::ErrorCode BufferQueue::getBuffer(Buffer &Buf) {
   BufferRep *B = nullptr;
   {
     SpinMutexLock Guard(&Mutex);
-    if (LiveBuffers == BufferCount)
+    if (LiveBuffers + UndrainedBuffers == BufferCount)
       return ErrorCode::NotEnoughMemory;
     B = Next++;
     if (Next == (Buffers + BufferCount))
@@ -202,11 +208,14 @@ BufferQueue::ErrorCode BufferQueue::releaseBuffer(Buffer &Buf) {
     B = First++;
     if (First == (Buffers + BufferCount))
       First = Buffers;
-  }
 
-  // Now that the buffer has been released, we mark it as "used".
-  B->Buff = Buf;
-  B->Used = true;
+    // Now that the buffer has been released, we mark it as "used". This
+    // happens under the lock so that 'drain' never sees a stale buffer.
+    B->Buff = Buf;
+    B->Used = true;
+    if (Streaming)
+      ++UndrainedBuffers;
+  }
   decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
   decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
   atomic_store(B->Buff.Extents, atomic_load(Buf.Extents, memory_order_acquire),
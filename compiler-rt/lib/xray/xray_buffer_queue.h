@@ -159,6 +159,13 @@ private:
   // Count of buffers that have been handed out through 'getBuffer'.
   size_t LiveBuffers;
 
+  // When streaming, released buffers are not handed out again until they have
+  // been passed to 'drain'. These track the oldest such buffer and how many
+  // there are.
+  bool Streaming;
+  BufferRep *NextToDrain;
+  size_t UndrainedBuffers;
+
   // We use a generation number to identify buffers and which generation they're
   // associated with.
   atomic_uint64_t Generation;
@@ -195,8 +202,9 @@ public:
   }
 
   /// Initialise a queue of size |N| with buffers of size |B|. We report success
-  /// through |Success|.
-  BufferQueue(size_t B, size_t N, bool &Success);
+  /// through |Success|. When |S| is true, the queue is in streaming mode (see
+  /// 'drain').
+  BufferQueue(size_t B, size_t N, bool &Success, bool S = false);
 
   /// Updates |Buf| to contain the pointer to an appropriate buffer. Returns an
   /// error in case there are no available buffers to return when we will run
@@ -221,13 +229,43 @@ public:
   ErrorCode releaseBuffer(Buffer &Buf);
 
   /// Initializes the buffer queue, starting a new generation. We can re-set the
-  /// size of buffers with |BS| along with the buffer count with |BC|.
+  /// size of buffers with |BS| along with the buffer count with |BC|, and
+  /// enable streaming mode with |S|.
   ///
   /// Returns:
   ///   - ErrorCode::Ok when we successfully initialize the buffer. This
   ///   requires that the buffer queue is previously finalized.
   ///   - ErrorCode::AlreadyInitialized when the buffer queue is not finalized.
-  ErrorCode init(size_t BS, size_t BC);
+  ErrorCode init(size_t BS, size_t BC, bool S = false);
+
+  /// In streaming mode, applies the provided function F to each Buffer that
+  /// has been released since the last call to drain, in the order they were
+  /// released, and then makes them available to getBuffer(...) again. Buffers
+  /// are never overwritten before they are drained; once all of them are
+  /// either live or waiting to be drained, getBuffer(...) fails with
+  /// ErrorCode::NotEnoughMemory. F runs without holding the queue's lock.
+  /// Only one thread may drain at a time.
+  ///
+  /// Returns the number of buffers drained.
+  template <class F> size_t drain(F Fn) XRAY_NEVER_INSTRUMENT {
+    BufferRep *Start = nullptr;
+    size_t Count = 0;
+    {
+      SpinMutexLock G(&Mutex);
+      Start = NextToDrain;
+      Count = UndrainedBuffers;
+    }
+    BufferRep *B = Start;
+    for (size_t I = 0; I < Count; ++I) {
+      Fn(static_cast<const Buffer &>(B->Buff));
+      if (++B == Buffers + BufferCount)
+        B = Buffers;
+    }
+    SpinMutexLock G(&Mutex);
+    NextToDrain = B;
+    UndrainedBuffers -= Count;
+    return Count;
+  }
 
   bool finalizing() const {
     return atomic_load(&Finalizing, memory_order_acquire);
@@ -27,6 +27,7 @@
 #include "sanitizer_common/sanitizer_allocator_internal.h"
 #include "sanitizer_common/sanitizer_atomic.h"
 #include "sanitizer_common/sanitizer_common.h"
+#include "sanitizer_common/sanitizer_file.h"
 #include "xray/xray_interface.h"
 #include "xray/xray_records.h"
 #include "xray_allocator.h"
@@ -90,6 +91,12 @@ static atomic_uint64_t TicksPerSec{0};
 static atomic_sint32_t LogFlushStatus = {
     XRayLogFlushStatus::XRAY_LOG_NOT_FLUSHING};
 
+// When streaming, the log the background thread writes to, the thread, and
+// the flag that tells it to stop.
+static LogWriter *StreamWriter = nullptr;
+static void *StreamThread = nullptr;
+static atomic_uint8_t StreamStop{0};
+
 // This function will initialize the thread-local data structure used by the FDR
 // logging implementation and return a reference to it. The implementation
 // details require a bit of care to maintain.
@@ -173,6 +180,67 @@ static XRayFileHeader &fdrCommonHeaderInfo() {
   return reinterpret_cast<XRayFileHeader &>(HStorage);
 }
 
+static void writeHeader(LogWriter *LW) XRAY_NEVER_INSTRUMENT {
+  XRayFileHeader Header = fdrCommonHeaderInfo();
+  Header.FdrData = FdrAdditionalHeaderData{BQ->ConfiguredBufferSize()};
+  LW->WriteAll(reinterpret_cast<char *>(&Header),
+               reinterpret_cast<char *>(&Header) + sizeof(Header));
+}
+
+static void writeBuffer(LogWriter *LW,
+                        const BufferQueue::Buffer &B) XRAY_NEVER_INSTRUMENT {
+  // Starting at version 2 of the FDR logging implementation, we only write
+  // the records identified by the extents of the buffer. We use the Extents
+  // from the Buffer and write that out as the first record in the buffer.  We
+  // still use a Metadata record, but fill in the extents instead for the
+  // data.
+  MetadataRecord ExtentsRecord;
+  auto BufferExtents = atomic_load(B.Extents, memory_order_acquire);
+  DCHECK(BufferExtents <= B.Size);
+  ExtentsRecord.Type = uint8_t(RecordType::Metadata);
+  ExtentsRecord.RecordKind =
+      uint8_t(MetadataRecord::RecordKinds::BufferExtents);
+  internal_memcpy(ExtentsRecord.Data, &BufferExtents, sizeof(BufferExtents));
+  if (BufferExtents > 0) {
+    LW->WriteAll(reinterpret_cast<char *>(&ExtentsRecord),
+                 reinterpret_cast<char *>(&ExtentsRecord) +
+                     sizeof(MetadataRecord));
+    LW->WriteAll(reinterpret_cast<char *>(B.Data),
+                 reinterpret_cast<char *>(B.Data) + BufferExtents);
+  }
+}
+
+static LogWriter *openStreamWriter() XRAY_NEVER_INSTRUMENT {
+#if !SANITIZER_FUCHSIA
+  const char *Path = fdrFlags()->stream_path;
+  if (Path != nullptr && Path[0] != '\0') {
+    error_t Err = 0;
+    fd_t Fd = OpenFile(Path, WrOnly, &Err);
+    if (Fd == kInvalidFd) {
+      Report("XRay FDR: Failed opening '%s' for streaming; errno = %d\n", Path,
+             Err);
+      return nullptr;
+    }
+    LogWriter *LW = allocate<LogWriter>();
+    new (LW) LogWriter(Fd);
+    return LW;
+  }
+#endif
+  return LogWriter::Open();
+}
+
+// The background thread that writes out buffers as soon as they have been
+// released, while streaming.
+static void *streamBuffers(void *) XRAY_NEVER_INSTRUMENT {
+  while (!atomic_load(&StreamStop, memory_order_acquire)) {
+    BQ->drain([](const BufferQueue::Buffer &B) {
+      writeBuffer(StreamWriter, B);
+    });
+    SleepForMillis(fdrFlags()->stream_interval_ms);
+  }
+  return nullptr;
+}
+
 // This is the iterator implementation, which knows how to handle FDR-mode
 // specific buffers. This is used as an implementation of the iterator function
 // needed by __xray_set_buffer_iterator(...). It maintains a global state of the
@@ -321,6 +389,28 @@ XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
       TLD.Controller->flush();
   });
 
+  // When streaming, all that is left is to stop the background thread and to
+  // write out the buffers it has not seen yet, including the current
+  // thread's.
+  if (StreamWriter != nullptr) {
+    atomic_store(&StreamStop, 1, memory_order_release);
+    internal_join_thread(StreamThread);
+    StreamThread = nullptr;
+
+    auto &TLD = getThreadLocalData();
+    if (TLD.Controller != nullptr)
+      TLD.Controller->flush();
+    BQ->drain([](const BufferQueue::Buffer &B) {
+      writeBuffer(StreamWriter, B);
+    });
+    LogWriter::Close(StreamWriter);
+    StreamWriter = nullptr;
+
+    atomic_store(&LogFlushStatus, XRayLogFlushStatus::XRAY_LOG_FLUSHED,
+                 memory_order_release);
+    return XRayLogFlushStatus::XRAY_LOG_FLUSHED;
+  }
+
   if (fdrFlags()->no_file_flush) {
     if (Verbosity())
       Report("XRay FDR: Not flushing to file, 'no_file_flush=true'.\n");
@@ -346,10 +436,7 @@ XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
     return Result;
   }
 
-  XRayFileHeader Header = fdrCommonHeaderInfo();
-  Header.FdrData = FdrAdditionalHeaderData{BQ->ConfiguredBufferSize()};
-  LW->WriteAll(reinterpret_cast<char *>(&Header),
-               reinterpret_cast<char *>(&Header) + sizeof(Header));
+  writeHeader(LW);
 
   // Release the current thread's buffer before we attempt to write out all the
   // buffers. This ensures that in case we had only a single thread going, that
@@ -358,27 +445,7 @@ XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
   if (TLD.Controller != nullptr)
     TLD.Controller->flush();
 
-  BQ->apply([&](const BufferQueue::Buffer &B) {
-    // Starting at version 2 of the FDR logging implementation, we only write
-    // the records identified by the extents of the buffer. We use the Extents
-    // from the Buffer and write that out as the first record in the buffer.  We
-    // still use a Metadata record, but fill in the extents instead for the
-    // data.
-    MetadataRecord ExtentsRecord;
-    auto BufferExtents = atomic_load(B.Extents, memory_order_acquire);
-    DCHECK(BufferExtents <= B.Size);
-    ExtentsRecord.Type = uint8_t(RecordType::Metadata);
-    ExtentsRecord.RecordKind =
-        uint8_t(MetadataRecord::RecordKinds::BufferExtents);
-    internal_memcpy(ExtentsRecord.Data, &BufferExtents, sizeof(BufferExtents));
-    if (BufferExtents > 0) {
-      LW->WriteAll(reinterpret_cast<char *>(&ExtentsRecord),
-                   reinterpret_cast<char *>(&ExtentsRecord) +
-                       sizeof(MetadataRecord));
-      LW->WriteAll(reinterpret_cast<char *>(B.Data),
-                   reinterpret_cast<char *>(B.Data) + BufferExtents);
-    }
-  });
+  BQ->apply([&](const BufferQueue::Buffer &B) { writeBuffer(LW, B); });
 
   atomic_store(&LogFlushStatus, XRayLogFlushStatus::XRAY_LOG_FLUSHED,
                memory_order_release);
@@ -662,23 +729,38 @@ XRayLogInitStatus fdrLoggingInit(size_t, size_t, void *Options,
   *fdrFlags() = FDRFlags;
   auto BufferSize = FDRFlags.buffer_size;
   auto BufferMax = FDRFlags.buffer_max;
+  auto Stream = FDRFlags.stream;
 
   if (BQ == nullptr) {
     bool Success = false;
     BQ = reinterpret_cast<BufferQueue *>(&BufferQueueStorage);
-    new (BQ) BufferQueue(BufferSize, BufferMax, Success);
+    new (BQ) BufferQueue(BufferSize, BufferMax, Success, Stream);
     if (!Success) {
       Report("BufferQueue init failed.\n");
       return XRayLogInitStatus::XRAY_LOG_UNINITIALIZED;
     }
   } else {
-    if (BQ->init(BufferSize, BufferMax) != BufferQueue::ErrorCode::Ok) {
+    if (BQ->init(BufferSize, BufferMax, Stream) !=
+        BufferQueue::ErrorCode::Ok) {
       if (Verbosity())
         Report("Failed to re-initialize global buffer queue. Init failed.\n");
       return XRayLogInitStatus::XRAY_LOG_UNINITIALIZED;
     }
   }
 
+  if (Stream) {
+    StreamWriter = openStreamWriter();
+    if (StreamWriter == nullptr) {
+      BQ->finalize();
+      atomic_store(&LoggingStatus, XRayLogInitStatus::XRAY_LOG_UNINITIALIZED,
+                   memory_order_release);
+      return XRayLogInitStatus::XRAY_LOG_UNINITIALIZED;
+    }
+    writeHeader(StreamWriter);
+    atomic_store(&StreamStop, 0, memory_order_release);
+    StreamThread = internal_start_thread(streamBuffers, nullptr);
+  }
+
   static pthread_once_t OnceInit = PTHREAD_ONCE_INIT;
   pthread_once(
       &OnceInit, +[] {
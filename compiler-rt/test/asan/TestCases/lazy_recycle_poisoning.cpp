@@ -0,0 +1,27 @@
+// Chunks recycled lazily must get their redzones back when they are reused.
+// RUN: %clangxx_asan -O0 %s -o %t
+// RUN: %env_asan_opts=quarantine_size_mb=0:lazy_recycle_poisoning_size=1 not %run %t 2>&1 | FileCheck %s
+// RUN: %env_asan_opts=quarantine_size_mb=0:lazy_recycle_poisoning_size=1 not %run %t left 2>&1 | FileCheck %s --check-prefix=LEFT
+
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char **argv) {
+  // Reuse the same chunk with decreasing sizes so that parts of the previous
+  // user memory end up in the redzones of the new allocation.
+  char *volatile x = nullptr;
+  for (int size = 4000; size > 3000; size -= 100) {
+    x = (char *)malloc(size);
+    memset(x, 0, size);
+    free(x);
+  }
+  x = (char *)malloc(3001);
+  memset(x, 0, 3001);
+  int res = argc > 1 ? x[-1] : x[3001];
+  free(x);
+  return res;
+  // CHECK: heap-buffer-overflow
+  // CHECK: 0 bytes after 3001-byte region
+  // LEFT: heap-buffer-overflow
+  // LEFT: 1 bytes before 3001-byte region
+}
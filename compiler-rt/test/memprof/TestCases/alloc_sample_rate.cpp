@@ -0,0 +1,25 @@
+// Check that alloc_sample_rate profiles only a fraction of the allocations.
+
+// RUN: %clangxx_memprof  %s -o %t
+
+// RUN: %env_memprof_opts=print_text=true:log_path=stdout %run %t | FileCheck %s --check-prefix=ALL
+// RUN: %env_memprof_opts=print_text=true:log_path=stdout:alloc_sample_rate=1 %run %t | FileCheck %s --check-prefix=ALL
+// RUN: %env_memprof_opts=print_text=true:log_path=stdout:alloc_sample_rate=100 %run %t | FileCheck %s --check-prefix=SAMPLED
+
+#include <stdlib.h>
+#include <string.h>
+int main(int argc, char **argv) {
+  for (int i = 0; i < 10000; i++) {
+    char *x = (char *)malloc(77);
+    memset(x, 0, 77);
+    free(x);
+  }
+  return 0;
+}
+// Every allocation is profiled by default.
+// ALL: alloc_count 10000, size (ave/min/max) 77.00 / 77 / 77
+
+// About one in 100 allocations is profiled. The chance of profiling none, or
+// 1000 or more, of them is negligible.
+// SAMPLED-NOT: alloc_count 10000, size (ave/min/max) 77.00
+// SAMPLED: alloc_count {{[1-9][0-9]?[0-9]?}}, size (ave/min/max) 77.00 / 77 / 77
@@ -0,0 +1,50 @@
+// RUN: %clang_pgogen -O2 -mllvm -instrprof-shard-counters -o %t %s -pthread
+// RUN: rm -f %t.profraw
+// RUN: env LLVM_PROFILE_FILE=%t.profraw %run %t
+// RUN: llvm-profdata show --all-functions --counts %t.profraw | FileCheck %s
+
+// Counts of the threads that exited before the profile is written, and of the
+// ones that are still running, both end up in the profile.
+
+#include <pthread.h>
+
+#define NUM_THREADS 8
+#define NUM_ITERS 100000
+
+static pthread_barrier_t Barrier;
+static volatile int Sink;
+
+__attribute__((noinline)) void update(int I) { Sink += I; }
+
+void *worker(void *Arg) {
+  for (int I = 0; I < NUM_ITERS; ++I)
+    update(I);
+  return 0;
+}
+
+void *waiter(void *Arg) {
+  update(0);
+  pthread_barrier_wait(&Barrier);
+  pthread_barrier_wait(&Barrier);
+  return 0;
+}
+
+int main(void) {
+  pthread_t Threads[NUM_THREADS];
+  for (int Round = 0; Round < 2; ++Round) {
+    for (int I = 0; I < NUM_THREADS; ++I)
+      pthread_create(&Threads[I], 0, worker, 0);
+    for (int I = 0; I < NUM_THREADS; ++I)
+      pthread_join(Threads[I], 0);
+  }
+
+  // This thread still owns its shard when the profile is written at exit.
+  pthread_t Waiter;
+  pthread_barrier_init(&Barrier, 0, 2);
+  pthread_create(&Waiter, 0, waiter, 0);
+  pthread_barrier_wait(&Barrier);
+  return 0;
+}
+
+// CHECK-LABEL: update:
+// CHECK: Block counts: [1600001]
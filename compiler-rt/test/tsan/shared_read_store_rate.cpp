@@ -0,0 +1,38 @@
+// RUN: %clangxx_tsan -O1 %s -o %t
+// RUN: %env_tsan_opts=shared_read_store_rate=8 %deflake %run %t 2>&1 | FileCheck %s
+
+// A write racing with reads of a location shared by more readers than fit in
+// the shadow is still detected when only some of the reads are remembered.
+
+#include "test.h"
+
+const int kReaders = 16;
+int Global;
+
+void *Reader(void *x) {
+  int sum = 0;
+  for (int i = 0; i < 1000; i++)
+    sum += *(volatile int *)&Global;
+  barrier_wait(&barrier);
+  return (void *)(long)sum;
+}
+
+void *Writer(void *x) {
+  barrier_wait(&barrier);
+  Global = 1;
+  return NULL;
+}
+
+int main() {
+  barrier_init(&barrier, kReaders + 1);
+  pthread_t t[kReaders + 1];
+  for (int i = 0; i < kReaders; i++)
+    pthread_create(&t[i], NULL, Reader, NULL);
+  pthread_create(&t[kReaders], NULL, Writer, NULL);
+  for (int i = 0; i <= kReaders; i++)
+    pthread_join(t[i], NULL);
+  return 0;
+}
+
+// CHECK: WARNING: ThreadSanitizer: data race
+// CHECK: SUMMARY: ThreadSanitizer: data race{{.*}}Writer
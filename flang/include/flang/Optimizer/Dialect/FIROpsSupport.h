@@ -109,6 +109,12 @@ static constexpr llvm::StringRef getHostSymbolAttrName() {
   return "fir.host_symbol";
 }
 
+/// Attribute to mark the fir.do_loop operations of a DO CONCURRENT construct,
+/// whose iterations may run in any order and in parallel.
+static constexpr llvm::StringRef getDoConcurrentAttrName() {
+  return "fir.do_concurrent";
+}
+
 /// Attribute containing the original name of a function from before the
 /// ExternalNameConverision pass runs
 static constexpr llvm::StringRef getInternalFuncNameAttrName() {
@@ -11,8 +11,25 @@
 #ifndef FORTRAN_RUNTIME_MATMUL_H_
 #define FORTRAN_RUNTIME_MATMUL_H_
 #include "flang/Runtime/entry-names.h"
+#include <complex>
 namespace Fortran::runtime {
 class Descriptor;
+
+// External BLAS-3 GEMM routines with the reference Fortran BLAS interface
+// (C = alpha*op(A)*op(B) + beta*C, column-major, arguments by reference).
+template <typename T>
+using GemmRoutine = void (*)(const char *transa, const char *transb,
+    const int *m, const int *n, const int *k, const T *alpha, const T *a,
+    const int *lda, const T *b, const int *ldb, const T *beta, T *c,
+    const int *ldc);
+
+struct MatmulBlasRoutines {
+  GemmRoutine<float> sgemm{nullptr};
+  GemmRoutine<double> dgemm{nullptr};
+  GemmRoutine<std::complex<float>> cgemm{nullptr};
+  GemmRoutine<std::complex<double>> zgemm{nullptr};
+};
+
 extern "C" {
 
 // The most general MATMUL.  All type and shape information is taken from the
@@ -24,6 +41,12 @@ void RTDECL(Matmul)(Descriptor &, const Descriptor &, const Descriptor &,
 // and have a valid base address.
 void RTDECL(MatmulDirect)(const Descriptor &, const Descriptor &,
     const Descriptor &, const char *sourceFile = nullptr, int line = 0);
+
+// Routes MATMUL and MATMUL(TRANSPOSE()) of large REAL and COMPLEX matrices of
+// a single type to external GEMM routines; null routines are not used.  The
+// matrices must be large enough that the call pays off, and their extents
+// must fit in a default INTEGER.  Passing null disables the routing.
+void RTDECL(RegisterMatmulBlas)(const MatmulBlasRoutines *);
 } // extern "C"
 } // namespace Fortran::runtime
 #endif // FORTRAN_RUNTIME_MATMUL_H_
@@ -320,16 +320,28 @@ bool CodeGenAction::beginSourceFileAction() {
   // Add OpenMP-related passes
   // WARNING: These passes must be run immediately after the lowering to ensure
   // that the FIR is correct with respect to OpenMP operations/attributes.
+  bool doConcurrentParallel =
+      ci.getInvocation().getCodeGenOpts().DoConcurrentParallel;
   if (ci.getInvocation().getFrontendOpts().features.IsEnabled(
           Fortran::common::LanguageFeature::OpenMP)) {
     bool isDevice = false;
     if (auto offloadMod = llvm::dyn_cast<mlir::omp::OffloadModuleInterface>(
             mlirModule->getOperation()))
       isDevice = offloadMod.getIsTargetDevice();
+    // DO CONCURRENT loops are only mapped to host threads; offloading them
+    // to a device is not supported yet.
+    if (doConcurrentParallel && !isDevice)
+      pm.addNestedPass<mlir::func::FuncOp>(
+          fir::createDoConcurrentConversionPass());
     // WARNING: This pipeline must be run immediately after the lowering to
     // ensure that the FIR is correct with respect to OpenMP operations/
     // attributes.
     fir::createOpenMPFIRPassPipeline(pm, isDevice);
+  } else if (doConcurrentParallel) {
+    unsigned diagID = ci.getDiagnostics().getCustomDiagID(
+        clang::DiagnosticsEngine::Warning,
+        "-fdo-concurrent-parallel requires -fopenmp and is ignored");
+    ci.getDiagnostics().Report(diagID);
   }
 
   pm.enableVerifier(/*verifyPasses=*/true);
@@ -1902,6 +1902,10 @@ private:
           // The loop variable value is explicitly updated.
           info.doLoop = builder->create<fir::DoLoopOp>(
               loc, lowerValue, upperValue, stepValue, /*unordered=*/true);
+          // Unordered increment loops come from DO CONCURRENT constructs;
+          // tag them so that they may later be mapped to parallel loops.
+          info.doLoop->setAttr(fir::getDoConcurrentAttrName(),
+                               builder->getUnitAttr());
           builder->setInsertionPointToStart(info.doLoop.getBody());
           loopValue = builder->createConvert(loc, loopVarType,
                                              info.doLoop.getInductionVar());
@@ -16,6 +16,7 @@
 #include "flang/Optimizer/Builder/FIRBuilder.h"
 #include "flang/Optimizer/Builder/HLFIRTools.h"
 #include "flang/Optimizer/Dialect/FIROps.h"
+#include "flang/Optimizer/Dialect/FIROpsSupport.h"
 #include "flang/Optimizer/Dialect/FIRType.h"
 #include "flang/Optimizer/HLFIR/HLFIRDialect.h"
 #include "flang/Optimizer/HLFIR/HLFIROps.h"
@@ -73,8 +74,9 @@ namespace {
 /// elements of %array in place without creating an extra temporary for the
 /// elemental. We must check that there are no reads from the array at indexes
 /// which might conflict with the assignment or any writes. For now we will keep
-/// that strict and say that all reads must be at the elemental index (it is
-/// probably safe to read from higher indices if lowering to an ordered loop).
+/// that strict and say that all reads must be at the elemental index, either
+/// of the array itself or of a section of it shifted towards higher subscripts,
+/// as in a(1:n-1) = a(2:n); the latter requires an ordered loop.
 class ElementalAssignBufferization
     : public mlir::OpRewritePattern<hlfir::ElementalOp> {
 private:
@@ -82,6 +84,9 @@ private:
     mlir::Value array;
     hlfir::AssignOp assign;
     hlfir::DestroyOp destroy;
+    // The elemental reads elements of the array that the assignment writes
+    // at later iterations, so the loop nest must run in order.
+    bool needsOrderedLoop = false;
   };
   /// determines if the transformation can be applied to this elemental
   static std::optional<MatchInfo> findMatch(hlfir::ElementalOp elemental);
@@ -158,6 +163,33 @@ containsReadOrWriteEffectOn(const mlir::MemoryEffects::EffectInstance &effect,
   return mlir::AliasResult::NoAlias;
 }
 
+// Returns true if the given designators differ at most in their subscripts
+// and the sections that they select.
+static bool haveSameDesignatorSpecs(hlfir::DesignateOp des1,
+                                    hlfir::DesignateOp des2) {
+  // Require all components of the designators to be the same.
+  // It might be too strict, e.g. we may probably allow for
+  // different type parameters.
+  if (des1.getComponent() != des2.getComponent() ||
+      des1.getComponentShape() != des2.getComponentShape() ||
+      des1.getSubstring() != des2.getSubstring() ||
+      des1.getComplexPart() != des2.getComplexPart() ||
+      des1.getTypeparams() != des2.getTypeparams()) {
+    LLVM_DEBUG(llvm::dbgs() << "Different designator specs for:\n"
+                            << des1 << "and:\n"
+                            << des2 << "\n");
+    return false;
+  }
+
+  if (des1.getIsTriplet() != des2.getIsTriplet()) {
+    LLVM_DEBUG(llvm::dbgs() << "Different sections for:\n"
+                            << des1 << "and:\n"
+                            << des2 << "\n");
+    return false;
+  }
+  return true;
+}
+
 // Returns true if the given array references represent identical
 // or completely disjoint array slices. The callers may use this
 // method when the alias analysis reports an alias of some kind,
@@ -182,26 +214,8 @@ static bool areIdenticalOrDisjointSlices(mlir::Value ref1, mlir::Value ref2) {
     return false;
   }
 
-  // Require all components of the designators to be the same.
-  // It might be too strict, e.g. we may probably allow for
-  // different type parameters.
-  if (des1.getComponent() != des2.getComponent() ||
-      des1.getComponentShape() != des2.getComponentShape() ||
-      des1.getSubstring() != des2.getSubstring() ||
-      des1.getComplexPart() != des2.getComplexPart() ||
-      des1.getTypeparams() != des2.getTypeparams()) {
-    LLVM_DEBUG(llvm::dbgs() << "Different designator specs for:\n"
-                            << des1 << "and:\n"
-                            << des2 << "\n");
+  if (!haveSameDesignatorSpecs(des1, des2))
     return false;
-  }
-
-  if (des1.getIsTriplet() != des2.getIsTriplet()) {
-    LLVM_DEBUG(llvm::dbgs() << "Different sections for:\n"
-                            << des1 << "and:\n"
-                            << des2 << "\n");
-    return false;
-  }
 
   // Analyze the subscripts.
   // For example:
@@ -294,6 +308,77 @@ static bool areIdenticalOrDisjointSlices(mlir::Value ref1, mlir::Value ref2) {
   return false;
 }
 
+// Returns the constant C such that `value` is `base + C`, if any.
+static std::optional<std::int64_t> getConstantDisplacement(mlir::Value base,
+                                                           mlir::Value value) {
+  auto removeConvert = [](mlir::Value v) {
+    while (auto conv = v.getDefiningOp<fir::ConvertOp>())
+      v = conv.getValue();
+    return v;
+  };
+  base = removeConvert(base);
+  value = removeConvert(value);
+  if (base == value)
+    return 0;
+  if (auto baseCst = fir::getIntIfConstant(base))
+    if (auto valueCst = fir::getIntIfConstant(value))
+      return *valueCst - *baseCst;
+  if (auto addi = value.getDefiningOp<mlir::arith::AddIOp>()) {
+    if (removeConvert(addi.getLhs()) == base)
+      return fir::getIntIfConstant(addi.getRhs());
+    if (removeConvert(addi.getRhs()) == base)
+      return fir::getIntIfConstant(addi.getLhs());
+  }
+  if (auto subi = value.getDefiningOp<mlir::arith::SubIOp>())
+    if (removeConvert(subi.getLhs()) == base)
+      if (auto cst = fir::getIntIfConstant(subi.getRhs()))
+        return -*cst;
+  return std::nullopt;
+}
+
+// Returns true if the array section `read` is the array section `written`
+// shifted towards higher subscripts, e.g. a(2:n) and a(1:n-1): every lower
+// bound of `read` is the corresponding one of `written` plus a non-negative
+// constant, under the same positive stride. The element of `read` at some
+// elemental indices is then either never written, or written at indices that
+// come later in a loop nest running forwards in every dimension. So a
+// self-referencing assignment like a(1:n-1) = a(2:n) + 1 can be done in place
+// by such an ordered loop nest, without a temporary.
+static bool isForwardShiftedSlice(mlir::Value written, mlir::Value read) {
+  auto des1 = written.getDefiningOp<hlfir::DesignateOp>();
+  auto des2 = read.getDefiningOp<hlfir::DesignateOp>();
+  if (!des1 || !des2 || des1.getMemref() != des2.getMemref() ||
+      !haveSameDesignatorSpecs(des1, des2))
+    return false;
+
+  auto des1It = des1.getIndices().begin();
+  auto des2It = des2.getIndices().begin();
+  for (bool isTriplet : des1.getIsTriplet()) {
+    if (!isTriplet) {
+      if (*des1It++ != *des2It++)
+        return false;
+      continue;
+    }
+    mlir::Value des1Lb = *des1It++;
+    mlir::Value des2Lb = *des2It++;
+    // The upper bounds follow from the common shape of the sections.
+    ++des1It;
+    ++des2It;
+    mlir::Value des1Stride = *des1It++;
+    mlir::Value des2Stride = *des2It++;
+    std::optional<std::int64_t> stride = fir::getIntIfConstant(des1Stride);
+    std::optional<std::int64_t> shift =
+        getConstantDisplacement(des1Lb, des2Lb);
+    if (des1Stride != des2Stride || !stride || *stride <= 0 || !shift ||
+        *shift < 0)
+      return false;
+  }
+  LLVM_DEBUG(llvm::dbgs() << "Forward shifted slices:\n"
+                          << des1 << "and:\n"
+                          << des2 << "\n");
+  return true;
+}
+
 std::optional<ElementalAssignBufferization::MatchInfo>
 ElementalAssignBufferization::findMatch(hlfir::ElementalOp elemental) {
   mlir::Operation::user_range users = elemental->getUsers();
@@ -418,10 +503,15 @@ ElementalAssignBufferization::findMatch(hlfir::ElementalOp elemental) {
     if (!res.isPartial()) {
       if (auto designate =
               effect.getValue().getDefiningOp<hlfir::DesignateOp>()) {
+        bool forwardShifted = false;
         if (!areIdenticalOrDisjointSlices(match.array, designate.getMemref())) {
-          LLVM_DEBUG(llvm::dbgs() << "possible read conflict: " << designate
-                                  << " at " << elemental.getLoc() << "\n");
-          return std::nullopt;
+          forwardShifted =
+              isForwardShiftedSlice(match.array, designate.getMemref());
+          if (!forwardShifted) {
+            LLVM_DEBUG(llvm::dbgs() << "possible read conflict: " << designate
+                                    << " at " << elemental.getLoc() << "\n");
+            return std::nullopt;
+          }
         }
         auto indices = designate.getIndices();
         auto elementalIndices = elemental.getIndices();
@@ -431,8 +521,10 @@ ElementalAssignBufferization::findMatch(hlfir::ElementalOp elemental) {
           return std::nullopt;
         }
         if (std::equal(indices.begin(), indices.end(), elementalIndices.begin(),
-                       elementalIndices.end()))
+                       elementalIndices.end())) {
+          match.needsOrderedLoop |= forwardShifted;
           continue;
+        }
       }
     }
     LLVM_DEBUG(llvm::dbgs() << "disallowed side-effect: " << effect.getValue()
@@ -481,8 +573,9 @@ mlir::LogicalResult ElementalAssignBufferization::matchAndRewrite(
 
   // Generate a loop nest looping around the hlfir.elemental shape and clone
   // hlfir.elemental region inside the inner loop
-  hlfir::LoopNest loopNest =
-      hlfir::genLoopNest(loc, builder, extents, !elemental.isOrdered());
+  hlfir::LoopNest loopNest = hlfir::genLoopNest(
+      loc, builder, extents,
+      !elemental.isOrdered() && !match->needsOrderedLoop);
   builder.setInsertionPointToStart(loopNest.innerLoop.getBody());
   auto yield = hlfir::inlineElementalOp(loc, builder, elemental,
                                         loopNest.oneBasedIndices);
@@ -0,0 +1,188 @@
+//===- DoConcurrentConversion.cpp -----------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a transform mapping the loops of DO CONCURRENT
+// constructs to OpenMP worksharing loops, so that their iterations run in
+// parallel on the host:
+//
+//   fir.do_loop %i = %lb to %ub step %st unordered {fir.do_concurrent} {...}
+//
+// becomes
+//
+//   omp.parallel {
+//     <private copies of the local storage of the loop>
+//     omp.wsloop {
+//       omp.loop_nest (%i) : index = (%lb) to (%ub) inclusive step (%st) {...}
+//       omp.terminator
+//     }
+//     omp.terminator
+//   }
+//
+//===----------------------------------------------------------------------===//
+
+#include "flang/Optimizer/Dialect/FIRDialect.h"
+#include "flang/Optimizer/Dialect/FIROps.h"
+#include "flang/Optimizer/Dialect/FIROpsSupport.h"
+#include "flang/Optimizer/HLFIR/HLFIROps.h"
+#include "flang/Optimizer/Transforms/Passes.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/OpenMP/OpenMPDialect.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/PatternMatch.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+
+namespace fir {
+#define GEN_PASS_DEF_DOCONCURRENTCONVERSION
+#include "flang/Optimizer/Transforms/Passes.h.inc"
+} // namespace fir
+
+#define DEBUG_TYPE "fir-do-concurrent-conversion"
+
+/// Is \p op a variable declaration or a conversion, through which the uses of
+/// some storage are tracked?
+static bool isStorageAlias(mlir::Operation *op) {
+  return mlir::isa<fir::DeclareOp, hlfir::DeclareOp, fir::ConvertOp>(op);
+}
+
+/// Returns true if all the uses of \p value, looking through its declarations
+/// and conversions, are nested in \p loop.
+static bool isOnlyUsedIn(mlir::Value value, mlir::Operation *loop) {
+  for (mlir::Operation *user : value.getUsers()) {
+    if (loop->isAncestor(user))
+      continue;
+    if (!isStorageAlias(user))
+      return false;
+    for (mlir::Value result : user->getResults())
+      if (!isOnlyUsedIn(result, loop))
+        return false;
+  }
+  return true;
+}
+
+/// Collects the local storage of \p loop: the stack allocations made outside
+/// of it that are only used in it. They hold the index variables of the
+/// construct, its LOCAL and LOCAL_INIT variables, and the variables of
+/// unspecified locality that only appear in the construct. A value defined in
+/// one iteration of DO CONCURRENT cannot be referenced by another one
+/// (F'2018 11.1.7.5), so each thread may use its own copy of such storage.
+static void collectLocalStorage(fir::DoLoopOp loop,
+                                llvm::SetVector<fir::AllocaOp> &allocas) {
+  loop.walk([&](mlir::Operation *op) {
+    for (mlir::Value operand : op->getOperands()) {
+      mlir::Operation *def = operand.getDefiningOp();
+      while (def && !loop->isAncestor(def) && isStorageAlias(def))
+        def = def->getOperand(0).getDefiningOp();
+      if (auto alloca = mlir::dyn_cast_or_null<fir::AllocaOp>(def))
+        if (!loop->isAncestor(alloca) && isOnlyUsedIn(alloca, loop))
+          allocas.insert(alloca);
+    }
+  });
+}
+
+/// Replaces the uses of \p value in \p loop by \p privateValue, cloning the
+/// declarations and conversions of \p value at the current insertion point.
+static void privatize(mlir::RewriterBase &rewriter, mlir::Value value,
+                      mlir::Value privateValue, mlir::Operation *loop) {
+  for (mlir::OpOperand &use : llvm::make_early_inc_range(value.getUses())) {
+    mlir::Operation *user = use.getOwner();
+    if (loop->isAncestor(user)) {
+      rewriter.modifyOpInPlace(user, [&]() { use.set(privateValue); });
+      continue;
+    }
+    mlir::IRMapping mapping;
+    mapping.map(value, privateValue);
+    mlir::Operation *clone = rewriter.clone(*user, mapping);
+    for (auto [result, privateResult] :
+         llvm::zip(user->getResults(), clone->getResults()))
+      privatize(rewriter, result, privateResult, loop);
+  }
+}
+
+/// Can \p loop be mapped to an OpenMP worksharing loop?
+static bool isConvertible(fir::DoLoopOp loop) {
+  if (!loop.getUnorderedAttr() || loop.hasIterOperands() ||
+      loop.getNumResults() != 0) {
+    LLVM_DEBUG(llvm::dbgs() << "not a plain unordered loop: " << loop << "\n");
+    return false;
+  }
+  return true;
+}
+
+static void convertToWorksharingLoop(mlir::RewriterBase &rewriter,
+                                     fir::DoLoopOp loop) {
+  mlir::Location loc = loop.getLoc();
+  llvm::SetVector<fir::AllocaOp> allocas;
+  collectLocalStorage(loop, allocas);
+
+  rewriter.setInsertionPoint(loop);
+  auto parallelOp = rewriter.create<mlir::omp::ParallelOp>(loc);
+  mlir::Block *parallelBlock = rewriter.createBlock(&parallelOp.getRegion());
+  rewriter.create<mlir::omp::TerminatorOp>(loc);
+  rewriter.setInsertionPointToStart(parallelBlock);
+  for (fir::AllocaOp alloca : allocas) {
+    mlir::Operation *privateAlloca = rewriter.clone(*alloca);
+    privatize(rewriter, alloca, privateAlloca->getResult(0), loop);
+  }
+
+  auto wsloopOp = rewriter.create<mlir::omp::WsloopOp>(loc);
+  rewriter.createBlock(&wsloopOp.getRegion());
+  auto wsloopTerminator = rewriter.create<mlir::omp::TerminatorOp>(loc);
+  rewriter.setInsertionPoint(wsloopTerminator);
+  mlir::omp::LoopNestClauseOps clauseOps;
+  clauseOps.loopLBVar.push_back(loop.getLowerBound());
+  clauseOps.loopUBVar.push_back(loop.getUpperBound());
+  clauseOps.loopStepVar.push_back(loop.getStep());
+  clauseOps.loopInclusiveAttr = rewriter.getUnitAttr();
+  auto loopNestOp = rewriter.create<mlir::omp::LoopNestOp>(loc, clauseOps);
+
+  // Move the loop body, whose only argument is the induction variable, into
+  // the loop nest.
+  rewriter.inlineRegionBefore(loop.getRegion(), loopNestOp.getRegion(),
+                              loopNestOp.getRegion().end());
+  mlir::Operation *terminator =
+      loopNestOp.getRegion().front().getTerminator();
+  rewriter.setInsertionPoint(terminator);
+  rewriter.replaceOpWithNewOp<mlir::omp::YieldOp>(terminator);
+  rewriter.eraseOp(loop);
+}
+
+namespace {
+class DoConcurrentConversion
+    : public fir::impl::DoConcurrentConversionBase<DoConcurrentConversion> {
+public:
+  void runOnOperation() override {
+    mlir::func::FuncOp func = getOperation();
+    if (func.isDeclaration())
+      return;
+
+    // Only the outermost loop of a nest is distributed among the threads; the
+    // nested ones run sequentially in each iteration. Loops already nested in
+    // an OpenMP construct are left alone.
+    llvm::SmallVector<fir::DoLoopOp> loops;
+    func.walk<mlir::WalkOrder::PreOrder>([&](mlir::Operation *op) {
+      if (mlir::isa<mlir::omp::OpenMPDialect>(op->getDialect()))
+        return mlir::WalkResult::skip();
+      auto loop = mlir::dyn_cast<fir::DoLoopOp>(op);
+      if (!loop || !loop->hasAttr(fir::getDoConcurrentAttrName()))
+        return mlir::WalkResult::advance();
+      if (isConvertible(loop))
+        loops.push_back(loop);
+      return mlir::WalkResult::skip();
+    });
+
+    mlir::IRRewriter rewriter(&getContext());
+    for (fir::DoLoopOp loop : loops)
+      convertToWorksharingLoop(rewriter, loop);
+  }
+};
+} // namespace
+
+std::unique_ptr<mlir::Pass> fir::createDoConcurrentConversionPass() {
+  return std::make_unique<DoConcurrentConversion>();
+}
@@ -91,7 +91,8 @@ void Prescanner::Prescan(ProvenanceRange range) {
 }
 
 void Prescanner::Statement() {
-  TokenSequence tokens;
+  TokenSequence &tokens{statementTokens_};
+  tokens.clear();
   const char *statementStart{nextLine_};
   LineClassification line{ClassifyLine(statementStart)};
   switch (line.kind) {
@@ -415,8 +416,14 @@ void Prescanner::EnforceStupidEndStatementRules(const TokenSequence &tokens) {
 }
 
 void Prescanner::SkipToEndOfLine() {
-  while (*at_ != '\n') {
-    ++at_, ++column_;
+  if (const void *nl{std::memchr(at_, '\n', limit_ - at_)}) {
+    const char *p{static_cast<const char *>(nl)};
+    column_ += p - at_;
+    at_ = p;
+  } else {
+    while (*at_ != '\n') {
+      ++at_, ++column_;
+    }
   }
 }
 
@@ -526,16 +533,17 @@ const char *Prescanner::SkipWhiteSpaceAndCComments(const char *p) const {
 }
 
 const char *Prescanner::SkipCComment(const char *p) const {
-  char star{' '}, slash{' '};
-  p += 2;
-  while (star != '*' || slash != '/') {
-    if (p >= limit_) {
-      return nullptr; // signifies an unterminated comment
+  for (p += 2; p < limit_;) {
+    const void *star{std::memchr(p, '*', limit_ - p)};
+    if (!star) {
+      break;
+    }
+    p = static_cast<const char *>(star) + 1;
+    if (p < limit_ && *p == '/') {
+      return p + 1;
     }
-    star = slash;
-    slash = *p++;
   }
-  return p;
+  return nullptr; // signifies an unterminated comment
 }
 
 bool Prescanner::NextToken(TokenSequence &tokens) {
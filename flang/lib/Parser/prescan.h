@@ -247,6 +247,10 @@ private:
   static const int prime1{1019}, prime2{1021};
   std::bitset<prime2> compilerDirectiveBloomFilter_; // 128 bytes
   std::unordered_set<std::string> compilerDirectiveSentinels_;
+
+  // The tokens of the statement being prescanned; kept across statements so
+  // that its storage is reused rather than reallocated for each one.
+  TokenSequence statementTokens_;
 };
 } // namespace Fortran::parser
 #endif // FORTRAN_PARSER_PRESCAN_H_
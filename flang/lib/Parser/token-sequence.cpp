@@ -130,8 +130,9 @@ void TokenSequence::Put(
 
 void TokenSequence::Put(
     const char *s, std::size_t bytes, Provenance provenance) {
-  for (std::size_t j{0}; j < bytes; ++j) {
-    PutNextTokenChar(s[j], provenance + j);
+  if (bytes > 0) {
+    char_.insert(char_.end(), s, s + bytes);
+    provenances_.Put({provenance, bytes});
   }
   CloseToken();
 }
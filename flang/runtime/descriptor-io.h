@@ -25,6 +25,8 @@
 #include "flang/Common/uint128.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
+#include <algorithm>
+#include <limits>
 
 namespace Fortran::runtime::io::descr {
 template <typename A>
@@ -44,70 +46,121 @@ inline RT_API_ATTRS A &ExtractElement(IoStatementState &io,
 // automatic repetition counts, like "10*3.14159", for list-directed and
 // NAMELIST array output.
 
-template <int KIND, Direction DIR>
-inline RT_API_ATTRS bool FormattedIntegerIO(
-    IoStatementState &io, const Descriptor &descriptor) {
+// Formatted and list-directed output of the elements of an INTEGER or REAL
+// array.  A data edit descriptor with a repeat count, like the 10 in
+// (10ES16.8), is fetched once and then applied to as many elements as it
+// covers, rather than interpreting the FORMAT again for each element; a
+// contiguous array is traversed with a pointer rather than by subscripts.
+template <typename A, typename EDIT_ELEMENT>
+inline RT_API_ATTRS bool FormattedNumericOutput(IoStatementState &io,
+    const Descriptor &descriptor, EDIT_ELEMENT editElement) {
   std::size_t numElements{descriptor.Elements()};
   SubscriptValue subscripts[maxRank];
   descriptor.GetLowerBounds(subscripts);
-  using IntType = CppTypeFor<TypeCategory::Integer, KIND>;
-  bool anyInput{false};
-  for (std::size_t j{0}; j < numElements; ++j) {
-    if (auto edit{io.GetNextDataEdit()}) {
-      IntType &x{ExtractElement<IntType>(io, descriptor, subscripts)};
-      if constexpr (DIR == Direction::Output) {
-        if (!EditIntegerOutput<KIND>(io, *edit, x)) {
+  const A *contiguous{numElements > 0 && descriptor.IsContiguous()
+          ? &ExtractElement<A>(io, descriptor, subscripts)
+          : nullptr};
+  for (std::size_t j{0}; j < numElements;) {
+    std::size_t maxRepeat{std::min<std::size_t>(
+        numElements - j, std::numeric_limits<int>::max())};
+    auto edit{io.GetNextDataEdit(static_cast<int>(maxRepeat))};
+    if (!edit) {
+      return false;
+    }
+    // A bad FORMAT yields a zero repeat count; it still edits one element.
+    for (int k{0}, repeat{std::max(edit->repeat, 1)}; k < repeat; ++k, ++j) {
+      if (contiguous) {
+        if (!editElement(*edit, contiguous[j])) {
           return false;
         }
-      } else if (edit->descriptor != DataEdit::ListDirectedNullValue) {
-        if (EditIntegerInput(io, *edit, reinterpret_cast<void *>(&x), KIND)) {
-          anyInput = true;
-        } else {
-          return anyInput && edit->IsNamelist();
+      } else {
+        const A &x{ExtractElement<A>(io, descriptor, subscripts)};
+        if (!editElement(*edit, x)) {
+          return false;
+        }
+        if (!descriptor.IncrementSubscripts(subscripts) &&
+            j + 1 < numElements) {
+          io.GetIoErrorHandler().Crash(
+              "FormattedNumericOutput: subscripts out of bounds");
         }
       }
-      if (!descriptor.IncrementSubscripts(subscripts) && j + 1 < numElements) {
-        io.GetIoErrorHandler().Crash(
-            "FormattedIntegerIO: subscripts out of bounds");
-      }
-    } else {
-      return false;
     }
   }
   return true;
 }
 
+template <int KIND, Direction DIR>
+inline RT_API_ATTRS bool FormattedIntegerIO(
+    IoStatementState &io, const Descriptor &descriptor) {
+  using IntType = CppTypeFor<TypeCategory::Integer, KIND>;
+  if constexpr (DIR == Direction::Output) {
+    return FormattedNumericOutput<IntType>(
+        io, descriptor, [&io](const DataEdit &edit, IntType x) {
+          return EditIntegerOutput<KIND>(io, edit, x);
+        });
+  } else {
+    std::size_t numElements{descriptor.Elements()};
+    SubscriptValue subscripts[maxRank];
+    descriptor.GetLowerBounds(subscripts);
+    bool anyInput{false};
+    for (std::size_t j{0}; j < numElements; ++j) {
+      if (auto edit{io.GetNextDataEdit()}) {
+        IntType &x{ExtractElement<IntType>(io, descriptor, subscripts)};
+        if (edit->descriptor != DataEdit::ListDirectedNullValue) {
+          if (EditIntegerInput(io, *edit, reinterpret_cast<void *>(&x), KIND)) {
+            anyInput = true;
+          } else {
+            return anyInput && edit->IsNamelist();
+          }
+        }
+        if (!descriptor.IncrementSubscripts(subscripts) &&
+            j + 1 < numElements) {
+          io.GetIoErrorHandler().Crash(
+              "FormattedIntegerIO: subscripts out of bounds");
+        }
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
 template <int KIND, Direction DIR>
 inline RT_API_ATTRS bool FormattedRealIO(
     IoStatementState &io, const Descriptor &descriptor) {
-  std::size_t numElements{descriptor.Elements()};
-  SubscriptValue subscripts[maxRank];
-  descriptor.GetLowerBounds(subscripts);
   using RawType = typename RealOutputEditing<KIND>::BinaryFloatingPoint;
-  bool anyInput{false};
-  for (std::size_t j{0}; j < numElements; ++j) {
-    if (auto edit{io.GetNextDataEdit()}) {
-      RawType &x{ExtractElement<RawType>(io, descriptor, subscripts)};
-      if constexpr (DIR == Direction::Output) {
-        if (!RealOutputEditing<KIND>{io, x}.Edit(*edit)) {
-          return false;
+  if constexpr (DIR == Direction::Output) {
+    return FormattedNumericOutput<RawType>(
+        io, descriptor, [&io](const DataEdit &edit, const RawType &x) {
+          return RealOutputEditing<KIND>{io, x}.Edit(edit);
+        });
+  } else {
+    std::size_t numElements{descriptor.Elements()};
+    SubscriptValue subscripts[maxRank];
+    descriptor.GetLowerBounds(subscripts);
+    bool anyInput{false};
+    for (std::size_t j{0}; j < numElements; ++j) {
+      if (auto edit{io.GetNextDataEdit()}) {
+        RawType &x{ExtractElement<RawType>(io, descriptor, subscripts)};
+        if (edit->descriptor != DataEdit::ListDirectedNullValue) {
+          if (EditRealInput<KIND>(io, *edit, reinterpret_cast<void *>(&x))) {
+            anyInput = true;
+          } else {
+            return anyInput && edit->IsNamelist();
+          }
         }
-      } else if (edit->descriptor != DataEdit::ListDirectedNullValue) {
-        if (EditRealInput<KIND>(io, *edit, reinterpret_cast<void *>(&x))) {
-          anyInput = true;
-        } else {
-          return anyInput && edit->IsNamelist();
+        if (!descriptor.IncrementSubscripts(subscripts) &&
+            j + 1 < numElements) {
+          io.GetIoErrorHandler().Crash(
+              "FormattedRealIO: subscripts out of bounds");
         }
+      } else {
+        return false;
       }
-      if (!descriptor.IncrementSubscripts(subscripts) && j + 1 < numElements) {
-        io.GetIoErrorHandler().Crash(
-            "FormattedRealIO: subscripts out of bounds");
-      }
-    } else {
-      return false;
     }
+    return true;
   }
-  return true;
 }
 
 template <int KIND, Direction DIR>
@@ -99,9 +99,22 @@ static inline RT_API_ATTRS CppTypeFor<RCAT, RKIND> DoDotProduct(
           xp++;
         }
       } else {
-        for (SubscriptValue j{0}; j < n; ++j) {
+        // Independent partial sums let the loop vectorize.
+        constexpr int lanes{8};
+        AccumType sums[lanes]{};
+        SubscriptValue j{0};
+        for (; j + lanes <= n; j += lanes) {
+          for (int lane{0}; lane < lanes; ++lane) {
+            sums[lane] += static_cast<AccumType>(xp[j + lane]) *
+                static_cast<AccumType>(yp[j + lane]);
+          }
+        }
+        for (; j < n; ++j) {
           accum +=
-              static_cast<AccumType>(*xp++) * static_cast<AccumType>(*yp++);
+              static_cast<AccumType>(xp[j]) * static_cast<AccumType>(yp[j]);
+        }
+        for (AccumType laneSum : sums) {
+          accum += laneSum;
         }
       }
       return static_cast<Result>(accum);
@@ -143,6 +143,18 @@ void ExecutionEnvironment::Configure(int ac, const char *av[],
     }
   }
 
+  if (auto *x{std::getenv("FORT_REDUCTION_THREADS")}) {
+    char *end;
+    auto n{std::strtol(x, &end, 10)};
+    if (n > 0 && n <= 1024 && *end == '\0') {
+      reductionThreads = n;
+    } else {
+      std::fprintf(stderr,
+          "Fortran runtime: FORT_REDUCTION_THREADS=%s is invalid; ignored\n",
+          x);
+    }
+  }
+
   // TODO: Set RP/ROUND='PROCESSOR_DEFINED' from environment
 }
 
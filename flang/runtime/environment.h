@@ -56,6 +56,7 @@ struct ExecutionEnvironment {
   bool noStopMessage{false}; // NO_STOP_MESSAGE=1 inhibits "Fortran STOP"
   bool defaultUTF8{false}; // DEFAULT_UTF8
   bool checkPointerDeallocation{true}; // FORT_CHECK_POINTER_DEALLOCATION
+  int reductionThreads{1}; // FORT_REDUCTION_THREADS
 };
 
 RT_OFFLOAD_VAR_GROUP_BEGIN
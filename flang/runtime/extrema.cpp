@@ -96,6 +96,36 @@ public:
     }
     return true;
   }
+  template <typename IGNORED>
+  RT_API_ATTRS bool AccumulateContiguous(
+      const Type *p, SubscriptValue n, SubscriptValue offset) {
+    SubscriptValue at{-1};
+    for (SubscriptValue j{0}; j < n; ++j) {
+      if (!previous_ || compare_(p[j], *previous_)) {
+        previous_ = &p[j];
+        at = j;
+      }
+    }
+    if (at >= 0) {
+      // Convert the position in array element order to subscripts.
+      at += offset;
+      for (int j{0}; j < argRank_; ++j) {
+        SubscriptValue extent{array_.GetDimension(j).Extent()};
+        extremumLoc_[j] = at % extent + 1;
+        at /= extent;
+      }
+    }
+    return true;
+  }
+  RT_API_ATTRS void Combine(const ExtremumLocAccumulator &that) {
+    if (that.previous_ &&
+        (!previous_ || compare_(*that.previous_, *previous_))) {
+      previous_ = that.previous_;
+      for (int j{0}; j < argRank_; ++j) {
+        extremumLoc_[j] = that.extremumLoc_[j];
+      }
+    }
+  }
 
 private:
   const Descriptor &array_;
@@ -456,6 +486,49 @@ public:
   RT_API_ATTRS bool AccumulateAt(const SubscriptValue at[]) {
     return Accumulate(*array_.Element<A>(at));
   }
+  template <typename A>
+  RT_API_ATTRS bool AccumulateContiguous(
+      const A *p, SubscriptValue n, SubscriptValue /*offset*/) {
+    SubscriptValue j{0};
+    if constexpr (CAT == TypeCategory::Real) {
+      // A NaN is only the result when all of the elements are NaNs; the
+      // comparisons below never select one.
+      while (j < n && p[j] != p[j]) {
+        ++j;
+      }
+      if (j == n) {
+        return n == 0 || Accumulate(p[n - 1]);
+      }
+    } else if (n == 0) {
+      return true;
+    }
+    Type extrema[reductionLanes];
+    for (Type &laneExtremum : extrema) {
+      laneExtremum = p[j];
+    }
+    for (; j + reductionLanes <= n; j += reductionLanes) {
+      for (int lane{0}; lane < reductionLanes; ++lane) {
+        Type x{p[j + lane]};
+        if constexpr (IS_MAXVAL) {
+          extrema[lane] = x > extrema[lane] ? x : extrema[lane];
+        } else {
+          extrema[lane] = x < extrema[lane] ? x : extrema[lane];
+        }
+      }
+    }
+    for (; j < n; ++j) {
+      Accumulate(p[j]);
+    }
+    for (Type laneExtremum : extrema) {
+      Accumulate(laneExtremum);
+    }
+    return true;
+  }
+  RT_API_ATTRS void Combine(const NumericExtremumAccumulator &that) {
+    if (that.any_) {
+      Accumulate(that.extremum_);
+    }
+  }
 
 private:
   const Descriptor &array_;
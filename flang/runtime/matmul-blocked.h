@@ -0,0 +1,333 @@
+//===-- runtime/matmul-blocked.h --------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Cache- and register-blocked matrix*matrix multiplication for MATMUL and
+// MATMUL(TRANSPOSE()) of contiguous REAL(4), REAL(8), COMPLEX(4) and
+// COMPLEX(8) matrices of a single type.
+//
+// The blocking follows the usual GEMM structure: panels of Y and blocks of
+// X are packed into buffers that fit in the caches, and a micro-kernel
+// accumulates a small tile of the product in registers.  The micro-kernel
+// loads the tile from the product before each K block and adds the terms in
+// increasing K order, so every element is summed in the same order as by the
+// straightforward loops.
+//
+// On x86-64 hosts, the micro-kernel is also compiled for AVX2 and FMA, and
+// selected at runtime when the CPU supports them; the compiler may then fuse
+// the multiplications and additions, which only changes the rounding.  Large
+// cases can be routed to an external BLAS registered with
+// RTNAME(RegisterMatmulBlas).
+
+#ifndef FORTRAN_RUNTIME_MATMUL_BLOCKED_H_
+#define FORTRAN_RUNTIME_MATMUL_BLOCKED_H_
+
+#include "terminator.h"
+#include "flang/Common/optional.h"
+#include "flang/Runtime/c-or-cpp.h"
+#include "flang/Runtime/descriptor.h"
+#include "flang/Runtime/matmul.h"
+#include "flang/Runtime/memory.h"
+#include <algorithm>
+#include <climits>
+#include <complex>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__GNUC__) || defined(__clang__)
+// The micro-kernel must be inlined in the wrappers that compile it for
+// specific CPU features, and its loops over the tile fully unrolled so that
+// the tile stays in registers.
+#define RT_MATMUL_ALWAYS_INLINE __attribute__((always_inline))
+#define RT_MATMUL_UNROLL _Pragma("GCC unroll 16")
+#else
+#define RT_MATMUL_ALWAYS_INLINE
+#define RT_MATMUL_UNROLL
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(RT_DEVICE_COMPILATION)
+#define RT_MATMUL_DISPATCH_AVX2 1
+#endif
+
+namespace Fortran::runtime::matmul {
+
+template <typename T>
+constexpr bool IsBlockedType{std::is_same_v<T, float> ||
+    std::is_same_v<T, double> || std::is_same_v<T, std::complex<float>> ||
+    std::is_same_v<T, std::complex<double>>};
+
+// Block sizes per element type.  The MR x NR tile of the product lives in
+// registers, a KC x NR panel of Y in L1, an MC x KC block of X in L2 and a
+// KC x NC panel of Y in L3.
+template <typename T> struct BlockSizes {
+  static constexpr bool isComplex{!std::is_floating_point_v<T>};
+  // Two 256-bit vectors of REAL; complex multiplication does not vectorize.
+  static constexpr SubscriptValue mr{isComplex ? 4 : 64 / sizeof(T)};
+  static constexpr SubscriptValue nr{isComplex ? 4 : 6};
+  static constexpr SubscriptValue kc{256};
+  static constexpr SubscriptValue mc{(24 * 1024 / sizeof(T)) / mr * mr};
+  static constexpr SubscriptValue nc{(512 * 1024 / sizeof(T)) / nr * nr};
+};
+
+// Cases smaller than this number of multiplications do not pay for the
+// packing.
+constexpr SubscriptValue blockedThreshold{32 * 32 * 32};
+// Cases smaller than this number of multiplications do not pay for the
+// overhead of an external BLAS call.
+constexpr SubscriptValue blasThreshold{128 * 128 * 128};
+
+#if !defined(RT_DEVICE_COMPILATION)
+// The routines registered with RTNAME(RegisterMatmulBlas).
+extern MatmulBlasRoutines blasRoutines;
+#endif
+
+// Computes product(0:m-1,0:n-1) += X*Y over kb terms, where X is a packed
+// MR-row panel and Y a packed NR-column panel, and product has leading
+// dimension ldp.  m <= MR and n <= NR handle the edges of the matrices.
+template <typename T>
+inline RT_API_ATTRS RT_MATMUL_ALWAYS_INLINE void MicroKernel(
+    SubscriptValue kb, const T *RESTRICT xPanel, const T *RESTRICT yPanel,
+    T *RESTRICT product, SubscriptValue ldp, SubscriptValue m,
+    SubscriptValue n) {
+  constexpr SubscriptValue mr{BlockSizes<T>::mr};
+  constexpr SubscriptValue nr{BlockSizes<T>::nr};
+  bool isFullTile{m == mr && n == nr};
+  T acc[nr * mr];
+  if (isFullTile) {
+    for (SubscriptValue j{0}; j < nr; ++j) {
+      for (SubscriptValue i{0}; i < mr; ++i) {
+        acc[j * mr + i] = product[i + j * ldp];
+      }
+    }
+  } else {
+    for (SubscriptValue j{0}; j < nr; ++j) {
+      for (SubscriptValue i{0}; i < mr; ++i) {
+        acc[j * mr + i] = i < m && j < n ? product[i + j * ldp] : T{};
+      }
+    }
+  }
+  for (SubscriptValue k{0}; k < kb; ++k) {
+    RT_MATMUL_UNROLL
+    for (SubscriptValue j{0}; j < nr; ++j) {
+      RT_MATMUL_UNROLL
+      for (SubscriptValue i{0}; i < mr; ++i) {
+        acc[j * mr + i] += xPanel[k * mr + i] * yPanel[k * nr + j];
+      }
+    }
+  }
+  if (isFullTile) {
+    for (SubscriptValue j{0}; j < nr; ++j) {
+      for (SubscriptValue i{0}; i < mr; ++i) {
+        product[i + j * ldp] = acc[j * mr + i];
+      }
+    }
+  } else {
+    for (SubscriptValue j{0}; j < n; ++j) {
+      for (SubscriptValue i{0}; i < m; ++i) {
+        product[i + j * ldp] = acc[j * mr + i];
+      }
+    }
+  }
+}
+
+template <typename T>
+using MicroKernelFn = void (*)(SubscriptValue, const T *RESTRICT,
+    const T *RESTRICT, T *RESTRICT, SubscriptValue, SubscriptValue,
+    SubscriptValue);
+
+#if RT_MATMUL_DISPATCH_AVX2
+template <typename T>
+__attribute__((target("avx2,fma"))) void MicroKernelAVX2(SubscriptValue kb,
+    const T *RESTRICT xPanel, const T *RESTRICT yPanel, T *RESTRICT product,
+    SubscriptValue ldp, SubscriptValue m, SubscriptValue n) {
+  MicroKernel<T>(kb, xPanel, yPanel, product, ldp, m, n);
+}
+#endif
+
+// Selects the best micro-kernel for the host CPU.
+template <typename T> inline RT_API_ATTRS MicroKernelFn<T> GetMicroKernel() {
+#if RT_MATMUL_DISPATCH_AVX2
+  static const bool hasAVX2{
+      __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")};
+  if (hasAVX2) {
+    return &MicroKernelAVX2<T>;
+  }
+#endif
+  return &MicroKernel<T>;
+}
+
+// Packs X(i0:i0+mb-1,k0:k0+kb-1) into MR-row panels, each stored K-major and
+// padded with zeroes to MR rows.  X(i,k) is x[i + k*ldx], or x[k + i*ldx]
+// when X_IS_TRANSPOSED.
+template <typename T, bool X_IS_TRANSPOSED>
+inline RT_API_ATTRS void PackX(T *RESTRICT packed, const T *RESTRICT x,
+    SubscriptValue ldx, SubscriptValue i0, SubscriptValue mb,
+    SubscriptValue k0, SubscriptValue kb) {
+  constexpr SubscriptValue mr{BlockSizes<T>::mr};
+  for (SubscriptValue ir{0}; ir < mb; ir += mr) {
+    SubscriptValue m{std::min(mr, mb - ir)};
+    for (SubscriptValue k{0}; k < kb; ++k) {
+      for (SubscriptValue i{0}; i < mr; ++i) {
+        SubscriptValue row{i0 + ir + i}, col{k0 + k};
+        if (i >= m) {
+          *packed++ = T{};
+        } else if constexpr (X_IS_TRANSPOSED) {
+          *packed++ = x[col + row * ldx];
+        } else {
+          *packed++ = x[row + col * ldx];
+        }
+      }
+    }
+  }
+}
+
+// Packs Y(k0:k0+kb-1,j0:j0+nb-1) into NR-column panels, each stored K-major
+// and padded with zeroes to NR columns.
+template <typename T>
+inline RT_API_ATTRS void PackY(T *RESTRICT packed, const T *RESTRICT y,
+    SubscriptValue ldy, SubscriptValue k0, SubscriptValue kb,
+    SubscriptValue j0, SubscriptValue nb) {
+  constexpr SubscriptValue nr{BlockSizes<T>::nr};
+  for (SubscriptValue jr{0}; jr < nb; jr += nr) {
+    SubscriptValue n{std::min(nr, nb - jr)};
+    for (SubscriptValue k{0}; k < kb; ++k) {
+      for (SubscriptValue j{0}; j < nr; ++j) {
+        *packed++ = j < n ? y[k0 + k + (j0 + jr + j) * ldy] : T{};
+      }
+    }
+  }
+}
+
+// product(rows,cols) = X(rows,n) * Y(n,cols); the product is contiguous.
+template <typename T, bool X_IS_TRANSPOSED>
+inline RT_API_ATTRS void BlockedMatrixTimesMatrix(T *RESTRICT product,
+    SubscriptValue rows, SubscriptValue cols, const T *RESTRICT x,
+    SubscriptValue ldx, const T *RESTRICT y, SubscriptValue ldy,
+    SubscriptValue n, const Terminator &terminator) {
+  using Sizes = BlockSizes<T>;
+  std::memset(product, 0, rows * cols * sizeof *product);
+  SubscriptValue mcMax{std::min(Sizes::mc, rows)};
+  SubscriptValue ncMax{std::min(Sizes::nc, cols)};
+  SubscriptValue kcMax{std::min(Sizes::kc, n)};
+  // Round up to whole panels.
+  mcMax = (mcMax + Sizes::mr - 1) / Sizes::mr * Sizes::mr;
+  ncMax = (ncMax + Sizes::nr - 1) / Sizes::nr * Sizes::nr;
+  T *packedX{static_cast<T *>(
+      AllocateMemoryOrCrash(terminator, mcMax * kcMax * sizeof(T)))};
+  T *packedY{static_cast<T *>(
+      AllocateMemoryOrCrash(terminator, ncMax * kcMax * sizeof(T)))};
+  MicroKernelFn<T> microKernel{GetMicroKernel<T>()};
+  for (SubscriptValue jc{0}; jc < cols; jc += Sizes::nc) {
+    SubscriptValue nb{std::min(Sizes::nc, cols - jc)};
+    for (SubscriptValue kc{0}; kc < n; kc += Sizes::kc) {
+      SubscriptValue kb{std::min(Sizes::kc, n - kc)};
+      PackY(packedY, y, ldy, kc, kb, jc, nb);
+      for (SubscriptValue ic{0}; ic < rows; ic += Sizes::mc) {
+        SubscriptValue mb{std::min(Sizes::mc, rows - ic)};
+        PackX<T, X_IS_TRANSPOSED>(packedX, x, ldx, ic, mb, kc, kb);
+        for (SubscriptValue jr{0}; jr < nb; jr += Sizes::nr) {
+          for (SubscriptValue ir{0}; ir < mb; ir += Sizes::mr) {
+            microKernel(kb, packedX + ir * kb, packedY + jr * kb,
+                product + (ic + ir) + (jc + jr) * rows, rows,
+                std::min(Sizes::mr, mb - ir), std::min(Sizes::nr, nb - jr));
+          }
+        }
+      }
+    }
+  }
+  FreeMemory(packedY);
+  FreeMemory(packedX);
+}
+
+#if !defined(RT_DEVICE_COMPILATION)
+template <typename T> inline GemmRoutine<T> GetGemmRoutine() {
+  if constexpr (std::is_same_v<T, float>) {
+    return blasRoutines.sgemm;
+  } else if constexpr (std::is_same_v<T, double>) {
+    return blasRoutines.dgemm;
+  } else if constexpr (std::is_same_v<T, std::complex<float>>) {
+    return blasRoutines.cgemm;
+  } else {
+    return blasRoutines.zgemm;
+  }
+}
+
+// Calls the registered external GEMM, if any, when the case is large enough.
+template <typename T, bool X_IS_TRANSPOSED>
+inline bool CallExternalGemm(T *product, SubscriptValue rows,
+    SubscriptValue cols, const T *x, SubscriptValue ldx, const T *y,
+    SubscriptValue ldy, SubscriptValue n) {
+  GemmRoutine<T> gemm{GetGemmRoutine<T>()};
+  if (!gemm || rows * cols * n < blasThreshold) {
+    return false;
+  }
+  for (SubscriptValue extent : {rows, cols, n, ldx, ldy}) {
+    if (extent > INT_MAX) {
+      return false;
+    }
+  }
+  int m{static_cast<int>(rows)}, nn{static_cast<int>(cols)},
+      k{static_cast<int>(n)}, lda{static_cast<int>(ldx)},
+      ldb{static_cast<int>(ldy)}, ldc{m};
+  const T alpha{1}, beta{0};
+  const char transa{X_IS_TRANSPOSED ? 'T' : 'N'}, transb{'N'};
+  gemm(&transa, &transb, &m, &nn, &k, &alpha, x, &lda, y, &ldb, &beta, product,
+      &ldc);
+  return true;
+}
+#endif
+
+// Converts an optional column byte stride to a leading dimension in
+// elements, or returns false when it is not a multiple of the element size.
+template <typename T>
+inline RT_API_ATTRS bool GetLeadingDimension(SubscriptValue &ld,
+    SubscriptValue contiguousLd,
+    Fortran::common::optional<std::size_t> columnByteStride) {
+  if (!columnByteStride) {
+    ld = contiguousLd;
+    return true;
+  }
+  if (*columnByteStride % sizeof(T) != 0) {
+    return false;
+  }
+  ld = *columnByteStride / sizeof(T);
+  return true;
+}
+
+// Computes product(rows,cols) = X(rows,n) * Y(n,cols), where X is stored
+// transposed when X_IS_TRANSPOSED, with an external GEMM or the blocked
+// kernels.  Returns false, leaving the product untouched, when the case is
+// too small to benefit or the column strides are not element multiples.
+template <typename T, bool X_IS_TRANSPOSED>
+inline RT_API_ATTRS bool TryBlockedMatrixTimesMatrix(T *product,
+    SubscriptValue rows, SubscriptValue cols, const T *x, const T *y,
+    SubscriptValue n, Fortran::common::optional<std::size_t> xColumnByteStride,
+    Fortran::common::optional<std::size_t> yColumnByteStride,
+    const Terminator &terminator) {
+  if (rows * cols * n < blockedThreshold) {
+    return false;
+  }
+  SubscriptValue ldx, ldy;
+  if (!GetLeadingDimension<T>(ldx, X_IS_TRANSPOSED ? n : rows,
+          xColumnByteStride) ||
+      !GetLeadingDimension<T>(ldy, n, yColumnByteStride)) {
+    return false;
+  }
+#if !defined(RT_DEVICE_COMPILATION)
+  if (CallExternalGemm<T, X_IS_TRANSPOSED>(
+          product, rows, cols, x, ldx, y, ldy, n)) {
+    return true;
+  }
+#endif
+  BlockedMatrixTimesMatrix<T, X_IS_TRANSPOSED>(
+      product, rows, cols, x, ldx, y, ldy, n, terminator);
+  return true;
+}
+
+} // namespace Fortran::runtime::matmul
+#endif // FORTRAN_RUNTIME_MATMUL_BLOCKED_H_
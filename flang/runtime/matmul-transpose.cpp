@@ -17,10 +17,11 @@
 // of logical kinds (16).  A single template undergoes many instantiations
 // to cover all of the valid possibilities.
 //
-// The usefulness of this optimization should be reviewed once Matmul is swapped
-// to use the faster BLAS routines.
+// Large REAL and COMPLEX matrix*matrix cases share the cache-blocked kernels
+// and the external BLAS routing of MATMUL, which read X transposed.
 
 #include "flang/Runtime/matmul-transpose.h"
+#include "matmul-blocked.h"
 #include "terminator.h"
 #include "tools.h"
 #include "flang/Common/optional.h"
@@ -247,7 +248,15 @@ inline static RT_API_ATTRS void DoMatmulTranspose(
         yColumnByteStride = y.SubscriptsToByteOffset(yAt);
       }
       if (resRank == 2) { // M*M -> M
-        // TODO: use BLAS-3 GEMM for supported types.
+        if constexpr (std::is_same_v<XT, YT> &&
+            std::is_same_v<XT, WriteResult> && matmul::IsBlockedType<XT>) {
+          if (matmul::TryBlockedMatrixTimesMatrix<XT, true>(
+                  result.template OffsetElement<WriteResult>(), rows, cols,
+                  x.OffsetElement<XT>(), y.OffsetElement<YT>(), n,
+                  xColumnByteStride, yColumnByteStride, terminator)) {
+            return;
+          }
+        }
         MatrixTransposedTimesMatrixHelper<RCAT, RKIND, XT, YT>(
             result.template OffsetElement<WriteResult>(), rows, cols,
             x.OffsetElement<XT>(), y.OffsetElement<YT>(), n, xColumnByteStride,
@@ -17,9 +17,12 @@
 // of logical kinds (16).  A single template undergoes many instantiations
 // to cover all of the valid possibilities.
 //
-// Places where BLAS routines could be called are marked as TODO items.
+// Large REAL and COMPLEX matrix*matrix cases use the cache-blocked kernels
+// of matmul-blocked.h, or an external BLAS GEMM when one is registered.
+// Other places where BLAS routines could be called are marked as TODO items.
 
 #include "flang/Runtime/matmul.h"
+#include "matmul-blocked.h"
 #include "terminator.h"
 #include "tools.h"
 #include "flang/Common/optional.h"
@@ -30,6 +33,10 @@
 
 namespace Fortran::runtime {
 
+#if !defined(RT_DEVICE_COMPILATION)
+MatmulBlasRoutines matmul::blasRoutines;
+#endif
+
 // Suppress the warnings about calling __host__-only std::complex operators,
 // defined in C++ STD header files, from __device__ code.
 RT_DIAG_PUSH
@@ -323,16 +330,14 @@ static inline RT_API_ATTRS void DoMatmul(
       // This implies that the column stride is divisible
       // by the element size, which is usually true.
       if (resRank == 2) { // M*M -> M
-        if (std::is_same_v<XT, YT>) {
-          if constexpr (std::is_same_v<XT, float>) {
-            // TODO: call BLAS-3 SGEMM
-            // TODO: try using CUTLASS for device.
-          } else if constexpr (std::is_same_v<XT, double>) {
-            // TODO: call BLAS-3 DGEMM
-          } else if constexpr (std::is_same_v<XT, std::complex<float>>) {
-            // TODO: call BLAS-3 CGEMM
-          } else if constexpr (std::is_same_v<XT, std::complex<double>>) {
-            // TODO: call BLAS-3 ZGEMM
+        if constexpr (std::is_same_v<XT, YT> &&
+            std::is_same_v<XT, WriteResult> && matmul::IsBlockedType<XT>) {
+          // TODO: try using CUTLASS for device.
+          if (matmul::TryBlockedMatrixTimesMatrix<XT, false>(
+                  result.template OffsetElement<WriteResult>(), extent[0],
+                  extent[1], x.OffsetElement<XT>(), y.OffsetElement<YT>(), n,
+                  xColumnByteStride, yColumnByteStride, terminator)) {
+            return;
           }
         }
         MatrixTimesMatrixHelper<RCAT, RKIND, XT, YT>(
@@ -481,6 +486,12 @@ void RTDEF(MatmulDirect)(const Descriptor &result, const Descriptor &x,
   Matmul<false>{}(result, x, y, sourceFile, line);
 }
 
+void RTDEF(RegisterMatmulBlas)(const MatmulBlasRoutines *routines) {
+#if !defined(RT_DEVICE_COMPILATION)
+  matmul::blasRoutines = routines ? *routines : MatmulBlasRoutines{};
+#endif
+}
+
 RT_EXT_API_GROUP_END
 } // extern "C"
 } // namespace Fortran::runtime
@@ -30,6 +30,33 @@ public:
     product_ *= *array_.Element<A>(at);
     return product_ != 0;
   }
+  // Integer products are exact modulo wraparound, so they can be computed in
+  // any order; real products keep the element order.
+  template <typename A, typename I = INTERMEDIATE,
+      std::enable_if_t<std::is_integral_v<I>, int> = 0>
+  RT_API_ATTRS bool AccumulateContiguous(
+      const A *p, SubscriptValue n, SubscriptValue /*offset*/) {
+    INTERMEDIATE products[reductionLanes];
+    for (INTERMEDIATE &laneProduct : products) {
+      laneProduct = 1;
+    }
+    SubscriptValue j{0};
+    for (; j + reductionLanes <= n; j += reductionLanes) {
+      for (int lane{0}; lane < reductionLanes; ++lane) {
+        products[lane] *= p[j + lane];
+      }
+    }
+    for (; j < n; ++j) {
+      product_ *= p[j];
+    }
+    for (INTERMEDIATE laneProduct : products) {
+      product_ *= laneProduct;
+    }
+    return product_ != 0;
+  }
+  RT_API_ATTRS void Combine(const NonComplexProductAccumulator &that) {
+    product_ *= that.product_;
+  }
 
 private:
   const Descriptor &array_;
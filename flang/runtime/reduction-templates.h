@@ -27,6 +27,13 @@
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
 #include <algorithm>
+#include <type_traits>
+#include <utility>
+#if !defined(RT_DEVICE_COMPILATION)
+#include "environment.h"
+#include <thread>
+#include <vector>
+#endif
 
 namespace Fortran::runtime {
 
@@ -38,6 +45,92 @@ namespace Fortran::runtime {
 // array and does something with a scalar element, and a GetResult()
 // member function that copies a final result into its destination.
 
+// Accumulators may also support a fast path for total reductions of
+// contiguous arrays without an array MASK=:
+// * AccumulateContiguous(p, n, offset) accumulates the n elements at p, the
+//   first of which is the element of the array at zero-based position offset
+//   in array element order.  It is free to process the elements in any order
+//   that the standard allows, typically with several independent partial
+//   results so that the loop vectorizes.
+// * Combine(that) accumulates the result of a copy of the accumulator that
+//   processed the elements that follow the ones already accumulated.  When
+//   present, very large arrays may be split across threads; see
+//   FORT_REDUCTION_THREADS.
+
+// Number of independent partial results kept by the contiguous fast paths,
+// enough to fill the vector registers of common targets.
+static constexpr int reductionLanes{8};
+
+template <typename ACCUMULATOR, typename TYPE, typename = void>
+struct HasContiguousAccumulation : std::false_type {};
+template <typename ACCUMULATOR, typename TYPE>
+struct HasContiguousAccumulation<ACCUMULATOR, TYPE,
+    std::void_t<decltype(std::declval<ACCUMULATOR &>()
+                             .template AccumulateContiguous<TYPE>(
+                                 std::declval<const TYPE *>(),
+                                 SubscriptValue{}, SubscriptValue{}))>>
+    : std::true_type {};
+
+template <typename ACCUMULATOR, typename = void>
+struct HasCombine : std::false_type {};
+template <typename ACCUMULATOR>
+struct HasCombine<ACCUMULATOR,
+    std::void_t<decltype(std::declval<ACCUMULATOR &>().Combine(
+        std::declval<const ACCUMULATOR &>()))>> : std::true_type {};
+
+#if !defined(RT_DEVICE_COMPILATION)
+// Below this number of elements per thread, starting threads does not pay.
+static constexpr SubscriptValue minElementsPerReductionThread{1 << 18};
+
+// Splits the contiguous elements across up to FORT_REDUCTION_THREADS
+// threads, and combines their results in element order.
+template <typename TYPE, typename ACCUMULATOR>
+inline bool DoThreadedContiguousReduction(
+    const TYPE *p, SubscriptValue elements, ACCUMULATOR &accumulator) {
+  SubscriptValue threads{std::min<SubscriptValue>(
+      executionEnvironment.reductionThreads,
+      elements / minElementsPerReductionThread)};
+  if (threads <= 1) {
+    return false;
+  }
+  SubscriptValue chunk{(elements + threads - 1) / threads};
+  std::vector<ACCUMULATOR> partials(threads - 1, accumulator);
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (SubscriptValue t{1}; t < threads; ++t) {
+    SubscriptValue offset{t * chunk};
+    SubscriptValue n{std::min(chunk, elements - offset)};
+    workers.emplace_back([&partials, p, t, offset, n]() {
+      partials[t - 1].template AccumulateContiguous<TYPE>(
+          p + offset, n, offset);
+    });
+  }
+  accumulator.template AccumulateContiguous<TYPE>(p, chunk, 0);
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+  for (const ACCUMULATOR &partial : partials) {
+    accumulator.Combine(partial);
+  }
+  return true;
+}
+#endif
+
+template <typename TYPE, typename ACCUMULATOR>
+inline RT_API_ATTRS void DoContiguousReduction(
+    const Descriptor &x, ACCUMULATOR &accumulator) {
+  const TYPE *p{x.OffsetElement<TYPE>()};
+  SubscriptValue elements{static_cast<SubscriptValue>(x.Elements())};
+#if !defined(RT_DEVICE_COMPILATION)
+  if constexpr (HasCombine<ACCUMULATOR>::value) {
+    if (DoThreadedContiguousReduction(p, elements, accumulator)) {
+      return;
+    }
+  }
+#endif
+  accumulator.template AccumulateContiguous<TYPE>(p, elements, 0);
+}
+
 // Total reduction of the array argument to a scalar (or to a vector in the
 // cases of FINDLOC, MAXLOC, & MINLOC).  These are the cases without DIM= or
 // cases where the argument has rank 1 and DIM=, if present, must be 1.
@@ -71,6 +164,12 @@ inline RT_API_ATTRS void DoTotalReduction(const Descriptor &x, int dim,
     }
   }
   // No MASK=, or scalar MASK=.TRUE.
+  if constexpr (HasContiguousAccumulation<ACCUMULATOR, TYPE>::value) {
+    if (x.IsContiguous() && x.ElementBytes() == sizeof(TYPE)) {
+      DoContiguousReduction<TYPE>(x, accumulator);
+      return;
+    }
+  }
   for (auto elements{x.Elements()}; elements--; x.IncrementSubscripts(xAt)) {
     if (!accumulator.template AccumulateAt<TYPE>(xAt)) {
       break; // cut short, result is known
@@ -35,6 +35,27 @@ public:
     sum_ += *array_.Element<A>(at);
     return true;
   }
+  template <typename A>
+  RT_API_ATTRS bool AccumulateContiguous(
+      const A *p, SubscriptValue n, SubscriptValue /*offset*/) {
+    INTERMEDIATE sums[reductionLanes]{};
+    SubscriptValue j{0};
+    for (; j + reductionLanes <= n; j += reductionLanes) {
+      for (int lane{0}; lane < reductionLanes; ++lane) {
+        sums[lane] += p[j + lane];
+      }
+    }
+    for (; j < n; ++j) {
+      sum_ += p[j];
+    }
+    for (INTERMEDIATE laneSum : sums) {
+      sum_ += laneSum;
+    }
+    return true;
+  }
+  RT_API_ATTRS void Combine(const IntegerSumAccumulator &that) {
+    sum_ += that.sum_;
+  }
 
 private:
   const Descriptor &array_;
@@ -51,18 +72,63 @@ public:
   RT_API_ATTRS void GetResult(A *p, int /*zeroBasedDim*/ = -1) const {
     *p = Result<A>();
   }
+  // Kahan summation
+  template <typename A>
+  static RT_API_ATTRS void KahanAdd(
+      INTERMEDIATE &sum, INTERMEDIATE &correction, A x) {
+    auto next{x - correction};
+    auto oldSum{sum};
+    sum += next;
+    // The correction is the (negated) rounding error of the addition, and
+    // algebraically zero.  Once the sum is infinite, it would be Inf-Inf and
+    // turn the sum into a NaN, so drop it.
+    correction = sum - sum == 0 ? (sum - oldSum) - next : 0;
+  }
   template <typename A> RT_API_ATTRS bool Accumulate(A x) {
-    // Kahan summation
-    auto next{x + correction_};
-    auto oldSum{sum_};
-    sum_ += next;
-    correction_ = (sum_ - oldSum) - next; // algebraically zero
+    KahanAdd(sum_, correction_, x);
     return true;
   }
   template <typename A>
   RT_API_ATTRS bool AccumulateAt(const SubscriptValue at[]) {
     return Accumulate(*array_.Element<A>(at));
   }
+  // Kahan-sums the n values at p round-robin into the partial sums and
+  // corrections of LANES independent lanes.  Returns the number of values
+  // summed, a multiple of LANES; the caller sums the remaining ones.
+  template <int LANES, typename A>
+  static RT_API_ATTRS SubscriptValue KahanAddLanes(INTERMEDIATE sums[],
+      INTERMEDIATE corrections[], const A *p, SubscriptValue n) {
+    SubscriptValue j{0};
+    for (; j + LANES <= n; j += LANES) {
+      for (int lane{0}; lane < LANES; ++lane) {
+        KahanAdd(sums[lane], corrections[lane], p[j + lane]);
+      }
+    }
+    return j;
+  }
+  // Accumulates the result of a partial Kahan summation.
+  RT_API_ATTRS void AccumulatePartial(
+      INTERMEDIATE sum, INTERMEDIATE correction) {
+    KahanAdd(sum_, correction_, sum);
+    KahanAdd(sum_, correction_, -correction);
+  }
+  template <typename A>
+  RT_API_ATTRS bool AccumulateContiguous(
+      const A *p, SubscriptValue n, SubscriptValue /*offset*/) {
+    INTERMEDIATE sums[reductionLanes]{}, corrections[reductionLanes]{};
+    for (SubscriptValue j{KahanAddLanes<reductionLanes>(
+             sums, corrections, p, n)};
+         j < n; ++j) {
+      Accumulate(p[j]);
+    }
+    for (int lane{0}; lane < reductionLanes; ++lane) {
+      AccumulatePartial(sums[lane], corrections[lane]);
+    }
+    return true;
+  }
+  RT_API_ATTRS void Combine(const RealSumAccumulator &that) {
+    AccumulatePartial(that.sum_, that.correction_);
+  }
 
 private:
   const Descriptor &array_;
@@ -92,6 +158,31 @@ public:
   RT_API_ATTRS bool AccumulateAt(const SubscriptValue at[]) {
     return Accumulate(*array_.Element<A>(at));
   }
+  template <typename A>
+  RT_API_ATTRS bool AccumulateContiguous(
+      const A *p, SubscriptValue n, SubscriptValue /*offset*/) {
+    // Sum the real and imaginary parts as an array of 2*n parts, so that the
+    // even lanes hold real parts and the odd lanes imaginary parts.
+    using Part = typename A::value_type;
+    static_assert(reductionLanes % 2 == 0);
+    PART sums[reductionLanes]{}, corrections[reductionLanes]{};
+    SubscriptValue j{RealSumAccumulator<PART>::template KahanAddLanes<
+                         reductionLanes>(sums, corrections,
+                         reinterpret_cast<const Part *>(p), 2 * n) /
+        2};
+    for (; j < n; ++j) {
+      Accumulate(p[j]);
+    }
+    for (int lane{0}; lane < reductionLanes; lane += 2) {
+      reals_.AccumulatePartial(sums[lane], corrections[lane]);
+      imaginaries_.AccumulatePartial(sums[lane + 1], corrections[lane + 1]);
+    }
+    return true;
+  }
+  RT_API_ATTRS void Combine(const ComplexSumAccumulator &that) {
+    reals_.Combine(that.reals_);
+    imaginaries_.Combine(that.imaginaries_);
+  }
 
 private:
   const Descriptor &array_;
@@ -20,6 +20,7 @@
 #include "copy.h"
 #include "terminator.h"
 #include "tools.h"
+#include "type-info.h"
 #include "flang/Common/float128.h"
 #include "flang/Runtime/descriptor.h"
 
@@ -138,6 +139,63 @@ static inline RT_API_ATTRS std::size_t AllocateResult(Descriptor &result,
   return elementLen;
 }
 
+// True when the elements of an array can be copied with memcpy, i.e. they
+// have no allocatable or automatic components needing a deep copy.
+static inline RT_API_ATTRS bool IsShallowCopyable(const Descriptor &array) {
+  if (const DescriptorAddendum * addendum{array.Addendum()}) {
+    if (const typeInfo::DerivedType * derived{addendum->derivedType()}) {
+      return derived->noDestructionNeeded();
+    }
+  }
+  return true;
+}
+
+// Transposes the contiguous rows x columns matrix "from" into the contiguous
+// columns x rows matrix "to", tile by tile so that both the strided reads
+// and the strided writes of a tile stay in the cache.
+template <std::size_t BYTES>
+static RT_API_ATTRS void TransposeTiled(char *to, const char *from,
+    std::size_t rows, std::size_t columns, std::size_t elementBytes) {
+  constexpr std::size_t tile{32};
+  std::size_t bytes{BYTES ? BYTES : elementBytes};
+  for (std::size_t jTile{0}; jTile < columns; jTile += tile) {
+    std::size_t jEnd{std::min(jTile + tile, columns)};
+    for (std::size_t iTile{0}; iTile < rows; iTile += tile) {
+      std::size_t iEnd{std::min(iTile + tile, rows)};
+      for (std::size_t j{jTile}; j < jEnd; ++j) {
+        for (std::size_t i{iTile}; i < iEnd; ++i) {
+          std::memcpy(to + (j + i * columns) * bytes,
+              from + (i + j * rows) * bytes, bytes);
+        }
+      }
+    }
+  }
+}
+
+static RT_API_ATTRS void TransposeContiguous(char *to, const char *from,
+    std::size_t rows, std::size_t columns, std::size_t elementBytes) {
+  switch (elementBytes) {
+  case 1:
+    TransposeTiled<1>(to, from, rows, columns, elementBytes);
+    break;
+  case 2:
+    TransposeTiled<2>(to, from, rows, columns, elementBytes);
+    break;
+  case 4:
+    TransposeTiled<4>(to, from, rows, columns, elementBytes);
+    break;
+  case 8:
+    TransposeTiled<8>(to, from, rows, columns, elementBytes);
+    break;
+  case 16:
+    TransposeTiled<16>(to, from, rows, columns, elementBytes);
+    break;
+  default:
+    TransposeTiled<0>(to, from, rows, columns, elementBytes);
+    break;
+  }
+}
+
 template <TypeCategory CAT, int KIND>
 static inline RT_API_ATTRS std::size_t AllocateBesselResult(Descriptor &result,
     int32_t n1, int32_t n2, Terminator &terminator, const char *function) {
@@ -791,12 +849,35 @@ void RTDEF(Reshape)(Descriptor &result, const Descriptor &source,
       result, source, resultRank, resultExtent, terminator, "RESHAPE");
 
   // Populate the result's elements.
+  std::size_t resultElement{0};
+  std::size_t elementsFromSource{std::min(resultElements, sourceElements)};
+  bool isIdentityOrder{true};
+  for (int j{0}; j < resultRank; ++j) {
+    isIdentityOrder &= dimOrder[j] == j;
+  }
+  if (isIdentityOrder && source.IsContiguous() && IsShallowCopyable(source) &&
+      (!pad || IsShallowCopyable(*pad))) {
+    // Without ORDER=, the elements of the contiguous result are those of
+    // SOURCE= followed by those of PAD=, in array element order.
+    char *to{result.OffsetElement<char>()};
+    std::memcpy(
+        to, source.OffsetElement<char>(), elementsFromSource * elementBytes);
+    to += elementsFromSource * elementBytes;
+    if (elementsFromSource < resultElements) {
+      SubscriptValue padSubscript[maxRank];
+      pad->GetLowerBounds(padSubscript);
+      for (resultElement = elementsFromSource; resultElement < resultElements;
+           ++resultElement, to += elementBytes) {
+        std::memcpy(to, pad->Element<char>(padSubscript), elementBytes);
+        pad->IncrementSubscripts(padSubscript);
+      }
+    }
+    return;
+  }
   SubscriptValue resultSubscript[maxRank];
   result.GetLowerBounds(resultSubscript);
   SubscriptValue sourceSubscript[maxRank];
   source.GetLowerBounds(sourceSubscript);
-  std::size_t resultElement{0};
-  std::size_t elementsFromSource{std::min(resultElements, sourceElements)};
   for (; resultElement < elementsFromSource; ++resultElement) {
     CopyElement(result, resultSubscript, source, sourceSubscript, terminator);
     source.IncrementSubscripts(sourceSubscript);
@@ -831,7 +912,26 @@ void RTDEF(Spread)(Descriptor &result, const Descriptor &source, int dim,
   for (int j{0}; j < rank; ++j) {
     extent[j] = j == dim - 1 ? ncopies : source.GetDimension(k++).Extent();
   }
-  AllocateResult(result, source, rank, extent, terminator, "SPREAD");
+  std::size_t elementBytes{
+      AllocateResult(result, source, rank, extent, terminator, "SPREAD")};
+  if (source.IsContiguous() && IsShallowCopyable(source)) {
+    // Each contiguous block of SOURCE= spanning the dimensions before DIM=
+    // becomes NCOPIES consecutive blocks of the result.
+    std::size_t blockElements{1};
+    for (int j{0}; j < dim - 1; ++j) {
+      blockElements *= extent[j];
+    }
+    std::size_t blocks{blockElements ? source.Elements() / blockElements : 0};
+    std::size_t blockBytes{blockElements * elementBytes};
+    char *to{result.OffsetElement<char>()};
+    const char *from{source.OffsetElement<char>()};
+    for (std::size_t n{0}; n < blocks; ++n, from += blockBytes) {
+      for (std::int64_t copy{0}; copy < ncopies; ++copy, to += blockBytes) {
+        std::memcpy(to, from, blockBytes);
+      }
+    }
+    return;
+  }
   SubscriptValue resultAt[maxRank];
   for (int j{0}; j < rank; ++j) {
     resultAt[j] = 1;
@@ -855,7 +955,13 @@ void RTDEF(Transpose)(Descriptor &result, const Descriptor &matrix,
   RUNTIME_CHECK(terminator, matrix.rank() == 2);
   SubscriptValue extent[2]{
       matrix.GetDimension(1).Extent(), matrix.GetDimension(0).Extent()};
-  AllocateResult(result, matrix, 2, extent, terminator, "TRANSPOSE");
+  std::size_t elementBytes{
+      AllocateResult(result, matrix, 2, extent, terminator, "TRANSPOSE")};
+  if (matrix.IsContiguous() && IsShallowCopyable(matrix)) {
+    TransposeContiguous(result.OffsetElement<char>(),
+        matrix.OffsetElement<char>(), extent[1], extent[0], elementBytes);
+    return;
+  }
   SubscriptValue resultAt[2]{1, 1};
   SubscriptValue matrixLB[2];
   matrix.GetLowerBounds(matrixLB);
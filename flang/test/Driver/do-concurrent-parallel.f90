@@ -0,0 +1,29 @@
+! Test -fdo-concurrent-parallel, which maps DO CONCURRENT loops to OpenMP
+! worksharing loops.
+
+! RUN: %flang -### -fdo-concurrent-parallel %s 2>&1 | FileCheck %s --check-prefix=DRIVER
+! RUN: %flang_fc1 -emit-hlfir -fopenmp -fdo-concurrent-parallel %s -o - | FileCheck %s --check-prefix=HOST
+! RUN: %flang_fc1 -emit-hlfir -fopenmp %s -o - | FileCheck %s --check-prefix=SEQUENTIAL
+! RUN: %flang_fc1 -emit-hlfir -fdo-concurrent-parallel %s -o - 2>&1 | FileCheck %s --check-prefixes=NO-OPENMP,SEQUENTIAL
+
+! DRIVER: "-fc1"{{.*}}"-fdo-concurrent-parallel"
+
+! NO-OPENMP: warning: -fdo-concurrent-parallel requires -fopenmp and is ignored
+
+subroutine sub(a, n)
+  integer :: n, a(n), i
+  do concurrent (i = 1:n)
+    a(i) = i
+  end do
+end subroutine
+
+! HOST-LABEL: func.func @_QPsub(
+! HOST-NOT:     fir.do_loop
+! HOST:         omp.parallel {
+! HOST:           omp.wsloop {
+! HOST:             omp.loop_nest (%{{.*}}) : index = (%{{.*}}) to (%{{.*}}) inclusive step (%{{.*}}) {
+! HOST:               omp.yield
+
+! SEQUENTIAL-LABEL: func.func @_QPsub(
+! SEQUENTIAL-NOT:     omp.parallel
+! SEQUENTIAL:         fir.do_loop {{.*}} unordered attributes {fir.do_concurrent} {
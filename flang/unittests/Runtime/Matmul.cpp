@@ -198,3 +198,84 @@ TEST(Matmul, Basic) {
   EXPECT_TRUE(
       static_cast<bool>(*result.ZeroBasedIndexedElement<std::uint16_t>(3)));
 }
+
+// Large enough REAL and COMPLEX cases use the blocked kernels; small integer
+// values keep the products exact regardless of the summation order.
+TEST(Matmul, Blocked) {
+  constexpr int rows{45}, n{70}, cols{37};
+  std::vector<double> xData(rows * n), yData(n * cols);
+  for (int j{0}; j < rows * n; ++j) {
+    xData[j] = j % 7 - 3;
+  }
+  for (int j{0}; j < n * cols; ++j) {
+    yData[j] = j % 5 - 2;
+  }
+  auto x{MakeArray<TypeCategory::Real, 8>(std::vector<int>{rows, n}, xData)};
+  auto y{MakeArray<TypeCategory::Real, 8>(std::vector<int>{n, cols}, yData)};
+
+  StaticDescriptor<2, true> statDesc;
+  Descriptor &result{statDesc.descriptor()};
+  RTNAME(Matmul)(result, *x, *y, __FILE__, __LINE__);
+  ASSERT_EQ(result.rank(), 2);
+  EXPECT_EQ(result.GetDimension(0).Extent(), rows);
+  EXPECT_EQ(result.GetDimension(1).Extent(), cols);
+  ASSERT_EQ(result.type(), (TypeCode{TypeCategory::Real, 8}));
+  for (int i{0}; i < rows; ++i) {
+    for (int j{0}; j < cols; ++j) {
+      double expected{0};
+      for (int k{0}; k < n; ++k) {
+        expected += xData[i + k * rows] * yData[k + j * n];
+      }
+      EXPECT_EQ(*result.ZeroBasedIndexedElement<double>(i + j * rows), expected)
+          << "at (" << i << ", " << j << ")";
+    }
+  }
+  result.Destroy();
+}
+
+static int gemmCalls{0};
+static void CountingDgemm(const char *transa, const char *transb, const int *m,
+    const int *n, const int *k, const double *alpha, const double *a,
+    const int *lda, const double *b, const int *ldb, const double *beta,
+    double *c, const int *ldc) {
+  ++gemmCalls;
+  EXPECT_EQ(*transa, 'N');
+  EXPECT_EQ(*transb, 'N');
+  EXPECT_EQ(*alpha, 1.0);
+  EXPECT_EQ(*beta, 0.0);
+  for (int j{0}; j < *n; ++j) {
+    for (int i{0}; i < *m; ++i) {
+      c[i + j * *ldc] = -1.0;
+    }
+  }
+}
+
+TEST(Matmul, ExternalBlas) {
+  MatmulBlasRoutines routines;
+  routines.dgemm = CountingDgemm;
+  RTNAME(RegisterMatmulBlas)(&routines);
+
+  constexpr int large{130}, small{8};
+  auto x{MakeArray<TypeCategory::Real, 8>(std::vector<int>{large, large},
+      std::vector<double>(large * large, 1.0))};
+  StaticDescriptor<2, true> statDesc;
+  Descriptor &result{statDesc.descriptor()};
+  RTNAME(Matmul)(result, *x, *x, __FILE__, __LINE__);
+  EXPECT_EQ(gemmCalls, 1);
+  EXPECT_EQ(*result.ZeroBasedIndexedElement<double>(0), -1.0);
+  result.Destroy();
+
+  // Small cases are not worth the call.
+  auto s{MakeArray<TypeCategory::Real, 8>(std::vector<int>{small, small},
+      std::vector<double>(small * small, 1.0))};
+  RTNAME(Matmul)(result, *s, *s, __FILE__, __LINE__);
+  EXPECT_EQ(gemmCalls, 1);
+  EXPECT_EQ(*result.ZeroBasedIndexedElement<double>(0), small);
+  result.Destroy();
+
+  RTNAME(RegisterMatmulBlas)(nullptr);
+  RTNAME(Matmul)(result, *x, *x, __FILE__, __LINE__);
+  EXPECT_EQ(gemmCalls, 1);
+  EXPECT_EQ(*result.ZeroBasedIndexedElement<double>(0), large);
+  result.Destroy();
+}
@@ -233,3 +233,35 @@ TEST(MatmulTranspose, Basic) {
   EXPECT_TRUE(
       static_cast<bool>(*result.ZeroBasedIndexedElement<std::uint16_t>(1)));
 }
+
+TEST(MatmulTranspose, Blocked) {
+  constexpr int rows{45}, n{70}, cols{37};
+  std::vector<float> xData(n * rows), yData(n * cols);
+  for (int j{0}; j < n * rows; ++j) {
+    xData[j] = j % 7 - 3;
+  }
+  for (int j{0}; j < n * cols; ++j) {
+    yData[j] = j % 5 - 2;
+  }
+  auto x{MakeArray<TypeCategory::Real, 4>(std::vector<int>{n, rows}, xData)};
+  auto y{MakeArray<TypeCategory::Real, 4>(std::vector<int>{n, cols}, yData)};
+
+  StaticDescriptor<2, true> statDesc;
+  Descriptor &result{statDesc.descriptor()};
+  RTNAME(MatmulTranspose)(result, *x, *y, __FILE__, __LINE__);
+  ASSERT_EQ(result.rank(), 2);
+  EXPECT_EQ(result.GetDimension(0).Extent(), rows);
+  EXPECT_EQ(result.GetDimension(1).Extent(), cols);
+  ASSERT_EQ(result.type(), (TypeCode{TypeCategory::Real, 4}));
+  for (int i{0}; i < rows; ++i) {
+    for (int j{0}; j < cols; ++j) {
+      float expected{0};
+      for (int k{0}; k < n; ++k) {
+        expected += xData[k + i * n] * yData[k + j * n];
+      }
+      EXPECT_EQ(*result.ZeroBasedIndexedElement<float>(i + j * rows), expected)
+          << "at (" << i << ", " << j << ")";
+    }
+  }
+  result.Destroy();
+}
@@ -267,6 +267,51 @@ TEST(IOApiTests, DescriptorOutputTest) {
       << std::string{buffer, sizeof buffer} << "'";
 }
 
+TEST(IOApiTests, NumericArrayOutputTest) {
+  static constexpr int bufferSize{40};
+  char buffer[bufferSize];
+
+  // A repeated edit descriptor serves several elements of a contiguous array,
+  // and is cut short by the end of the array.
+  static constexpr SubscriptValue realExtent[]{7};
+  double reals[]{1, 2, 3, 4, 5, 6, 7};
+  StaticDescriptor<1> realStatDesc;
+  Descriptor &realDesc{realStatDesc.descriptor()};
+  realDesc.Establish(TypeCode{CFI_type_double}, sizeof(double), reals, 1,
+      realExtent);
+  const char *format{"(2F5.1,'|',10F4.0)"};
+  auto cookie{IONAME(BeginInternalFormattedOutput)(
+      buffer, bufferSize, format, std::strlen(format))};
+  EXPECT_TRUE(IONAME(OutputDescriptor)(cookie, realDesc));
+  ASSERT_EQ(IONAME(EndIoStatement)(cookie), 0);
+  EXPECT_TRUE(CompareFormattedStrings(
+      "  1.0  2.0|  3.  4.  5.  6.  7.", std::string{buffer, sizeof buffer}))
+      << "got '" << std::string{buffer, sizeof buffer} << "'";
+
+  // A noncontiguous array, with formatted and list-directed output
+  static constexpr SubscriptValue intExtent[]{3};
+  std::int32_t ints[]{1, 2, 3, 4, 5, 6};
+  StaticDescriptor<1> intStatDesc;
+  Descriptor &intDesc{intStatDesc.descriptor()};
+  intDesc.Establish(TypeCode{CFI_type_int32_t}, sizeof(std::int32_t), ints, 1,
+      intExtent);
+  intDesc.GetDimension(0).SetByteStride(2 * sizeof(std::int32_t));
+  format = "(3I2)";
+  cookie = IONAME(BeginInternalFormattedOutput)(
+      buffer, bufferSize, format, std::strlen(format));
+  EXPECT_TRUE(IONAME(OutputDescriptor)(cookie, intDesc));
+  ASSERT_EQ(IONAME(EndIoStatement)(cookie), 0);
+  EXPECT_TRUE(
+      CompareFormattedStrings(" 1 3 5", std::string{buffer, sizeof buffer}))
+      << "got '" << std::string{buffer, sizeof buffer} << "'";
+  cookie = IONAME(BeginInternalListOutput)(buffer, bufferSize);
+  EXPECT_TRUE(IONAME(OutputDescriptor)(cookie, intDesc));
+  ASSERT_EQ(IONAME(EndIoStatement)(cookie), 0);
+  EXPECT_TRUE(
+      CompareFormattedStrings(" 1 3 5", std::string{buffer, sizeof buffer}))
+      << "got '" << std::string{buffer, sizeof buffer} << "'";
+}
+
 //------------------------------------------------------------------------------
 /// Tests for output formatting real values
 //------------------------------------------------------------------------------
@@ -9,14 +9,17 @@
 #include "flang/Runtime/reduction.h"
 #include "gtest/gtest.h"
 #include "tools.h"
+#include "../../runtime/environment.h"
 #include "flang/Common/float128.h"
 #include "flang/Runtime/allocatable.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
 #include "flang/Runtime/reduce.h"
 #include "flang/Runtime/type-code.h"
+#include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -671,3 +674,68 @@ TEST(Reductions, ReduceInt4Dim) {
   EXPECT_EQ(*sums.ZeroBasedIndexedElement<std::int32_t>(1), 6);
   sums.Destroy();
 }
+
+TEST(Reductions, ContiguousSumReal8) {
+  std::vector<double> rawData(100003, 0.1);
+  auto array{MakeArray<TypeCategory::Real, 8>(
+      std::vector<int>{static_cast<int>(rawData.size())}, rawData)};
+  double sum{RTNAME(SumReal8)(*array, __FILE__, __LINE__)};
+  EXPECT_NEAR(sum, 10000.3, 1.0e-11);
+  rawData[3] = std::numeric_limits<double>::infinity();
+  auto infArray{MakeArray<TypeCategory::Real, 8>(
+      std::vector<int>{static_cast<int>(rawData.size())}, rawData)};
+  sum = RTNAME(SumReal8)(*infArray, __FILE__, __LINE__);
+  EXPECT_EQ(sum, std::numeric_limits<double>::infinity());
+}
+
+TEST(Reductions, ContiguousExtremaWithNaN) {
+  double nan{std::numeric_limits<double>::quiet_NaN()};
+  std::vector<double> rawData(37, nan);
+  auto allNaN{MakeArray<TypeCategory::Real, 8>(std::vector<int>{37}, rawData)};
+  EXPECT_TRUE(std::isnan(RTNAME(MaxvalReal8)(*allNaN, __FILE__, __LINE__)));
+  for (int j{20}; j < 37; ++j) {
+    rawData[j] = j == 29 ? 50.0 : j;
+  }
+  auto array{MakeArray<TypeCategory::Real, 8>(std::vector<int>{37}, rawData)};
+  EXPECT_EQ(RTNAME(MaxvalReal8)(*array, __FILE__, __LINE__), 50.0);
+  EXPECT_EQ(RTNAME(MinvalReal8)(*array, __FILE__, __LINE__), 20.0);
+}
+
+TEST(Reductions, ContiguousMaxlocInt4) {
+  std::vector<std::int32_t> rawData(60);
+  for (int j{0}; j < 60; ++j) {
+    rawData[j] = j % 7;
+  }
+  auto array{
+      MakeArray<TypeCategory::Integer, 4>(std::vector<int>{6, 10}, rawData)};
+  StaticDescriptor<2, true> statDesc;
+  Descriptor &loc{statDesc.descriptor()};
+  RTNAME(MaxlocInteger4)
+  (loc, *array, /*KIND=*/4, __FILE__, __LINE__, /*MASK=*/nullptr,
+      /*BACK=*/false);
+  EXPECT_EQ(loc.rank(), 1);
+  EXPECT_EQ(loc.GetDimension(0).Extent(), 2);
+  EXPECT_EQ(*loc.ZeroBasedIndexedElement<std::int32_t>(0), 1); // index 6
+  EXPECT_EQ(*loc.ZeroBasedIndexedElement<std::int32_t>(1), 2);
+  loc.Destroy();
+  RTNAME(MaxlocInteger4)
+  (loc, *array, /*KIND=*/4, __FILE__, __LINE__, /*MASK=*/nullptr,
+      /*BACK=*/true);
+  EXPECT_EQ(*loc.ZeroBasedIndexedElement<std::int32_t>(0), 2); // index 55
+  EXPECT_EQ(*loc.ZeroBasedIndexedElement<std::int32_t>(1), 10);
+  loc.Destroy();
+}
+
+TEST(Reductions, ThreadedSumInt8) {
+  constexpr int n{1 << 20};
+  std::vector<std::int64_t> rawData(n);
+  for (int j{0}; j < n; ++j) {
+    rawData[j] = j;
+  }
+  auto array{MakeArray<TypeCategory::Integer, 8>(std::vector<int>{n}, rawData)};
+  int savedThreads{executionEnvironment.reductionThreads};
+  executionEnvironment.reductionThreads = 4;
+  std::int64_t sum{RTNAME(SumInteger8)(*array, __FILE__, __LINE__)};
+  executionEnvironment.reductionThreads = savedThreads;
+  EXPECT_EQ(sum, static_cast<std::int64_t>(n) * (n - 1) / 2);
+}
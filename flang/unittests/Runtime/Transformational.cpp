@@ -480,6 +480,84 @@ TEST(Transformational, Transpose) {
   result.Destroy();
 }
 
+TEST(Transformational, TransposeTiled) {
+  // Spans several tiles in both dimensions, with partial tiles at the ends.
+  constexpr int rows{70}, columns{45};
+  std::vector<std::int64_t> values(rows * columns);
+  for (int j{0}; j < rows * columns; ++j) {
+    values[j] = j;
+  }
+  auto array{MakeArray<TypeCategory::Integer, 8>(
+      std::vector<int>{rows, columns}, std::move(values))};
+  StaticDescriptor<2, true> statDesc;
+  Descriptor &result{statDesc.descriptor()};
+  RTNAME(Transpose)(result, *array, __FILE__, __LINE__);
+  EXPECT_EQ(result.GetDimension(0).Extent(), columns);
+  EXPECT_EQ(result.GetDimension(1).Extent(), rows);
+  for (int i{0}; i < rows; ++i) {
+    for (int j{0}; j < columns; ++j) {
+      EXPECT_EQ(*result.ZeroBasedIndexedElement<std::int64_t>(j + i * columns),
+          i + j * rows)
+          << " at (" << j << ',' << i << ')';
+    }
+  }
+  result.Destroy();
+}
+
+TEST(Transformational, Reshape) {
+  auto source{MakeArray<TypeCategory::Integer, 4>(
+      std::vector<int>{2, 2}, std::vector<std::int32_t>{1, 2, 3, 4})};
+  auto shape{MakeArray<TypeCategory::Integer, 4>(
+      std::vector<int>{2}, std::vector<std::int32_t>{3, 3})};
+  auto pad{MakeArray<TypeCategory::Integer, 4>(
+      std::vector<int>{2}, std::vector<std::int32_t>{-1, -2})};
+  StaticDescriptor<2, true> statDesc;
+  Descriptor &result{statDesc.descriptor()};
+  RTNAME(Reshape)(result, *source, *shape, &*pad, nullptr, __FILE__, __LINE__);
+  EXPECT_EQ(result.rank(), 2);
+  EXPECT_EQ(result.GetDimension(0).Extent(), 3);
+  EXPECT_EQ(result.GetDimension(1).Extent(), 3);
+  static std::int32_t expect[9]{1, 2, 3, 4, -1, -2, -1, -2, -1};
+  for (int j{0}; j < 9; ++j) {
+    EXPECT_EQ(*result.ZeroBasedIndexedElement<std::int32_t>(j), expect[j])
+        << " at " << j;
+  }
+  result.Destroy();
+
+  // ORDER=[2,1] fills the result by rows.
+  auto order{MakeArray<TypeCategory::Integer, 4>(
+      std::vector<int>{2}, std::vector<std::int32_t>{2, 1})};
+  RTNAME(Reshape)
+  (result, *source, *shape, &*pad, &*order, __FILE__, __LINE__);
+  static std::int32_t expectOrdered[9]{1, 4, -1, 2, -1, -2, 3, -2, -1};
+  for (int j{0}; j < 9; ++j) {
+    EXPECT_EQ(
+        *result.ZeroBasedIndexedElement<std::int32_t>(j), expectOrdered[j])
+        << " at " << j;
+  }
+  result.Destroy();
+}
+
+TEST(Transformational, SpreadMatrix) {
+  // ARRAY  1 3 5
+  //        2 4 6
+  auto array{MakeArray<TypeCategory::Integer, 4>(
+      std::vector<int>{2, 3}, std::vector<std::int32_t>{1, 2, 3, 4, 5, 6})};
+  StaticDescriptor<3, true> statDesc;
+  Descriptor &result{statDesc.descriptor()};
+  RTNAME(Spread)(result, *array, 2, 2, __FILE__, __LINE__);
+  EXPECT_EQ(result.rank(), 3);
+  EXPECT_EQ(result.GetDimension(0).Extent(), 2);
+  EXPECT_EQ(result.GetDimension(1).Extent(), 2);
+  EXPECT_EQ(result.GetDimension(2).Extent(), 3);
+  static std::int32_t expect[12]{1, 2, 1, 2, 3, 4, 3, 4, 5, 6, 5, 6};
+  for (int j{0}; j < 12; ++j) {
+    EXPECT_EQ(*result.ZeroBasedIndexedElement<std::int32_t>(j), expect[j])
+        << " at " << j;
+  }
+  result.Destroy();
+}
+
 TEST(Transformational, Unpack) {
   auto vector{MakeArray<TypeCategory::Integer, 4>(
       std::vector<int>{4}, std::vector<std::int32_t>{1, 2, 3, 4})};
@@ -0,0 +1,55 @@
+//===-- Utilities for vector variants of math functions ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC___SUPPORT_FPUTIL_VECTOR_MATH_H
+#define LLVM_LIBC_SRC___SUPPORT_FPUTIL_VECTOR_MATH_H
+
+#include "src/__support/macros/attributes.h"
+#include "src/__support/macros/optimization.h" // LIBC_UNLIKELY
+
+#include <stddef.h>
+
+namespace LIBC_NAMESPACE::fputil {
+
+// The argument and result types of the vector math functions. They are passed
+// like the LLVM IR vector types, e.g. <4 x float>, of the calls emitted by the
+// loop vectorizer with -fveclib=LLVMlibc.
+template <typename T, size_t N>
+using simd = T __attribute__((ext_vector_type(N)));
+
+// Applies a scalar math function to every lane of x, with the same results.
+// - is_special(x) tells whether the scalar function needs one of its special
+//   cases for x.
+// - common(x) computes the main path of the scalar function, without branches,
+//   for the x which are not special. It is evaluated for all the lanes in a
+//   loop which the compiler vectorizes, with common_input substituted for the
+//   special lanes so that they don't index tables out of bounds.
+// - scalar(x) recomputes the special lanes, if any.
+template <size_t N, typename IsSpecial, typename Common, typename Scalar>
+LIBC_INLINE simd<float, N> map_lanes(simd<float, N> x, IsSpecial is_special,
+                                     Common common, Scalar scalar,
+                                     float common_input) {
+  simd<float, N> result;
+  bool any_special = false;
+  for (size_t i = 0; i < N; ++i) {
+    bool special = is_special(x[i]);
+    any_special |= special;
+    result[i] = common(special ? common_input : x[i]);
+  }
+  if (LIBC_UNLIKELY(any_special)) {
+    for (size_t i = 0; i < N; ++i) {
+      if (is_special(x[i]))
+        result[i] = scalar(x[i]);
+    }
+  }
+  return result;
+}
+
+} // namespace LIBC_NAMESPACE::fputil
+
+#endif // LLVM_LIBC_SRC___SUPPORT_FPUTIL_VECTOR_MATH_H
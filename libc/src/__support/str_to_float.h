@@ -863,7 +863,18 @@ decimal_string_to_float(const char *__restrict src, const char DECIMAL_POINT,
   // The loop fills the mantissa with as many digits as it can hold
   const StorageType bitstype_max_div_by_base =
       cpp::numeric_limits<StorageType>::max() / BASE;
+  // Below this, eight more digits fit in the mantissa.
+  const StorageType bitstype_max_div_by_1e8 =
+      cpp::numeric_limits<StorageType>::max() / 100000000;
   while (true) {
+    if (mantissa < bitstype_max_div_by_1e8 && has_eight_digits(src + index)) {
+      mantissa = (mantissa * 100000000) + parse_eight_digits(src + index);
+      seen_digit = true;
+      if (after_decimal)
+        exponent -= 8;
+      index += 8;
+      continue;
+    }
     if (isdigit(src[index])) {
       uint32_t digit = src[index] - '0';
       seen_digit = true;
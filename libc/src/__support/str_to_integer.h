@@ -13,6 +13,7 @@
 #include "src/__support/CPP/type_traits.h"
 #include "src/__support/common.h"
 #include "src/__support/ctype_utils.h"
+#include "src/__support/endian.h"
 #include "src/__support/str_to_num_result.h"
 #include "src/__support/uint128.h"
 #include "src/errno/libc_errno.h" // For ERANGE
@@ -70,6 +71,40 @@ LIBC_INLINE int infer_base(const char *__restrict src, size_t src_len) {
   return 10;
 }
 
+// Returns true if the next eight characters of src are all decimal digits. The
+// characters are checked one at a time so that nothing past the first
+// non-digit, which may be the terminating null, is read.
+LIBC_INLINE bool
+has_eight_digits(const char *__restrict src,
+                 size_t src_len = cpp::numeric_limits<size_t>::max()) {
+  if (src_len < 8)
+    return false;
+  for (size_t i = 0; i < 8; ++i) {
+    if (!isdigit(src[i]))
+      return false;
+  }
+  return true;
+}
+
+// Returns the value of the eight decimal digits at the start of src, which must
+// have been checked with has_eight_digits. The digits are combined within one
+// 64-bit word (SWAR) using three multiplications instead of eight.
+LIBC_INLINE uint32_t parse_eight_digits(const char *__restrict src) {
+  uint64_t chunk;
+  __builtin_memcpy(&chunk, src, sizeof(chunk));
+  // Put the first digit in the lowest byte.
+  chunk = Endian::to_little_endian(chunk) - 0x3030303030303030;
+  // Every other byte now holds the value of two consecutive digits.
+  chunk = (chunk * 10) + (chunk >> 8);
+  // Combine the four two-digit values, weighted by 10^6, 10^4, 10^2 and 1,
+  // into the upper half of the word.
+  constexpr uint64_t MASK = 0x000000FF000000FF;
+  constexpr uint64_t MUL1 = 100 + (1000000ULL << 32);
+  constexpr uint64_t MUL2 = 1 + (10000ULL << 32);
+  chunk = (((chunk & MASK) * MUL1) + (((chunk >> 16) & MASK) * MUL2)) >> 32;
+  return static_cast<uint32_t>(chunk);
+}
+
 // Takes a pointer to a string and the base to convert to. This function is used
 // as the backend for all of the string to int functions.
 template <class T>
@@ -116,6 +151,18 @@ strtointeger(const char *__restrict src, int base,
       (is_positive ? cpp::numeric_limits<T>::max() : NEGATIVE_MAX);
   ResultType const abs_max_div_by_base = abs_max / base;
 
+  // Decimal numbers are consumed eight digits at a time for as long as that
+  // can't overflow. The remaining digits are handled one by one below.
+  if (base == 10) {
+    ResultType const abs_max_div_by_1e8 = abs_max / 100000000;
+    while (result < abs_max_div_by_1e8 &&
+           has_eight_digits(src + src_cur, src_len - src_cur)) {
+      result = result * 100000000 + parse_eight_digits(src + src_cur);
+      is_number = true;
+      src_cur += 8;
+    }
+  }
+
   while (src_cur < src_len && isalnum(src[src_cur])) {
     int cur_digit = b36_char_to_int(src[src_cur]);
     if (cur_digit >= base)
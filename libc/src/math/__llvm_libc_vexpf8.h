@@ -0,0 +1,20 @@
+//===-- Implementation header for __llvm_libc_vexpf8 ---------- -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_MATH___LLVM_LIBC_VEXPF8_H
+#define LLVM_LIBC_SRC_MATH___LLVM_LIBC_VEXPF8_H
+
+#include "src/__support/FPUtil/vector_math.h"
+
+namespace LIBC_NAMESPACE {
+
+fputil::simd<float, 8> __llvm_libc_vexpf8(fputil::simd<float, 8> x);
+
+} // namespace LIBC_NAMESPACE
+
+#endif // LLVM_LIBC_SRC_MATH___LLVM_LIBC_VEXPF8_H
@@ -0,0 +1,25 @@
+//===-- 4-lane single-precision e^x function ------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/math/__llvm_libc_vexpf4.h"
+#include "expf_utils.h"
+#include "src/__support/FPUtil/vector_math.h"
+#include "src/__support/common.h"
+#include "src/math/expf.h"
+
+namespace LIBC_NAMESPACE {
+
+// Called by loops vectorized with -fveclib=LLVMlibc. The result of each lane
+// is the same as the one of expf.
+LLVM_LIBC_FUNCTION(fputil::simd<float, 4>, __llvm_libc_vexpf4,
+                   (fputil::simd<float, 4> x)) {
+  return fputil::map_lanes<4>(x, expf_is_special, expf_common,
+                               LIBC_NAMESPACE::expf, 1.5f);
+}
+
+} // namespace LIBC_NAMESPACE
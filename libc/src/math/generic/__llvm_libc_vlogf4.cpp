@@ -0,0 +1,28 @@
+//===-- 4-lane single-precision log(x) function ---------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/math/__llvm_libc_vlogf4.h"
+#include "logf_utils.h"
+#include "src/__support/FPUtil/vector_math.h"
+#include "src/__support/common.h"
+#include "src/math/logf.h"
+
+namespace LIBC_NAMESPACE {
+
+// Called by loops vectorized with -fveclib=LLVMlibc. The result of each lane
+// is the same as the one of logf.
+LLVM_LIBC_FUNCTION(fputil::simd<float, 4>, __llvm_libc_vlogf4,
+                   (fputil::simd<float, 4> x)) {
+  using FPBits = fputil::FPBits<float>;
+  return fputil::map_lanes<4>(
+      x, logf_is_special,
+      [](float xi) { return logf_common(FPBits(xi), -FPBits::EXP_BIAS); },
+      LIBC_NAMESPACE::logf, 1.5f);
+}
+
+} // namespace LIBC_NAMESPACE
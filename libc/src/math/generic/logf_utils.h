@@ -0,0 +1,116 @@
+//===-- Common path of the single-precision log(x) function -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_MATH_GENERIC_LOGF_UTILS_H
+#define LLVM_LIBC_SRC_MATH_GENERIC_LOGF_UTILS_H
+
+#include "common_constants.h" // Lookup table for (1/f) and log(f)
+#include "src/__support/FPUtil/FPBits.h"
+#include "src/__support/FPUtil/except_value_utils.h"
+#include "src/__support/FPUtil/PolyEval.h"
+#include "src/__support/FPUtil/multiply_add.h"
+#include "src/__support/common.h"
+#include "src/__support/macros/properties/cpu_features.h"
+
+namespace LIBC_NAMESPACE {
+
+constexpr double LOGF_LOG_2 = 0x1.62e42fefa39efp-1;
+
+// A hard-to-round input of logf, with its result rounded to nearest and the
+// side of it on which the exact result lies.
+struct LogfExcept {
+  uint32_t x_u;
+  float result;
+  int direction; // 1 if the exact result is above, -1 if below, 0 if exact.
+};
+
+// The hard-to-round inputs of logf, which it handles separately.
+constexpr LogfExcept LOGF_EXCEPTS[] = {
+    {0x3f7f4d6fU, -0x1.659ec8p-9f, 1}, // x = 0x1.fe9adep-1f
+    {0x41178febU, 0x1.1fcbcep+1f, 1},  // x = 0x1.2f1fd6p+3f
+#ifdef LIBC_TARGET_CPU_HAS_FMA
+    {0x3f800000U, 0.0f, 0}, // x = 1.0f
+#else
+    {0x1e88452dU, -0x1.6d7b18p+5f, 1}, // x = 0x1.108a5ap-66f
+#endif // LIBC_TARGET_CPU_HAS_FMA
+    {0x4c5d65a5U, 0x1.1e0696p+4f, -1}, // x = 0x1.bacb4ap+25f
+    {0x65d890d3U, 0x1.a9a3f2p+5f, -1}, // x = 0x1.b121a6p+76f
+    {0x6f31a8ecU, 0x1.08b512p+6f, -1}, // x = 0x1.6351d8p+95f
+    {0x7a17f30aU, 0x1.451436p+6f, 1},  // x = 0x1.2fe614p+117f
+#ifndef LIBC_TARGET_CPU_HAS_FMA
+    {0x500ffb03U, 0x1.6fdd34p+4f, 1}, // x = 0x1.1ff606p+33f
+    {0x5cd69e88U, 0x1.45c146p+5f, 1}, // x = 0x1.ad3d1p+58f
+    {0x5ee8984eU, 0x1.5c9442p+5f, 1}, // x = 0x1.d1309cp+62f
+#endif // LIBC_TARGET_CPU_HAS_FMA
+};
+
+// Returns the result of logf for one of its hard-to-round inputs, correctly
+// rounded in the current rounding mode.
+LIBC_INLINE float logf_except_result(const LogfExcept &except) {
+  if (except.direction > 0)
+    return fputil::round_result_slightly_up(except.result);
+  if (except.direction < 0)
+    return fputil::round_result_slightly_down(except.result);
+  return except.result;
+}
+
+// Returns true if logf needs one of its special cases for x: a hard-to-round
+// input, x which is not a positive normal number, and without FMA, the powers
+// of two.
+LIBC_INLINE bool logf_is_special(float x) {
+  using FPBits = fputil::FPBits<float>;
+  uint32_t x_u = FPBits(x).uintval();
+  bool special = x_u < FPBits::min_normal().uintval() ||
+                 x_u > FPBits::max_normal().uintval();
+#ifndef LIBC_TARGET_CPU_HAS_FMA
+  special |= (x_u & 0x007f'ffffU) == 0;
+#endif // LIBC_TARGET_CPU_HAS_FMA
+  for (const LogfExcept &except : LOGF_EXCEPTS)
+    special |= x_u == except.x_u;
+  return special;
+}
+
+// Computes log(2^m * x), without branches, for a positive normal x whose
+// biased exponent is already accounted for in m, i.e. m starts from -EXP_BIAS.
+// This is shared by logf and its vector variants.
+LIBC_INLINE float logf_common(fputil::FPBits<float> xbits, int m) {
+  uint32_t x_u = xbits.uintval();
+  uint32_t mant = xbits.get_mantissa();
+  // Extract 7 leading fractional bits of the mantissa
+  int index = mant >> 16;
+  // Add unbiased exponent. Add an extra 1 if the 7 leading fractional bits are
+  // all 1's.
+  m += static_cast<int>((x_u + (1 << 16)) >> 23);
+
+  // Set bits to 1.m
+  xbits.set_biased_exponent(0x7F);
+
+  float u = xbits.get_val();
+  double v;
+#ifdef LIBC_TARGET_CPU_HAS_FMA
+  v = static_cast<double>(fputil::multiply_add(u, R[index], -1.0f)); // Exact.
+#else
+  v = fputil::multiply_add(static_cast<double>(u), RD[index], -1.0); // Exact
+#endif // LIBC_TARGET_CPU_HAS_FMA
+
+  // Degree-5 polynomial approximation of log generated by Sollya with:
+  // > P = fpminimax(log(1 + x)/x, 4, [|1, D...|], [-2^-8, 2^-7]);
+  constexpr double COEFFS[4] = {-0x1.000000000fe63p-1, 0x1.555556e963c16p-2,
+                                -0x1.000028dedf986p-2, 0x1.966681bfda7f7p-3};
+  double v2 = v * v; // Exact
+  double p2 = fputil::multiply_add(v, COEFFS[3], COEFFS[2]);
+  double p1 = fputil::multiply_add(v, COEFFS[1], COEFFS[0]);
+  double p0 = LOG_R[index] + v;
+  double r = fputil::multiply_add(static_cast<double>(m), LOGF_LOG_2,
+                                  fputil::polyeval(v2, p0, p1, p2));
+  return static_cast<float>(r);
+}
+
+} // namespace LIBC_NAMESPACE
+
+#endif // LLVM_LIBC_SRC_MATH_GENERIC_LOGF_UTILS_H
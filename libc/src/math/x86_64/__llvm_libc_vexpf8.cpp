@@ -0,0 +1,29 @@
+//===-- 8-lane single-precision e^x function ------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/math/__llvm_libc_vexpf8.h"
+#include "src/math/generic/expf_utils.h"
+#include "src/__support/FPUtil/vector_math.h"
+#include "src/__support/common.h"
+#include "src/math/expf.h"
+
+namespace LIBC_NAMESPACE {
+
+// Called by loops vectorized with -fveclib=LLVMlibc for AVX targets, which
+// use 8 lanes for float. The result of each lane is the same as the one of
+// expf. This file is built with -mavx, which the vectorizer needs to pick 8
+// lanes, and not with -mavx2 or -mfma, so that it runs on all the CPUs which
+// call it and evaluates the main path the same way as expf on the baseline
+// target.
+LLVM_LIBC_FUNCTION(fputil::simd<float, 8>, __llvm_libc_vexpf8,
+                   (fputil::simd<float, 8> x)) {
+  return fputil::map_lanes<8>(x, expf_is_special, expf_common,
+                               LIBC_NAMESPACE::expf, 1.5f);
+}
+
+} // namespace LIBC_NAMESPACE
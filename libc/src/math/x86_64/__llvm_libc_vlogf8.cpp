@@ -0,0 +1,32 @@
+//===-- 8-lane single-precision log(x) function ---------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/math/__llvm_libc_vlogf8.h"
+#include "src/math/generic/logf_utils.h"
+#include "src/__support/FPUtil/vector_math.h"
+#include "src/__support/common.h"
+#include "src/math/logf.h"
+
+namespace LIBC_NAMESPACE {
+
+// Called by loops vectorized with -fveclib=LLVMlibc for AVX targets, which
+// use 8 lanes for float. The result of each lane is the same as the one of
+// logf. This file is built with -mavx, which the vectorizer needs to pick 8
+// lanes, and not with -mavx2 or -mfma, so that it runs on all the CPUs which
+// call it and evaluates the main path the same way as logf on the baseline
+// target.
+LLVM_LIBC_FUNCTION(fputil::simd<float, 8>, __llvm_libc_vlogf8,
+                   (fputil::simd<float, 8> x)) {
+  using FPBits = fputil::FPBits<float>;
+  return fputil::map_lanes<8>(
+      x, logf_is_special,
+      [](float xi) { return logf_common(FPBits(xi), -FPBits::EXP_BIAS); },
+      LIBC_NAMESPACE::logf, 1.5f);
+}
+
+} // namespace LIBC_NAMESPACE
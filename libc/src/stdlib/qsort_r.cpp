@@ -21,8 +21,7 @@ LLVM_LIBC_FUNCTION(void, qsort_r,
   if (array == nullptr || array_size == 0 || elem_size == 0)
     return;
   internal::Comparator c(compare, arg);
-  internal::quicksort(internal::Array(reinterpret_cast<uint8_t *>(array),
-                                      array_size, elem_size, c));
+  internal::sort(reinterpret_cast<uint8_t *>(array), array_size, elem_size, c);
 }
 
 } // namespace LIBC_NAMESPACE
@@ -15,8 +15,6 @@
 
 namespace LIBC_NAMESPACE::internal {
 
-// A simple quicksort implementation using the Hoare partition scheme.
-
 using Compare = int(const void *, const void *);
 using CompareWithState = int(const void *, const void *, void *);
 
@@ -56,29 +54,56 @@ struct Comparator {
   }
 };
 
-class Array {
+// Swaps the n bytes at a and b, a word at a time. a and b are either the same
+// or don't overlap.
+LIBC_INLINE void swap_bytes(uint8_t *a, uint8_t *b, size_t n) {
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= n; i += sizeof(uint64_t)) {
+    uint64_t tmp_a, tmp_b;
+    __builtin_memcpy(&tmp_a, a + i, sizeof(uint64_t));
+    __builtin_memcpy(&tmp_b, b + i, sizeof(uint64_t));
+    __builtin_memcpy(a + i, &tmp_b, sizeof(uint64_t));
+    __builtin_memcpy(b + i, &tmp_a, sizeof(uint64_t));
+  }
+  if (i + sizeof(uint32_t) <= n) {
+    uint32_t tmp_a, tmp_b;
+    __builtin_memcpy(&tmp_a, a + i, sizeof(uint32_t));
+    __builtin_memcpy(&tmp_b, b + i, sizeof(uint32_t));
+    __builtin_memcpy(a + i, &tmp_b, sizeof(uint32_t));
+    __builtin_memcpy(b + i, &tmp_a, sizeof(uint32_t));
+    i += sizeof(uint32_t);
+  }
+  for (; i < n; ++i) {
+    uint8_t tmp = a[i];
+    a[i] = b[i];
+    b[i] = tmp;
+  }
+}
+
+// An array of elements of elem_size bytes. When ELEM_SIZE is not zero it is
+// the element size, known at compile time, so that element accesses and swaps
+// compile down to a few word-sized loads and stores.
+template <size_t ELEM_SIZE = 0> class ArrayImpl {
   uint8_t *array;
   size_t array_size;
-  size_t elem_size;
+  size_t elem_size_val;
   Comparator compare;
 
 public:
-  Array(uint8_t *a, size_t s, size_t e, Comparator c)
-      : array(a), array_size(s), elem_size(e), compare(c) {}
-
-  uint8_t *get(size_t i) const { return array + i * elem_size; }
-
-  void swap(size_t i, size_t j) const {
-    uint8_t *elem_i = get(i);
-    uint8_t *elem_j = get(j);
-    for (size_t b = 0; b < elem_size; ++b) {
-      uint8_t temp = elem_i[b];
-      elem_i[b] = elem_j[b];
-      elem_j[b] = temp;
-    }
+  ArrayImpl(uint8_t *a, size_t s, size_t e, Comparator c)
+      : array(a), array_size(s), elem_size_val(e), compare(c) {}
+
+  LIBC_INLINE size_t elem_size() const {
+    return ELEM_SIZE != 0 ? ELEM_SIZE : elem_size_val;
+  }
+
+  LIBC_INLINE uint8_t *get(size_t i) const { return array + i * elem_size(); }
+
+  LIBC_INLINE void swap(size_t i, size_t j) const {
+    swap_bytes(get(i), get(j), elem_size());
   }
 
-  int elem_compare(size_t i, const uint8_t *other) const {
+  LIBC_INLINE int elem_compare(size_t i, const uint8_t *other) const {
     // An element must compare equal to itself so we don't need to consult the
     // user provided comparator.
     if (get(i) == other)
@@ -86,65 +111,269 @@ public:
     return compare.comp_vals(get(i), other);
   }
 
-  size_t size() const { return array_size; }
+  LIBC_INLINE size_t size() const { return array_size; }
+};
+
+using Array = ArrayImpl<>;
+
+// The sort below is a pattern-defeating quicksort (pdqsort): an introsort
+// which detects sorted and reverse sorted runs, groups elements equal to the
+// pivot, and breaks up patterns which lead to unbalanced partitions. Ranges
+// are given as indices [begin, end) into the array.
 
-  // Make an Array starting at index |i| and size |s|.
-  Array make_array(size_t i, size_t s) const {
-    return Array(get(i), s, elem_size, compare);
+// Ranges smaller than this are insertion sorted.
+constexpr size_t INSERTION_SORT_THRESHOLD = 24;
+// Ranges larger than this take the pivot as the median of three medians.
+constexpr size_t NINTHER_THRESHOLD = 128;
+// The number of elements partial_insertion_sort may move before giving up.
+constexpr size_t PARTIAL_INSERTION_SORT_LIMIT = 8;
+
+template <typename A>
+LIBC_INLINE void insertion_sort(const A &array, size_t begin, size_t end) {
+  for (size_t i = begin + 1; i < end; ++i) {
+    for (size_t j = i; j > begin && array.elem_compare(j - 1, array.get(j)) > 0;
+         --j)
+      array.swap(j - 1, j);
   }
-};
+}
 
-static size_t partition(const Array &array) {
-  const size_t array_size = array.size();
-  size_t pivot_index = array_size / 2;
-  uint8_t *pivot = array.get(pivot_index);
-  size_t i = 0;
-  size_t j = array_size - 1;
+// Insertion sorts [begin, end) unless that takes too many moves, in which case
+// it stops and returns false, leaving the range partially sorted.
+template <typename A>
+LIBC_INLINE bool partial_insertion_sort(const A &array, size_t begin,
+                                        size_t end) {
+  size_t moves = 0;
+  for (size_t i = begin + 1; i < end; ++i) {
+    size_t j = i;
+    for (; j > begin && array.elem_compare(j - 1, array.get(j)) > 0; --j)
+      array.swap(j - 1, j);
+    moves += i - j;
+    if (moves > PARTIAL_INSERTION_SORT_LIMIT)
+      return false;
+  }
+  return true;
+}
 
+template <typename A>
+LIBC_INLINE void sift_down(const A &array, size_t begin, size_t root,
+                           size_t heap_size) {
   while (true) {
-    int compare_i, compare_j;
-
-    while ((compare_i = array.elem_compare(i, pivot)) < 0)
-      ++i;
-    while ((compare_j = array.elem_compare(j, pivot)) > 0)
-      --j;
-
-    // At some point i will crossover j so we will definitely break out of
-    // this while loop.
-    if (i >= j)
-      return j + 1;
-
-    array.swap(i, j);
-
-    // The pivot itself might have got swapped so we will update the pivot.
-    if (i == pivot_index) {
-      pivot = array.get(j);
-      pivot_index = j;
-    } else if (j == pivot_index) {
-      pivot = array.get(i);
-      pivot_index = i;
+    size_t child = 2 * root + 1;
+    if (child >= heap_size)
+      return;
+    if (child + 1 < heap_size &&
+        array.elem_compare(begin + child, array.get(begin + child + 1)) < 0)
+      ++child;
+    if (array.elem_compare(begin + root, array.get(begin + child)) >= 0)
+      return;
+    array.swap(begin + root, begin + child);
+    root = child;
+  }
+}
+
+// The fallback when too many partitions were unbalanced, so that the sort
+// stays O(n log n) on adversarial inputs.
+template <typename A>
+LIBC_INLINE void heapsort(const A &array, size_t begin, size_t end) {
+  const size_t size = end - begin;
+  for (size_t i = size / 2; i-- > 0;)
+    sift_down(array, begin, i, size);
+  for (size_t heap_size = size; heap_size > 1; --heap_size) {
+    array.swap(begin, begin + heap_size - 1);
+    sift_down(array, begin, 0, heap_size - 1);
+  }
+}
+
+template <typename A>
+LIBC_INLINE void sort2(const A &array, size_t a, size_t b) {
+  if (array.elem_compare(b, array.get(a)) < 0)
+    array.swap(a, b);
+}
+
+// Moves the median of the elements at a, b and c to b.
+template <typename A>
+LIBC_INLINE void sort3(const A &array, size_t a, size_t b, size_t c) {
+  sort2(array, a, b);
+  sort2(array, b, c);
+  sort2(array, a, b);
+}
+
+// Partitions [begin, end) around the pivot at begin. The elements less than
+// the pivot end up before it and the others after it. Returns the new position
+// of the pivot, and whether the range was already partitioned.
+template <typename A>
+LIBC_INLINE size_t partition_right(const A &array, size_t begin, size_t end,
+                                   bool &already_partitioned) {
+  const uint8_t *pivot = array.get(begin);
+  size_t first = begin + 1;
+  size_t last = end - 1;
+
+  while (first <= last && array.elem_compare(first, pivot) < 0)
+    ++first;
+  while (last >= first && array.elem_compare(last, pivot) >= 0)
+    --last;
+
+  // No element had to be moved, which hints that the range may be sorted.
+  already_partitioned = first > last;
+
+  // Every element in [begin + 1, first) is less than the pivot and every
+  // element in (last, end) is not, so the scans can't leave the range.
+  while (first < last) {
+    array.swap(first, last);
+    do
+      ++first;
+    while (array.elem_compare(first, pivot) < 0);
+    do
+      --last;
+    while (array.elem_compare(last, pivot) >= 0);
+  }
+
+  size_t pivot_pos = first - 1;
+  if (pivot_pos != begin)
+    array.swap(begin, pivot_pos);
+  return pivot_pos;
+}
+
+// Partitions [begin, end) around the pivot at begin like partition_right, but
+// the elements equal to the pivot end up before it. This is used when the
+// pivot is known to be the smallest element of the range, so that all the
+// elements equal to it are put in place at once.
+template <typename A>
+LIBC_INLINE size_t partition_left(const A &array, size_t begin, size_t end) {
+  const uint8_t *pivot = array.get(begin);
+  size_t first = begin + 1;
+  size_t last = end - 1;
+
+  while (last >= first && array.elem_compare(last, pivot) > 0)
+    --last;
+  while (first <= last && array.elem_compare(first, pivot) <= 0)
+    ++first;
+
+  while (first < last) {
+    array.swap(first, last);
+    do
+      --last;
+    while (array.elem_compare(last, pivot) > 0);
+    do
+      ++first;
+    while (array.elem_compare(first, pivot) <= 0);
+  }
+
+  if (last != begin)
+    array.swap(begin, last);
+  return last;
+}
+
+template <typename A>
+LIBC_INLINE void pdqsort_loop(const A &array, size_t begin, size_t end,
+                              unsigned bad_allowed, bool leftmost) {
+  while (true) {
+    const size_t size = end - begin;
+    if (size < INSERTION_SORT_THRESHOLD) {
+      insertion_sort(array, begin, end);
+      return;
+    }
+
+    // Move the pivot to begin.
+    const size_t mid = begin + size / 2;
+    if (size > NINTHER_THRESHOLD) {
+      sort3(array, begin, mid, end - 1);
+      sort3(array, begin + 1, mid - 1, end - 2);
+      sort3(array, begin + 2, mid + 1, end - 3);
+      sort3(array, mid - 1, mid, mid + 1);
+      array.swap(begin, mid);
+    } else {
+      sort3(array, mid, begin, end - 1);
+    }
+
+    // The element before the range is not greater than any element in it. If
+    // it is equal to the pivot, the pivot is the smallest element of the
+    // range, and there is no need to sort the elements equal to it any
+    // further.
+    if (!leftmost && array.elem_compare(begin - 1, array.get(begin)) >= 0) {
+      begin = partition_left(array, begin, end) + 1;
+      continue;
+    }
+
+    bool already_partitioned;
+    const size_t pivot_pos =
+        partition_right(array, begin, end, already_partitioned);
+    const size_t l_size = pivot_pos - begin;
+    const size_t r_size = end - (pivot_pos + 1);
+
+    if (l_size < size / 8 || r_size < size / 8) {
+      // Too many bad partitions, fall back to heapsort.
+      if (--bad_allowed == 0) {
+        heapsort(array, begin, end);
+        return;
+      }
+
+      // Swap some elements around to break up the pattern which led to the
+      // bad partition.
+      if (l_size >= INSERTION_SORT_THRESHOLD) {
+        array.swap(begin, begin + l_size / 4);
+        array.swap(pivot_pos - 1, pivot_pos - l_size / 4);
+        if (l_size > NINTHER_THRESHOLD) {
+          array.swap(begin + 1, begin + (l_size / 4 + 1));
+          array.swap(begin + 2, begin + (l_size / 4 + 2));
+          array.swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+          array.swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+        }
+      }
+      if (r_size >= INSERTION_SORT_THRESHOLD) {
+        array.swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+        array.swap(end - 1, end - r_size / 4);
+        if (r_size > NINTHER_THRESHOLD) {
+          array.swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+          array.swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+          array.swap(end - 2, end - (1 + r_size / 4));
+          array.swap(end - 3, end - (2 + r_size / 4));
+        }
+      }
+    } else if (already_partitioned &&
+               partial_insertion_sort(array, begin, pivot_pos) &&
+               partial_insertion_sort(array, pivot_pos + 1, end)) {
+      // The range was most likely sorted already.
+      return;
     }
 
-    if (compare_i == 0 && compare_j == 0) {
-      // If we do not move the pointers, we will end up with an
-      // infinite loop as i and j will be stuck without advancing.
-      ++i;
-      --j;
+    // Recurse into the smaller side and loop on the larger one, so that the
+    // recursion depth stays logarithmic.
+    if (l_size < r_size) {
+      pdqsort_loop(array, begin, pivot_pos, bad_allowed, leftmost);
+      begin = pivot_pos + 1;
+      leftmost = false;
+    } else {
+      pdqsort_loop(array, pivot_pos + 1, end, bad_allowed, false);
+      end = pivot_pos;
     }
   }
 }
 
-LIBC_INLINE void quicksort(const Array &array) {
+template <typename A> LIBC_INLINE void quicksort(const A &array) {
   const size_t array_size = array.size();
   if (array_size <= 1)
     return;
-  size_t split_index = partition(array);
-  if (array_size <= 2) {
-    // The partition operation sorts the two element array.
-    return;
+  // Allow about log2(n) bad partitions before falling back to heapsort.
+  unsigned bad_allowed = 1;
+  for (size_t n = array_size; n > 1; n >>= 1)
+    ++bad_allowed;
+  pdqsort_loop(array, 0, array_size, bad_allowed, true);
+}
+
+// Sorts the array, with dedicated instances for the most common element sizes.
+LIBC_INLINE void sort(uint8_t *array, size_t array_size, size_t elem_size,
+                      Comparator compare) {
+  switch (elem_size) {
+  case 4:
+    return quicksort(ArrayImpl<4>(array, array_size, elem_size, compare));
+  case 8:
+    return quicksort(ArrayImpl<8>(array, array_size, elem_size, compare));
+  case 16:
+    return quicksort(ArrayImpl<16>(array, array_size, elem_size, compare));
+  default:
+    return quicksort(Array(array, array_size, elem_size, compare));
   }
-  quicksort(array.make_array(0, split_index));
-  quicksort(array.make_array(split_index, array.size() - split_index));
 }
 
 } // namespace LIBC_NAMESPACE::internal
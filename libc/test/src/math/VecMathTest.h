@@ -0,0 +1,102 @@
+//===-- Utility class to test the vector math functions ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/__support/FPUtil/FPBits.h"
+#include "src/__support/FPUtil/vector_math.h"
+#include "test/UnitTest/FEnvSafeTest.h"
+#include "test/UnitTest/FPMatcher.h"
+#include "test/UnitTest/Test.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Checks that every lane of a vector math function gives the same result as
+// the scalar function, including when special inputs are mixed with ordinary
+// ones in the same vector.
+template <size_t N>
+class VecMathTest : public LIBC_NAMESPACE::testing::FEnvSafeTest {
+
+  DECLARE_SPECIAL_CONSTANTS(float)
+
+public:
+  using Vec = LIBC_NAMESPACE::fputil::simd<float, N>;
+  typedef Vec (*VecFunc)(Vec);
+  typedef float (*ScalarFunc)(float);
+
+  // Evaluates the inputs N at a time, starting at every offset so that each
+  // input lands in every lane.
+  void check(VecFunc vec_func, ScalarFunc scalar_func, const float *inputs,
+             size_t count) {
+    for (size_t start = 0; start < count; ++start) {
+      Vec x;
+      for (size_t i = 0; i < N; ++i)
+        x[i] = inputs[(start + i) % count];
+      Vec result = vec_func(x);
+      for (size_t i = 0; i < N; ++i)
+        EXPECT_FP_EQ(scalar_func(x[i]), static_cast<float>(result[i]));
+    }
+  }
+
+  void testSpecialNumbers(VecFunc vec_func, ScalarFunc scalar_func,
+                          const float *tricky_inputs, size_t tricky_count) {
+    const float INPUTS[] = {aNaN,
+                            sNaN,
+                            inf,
+                            neg_inf,
+                            zero,
+                            neg_zero,
+                            min_denormal,
+                            max_denormal,
+                            min_normal,
+                            max_normal,
+                            -min_denormal,
+                            -max_normal,
+                            1.0f,
+                            -1.0f,
+                            0.5f,
+                            2.0f,
+                            88.72283f,
+                            89.0f,
+                            -87.33654f,
+                            -103.97208f,
+                            -104.0f,
+                            0x1.0p-25f,
+                            -0x1.0p-25f};
+    check(vec_func, scalar_func, INPUTS, sizeof(INPUTS) / sizeof(INPUTS[0]));
+    check(vec_func, scalar_func, tricky_inputs, tricky_count);
+
+    // Mix every special input with ordinary ones.
+    for (float special : INPUTS) {
+      const float MIXED[] = {special, 1.5f, 3.25f, 0.75f, 10.0f, 0.125f, 7.0f};
+      check(vec_func, scalar_func, MIXED, sizeof(MIXED) / sizeof(MIXED[0]));
+    }
+  }
+
+  void testRange(VecFunc vec_func, ScalarFunc scalar_func) {
+    using FPBits = LIBC_NAMESPACE::fputil::FPBits<float>;
+    constexpr uint32_t COUNT = 100'000;
+    constexpr uint32_t STEP = UINT32_MAX / COUNT;
+    uint32_t v = 0;
+    for (uint32_t i = 0; i < COUNT; i += N) {
+      Vec x;
+      for (size_t j = 0; j < N; ++j, v += STEP)
+        x[j] = FPBits(v).get_val();
+      Vec result = vec_func(x);
+      for (size_t j = 0; j < N; ++j)
+        ASSERT_FP_EQ(scalar_func(x[j]), static_cast<float>(result[j]));
+    }
+  }
+};
+
+#define LIST_VEC_MATH_TESTS(N, vec_func, scalar_func, tricky_inputs)           \
+  using LlvmLibcVecMathTest = VecMathTest<N>;                                  \
+  TEST_F(LlvmLibcVecMathTest, SpecialNumbers) {                                \
+    testSpecialNumbers(&vec_func, &scalar_func, tricky_inputs,                 \
+                       sizeof(tricky_inputs) / sizeof(tricky_inputs[0]));      \
+  }                                                                            \
+  TEST_F(LlvmLibcVecMathTest, Range) { testRange(&vec_func, &scalar_func); }
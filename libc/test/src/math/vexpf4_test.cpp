@@ -0,0 +1,30 @@
+//===-- Unittests for __llvm_libc_vexpf4 ----------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "VecMathTest.h"
+
+#include "src/__support/FPUtil/FPBits.h"
+#include "src/math/__llvm_libc_vexpf4.h"
+#include "src/math/expf.h"
+
+using FPBits = LIBC_NAMESPACE::fputil::FPBits<float>;
+
+// The boundaries of the special cases of expf.
+static const float TRICKY_INPUTS[] = {
+    FPBits(0xc236bd8cU).get_val(), FPBits(0x42b20000U).get_val(),
+    FPBits(0x42b1ffffU).get_val(), FPBits(0xc2b20000U).get_val(),
+    FPBits(0xc2b1ffffU).get_val(), FPBits(0x32800000U).get_val(),
+    FPBits(0x32800001U).get_val(), FPBits(0xb2800000U).get_val(),
+    FPBits(0xb2800001U).get_val(), FPBits(0x42affff8U).get_val(),
+    FPBits(0x42b00008U).get_val(), FPBits(0xc2affff8U).get_val(),
+    FPBits(0xc2b00008U).get_val(), FPBits(0x42cffff8U).get_val(),
+    FPBits(0xc2cffff8U).get_val(),
+};
+
+LIST_VEC_MATH_TESTS(4, LIBC_NAMESPACE::__llvm_libc_vexpf4,
+                    LIBC_NAMESPACE::expf, TRICKY_INPUTS)
@@ -0,0 +1,31 @@
+//===-- Unittests for __llvm_libc_vlogf8 ----------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "VecMathTest.h"
+
+#include "src/__support/FPUtil/FPBits.h"
+#include "src/math/__llvm_libc_vlogf8.h"
+#include "src/math/logf.h"
+
+using FPBits = LIBC_NAMESPACE::fputil::FPBits<float>;
+
+// The hard-to-round inputs of logf with and without FMA, and powers of two.
+static const float TRICKY_INPUTS[] = {
+    FPBits(0x3f7f4d6fU).get_val(), FPBits(0x41178febU).get_val(),
+    FPBits(0x3f800000U).get_val(), FPBits(0x1e88452dU).get_val(),
+    FPBits(0x4c5d65a5U).get_val(), FPBits(0x65d890d3U).get_val(),
+    FPBits(0x6f31a8ecU).get_val(), FPBits(0x7a17f30aU).get_val(),
+    FPBits(0x500ffb03U).get_val(), FPBits(0x5cd69e88U).get_val(),
+    FPBits(0x5ee8984eU).get_val(), FPBits(0x3f800001U).get_val(),
+    FPBits(0x3f7fffffU).get_val(), FPBits(0x00800000U).get_val(),
+    FPBits(0x3a800000U).get_val(), FPBits(0x5f800000U).get_val(),
+    FPBits(0x7f000000U).get_val(),
+};
+
+LIST_VEC_MATH_TESTS(8, LIBC_NAMESPACE::__llvm_libc_vlogf8,
+                    LIBC_NAMESPACE::logf, TRICKY_INPUTS)
@@ -263,3 +263,89 @@ TEST(LlvmLibcQSortTest, SingleElementArray) {
 
   ASSERT_LE(array[0], ELEM);
 }
+
+// The arrays below are large enough to go through the partitioning, and they
+// have patterns which lead to bad partitions with a naive pivot choice.
+
+TEST(LlvmLibcQsortTest, LargeArrayPatterns) {
+  constexpr size_t ARRAY_SIZE = 1000;
+  int array[ARRAY_SIZE];
+
+  for (int pattern = 0; pattern < 5; ++pattern) {
+    for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+      int n = static_cast<int>(i);
+      switch (pattern) {
+      case 0: // Pseudo-random
+        array[i] = (n * 7919) % 1009;
+        break;
+      case 1: // Organ pipe
+        array[i] = n < 500 ? n : 1000 - n;
+        break;
+      case 2: // Few distinct values
+        array[i] = n % 3;
+        break;
+      case 3: // Sorted with a trailing smaller element
+        array[i] = n == 999 ? -1 : n;
+        break;
+      default: // Alternating ends
+        array[i] = (n % 2) ? n : 1000 - n;
+      }
+    }
+
+    LIBC_NAMESPACE::qsort(array, ARRAY_SIZE, sizeof(int), int_compare);
+
+    for (size_t i = 0; i < ARRAY_SIZE - 1; ++i)
+      ASSERT_LE(array[i], array[i + 1]);
+  }
+}
+
+struct Record {
+  long long key;
+  long long value;
+};
+
+static int record_compare(const void *l, const void *r) {
+  long long lk = reinterpret_cast<const Record *>(l)->key;
+  long long rk = reinterpret_cast<const Record *>(r)->key;
+  return lk < rk ? -1 : (lk > rk ? 1 : 0);
+}
+
+TEST(LlvmLibcQsortTest, LargeRecordArray) {
+  constexpr size_t ARRAY_SIZE = 500;
+  Record array[ARRAY_SIZE];
+  for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+    long long key = static_cast<long long>((i * 211) % ARRAY_SIZE);
+    array[i] = {key, -key};
+  }
+
+  LIBC_NAMESPACE::qsort(array, ARRAY_SIZE, sizeof(Record), record_compare);
+
+  for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+    ASSERT_EQ(array[i].key, static_cast<long long>(i));
+    ASSERT_EQ(array[i].value, -static_cast<long long>(i));
+  }
+}
+
+TEST(LlvmLibcQsortTest, OddElementSize) {
+  constexpr size_t ELEM_SIZE = 7;
+  constexpr size_t ARRAY_SIZE = 300;
+  unsigned char array[ARRAY_SIZE * ELEM_SIZE];
+  for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+    unsigned char key = static_cast<unsigned char>((i * 37) % 251);
+    for (size_t b = 0; b < ELEM_SIZE; ++b)
+      array[i * ELEM_SIZE + b] = key;
+  }
+
+  LIBC_NAMESPACE::qsort(
+      array, ARRAY_SIZE, ELEM_SIZE, [](const void *l, const void *r) {
+        return int(*reinterpret_cast<const unsigned char *>(l)) -
+               int(*reinterpret_cast<const unsigned char *>(r));
+      });
+
+  for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+    for (size_t b = 0; b < ELEM_SIZE; ++b)
+      ASSERT_EQ(array[i * ELEM_SIZE + b], array[i * ELEM_SIZE]);
+    if (i + 1 < ARRAY_SIZE)
+      ASSERT_LE(array[i * ELEM_SIZE], array[(i + 1) * ELEM_SIZE]);
+  }
+}
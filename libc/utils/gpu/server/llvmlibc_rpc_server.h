@@ -76,6 +76,18 @@ rpc_status_t rpc_server_shutdown(rpc_device_t rpc_device, rpc_free_ty dealloc,
 /// are any active requests. Runs until all work on the server is completed.
 rpc_status_t rpc_handle_server(rpc_device_t rpc_device);
 
+/// Start \p num_workers threads which handle the server in the background,
+/// concurrently with each other and with rpc_handle_server, until the server is
+/// shut down. Registered callbacks can then be invoked from several threads at
+/// once and must be thread safe, and no callbacks may be registered after this
+/// call. The first error encountered by the workers is returned by the next
+/// call to rpc_handle_server. Workers which find no work back off, and sleep for
+/// up to about a millisecond between scans of the ports, so requests may take
+/// that long to be picked up after a quiet period. Workers can only be started
+/// once.
+rpc_status_t rpc_server_start_workers(rpc_device_t rpc_device,
+                                      uint32_t num_workers);
+
 /// Register a callback to handle an opcode from the RPC client. The associated
 /// data must remain accessible as long as the user intends to handle the server
 /// with this callback.
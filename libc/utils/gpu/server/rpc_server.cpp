@@ -22,10 +22,13 @@
 #include "src/stdio/gpu/file.h"
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <variant>
 #include <vector>
@@ -203,13 +206,32 @@ rpc_status_t handle_server_impl(
     }
 
     port->recv_n(strs, sizes, [&](uint64_t size) { return new char[size]; });
+
+    // Coalesce the writes of all the lanes to the same stream under a single
+    // lock, in lane order, so that they aren't interleaved with the output of
+    // other ports handled concurrently.
+    uint64_t results[lane_size] = {0};
+    bool written[lane_size] = {false};
+    for (uint32_t lane = 0; lane < lane_size; ++lane) {
+      if (!strs[lane] || written[lane])
+        continue;
+
+      FILE *file = files[lane];
+      flockfile(file);
+      for (uint32_t id = lane; id < lane_size; ++id) {
+        if (!strs[id] || files[id] != file)
+          continue;
+        results[id] = fwrite_unlocked(strs[id], 1, sizes[id], file);
+        if (port->get_opcode() == RPC_WRITE_TO_STDOUT_NEWLINE &&
+            results[id] == sizes[id])
+          results[id] += fwrite_unlocked("\n", 1, 1, file);
+        written[id] = true;
+      }
+      funlockfile(file);
+    }
+
     port->send([&](rpc::Buffer *buffer, uint32_t id) {
-      flockfile(files[id]);
-      buffer->data[0] = fwrite_unlocked(strs[id], 1, sizes[id], files[id]);
-      if (port->get_opcode() == RPC_WRITE_TO_STDOUT_NEWLINE &&
-          buffer->data[0] == sizes[id])
-        buffer->data[0] += fwrite_unlocked("\n", 1, 1, files[id]);
-      funlockfile(files[id]);
+      buffer->data[0] = results[id];
       delete[] reinterpret_cast<uint8_t *>(strs[id]);
     });
     break;
@@ -372,8 +394,10 @@ rpc_status_t handle_server_impl(
 
 struct Device {
   Device(uint32_t lane_size, uint32_t num_ports, void *buffer)
-      : lane_size(lane_size), buffer(buffer), server(num_ports, buffer),
-        client(num_ports, buffer) {}
+      : lane_size(lane_size), num_ports(num_ports), buffer(buffer),
+        server(num_ports, buffer), client(num_ports, buffer) {}
+
+  ~Device() { stop_workers(); }
 
   rpc_status_t handle_server(uint32_t &index) {
     switch (lane_size) {
@@ -388,12 +412,97 @@ struct Device {
     }
   }
 
+  // Handles the server until it is stopped. Each worker starts its scan at a
+  // different port so that they don't all contend for the same ones.
+  void run_worker(uint32_t start) {
+    uint32_t index = start;
+    uint32_t idle_scans = 0;
+    bool found_work = false;
+    while (!stopping.load(std::memory_order_relaxed)) {
+      rpc_status_t status = handle_server(index);
+      if (status == RPC_STATUS_CONTINUE) {
+        found_work = true;
+        continue;
+      }
+
+      // Keep the first error for the next call to rpc_handle_server.
+      if (status != RPC_STATUS_SUCCESS) {
+        uint32_t expected = RPC_STATUS_SUCCESS;
+        worker_status.compare_exchange_strong(expected, status);
+      }
+
+      // Scan the ports before the starting one, then start over.
+      if (index != 0) {
+        index = 0;
+        continue;
+      }
+      index = start;
+      idle_scans = found_work ? 0 : idle_scans + 1;
+      found_work = false;
+      back_off(idle_scans);
+    }
+  }
+
+  // Waits before the next scan of the ports once \p idle_scans scans in a row
+  // found no work. The worker first yields, so that it picks up new requests
+  // quickly, then sleeps for exponentially longer periods so that idle workers
+  // don't keep the host cores busy. Stopping the workers wakes them up.
+  void back_off(uint32_t idle_scans) {
+    constexpr uint32_t MAX_IDLE_YIELDS = 64;
+    constexpr uint32_t MAX_SLEEP_SHIFT = 10; // About one millisecond.
+    if (idle_scans == 0)
+      return;
+    if (idle_scans <= MAX_IDLE_YIELDS) {
+      std::this_thread::yield();
+      return;
+    }
+    uint32_t shift = std::min(idle_scans - MAX_IDLE_YIELDS, MAX_SLEEP_SHIFT);
+    std::unique_lock<std::mutex> lock(stop_mutex);
+    stop_cv.wait_for(lock, std::chrono::microseconds(1u << shift), [&] {
+      return stopping.load(std::memory_order_relaxed);
+    });
+  }
+
+  rpc_status_t start_workers(uint32_t num_workers) {
+    if (!workers.empty())
+      return RPC_STATUS_ERROR;
+    for (uint32_t i = 0; i < num_workers; ++i) {
+      uint32_t start = static_cast<uint32_t>(
+          static_cast<uint64_t>(num_ports) * i / num_workers);
+      workers.emplace_back([this, start] { run_worker(start); });
+    }
+    return RPC_STATUS_SUCCESS;
+  }
+
+  void stop_workers() {
+    {
+      std::lock_guard<std::mutex> lock(stop_mutex);
+      stopping.store(true, std::memory_order_relaxed);
+    }
+    stop_cv.notify_all();
+    for (std::thread &worker : workers)
+      worker.join();
+    workers.clear();
+  }
+
+  // Returns and clears the first error encountered by the workers.
+  rpc_status_t take_worker_status() {
+    return static_cast<rpc_status_t>(
+        worker_status.exchange(RPC_STATUS_SUCCESS));
+  }
+
   uint32_t lane_size;
+  uint32_t num_ports;
   void *buffer;
   rpc::Server server;
   rpc::Client client;
   std::unordered_map<uint16_t, rpc_opcode_callback_ty> callbacks;
   std::unordered_map<uint16_t, void *> callback_data;
+  std::vector<std::thread> workers;
+  std::atomic<bool> stopping{false};
+  std::mutex stop_mutex;
+  std::condition_variable stop_cv;
+  std::atomic<uint32_t> worker_status{RPC_STATUS_SUCCESS};
 };
 
 rpc_status_t rpc_server_init(rpc_device_t *rpc_device, uint64_t num_ports,
@@ -424,6 +533,8 @@ rpc_status_t rpc_server_shutdown(rpc_device_t rpc_device, rpc_free_ty dealloc,
     return RPC_STATUS_ERROR;
 
   Device *device = reinterpret_cast<Device *>(rpc_device.handle);
+  // The workers have to be done with the buffer before it is freed.
+  device->stop_workers();
   dealloc(device->buffer, data);
   delete device;
 
@@ -435,6 +546,9 @@ rpc_status_t rpc_handle_server(rpc_device_t rpc_device) {
     return RPC_STATUS_ERROR;
 
   Device *device = reinterpret_cast<Device *>(rpc_device.handle);
+  if (rpc_status_t status = device->take_worker_status())
+    return status;
+
   uint32_t index = 0;
   for (;;) {
     rpc_status_t status = device->handle_server(index);
@@ -443,6 +557,15 @@ rpc_status_t rpc_handle_server(rpc_device_t rpc_device) {
   }
 }
 
+rpc_status_t rpc_server_start_workers(rpc_device_t rpc_device,
+                                      uint32_t num_workers) {
+  if (!rpc_device.handle)
+    return RPC_STATUS_ERROR;
+
+  Device *device = reinterpret_cast<Device *>(rpc_device.handle);
+  return device->start_workers(num_workers);
+}
+
 rpc_status_t rpc_register_callback(rpc_device_t rpc_device, uint16_t opcode,
                                    rpc_opcode_callback_ty callback,
                                    void *data) {
@@ -0,0 +1 @@
+set(LIBCXX_PSTL_BACKEND thread_pool CACHE STRING "")
@@ -12,6 +12,8 @@
 
 #include <__algorithm/iterator_operations.h>
 #include <__algorithm/min.h>
+#include <__algorithm/simd_utils.h>
+#include <__algorithm/unwrap_iter.h>
 #include <__bit/invert_if.h>
 #include <__bit/popcount.h>
 #include <__config>
@@ -19,6 +21,12 @@
 #include <__functional/invoke.h>
 #include <__fwd/bit_reference.h>
 #include <__iterator/iterator_traits.h>
+#include <__type_traits/is_constant_evaluated.h>
+#include <__type_traits/is_equality_comparable.h>
+#include <__type_traits/is_integral.h>
+#include <__type_traits/is_same.h>
+#include <__type_traits/remove_const.h>
+#include <cstddef>
 
 #if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
 #  pragma GCC system_header
@@ -40,6 +48,36 @@ __count(_Iter __first, _Sent __last, const _Tp& __value, _Proj& __proj) {
   return __r;
 }
 
+#if _LIBCPP_VECTORIZE_ALGORITHMS
+template <class _AlgPolicy,
+          class _Tp,
+          class _Up,
+          class _Proj,
+          __enable_if_t<__is_identity<_Proj>::value && __libcpp_is_trivially_equality_comparable<_Tp, _Up>::value &&
+                            is_integral<_Tp>::value && !is_same<__remove_const_t<_Tp>, bool>::value,
+                        int> = 0>
+_LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_SINCE_CXX20 ptrdiff_t
+__count(_Tp* __first, _Tp* __last, const _Up& __value, _Proj& __proj) {
+  using __value_type          = __remove_const_t<_Tp>;
+  constexpr size_t __vec_size = __native_vector_size<__value_type>;
+  using __vec                 = __simd_vector<__value_type, __vec_size>;
+
+  ptrdiff_t __r = 0;
+  if (!__libcpp_is_constant_evaluated()) {
+    // The bits of the mask past the vector size are unspecified
+    constexpr unsigned long long __valid_bits = __vec_size >= 64 ? ~0ull : (1ull << __vec_size) - 1;
+    const __value_type __v                    = __value;
+    for (; static_cast<size_t>(__last - __first) >= __vec_size; __first += __vec_size)
+      __r += std::__libcpp_popcount(
+          static_cast<unsigned long long>(std::__as_mask(std::__load_vector<__vec>(__first) == __v)) & __valid_bits);
+  }
+  for (; __first != __last; ++__first)
+    if (std::__invoke(__proj, *__first) == __value)
+      ++__r;
+  return __r;
+}
+#endif // _LIBCPP_VECTORIZE_ALGORITHMS
+
 // __bit_iterator implementation
 template <bool _ToCount, class _Cp, bool _IsConst>
 _LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_SINCE_CXX20 typename __bit_iterator<_Cp, _IsConst>::difference_type
@@ -82,7 +120,7 @@ template <class _InputIterator, class _Tp>
 _LIBCPP_NODISCARD inline _LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_SINCE_CXX20 __iter_diff_t<_InputIterator>
 count(_InputIterator __first, _InputIterator __last, const _Tp& __value) {
   __identity __proj;
-  return std::__count<_ClassicAlgPolicy>(__first, __last, __value, __proj);
+  return std::__count<_ClassicAlgPolicy>(std::__unwrap_iter(__first), std::__unwrap_iter(__last), __value, __proj);
 }
 
 _LIBCPP_END_NAMESPACE_STD
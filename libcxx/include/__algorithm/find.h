@@ -12,6 +12,7 @@
 
 #include <__algorithm/find_segment_if.h>
 #include <__algorithm/min.h>
+#include <__algorithm/simd_utils.h>
 #include <__algorithm/unwrap_iter.h>
 #include <__bit/countr.h>
 #include <__bit/invert_if.h>
@@ -21,6 +22,7 @@
 #include <__fwd/bit_reference.h>
 #include <__iterator/segmented_iterator.h>
 #include <__string/constexpr_c_functions.h>
+#include <__type_traits/is_constant_evaluated.h>
 #include <__type_traits/is_integral.h>
 #include <__type_traits/is_same.h>
 #include <__type_traits/is_signed.h>
@@ -77,6 +79,34 @@ _LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_SINCE_CXX14 _Tp* __find(_Tp* __first, _T
 }
 #endif // _LIBCPP_HAS_NO_WIDE_CHARACTERS
 
+#if _LIBCPP_VECTORIZE_ALGORITHMS
+template <class _Tp>
+inline const bool __find_uses_wmemchr_v =
+#  ifndef _LIBCPP_HAS_NO_WIDE_CHARACTERS
+    sizeof(_Tp) == sizeof(wchar_t) && _LIBCPP_ALIGNOF(_Tp) >= _LIBCPP_ALIGNOF(wchar_t);
+#  else
+    false;
+#  endif
+
+// Integers which can't be searched for with memchr or wmemchr
+template <class _Tp,
+          class _Up,
+          class _Proj,
+          __enable_if_t<__is_identity<_Proj>::value && __libcpp_is_trivially_equality_comparable<_Tp, _Up>::value &&
+                            is_integral<_Tp>::value && sizeof(_Tp) != 1 && !__find_uses_wmemchr_v<_Tp>,
+                        int> = 0>
+_LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_SINCE_CXX14 _Tp*
+__find(_Tp* __first, _Tp* __last, const _Up& __value, _Proj& __proj) {
+  if (__libcpp_is_constant_evaluated()) {
+    for (; __first != __last; ++__first)
+      if (std::__invoke(__proj, *__first) == __value)
+        break;
+    return __first;
+  }
+  return std::__find_vectorized(__first, __last, __value);
+}
+#endif // _LIBCPP_VECTORIZE_ALGORITHMS
+
 // TODO: This should also be possible to get right with different signedness
 // cast integral types to allow vectorization
 template <class _Tp,
@@ -11,8 +11,16 @@
 
 #include <__algorithm/comp.h>
 #include <__algorithm/comp_ref_type.h>
+#include <__algorithm/simd_utils.h>
+#include <__algorithm/unwrap_iter.h>
 #include <__config>
 #include <__iterator/iterator_traits.h>
+#include <__type_traits/desugars_to.h>
+#include <__type_traits/is_constant_evaluated.h>
+#include <__type_traits/is_integral.h>
+#include <__type_traits/is_same.h>
+#include <__type_traits/remove_const.h>
+#include <__type_traits/remove_cvref.h>
 
 #if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
 #  pragma GCC system_header
@@ -34,10 +42,33 @@ __max_element(_ForwardIterator __first, _ForwardIterator __last, _Compare __comp
   return __first;
 }
 
+#if _LIBCPP_VECTORIZE_ALGORITHMS
+template <class _Compare,
+          class _Tp,
+          __enable_if_t<is_integral<_Tp>::value && !is_same<__remove_const_t<_Tp>, bool>::value &&
+                            __desugars_to_v<__less_tag, __remove_cvref_t<_Compare>, _Tp, _Tp>,
+                        int> = 0>
+inline _LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_SINCE_CXX14 _Tp* __max_element(_Tp* __first, _Tp* __last, _Compare) {
+  if (__first == __last)
+    return __first;
+
+  if (!__libcpp_is_constant_evaluated())
+    return std::__find_extremum_vectorized</*_IsMax=*/true>(__first, __last);
+
+  _Tp* __i = __first;
+  while (++__i != __last)
+    if (*__first < *__i)
+      __first = __i;
+  return __first;
+}
+#endif // _LIBCPP_VECTORIZE_ALGORITHMS
+
 template <class _ForwardIterator, class _Compare>
 _LIBCPP_NODISCARD inline _LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_SINCE_CXX14 _ForwardIterator
 max_element(_ForwardIterator __first, _ForwardIterator __last, _Compare __comp) {
-  return std::__max_element<__comp_ref_type<_Compare> >(__first, __last, __comp);
+  return std::__rewrap_iter(
+      __first,
+      std::__max_element<__comp_ref_type<_Compare> >(std::__unwrap_iter(__first), std::__unwrap_iter(__last), __comp));
 }
 
 template <class _ForwardIterator>
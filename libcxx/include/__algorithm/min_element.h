@@ -11,11 +11,19 @@
 
 #include <__algorithm/comp.h>
 #include <__algorithm/comp_ref_type.h>
+#include <__algorithm/simd_utils.h>
+#include <__algorithm/unwrap_iter.h>
 #include <__config>
 #include <__functional/identity.h>
 #include <__functional/invoke.h>
 #include <__iterator/iterator_traits.h>
+#include <__type_traits/desugars_to.h>
 #include <__type_traits/is_callable.h>
+#include <__type_traits/is_constant_evaluated.h>
+#include <__type_traits/is_integral.h>
+#include <__type_traits/is_same.h>
+#include <__type_traits/remove_const.h>
+#include <__type_traits/remove_cvref.h>
 #include <__utility/move.h>
 
 #if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
@@ -41,6 +49,30 @@ __min_element(_Iter __first, _Sent __last, _Comp __comp, _Proj& __proj) {
   return __first;
 }
 
+#if _LIBCPP_VECTORIZE_ALGORITHMS
+template <class _Comp,
+          class _Tp,
+          class _Proj,
+          __enable_if_t<is_integral<_Tp>::value && !is_same<__remove_const_t<_Tp>, bool>::value &&
+                            __desugars_to_v<__less_tag, __remove_cvref_t<_Comp>, _Tp, _Tp> &&
+                            __is_identity<_Proj>::value,
+                        int> = 0>
+inline _LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_SINCE_CXX14 _Tp*
+__min_element(_Tp* __first, _Tp* __last, _Comp, _Proj&) {
+  if (__first == __last)
+    return __first;
+
+  if (!__libcpp_is_constant_evaluated())
+    return std::__find_extremum_vectorized</*_IsMax=*/false>(__first, __last);
+
+  _Tp* __i = __first;
+  while (++__i != __last)
+    if (*__i < *__first)
+      __first = __i;
+  return __first;
+}
+#endif // _LIBCPP_VECTORIZE_ALGORITHMS
+
 template <class _Comp, class _Iter, class _Sent>
 _LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_SINCE_CXX14 _Iter __min_element(_Iter __first, _Sent __last, _Comp __comp) {
   auto __proj = __identity();
@@ -55,7 +87,9 @@ min_element(_ForwardIterator __first, _ForwardIterator __last, _Compare __comp)
   static_assert(
       __is_callable<_Compare, decltype(*__first), decltype(*__first)>::value, "The comparator has to be callable");
 
-  return std::__min_element<__comp_ref_type<_Compare> >(std::move(__first), std::move(__last), __comp);
+  return std::__rewrap_iter(
+      __first,
+      std::__min_element<__comp_ref_type<_Compare> >(std::__unwrap_iter(__first), std::__unwrap_iter(__last), __comp));
 }
 
 template <class _ForwardIterator>
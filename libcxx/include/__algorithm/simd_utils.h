@@ -9,12 +9,12 @@
 #ifndef _LIBCPP___ALGORITHM_SIMD_UTILS_H
 #define _LIBCPP___ALGORITHM_SIMD_UTILS_H
 
-#include <__algorithm/min.h>
 #include <__bit/bit_cast.h>
 #include <__bit/countr.h>
 #include <__config>
 #include <__type_traits/is_arithmetic.h>
 #include <__type_traits/is_same.h>
+#include <__type_traits/remove_const.h>
 #include <__utility/integer_sequence.h>
 #include <cstddef>
 #include <cstdint>
@@ -93,13 +93,18 @@ _LIBCPP_NODISCARD _LIBCPP_HIDE_FROM_ABI bool __all_of(__simd_vector<_Tp, _Np> __
 }
 
 template <class _Tp, size_t _Np>
-_LIBCPP_NODISCARD _LIBCPP_HIDE_FROM_ABI size_t __find_first_set(__simd_vector<_Tp, _Np> __vec) noexcept {
+_LIBCPP_NODISCARD _LIBCPP_HIDE_FROM_ABI bool __any_of(__simd_vector<_Tp, _Np> __vec) noexcept {
+  return __builtin_reduce_or(__builtin_convertvector(__vec, __simd_vector<bool, _Np>));
+}
+
+// Returns an unsigned integer with the bit N set iff the element N of __vec is non-zero.
+template <class _Tp, size_t _Np>
+_LIBCPP_NODISCARD _LIBCPP_HIDE_FROM_ABI auto __as_mask(__simd_vector<_Tp, _Np> __vec) noexcept {
   using __mask_vec = __simd_vector<bool, _Np>;
 
   // This has MSan disabled du to https://github.com/llvm/llvm-project/issues/85876
   auto __impl = [&]<class _MaskT>(_MaskT) _LIBCPP_NO_SANITIZE("memory") noexcept {
-    return std::min<size_t>(
-        _Np, std::__countr_zero(__builtin_bit_cast(_MaskT, __builtin_convertvector(__vec, __mask_vec))));
+    return __builtin_bit_cast(_MaskT, __builtin_convertvector(__vec, __mask_vec));
   };
 
   if constexpr (sizeof(__mask_vec) == sizeof(uint8_t)) {
@@ -116,11 +121,86 @@ _LIBCPP_NODISCARD _LIBCPP_HIDE_FROM_ABI size_t __find_first_set(__simd_vector<_T
   }
 }
 
+template <class _Tp, size_t _Np>
+_LIBCPP_NODISCARD _LIBCPP_HIDE_FROM_ABI size_t __find_first_set(__simd_vector<_Tp, _Np> __vec) noexcept {
+  // This doesn't use std::min, since <__algorithm/min.h> depends on algorithms which use this header.
+  size_t __index = std::__countr_zero(std::__as_mask(__vec));
+  return __index < _Np ? __index : _Np;
+}
+
 template <class _Tp, size_t _Np>
 _LIBCPP_NODISCARD _LIBCPP_HIDE_FROM_ABI size_t __find_first_not_set(__simd_vector<_Tp, _Np> __vec) noexcept {
   return std::__find_first_set(~__vec);
 }
 
+// Returns a pointer to the first element of [__first, __last) which is equal to __value, or __last.
+template <class _Tp>
+_LIBCPP_NODISCARD _LIBCPP_HIDE_FROM_ABI _Tp*
+__find_vectorized(_Tp* __first, _Tp* __last, __remove_const_t<_Tp> __value) noexcept {
+  using __value_type              = __remove_const_t<_Tp>;
+  constexpr size_t __unroll_count = 4;
+  constexpr size_t __vec_size     = __native_vector_size<__value_type>;
+  using __vec                     = __simd_vector<__value_type, __vec_size>;
+  using __cmp_vec                 = decltype(__vec() == __vec());
+
+  while (static_cast<size_t>(__last - __first) >= __unroll_count * __vec_size) {
+    __cmp_vec __cmp_res[__unroll_count];
+    for (size_t __i = 0; __i != __unroll_count; ++__i)
+      __cmp_res[__i] = std::__load_vector<__vec>(__first + __i * __vec_size) == __value;
+
+    for (size_t __i = 0; __i != __unroll_count; ++__i) {
+      if (std::__any_of(__cmp_res[__i]))
+        return __first + __i * __vec_size + std::__find_first_set(__cmp_res[__i]);
+    }
+    __first += __unroll_count * __vec_size;
+  }
+
+  while (static_cast<size_t>(__last - __first) >= __vec_size) {
+    if (auto __cmp_res = std::__load_vector<__vec>(__first) == __value; std::__any_of(__cmp_res))
+      return __first + std::__find_first_set(__cmp_res);
+    __first += __vec_size;
+  }
+
+  for (; __first != __last; ++__first) {
+    if (*__first == __value)
+      break;
+  }
+  return __first;
+}
+
+// Returns a pointer to the first smallest element of [__first, __last), or to the first largest one if _IsMax is true.
+// The range must not be empty. The extremum is computed over whole vectors first, and then searched for.
+template <bool _IsMax, class _Tp>
+_LIBCPP_NODISCARD _LIBCPP_HIDE_FROM_ABI _Tp* __find_extremum_vectorized(_Tp* __first, _Tp* __last) noexcept {
+  using __value_type          = __remove_const_t<_Tp>;
+  constexpr size_t __vec_size = __native_vector_size<__value_type>;
+  using __vec                 = __simd_vector<__value_type, __vec_size>;
+
+  _Tp* __iter = __first;
+  __value_type __extremum;
+  if (static_cast<size_t>(__last - __iter) >= __vec_size) {
+    __vec __acc = std::__load_vector<__vec>(__iter);
+    for (__iter += __vec_size; static_cast<size_t>(__last - __iter) >= __vec_size; __iter += __vec_size) {
+      if constexpr (_IsMax)
+        __acc = __builtin_elementwise_max(__acc, std::__load_vector<__vec>(__iter));
+      else
+        __acc = __builtin_elementwise_min(__acc, std::__load_vector<__vec>(__iter));
+    }
+    if constexpr (_IsMax)
+      __extremum = __builtin_reduce_max(__acc);
+    else
+      __extremum = __builtin_reduce_min(__acc);
+  } else {
+    __extremum = *__iter++;
+  }
+
+  for (; __iter != __last; ++__iter) {
+    if (_IsMax ? __extremum < *__iter : *__iter < __extremum)
+      __extremum = *__iter;
+  }
+  return std::__find_vectorized(__first, __last, __extremum);
+}
+
 _LIBCPP_END_NAMESPACE_STD
 
 #endif // _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS
@@ -28,6 +28,8 @@
 #include <__format/formatter_char.h>
 #include <__format/formatter_floating_point.h>
 #include <__format/formatter_integer.h>
+#include <__format/formatter_integral.h>
+#include <__format/formatter_output.h>
 #include <__format/formatter_pointer.h>
 #include <__format/formatter_string.h>
 #include <__format/parser_std_format_spec.h>
@@ -37,6 +39,7 @@
 #include <__iterator/iterator_traits.h> // iter_value_t
 #include <__variant/monostate.h>
 #include <array>
+#include <limits>
 #include <string>
 #include <string_view>
 
@@ -241,6 +244,26 @@ _LIBCPP_HIDE_FROM_ABI constexpr void __compile_time_visit_format_arg(
   std::__throw_format_error("Invalid argument");
 }
 
+// The arguments which are written directly when their replacement field has
+// no format-spec, instead of through their formatter. Their default output is
+// the one of to_chars or a plain copy of the string.
+template <class _Tp, class _CharT>
+inline constexpr bool __has_unformatted_fast_path =
+    same_as<_Tp, int> || same_as<_Tp, long long> || same_as<_Tp, unsigned> || same_as<_Tp, unsigned long long> ||
+    same_as<_Tp, const _CharT*> || same_as<_Tp, basic_string_view<_CharT>>;
+
+template <class _Tp, class _Ctx>
+  requires __has_unformatted_fast_path<_Tp, typename _Ctx::char_type>
+_LIBCPP_HIDE_FROM_ABI typename _Ctx::iterator __write_unformatted(_Tp __arg, _Ctx& __ctx) {
+  using _CharT = typename _Ctx::char_type;
+  if constexpr (integral<_Tp>) {
+    array<char, numeric_limits<_Tp>::digits10 + 2> __buffer;
+    char* __last = __formatter::__to_buffer(__buffer.data(), __buffer.data() + __buffer.size(), __arg, 10);
+    return __formatter::__copy<char, _CharT>(basic_string_view<char>{__buffer.data(), __last}, __ctx.out());
+  } else
+    return __formatter::__copy(basic_string_view<_CharT>{__arg}, __ctx.out());
+}
+
 template <contiguous_iterator _Iterator, class _ParseCtx, class _Ctx>
 _LIBCPP_HIDE_FROM_ABI constexpr _Iterator
 __handle_replacement_field(_Iterator __begin, _Iterator __end, _ParseCtx& __parse_ctx, _Ctx& __ctx) {
@@ -279,7 +302,14 @@ __handle_replacement_field(_Iterator __begin, _Iterator __end, _ParseCtx& __pars
             std::__throw_format_error("The argument index value is too large for the number of arguments supplied");
           else if constexpr (same_as<decltype(__arg), typename basic_format_arg<_Ctx>::handle>)
             __arg.format(__parse_ctx, __ctx);
-          else {
+          else if constexpr (__has_unformatted_fast_path<decltype(__arg), _CharT>) {
+            if (__parse) {
+              formatter<decltype(__arg), _CharT> __formatter;
+              __parse_ctx.advance_to(__formatter.parse(__parse_ctx));
+              __ctx.advance_to(__formatter.format(__arg, __ctx));
+            } else
+              __ctx.advance_to(__format::__write_unformatted(__arg, __ctx));
+          } else {
             formatter<decltype(__arg), _CharT> __formatter;
             if (__parse)
               __parse_ctx.advance_to(__formatter.parse(__parse_ctx));
@@ -328,6 +358,18 @@ _LIBCPP_HIDE_FROM_ABI constexpr typename _Ctx::iterator __vformat_to(_ParseCtx&&
         std::__throw_format_error("The format string contains an invalid escape sequence");
 
       break;
+
+    default:
+      if constexpr (!same_as<remove_cvref_t<_Ctx>, __compile_time_basic_format_context<_CharT>>) {
+        // Copy the literal text up to the next replacement field or escape
+        // sequence at once, instead of one character per iteration.
+        auto __next = __begin;
+        while (++__next != __end && *__next != _CharT('{') && *__next != _CharT('}'))
+          ;
+        __out_it = __formatter::__copy(__begin, __next, std::move(__out_it));
+        __begin  = __next;
+        continue;
+      }
     }
 
     // Copy the character to the output verbatim.
@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Implementation of the libdispatch backend's entry points on top of a pool of
+// std::threads, for platforms without libdispatch. Selected with
+// LIBCXX_PSTL_BACKEND=thread_pool.
+
+#include <__config>
+#include <__pstl/backends/libdispatch.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef _LIBCPP_PSTL_THREAD_POOL_GRAIN_SIZE
+#  define _LIBCPP_PSTL_THREAD_POOL_GRAIN_SIZE 256
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+namespace __pstl::__libdispatch {
+
+namespace {
+
+// Smallest number of elements given to a thread at once, and number of chunks
+// to create per thread so that threads finishing early can take work from the
+// others.
+constexpr ptrdiff_t grain_size        = _LIBCPP_PSTL_THREAD_POOL_GRAIN_SIZE;
+constexpr ptrdiff_t chunks_per_thread = 16;
+
+// A parallel loop run by the pool. Its chunks are claimed one at a time by the
+// thread that started it and by any worker that is idle, until none is left.
+struct job {
+  void* context;
+  void (*func)(void*, size_t);
+  size_t chunk_count;
+  atomic<size_t> next_chunk{0};
+  // Number of workers that took the job and may still be running one of its
+  // chunks. Protected by the mutex of the pool.
+  unsigned workers = 0;
+
+  void run_chunks() {
+    for (size_t chunk; (chunk = next_chunk.fetch_add(1, memory_order_relaxed)) < chunk_count;)
+      func(context, chunk);
+  }
+};
+
+class thread_pool {
+public:
+  thread_pool() {
+    unsigned thread_count = std::max(1u, thread::hardware_concurrency());
+#ifndef _LIBCPP_HAS_NO_EXCEPTIONS
+    try {
+#endif
+      // The calling thread takes part in its loops, so it counts as one of the
+      // threads.
+      for (; worker_count_ + 1 < thread_count; ++worker_count_)
+        thread(&thread_pool::work, this).detach();
+#ifndef _LIBCPP_HAS_NO_EXCEPTIONS
+    } catch (...) {
+      // Run with the workers that could be started.
+    }
+#endif
+  }
+
+  unsigned thread_count() const { return worker_count_ + 1; }
+
+  // Runs all the chunks of `j`, with the help of the idle workers. This is safe
+  // to call from a chunk of another job: the caller only waits for workers that
+  // are running chunks of `j`, and never for a worker to become available.
+  void run(job& j) {
+    {
+      lock_guard<mutex> lock(mutex_);
+      jobs_.push_back(&j);
+    }
+    work_available_.notify_all();
+
+    j.run_chunks();
+
+    unique_lock<mutex> lock(mutex_);
+    remove(j);
+    job_done_.wait(lock, [&] { return j.workers == 0; });
+  }
+
+private:
+  // Called with mutex_ held.
+  void remove(job& j) {
+    auto it = std::find(jobs_.begin(), jobs_.end(), &j);
+    if (it != jobs_.end())
+      jobs_.erase(it);
+  }
+
+  void work() {
+    unique_lock<mutex> lock(mutex_);
+    for (;;) {
+      work_available_.wait(lock, [&] { return !jobs_.empty(); });
+      // Take the most recent job first, so that loops nested in the chunks of
+      // another one finish, and unblock their caller, as soon as possible.
+      job& j = *jobs_.back();
+      ++j.workers;
+      lock.unlock();
+      j.run_chunks();
+      lock.lock();
+      remove(j);
+      if (--j.workers == 0)
+        job_done_.notify_all();
+    }
+  }
+
+  mutex mutex_;
+  condition_variable work_available_;
+  condition_variable job_done_;
+  vector<job*> jobs_;
+  unsigned worker_count_ = 0;
+};
+
+thread_pool& get_thread_pool() {
+  // The workers are never joined, so the pool must outlive static destructors
+  // that may still run parallel algorithms.
+  static thread_pool* pool = new thread_pool;
+  return *pool;
+}
+
+} // namespace
+
+void __dispatch_apply(size_t chunk_count, void* context, void (*func)(void* context, size_t chunk)) noexcept {
+  if (chunk_count <= 1) {
+    for (size_t chunk = 0; chunk != chunk_count; ++chunk)
+      func(context, chunk);
+    return;
+  }
+  job j{context, func, chunk_count};
+  get_thread_pool().run(j);
+}
+
+__chunk_partitions __partition_chunks(ptrdiff_t element_count) noexcept {
+  ptrdiff_t max_chunks = static_cast<ptrdiff_t>(get_thread_pool().thread_count()) * chunks_per_thread;
+  __chunk_partitions partitions;
+  partitions.__chunk_count_ = std::clamp<ptrdiff_t>(element_count / grain_size, 1, max_chunks);
+  partitions.__chunk_size_  = element_count / partitions.__chunk_count_;
+  // The first chunk takes the elements left over by the division.
+  partitions.__first_chunk_size_ = element_count - (partitions.__chunk_count_ - 1) * partitions.__chunk_size_;
+  return partitions;
+}
+
+} // namespace __pstl::__libdispatch
+
+_LIBCPP_END_NAMESPACE_STD
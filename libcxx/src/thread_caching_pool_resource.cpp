@@ -0,0 +1,337 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <experimental/thread_caching_pool_resource>
+#include <memory_resource>
+#include <mutex>
+
+_LIBCPP_BEGIN_NAMESPACE_EXPERIMENTAL
+
+namespace pmr {
+
+// Blocks of up to 1024 bytes are cached, in classes of powers of two starting
+// at 8 bytes. The blocks of a class are taken from and returned to the shared
+// pools with the size of the class, so that they always belong to the same
+// fixed pool regardless of the size they were requested with.
+static constexpr size_t __log2_smallest_cached_block = 3;
+static constexpr int __num_cached_classes            = 8;
+
+// The number of blocks moved between a thread cache and the shared pools at
+// once. A cache holds at most twice as many blocks of a class.
+static constexpr size_t __batch_size = 32;
+
+// The number of resources a thread caches blocks for. Using more resources
+// from one thread evicts the caches of the others.
+static constexpr int __max_cached_resources = 4;
+
+static size_t __class_block_size(int __class) { return size_t(1) << (__class + __log2_smallest_cached_block); }
+
+// Returns the class of the blocks used for the request, or -1 if it isn't cached.
+static int __cached_class(size_t __bytes, size_t __align) {
+  if (__align > alignof(std::max_align_t))
+    return -1;
+  size_t __size = __bytes > __align ? __bytes : __align;
+  int __class   = 0;
+  while (__class_block_size(__class) < __size) {
+    if (++__class == __num_cached_classes)
+      return -1;
+  }
+  return __class;
+}
+
+class thread_caching_pool_resource::__impl {
+  struct __free_block {
+    __free_block* __next_;
+  };
+
+  // The blocks a thread caches for one resource. Resources are identified by
+  // a unique id rather than by address, since a destroyed resource may leave
+  // entries behind in the caches of other threads.
+  struct __cache_entry {
+    uint64_t __id_         = 0;
+    uint64_t __generation_ = 0;
+    uint64_t __hits_       = 0;
+    __free_block* __blocks_[__num_cached_classes]{};
+    size_t __counts_[__num_cached_classes]{};
+
+    void __reset(uint64_t __id, uint64_t __generation) {
+      *this         = __cache_entry();
+      __id_         = __id;
+      __generation_ = __generation;
+    }
+  };
+
+  struct __thread_cache {
+    __cache_entry __entries_[__max_cached_resources];
+    int __next_victim_ = 0;
+
+    ~__thread_cache() {
+      for (__cache_entry& __entry : __entries_)
+        __impl::__flush_entry(__entry);
+      __thread_cache_destroyed_ = true;
+    }
+  };
+
+  // Set when the cache of the thread is destroyed. The order in which the
+  // thread_local objects of a thread are destroyed is unspecified, so others
+  // may still use a resource from their destructor after it. This flag is
+  // trivially destructible, so it remains usable until the thread exits.
+  static thread_local bool __thread_cache_destroyed_;
+
+  // Returns the cache of the calling thread, or nullptr if it was destroyed.
+  static __thread_cache* __this_thread_cache() {
+    if (__thread_cache_destroyed_)
+      return nullptr;
+    static thread_local __thread_cache __cache;
+    return &__cache;
+  }
+
+  // The live resources, so that caches of exiting threads or evicted caches
+  // are only returned to resources which still exist.
+  static std::mutex __registry_mutex_;
+  static __impl* __registry_head_;
+  static std::atomic<uint64_t> __next_id_;
+
+  __impl* __prev_ = nullptr;
+  __impl* __next_ = nullptr;
+  const uint64_t __id_;
+  int __num_classes_;
+
+  std::mutex __mutex_;
+  std::pmr::unsynchronized_pool_resource __pool_;
+  // Incremented by release(), which frees the blocks held in the caches.
+  std::atomic<uint64_t> __generation_{0};
+
+  std::atomic<uint64_t> __hits_{0};
+  std::atomic<uint64_t> __misses_{0};
+  std::atomic<uint64_t> __batches_returned_{0};
+  std::atomic<uint64_t> __uncached_{0};
+
+  // Returns all the blocks of __entry to the shared pools. The caller holds
+  // __mutex_.
+  void __return_entry(__cache_entry& __entry) {
+    __hits_.fetch_add(__entry.__hits_, std::memory_order_relaxed);
+    if (__entry.__generation_ != __generation_.load(std::memory_order_relaxed))
+      return;
+    for (int __class = 0; __class != __num_classes_; ++__class) {
+      for (__free_block* __b = __entry.__blocks_[__class]; __b != nullptr;) {
+        __free_block* __next = __b->__next_;
+        __pool_.deallocate(__b, __class_block_size(__class), 1);
+        __b = __next;
+      }
+    }
+  }
+
+  static void __flush_entry(__cache_entry& __entry) {
+    if (__entry.__id_ == 0)
+      return;
+    std::lock_guard<std::mutex> __registry_guard(__registry_mutex_);
+    for (__impl* __r = __registry_head_; __r != nullptr; __r = __r->__next_) {
+      if (__r->__id_ == __entry.__id_) {
+        std::lock_guard<std::mutex> __guard(__r->__mutex_);
+        __r->__return_entry(__entry);
+        break;
+      }
+    }
+    __entry = __cache_entry();
+  }
+
+  // Returns the entry of the calling thread for this resource, or nullptr if
+  // the thread no longer has a cache.
+  __cache_entry* __this_thread_entry() {
+    __thread_cache* __cache_ptr = __this_thread_cache();
+    if (__cache_ptr == nullptr)
+      return nullptr;
+    __thread_cache& __cache = *__cache_ptr;
+    uint64_t __generation   = __generation_.load(std::memory_order_relaxed);
+    for (__cache_entry& __entry : __cache.__entries_) {
+      if (__entry.__id_ == __id_) {
+        if (__entry.__generation_ != __generation) {
+          // The blocks were freed by release().
+          __hits_.fetch_add(__entry.__hits_, std::memory_order_relaxed);
+          __entry.__reset(__id_, __generation);
+        }
+        return &__entry;
+      }
+    }
+
+    __cache_entry* __free_entry = nullptr;
+    for (__cache_entry& __entry : __cache.__entries_) {
+      if (__entry.__id_ == 0) {
+        __free_entry = &__entry;
+        break;
+      }
+    }
+    if (__free_entry == nullptr) {
+      __free_entry           = &__cache.__entries_[__cache.__next_victim_];
+      __cache.__next_victim_ = (__cache.__next_victim_ + 1) % __max_cached_resources;
+      __flush_entry(*__free_entry);
+    }
+    __free_entry->__reset(__id_, __generation);
+    return __free_entry;
+  }
+
+public:
+  __impl(const std::pmr::pool_options& __opts, std::pmr::memory_resource* __upstream)
+      : __id_(__next_id_.fetch_add(1, std::memory_order_relaxed)), __pool_(__opts, __upstream) {
+    // Only cache the classes which are served by the fixed pools.
+    size_t __largest = __pool_.options().largest_required_pool_block;
+    __num_classes_   = 0;
+    while (__num_classes_ != __num_cached_classes && __class_block_size(__num_classes_) <= __largest)
+      ++__num_classes_;
+
+    std::lock_guard<std::mutex> __registry_guard(__registry_mutex_);
+    __next_ = __registry_head_;
+    if (__next_ != nullptr)
+      __next_->__prev_ = this;
+    __registry_head_ = this;
+  }
+
+  ~__impl() {
+    std::lock_guard<std::mutex> __registry_guard(__registry_mutex_);
+    if (__prev_ != nullptr)
+      __prev_->__next_ = __next_;
+    else
+      __registry_head_ = __next_;
+    if (__next_ != nullptr)
+      __next_->__prev_ = __prev_;
+  }
+
+  void* __allocate(size_t __bytes, size_t __align) {
+    int __class = __cached_class(__bytes, __align);
+    if (__class < 0 || __class >= __num_classes_) {
+      __uncached_.fetch_add(1, std::memory_order_relaxed);
+      std::lock_guard<std::mutex> __guard(__mutex_);
+      return __pool_.allocate(__bytes, __align);
+    }
+
+    __cache_entry* __entry_ptr = __this_thread_entry();
+    if (__entry_ptr == nullptr) {
+      // Blocks of a cached class always come from the pool of the class.
+      __uncached_.fetch_add(1, std::memory_order_relaxed);
+      std::lock_guard<std::mutex> __guard(__mutex_);
+      return __pool_.allocate(__class_block_size(__class), 1);
+    }
+
+    __cache_entry& __entry = *__entry_ptr;
+    if (__free_block* __b = __entry.__blocks_[__class]) {
+      __entry.__blocks_[__class] = __b->__next_;
+      --__entry.__counts_[__class];
+      ++__entry.__hits_;
+      return __b;
+    }
+
+    // Refill the cache with a batch of blocks, and hand out the last one.
+    __misses_.fetch_add(1, std::memory_order_relaxed);
+    __hits_.fetch_add(__entry.__hits_, std::memory_order_relaxed);
+    __entry.__hits_ = 0;
+    const size_t __block_size = __class_block_size(__class);
+    std::lock_guard<std::mutex> __guard(__mutex_);
+    for (size_t __i = 1; __i != __batch_size; ++__i) {
+      __free_block* __b          = static_cast<__free_block*>(__pool_.allocate(__block_size, 1));
+      __b->__next_               = __entry.__blocks_[__class];
+      __entry.__blocks_[__class] = __b;
+      ++__entry.__counts_[__class];
+    }
+    return __pool_.allocate(__block_size, 1);
+  }
+
+  void __deallocate(void* __p, size_t __bytes, size_t __align) {
+    int __class = __cached_class(__bytes, __align);
+    if (__class < 0 || __class >= __num_classes_) {
+      std::lock_guard<std::mutex> __guard(__mutex_);
+      __pool_.deallocate(__p, __bytes, __align);
+      return;
+    }
+
+    __cache_entry* __entry_ptr = __this_thread_entry();
+    if (__entry_ptr == nullptr) {
+      std::lock_guard<std::mutex> __guard(__mutex_);
+      __pool_.deallocate(__p, __class_block_size(__class), 1);
+      return;
+    }
+
+    __cache_entry& __entry     = *__entry_ptr;
+    __free_block* __b          = static_cast<__free_block*>(__p);
+    __b->__next_               = __entry.__blocks_[__class];
+    __entry.__blocks_[__class] = __b;
+    if (++__entry.__counts_[__class] <= 2 * __batch_size)
+      return;
+
+    // Give a batch back, so that blocks freed by another thread than the one
+    // which allocated them don't pile up in the cache.
+    __batches_returned_.fetch_add(1, std::memory_order_relaxed);
+    const size_t __block_size = __class_block_size(__class);
+    std::lock_guard<std::mutex> __guard(__mutex_);
+    for (size_t __i = 0; __i != __batch_size; ++__i) {
+      __free_block* __next = __entry.__blocks_[__class]->__next_;
+      __pool_.deallocate(__entry.__blocks_[__class], __block_size, 1);
+      __entry.__blocks_[__class] = __next;
+    }
+    __entry.__counts_[__class] -= __batch_size;
+  }
+
+  void __release() {
+    std::lock_guard<std::mutex> __guard(__mutex_);
+    __generation_.fetch_add(1, std::memory_order_relaxed);
+    __pool_.release();
+  }
+
+  std::pmr::memory_resource* __upstream_resource() const { return __pool_.upstream_resource(); }
+
+  std::pmr::pool_options __options() const { return __pool_.options(); }
+
+  pool_stats __stats() const {
+    pool_stats __s;
+    __s.cache_hits       = __hits_.load(std::memory_order_relaxed);
+    __s.cache_misses     = __misses_.load(std::memory_order_relaxed);
+    __s.batches_returned = __batches_returned_.load(std::memory_order_relaxed);
+    __s.uncached         = __uncached_.load(std::memory_order_relaxed);
+    return __s;
+  }
+};
+
+constinit std::mutex thread_caching_pool_resource::__impl::__registry_mutex_;
+constinit thread_caching_pool_resource::__impl* thread_caching_pool_resource::__impl::__registry_head_ = nullptr;
+constinit std::atomic<uint64_t> thread_caching_pool_resource::__impl::__next_id_{1};
+constinit thread_local bool thread_caching_pool_resource::__impl::__thread_cache_destroyed_ = false;
+
+thread_caching_pool_resource::thread_caching_pool_resource(
+    const std::pmr::pool_options& __opts, std::pmr::memory_resource* __upstream)
+    : __impl_(new __impl(__opts, __upstream)) {}
+
+thread_caching_pool_resource::~thread_caching_pool_resource() { delete __impl_; }
+
+void thread_caching_pool_resource::release() { __impl_->__release(); }
+
+std::pmr::memory_resource* thread_caching_pool_resource::upstream_resource() const {
+  return __impl_->__upstream_resource();
+}
+
+std::pmr::pool_options thread_caching_pool_resource::options() const { return __impl_->__options(); }
+
+thread_caching_pool_resource::pool_stats thread_caching_pool_resource::stats() const { return __impl_->__stats(); }
+
+void* thread_caching_pool_resource::do_allocate(size_t __bytes, size_t __align) {
+  return __impl_->__allocate(__bytes, __align);
+}
+
+void thread_caching_pool_resource::do_deallocate(void* __p, size_t __bytes, size_t __align) {
+  __impl_->__deallocate(__p, __bytes, __align);
+}
+
+bool thread_caching_pool_resource::do_is_equal(const std::pmr::memory_resource& __other) const noexcept {
+  return &__other == this;
+}
+
+} // namespace pmr
+
+_LIBCPP_END_NAMESPACE_EXPERIMENTAL
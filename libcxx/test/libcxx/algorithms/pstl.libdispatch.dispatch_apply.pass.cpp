@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14
+
+// UNSUPPORTED: libcpp-has-no-incomplete-pstl
+
+// REQUIRES: libcpp-pstl-backend-libdispatch
+
+// void __dispatch_apply(size_t, void*, void (*)(void*, size_t)) noexcept;
+// __chunk_partitions __partition_chunks(ptrdiff_t) noexcept;
+
+// Check the library entry points of the libdispatch backend, which are either
+// provided by libdispatch or by the thread_pool backend. Every chunk must run
+// exactly once, including when a loop is started from a chunk of another one,
+// and the partitions must cover all the elements.
+
+#include <__pstl/backends/libdispatch.h>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "test_macros.h"
+
+namespace libdispatch = std::__pstl::__libdispatch;
+
+struct Counters {
+  std::vector<std::atomic<int>> runs;
+
+  explicit Counters(std::size_t n) : runs(n) {}
+
+  void check() {
+    for (auto& run : runs)
+      assert(run.load() == 1);
+  }
+};
+
+void count_chunk(void* context, std::size_t chunk) { ++static_cast<Counters*>(context)->runs[chunk]; }
+
+constexpr std::size_t outer_chunks = 64;
+constexpr std::size_t inner_chunks = 32;
+
+void run_nested_loop(void* context, std::size_t chunk) {
+  Counters inner(inner_chunks);
+  libdispatch::__dispatch_apply(inner_chunks, &inner, count_chunk);
+  inner.check();
+  ++static_cast<Counters*>(context)->runs[chunk];
+}
+
+void test_partitions(std::ptrdiff_t element_count) {
+  auto partitions = libdispatch::__partition_chunks(element_count);
+  assert(partitions.__chunk_count_ >= 1);
+  assert(partitions.__first_chunk_size_ >= partitions.__chunk_size_);
+  assert(partitions.__first_chunk_size_ + (partitions.__chunk_count_ - 1) * partitions.__chunk_size_ == element_count);
+}
+
+int main(int, char**) {
+  for (std::size_t chunk_count : {0, 1, 2, 7, 100, 10000}) {
+    Counters counters(chunk_count);
+    libdispatch::__dispatch_apply(chunk_count, &counters, count_chunk);
+    counters.check();
+  }
+
+  {
+    Counters outer(outer_chunks);
+    libdispatch::__dispatch_apply(outer_chunks, &outer, run_nested_loop);
+    outer.check();
+  }
+
+  for (std::ptrdiff_t element_count : {0, 1, 255, 256, 257, 1000, 100000, 10000000})
+    test_partitions(element_count);
+
+  return 0;
+}
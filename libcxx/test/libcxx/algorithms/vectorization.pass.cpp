@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03
+
+// Check that the vectorized implementations of std::find, std::count,
+// std::min_element and std::max_element return the same results as the naive
+// loops, for all the range sizes around the vector width and all the
+// positions of the searched elements.
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "test_macros.h"
+
+template <class T>
+void test_type() {
+  for (std::size_t size = 0; size != 140; ++size) {
+    std::vector<T> v(size);
+    for (std::size_t i = 0; i != size; ++i)
+      v[i] = static_cast<T>(i % 7 + 10);
+
+    for (std::size_t pos = 0; pos != size; ++pos) {
+      std::vector<T> w = v;
+      w[pos]           = static_cast<T>(3);
+      assert(std::find(w.begin(), w.end(), static_cast<T>(3)) == w.begin() + pos);
+      assert(std::find(w.data(), w.data() + size, static_cast<T>(3)) == w.data() + pos);
+      assert(std::count(w.begin(), w.end(), static_cast<T>(3)) == 1);
+      assert(std::min_element(w.begin(), w.end()) == w.begin() + pos);
+
+      // Put the same extremum twice, the first one has to be returned
+      w[pos] = static_cast<T>(100);
+      if (pos + 1 != size)
+        w[size - 1] = static_cast<T>(100);
+      assert(std::max_element(w.begin(), w.end()) == w.begin() + pos);
+      assert(std::find(w.begin(), w.end(), static_cast<T>(3)) == w.end());
+    }
+
+    std::ptrdiff_t expected = 0;
+    for (std::size_t i = 0; i != size; ++i)
+      expected += v[i] == static_cast<T>(12);
+    assert(std::count(v.begin(), v.end(), static_cast<T>(12)) == expected);
+    assert(std::count(v.data(), v.data() + size, static_cast<T>(12)) == expected);
+  }
+
+  const T values[] = {static_cast<T>(5), static_cast<T>(2), static_cast<T>(9), static_cast<T>(2), static_cast<T>(9)};
+  assert(std::min_element(std::begin(values), std::end(values)) == values + 1);
+  assert(std::max_element(std::begin(values), std::end(values)) == values + 2);
+}
+
+template <class T>
+TEST_CONSTEXPR_CXX20 bool test_constexpr() {
+  T values[] = {4, 1, 7, 1, 7, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3};
+  T* last   = values + sizeof(values) / sizeof(values[0]);
+  assert(std::find(values, last, T(7)) == values + 2);
+  assert(std::count(values, last, T(3)) == 28);
+  assert(std::min_element(values, last) == values + 1);
+  assert(std::max_element(values, last) == values + 2);
+  return true;
+}
+
+int main(int, char**) {
+  test_type<char>();
+  test_type<signed char>();
+  test_type<unsigned char>();
+  test_type<short>();
+  test_type<unsigned short>();
+  test_type<int>();
+  test_type<unsigned>();
+  test_type<long long>();
+  test_type<unsigned long long>();
+  test_type<std::int64_t>();
+
+  test_constexpr<short>();
+  test_constexpr<int>();
+  test_constexpr<long long>();
+#if TEST_STD_VER >= 20
+  static_assert(test_constexpr<short>());
+  static_assert(test_constexpr<int>());
+  static_assert(test_constexpr<long long>());
+#endif
+
+  return 0;
+}
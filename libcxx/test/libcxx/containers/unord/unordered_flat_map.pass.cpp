@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14
+// REQUIRES: c++experimental
+
+// <experimental/unordered_flat_map>
+
+// Check the libc++ unordered_flat_map extension: lookups across probe groups,
+// erasure with tombstones, growth and in-place rehashes.
+
+#include <experimental/unordered_flat_map>
+#include <cassert>
+#include <cstddef>
+#include <string>
+
+#include "test_macros.h"
+
+// Sends all the keys to the same first group, so that probing has to go past
+// full groups and deleted slots.
+struct BadHash {
+  std::size_t operator()(int) const { return 0; }
+};
+
+template <class Map>
+void check_contents(const Map& m, int first, int last) {
+  assert(m.size() == static_cast<std::size_t>(last - first));
+  for (int i = first; i != last; ++i) {
+    auto it = m.find(i);
+    assert(it != m.end());
+    assert(it->first == i);
+    assert(it->second == i * 2);
+  }
+  assert(m.find(last) == m.end());
+  std::size_t n = 0;
+  for (const auto& v : m) {
+    assert(v.first >= first && v.first < last);
+    ++n;
+  }
+  assert(n == m.size());
+}
+
+template <class Hash>
+void test_int_keys() {
+  using Map = std::experimental::unordered_flat_map<int, int, Hash>;
+  Map m;
+  assert(m.empty());
+  assert(m.find(0) == m.end());
+  assert(m.begin() == m.end());
+  assert(m.erase(0) == 0);
+
+  for (int i = 0; i != 1000; ++i) {
+    auto r = m.insert({i, i * 2});
+    assert(r.second);
+    assert(r.first->first == i);
+  }
+  check_contents(m, 0, 1000);
+  assert(!m.insert({5, 0}).second);
+  assert(m.at(5) == 10);
+  assert(m.load_factor() <= m.max_load_factor());
+
+  // Erase and insert many times, so that the table has to be rehashed in place
+  // to get rid of the deleted slots.
+  for (int round = 0; round != 10; ++round) {
+    for (int i = 0; i != 500; ++i)
+      assert(m.erase(i + round * 500) == 1);
+    for (int i = 0; i != 500; ++i)
+      assert(m.try_emplace(i + (round + 2) * 500, (i + (round + 2) * 500) * 2).second);
+    check_contents(m, (round + 1) * 500, (round + 3) * 500);
+  }
+
+  for (auto it = m.begin(); it != m.end();)
+    it = m.erase(it);
+  assert(m.empty());
+  assert(m.begin() == m.end());
+}
+
+void test_string_keys() {
+  using Map = std::experimental::unordered_flat_map<std::string, std::string>;
+  Map m{{"a", "1"}, {"b", "2"}};
+  m["c"] = "3";
+  assert(m.insert_or_assign("a", "4").second == false);
+  assert(m.emplace("d", "5").second);
+  assert(m.size() == 4);
+  assert(m.at("a") == "4");
+  assert(m.count("c") == 1);
+  assert(m.contains("d"));
+  assert(!m.contains("e"));
+
+  Map copy = m;
+  assert(copy == m);
+  copy.erase("a");
+  assert(copy != m);
+
+  Map moved = std::move(copy);
+  assert(moved.size() == 3);
+  assert(copy.empty());
+  copy.swap(moved);
+  assert(copy.size() == 3 && moved.empty());
+
+  m.reserve(1000);
+  assert(m.size() == 4 && m.at("b") == "2");
+  m.clear();
+  assert(m.empty());
+  m.rehash(0);
+  assert(m.find("a") == m.end());
+
+#ifndef TEST_HAS_NO_EXCEPTIONS
+  try {
+    (void)m.at("a");
+    assert(false);
+  } catch (const std::out_of_range&) {
+  }
+#endif
+}
+
+int main(int, char**) {
+  test_int_keys<std::hash<int>>();
+  test_int_keys<BadHash>();
+  test_string_keys();
+
+  return 0;
+}
@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14
+// UNSUPPORTED: no-threads
+// REQUIRES: c++experimental
+
+// <experimental/thread_caching_pool_resource>
+
+// Check that blocks are served by the thread caches, that they can be freed by
+// another thread than the one which allocated them, and that release() and
+// the destruction of a resource don't leave dangling blocks in the caches.
+// Also check that a resource can still be used by a thread_local object which
+// is destroyed after the cache of its thread.
+
+#include <experimental/thread_caching_pool_resource>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+#include "test_macros.h"
+
+using Resource = std::experimental::pmr::thread_caching_pool_resource;
+
+struct Block {
+  void* p;
+  std::size_t size;
+};
+
+void allocate_blocks(Resource& r, std::vector<Block>& blocks, int count) {
+  for (int i = 0; i != count; ++i) {
+    std::size_t size = 1 + static_cast<std::size_t>(i * 37) % 2000;
+    void* p          = r.allocate(size, 8);
+    std::memset(p, i & 0xff, size);
+    blocks.push_back({p, size});
+  }
+}
+
+void test_threads() {
+  Resource r;
+  assert(r.upstream_resource() == std::pmr::get_default_resource());
+
+  std::vector<Block> blocks[4];
+  std::vector<std::thread> threads;
+  for (auto& b : blocks)
+    threads.emplace_back([&r, &b] { allocate_blocks(r, b, 1000); });
+  for (auto& t : threads)
+    t.join();
+  threads.clear();
+
+  // Free the blocks from other threads than the ones which allocated them.
+  for (int i = 0; i != 4; ++i)
+    threads.emplace_back([&r, &b = blocks[(i + 1) % 4]] {
+      for (const Block& block : b)
+        r.deallocate(block.p, block.size, 8);
+    });
+  for (auto& t : threads)
+    t.join();
+
+  Resource::pool_stats stats = r.stats();
+  assert(stats.cache_misses > 0);
+  assert(stats.uncached > 0);
+  assert(stats.batches_returned > 0);
+}
+
+void test_release() {
+  Resource r;
+  std::vector<Block> blocks;
+  allocate_blocks(r, blocks, 100);
+  for (const Block& block : blocks)
+    r.deallocate(block.p, block.size, 8);
+  r.release();
+
+  // The blocks cached by this thread were freed by release().
+  blocks.clear();
+  allocate_blocks(r, blocks, 100);
+  for (const Block& block : blocks)
+    r.deallocate(block.p, block.size, 8);
+  assert(r.stats().cache_hits > 0);
+}
+
+void test_many_resources() {
+  // Use more resources than a thread caches, and destroy some of them while
+  // the thread still caches their blocks.
+  std::vector<Resource*> resources;
+  for (int i = 0; i != 10; ++i) {
+    resources.push_back(new Resource);
+    void* p = resources.back()->allocate(32, 8);
+    resources.back()->deallocate(p, 32, 8);
+    if (i % 2 == 0) {
+      delete resources.back();
+      resources.pop_back();
+    }
+  }
+  for (Resource* r : resources) {
+    void* p = r->allocate(64, 16);
+    r->deallocate(p, 64, 16);
+    delete r;
+  }
+}
+
+struct ThreadLocalVector {
+  std::pmr::vector<int>* v = nullptr;
+
+  ~ThreadLocalVector() {
+    // The cache of the thread was destroyed before this object.
+    for (int i = 0; i != 100; ++i)
+      v->push_back(i);
+    delete v;
+  }
+};
+
+void test_thread_exit() {
+  Resource r;
+  std::thread([&r] {
+    // Constructed before the cache of the thread, which is created by the
+    // first allocation, so destroyed after it.
+    static thread_local ThreadLocalVector holder;
+    holder.v = new std::pmr::vector<int>(&r);
+    for (int i = 0; i != 100; ++i)
+      holder.v->push_back(i);
+  }).join();
+  assert(r.stats().uncached > 0);
+}
+
+int main(int, char**) {
+  test_threads();
+  test_release();
+  test_many_resources();
+  test_thread_exit();
+
+  Resource r;
+  std::pmr::vector<int> v(&r);
+  for (int i = 0; i != 1000; ++i)
+    v.push_back(i);
+
+  return 0;
+}
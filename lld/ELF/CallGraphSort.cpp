@@ -20,14 +20,19 @@
 /// https://research.fb.com/wp-content/uploads/2017/01/cgo2017-hfsort-final1.pdf
 /// - a more advanced one, referred to as Cache-Directed-Sort (CDSort), which
 ///   typically produces layouts with higher locality, and hence, yields fewer
-///   instruction cache misses on large binaries.
+///   instruction cache misses on large binaries. The modeled i-TLB geometry is
+///   set with --call-graph-profile-cache-{entries,size}.
+/// - the Extended-TSP (ExtTSP) algorithm, which is normally used for basic
+///   block placement and here treats every input section as a node.
 //===----------------------------------------------------------------------===//
 
 #include "CallGraphSort.h"
 #include "InputFiles.h"
 #include "InputSection.h"
 #include "Symbols.h"
+#include "lld/Common/ErrorHandler.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Transforms/Utils/CodeLayout.h"
 
 #include <numeric>
@@ -271,10 +276,10 @@ DenseMap<const InputSectionBase *, int> CallGraphSort::run() {
   return orderMap;
 }
 
-// Sort sections by the profile data using the Cache-Directed Sort algorithm.
-// The placement is done by optimizing the locality by co-locating frequently
-// executed code sections together.
-DenseMap<const InputSectionBase *, int> elf::computeCacheDirectedSortOrder() {
+// Sort sections by the profile data using the Cache-Directed Sort or the
+// Extended-TSP algorithm. The placement is done by optimizing the locality by
+// co-locating frequently executed code sections together.
+DenseMap<const InputSectionBase *, int> elf::computeCodeLayoutSortOrder() {
   SmallVector<uint64_t, 0> funcSizes;
   SmallVector<uint64_t, 0> funcCounts;
   SmallVector<codelayout::EdgeCount, 0> callCounts;
@@ -320,8 +325,35 @@ DenseMap<const InputSectionBase *, int> elf::computeCacheDirectedSortOrder() {
   }
 
   // Run the layout algorithm.
-  std::vector<uint64_t> sortedSections = codelayout::computeCacheDirectedLayout(
-      funcSizes, funcCounts, callCounts, callOffsets);
+  std::vector<uint64_t> sortedSections;
+  if (config->callGraphProfileSort == CGProfileSortKind::Exttsp) {
+    sortedSections =
+        codelayout::computeExtTspLayout(funcSizes, funcCounts, callCounts);
+  } else {
+    codelayout::CDSortConfig cdsConfig;
+    cdsConfig.CacheEntries = config->callGraphProfileCacheEntries;
+    cdsConfig.CacheSize = config->callGraphProfileCacheSize;
+    sortedSections = codelayout::computeCacheDirectedLayout(
+        cdsConfig, funcSizes, funcCounts, callCounts, callOffsets);
+  }
+
+  // Report the estimated locality gain. The ExtTSP score is anti-correlated
+  // with the number of i-cache misses, so compare the score of the new layout
+  // against the order in which the sections were first seen.
+  if (errorHandler().verbose && !sections.empty()) {
+    double before =
+        codelayout::calcExtTspScore(funcSizes, funcCounts, callCounts);
+    double after = codelayout::calcExtTspScore(sortedSections, funcSizes,
+                                               funcCounts, callCounts);
+    std::string msg;
+    raw_string_ostream os(msg);
+    os << "call graph profile: laid out " << sections.size()
+       << " sections, ExtTSP score " << format("%.1f", before) << " -> "
+       << format("%.1f", after);
+    if (before > 0)
+      os << " (" << format("%+.1f%%", (after - before) / before * 100) << ")";
+    log(os.str());
+  }
 
   // Create the final order.
   DenseMap<const InputSectionBase *, int> orderMap;
@@ -335,9 +367,10 @@ DenseMap<const InputSectionBase *, int> elf::computeCacheDirectedSortOrder() {
 // Sort sections by the profile data provided by --callgraph-profile-file.
 //
 // This first builds a call graph based on the profile data then merges sections
-// according either to the C³ or Cache-Directed-Sort ordering algorithm.
+// according to the C³, Cache-Directed-Sort or ExtTSP ordering algorithm.
 DenseMap<const InputSectionBase *, int> elf::computeCallGraphProfileOrder() {
-  if (config->callGraphProfileSort == CGProfileSortKind::Cdsort)
-    return computeCacheDirectedSortOrder();
+  if (config->callGraphProfileSort == CGProfileSortKind::Cdsort ||
+      config->callGraphProfileSort == CGProfileSortKind::Exttsp)
+    return computeCodeLayoutSortOrder();
   return CallGraphSort().run();
 }
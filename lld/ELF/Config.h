@@ -59,8 +59,8 @@ enum class BsymbolicKind { None, NonWeakFunctions, Functions, NonWeak, All };
 // For --build-id.
 enum class BuildIdKind { None, Fast, Md5, Sha1, Hexstring, Uuid };
 
-// For --call-graph-profile-sort={none,hfsort,cdsort}.
-enum class CGProfileSortKind { None, Hfsort, Cdsort };
+// For --call-graph-profile-sort={none,hfsort,cdsort,exttsp}.
+enum class CGProfileSortKind { None, Hfsort, Cdsort, Exttsp };
 
 // For --discard-{all,locals,none}.
 enum class DiscardPolicy { Default, All, Locals, None };
@@ -221,6 +221,8 @@ struct Config {
   bool armBe8 = false;
   BsymbolicKind bsymbolic = BsymbolicKind::None;
   CGProfileSortKind callGraphProfileSort;
+  uint32_t callGraphProfileCacheEntries;
+  uint32_t callGraphProfileCacheSize;
   bool checkSections;
   bool checkDynamicRelocs;
   std::optional<llvm::DebugCompressionType> compressDebugSections;
@@ -251,6 +253,8 @@ struct Config {
   bool hasDynSymTab;
   bool ignoreDataAddressEquality;
   bool ignoreFunctionAddressEquality;
+  bool incremental;
+  bool leanMemory;
   bool ltoCSProfileGenerate;
   bool ltoPGOWarnMismatch;
   bool ltoDebugPassManager;
@@ -286,6 +290,7 @@ struct Config {
   llvm::SmallVector<std::pair<llvm::GlobPattern, uint32_t>, 0> shuffleSections;
   bool singleRoRx;
   bool shared;
+  bool streamOutput;
   bool symbolic;
   bool isStatic = false;
   bool sysvHash = false;
@@ -481,6 +486,9 @@ struct Ctx {
                  std::pair<const InputFile *, const InputFile *>>
       backwardReferences;
   llvm::SmallSet<llvm::StringRef, 0> auxiliaryFiles;
+  // Paths that were looked up while searching for input files but did not
+  // exist. Used by --incremental.
+  llvm::SetVector<llvm::CachedHashString> missingFiles;
   // InputFile for linker created symbols with no source location.
   InputFile *internalFile;
   // True if SHT_LLVM_SYMPART is used.
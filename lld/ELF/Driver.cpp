@@ -55,6 +55,7 @@
 #include "llvm/Object/Archive.h"
 #include "llvm/Object/IRObjectFile.h"
 #include "llvm/Remarks/HotnessThresholdParser.h"
+#include "llvm/Support/BLAKE3.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/FileSystem.h"
@@ -106,6 +107,7 @@ void Ctx::reset() {
   whyExtractRecords.clear();
   backwardReferences.clear();
   auxiliaryFiles.clear();
+  missingFiles.clear();
   internalFile = nullptr;
   hasSympart.store(false, std::memory_order_relaxed);
   hasTlsIe.store(false, std::memory_order_relaxed);
@@ -576,6 +578,108 @@ constexpr const char *saveTempsValues[] = {
     "resolution", "preopt",     "promote", "internalize",  "import",
     "opt",        "precodegen", "prelink", "combinedindex"};
 
+// --incremental records what a link depended on next to the output: a digest
+// of the linker version, the working directory and the command line, the size
+// and modification time of the output, a hash of every file that was read and
+// the search path candidates that did not exist. The next --incremental link
+// checks all of that before loading any input. If nothing changed and the
+// output is still the file we wrote, there is nothing to do. Otherwise we fall
+// back to a full link, which refreshes the state.
+static std::string getIncrementalStatePath() {
+  return config->outputFile.str() + ".lld-incremental";
+}
+
+static std::string hashIncrementalInput(StringRef contents) {
+  return toHex(BLAKE3::hash(arrayRefFromStringRef(contents)));
+}
+
+static std::string computeCommandDigest(opt::InputArgList &args) {
+  BLAKE3 hasher;
+  // Prefix each string with its size so that concatenations stay distinct.
+  auto add = [&](StringRef s) {
+    uint8_t size[8];
+    write64le(size, s.size());
+    hasher.update(ArrayRef(size));
+    hasher.update(s);
+  };
+  add(getLLDVersion());
+  SmallString<128> cwd;
+  if (!sys::fs::current_path(cwd))
+    add(cwd);
+  for (const opt::Arg *arg : args)
+    add(arg->getAsString(args));
+  return toHex(hasher.final());
+}
+
+// The size and modification time of the output tell us whether somebody else
+// has replaced it since the last link.
+static std::optional<std::string> getOutputStamp() {
+  sys::fs::file_status st;
+  if (sys::fs::status(config->outputFile, st) ||
+      !sys::fs::is_regular_file(st))
+    return std::nullopt;
+  return (Twine(st.getSize()) + " " +
+          Twine(st.getLastModificationTime().time_since_epoch().count()))
+      .str();
+}
+
+// The state file holds one record per line: the command digest, the output
+// stamp, then "file <hash> <path>" for every file read and "missing <path>"
+// for every candidate that did not exist.
+static bool isIncrementalOutputUpToDate(opt::InputArgList &args) {
+  llvm::TimeTraceScope timeScope("Check incremental state");
+  auto mbOrErr = MemoryBuffer::getFile(getIncrementalStatePath());
+  if (!mbOrErr)
+    return false;
+  SmallVector<StringRef, 0> lines;
+  (*mbOrErr)->getBuffer().split(lines, '\n', -1, /*KeepEmpty=*/false);
+  std::optional<std::string> stamp = getOutputStamp();
+  if (lines.size() < 2 || lines[0] != computeCommandDigest(args) || !stamp ||
+      lines[1] != *stamp)
+    return false;
+  for (StringRef line : ArrayRef(lines).drop_front(2)) {
+    auto [kind, rest] = line.split(' ');
+    if (kind == "missing") {
+      if (sys::fs::exists(rest))
+        return false;
+    } else if (kind == "file") {
+      auto [hash, path] = rest.split(' ');
+      auto fileOrErr = MemoryBuffer::getFile(path, /*IsText=*/false,
+                                             /*RequiresNullTerminator=*/false);
+      if (!fileOrErr || hashIncrementalInput((*fileOrErr)->getBuffer()) != hash)
+        return false;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void writeIncrementalState(opt::InputArgList &args) {
+  std::string path = getIncrementalStatePath();
+  std::optional<std::string> stamp = getOutputStamp();
+  if (!stamp) {
+    sys::fs::remove(path);
+    return;
+  }
+  std::error_code ec;
+  raw_fd_ostream os(path, ec, sys::fs::OF_None);
+  if (ec) {
+    warn("--incremental: cannot write " + path + ": " + ec.message());
+    return;
+  }
+  os << computeCommandDigest(args) << '\n' << *stamp << '\n';
+  // Every file read, including linker scripts, version scripts, archives,
+  // thin archive members and files read during the link such as the call
+  // graph ordering file. Hash the contents that were used, not the files as
+  // they are now.
+  for (const std::unique_ptr<MemoryBuffer> &mb : ctx.memoryBuffers)
+    os << "file " << hashIncrementalInput(mb->getBuffer()) << ' '
+       << mb->getBufferIdentifier() << '\n';
+  for (const CachedHashString &missing : ctx.missingFiles)
+    os << "missing " << missing.val() << '\n';
+}
+
 void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
   ELFOptTable parser;
   opt::InputArgList args = parser.parse(argsArr.slice(1));
@@ -644,6 +748,11 @@ void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
   {
     llvm::TimeTraceScope timeScope("ExecuteLinker");
 
+    if (config->incremental && isIncrementalOutputUpToDate(args)) {
+      log("--incremental: " + config->outputFile + " is up to date");
+      return;
+    }
+
     initLLVM();
     createFiles(args);
     if (errorCount())
@@ -656,6 +765,9 @@ void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
       return;
 
     invokeELFT(link, args);
+
+    if (config->incremental && !errorCount())
+      writeIncrementalState(args);
   }
 
   if (config->timeTraceEnabled) {
@@ -1083,6 +1195,8 @@ static CGProfileSortKind getCGProfileSortKind(opt::InputArgList &args) {
     return CGProfileSortKind::Hfsort;
   if (s == "cdsort")
     return CGProfileSortKind::Cdsort;
+  if (s == "exttsp")
+    return CGProfileSortKind::Exttsp;
   if (s != "none")
     error("unknown --call-graph-profile-sort= value: " + s);
   return CGProfileSortKind::None;
@@ -1226,6 +1340,10 @@ static void readConfigs(opt::InputArgList &args) {
       config->bsymbolic = BsymbolicKind::All;
   }
   config->callGraphProfileSort = getCGProfileSortKind(args);
+  config->callGraphProfileCacheEntries =
+      args::getInteger(args, OPT_call_graph_profile_cache_entries, 16);
+  config->callGraphProfileCacheSize =
+      args::getInteger(args, OPT_call_graph_profile_cache_size, 2048);
   config->checkSections =
       args.hasFlag(OPT_check_sections, OPT_no_check_sections, true);
   config->chroot = args.getLastArgValue(OPT_chroot);
@@ -1272,6 +1390,9 @@ static void readConfigs(opt::InputArgList &args) {
   config->fortranCommon =
       args.hasFlag(OPT_fortran_common, OPT_no_fortran_common, false);
   config->gcSections = args.hasFlag(OPT_gc_sections, OPT_no_gc_sections, false);
+  config->incremental =
+      args.hasFlag(OPT_incremental, OPT_no_incremental, false) &&
+      config->outputFile != "-";
   config->gnuUnique = args.hasFlag(OPT_gnu_unique, OPT_no_gnu_unique, true);
   config->gdbIndex = args.hasFlag(OPT_gdb_index, OPT_no_gdb_index, false);
   config->icf = getICF(args);
@@ -1280,6 +1401,7 @@ static void readConfigs(opt::InputArgList &args) {
   config->ignoreFunctionAddressEquality =
       args.hasArg(OPT_ignore_function_address_equality);
   config->init = args.getLastArgValue(OPT_init, "_init");
+  config->leanMemory = args.hasFlag(OPT_lean_memory, OPT_no_lean_memory, false);
   config->ltoAAPipeline = args.getLastArgValue(OPT_lto_aa_pipeline);
   config->ltoCSProfileGenerate = args.hasArg(OPT_lto_cs_profile_generate);
   config->ltoCSProfileFile = args.getLastArgValue(OPT_lto_cs_profile_file);
@@ -1381,6 +1503,8 @@ static void readConfigs(opt::InputArgList &args) {
   config->soName = args.getLastArgValue(OPT_soname);
   config->sortSection = getSortSection(args);
   config->splitStackAdjustSize = args::getInteger(args, OPT_split_stack_adjust_size, 16384);
+  config->streamOutput =
+      args.hasFlag(OPT_stream_output, OPT_no_stream_output, false);
   config->strip = getStrip(args);
   config->sysroot = args.getLastArgValue(OPT_sysroot);
   config->target1Rel = args.hasFlag(OPT_target1_rel, OPT_target1_abs, false);
@@ -1641,6 +1765,10 @@ static void readConfigs(opt::InputArgList &args) {
 
   if (config->splitStackAdjustSize < 0)
     error("--split-stack-adjust-size: size must be >= 0");
+  if (config->callGraphProfileCacheEntries == 0)
+    error("--call-graph-profile-cache-entries: number of entries must be > 0");
+  if (config->callGraphProfileCacheSize == 0)
+    error("--call-graph-profile-cache-size: size must be > 0");
 
   // The text segment is traditionally the first segment, whose address equals
   // the base address. However, lld places the R PT_LOAD first. -Ttext-segment
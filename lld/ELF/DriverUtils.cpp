@@ -208,6 +208,16 @@ std::string elf::createResponseFile(const opt::InputArgList &args) {
   return std::string(data);
 }
 
+// Checks whether an input file candidate exists. Candidates that don't are
+// remembered for --incremental, since creating one would change the link.
+bool elf::fileExists(StringRef path) {
+  if (fs::exists(path))
+    return true;
+  if (config->incremental)
+    ctx.missingFiles.insert(llvm::CachedHashString(path));
+  return false;
+}
+
 // Find a file by concatenating given paths. If a resulting path
 // starts with "=", the character is replaced with a --sysroot value.
 static std::optional<std::string> findFile(StringRef path1,
@@ -218,7 +228,7 @@ static std::optional<std::string> findFile(StringRef path1,
   else
     path::append(s, path1, path2);
 
-  if (fs::exists(s))
+  if (fileExists(s))
     return std::string(s);
   return std::nullopt;
 }
@@ -255,7 +265,7 @@ std::optional<std::string> elf::searchLibrary(StringRef name) {
 // look for the script in the '-L' search paths. This matches the behaviour of
 // '-T', --version-script=, and linker script INPUT() command in ld.bfd.
 std::optional<std::string> elf::searchScript(StringRef name) {
-  if (fs::exists(name))
+  if (fileExists(name))
     return name.str();
   return findFromSearchPaths(name);
 }
@@ -420,9 +420,13 @@ void ICF<ELFT>::forEachClass(llvm::function_ref<void(size_t, size_t)> fn) {
   // The sharding must be completed before any calls to Fn are made
   // so that Fn can modify the Chunks in its shard without causing data
   // races.
-  const size_t numShards = 256;
+  //
+  // Use several shards per thread so that large classes, which take longer to
+  // segregate, don't leave the other threads idle.
+  const size_t numShards = std::min<size_t>(
+      std::max<size_t>(256, config->threadCount * 16), sections.size() / 4);
   size_t step = sections.size() / numShards;
-  size_t boundaries[numShards + 1];
+  SmallVector<size_t, 0> boundaries(numShards + 1);
   boundaries[0] = 0;
   boundaries[numShards] = sections.size();
 
@@ -513,10 +517,20 @@ template <class ELFT> void ICF<ELFT>::run() {
   }
 
   // From now on, sections in Sections vector are ordered so that sections
-  // in the same equivalence class are consecutive in the vector.
-  llvm::stable_sort(sections, [](const InputSection *a, const InputSection *b) {
-    return a->eqClass[0] < b->eqClass[0];
-  });
+  // in the same equivalence class are consecutive in the vector. Ties are
+  // broken by the original position, which makes the parallel sort produce
+  // the same order as a stable sort.
+  {
+    SmallVector<std::pair<uint32_t, uint32_t>, 0> keys(sections.size());
+    parallelFor(0, sections.size(), [&](size_t i) {
+      keys[i] = {sections[i]->eqClass[0], static_cast<uint32_t>(i)};
+    });
+    parallelSort(keys.begin(), keys.end());
+    SmallVector<InputSection *, 0> sorted(sections.size());
+    parallelFor(0, keys.size(),
+                [&](size_t i) { sorted[i] = sections[keys[i].second]; });
+    sections = std::move(sorted);
+  }
 
   // Compare static contents and assign unique equivalence class IDs for each
   // static content. Use a base offset for these IDs to ensure no overlap with
@@ -26,6 +26,7 @@
 #include "llvm/Support/ARMBuildAttributes.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/RISCVAttributeParser.h"
 #include "llvm/Support/TarWriter.h"
@@ -333,6 +334,17 @@ extern template void ObjFile<ELF64BE>::importCmseSymbols();
 template <class ELFT>
 static void doParseFiles(const std::vector<InputFile *> &files,
                          InputFile *armCmseImpLib) {
+  // Symbol resolution below has to be serial to preserve the command line order
+  // semantics, but hashing the global symbol names does not. Do that first, in
+  // parallel, so that the serial pass only looks up precomputed hashes.
+  {
+    llvm::TimeTraceScope timeScope("Hash symbol names");
+    parallelForEach(files, [](InputFile *file) {
+      if (file->kind() == InputFile::ObjKind && file->ekind == config->ekind)
+        cast<ObjFile<ELFT>>(file)->hashGlobalSymbolNames();
+    });
+  }
+
   // Add all files to the symbol table. This will add almost all symbols that we
   // need to the symbol table. This process might add files to the link due to
   // addDependentLibrary.
@@ -1113,7 +1125,8 @@ void ObjFile<ELFT>::initializeSymbols(const object::ELFFile<ELFT> &obj) {
   // Some entries have been filled by LazyObjFile.
   for (size_t i = firstGlobal, end = eSyms.size(); i != end; ++i)
     if (!symbols[i])
-      symbols[i] = symtab.insert(CHECK(eSyms[i].getName(stringTable), this));
+      symbols[i] = insertGlobal(i, eSyms[i]);
+  globalNameHashes.reset();
 
   // Perform symbol resolution on non-local symbols.
   SmallVector<unsigned, 32> undefineds;
@@ -1871,13 +1884,38 @@ template <class ELFT> void ObjFile<ELFT>::parseLazy() {
   for (size_t i = firstGlobal, end = eSyms.size(); i != end; ++i) {
     if (eSyms[i].st_shndx == SHN_UNDEF)
       continue;
-    symbols[i] = symtab.insert(CHECK(eSyms[i].getName(stringTable), this));
+    symbols[i] = insertGlobal(i, eSyms[i]);
     symbols[i]->resolve(LazySymbol{*this});
     if (!lazy)
       break;
   }
 }
 
+template <class ELFT> void ObjFile<ELFT>::hashGlobalSymbolNames() {
+  ArrayRef<Elf_Sym> eSyms = this->getELFSyms<ELFT>();
+  if (eSyms.size() <= firstGlobal)
+    return;
+  globalNameHashes = std::make_unique<uint32_t[]>(eSyms.size() - firstGlobal);
+  for (size_t i = firstGlobal, end = eSyms.size(); i != end; ++i) {
+    Expected<StringRef> name = eSyms[i].getName(stringTable);
+    if (!name) {
+      // Leave the error to be reported by parse().
+      consumeError(name.takeError());
+      globalNameHashes.reset();
+      return;
+    }
+    globalNameHashes[i - firstGlobal] = SymbolTable::getHash(*name);
+  }
+}
+
+template <class ELFT>
+Symbol *ObjFile<ELFT>::insertGlobal(size_t i, const Elf_Sym &eSym) {
+  StringRef name = CHECK(eSym.getName(stringTable), this);
+  if (!globalNameHashes)
+    return symtab.insert(name);
+  return symtab.insert(name, globalNameHashes[i - firstGlobal]);
+}
+
 bool InputFile::shouldExtractForCommon(StringRef name) const {
   if (isa<BitcodeFile>(this))
     return isBitcodeNonCommonDef(mb, name, archiveName);
@@ -252,6 +252,10 @@ public:
   void parse(bool ignoreComdats = false);
   void parseLazy();
 
+  // Computes the symbol table hashes of the global symbol names ahead of
+  // parse() or parseLazy(). May be called concurrently for different files.
+  void hashGlobalSymbolNames();
+
   StringRef getShtGroupSignature(ArrayRef<Elf_Shdr> sections,
                                  const Elf_Shdr &sec);
 
@@ -298,6 +302,7 @@ private:
                           const llvm::object::ELFFile<ELFT> &obj);
   void initializeSymbols(const llvm::object::ELFFile<ELFT> &obj);
   void initializeJustSymbols();
+  Symbol *insertGlobal(size_t i, const Elf_Sym &eSym);
 
   InputSectionBase *getRelocTarget(uint32_t idx, const Elf_Shdr &sec,
                                    uint32_t info);
@@ -326,6 +331,10 @@ private:
   // parse it only once for each object file we link.
   std::unique_ptr<DWARFCache> dwarf;
   llvm::once_flag initDwarf;
+
+  // SymbolTable::getHash() of each global symbol name, if precomputed by
+  // hashGlobalSymbolNames(). Released once the symbols are inserted.
+  std::unique_ptr<uint32_t[]> globalNameHashes;
 };
 
 class BitcodeFile : public InputFile {
@@ -1325,7 +1325,9 @@ void MergeInputSection::splitStrings(StringRef s, size_t entSize) {
   if (!std::all_of(end - entSize, end, [](char c) { return c == 0; }))
     fatal(toString(this) + ": string is not null terminated");
   if (entSize == 1) {
-    // Optimize the common case.
+    // Optimize the common case. Counting the terminators first lets us size
+    // pieces once; std::count over bytes is vectorized.
+    pieces.reserve(pieces.size() + std::count(p, end, '\0'));
     do {
       size_t size = strlen(p);
       pieces.emplace_back(p - s.begin(), xxh3_64bits(StringRef(p, size)), live);
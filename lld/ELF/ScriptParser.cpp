@@ -302,7 +302,7 @@ void ScriptParser::addFile(StringRef s) {
   if (isUnderSysroot && s.starts_with("/")) {
     SmallString<128> pathData;
     StringRef path = (config->sysroot + s).toStringRef(pathData);
-    if (sys::fs::exists(path))
+    if (fileExists(path))
       ctx.driver.addFile(saver().save(path), /*withLOption=*/false);
     else
       setError("cannot find " + s + " inside " + config->sysroot);
@@ -329,13 +329,13 @@ void ScriptParser::addFile(StringRef s) {
     if (!directory.empty()) {
       SmallString<0> path(directory);
       sys::path::append(path, s);
-      if (sys::fs::exists(path)) {
+      if (fileExists(path)) {
         ctx.driver.addFile(path, /*withLOption=*/false);
         return;
       }
     }
     // Then search in the current working directory.
-    if (sys::fs::exists(s)) {
+    if (fileExists(s)) {
       ctx.driver.addFile(s, /*withLOption=*/false);
     } else {
       // Finally, search in the list of library paths.
@@ -43,6 +43,15 @@ public:
   void wrap(Symbol *sym, Symbol *real, Symbol *wrap);
 
   Symbol *insert(StringRef name);
+  // Same as insert(name), with the result of getHash(name) precomputed.
+  Symbol *insert(StringRef name, uint32_t hash);
+
+  // Returns the hash insert() uses to look up name. It is thread-safe, so that
+  // input files can hash their symbol names in parallel before the (serial)
+  // symbol resolution.
+  static uint32_t getHash(StringRef name) {
+    return llvm::DenseMapInfo<StringRef>::getHashValue(getStem(name));
+  }
 
   template <typename T> Symbol *addSymbol(const T &newSym) {
     Symbol *sym = insert(newSym.getName());
@@ -81,6 +90,19 @@ public:
   llvm::StringMap<bool> inCMSEOutImpLib;
 
 private:
+  // <name>@@<version> means the symbol is the default version. In that
+  // case <name>@@<version> will be used to resolve references to <name>.
+  //
+  // Since this is a hot path, the following string search code is
+  // optimized for speed. StringRef::find(char) is much faster than
+  // StringRef::find(StringRef).
+  static StringRef getStem(StringRef name) {
+    size_t pos = name.find('@');
+    if (pos != StringRef::npos && pos + 1 < name.size() && name[pos + 1] == '@')
+      return name.take_front(pos);
+    return name;
+  }
+
   SmallVector<Symbol *, 0> findByVersion(SymbolVersion ver);
   SmallVector<Symbol *, 0> findAllByVersion(SymbolVersion ver,
                                             bool includeNonDefault);
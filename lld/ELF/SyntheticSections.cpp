@@ -2233,9 +2233,12 @@ template <class ELFT> void SymbolTableSection<ELFT>::writeTo(uint8_t *buf) {
   // The first entry is a null entry as per the ELF spec.
   buf += sizeof(Elf_Sym);
 
-  auto *eSym = reinterpret_cast<Elf_Sym *>(buf);
-
-  for (SymbolTableEntry &ent : symbols) {
+  // Entries are independent of each other, so they are written in parallel.
+  // This matters for large outputs with millions of symbols.
+  auto *eSyms = reinterpret_cast<Elf_Sym *>(buf);
+  parallelFor(0, symbols.size(), [&](size_t i) {
+    const SymbolTableEntry &ent = symbols[i];
+    Elf_Sym *eSym = eSyms + i;
     Symbol *sym = ent.sym;
     bool isDefinedHere = type == SHT_SYMTAB || sym->partition == partition;
 
@@ -2267,9 +2270,7 @@ template <class ELFT> void SymbolTableSection<ELFT>::writeTo(uint8_t *buf) {
         eSym->st_size = 0;
       }
     }
-
-    ++eSym;
-  }
+  });
 
   // On MIPS we need to mark symbol which has a PLT entry and requires
   // pointer equality by STO_MIPS_PLT flag. That is necessary to help
@@ -3251,37 +3252,47 @@ template <class ELFT> void DebugNamesSection<ELFT>::writeTo(uint8_t *buf) {
   // TODO: Write the local TU list, then the foreign TU list..
 
   // Write the hash lookup table.
-  SmallVector<SmallVector<NameEntry *, 0>, 0> buckets(hdr.BucketCount);
+  //
   // Symbols enter into a bucket whose index is the hash modulo bucket_count.
+  // Sort the name entries by bucket with a counting sort into one flat array:
+  // there are about as many buckets as names, and a vector per bucket would
+  // cost an allocation per name.
+  SmallVector<uint32_t, 0> bucketStarts(hdr.BucketCount + 1);
   for (auto &nameVec : nameVecs)
     for (NameEntry &ne : nameVec)
-      buckets[ne.hashValue % hdr.BucketCount].push_back(&ne);
+      ++bucketStarts[ne.hashValue % hdr.BucketCount + 1];
+  for (uint32_t i = 0; i != hdr.BucketCount; ++i)
+    bucketStarts[i + 1] += bucketStarts[i];
+  SmallVector<const NameEntry *, 0> sorted;
+  sorted.resize_for_overwrite(hdr.NameCount);
+  {
+    SmallVector<uint32_t, 0> next(bucketStarts.begin(),
+                                  bucketStarts.end() - 1);
+    for (auto &nameVec : nameVecs)
+      for (NameEntry &ne : nameVec)
+        sorted[next[ne.hashValue % hdr.BucketCount]++] = &ne;
+  }
 
   // Write buckets (accumulated bucket counts).
-  uint32_t bucketIdx = 1;
-  for (const SmallVector<NameEntry *, 0> &bucket : buckets) {
-    if (!bucket.empty())
-      endian::write32<ELFT::Endianness>(buf, bucketIdx);
+  for (uint32_t i = 0; i != hdr.BucketCount; ++i) {
+    if (bucketStarts[i] != bucketStarts[i + 1])
+      endian::write32<ELFT::Endianness>(buf, bucketStarts[i] + 1);
     buf += 4;
-    bucketIdx += bucket.size();
   }
   // Write the hashes.
-  for (const SmallVector<NameEntry *, 0> &bucket : buckets)
-    for (const NameEntry *e : bucket)
-      endian::writeNext<uint32_t, ELFT::Endianness>(buf, e->hashValue);
+  for (const NameEntry *e : sorted)
+    endian::writeNext<uint32_t, ELFT::Endianness>(buf, e->hashValue);
 
   // Write the name table. The name entries are ordered by bucket_idx and
   // correspond one-to-one with the hash lookup table.
   //
   // First, write the relocated string offsets.
-  for (const SmallVector<NameEntry *, 0> &bucket : buckets)
-    for (const NameEntry *ne : bucket)
-      endian::writeNext<uint32_t, ELFT::Endianness>(buf, ne->stringOffset);
+  for (const NameEntry *ne : sorted)
+    endian::writeNext<uint32_t, ELFT::Endianness>(buf, ne->stringOffset);
 
   // Then write the entry offsets.
-  for (const SmallVector<NameEntry *, 0> &bucket : buckets)
-    for (const NameEntry *ne : bucket)
-      endian::writeNext<uint32_t, ELFT::Endianness>(buf, ne->entryOffset);
+  for (const NameEntry *ne : sorted)
+    endian::writeNext<uint32_t, ELFT::Endianness>(buf, ne->entryOffset);
 
   // Write the abbrev table.
   buf = llvm::copy(abbrevTableBuf, buf);
@@ -3398,10 +3409,12 @@ readPubNamesAndTypes(const LLDDwarfObj<ELFT> &obj,
 }
 
 // Create a list of symbols from a given list of symbol names and types
-// by uniquifying them by name.
+// by uniquifying them by name. nameAttrs is consumed: the per-input entries can
+// be the largest allocation of a -g link, so they are freed as soon as they
+// have been grouped.
 static std::pair<SmallVector<GdbIndexSection::GdbSymbol, 0>, size_t>
 createSymbols(
-    ArrayRef<SmallVector<GdbIndexSection::NameAttrEntry, 0>> nameAttrs,
+    SmallVector<SmallVector<GdbIndexSection::NameAttrEntry, 0>, 0> &&nameAttrs,
     const SmallVector<GdbIndexSection::GdbChunk, 0> &chunks) {
   using GdbSymbol = GdbIndexSection::GdbSymbol;
   using NameAttrEntry = GdbIndexSection::NameAttrEntry;
@@ -3443,19 +3456,24 @@ createSymbols(
       ++i;
     }
   });
+  nameAttrs.clear();
+  map.reset();
 
   size_t numSymbols = 0;
   for (ArrayRef<GdbSymbol> v : ArrayRef(symbols.get(), numShards))
     numSymbols += v.size();
 
   // The return type is a flattened vector, so we'll copy each vector
-  // contents to Ret.
+  // contents to Ret. Each shard is released once it has been copied, to avoid
+  // holding all symbols twice.
   SmallVector<GdbSymbol, 0> ret;
   ret.reserve(numSymbols);
   for (SmallVector<GdbSymbol, 0> &vec :
-       MutableArrayRef(symbols.get(), numShards))
-    for (GdbSymbol &sym : vec)
+       MutableArrayRef(symbols.get(), numShards)) {
+    SmallVector<GdbSymbol, 0> shard = std::move(vec);
+    for (GdbSymbol &sym : shard)
       ret.push_back(std::move(sym));
+  }
 
   // CU vectors and symbol names are adjacent in the output file.
   // We can compute their offsets in the output file now.
@@ -3526,7 +3544,8 @@ std::unique_ptr<GdbIndexSection> GdbIndexSection::create() {
 
   auto ret = std::make_unique<GdbIndexSection>();
   ret->chunks = std::move(chunks);
-  std::tie(ret->symbols, ret->size) = createSymbols(nameAttrs, ret->chunks);
+  std::tie(ret->symbols, ret->size) =
+      createSymbols(std::move(nameAttrs), ret->chunks);
 
   // Count the areas other than the constant pool.
   ret->size += sizeof(GdbIndexHeader) + ret->computeSymtabSize() * 8;
@@ -32,6 +32,9 @@
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/xxhash.h"
 #include <climits>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #define DEBUG_TYPE "lld"
 
@@ -43,6 +46,206 @@ using namespace llvm::support::endian;
 using namespace lld;
 using namespace lld::elf;
 
+// Build IDs are computed by hashing the output in chunks of this size and
+// then hashing the chunk hashes. See computeHash.
+static constexpr size_t buildIdChunkSize = 1024 * 1024;
+
+// With --stream-output, output sections are written in batches of at least
+// this many bytes before the finished prefix is handed to the streamer.
+static constexpr uint64_t streamBatchSize = 4 * 1024 * 1024;
+
+using ChunkHashFn = std::function<void(uint8_t *dest, ArrayRef<uint8_t> arr)>;
+
+namespace {
+// For --stream-output. The output is still built in an in-memory buffer, but
+// the parts of the buffer that are final are written to a temporary file on a
+// background thread while later sections are being relocated. If the build ID
+// is a hash, the chunks that computeHash would hash are hashed as soon as they
+// have been written, so that only the hash of the hashes is left at the end.
+//
+// This is installed as errorHandler().outputBuffer, so if the link fails or
+// calls fatal() midway, the temporary file is removed and the output file is
+// left untouched.
+class OutputStreamer : public FileOutputBuffer {
+public:
+  OutputStreamer(StringRef path, std::unique_ptr<FileOutputBuffer> mem,
+                 sys::fs::TempFile file, ChunkHashFn hashFn, size_t hashSize);
+  ~OutputStreamer() override { discard(); }
+
+  uint8_t *getBufferStart() const override { return mem->getBufferStart(); }
+  uint8_t *getBufferEnd() const override { return mem->getBufferEnd(); }
+  size_t getBufferSize() const override { return mem->getBufferSize(); }
+
+  // Declares that the bytes before `end` will not be modified anymore.
+  void publish(uint64_t end);
+  // Writes the rest of the buffer and waits for the background thread.
+  void finish();
+  // Writes a range again that was modified after it had been published. Must
+  // be called after finish().
+  void rewrite(uint64_t offset, uint64_t size);
+  // Renames the temporary file to the output path.
+  Error commit() override;
+  // Stops the background thread and removes the temporary file.
+  void discard() override;
+
+  bool hasChunkHashes() const { return bool(hashFn); }
+  ArrayRef<uint8_t> getChunkHashes() const { return chunkHashes; }
+
+private:
+  void run();
+  void stop();
+  Error takeError();
+
+  std::unique_ptr<FileOutputBuffer> mem;
+  sys::fs::TempFile file;
+  raw_fd_ostream os;
+  ArrayRef<uint8_t> data;
+  ChunkHashFn hashFn;
+  size_t hashSize;
+  std::vector<uint8_t> chunkHashes;
+
+  std::mutex mu;
+  std::condition_variable cv;
+  uint64_t published = 0;
+  bool aborted = false;
+  bool done = false;
+  std::thread thread;
+};
+} // namespace
+
+OutputStreamer::OutputStreamer(StringRef path,
+                               std::unique_ptr<FileOutputBuffer> mem,
+                               sys::fs::TempFile file, ChunkHashFn hashFn,
+                               size_t hashSize)
+    : FileOutputBuffer(path), mem(std::move(mem)), file(std::move(file)),
+      os(this->file.FD, /*shouldClose=*/false),
+      data(this->mem->getBufferStart(), this->mem->getBufferSize()),
+      hashFn(std::move(hashFn)), hashSize(hashSize) {
+  if (this->hashFn)
+    chunkHashes.resize(divideCeil(data.size(), buildIdChunkSize) * hashSize);
+  thread = std::thread([this] { run(); });
+}
+
+void OutputStreamer::publish(uint64_t end) {
+  {
+    std::lock_guard<std::mutex> lock(mu);
+    published = std::max(published, end);
+  }
+  cv.notify_one();
+}
+
+void OutputStreamer::finish() {
+  if (!thread.joinable())
+    return;
+  publish(data.size());
+  thread.join();
+}
+
+void OutputStreamer::stop() {
+  if (!thread.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mu);
+    aborted = true;
+  }
+  cv.notify_one();
+  thread.join();
+}
+
+void OutputStreamer::run() {
+  uint64_t written = 0;
+  uint64_t hashed = 0;
+  while (written < data.size()) {
+    uint64_t end;
+    {
+      std::unique_lock<std::mutex> lock(mu);
+      cv.wait(lock, [&] { return aborted || published > written; });
+      if (aborted)
+        return;
+      end = published;
+    }
+    os.write(reinterpret_cast<const char *>(data.data() + written),
+             end - written);
+    written = end;
+
+    // Hash every chunk that is now complete.
+    if (!hashFn)
+      continue;
+    while (hashed < written) {
+      uint64_t chunkEnd =
+          std::min<uint64_t>(hashed + buildIdChunkSize, data.size());
+      if (chunkEnd > written)
+        break;
+      hashFn(chunkHashes.data() + hashed / buildIdChunkSize * hashSize,
+             data.slice(hashed, chunkEnd - hashed));
+      hashed = chunkEnd;
+    }
+  }
+  os.flush();
+}
+
+void OutputStreamer::rewrite(uint64_t offset, uint64_t size) {
+  assert(!thread.joinable());
+  os.pwrite(reinterpret_cast<const char *>(data.data() + offset), size,
+            offset);
+}
+
+Error OutputStreamer::takeError() {
+  os.flush();
+  if (!os.has_error())
+    return Error::success();
+  std::error_code ec = os.error();
+  os.clear_error();
+  return errorCodeToError(ec);
+}
+
+Error OutputStreamer::commit() {
+  finish();
+  done = true;
+  if (Error e = takeError()) {
+    consumeError(file.discard());
+    return e;
+  }
+  return file.keep(FinalPath);
+}
+
+void OutputStreamer::discard() {
+  stop();
+  if (done)
+    return;
+  done = true;
+  consumeError(takeError());
+  consumeError(file.discard());
+}
+
+// Returns the function that hashes a chunk of the output for the build ID, or
+// an empty function if the build ID is not a hash of the output.
+//
+// Fedora introduced build ID as "approximation of true uniqueness across all
+// binaries that might be used by overlapping sets of people". It does not
+// need some security goals that some hash algorithms strive to provide, e.g.
+// (second-)preimage and collision resistance. In practice people use 'md5'
+// and 'sha1' just for different lengths. Implement them with the more
+// efficient BLAKE3.
+static ChunkHashFn getBuildIdHashFn(size_t hashSize) {
+  switch (config->buildId) {
+  case BuildIdKind::Fast:
+    return [](uint8_t *dest, ArrayRef<uint8_t> arr) {
+      write64le(dest, xxh3_64bits(arr));
+    };
+  case BuildIdKind::Md5:
+    return [=](uint8_t *dest, ArrayRef<uint8_t> arr) {
+      memcpy(dest, BLAKE3::hash<16>(arr).data(), hashSize);
+    };
+  case BuildIdKind::Sha1:
+    return [=](uint8_t *dest, ArrayRef<uint8_t> arr) {
+      memcpy(dest, BLAKE3::hash<20>(arr).data(), hashSize);
+    };
+  default:
+    return nullptr;
+  }
+}
+
 namespace {
 // The writer writes a SymbolTable result to a file.
 template <class ELFT> class Writer {
@@ -81,6 +284,8 @@ private:
   void writeBuildId();
 
   std::unique_ptr<FileOutputBuffer> &buffer;
+  // Set if buffer is an OutputStreamer.
+  OutputStreamer *streamer = nullptr;
 
   void addRelIpltSymbols();
   void addStartEndSymbols();
@@ -95,6 +300,23 @@ template <class ELFT> void elf::writeResult() {
   Writer<ELFT>().run();
 }
 
+// For --lean-memory. Once every section has been written, the Relocation
+// vectors built by scanRelocations and the contents of the input files are
+// not needed anymore, but they would otherwise stay resident while the build
+// ID is computed and the output is flushed, which is when the dirty output
+// pages push the link to its peak RSS.
+static void releaseInputMemory() {
+  llvm::TimeTraceScope timeScope("Release input memory");
+  parallelForEach(ctx.inputSections, [](InputSectionBase *sec) {
+    // Moving out of the vector is what actually frees its heap buffer.
+    SmallVector<Relocation, 0> rels = std::move(sec->relocations);
+  });
+  // Input files are mapped read-only, so a page that is touched again (e.g.
+  // a symbol name read by --out-implib) is simply faulted back in.
+  for (MemoryBuffer &mb : llvm::make_pointee_range(ctx.memoryBuffers))
+    mb.dontNeedIfMmap();
+}
+
 static void removeEmptyPTLoad(SmallVector<PhdrEntry *, 0> &phdrs) {
   auto it = std::stable_partition(
       phdrs.begin(), phdrs.end(), [&](const PhdrEntry *p) {
@@ -363,12 +585,23 @@ template <class ELFT> void Writer<ELFT>::run() {
       writeSectionsBinary();
     }
 
+    if (config->leanMemory)
+      releaseInputMemory();
+
     // Backfill .note.gnu.build-id section content. This is done at last
     // because the content is usually a hash value of the entire output file.
+    if (streamer)
+      streamer->finish();
     writeBuildId();
     if (errorCount())
       return;
 
+    if (streamer)
+      for (Partition &part : partitions)
+        if (part.buildId && part.buildId->getParent())
+          streamer->rewrite(part.buildId->getParent()->offset +
+                                part.buildId->outSecOff,
+                            part.buildId->getSize());
     if (auto e = buffer->commit())
       fatal("failed to write output '" + buffer->getPath() +
             "': " + toString(std::move(e)));
@@ -1211,9 +1444,13 @@ template <class ELFT> void Writer<ELFT>::sortInputSections() {
   // Build the order once since it is expensive.
   DenseMap<const InputSectionBase *, int> order = buildSectionOrder();
   maybeShuffle(order);
+  // Output sections are sorted independently of each other.
+  SmallVector<OutputSection *, 0> osecs;
   for (SectionCommand *cmd : script->sectionCommands)
     if (auto *osd = dyn_cast<OutputDesc>(cmd))
-      sortSection(osd->osec, order);
+      osecs.push_back(&osd->osec);
+  parallelForEach(osecs,
+                  [&](OutputSection *osec) { sortSection(*osec, order); });
 }
 
 template <class ELFT> void Writer<ELFT>::sortSections() {
@@ -2670,10 +2907,18 @@ template <class ELFT> void Writer<ELFT>::openFile() {
   }
 
   unlinkAsync(config->outputFile);
+
+  // Streaming writes a temporary file that is renamed over the output at the
+  // end, so it is only used if the output is (or will be) a regular file.
+  bool stream = config->streamOutput && !config->oFormatBinary &&
+                config->outputFile != "-" &&
+                (!sys::fs::exists(config->outputFile) ||
+                 sys::fs::is_regular_file(config->outputFile));
+
   unsigned flags = 0;
   if (!config->relocatable)
     flags |= FileOutputBuffer::F_executable;
-  if (!config->mmapOutputFile)
+  if (!config->mmapOutputFile || stream)
     flags |= FileOutputBuffer::F_no_mmap;
   Expected<std::unique_ptr<FileOutputBuffer>> bufferOrErr =
       FileOutputBuffer::create(config->outputFile, fileSize, flags);
@@ -2685,6 +2930,32 @@ template <class ELFT> void Writer<ELFT>::openFile() {
   }
   buffer = std::move(*bufferOrErr);
   Out::bufferStart = buffer->getBufferStart();
+  if (!stream)
+    return;
+
+  unsigned mode = sys::fs::all_read | sys::fs::all_write;
+  if (!config->relocatable)
+    mode |= sys::fs::all_exe;
+  Expected<sys::fs::TempFile> file =
+      sys::fs::TempFile::create(config->outputFile + ".tmp%%%%%%%", mode);
+  if (!file) {
+    error("failed to open " + config->outputFile + ": " +
+          llvm::toString(file.takeError()));
+    return;
+  }
+  ChunkHashFn hashFn;
+  size_t hashSize = 0;
+  if (mainPart->buildId && mainPart->buildId->getParent()) {
+    hashSize = mainPart->buildId->hashSize;
+    hashFn = getBuildIdHashFn(hashSize);
+  }
+  // The in-memory buffer becomes the streamer's backing store, and the
+  // streamer takes its place so that exitLld() discards the temporary file.
+  auto s = std::make_unique<OutputStreamer>(config->outputFile,
+                                            std::move(buffer), std::move(*file),
+                                            std::move(hashFn), hashSize);
+  streamer = s.get();
+  buffer = std::move(s);
 }
 
 template <class ELFT> void Writer<ELFT>::writeSectionsBinary() {
@@ -2743,11 +3014,32 @@ template <class ELFT> void Writer<ELFT>::writeSections() {
       if (isStaticRelSecType(sec->type))
         sec->writeTo<ELFT>(Out::bufferStart + sec->offset, tg);
   }
-  {
+  if (!streamer) {
     parallel::TaskGroup tg;
     for (OutputSection *sec : outputSections)
       if (!isStaticRelSecType(sec->type))
         sec->writeTo<ELFT>(Out::bufferStart + sec->offset, tg);
+  } else {
+    // Write the sections in file offset order, a batch at a time. Once a
+    // batch is done, everything before the next unwritten section is final
+    // and can be streamed out while the next batch is being relocated.
+    SmallVector<OutputSection *, 0> secs;
+    for (OutputSection *sec : outputSections)
+      if (!isStaticRelSecType(sec->type))
+        secs.push_back(sec);
+    llvm::stable_sort(secs, [](const OutputSection *a, const OutputSection *b) {
+      return a->offset < b->offset;
+    });
+    for (size_t i = 0, e = secs.size(); i != e;) {
+      {
+        parallel::TaskGroup tg;
+        uint64_t batchStart = secs[i]->offset;
+        do {
+          secs[i]->writeTo<ELFT>(Out::bufferStart + secs[i]->offset, tg);
+        } while (++i != e && secs[i]->offset - batchStart < streamBatchSize);
+      }
+      streamer->publish(i == e ? fileSize : secs[i]->offset);
+    }
   }
 
   // Finally, check that all dynamic relocation addends were written correctly.
@@ -2762,11 +3054,9 @@ template <class ELFT> void Writer<ELFT>::writeSections() {
 // In order to utilize multiple cores, we first split data into 1MB
 // chunks, compute a hash for each chunk, and then compute a hash value
 // of the hash values.
-static void
-computeHash(llvm::MutableArrayRef<uint8_t> hashBuf,
-            llvm::ArrayRef<uint8_t> data,
-            std::function<void(uint8_t *dest, ArrayRef<uint8_t> arr)> hashFn) {
-  std::vector<ArrayRef<uint8_t>> chunks = split(data, 1024 * 1024);
+static void computeHash(llvm::MutableArrayRef<uint8_t> hashBuf,
+                        llvm::ArrayRef<uint8_t> data, ChunkHashFn hashFn) {
+  std::vector<ArrayRef<uint8_t>> chunks = split(data, buildIdChunkSize);
   const size_t hashesSize = chunks.size() * hashBuf.size();
   std::unique_ptr<uint8_t[]> hashes(new uint8_t[hashesSize]);
 
@@ -2795,28 +3085,18 @@ template <class ELFT> void Writer<ELFT>::writeBuildId() {
   MutableArrayRef<uint8_t> output(buildId.get(), hashSize);
   llvm::ArrayRef<uint8_t> input{Out::bufferStart, size_t(fileSize)};
 
-  // Fedora introduced build ID as "approximation of true uniqueness across all
-  // binaries that might be used by overlapping sets of people". It does not
-  // need some security goals that some hash algorithms strive to provide, e.g.
-  // (second-)preimage and collision resistance. In practice people use 'md5'
-  // and 'sha1' just for different lengths. Implement them with the more
-  // efficient BLAKE3.
   switch (config->buildId) {
   case BuildIdKind::Fast:
-    computeHash(output, input, [](uint8_t *dest, ArrayRef<uint8_t> arr) {
-      write64le(dest, xxh3_64bits(arr));
-    });
-    break;
   case BuildIdKind::Md5:
-    computeHash(output, input, [&](uint8_t *dest, ArrayRef<uint8_t> arr) {
-      memcpy(dest, BLAKE3::hash<16>(arr).data(), hashSize);
-    });
-    break;
-  case BuildIdKind::Sha1:
-    computeHash(output, input, [&](uint8_t *dest, ArrayRef<uint8_t> arr) {
-      memcpy(dest, BLAKE3::hash<20>(arr).data(), hashSize);
-    });
+  case BuildIdKind::Sha1: {
+    ChunkHashFn hashFn = getBuildIdHashFn(hashSize);
+    // With --stream-output the chunks have already been hashed.
+    if (streamer && streamer->hasChunkHashes())
+      hashFn(output.data(), streamer->getChunkHashes());
+    else
+      computeHash(output, input, hashFn);
     break;
+  }
   case BuildIdKind::Uuid:
     if (auto ec = llvm::getRandomBytes(buildId.get(), hashSize))
       error("entropy source failure: " + ec.message());
@@ -459,8 +459,11 @@ void UnwindInfoSectionImpl::finalize() {
   // vector of indices to entries and sort & fold that instead.
   cuIndices.resize(cuEntries.size());
   std::iota(cuIndices.begin(), cuIndices.end(), 0);
-  llvm::sort(cuIndices, [&](size_t a, size_t b) {
-    return cuEntries[a].functionAddress < cuEntries[b].functionAddress;
+  // Break ties on the index so that the parallel sort stays deterministic.
+  parallelSort(cuIndices, [&](size_t a, size_t b) {
+    if (cuEntries[a].functionAddress != cuEntries[b].functionAddress)
+      return cuEntries[a].functionAddress < cuEntries[b].functionAddress;
+    return a < b;
   });
 
   // Record the ending boundary before we fold the entries.
@@ -680,9 +683,12 @@ void UnwindInfoSectionImpl::writeTo(uint8_t *buf) const {
     lep++;
   }
 
-  // Level-2 pages
-  auto *pp = reinterpret_cast<uint32_t *>(lep);
-  for (const SecondLevelPage &page : secondLevelPages) {
+  // Level-2 pages. Each page occupies a fixed-size slot, so they can be
+  // written independently of one another.
+  auto *l2Pages = reinterpret_cast<uint32_t *>(lep);
+  parallelFor(0, secondLevelPages.size(), [&](size_t pageIdx) {
+    const SecondLevelPage &page = secondLevelPages[pageIdx];
+    uint32_t *pp = l2Pages + pageIdx * SECOND_LEVEL_PAGE_WORDS;
     if (page.kind == UNWIND_SECOND_LEVEL_COMPRESSED) {
       uintptr_t functionAddressBase =
           cuEntries[cuIndices[page.entryIndex]].functionAddress;
@@ -724,8 +730,7 @@ void UnwindInfoSectionImpl::writeTo(uint8_t *buf) const {
         *ep++ = cue.encoding;
       }
     }
-    pp += SECOND_LEVEL_PAGE_WORDS;
-  }
+  });
 }
 
 UnwindInfoSection *macho::makeUnwindInfoSection() {
@@ -0,0 +1,77 @@
+# REQUIRES: x86
+## Test that --incremental skips a relink when nothing it depends on changed,
+## checking this before any input file is loaded, and links otherwise.
+
+# RUN: rm -rf %t && split-file %s %t && cd %t
+# RUN: llvm-mc -filetype=obj -triple=x86_64 a.s -o a.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64 b.s -o b.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64 foo.s -o foo.o
+# RUN: mkdir lib1 lib2
+# RUN: llvm-ar rc lib2/libfoo.a foo.o
+
+# RUN: ld.lld --incremental a.o b.o -Llib1 -Llib2 -lfoo -o out --verbose 2>&1 | FileCheck %s --check-prefix=LINK
+# RUN: FileCheck %s --input-file=out.lld-incremental --check-prefix=STATE
+
+# LINK-NOT:  is up to date
+# LINK:      a.o
+# LINK:      b.o
+# LINK:      lib2{{/|\\}}libfoo.a
+
+# STATE:      {{^[0-9a-f]{64}$}}
+# STATE-NEXT: {{^[0-9]+ [0-9]+$}}
+# STATE-DAG:  file {{[0-9a-f]{64}}} a.o
+# STATE-DAG:  file {{[0-9a-f]{64}}} b.o
+# STATE-DAG:  file {{[0-9a-f]{64}}} lib2{{/|\\}}libfoo.a
+# STATE-DAG:  missing lib1{{/|\\}}libfoo.a
+
+## Nothing changed: no input is even opened.
+# RUN: ld.lld --incremental a.o b.o -Llib1 -Llib2 -lfoo -o out --verbose 2>&1 | FileCheck %s --check-prefix=SKIP
+# SKIP:     --incremental: out is up to date
+# SKIP-NOT: {{[ab]}}.o
+# SKIP-NOT: libfoo.a
+
+## A changed input leads to a full link.
+# RUN: cp b.o b.o.orig
+# RUN: llvm-mc -filetype=obj -triple=x86_64 b2.s -o b.o
+# RUN: ld.lld --incremental a.o b.o -Llib1 -Llib2 -lfoo -o out --verbose 2>&1 | FileCheck %s --check-prefix=LINK
+# RUN: ld.lld --incremental a.o b.o -Llib1 -Llib2 -lfoo -o out --verbose 2>&1 | FileCheck %s --check-prefix=SKIP
+
+## So does a library that now shadows the one found before.
+# RUN: cp lib2/libfoo.a lib1/libfoo.a
+# RUN: ld.lld --incremental a.o b.o -Llib1 -Llib2 -lfoo -o out --verbose 2>&1 | FileCheck %s --check-prefix=LINK1
+# LINK1-NOT: is up to date
+# LINK1:     lib1{{/|\\}}libfoo.a
+
+## So do different options.
+# RUN: ld.lld --incremental a.o b.o -Llib1 -Llib2 -lfoo -o out --verbose --gc-sections 2>&1 | FileCheck %s --check-prefix=LINK1
+
+## So does an output that was replaced by something else.
+# RUN: ld.lld --incremental a.o b.o -Llib1 -Llib2 -lfoo -o out --verbose --gc-sections 2>&1 | FileCheck %s --check-prefix=SKIP
+# RUN: cp b.o.orig out
+# RUN: ld.lld --incremental a.o b.o -Llib1 -Llib2 -lfoo -o out --verbose --gc-sections 2>&1 | FileCheck %s --check-prefix=LINK1
+
+## Without --incremental, no state is written.
+# RUN: ld.lld a.o b.o -Llib1 -Llib2 -lfoo -o out2
+# RUN: not ls out2.lld-incremental
+
+#--- a.s
+.globl _start
+_start:
+  call b
+  call foo
+
+#--- b.s
+.globl b
+b:
+  ret
+
+#--- b2.s
+.globl b
+b:
+  nop
+  ret
+
+#--- foo.s
+.globl foo
+foo:
+  ret
@@ -0,0 +1,56 @@
+# REQUIRES: x86
+## Test that --stream-output produces the same file as a normal link, and that
+## a link that fails while the output is being written leaves neither a partial
+## output file nor a temporary file behind.
+
+# RUN: rm -rf %t && mkdir %t && cd %t
+# RUN: llvm-mc -filetype=obj -triple=x86_64 %s -o a.o
+
+# RUN: ld.lld a.o --defsym=foo=0x1000 -o plain
+# RUN: ld.lld a.o --defsym=foo=0x1000 --stream-output -o streamed
+# RUN: cmp plain streamed
+# RUN: ld.lld a.o --defsym=foo=0x1000 --stream-output -o streamed --no-stream-output
+# RUN: cmp plain streamed
+
+## The build ID is the same whether the chunks are hashed while streaming or
+## after the fact.
+# RUN: ld.lld a.o --defsym=foo=0x1000 --build-id=fast -o plain
+# RUN: ld.lld a.o --defsym=foo=0x1000 --build-id=fast --stream-output -o streamed
+# RUN: cmp plain streamed
+# RUN: ld.lld a.o --defsym=foo=0x1000 --build-id=sha1 -o plain
+# RUN: ld.lld a.o --defsym=foo=0x1000 --build-id=sha1 --stream-output -o streamed
+# RUN: cmp plain streamed
+# RUN: ld.lld a.o --defsym=foo=0x1000 --build-id=0x12345678 -o plain
+# RUN: ld.lld a.o --defsym=foo=0x1000 --build-id=0x12345678 --stream-output -o streamed
+# RUN: cmp plain streamed
+
+## Streaming is not used for stdout or --oformat=binary.
+# RUN: ld.lld a.o --defsym=foo=0x1000 --oformat=binary -o plain
+# RUN: ld.lld a.o --defsym=foo=0x1000 --oformat=binary --stream-output -o streamed
+# RUN: cmp plain streamed
+# RUN: ld.lld a.o --defsym=foo=0x1000 --stream-output -o - > streamed
+# RUN: ld.lld a.o --defsym=foo=0x1000 -o plain
+# RUN: cmp plain streamed
+
+## The relocation error is reported while the sections are being written.
+## The existing output is left alone and the temporary file is removed.
+# RUN: cp plain out
+# RUN: not ld.lld a.o --defsym=foo=0x100000000 --stream-output -o out 2>&1 | FileCheck %s
+# RUN: cmp plain out
+# RUN: not ld.lld a.o --defsym=foo=0x100000000 --stream-output -o new 2>&1 | FileCheck %s
+# RUN: not ls new
+# RUN: ls | FileCheck %s --check-prefix=FILES --implicit-check-not=tmp
+
+# CHECK: error: {{.*}}relocation R_X86_64_32 out of range: 4294967296 is not in [0, 4294967295]
+
+# FILES: a.o
+# FILES: out
+# FILES: plain
+# FILES: streamed
+
+.globl _start
+_start:
+  ret
+
+.data
+.long foo
@@ -13,6 +13,7 @@
 #include "lld/Common/ErrorHandler.h"
 #include "lld/Common/LLVM.h"
 #include "llvm/Support/LEB128.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/xxhash.h"
 
 #define DEBUG_TYPE "lld"
@@ -507,11 +508,13 @@ void SyntheticMergedChunk::finalizeContents() {
 
   // finalize() fixed tail-optimized strings, so we can now get
   // offsets of strings. Get an offset for each string and save it
-  // to a corresponding SectionPiece for easy access.
-  for (MergeInputChunk *sec : chunks)
+  // to a corresponding SectionPiece for easy access. The builder is only read
+  // from here on, so this can be done for all chunks in parallel.
+  parallelForEach(chunks, [&](MergeInputChunk *sec) {
     for (size_t i = 0, e = sec->pieces.size(); i != e; ++i)
       if (sec->pieces[i].live)
         sec->pieces[i].outputOff = builder.getOffset(sec->getData(i));
+  });
 }
 
 uint64_t InputSection::getTombstoneForSection(StringRef name) {
@@ -79,9 +79,11 @@ void CodeSection::writeTo(uint8_t *buf) {
   // Write code section headers
   memcpy(buf, codeSectionHeader.data(), codeSectionHeader.size());
 
-  // Write code section bodies
-  for (const InputChunk *chunk : functions)
+  // Write code section bodies. Every function is written to its own range of
+  // the output, so relocations can be applied in parallel.
+  parallelForEach(functions, [&](const InputChunk *chunk) {
     chunk->writeTo(buf);
+  });
 }
 
 uint32_t CodeSection::getNumRelocations() const {
@@ -176,17 +178,18 @@ void DataSection::writeTo(uint8_t *buf) {
   // Write data section headers
   memcpy(buf, dataSectionHeader.data(), dataSectionHeader.size());
 
-  for (const OutputSegment *segment : segments) {
+  parallelForEach(segments, [&](const OutputSegment *segment) {
     if (!segment->requiredInBinary())
-      continue;
+      return;
     // Write data segment header
     uint8_t *segStart = buf + segment->sectionOffset;
     memcpy(segStart, segment->header.data(), segment->header.size());
 
     // Write segment data payload
-    for (const InputChunk *chunk : segment->inputSegments)
+    parallelForEach(segment->inputSegments, [&](const InputChunk *chunk) {
       chunk->writeTo(buf);
-  }
+    });
+  });
 }
 
 uint32_t DataSection::getNumRelocations() const {
@@ -270,8 +273,9 @@ void CustomSection::writeTo(uint8_t *buf) {
   buf += nameData.size();
 
   // Write custom sections payload
-  for (const InputChunk *section : inputSections)
+  parallelForEach(inputSections, [&](const InputChunk *section) {
     section->writeTo(buf);
+  });
 }
 
 uint32_t CustomSection::getNumRelocations() const {
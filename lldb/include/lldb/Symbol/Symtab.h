@@ -342,15 +342,6 @@ private:
   void SymbolIndicesToSymbolContextList(std::vector<uint32_t> &symbol_indexes,
                                         SymbolContextList &sc_list);
 
-  void RegisterMangledNameEntry(
-      uint32_t value, std::set<const char *> &class_contexts,
-      std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog,
-      RichManglingContext &rmc);
-
-  void RegisterBacklogEntry(const NameToIndexMap::Entry &entry,
-                            const char *decl_context,
-                            const std::set<const char *> &class_contexts);
-
   Symtab(const Symtab &) = delete;
   const Symtab &operator=(const Symtab &) = delete;
 };
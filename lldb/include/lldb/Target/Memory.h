@@ -57,12 +57,23 @@ protected:
   InvalidRanges m_invalid_ranges;
   Process &m_process;
   uint32_t m_L2_cache_line_byte_size;
+  // When the L2 cache misses at a constant stride, as when reading the
+  // elements of an array or the same member of consecutive elements, the next
+  // lines at that stride are read along with the missed one. Their number
+  // doubles with each miss that continues the pattern, up to
+  // m_max_prefetch_lines.
+  uint32_t m_max_prefetch_lines;
+  uint32_t m_prefetch_lines = 0;
+  lldb::addr_t m_last_miss_addr = LLDB_INVALID_ADDRESS;
+  lldb::addr_t m_miss_stride = 0;
 
 private:
   MemoryCache(const MemoryCache &) = delete;
   const MemoryCache &operator=(const MemoryCache &) = delete;
 
   lldb::DataBufferSP GetL2CacheLine(lldb::addr_t addr, Status &error);
+
+  std::vector<lldb::addr_t> GetL2CacheLinesToPrefetch(lldb::addr_t miss_addr);
 };
 
     
@@ -82,6 +82,7 @@ public:
 
   bool GetDisableMemoryCache() const;
   uint64_t GetMemoryCacheLineSize() const;
+  uint64_t GetMemoryCacheMaxPrefetchLines() const;
   Args GetExtraStartupCommands() const;
   void SetExtraStartupCommands(const Args &args);
   FileSpec GetPythonOSPluginPath() const;
@@ -1602,6 +1603,33 @@ public:
   size_t ReadMemoryFromInferior(lldb::addr_t vm_addr, void *buf, size_t size,
                                 Status &error);
 
+  /// Read several ranges of memory from a process, bypassing caching.
+  ///
+  /// Process plug-ins which can read several ranges at once, e.g. with a
+  /// single round trip to a remote stub, do so. The other ones read them one
+  /// after the other like ReadMemoryFromInferior.
+  ///
+  /// \param[in] ranges
+  ///     The ranges of virtual load addresses to read.
+  ///
+  /// \param[out] buf
+  ///     A byte buffer which receives the bytes of all the ranges, one range
+  ///     after the other. It must be at least as long as the sum of the sizes
+  ///     of the ranges.
+  ///
+  /// \return
+  ///     The number of bytes that were actually read for each range. Zero is
+  ///     returned for the ranges which could not be read.
+  std::vector<size_t> ReadMemoryRangesFromInferior(
+      llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges, uint8_t *buf);
+
+  /// Read several ranges of memory with ReadMemoryRangesFromInferior and add
+  /// the bytes which could be read to the memory cache, so that later reads
+  /// of these ranges don't go to the process. Does nothing if the memory
+  /// cache is disabled.
+  void PrefetchMemoryRanges(
+      llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges);
+
   /// Read a NULL terminated C string from memory
   ///
   /// This function will read a cache page at a time until the NULL
@@ -2778,6 +2806,25 @@ protected:
   virtual size_t DoReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
                               Status &error) = 0;
 
+  /// Actually do the reading of several ranges of memory from a process.
+  ///
+  /// Subclasses can override this function to read the ranges with fewer
+  /// requests than one per range. The default implementation reads them one
+  /// after the other with DoReadMemory.
+  ///
+  /// \param[in] ranges
+  ///     The ranges of virtual load addresses to read.
+  ///
+  /// \param[out] buf
+  ///     A byte buffer which receives the bytes of all the ranges, one range
+  ///     after the other.
+  ///
+  /// \return
+  ///     The number of bytes that were actually read for each range.
+  virtual std::vector<size_t>
+  DoReadMemoryRanges(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+                     uint8_t *buf);
+
   /// DoGetMemoryRegionInfo is called by GetMemoryRegionInfo after it has
   /// removed non address bits from load_addr. Override this method in
   /// subclasses of Process.
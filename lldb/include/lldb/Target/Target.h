@@ -12,6 +12,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -1174,6 +1175,19 @@ public:
                                const EvaluateExpressionOptions &options,
                                ValueObject *ctx_obj, Status &error);
 
+  // Returns the parsed expression cached under "key" if it can run in
+  // "exe_ctx", i.e. in the same process at the same pc, and removes it from
+  // the cache while the caller uses it. Returns nullptr otherwise.
+  lldb::UserExpressionSP TakeCachedUserExpression(llvm::StringRef key,
+                                                  ExecutionContext &exe_ctx);
+
+  // Caches a parsed expression, whose JIT'ed code is kept in the process, so
+  // that evaluating the same expression again can skip parsing it.
+  void CacheUserExpression(llvm::StringRef key,
+                           lldb::UserExpressionSP expression_sp);
+
+  void ClearUserExpressionCache();
+
   // Creates a FunctionCaller for the given language, the rest of the
   // parameters have the same meaning as for the FunctionCaller constructor.
   // Since a FunctionCaller can't be
@@ -1567,6 +1581,10 @@ protected:
   lldb::SearchFilterSP m_search_filter_sp;
   PathMappingList m_image_search_paths;
   TypeSystemMap m_scratch_type_system_map;
+  /// Parsed expressions which can be evaluated again, most recent last.
+  std::vector<std::pair<std::string, lldb::UserExpressionSP>>
+      m_user_expression_cache;
+  std::mutex m_user_expression_cache_mutex;
 
   typedef std::map<lldb::LanguageType, lldb::REPLSP> REPLMap;
   REPLMap m_repl_map;
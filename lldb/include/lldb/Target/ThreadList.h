@@ -129,6 +129,19 @@ public:
 
   void DiscardThreadPlans();
 
+  /// Unwind the first \a num_frames frames of the threads \a tids ahead of
+  /// printing or walking their backtraces.
+  ///
+  /// The threads of processes which aren't live, like core files, are unwound
+  /// in parallel. For live processes, whose plug-ins talk to the process one
+  /// request at a time, the top of the stack of every thread is read into
+  /// the memory cache in one batch instead.
+  ///
+  /// \param[in] num_frames
+  ///     The number of frames to unwind, UINT32_MAX for all of them.
+  void PrefetchStackFrames(llvm::ArrayRef<lldb::tid_t> tids,
+                           uint32_t num_frames);
+
   uint32_t GetStopID() const;
 
   void SetStopID(uint32_t stop_id);
@@ -172,6 +172,8 @@ public:
     eServerPacketType_jLLDBTraceGetState,
     eServerPacketType_jLLDBTraceGetBinaryData,
 
+    eServerPacketType_MultiMemRead, // read several ranges of memory
+
     eServerPacketType_qMemTags, // read memory tags
     eServerPacketType_QMemTags, // write memory tags
 
@@ -207,6 +207,16 @@ protected:
     }
   }
 
+  void WillHandleThreads(llvm::ArrayRef<lldb::tid_t> tids) override {
+    // Unique stacks are bucketed by all of their frames.
+    uint32_t num_frames = UINT32_MAX;
+    if (!m_unique_stacks && m_options.m_count != UINT32_MAX &&
+        m_options.m_start < UINT32_MAX - m_options.m_count)
+      num_frames = m_options.m_start + m_options.m_count;
+    m_exe_ctx.GetProcessPtr()->GetThreadList().PrefetchStackFrames(tids,
+                                                                   num_frames);
+  }
+
   bool HandleOneThread(lldb::tid_t tid, CommandReturnObject &result) override {
     ThreadSP thread_sp =
         m_exe_ctx.GetProcessPtr()->GetThreadList().FindThreadByID(tid);
@@ -68,6 +68,10 @@ protected:
 
   virtual bool HandleOneThread(lldb::tid_t, CommandReturnObject &result) = 0;
 
+  // Override this to do work for all the threads before they are handled one
+  // at a time, e.g. to compute their backtraces in parallel.
+  virtual void WillHandleThreads(llvm::ArrayRef<lldb::tid_t> tids) {}
+
   bool BucketThread(lldb::tid_t tid, std::set<UniqueStack> &unique_stacks,
                     CommandReturnObject &result);
 
@@ -40,6 +40,7 @@
 #include "lldb/Utility/State.h"
 #include "lldb/Utility/StreamString.h"
 #include "llvm/BinaryFormat/Dwarf.h"
+#include "llvm/Support/FormatVariadic.h"
 
 using namespace lldb_private;
 
@@ -249,21 +250,55 @@ UserExpression::Evaluate(ExecutionContext &exe_ctx,
       language = frame->GetLanguage();
   }
 
-  lldb::UserExpressionSP user_expression_sp(
-      target->GetUserExpressionForLanguage(expr, full_prefix, language,
-                                           desired_type, options, ctx_obj,
-                                           error));
-  if (error.Fail() || !user_expression_sp) {
-    LLDB_LOG(log, "== [UserExpression::Evaluate] Getting expression: {0} ==",
-             error.AsCString());
-    return lldb::eExpressionSetupError;
+  const bool keep_expression_in_memory = true;
+  const bool generate_debug_info = options.GetGenerateDebugInfo();
+
+  // Conditional breakpoints and data formatters evaluate the same expression
+  // over and over, so reuse the parsed and JIT'ed expression of a previous
+  // evaluation at the same pc. Expressions which refer to persistent
+  // variables or types are bound to them when they are parsed, so they are
+  // always parsed again. The target settings which change how expressions
+  // are parsed are part of the key, so changing them parses them again.
+  std::string cache_key;
+  if (process && !ctx_obj && execution_policy != eExecutionPolicyTopLevel &&
+      !options.GetREPLEnabled() && !options.GetPoundLineFilePath() &&
+      !expr.contains('$') && !full_prefix.contains('$')) {
+    std::string module_search_paths;
+    FileSpecList module_search_path_list = target->GetClangModuleSearchPaths();
+    for (const FileSpec &path : module_search_path_list.files())
+      module_search_paths += path.GetPath() + ':';
+    cache_key =
+        llvm::formatv("{0},{1},{2},{3},{4},{5},{6},{7},{8},{9}\n{10}\n{11}",
+                      language.name, language.version, (int)desired_type,
+                      (int)execution_policy, generate_debug_info,
+                      (int)options.GetUseDynamic(),
+                      (int)target->GetImportStdModule(),
+                      target->GetEnableAutoImportClangModules(),
+                      target->GetInjectLocalVariables(&exe_ctx),
+                      module_search_paths, full_prefix, expr)
+            .str();
   }
 
-  LLDB_LOG(log, "== [UserExpression::Evaluate] Parsing expression {0} ==",
-           expr.str());
+  lldb::UserExpressionSP user_expression_sp;
+  if (!cache_key.empty())
+    user_expression_sp = target->TakeCachedUserExpression(cache_key, exe_ctx);
+  const bool is_cached = (bool)user_expression_sp;
+
+  if (is_cached) {
+    LLDB_LOG(log, "== [UserExpression::Evaluate] Reusing expression {0} ==",
+             expr.str());
+  } else {
+    user_expression_sp.reset(target->GetUserExpressionForLanguage(
+        expr, full_prefix, language, desired_type, options, ctx_obj, error));
+    if (error.Fail() || !user_expression_sp) {
+      LLDB_LOG(log, "== [UserExpression::Evaluate] Getting expression: {0} ==",
+               error.AsCString());
+      return lldb::eExpressionSetupError;
+    }
 
-  const bool keep_expression_in_memory = true;
-  const bool generate_debug_info = options.GetGenerateDebugInfo();
+    LLDB_LOG(log, "== [UserExpression::Evaluate] Parsing expression {0} ==",
+             expr.str());
+  }
 
   if (options.InvokeCancelCallback(lldb::eExpressionEvaluationParse)) {
     error.SetErrorString("expression interrupted by callback before parse");
@@ -275,8 +310,13 @@ UserExpression::Evaluate(ExecutionContext &exe_ctx,
   DiagnosticManager diagnostic_manager;
 
   bool parse_success =
+      is_cached ||
       user_expression_sp->Parse(diagnostic_manager, exe_ctx, execution_policy,
                                 keep_expression_in_memory, generate_debug_info);
+  // Expressions which needed fix-its are parsed again so that the fixed
+  // expression keeps being reported.
+  bool can_cache = !cache_key.empty() && parse_success &&
+                   user_expression_sp->IsParseCacheable();
 
   // Calculate the fixed expression always, since we need it for errors.
   std::string tmp_fixed_expression;
@@ -352,6 +392,8 @@ UserExpression::Evaluate(ExecutionContext &exe_ctx,
         error.SetExpressionError(lldb::eExpressionSetupError,
                                  "expression needed to run but couldn't");
     } else if (execution_policy == eExecutionPolicyTopLevel) {
+      // Names in cached expressions may now resolve to the new declarations.
+      target->ClearUserExpressionCache();
       error.SetError(UserExpression::kNoResult, lldb::eErrorTypeGeneric);
       return lldb::eExpressionCompleted;
     } else {
@@ -398,6 +440,9 @@ UserExpression::Evaluate(ExecutionContext &exe_ctx,
 
           error.SetError(UserExpression::kNoResult, lldb::eErrorTypeGeneric);
         }
+
+        if (can_cache)
+          target->CacheUserExpression(cache_key, user_expression_sp);
       }
     }
   }
@@ -194,6 +194,92 @@ GDBRemoteClientBase::SendPacketAndWaitForResponse(
   return SendPacketAndWaitForResponseNoLock(payload, response);
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteClientBase::SendPacketsAndWaitForResponses(
+    llvm::ArrayRef<std::string> payloads,
+    std::vector<StringExtractorGDBRemote> &responses,
+    std::chrono::seconds interrupt_timeout) {
+  responses.clear();
+  responses.resize(payloads.size());
+  if (payloads.empty())
+    return PacketResult::Success;
+
+  Lock lock(*this, interrupt_timeout);
+  if (!lock) {
+    if (Log *log = GetLog(GDBRLog::Process))
+      LLDB_LOGF(log,
+                "GDBRemoteClientBase::%s failed to get mutex, not sending "
+                "%zu packets",
+                __FUNCTION__, payloads.size());
+    return PacketResult::ErrorSendFailed;
+  }
+
+  if (GetSendAcks()) {
+    for (size_t i = 0; i < payloads.size(); ++i) {
+      PacketResult packet_result =
+          SendPacketAndWaitForResponseNoLock(payloads[i], responses[i]);
+      if (packet_result != PacketResult::Success)
+        return packet_result;
+    }
+    return PacketResult::Success;
+  }
+
+  // Keep the number of packets in flight bounded, so that the responses
+  // waiting to be read can't fill up the buffers of the connection.
+  const size_t max_packets_in_flight = 32;
+  size_t num_sent = 0;
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    while (num_sent < payloads.size() &&
+           num_sent < i + max_packets_in_flight) {
+      PacketResult packet_result = SendPacketNoLock(payloads[num_sent]);
+      if (packet_result != PacketResult::Success) {
+        DiscardResponsesNoLock(num_sent - i);
+        return packet_result;
+      }
+      ++num_sent;
+    }
+    // Syncing with qEcho on a timeout expects a single packet in flight, so
+    // the outstanding responses are discarded here instead.
+    PacketResult packet_result =
+        ReadPacket(responses[i], GetPacketTimeout(), false);
+    if (packet_result != PacketResult::Success) {
+      // The response to this packet may still arrive after a timeout.
+      DiscardResponsesNoLock(num_sent - i);
+      return packet_result;
+    }
+    // The responses are matched to the payloads by their order, so an invalid
+    // response can't be skipped like SendPacketAndWaitForResponseNoLock does.
+    if (!responses[i].ValidateResponse()) {
+      Log *log = GetLog(GDBRLog::Packets);
+      LLDB_LOGF(log,
+                "error: packet with payload \"%s\" got invalid response "
+                "\"%s\": using invalid response",
+                payloads[i].c_str(), responses[i].GetStringRef().data());
+    }
+  }
+  return PacketResult::Success;
+}
+
+void GDBRemoteClientBase::DiscardResponsesNoLock(size_t count) {
+  Log *log = GetLog(GDBRLog::Packets);
+  for (size_t i = 0; i < count && IsConnected(); ++i) {
+    StringExtractorGDBRemote response;
+    if (ReadPacket(response, GetPacketTimeout(), false) !=
+        PacketResult::Success) {
+      // There are no sequence numbers in the protocol, so a response that
+      // arrives later could be taken for the response to another packet.
+      LLDB_LOGF(log,
+                "GDBRemoteClientBase::%s failed to read %zu outstanding "
+                "responses, disconnecting",
+                __FUNCTION__, count - i);
+      Disconnect();
+      return;
+    }
+    LLDB_LOG(log, "discarding outstanding response `{0}`",
+             response.GetStringRef());
+  }
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteClientBase::ReadPacketWithOutputSupport(
     StringExtractorGDBRemote &response, Timeout<std::micro> timeout,
@@ -58,6 +58,15 @@ public:
       llvm::StringRef payload, StringExtractorGDBRemote &response,
       std::chrono::seconds interrupt_timeout = std::chrono::seconds(0));
 
+  // Sends all of the payloads before waiting for any of the responses, so that
+  // the round trips to the remote stub overlap. This is only done when acks
+  // are disabled, otherwise the packets are sent one at a time. The responses
+  // are returned in the same order as the payloads.
+  PacketResult SendPacketsAndWaitForResponses(
+      llvm::ArrayRef<std::string> payloads,
+      std::vector<StringExtractorGDBRemote> &responses,
+      std::chrono::seconds interrupt_timeout = std::chrono::seconds(0));
+
   PacketResult ReadPacketWithOutputSupport(
       StringExtractorGDBRemote &response, Timeout<std::micro> timeout,
       bool sync_on_timeout,
@@ -104,6 +113,11 @@ protected:
   virtual void OnRunPacketSent(bool first);
 
 private:
+  /// Reads and drops the responses to \a count packets that were sent but
+  /// whose responses will not be used, so that the next packet gets its own
+  /// response. Disconnects if they can't be read.
+  void DiscardResponsesNoLock(size_t count);
+
   /// Variables handling synchronization between the Continue thread and any
   /// other threads wishing to send packets over the connection. Either the
   /// continue thread has control over the connection (m_is_running == true) or
@@ -285,6 +285,7 @@ void GDBRemoteCommunicationClient::ResetDiscoverableSettings(bool did_exec) {
     m_avoid_g_packets = eLazyBoolCalculate;
     m_supports_multiprocess = eLazyBoolCalculate;
     m_supports_qSaveCore = eLazyBoolCalculate;
+    m_supports_multi_mem_read = eLazyBoolCalculate;
     m_supports_qXfer_auxv_read = eLazyBoolCalculate;
     m_supports_qXfer_libraries_read = eLazyBoolCalculate;
     m_supports_qXfer_libraries_svr4_read = eLazyBoolCalculate;
@@ -345,6 +346,7 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
   m_supports_QPassSignals = eLazyBoolNo;
   m_supports_memory_tagging = eLazyBoolNo;
   m_supports_qSaveCore = eLazyBoolNo;
+  m_supports_multi_mem_read = eLazyBoolNo;
   m_uses_native_signals = eLazyBoolNo;
 
   m_max_packet_size = UINT64_MAX; // It's supposed to always be there, but if
@@ -394,6 +396,8 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
         m_supports_memory_tagging = eLazyBoolYes;
       else if (x == "qSaveCore+")
         m_supports_qSaveCore = eLazyBoolYes;
+      else if (x == "MultiMemRead+")
+        m_supports_multi_mem_read = eLazyBoolYes;
       else if (x == "native-signals+")
         m_uses_native_signals = eLazyBoolYes;
       // Look for a list of compressions in the features list e.g.
@@ -648,6 +652,12 @@ bool GDBRemoteCommunicationClient::GetMemoryTaggingSupported() {
   return m_supports_memory_tagging == eLazyBoolYes;
 }
 
+bool GDBRemoteCommunicationClient::GetMultiMemReadSupported() {
+  if (m_supports_multi_mem_read == eLazyBoolCalculate)
+    GetRemoteQSupported();
+  return m_supports_multi_mem_read == eLazyBoolYes;
+}
+
 DataBufferSP GDBRemoteCommunicationClient::ReadMemoryTags(lldb::addr_t addr,
                                                           size_t len,
                                                           int32_t type) {
@@ -692,6 +702,123 @@ DataBufferSP GDBRemoteCommunicationClient::ReadMemoryTags(lldb::addr_t addr,
   return buffer_sp;
 }
 
+std::vector<size_t> GDBRemoteCommunicationClient::ReadMemoryRanges(
+    llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges, uint8_t *buf,
+    size_t max_read_size) {
+  std::vector<size_t> bytes_read(ranges.size(), 0);
+  std::vector<size_t> offsets(ranges.size(), 0);
+  for (size_t i = 1; i < ranges.size(); ++i)
+    offsets[i] = offsets[i - 1] + ranges[i - 1].GetByteSize();
+
+  const bool multi_mem_read = GetMultiMemReadSupported();
+  const bool binary_memory_read = multi_mem_read || GetxPacketSupported();
+  // Bound the number of ranges of a MultiMemRead packet, to keep the request
+  // well below the packet size the remote can receive.
+  const size_t max_ranges_per_packet = 64;
+
+  // The ranges of each packet, which are consecutive in the list of ranges.
+  std::vector<std::pair<size_t, size_t>> packet_ranges;
+  size_t packet_read_size = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    const size_t size = ranges[i].GetByteSize();
+    if (size == 0)
+      continue;
+    assert(size <= max_read_size);
+    if (multi_mem_read && !packet_ranges.empty() &&
+        packet_ranges.back().second == i &&
+        i - packet_ranges.back().first < max_ranges_per_packet &&
+        packet_read_size + size <= max_read_size) {
+      packet_ranges.back().second = i + 1;
+      packet_read_size += size;
+      continue;
+    }
+    packet_ranges.push_back({i, i + 1});
+    packet_read_size = size;
+  }
+
+  std::vector<std::string> payloads;
+  for (auto [begin, end] : packet_ranges) {
+    StreamString packet;
+    if (multi_mem_read) {
+      // Format MultiMemRead:ranges:address,length[,address,length]*;
+      packet.PutCString("MultiMemRead:ranges:");
+      for (size_t i = begin; i < end; ++i)
+        packet.Printf("%s%" PRIx64 ",%zx", i == begin ? "" : ",",
+                      ranges[i].GetRangeBase(), ranges[i].GetByteSize());
+      packet.PutChar(';');
+    } else {
+      packet.Printf("%c%" PRIx64 ",%zx", binary_memory_read ? 'x' : 'm',
+                    ranges[begin].GetRangeBase(), ranges[begin].GetByteSize());
+    }
+    payloads.push_back(std::string(packet.GetString()));
+  }
+
+  Log *log = GetLog(GDBRLog::Memory);
+  std::vector<StringExtractorGDBRemote> responses;
+  if (SendPacketsAndWaitForResponses(payloads, responses) !=
+      PacketResult::Success) {
+    LLDB_LOGF(log, "GDBRemoteCommunicationClient::%s: memory read failed",
+              __FUNCTION__);
+    return bytes_read;
+  }
+
+  for (size_t p = 0; p < packet_ranges.size(); ++p) {
+    auto [begin, end] = packet_ranges[p];
+    StringExtractorGDBRemote &response = responses[p];
+    if (!response.IsNormalResponse())
+      continue;
+
+    if (!multi_mem_read) {
+      const size_t size = ranges[begin].GetByteSize();
+      uint8_t *dst = buf + offsets[begin];
+      if (binary_memory_read) {
+        // The packet receive layer has already de-quoted any 0x7d character
+        // escaping that was present in the packet.
+        bytes_read[begin] = std::min(response.GetBytesLeft(), size);
+        memcpy(dst, response.GetStringRef().data(), bytes_read[begin]);
+      } else {
+        bytes_read[begin] = response.GetHexBytes(
+            llvm::MutableArrayRef<uint8_t>(dst, size), '\xdd');
+      }
+      continue;
+    }
+
+    // We are expecting
+    // length[,length]*;<binary data of all the ranges>
+    auto [lengths, data] = response.GetStringRef().split(';');
+    llvm::SmallVector<llvm::StringRef, 16> length_strs;
+    lengths.split(length_strs, ',');
+    std::vector<size_t> packet_bytes_read;
+    for (llvm::StringRef length_str : length_strs) {
+      size_t length;
+      if (length_str.getAsInteger(16, length))
+        break;
+      packet_bytes_read.push_back(length);
+    }
+    if (packet_bytes_read.size() != end - begin) {
+      LLDB_LOGF(log,
+                "GDBRemoteCommunicationClient::%s: invalid MultiMemRead "
+                "response \"%s\"",
+                __FUNCTION__, lengths.str().c_str());
+      continue;
+    }
+    for (size_t i = begin; i < end; ++i) {
+      const size_t length = packet_bytes_read[i - begin];
+      if (length > ranges[i].GetByteSize() || length > data.size()) {
+        LLDB_LOGF(log,
+                  "GDBRemoteCommunicationClient::%s: MultiMemRead response "
+                  "has too few bytes for 0x%" PRIx64,
+                  __FUNCTION__, ranges[i].GetRangeBase());
+        break;
+      }
+      memcpy(buf + offsets[i], data.data(), length);
+      bytes_read[i] = length;
+      data = data.drop_front(length);
+    }
+  }
+  return bytes_read;
+}
+
 Status GDBRemoteCommunicationClient::WriteMemoryTags(
     lldb::addr_t addr, size_t len, int32_t type,
     const std::vector<uint8_t> &tags) {
@@ -23,6 +23,7 @@
 #include "lldb/Utility/ArchSpec.h"
 #include "lldb/Utility/GDBRemote.h"
 #include "lldb/Utility/ProcessInfo.h"
+#include "lldb/Utility/RangeMap.h"
 #include "lldb/Utility/StructuredData.h"
 #include "lldb/Utility/TraceGDBRemotePackets.h"
 #include "lldb/Utility/UUID.h"
@@ -432,11 +433,35 @@ public:
 
   bool GetMemoryTaggingSupported();
 
+  bool GetMultiMemReadSupported();
+
   bool UsesNativeSignals();
 
   lldb::DataBufferSP ReadMemoryTags(lldb::addr_t addr, size_t len,
                                     int32_t type);
 
+  /// Read several ranges of memory in as few round trips as possible. The
+  /// ranges are read with MultiMemRead packets if the remote supports them,
+  /// otherwise their x or m packets are pipelined.
+  ///
+  /// \param[in] ranges
+  ///     The ranges to read. Each of them must be at most \a max_read_size
+  ///     bytes long.
+  ///
+  /// \param[out] buf
+  ///     A buffer which receives the bytes of all the ranges, one range after
+  ///     the other.
+  ///
+  /// \param[in] max_read_size
+  ///     The maximum number of bytes to read with one packet.
+  ///
+  /// \return
+  ///     The number of bytes read for each range, which is zero for the ranges
+  ///     which could not be read.
+  std::vector<size_t>
+  ReadMemoryRanges(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+                   uint8_t *buf, size_t max_read_size);
+
   Status WriteMemoryTags(lldb::addr_t addr, size_t len, int32_t type,
                          const std::vector<uint8_t> &tags);
 
@@ -559,6 +584,7 @@ protected:
   LazyBool m_supports_error_string_reply = eLazyBoolCalculate;
   LazyBool m_supports_multiprocess = eLazyBoolCalculate;
   LazyBool m_supports_memory_tagging = eLazyBoolCalculate;
+  LazyBool m_supports_multi_mem_read = eLazyBoolCalculate;
   LazyBool m_supports_qSaveCore = eLazyBoolCalculate;
   LazyBool m_uses_native_signals = eLazyBoolCalculate;
 
@@ -30,6 +30,10 @@ public:
   ~GDBRemoteCommunicationServerCommon() override;
 
 protected:
+  // The max packet size advertised in qSupported. 128KBytes is a reasonable
+  // max packet size--debugger can always use less.
+  static constexpr uint32_t MaxPacketSize = 128 * 1024;
+
   ProcessLaunchInfo m_process_launch_info;
   Status m_process_launch_error;
   ProcessInstanceInfoList m_proc_infos;
@@ -94,6 +94,9 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
       &GDBRemoteCommunicationServerLLGS::Handle_memory_read);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_M,
                                 &GDBRemoteCommunicationServerLLGS::Handle_M);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_MultiMemRead,
+      &GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType__M,
                                 &GDBRemoteCommunicationServerLLGS::Handle__M);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType__m,
@@ -2554,6 +2557,74 @@ GDBRemoteCommunicationServerLLGS::Handle_memory_read(
   return SendPacketNoLock(response.GetString());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead(
+    StringExtractorGDBRemote &packet) {
+  Log *log = GetLog(LLDBLog::Process);
+
+  if (!m_current_process ||
+      (m_current_process->GetID() == LLDB_INVALID_PROCESS_ID)) {
+    LLDB_LOGF(
+        log,
+        "GDBRemoteCommunicationServerLLGS::%s failed, no process available",
+        __FUNCTION__);
+    return SendErrorResponse(0x15);
+  }
+
+  // Parse out the ranges:
+  // MultiMemRead:ranges:address,length[,address,length]*;
+  llvm::StringRef ranges_str = packet.GetStringRef();
+  if (!ranges_str.consume_front("MultiMemRead:ranges:") ||
+      !ranges_str.consume_back(";"))
+    return SendIllFormedResponse(packet, "Invalid MultiMemRead packet");
+
+  llvm::SmallVector<llvm::StringRef, 32> fields;
+  ranges_str.split(fields, ',');
+  if (fields.size() % 2 != 0)
+    return SendIllFormedResponse(packet, "Invalid ranges in MultiMemRead");
+
+  std::vector<std::pair<lldb::addr_t, size_t>> ranges;
+  for (size_t i = 0; i < fields.size(); i += 2) {
+    lldb::addr_t addr;
+    size_t size;
+    if (fields[i].getAsInteger(16, addr) ||
+        fields[i + 1].getAsInteger(16, size))
+      return SendIllFormedResponse(packet, "Invalid range in MultiMemRead");
+    ranges.push_back({addr, size});
+  }
+
+  // The reply is the number of bytes read for each range, followed by the
+  // bytes of all the ranges. A range which can't be read isn't an error, it
+  // is just reported as 0 bytes read. Reading stops at the max packet size,
+  // so that the client can't make us allocate an unbounded buffer.
+  StreamGDBRemote lengths;
+  std::string data;
+  for (auto [addr, size] : ranges) {
+    size_t offset = data.size();
+    size = std::min<size_t>(size, MaxPacketSize - offset);
+    data.resize(offset + size);
+    size_t bytes_read = 0;
+    Status error = m_current_process->ReadMemoryWithoutTrap(
+        addr, &data[offset], size, bytes_read);
+    if (error.Fail()) {
+      LLDB_LOGF(log,
+                "GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64
+                " mem 0x%" PRIx64 ": failed to read. Error: %s",
+                __FUNCTION__, m_current_process->GetID(), addr,
+                error.AsCString());
+      bytes_read = 0;
+    }
+    data.resize(offset + bytes_read);
+    lengths.Printf("%s%zx", lengths.GetSize() == 0 ? "" : ",", bytes_read);
+  }
+
+  StreamGDBRemote response;
+  response.PutCString(lengths.GetString());
+  response.PutChar(';');
+  response.PutEscapedBytes(data.data(), data.size());
+  return SendPacketNoLock(response.GetString());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle__M(StringExtractorGDBRemote &packet) {
   Log *log = GetLog(LLDBLog::Process);
@@ -4213,6 +4284,7 @@ std::vector<std::string> GDBRemoteCommunicationServerLLGS::HandleFeatures(
                             "QListThreadsInStopReply+",
                             "qXfer:features:read+",
                             "QNonStop+",
+                            "MultiMemRead+",
                         });
 
   // report server-only features
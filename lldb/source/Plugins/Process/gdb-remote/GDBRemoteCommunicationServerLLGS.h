@@ -198,6 +198,8 @@ protected:
   // Handles $m and $x packets.
   PacketResult Handle_memory_read(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_MultiMemRead(StringExtractorGDBRemote &packet);
+
   PacketResult Handle_M(StringExtractorGDBRemote &packet);
   PacketResult Handle__M(StringExtractorGDBRemote &packet);
   PacketResult Handle__m(StringExtractorGDBRemote &packet);
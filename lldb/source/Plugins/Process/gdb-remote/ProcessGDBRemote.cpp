@@ -2620,6 +2620,48 @@ size_t ProcessGDBRemote::DoReadMemory(addr_t addr, void *buf, size_t size,
   return 0;
 }
 
+std::vector<size_t> ProcessGDBRemote::DoReadMemoryRanges(
+    llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges, uint8_t *buf) {
+  GetMaxMemorySize();
+  bool binary_memory_read = m_gdb_comm.GetMultiMemReadSupported() ||
+                            m_gdb_comm.GetxPacketSupported();
+  // M and m packets take 2 bytes for 1 byte of memory
+  size_t max_memory_size =
+      binary_memory_read ? m_max_memory_size : m_max_memory_size / 2;
+
+  // Split the ranges into pieces which fit in one packet. The pieces of a
+  // range are consecutive, and so is their data in the buffer.
+  std::vector<Range<lldb::addr_t, size_t>> pieces;
+  std::vector<size_t> piece_range_indexes;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    addr_t addr = ranges[i].GetRangeBase();
+    size_t size = ranges[i].GetByteSize();
+    while (size > 0) {
+      size_t piece_size = std::min(size, max_memory_size);
+      pieces.push_back({addr, piece_size});
+      piece_range_indexes.push_back(i);
+      addr += piece_size;
+      size -= piece_size;
+    }
+  }
+
+  std::vector<size_t> piece_bytes_read =
+      m_gdb_comm.ReadMemoryRanges(pieces, buf, max_memory_size);
+
+  // The bytes of a range are only valid up to its first short piece.
+  std::vector<size_t> bytes_read(ranges.size(), 0);
+  std::vector<bool> range_done(ranges.size(), false);
+  for (size_t p = 0; p < pieces.size(); ++p) {
+    size_t i = piece_range_indexes[p];
+    if (range_done[i])
+      continue;
+    bytes_read[i] += piece_bytes_read[p];
+    if (piece_bytes_read[p] < pieces[p].GetByteSize())
+      range_done[i] = true;
+  }
+  return bytes_read;
+}
+
 bool ProcessGDBRemote::SupportsMemoryTagging() {
   return m_gdb_comm.GetMemoryTaggingSupported();
 }
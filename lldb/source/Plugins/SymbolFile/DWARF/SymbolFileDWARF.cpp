@@ -12,8 +12,10 @@
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Threading.h"
 
+#include "lldb/Core/Debugger.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleList.h"
 #include "lldb/Core/ModuleSpec.h"
@@ -129,6 +131,10 @@ public:
   bool IgnoreFileIndexes() const {
     return GetPropertyAtIndexAs<bool>(ePropertyIgnoreIndexes, false);
   }
+
+  bool PreloadVariableTypes() const {
+    return GetPropertyAtIndexAs<bool>(ePropertyPreloadVariableTypes, false);
+  }
 };
 
 } // namespace
@@ -3359,6 +3365,8 @@ size_t SymbolFileDWARF::ParseVariablesForContext(const SymbolContext &sc) {
       if (!ranges.IsEmpty())
         func_lo_pc = ranges.GetMinRangeBase(0);
       if (func_lo_pc != LLDB_INVALID_ADDRESS) {
+        if (GetGlobalPluginProperties().PreloadVariableTypes())
+          PreloadVariableTypeDIEs(function_die);
         const size_t num_variables =
             ParseVariablesInFunctionContext(sc, function_die, func_lo_pc);
 
@@ -3943,6 +3951,94 @@ SymbolFileDWARF::MergeBlockAbstractParameters(const DWARFDIE &block_die,
   return merged;
 }
 
+void SymbolFileDWARF::PreloadVariableTypeDIEs(const DWARFDIE &function_die) {
+  LLDB_SCOPED_TIMER();
+
+  // The number of levels of type references which are followed.
+  constexpr unsigned max_depth = 8;
+
+  std::vector<DWARFDIE> worklist;
+  std::vector<DWARFDIE> blocks = {function_die};
+  while (!blocks.empty()) {
+    DWARFDIE block = blocks.back();
+    blocks.pop_back();
+    for (DWARFDIE child : block.children()) {
+      switch (child.Tag()) {
+      case DW_TAG_variable:
+      case DW_TAG_constant:
+      case DW_TAG_formal_parameter:
+        worklist.push_back(child);
+        break;
+      case DW_TAG_lexical_block:
+      case DW_TAG_inlined_subroutine:
+        blocks.push_back(child);
+        break;
+      default:
+        break;
+      }
+    }
+  }
+
+  llvm::DenseSet<const DWARFDebugInfoEntry *> visited;
+  for (unsigned depth = 0; depth < max_depth && !worklist.empty(); ++depth) {
+    std::vector<std::pair<DWARFUnit *, uint64_t>> refs;
+    llvm::SetVector<DWARFUnit *> units;
+    auto add_type_ref = [&](const DWARFDIE &die) {
+      DWARFFormValue form_value;
+      if (!die.GetDIE()->GetAttributeValue(die.GetCU(), DW_AT_type,
+                                           form_value))
+        return;
+      auto [unit, offset] = form_value.ReferencedUnitAndOffset();
+      if (!unit)
+        return;
+      refs.emplace_back(unit, offset);
+      units.insert(unit);
+    };
+
+    for (const DWARFDIE &die : worklist) {
+      switch (die.Tag()) {
+      case DW_TAG_pointer_type:
+      case DW_TAG_reference_type:
+      case DW_TAG_rvalue_reference_type:
+      case DW_TAG_ptr_to_member_type:
+        // Pointees are only completed when they are dereferenced.
+        continue;
+      default:
+        break;
+      }
+      add_type_ref(die);
+      for (DWARFDIE child : die.children()) {
+        switch (child.Tag()) {
+        case DW_TAG_member:
+        case DW_TAG_inheritance:
+        case DW_TAG_template_type_parameter:
+        case DW_TAG_template_value_parameter:
+          add_type_ref(child);
+          break;
+        default:
+          break;
+        }
+      }
+    }
+
+    // Units which are already extracted return right away, the others are
+    // extracted in parallel like when indexing.
+    if (units.size() > 1) {
+      llvm::ThreadPoolTaskGroup task_group(Debugger::GetThreadPool());
+      for (DWARFUnit *unit : units)
+        task_group.async([unit]() { unit->ExtractDIEsIfNeeded(); });
+      task_group.wait();
+    }
+
+    worklist.clear();
+    for (const auto &[unit, offset] : refs) {
+      DWARFDIE type_die = unit->GetDIE(offset);
+      if (type_die && visited.insert(type_die.GetDIE()).second)
+        worklist.push_back(type_die);
+    }
+  }
+}
+
 size_t SymbolFileDWARF::ParseVariablesInFunctionContext(
     const SymbolContext &sc, const DWARFDIE &die,
     const lldb::addr_t func_low_pc) {
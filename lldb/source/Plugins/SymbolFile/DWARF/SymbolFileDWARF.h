@@ -420,6 +420,16 @@ protected:
                                          const DWARFDIE &die,
                                          const lldb::addr_t func_low_pc);
 
+  /// Extract, in parallel, the DIEs of the units which hold the types of the
+  /// variables in the function \p function_die, following the types needed
+  /// to complete them (typedefs, qualifiers, arrays, members, base classes
+  /// and template arguments) but not pointees.
+  ///
+  /// Building the clang types still happens serially on demand, but it no
+  /// longer has to extract each unit it runs into one after the other. Only
+  /// done when plugin.symbol-file.dwarf.preload-variable-types is set.
+  void PreloadVariableTypeDIEs(const DWARFDIE &function_die);
+
   size_t ParseVariablesInFunctionContextRecursive(const SymbolContext &sc,
                                                   const DWARFDIE &die,
                                                   lldb::addr_t func_low_pc,
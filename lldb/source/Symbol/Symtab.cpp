@@ -10,6 +10,7 @@
 #include <set>
 
 #include "lldb/Core/DataFileCache.h"
+#include "lldb/Core/Debugger.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/RichManglingContext.h"
 #include "lldb/Core/Section.h"
@@ -27,6 +28,7 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/DJB.h"
+#include "llvm/Support/ThreadPool.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -278,6 +280,66 @@ static bool lldb_skip_name(llvm::StringRef mangled,
   llvm_unreachable("unknown scheme!");
 }
 
+namespace {
+/// The name index entries of a contiguous range of symbols. The ranges are
+/// indexed in parallel and their entries are then appended to the name indexes
+/// in order.
+struct NameIndexChunk {
+  std::vector<Symtab::NameToIndexMap::Entry> names;
+  std::vector<Symtab::NameToIndexMap::Entry> basenames;
+  std::vector<Symtab::NameToIndexMap::Entry> methods;
+  std::vector<Symtab::NameToIndexMap::Entry> selectors;
+  /// The declaration contexts of constructors and destructors, which are known
+  /// to be classes. The "const char *" must come from a
+  /// ConstString::GetCString().
+  std::set<const char *> class_contexts;
+  /// Methods in a declaration context. They can only be registered once the
+  /// class contexts of all of the symbols are known.
+  std::vector<std::pair<Symtab::NameToIndexMap::Entry, const char *>>
+      context_methods;
+};
+} // namespace
+
+/// The number of symbols indexed by one task.
+static constexpr uint32_t g_name_index_chunk_size = 16384;
+
+static void RegisterMangledNameEntry(uint32_t value, NameIndexChunk &chunk,
+                                     RichManglingContext &rmc) {
+  // Only register functions that have a base name.
+  llvm::StringRef base_name = rmc.ParseFunctionBaseName();
+  if (base_name.empty())
+    return;
+
+  // The base name will be our entry's name.
+  Symtab::NameToIndexMap::Entry entry(ConstString(base_name), value);
+  llvm::StringRef decl_context = rmc.ParseFunctionDeclContextName();
+
+  // Register functions with no context.
+  if (decl_context.empty()) {
+    // This has to be a basename
+    chunk.basenames.push_back(entry);
+    // If there is no context (no namespaces or class scopes that come before
+    // the function name) then this also could be a fullname.
+    chunk.names.push_back(entry);
+    return;
+  }
+
+  // Make sure we have a pool-string pointer for the context name.
+  const char *decl_context_ccstr = ConstString(decl_context).GetCString();
+
+  // Register constructors and destructors. They are methods and create
+  // declaration contexts.
+  if (rmc.IsCtorOrDtor()) {
+    chunk.methods.push_back(entry);
+    chunk.class_contexts.insert(decl_context_ccstr);
+    return;
+  }
+
+  // Regular methods are registered once all of the declaration contexts are
+  // known.
+  chunk.context_methods.push_back(std::make_pair(entry, decl_context_ccstr));
+}
+
 void Symtab::InitNameIndexes() {
   // Protected function, no need to lock mutex...
   if (!m_name_indexes_computed) {
@@ -299,167 +361,145 @@ void Symtab::InitNameIndexes() {
         GetNameToSymbolIndexMap(lldb::eFunctionNameTypeMethod);
     auto &selector_to_index =
         GetNameToSymbolIndexMap(lldb::eFunctionNameTypeSelector);
-    // Create the name index vector to be able to quickly search by name
-    const size_t num_symbols = m_symbols.size();
-    name_to_index.Reserve(num_symbols);
-
-    // The "const char *" in "class_contexts" and backlog::value_type::second
-    // must come from a ConstString::GetCString()
-    std::set<const char *> class_contexts;
-    std::vector<std::pair<NameToIndexMap::Entry, const char *>> backlog;
-    backlog.reserve(num_symbols / 2);
-
-    // Instantiation of the demangler is expensive, so better use a single one
-    // for all entries during batch processing.
-    RichManglingContext rmc;
-    for (uint32_t value = 0; value < num_symbols; ++value) {
-      Symbol *symbol = &m_symbols[value];
-
-      // Don't let trampolines get into the lookup by name map If we ever need
-      // the trampoline symbols to be searchable by name we can remove this and
-      // then possibly add a new bool to any of the Symtab functions that
-      // lookup symbols by name to indicate if they want trampolines. We also
-      // don't want any synthetic symbols with auto generated names in the
-      // name lookups.
-      if (symbol->IsTrampoline() || symbol->IsSyntheticWithAutoGeneratedName())
-        continue;
-
-      // If the symbol's name string matched a Mangled::ManglingScheme, it is
-      // stored in the mangled field.
-      Mangled &mangled = symbol->GetMangled();
-      if (ConstString name = mangled.GetMangledName()) {
-        name_to_index.Append(name, value);
-
-        if (symbol->ContainsLinkerAnnotations()) {
-          // If the symbol has linker annotations, also add the version without
-          // the annotations.
-          ConstString stripped = ConstString(
-              m_objfile->StripLinkerSymbolAnnotations(name.GetStringRef()));
-          name_to_index.Append(stripped, value);
-        }
+    const uint32_t num_symbols = m_symbols.size();
+
+    auto index_symbols = [&](uint32_t begin, uint32_t end,
+                             NameIndexChunk &chunk) {
+      chunk.names.reserve(end - begin);
+      // Instantiation of the demangler is expensive, so better use a single
+      // one for all entries during batch processing.
+      RichManglingContext rmc;
+      for (uint32_t value = begin; value < end; ++value) {
+        Symbol *symbol = &m_symbols[value];
+
+        // Don't let trampolines get into the lookup by name map If we ever
+        // need the trampoline symbols to be searchable by name we can remove
+        // this and then possibly add a new bool to any of the Symtab functions
+        // that lookup symbols by name to indicate if they want trampolines. We
+        // also don't want any synthetic symbols with auto generated names in
+        // the name lookups.
+        if (symbol->IsTrampoline() ||
+            symbol->IsSyntheticWithAutoGeneratedName())
+          continue;
+
+        // If the symbol's name string matched a Mangled::ManglingScheme, it is
+        // stored in the mangled field.
+        Mangled &mangled = symbol->GetMangled();
+        if (ConstString name = mangled.GetMangledName()) {
+          chunk.names.emplace_back(name, value);
+
+          if (symbol->ContainsLinkerAnnotations()) {
+            // If the symbol has linker annotations, also add the version
+            // without the annotations.
+            ConstString stripped = ConstString(
+                m_objfile->StripLinkerSymbolAnnotations(name.GetStringRef()));
+            chunk.names.emplace_back(stripped, value);
+          }
 
-        const SymbolType type = symbol->GetType();
-        if (type == eSymbolTypeCode || type == eSymbolTypeResolver) {
-          if (mangled.GetRichManglingInfo(rmc, lldb_skip_name)) {
-            RegisterMangledNameEntry(value, class_contexts, backlog, rmc);
-            continue;
+          const SymbolType type = symbol->GetType();
+          if (type == eSymbolTypeCode || type == eSymbolTypeResolver) {
+            if (mangled.GetRichManglingInfo(rmc, lldb_skip_name)) {
+              RegisterMangledNameEntry(value, chunk, rmc);
+              continue;
+            }
           }
         }
-      }
 
-      // Symbol name strings that didn't match a Mangled::ManglingScheme, are
-      // stored in the demangled field.
-      if (ConstString name = mangled.GetDemangledName()) {
-        name_to_index.Append(name, value);
-
-        if (symbol->ContainsLinkerAnnotations()) {
-          // If the symbol has linker annotations, also add the version without
-          // the annotations.
-          name = ConstString(
-              m_objfile->StripLinkerSymbolAnnotations(name.GetStringRef()));
-          name_to_index.Append(name, value);
-        }
+        // Symbol name strings that didn't match a Mangled::ManglingScheme, are
+        // stored in the demangled field.
+        if (ConstString name = mangled.GetDemangledName()) {
+          chunk.names.emplace_back(name, value);
+
+          if (symbol->ContainsLinkerAnnotations()) {
+            // If the symbol has linker annotations, also add the version
+            // without the annotations.
+            name = ConstString(
+                m_objfile->StripLinkerSymbolAnnotations(name.GetStringRef()));
+            chunk.names.emplace_back(name, value);
+          }
 
-        // If the demangled name turns out to be an ObjC name, and is a category
-        // name, add the version without categories to the index too.
-        for (Language *lang : languages) {
-          for (auto variant : lang->GetMethodNameVariants(name)) {
-            if (variant.GetType() & lldb::eFunctionNameTypeSelector)
-              selector_to_index.Append(variant.GetName(), value);
-            else if (variant.GetType() & lldb::eFunctionNameTypeFull)
-              name_to_index.Append(variant.GetName(), value);
-            else if (variant.GetType() & lldb::eFunctionNameTypeMethod)
-              method_to_index.Append(variant.GetName(), value);
-            else if (variant.GetType() & lldb::eFunctionNameTypeBase)
-              basename_to_index.Append(variant.GetName(), value);
+          // If the demangled name turns out to be an ObjC name, and is a
+          // category name, add the version without categories to the index
+          // too.
+          for (Language *lang : languages) {
+            for (auto variant : lang->GetMethodNameVariants(name)) {
+              if (variant.GetType() & lldb::eFunctionNameTypeSelector)
+                chunk.selectors.emplace_back(variant.GetName(), value);
+              else if (variant.GetType() & lldb::eFunctionNameTypeFull)
+                chunk.names.emplace_back(variant.GetName(), value);
+              else if (variant.GetType() & lldb::eFunctionNameTypeMethod)
+                chunk.methods.emplace_back(variant.GetName(), value);
+              else if (variant.GetType() & lldb::eFunctionNameTypeBase)
+                chunk.basenames.emplace_back(variant.GetName(), value);
+            }
           }
         }
       }
+    };
+
+    // Demangling dominates the time it takes to index large symbol tables, so
+    // split them in chunks which are indexed in parallel.
+    const uint32_t num_chunks =
+        (num_symbols + g_name_index_chunk_size - 1) / g_name_index_chunk_size;
+    std::vector<NameIndexChunk> chunks(num_chunks);
+    auto index_chunk = [&](uint32_t i) {
+      const uint32_t begin = i * g_name_index_chunk_size;
+      index_symbols(begin,
+                    std::min(begin + g_name_index_chunk_size, num_symbols),
+                    chunks[i]);
+    };
+    if (num_chunks == 1) {
+      index_chunk(0);
+    } else if (num_chunks > 1) {
+      llvm::ThreadPoolTaskGroup task_group(Debugger::GetThreadPool());
+      for (uint32_t i = 0; i < num_chunks; ++i)
+        task_group.async(index_chunk, i);
+      task_group.wait();
     }
 
-    for (const auto &record : backlog) {
-      RegisterBacklogEntry(record.first, record.second, class_contexts);
+    // Merge the chunks in symbol order.
+    std::set<const char *> class_contexts;
+    size_t num_names = 0;
+    for (const NameIndexChunk &chunk : chunks) {
+      class_contexts.insert(chunk.class_contexts.begin(),
+                            chunk.class_contexts.end());
+      num_names += chunk.names.size();
+    }
+    name_to_index.Reserve(num_names);
+    for (const NameIndexChunk &chunk : chunks) {
+      for (const auto &entry : chunk.names)
+        name_to_index.Append(entry);
+      for (const auto &entry : chunk.basenames)
+        basename_to_index.Append(entry);
+      for (const auto &entry : chunk.methods)
+        method_to_index.Append(entry);
+      for (const auto &entry : chunk.selectors)
+        selector_to_index.Append(entry);
+      for (const auto &record : chunk.context_methods) {
+        method_to_index.Append(record.first);
+        // If we got here, we have something that had a context (was inside
+        // a namespace or class) yet we don't know the entry
+        if (!class_contexts.count(record.second))
+          basename_to_index.Append(record.first);
+      }
+    }
+    chunks.clear();
+
+    auto finalize = [](NameToIndexMap *map) {
+      map->Sort();
+      map->SizeToFit();
+    };
+    if (num_chunks > 1) {
+      llvm::ThreadPoolTaskGroup task_group(Debugger::GetThreadPool());
+      for (NameToIndexMap *map : {&name_to_index, &selector_to_index,
+                                  &basename_to_index, &method_to_index})
+        task_group.async(finalize, map);
+      task_group.wait();
+    } else {
+      for (NameToIndexMap *map : {&name_to_index, &selector_to_index,
+                                  &basename_to_index, &method_to_index})
+        finalize(map);
     }
-
-    name_to_index.Sort();
-    name_to_index.SizeToFit();
-    selector_to_index.Sort();
-    selector_to_index.SizeToFit();
-    basename_to_index.Sort();
-    basename_to_index.SizeToFit();
-    method_to_index.Sort();
-    method_to_index.SizeToFit();
-  }
-}
-
-void Symtab::RegisterMangledNameEntry(
-    uint32_t value, std::set<const char *> &class_contexts,
-    std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog,
-    RichManglingContext &rmc) {
-  // Only register functions that have a base name.
-  llvm::StringRef base_name = rmc.ParseFunctionBaseName();
-  if (base_name.empty())
-    return;
-
-  // The base name will be our entry's name.
-  NameToIndexMap::Entry entry(ConstString(base_name), value);
-  llvm::StringRef decl_context = rmc.ParseFunctionDeclContextName();
-
-  // Register functions with no context.
-  if (decl_context.empty()) {
-    // This has to be a basename
-    auto &basename_to_index =
-        GetNameToSymbolIndexMap(lldb::eFunctionNameTypeBase);
-    basename_to_index.Append(entry);
-    // If there is no context (no namespaces or class scopes that come before
-    // the function name) then this also could be a fullname.
-    auto &name_to_index = GetNameToSymbolIndexMap(lldb::eFunctionNameTypeNone);
-    name_to_index.Append(entry);
-    return;
-  }
-
-  // Make sure we have a pool-string pointer and see if we already know the
-  // context name.
-  const char *decl_context_ccstr = ConstString(decl_context).GetCString();
-  auto it = class_contexts.find(decl_context_ccstr);
-
-  auto &method_to_index =
-      GetNameToSymbolIndexMap(lldb::eFunctionNameTypeMethod);
-  // Register constructors and destructors. They are methods and create
-  // declaration contexts.
-  if (rmc.IsCtorOrDtor()) {
-    method_to_index.Append(entry);
-    if (it == class_contexts.end())
-      class_contexts.insert(it, decl_context_ccstr);
-    return;
-  }
-
-  // Register regular methods with a known declaration context.
-  if (it != class_contexts.end()) {
-    method_to_index.Append(entry);
-    return;
-  }
-
-  // Regular methods in unknown declaration contexts are put to the backlog. We
-  // will revisit them once we processed all remaining symbols.
-  backlog.push_back(std::make_pair(entry, decl_context_ccstr));
-}
-
-void Symtab::RegisterBacklogEntry(
-    const NameToIndexMap::Entry &entry, const char *decl_context,
-    const std::set<const char *> &class_contexts) {
-  auto &method_to_index =
-      GetNameToSymbolIndexMap(lldb::eFunctionNameTypeMethod);
-  auto it = class_contexts.find(decl_context);
-  if (it != class_contexts.end()) {
-    method_to_index.Append(entry);
-  } else {
-    // If we got here, we have something that had a context (was inside
-    // a namespace or class) yet we don't know the entry
-    method_to_index.Append(entry);
-    auto &basename_to_index =
-        GetNameToSymbolIndexMap(lldb::eFunctionNameTypeBase);
-    basename_to_index.Append(entry);
   }
 }
 
@@ -1337,14 +1377,44 @@ bool Symtab::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
 
   { // Scope for "elapsed" object below so it can measure the time to index.
     ElapsedTime elapsed(m_objfile->GetModule()->GetSymtabIndexTime());
+    // Each C string map has to be sorted after it is decoded, so find where
+    // all of them start and decode them in parallel.
     const uint8_t num_cstr_maps = data.GetU8(offset_ptr);
+    std::vector<std::pair<UniqueCStringMap<uint32_t> *, lldb::offset_t>>
+        cstr_maps;
+    uint64_t num_entries = 0;
     for (uint8_t i=0; i<num_cstr_maps; ++i) {
       uint8_t type = data.GetU8(offset_ptr);
       UniqueCStringMap<uint32_t> &cstr_map =
           GetNameToSymbolIndexMap((lldb::FunctionNameType)type);
-      if (!DecodeCStrMap(data, offset_ptr, strtab, cstr_map))
+      const lldb::offset_t map_offset = *offset_ptr;
+      // Skip the identifier, the count and the (string offset, value) pairs.
+      *offset_ptr += 4;
+      const uint32_t count = data.GetU32(offset_ptr);
+      const uint64_t map_size = 8 + 8 * (uint64_t)count;
+      if (!data.ValidOffsetForDataOfSize(map_offset, map_size))
         return false;
+      *offset_ptr = map_offset + map_size;
+      cstr_maps.push_back(std::make_pair(&cstr_map, map_offset));
+      num_entries += count;
     }
+    std::vector<char> decoded(cstr_maps.size(), false);
+    auto decode_map = [&](size_t i) {
+      lldb::offset_t map_offset = cstr_maps[i].second;
+      decoded[i] =
+          DecodeCStrMap(data, &map_offset, strtab, *cstr_maps[i].first);
+    };
+    if (num_entries > g_name_index_chunk_size) {
+      llvm::ThreadPoolTaskGroup task_group(Debugger::GetThreadPool());
+      for (size_t i = 0; i < cstr_maps.size(); ++i)
+        task_group.async(decode_map, i);
+      task_group.wait();
+    } else {
+      for (size_t i = 0; i < cstr_maps.size(); ++i)
+        decode_map(i);
+    }
+    if (llvm::is_contained(decoded, false))
+      return false;
     m_name_indexes_computed = true;
   }
   return true;
@@ -24,7 +24,8 @@ using namespace lldb_private;
 MemoryCache::MemoryCache(Process &process)
     : m_mutex(), m_L1_cache(), m_L2_cache(), m_invalid_ranges(),
       m_process(process),
-      m_L2_cache_line_byte_size(process.GetMemoryCacheLineSize()) {}
+      m_L2_cache_line_byte_size(process.GetMemoryCacheLineSize()),
+      m_max_prefetch_lines(process.GetMemoryCacheMaxPrefetchLines()) {}
 
 // Destructor
 MemoryCache::~MemoryCache() = default;
@@ -36,6 +37,10 @@ void MemoryCache::Clear(bool clear_invalid_ranges) {
   if (clear_invalid_ranges)
     m_invalid_ranges.Clear();
   m_L2_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+  m_max_prefetch_lines = m_process.GetMemoryCacheMaxPrefetchLines();
+  m_prefetch_lines = 0;
+  m_last_miss_addr = LLDB_INVALID_ADDRESS;
+  m_miss_stride = 0;
 }
 
 void MemoryCache::AddL1CacheData(lldb::addr_t addr, const void *src,
@@ -123,6 +128,44 @@ bool MemoryCache::RemoveInvalidRange(lldb::addr_t base_addr,
   return false;
 }
 
+std::vector<lldb::addr_t>
+MemoryCache::GetL2CacheLinesToPrefetch(lldb::addr_t miss_addr) {
+  // Strides larger than this are more likely to come from unrelated reads
+  // than from walking a data structure.
+  const lldb::addr_t max_stride = 4 * m_L2_cache_line_byte_size;
+
+  const lldb::addr_t last_miss_addr = m_last_miss_addr;
+  m_last_miss_addr = miss_addr;
+  lldb::addr_t stride = 0;
+  if (last_miss_addr != LLDB_INVALID_ADDRESS && miss_addr > last_miss_addr &&
+      miss_addr - last_miss_addr <= max_stride)
+    stride = miss_addr - last_miss_addr;
+
+  if (stride == 0 || stride != m_miss_stride) {
+    m_miss_stride = stride;
+    m_prefetch_lines = 0;
+    return {};
+  }
+
+  m_prefetch_lines = std::min(std::max(2 * m_prefetch_lines, 1u),
+                              m_max_prefetch_lines);
+  std::vector<lldb::addr_t> line_addrs;
+  lldb::addr_t line_addr = miss_addr;
+  for (uint32_t i = 0; i < m_prefetch_lines; ++i) {
+    if (line_addr > LLDB_INVALID_ADDRESS - stride)
+      break;
+    line_addr += stride;
+    if (m_invalid_ranges.FindEntryThatContains(line_addr))
+      break;
+    if (m_L2_cache.find(line_addr) == m_L2_cache.end())
+      line_addrs.push_back(line_addr);
+    // The next miss which continues the pattern comes after the lines read
+    // here.
+    m_last_miss_addr = line_addr;
+  }
+  return line_addrs;
+}
+
 lldb::DataBufferSP MemoryCache::GetL2CacheLine(lldb::addr_t line_base_addr,
                                                Status &error) {
   // This function assumes that the address given is aligned correctly.
@@ -133,11 +176,42 @@ lldb::DataBufferSP MemoryCache::GetL2CacheLine(lldb::addr_t line_base_addr,
   if (pos != m_L2_cache.end())
     return pos->second;
 
+  std::vector<lldb::addr_t> prefetch_addrs;
+  if (m_max_prefetch_lines > 0)
+    prefetch_addrs = GetL2CacheLinesToPrefetch(line_base_addr);
+
   auto data_buffer_heap_sp =
       std::make_shared<DataBufferHeap>(m_L2_cache_line_byte_size, 0);
-  size_t process_bytes_read = m_process.ReadMemoryFromInferior(
-      line_base_addr, data_buffer_heap_sp->GetBytes(),
-      data_buffer_heap_sp->GetByteSize(), error);
+  size_t process_bytes_read = 0;
+  if (!prefetch_addrs.empty()) {
+    // Read the missed line and the prefetched ones at once. Each line is a
+    // separate range, so that an unreadable line doesn't fail the others.
+    std::vector<Range<lldb::addr_t, size_t>> ranges;
+    ranges.push_back({line_base_addr, m_L2_cache_line_byte_size});
+    for (lldb::addr_t addr : prefetch_addrs)
+      ranges.push_back({addr, m_L2_cache_line_byte_size});
+    DataBufferHeap buffer(ranges.size() * m_L2_cache_line_byte_size, 0);
+    std::vector<size_t> bytes_read =
+        m_process.ReadMemoryRangesFromInferior(ranges, buffer.GetBytes());
+
+    process_bytes_read = bytes_read[0];
+    memcpy(data_buffer_heap_sp->GetBytes(), buffer.GetBytes(),
+           process_bytes_read);
+    // Only cache the prefetched lines which were read completely, a partial
+    // line will be read again if it is needed.
+    for (size_t i = 1; i < ranges.size(); ++i) {
+      if (bytes_read[i] == m_L2_cache_line_byte_size)
+        m_L2_cache[ranges[i].GetRangeBase()] = std::make_shared<DataBufferHeap>(
+            buffer.GetBytes() + i * m_L2_cache_line_byte_size,
+            m_L2_cache_line_byte_size);
+    }
+  }
+  // Read the line on its own if it wasn't read along with the prefetched ones,
+  // or to get the error if that read failed.
+  if (process_bytes_read == 0)
+    process_bytes_read = m_process.ReadMemoryFromInferior(
+        line_base_addr, data_buffer_heap_sp->GetBytes(),
+        data_buffer_heap_sp->GetByteSize(), error);
 
   // If we failed a read, not much we can do.
   if (process_bytes_read == 0)
@@ -198,6 +198,12 @@ uint64_t ProcessProperties::GetMemoryCacheLineSize() const {
       idx, g_process_properties[idx].default_uint_value);
 }
 
+uint64_t ProcessProperties::GetMemoryCacheMaxPrefetchLines() const {
+  const uint32_t idx = ePropertyMemCacheMaxPrefetchLines;
+  return GetPropertyAtIndexAs<uint64_t>(
+      idx, g_process_properties[idx].default_uint_value);
+}
+
 Args ProcessProperties::GetExtraStartupCommands() const {
   Args args;
   const uint32_t idx = ePropertyExtraStartCommand;
@@ -2077,6 +2083,71 @@ size_t Process::ReadMemoryFromInferior(addr_t addr, void *buf, size_t size,
   return bytes_read;
 }
 
+std::vector<size_t> Process::ReadMemoryRangesFromInferior(
+    llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges, uint8_t *buf) {
+  LLDB_SCOPED_TIMER();
+
+  std::vector<Range<lldb::addr_t, size_t>> fixed_ranges(ranges.begin(),
+                                                        ranges.end());
+  if (ABISP abi_sp = GetABI())
+    for (auto &range : fixed_ranges)
+      range.SetRangeBase(abi_sp->FixAnyAddress(range.GetRangeBase()));
+
+  std::vector<size_t> bytes_read = DoReadMemoryRanges(fixed_ranges, buf);
+
+  // Replace any software breakpoint opcodes that fall into these ranges back
+  // into "buf" before we return
+  uint8_t *range_buf = buf;
+  for (size_t i = 0; i < fixed_ranges.size(); ++i) {
+    if (bytes_read[i] > 0)
+      RemoveBreakpointOpcodesFromBuffer(fixed_ranges[i].GetRangeBase(),
+                                        bytes_read[i], range_buf);
+    range_buf += fixed_ranges[i].GetByteSize();
+  }
+  return bytes_read;
+}
+
+void Process::PrefetchMemoryRanges(
+    llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges) {
+  if (ranges.empty() || GetDisableMemoryCache())
+    return;
+
+  size_t total_size = 0;
+  for (const auto &range : ranges)
+    total_size += range.GetByteSize();
+  std::vector<uint8_t> buf(total_size);
+  std::vector<size_t> bytes_read =
+      ReadMemoryRangesFromInferior(ranges, buf.data());
+
+  const uint8_t *range_buf = buf.data();
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (bytes_read[i] > 0)
+      m_memory_cache.AddL1CacheData(ranges[i].GetRangeBase(), range_buf,
+                                    bytes_read[i]);
+    range_buf += ranges[i].GetByteSize();
+  }
+}
+
+std::vector<size_t> Process::DoReadMemoryRanges(
+    llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges, uint8_t *buf) {
+  std::vector<size_t> bytes_read(ranges.size(), 0);
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    const addr_t addr = ranges[i].GetRangeBase();
+    const size_t size = ranges[i].GetByteSize();
+    Status error;
+    while (bytes_read[i] < size) {
+      const size_t curr_size = size - bytes_read[i];
+      const size_t curr_bytes_read = DoReadMemory(
+          addr + bytes_read[i], buf + bytes_read[i], curr_size, error);
+      bytes_read[i] += curr_bytes_read;
+      if (curr_bytes_read == curr_size || curr_bytes_read == 0)
+        break;
+    }
+    buf += size;
+  }
+  return bytes_read;
+}
+
 uint64_t Process::ReadUnsignedIntegerFromMemory(lldb::addr_t vm_addr,
                                                 size_t integer_byte_size,
                                                 uint64_t fail_value,
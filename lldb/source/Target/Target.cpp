@@ -201,6 +201,7 @@ void Target::DeleteCurrentProcess() {
     m_process_sp->Finalize(false /* not destructing */);
 
     CleanupProcess();
+    ClearUserExpressionCache();
 
     m_process_sp.reset();
   }
@@ -1460,6 +1461,7 @@ void Target::ClearModules(bool delete_locations) {
   m_section_load_history.Clear();
   m_images.Clear();
   m_scratch_type_system_map.Clear();
+  ClearUserExpressionCache();
 }
 
 void Target::DidExec() {
@@ -1696,6 +1698,8 @@ void Target::ModulesDidLoad(ModuleList &module_list) {
     }
     m_breakpoint_list.UpdateBreakpoints(module_list, true, false);
     m_internal_breakpoint_list.UpdateBreakpoints(module_list, true, false);
+    // Names in cached expressions may now resolve differently.
+    ClearUserExpressionCache();
     if (m_process_sp) {
       m_process_sp->ModulesDidLoad(module_list);
     }
@@ -1715,6 +1719,7 @@ void Target::SymbolsDidLoad(ModuleList &module_list) {
 
     m_breakpoint_list.UpdateBreakpoints(module_list, true, false);
     m_internal_breakpoint_list.UpdateBreakpoints(module_list, true, false);
+    ClearUserExpressionCache();
     auto data_sp =
         std::make_shared<TargetEventData>(shared_from_this(), module_list);
     BroadcastEvent(eBroadcastBitSymbolsLoaded, data_sp);
@@ -1730,6 +1735,7 @@ void Target::ModulesDidUnload(ModuleList &module_list, bool delete_locations) {
     m_breakpoint_list.UpdateBreakpoints(module_list, false, delete_locations);
     m_internal_breakpoint_list.UpdateBreakpoints(module_list, false,
                                                  delete_locations);
+    ClearUserExpressionCache();
 
     // If a module was torn down it will have torn down the 'TypeSystemClang's
     // that we used as source 'ASTContext's for the persistent variables in
@@ -2536,6 +2542,46 @@ UserExpression *Target::GetUserExpressionForLanguage(
   return user_expr;
 }
 
+/// The number of parsed expressions a target keeps around.
+static constexpr size_t g_max_cached_user_expressions = 64;
+
+lldb::UserExpressionSP
+Target::TakeCachedUserExpression(llvm::StringRef key,
+                                 ExecutionContext &exe_ctx) {
+  std::lock_guard<std::mutex> guard(m_user_expression_cache_mutex);
+  for (auto pos = m_user_expression_cache.rbegin(),
+            end = m_user_expression_cache.rend();
+       pos != end; ++pos) {
+    if (pos->first != key || !pos->second->MatchesContext(exe_ctx))
+      continue;
+    lldb::UserExpressionSP expression_sp = std::move(pos->second);
+    m_user_expression_cache.erase(std::next(pos).base());
+    return expression_sp;
+  }
+  return nullptr;
+}
+
+void Target::CacheUserExpression(llvm::StringRef key,
+                                 lldb::UserExpressionSP expression_sp) {
+  lldb::UserExpressionSP evicted_sp;
+  std::lock_guard<std::mutex> guard(m_user_expression_cache_mutex);
+  if (m_user_expression_cache.size() == g_max_cached_user_expressions) {
+    evicted_sp = std::move(m_user_expression_cache.front().second);
+    m_user_expression_cache.erase(m_user_expression_cache.begin());
+  }
+  m_user_expression_cache.emplace_back(key.str(), std::move(expression_sp));
+}
+
+void Target::ClearUserExpressionCache() {
+  // Destroying the expressions frees their memory in the process, don't do
+  // that with the lock held.
+  std::vector<std::pair<std::string, lldb::UserExpressionSP>> expressions;
+  {
+    std::lock_guard<std::mutex> guard(m_user_expression_cache_mutex);
+    expressions.swap(m_user_expression_cache);
+  }
+}
+
 FunctionCaller *Target::GetFunctionCallerForLanguage(
     lldb::LanguageType language, const CompilerType &return_type,
     const Address &function_address, const ValueList &arg_value_list,
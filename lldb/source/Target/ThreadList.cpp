@@ -10,6 +10,7 @@
 
 #include <algorithm>
 
+#include "lldb/Core/Debugger.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/RegisterContext.h"
 #include "lldb/Target/Thread.h"
@@ -20,6 +21,8 @@
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/State.h"
 
+#include "llvm/Support/ThreadPool.h"
+
 using namespace lldb;
 using namespace lldb_private;
 
@@ -499,6 +502,49 @@ void ThreadList::RefreshStateAfterStop() {
     (*pos)->RefreshStateAfterStop();
 }
 
+/// The number of bytes from the top of each stack read ahead of unwinding a
+/// live process.
+static constexpr size_t g_stack_prefetch_size = 4096;
+
+void ThreadList::PrefetchStackFrames(llvm::ArrayRef<lldb::tid_t> tids,
+                                     uint32_t num_frames) {
+  if (num_frames == 0 || tids.size() < 2)
+    return;
+
+  std::vector<ThreadSP> threads;
+  for (lldb::tid_t tid : tids)
+    if (ThreadSP thread_sp = FindThreadByID(tid))
+      threads.push_back(thread_sp);
+
+  if (m_process->IsLiveDebugSession()) {
+    std::vector<Range<lldb::addr_t, size_t>> ranges;
+    for (const ThreadSP &thread_sp : threads) {
+      RegisterContextSP reg_ctx_sp = thread_sp->GetRegisterContext();
+      if (!reg_ctx_sp)
+        continue;
+      lldb::addr_t sp = reg_ctx_sp->GetSP(LLDB_INVALID_ADDRESS);
+      if (sp != LLDB_INVALID_ADDRESS)
+        ranges.emplace_back(sp, g_stack_prefetch_size);
+    }
+    m_process->PrefetchMemoryRanges(ranges);
+    return;
+  }
+
+  // The unwinders of all the threads share the ABI, create it up front.
+  m_process->GetABI();
+
+  llvm::ThreadPoolTaskGroup task_group(Debugger::GetThreadPool());
+  for (const ThreadSP &thread_sp : threads) {
+    task_group.async([thread_sp, num_frames]() {
+      if (num_frames == UINT32_MAX)
+        thread_sp->GetStackFrameCount();
+      else
+        thread_sp->GetStackFrameAtIndex(num_frames - 1);
+    });
+  }
+  task_group.wait();
+}
+
 void ThreadList::DiscardThreadPlans() {
   // You don't need to update the thread list here, because only threads that
   // you currently know about have any thread plans.
@@ -0,0 +1,79 @@
+"""
+Test that UserExpression::Evaluate reuses a parsed expression at the same pc,
+and parses it again at another pc, after a module is loaded, after an
+expression setting changes and after a top-level expression.
+"""
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class ExpressionCacheTestCase(TestBase):
+    expr = "global + 1"
+
+    def check_counts(self, parsed, reused):
+        with open(self.log_file) as f:
+            log = f.read()
+        self.assertEqual(
+            log.count("Parsing expression %s ==" % self.expr), parsed, log
+        )
+        self.assertEqual(
+            log.count("Reusing expression %s ==" % self.expr), reused, log
+        )
+
+    @skipIfRemote
+    @skipIfWindows
+    def test(self):
+        self.build()
+        self.log_file = self.getBuildArtifact("expr.log")
+        self.runCmd("log enable -f %s lldb expr" % self.log_file)
+        self.addTearDownHook(lambda: self.runCmd("log disable lldb expr"))
+        self.addTearDownHook(
+            lambda: self.runCmd("settings clear target.import-std-module")
+        )
+
+        target, process, _, f_bkpt = lldbutil.run_to_source_breakpoint(
+            self, "// break in f", lldb.SBFileSpec("main.c")
+        )
+        self.expect_expr(self.expr, result_type="int", result_value="2")
+        self.check_counts(parsed=1, reused=0)
+
+        # The same expression at the same pc reuses the parsed expression.
+        lldbutil.continue_to_breakpoint(process, f_bkpt)
+        self.expect_expr("x", result_type="int", result_value="2")
+        self.expect_expr(self.expr, result_type="int", result_value="2")
+        self.check_counts(parsed=1, reused=1)
+
+        # At a different pc it is parsed again.
+        main_bkpt = target.BreakpointCreateBySourceRegex(
+            "// break in main", lldb.SBFileSpec("main.c")
+        )
+        lldbutil.continue_to_breakpoint(process, main_bkpt)
+        self.expect_expr(self.expr, result_type="int", result_value="2")
+        self.check_counts(parsed=2, reused=1)
+        self.expect_expr(self.expr, result_type="int", result_value="2")
+        self.check_counts(parsed=2, reused=2)
+
+        # Loading a module clears the cache.
+        ctx = self.platformContext
+        dylib = self.getBuildArtifact(
+            ctx.shlib_prefix + "other." + ctx.shlib_extension
+        )
+        self.runCmd("process load %s" % dylib)
+        self.expect_expr(self.expr, result_type="int", result_value="2")
+        self.check_counts(parsed=3, reused=2)
+
+        # Changing a setting which affects parsing parses it again.
+        self.runCmd("settings set target.import-std-module fallback")
+        self.expect_expr(self.expr, result_type="int", result_value="2")
+        self.check_counts(parsed=4, reused=2)
+        self.expect_expr(self.expr, result_type="int", result_value="2")
+        self.check_counts(parsed=4, reused=3)
+
+        # So does a top-level expression, whose declarations could change what
+        # the names in the expression refer to.
+        self.runCmd("expression --top-level -- int top_level_global = 3;")
+        self.expect_expr(self.expr, result_type="int", result_value="2")
+        self.check_counts(parsed=5, reused=3)
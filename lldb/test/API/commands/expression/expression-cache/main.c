@@ -0,0 +1,11 @@
+int global = 1;
+
+int f(int x) {
+  return x + global; // break in f
+}
+
+int main() {
+  int a = f(1);
+  int b = f(2);
+  return a + b; // break in main
+}
@@ -0,0 +1,54 @@
+"""
+Test that frame variable shows the same values whether or not the DWARF units
+of the variable types are preloaded, with the types either in the compile
+units or in type units.
+"""
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class PreloadVariableTypesTestCase(TestBase):
+    def check_variables(self, preload):
+        setting = "plugin.symbol-file.dwarf.preload-variable-types"
+        self.runCmd("settings set %s %s" % (setting, "true" if preload else "false"))
+        self.addTearDownHook(lambda: self.runCmd("settings clear " + setting))
+        self.runCmd("log timers reset")
+        lldbutil.run_to_source_breakpoint(
+            self, "// break here", lldb.SBFileSpec("main.cpp")
+        )
+
+        self.expect_var_path("d.b", value="1")
+        self.expect_var_path("d.holder.value", value="2")
+        self.expect_var_path("d.holder.inner.i", value="3")
+        self.expect_var_path("d.ptr->i", value="7")
+        self.expect_var_path("d.chars[0].value", value="'a'")
+        self.expect_var_path("d.chars[1].inner.i", value="5")
+        self.expect_var_path("h.value", value="2")
+        self.expect_var_path("h.inner.i", value="3")
+
+        self.runCmd("frame select 1")
+        self.expect_var_path("inner.i", value="6")
+
+        # The preloading can be measured with the timers.
+        self.expect(
+            "log timers dump",
+            substrs=["PreloadVariableTypeDIEs"],
+            matching=preload,
+        )
+
+    def test(self):
+        self.build()
+        self.check_variables(preload=False)
+
+    def test_preload(self):
+        self.build()
+        self.check_variables(preload=True)
+
+    @skipUnlessPlatform(["linux"])
+    def test_preload_type_units(self):
+        self.build(dictionary={"CFLAGS_EXTRAS": "-fdebug-types-section"})
+        self.check_variables(preload=True)
+
@@ -0,0 +1,14 @@
+#include "types.h"
+
+int use(Derived d, Holder<int> h) {
+  return d.b + h.value; // break here
+}
+
+int main() {
+  Derived d = make_derived();
+  const Holder<int> h = d.holder;
+  {
+    Inner inner = {6};
+    return use(d, h) + inner.i;
+  }
+}
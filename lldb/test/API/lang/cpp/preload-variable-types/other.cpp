@@ -0,0 +1,16 @@
+#include "types.h"
+
+static Inner g_inner = {7};
+
+Derived make_derived() {
+  Derived d;
+  d.b = 1;
+  d.holder.value = 2;
+  d.holder.inner.i = 3;
+  d.ptr = &g_inner;
+  d.chars[0].value = 'a';
+  d.chars[0].inner.i = 4;
+  d.chars[1].value = 'b';
+  d.chars[1].inner.i = 5;
+  return d;
+}
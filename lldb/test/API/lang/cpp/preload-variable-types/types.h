@@ -0,0 +1,21 @@
+struct Inner {
+  int i;
+};
+
+template <typename T> struct Holder {
+  T value;
+  Inner inner;
+};
+
+struct Base {
+  int b;
+};
+
+struct Derived : Base {
+  Holder<int> holder;
+  Inner *ptr;
+  typedef Holder<char> CharHolder;
+  CharHolder chars[2];
+};
+
+Derived make_derived();
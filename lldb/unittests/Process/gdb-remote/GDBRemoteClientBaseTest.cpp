@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 #include <future>
+#include <thread>
 
 #include "GDBRemoteTestUtils.h"
 
@@ -362,3 +363,31 @@ TEST_F(GDBRemoteClientBaseTest, SendPacketAndReceiveResponseWithOutputSupport) {
   ASSERT_EQ("OK", response.GetStringRef());
   ASSERT_EQ("Hello, world", command_output.GetString().str());
 }
+
+TEST_F(GDBRemoteClientBaseTest, SendPacketsDiscardsResponsesAfterTimeout) {
+  StringExtractorGDBRemote response;
+  client.SetPacketTimeout(std::chrono::seconds(1));
+
+  std::vector<std::string> payloads = {"p1", "p2"};
+  std::vector<StringExtractorGDBRemote> responses;
+  std::future<PacketResult> async_result = std::async(std::launch::async, [&] {
+    return client.SendPacketsAndWaitForResponses(payloads, responses);
+  });
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(response));
+  ASSERT_EQ("p1", response.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(response));
+  ASSERT_EQ("p2", response.GetStringRef());
+
+  // Respond only after the client has given up waiting for the first response.
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("r1"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("r2"));
+  ASSERT_EQ(PacketResult::ErrorReplyTimeout, async_result.get());
+
+  // The late responses must not be taken for the response to the next packet.
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("r3"));
+  ASSERT_EQ(PacketResult::Success,
+            client.SendPacketAndWaitForResponse("p3", response));
+  ASSERT_EQ("r3", response.GetStringRef());
+  ASSERT_TRUE(client.IsConnected());
+}
@@ -615,3 +615,43 @@ TEST_F(GDBRemoteCommunicationClientTest, CalculateMD5) {
   EXPECT_EQ(expected_low, low);
   EXPECT_EQ(expected_high, high);
 }
+
+TEST_F(GDBRemoteCommunicationClientTest, ReadMemoryRangesMultiMemRead) {
+  const std::vector<Range<addr_t, size_t>> ranges = {
+      {0x1000, 4}, {0x2000, 2}, {0x3000, 3}};
+  uint8_t buf[9] = {};
+  std::future<std::vector<size_t>> async_result =
+      std::async(std::launch::async,
+                 [&] { return client.ReadMemoryRanges(ranges, buf, 8); });
+
+  HandlePacket(server, testing::StartsWith("qSupported:"), "MultiMemRead+");
+  // The last range doesn't fit in the same reply as the first two.
+  HandlePacket(server, "MultiMemRead:ranges:1000,4,2000,2;", "4,1;abcde");
+  HandlePacket(server, "MultiMemRead:ranges:3000,3;", "E08");
+
+  EXPECT_THAT(async_result.get(), testing::ElementsAre(4u, 1u, 0u));
+  EXPECT_EQ(0, memcmp(buf, "abcde", 5));
+}
+
+TEST_F(GDBRemoteCommunicationClientTest, ReadMemoryRangesPipelined) {
+  const std::vector<Range<addr_t, size_t>> ranges = {{0x1000, 4},
+                                                      {0x2000, 2}};
+  uint8_t buf[6] = {};
+  std::future<std::vector<size_t>> async_result =
+      std::async(std::launch::async,
+                 [&] { return client.ReadMemoryRanges(ranges, buf, 8); });
+
+  HandlePacket(server, testing::StartsWith("qSupported:"), "");
+  HandlePacket(server, "x0,0", "OK");
+  // Both packets are sent before the first response is received.
+  StringExtractorGDBRemote request;
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("x1000,4", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("x2000,2", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("abcd"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("ef"));
+
+  EXPECT_THAT(async_result.get(), testing::ElementsAre(4u, 2u));
+  EXPECT_EQ(0, memcmp(buf, "abcdef", 6));
+}
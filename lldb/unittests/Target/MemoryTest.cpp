@@ -226,3 +226,60 @@ TEST_F(MemoryTest, TesetMemoryCacheRead) {
                                                        // instead of using an
                                                        // old cache
 }
+
+TEST_F(MemoryTest, TestMemoryCachePrefetch) {
+  ArchSpec arch("x86_64-apple-macosx-");
+
+  Platform::SetHostPlatform(PlatformRemoteMacOSX::CreateInstance(true, &arch));
+
+  DebuggerSP debugger_sp = Debugger::CreateInstance();
+  ASSERT_TRUE(debugger_sp);
+
+  TargetSP target_sp = CreateTarget(debugger_sp, arch);
+  ASSERT_TRUE(target_sp);
+
+  ListenerSP listener_sp(Listener::MakeListener("dummy"));
+  ProcessSP process_sp = std::make_shared<DummyProcess>(target_sp, listener_sp);
+  ASSERT_TRUE(process_sp);
+
+  DummyProcess *process = static_cast<DummyProcess *>(process_sp.get());
+  MemoryCache &mem_cache = process->GetMemoryCache();
+  const uint64_t l2_cache_size = process->GetMemoryCacheLineSize();
+  Status error;
+  uint8_t byte;
+  process->SetMaxReadSize(l2_cache_size * 100);
+
+  // The first two misses at a stride of one line only read the missed lines.
+  const addr_t base = 0x10000;
+  ASSERT_EQ(mem_cache.Read(base, &byte, 1, error), 1u);
+  ASSERT_EQ(mem_cache.Read(base + l2_cache_size, &byte, 1, error), 1u);
+  ASSERT_EQ(process->m_bytes_left, l2_cache_size * 98);
+
+  // The third one also reads the next line, which is then cached.
+  ASSERT_EQ(mem_cache.Read(base + l2_cache_size * 2, &byte, 1, error), 1u);
+  ASSERT_EQ(process->m_bytes_left, l2_cache_size * 96);
+  ASSERT_EQ(mem_cache.Read(base + l2_cache_size * 3, &byte, 1, error), 1u);
+  ASSERT_EQ(process->m_bytes_left, l2_cache_size * 96);
+
+  // The number of prefetched lines doubles while the pattern continues.
+  ASSERT_EQ(mem_cache.Read(base + l2_cache_size * 4, &byte, 1, error), 1u);
+  ASSERT_EQ(process->m_bytes_left, l2_cache_size * 93);
+  ASSERT_EQ(mem_cache.Read(base + l2_cache_size * 5, &byte, 1, error), 1u);
+  ASSERT_EQ(mem_cache.Read(base + l2_cache_size * 6, &byte, 1, error), 1u);
+  ASSERT_EQ(process->m_bytes_left, l2_cache_size * 93);
+  ASSERT_EQ(mem_cache.Read(base + l2_cache_size * 7, &byte, 1, error), 1u);
+  ASSERT_EQ(process->m_bytes_left, l2_cache_size * 88);
+
+  // Reading somewhere else stops the prefetching.
+  ASSERT_EQ(mem_cache.Read(0x80000, &byte, 1, error), 1u);
+  ASSERT_EQ(mem_cache.Read(0x80000 + l2_cache_size, &byte, 1, error), 1u);
+  ASSERT_EQ(process->m_bytes_left, l2_cache_size * 86);
+
+  // Lines at a stride of two lines are prefetched too.
+  ASSERT_EQ(mem_cache.Read(0x80000 + l2_cache_size * 3, &byte, 1, error), 1u);
+  ASSERT_EQ(mem_cache.Read(0x80000 + l2_cache_size * 5, &byte, 1, error), 1u);
+  ASSERT_EQ(process->m_bytes_left, l2_cache_size * 83);
+  ASSERT_EQ(mem_cache.Read(0x80000 + l2_cache_size * 7, &byte, 1, error), 1u);
+  ASSERT_EQ(mem_cache.Read(0x80000 + l2_cache_size * 6, &byte, 1, error), 1u);
+  ASSERT_EQ(process->m_bytes_left, l2_cache_size * 82);
+}
@@ -0,0 +1,97 @@
+//===- StringMap.cpp - StringMap lookup and insertion benchmarks ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+/// Build NumKeys distinct identifiers shaped like the ones that fill clang's
+/// IdentifierTable and lld's symbol table: mostly short camel-case names built
+/// from a small vocabulary, plus a tail of long Itanium-mangled names that
+/// share their prefixes.
+static std::vector<std::string> makeIdentifiers(size_t NumKeys) {
+  static const char *const Words[] = {
+      "get",    "set",    "is",     "create", "Value",  "Type",   "Decl",
+      "Expr",   "Stmt",   "Node",   "Map",    "List",   "Info",   "Context",
+      "Impl",   "Base",   "Size",   "Begin",  "End",    "Iter",   "Builder",
+      "Module", "Symbol", "Section", "Index", "Entry",  "Kind",   "Name"};
+  constexpr size_t NumWords = sizeof(Words) / sizeof(Words[0]);
+
+  std::mt19937 Rng(0x5eed);
+  std::vector<std::string> Keys;
+  Keys.reserve(NumKeys);
+  StringMap<char> Seen;
+  while (Keys.size() < NumKeys) {
+    std::string Key;
+    if (Rng() % 4 == 0) {
+      // _ZN4llvm<len><word>...E<params>
+      Key = "_ZN4llvm";
+      for (unsigned I = 0, E = 2 + Rng() % 3; I != E; ++I) {
+        std::string Part = std::string(Words[Rng() % NumWords]) +
+                           Words[Rng() % NumWords];
+        Key += std::to_string(Part.size()) + Part;
+      }
+      Key += "E";
+      Key += "RKS0_"[Rng() % 5];
+    } else {
+      for (unsigned I = 0, E = 1 + Rng() % 3; I != E; ++I)
+        Key += Words[Rng() % NumWords];
+      if (Rng() % 3 == 0)
+        Key += std::to_string(Rng() % 100);
+    }
+    if (Seen.try_emplace(Key).second)
+      Keys.push_back(std::move(Key));
+  }
+  return Keys;
+}
+
+static void BM_StringMapInsert(benchmark::State &State) {
+  std::vector<std::string> Keys = makeIdentifiers(State.range(0));
+  for (auto _ : State) {
+    StringMap<unsigned> Map;
+    for (const std::string &Key : Keys)
+      Map.try_emplace(Key, 0);
+    benchmark::DoNotOptimize(Map.size());
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_StringMapInsert)->Range(1 << 8, 1 << 18);
+
+static void BM_StringMapLookupHit(benchmark::State &State) {
+  std::vector<std::string> Keys = makeIdentifiers(State.range(0));
+  StringMap<unsigned> Map;
+  for (const std::string &Key : Keys)
+    Map.try_emplace(Key, 0);
+  std::shuffle(Keys.begin(), Keys.end(), std::mt19937(1));
+  for (auto _ : State)
+    for (const std::string &Key : Keys)
+      benchmark::DoNotOptimize(Map.find(Key));
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_StringMapLookupHit)->Range(1 << 8, 1 << 18);
+
+static void BM_StringMapLookupMiss(benchmark::State &State) {
+  std::vector<std::string> Keys = makeIdentifiers(2 * State.range(0));
+  StringMap<unsigned> Map;
+  for (size_t I = 0, E = Keys.size() / 2; I != E; ++I)
+    Map.try_emplace(Keys[I], 0);
+  std::vector<std::string> Misses(Keys.begin() + Keys.size() / 2, Keys.end());
+  for (auto _ : State)
+    for (const std::string &Key : Misses)
+      benchmark::DoNotOptimize(Map.find(Key));
+  State.SetItemsProcessed(State.iterations() * Misses.size());
+}
+BENCHMARK(BM_StringMapLookupMiss)->Range(1 << 8, 1 << 18);
+
+BENCHMARK_MAIN();
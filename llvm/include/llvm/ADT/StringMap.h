@@ -33,7 +33,8 @@ class StringMapImpl {
 protected:
   // Array of NumBuckets pointers to entries, null pointers are holes.
   // TheTable[NumBuckets] contains a sentinel value for easy iteration. Followed
-  // by an array of the actual hash values as unsigned integers.
+  // by an array of the actual hash values as unsigned integers, and then by
+  // one control byte per bucket used to probe the table in groups.
   StringMapEntryBase **TheTable = nullptr;
   unsigned NumBuckets = 0;
   unsigned NumItems = 0;
@@ -87,6 +88,13 @@ protected:
   /// setup the map as empty.
   void init(unsigned Size);
 
+  /// Copy the per-bucket probe metadata from \p RHS, which must have the same
+  /// number of buckets.  Used when copying the buckets one by one.
+  void copyControlBytes(const StringMapImpl &RHS);
+
+  /// Mark every bucket as empty in the probe metadata.
+  void clearControlBytes();
+
 public:
   static constexpr uintptr_t TombstoneIntVal =
       static_cast<uintptr_t>(-1)
@@ -176,6 +184,7 @@ public:
           static_cast<MapEntryTy *>(Bucket)->getValue());
       HashTable[I] = RHSHashTable[I];
     }
+    copyControlBytes(RHS);
 
     // Note that here we've copied everything from the RHS into this object,
     // tombstones included. We could, instead, have re-probed for each key to
@@ -402,6 +411,7 @@ public:
       }
       Bucket = nullptr;
     }
+    clearControlBytes();
 
     NumItems = 0;
     NumTombstones = 0;
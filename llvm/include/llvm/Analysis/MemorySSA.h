@@ -1085,6 +1085,25 @@ public:
     return getClobberingMemoryAccess(MA, Loc, BAA);
   }
 
+  /// Compute the clobbering access of each access in \p Accesses and append
+  /// them to \p Clobbers in the same order. All walks share the alias
+  /// analysis results cached in \p AA, so this is cheaper than issuing the
+  /// queries through the overloads that create a BatchAAResults per query.
+  /// The IR must not change while \p AA is in use.
+  void getClobberingMemoryAccesses(ArrayRef<MemoryAccess *> Accesses,
+                                   SmallVectorImpl<MemoryAccess *> &Clobbers,
+                                   BatchAAResults &AA) {
+    Clobbers.reserve(Clobbers.size() + Accesses.size());
+    for (MemoryAccess *MA : Accesses)
+      Clobbers.push_back(getClobberingMemoryAccess(MA, AA));
+  }
+
+  void getClobberingMemoryAccesses(ArrayRef<MemoryAccess *> Accesses,
+                                   SmallVectorImpl<MemoryAccess *> &Clobbers) {
+    BatchAAResults BAA(MSSA->getAA());
+    getClobberingMemoryAccesses(Accesses, Clobbers, BAA);
+  }
+
   /// Given a memory access, invalidate anything this walker knows about
   /// that access.
   /// This API is used by walkers that store information to perform basic cache
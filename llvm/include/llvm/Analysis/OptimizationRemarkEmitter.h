@@ -67,6 +67,10 @@ public:
            F->getContext().getDiagHandlerPtr()->isAnyRemarkEnabled();
   }
 
+  /// Return true iff remarks of kind \p Kind emitted by \p PassName would
+  /// reach the diagnostic handler or the optimization record file.
+  bool enabled(StringRef PassName, DiagnosticKind Kind) const;
+
   /// Output the remark via the diagnostic handler and to the
   /// optimization record file.
   void emit(DiagnosticInfoOptimizationBase &OptDiag);
@@ -88,6 +92,23 @@ public:
     }
   }
 
+  /// Take a lambda that returns a remark emitted by \p PassName, and only
+  /// call it if remarks of that kind from \p PassName are enabled. Prefer
+  /// this over the overload above when the remark's arguments are expensive
+  /// to build.
+  template <typename T>
+  void emit(StringRef PassName, T RemarkBuilder,
+            decltype(RemarkBuilder()) * = nullptr) {
+    using RemarkT = decltype(RemarkBuilder());
+    static_assert(std::is_base_of<DiagnosticInfoOptimizationBase,
+                                  RemarkT>::value,
+                  "the lambda passed to emit() must return a remark");
+    if (enabled(PassName, getRemarkKind<RemarkT>())) {
+      auto R = RemarkBuilder();
+      emit((DiagnosticInfoOptimizationBase &)R);
+    }
+  }
+
   /// Whether we allow for extra compile-time budget to perform more
   /// analysis to produce fewer false positives.
   ///
@@ -101,12 +122,27 @@ public:
   static bool allowExtraAnalysis(const Function &F, StringRef PassName) {
     return allowExtraAnalysis(F.getContext(), PassName);
   }
-  static bool allowExtraAnalysis(LLVMContext &Ctx, StringRef PassName) {
-    return Ctx.getLLVMRemarkStreamer() ||
-           Ctx.getDiagHandlerPtr()->isAnyRemarkEnabled(PassName);
-  }
+  static bool allowExtraAnalysis(LLVMContext &Ctx, StringRef PassName);
 
 private:
+  /// The DiagnosticKind of remarks of type \p RemarkT.
+  template <typename RemarkT> static constexpr DiagnosticKind getRemarkKind() {
+    if constexpr (std::is_base_of_v<OptimizationRemark, RemarkT>)
+      return DK_OptimizationRemark;
+    else if constexpr (std::is_base_of_v<OptimizationRemarkMissed, RemarkT>)
+      return DK_OptimizationRemarkMissed;
+    else if constexpr (std::is_base_of_v<OptimizationRemarkAnalysisFPCommute,
+                                         RemarkT>)
+      return DK_OptimizationRemarkAnalysisFPCommute;
+    else if constexpr (std::is_base_of_v<OptimizationRemarkAnalysisAliasing,
+                                         RemarkT>)
+      return DK_OptimizationRemarkAnalysisAliasing;
+    else if constexpr (std::is_base_of_v<OptimizationRemarkAnalysis, RemarkT>)
+      return DK_OptimizationRemarkAnalysis;
+    else
+      return DK_OptimizationFailure;
+  }
+
   const Function *F;
 
   BlockFrequencyInfo *BFI;
@@ -2045,6 +2045,11 @@ private:
   /// Helper for forgetMemoizedResults.
   void forgetMemoizedResultsImpl(const SCEV *S);
 
+  /// Drop all cached information if the caches exceed the budget set by
+  /// -scalar-evolution-cache-budget. Only called when no SCEV computation is
+  /// in progress.
+  void enforceCacheBudget();
+
   /// Iterate over instructions in \p Worklist and their users. Erase entries
   /// from ValueExprMap and collect SCEV expressions in \p ToForget
   void visitAndClearUsers(SmallVectorImpl<Instruction *> &Worklist,
@@ -130,7 +130,8 @@ public:
     SVML,             // Intel short vector math library.
     SLEEFGNUABI, // SLEEF - SIMD Library for Evaluating Elementary Functions.
     ArmPL,       // Arm Performance Libraries.
-    AMDLIBM      // AMD Math Vector library.
+    AMDLIBM,     // AMD Math Vector library.
+    LLVMLIBC     // LLVM libc vector math functions.
   };
 
   TargetLibraryInfoImpl();
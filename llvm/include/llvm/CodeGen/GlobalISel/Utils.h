@@ -164,6 +164,12 @@ void reportGISelFailure(MachineFunction &MF, const TargetPassConfig &TPC,
                         const char *PassName, StringRef Msg,
                         const MachineInstr &MI);
 
+/// Count a GlobalISel failure of \p MF in the -stats counter of the stage
+/// named \p PassName, the pass name of its failure remark. Only the first
+/// failure of a function is counted, so this must be called before the
+/// FailedISel property is set. reportGISelFailure does this itself.
+void countGISelFailure(const MachineFunction &MF, StringRef PassName);
+
 /// Report an ISel warning as a missed optimization remark to the LLVMContext's
 /// diagnostic stream.
 void reportGISelWarning(MachineFunction &MF, const TargetPassConfig &TPC,
@@ -4,6 +4,8 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/MC/MCSection.h"
 #include "llvm/MC/MCStreamer.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/StringSaver.h"
 #include <cassert>
 
 namespace llvm {
@@ -32,6 +34,10 @@ class DWPStringPool {
 
   MCStreamer &Out;
   MCSection *Sec;
+  // The pool keeps its own copy of every unique string so that callers may
+  // release the input an offset was requested for once it has been processed.
+  BumpPtrAllocator Alloc;
+  StringSaver Saver{Alloc};
   DenseMap<const char *, uint32_t, CStrDenseMapInfo> Pool;
   uint32_t Offset = 0;
 
@@ -41,14 +47,17 @@ public:
   uint32_t getOffset(const char *Str, unsigned Length) {
     assert(strlen(Str) + 1 == Length && "Ensure length hint is correct");
 
-    auto Pair = Pool.insert(std::make_pair(Str, Offset));
-    if (Pair.second) {
-      Out.switchSection(Sec);
-      Out.emitBytes(StringRef(Str, Length));
-      Offset += Length;
-    }
+    auto It = Pool.find(Str);
+    if (It != Pool.end())
+      return It->second;
 
-    return Pair.first->second;
+    uint32_t StrOffset = Offset;
+    Pool.insert(std::make_pair(Saver.save(StringRef(Str, Length - 1)).data(),
+                               StrOffset));
+    Out.switchSection(Sec);
+    Out.emitBytes(StringRef(Str, Length));
+    Offset += Length;
+    return StrOffset;
   }
 };
 } // namespace llvm
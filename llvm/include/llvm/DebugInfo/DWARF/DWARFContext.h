@@ -131,6 +131,21 @@ private:
   // Index, and TU Index for DWARF5.
   bool ParseCUTUIndexManually = false;
 
+  /// If non-zero, the total .debug_info size of the compile units whose DIEs
+  /// address lookups may keep extracted.
+  uint64_t MaxAddressLookupUnitsSize = 0;
+  /// The compile units whose DIEs were extracted by address lookups, least
+  /// recently used first, and their total .debug_info size.
+  std::vector<DWARFUnit *> AddressLookupUnits;
+  uint64_t AddressLookupUnitsSize = 0;
+
+  /// Record that an address lookup is about to use the DIEs of \p U. This
+  /// never frees DIEs, so it is safe in the middle of a lookup.
+  void noteAddressLookupUnit(DWARFUnit *U);
+  /// Free the DIEs of the least recently used units until the rest fit in
+  /// MaxAddressLookupUnitsSize. Only called when a lookup starts.
+  void pruneAddressLookupUnits();
+
 public:
   DWARFContext(std::unique_ptr<const DWARFObject> DObj,
                std::string DWPName = "",
@@ -396,6 +411,9 @@ public:
   getLocalsForAddress(object::SectionedAddress Address) override;
 
   bool isLittleEndian() const { return DObj->isLittleEndian(); }
+  /// Returns true if this context was created to be usable from multiple
+  /// threads.
+  bool isThreadSafe() const { return State->isThreadSafe(); }
   static unsigned getMaxSupportedVersion() { return 5; }
   static bool isSupportedVersion(unsigned version) {
     return version >= 2 && version <= getMaxSupportedVersion();
@@ -485,6 +503,23 @@ public:
   /// manually only for DWARF5.
   void setParseCUTUIndexManually(bool PCUTU) { ParseCUTUIndexManually = PCUTU; }
 
+  /// Bound the memory that address lookups (e.g. getLineInfoForAddress() or
+  /// getInliningInfoForAddress()) spend on extracted DIEs. Once the compile
+  /// units used by lookups add up to more than \p Size bytes of .debug_info,
+  /// the DIEs of the least recently used ones are freed and extracted again
+  /// when they are needed. Zero, the default, keeps all DIEs.
+  ///
+  /// DIEs are only freed when the next lookup starts, so the DIEs a lookup
+  /// uses, including those of other units reached through cross-unit
+  /// references, stay valid until it returns. Freeing DIEs invalidates any
+  /// DWARFDie of those units, so this is only for clients that do not hold on
+  /// to DIEs across lookups, such as symbolizers, and is not supported for
+  /// thread-safe contexts.
+  void setMaxAddressLookupUnitsSize(uint64_t Size) {
+    assert(!isThreadSafe() && "DIEs can't be freed in a thread-safe context");
+    MaxAddressLookupUnitsSize = Size;
+  }
+
 private:
   void addLocalsForDie(DWARFCompileUnit *CU, DWARFDie Subprogram, DWARFDie Die,
                        std::vector<DILocal> &Result);
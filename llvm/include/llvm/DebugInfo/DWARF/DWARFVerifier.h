@@ -42,6 +42,8 @@ public:
   size_t GetNumCategories() const { return Aggregation.size(); }
   void Report(StringRef s, std::function<void()> detailCallback);
   void EnumerateResults(std::function<void(StringRef, unsigned)> handleCounts);
+  /// Add the counts collected by \p Other to this aggregator.
+  void Merge(const OutputCategoryAggregator &Other);
 };
 
 /// A class that verifies DWARF debug information given a DWARF Context.
@@ -106,6 +108,23 @@ private:
   raw_ostream &note() const;
   raw_ostream &dump(const DWARFDie &Die, unsigned indent = 0) const;
 
+  /// Returns true if verification work may be spread over several threads.
+  /// This requires a DWARFContext that was created thread-safe.
+  bool shouldVerifyInParallel() const;
+
+  /// Calls \p VerifyItem for every index in [0, \p NumItems).
+  ///
+  /// If verification may run in parallel, contiguous ranges of items are
+  /// verified on the default thread pool, each by its own verifier that
+  /// buffers its output and error categories. The buffers are printed in item
+  /// order afterwards, so the output matches a serial run. Otherwise every
+  /// item is verified by this verifier.
+  ///
+  /// \returns The sum of the error counts returned by \p VerifyItem.
+  unsigned verifyInParallel(
+      size_t NumItems,
+      function_ref<unsigned(DWARFVerifier &, size_t)> VerifyItem);
+
   /// Verifies the abbreviations section.
   ///
   /// This function currently checks that:
@@ -236,12 +255,14 @@ private:
   /// compile units that have the same DW_AT_stmt_list value.
   void verifyDebugLineStmtOffsets();
 
-  /// Verify that all of the rows in the line table are valid.
+  /// Verify that all of the rows in the line table of \p Unit are valid.
   ///
   /// This function currently checks for:
   /// - addresses within a sequence that decrease in value
   /// - invalid file indexes
-  void verifyDebugLineRows();
+  ///
+  /// \returns The number of errors occurred during verification.
+  unsigned verifyDebugLineRows(DWARFUnit &Unit);
 
   /// Verify that an Apple-style accelerator table is valid.
   ///
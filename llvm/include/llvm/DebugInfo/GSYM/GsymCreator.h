@@ -313,6 +313,9 @@ public:
 
   /// Encode a GSYM into the file writer stream at the current position.
   ///
+  /// Function infos are encoded in parallel, using llvm::parallel::strategy,
+  /// a bounded window at a time.
+  ///
   /// \param O The stream to save the binary data to
   /// \returns An error object that indicates success or failure of the save.
   llvm::Error encode(FileWriter &O) const;
@@ -355,7 +358,8 @@ public:
   /// Finalize the data in the GSYM creator prior to saving the data out.
   ///
   /// Finalize must be called after all FunctionInfo objects have been added
-  /// and before GsymCreator::save() is called.
+  /// and before GsymCreator::save() is called. The function infos are sorted
+  /// in parallel, using llvm::parallel::strategy.
   ///
   /// \param  OS Output stream to report duplicate function infos, overlapping
   ///         function infos, and function infos that were merged or removed.
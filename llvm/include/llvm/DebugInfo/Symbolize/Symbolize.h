@@ -62,10 +62,14 @@ public:
     std::string FallbackDebugPath;
     std::string DWPName;
     std::vector<std::string> DebugFileDirectory;
+    std::string GsymCacheDirectory;
     size_t MaxCacheSize =
         sizeof(size_t) == 4
             ? 512 * 1024 * 1024 /* 512 MiB */
             : static_cast<size_t>(4ULL * 1024 * 1024 * 1024) /* 4 GiB */;
+    // If non-zero, bounds the .debug_info size of the units per module whose
+    // DIEs stay extracted between lookups.
+    uint64_t MaxDWARFUnitCacheSize = 0;
   };
 
   LLVMSymbolizer();
@@ -170,6 +174,13 @@ private:
   createModuleInfo(const ObjectFile *Obj, std::unique_ptr<DIContext> Context,
                    StringRef ModuleName);
 
+  /// Returns a GSYM-backed context for the debug info in \p Obj, or null if
+  /// none can be created. The GSYM file lives in Opts.GsymCacheDirectory, is
+  /// named after the object's build ID or content hash, and is converted from
+  /// DWARF on first use, so that later symbolizer processes only need to map
+  /// it.
+  std::unique_ptr<DIContext> getOrCreateGsymContext(const ObjectFile &Obj);
+
   ObjectFile *lookUpDsymFile(const std::string &Path,
                              const MachOObjectFile *ExeObj,
                              const std::string &ArchName);
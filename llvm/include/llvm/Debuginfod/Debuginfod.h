@@ -11,7 +11,8 @@
 /// server. The client functions are getDefaultDebuginfodUrls,
 /// getCachedOrDownloadArtifact, and several convenience functions for specific
 /// artifact types: getCachedOrDownloadSource, getCachedOrDownloadExecutable,
-/// and getCachedOrDownloadDebuginfo. For the server, this file declares the
+/// and getCachedOrDownloadDebuginfo, as well as getCachedOrDownloadArtifacts to
+/// fetch several artifacts concurrently. For the server, this file declares the
 /// DebuginfodLogEntry and DebuginfodServer structs, as well as the
 /// DebuginfodLog, DebuginfodCollection classes.
 ///
@@ -35,6 +36,7 @@
 #include <condition_variable>
 #include <optional>
 #include <queue>
+#include <vector>
 
 namespace llvm {
 
@@ -61,6 +63,11 @@ Expected<std::string> getDefaultDebuginfodCacheDirectory();
 /// DEBUGINFOD_TIMEOUT environment variable, default is 90 seconds (90000 ms).
 std::chrono::milliseconds getDefaultDebuginfodTimeout();
 
+/// Finds the default maximum number of artifacts that are downloaded at the
+/// same time. Checks DEBUGINFOD_MAX_CONNECTIONS environment variable, default
+/// is 8.
+unsigned getDefaultDebuginfodMaxConnections();
+
 /// Get the full URL path for a source request of a given BuildID and file
 /// path.
 std::string getDebuginfodSourceUrlPath(object::BuildIDRef ID,
@@ -92,11 +99,21 @@ Expected<std::string> getCachedOrDownloadArtifact(StringRef UniqueKey,
 
 /// Fetches any debuginfod artifact using the specified local cache directory,
 /// server URLs, and request timeout (in milliseconds). If the artifact is
-/// found, uses the UniqueKey for the local cache file.
+/// found, uses the UniqueKey for the local cache file. Concurrent fetches of
+/// the same artifact from processes sharing the cache directory are serialized
+/// with a lock file, and an interrupted download is resumed with a range
+/// request.
 Expected<std::string> getCachedOrDownloadArtifact(
     StringRef UniqueKey, StringRef UrlPath, StringRef CacheDirectoryPath,
     ArrayRef<StringRef> DebuginfodUrls, std::chrono::milliseconds Timeout);
 
+/// Fetches several debuginfod artifacts using the default local cache
+/// directory and server URLs, downloading up to
+/// getDefaultDebuginfodMaxConnections() of them at the same time. Returns the
+/// cached file path or the error for each of the UrlPaths, in order.
+std::vector<Expected<std::string>>
+getCachedOrDownloadArtifacts(ArrayRef<std::string> UrlPaths);
+
 class ThreadPoolInterface;
 
 struct DebuginfodLogEntry {
@@ -0,0 +1,43 @@
+//===- llvm/Debuginfod/HTTPCacheStore.h - HTTP cache store ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file declares HTTPCacheStore, a RemoteCacheStore that keeps cache
+/// entries on an HTTP server, for use with RemoteFileCache.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_DEBUGINFOD_HTTPCACHESTORE_H
+#define LLVM_DEBUGINFOD_HTTPCACHESTORE_H
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Caching.h"
+
+#include <chrono>
+
+namespace llvm {
+
+/// A RemoteCacheStore backed by an HTTP server. The entry for a key is read
+/// with a GET and written with a PUT of <BaseUrl>/<Key>. A 404 response to a
+/// GET is a miss. HTTPClient::initialize() must have been called.
+class HTTPCacheStore : public RemoteCacheStore {
+public:
+  HTTPCacheStore(StringRef BaseUrl, std::chrono::milliseconds Timeout)
+      : BaseUrl(BaseUrl.rtrim('/')), Timeout(Timeout) {}
+
+  Expected<std::unique_ptr<MemoryBuffer>> fetch(StringRef Key) override;
+  Error upload(StringRef Key, MemoryBufferRef Data) override;
+
+private:
+  SmallString<128> BaseUrl;
+  std::chrono::milliseconds Timeout;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_DEBUGINFOD_HTTPCACHESTORE_H
@@ -24,7 +24,7 @@
 
 namespace llvm {
 
-enum class HTTPMethod { GET };
+enum class HTTPMethod { GET, PUT };
 
 /// A stateless description of an outbound HTTP request.
 struct HTTPRequest {
@@ -32,6 +32,8 @@ struct HTTPRequest {
   SmallVector<std::string, 0> Headers;
   HTTPMethod Method = HTTPMethod::GET;
   bool FollowRedirects = true;
+  /// The body sent with a PUT request. It must outlive the request.
+  StringRef Body;
   HTTPRequest(StringRef Url);
 };
 
@@ -13,10 +13,18 @@
 #ifndef LLVM_EXECUTIONENGINE_ORC_COMPILEUTILS_H
 #define LLVM_EXECUTIONENGINE_ORC_COMPILEUTILS_H
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
 #include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
 #include "llvm/ExecutionEngine/Orc/Layer.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Caching.h"
+#include "llvm/Support/ThreadPool.h"
+#include <atomic>
+#include <future>
 #include <memory>
+#include <mutex>
 
 namespace llvm {
 
@@ -93,6 +101,66 @@ private:
   ObjectCache *ObjCache = nullptr;
 };
 
+/// An IRCompiler that keeps the objects produced by another IRCompiler in a
+/// directory on disk, so that later runs of the program, and other processes
+/// using the same directory, don't have to compile the same IR again.
+///
+/// Objects are keyed by a hash of the module's IR combined with the target
+/// triple, CPU, features, relocation model, code model and optimization level
+/// of the JITTargetMachineBuilder. Entries are added to the directory
+/// atomically, and the directory is pruned with pruneCache() after each entry
+/// is added. Clients that vary other TargetOptions between runs should use
+/// separate directories.
+///
+/// This compiler is thread safe if the base compiler is.
+class CachingIRCompiler : public IRCompileLayer::IRCompiler {
+public:
+  /// Create a compiler that looks modules up in \p CacheDir before compiling
+  /// them with \p BaseCompiler. \p JTMB should describe the target that
+  /// \p BaseCompiler compiles for.
+  static Expected<std::unique_ptr<CachingIRCompiler>>
+  Create(std::unique_ptr<IRCompileLayer::IRCompiler> BaseCompiler,
+         const JITTargetMachineBuilder &JTMB, StringRef CacheDir,
+         CachePruningPolicy Policy = CachePruningPolicy());
+
+  Expected<std::unique_ptr<MemoryBuffer>> operator()(Module &M) override;
+
+  /// Start loading the cached object for \p M, if there is one, on a
+  /// background thread, so that compiling \p M later doesn't wait for the
+  /// disk. The cache key is computed before this method returns.
+  void prefetch(const Module &M);
+
+  /// Return the cache key of \p M.
+  std::string getCacheKey(const Module &M) const;
+
+private:
+  CachingIRCompiler(std::unique_ptr<IRCompileLayer::IRCompiler> BaseCompiler,
+                    const JITTargetMachineBuilder &JTMB, StringRef CacheDir,
+                    CachePruningPolicy Policy);
+
+  void addBuffer(unsigned Task, std::unique_ptr<MemoryBuffer> Obj);
+  std::unique_ptr<MemoryBuffer> takeBuffer(unsigned Task);
+  std::unique_ptr<MemoryBuffer> takePrefetchedObject(StringRef Key);
+
+  std::unique_ptr<IRCompileLayer::IRCompiler> BaseCompiler;
+  std::string TargetKey;
+  std::string CacheDir;
+  CachePruningPolicy Policy;
+  FileCache Cache;
+
+  // The cache hands objects over through a callback, which identifies the
+  // lookup by its task number.
+  std::atomic<unsigned> NextTask{0};
+  std::mutex BuffersMutex;
+  DenseMap<unsigned, std::unique_ptr<MemoryBuffer>> Buffers;
+  StringMap<std::shared_future<void>> Prefetches;
+  StringMap<std::unique_ptr<MemoryBuffer>> PrefetchedObjects;
+
+  // Declared last so that it is destroyed, and waits for the prefetches that
+  // use the members above, first.
+  DefaultThreadPool PrefetchPool;
+};
+
 } // end namespace orc
 
 } // end namespace llvm
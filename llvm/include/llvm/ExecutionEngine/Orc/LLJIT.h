@@ -260,6 +260,8 @@ protected:
   std::unique_ptr<IRCompileLayer> CompileLayer;
   std::unique_ptr<IRTransformLayer> TransformLayer;
   std::unique_ptr<IRTransformLayer> InitHelperTransformLayer;
+  // The compile function, if objects are cached and prefetched.
+  CachingIRCompiler *PrefetchingCompiler = nullptr;
 };
 
 /// An extended version of LLJIT that supports lazy function-at-a-time
@@ -278,6 +280,9 @@ public:
   /// Returns a reference to the on-demand layer.
   CompileOnDemandLayer &getCompileOnDemandLayer() { return *CODLayer; }
 
+  /// Returns a reference to the lazy call-through manager.
+  LazyCallThroughManager &getLazyCallThroughManager() { return *LCTMgr; }
+
   /// Add a module to be lazily compiled to JITDylib JD.
   Error addLazyIRModule(JITDylib &JD, ThreadSafeModule M);
 
@@ -320,6 +325,8 @@ public:
   ProcessSymbolsJITDylibSetupFunction SetupProcessSymbolsJITDylib;
   ObjectLinkingLayerCreator CreateObjectLinkingLayer;
   CompileFunctionCreator CreateCompileFunction;
+  std::string ObjectCacheDirectory;
+  bool PrefetchCachedObjects = false;
   unique_function<Error(LLJIT &)> PrePlatformSetup;
   PlatformSetupFunction SetUpPlatform;
   NotifyCreatedFunction NotifyCreated;
@@ -421,6 +428,29 @@ public:
     return impl();
   }
 
+  /// Set a directory to cache compiled objects in.
+  ///
+  /// If this method is called, the compile function (whether the default or
+  /// one from a CompileFunctionCreator) is wrapped in a CachingIRCompiler, so
+  /// modules that were compiled before, by this or another process using the
+  /// same directory, are loaded from the directory instead of being compiled.
+  SetterImpl &setObjectCacheDirectory(std::string ObjectCacheDirectory) {
+    impl().ObjectCacheDirectory = std::move(ObjectCacheDirectory);
+    return impl();
+  }
+
+  /// Start loading the cached object of each module added with addIRModule on
+  /// a background thread, so that it is ready by the time the module is
+  /// compiled. Only has an effect together with setObjectCacheDirectory.
+  ///
+  /// The object is found by the module as it is added, so this only helps if
+  /// the IR transform layers leave modules unchanged, and not for LLLazyJIT,
+  /// which compiles partitions of modules.
+  SetterImpl &setPrefetchCachedObjects(bool PrefetchCachedObjects) {
+    impl().PrefetchCachedObjects = PrefetchCachedObjects;
+    return impl();
+  }
+
   /// Set a setup function to be run just before the PlatformSetupFunction is
   /// run.
   ///
@@ -40,6 +40,9 @@ public:
   using NotifyResolvedFunction =
       unique_function<Error(ExecutorAddr ResolvedAddr)>;
 
+  using NotifyCallThroughFunction =
+      unique_function<void(JITDylib &SourceJD, const SymbolStringPtr &Name)>;
+
   LazyCallThroughManager(ExecutionSession &ES, ExecutorAddr ErrorHandlerAddr,
                          TrampolinePool *TP);
 
@@ -53,6 +56,14 @@ public:
       ExecutorAddr TrampolineAddr,
       TrampolinePool::NotifyLandingResolvedFunction NotifyLandingResolved);
 
+  /// Set a function to be called with the target of each call-through, before
+  /// the target is looked up. This can be used to record the order in which
+  /// lazily compiled functions are first called. It must be set before any
+  /// trampolines are entered.
+  void setNotifyCallThrough(NotifyCallThroughFunction NotifyCallThrough) {
+    this->NotifyCallThrough = std::move(NotifyCallThrough);
+  }
+
   virtual ~LazyCallThroughManager() = default;
 
 protected:
@@ -80,6 +91,7 @@ private:
   TrampolinePool *TP = nullptr;
   ReexportsMap Reexports;
   NotifiersMap Notifiers;
+  NotifyCallThroughFunction NotifyCallThrough;
 };
 
 /// A lazy call-through manager that builds trampolines in the current process.
@@ -17,6 +17,8 @@
 #include "llvm/ExecutionEngine/JITLink/JITLinkMemoryManager.h"
 #include "llvm/ExecutionEngine/Orc/MemoryMapper.h"
 
+#include <map>
+
 namespace llvm {
 namespace orc {
 
@@ -46,6 +48,18 @@ public:
   // synchronous overload
   using JITLinkMemoryManager::deallocate;
 
+  /// Occupancy of a range reserved from the MemoryMapper.
+  struct SlabInfo {
+    ExecutorAddrRange Range;
+    /// The number of bytes allocated to linked graphs.
+    ExecutorAddrDiff UsedBytes = 0;
+    /// The number of linked graphs allocated in the range.
+    size_t NumAllocations = 0;
+  };
+
+  /// Returns the occupancy of the reserved ranges, in address order.
+  std::vector<SlabInfo> getSlabInfos();
+
 private:
   class InFlightAlloc;
 
@@ -62,6 +76,9 @@ private:
   // Ranges that have been reserved in executor and already allocated
   DenseMap<ExecutorAddr, ExecutorAddrDiff> UsedMemory;
 
+  // Ranges that have been reserved in executor, by start address
+  std::map<ExecutorAddr, ExecutorAddrDiff> Reservations;
+
   std::unique_ptr<MemoryMapper> Mapper;
 };
 
@@ -18,13 +18,18 @@
 #include "llvm/ExecutionEngine/Orc/DebugUtils.h"
 #include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
 #include "llvm/Support/Debug.h"
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace llvm {
 namespace orc {
 
+class LazyCallThroughManager;
 class Speculator;
 
 // Track the Impls (JITDylib,Symbols) of Symbols while lazy call through
@@ -203,6 +208,96 @@ private:
   ResultEval QueryAnalysis;
 };
 
+/// A sequence of (JITDylib name, symbol name) pairs, in the order in which the
+/// symbols were first called through a lazy call-through.
+using LazyCallTrace = std::vector<std::pair<std::string, std::string>>;
+
+/// Write Trace to Path, one tab-separated JITDylib and symbol name per line.
+Error writeLazyCallTrace(const LazyCallTrace &Trace, StringRef Path);
+
+/// Read a trace written by writeLazyCallTrace.
+Expected<LazyCallTrace> readLazyCallTrace(StringRef Path);
+
+/// Records the order in which the targets of a LazyCallThroughManager's
+/// trampolines are first called, so that a later run can compile them ahead
+/// of time with a TraceSpeculator.
+///
+/// The recorder must outlive the use of the LazyCallThroughManager's
+/// trampolines.
+class LazyCallTraceRecorder {
+public:
+  /// Start recording call-throughs made via LCTM.
+  LazyCallTraceRecorder(LazyCallThroughManager &LCTM);
+
+  /// Returns the trace recorded so far.
+  LazyCallTrace getTrace();
+
+  /// Write the trace recorded so far to Path.
+  Error writeToFile(StringRef Path) {
+    return writeLazyCallTrace(getTrace(), Path);
+  }
+
+private:
+  void record(JITDylib &JD, const SymbolStringPtr &Name);
+
+  std::mutex TraceMutex;
+  DenseSet<std::pair<JITDylib *, SymbolStringPtr>> Seen;
+  LazyCallTrace Trace;
+};
+
+/// Compiles the symbols of a LazyCallTrace recorded by a previous run before
+/// they are called.
+///
+/// Symbols are looked up in trace order from IdleTasks, with at most
+/// MaxInFlight lookups outstanding, so that a WorkStealingTaskDispatcher only
+/// runs speculation on workers that have nothing else to do. Symbols whose
+/// JITDylib or definition does not exist are skipped.
+class TraceSpeculator {
+public:
+  TraceSpeculator(ExecutionSession &ES, LazyCallTrace Trace,
+                  size_t MaxInFlight = 1);
+
+  /// Create a TraceSpeculator for the trace in Path.
+  static Expected<std::unique_ptr<TraceSpeculator>>
+  Create(ExecutionSession &ES, StringRef Path, size_t MaxInFlight = 1);
+
+  TraceSpeculator(const TraceSpeculator &) = delete;
+  TraceSpeculator &operator=(const TraceSpeculator &) = delete;
+
+  /// Stops speculation.
+  ~TraceSpeculator() { stop(); }
+
+  /// Start speculating. The modules for the traced symbols should already
+  /// have been added.
+  void start();
+
+  /// Do not start any further lookups. Lookups that are already underway
+  /// will still complete.
+  void stop() { S->Stopped = true; }
+
+  /// Returns the number of trace entries that have been processed so far,
+  /// including skipped ones.
+  size_t getNumSpeculated() const { return S->NumSpeculated; }
+
+private:
+  class SpeculationTask;
+
+  struct State {
+    State(ExecutionSession &ES, LazyCallTrace Trace)
+        : ES(ES), Trace(std::move(Trace)) {}
+    ExecutionSession &ES;
+    LazyCallTrace Trace;
+    std::atomic<size_t> Next{0};
+    std::atomic<size_t> NumSpeculated{0};
+    std::atomic<bool> Stopped{false};
+  };
+
+  static void speculateFrom(std::shared_ptr<State> S);
+
+  std::shared_ptr<State> S;
+  size_t MaxInFlight;
+};
+
 } // namespace orc
 } // namespace llvm
 
@@ -13,6 +13,7 @@
 #ifndef LLVM_EXECUTIONENGINE_ORC_TASKDISPATCH_H
 #define LLVM_EXECUTIONENGINE_ORC_TASKDISPATCH_H
 
+#include "llvm/ADT/FunctionExtras.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ExtensibleRTTI.h"
@@ -22,10 +23,13 @@
 #include <string>
 
 #if LLVM_ENABLE_THREADS
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <mutex>
 #include <thread>
+#include <vector>
 #endif
 
 namespace llvm {
@@ -55,6 +59,13 @@ public:
   static const char *DefaultDescription;
 };
 
+/// Base class for tasks that should only run when there is no other work to
+/// do, e.g. speculative compilation.
+class IdleTask : public RTTIExtends<IdleTask, Task> {
+public:
+  static char ID;
+};
+
 /// Generic task implementation.
 template <typename FnT> class GenericNamedTaskImpl : public GenericNamedTask {
 public:
@@ -131,6 +142,100 @@ private:
   std::deque<std::unique_ptr<Task>> MaterializationTaskQueue;
 };
 
+/// Runs tasks on a fixed set of worker threads.
+///
+/// Each worker has its own queues, so dispatching a task only contends with
+/// the worker it is queued on. Tasks dispatched from a worker are queued on
+/// that worker, and idle workers steal tasks from the queues of busy ones.
+///
+/// Queued tasks run in order of priority. By default, tasks that continue
+/// suspended work (e.g. LookupTasks) run before materializations, IdleTasks
+/// run last, and a priority function can be supplied to classify tasks
+/// differently.
+///
+/// Since the number of threads is fixed, tasks must not block waiting for
+/// other tasks dispatched to the same dispatcher, or the dispatcher may
+/// deadlock once all workers are blocked. Use DynamicThreadPoolTaskDispatcher
+/// if materializers perform blocking lookups.
+class WorkStealingTaskDispatcher : public TaskDispatcher {
+public:
+  /// Task priorities, from the first to run to the last.
+  enum class Priority { High, Normal, Low };
+  static constexpr unsigned NumPriorities = 3;
+
+  using GetPriorityFunction = unique_function<Priority(Task &)>;
+
+  /// Queueing statistics of a WorkStealingTaskDispatcher.
+  struct Metrics {
+    /// The number of tasks dispatched so far.
+    uint64_t NumDispatched = 0;
+    /// The number of tasks that are queued but not yet running.
+    uint64_t QueueDepth = 0;
+    /// The largest QueueDepth so far.
+    uint64_t MaxQueueDepth = 0;
+    /// The number of tasks that ran on a worker other than the one they were
+    /// queued on.
+    uint64_t NumStolen = 0;
+    /// The total and the largest time that tasks spent queued.
+    std::chrono::nanoseconds TotalQueueLatency{0};
+    std::chrono::nanoseconds MaxQueueLatency{0};
+  };
+
+  /// Start NumThreads workers. If GetPriority is not given then
+  /// getDefaultPriority is used.
+  WorkStealingTaskDispatcher(size_t NumThreads,
+                             GetPriorityFunction GetPriority = nullptr);
+  ~WorkStealingTaskDispatcher() override;
+
+  void dispatch(std::unique_ptr<Task> T) override;
+  void shutdown() override;
+
+  /// Returns a snapshot of the queueing statistics.
+  Metrics getMetrics() const;
+
+  /// Materializations run at Normal priority, IdleTasks at Low, and all other
+  /// tasks at High.
+  static Priority getDefaultPriority(Task &T);
+
+private:
+  struct QueuedTask {
+    std::unique_ptr<Task> T;
+    std::chrono::steady_clock::time_point DispatchTime;
+  };
+
+  struct WorkerQueue {
+    std::mutex Mutex;
+    std::deque<QueuedTask> Tasks[NumPriorities];
+  };
+
+  void runWorker(size_t Index);
+  bool takeTask(size_t Index, QueuedTask &QT);
+
+  GetPriorityFunction GetPriority;
+  std::vector<std::unique_ptr<WorkerQueue>> Queues;
+  std::vector<std::thread> Workers;
+  std::atomic<size_t> NextQueue{0};
+
+  // Idle workers sleep on WorkAvailableCV until there are queued tasks.
+  std::mutex SleepMutex;
+  std::condition_variable WorkAvailableCV;
+  std::atomic<size_t> NumSleeping{0};
+  std::atomic<bool> Running{true};
+
+  // The number of tasks that are queued or running, for shutdown.
+  std::mutex OutstandingMutex;
+  std::condition_variable OutstandingCV;
+  std::atomic<size_t> Outstanding{0};
+
+  std::atomic<uint64_t> NumQueued[NumPriorities] = {};
+  std::atomic<uint64_t> NumDispatched{0};
+  std::atomic<uint64_t> QueueDepth{0};
+  std::atomic<uint64_t> MaxQueueDepth{0};
+  std::atomic<uint64_t> NumStolen{0};
+  std::atomic<uint64_t> TotalQueueLatencyNs{0};
+  std::atomic<uint64_t> MaxQueueLatencyNs{0};
+};
+
 #endif // LLVM_ENABLE_THREADS
 
 } // End namespace orc
@@ -0,0 +1,116 @@
+//===- TieredCompileLayer.h - Recompile hot functions -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// JIT layer that compiles functions quickly first, counts their calls, and
+// recompiles hot functions with a second layer in the background.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
+#define LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
+
+#include "llvm/ExecutionEngine/Orc/IndirectionUtils.h"
+#include "llvm/ExecutionEngine/Orc/Layer.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace llvm {
+namespace orc {
+
+/// Compiles modules with a fast tier-0 layer, and recompiles functions that
+/// are called often with a tier-1 layer.
+///
+/// Each externally visible function in a module added to this layer is
+/// instrumented with a call counter and emitted to an implementation dylib
+/// (named after the target dylib with a ".tiered" suffix) via the tier-0
+/// layer. The target dylib gets an indirect stub for the function that points
+/// at the tier-0 body. Once the function has been called Threshold times, a
+/// task is dispatched that extracts the uninstrumented function from a copy of
+/// the original module, emits it via the tier-1 layer, and updates the stub to
+/// point at the new body. Calls through the stub pick up the new body from
+/// then on; activations of the tier-0 body that are already running finish in
+/// tier-0 code.
+///
+/// The instrumentation calls into this layer directly, so the JIT'd code must
+/// run in the current process, and the layer must outlive it.
+class TieredCompileLayer : public IRLayer {
+public:
+  /// Builder for IndirectStubsManagers.
+  using IndirectStubsManagerBuilder =
+      std::function<std::unique_ptr<IndirectStubsManager>()>;
+
+  /// Called after the stub for Name in the target dylib has been updated to
+  /// point at the tier-1 body at Addr.
+  using NotifyTierUpFunction =
+      unique_function<void(JITDylib &JD, SymbolStringPtr Name,
+                           ExecutorAddr Addr)>;
+
+  /// Construct a TieredCompileLayer. Functions move from Tier0Layer to
+  /// Tier1Layer once they have been called Threshold times.
+  TieredCompileLayer(ExecutionSession &ES, IRLayer &Tier0Layer,
+                     IRLayer &Tier1Layer,
+                     IndirectStubsManagerBuilder BuildIndirectStubsManager,
+                     uint64_t Threshold = 1000);
+
+  /// Set a function to be notified when a function moves up to tier 1.
+  void setNotifyTierUp(NotifyTierUpFunction NotifyTierUp) {
+    this->NotifyTierUp = std::move(NotifyTierUp);
+  }
+
+  /// Emits the given module. This should not be called by clients: it will be
+  /// called by the JIT when a definition added via the add method is
+  /// requested.
+  void emit(std::unique_ptr<MaterializationResponsibility> R,
+            ThreadSafeModule TSM) override;
+
+private:
+  struct PerDylibResources {
+    PerDylibResources(JITDylib &ImplD,
+                      std::unique_ptr<IndirectStubsManager> ISMgr)
+        : ImplD(ImplD), ISMgr(std::move(ISMgr)) {}
+    JITDylib &ImplD;
+    std::unique_ptr<IndirectStubsManager> ISMgr;
+  };
+
+  /// A function that has been emitted at tier 0.
+  struct TieredFunction {
+    JITDylib *TargetD;
+    PerDylibResources *PDR;
+    std::shared_ptr<ThreadSafeModule> Source;
+    std::string Name;
+    SymbolStringPtr StubName;
+    SymbolStringPtr Tier1Name;
+  };
+
+  using PerDylibResourcesMap = std::map<const JITDylib *, PerDylibResources>;
+
+  PerDylibResources &getPerDylibResources(JITDylib &TargetD);
+
+  static void tierUpEntryPoint(TieredCompileLayer *Layer, uint64_t Id);
+  void tierUp(uint64_t Id);
+
+  mutable std::mutex TieredLayerMutex;
+  IRLayer &Tier0Layer;
+  IRLayer &Tier1Layer;
+  IndirectStubsManagerBuilder BuildIndirectStubsManager;
+  uint64_t Threshold;
+  PerDylibResourcesMap DylibResources;
+  SymbolLinkagePromoter PromoteSymbols;
+  std::vector<std::unique_ptr<TieredFunction>> Functions;
+  NotifyTierUpFunction NotifyTierUp;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
@@ -30,7 +30,8 @@ enum class VectorLibrary {
   SLEEF,              // SLEEF SIMD Library for Evaluating Elementary Functions.
   Darwin_libsystem_m, // Use Darwin's libsystem_m vector functions.
   ArmPL,              // Arm Performance Libraries.
-  AMDLIBM             // AMD vector math library.
+  AMDLIBM,            // AMD vector math library.
+  LLVMLIBC            // LLVM libc vector math functions.
 };
 
 TargetLibraryInfoImpl *createTLII(llvm::Triple &TargetTriple,
@@ -17,6 +17,7 @@
 #ifndef LLVM_IR_GVMATERIALIZER_H
 #define LLVM_IR_GVMATERIALIZER_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include <vector>
 
 namespace llvm {
@@ -36,6 +37,11 @@ public:
   ///
   virtual Error materialize(GlobalValue *GV) = 0;
 
+  /// Make sure all of the given GlobalValues are fully read.  Materializers
+  /// that can read several bodies more cheaply than one at a time override
+  /// this; the default materializes them one by one, in order.
+  virtual Error materializeBatch(ArrayRef<GlobalValue *> GVs);
+
   /// Make sure the entire Module has been completely read.
   ///
   virtual Error materializeModule() = 0;
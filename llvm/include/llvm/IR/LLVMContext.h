@@ -149,6 +149,19 @@ public:
   /// especially in release mode.
   void setDiscardValueNames(bool Discard);
 
+  /// Whether the constant and type uniquing tables may be used from several
+  /// threads at once.  Off by default.
+  bool isConcurrentUniquing() const;
+
+  /// Make the uniquing tables behind ConstantInt::get, ConstantFP::get,
+  /// IntegerType::get, PointerType::get and the aggregate, expression and
+  /// inline asm constants safe to query concurrently.  They are replaced by
+  /// sharded, lock-striped maps; contexts that never call this keep the
+  /// unsynchronized single-threaded paths.  Must be called before the context
+  /// is shared between threads, and cannot be undone.  Use lists, metadata
+  /// and the remaining context state are still not thread-safe.
+  void enableConcurrentUniquing();
+
   /// Whether there is a string map for uniquing debug info
   /// identifiers across the context.  Off by default.
   bool isODRUniquingDebugTypes() const;
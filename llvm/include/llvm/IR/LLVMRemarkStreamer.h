@@ -42,6 +42,13 @@ public:
   LLVMRemarkStreamer(remarks::RemarkStreamer &RS) : RS(RS) {}
   /// Emit a diagnostic through the streamer.
   void emit(const DiagnosticInfoOptimizationBase &Diag);
+  /// Return true if remarks of kind \p Kind (a DiagnosticKind) emitted by
+  /// \p PassName would be streamed. Unlike the checks in emit, this doesn't
+  /// need the remark to be built.
+  bool isEnabled(StringRef PassName, int Kind) const;
+  /// Return true if remarks of some kind emitted by \p PassName would be
+  /// streamed.
+  bool isEnabled(StringRef PassName) const;
 };
 
 template <typename ThisError>
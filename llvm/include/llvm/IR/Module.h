@@ -568,6 +568,10 @@ public:
   /// Make sure the GlobalValue is fully read.
   llvm::Error materialize(GlobalValue *GV);
 
+  /// Make sure all of the given GlobalValues are fully read.  This can be
+  /// faster than materializing them one at a time.
+  llvm::Error materializeBatch(ArrayRef<GlobalValue *> GVs);
+
   /// Make sure all GlobalValues in this Module are fully read and clear the
   /// Materializer.
   llvm::Error materializeAll();
@@ -52,6 +52,11 @@ public:
     // The set of identified but non opaque structures in the composite module.
     DenseSet<StructType *, StructTypeKeyInfo> NonOpaqueStructTypes;
 
+    // The exact types tracked by the two sets above. NonOpaqueStructTypes
+    // keeps only one of several isomorphic types, so membership queries on it
+    // need a structural hash and compare; this set answers them by identity.
+    DenseSet<StructType *> MemberTypes;
+
   public:
     void addNonOpaque(StructType *Ty);
     void switchToNonOpaque(StructType *Ty);
@@ -10,7 +10,9 @@
 #define LLVM_MC_MCASSEMBLER_H
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/iterator.h"
 #include "llvm/ADT/iterator_range.h"
@@ -26,6 +28,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -131,6 +134,11 @@ private:
   /// The list of linker options to propagate into the object file.
   std::vector<std::vector<std::string>> LinkerOptions;
 
+  /// The fragments of each section that may change size during relaxation,
+  /// in layout order. A section's list is built by its first relaxation pass
+  /// and only lives while layout() runs.
+  DenseMap<const MCSection *, SmallVector<MCFragment *, 0>> RelaxableFragments;
+
   /// List of declared file names
   std::vector<std::pair<std::string, size_t>> FileNames;
   // Optional compiler version.
@@ -208,8 +216,9 @@ private:
   bool layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec);
 
   /// Perform relaxation on a single fragment - returns true if the fragment
-  /// changes as a result of relaxation.
-  bool relaxFragment(MCAsmLayout &Layout, MCFragment &F);
+  /// changes as a result of relaxation, or std::nullopt if fragments of its
+  /// kind never change during relaxation.
+  std::optional<bool> relaxFragment(MCAsmLayout &Layout, MCFragment &F);
   bool relaxInstruction(MCAsmLayout &Layout, MCRelaxableFragment &IF);
   bool relaxLEB(MCAsmLayout &Layout, MCLEBFragment &IF);
   bool relaxBoundaryAlign(MCAsmLayout &Layout, MCBoundaryAlignFragment &BF);
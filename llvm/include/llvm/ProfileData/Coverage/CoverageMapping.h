@@ -947,6 +947,22 @@ class CoverageMapping {
                bool &DataFound,
                SmallVectorImpl<object::BuildID> *FoundBinaryIDs = nullptr);
 
+  // The coverage readers of one object file and the buffers they refer to.
+  struct ObjectReaders;
+
+  // Open an object file and create its coverage readers.
+  static Error createObjectReaders(StringRef Filename, StringRef Arch,
+                                   StringRef CompilationDir,
+                                   bool CollectBinaryIDs,
+                                   ObjectReaders &Object);
+
+  // Load coverage records from the readers of an object file.
+  static Error
+  loadFromObjectReaders(StringRef Filename, ObjectReaders &Object,
+                        IndexedInstrProfReader &ProfileReader,
+                        CoverageMapping &Coverage, bool &DataFound,
+                        SmallVectorImpl<object::BuildID> *FoundBinaryIDs);
+
   /// Add a function record corresponding to \p Record.
   Error loadFunctionRecord(const CoverageMappingRecord &Record,
                            IndexedInstrProfReader &ProfileReader);
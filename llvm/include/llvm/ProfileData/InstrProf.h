@@ -173,6 +173,18 @@ inline StringRef getInstrProfCounterBiasVarName() {
   return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_COUNTER_BIAS_VAR);
 }
 
+/// Return the name of the thread-local variable holding the offset from the
+/// counters section to the counters shard of the current thread.
+inline StringRef getInstrProfCounterShardBiasVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_COUNTER_SHARD_BIAS_VAR);
+}
+
+/// Return the name of the runtime function allocating the counters shard of
+/// the current thread.
+inline StringRef getInstrProfCounterShardInitFuncName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_COUNTER_SHARD_INIT);
+}
+
 /// Return the marker used to separate PGO names during serialization.
 inline StringRef getInstrProfNameSeparator() { return "\01"; }
 
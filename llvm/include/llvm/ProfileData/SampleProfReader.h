@@ -591,9 +591,7 @@ public:
 
   /// It includes all the names that have samples either in outline instance
   /// or inline instance.
-  std::vector<FunctionId> *getNameTable() override {
-    return &NameTable;
-  }
+  std::vector<FunctionId> *getNameTable() override;
 
 protected:
   /// Read a numeric value of type T from the profile.
@@ -651,9 +649,18 @@ protected:
   /// Points to the end of the buffer.
   const uint8_t *End = nullptr;
 
-  /// Function name table.
+  /// Function name table. For a fixed length MD5 name table it is only
+  /// populated on demand by getNameTable(), see MD5NameMemStart.
   std::vector<FunctionId> NameTable;
 
+  /// The start of a fixed length MD5 name table in the profile buffer, or
+  /// null. Names are then read from the buffer instead of NameTable, so
+  /// loading such a profile does not copy the name table to the heap.
+  const uint8_t *MD5NameMemStart = nullptr;
+
+  /// The number of entries at MD5NameMemStart.
+  size_t MD5NameTableSize = 0;
+
   /// CSNameTable is used to save full context vectors. It is the backing buffer
   /// for SampleContextFrames.
   std::vector<SampleContextFrameVector> CSNameTable;
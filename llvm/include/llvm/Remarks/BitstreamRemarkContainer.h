@@ -84,9 +84,10 @@ enum RecordIDs {
   RECORD_REMARK_HOTNESS,
   RECORD_REMARK_ARG_WITH_DEBUGLOC,
   RECORD_REMARK_ARG_WITHOUT_DEBUGLOC,
+  RECORD_REMARK_STRTAB,
   // Helpers.
   RECORD_FIRST = RECORD_META_CONTAINER_INFO,
-  RECORD_LAST = RECORD_REMARK_ARG_WITHOUT_DEBUGLOC
+  RECORD_LAST = RECORD_REMARK_STRTAB
 };
 
 constexpr StringRef MetaContainerInfoName = StringRef("Container info", 14);
@@ -99,6 +100,7 @@ constexpr StringRef RemarkHotnessName = StringRef("Remark hotness", 14);
 constexpr StringRef RemarkArgWithDebugLocName =
     StringRef("Argument with debug location", 28);
 constexpr StringRef RemarkArgWithoutDebugLocName = StringRef("Argument", 8);
+constexpr StringRef RemarkStrTabName = StringRef("Remark string table", 19);
 
 } // end namespace remarks
 } // end namespace llvm
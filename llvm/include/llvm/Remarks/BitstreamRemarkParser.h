@@ -63,6 +63,9 @@ struct BitstreamRemarkParserHelper {
   std::optional<uint32_t> SourceLine;
   std::optional<uint32_t> SourceColumn;
   std::optional<uint64_t> Hotness;
+  /// The strings this remark adds to the string table, if they are inlined.
+  std::optional<uint64_t> StrTabFirstIdx;
+  std::optional<StringRef> StrTabBuf;
   struct Argument {
     std::optional<uint64_t> KeyIdx;
     std::optional<uint64_t> ValueIdx;
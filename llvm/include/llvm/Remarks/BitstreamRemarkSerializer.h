@@ -58,6 +58,13 @@ struct BitstreamRemarkSerializerHelper {
   BitstreamWriter Bitstream;
   /// The type of the container we are serializing.
   BitstreamRemarkContainerType ContainerType;
+  /// Emit the strings that a remark introduces in the remark block itself, so
+  /// that a SeparateRemarksFile can be parsed as it is being written, without
+  /// the string table from the metadata.
+  bool InlineStrTab = false;
+  /// Number of strings from the string table that were already emitted in
+  /// remark blocks.
+  uint64_t NumInlinedStrings = 0;
 
   /// Abbrev IDs initialized in the block info block.
   /// Note: depending on the container type, some IDs might be uninitialized.
@@ -72,6 +79,7 @@ struct BitstreamRemarkSerializerHelper {
   uint64_t RecordRemarkHotnessAbbrevID = 0;
   uint64_t RecordRemarkArgWithDebugLocAbbrevID = 0;
   uint64_t RecordRemarkArgWithoutDebugLocAbbrevID = 0;
+  uint64_t RecordRemarkStrTabAbbrevID = 0;
 
   BitstreamRemarkSerializerHelper(BitstreamRemarkContainerType ContainerType);
 
@@ -103,6 +111,8 @@ struct BitstreamRemarkSerializerHelper {
 
   /// The block info for the remarks block.
   void setupRemarkBlockInfo();
+  /// The strings a remark adds to the string table, emitted in its block.
+  void emitRemarkStrTab(const Remark &Remark, StringTable &StrTab);
 
   /// Emit the metadata for the remarks.
   void emitMetaBlock(uint64_t ContainerVersion,
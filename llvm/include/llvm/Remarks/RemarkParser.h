@@ -63,6 +63,8 @@ struct ParsedStringTable {
   /// This object has high changes to be std::move'd around, so don't use a
   /// SmallVector for once.
   std::vector<size_t> Offsets;
+  /// Strings appended after construction, from buffers other than \p Buffer.
+  std::vector<StringRef> Appended;
 
   ParsedStringTable(StringRef Buffer);
   /// Disable copy.
@@ -72,8 +74,11 @@ struct ParsedStringTable {
   ParsedStringTable(ParsedStringTable &&) = default;
   ParsedStringTable &operator=(ParsedStringTable &&) = default;
 
-  size_t size() const { return Offsets.size(); }
+  size_t size() const { return Offsets.size() + Appended.size(); }
   Expected<StringRef> operator[](size_t Index) const;
+  /// Append the '\0'-separated strings in \p Buffer to the table. \p Buffer
+  /// needs to outlive the table.
+  void append(StringRef Buffer);
 };
 
 Expected<std::unique_ptr<RemarkParser>> createRemarkParser(Format ParserFormat,
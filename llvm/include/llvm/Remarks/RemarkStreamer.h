@@ -30,6 +30,8 @@
 #ifndef LLVM_REMARKS_REMARKSTREAMER_H
 #define LLVM_REMARKS_REMARKSTREAMER_H
 
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Remarks/Remark.h"
 #include "llvm/Remarks/RemarkSerializer.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/Regex.h"
@@ -44,6 +46,12 @@ namespace remarks {
 class RemarkStreamer final {
   /// The regex used to filter remarks based on the passes that emit them.
   std::optional<Regex> PassFilter;
+  /// The result of matching PassFilter against each pass name seen so far.
+  /// Pass names come from a small set, and are checked for every remark.
+  StringMap<bool> PassFilterCache;
+  /// The set of remark types to keep, as a mask of (1 << Type). No mask
+  /// means all types are kept.
+  std::optional<unsigned> TypeFilter;
   /// The object used to serialize the remarks to a specific format.
   std::unique_ptr<remarks::RemarkSerializer> RemarkSerializer;
   /// The filename that the remark diagnostics are emitted to.
@@ -66,6 +74,19 @@ public:
   Error setFilter(StringRef Filter);
   /// Check wether the string matches the filter.
   bool matchesFilter(StringRef Str);
+  /// Set a filter on the remark type based on a comma-separated list of types
+  /// as spelled by typeToStr, ignoring case (e.g. "missed,analysis").
+  /// Returns an error if a type is unknown.
+  Error setTypeFilter(StringRef Filter);
+  /// Check whether remarks of type \p Ty pass the type filter.
+  bool matchesTypeFilter(Type Ty) const {
+    return !TypeFilter || (*TypeFilter & (1U << static_cast<unsigned>(Ty)));
+  }
+  /// Check whether a remark of type \p Ty emitted by \p PassName would be
+  /// streamed. This is cheap enough to be checked before the remark is built.
+  bool isEnabled(StringRef PassName, Type Ty) {
+    return matchesTypeFilter(Ty) && matchesFilter(PassName);
+  }
   /// Check if the remarks also need to have associated metadata in a section.
   bool needsSection() const;
 };
@@ -8,18 +8,23 @@
 //
 // This file defines the CachedFileStream and the localCache function, which
 // simplifies caching files on the local filesystem in a directory whose
-// contents are managed by a CachePruningPolicy.
+// contents are managed by a CachePruningPolicy. It also defines
+// RemoteFileCache, which layers such a local cache over a store shared between
+// machines.
 //
 //===----------------------------------------------------------------------===//
 
 #ifndef LLVM_SUPPORT_CACHING_H
 #define LLVM_SUPPORT_CACHING_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/Support/Error.h"
+#include <memory>
 
 namespace llvm {
 
 class MemoryBuffer;
+class MemoryBufferRef;
 
 /// This class wraps an output stream for a file. Most clients should just be
 /// able to return an instance of this base class from the stream callback, but
@@ -74,6 +79,62 @@ Expected<FileCache> localCache(
     const Twine &CacheDirectoryPathRef,
     AddBufferFn AddBuffer = [](size_t Task, const Twine &ModuleName,
                                std::unique_ptr<MemoryBuffer> MB) {});
+
+/// A store of cache entries that is shared between machines, for example a
+/// server reachable over HTTP. Implementations must be thread safe.
+class RemoteCacheStore {
+public:
+  virtual ~RemoteCacheStore();
+
+  /// Returns the contents of the entry for \p Key, or nullptr if the store
+  /// does not have one.
+  virtual Expected<std::unique_ptr<MemoryBuffer>> fetch(StringRef Key) = 0;
+
+  /// Adds the entry \p Data for \p Key to the store.
+  virtual Error upload(StringRef Key, MemoryBufferRef Data) = 0;
+};
+
+/// A two-level file cache. Lookups are first served from a localCache
+/// directory. Local misses are fetched from a RemoteCacheStore and added to the
+/// local cache. Entries produced for a miss in both levels are uploaded to the
+/// store on a background thread once they have been committed locally, so
+/// producing an entry never waits for the network.
+///
+/// The store is only an accelerator: a failed fetch is treated as a miss and a
+/// failed upload is dropped.
+class RemoteFileCache {
+public:
+  /// Creates a cache whose local level behaves like the localCache with the
+  /// same arguments. \p Threads is the number of threads used for prefetches
+  /// and uploads.
+  static Expected<std::unique_ptr<RemoteFileCache>> create(
+      const Twine &CacheNameRef, const Twine &TempFilePrefixRef,
+      const Twine &CacheDirectoryPathRef,
+      std::unique_ptr<RemoteCacheStore> Store,
+      AddBufferFn AddBuffer = [](size_t Task, const Twine &ModuleName,
+                                 std::unique_ptr<MemoryBuffer> MB) {},
+      unsigned Threads = 4);
+
+  /// Waits for pending prefetches and uploads.
+  ~RemoteFileCache();
+
+  /// Returns the cache. It may be used concurrently from several threads.
+  FileCache getCache() const;
+
+  /// Starts fetching the entries for \p Keys into the local cache in the
+  /// background. A later lookup of one of these keys waits for its prefetch
+  /// instead of fetching it again.
+  void prefetch(ArrayRef<std::string> Keys);
+
+  /// Blocks until all pending prefetches and uploads are done.
+  void wait();
+
+private:
+  struct Impl;
+  RemoteFileCache(std::shared_ptr<Impl> I) : I(std::move(I)) {}
+
+  std::shared_ptr<Impl> I;
+};
 } // namespace llvm
 
 #endif
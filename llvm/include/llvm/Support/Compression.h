@@ -71,6 +71,30 @@ Error decompress(ArrayRef<uint8_t> Input, uint8_t *Output,
 Error decompress(ArrayRef<uint8_t> Input, SmallVectorImpl<uint8_t> &Output,
                  size_t UncompressedSize);
 
+/// Inputs larger than this are split into independent frames by
+/// compressParallel.
+constexpr size_t DefaultParallelChunkSize = size_t(4) << 20;
+
+/// Compress Input as a sequence of independent zstd frames, each holding at
+/// most ChunkSize bytes of input, using the llvm::parallel executor. The
+/// concatenated frames are a valid zstd stream that decompress() accepts.
+/// The output only depends on ChunkSize, not on the number of threads. Long
+/// distance matching needs a single frame, so EnableLdm disables splitting.
+void compressParallel(ArrayRef<uint8_t> Input,
+                      SmallVectorImpl<uint8_t> &CompressedBuffer,
+                      int Level = DefaultCompression, bool EnableLdm = false,
+                      size_t ChunkSize = DefaultParallelChunkSize);
+
+/// Decompress Input, decoding its frames in parallel if it consists of
+/// several frames that all record their uncompressed size. Falls back to
+/// decompress() otherwise.
+Error decompressParallel(ArrayRef<uint8_t> Input, uint8_t *Output,
+                         size_t &UncompressedSize);
+
+Error decompressParallel(ArrayRef<uint8_t> Input,
+                         SmallVectorImpl<uint8_t> &Output,
+                         size_t UncompressedSize);
+
 } // End of namespace zstd
 
 enum class Format {
@@ -101,9 +125,8 @@ struct Params {
   Format format;
   int level;
   bool zstdEnableLdm = false; // Enable zstd long distance matching
-  // This may support multi-threading for zstd in the future. Note that
-  // different threads may produce different output, so be careful if certain
-  // output determinism is desired.
+  // Large zstd inputs are compressed as several frames in parallel, see
+  // zstd::compressParallel. The output does not depend on the thread count.
 };
 
 // Return nullptr if LLVM was built with support (LLVM_ENABLE_ZLIB,
@@ -112,11 +135,13 @@ struct Params {
 const char *getReasonIfUnsupported(Format F);
 
 // Compress Input with the specified format P.Format. If Level is -1, use
-// *::DefaultCompression for the format.
+// *::DefaultCompression for the format. Zstd inputs larger than
+// zstd::DefaultParallelChunkSize are compressed in parallel.
 void compress(Params P, ArrayRef<uint8_t> Input,
               SmallVectorImpl<uint8_t> &Output);
 
-// Decompress Input. The uncompressed size must be available.
+// Decompress Input. The uncompressed size must be available. Multi-frame zstd
+// inputs are decompressed in parallel.
 Error decompress(DebugCompressionType T, ArrayRef<uint8_t> Input,
                  uint8_t *Output, size_t UncompressedSize);
 Error decompress(Format F, ArrayRef<uint8_t> Input,
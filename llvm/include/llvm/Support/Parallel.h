@@ -79,6 +79,11 @@ public:
       Cond.notify_all();
   }
 
+  bool isDone() const {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Count == 0;
+  }
+
   void sync() const {
     std::unique_lock<std::mutex> lock(Mutex);
     Cond.wait(lock, [&] { return Count == 0; });
@@ -101,7 +106,9 @@ public:
   // threads, but strictly in sequential order.
   void spawn(std::function<void()> f, bool Sequential = false);
 
-  void sync() const { L.sync(); }
+  // Wait for all spawned tasks to finish. When called from a worker thread,
+  // the group's tasks still queued on that thread are run in place.
+  void sync() const;
 
   bool isParallel() const { return Parallel; }
 };
@@ -92,6 +92,13 @@ public:
     return BytesAllocated;
   }
 
+  /// Return allocator used by the thread with index \a Idx. This allows
+  /// collecting per-thread statistics, e.g. to find unbalanced workloads.
+  const AllocatorTy &getAllocator(size_t Idx) const {
+    assert(Idx < NumOfAllocators);
+    return Allocators[Idx];
+  }
+
   /// Set red zone for all allocators.
   void setRedZoneSize(size_t NewSize) {
     for (size_t Idx = 0; Idx < getNumberOfAllocators(); Idx++)
@@ -104,6 +111,9 @@ public:
       errs() << "\n Allocator " << Idx << "\n";
       Allocators[Idx].PrintStats();
     }
+    errs() << "\nTotal: " << getBytesAllocated() << " bytes allocated, "
+           << getTotalMemory() << " bytes used by " << getNumberOfAllocators()
+           << " allocators\n";
   }
   /// @}
 
@@ -52,6 +52,9 @@
 //
 // The main process should begin with a timeTraceProfilerInitialize, and
 // finish with timeTraceProfileWrite and timeTraceProfilerCleanup calls.
+// Long-running processes can call timeTraceProfilerStartStreaming after
+// timeTraceProfilerInitialize to write sections out as they complete, which
+// bounds the memory used by the profiler.
 // Each new thread should begin with a timeTraceProfilerInitialize, and
 // finish with a timeTraceProfilerFinishThread call.
 //
@@ -118,6 +121,27 @@ void timeTraceProfilerWrite(raw_pwrite_stream &OS);
 Error timeTraceProfilerWrite(StringRef PreferredFileName,
                              StringRef FallbackFileName);
 
+/// Stream the profile to \p FileName while the program runs instead of
+/// keeping every section in memory until timeTraceProfilerWrite.
+/// Completed sections are queued in per-thread ring buffers of
+/// \p EntriesPerThread entries, which a background thread writes out. If a
+/// buffer is full because the writer fell behind, the section is dropped and
+/// counted in the "droppedEvents" attribute of the trace.
+/// Must be called on the main thread after timeTraceProfilerInitialize, and
+/// before other threads initialize their profilers.
+Error timeTraceProfilerStartStreaming(StringRef FileName,
+                                      size_t EntriesPerThread = 4096);
+
+/// Is the time trace profiler streaming to a file?
+bool timeTraceProfilerStreaming();
+
+/// Write the remaining sections and the totals to the streamed profile, and
+/// close it. Threads other than the main one must have called
+/// timeTraceProfilerFinishThread already. timeTraceProfilerWrite with file
+/// names calls this when streaming, and so does timeTraceProfilerCleanup if it
+/// was not called yet.
+Error timeTraceProfilerFinishStreaming();
+
 /// Manually begin a time section, with the given \p Name and \p Detail.
 /// Profiler copies the string data, so the pointers can be given into
 /// temporaries. Time sections can be hierarchical; every Begin must have a
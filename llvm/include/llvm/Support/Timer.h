@@ -28,13 +28,18 @@ class TimeRecord {
   double SystemTime = 0.0;           ///< System time elapsed.
   ssize_t MemUsed = 0;               ///< Memory allocated (in bytes).
   uint64_t InstructionsExecuted = 0; ///< Number of instructions executed
+  uint64_t Cycles = 0;               ///< CPU cycles (-track-perf-counters).
+  uint64_t L1DMisses = 0;            ///< L1 data cache read misses.
+  uint64_t LLCMisses = 0;            ///< Last level cache misses.
+  uint64_t BranchMisses = 0;         ///< Mispredicted branches.
 public:
   TimeRecord() = default;
 
   /// Get the current time and memory usage.  If Start is true we get the memory
   /// usage before the time, otherwise we get time before memory usage.  This
   /// matters if the time to get the memory usage is significant and shouldn't
-  /// be counted as part of a duration.
+  /// be counted as part of a duration.  With -track-perf-counters on Linux the
+  /// calling thread's hardware counters are sampled as well.
   static TimeRecord getCurrentTime(bool Start = true);
 
   double getProcessTime() const { return UserTime + SystemTime; }
@@ -43,6 +48,10 @@ public:
   double getWallTime() const { return WallTime; }
   ssize_t getMemUsed() const { return MemUsed; }
   uint64_t getInstructionsExecuted() const { return InstructionsExecuted; }
+  uint64_t getCycles() const { return Cycles; }
+  uint64_t getL1DMisses() const { return L1DMisses; }
+  uint64_t getLLCMisses() const { return LLCMisses; }
+  uint64_t getBranchMisses() const { return BranchMisses; }
 
   bool operator<(const TimeRecord &T) const {
     // Sort by Wall Time elapsed, as it is the only thing really accurate
@@ -55,6 +64,10 @@ public:
     SystemTime += RHS.SystemTime;
     MemUsed += RHS.MemUsed;
     InstructionsExecuted += RHS.InstructionsExecuted;
+    Cycles += RHS.Cycles;
+    L1DMisses += RHS.L1DMisses;
+    LLCMisses += RHS.LLCMisses;
+    BranchMisses += RHS.BranchMisses;
   }
   void operator-=(const TimeRecord &RHS) {
     WallTime -= RHS.WallTime;
@@ -62,6 +75,10 @@ public:
     SystemTime -= RHS.SystemTime;
     MemUsed -= RHS.MemUsed;
     InstructionsExecuted -= RHS.InstructionsExecuted;
+    Cycles -= RHS.Cycles;
+    L1DMisses -= RHS.L1DMisses;
+    LLCMisses -= RHS.LLCMisses;
+    BranchMisses -= RHS.BranchMisses;
   }
 
   /// Print the current time record to \p OS, with a breakdown showing
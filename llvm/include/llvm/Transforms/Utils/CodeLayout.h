@@ -57,6 +57,12 @@ double calcExtTspScore(ArrayRef<uint64_t> NodeSizes,
                        ArrayRef<uint64_t> NodeCounts,
                        ArrayRef<EdgeCount> EdgeCounts);
 
+/// Returns a hash of the tuning parameters of the Ext-TSP algorithm, which is
+/// the same in every run with the same parameters. Clients keeping layouts
+/// between runs use it to tell whether the algorithm would give the same
+/// layouts.
+uint64_t getExtTspParamsHash();
+
 /// Algorithm-specific params for Cache-Directed Sort. The values are tuned for
 /// the best performance of large-scale front-end bound binaries.
 struct CDSortConfig {
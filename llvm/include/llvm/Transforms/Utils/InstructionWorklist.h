@@ -119,6 +119,13 @@ public:
     }
   }
 
+  /// Drop all pending instructions, e.g. when giving up early.
+  void clear() {
+    Worklist.clear();
+    WorklistMap.clear();
+    Deferred.clear();
+  }
+
   /// Check that the worklist is empty and nuke the backing store for the map.
   void zap() {
     assert(WorklistMap.empty() && "Worklist empty, but map not?");
@@ -14,6 +14,7 @@
 #include "llvm/Analysis/LazyValueInfo.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/AssumptionCache.h"
 #include "llvm/Analysis/ConstantFolding.h"
 #include "llvm/Analysis/InstructionSimplify.h"
@@ -34,6 +35,7 @@
 #include "llvm/IR/PatternMatch.h"
 #include "llvm/IR/ValueHandle.h"
 #include "llvm/InitializePasses.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FormattedStream.h"
 #include "llvm/Support/KnownBits.h"
@@ -44,10 +46,20 @@ using namespace PatternMatch;
 
 #define DEBUG_TYPE "lazy-value-info"
 
+STATISTIC(NumCacheHits, "Number of block values found in the LVI cache");
+STATISTIC(NumCacheMisses, "Number of block values missing from the LVI cache");
+STATISTIC(NumBlocksEvicted, "Number of block caches evicted by LVI");
+
 // This is the number of worklist items we will process to try to discover an
 // answer for a given value.
 static const unsigned MaxProcessedPerValue = 500;
 
+static cl::opt<unsigned> MaxCachedBlocks(
+    "lvi-max-cached-blocks", cl::Hidden, cl::init(0),
+    cl::desc("Maximum number of basic blocks LVI keeps cached values for. "
+             "The least recently used blocks are evicted once a query "
+             "finishes (0 = unlimited)"));
+
 char LazyValueInfoWrapperPass::ID = 0;
 LazyValueInfoWrapperPass::LazyValueInfoWrapperPass() : FunctionPass(ID) {
   initializeLazyValueInfoWrapperPassPass(*PassRegistry::getPassRegistry());
@@ -166,6 +178,8 @@ namespace {
       // std::nullopt indicates that the nonnull pointers for this basic block
       // block have not been computed yet.
       std::optional<NonNullPointerSet> NonNullPointers;
+      // Value of UseClock when this entry was last accessed.
+      mutable uint64_t LastUse = 0;
     };
 
     /// Cached information per basic block.
@@ -173,11 +187,14 @@ namespace {
         BlockCache;
     /// Set of value handles used to erase values from the cache on deletion.
     DenseSet<LVIValueHandle, DenseMapInfo<Value *>> ValueHandles;
+    /// Incremented on every block entry access, used for LRU eviction.
+    mutable uint64_t UseClock = 0;
 
     const BlockCacheEntry *getBlockEntry(BasicBlock *BB) const {
       auto It = BlockCache.find_as(BB);
       if (It == BlockCache.end())
         return nullptr;
+      It->second->LastUse = ++UseClock;
       return It->second.get();
     }
 
@@ -187,6 +204,7 @@ namespace {
         It = BlockCache.insert({ BB, std::make_unique<BlockCacheEntry>() })
                        .first;
 
+      It->second->LastUse = ++UseClock;
       return It->second.get();
     }
 
@@ -214,16 +232,23 @@ namespace {
     std::optional<ValueLatticeElement>
     getCachedValueInfo(Value *V, BasicBlock *BB) const {
       const BlockCacheEntry *Entry = getBlockEntry(BB);
-      if (!Entry)
+      if (!Entry) {
+        ++NumCacheMisses;
         return std::nullopt;
+      }
 
-      if (Entry->OverDefined.count(V))
+      if (Entry->OverDefined.count(V)) {
+        ++NumCacheHits;
         return ValueLatticeElement::getOverdefined();
+      }
 
       auto LatticeIt = Entry->LatticeElements.find_as(V);
-      if (LatticeIt == Entry->LatticeElements.end())
+      if (LatticeIt == Entry->LatticeElements.end()) {
+        ++NumCacheMisses;
         return std::nullopt;
+      }
 
+      ++NumCacheHits;
       return LatticeIt->second;
     }
 
@@ -246,6 +271,11 @@ namespace {
       ValueHandles.clear();
     }
 
+    /// Evict the least recently used blocks if more than MaxCachedBlocks
+    /// blocks are cached. Must not be called while the solver is running, as
+    /// it relies on the values it just computed staying in the cache.
+    void enforceLimit();
+
     /// Inform the cache that a given value has been deleted.
     void eraseValue(Value *V);
 
@@ -283,6 +313,24 @@ void LazyValueInfoCache::eraseBlock(BasicBlock *BB) {
   BlockCache.erase(BB);
 }
 
+void LazyValueInfoCache::enforceLimit() {
+  if (!MaxCachedBlocks || BlockCache.size() <= MaxCachedBlocks)
+    return;
+
+  // Evict down to 3/4 of the limit so that the sort is amortized over many
+  // queries.
+  SmallVector<std::pair<uint64_t, BasicBlock *>, 0> Entries;
+  Entries.reserve(BlockCache.size());
+  for (auto &Pair : BlockCache)
+    Entries.push_back({Pair.second->LastUse, Pair.first});
+  llvm::sort(Entries, llvm::less_first());
+
+  size_t NumToEvict = BlockCache.size() - MaxCachedBlocks * 3 / 4;
+  for (auto &Entry : ArrayRef(Entries).take_front(NumToEvict))
+    BlockCache.erase(Entry.second);
+  NumBlocksEvicted += NumToEvict;
+}
+
 void LazyValueInfoCache::threadEdgeImpl(BasicBlock *OldSucc,
                                         BasicBlock *NewSucc) {
   // When an edge in the graph has been threaded, values that we could not
@@ -1531,6 +1579,7 @@ ValueLatticeElement LazyValueInfoImpl::getValueInBlock(Value *V, BasicBlock *BB,
   }
 
   ValueLatticeElement Result = *OptResult;
+  TheCache.enforceLimit();
   LLVM_DEBUG(dbgs() << "  Result = " << Result << "\n");
   return Result;
 }
@@ -1568,6 +1617,7 @@ getValueOnEdge(Value *V, BasicBlock *FromBB, BasicBlock *ToBB,
     Result = getEdgeValue(V, FromBB, ToBB, CxtI);
   }
 
+  TheCache.enforceLimit();
   LLVM_DEBUG(dbgs() << "  Result = " << *Result << "\n");
   return *Result;
 }
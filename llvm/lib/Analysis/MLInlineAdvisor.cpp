@@ -54,17 +54,52 @@ using CompiledModelType = llvm::InlinerSizeModel;
 using CompiledModelType = NoopSavedModelImpl;
 #endif
 
+// A second embedded model may be trained for runtime performance instead of
+// size. It is built from LLVM_INLINER_SPEED_MODEL_PATH and must use the same
+// feature and decision signature as the size model, so a policy trained in
+// development mode (-enable-ml-inliner=development with -training-log) on
+// profiled builds can be compiled in AOT and selected with
+// -ml-inliner-release-model=speed.
+#if defined(LLVM_HAVE_TF_AOT_INLINERSPEEDMODEL)
+// codegen-ed file
+#include "InlinerSpeedModel.h" // NOLINT
+using CompiledSpeedModelType = llvm::InlinerSpeedModel;
+#else
+using CompiledSpeedModelType = NoopSavedModelImpl;
+#endif
+
+namespace {
+enum class ReleaseModelKind { Size, Speed };
+} // namespace
+
+static cl::opt<ReleaseModelKind> ReleaseModel(
+    "ml-inliner-release-model", cl::Hidden, cl::init(ReleaseModelKind::Size),
+    cl::desc("Embedded model used by the release mode ML inliner"),
+    cl::values(clEnumValN(ReleaseModelKind::Size, "size",
+                          "Model trained to reduce code size"),
+               clEnumValN(ReleaseModelKind::Speed, "speed",
+                          "Model trained to improve runtime performance")));
+
+template <class T>
+static std::unique_ptr<MLModelRunner> createAOTRunner(LLVMContext &Ctx) {
+  if (!llvm::isEmbeddedModelEvaluatorValid<T>())
+    return nullptr;
+  return std::make_unique<ReleaseModeModelRunner<T>>(Ctx, FeatureMap,
+                                                     DecisionName);
+}
+
 std::unique_ptr<InlineAdvisor>
 llvm::getReleaseModeAdvisor(Module &M, ModuleAnalysisManager &MAM,
                             std::function<bool(CallBase &)> GetDefaultAdvice) {
-  if (!llvm::isEmbeddedModelEvaluatorValid<CompiledModelType>() &&
-      InteractiveChannelBaseName.empty())
-    return nullptr;
   std::unique_ptr<MLModelRunner> AOTRunner;
-  if (InteractiveChannelBaseName.empty())
-    AOTRunner = std::make_unique<ReleaseModeModelRunner<CompiledModelType>>(
-        M.getContext(), FeatureMap, DecisionName);
-  else {
+  if (InteractiveChannelBaseName.empty()) {
+    if (ReleaseModel == ReleaseModelKind::Speed)
+      AOTRunner = createAOTRunner<CompiledSpeedModelType>(M.getContext());
+    else
+      AOTRunner = createAOTRunner<CompiledModelType>(M.getContext());
+    if (!AOTRunner)
+      return nullptr;
+  } else {
     auto Features = FeatureMap;
     if (InteractiveIncludeDefault)
       Features.push_back(DefaultDecisionSpec);
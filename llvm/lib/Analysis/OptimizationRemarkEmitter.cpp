@@ -19,6 +19,7 @@
 #include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LLVMRemarkStreamer.h"
 #include "llvm/InitializePasses.h"
 #include <optional>
 
@@ -76,6 +77,36 @@ void OptimizationRemarkEmitter::computeHotness(
     OptDiag.setHotness(computeHotness(V));
 }
 
+bool OptimizationRemarkEmitter::enabled(StringRef PassName,
+                                        DiagnosticKind Kind) const {
+  LLVMContext &Ctx = F->getContext();
+  if (LLVMRemarkStreamer *RS = Ctx.getLLVMRemarkStreamer())
+    if (RS->isEnabled(PassName, Kind))
+      return true;
+
+  const DiagnosticHandler *DH = Ctx.getDiagHandlerPtr();
+  switch (Kind) {
+  case DK_OptimizationRemark:
+    return DH->isPassedOptRemarkEnabled(PassName);
+  case DK_OptimizationRemarkMissed:
+    return DH->isMissedOptRemarkEnabled(PassName);
+  case DK_OptimizationFailure:
+    // Failures are warnings, and always reach the diagnostic handler.
+    return true;
+  default:
+    return PassName == OptimizationRemarkAnalysis::AlwaysPrint ||
+           DH->isAnalysisRemarkEnabled(PassName);
+  }
+}
+
+bool OptimizationRemarkEmitter::allowExtraAnalysis(LLVMContext &Ctx,
+                                                   StringRef PassName) {
+  if (LLVMRemarkStreamer *RS = Ctx.getLLVMRemarkStreamer())
+    if (RS->isEnabled(PassName))
+      return true;
+  return Ctx.getDiagHandlerPtr()->isAnyRemarkEnabled(PassName);
+}
+
 void OptimizationRemarkEmitter::emit(
     DiagnosticInfoOptimizationBase &OptDiagBase) {
   auto &OptDiag = cast<DiagnosticInfoIROptimization>(OptDiagBase);
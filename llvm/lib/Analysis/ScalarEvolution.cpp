@@ -142,6 +142,12 @@ STATISTIC(NumExitCountsNotComputed,
           "Number of loop exits without predictable exit counts");
 STATISTIC(NumBruteForceTripCountsComputed,
           "Number of loops with trip counts computed by force");
+STATISTIC(NumBackedgeTakenCountCacheHits,
+          "Number of backedge-taken count queries answered from the cache");
+STATISTIC(MaxValueExprMapSize,
+          "Largest number of values with a cached SCEV expression");
+STATISTIC(NumCacheBudgetResets,
+          "Number of times all SCEV caches were dropped to stay in budget");
 
 #ifdef EXPENSIVE_CHECKS
 bool llvm::VerifySCEV = true;
@@ -156,6 +162,12 @@ static cl::opt<unsigned>
                                      "derived loop"),
                             cl::init(100));
 
+static cl::opt<unsigned> SCEVCacheBudget(
+    "scalar-evolution-cache-budget", cl::Hidden, cl::init(0),
+    cl::desc("Forget all cached SCEV information when a loop is invalidated "
+             "and more than this many values have a cached SCEV expression "
+             "(0 = unlimited)"));
+
 static cl::opt<bool, true> VerifySCEVOpt(
     "verify-scev", cl::Hidden, cl::location(VerifySCEV),
     cl::desc("Verify ScalarEvolution's backedge taken counts (slow)"));
@@ -8337,8 +8349,10 @@ ScalarEvolution::getBackedgeTakenInfo(const Loop *L) {
   // backedge-taken count, which could result in infinite recursion.
   std::pair<DenseMap<const Loop *, BackedgeTakenInfo>::iterator, bool> Pair =
       BackedgeTakenCounts.insert({L, BackedgeTakenInfo()});
-  if (!Pair.second)
+  if (!Pair.second) {
+    ++NumBackedgeTakenCountCacheHits;
     return Pair.first->second;
+  }
 
   // computeBackedgeTakenCount may allocate memory for its result. Inserting it
   // into the BackedgeTakenCounts map transfers ownership. Otherwise, the result
@@ -8458,6 +8472,15 @@ void ScalarEvolution::forgetLoop(const Loop *L) {
     LoopWorklist.append(CurrL->begin(), CurrL->end());
   }
   forgetMemoizedResults(ToForget);
+  enforceCacheBudget();
+}
+
+void ScalarEvolution::enforceCacheBudget() {
+  MaxValueExprMapSize.updateMax(ValueExprMap.size());
+  if (!SCEVCacheBudget || ValueExprMap.size() <= SCEVCacheBudget)
+    return;
+  ++NumCacheBudgetResets;
+  forgetAllLoops();
 }
 
 void ScalarEvolution::forgetTopmostLoop(const Loop *L) {
@@ -39,7 +39,9 @@ static cl::opt<TargetLibraryInfoImpl::VectorLibrary> ClVectorLibrary(
                clEnumValN(TargetLibraryInfoImpl::ArmPL, "ArmPL",
                           "Arm Performance Libraries"),
                clEnumValN(TargetLibraryInfoImpl::AMDLIBM, "AMDLIBM",
-                          "AMD vector math library")));
+                          "AMD vector math library"),
+               clEnumValN(TargetLibraryInfoImpl::LLVMLIBC, "LLVMlibc",
+                          "LLVM libc vector math functions")));
 
 StringLiteral const TargetLibraryInfoImpl::StandardNames[LibFunc::NumLibFuncs] =
     {
@@ -1245,6 +1247,20 @@ const VecDesc VecFuncs_AMDLIBM[] = {
 #include "llvm/Analysis/VecFuncs.def"
 };
 
+static const VecDesc VecFuncs_LLVMLIBC_VF4[] = {
+#define TLI_DEFINE_LLVMLIBC_VF4_VECFUNCS
+#define TLI_DEFINE_VECFUNC(SCAL, VEC, VF, MASK, VABI_PREFIX)                   \
+  {SCAL, VEC, VF, MASK, VABI_PREFIX},
+#include "llvm/Analysis/VecFuncs.def"
+};
+
+static const VecDesc VecFuncs_LLVMLIBC_X86[] = {
+#define TLI_DEFINE_LLVMLIBC_X86_VECFUNCS
+#define TLI_DEFINE_VECFUNC(SCAL, VEC, VF, MASK, VABI_PREFIX)                   \
+  {SCAL, VEC, VF, MASK, VABI_PREFIX},
+#include "llvm/Analysis/VecFuncs.def"
+};
+
 void TargetLibraryInfoImpl::addVectorizableFunctionsFromVecLib(
     enum VectorLibrary VecLib, const llvm::Triple &TargetTriple) {
   switch (VecLib) {
@@ -1296,6 +1312,23 @@ void TargetLibraryInfoImpl::addVectorizableFunctionsFromVecLib(
     addVectorizableFunctions(VecFuncs_AMDLIBM);
     break;
   }
+  case LLVMLIBC: {
+    switch (TargetTriple.getArch()) {
+    default:
+      break;
+    case llvm::Triple::x86_64:
+      // The 8-lane variants only require AVX, which is what makes the
+      // vectorizer use 8 lanes for float.
+      addVectorizableFunctions(VecFuncs_LLVMLIBC_VF4);
+      addVectorizableFunctions(VecFuncs_LLVMLIBC_X86);
+      break;
+    case llvm::Triple::aarch64:
+    case llvm::Triple::aarch64_be:
+      addVectorizableFunctions(VecFuncs_LLVMLIBC_VF4);
+      break;
+    }
+    break;
+  }
   case NoLibrary:
     break;
   }
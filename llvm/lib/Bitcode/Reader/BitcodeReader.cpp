@@ -71,6 +71,8 @@
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/ModRef.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/TargetParser/Triple.h"
 #include <algorithm>
@@ -705,6 +707,7 @@ public:
   Error materializeForwardReferencedFunctions();
 
   Error materialize(GlobalValue *GV) override;
+  Error materializeBatch(ArrayRef<GlobalValue *> GVs) override;
   Error materializeModule() override;
   std::vector<StructType *> getIdentifiedStructTypes() const override;
 
@@ -902,6 +905,7 @@ private:
   Error findFunctionInStream(
       Function *F,
       DenseMap<Function *, uint64_t>::iterator DeferredFunctionInfoIterator);
+  void prefetchFunctionBodies(ArrayRef<uint64_t> BodyBits);
 
   SyncScope::ID getDecodedSyncScopeID(unsigned Val);
 };
@@ -6937,6 +6941,84 @@ Error BitcodeReader::materialize(GlobalValue *GV) {
   return materializeForwardReferencedFunctions();
 }
 
+Error BitcodeReader::materializeBatch(ArrayRef<GlobalValue *> GVs) {
+  // Locate every requested body up front so they can be parsed in stream
+  // order rather than jumping back and forth through the buffer.
+  SmallVector<std::pair<uint64_t, Function *>, 16> Bodies;
+  for (GlobalValue *GV : GVs) {
+    Function *F = dyn_cast<Function>(GV);
+    if (!F || !F->isMaterializable())
+      continue;
+    auto DFII = DeferredFunctionInfo.find(F);
+    assert(DFII != DeferredFunctionInfo.end() && "Deferred function not found!");
+    if (DFII->second == 0)
+      if (Error Err = findFunctionInStream(F, DFII))
+        return Err;
+    Bodies.push_back({DFII->second, F});
+  }
+  llvm::sort(Bodies, less_first());
+
+  if (Bodies.size() > 1) {
+    SmallVector<uint64_t, 16> BodyBits;
+    for (const auto &Body : Bodies)
+      BodyBits.push_back(Body.first);
+    prefetchFunctionBodies(BodyBits);
+  }
+
+  // Bodies already pulled in through a blockaddress forward reference are
+  // skipped by materialize().
+  for (const auto &Body : Bodies)
+    if (Error Err = materialize(Body.second))
+      return Err;
+  return Error::success();
+}
+
+/// Fault in the bytes of the function blocks starting at \p BodyBits from
+/// several threads.  For a cold mmap'd file this overlaps the disk reads that
+/// parsing the bodies one after another would otherwise wait on serially.
+void BitcodeReader::prefetchFunctionBodies(ArrayRef<uint64_t> BodyBits) {
+  // Only worth spinning up threads for inputs spanning a good number of pages.
+  constexpr size_t MinPrefetchBytes = 1 << 20;
+
+  ArrayRef<uint8_t> Bytes = Stream.getBitcodeBytes();
+  SmallVector<ArrayRef<uint8_t>, 16> Ranges;
+  size_t TotalBytes = 0;
+  for (uint64_t Bit : BodyBits) {
+    // Decode just the block header: the code width, then the block length in
+    // 32-bit words.  Malformed headers are diagnosed when the body is parsed.
+    SimpleBitstreamCursor Header(Bytes);
+    if (errorToBool(Header.JumpToBit(Bit)))
+      continue;
+    Expected<uint32_t> CodeLen = Header.ReadVBR(bitc::CodeLenWidth);
+    if (!CodeLen) {
+      consumeError(CodeLen.takeError());
+      continue;
+    }
+    Header.SkipToFourByteBoundary();
+    Expected<SimpleBitstreamCursor::word_t> NumWords =
+        Header.Read(bitc::BlockSizeWidth);
+    if (!NumWords) {
+      consumeError(NumWords.takeError());
+      continue;
+    }
+    size_t Begin = Bit / 8;
+    size_t End = Header.GetCurrentBitNo() / 8 + size_t(*NumWords) * 4;
+    if (End > Bytes.size())
+      continue;
+    Ranges.push_back(Bytes.slice(Begin, End - Begin));
+    TotalBytes += End - Begin;
+  }
+  if (TotalBytes < MinPrefetchBytes)
+    return;
+
+  const size_t PageSize = sys::Process::getPageSizeEstimate();
+  parallelFor(0, Ranges.size(), [&](size_t I) {
+    ArrayRef<uint8_t> Range = Ranges[I];
+    for (size_t Offset = 0; Offset < Range.size(); Offset += PageSize)
+      (void)*static_cast<const volatile uint8_t *>(&Range[Offset]);
+  });
+}
+
 Error BitcodeReader::materializeModule() {
   if (Error Err = materializeMetadata())
     return Err;
@@ -12,6 +12,8 @@
 #include "llvm/CodeGen/GlobalISel/Utils.h"
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/APInt.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringSwitch.h"
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/CodeGen/CodeGenCommonISel.h"
 #include "llvm/CodeGen/GlobalISel/GISelChangeObserver.h"
@@ -43,6 +45,15 @@
 using namespace llvm;
 using namespace MIPatternMatch;
 
+STATISTIC(NumIRTranslatorFailures,
+          "Number of GlobalISel IR translation failures");
+STATISTIC(NumLegalizerFailures, "Number of GlobalISel legalization failures");
+STATISTIC(NumRegBankSelectFailures,
+          "Number of GlobalISel register bank selection failures");
+STATISTIC(NumInstructionSelectFailures,
+          "Number of GlobalISel instruction selection failures");
+STATISTIC(NumOtherFailures, "Number of other GlobalISel failures");
+
 Register llvm::constrainRegToClass(MachineRegisterInfo &MRI,
                                    const TargetInstrInfo &TII,
                                    const RegisterBankInfo &RBI, Register Reg,
@@ -272,9 +283,27 @@ void llvm::reportGISelWarning(MachineFunction &MF, const TargetPassConfig &TPC,
   reportGISelDiagnostic(DS_Warning, MF, TPC, MORE, R);
 }
 
+// Attribute a failure to the GlobalISel stage that reported it, so that the
+// -stats output shows where functions fall back to SelectionDAG. The keys are
+// the pass names the stages use for their failure remarks.
+void llvm::countGISelFailure(const MachineFunction &MF, StringRef PassName) {
+  // Only count the first failure of a function; it is the one that makes the
+  // function fall back.
+  if (MF.getProperties().hasProperty(
+          MachineFunctionProperties::Property::FailedISel))
+    return;
+  ++*StringSwitch<Statistic *>(PassName)
+         .Case("gisel-irtranslator", &NumIRTranslatorFailures)
+         .Case("gisel-legalize", &NumLegalizerFailures)
+         .Case("gisel-regbankselect", &NumRegBankSelectFailures)
+         .Case("gisel-select", &NumInstructionSelectFailures)
+         .Default(&NumOtherFailures);
+}
+
 void llvm::reportGISelFailure(MachineFunction &MF, const TargetPassConfig &TPC,
                               MachineOptimizationRemarkEmitter &MORE,
                               MachineOptimizationRemarkMissed &R) {
+  countGISelFailure(MF, R.getPassName());
   MF.getProperties().set(MachineFunctionProperties::Property::FailedISel);
   reportGISelDiagnostic(DS_Error, MF, TPC, MORE, R);
 }
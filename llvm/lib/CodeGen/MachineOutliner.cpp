@@ -63,6 +63,7 @@
 #include "llvm/CodeGen/LivePhysRegs.h"
 #include "llvm/CodeGen/MachineModuleInfo.h"
 #include "llvm/CodeGen/MachineOptimizationRemarkEmitter.h"
+#include "llvm/CodeGen/MachineStableHash.h"
 #include "llvm/CodeGen/Passes.h"
 #include "llvm/CodeGen/TargetInstrInfo.h"
 #include "llvm/CodeGen/TargetSubtargetInfo.h"
@@ -121,6 +122,14 @@ static cl::opt<unsigned> OutlinerBenefitThreshold(
     cl::desc(
         "The minimum size in bytes before an outlining candidate is accepted"));
 
+/// The stable hash identifies the outlined sequence independently of the
+/// module it was found in. Collecting the remarks of all ThinLTO backends
+/// shows which sequences are outlined in several modules.
+static cl::opt<bool> OutlinerRemarkStableHash(
+    "outliner-remark-stable-hash", cl::init(false), cl::Hidden,
+    cl::desc("Report a stable hash of each outlined function's body in the "
+             "OutlinedFunction remark"));
+
 namespace {
 
 /// Maps \p MachineInstrs to unsigned integers and stores the mappings.
@@ -548,6 +557,22 @@ void MachineOutliner::emitNotOutliningCheaperRemark(
   });
 }
 
+/// Return a stable hash of the instructions in \p MF, or 0 if one of them
+/// has operands, such as global addresses, that cannot be hashed stably.
+static stable_hash getOutlinedBodyHash(const MachineFunction &MF) {
+  SmallVector<stable_hash> HashComponents;
+  for (const MachineBasicBlock &MBB : MF) {
+    for (const MachineInstr &MI : MBB) {
+      stable_hash Hash = stableHashValue(MI);
+      if (!Hash)
+        return 0;
+      HashComponents.push_back(Hash);
+    }
+  }
+  return stable_hash_combine_range(HashComponents.begin(),
+                                   HashComponents.end());
+}
+
 void MachineOutliner::emitOutlinedFunctionRemark(OutlinedFunction &OF) {
   MachineBasicBlock *MBB = &*OF.MF->begin();
   MachineOptimizationRemarkEmitter MORE(*OF.MF, nullptr);
@@ -570,6 +595,10 @@ void MachineOutliner::emitOutlinedFunctionRemark(OutlinedFunction &OF) {
 
   R << ")";
 
+  if (OutlinerRemarkStableHash)
+    if (stable_hash Hash = getOutlinedBodyHash(*OF.MF))
+      R << " " << NV("StableHash", Hash);
+
   MORE.emit(R);
 }
 
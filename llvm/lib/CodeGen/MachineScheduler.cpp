@@ -74,6 +74,9 @@ using namespace llvm;
 #define DEBUG_TYPE "machine-scheduler"
 
 STATISTIC(NumClustered, "Number of load/store pairs clustered");
+STATISTIC(NumRegionsOverPressureLimit,
+          "Number of regions scheduled without pressure tracking because "
+          "they exceed -misched-regpressure-max-region-size");
 
 namespace llvm {
 
@@ -155,6 +158,15 @@ static cl::opt<unsigned> ReadyListLimit("misched-limit", cl::Hidden,
 static cl::opt<bool> EnableRegPressure("misched-regpressure", cl::Hidden,
   cl::desc("Enable register pressure scheduling."), cl::init(true));
 
+/// Register pressure tracking and the per-instruction pressure diffs dominate
+/// scheduling time in very large regions. Above this size, schedule the
+/// region by latency and resources alone.
+static cl::opt<unsigned> RegPressureMaxRegionSize(
+    "misched-regpressure-max-region-size", cl::Hidden,
+    cl::desc("Do not track register pressure in regions with more than N "
+             "instructions (0 = no limit)"),
+    cl::init(0));
+
 static cl::opt<bool> EnableCyclicPath("misched-cyclicpath", cl::Hidden,
   cl::desc("Enable cyclic critical path analysis."), cl::init(true));
 
@@ -3305,6 +3317,13 @@ void GenericScheduler::initPolicy(MachineBasicBlock::iterator Begin,
   if (!EnableRegPressure) {
     RegionPolicy.ShouldTrackPressure = false;
     RegionPolicy.ShouldTrackLaneMasks = false;
+  } else if (RegPressureMaxRegionSize && RegionPolicy.ShouldTrackPressure &&
+             NumRegionInstrs > RegPressureMaxRegionSize) {
+    LLVM_DEBUG(dbgs() << "Region of " << NumRegionInstrs
+                      << " instructions exceeds pressure tracking limit\n");
+    ++NumRegionsOverPressureLimit;
+    RegionPolicy.ShouldTrackPressure = false;
+    RegionPolicy.ShouldTrackLaneMasks = false;
   }
 
   // Check -misched-topdown/bottomup can force or unforce scheduling direction.
@@ -81,6 +81,10 @@ using namespace llvm;
 STATISTIC(NumGlobalSplits, "Number of split global live ranges");
 STATISTIC(NumLocalSplits,  "Number of split local live ranges");
 STATISTIC(NumEvicted,      "Number of interferences evicted");
+STATISTIC(NumSplitBudgetExceeded,
+          "Number of live ranges not split due to the split budget");
+STATISTIC(NumEvictBudgetExceeded,
+          "Number of live ranges not evicting due to the eviction budget");
 
 static cl::opt<SplitEditor::ComplementSpillMode> SplitSpillMode(
     "split-spill-mode", cl::Hidden,
@@ -146,6 +150,20 @@ static cl::opt<unsigned> SplitThresholdForRegWithHint(
              "percentate"),
     cl::init(75), cl::Hidden);
 
+// The split and eviction budgets trade code quality for compile time on huge
+// functions. Once a budget is used up, the remaining spillable live ranges go
+// straight to spilling instead of being split or evicting other ranges.
+// Ranges that cannot be spilled are never subject to the budgets.
+static cl::opt<unsigned> GreedySplitBudget(
+    "greedy-split-budget", cl::Hidden, cl::init(0),
+    cl::desc("Maximum number of live range split attempts per function "
+             "(0 = unlimited)"));
+
+static cl::opt<unsigned> GreedyEvictionBudget(
+    "greedy-eviction-budget", cl::Hidden, cl::init(0),
+    cl::desc("Maximum number of eviction attempts per function "
+             "(0 = unlimited)"));
+
 static RegisterRegAlloc greedyRegAlloc("greedy", "greedy register allocator",
                                        createGreedyRegisterAllocator);
 
@@ -2443,10 +2461,16 @@ MCRegister RAGreedy::selectOrSplitImpl(const LiveInterval &VirtReg,
   // Try to evict a less worthy live range, but only for ranges from the primary
   // queue. The RS_Split ranges already failed to do this, and they should not
   // get a second chance until they have been split.
-  if (Stage != RS_Split)
-    if (Register PhysReg =
-            tryEvict(VirtReg, Order, NewVRegs, CostPerUseLimit,
-                     FixedRegisters)) {
+  bool CanEvict = Stage != RS_Split;
+  if (CanEvict && GreedyEvictionBudget && VirtReg.isSpillable() &&
+      NumEvictAttempts >= GreedyEvictionBudget) {
+    ++NumEvictBudgetExceeded;
+    CanEvict = false;
+  }
+  if (CanEvict) {
+    ++NumEvictAttempts;
+    if (Register PhysReg = tryEvict(VirtReg, Order, NewVRegs, CostPerUseLimit,
+                                    FixedRegisters)) {
       Register Hint = MRI->getSimpleHint(VirtReg.reg());
       // If VirtReg has a hint and that hint is broken record this
       // virtual register as a recoloring candidate for broken hint.
@@ -2457,6 +2481,7 @@ MCRegister RAGreedy::selectOrSplitImpl(const LiveInterval &VirtReg,
         SetOfBrokenHints.insert(&VirtReg);
       return PhysReg;
     }
+  }
 
   assert((NewVRegs.empty() || Depth) && "Cannot append to existing NewVRegs");
 
@@ -2470,7 +2495,16 @@ MCRegister RAGreedy::selectOrSplitImpl(const LiveInterval &VirtReg,
     return 0;
   }
 
-  if (Stage < RS_Spill) {
+  bool CanSplit = Stage < RS_Spill;
+  if (CanSplit && GreedySplitBudget && VirtReg.isSpillable() &&
+      NumSplitAttempts >= GreedySplitBudget) {
+    LLVM_DEBUG(dbgs() << "split budget exhausted, spilling\n");
+    ++NumSplitBudgetExceeded;
+    CanSplit = false;
+  }
+
+  if (CanSplit) {
+    ++NumSplitAttempts;
     // Try splitting VirtReg or interferences.
     unsigned NewVRegSizeBefore = NewVRegs.size();
     Register PhysReg = trySplit(VirtReg, Order, NewVRegs, FixedRegisters);
@@ -2767,6 +2801,8 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   IntfCache.init(MF, Matrix->getLiveUnions(), Indexes, LIS, TRI);
   GlobalCand.resize(32);  // This will grow as needed.
   SetOfBrokenHints.clear();
+  NumSplitAttempts = 0;
+  NumEvictAttempts = 0;
 
   allocatePhysRegs();
   tryHintsRecoloring();
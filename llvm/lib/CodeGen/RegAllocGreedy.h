@@ -280,6 +280,12 @@ private:
 
   bool ReverseLocalAssignment = false;
 
+  /// Number of split and eviction attempts made in the current machine
+  /// function, checked against -greedy-split-budget and
+  /// -greedy-eviction-budget.
+  unsigned NumSplitAttempts = 0;
+  unsigned NumEvictAttempts = 0;
+
 public:
   RAGreedy(const RegClassFilterFunc F = allocateAllRegClasses);
 
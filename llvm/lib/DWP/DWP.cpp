@@ -633,11 +633,9 @@ Error write(MCStreamer &Out, ArrayRef<std::string> Inputs,
 
   DWPStringPool Strings(Out, StrSection);
 
-  SmallVector<OwningBinary<object::ObjectFile>, 128> Objects;
-  Objects.reserve(Inputs.size());
-
-  std::deque<SmallString<32>> UncompressedSections;
-
+  // Inputs are opened one at a time and released once their contributions
+  // have been emitted, so only the current input (and its decompressed
+  // sections) is resident in addition to the output being built.
   for (const auto &Input : Inputs) {
     auto ErrOrObj = object::ObjectFile::createObjectFile(Input);
     if (!ErrOrObj) {
@@ -647,8 +645,9 @@ Error write(MCStreamer &Out, ArrayRef<std::string> Inputs,
                           });
     }
 
-    auto &Obj = *ErrOrObj->getBinary();
-    Objects.push_back(std::move(*ErrOrObj));
+    OwningBinary<object::ObjectFile> CurObj = std::move(*ErrOrObj);
+    auto &Obj = *CurObj.getBinary();
+    std::deque<SmallString<32>> UncompressedSections;
 
     UnitIndexEntry CurEntry = {};
 
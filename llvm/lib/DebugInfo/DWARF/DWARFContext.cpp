@@ -1514,15 +1514,47 @@ DWARFCompileUnit *DWARFContext::getCompileUnitForOffset(uint64_t Offset) {
       State->getNormalUnits().getUnitForOffset(Offset));
 }
 
+void DWARFContext::noteAddressLookupUnit(DWARFUnit *U) {
+  if (!MaxAddressLookupUnitsSize || !U)
+    return;
+  auto It = llvm::find(AddressLookupUnits, U);
+  if (It != AddressLookupUnits.end())
+    AddressLookupUnits.erase(It);
+  else
+    AddressLookupUnitsSize += U->getLength();
+  AddressLookupUnits.push_back(U);
+}
+
+void DWARFContext::pruneAddressLookupUnits() {
+  if (!MaxAddressLookupUnitsSize)
+    return;
+  while (AddressLookupUnitsSize > MaxAddressLookupUnitsSize &&
+         !AddressLookupUnits.empty()) {
+    DWARFUnit *Victim = AddressLookupUnits.front();
+    AddressLookupUnits.erase(AddressLookupUnits.begin());
+    AddressLookupUnitsSize -= Victim->getLength();
+    Victim->clearDIEs(/*KeepCUDie=*/true);
+  }
+}
+
 DWARFCompileUnit *DWARFContext::getCompileUnitForCodeAddress(uint64_t Address) {
+  // Free DIEs before this lookup starts and before anything is extracted for
+  // it, so that no DIE it uses, including DIEs of other units it reaches
+  // through cross-unit references, is freed until it returns.
+  pruneAddressLookupUnits();
   uint64_t CUOffset = getDebugAranges()->findAddress(Address);
-  return getCompileUnitForOffset(CUOffset);
+  DWARFCompileUnit *CU = getCompileUnitForOffset(CUOffset);
+  noteAddressLookupUnit(CU);
+  return CU;
 }
 
 DWARFCompileUnit *DWARFContext::getCompileUnitForDataAddress(uint64_t Address) {
+  pruneAddressLookupUnits();
   uint64_t CUOffset = getDebugAranges()->findAddress(Address);
-  if (DWARFCompileUnit *OffsetCU = getCompileUnitForOffset(CUOffset))
+  if (DWARFCompileUnit *OffsetCU = getCompileUnitForOffset(CUOffset)) {
+    noteAddressLookupUnit(OffsetCU);
     return OffsetCU;
+  }
 
   // Global variables are often missed by the above search, for one of two
   // reasons:
@@ -1533,8 +1565,10 @@ DWARFCompileUnit *DWARFContext::getCompileUnitForDataAddress(uint64_t Address) {
   //      parent compile unit.
   //
   // So, we walk the CU's and their child DI's manually, looking for the
-  // specific global variable.
+  // specific global variable. The units walked here are only freed by the
+  // next lookup.
   for (std::unique_ptr<DWARFUnit> &CU : compile_units()) {
+    noteAddressLookupUnit(CU.get());
     if (CU->getVariableForAddress(Address)) {
       return static_cast<DWARFCompileUnit *>(CU.get());
     }
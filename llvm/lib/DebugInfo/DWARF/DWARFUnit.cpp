@@ -392,7 +392,6 @@ void DWARFUnit::clear() {
   AddrOffsetSectionBase = std::nullopt;
   SU = nullptr;
   clearDIEs(false);
-  AddrDieMap.clear();
   if (DWO)
     DWO->clear();
   DWO.reset();
@@ -661,6 +660,10 @@ void DWARFUnit::clearDIEs(bool KeepCUDie) {
   DieArray = (KeepCUDie && !DieArray.empty())
                  ? std::vector<DWARFDebugInfoEntry>({DieArray[0]})
                  : std::vector<DWARFDebugInfoEntry>();
+  // The address maps refer to the DIEs that were just freed.
+  AddrDieMap.clear();
+  VariableDieMap.clear();
+  RootsParsedForVariables.clear();
 }
 
 Expected<DWARFAddressRangesVector>
@@ -32,6 +32,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <map>
@@ -408,20 +409,37 @@ unsigned DWARFVerifier::verifyUnits(const DWARFUnitVector &Units) {
   unsigned NumDebugInfoErrors = 0;
   ReferenceMap CrossUnitReferences;
 
-  unsigned Index = 1;
-  for (const auto &Unit : Units) {
-    OS << "Verifying unit: " << Index << " / " << Units.getNumUnits();
-    if (const char* Name = Unit->getUnitDIE(true).getShortName())
-      OS << ", \"" << Name << '\"';
-    OS << '\n';
-    OS.flush();
-    ReferenceMap UnitLocalReferences;
-    NumDebugInfoErrors +=
-        verifyUnitContents(*Unit, UnitLocalReferences, CrossUnitReferences);
-    NumDebugInfoErrors += verifyDebugInfoReferences(
-        UnitLocalReferences, [&](uint64_t Offset) { return Unit.get(); });
-    ++Index;
-  }
+  // Verifying a unit may follow references into other units, so extract the
+  // DIEs of all of them up front; DWARFUnit does not do that thread-safely.
+  bool Parallel = shouldVerifyInParallel();
+  if (Parallel)
+    for (const auto &Unit : Units)
+      Unit->getNumDIEs();
+
+  // Each unit collects its cross unit references separately. They are merged
+  // in unit order once all units have been verified.
+  std::vector<ReferenceMap> UnitCrossReferences(Parallel ? Units.size() : 0);
+  NumDebugInfoErrors += verifyInParallel(
+      Units.size(), [&](DWARFVerifier &Verifier, size_t Index) {
+        DWARFUnit *Unit = Units[Index].get();
+        raw_ostream &UnitOS = Verifier.OS;
+        UnitOS << "Verifying unit: " << Index + 1 << " / "
+               << Units.getNumUnits();
+        if (const char *Name = Unit->getUnitDIE(true).getShortName())
+          UnitOS << ", \"" << Name << '\"';
+        UnitOS << '\n';
+        UnitOS.flush();
+        ReferenceMap UnitLocalReferences;
+        unsigned NumErrors = Verifier.verifyUnitContents(
+            *Unit, UnitLocalReferences,
+            Parallel ? UnitCrossReferences[Index] : CrossUnitReferences);
+        NumErrors += Verifier.verifyDebugInfoReferences(
+            UnitLocalReferences, [&](uint64_t Offset) { return Unit; });
+        return NumErrors;
+      });
+  for (ReferenceMap &References : UnitCrossReferences)
+    for (auto &[Offset, Referrers] : References)
+      CrossUnitReferences[Offset].insert(Referrers.begin(), Referrers.end());
 
   NumDebugInfoErrors += verifyDebugInfoReferences(
       CrossUnitReferences, [&](uint64_t Offset) -> DWARFUnit * {
@@ -975,108 +993,108 @@ void DWARFVerifier::verifyDebugLineStmtOffsets() {
   }
 }
 
-void DWARFVerifier::verifyDebugLineRows() {
-  for (const auto &CU : DCtx.compile_units()) {
-    auto Die = CU->getUnitDIE();
-    auto LineTable = DCtx.getLineTableForUnit(CU.get());
-    // If there is no line table we will have created an error in the
-    // .debug_info verifier or in verifyDebugLineStmtOffsets().
-    if (!LineTable)
-      continue;
-
-    // Verify prologue.
-    bool isDWARF5 = LineTable->Prologue.getVersion() >= 5;
-    uint32_t MaxDirIndex = LineTable->Prologue.IncludeDirectories.size();
-    uint32_t MinFileIndex = isDWARF5 ? 0 : 1;
-    uint32_t FileIndex = MinFileIndex;
-    StringMap<uint16_t> FullPathMap;
-    for (const auto &FileName : LineTable->Prologue.FileNames) {
-      // Verify directory index.
-      if (FileName.DirIdx > MaxDirIndex) {
-        ++NumDebugLineErrors;
-        ErrorCategory.Report(
-            "Invalid index in .debug_line->prologue.file_names->dir_idx",
-            [&]() {
-              error() << ".debug_line["
-                      << format("0x%08" PRIx64,
-                                *toSectionOffset(Die.find(DW_AT_stmt_list)))
-                      << "].prologue.file_names[" << FileIndex
-                      << "].dir_idx contains an invalid index: "
-                      << FileName.DirIdx << "\n";
-            });
-      }
+unsigned DWARFVerifier::verifyDebugLineRows(DWARFUnit &Unit) {
+  unsigned NumErrors = 0;
+  auto Die = Unit.getUnitDIE();
+  auto LineTable = DCtx.getLineTableForUnit(&Unit);
+  // If there is no line table we will have created an error in the
+  // .debug_info verifier or in verifyDebugLineStmtOffsets().
+  if (!LineTable)
+    return NumErrors;
 
-      // Check file paths for duplicates.
-      std::string FullPath;
-      const bool HasFullPath = LineTable->getFileNameByIndex(
-          FileIndex, CU->getCompilationDir(),
-          DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath, FullPath);
-      assert(HasFullPath && "Invalid index?");
-      (void)HasFullPath;
-      auto It = FullPathMap.find(FullPath);
-      if (It == FullPathMap.end())
-        FullPathMap[FullPath] = FileIndex;
-      else if (It->second != FileIndex && DumpOpts.Verbose) {
-        warn() << ".debug_line["
-               << format("0x%08" PRIx64,
-                         *toSectionOffset(Die.find(DW_AT_stmt_list)))
-               << "].prologue.file_names[" << FileIndex
-               << "] is a duplicate of file_names[" << It->second << "]\n";
-      }
+  // Verify prologue.
+  bool isDWARF5 = LineTable->Prologue.getVersion() >= 5;
+  uint32_t MaxDirIndex = LineTable->Prologue.IncludeDirectories.size();
+  uint32_t MinFileIndex = isDWARF5 ? 0 : 1;
+  uint32_t FileIndex = MinFileIndex;
+  StringMap<uint16_t> FullPathMap;
+  for (const auto &FileName : LineTable->Prologue.FileNames) {
+    // Verify directory index.
+    if (FileName.DirIdx > MaxDirIndex) {
+      ++NumErrors;
+      ErrorCategory.Report(
+          "Invalid index in .debug_line->prologue.file_names->dir_idx",
+          [&]() {
+            error() << ".debug_line["
+                    << format("0x%08" PRIx64,
+                              *toSectionOffset(Die.find(DW_AT_stmt_list)))
+                    << "].prologue.file_names[" << FileIndex
+                    << "].dir_idx contains an invalid index: "
+                    << FileName.DirIdx << "\n";
+          });
+    }
 
-      FileIndex++;
+    // Check file paths for duplicates.
+    std::string FullPath;
+    const bool HasFullPath = LineTable->getFileNameByIndex(
+        FileIndex, Unit.getCompilationDir(),
+        DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath, FullPath);
+    assert(HasFullPath && "Invalid index?");
+    (void)HasFullPath;
+    auto It = FullPathMap.find(FullPath);
+    if (It == FullPathMap.end())
+      FullPathMap[FullPath] = FileIndex;
+    else if (It->second != FileIndex && DumpOpts.Verbose) {
+      warn() << ".debug_line["
+             << format("0x%08" PRIx64,
+                       *toSectionOffset(Die.find(DW_AT_stmt_list)))
+             << "].prologue.file_names[" << FileIndex
+             << "] is a duplicate of file_names[" << It->second << "]\n";
     }
 
-    // Nothing to verify in a line table with a single row containing the end
-    // sequence.
-    if (LineTable->Rows.size() == 1 && LineTable->Rows.front().EndSequence)
-      continue;
+    FileIndex++;
+  }
 
-    // Verify rows.
-    uint64_t PrevAddress = 0;
-    uint32_t RowIndex = 0;
-    for (const auto &Row : LineTable->Rows) {
-      // Verify row address.
-      if (Row.Address.Address < PrevAddress) {
-        ++NumDebugLineErrors;
-        ErrorCategory.Report(
-            "decreasing address between debug_line rows", [&]() {
-              error() << ".debug_line["
-                      << format("0x%08" PRIx64,
-                                *toSectionOffset(Die.find(DW_AT_stmt_list)))
-                      << "] row[" << RowIndex
-                      << "] decreases in address from previous row:\n";
-
-              DWARFDebugLine::Row::dumpTableHeader(OS, 0);
-              if (RowIndex > 0)
-                LineTable->Rows[RowIndex - 1].dump(OS);
-              Row.dump(OS);
-              OS << '\n';
-            });
-      }
+  // Nothing to verify in a line table with a single row containing the end
+  // sequence.
+  if (LineTable->Rows.size() == 1 && LineTable->Rows.front().EndSequence)
+    return NumErrors;
 
-      if (!LineTable->hasFileAtIndex(Row.File)) {
-        ++NumDebugLineErrors;
-        ErrorCategory.Report("Invalid file index in debug_line", [&]() {
-          error() << ".debug_line["
-                  << format("0x%08" PRIx64,
-                            *toSectionOffset(Die.find(DW_AT_stmt_list)))
-                  << "][" << RowIndex << "] has invalid file index " << Row.File
-                  << " (valid values are [" << MinFileIndex << ','
-                  << LineTable->Prologue.FileNames.size()
-                  << (isDWARF5 ? ")" : "]") << "):\n";
-          DWARFDebugLine::Row::dumpTableHeader(OS, 0);
-          Row.dump(OS);
-          OS << '\n';
-        });
-      }
-      if (Row.EndSequence)
-        PrevAddress = 0;
-      else
-        PrevAddress = Row.Address.Address;
-      ++RowIndex;
+  // Verify rows.
+  uint64_t PrevAddress = 0;
+  uint32_t RowIndex = 0;
+  for (const auto &Row : LineTable->Rows) {
+    // Verify row address.
+    if (Row.Address.Address < PrevAddress) {
+      ++NumErrors;
+      ErrorCategory.Report(
+          "decreasing address between debug_line rows", [&]() {
+            error() << ".debug_line["
+                    << format("0x%08" PRIx64,
+                              *toSectionOffset(Die.find(DW_AT_stmt_list)))
+                    << "] row[" << RowIndex
+                    << "] decreases in address from previous row:\n";
+
+            DWARFDebugLine::Row::dumpTableHeader(OS, 0);
+            if (RowIndex > 0)
+              LineTable->Rows[RowIndex - 1].dump(OS);
+            Row.dump(OS);
+            OS << '\n';
+          });
+    }
+
+    if (!LineTable->hasFileAtIndex(Row.File)) {
+      ++NumErrors;
+      ErrorCategory.Report("Invalid file index in debug_line", [&]() {
+        error() << ".debug_line["
+                << format("0x%08" PRIx64,
+                          *toSectionOffset(Die.find(DW_AT_stmt_list)))
+                << "][" << RowIndex << "] has invalid file index " << Row.File
+                << " (valid values are [" << MinFileIndex << ','
+                << LineTable->Prologue.FileNames.size()
+                << (isDWARF5 ? ")" : "]") << "):\n";
+        DWARFDebugLine::Row::dumpTableHeader(OS, 0);
+        Row.dump(OS);
+        OS << '\n';
+      });
     }
+    if (Row.EndSequence)
+      PrevAddress = 0;
+    else
+      PrevAddress = Row.Address.Address;
+    ++RowIndex;
   }
+  return NumErrors;
 }
 
 DWARFVerifier::DWARFVerifier(raw_ostream &S, DWARFContext &D,
@@ -1095,7 +1113,15 @@ bool DWARFVerifier::handleDebugLine() {
   NumDebugLineErrors = 0;
   OS << "Verifying .debug_line...\n";
   verifyDebugLineStmtOffsets();
-  verifyDebugLineRows();
+  // verifyDebugLineStmtOffsets() parsed every line table, so the rows below
+  // only read them from the context's cache.
+  SmallVector<DWARFUnit *> Units;
+  for (const auto &CU : DCtx.compile_units())
+    Units.push_back(CU.get());
+  NumDebugLineErrors += verifyInParallel(
+      Units.size(), [&](DWARFVerifier &Verifier, size_t Index) {
+        return Verifier.verifyDebugLineRows(*Units[Index]);
+      });
   return NumDebugLineErrors == 0;
 }
 
@@ -1840,20 +1866,30 @@ unsigned DWARFVerifier::verifyDebugNames(const DWARFSection &AccelSection,
   if (NumErrors > 0)
     return NumErrors;
   for (const auto &NI : AccelTable)
-    for (const DWARFDebugNames::NameTableEntry &NTE : NI)
-      NumErrors += verifyNameIndexEntries(NI, NTE);
+    NumErrors += verifyInParallel(
+        NI.getNameCount(), [&](DWARFVerifier &Verifier, size_t Index) {
+          return Verifier.verifyNameIndexEntries(
+              NI, NI.getNameTableEntry(Index + 1));
+        });
 
   if (NumErrors > 0)
     return NumErrors;
 
-  for (const std::unique_ptr<DWARFUnit> &U : DCtx.compile_units()) {
+  SmallVector<std::pair<DWARFCompileUnit *, const DWARFDebugNames::NameIndex *>>
+      IndexedUnits;
+  for (const std::unique_ptr<DWARFUnit> &U : DCtx.compile_units())
     if (const DWARFDebugNames::NameIndex *NI =
-            AccelTable.getCUNameIndex(U->getOffset())) {
-      auto *CU = cast<DWARFCompileUnit>(U.get());
-      for (const DWARFDebugInfoEntry &Die : CU->dies())
-        NumErrors += verifyNameIndexCompleteness(DWARFDie(CU, &Die), *NI);
-    }
-  }
+            AccelTable.getCUNameIndex(U->getOffset()))
+      IndexedUnits.emplace_back(cast<DWARFCompileUnit>(U.get()), NI);
+  NumErrors += verifyInParallel(
+      IndexedUnits.size(), [&](DWARFVerifier &Verifier, size_t Index) {
+        auto [CU, NI] = IndexedUnits[Index];
+        unsigned NumUnitErrors = 0;
+        for (const DWARFDebugInfoEntry &Die : CU->dies())
+          NumUnitErrors +=
+              Verifier.verifyNameIndexCompleteness(DWARFDie(CU, &Die), *NI);
+        return NumUnitErrors;
+      });
   return NumErrors;
 }
 
@@ -1861,18 +1897,28 @@ bool DWARFVerifier::handleAccelTables() {
   const DWARFObject &D = DCtx.getDWARFObj();
   DataExtractor StrData(D.getStrSection(), DCtx.isLittleEndian(), 0);
   unsigned NumErrors = 0;
+
+  // The tables are checked against the DIEs they point to, so extract those
+  // before any thread looks them up.
+  if (shouldVerifyInParallel())
+    for (const auto &U : DCtx.normal_units())
+      U->getNumDIEs();
+
+  SmallVector<std::pair<const DWARFSection *, const char *>, 4> AppleTables;
   if (!D.getAppleNamesSection().Data.empty())
-    NumErrors += verifyAppleAccelTable(&D.getAppleNamesSection(), &StrData,
-                                       ".apple_names");
+    AppleTables.emplace_back(&D.getAppleNamesSection(), ".apple_names");
   if (!D.getAppleTypesSection().Data.empty())
-    NumErrors += verifyAppleAccelTable(&D.getAppleTypesSection(), &StrData,
-                                       ".apple_types");
+    AppleTables.emplace_back(&D.getAppleTypesSection(), ".apple_types");
   if (!D.getAppleNamespacesSection().Data.empty())
-    NumErrors += verifyAppleAccelTable(&D.getAppleNamespacesSection(), &StrData,
-                                       ".apple_namespaces");
+    AppleTables.emplace_back(&D.getAppleNamespacesSection(),
+                             ".apple_namespaces");
   if (!D.getAppleObjCSection().Data.empty())
-    NumErrors += verifyAppleAccelTable(&D.getAppleObjCSection(), &StrData,
-                                       ".apple_objc");
+    AppleTables.emplace_back(&D.getAppleObjCSection(), ".apple_objc");
+  NumErrors += verifyInParallel(
+      AppleTables.size(), [&](DWARFVerifier &Verifier, size_t Index) {
+        auto [Section, Name] = AppleTables[Index];
+        return Verifier.verifyAppleAccelTable(Section, &StrData, Name);
+      });
 
   if (!D.getNamesSection().Data.empty())
     NumErrors += verifyDebugNames(D.getNamesSection(), StrData);
@@ -2028,6 +2074,11 @@ void OutputCategoryAggregator::EnumerateResults(
   }
 }
 
+void OutputCategoryAggregator::Merge(const OutputCategoryAggregator &Other) {
+  for (auto &&[name, count] : Other.Aggregation)
+    Aggregation[name] += count;
+}
+
 void DWARFVerifier::summarize() {
   if (DumpOpts.ShowAggregateErrors && ErrorCategory.GetNumCategories()) {
     error() << "Aggregated error counts:\n";
@@ -2062,6 +2113,50 @@ void DWARFVerifier::summarize() {
   }
 }
 
+bool DWARFVerifier::shouldVerifyInParallel() const {
+  return DCtx.isThreadSafe() && parallel::strategy.compute_thread_count() > 1;
+}
+
+unsigned DWARFVerifier::verifyInParallel(
+    size_t NumItems,
+    function_ref<unsigned(DWARFVerifier &, size_t)> VerifyItem) {
+  unsigned NumErrors = 0;
+  if (NumItems < 2 || !shouldVerifyInParallel()) {
+    for (size_t I = 0; I < NumItems; ++I)
+      NumErrors += VerifyItem(*this, I);
+    return NumErrors;
+  }
+
+  // A few chunks per thread keep the threads busy when some items take much
+  // longer than others, while the number of buffered outputs stays small.
+  size_t NumChunks =
+      std::min<size_t>(NumItems, parallel::strategy.compute_thread_count() * 4);
+  struct ChunkResult {
+    std::string Output;
+    OutputCategoryAggregator Categories;
+    unsigned NumErrors = 0;
+  };
+  std::vector<ChunkResult> Results(NumChunks);
+  parallelFor(0, NumChunks, [&](size_t Chunk) {
+    ChunkResult &Result = Results[Chunk];
+    raw_string_ostream ChunkOS(Result.Output);
+    ChunkOS.enable_colors(OS.has_colors());
+    DWARFVerifier Verifier(ChunkOS, DCtx, DumpOpts);
+    size_t Begin = NumItems * Chunk / NumChunks;
+    size_t End = NumItems * (Chunk + 1) / NumChunks;
+    for (size_t I = Begin; I < End; ++I)
+      Result.NumErrors += VerifyItem(Verifier, I);
+    Result.Categories = std::move(Verifier.ErrorCategory);
+  });
+
+  for (ChunkResult &Result : Results) {
+    OS << Result.Output;
+    ErrorCategory.Merge(Result.Categories);
+    NumErrors += Result.NumErrors;
+  }
+  return NumErrors;
+}
+
 raw_ostream &DWARFVerifier::error() const { return WithColor::error(OS); }
 
 raw_ostream &DWARFVerifier::warn() const { return WithColor::warning(OS); }
@@ -0,0 +1,115 @@
+//===-- GsymContext.cpp ---------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/GSYM/GsymContext.h"
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+
+using namespace llvm;
+using namespace llvm::gsym;
+
+GsymContext::~GsymContext() = default;
+GsymContext::GsymContext(std::unique_ptr<GsymReader> Reader)
+    : DIContext(CK_GSYM), Reader(std::move(Reader)) {}
+
+void GsymContext::dump(raw_ostream &OS, DIDumpOptions DumpOpts) {
+  Reader->dump(OS);
+}
+
+static void fillLineInfoFromLocation(const LookupResult &LR, uint32_t Index,
+                                     DILineInfoSpecifier Specifier,
+                                     DILineInfo &LineInfo) {
+  const SourceLocation &Location = LR.Locations[Index];
+  if (Specifier.FNKind != DINameKind::None && !Location.Name.empty())
+    LineInfo.FunctionName = Location.Name.str();
+
+  std::string FileName;
+  switch (Specifier.FLIKind) {
+  case DILineInfoSpecifier::FileLineInfoKind::None:
+    break;
+  case DILineInfoSpecifier::FileLineInfoKind::BaseNameOnly:
+    FileName = Location.Base.str();
+    break;
+  case DILineInfoSpecifier::FileLineInfoKind::RawValue:
+  case DILineInfoSpecifier::FileLineInfoKind::RelativeFilePath:
+  case DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath:
+    // GSYM only stores the directory and base name of each file.
+    FileName = LR.getSourceFile(Index);
+    break;
+  }
+  if (!FileName.empty())
+    LineInfo.FileName = std::move(FileName);
+  LineInfo.Line = Location.Line;
+}
+
+DILineInfo GsymContext::getLineInfoForAddress(object::SectionedAddress Address,
+                                              DILineInfoSpecifier Specifier) {
+  DILineInfo LineInfo;
+  Expected<LookupResult> LR = Reader->lookup(Address.Address);
+  if (!LR) {
+    consumeError(LR.takeError());
+    return LineInfo;
+  }
+  LineInfo.StartAddress = LR->FuncRange.start();
+  if (LR->Locations.empty()) {
+    // Functions that only came from the symbol table have no line table.
+    if (Specifier.FNKind != DINameKind::None)
+      LineInfo.FunctionName = LR->FuncName.str();
+    return LineInfo;
+  }
+  // The first location is the most deeply inlined one.
+  fillLineInfoFromLocation(*LR, 0, Specifier, LineInfo);
+  return LineInfo;
+}
+
+DILineInfo
+GsymContext::getLineInfoForDataAddress(object::SectionedAddress Address) {
+  // We can't implement this, there's no such information in the GSYM file.
+  return {};
+}
+
+DILineInfoTable
+GsymContext::getLineInfoForAddressRange(object::SectionedAddress Address,
+                                        uint64_t Size,
+                                        DILineInfoSpecifier Specifier) {
+  // This is only used by llvm-rtdyld and the JIT event listeners, which always
+  // have DWARF at hand.
+  return {};
+}
+
+DIInliningInfo
+GsymContext::getInliningInfoForAddress(object::SectionedAddress Address,
+                                       DILineInfoSpecifier Specifier) {
+  DIInliningInfo InlineInfo;
+  Expected<LookupResult> LR = Reader->lookup(Address.Address);
+  if (!LR) {
+    consumeError(LR.takeError());
+    return InlineInfo;
+  }
+  // Locations are ordered from the most deeply inlined function to the
+  // concrete function, which is the order DIInliningInfo expects.
+  for (uint32_t I = 0, E = LR->Locations.size(); I != E; ++I) {
+    DILineInfo LineInfo;
+    fillLineInfoFromLocation(*LR, I, Specifier, LineInfo);
+    InlineInfo.addFrame(LineInfo);
+  }
+  if (InlineInfo.getNumberOfFrames() == 0) {
+    DILineInfo LineInfo;
+    if (Specifier.FNKind != DINameKind::None)
+      LineInfo.FunctionName = LR->FuncName.str();
+    InlineInfo.addFrame(LineInfo);
+  }
+  InlineInfo.getMutableFrame(InlineInfo.getNumberOfFrames() - 1)
+      ->StartAddress = LR->FuncRange.start();
+  return InlineInfo;
+}
+
+std::vector<DILocal>
+GsymContext::getLocalsForAddress(object::SectionedAddress Address) {
+  // We can't implement this, there's no such information in the GSYM file.
+  return {};
+}
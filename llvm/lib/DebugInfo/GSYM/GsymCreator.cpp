@@ -11,6 +11,7 @@
 #include "llvm/DebugInfo/GSYM/LineTable.h"
 #include "llvm/DebugInfo/GSYM/OutputAggregator.h"
 #include "llvm/MC/StringTableBuilder.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include <algorithm>
@@ -168,13 +169,40 @@ llvm::Error GsymCreator::encode(FileWriter &O) const {
   StrTab.write(O.get_stream());
   const off_t StrtabSize = O.tell() - StrtabOffset;
   std::vector<uint32_t> AddrInfoOffsets;
+  AddrInfoOffsets.reserve(Funcs.size());
 
-  // Write out the address infos for each function info.
-  for (const auto &FuncInfo : Funcs) {
-    if (Expected<uint64_t> OffsetOrErr = FuncInfo.encode(O))
-      AddrInfoOffsets.push_back(OffsetOrErr.get());
-    else
-      return OffsetOrErr.takeError();
+  // Write out the address infos for each function info. The encoding of a
+  // function info doesn't depend on where it ends up in the file, so encode
+  // a window of them in parallel and then write them out in order. Only the
+  // encodings of the current window are kept in memory.
+  const size_t NumFuncs = Funcs.size();
+  const size_t WindowSize = 4096;
+  std::vector<SmallString<0>> Encodings(std::min(NumFuncs, WindowSize));
+  std::mutex ErrorMutex;
+  for (size_t Begin = 0; Begin < NumFuncs; Begin += WindowSize) {
+    const size_t End = std::min(Begin + WindowSize, NumFuncs);
+    Error Err = Error::success();
+    parallelFor(Begin, End, [&](size_t Idx) {
+      SmallString<0> &Encoding = Encodings[Idx - Begin];
+      Encoding.clear();
+      raw_svector_ostream OutStrm(Encoding);
+      FileWriter FW(OutStrm, O.getByteOrder());
+      if (Expected<uint64_t> OffsetOrErr = Funcs[Idx].encode(FW);
+          !OffsetOrErr) {
+        std::lock_guard<std::mutex> Lock(ErrorMutex);
+        Err = joinErrors(std::move(Err), OffsetOrErr.takeError());
+      }
+    });
+    if (Err)
+      return Err;
+    for (size_t Idx = Begin; Idx < End; ++Idx) {
+      // FunctionInfo::encode aligns the data to 4 bytes, do the same here.
+      O.alignTo(4);
+      AddrInfoOffsets.push_back(O.tell());
+      const SmallString<0> &Encoding = Encodings[Idx - Begin];
+      O.writeData(ArrayRef<uint8_t>(
+          reinterpret_cast<const uint8_t *>(Encoding.data()), Encoding.size()));
+    }
   }
   // Fixup the string table offset and size in the header
   O.fixup32((uint32_t)StrtabOffset, offsetof(Header, StrtabOffset));
@@ -226,13 +254,14 @@ llvm::Error GsymCreator::finalize(OutputAggregator &Out) {
   // object.
   if (!IsSegment) {
     if (NumBefore > 1) {
-      // Sort function infos so we can emit sorted functions.
-      llvm::sort(Funcs);
-      std::vector<FunctionInfo> FinalizedFuncs;
-      FinalizedFuncs.reserve(Funcs.size());
-      FinalizedFuncs.emplace_back(std::move(Funcs.front()));
+      // Sort function infos so we can emit sorted functions. Large binaries
+      // have millions of them, so sort them using the parallel strategy.
+      llvm::parallelSort(Funcs, std::less<FunctionInfo>());
+      // Unique the function infos in place to avoid keeping a second copy of
+      // all of them alive. LastIdx is the index of the last kept entry.
+      size_t LastIdx = 0;
       for (size_t Idx=1; Idx < NumBefore; ++Idx) {
-        FunctionInfo &Prev = FinalizedFuncs.back();
+        FunctionInfo &Prev = Funcs[LastIdx];
         FunctionInfo &Curr = Funcs[Idx];
         // Empty ranges won't intersect, but we still need to
         // catch the case where we have multiple symbols at the
@@ -271,7 +300,8 @@ llvm::Error GsymCreator::finalize(OutputAggregator &Out) {
                 << Prev << "\n"
                 << Curr << "\n";
             });
-            FinalizedFuncs.emplace_back(std::move(Curr));
+            if (++LastIdx != Idx)
+              Funcs[LastIdx] = std::move(Curr);
           }
         } else {
           if (Prev.Range.size() == 0 && Curr.Range.contains(Prev.Range.start())) {
@@ -280,11 +310,12 @@ llvm::Error GsymCreator::finalize(OutputAggregator &Out) {
             // symbol function info with the current one.
             std::swap(Prev, Curr);
           } else {
-            FinalizedFuncs.emplace_back(std::move(Curr));
+            if (++LastIdx != Idx)
+              Funcs[LastIdx] = std::move(Curr);
           }
         }
       }
-      std::swap(Funcs, FinalizedFuncs);
+      Funcs.erase(Funcs.begin() + LastIdx + 1, Funcs.end());
     }
     // If our last function info entry doesn't have a size and if we have valid
     // text ranges, we should set the size of the last entry since any search for
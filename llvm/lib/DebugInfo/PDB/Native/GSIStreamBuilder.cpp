@@ -185,13 +185,17 @@ void GSIStreamBuilder::finalizeGlobalBuckets(uint32_t RecordZeroOffset) {
   Records.resize(Globals.size());
   uint32_t SymOffset = RecordZeroOffset;
   for (size_t I = 0, E = Globals.size(); I < E; ++I) {
-    StringRef Name = getSymbolName(Globals[I]);
-    Records[I].Name = Name.data();
-    Records[I].NameLen = Name.size();
     Records[I].SymOffset = SymOffset;
     SymOffset += Globals[I].length();
   }
 
+  // Extracting the name requires decoding each record, so do it in parallel.
+  parallelFor(0, Globals.size(), [&](size_t I) {
+    StringRef Name = getSymbolName(Globals[I]);
+    Records[I].Name = Name.data();
+    Records[I].NameLen = Name.size();
+  });
+
   GSH->finalizeBuckets(RecordZeroOffset, Records);
 }
 
@@ -14,6 +14,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/BinaryFormat/COFF.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/GSYM/GsymContext.h"
 #include "llvm/Object/COFF.h"
 #include "llvm/Object/ELFObjectFile.h"
 #include "llvm/Object/ObjectFile.h"
@@ -262,12 +263,13 @@ bool SymbolizableObjectFile::getNameFromSymbolTable(
 
 bool SymbolizableObjectFile::shouldOverrideWithSymbolTable(
     FunctionNameKind FNKind, bool UseSymbolTable) const {
-  // When DWARF is used with -gline-tables-only / -gmlt, the symbol table gives
-  // better answers for linkage names than the DIContext. Otherwise, we are
-  // probably using PEs and PDBs, and we shouldn't do the override. PE files
-  // generally only contain the names of exported symbols.
+  // When DWARF (or GSYM converted from it) is used with -gline-tables-only /
+  // -gmlt, the symbol table gives better answers for linkage names than the
+  // DIContext. Otherwise, we are probably using PEs and PDBs, and we shouldn't
+  // do the override. PE files generally only contain the names of exported
+  // symbols.
   return FNKind == FunctionNameKind::LinkageName && UseSymbolTable &&
-         isa<DWARFContext>(DebugInfoContext.get());
+         isa<DWARFContext, gsym::GsymContext>(DebugInfoContext.get());
 }
 
 DILineInfo
@@ -13,8 +13,15 @@
 #include "llvm/DebugInfo/Symbolize/Symbolize.h"
 
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/DebugInfo/BTF/BTFContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/GSYM/DwarfTransformer.h"
+#include "llvm/DebugInfo/GSYM/GsymContext.h"
+#include "llvm/DebugInfo/GSYM/GsymCreator.h"
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+#include "llvm/DebugInfo/GSYM/ObjectFileTransformer.h"
+#include "llvm/DebugInfo/GSYM/OutputAggregator.h"
 #include "llvm/DebugInfo/PDB/PDB.h"
 #include "llvm/DebugInfo/PDB/PDBContext.h"
 #include "llvm/DebugInfo/Symbolize/SymbolizableObjectFile.h"
@@ -31,6 +38,8 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/xxhash.h"
 #include <algorithm>
 #include <cassert>
 #include <cstring>
@@ -599,6 +608,90 @@ LLVMSymbolizer::createModuleInfo(const ObjectFile *Obj,
   return InsertResult.first->second.get();
 }
 
+// Converts the DWARF in \p Obj into a GSYM file at \p GsymPath. The file is
+// written under a temporary name first, so that concurrent symbolizers see
+// either no file or a complete one.
+static Error createGsymFile(const ObjectFile &Obj, StringRef GsymPath) {
+  auto IgnoreError = [](Error E) { consumeError(std::move(E)); };
+  std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(
+      Obj, DWARFContext::ProcessDebugRelocations::Process, nullptr,
+      /*DWPName=*/"", IgnoreError, IgnoreError, /*ThreadSafe=*/true);
+  if (DICtx->getNumCompileUnits() == 0)
+    return createStringError(errc::invalid_argument, "no DWARF to convert");
+
+  gsym::GsymCreator Gsym(/*Quiet=*/true);
+  gsym::OutputAggregator Out(nullptr);
+  AddressRanges TextRanges;
+  for (const SectionRef &Sect : Obj.sections()) {
+    if (!Sect.isText() || Sect.getSize() == 0)
+      continue;
+    TextRanges.insert(
+        AddressRange(Sect.getAddress(), Sect.getAddress() + Sect.getSize()));
+  }
+  if (!TextRanges.empty())
+    Gsym.SetValidTextRanges(TextRanges);
+
+  gsym::DwarfTransformer DT(*DICtx, Gsym);
+  unsigned NumThreads = hardware_concurrency().compute_thread_count();
+  if (Error Err = DT.convert(NumThreads, Out))
+    return Err;
+  if (Error Err = gsym::ObjectFileTransformer::convert(Obj, Out, Gsym))
+    return Err;
+  if (Error Err = Gsym.finalize(Out))
+    return Err;
+
+  if (std::error_code EC =
+          sys::fs::create_directories(sys::path::parent_path(GsymPath)))
+    return errorCodeToError(EC);
+  SmallString<128> TempPath;
+  if (std::error_code EC =
+          sys::fs::createUniqueFile(GsymPath + "-%%%%%%.tmp", TempPath))
+    return errorCodeToError(EC);
+  llvm::endianness Endian = Obj.isLittleEndian() ? llvm::endianness::little
+                                                 : llvm::endianness::big;
+  Error Err = Gsym.save(TempPath, Endian);
+  if (!Err)
+    Err = errorCodeToError(sys::fs::rename(TempPath, GsymPath));
+  if (Err)
+    sys::fs::remove(TempPath);
+  return Err;
+}
+
+std::unique_ptr<DIContext>
+LLVMSymbolizer::getOrCreateGsymContext(const ObjectFile &Obj) {
+  // Key the cached file on the contents of the object: its build ID if it has
+  // one, or else a hash of the whole file. The architecture is part of the
+  // key because a build ID may be shared by the slices of a universal binary.
+  // An object that changes gets a new key, so an existing file is never
+  // stale and does not need to be checked against the object.
+  std::string Key = Obj.makeTriple().getArchName().str();
+  object::BuildIDRef BuildID = object::getBuildID(&Obj);
+  if (!BuildID.empty()) {
+    Key += ":build-id:" + toHex(BuildID, /*LowerCase=*/true);
+  } else {
+    ArrayRef<uint8_t> Contents = arrayRefFromStringRef(Obj.getData());
+    Key += ":xxh3:" + utohexstr(xxh3_64bits(Contents));
+  }
+  SmallString<128> GsymPath(Opts.GsymCacheDirectory);
+  sys::path::append(GsymPath, sys::path::filename(Obj.getFileName()) + "-" +
+                                  utohexstr(xxh3_64bits(Key)) + ".gsym");
+
+  if (!sys::fs::exists(GsymPath)) {
+    if (Error Err = createGsymFile(Obj, GsymPath)) {
+      consumeError(std::move(Err));
+      return nullptr;
+    }
+  }
+
+  Expected<gsym::GsymReader> ReaderOrErr = gsym::GsymReader::openFile(GsymPath);
+  if (!ReaderOrErr) {
+    consumeError(ReaderOrErr.takeError());
+    return nullptr;
+  }
+  return std::make_unique<gsym::GsymContext>(
+      std::make_unique<gsym::GsymReader>(std::move(*ReaderOrErr)));
+}
+
 Expected<SymbolizableModule *>
 LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
   std::string BinaryName = ModuleName;
@@ -656,10 +749,15 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
       Context.reset(new PDBContext(*CoffObject, std::move(Session)));
     }
   }
-  if (!Context)
-    Context = DWARFContext::create(
+  if (!Context && !Opts.GsymCacheDirectory.empty())
+    Context = getOrCreateGsymContext(*Objects.second);
+  if (!Context) {
+    std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(
         *Objects.second, DWARFContext::ProcessDebugRelocations::Process,
         nullptr, Opts.DWPName);
+    DICtx->setMaxAddressLookupUnitsSize(Opts.MaxDWARFUnitCacheSize);
+    Context = std::move(DICtx);
+  }
   auto ModuleOrErr =
       createModuleInfo(Objects.first, std::move(Context), ModuleName);
   if (ModuleOrErr) {
@@ -35,12 +35,14 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/LockFileManager.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/xxhash.h"
 
 #include <atomic>
+#include <limits>
 #include <optional>
 #include <thread>
 
@@ -116,6 +118,17 @@ std::chrono::milliseconds getDefaultDebuginfodTimeout() {
   return std::chrono::milliseconds(90 * 1000);
 }
 
+unsigned getDefaultDebuginfodMaxConnections() {
+  unsigned MaxConnections;
+  const char *MaxConnectionsEnv = std::getenv("DEBUGINFOD_MAX_CONNECTIONS");
+  if (MaxConnectionsEnv &&
+      to_integer(StringRef(MaxConnectionsEnv).trim(), MaxConnections, 10) &&
+      MaxConnections)
+    return MaxConnections;
+
+  return 8;
+}
+
 /// The following functions fetch a debuginfod artifact to a file in a local
 /// cache and return the cached file path. They first search the local cache,
 /// followed by the debuginfod servers.
@@ -174,23 +187,54 @@ Expected<std::string> getCachedOrDownloadArtifact(StringRef UniqueKey,
                                      getDefaultDebuginfodTimeout());
 }
 
+std::vector<Expected<std::string>>
+getCachedOrDownloadArtifacts(ArrayRef<std::string> UrlPaths) {
+  std::vector<std::optional<Expected<std::string>>> Results(UrlPaths.size());
+  if (!UrlPaths.empty()) {
+    // The work is bound by the network rather than by the CPU, so the number
+    // of threads is not limited to the hardware concurrency.
+    DefaultThreadPool Pool(hardware_concurrency(std::min<size_t>(
+        getDefaultDebuginfodMaxConnections(), UrlPaths.size())));
+    for (size_t I = 0, E = UrlPaths.size(); I != E; ++I)
+      Pool.async([&, I] {
+        Results[I].emplace(getCachedOrDownloadArtifact(
+            getDebuginfodCacheKey(UrlPaths[I]), UrlPaths[I]));
+      });
+    Pool.wait();
+  }
+
+  std::vector<Expected<std::string>> Paths;
+  Paths.reserve(Results.size());
+  for (std::optional<Expected<std::string>> &Result : Results)
+    Paths.push_back(std::move(*Result));
+  return Paths;
+}
+
 namespace {
 
-/// A simple handler which streams the returned data to a cache file. The cache
-/// file is only created if a 200 OK status is observed.
+/// A simple handler which streams the returned data to the partially
+/// downloaded file of an artifact. The file is only written if a 200 OK status
+/// is observed, or a 206 Partial Content status when resuming a download. In
+/// the latter case the data is appended to the file.
 class StreamedHTTPResponseHandler : public HTTPResponseHandler {
-  using CreateStreamFn =
-      std::function<Expected<std::unique_ptr<CachedFileStream>>()>;
-  CreateStreamFn CreateStream;
+  StringRef PartialPath;
+  uint64_t ResumeOffset;
   HTTPClient &Client;
-  std::unique_ptr<CachedFileStream> FileStream;
+  std::unique_ptr<raw_fd_ostream> FileStream;
 
 public:
-  StreamedHTTPResponseHandler(CreateStreamFn CreateStream, HTTPClient &Client)
-      : CreateStream(CreateStream), Client(Client) {}
+  StreamedHTTPResponseHandler(StringRef PartialPath, uint64_t ResumeOffset,
+                              HTTPClient &Client)
+      : PartialPath(PartialPath), ResumeOffset(ResumeOffset), Client(Client) {}
   virtual ~StreamedHTTPResponseHandler() = default;
 
   Error handleBodyChunk(StringRef BodyChunk) override;
+
+  /// Closes the file. Returns an error if it could not be written completely.
+  Error close();
+
+  /// Returns true if any of the response body was written to the file.
+  bool hasWrittenFile() const { return bool(FileStream); }
 };
 
 } // namespace
@@ -198,15 +242,29 @@ public:
 Error StreamedHTTPResponseHandler::handleBodyChunk(StringRef BodyChunk) {
   if (!FileStream) {
     unsigned Code = Client.responseCode();
-    if (Code && Code != 200)
+    bool Resumed = ResumeOffset && Code == 206;
+    if (Code && Code != 200 && !Resumed)
       return Error::success();
-    Expected<std::unique_ptr<CachedFileStream>> FileStreamOrError =
-        CreateStream();
-    if (!FileStreamOrError)
-      return FileStreamOrError.takeError();
-    FileStream = std::move(*FileStreamOrError);
+    // A server that does not support range requests sends the whole artifact,
+    // which replaces the partial file.
+    std::error_code EC;
+    FileStream = std::make_unique<raw_fd_ostream>(
+        PartialPath, EC, Resumed ? sys::fs::OF_Append : sys::fs::OF_None);
+    if (EC)
+      return createFileError(PartialPath, EC);
+  }
+  *FileStream << BodyChunk;
+  return Error::success();
+}
+
+Error StreamedHTTPResponseHandler::close() {
+  if (!FileStream)
+    return Error::success();
+  FileStream->close();
+  if (std::error_code EC = FileStream->error()) {
+    FileStream->clear_error();
+    return createFileError(PartialPath, EC);
   }
-  *FileStream->OS << BodyChunk;
   return Error::success();
 }
 
@@ -254,6 +312,12 @@ Expected<std::string> getCachedOrDownloadArtifact(
   SmallString<64> AbsCachedArtifactPath;
   sys::path::append(AbsCachedArtifactPath, CacheDirectoryPath,
                     "llvmcache-" + UniqueKey);
+  // The lock and partially downloaded files must not start with "llvmcache-",
+  // or pruneCache would treat them as cache entries and delete them while a
+  // download is in progress.
+  SmallString<64> AbsDownloadPath;
+  sys::path::append(AbsDownloadPath, CacheDirectoryPath,
+                    "debuginfod-download-" + UniqueKey);
 
   Expected<FileCache> CacheOrErr =
       localCache("Debuginfod-client", ".debuginfod-client", CacheDirectoryPath);
@@ -282,6 +346,52 @@ Expected<std::string> getCachedOrDownloadArtifact(
         "allow Debuginfod to make HTTP requests, call HTTPClient::initialize() "
         "at the beginning of main.");
 
+  if (DebuginfodUrls.empty())
+    return createStringError(errc::argument_out_of_domain,
+                             "build id not found");
+
+  if (std::error_code EC = sys::fs::create_directories(CacheDirectoryPath))
+    return createFileError(CacheDirectoryPath, EC);
+
+  // Only one thread or process that shares the cache directory downloads an
+  // artifact at a time; the others wait for it and use the cached file. The
+  // owner of the lock may also resume the partial download of an earlier
+  // attempt. Without the lock, download to a file of our own instead.
+  unsigned MaxWaitSeconds =
+      Timeout > std::chrono::milliseconds::zero()
+          ? std::chrono::ceil<std::chrono::seconds>(Timeout).count()
+          : std::numeric_limits<unsigned>::max();
+  std::optional<LockFileManager> Locker;
+  bool CanResume = false;
+  while (true) {
+    Locker.emplace(AbsDownloadPath);
+    if (*Locker == LockFileManager::LFS_Owned) {
+      CanResume = true;
+      break;
+    }
+    if (*Locker == LockFileManager::LFS_Error)
+      break;
+    LockFileManager::WaitForUnlockResult WaitResult =
+        Locker->waitForUnlock(MaxWaitSeconds);
+    if (WaitResult == LockFileManager::Res_Timeout)
+      break;
+    // Otherwise the owner either stored the artifact or gave up, in which case
+    // we try to take over.
+    if (WaitResult == LockFileManager::Res_Success &&
+        sys::fs::exists(AbsCachedArtifactPath))
+      return std::string(AbsCachedArtifactPath);
+  }
+
+  // Another owner may have stored the artifact since the cache lookup.
+  if (CanResume && sys::fs::exists(AbsCachedArtifactPath))
+    return std::string(AbsCachedArtifactPath);
+
+  SmallString<64> PartialPath(AbsDownloadPath);
+  PartialPath += CanResume ? ".partial" : ".partial-%%%%%%%%";
+  if (!CanResume)
+    sys::fs::createUniquePath(PartialPath, PartialPath, /*MakeAbsolute=*/false);
+  FileRemover PartialRemover(PartialPath, /*deleteIt=*/!CanResume);
+
   HTTPClient Client;
   Client.setTimeout(Timeout);
   for (StringRef ServerUrl : DebuginfodUrls) {
@@ -289,20 +399,46 @@ Expected<std::string> getCachedOrDownloadArtifact(
     sys::path::append(ArtifactUrl, sys::path::Style::posix, ServerUrl, UrlPath);
 
     // Perform the HTTP request and if successful, write the response body to
-    // the cache.
-    {
-      StreamedHTTPResponseHandler Handler(
-          [&]() { return CacheAddStream(Task, ""); }, Client);
-      HTTPRequest Request(ArtifactUrl);
-      Request.Headers = getHeaders();
-      Error Err = Client.perform(Request, Handler);
-      if (Err)
-        return std::move(Err);
-
-      unsigned Code = Client.responseCode();
-      if (Code && Code != 200)
-        continue;
+    // the partial file. Continue an earlier download with a range request.
+    uint64_t ResumeOffset = 0;
+    if (CanResume && sys::fs::file_size(PartialPath, ResumeOffset))
+      ResumeOffset = 0;
+    HTTPRequest Request(ArtifactUrl);
+    Request.Headers = getHeaders();
+    if (ResumeOffset) {
+      Request.Headers.push_back(
+          ("Range: bytes=" + Twine(ResumeOffset) + "-").str());
+      // Range offsets refer to the encoded response body, so make sure that
+      // it is the artifact itself.
+      Request.Headers.push_back("Accept-Encoding: identity");
     }
+    StreamedHTTPResponseHandler Handler(PartialPath, ResumeOffset, Client);
+    if (Error Err = Client.perform(Request, Handler))
+      return joinErrors(std::move(Err), Handler.close());
+    if (Error Err = Handler.close())
+      return std::move(Err);
+
+    unsigned Code = Client.responseCode();
+    // The range is not satisfiable if the partial file does not belong to the
+    // artifact. Drop it, so that the next attempt starts over.
+    if (Code == 416)
+      sys::fs::remove(PartialPath);
+    if (Code && Code != 200 && !(Code == 206 && ResumeOffset))
+      continue;
+
+    // The handler only creates the file when it receives part of the body, so
+    // store an empty artifact if the body was empty. This also replaces a
+    // stale partial file.
+    if (!Handler.hasWrittenFile() && !(Code == 206 && ResumeOffset)) {
+      std::error_code EC;
+      raw_fd_ostream EmptyFile(PartialPath, EC);
+      if (EC)
+        return createFileError(PartialPath, EC);
+    }
+
+    // Publish the artifact in the cache in a single step.
+    if (std::error_code EC = sys::fs::rename(PartialPath, AbsCachedArtifactPath))
+      return createFileError(AbsCachedArtifactPath, EC);
 
     Expected<CachePruningPolicy> PruningPolicyOrErr =
         parseCachePruningPolicy(std::getenv("DEBUGINFOD_CACHE_POLICY"));
@@ -0,0 +1,84 @@
+//===-- llvm/Debuginfod/HTTPCacheStore.cpp - HTTP cache store ---*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file implements HTTPCacheStore on top of HTTPClient.
+///
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Debuginfod/HTTPCacheStore.h"
+#include "llvm/Debuginfod/HTTPClient.h"
+#include "llvm/Support/Errc.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+using namespace llvm;
+
+namespace {
+
+// Collects the body of a successful response.
+class BufferedHTTPResponseHandler : public HTTPResponseHandler {
+  HTTPClient &Client;
+
+public:
+  SmallString<0> Body;
+
+  BufferedHTTPResponseHandler(HTTPClient &Client) : Client(Client) {}
+  virtual ~BufferedHTTPResponseHandler() = default;
+
+  Error handleBodyChunk(StringRef BodyChunk) override {
+    // Drop the body of error responses, such as a 404 page.
+    unsigned Code = Client.responseCode();
+    if (Code && Code != 200)
+      return Error::success();
+    Body += BodyChunk;
+    return Error::success();
+  }
+};
+
+} // namespace
+
+Expected<std::unique_ptr<MemoryBuffer>> HTTPCacheStore::fetch(StringRef Key) {
+  if (!HTTPClient::isAvailable())
+    return nullptr;
+  // Curl handles must not be shared between threads, so use one per request.
+  HTTPClient Client;
+  Client.setTimeout(Timeout);
+  HTTPRequest Request((BaseUrl + "/" + Key).str());
+  BufferedHTTPResponseHandler Handler(Client);
+  if (Error Err = Client.perform(Request, Handler))
+    return std::move(Err);
+
+  unsigned Code = Client.responseCode();
+  if (Code == 404)
+    return nullptr;
+  if (Code != 200)
+    return createStringError(errc::io_error,
+                             "cache server returned HTTP status %u for %s",
+                             Code, Request.Url.c_str());
+  return MemoryBuffer::getMemBufferCopy(Handler.Body, Key);
+}
+
+Error HTTPCacheStore::upload(StringRef Key, MemoryBufferRef Data) {
+  if (!HTTPClient::isAvailable())
+    return Error::success();
+  HTTPClient Client;
+  Client.setTimeout(Timeout);
+  HTTPRequest Request((BaseUrl + "/" + Key).str());
+  Request.Method = HTTPMethod::PUT;
+  Request.Body = Data.getBuffer();
+  BufferedHTTPResponseHandler Handler(Client);
+  if (Error Err = Client.perform(Request, Handler))
+    return Err;
+
+  unsigned Code = Client.responseCode();
+  if (Code < 200 || Code >= 300)
+    return createStringError(errc::io_error,
+                             "cache server returned HTTP status %u for %s",
+                             Code, Request.Url.c_str());
+  return Error::success();
+}
@@ -28,7 +28,7 @@ HTTPRequest::HTTPRequest(StringRef Url) { this->Url = Url.str(); }
 
 bool operator==(const HTTPRequest &A, const HTTPRequest &B) {
   return A.Url == B.Url && A.Method == B.Method &&
-         A.FollowRedirects == B.FollowRedirects;
+         A.FollowRedirects == B.FollowRedirects && A.Body == B.Body;
 }
 
 HTTPResponseHandler::~HTTPResponseHandler() = default;
@@ -105,9 +105,16 @@ HTTPClient::~HTTPClient() { curl_easy_cleanup(Curl); }
 
 Error HTTPClient::perform(const HTTPRequest &Request,
                           HTTPResponseHandler &Handler) {
-  if (Request.Method != HTTPMethod::GET)
-    return createStringError(errc::invalid_argument,
-                             "Unsupported CURL request method.");
+  // The handle is reused, so reset the method of a previous request.
+  if (Request.Method == HTTPMethod::PUT) {
+    curl_easy_setopt(Curl, CURLOPT_CUSTOMREQUEST, "PUT");
+    curl_easy_setopt(Curl, CURLOPT_POSTFIELDS, Request.Body.data());
+    curl_easy_setopt(Curl, CURLOPT_POSTFIELDSIZE_LARGE,
+                     static_cast<curl_off_t>(Request.Body.size()));
+  } else {
+    curl_easy_setopt(Curl, CURLOPT_CUSTOMREQUEST, nullptr);
+    curl_easy_setopt(Curl, CURLOPT_HTTPGET, 1L);
+  }
 
   SmallString<128> Url = Request.Url;
   curl_easy_setopt(Curl, CURLOPT_URL, Url.c_str());
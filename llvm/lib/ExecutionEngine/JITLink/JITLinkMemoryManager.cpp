@@ -300,15 +300,37 @@ public:
 
 private:
   Error applyProtections() {
+    // Adjacent segments with the same protections are protected, and flushed
+    // from the instruction cache, together.
+    struct ProtectionRun {
+      char *Start, *End;
+      orc::MemProt Prot;
+    };
+    SmallVector<ProtectionRun, 4> Runs;
     for (auto &KV : BL.segments()) {
       const auto &AG = KV.first;
       auto &Seg = KV.second;
 
-      auto Prot = toSysMemoryProtectionFlags(AG.getMemProt());
-
       uint64_t SegSize =
           alignTo(Seg.ContentSize + Seg.ZeroFillSize, MemMgr.PageSize);
-      sys::MemoryBlock MB(Seg.WorkingMem, SegSize);
+      if (SegSize == 0)
+        continue;
+      if (!Runs.empty() && Runs.back().End == Seg.WorkingMem &&
+          Runs.back().Prot == AG.getMemProt())
+        Runs.back().End += SegSize;
+      else
+        Runs.push_back({Seg.WorkingMem, Seg.WorkingMem + SegSize,
+                        AG.getMemProt()});
+    }
+
+    for (auto &Run : Runs) {
+      // The slab was allocated read/write, so there is nothing to do for
+      // read/write runs.
+      if (Run.Prot == (orc::MemProt::Read | orc::MemProt::Write))
+        continue;
+
+      auto Prot = toSysMemoryProtectionFlags(Run.Prot);
+      sys::MemoryBlock MB(Run.Start, Run.End - Run.Start);
       if (auto EC = sys::Memory::protectMappedMemory(MB, Prot))
         return errorCodeToError(EC);
       if (Prot & sys::Memory::MF_EXEC)
@@ -9,6 +9,8 @@
 #include "llvm/ExecutionEngine/Orc/CompileUtils.h"
 
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
@@ -18,6 +20,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
+#include "llvm/Support/raw_sha1_ostream.h"
 #include "llvm/Target/TargetMachine.h"
 
 #include <algorithm>
@@ -92,5 +95,138 @@ ConcurrentIRCompiler::operator()(Module &M) {
   return C(M);
 }
 
+Expected<std::unique_ptr<CachingIRCompiler>>
+CachingIRCompiler::Create(std::unique_ptr<IRCompileLayer::IRCompiler> BaseCompiler,
+                          const JITTargetMachineBuilder &JTMB,
+                          StringRef CacheDir, CachePruningPolicy Policy) {
+  std::unique_ptr<CachingIRCompiler> C(new CachingIRCompiler(
+      std::move(BaseCompiler), JTMB, CacheDir, std::move(Policy)));
+  CachingIRCompiler *Self = C.get();
+  auto Cache = localCache(
+      "ORC object cache", "orc-object", CacheDir,
+      [Self](unsigned Task, const Twine &ModuleName,
+             std::unique_ptr<MemoryBuffer> Obj) {
+        Self->addBuffer(Task, std::move(Obj));
+      });
+  if (!Cache)
+    return Cache.takeError();
+  C->Cache = std::move(*Cache);
+  return std::move(C);
+}
+
+CachingIRCompiler::CachingIRCompiler(
+    std::unique_ptr<IRCompileLayer::IRCompiler> BaseCompiler,
+    const JITTargetMachineBuilder &JTMB, StringRef CacheDir,
+    CachePruningPolicy Policy)
+    : IRCompiler(BaseCompiler->getManglingOptions()),
+      BaseCompiler(std::move(BaseCompiler)), CacheDir(CacheDir.str()),
+      Policy(std::move(Policy)), PrefetchPool(hardware_concurrency(1)) {
+  // Objects from other LLVM versions, or for other targets, must not be used.
+  raw_string_ostream OS(TargetKey);
+  OS << LLVM_VERSION_STRING << '\0' << JTMB.getTargetTriple().str() << '\0'
+     << JTMB.getCPU() << '\0' << JTMB.getFeatures().getString() << '\0'
+     << static_cast<int>(JTMB.getCodeGenOptLevel()) << '\0';
+  if (const auto &RM = JTMB.getRelocationModel())
+    OS << static_cast<int>(*RM);
+  OS << '\0';
+  if (const auto &CM = JTMB.getCodeModel())
+    OS << static_cast<int>(*CM);
+  OS << '\0';
+}
+
+std::string CachingIRCompiler::getCacheKey(const Module &M) const {
+  raw_sha1_ostream Hasher;
+  Hasher << TargetKey;
+  M.print(Hasher, nullptr);
+  return toHex(Hasher.sha1());
+}
+
+Expected<std::unique_ptr<MemoryBuffer>>
+CachingIRCompiler::operator()(Module &M) {
+  std::string Key = getCacheKey(M);
+  if (std::unique_ptr<MemoryBuffer> Obj = takePrefetchedObject(Key))
+    return std::move(Obj);
+
+  unsigned Task = NextTask++;
+  auto AddStream = Cache(Task, Key, M.getModuleIdentifier());
+  if (!AddStream)
+    return AddStream.takeError();
+  if (!*AddStream)
+    return takeBuffer(Task);
+
+  auto Obj = (*BaseCompiler)(M);
+  if (!Obj)
+    return Obj.takeError();
+
+  {
+    auto Stream = (*AddStream)(Task, M.getModuleIdentifier());
+    if (!Stream)
+      return Stream.takeError();
+    *(*Stream)->OS << (*Obj)->getBuffer();
+  }
+  // Committing the entry handed a copy of it back, which isn't needed.
+  takeBuffer(Task);
+  pruneCache(CacheDir, Policy);
+  return Obj;
+}
+
+void CachingIRCompiler::prefetch(const Module &M) {
+  std::string Key = getCacheKey(M);
+  std::lock_guard<std::mutex> Lock(BuffersMutex);
+  if (Prefetches.count(Key))
+    return;
+  Prefetches[Key] = PrefetchPool.async([this, Key] {
+    unsigned Task = NextTask++;
+    auto AddStream = Cache(Task, Key, "");
+    // Errors and misses are left to the compile.
+    if (!AddStream) {
+      consumeError(AddStream.takeError());
+      return;
+    }
+    if (*AddStream)
+      return;
+    std::unique_ptr<MemoryBuffer> Obj = takeBuffer(Task);
+    std::lock_guard<std::mutex> Lock(BuffersMutex);
+    PrefetchedObjects[Key] = std::move(Obj);
+  });
+}
+
+void CachingIRCompiler::addBuffer(unsigned Task,
+                                  std::unique_ptr<MemoryBuffer> Obj) {
+  std::lock_guard<std::mutex> Lock(BuffersMutex);
+  Buffers[Task] = std::move(Obj);
+}
+
+std::unique_ptr<MemoryBuffer> CachingIRCompiler::takeBuffer(unsigned Task) {
+  std::lock_guard<std::mutex> Lock(BuffersMutex);
+  auto I = Buffers.find(Task);
+  if (I == Buffers.end())
+    return nullptr;
+  std::unique_ptr<MemoryBuffer> Obj = std::move(I->second);
+  Buffers.erase(I);
+  return Obj;
+}
+
+std::unique_ptr<MemoryBuffer>
+CachingIRCompiler::takePrefetchedObject(StringRef Key) {
+  std::shared_future<void> Prefetch;
+  {
+    std::lock_guard<std::mutex> Lock(BuffersMutex);
+    auto I = Prefetches.find(Key);
+    if (I == Prefetches.end())
+      return nullptr;
+    Prefetch = I->second;
+  }
+  Prefetch.wait();
+  std::lock_guard<std::mutex> Lock(BuffersMutex);
+  Prefetches.erase(Key);
+  auto I = PrefetchedObjects.find(Key);
+  if (I == PrefetchedObjects.end())
+    return nullptr;
+  std::unique_ptr<MemoryBuffer> Obj = std::move(I->second);
+  PrefetchedObjects.erase(I);
+  return Obj;
+}
+
 } // end namespace orc
 } // end namespace llvm
@@ -897,6 +897,9 @@ Error LLJIT::addIRModule(ResourceTrackerSP RT, ThreadSafeModule TSM) {
           TSM.withModuleDo([&](Module &M) { return applyDataLayout(M); }))
     return Err;
 
+  if (PrefetchingCompiler)
+    TSM.withModuleDo([&](Module &M) { PrefetchingCompiler->prefetch(M); });
+
   return InitHelperTransformLayer->add(std::move(RT), std::move(TSM));
 }
 
@@ -1003,7 +1006,16 @@ LLJIT::LLJIT(LLJITBuilderState &S, Error &Err)
       std::make_unique<ObjectTransformLayer>(*ES, *ObjLinkingLayer);
 
   {
-    auto CompileFunction = createCompileFunction(S, std::move(*S.JTMB));
+    auto CompileFunction = createCompileFunction(S, *S.JTMB);
+    // If there is an object cache directory then look modules up there before
+    // compiling them.
+    if (CompileFunction && !S.ObjectCacheDirectory.empty()) {
+      auto CachingCompiler = CachingIRCompiler::Create(
+          std::move(*CompileFunction), *S.JTMB, S.ObjectCacheDirectory);
+      if (CachingCompiler && S.PrefetchCachedObjects)
+        PrefetchingCompiler = CachingCompiler->get();
+      CompileFunction = std::move(CachingCompiler);
+    }
     if (!CompileFunction) {
       Err = CompileFunction.takeError();
       return;
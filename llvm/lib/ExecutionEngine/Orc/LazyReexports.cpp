@@ -76,6 +76,9 @@ void LazyCallThroughManager::resolveTrampolineLandingAddress(
   if (!Entry)
     return NotifyLandingResolved(reportCallThroughError(Entry.takeError()));
 
+  if (NotifyCallThrough)
+    NotifyCallThrough(*Entry->SourceJD, Entry->SymbolName);
+
   // Declaring SLS and the callback outside of the call to ES.lookup is a
   // workaround to fix build failures on AIX and on z/OS platforms.
   SymbolLookupSet SLS({Entry->SymbolName});
@@ -138,7 +138,15 @@ void MapperJITLinkMemoryManager::allocate(const JITLinkDylib *JD, LinkGraph &G,
 
   if (SelectedRange.empty()) { // no already reserved range was found
     auto TotalAllocation = alignTo(TotalSize, ReservationUnits);
-    Mapper->reserve(TotalAllocation, std::move(CompleteAllocation));
+    Mapper->reserve(TotalAllocation,
+                    [this, CompleteAllocation = std::move(CompleteAllocation)](
+                        Expected<ExecutorAddrRange> Result) mutable {
+                      // Mutex is still held here, CompleteAllocation
+                      // releases it.
+                      if (Result)
+                        Reservations[Result->Start] = Result->size();
+                      CompleteAllocation(std::move(Result));
+                    });
   } else {
     CompleteAllocation(SelectedRange);
   }
@@ -185,5 +193,30 @@ void MapperJITLinkMemoryManager::deallocate(
   });
 }
 
+std::vector<MapperJITLinkMemoryManager::SlabInfo>
+MapperJITLinkMemoryManager::getSlabInfos() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  std::vector<SlabInfo> Infos;
+  Infos.reserve(Reservations.size());
+  for (auto &[Start, Size] : Reservations) {
+    SlabInfo Info;
+    Info.Range = ExecutorAddrRange(Start, Size);
+    Infos.push_back(Info);
+  }
+
+  for (auto &[Addr, Size] : UsedMemory) {
+    // Find the reservation that contains this allocation.
+    auto It = llvm::partition_point(
+        Infos, [&](const SlabInfo &Info) { return Info.Range.Start <= Addr; });
+    assert(It != Infos.begin() && "Allocation outside of reservations");
+    auto &Info = *std::prev(It);
+    Info.UsedBytes += Size;
+    ++Info.NumAllocations;
+  }
+
+  return Infos;
+}
+
 } // end namespace orc
 } // end namespace llvm
@@ -68,6 +68,14 @@ void InProcessMemoryMapper::initialize(MemoryMapper::AllocInfo &AI,
   ExecutorAddr MinAddr(~0ULL);
   ExecutorAddr MaxAddr(0);
 
+  // Adjacent segments with the same protections are protected, and flushed
+  // from the instruction cache, together.
+  struct ProtectionRun {
+    ExecutorAddr Start, End;
+    MemProt Prot;
+  };
+  SmallVector<ProtectionRun, 4> Runs;
+
   // FIXME: Release finalize lifetime segments.
   for (auto &Segment : AI.Segments) {
     auto Base = AI.MappingBase + Segment.Offset;
@@ -82,13 +90,31 @@ void InProcessMemoryMapper::initialize(MemoryMapper::AllocInfo &AI,
     std::memset((Base + Segment.ContentSize).toPtr<void *>(), 0,
                 Segment.ZeroFillSize);
 
+    if (Size == 0)
+      continue;
+
+    // Segments are page aligned, so the runs can be too.
+    auto End = Base + alignTo(Size, PageSize);
+    auto Prot = Segment.AG.getMemProt();
+    if (!Runs.empty() && Runs.back().End == Base && Runs.back().Prot == Prot)
+      Runs.back().End = End;
+    else
+      Runs.push_back({Base, End, Prot});
+  }
+
+  for (auto &Run : Runs) {
+    // Reserved memory starts out read/write, and deinitialize resets it to
+    // read/write, so there is nothing to do for read/write runs.
+    if (Run.Prot == (MemProt::Read | MemProt::Write))
+      continue;
+
+    sys::MemoryBlock MB(Run.Start.toPtr<void *>(), Run.End - Run.Start);
     if (auto EC = sys::Memory::protectMappedMemory(
-            {Base.toPtr<void *>(), Size},
-            toSysMemoryProtectionFlags(Segment.AG.getMemProt()))) {
+            MB, toSysMemoryProtectionFlags(Run.Prot))) {
       return OnInitialized(errorCodeToError(EC));
     }
-    if ((Segment.AG.getMemProt() & MemProt::Exec) == MemProt::Exec)
-      sys::Memory::InvalidateInstructionCache(Base.toPtr<void *>(), Size);
+    if ((Run.Prot & MemProt::Exec) == MemProt::Exec)
+      sys::Memory::InvalidateInstructionCache(MB.base(), MB.allocatedSize());
   }
 
   auto DeinitializeActions = shared::runFinalizeActions(AI.Actions);
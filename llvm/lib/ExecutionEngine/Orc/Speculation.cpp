@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ExecutionEngine/Orc/Speculation.h"
+#include "llvm/ExecutionEngine/Orc/LazyReexports.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/IRBuilder.h"
@@ -16,6 +17,8 @@
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
 
 namespace llvm {
 
@@ -138,5 +141,126 @@ void IRSpeculationLayer::emit(std::unique_ptr<MaterializationResponsibility> R,
   NextLayer.emit(std::move(R), std::move(TSM));
 }
 
+Error writeLazyCallTrace(const LazyCallTrace &Trace, StringRef Path) {
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::OF_TextWithCRLF);
+  if (EC)
+    return createFileError(Path, EC);
+  for (auto &[JDName, SymName] : Trace)
+    OS << JDName << '\t' << SymName << '\n';
+  OS.close();
+  if (OS.has_error())
+    return createFileError(Path, OS.error());
+  return Error::success();
+}
+
+Expected<LazyCallTrace> readLazyCallTrace(StringRef Path) {
+  auto Buffer = MemoryBuffer::getFile(Path, /*IsText=*/true);
+  if (!Buffer)
+    return createFileError(Path, Buffer.getError());
+
+  LazyCallTrace Trace;
+  SmallVector<StringRef> Lines;
+  (*Buffer)->getBuffer().split(Lines, '\n', -1, /*KeepEmpty=*/false);
+  for (auto [LineNo, Line] : enumerate(Lines)) {
+    auto [JDName, SymName] = Line.split('\t');
+    if (JDName.empty() || SymName.empty())
+      return createFileError(
+          Path, make_error<StringError>("malformed lazy call trace entry at "
+                                        "line " +
+                                            Twine(LineNo + 1),
+                                        inconvertibleErrorCode()));
+    Trace.push_back({JDName.str(), SymName.str()});
+  }
+  return std::move(Trace);
+}
+
+LazyCallTraceRecorder::LazyCallTraceRecorder(LazyCallThroughManager &LCTM) {
+  LCTM.setNotifyCallThrough(
+      [this](JITDylib &JD, const SymbolStringPtr &Name) { record(JD, Name); });
+}
+
+LazyCallTrace LazyCallTraceRecorder::getTrace() {
+  std::lock_guard<std::mutex> Lock(TraceMutex);
+  return Trace;
+}
+
+void LazyCallTraceRecorder::record(JITDylib &JD, const SymbolStringPtr &Name) {
+  std::lock_guard<std::mutex> Lock(TraceMutex);
+  // Trampolines may be re-entered before their stubs are updated, so only
+  // keep the first call of each symbol.
+  if (Seen.insert({&JD, Name}).second)
+    Trace.push_back({JD.getName(), (*Name).str()});
+}
+
+class TraceSpeculator::SpeculationTask : public IdleTask {
+public:
+  SpeculationTask(std::shared_ptr<State> S) : S(std::move(S)) {}
+  void printDescription(raw_ostream &OS) override {
+    OS << "Trace speculation from entry " << S->Next;
+  }
+  void run() override { speculateFrom(std::move(S)); }
+
+private:
+  std::shared_ptr<State> S;
+};
+
+TraceSpeculator::TraceSpeculator(ExecutionSession &ES, LazyCallTrace Trace,
+                                 size_t MaxInFlight)
+    : S(std::make_shared<State>(ES, std::move(Trace))),
+      MaxInFlight(MaxInFlight) {
+  assert(MaxInFlight && "MaxInFlight must be non-zero");
+}
+
+Expected<std::unique_ptr<TraceSpeculator>>
+TraceSpeculator::Create(ExecutionSession &ES, StringRef Path,
+                        size_t MaxInFlight) {
+  auto Trace = readLazyCallTrace(Path);
+  if (!Trace)
+    return Trace.takeError();
+  return std::make_unique<TraceSpeculator>(ES, std::move(*Trace), MaxInFlight);
+}
+
+void TraceSpeculator::start() {
+  for (size_t I = 0; I != MaxInFlight; ++I)
+    S->ES.dispatchTask(std::make_unique<SpeculationTask>(S));
+}
+
+void TraceSpeculator::speculateFrom(std::shared_ptr<State> S) {
+  while (!S->Stopped) {
+    size_t I = S->Next++;
+    if (I >= S->Trace.size())
+      return;
+
+    auto &[JDName, SymName] = S->Trace[I];
+    auto *JD = S->ES.getJITDylibByName(JDName);
+    if (!JD) {
+      ++S->NumSpeculated;
+      continue;
+    }
+
+    // Whichever of the lookup call and its completion callback finishes
+    // second moves on to the next entry: this thread if the symbol was
+    // already compiled, otherwise a new task.
+    auto Handoff = std::make_shared<std::atomic<bool>>(false);
+    S->ES.lookup(
+        LookupKind::Static,
+        makeJITDylibSearchOrder(JD, JITDylibLookupFlags::MatchAllSymbols),
+        SymbolLookupSet(S->ES.intern(SymName),
+                        SymbolLookupFlags::WeaklyReferencedSymbol),
+        SymbolState::Ready,
+        [S, Handoff](Expected<SymbolMap> Result) {
+          if (!Result)
+            S->ES.reportError(Result.takeError());
+          ++S->NumSpeculated;
+          if (Handoff->exchange(true))
+            S->ES.dispatchTask(std::make_unique<SpeculationTask>(S));
+        },
+        NoDependenciesToRegister);
+    if (!Handoff->exchange(true))
+      return;
+  }
+}
+
 } // namespace orc
 } // namespace llvm
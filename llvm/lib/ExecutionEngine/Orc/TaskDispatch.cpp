@@ -15,6 +15,7 @@ namespace orc {
 char Task::ID = 0;
 char GenericNamedTask::ID = 0;
 const char *GenericNamedTask::DefaultDescription = "Generic Task";
+char IdleTask::ID = 0;
 
 void Task::anchor() {}
 TaskDispatcher::~TaskDispatcher() = default;
@@ -79,6 +80,172 @@ void DynamicThreadPoolTaskDispatcher::shutdown() {
   Running = false;
   OutstandingCV.wait(Lock, [this]() { return Outstanding == 0; });
 }
+
+namespace {
+// The dispatcher and queue of the worker running on this thread, if any.
+thread_local WorkStealingTaskDispatcher *CurrentDispatcher = nullptr;
+thread_local size_t CurrentQueue = 0;
+} // namespace
+
+static void updateMax(std::atomic<uint64_t> &Max, uint64_t Value) {
+  uint64_t Current = Max.load(std::memory_order_relaxed);
+  while (Current < Value &&
+         !Max.compare_exchange_weak(Current, Value, std::memory_order_relaxed))
+    ;
+}
+
+WorkStealingTaskDispatcher::WorkStealingTaskDispatcher(
+    size_t NumThreads, GetPriorityFunction GetPriority)
+    : GetPriority(std::move(GetPriority)) {
+  assert(NumThreads && "WorkStealingTaskDispatcher needs at least one thread");
+  for (size_t I = 0; I != NumThreads; ++I)
+    Queues.push_back(std::make_unique<WorkerQueue>());
+  for (size_t I = 0; I != NumThreads; ++I)
+    Workers.emplace_back([this, I]() { runWorker(I); });
+}
+
+WorkStealingTaskDispatcher::~WorkStealingTaskDispatcher() { shutdown(); }
+
+WorkStealingTaskDispatcher::Priority
+WorkStealingTaskDispatcher::getDefaultPriority(Task &T) {
+  if (isa<MaterializationTask>(T))
+    return Priority::Normal;
+  if (isa<IdleTask>(T))
+    return Priority::Low;
+  // Other tasks, e.g. lookup continuations, resume work that is already
+  // underway and that lookups may be blocked on.
+  return Priority::High;
+}
+
+void WorkStealingTaskDispatcher::dispatch(std::unique_ptr<Task> T) {
+  // Once the workers are gone, run any straggling tasks in place.
+  if (!Running) {
+    T->run();
+    return;
+  }
+
+  unsigned P = static_cast<unsigned>(GetPriority ? GetPriority(*T)
+                                                 : getDefaultPriority(*T));
+  // Keep work dispatched by a task on the same worker, and spread other work
+  // round-robin.
+  size_t Index = CurrentDispatcher == this
+                     ? CurrentQueue
+                     : NextQueue.fetch_add(1, std::memory_order_relaxed) %
+                           Queues.size();
+
+  ++Outstanding;
+  ++NumDispatched;
+  updateMax(MaxQueueDepth, ++QueueDepth);
+  {
+    std::lock_guard<std::mutex> Lock(Queues[Index]->Mutex);
+    Queues[Index]->Tasks[P].push_back(
+        {std::move(T), std::chrono::steady_clock::now()});
+    ++NumQueued[P];
+  }
+
+  if (NumSleeping) {
+    std::lock_guard<std::mutex> Lock(SleepMutex);
+    WorkAvailableCV.notify_one();
+  }
+}
+
+bool WorkStealingTaskDispatcher::takeTask(size_t Index, QueuedTask &QT) {
+  for (unsigned P = 0; P != NumPriorities; ++P) {
+    if (!NumQueued[P])
+      continue;
+    // Take the most recently queued task from our own queue, as its data is
+    // most likely still in the cache...
+    {
+      WorkerQueue &Q = *Queues[Index];
+      std::lock_guard<std::mutex> Lock(Q.Mutex);
+      if (!Q.Tasks[P].empty()) {
+        QT = std::move(Q.Tasks[P].back());
+        Q.Tasks[P].pop_back();
+        --NumQueued[P];
+        return true;
+      }
+    }
+    // ...otherwise steal the oldest task from another worker.
+    for (size_t I = 1, E = Queues.size(); I != E; ++I) {
+      WorkerQueue &Q = *Queues[(Index + I) % E];
+      std::lock_guard<std::mutex> Lock(Q.Mutex);
+      if (!Q.Tasks[P].empty()) {
+        QT = std::move(Q.Tasks[P].front());
+        Q.Tasks[P].pop_front();
+        --NumQueued[P];
+        ++NumStolen;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void WorkStealingTaskDispatcher::runWorker(size_t Index) {
+  CurrentDispatcher = this;
+  CurrentQueue = Index;
+
+  while (true) {
+    QueuedTask QT;
+    if (takeTask(Index, QT)) {
+      --QueueDepth;
+      uint64_t LatencyNs =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - QT.DispatchTime)
+              .count();
+      TotalQueueLatencyNs += LatencyNs;
+      updateMax(MaxQueueLatencyNs, LatencyNs);
+
+      QT.T->run();
+      QT.T.reset();
+
+      if (--Outstanding == 0) {
+        std::lock_guard<std::mutex> Lock(OutstandingMutex);
+        OutstandingCV.notify_all();
+      }
+      continue;
+    }
+
+    // Sleep until a task is dispatched. NumSleeping is published before
+    // QueueDepth is checked, so a concurrent dispatch either sees a sleeper
+    // to wake or is seen here.
+    std::unique_lock<std::mutex> Lock(SleepMutex);
+    ++NumSleeping;
+    WorkAvailableCV.wait(Lock, [this]() { return QueueDepth || !Running; });
+    --NumSleeping;
+    if (!Running && !QueueDepth)
+      return;
+  }
+}
+
+void WorkStealingTaskDispatcher::shutdown() {
+  assert(CurrentDispatcher != this &&
+         "Cannot shut down a WorkStealingTaskDispatcher from its own worker");
+  {
+    std::unique_lock<std::mutex> Lock(OutstandingMutex);
+    OutstandingCV.wait(Lock, [this]() { return Outstanding == 0; });
+  }
+  {
+    std::lock_guard<std::mutex> Lock(SleepMutex);
+    Running = false;
+    WorkAvailableCV.notify_all();
+  }
+  for (std::thread &Worker : Workers)
+    Worker.join();
+  Workers.clear();
+}
+
+WorkStealingTaskDispatcher::Metrics
+WorkStealingTaskDispatcher::getMetrics() const {
+  Metrics M;
+  M.NumDispatched = NumDispatched;
+  M.QueueDepth = QueueDepth;
+  M.MaxQueueDepth = MaxQueueDepth;
+  M.NumStolen = NumStolen;
+  M.TotalQueueLatency = std::chrono::nanoseconds(TotalQueueLatencyNs);
+  M.MaxQueueLatency = std::chrono::nanoseconds(MaxQueueLatencyNs);
+  return M;
+}
 #endif
 
 } // namespace orc
@@ -0,0 +1,298 @@
+//===------ TieredCompileLayer.cpp - Recompile hot functions --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/TieredCompileLayer.h"
+#include "llvm/ExecutionEngine/Orc/Mangling.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/GlobalAlias.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Module.h"
+
+#define DEBUG_TYPE "orc"
+
+namespace llvm {
+namespace orc {
+
+TieredCompileLayer::TieredCompileLayer(
+    ExecutionSession &ES, IRLayer &Tier0Layer, IRLayer &Tier1Layer,
+    IndirectStubsManagerBuilder BuildIndirectStubsManager, uint64_t Threshold)
+    : IRLayer(ES, Tier0Layer.getManglingOptions()), Tier0Layer(Tier0Layer),
+      Tier1Layer(Tier1Layer),
+      BuildIndirectStubsManager(std::move(BuildIndirectStubsManager)),
+      Threshold(Threshold) {
+  assert(Threshold && "Threshold must be non-zero");
+}
+
+void TieredCompileLayer::emit(std::unique_ptr<MaterializationResponsibility> R,
+                              ThreadSafeModule TSM) {
+  assert(TSM && "Null module");
+
+  auto &ES = getExecutionSession();
+  auto &TargetD = R->getTargetJITDylib();
+  auto &PDR = getPerDylibResources(TargetD);
+
+  // Find the functions to tier, and promote local symbols so that functions
+  // extracted for tier 1 can refer to them.
+  std::vector<std::string> TieredNames;
+  DenseMap<SymbolStringPtr, SymbolStringPtr> Tier0Names;
+  TSM.withModuleDo([&](Module &M) {
+    MangleAndInterner Mangle(ES, M.getDataLayout());
+    for (auto &F : M.functions()) {
+      if (F.isDeclaration() || F.hasLocalLinkage() ||
+          F.hasAvailableExternallyLinkage() || !F.hasName())
+        continue;
+      // An alias can not refer to the declaration that replaces the body.
+      if (any_of(F.users(), [](User *U) { return isa<GlobalAlias>(U); }))
+        continue;
+      auto Name = Mangle(F.getName());
+      auto I = R->getSymbols().find(Name);
+      if (I == R->getSymbols().end() || !I->second.isCallable())
+        continue;
+      TieredNames.push_back(F.getName().str());
+      Tier0Names[Name] = Mangle((F.getName() + ".tier0").str());
+    }
+    PromoteSymbols(M);
+  });
+
+  // Keep an uninstrumented copy of the module to extract tier-1 functions
+  // from.
+  auto Source = std::make_shared<ThreadSafeModule>(cloneToNewContext(TSM));
+
+  // Register the functions, then move each body to a ".tier0" name, leaving a
+  // declaration with the original name behind so that calls within the module
+  // go through the stub, and count calls on entry to the body.
+  TSM.withModuleDo([&](Module &M) {
+    MangleAndInterner Mangle(ES, M.getDataLayout());
+    auto &Ctx = M.getContext();
+    auto *Int64Ty = Type::getInt64Ty(Ctx);
+    auto *PtrTy = PointerType::getUnqual(Ctx);
+    auto *TierUpTy =
+        FunctionType::get(Type::getVoidTy(Ctx), {PtrTy, Int64Ty}, false);
+    auto *TierUpFn = ConstantExpr::getIntToPtr(
+        ConstantInt::get(Int64Ty,
+                         ExecutorAddr::fromPtr(&tierUpEntryPoint).getValue()),
+        PtrTy);
+    auto *LayerPtr = ConstantExpr::getIntToPtr(
+        ConstantInt::get(Int64Ty, ExecutorAddr::fromPtr(this).getValue()),
+        PtrTy);
+    IRBuilder<> Builder(Ctx);
+
+    for (auto &Name : TieredNames) {
+      uint64_t Id;
+      {
+        std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+        Id = Functions.size();
+        Functions.push_back(std::make_unique<TieredFunction>(TieredFunction{
+            &TargetD, &PDR, Source, Name, Mangle(Name),
+            Mangle(Name + ".tier1")}));
+      }
+
+      auto *F = M.getFunction(Name);
+      F->setName(Name + ".tier0");
+      auto *Decl = Function::Create(F->getFunctionType(),
+                                    GlobalValue::ExternalLinkage, Name, &M);
+      Decl->setCallingConv(F->getCallingConv());
+      Decl->setAttributes(F->getAttributes());
+      F->replaceAllUsesWith(Decl);
+
+      auto *Counter = new GlobalVariable(
+          M, Int64Ty, false, GlobalValue::InternalLinkage,
+          ConstantInt::get(Int64Ty, 0), "__orc_tier.count." + Name);
+
+      BasicBlock &Body = F->getEntryBlock();
+      BasicBlock *TierUpBlock =
+          BasicBlock::Create(Ctx, "__orc_tier.up", F, &Body);
+      BasicBlock *CountBlock =
+          BasicBlock::Create(Ctx, "__orc_tier.count", F, TierUpBlock);
+
+      Builder.SetInsertPoint(CountBlock);
+      auto *Count = Builder.CreateAtomicRMW(
+          AtomicRMWInst::Add, Counter, ConstantInt::get(Int64Ty, 1),
+          MaybeAlign(), AtomicOrdering::Monotonic);
+      auto *IsHot = Builder.CreateICmpEQ(
+          Count, ConstantInt::get(Int64Ty, Threshold - 1), "tier.is.hot");
+      Builder.CreateCondBr(IsHot, TierUpBlock, &Body);
+
+      Builder.SetInsertPoint(TierUpBlock);
+      Builder.CreateCall(TierUpTy, TierUpFn,
+                         {LayerPtr, ConstantInt::get(Int64Ty, Id)});
+      Builder.CreateBr(&Body);
+    }
+  });
+
+  if (auto Err = Tier0Layer.add(PDR.ImplD, std::move(TSM))) {
+    ES.reportError(std::move(Err));
+    R->failMaterialization();
+    return;
+  }
+
+  // Everything that is not tiered is re-exported from the implementation
+  // dylib.
+  SymbolAliasMap NonTiered;
+  for (auto &[Name, Flags] : R->getSymbols())
+    if (!Tier0Names.count(Name))
+      NonTiered[Name] = SymbolAliasMapEntry(Name, Flags);
+  if (!NonTiered.empty())
+    if (auto Err =
+            R->replace(reexports(PDR.ImplD, std::move(NonTiered),
+                                 JITDylibLookupFlags::MatchAllSymbols))) {
+      ES.reportError(std::move(Err));
+      R->failMaterialization();
+      return;
+    }
+
+  if (Tier0Names.empty())
+    return;
+
+  // The tier-0 code calls the stubs, so they must be resolved before the
+  // tier-0 bodies can be linked. Create them without a target for now: they
+  // will not be called before they are emitted, and they are only emitted
+  // once they point at the tier-0 bodies.
+  IndirectStubsManager::StubInitsMap StubInits;
+  for (auto &KV : Tier0Names)
+    StubInits[*KV.first] = {ExecutorAddr(), R->getSymbols().lookup(KV.first)};
+  if (auto Err = PDR.ISMgr->createStubs(StubInits)) {
+    ES.reportError(std::move(Err));
+    R->failMaterialization();
+    return;
+  }
+
+  SymbolMap Stubs;
+  SymbolDependenceGroup DepGroup;
+  auto &Tier0Deps = DepGroup.Dependencies[&PDR.ImplD];
+  SymbolLookupSet Tier0Symbols;
+  for (auto &[Name, Tier0Name] : Tier0Names) {
+    Stubs[Name] = PDR.ISMgr->findStub(*Name, false);
+    DepGroup.Symbols.insert(Name);
+    Tier0Deps.insert(Tier0Name);
+    Tier0Symbols.add(Tier0Name);
+  }
+  if (auto Err = R->notifyResolved(Stubs)) {
+    ES.reportError(std::move(Err));
+    R->failMaterialization();
+    return;
+  }
+
+  std::shared_ptr<MaterializationResponsibility> SharedR(std::move(R));
+  ES.lookup(
+      LookupKind::Static,
+      makeJITDylibSearchOrder(&PDR.ImplD, JITDylibLookupFlags::MatchAllSymbols),
+      std::move(Tier0Symbols), SymbolState::Resolved,
+      [&ES, &PDR, SharedR, Tier0Names = std::move(Tier0Names),
+       DepGroup = std::move(DepGroup)](Expected<SymbolMap> Result) {
+        if (!Result) {
+          ES.reportError(Result.takeError());
+          SharedR->failMaterialization();
+          return;
+        }
+
+        for (auto &[Name, Tier0Name] : Tier0Names)
+          if (auto Err = PDR.ISMgr->updatePointer(
+                  *Name, (*Result)[Tier0Name].getAddress())) {
+            ES.reportError(std::move(Err));
+            SharedR->failMaterialization();
+            return;
+          }
+
+        // The stubs are not ready until the tier-0 bodies are.
+        if (auto Err = SharedR->notifyEmitted(DepGroup)) {
+          ES.reportError(std::move(Err));
+          SharedR->failMaterialization();
+        }
+      },
+      NoDependenciesToRegister);
+}
+
+TieredCompileLayer::PerDylibResources &
+TieredCompileLayer::getPerDylibResources(JITDylib &TargetD) {
+  std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+
+  auto I = DylibResources.find(&TargetD);
+  if (I == DylibResources.end()) {
+    auto &ImplD = getExecutionSession().createBareJITDylib(TargetD.getName() +
+                                                           ".tiered");
+    JITDylibSearchOrder NewLinkOrder;
+    TargetD.withLinkOrderDo([&](const JITDylibSearchOrder &TargetLinkOrder) {
+      NewLinkOrder = TargetLinkOrder;
+    });
+
+    assert(!NewLinkOrder.empty() && NewLinkOrder.front().first == &TargetD &&
+           NewLinkOrder.front().second ==
+               JITDylibLookupFlags::MatchAllSymbols &&
+           "TargetD must be at the front of its own search order and match "
+           "non-exported symbol");
+    // Keep TargetD first so that calls from either tier resolve to the stubs.
+    NewLinkOrder.insert(std::next(NewLinkOrder.begin()),
+                        {&ImplD, JITDylibLookupFlags::MatchAllSymbols});
+    ImplD.setLinkOrder(NewLinkOrder, false);
+    TargetD.setLinkOrder(std::move(NewLinkOrder), false);
+
+    PerDylibResources PDR(ImplD, BuildIndirectStubsManager());
+    I = DylibResources.insert(std::make_pair(&TargetD, std::move(PDR))).first;
+  }
+
+  return I->second;
+}
+
+void TieredCompileLayer::tierUpEntryPoint(TieredCompileLayer *Layer,
+                                          uint64_t Id) {
+  assert(Layer && "Null layer in tier-up call");
+  // Don't hold up the caller: compile in the background.
+  Layer->getExecutionSession().dispatchTask(makeGenericNamedTask(
+      [Layer, Id]() { Layer->tierUp(Id); }, "Tier-up compile"));
+}
+
+void TieredCompileLayer::tierUp(uint64_t Id) {
+  TieredFunction *TF;
+  {
+    std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+    assert(Id < Functions.size() && "Invalid tiered function id");
+    TF = Functions[Id].get();
+  }
+
+  auto &ES = getExecutionSession();
+  auto ShouldExtract = [&](const GlobalValue &GV) {
+    return GV.getName() == TF->Name;
+  };
+  auto Tier1TSM = cloneToNewContext(*TF->Source, ShouldExtract);
+  Tier1TSM.withModuleDo([&](Module &M) {
+    M.getFunction(TF->Name)->setName(TF->Name + ".tier1");
+    M.setModuleIdentifier((M.getModuleIdentifier() + "." + TF->Name +
+                           ".tier1").str());
+  });
+
+  LLVM_DEBUG(dbgs() << "Moving " << TF->Name << " to tier 1\n");
+  if (auto Err = Tier1Layer.add(TF->PDR->ImplD, std::move(Tier1TSM))) {
+    ES.reportError(std::move(Err));
+    return;
+  }
+
+  ES.lookup(
+      LookupKind::Static,
+      makeJITDylibSearchOrder(&TF->PDR->ImplD,
+                              JITDylibLookupFlags::MatchAllSymbols),
+      SymbolLookupSet(TF->Tier1Name), SymbolState::Ready,
+      [this, TF](Expected<SymbolMap> Result) {
+        auto &ES = getExecutionSession();
+        if (!Result) {
+          ES.reportError(Result.takeError());
+          return;
+        }
+        auto Addr = (*Result)[TF->Tier1Name].getAddress();
+        if (auto Err = TF->PDR->ISMgr->updatePointer(*TF->StubName, Addr)) {
+          ES.reportError(std::move(Err));
+          return;
+        }
+        if (NotifyTierUp)
+          NotifyTierUp(*TF->TargetD, TF->StubName, Addr);
+      },
+      NoDependenciesToRegister);
+}
+
+} // end namespace orc
+} // end namespace llvm
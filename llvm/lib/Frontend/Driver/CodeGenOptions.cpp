@@ -50,6 +50,10 @@ TargetLibraryInfoImpl *createTLII(llvm::Triple &TargetTriple,
     TLII->addVectorizableFunctionsFromVecLib(TargetLibraryInfoImpl::AMDLIBM,
                                              TargetTriple);
     break;
+  case VectorLibrary::LLVMLIBC:
+    TLII->addVectorizableFunctionsFromVecLib(TargetLibraryInfoImpl::LLVMLIBC,
+                                             TargetTriple);
+    break;
   default:
     break;
   }
@@ -888,6 +888,11 @@ Constant *ConstantInt::getBool(Type *Ty, bool V) {
 ConstantInt *ConstantInt::get(LLVMContext &Context, const APInt &V) {
   // get an existing value or the insertion position
   LLVMContextImpl *pImpl = Context.pImpl;
+  if (LLVM_UNLIKELY(pImpl->ConcurrentUniquing))
+    return pImpl->ConcurrentIntConstants.getOrCreate(V, [&] {
+      IntegerType *ITy = IntegerType::get(Context, V.getBitWidth());
+      return std::unique_ptr<ConstantInt>(new ConstantInt(ITy, V));
+    });
   std::unique_ptr<ConstantInt> &Slot =
       V.isZero()  ? pImpl->IntZeroConstants[V.getBitWidth()]
       : V.isOne() ? pImpl->IntOneConstants[V.getBitWidth()]
@@ -1050,6 +1055,12 @@ Constant *ConstantFP::getZero(Type *Ty, bool Negative) {
 ConstantFP* ConstantFP::get(LLVMContext &Context, const APFloat& V) {
   LLVMContextImpl* pImpl = Context.pImpl;
 
+  if (LLVM_UNLIKELY(pImpl->ConcurrentUniquing))
+    return pImpl->ConcurrentFPConstants.getOrCreate(V, [&] {
+      Type *Ty = Type::getFloatingPointTy(Context, V.getSemantics());
+      return std::unique_ptr<ConstantFP>(new ConstantFP(Ty, V));
+    });
+
   std::unique_ptr<ConstantFP> &Slot = pImpl->FPConstants[V];
 
   if (!Slot) {
@@ -34,6 +34,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <mutex>
 #include <utility>
 
 #define DEBUG_TYPE "ir"
@@ -596,8 +597,27 @@ public:
 
 private:
   MapTy Map;
+  /// Held around every access once the context allows concurrent uniquing.
+  std::mutex Lock;
+  bool Concurrent = false;
+
+  std::unique_lock<std::mutex> lock() {
+    return Concurrent ? std::unique_lock<std::mutex>(Lock)
+                      : std::unique_lock<std::mutex>();
+  }
+
+  void removeImpl(ConstantClass *CP) {
+    typename MapTy::iterator I = Map.find(CP);
+    assert(I != Map.end() && "Constant not found in constant table!");
+    assert(*I == CP && "Didn't find correct element?");
+    Map.erase(I);
+  }
 
 public:
+  /// Make getOrCreate(), remove() and replaceOperandsInPlace() safe to call
+  /// from several threads.  See LLVMContext::enableConcurrentUniquing().
+  void setConcurrent() { Concurrent = true; }
+
   typename MapTy::iterator begin() { return Map.begin(); }
   typename MapTy::iterator end() { return Map.end(); }
 
@@ -623,6 +643,7 @@ public:
     /// Hash once, and reuse it for the lookup and the insertion if needed.
     LookupKeyHashed Lookup(MapInfo::getHashValue(Key), Key);
 
+    auto Guard = lock();
     ConstantClass *Result = nullptr;
 
     auto I = Map.find_as(Lookup);
@@ -637,10 +658,8 @@ public:
 
   /// Remove this constant from the map
   void remove(ConstantClass *CP) {
-    typename MapTy::iterator I = Map.find(CP);
-    assert(I != Map.end() && "Constant not found in constant table!");
-    assert(*I == CP && "Didn't find correct element?");
-    Map.erase(I);
+    auto Guard = lock();
+    removeImpl(CP);
   }
 
   ConstantClass *replaceOperandsInPlace(ArrayRef<Constant *> Operands,
@@ -651,13 +670,14 @@ public:
     /// Hash once, and reuse it for the lookup and the insertion if needed.
     LookupKeyHashed Lookup(MapInfo::getHashValue(Key), Key);
 
+    auto Guard = lock();
     auto ItMap = Map.find_as(Lookup);
     if (ItMap != Map.end())
       return *ItMap;
 
     // Update to the new value.  Optimize for the case when we have a single
     // operand that we're changing, but handle bulk updates efficiently.
-    remove(CP);
+    removeImpl(CP);
     if (NumUpdated == 1) {
       assert(OperandNo < CP->getNumOperands() && "Invalid index");
       assert(CP->getOperand(OperandNo) != To && "I didn't contain From!");
@@ -12,6 +12,14 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/IR/GVMaterializer.h"
+#include "llvm/Support/Error.h"
 using namespace llvm;
 
 GVMaterializer::~GVMaterializer() = default;
+
+Error GVMaterializer::materializeBatch(ArrayRef<GlobalValue *> GVs) {
+  for (GlobalValue *GV : GVs)
+    if (Error Err = materialize(GV))
+      return Err;
+  return Error::success();
+}
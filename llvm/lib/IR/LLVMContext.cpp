@@ -367,6 +367,22 @@ void LLVMContext::setDiscardValueNames(bool Discard) {
   pImpl->DiscardValueNames = Discard;
 }
 
+bool LLVMContext::isConcurrentUniquing() const {
+  return pImpl->ConcurrentUniquing;
+}
+
+void LLVMContext::enableConcurrentUniquing() {
+  if (pImpl->ConcurrentUniquing)
+    return;
+
+  // Create the lazily cached singletons up front so that threads racing on
+  // their first use don't both try to fill them in.
+  (void)ConstantInt::getTrue(*this);
+  (void)ConstantInt::getFalse(*this);
+  (void)PointerType::get(*this, 0);
+  pImpl->enableConcurrentUniquing();
+}
+
 OptPassGate &LLVMContext::getOptPassGate() const {
   return pImpl->getOptPassGate();
 }
@@ -119,8 +119,10 @@ LLVMContextImpl::~LLVMContextImpl() {
   IntZeroConstants.clear();
   IntOneConstants.clear();
   IntConstants.clear();
+  ConcurrentIntConstants.clear();
   IntSplatConstants.clear();
   FPConstants.clear();
+  ConcurrentFPConstants.clear();
   FPSplatConstants.clear();
   CDSConstants.clear();
 
@@ -170,6 +172,45 @@ void LLVMContextImpl::dropTriviallyDeadConstantArrays() {
   }
 }
 
+void LLVMContextImpl::enableConcurrentUniquing() {
+  assert(!ConcurrentUniquing && "Concurrent uniquing already enabled");
+  ConcurrentIntConstants.init();
+  ConcurrentFPConstants.init();
+  ConcurrentIntegerTypes.init();
+  ConcurrentPointerTypes.init();
+
+  // Carry over everything uniqued so far so the concurrent maps keep handing
+  // out the same objects.
+  for (auto &Entry : IntZeroConstants)
+    ConcurrentIntConstants.insert(Entry.second->getValue(),
+                                  std::move(Entry.second));
+  for (auto &Entry : IntOneConstants)
+    ConcurrentIntConstants.insert(Entry.second->getValue(),
+                                  std::move(Entry.second));
+  for (auto &Entry : IntConstants)
+    ConcurrentIntConstants.insert(Entry.first, std::move(Entry.second));
+  for (auto &Entry : FPConstants)
+    ConcurrentFPConstants.insert(Entry.first, std::move(Entry.second));
+  for (auto &Entry : IntegerTypes)
+    ConcurrentIntegerTypes.insert(Entry.first, Entry.second);
+  for (auto &Entry : PointerTypes)
+    ConcurrentPointerTypes.insert(Entry.first, Entry.second);
+  IntZeroConstants.clear();
+  IntOneConstants.clear();
+  IntConstants.clear();
+  FPConstants.clear();
+  IntegerTypes.clear();
+  PointerTypes.clear();
+
+  ArrayConstants.setConcurrent();
+  StructConstants.setConcurrent();
+  VectorConstants.setConcurrent();
+  ExprConstants.setConcurrent();
+  InlineAsms.setConcurrent();
+
+  ConcurrentUniquing = true;
+}
+
 void Module::dropTriviallyDeadConstantArrays() {
   Context.pImpl->dropTriviallyDeadConstantArrays();
 }
@@ -45,6 +45,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <utility>
@@ -1451,6 +1452,59 @@ public:
   }
 };
 
+/// Uniquing map split into independently locked shards, used in place of a
+/// plain DenseMap once LLVMContext::enableConcurrentUniquing() has been called.
+/// Entries are only removed when the context is destroyed, so the pointers
+/// handed out stay valid without holding any lock.
+template <typename KeyT, typename ValueT> class ShardedUniquingMap {
+  static constexpr unsigned NumShardsLog2 = 5;
+
+  struct alignas(64) Shard {
+    std::mutex Lock;
+    DenseMap<KeyT, ValueT> Map;
+  };
+  std::unique_ptr<Shard[]> Shards;
+
+  Shard &getShard(const KeyT &Key) {
+    // Multiplicative hashing spreads the weak DenseMapInfo hashes of small
+    // integer keys across the shards.
+    uint64_t Hash = DenseMapInfo<KeyT>::getHashValue(Key);
+    return Shards[(Hash * 0x9E3779B97F4A7C15ULL) >> (64 - NumShardsLog2)];
+  }
+
+public:
+  /// Allocate the shards.  Called once, before the map is shared.
+  void init() {
+    assert(!Shards && "Sharded map already initialized");
+    Shards = std::make_unique<Shard[]>(1u << NumShardsLog2);
+  }
+
+  /// Insert \p Value unless \p Key is already present.  Not thread-safe; only
+  /// used to migrate the single-threaded tables.
+  void insert(const KeyT &Key, ValueT Value) {
+    getShard(Key).Map.try_emplace(Key, std::move(Value));
+  }
+
+  /// Return the entry for \p Key, calling \p Create to build it under the
+  /// shard lock if there is none yet.
+  template <typename CreateFnT>
+  auto getOrCreate(const KeyT &Key, CreateFnT Create) {
+    Shard &S = getShard(Key);
+    std::lock_guard<std::mutex> Lock(S.Lock);
+    ValueT &Slot = S.Map[Key];
+    if (!Slot)
+      Slot = Create();
+    return &*Slot;
+  }
+
+  void clear() {
+    if (!Shards)
+      return;
+    for (unsigned I = 0, E = 1u << NumShardsLog2; I != E; ++I)
+      Shards[I].Map.clear();
+  }
+};
+
 class LLVMContextImpl {
 public:
   /// OwnedModules - The set of modules instantiated in this context, and which
@@ -1598,6 +1652,23 @@ public:
   DenseMap<std::pair<Type *, ElementCount>, VectorType *> VectorTypes;
   PointerType *AS0PointerType = nullptr; // AddrSpace = 0
   DenseMap<unsigned, PointerType *> PointerTypes;
+
+  /// Set by LLVMContext::enableConcurrentUniquing().  From then on the maps
+  /// below replace IntZeroConstants, IntOneConstants, IntConstants,
+  /// FPConstants, IntegerTypes and PointerTypes, and the ConstantUniqueMaps
+  /// lock around every access.
+  bool ConcurrentUniquing = false;
+  ShardedUniquingMap<APInt, std::unique_ptr<ConstantInt>>
+      ConcurrentIntConstants;
+  ShardedUniquingMap<APFloat, std::unique_ptr<ConstantFP>>
+      ConcurrentFPConstants;
+  ShardedUniquingMap<unsigned, IntegerType *> ConcurrentIntegerTypes;
+  ShardedUniquingMap<unsigned, PointerType *> ConcurrentPointerTypes;
+  /// Serializes allocations from Alloc made by the concurrent maps.
+  std::mutex ConcurrentAllocLock;
+
+  /// Move the uniquing tables listed above into their concurrent versions.
+  void enableConcurrentUniquing();
   DenseMap<std::pair<Type *, unsigned>, PointerType *> LegacyPointerTypes;
   DenseMap<std::pair<Type *, unsigned>, TypedPointerType *> ASTypedPointerTypes;
 
@@ -16,12 +16,19 @@
 #include "llvm/IR/Function.h"
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/Remarks/RemarkStreamer.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include <optional>
 
 using namespace llvm;
 
+static cl::opt<std::string> RemarksKinds(
+    "pass-remarks-kinds", cl::Hidden,
+    cl::desc("Only emit optimization remarks of the given comma-separated "
+             "kinds (passed, missed, analysis, analysisfpcommute, "
+             "analysisaliasing, failure) to the optimization record file"));
+
 /// DiagnosticKind -> remarks::Type
 static remarks::Type toRemarkType(enum DiagnosticKind Kind) {
   switch (Kind) {
@@ -79,8 +86,8 @@ LLVMRemarkStreamer::toRemark(const DiagnosticInfoOptimizationBase &Diag) const {
 }
 
 void LLVMRemarkStreamer::emit(const DiagnosticInfoOptimizationBase &Diag) {
-  if (!RS.matchesFilter(Diag.getPassName()))
-      return;
+  if (!isEnabled(Diag.getPassName(), Diag.getKind()))
+    return;
 
   // First, convert the diagnostic to a remark.
   remarks::Remark R = toRemark(Diag);
@@ -88,6 +95,27 @@ void LLVMRemarkStreamer::emit(const DiagnosticInfoOptimizationBase &Diag) {
   RS.getSerializer().emit(R);
 }
 
+bool LLVMRemarkStreamer::isEnabled(StringRef PassName, int Kind) const {
+  return RS.isEnabled(PassName,
+                      toRemarkType(static_cast<DiagnosticKind>(Kind)));
+}
+
+bool LLVMRemarkStreamer::isEnabled(StringRef PassName) const {
+  return RS.matchesFilter(PassName);
+}
+
+/// Apply the pass and kind filters to the main remark streamer.
+static Error setupFilters(LLVMContext &Context, StringRef RemarksPasses) {
+  remarks::RemarkStreamer &RS = *Context.getMainRemarkStreamer();
+  if (!RemarksPasses.empty())
+    if (Error E = RS.setFilter(RemarksPasses))
+      return make_error<LLVMRemarkSetupPatternError>(std::move(E));
+  if (!RemarksKinds.empty())
+    if (Error E = RS.setTypeFilter(RemarksKinds))
+      return make_error<LLVMRemarkSetupPatternError>(std::move(E));
+  return Error::success();
+}
+
 char LLVMRemarkSetupFileError::ID = 0;
 char LLVMRemarkSetupPatternError::ID = 0;
 char LLVMRemarkSetupFormatError::ID = 0;
@@ -132,9 +160,8 @@ Expected<std::unique_ptr<ToolOutputFile>> llvm::setupLLVMOptimizationRemarks(
   Context.setLLVMRemarkStreamer(
       std::make_unique<LLVMRemarkStreamer>(*Context.getMainRemarkStreamer()));
 
-  if (!RemarksPasses.empty())
-    if (Error E = Context.getMainRemarkStreamer()->setFilter(RemarksPasses))
-      return make_error<LLVMRemarkSetupPatternError>(std::move(E));
+  if (Error E = setupFilters(Context, RemarksPasses))
+    return std::move(E);
 
   return std::move(RemarksFile);
 }
@@ -166,9 +193,5 @@ Error llvm::setupLLVMOptimizationRemarks(
   Context.setLLVMRemarkStreamer(
       std::make_unique<LLVMRemarkStreamer>(*Context.getMainRemarkStreamer()));
 
-  if (!RemarksPasses.empty())
-    if (Error E = Context.getMainRemarkStreamer()->setFilter(RemarksPasses))
-      return make_error<LLVMRemarkSetupPatternError>(std::move(E));
-
-  return Error::success();
+  return setupFilters(Context, RemarksPasses);
 }
@@ -452,6 +452,13 @@ Error Module::materialize(GlobalValue *GV) {
   return Materializer->materialize(GV);
 }
 
+Error Module::materializeBatch(ArrayRef<GlobalValue *> GVs) {
+  if (!Materializer)
+    return Error::success();
+
+  return Materializer->materializeBatch(GVs);
+}
+
 Error Module::materializeAll() {
   if (!Materializer)
     return Error::success();
@@ -291,10 +291,17 @@ IntegerType *IntegerType::get(LLVMContext &C, unsigned NumBits) {
     break;
   }
 
-  IntegerType *&Entry = C.pImpl->IntegerTypes[NumBits];
+  LLVMContextImpl *CImpl = C.pImpl;
+  if (LLVM_UNLIKELY(CImpl->ConcurrentUniquing))
+    return CImpl->ConcurrentIntegerTypes.getOrCreate(NumBits, [&] {
+      std::lock_guard<std::mutex> Lock(CImpl->ConcurrentAllocLock);
+      return new (CImpl->Alloc) IntegerType(C, NumBits);
+    });
+
+  IntegerType *&Entry = CImpl->IntegerTypes[NumBits];
 
   if (!Entry)
-    Entry = new (C.pImpl->Alloc) IntegerType(C, NumBits);
+    Entry = new (CImpl->Alloc) IntegerType(C, NumBits);
 
   return Entry;
 }
@@ -743,6 +750,13 @@ PointerType *PointerType::get(Type *EltTy, unsigned AddressSpace) {
 PointerType *PointerType::get(LLVMContext &C, unsigned AddressSpace) {
   LLVMContextImpl *CImpl = C.pImpl;
 
+  // The address space 0 type is created before concurrent uniquing starts.
+  if (LLVM_UNLIKELY(CImpl->ConcurrentUniquing) && AddressSpace != 0)
+    return CImpl->ConcurrentPointerTypes.getOrCreate(AddressSpace, [&] {
+      std::lock_guard<std::mutex> Lock(CImpl->ConcurrentAllocLock);
+      return new (CImpl->Alloc) PointerType(C, AddressSpace);
+    });
+
   // Since AddressSpace #0 is the common case, we special case it.
   PointerType *&Entry = AddressSpace == 0 ? CImpl->AS0PointerType
                                           : CImpl->PointerTypes[AddressSpace];
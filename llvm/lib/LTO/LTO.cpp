@@ -998,35 +998,40 @@ Error LTO::linkRegularLTO(RegularLTOState::AddedModule Mod,
 Error LTO::addThinLTO(BitcodeModule BM, ArrayRef<InputFile::Symbol> Syms,
                       const SymbolResolution *&ResI,
                       const SymbolResolution *ResE) {
+  // Computing a GUID means building the global identifier and hashing it with
+  // MD5, so do it once per symbol; both loops below need it.
+  SmallVector<GlobalValue::GUID, 0> GUIDs(Syms.size());
   const SymbolResolution *ResITmp = ResI;
-  for (const InputFile::Symbol &Sym : Syms) {
+  for (auto [I, Sym] : enumerate(Syms)) {
     assert(ResITmp != ResE);
     SymbolResolution Res = *ResITmp++;
 
     if (!Sym.getIRName().empty()) {
       auto GUID = GlobalValue::getGUID(GlobalValue::getGlobalIdentifier(
           Sym.getIRName(), GlobalValue::ExternalLinkage, ""));
+      GUIDs[I] = GUID;
       if (Res.Prevailing)
         ThinLTO.PrevailingModuleForGUID[GUID] = BM.getModuleIdentifier();
     }
   }
 
+  // The summary reader asks about every GUID in the module. Use lookup() so
+  // that non-prevailing GUIDs do not get an empty entry in the map.
   if (Error Err =
           BM.readSummary(ThinLTO.CombinedIndex, BM.getModuleIdentifier(),
                          [&](GlobalValue::GUID GUID) {
-                           return ThinLTO.PrevailingModuleForGUID[GUID] ==
-                                  BM.getModuleIdentifier();
+                           return ThinLTO.PrevailingModuleForGUID.lookup(
+                                      GUID) == BM.getModuleIdentifier();
                          }))
     return Err;
   LLVM_DEBUG(dbgs() << "Module " << BM.getModuleIdentifier() << "\n");
 
-  for (const InputFile::Symbol &Sym : Syms) {
+  for (auto [I, Sym] : enumerate(Syms)) {
     assert(ResI != ResE);
     SymbolResolution Res = *ResI++;
 
     if (!Sym.getIRName().empty()) {
-      auto GUID = GlobalValue::getGUID(GlobalValue::getGlobalIdentifier(
-          Sym.getIRName(), GlobalValue::ExternalLinkage, ""));
+      auto GUID = GUIDs[I];
       if (Res.Prevailing) {
         assert(ThinLTO.PrevailingModuleForGUID[GUID] ==
                BM.getModuleIdentifier());
@@ -1753,7 +1758,7 @@ Error LTO::runThinLTO(AddStreamFn AddStream, FileCache Cache,
                                LocalWPDTargetsMap);
 
   auto isPrevailing = [&](GlobalValue::GUID GUID, const GlobalValueSummary *S) {
-    return ThinLTO.PrevailingModuleForGUID[GUID] == S->modulePath();
+    return ThinLTO.PrevailingModuleForGUID.lookup(GUID) == S->modulePath();
   };
   if (EnableMemProfContextDisambiguation) {
     MemProfContextDisambiguation ContextDisambiguation;
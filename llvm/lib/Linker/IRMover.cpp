@@ -26,14 +26,19 @@
 #include "llvm/IR/PseudoProbe.h"
 #include "llvm/IR/TypeFinder.h"
 #include "llvm/Object/ModuleSymbolTable.h"
+#include "llvm/Pass.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/TargetParser/Triple.h"
 #include "llvm/Transforms/Utils/ValueMapper.h"
 #include <optional>
 #include <utility>
 using namespace llvm;
 
+static const char TimeIRLinkingGroupName[] = "irlink";
+static const char TimeIRLinkingGroupDescription[] = "LLVM IR Linking";
+
 //===----------------------------------------------------------------------===//
 // TypeMap implementation.
 //===----------------------------------------------------------------------===//
@@ -1606,23 +1611,31 @@ Error IRLinker::run() {
   DstM.setTargetTriple(SrcTriple.merge(DstTriple));
 
   // Loop over all of the linked values to compute type mappings.
-  computeTypeMapping();
-
-  std::reverse(Worklist.begin(), Worklist.end());
-  while (!Worklist.empty()) {
-    GlobalValue *GV = Worklist.back();
-    Worklist.pop_back();
+  {
+    NamedRegionTimer T("types", "Compute type mapping", TimeIRLinkingGroupName,
+                       TimeIRLinkingGroupDescription, TimePassesIsEnabled);
+    computeTypeMapping();
+  }
 
-    // Already mapped.
-    if (ValueMap.find(GV) != ValueMap.end() ||
-        IndirectSymbolValueMap.find(GV) != IndirectSymbolValueMap.end())
-      continue;
+  {
+    NamedRegionTimer T("values", "Link global values", TimeIRLinkingGroupName,
+                       TimeIRLinkingGroupDescription, TimePassesIsEnabled);
+    std::reverse(Worklist.begin(), Worklist.end());
+    while (!Worklist.empty()) {
+      GlobalValue *GV = Worklist.back();
+      Worklist.pop_back();
+
+      // Already mapped.
+      if (ValueMap.find(GV) != ValueMap.end() ||
+          IndirectSymbolValueMap.find(GV) != IndirectSymbolValueMap.end())
+        continue;
 
-    assert(!GV->isDeclaration());
-    Mapper.mapValue(*GV);
-    if (FoundError)
-      return std::move(*FoundError);
-    flushRAUWWorklist();
+      assert(!GV->isDeclaration());
+      Mapper.mapValue(*GV);
+      if (FoundError)
+        return std::move(*FoundError);
+      flushRAUWWorklist();
+    }
   }
 
   // Note that we are done linking global value bodies. This prevents
@@ -1630,16 +1643,20 @@ Error IRLinker::run() {
   DoneLinkingBodies = true;
   Mapper.addFlags(RF_NullMapMissingGlobalValues);
 
-  // Remap all of the named MDNodes in Src into the DstM module. We do this
-  // after linking GlobalValues so that MDNodes that reference GlobalValues
-  // are properly remapped.
-  linkNamedMDNodes();
-
-  // Clean up any global objects with potentially unmapped metadata.
-  // Specifically declarations which did not become definitions.
-  for (GlobalObject *NGO : UnmappedMetadata) {
-    if (NGO->isDeclaration())
-      Mapper.remapGlobalObjectMetadata(*NGO);
+  {
+    NamedRegionTimer T("metadata", "Link metadata", TimeIRLinkingGroupName,
+                       TimeIRLinkingGroupDescription, TimePassesIsEnabled);
+    // Remap all of the named MDNodes in Src into the DstM module. We do this
+    // after linking GlobalValues so that MDNodes that reference GlobalValues
+    // are properly remapped.
+    linkNamedMDNodes();
+
+    // Clean up any global objects with potentially unmapped metadata.
+    // Specifically declarations which did not become definitions.
+    for (GlobalObject *NGO : UnmappedMetadata) {
+      if (NGO->isDeclaration())
+        Mapper.remapGlobalObjectMetadata(*NGO);
+    }
   }
 
   if (!IsPerformingImport && !SrcM->getModuleInlineAsm().empty()) {
@@ -1676,6 +1693,8 @@ Error IRLinker::run() {
   }
 
   // Merge the module flags into the DstM module.
+  NamedRegionTimer T("flags", "Link module flags", TimeIRLinkingGroupName,
+                     TimeIRLinkingGroupDescription, TimePassesIsEnabled);
   return linkModuleFlagsMetadata();
 }
 
@@ -1726,12 +1745,15 @@ bool IRMover::StructTypeKeyInfo::isEqual(const StructType *LHS,
 
 void IRMover::IdentifiedStructTypeSet::addNonOpaque(StructType *Ty) {
   assert(!Ty->isOpaque());
-  NonOpaqueStructTypes.insert(Ty);
+  if (NonOpaqueStructTypes.insert(Ty).second)
+    MemberTypes.insert(Ty);
 }
 
 void IRMover::IdentifiedStructTypeSet::switchToNonOpaque(StructType *Ty) {
   assert(!Ty->isOpaque());
-  NonOpaqueStructTypes.insert(Ty);
+  // If an isomorphic type is already known, Ty is no longer a member.
+  if (!NonOpaqueStructTypes.insert(Ty).second)
+    MemberTypes.erase(Ty);
   bool Removed = OpaqueStructTypes.erase(Ty);
   (void)Removed;
   assert(Removed);
@@ -1740,6 +1762,7 @@ void IRMover::IdentifiedStructTypeSet::switchToNonOpaque(StructType *Ty) {
 void IRMover::IdentifiedStructTypeSet::addOpaque(StructType *Ty) {
   assert(Ty->isOpaque());
   OpaqueStructTypes.insert(Ty);
+  MemberTypes.insert(Ty);
 }
 
 StructType *
@@ -1751,10 +1774,12 @@ IRMover::IdentifiedStructTypeSet::findNonOpaque(ArrayRef<Type *> ETypes,
 }
 
 bool IRMover::IdentifiedStructTypeSet::hasType(StructType *Ty) {
-  if (Ty->isOpaque())
-    return OpaqueStructTypes.count(Ty);
-  auto I = NonOpaqueStructTypes.find(Ty);
-  return I == NonOpaqueStructTypes.end() ? false : *I == Ty;
+  assert(MemberTypes.contains(Ty) ==
+             (Ty->isOpaque() ? OpaqueStructTypes.contains(Ty)
+                             : NonOpaqueStructTypes.contains(Ty) &&
+                                   *NonOpaqueStructTypes.find(Ty) == Ty) &&
+         "identity set out of sync");
+  return MemberTypes.contains(Ty);
 }
 
 IRMover::IRMover(Module &M) : Composite(M) {
@@ -70,6 +70,10 @@ STATISTIC(FragmentLayouts, "Number of fragment layouts");
 STATISTIC(ObjectBytes, "Number of emitted object file bytes");
 STATISTIC(RelaxationSteps, "Number of assembler layout and relaxation steps");
 STATISTIC(RelaxedInstructions, "Number of relaxed instructions");
+STATISTIC(RelaxFragmentVisits,
+          "Number of fragments visited during layout and relaxation");
+STATISTIC(RelaxFragmentChanges,
+          "Number of fragments that changed during layout and relaxation");
 
 } // end namespace stats
 } // end anonymous namespace
@@ -831,6 +835,7 @@ void MCAssembler::layout(MCAsmLayout &Layout) {
   }
 
   // Assign layout order indices to sections and fragments.
+  RelaxableFragments.clear();
   for (unsigned i = 0, e = Layout.getSectionOrder().size(); i != e; ++i) {
     MCSection *Sec = Layout.getSectionOrder()[i];
     Sec->setLayoutOrder(i);
@@ -842,14 +847,17 @@ void MCAssembler::layout(MCAsmLayout &Layout) {
 
   // Layout until everything fits.
   while (layoutOnce(Layout)) {
-    if (getContext().hadError())
+    if (getContext().hadError()) {
+      RelaxableFragments.clear();
       return;
+    }
     // Size of fragments in one section can depend on the size of fragments in
     // another. If any fragment has changed size, we have to re-layout (and
     // as a result possibly further relax) all.
     for (MCSection &Sec : *this)
       Layout.invalidateFragmentsFrom(&*Sec.begin());
   }
+  RelaxableFragments.clear();
 
   DEBUG_WITH_TYPE("mc-dump", {
       errs() << "assembler backend - post-relaxation\n--\n";
@@ -1193,10 +1201,11 @@ bool MCAssembler::relaxPseudoProbeAddr(MCAsmLayout &Layout,
   return OldSize != Data.size();
 }
 
-bool MCAssembler::relaxFragment(MCAsmLayout &Layout, MCFragment &F) {
+std::optional<bool> MCAssembler::relaxFragment(MCAsmLayout &Layout,
+                                               MCFragment &F) {
   switch(F.getKind()) {
   default:
-    return false;
+    return std::nullopt;
   case MCFragment::FT_Relaxable:
     assert(!getRelaxAll() &&
            "Did not expect a MCRelaxableFragment in RelaxAll mode");
@@ -1226,12 +1235,30 @@ bool MCAssembler::layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec) {
   // invalidated because their offset is going to change.
   MCFragment *FirstRelaxedFragment = nullptr;
 
-  // Attempt to relax all the fragments in the section.
-  for (MCFragment &Frag : Sec) {
-    // Check if this is a fragment that needs relaxation.
-    bool RelaxedFrag = relaxFragment(Layout, Frag);
-    if (RelaxedFrag && !FirstRelaxedFragment)
-      FirstRelaxedFragment = &Frag;
+  // The first pass over a section visits every fragment and remembers the
+  // ones that can change size. Later passes only revisit those: the other
+  // fragments only need their offsets recomputed, which the layout does
+  // lazily.
+  auto [It, FirstPass] = RelaxableFragments.try_emplace(&Sec);
+  auto RelaxOne = [&](MCFragment &Frag) {
+    ++stats::RelaxFragmentVisits;
+    std::optional<bool> RelaxedFrag = relaxFragment(Layout, Frag);
+    if (!RelaxedFrag)
+      return false;
+    if (*RelaxedFrag) {
+      ++stats::RelaxFragmentChanges;
+      if (!FirstRelaxedFragment)
+        FirstRelaxedFragment = &Frag;
+    }
+    return true;
+  };
+  if (FirstPass) {
+    for (MCFragment &Frag : Sec)
+      if (RelaxOne(Frag))
+        It->second.push_back(&Frag);
+  } else {
+    for (MCFragment *Frag : It->second)
+      RelaxOne(*Frag);
   }
   if (FirstRelaxedFragment) {
     Layout.invalidateFragmentsFrom(FirstRelaxedFragment);
@@ -2118,6 +2118,35 @@ template <class ELFT> void ELFWriter<ELFT>::writeSegmentData() {
   }
 }
 
+template <class ELFT> void ELFWriter<ELFT>::zeroUnwrittenRanges() {
+  // The output buffer is allocated uninitialized so that large files are not
+  // touched twice. Collect the byte ranges that are about to be overwritten in
+  // full by segment contents or by the contents of sections that are not in a
+  // segment, and zero everything else (headers, padding and alignment gaps).
+  std::vector<std::pair<uint64_t, uint64_t>> Written;
+  for (const Segment &Seg : Obj.segments()) {
+    uint64_t Size = std::min<uint64_t>(Seg.FileSize, Seg.getContents().size());
+    if (Size != 0)
+      Written.emplace_back(Seg.Offset, Seg.Offset + Size);
+  }
+  for (const SectionBase &Sec : Obj.sections())
+    if (Sec.ParentSegment == nullptr && Sec.hasContents() && Sec.Size != 0)
+      Written.emplace_back(Sec.Offset, Sec.Offset + Sec.Size);
+  llvm::sort(Written);
+
+  uint8_t *Start = reinterpret_cast<uint8_t *>(Buf->getBufferStart());
+  uint64_t BufSize = Buf->getBufferSize();
+  uint64_t Offset = 0;
+  for (const auto &[Begin, End] : Written) {
+    if (Begin > Offset)
+      std::memset(Start + Offset, 0, std::min(Begin, BufSize) - Offset);
+    Offset = std::min(std::max(Offset, End), BufSize);
+    if (Offset == BufSize)
+      return;
+  }
+  std::memset(Start + Offset, 0, BufSize - Offset);
+}
+
 template <class ELFT>
 ELFWriter<ELFT>::ELFWriter(Object &Obj, raw_ostream &Buf, bool WSH,
                            bool OnlyKeepDebug)
@@ -2494,6 +2523,7 @@ template <class ELFT> size_t ELFWriter<ELFT>::totalSize() const {
 }
 
 template <class ELFT> Error ELFWriter<ELFT>::write() {
+  zeroUnwrittenRanges();
   // Segment data must be written first, so that the ELF header and program
   // header tables can overwrite it, if covered by a segment.
   writeSegmentData();
@@ -2635,7 +2665,7 @@ template <class ELFT> Error ELFWriter<ELFT>::finalize() {
   }
 
   size_t TotalSize = totalSize();
-  Buf = WritableMemoryBuffer::getNewMemBuffer(TotalSize);
+  Buf = WritableMemoryBuffer::getNewUninitMemBuffer(TotalSize);
   if (!Buf)
     return createStringError(errc::not_enough_memory,
                              "failed to allocate memory buffer of " +
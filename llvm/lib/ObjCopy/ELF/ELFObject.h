@@ -338,6 +338,7 @@ private:
   void writeShdrs();
   Error writeSectionData();
   void writeSegmentData();
+  void zeroUnwrittenRanges();
 
   void assignOffsets();
 
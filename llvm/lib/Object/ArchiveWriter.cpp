@@ -12,6 +12,7 @@
 
 #include "llvm/Object/ArchiveWriter.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/Magic.h"
@@ -31,6 +32,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
@@ -704,27 +706,41 @@ bool isImportDescriptor(StringRef Name) {
           Name.ends_with(NullThunkDataSuffix));
 }
 
-static Expected<std::vector<unsigned>> getSymbols(SymbolicFile *Obj,
-                                                  uint16_t Index,
-                                                  raw_ostream &SymNames,
-                                                  SymMap *SymMap) {
+static Error getArchiveSymbolNames(SymbolicFile &Obj,
+                                   std::vector<std::string> &Names) {
+  for (const object::BasicSymbolRef &S : Obj.symbols()) {
+    if (!isArchiveSymbol(S))
+      continue;
+    std::string Name;
+    raw_string_ostream NameStream(Name);
+    if (Error E = S.printName(NameStream))
+      return E;
+    Names.push_back(std::move(Name));
+  }
+  return Error::success();
+}
+
+static Expected<std::vector<unsigned>>
+getSymbols(SymbolicFile *Obj, uint16_t Index, raw_ostream &SymNames,
+           SymMap *SymMap, std::vector<std::string> *CachedNames = nullptr) {
   std::vector<unsigned> Ret;
 
   if (Obj == nullptr)
     return Ret;
 
+  std::vector<std::string> LocalNames;
+  if (!CachedNames) {
+    if (Error E = getArchiveSymbolNames(*Obj, LocalNames))
+      return std::move(E);
+    CachedNames = &LocalNames;
+  }
+
   std::map<std::string, uint16_t> *Map = nullptr;
   if (SymMap)
     Map = SymMap->UseECMap && isECObject(*Obj) ? &SymMap->ECMap : &SymMap->Map;
 
-  for (const object::BasicSymbolRef &S : Obj->symbols()) {
-    if (!isArchiveSymbol(S))
-      continue;
+  for (std::string &Name : *CachedNames) {
     if (Map) {
-      std::string Name;
-      raw_string_ostream NameStream(Name);
-      if (Error E = S.printName(NameStream))
-        return std::move(E);
       if (Map->find(Name) != Map->end())
         continue; // ignore duplicated symbol
       (*Map)[Name] = Index;
@@ -738,9 +754,7 @@ static Expected<std::vector<unsigned>> getSymbols(SymbolicFile *Obj,
       }
     } else {
       Ret.push_back(SymNames.tell());
-      if (Error E = S.printName(SymNames))
-        return std::move(E);
-      SymNames << '\0';
+      SymNames << Name << '\0';
     }
   }
   return Ret;
@@ -817,12 +831,47 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
 
   std::vector<std::unique_ptr<SymbolicFile>> SymFiles;
 
+  // Parsing members and extracting their symbol names is independent per
+  // member, so it is done up front in parallel. Bitcode members share the
+  // caller's LLVMContext, which is not thread-safe, and are handled serially
+  // below. Results are consumed in member order so that the archive and any
+  // reported error are the same as with a serial scan.
+  std::vector<std::optional<Expected<std::unique_ptr<SymbolicFile>>>>
+      ParsedFiles(NewMembers.size());
+  std::vector<std::vector<std::string>> SymbolNames(NewMembers.size());
+  std::vector<Error> SymbolNameErrors;
+  SymbolNameErrors.reserve(NewMembers.size());
+  for (size_t I = 0, E = NewMembers.size(); I != E; ++I)
+    SymbolNameErrors.push_back(Error::success());
+  auto ConsumeSymbolNameErrors = make_scope_exit([&] {
+    for (Error &E : SymbolNameErrors)
+      consumeError(std::move(E));
+  });
+  bool CacheSymbolNames = NeedSymbols != SymtabWritingMode::NoSymtab;
+
   if (NeedSymbols != SymtabWritingMode::NoSymtab || isAIXBigArchive(Kind)) {
-    for (const NewArchiveMember &M : NewMembers) {
-      Expected<std::unique_ptr<SymbolicFile>> SymFileOrErr =
-          getSymbolicFile(M.Buf->getMemBufferRef(), Context);
-      if (!SymFileOrErr)
-        return createFileError(M.MemberName, SymFileOrErr.takeError());
+    parallelFor(0, NewMembers.size(), [&](size_t I) {
+      MemoryBufferRef Buf = NewMembers[I].Buf->getMemBufferRef();
+      if (identify_magic(Buf.getBuffer()) == file_magic::bitcode)
+        return;
+      ParsedFiles[I] = getSymbolicFile(Buf, Context);
+      if (CacheSymbolNames && *ParsedFiles[I] && **ParsedFiles[I])
+        SymbolNameErrors[I] =
+            getArchiveSymbolNames(***ParsedFiles[I], SymbolNames[I]);
+    });
+
+    for (size_t I = 0, E = NewMembers.size(); I != E; ++I) {
+      const NewArchiveMember &M = NewMembers[I];
+      if (!ParsedFiles[I])
+        ParsedFiles[I] = getSymbolicFile(M.Buf->getMemBufferRef(), Context);
+      Expected<std::unique_ptr<SymbolicFile>> &SymFileOrErr = *ParsedFiles[I];
+      if (!SymFileOrErr) {
+        Error Err = SymFileOrErr.takeError();
+        for (size_t J = I + 1; J != E; ++J)
+          if (ParsedFiles[J] && !*ParsedFiles[J])
+            consumeError(ParsedFiles[J]->takeError());
+        return createFileError(M.MemberName, std::move(Err));
+      }
       SymFiles.push_back(std::move(*SymFileOrErr));
     }
   }
@@ -933,8 +982,15 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
 
     std::vector<unsigned> Symbols;
     if (NeedSymbols != SymtabWritingMode::NoSymtab) {
+      if (SymbolNameErrors[Index])
+        return createFileError(M->MemberName,
+                               std::move(SymbolNameErrors[Index]));
+      // Bitcode members were not scanned in parallel; an empty cache for them
+      // makes getSymbols() extract the names itself.
+      bool NamesCached = CurSymFile && !isa<IRObjectFile>(CurSymFile.get());
       Expected<std::vector<unsigned>> SymbolsOrErr =
-          getSymbols(CurSymFile.get(), Index + 1, SymNames, SymMap);
+          getSymbols(CurSymFile.get(), Index + 1, SymNames, SymMap,
+                     NamesCached ? &SymbolNames[Index] : nullptr);
       if (!SymbolsOrErr)
         return createFileError(M->MemberName, SymbolsOrErr.takeError());
       Symbols = std::move(*SymbolsOrErr);
@@ -27,6 +27,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/VirtualFileSystem.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
@@ -956,22 +957,27 @@ static Error handleMaybeNoDataFoundError(Error E) {
       });
 }
 
-Error CoverageMapping::loadFromFile(
-    StringRef Filename, StringRef Arch, StringRef CompilationDir,
-    IndexedInstrProfReader &ProfileReader, CoverageMapping &Coverage,
-    bool &DataFound, SmallVectorImpl<object::BuildID> *FoundBinaryIDs) {
+struct CoverageMapping::ObjectReaders {
+  std::unique_ptr<MemoryBuffer> CovMappingBuf;
+  SmallVector<std::unique_ptr<MemoryBuffer>, 4> Buffers;
+  SmallVector<object::BuildIDRef> BinaryIDs;
+  SmallVector<std::unique_ptr<CoverageMappingReader>, 4> Readers;
+};
+
+Error CoverageMapping::createObjectReaders(StringRef Filename, StringRef Arch,
+                                           StringRef CompilationDir,
+                                           bool CollectBinaryIDs,
+                                           ObjectReaders &Object) {
   auto CovMappingBufOrErr = MemoryBuffer::getFileOrSTDIN(
       Filename, /*IsText=*/false, /*RequiresNullTerminator=*/false);
   if (std::error_code EC = CovMappingBufOrErr.getError())
     return createFileError(Filename, errorCodeToError(EC));
-  MemoryBufferRef CovMappingBufRef =
-      CovMappingBufOrErr.get()->getMemBufferRef();
-  SmallVector<std::unique_ptr<MemoryBuffer>, 4> Buffers;
+  Object.CovMappingBuf = std::move(CovMappingBufOrErr.get());
+  MemoryBufferRef CovMappingBufRef = Object.CovMappingBuf->getMemBufferRef();
 
-  SmallVector<object::BuildIDRef> BinaryIDs;
   auto CoverageReadersOrErr = BinaryCoverageReader::create(
-      CovMappingBufRef, Arch, Buffers, CompilationDir,
-      FoundBinaryIDs ? &BinaryIDs : nullptr);
+      CovMappingBufRef, Arch, Object.Buffers, CompilationDir,
+      CollectBinaryIDs ? &Object.BinaryIDs : nullptr);
   if (Error E = CoverageReadersOrErr.takeError()) {
     E = handleMaybeNoDataFoundError(std::move(E));
     if (E)
@@ -979,21 +985,40 @@ Error CoverageMapping::loadFromFile(
     return E;
   }
 
-  SmallVector<std::unique_ptr<CoverageMappingReader>, 4> Readers;
   for (auto &Reader : CoverageReadersOrErr.get())
-    Readers.push_back(std::move(Reader));
-  if (FoundBinaryIDs && !Readers.empty()) {
+    Object.Readers.push_back(std::move(Reader));
+  return Error::success();
+}
+
+Error CoverageMapping::loadFromObjectReaders(
+    StringRef Filename, ObjectReaders &Object,
+    IndexedInstrProfReader &ProfileReader, CoverageMapping &Coverage,
+    bool &DataFound, SmallVectorImpl<object::BuildID> *FoundBinaryIDs) {
+  if (FoundBinaryIDs && !Object.Readers.empty()) {
     llvm::append_range(*FoundBinaryIDs,
-                       llvm::map_range(BinaryIDs, [](object::BuildIDRef BID) {
-                         return object::BuildID(BID);
-                       }));
+                       llvm::map_range(Object.BinaryIDs,
+                                       [](object::BuildIDRef BID) {
+                                         return object::BuildID(BID);
+                                       }));
   }
-  DataFound |= !Readers.empty();
-  if (Error E = loadFromReaders(Readers, ProfileReader, Coverage))
+  DataFound |= !Object.Readers.empty();
+  if (Error E = loadFromReaders(Object.Readers, ProfileReader, Coverage))
     return createFileError(Filename, std::move(E));
   return Error::success();
 }
 
+Error CoverageMapping::loadFromFile(
+    StringRef Filename, StringRef Arch, StringRef CompilationDir,
+    IndexedInstrProfReader &ProfileReader, CoverageMapping &Coverage,
+    bool &DataFound, SmallVectorImpl<object::BuildID> *FoundBinaryIDs) {
+  ObjectReaders Object;
+  if (Error E = createObjectReaders(Filename, Arch, CompilationDir,
+                                    FoundBinaryIDs != nullptr, Object))
+    return E;
+  return loadFromObjectReaders(Filename, Object, ProfileReader, Coverage,
+                               DataFound, FoundBinaryIDs);
+}
+
 Expected<std::unique_ptr<CoverageMapping>> CoverageMapping::load(
     ArrayRef<StringRef> ObjectFilenames, StringRef ProfileFilename,
     vfs::FileSystem &FS, ArrayRef<StringRef> Arches, StringRef CompilationDir,
@@ -1013,12 +1038,45 @@ Expected<std::unique_ptr<CoverageMapping>> CoverageMapping::load(
     return Arches[Idx];
   };
 
+  // Opening the object files and reading their coverage mapping sections is
+  // independent for each file, so do it in parallel. Records are still loaded
+  // in the order of the files, which needs the shared profile reader. Work in
+  // batches to bound the number of files that are open at once.
   SmallVector<object::BuildID> FoundBinaryIDs;
-  for (const auto &File : llvm::enumerate(ObjectFilenames)) {
-    if (Error E =
-            loadFromFile(File.value(), GetArch(File.index()), CompilationDir,
-                         *ProfileReader, *Coverage, DataFound, &FoundBinaryIDs))
-      return std::move(E);
+  const size_t BatchSize =
+      std::max(1u, parallel::strategy.compute_thread_count());
+  for (size_t Begin = 0; Begin < ObjectFilenames.size(); Begin += BatchSize) {
+    size_t End = std::min(ObjectFilenames.size(), Begin + BatchSize);
+    std::vector<ObjectReaders> Objects(End - Begin);
+    std::vector<Error> Errors;
+    for (size_t I = Begin; I < End; ++I)
+      Errors.push_back(Error::success());
+    parallelFor(Begin, End, [&](size_t I) {
+      Errors[I - Begin] =
+          createObjectReaders(ObjectFilenames[I], GetArch(I), CompilationDir,
+                              /*CollectBinaryIDs=*/true, Objects[I - Begin]);
+    });
+
+    Error Err = Error::success();
+    for (size_t I = Begin; I < End; ++I) {
+      if (Err) {
+        consumeError(std::move(Errors[I - Begin]));
+        continue;
+      }
+      if (Error E = std::move(Errors[I - Begin])) {
+        Err = std::move(E);
+        continue;
+      }
+      ObjectReaders &Object = Objects[I - Begin];
+      if (Error E = loadFromObjectReaders(ObjectFilenames[I], Object,
+                                          *ProfileReader, *Coverage, DataFound,
+                                          &FoundBinaryIDs))
+        Err = std::move(E);
+      // Release the readers and buffers of this file as early as possible.
+      Object = ObjectReaders();
+    }
+    if (Err)
+      return std::move(Err);
   }
 
   if (BIDFetcher) {
@@ -519,6 +519,19 @@ inline ErrorOr<size_t> SampleProfileReaderBinary::readStringIndex(T &Table) {
 
 ErrorOr<FunctionId>
 SampleProfileReaderBinary::readStringFromTable(size_t *RetIdx) {
+  if (MD5NameMemStart) {
+    auto Idx = readNumber<size_t>();
+    if (std::error_code EC = Idx.getError())
+      return EC;
+    if (*Idx >= MD5NameTableSize)
+      return sampleprof_error::truncated_name_table;
+    if (RetIdx)
+      *RetIdx = *Idx;
+    using namespace support;
+    return FunctionId(endian::read<uint64_t, endianness::little, unaligned>(
+        MD5NameMemStart + (*Idx) * sizeof(uint64_t)));
+  }
+
   auto Idx = readStringIndex(NameTable);
   if (std::error_code EC = Idx.getError())
     return EC;
@@ -1044,10 +1057,24 @@ std::error_code SampleProfileReaderExtBinary::verifySPMagic(uint64_t Magic) {
   return sampleprof_error::bad_magic;
 }
 
+std::vector<FunctionId> *SampleProfileReaderBinary::getNameTable() {
+  if (MD5NameMemStart && NameTable.empty()) {
+    NameTable.reserve(MD5NameTableSize);
+    for (size_t I = 0; I < MD5NameTableSize; ++I) {
+      using namespace support;
+      uint64_t FID = endian::read<uint64_t, endianness::little, unaligned>(
+          MD5NameMemStart + I * sizeof(uint64_t));
+      NameTable.emplace_back(FunctionId(FID));
+    }
+  }
+  return &NameTable;
+}
+
 std::error_code SampleProfileReaderBinary::readNameTable() {
   auto Size = readNumber<size_t>();
   if (std::error_code EC = Size.getError())
     return EC;
+  MD5NameMemStart = nullptr;
 
   // Normally if useMD5 is true, the name table should have MD5 values, not
   // strings, however in the case that ExtBinary profile has multiple name
@@ -1100,14 +1127,11 @@ SampleProfileReaderExtBinaryBase::readNameTableSec(bool IsMD5,
     if (Data + (*Size) * sizeof(uint64_t) > End)
       return sampleprof_error::truncated;
 
+    // Keep the table in the profile buffer. It is only copied to NameTable
+    // if a client asks for the whole table.
     NameTable.clear();
-    NameTable.reserve(*Size);
-    for (size_t I = 0; I < *Size; ++I) {
-      using namespace support;
-      uint64_t FID = endian::read<uint64_t, endianness::little, unaligned>(
-          Data + I * sizeof(uint64_t));
-      NameTable.emplace_back(FunctionId(FID));
-    }
+    MD5NameMemStart = Data;
+    MD5NameTableSize = *Size;
     if (!ProfileIsCS)
       MD5SampleContextStart = reinterpret_cast<const uint64_t *>(Data);
     Data = Data + (*Size) * sizeof(uint64_t);
@@ -1122,6 +1146,7 @@ SampleProfileReaderExtBinaryBase::readNameTableSec(bool IsMD5,
 
     NameTable.clear();
     NameTable.reserve(*Size);
+    MD5NameMemStart = nullptr;
     if (!ProfileIsCS)
       MD5SampleContextTable.resize(*Size);
     for (size_t I = 0; I < *Size; ++I) {
@@ -149,6 +149,13 @@ static Error parseRecord(BitstreamRemarkParserHelper &Parser, unsigned Code) {
         ArrayRef<BitstreamRemarkParserHelper::Argument>(Parser.TmpArgs);
     break;
   }
+  case RECORD_REMARK_STRTAB: {
+    if (Record.size() != 1)
+      return malformedRecord("BLOCK_REMARK", "RECORD_REMARK_STRTAB");
+    Parser.StrTabFirstIdx = Record[0];
+    Parser.StrTabBuf = Blob;
+    break;
+  }
   default:
     return unknownRecord("BLOCK_REMARK", *RecordID);
   }
@@ -502,6 +509,21 @@ BitstreamRemarkParser::processRemark(BitstreamRemarkParserHelper &Helper) {
   std::unique_ptr<Remark> Result = std::make_unique<Remark>();
   Remark &R = *Result;
 
+  // Strings inlined in the remark block extend the string table. They are
+  // already known if the table came with the metadata.
+  if (Helper.StrTabBuf) {
+    if (StrTab == std::nullopt)
+      StrTab.emplace(StringRef());
+    if (*Helper.StrTabFirstIdx > StrTab->size())
+      return createStringError(
+          std::make_error_code(std::errc::illegal_byte_sequence),
+          "Error while parsing BLOCK_REMARK: string table entries are "
+          "missing before index %lu.",
+          *Helper.StrTabFirstIdx);
+    if (*Helper.StrTabFirstIdx == StrTab->size())
+      StrTab->append(*Helper.StrTabBuf);
+  }
+
   if (StrTab == std::nullopt)
     return createStringError(
         std::make_error_code(std::errc::invalid_argument),
@@ -13,11 +13,17 @@
 
 #include "llvm/Remarks/BitstreamRemarkSerializer.h"
 #include "llvm/Remarks/Remark.h"
+#include "llvm/Support/CommandLine.h"
 #include <optional>
 
 using namespace llvm;
 using namespace llvm::remarks;
 
+static cl::opt<bool> InlineStringTable(
+    "remarks-inline-string-table", cl::Hidden, cl::init(false),
+    cl::desc("Emit the string table of separate bitstream remark files "
+             "incrementally in the remark blocks"));
+
 BitstreamRemarkSerializerHelper::BitstreamRemarkSerializerHelper(
     BitstreamRemarkContainerType ContainerType)
     : Bitstream(Encoded), ContainerType(ContainerType) {}
@@ -192,6 +198,19 @@ void BitstreamRemarkSerializerHelper::setupRemarkBlockInfo() {
     RecordRemarkArgWithoutDebugLocAbbrevID =
         Bitstream.EmitBlockInfoAbbrev(REMARK_BLOCK_ID, Abbrev);
   }
+
+  // The strings introduced by a remark. Only set up when used, to keep the
+  // output of the other modes unchanged.
+  if (InlineStrTab) {
+    setRecordName(RECORD_REMARK_STRTAB, Bitstream, R, RemarkStrTabName);
+
+    auto Abbrev = std::make_shared<BitCodeAbbrev>();
+    Abbrev->Add(BitCodeAbbrevOp(RECORD_REMARK_STRTAB));
+    Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 6)); // First index
+    Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Blob));   // New strings
+    RecordRemarkStrTabAbbrevID =
+        Bitstream.EmitBlockInfoAbbrev(REMARK_BLOCK_ID, Abbrev);
+  }
 }
 
 void BitstreamRemarkSerializerHelper::setupBlockInfo() {
@@ -267,10 +286,47 @@ void BitstreamRemarkSerializerHelper::emitMetaBlock(
   Bitstream.ExitBlock();
 }
 
+void BitstreamRemarkSerializerHelper::emitRemarkStrTab(const Remark &Remark,
+                                                       StringTable &StrTab) {
+  // Add all the strings first. New strings get consecutive IDs, so they can be
+  // emitted as one blob starting at the first ID that wasn't emitted yet.
+  std::string Buf;
+  auto Add = [&](StringRef Str) {
+    std::pair<unsigned, StringRef> Entry = StrTab.add(Str);
+    if (Entry.first < NumInlinedStrings)
+      return;
+    Buf += Entry.second;
+    Buf += '\0';
+    ++NumInlinedStrings;
+  };
+  uint64_t FirstIdx = NumInlinedStrings;
+  Add(Remark.RemarkName);
+  Add(Remark.PassName);
+  Add(Remark.FunctionName);
+  if (Remark.Loc)
+    Add(Remark.Loc->SourceFilePath);
+  for (const Argument &Arg : Remark.Args) {
+    Add(Arg.Key);
+    Add(Arg.Val);
+    if (Arg.Loc)
+      Add(Arg.Loc->SourceFilePath);
+  }
+  if (Buf.empty())
+    return;
+
+  R.clear();
+  R.push_back(RECORD_REMARK_STRTAB);
+  R.push_back(FirstIdx);
+  Bitstream.EmitRecordWithBlob(RecordRemarkStrTabAbbrevID, R, Buf);
+}
+
 void BitstreamRemarkSerializerHelper::emitRemarkBlock(const Remark &Remark,
                                                       StringTable &StrTab) {
   Bitstream.EnterSubblock(REMARK_BLOCK_ID, 4);
 
+  if (InlineStrTab)
+    emitRemarkStrTab(Remark, StrTab);
+
   R.clear();
   R.push_back(RECORD_REMARK_HEADER);
   R.push_back(static_cast<uint64_t>(Remark.RemarkType));
@@ -335,6 +391,7 @@ BitstreamRemarkSerializer::BitstreamRemarkSerializer(raw_ostream &OS,
          "be provided.");
   // We always use a string table with bitstream.
   StrTab.emplace();
+  Helper.InlineStrTab = InlineStringTable;
 }
 
 BitstreamRemarkSerializer::BitstreamRemarkSerializer(raw_ostream &OS,
@@ -34,11 +34,13 @@ ParsedStringTable::ParsedStringTable(StringRef InBuffer) : Buffer(InBuffer) {
 }
 
 Expected<StringRef> ParsedStringTable::operator[](size_t Index) const {
-  if (Index >= Offsets.size())
+  if (Index >= size())
     return createStringError(
         std::make_error_code(std::errc::invalid_argument),
-        "String with index %u is out of bounds (size = %u).", Index,
-        Offsets.size());
+        "String with index %u is out of bounds (size = %u).", Index, size());
+
+  if (Index >= Offsets.size())
+    return Appended[Index - Offsets.size()];
 
   size_t Offset = Offsets[Index];
   // If it's the last offset, we can't use the next offset to know the size of
@@ -48,6 +50,14 @@ Expected<StringRef> ParsedStringTable::operator[](size_t Index) const {
   return StringRef(Buffer.data() + Offset, NextOffset - Offset - 1);
 }
 
+void ParsedStringTable::append(StringRef InBuffer) {
+  while (!InBuffer.empty()) {
+    std::pair<StringRef, StringRef> Split = InBuffer.split('\0');
+    Appended.push_back(Split.first);
+    InBuffer = Split.second;
+  }
+}
+
 Expected<std::unique_ptr<RemarkParser>>
 llvm::remarks::createRemarkParser(Format ParserFormat, StringRef Buf) {
   switch (ParserFormat) {
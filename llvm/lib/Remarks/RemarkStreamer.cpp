@@ -38,14 +38,43 @@ Error RemarkStreamer::setFilter(StringRef Filter) {
     return createStringError(std::make_error_code(std::errc::invalid_argument),
                              RegexError.data());
   PassFilter = std::move(R);
+  PassFilterCache.clear();
   return Error::success();
 }
 
 bool RemarkStreamer::matchesFilter(StringRef Str) {
-  if (PassFilter)
-    return PassFilter->match(Str);
   // No filter means all strings pass.
-  return true;
+  if (!PassFilter)
+    return true;
+  auto [It, Inserted] = PassFilterCache.try_emplace(Str, false);
+  if (Inserted)
+    It->second = PassFilter->match(Str);
+  return It->second;
+}
+
+Error RemarkStreamer::setTypeFilter(StringRef Filter) {
+  unsigned Mask = 0;
+  SmallVector<StringRef, 4> Names;
+  Filter.split(Names, ',', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  for (StringRef Name : Names) {
+    Name = Name.trim();
+    bool Found = false;
+    for (unsigned I = static_cast<unsigned>(Type::First),
+                  E = static_cast<unsigned>(Type::Last);
+         I <= E; ++I) {
+      if (typeToStr(static_cast<Type>(I)).equals_insensitive(Name)) {
+        Mask |= 1U << I;
+        Found = true;
+        break;
+      }
+    }
+    if (!Found)
+      return createStringError(
+          std::make_error_code(std::errc::invalid_argument),
+          "unknown remark type '%s'", Name.str().c_str());
+  }
+  TypeFilter = Mask;
+  return Error::success();
 }
 
 bool RemarkStreamer::needsSection() const {
@@ -9,14 +9,19 @@
 // This file implements the localCache function, which simplifies creating,
 // adding to, and querying a local file system cache. localCache takes care of
 // periodically pruning older files from the cache using a CachePruningPolicy.
+// RemoteFileCache puts such a local cache in front of a RemoteCacheStore.
 //
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/Caching.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
+#include <future>
+#include <mutex>
 
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
 #include <unistd.h>
@@ -168,3 +173,197 @@ Expected<FileCache> llvm::localCache(const Twine &CacheNameRef,
     };
   };
 }
+
+RemoteCacheStore::~RemoteCacheStore() = default;
+
+struct RemoteFileCache::Impl {
+  Impl(FileCache Local, SmallString<64> TempFilePrefix,
+       SmallString<64> CacheDirectoryPath,
+       std::unique_ptr<RemoteCacheStore> Store, AddBufferFn AddBuffer,
+       unsigned Threads)
+      : Local(std::move(Local)), TempFilePrefix(std::move(TempFilePrefix)),
+        CacheDirectoryPath(std::move(CacheDirectoryPath)),
+        Store(std::move(Store)), AddBuffer(std::move(AddBuffer)),
+        Pool(hardware_concurrency(Threads)) {}
+
+  // Must match the file name used by localCache.
+  SmallString<64> getEntryPath(StringRef Key) const {
+    SmallString<64> EntryPath;
+    sys::path::append(EntryPath, CacheDirectoryPath, "llvmcache-" + Key);
+    return EntryPath;
+  }
+
+  // Returns the store's entry for Key, or nullptr on a miss or an error.
+  std::unique_ptr<MemoryBuffer> fetch(StringRef Key) {
+    Expected<std::unique_ptr<MemoryBuffer>> MBOrErr = Store->fetch(Key);
+    if (!MBOrErr) {
+      consumeError(MBOrErr.takeError());
+      return nullptr;
+    }
+    return std::move(*MBOrErr);
+  }
+
+  // Atomically adds Data to the local cache directory.
+  Error addToLocal(StringRef Key, MemoryBufferRef Data) {
+    if (std::error_code EC = sys::fs::create_directories(
+            CacheDirectoryPath, /*IgnoreExisting=*/true))
+      return createStringError(EC, Twine("can't create cache directory ") +
+                                       CacheDirectoryPath + ": " +
+                                       EC.message());
+    SmallString<64> TempFilenameModel;
+    sys::path::append(TempFilenameModel, CacheDirectoryPath,
+                      TempFilePrefix + "-%%%%%%.tmp.o");
+    Expected<sys::fs::TempFile> Temp = sys::fs::TempFile::create(
+        TempFilenameModel, sys::fs::owner_read | sys::fs::owner_write);
+    if (!Temp)
+      return Temp.takeError();
+    {
+      raw_fd_ostream OS(Temp->FD, /*shouldClose=*/false);
+      OS << Data.getBuffer();
+      OS.flush();
+      if (OS.has_error()) {
+        std::error_code EC = OS.error();
+        OS.clear_error();
+        consumeError(Temp->discard());
+        return errorCodeToError(EC);
+      }
+    }
+    return Temp->keep(getEntryPath(Key));
+  }
+
+  // Fetches the entry for Key into the local cache, unless it is already
+  // there or being fetched.
+  void prefetch(StringRef Key) {
+    if (sys::fs::exists(getEntryPath(Key)))
+      return;
+    std::lock_guard<std::mutex> Lock(Mu);
+    if (InFlight.count(Key))
+      return;
+    std::string KeyStr = Key.str();
+    InFlight[Key] = Pool.async([this, KeyStr] {
+      if (std::unique_ptr<MemoryBuffer> MB = fetch(KeyStr))
+        consumeError(addToLocal(KeyStr, *MB));
+    });
+  }
+
+  // Waits for a pending prefetch of Key, if there is one.
+  void waitForPrefetch(StringRef Key) {
+    std::shared_future<void> Future;
+    {
+      std::lock_guard<std::mutex> Lock(Mu);
+      auto It = InFlight.find(Key);
+      if (It == InFlight.end())
+        return;
+      Future = It->second;
+    }
+    Future.wait();
+    std::lock_guard<std::mutex> Lock(Mu);
+    InFlight.erase(Key);
+  }
+
+  // Uploads the committed local cache file Path as the entry for Key.
+  void upload(std::string Key, std::string Path) {
+    Pool.async([this, Key = std::move(Key), Path = std::move(Path)] {
+      ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+          MemoryBuffer::getFile(Path, /*IsText=*/false,
+                                /*RequiresNullTerminator=*/false);
+      // The pruner may already have removed the file.
+      if (MBOrErr)
+        consumeError(Store->upload(Key, **MBOrErr));
+    });
+  }
+
+  // Hands the stream of a local cache entry to the client. Once the client is
+  // done and the entry has been committed locally, schedules its upload.
+  struct UploadingStream : CachedFileStream {
+    std::unique_ptr<CachedFileStream> LocalStream;
+    Impl &I;
+    std::string Key;
+
+    UploadingStream(std::unique_ptr<CachedFileStream> LocalStream, Impl &I,
+                    std::string Key)
+        : CachedFileStream(std::move(LocalStream->OS),
+                           LocalStream->ObjectPathName),
+          LocalStream(std::move(LocalStream)), I(I), Key(std::move(Key)) {}
+
+    ~UploadingStream() {
+      LocalStream->OS = std::move(OS);
+      // Destroying the local stream commits the entry and adds it to the link.
+      LocalStream.reset();
+      I.upload(std::move(Key), std::move(ObjectPathName));
+    }
+  };
+
+  FileCache Local;
+  SmallString<64> TempFilePrefix, CacheDirectoryPath;
+  std::unique_ptr<RemoteCacheStore> Store;
+  AddBufferFn AddBuffer;
+
+  std::mutex Mu;
+  StringMap<std::shared_future<void>> InFlight;
+
+  // Declared last so that it is destroyed, and waits for the tasks that use
+  // the members above, first.
+  DefaultThreadPool Pool;
+};
+
+Expected<std::unique_ptr<RemoteFileCache>> RemoteFileCache::create(
+    const Twine &CacheNameRef, const Twine &TempFilePrefixRef,
+    const Twine &CacheDirectoryPathRef,
+    std::unique_ptr<RemoteCacheStore> Store, AddBufferFn AddBuffer,
+    unsigned Threads) {
+  Expected<FileCache> Local = localCache(CacheNameRef, TempFilePrefixRef,
+                                         CacheDirectoryPathRef, AddBuffer);
+  if (!Local)
+    return Local.takeError();
+  SmallString<64> TempFilePrefix, CacheDirectoryPath;
+  TempFilePrefixRef.toVector(TempFilePrefix);
+  CacheDirectoryPathRef.toVector(CacheDirectoryPath);
+  return std::unique_ptr<RemoteFileCache>(
+      new RemoteFileCache(std::make_shared<Impl>(
+          std::move(*Local), std::move(TempFilePrefix),
+          std::move(CacheDirectoryPath), std::move(Store),
+          std::move(AddBuffer), Threads)));
+}
+
+RemoteFileCache::~RemoteFileCache() { wait(); }
+
+void RemoteFileCache::wait() { I->Pool.wait(); }
+
+void RemoteFileCache::prefetch(ArrayRef<std::string> Keys) {
+  for (const std::string &Key : Keys)
+    I->prefetch(Key);
+}
+
+FileCache RemoteFileCache::getCache() const {
+  std::shared_ptr<Impl> I = this->I;
+  return [I](unsigned Task, StringRef Key,
+             const Twine &ModuleName) -> Expected<AddStreamFn> {
+    I->waitForPrefetch(Key);
+    Expected<AddStreamFn> AddStreamOrErr = I->Local(Task, Key, ModuleName);
+    // Errors and local hits need nothing from the store.
+    if (!AddStreamOrErr || !*AddStreamOrErr)
+      return AddStreamOrErr;
+    AddStreamFn LocalAddStream = std::move(*AddStreamOrErr);
+
+    if (std::unique_ptr<MemoryBuffer> MB = I->fetch(Key)) {
+      // Keep a copy in the local cache for the next lookup. If that fails the
+      // fetched entry can still be used.
+      consumeError(I->addToLocal(Key, *MB));
+      I->AddBuffer(Task, ModuleName, std::move(MB));
+      return AddStreamFn();
+    }
+
+    std::string KeyStr = Key.str();
+    return [I, LocalAddStream = std::move(LocalAddStream),
+            KeyStr](unsigned Task, const Twine &ModuleName)
+               -> Expected<std::unique_ptr<CachedFileStream>> {
+      Expected<std::unique_ptr<CachedFileStream>> StreamOrErr =
+          LocalAddStream(Task, ModuleName);
+      if (!StreamOrErr)
+        return StreamOrErr.takeError();
+      return std::make_unique<Impl::UploadingStream>(std::move(*StreamOrErr),
+                                                     *I, KeyStr);
+    };
+  };
+}
@@ -17,6 +17,10 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
+#include <algorithm>
+#include <cstring>
 #if LLVM_ENABLE_ZLIB
 #include <zlib.h>
 #endif
@@ -50,7 +54,7 @@ void compression::compress(Params P, ArrayRef<uint8_t> Input,
     zlib::compress(Input, Output, P.level);
     break;
   case compression::Format::Zstd:
-    zstd::compress(Input, Output, P.level, P.zstdEnableLdm);
+    zstd::compressParallel(Input, Output, P.level, P.zstdEnableLdm);
     break;
   }
 }
@@ -61,7 +65,7 @@ Error compression::decompress(DebugCompressionType T, ArrayRef<uint8_t> Input,
   case compression::Format::Zlib:
     return zlib::decompress(Input, Output, UncompressedSize);
   case compression::Format::Zstd:
-    return zstd::decompress(Input, Output, UncompressedSize);
+    return zstd::decompressParallel(Input, Output, UncompressedSize);
   }
   llvm_unreachable("");
 }
@@ -73,7 +77,7 @@ Error compression::decompress(compression::Format F, ArrayRef<uint8_t> Input,
   case compression::Format::Zlib:
     return zlib::decompress(Input, Output, UncompressedSize);
   case compression::Format::Zstd:
-    return zstd::decompress(Input, Output, UncompressedSize);
+    return zstd::decompressParallel(Input, Output, UncompressedSize);
   }
   llvm_unreachable("");
 }
@@ -224,6 +228,89 @@ Error zstd::decompress(ArrayRef<uint8_t> Input,
   return E;
 }
 
+void zstd::compressParallel(ArrayRef<uint8_t> Input,
+                            SmallVectorImpl<uint8_t> &CompressedBuffer,
+                            int Level, bool EnableLdm, size_t ChunkSize) {
+  assert(ChunkSize && "chunk size must be positive");
+  if (EnableLdm || Input.size() <= ChunkSize)
+    return zstd::compress(Input, CompressedBuffer, Level, EnableLdm);
+
+  // Compress each chunk into its own buffer, then concatenate the frames in
+  // order so that the output is deterministic.
+  size_t NumChunks = divideCeil(Input.size(), ChunkSize);
+  SmallVector<SmallVector<uint8_t, 0>, 0> Frames(NumChunks);
+  parallelFor(0, NumChunks, [&](size_t I) {
+    size_t Begin = I * ChunkSize;
+    size_t Size = std::min(ChunkSize, Input.size() - Begin);
+    zstd::compress(Input.slice(Begin, Size), Frames[I], Level);
+  });
+
+  size_t CompressedSize = 0;
+  for (const SmallVector<uint8_t, 0> &Frame : Frames)
+    CompressedSize += Frame.size();
+  CompressedBuffer.resize_for_overwrite(CompressedSize);
+  uint8_t *Out = CompressedBuffer.data();
+  for (const SmallVector<uint8_t, 0> &Frame : Frames) {
+    memcpy(Out, Frame.data(), Frame.size());
+    Out += Frame.size();
+  }
+}
+
+Error zstd::decompressParallel(ArrayRef<uint8_t> Input, uint8_t *Output,
+                               size_t &UncompressedSize) {
+  struct Frame {
+    ArrayRef<uint8_t> Data;
+    size_t Offset;
+    size_t Size;
+  };
+
+  // Find the frame boundaries and where each frame starts in the output. Let
+  // the serial path handle anything unusual, including reporting errors.
+  SmallVector<Frame, 0> Frames;
+  size_t Offset = 0;
+  for (ArrayRef<uint8_t> Rest = Input; !Rest.empty();) {
+    size_t FrameSize = ZSTD_findFrameCompressedSize(Rest.data(), Rest.size());
+    unsigned long long ContentSize =
+        ZSTD_getFrameContentSize(Rest.data(), Rest.size());
+    if (ZSTD_isError(FrameSize) || ContentSize == ZSTD_CONTENTSIZE_UNKNOWN ||
+        ContentSize == ZSTD_CONTENTSIZE_ERROR ||
+        ContentSize > UncompressedSize - Offset)
+      return zstd::decompress(Input, Output, UncompressedSize);
+    Frames.push_back({Rest.take_front(FrameSize), Offset, size_t(ContentSize)});
+    Offset += ContentSize;
+    Rest = Rest.drop_front(FrameSize);
+  }
+  if (Frames.size() < 2)
+    return zstd::decompress(Input, Output, UncompressedSize);
+
+  SmallVector<size_t, 0> Results(Frames.size());
+  parallelFor(0, Frames.size(), [&](size_t I) {
+    const Frame &F = Frames[I];
+    Results[I] = ::ZSTD_decompress(Output + F.Offset, F.Size, F.Data.data(),
+                                   F.Data.size());
+  });
+
+  UncompressedSize = Offset;
+  // Tell MemorySanitizer that zstd output buffer is fully initialized.
+  // This avoids a false report when running LLVM with uninstrumented ZLib.
+  __msan_unpoison(Output, UncompressedSize);
+  for (size_t Res : Results)
+    if (ZSTD_isError(Res))
+      return make_error<StringError>(ZSTD_getErrorName(Res),
+                                     inconvertibleErrorCode());
+  return Error::success();
+}
+
+Error zstd::decompressParallel(ArrayRef<uint8_t> Input,
+                               SmallVectorImpl<uint8_t> &Output,
+                               size_t UncompressedSize) {
+  Output.resize_for_overwrite(UncompressedSize);
+  Error E = zstd::decompressParallel(Input, Output.data(), UncompressedSize);
+  if (UncompressedSize < Output.size())
+    Output.truncate(UncompressedSize);
+  return E;
+}
+
 #else
 bool zstd::isAvailable() { return false; }
 void zstd::compress(ArrayRef<uint8_t> Input,
@@ -240,4 +327,18 @@ Error zstd::decompress(ArrayRef<uint8_t> Input,
                        size_t UncompressedSize) {
   llvm_unreachable("zstd::decompress is unavailable");
 }
+void zstd::compressParallel(ArrayRef<uint8_t> Input,
+                            SmallVectorImpl<uint8_t> &CompressedBuffer,
+                            int Level, bool EnableLdm, size_t ChunkSize) {
+  llvm_unreachable("zstd::compressParallel is unavailable");
+}
+Error zstd::decompressParallel(ArrayRef<uint8_t> Input, uint8_t *Output,
+                               size_t &UncompressedSize) {
+  llvm_unreachable("zstd::decompressParallel is unavailable");
+}
+Error zstd::decompressParallel(ArrayRef<uint8_t> Input,
+                               SmallVectorImpl<uint8_t> &Output,
+                               size_t UncompressedSize) {
+  llvm_unreachable("zstd::decompressParallel is unavailable");
+}
 #endif
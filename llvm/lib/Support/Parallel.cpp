@@ -9,8 +9,10 @@
 #include "llvm/Support/Parallel.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/Threading.h"
 
+#include <algorithm>
 #include <atomic>
 #include <deque>
 #include <future>
@@ -40,17 +42,149 @@ class Executor {
 public:
   virtual ~Executor() = default;
   virtual void add(std::function<void()> func, bool Sequential = false) = 0;
+  /// Run queued tasks on the calling worker thread until \p Done returns true
+  /// or no task is left to pick up.
+  virtual void runTasksUntil(function_ref<bool()> Done) = 0;
   virtual size_t getThreadCount() const = 0;
 
   static Executor *getDefaultExecutor();
 };
 
-/// An implementation of an Executor that runs closures on a thread pool
-///   in filo order.
+/// A unit of work queued on the executor.
+struct Task {
+  std::function<void()> F;
+};
+
+/// A single-owner, multi-thief work-stealing deque (Chase and Lev, "Dynamic
+/// Circular Work-Stealing Deque").
+///
+/// Only the owning worker may call push() and pop(), which operate on the
+/// bottom end in LIFO order. Any thread may call steal(), which takes from the
+/// top end. Retired buffers are kept alive until the deque is destroyed, as a
+/// thief may still be reading from them.
+class WorkStealingQueue {
+  struct Buffer {
+    explicit Buffer(int64_t Capacity)
+        : Mask(Capacity - 1), Slots(new std::atomic<Task *>[Capacity]) {
+      assert(isPowerOf2_64(Capacity) && "capacity must be a power of two");
+    }
+
+    int64_t capacity() const { return Mask + 1; }
+    Task *get(int64_t I) const {
+      return Slots[I & Mask].load(std::memory_order_relaxed);
+    }
+    void put(int64_t I, Task *T) {
+      Slots[I & Mask].store(T, std::memory_order_relaxed);
+    }
+
+    const int64_t Mask;
+    std::unique_ptr<std::atomic<Task *>[]> Slots;
+  };
+
+public:
+  WorkStealingQueue() {
+    Buffers.push_back(std::make_unique<Buffer>(InitialCapacity));
+    Buf.store(Buffers.back().get(), std::memory_order_relaxed);
+  }
+
+  ~WorkStealingQueue() {
+    while (Task *T = pop())
+      delete T;
+  }
+
+  void push(Task *T) {
+    int64_t B = Bottom.load(std::memory_order_relaxed);
+    int64_t Tp = Top.load(std::memory_order_acquire);
+    Buffer *A = Buf.load(std::memory_order_relaxed);
+    if (B - Tp > A->capacity() - 1)
+      A = grow(A, B, Tp);
+    A->put(B, T);
+    // Sequentially consistent so that ThreadPoolExecutor::wakeSleepingWorker()
+    // and a worker going to sleep agree on whether the deque is empty.
+    Bottom.store(B + 1, std::memory_order_seq_cst);
+  }
+
+  Task *pop() {
+    int64_t B = Bottom.load(std::memory_order_relaxed) - 1;
+    Buffer *A = Buf.load(std::memory_order_relaxed);
+    // The store to Bottom and the load of Top must not be reordered, so that
+    // the owner and a thief can't both take the last task. Sequentially
+    // consistent accesses are used rather than fences, which ThreadSanitizer
+    // does not model.
+    Bottom.store(B, std::memory_order_seq_cst);
+    int64_t Tp = Top.load(std::memory_order_seq_cst);
+    if (Tp > B) {
+      // The deque was already empty.
+      Bottom.store(B + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    Task *T = A->get(B);
+    if (Tp == B) {
+      // Last element: race against thieves for it.
+      if (!Top.compare_exchange_strong(Tp, Tp + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed))
+        T = nullptr;
+      Bottom.store(B + 1, std::memory_order_relaxed);
+    }
+    return T;
+  }
+
+  /// Try to take the oldest task. Returns nullptr if the deque is empty or if
+  /// another thread won the race for the task; \p Retry is set in the latter
+  /// case.
+  Task *steal(bool &Retry) {
+    int64_t Tp = Top.load(std::memory_order_seq_cst);
+    int64_t B = Bottom.load(std::memory_order_seq_cst);
+    if (Tp >= B)
+      return nullptr;
+    Buffer *A = Buf.load(std::memory_order_acquire);
+    Task *T = A->get(Tp);
+    if (!Top.compare_exchange_strong(Tp, Tp + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed)) {
+      Retry = true;
+      return nullptr;
+    }
+    return T;
+  }
+
+  bool empty() const {
+    int64_t B = Bottom.load(std::memory_order_seq_cst);
+    int64_t Tp = Top.load(std::memory_order_seq_cst);
+    return Tp >= B;
+  }
+
+private:
+  Buffer *grow(Buffer *Old, int64_t B, int64_t Tp) {
+    Buffers.push_back(std::make_unique<Buffer>(Old->capacity() * 2));
+    Buffer *New = Buffers.back().get();
+    for (int64_t I = Tp; I != B; ++I)
+      New->put(I, Old->get(I));
+    Buf.store(New, std::memory_order_release);
+    return New;
+  }
+
+  static constexpr int64_t InitialCapacity = 256;
+
+  alignas(64) std::atomic<int64_t> Top{0};
+  alignas(64) std::atomic<int64_t> Bottom{0};
+  std::atomic<Buffer *> Buf{nullptr};
+  // Owned by the worker; only grows.
+  std::vector<std::unique_ptr<Buffer>> Buffers;
+};
+
+/// An implementation of an Executor that runs closures on a thread pool.
+///
+/// Every worker owns a work-stealing deque. Tasks spawned from a worker are
+/// pushed onto its own deque and run in LIFO order, which keeps nested
+/// parallelism local to the spawning thread; idle workers steal the oldest
+/// tasks from other workers. Tasks spawned from threads outside of the pool go
+/// to a shared queue, from which workers take them in batches. Sequential
+/// tasks are kept in their own queue and run one at a time in spawn order.
 class ThreadPoolExecutor : public Executor {
 public:
   explicit ThreadPoolExecutor(ThreadPoolStrategy S = hardware_concurrency()) {
     ThreadCount = S.compute_thread_count();
+    Queues = std::make_unique<WorkStealingQueue[]>(ThreadCount);
     // Spawn all but one of the threads in another thread as spawning threads
     // can take a while.
     Threads.reserve(ThreadCount);
@@ -89,6 +223,8 @@ public:
         T.detach();
       else
         T.join();
+    for (Task *T : WorkQueue)
+      delete T;
   }
 
   struct Creator {
@@ -99,54 +235,180 @@ public:
   };
 
   void add(std::function<void()> F, bool Sequential = false) override {
+    if (Sequential) {
+      {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        WorkQueueSequential.emplace_front(std::move(F));
+        ++NumSequentialTasks;
+      }
+      Cond.notify_one();
+      return;
+    }
+
+    Task *T = new Task{std::move(F)};
+    if (isWorkerThread()) {
+      Queues[threadIndex].push(T);
+      wakeSleepingWorker();
+      return;
+    }
+
     {
       std::lock_guard<std::mutex> Lock(Mutex);
-      if (Sequential)
-        WorkQueueSequential.emplace_front(std::move(F));
-      else
-        WorkQueue.emplace_back(std::move(F));
+      WorkQueue.push_back(T);
+      ++NumSharedTasks;
     }
     Cond.notify_one();
   }
 
+  void runTasksUntil(function_ref<bool()> Done) override {
+    if (!isWorkerThread())
+      return;
+    // Any task is run, not only the ones of the group being waited for: a task
+    // of that group may sit below a task of another group on this deque, and
+    // with no idle worker to steal it, blocking would deadlock. This relies on
+    // tasks only waiting for groups they created themselves: a task run here
+    // never waits on the task below it on the stack, so no cycle can form.
+    while (!Done()) {
+      Task *T = findTask(threadIndex);
+      if (!T)
+        return;
+      run(T);
+    }
+  }
+
   size_t getThreadCount() const override { return ThreadCount; }
 
 private:
+  bool isWorkerThread() const { return threadIndex < ThreadCount; }
+
   bool hasSequentialTasks() const {
-    return !WorkQueueSequential.empty() && !SequentialQueueIsLocked;
+    return NumSequentialTasks != 0 && !SequentialQueueIsLocked;
   }
 
-  bool hasGeneralTasks() const { return !WorkQueue.empty(); }
+  bool hasGeneralTasks() const {
+    if (NumSharedTasks != 0)
+      return true;
+    for (unsigned I = 0; I < ThreadCount; ++I)
+      if (!Queues[I].empty())
+        return true;
+    return false;
+  }
+
+  void wakeSleepingWorker() {
+    // Pairs with the increment of NumSleeping in work(): either the sleeping
+    // worker sees the new task, or we see the sleeper and notify it.
+    if (NumSleeping.load(std::memory_order_seq_cst) == 0)
+      return;
+    { std::lock_guard<std::mutex> Lock(Mutex); }
+    Cond.notify_one();
+  }
+
+  static void run(Task *T) {
+    T->F();
+    delete T;
+  }
+
+  bool runSequentialTask() {
+    if (!hasSequentialTasks())
+      return false;
+    std::unique_lock<std::mutex> Lock(Mutex);
+    if (!hasSequentialTasks())
+      return false;
+    SequentialQueueIsLocked = true;
+    auto Fn = std::move(WorkQueueSequential.back());
+    WorkQueueSequential.pop_back();
+    --NumSequentialTasks;
+    Lock.unlock();
+    Fn();
+    SequentialQueueIsLocked = false;
+    return true;
+  }
+
+  /// Take a batch of tasks from the shared queue. The first one is returned
+  /// and the rest are moved to the deque of worker \p ThreadID, where other
+  /// workers can steal them without going through the shared lock.
+  Task *takeSharedTasks(unsigned ThreadID) {
+    if (NumSharedTasks == 0)
+      return nullptr;
+    std::unique_lock<std::mutex> Lock(Mutex);
+    if (WorkQueue.empty())
+      return nullptr;
+    size_t BatchSize =
+        std::clamp<size_t>(WorkQueue.size() / ThreadCount, 1, MaxBatchSize);
+    // Preserve the LIFO order of the shared queue: the most recent task is
+    // run first and the remaining ones are pushed oldest-first.
+    auto BatchBegin = WorkQueue.end() - BatchSize;
+    Task *First = WorkQueue.back();
+    for (auto It = BatchBegin, E = WorkQueue.end() - 1; It != E; ++It)
+      Queues[ThreadID].push(*It);
+    WorkQueue.erase(BatchBegin, WorkQueue.end());
+    NumSharedTasks -= BatchSize;
+    Lock.unlock();
+    if (BatchSize > 1)
+      wakeSleepingWorker();
+    return First;
+  }
+
+  Task *stealTask(unsigned ThreadID) {
+    // Each worker walks its victims starting at a pseudo-random position to
+    // spread thieves over the pool.
+    static thread_local uint32_t Seed = 0;
+    if (Seed == 0)
+      Seed = ThreadID * 2654435761u + 1;
+    bool Retry;
+    do {
+      Retry = false;
+      Seed ^= Seed << 13;
+      Seed ^= Seed >> 17;
+      Seed ^= Seed << 5;
+      for (unsigned I = 0, Start = Seed % ThreadCount; I < ThreadCount; ++I) {
+        unsigned Victim = (Start + I) % ThreadCount;
+        if (Victim == ThreadID)
+          continue;
+        if (Task *T = Queues[Victim].steal(Retry))
+          return T;
+      }
+    } while (Retry && !Stop);
+    return nullptr;
+  }
+
+  Task *findTask(unsigned ThreadID) {
+    if (Task *T = Queues[ThreadID].pop())
+      return T;
+    if (Task *T = takeSharedTasks(ThreadID))
+      return T;
+    return stealTask(ThreadID);
+  }
 
   void work(ThreadPoolStrategy S, unsigned ThreadID) {
     threadIndex = ThreadID;
     S.apply_thread_strategy(ThreadID);
-    while (true) {
+    while (!Stop) {
+      if (runSequentialTask())
+        continue;
+      if (Task *T = findTask(ThreadID)) {
+        run(T);
+        continue;
+      }
+
       std::unique_lock<std::mutex> Lock(Mutex);
+      NumSleeping.fetch_add(1, std::memory_order_seq_cst);
       Cond.wait(Lock, [&] {
         return Stop || hasGeneralTasks() || hasSequentialTasks();
       });
-      if (Stop)
-        break;
-      bool Sequential = hasSequentialTasks();
-      if (Sequential)
-        SequentialQueueIsLocked = true;
-      else
-        assert(hasGeneralTasks());
-
-      auto &Queue = Sequential ? WorkQueueSequential : WorkQueue;
-      auto Task = std::move(Queue.back());
-      Queue.pop_back();
-      Lock.unlock();
-      Task();
-      if (Sequential)
-        SequentialQueueIsLocked = false;
+      NumSleeping.fetch_sub(1, std::memory_order_relaxed);
     }
   }
 
+  static constexpr size_t MaxBatchSize = 64;
+
   std::atomic<bool> Stop{false};
   std::atomic<bool> SequentialQueueIsLocked{false};
-  std::deque<std::function<void()>> WorkQueue;
+  std::atomic<size_t> NumSequentialTasks{0};
+  std::atomic<size_t> NumSharedTasks{0};
+  std::atomic<unsigned> NumSleeping{0};
+  std::unique_ptr<WorkStealingQueue[]> Queues;
+  std::deque<Task *> WorkQueue;
   std::deque<std::function<void()>> WorkQueueSequential;
   std::mutex Mutex;
   std::condition_variable Cond;
@@ -188,26 +450,29 @@ size_t getThreadCount() {
 }
 #endif
 
-// Latch::sync() called by the dtor may cause one thread to block. If is a dead
-// lock if all threads in the default executor are blocked. To prevent the dead
-// lock, only allow the root TaskGroup to run tasks parallelly. In the scenario
-// of nested parallel_for_each(), only the outermost one runs parallelly.
+// Nested TaskGroups run in parallel too. A worker thread which waits for a
+// TaskGroup keeps running queued tasks until the group is done, so it never
+// blocks on work that only it could pick up. It only blocks once its own deque
+// is empty and nothing is left to steal, at which point the remaining tasks of
+// the group are running on other workers.
 TaskGroup::TaskGroup()
 #if LLVM_ENABLE_THREADS
-    : Parallel((parallel::strategy.ThreadsRequested != 1) &&
-               (threadIndex == UINT_MAX)) {}
+    : Parallel(parallel::strategy.ThreadsRequested != 1) {}
 #else
     : Parallel(false) {}
 #endif
 TaskGroup::~TaskGroup() {
   // We must ensure that all the workloads have finished before decrementing the
   // instances count.
-  L.sync();
+  sync();
 }
 
 void TaskGroup::spawn(std::function<void()> F, bool Sequential) {
 #if LLVM_ENABLE_THREADS
-  if (Parallel) {
+  // Sequential tasks of a group living on a worker thread run inline, in spawn
+  // order. Queuing them could leave every worker blocked in sync() waiting for
+  // the shared sequential queue.
+  if (Parallel && !(Sequential && threadIndex != UINT_MAX)) {
     L.inc();
     detail::Executor::getDefaultExecutor()->add(
         [&, F = std::move(F)] {
@@ -221,6 +486,15 @@ void TaskGroup::spawn(std::function<void()> F, bool Sequential) {
   F();
 }
 
+void TaskGroup::sync() const {
+#if LLVM_ENABLE_THREADS
+  if (Parallel && threadIndex != UINT_MAX)
+    detail::Executor::getDefaultExecutor()->runTasksUntil(
+        [&] { return L.isDone(); });
+#endif
+  L.sync();
+}
+
 } // namespace parallel
 } // namespace llvm
 
@@ -11,12 +11,61 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/bit.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/ReverseIteration.h"
 #include "llvm/Support/xxhash.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 using namespace llvm;
 
+// The buckets are probed in aligned groups of GroupSize. Each bucket has a
+// control byte, stored after the hash array: zero for an empty bucket,
+// CtrlDeleted for a tombstone, and otherwise the top seven bits of the hash
+// with the high bit set. A whole group of control bytes is compared against the tag of the
+// key at once, so most probes never touch the hash or the bucket pointers of
+// non-matching buckets.
+static constexpr unsigned GroupSize = 16;
+static constexpr uint8_t CtrlEmpty = 0;
+static constexpr uint8_t CtrlDeleted = 1;
+
+static inline uint8_t getCtrlTag(uint32_t FullHashValue) {
+  return static_cast<uint8_t>((FullHashValue >> 25) | 0x80);
+}
+
+/// Return a mask with bit I set when \p Ctrl[I] equals \p Tag.
+static inline uint32_t matchGroup(const uint8_t *Ctrl, uint8_t Tag) {
+#if defined(__SSE2__)
+  __m128i Group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Ctrl));
+  return static_cast<uint32_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(Group, _mm_set1_epi8((char)Tag))));
+#else
+  uint32_t Mask = 0;
+  for (unsigned I = 0; I != GroupSize; ++I)
+    Mask |= uint32_t(Ctrl[I] == Tag) << I;
+  return Mask;
+#endif
+}
+
+/// Return a mask with bit I set when \p Ctrl[I] is empty or a tombstone.
+static inline uint32_t matchGroupFree(const uint8_t *Ctrl) {
+#if defined(__SSE2__)
+  // Full buckets are the only ones with the sign bit set.
+  __m128i Group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Ctrl));
+  return static_cast<uint32_t>(~_mm_movemask_epi8(Group)) & 0xFFFF;
+#else
+  uint32_t Mask = 0;
+  for (unsigned I = 0; I != GroupSize; ++I)
+    Mask |= uint32_t(!(Ctrl[I] & 0x80)) << I;
+  return Mask;
+#endif
+}
+
 /// Returns the number of buckets to allocate to ensure that the DenseMap can
 /// accommodate \p NumEntries without need to grow().
 static inline unsigned getMinBucketToReserveForEntries(unsigned NumEntries) {
@@ -29,8 +78,9 @@ static inline unsigned getMinBucketToReserveForEntries(unsigned NumEntries) {
 }
 
 static inline StringMapEntryBase **createTable(unsigned NewNumBuckets) {
-  auto **Table = static_cast<StringMapEntryBase **>(safe_calloc(
-      NewNumBuckets + 1, sizeof(StringMapEntryBase **) + sizeof(unsigned)));
+  auto **Table = static_cast<StringMapEntryBase **>(
+      safe_calloc(NewNumBuckets + 1, sizeof(StringMapEntryBase **) +
+                                         sizeof(unsigned) + sizeof(uint8_t)));
 
   // Allocate one extra bucket, set it to look filled so the iterators stop at
   // end.
@@ -43,6 +93,18 @@ static inline unsigned *getHashTable(StringMapEntryBase **TheTable,
   return reinterpret_cast<unsigned *>(TheTable + NumBuckets + 1);
 }
 
+static inline uint8_t *getCtrlTable(StringMapEntryBase **TheTable,
+                                    unsigned NumBuckets) {
+  return reinterpret_cast<uint8_t *>(getHashTable(TheTable, NumBuckets) +
+                                     NumBuckets);
+}
+
+/// Return the first group to probe for \p FullHashValue.
+static inline unsigned getFirstGroup(uint32_t FullHashValue,
+                                     unsigned NumBuckets) {
+  return FullHashValue & (NumBuckets - 1) & ~(GroupSize - 1);
+}
+
 uint32_t StringMapImpl::hash(StringRef Key) { return xxh3_64bits(Key); }
 
 StringMapImpl::StringMapImpl(unsigned InitSize, unsigned itemSize) {
@@ -68,7 +130,7 @@ void StringMapImpl::init(unsigned InitSize) {
   assert((InitSize & (InitSize - 1)) == 0 &&
          "Init Size must be a power of 2 or zero!");
 
-  unsigned NewNumBuckets = InitSize ? InitSize : 16;
+  unsigned NewNumBuckets = std::max(InitSize, GroupSize);
   NumItems = 0;
   NumTombstones = 0;
 
@@ -93,51 +155,55 @@ unsigned StringMapImpl::LookupBucketFor(StringRef Name,
     init(16);
   if (shouldReverseIterate())
     FullHashValue = ~FullHashValue;
-  unsigned BucketNo = FullHashValue & (NumBuckets - 1);
   unsigned *HashTable = getHashTable(TheTable, NumBuckets);
+  uint8_t *CtrlTable = getCtrlTable(TheTable, NumBuckets);
+  uint8_t Tag = getCtrlTag(FullHashValue);
+  unsigned GroupNo = getFirstGroup(FullHashValue, NumBuckets);
 
-  unsigned ProbeAmt = 1;
+  unsigned ProbeAmt = GroupSize;
   int FirstTombstone = -1;
   while (true) {
-    StringMapEntryBase *BucketItem = TheTable[BucketNo];
-    // If we found an empty bucket, this key isn't in the table yet, return it.
-    if (LLVM_LIKELY(!BucketItem)) {
-      // If we found a tombstone, we want to reuse the tombstone instead of an
-      // empty bucket.  This reduces probing.
-      if (FirstTombstone != -1) {
-        HashTable[FirstTombstone] = FullHashValue;
-        return FirstTombstone;
+    const uint8_t *Ctrl = CtrlTable + GroupNo;
+    for (uint32_t Match = matchGroup(Ctrl, Tag); Match; Match &= Match - 1) {
+      unsigned BucketNo = GroupNo + llvm::countr_zero(Match);
+      // If the full hash value matches, check deeply for a match.  The common
+      // case here is that we are only looking at the control bytes and the
+      // full hash value, not at the items.  This is important for cache
+      // locality.
+      if (LLVM_LIKELY(HashTable[BucketNo] == FullHashValue)) {
+        // Do the comparison like this because Name isn't necessarily
+        // null-terminated!
+        StringMapEntryBase *BucketItem = TheTable[BucketNo];
+        char *ItemStr = (char *)BucketItem + ItemSize;
+        if (Name == StringRef(ItemStr, BucketItem->getKeyLength())) {
+          // We found a match!
+          return BucketNo;
+        }
       }
-
-      HashTable[BucketNo] = FullHashValue;
-      return BucketNo;
     }
 
-    if (BucketItem == getTombstoneVal()) {
-      // Skip over tombstones.  However, remember the first one we see.
-      if (FirstTombstone == -1)
-        FirstTombstone = BucketNo;
-    } else if (LLVM_LIKELY(HashTable[BucketNo] == FullHashValue)) {
-      // If the full hash value matches, check deeply for a match.  The common
-      // case here is that we are only looking at the buckets (for item info
-      // being non-null and for the full hash value) not at the items.  This
-      // is important for cache locality.
-
-      // Do the comparison like this because Name isn't necessarily
-      // null-terminated!
-      char *ItemStr = (char *)BucketItem + ItemSize;
-      if (Name == StringRef(ItemStr, BucketItem->getKeyLength())) {
-        // We found a match!
+    if (uint32_t Free = matchGroupFree(Ctrl)) {
+      uint32_t Empty = Free & matchGroup(Ctrl, CtrlEmpty);
+      // Remember the first tombstone we see.  If the group also has an empty
+      // bucket, this key isn't in the table yet, and we want to reuse the
+      // tombstone instead of an empty bucket.  This reduces probing.
+      if (FirstTombstone == -1 && Free != Empty)
+        FirstTombstone = GroupNo + llvm::countr_zero(Free & ~Empty);
+      if (LLVM_LIKELY(Empty)) {
+        unsigned BucketNo = FirstTombstone != -1
+                                ? FirstTombstone
+                                : GroupNo + llvm::countr_zero(Empty);
+        HashTable[BucketNo] = FullHashValue;
+        CtrlTable[BucketNo] = Tag;
         return BucketNo;
       }
     }
 
-    // Okay, we didn't find the item.  Probe to the next bucket.
-    BucketNo = (BucketNo + ProbeAmt) & (NumBuckets - 1);
-
-    // Use quadratic probing, it has fewer clumping artifacts than linear
-    // probing and has good cache behavior in the common case.
-    ++ProbeAmt;
+    // Okay, we didn't find the item.  Probe to the next group.  Quadratic
+    // probing over groups visits every group since the number of groups is a
+    // power of two.
+    GroupNo = (GroupNo + ProbeAmt) & (NumBuckets - 1);
+    ProbeAmt += GroupSize;
   }
 }
 
@@ -152,39 +218,35 @@ int StringMapImpl::FindKey(StringRef Key, uint32_t FullHashValue) const {
 #endif
   if (shouldReverseIterate())
     FullHashValue = ~FullHashValue;
-  unsigned BucketNo = FullHashValue & (NumBuckets - 1);
   unsigned *HashTable = getHashTable(TheTable, NumBuckets);
+  const uint8_t *CtrlTable = getCtrlTable(TheTable, NumBuckets);
+  uint8_t Tag = getCtrlTag(FullHashValue);
+  unsigned GroupNo = getFirstGroup(FullHashValue, NumBuckets);
 
-  unsigned ProbeAmt = 1;
+  unsigned ProbeAmt = GroupSize;
   while (true) {
-    StringMapEntryBase *BucketItem = TheTable[BucketNo];
-    // If we found an empty bucket, this key isn't in the table yet, return.
-    if (LLVM_LIKELY(!BucketItem))
-      return -1;
-
-    if (BucketItem == getTombstoneVal()) {
-      // Ignore tombstones.
-    } else if (LLVM_LIKELY(HashTable[BucketNo] == FullHashValue)) {
-      // If the full hash value matches, check deeply for a match.  The common
-      // case here is that we are only looking at the buckets (for item info
-      // being non-null and for the full hash value) not at the items.  This
-      // is important for cache locality.
-
-      // Do the comparison like this because NameStart isn't necessarily
-      // null-terminated!
-      char *ItemStr = (char *)BucketItem + ItemSize;
-      if (Key == StringRef(ItemStr, BucketItem->getKeyLength())) {
-        // We found a match!
-        return BucketNo;
+    const uint8_t *Ctrl = CtrlTable + GroupNo;
+    for (uint32_t Match = matchGroup(Ctrl, Tag); Match; Match &= Match - 1) {
+      unsigned BucketNo = GroupNo + llvm::countr_zero(Match);
+      if (LLVM_LIKELY(HashTable[BucketNo] == FullHashValue)) {
+        // Do the comparison like this because NameStart isn't necessarily
+        // null-terminated!
+        StringMapEntryBase *BucketItem = TheTable[BucketNo];
+        char *ItemStr = (char *)BucketItem + ItemSize;
+        if (Key == StringRef(ItemStr, BucketItem->getKeyLength())) {
+          // We found a match!
+          return BucketNo;
+        }
       }
     }
 
-    // Okay, we didn't find the item.  Probe to the next bucket.
-    BucketNo = (BucketNo + ProbeAmt) & (NumBuckets - 1);
+    // If the group has an empty bucket, this key isn't in the table.
+    if (LLVM_LIKELY(matchGroup(Ctrl, CtrlEmpty)))
+      return -1;
 
-    // Use quadratic probing, it has fewer clumping artifacts than linear
-    // probing and has good cache behavior in the common case.
-    ++ProbeAmt;
+    // Okay, we didn't find the item.  Probe to the next group.
+    GroupNo = (GroupNo + ProbeAmt) & (NumBuckets - 1);
+    ProbeAmt += GroupSize;
   }
 }
 
@@ -206,6 +268,7 @@ StringMapEntryBase *StringMapImpl::RemoveKey(StringRef Key) {
 
   StringMapEntryBase *Result = TheTable[Bucket];
   TheTable[Bucket] = getTombstoneVal();
+  getCtrlTable(TheTable, NumBuckets)[Bucket] = CtrlDeleted;
   --NumItems;
   ++NumTombstones;
   assert(NumItems + NumTombstones <= NumBuckets);
@@ -232,6 +295,7 @@ unsigned StringMapImpl::RehashTable(unsigned BucketNo) {
   unsigned NewBucketNo = BucketNo;
   auto **NewTableArray = createTable(NewSize);
   unsigned *NewHashArray = getHashTable(NewTableArray, NewSize);
+  uint8_t *NewCtrlArray = getCtrlTable(NewTableArray, NewSize);
   unsigned *HashTable = getHashTable(TheTable, NumBuckets);
 
   // Rehash all the items into their new buckets.  Luckily :) we already have
@@ -241,17 +305,19 @@ unsigned StringMapImpl::RehashTable(unsigned BucketNo) {
     if (Bucket && Bucket != getTombstoneVal()) {
       // If the bucket is not available, probe for a spot.
       unsigned FullHash = HashTable[I];
-      unsigned NewBucket = FullHash & (NewSize - 1);
-      if (NewTableArray[NewBucket]) {
-        unsigned ProbeSize = 1;
-        do {
-          NewBucket = (NewBucket + ProbeSize++) & (NewSize - 1);
-        } while (NewTableArray[NewBucket]);
+      unsigned GroupNo = getFirstGroup(FullHash, NewSize);
+      unsigned ProbeSize = GroupSize;
+      uint32_t Free;
+      while (!(Free = matchGroupFree(NewCtrlArray + GroupNo))) {
+        GroupNo = (GroupNo + ProbeSize) & (NewSize - 1);
+        ProbeSize += GroupSize;
       }
 
       // Finally found a slot.  Fill it in.
+      unsigned NewBucket = GroupNo + llvm::countr_zero(Free);
       NewTableArray[NewBucket] = Bucket;
       NewHashArray[NewBucket] = FullHash;
+      NewCtrlArray[NewBucket] = getCtrlTag(FullHash);
       if (I == BucketNo)
         NewBucketNo = NewBucket;
     }
@@ -264,3 +330,13 @@ unsigned StringMapImpl::RehashTable(unsigned BucketNo) {
   NumTombstones = 0;
   return NewBucketNo;
 }
+
+void StringMapImpl::copyControlBytes(const StringMapImpl &RHS) {
+  assert(NumBuckets == RHS.NumBuckets && "Tables must have the same size");
+  std::memcpy(getCtrlTable(TheTable, NumBuckets),
+              getCtrlTable(RHS.TheTable, RHS.NumBuckets), NumBuckets);
+}
+
+void StringMapImpl::clearControlBytes() {
+  std::memset(getCtrlTable(TheTable, NumBuckets), CtrlEmpty, NumBuckets);
+}
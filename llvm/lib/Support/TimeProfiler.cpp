@@ -14,16 +14,21 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/STLFunctionalExtras.h"
 #include "llvm/ADT/StringMap.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/Support/JSON.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Threading.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace llvm;
@@ -96,6 +101,115 @@ struct llvm::TimeTraceProfilerEntry {
   }
 };
 
+namespace {
+
+/// Write a completed entry as one (or, for async events, two) trace events.
+void writeTraceEvent(json::OStream &J, const TimeTraceProfilerEntry &E,
+                     sys::Process::Pid Pid, uint64_t Tid,
+                     TimePointType StartTime) {
+  auto StartUs = E.getFlameGraphStartUs(StartTime);
+  auto DurUs = E.getFlameGraphDurUs();
+
+  J.object([&] {
+    J.attribute("pid", Pid);
+    J.attribute("tid", int64_t(Tid));
+    J.attribute("ts", StartUs);
+    if (E.AsyncEvent) {
+      J.attribute("cat", E.Name);
+      J.attribute("ph", "b");
+      J.attribute("id", 0);
+    } else {
+      J.attribute("ph", "X");
+      J.attribute("dur", DurUs);
+    }
+    J.attribute("name", E.Name);
+    if (!E.Detail.empty()) {
+      J.attributeObject("args", [&] { J.attribute("detail", E.Detail); });
+    }
+  });
+
+  if (E.AsyncEvent) {
+    J.object([&] {
+      J.attribute("pid", Pid);
+      J.attribute("tid", int64_t(Tid));
+      J.attribute("ts", StartUs + DurUs);
+      J.attribute("cat", E.Name);
+      J.attribute("ph", "e");
+      J.attribute("id", 0);
+      J.attribute("name", E.Name);
+    });
+  }
+}
+
+void writeMetadataEvent(json::OStream &J, const char *Name,
+                        sys::Process::Pid Pid, uint64_t Tid, StringRef Arg) {
+  J.object([&] {
+    J.attribute("cat", "");
+    J.attribute("pid", Pid);
+    J.attribute("tid", int64_t(Tid));
+    J.attribute("ts", 0);
+    J.attribute("ph", "M");
+    J.attribute("name", Name);
+    J.attributeObject("args", [&] { J.attribute("name", Arg); });
+  });
+}
+
+/// A fixed-size single-producer, single-consumer queue of completed entries.
+/// The owning thread pushes entries as sections end, and the streaming writer
+/// thread drains them.
+class TimeTraceRingBuffer {
+public:
+  TimeTraceRingBuffer(size_t Capacity, uint64_t Tid, StringRef ThreadName)
+      : Slots(new std::optional<TimeTraceProfilerEntry>[Capacity]),
+        Capacity(Capacity), Tid(Tid), ThreadName(ThreadName) {}
+
+  /// Append \p E. Returns false if the buffer is full.
+  bool push(const TimeTraceProfilerEntry &E) {
+    size_t T = Tail.load(std::memory_order_relaxed);
+    size_t H = Head.load(std::memory_order_acquire);
+    if (T - H == Capacity)
+      return false;
+    Slots[T % Capacity].emplace(E);
+    Tail.store(T + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Is the buffer exactly half full? Used to wake up the writer once per fill
+  /// cycle rather than on every push.
+  bool reachedHalfFull() const {
+    return Tail.load(std::memory_order_relaxed) -
+               Head.load(std::memory_order_relaxed) ==
+           Capacity / 2;
+  }
+
+  /// Call \p Fn on every buffered entry and release them.
+  template <typename FnTy> void drain(FnTy Fn) {
+    size_t H = Head.load(std::memory_order_relaxed);
+    size_t T = Tail.load(std::memory_order_acquire);
+    for (; H != T; ++H) {
+      std::optional<TimeTraceProfilerEntry> &Slot = Slots[H % Capacity];
+      Fn(*Slot);
+      Slot.reset();
+    }
+    Head.store(H, std::memory_order_release);
+  }
+
+  uint64_t getTid() const { return Tid; }
+  StringRef getThreadName() const { return ThreadName; }
+
+  std::atomic<uint64_t> Dropped{0};
+
+private:
+  std::unique_ptr<std::optional<TimeTraceProfilerEntry>[]> Slots;
+  const size_t Capacity;
+  std::atomic<size_t> Head{0};
+  std::atomic<size_t> Tail{0};
+  const uint64_t Tid;
+  const SmallString<0> ThreadName;
+};
+
+} // anonymous namespace
+
 struct llvm::TimeTraceProfiler {
   TimeTraceProfiler(unsigned TimeTraceGranularity = 0, StringRef ProcName = "")
       : BeginningOfTime(system_clock::now()), StartTime(ClockType::now()),
@@ -127,7 +241,7 @@ struct llvm::TimeTraceProfiler {
 
     // Only include sections longer or equal to TimeTraceGranularity msec.
     if (duration_cast<microseconds>(Duration).count() >= TimeTraceGranularity)
-      Entries.emplace_back(E);
+      addEntry(E);
 
     // Track total time taken by each "name", but only the topmost levels of
     // them; e.g. if there's a template instantiation that instantiates other
@@ -149,6 +263,8 @@ struct llvm::TimeTraceProfiler {
                    });
   }
 
+  void addEntry(const TimeTraceProfilerEntry &E);
+
   // Write events from this TimeTraceProfilerInstance and
   // ThreadTimeTraceProfilerInstances.
   void write(raw_pwrite_stream &OS) {
@@ -167,51 +283,33 @@ struct llvm::TimeTraceProfiler {
     J.arrayBegin();
 
     // Emit all events for the main flame graph.
-    auto writeEvent = [&](const auto &E, uint64_t Tid) {
-      auto StartUs = E.getFlameGraphStartUs(StartTime);
-      auto DurUs = E.getFlameGraphDurUs();
-
-      J.object([&] {
-        J.attribute("pid", Pid);
-        J.attribute("tid", int64_t(Tid));
-        J.attribute("ts", StartUs);
-        if (E.AsyncEvent) {
-          J.attribute("cat", E.Name);
-          J.attribute("ph", "b");
-          J.attribute("id", 0);
-        } else {
-          J.attribute("ph", "X");
-          J.attribute("dur", DurUs);
-        }
-        J.attribute("name", E.Name);
-        if (!E.Detail.empty()) {
-          J.attributeObject("args", [&] { J.attribute("detail", E.Detail); });
-        }
-      });
-
-      if (E.AsyncEvent) {
-        J.object([&] {
-          J.attribute("pid", Pid);
-          J.attribute("tid", int64_t(Tid));
-          J.attribute("ts", StartUs + DurUs);
-          J.attribute("cat", E.Name);
-          J.attribute("ph", "e");
-          J.attribute("id", 0);
-          J.attribute("name", E.Name);
-        });
-      }
-    };
     for (const TimeTraceProfilerEntry &E : Entries)
-      writeEvent(E, this->Tid);
+      writeTraceEvent(J, E, Pid, this->Tid, StartTime);
     for (const TimeTraceProfiler *TTP : Instances.List)
       for (const TimeTraceProfilerEntry &E : TTP->Entries)
-        writeEvent(E, TTP->Tid);
+        writeTraceEvent(J, E, Pid, TTP->Tid, StartTime);
+
+    writeTotals(J, Instances.List);
+
+    writeMetadataEvent(J, "process_name", Pid, Tid, ProcName);
+    writeMetadataEvent(J, "thread_name", Pid, Tid, ThreadName);
+    for (const TimeTraceProfiler *TTP : Instances.List)
+      writeMetadataEvent(J, "thread_name", Pid, TTP->Tid, TTP->ThreadName);
+
+    J.arrayEnd();
+    J.attributeEnd();
 
-    // Emit totals by section name as additional "thread" events, sorted from
-    // longest one.
+    writeBeginningOfTime(J);
+    J.objectEnd();
+  }
+
+  // Emit totals by section name as additional "thread" events, sorted from
+  // longest one. The totals of this instance and of \p Others are combined.
+  void writeTotals(json::OStream &J,
+                   ArrayRef<TimeTraceProfiler *> Others) const {
     // Find highest used thread id.
     uint64_t MaxTid = this->Tid;
-    for (const TimeTraceProfiler *TTP : Instances.List)
+    for (const TimeTraceProfiler *TTP : Others)
       MaxTid = std::max(MaxTid, TTP->Tid);
 
     // Combine all CountAndTotalPerName from threads into one.
@@ -225,7 +323,7 @@ struct llvm::TimeTraceProfiler {
     };
     for (const auto &Stat : CountAndTotalPerName)
       combineStat(Stat);
-    for (const TimeTraceProfiler *TTP : Instances.List)
+    for (const TimeTraceProfiler *TTP : Others)
       for (const auto &Stat : TTP->CountAndTotalPerName)
         combineStat(Stat);
 
@@ -260,28 +358,9 @@ struct llvm::TimeTraceProfiler {
 
       ++TotalTid;
     }
+  }
 
-    auto writeMetadataEvent = [&](const char *Name, uint64_t Tid,
-                                  StringRef arg) {
-      J.object([&] {
-        J.attribute("cat", "");
-        J.attribute("pid", Pid);
-        J.attribute("tid", int64_t(Tid));
-        J.attribute("ts", 0);
-        J.attribute("ph", "M");
-        J.attribute("name", Name);
-        J.attributeObject("args", [&] { J.attribute("name", arg); });
-      });
-    };
-
-    writeMetadataEvent("process_name", Tid, ProcName);
-    writeMetadataEvent("thread_name", Tid, ThreadName);
-    for (const TimeTraceProfiler *TTP : Instances.List)
-      writeMetadataEvent("thread_name", TTP->Tid, TTP->ThreadName);
-
-    J.arrayEnd();
-    J.attributeEnd();
-
+  void writeBeginningOfTime(json::OStream &J) const {
     // Emit the absolute time when this TimeProfiler started.
     // This can be used to combine the profiling data from
     // multiple processes and preserve actual time intervals.
@@ -289,8 +368,6 @@ struct llvm::TimeTraceProfiler {
                 time_point_cast<microseconds>(BeginningOfTime)
                     .time_since_epoch()
                     .count());
-
-    J.objectEnd();
   }
 
   SmallVector<std::unique_ptr<TimeTraceProfilerEntry>, 16> Stack;
@@ -307,19 +384,211 @@ struct llvm::TimeTraceProfiler {
 
   // Minimum time granularity (in microseconds)
   const unsigned TimeTraceGranularity;
+
+  // Completed entries are queued here instead of in Entries when streaming.
+  TimeTraceRingBuffer *Ring = nullptr;
 };
 
+namespace {
+
+/// Writes completed entries to the trace file while the profiled program runs,
+/// so memory use is bounded by the per-thread ring buffers rather than by the
+/// number of recorded sections.
+class TimeTraceStreamer {
+public:
+  TimeTraceStreamer(std::unique_ptr<raw_fd_ostream> OS, size_t EntriesPerThread,
+                    sys::Process::Pid Pid, TimePointType StartTime)
+      : OS(std::move(OS)), J(*this->OS), EntriesPerThread(EntriesPerThread),
+        Pid(Pid), StartTime(StartTime) {
+    J.objectBegin();
+    J.attributeBegin("traceEvents");
+    J.arrayBegin();
+#if LLVM_ENABLE_THREADS
+    Writer = std::thread([this] { run(); });
+#endif
+  }
+
+  ~TimeTraceStreamer() { stop(); }
+
+  TimeTraceRingBuffer *registerThread(uint64_t Tid, StringRef ThreadName) {
+    std::lock_guard<std::mutex> Guard(Lock);
+    Buffers.push_back(
+        std::make_unique<TimeTraceRingBuffer>(EntriesPerThread, Tid, ThreadName));
+    return Buffers.back().get();
+  }
+
+  void add(TimeTraceRingBuffer &Ring, const TimeTraceProfilerEntry &E) {
+#if LLVM_ENABLE_THREADS
+    if (!Ring.push(E))
+      ++Ring.Dropped;
+    else if (Ring.reachedHalfFull())
+      Cond.notify_one();
+#else
+    // Without a writer thread, flush synchronously whenever the buffer fills.
+    if (!Ring.push(E)) {
+      drainAll();
+      Ring.push(E);
+    }
+#endif
+  }
+
+  /// Stop the writer, write the remaining entries followed by totals and
+  /// metadata, and close the file.
+  Error finish(const TimeTraceProfiler &Main,
+               ArrayRef<TimeTraceProfiler *> Others, StringRef ProcName) {
+    stop();
+    drainAll();
+
+    uint64_t Dropped = 0;
+    Main.writeTotals(J, Others);
+    writeMetadataEvent(J, "process_name", Pid, Main.Tid, ProcName);
+    for (const auto &Ring : Buffers) {
+      writeMetadataEvent(J, "thread_name", Pid, Ring->getTid(),
+                         Ring->getThreadName());
+      Dropped += Ring->Dropped;
+    }
+
+    J.arrayEnd();
+    J.attributeEnd();
+    Main.writeBeginningOfTime(J);
+    // Sections which didn't fit into a full ring buffer.
+    if (Dropped)
+      J.attribute("droppedEvents", int64_t(Dropped));
+    J.objectEnd();
+
+    OS->flush();
+    if (std::error_code EC = OS->error()) {
+      OS->clear_error();
+      return createStringError(EC, "Could not write time trace");
+    }
+    return Error::success();
+  }
+
+private:
+  void stop() {
+#if LLVM_ENABLE_THREADS
+    {
+      std::lock_guard<std::mutex> Guard(Lock);
+      if (Stopped)
+        return;
+      Stopped = true;
+    }
+    Cond.notify_one();
+    Writer.join();
+#endif
+  }
+
+  void drainAll() {
+    std::lock_guard<std::mutex> Guard(Lock);
+    for (const auto &Ring : Buffers)
+      Ring->drain([&](const TimeTraceProfilerEntry &E) {
+        writeTraceEvent(J, E, Pid, Ring->getTid(), StartTime);
+      });
+  }
+
+#if LLVM_ENABLE_THREADS
+  void run() {
+    std::unique_lock<std::mutex> Guard(Lock);
+    while (!Stopped) {
+      // Wake up periodically too, so that buffers of threads which record few
+      // sections don't hold on to them indefinitely.
+      Cond.wait_for(Guard, std::chrono::milliseconds(100));
+      Guard.unlock();
+      drainAll();
+      Guard.lock();
+    }
+  }
+#endif
+
+  std::unique_ptr<raw_fd_ostream> OS;
+  // Only used by the writer thread, and by finish() once it's stopped.
+  json::OStream J;
+  const size_t EntriesPerThread;
+  const sys::Process::Pid Pid;
+  const TimePointType StartTime;
+
+  // Guards Buffers and Stopped.
+  std::mutex Lock;
+  std::condition_variable Cond;
+  std::vector<std::unique_ptr<TimeTraceRingBuffer>> Buffers;
+  bool Stopped = false;
+#if LLVM_ENABLE_THREADS
+  std::thread Writer;
+#endif
+};
+
+} // anonymous namespace
+
+// The streamer is shared by all threads. It is created on the main thread
+// before any other thread initializes its profiler.
+static std::unique_ptr<TimeTraceStreamer> Streamer;
+
+void TimeTraceProfiler::addEntry(const TimeTraceProfilerEntry &E) {
+  if (Ring)
+    Streamer->add(*Ring, E);
+  else
+    Entries.emplace_back(E);
+}
+
 void llvm::timeTraceProfilerInitialize(unsigned TimeTraceGranularity,
                                        StringRef ProcName) {
   assert(TimeTraceProfilerInstance == nullptr &&
          "Profiler should not be initialized");
   TimeTraceProfilerInstance = new TimeTraceProfiler(
       TimeTraceGranularity, llvm::sys::path::filename(ProcName));
+  if (Streamer)
+    TimeTraceProfilerInstance->Ring = Streamer->registerThread(
+        TimeTraceProfilerInstance->Tid, TimeTraceProfilerInstance->ThreadName);
+}
+
+Error llvm::timeTraceProfilerStartStreaming(StringRef FileName,
+                                            size_t EntriesPerThread) {
+  assert(TimeTraceProfilerInstance != nullptr &&
+         "Profiler object can't be null");
+  assert(!Streamer && "Already streaming");
+  assert(EntriesPerThread > 0 && "Ring buffers can't be empty");
+
+  std::error_code EC;
+  auto OS = std::make_unique<raw_fd_ostream>(FileName, EC,
+                                             sys::fs::OF_TextWithCRLF);
+  if (EC)
+    return createStringError(EC, "Could not open " + FileName);
+
+  Streamer = std::make_unique<TimeTraceStreamer>(
+      std::move(OS), EntriesPerThread, TimeTraceProfilerInstance->Pid,
+      TimeTraceProfilerInstance->StartTime);
+  TimeTraceProfilerInstance->Ring = Streamer->registerThread(
+      TimeTraceProfilerInstance->Tid, TimeTraceProfilerInstance->ThreadName);
+  return Error::success();
+}
+
+bool llvm::timeTraceProfilerStreaming() { return Streamer != nullptr; }
+
+Error llvm::timeTraceProfilerFinishStreaming() {
+  assert(TimeTraceProfilerInstance != nullptr &&
+         "Profiler object can't be null");
+  assert(Streamer && "Not streaming");
+  assert(TimeTraceProfilerInstance->Stack.empty() &&
+         "All profiler sections should be ended when finishing the stream");
+
+  auto &Instances = getTimeTraceProfilerInstances();
+  std::unique_lock<std::mutex> Lock(Instances.Lock);
+  Error Err = Streamer->finish(*TimeTraceProfilerInstance, Instances.List,
+                               TimeTraceProfilerInstance->ProcName);
+  // Later sections are not recorded anywhere.
+  for (TimeTraceProfiler *TTP : Instances.List)
+    TTP->Ring = nullptr;
+  Lock.unlock();
+  TimeTraceProfilerInstance->Ring = nullptr;
+  Streamer.reset();
+  return Err;
 }
 
 // Removes all TimeTraceProfilerInstances.
 // Called from main thread.
 void llvm::timeTraceProfilerCleanup() {
+  if (Streamer && TimeTraceProfilerInstance)
+    consumeError(timeTraceProfilerFinishStreaming());
   delete TimeTraceProfilerInstance;
   TimeTraceProfilerInstance = nullptr;
 
@@ -342,6 +611,7 @@ void llvm::timeTraceProfilerFinishThread() {
 void llvm::timeTraceProfilerWrite(raw_pwrite_stream &OS) {
   assert(TimeTraceProfilerInstance != nullptr &&
          "Profiler object can't be null");
+  assert(!Streamer && "Use timeTraceProfilerFinishStreaming when streaming");
   TimeTraceProfilerInstance->write(OS);
 }
 
@@ -350,6 +620,10 @@ Error llvm::timeTraceProfilerWrite(StringRef PreferredFileName,
   assert(TimeTraceProfilerInstance != nullptr &&
          "Profiler object can't be null");
 
+  // The file was chosen when streaming started.
+  if (Streamer)
+    return timeTraceProfilerFinishStreaming();
+
   std::string Path = PreferredFileName.str();
   if (Path.empty()) {
     Path = FallbackFileName == "-" ? "out" : FallbackFileName.str();
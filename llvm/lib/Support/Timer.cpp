@@ -26,6 +26,7 @@
 #include "llvm/Support/Signposts.h"
 #include "llvm/Support/YAMLTraits.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 #include <limits>
 
 #if HAVE_UNISTD_H
@@ -36,6 +37,12 @@
 #include <libproc.h>
 #endif
 
+#if defined(__linux__) && defined(HAVE_UNISTD_H)
+#define LLVM_HAVE_PERF_EVENTS 1
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
 using namespace llvm;
 
 // This ugly hack is brought to you courtesy of constructor/destructor ordering
@@ -65,6 +72,16 @@ struct CreateTrackSpace {
   }
 };
 static ManagedStatic<cl::opt<bool>, CreateTrackSpace> TrackSpace;
+struct CreateTrackPerfCounters {
+  static void *call() {
+    return new cl::opt<bool>(
+        "track-perf-counters",
+        cl::desc("Enable -time-passes hardware performance counter tracking "
+                 "(cycles, instructions, cache and branch misses; Linux only)"),
+        cl::Hidden);
+  }
+};
+static ManagedStatic<cl::opt<bool>, CreateTrackPerfCounters> TrackPerfCounters;
 struct CreateInfoOutputFilename {
   static void *call() {
     return new cl::opt<std::string, true>(
@@ -89,6 +106,7 @@ ManagedStatic<cl::opt<bool>, CreateSortTimers> SortTimers;
 
 void llvm::initTimerOptions() {
   *TrackSpace;
+  *TrackPerfCounters;
   *InfoOutputFilename;
   *SortTimers;
 }
@@ -165,22 +183,134 @@ static uint64_t getCurInstructionsExecuted() {
   return 0;
 }
 
+namespace {
+/// The hardware counters sampled with -track-perf-counters.
+enum PerfCounterKind {
+  PC_Cycles,
+  PC_Instructions,
+  PC_L1DMisses,
+  PC_LLCMisses,
+  PC_BranchMisses,
+  PC_NumCounters
+};
+
+/// A perf_event_open counter group for the calling thread.  All counters are
+/// read with a single system call so that they describe the same interval.
+/// Counters the kernel or the PMU refuse to open simply read as zero.
+class PerfCounterGroup {
+#ifdef LLVM_HAVE_PERF_EVENTS
+  int FDs[PC_NumCounters];
+  /// The position of each opened counter in the group's read buffer.
+  unsigned Slots[PC_NumCounters];
+  unsigned NumOpened = 0;
+
+  int open(uint32_t Type, uint64_t Config, int GroupFD) {
+    perf_event_attr Attr = {};
+    Attr.size = sizeof(Attr);
+    Attr.type = Type;
+    Attr.config = Config;
+    Attr.read_format = PERF_FORMAT_GROUP;
+    // User-space only, which is permitted under the default
+    // perf_event_paranoid setting and is what the timers are measuring.
+    Attr.exclude_kernel = 1;
+    Attr.exclude_hv = 1;
+    return syscall(__NR_perf_event_open, &Attr, /*pid=*/0, /*cpu=*/-1, GroupFD,
+                   /*flags=*/0);
+  }
+
+public:
+  PerfCounterGroup() {
+    static const struct {
+      uint32_t Type;
+      uint64_t Config;
+    } Events[PC_NumCounters] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                                 (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    };
+    // The cycle counter leads the group; without it nothing else is opened.
+    for (unsigned I = 0; I != PC_NumCounters; ++I) {
+      FDs[I] = -1;
+      if (I != PC_Cycles && FDs[PC_Cycles] < 0)
+        continue;
+      FDs[I] = open(Events[I].Type, Events[I].Config,
+                    I == PC_Cycles ? -1 : FDs[PC_Cycles]);
+      if (FDs[I] >= 0)
+        Slots[I] = NumOpened++;
+    }
+  }
+
+  ~PerfCounterGroup() {
+    for (int FD : FDs)
+      if (FD >= 0)
+        ::close(FD);
+  }
+
+  void read(uint64_t (&Values)[PC_NumCounters]) const {
+    std::fill_n(Values, PC_NumCounters, 0);
+    if (!NumOpened)
+      return;
+    // PERF_FORMAT_GROUP layout: the number of counters, then their values.
+    uint64_t Buffer[1 + PC_NumCounters];
+    ssize_t Size = ::read(FDs[PC_Cycles], Buffer, sizeof(Buffer));
+    if (Size < (ssize_t)sizeof(uint64_t) * (1 + NumOpened) ||
+        Buffer[0] != NumOpened)
+      return;
+    for (unsigned I = 0; I != PC_NumCounters; ++I)
+      if (FDs[I] >= 0)
+        Values[I] = Buffer[1 + Slots[I]];
+  }
+#else
+public:
+  void read(uint64_t (&Values)[PC_NumCounters]) const {
+    std::fill_n(Values, PC_NumCounters, 0);
+  }
+#endif
+};
+} // namespace
+
+static void getCurPerfCounters(uint64_t (&Values)[PC_NumCounters]) {
+  if (!*TrackPerfCounters) {
+    std::fill_n(Values, PC_NumCounters, 0);
+    return;
+  }
+  // Counters are per thread, matching a Timer being started and stopped on
+  // the same thread; the group is opened the first time a thread needs it.
+  static thread_local PerfCounterGroup Group;
+  Group.read(Values);
+}
+
 TimeRecord TimeRecord::getCurrentTime(bool Start) {
   using Seconds = std::chrono::duration<double, std::ratio<1>>;
   TimeRecord Result;
   sys::TimePoint<> now;
   std::chrono::nanoseconds user, sys;
 
+  uint64_t Counters[PC_NumCounters];
+
   if (Start) {
     Result.MemUsed = getMemUsage();
     Result.InstructionsExecuted = getCurInstructionsExecuted();
     sys::Process::GetTimeUsage(now, user, sys);
+    getCurPerfCounters(Counters);
   } else {
+    getCurPerfCounters(Counters);
     sys::Process::GetTimeUsage(now, user, sys);
     Result.InstructionsExecuted = getCurInstructionsExecuted();
     Result.MemUsed = getMemUsage();
   }
 
+  if (Counters[PC_Instructions])
+    Result.InstructionsExecuted = Counters[PC_Instructions];
+  Result.Cycles = Counters[PC_Cycles];
+  Result.L1DMisses = Counters[PC_L1DMisses];
+  Result.LLCMisses = Counters[PC_LLCMisses];
+  Result.BranchMisses = Counters[PC_BranchMisses];
+
   Result.WallTime = Seconds(now.time_since_epoch()).count();
   Result.UserTime = Seconds(user).count();
   Result.SystemTime = Seconds(sys).count();
@@ -229,6 +359,14 @@ void TimeRecord::print(const TimeRecord &Total, raw_ostream &OS) const {
     OS << format("%9" PRId64 "  ", (int64_t)getMemUsed());
   if (Total.getInstructionsExecuted())
     OS << format("%9" PRId64 "  ", (int64_t)getInstructionsExecuted());
+  if (Total.getCycles())
+    OS << format("%12" PRId64 "  ", (int64_t)getCycles());
+  if (Total.getL1DMisses())
+    OS << format("%12" PRId64 "  ", (int64_t)getL1DMisses());
+  if (Total.getLLCMisses())
+    OS << format("%12" PRId64 "  ", (int64_t)getLLCMisses());
+  if (Total.getBranchMisses())
+    OS << format("%12" PRId64 "  ", (int64_t)getBranchMisses());
 }
 
 
@@ -390,6 +528,14 @@ void TimerGroup::PrintQueuedTimers(raw_ostream &OS) {
     OS << "  ---Mem---";
   if (Total.getInstructionsExecuted())
     OS << "  ---Instr---";
+  if (Total.getCycles())
+    OS << "  ---Cycles---";
+  if (Total.getL1DMisses())
+    OS << "  --L1D Miss--";
+  if (Total.getLLCMisses())
+    OS << "  --LLC Miss--";
+  if (Total.getBranchMisses())
+    OS << "  --Br Miss---";
   OS << "  --- Name ---\n";
 
   // Loop through all of the timing data, printing it out.
@@ -487,6 +633,22 @@ const char *TimerGroup::printJSONValues(raw_ostream &OS, const char *delim) {
       OS << delim;
       printJSONValue(OS, R, ".instr", T.getInstructionsExecuted());
     }
+    if (T.getCycles()) {
+      OS << delim;
+      printJSONValue(OS, R, ".cycles", T.getCycles());
+    }
+    if (T.getL1DMisses()) {
+      OS << delim;
+      printJSONValue(OS, R, ".l1d-miss", T.getL1DMisses());
+    }
+    if (T.getLLCMisses()) {
+      OS << delim;
+      printJSONValue(OS, R, ".llc-miss", T.getLLCMisses());
+    }
+    if (T.getBranchMisses()) {
+      OS << delim;
+      printJSONValue(OS, R, ".br-miss", T.getBranchMisses());
+    }
   }
   TimersToPrint.clear();
   return delim;
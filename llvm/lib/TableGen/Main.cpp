@@ -67,6 +67,13 @@ static cl::opt<bool> NoWarnOnUnusedTemplateArgs(
     "no-warn-on-unused-template-args",
     cl::desc("Disable unused template argument warnings."));
 
+static cl::list<std::string> ExtraOutputs(
+    "extra-output",
+    cl::desc("Also run the backend <action> on the parsed records and write "
+             "its output to <filename>. Can be repeated. The backends must "
+             "not modify the records."),
+    cl::value_desc("action=filename"));
+
 static int reportError(const char *ProgName, Twine Msg) {
   errs() << ProgName << ": " << Msg;
   errs().flush();
@@ -95,6 +102,28 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
   return 0;
 }
 
+/// Write \p Contents to \p Filename, honoring -write-if-changed.
+static int writeOutputFile(const char *argv0, StringRef Filename,
+                           StringRef Contents) {
+  if (WriteIfChanged) {
+    // Only updates the real output file if there are any differences.
+    // This prevents recompilation of all the files depending on it if there
+    // aren't any.
+    if (auto ExistingOrErr = MemoryBuffer::getFile(Filename, /*IsText=*/true))
+      if (std::move(ExistingOrErr.get())->getBuffer() == Contents)
+        return 0;
+  }
+  std::error_code EC;
+  ToolOutputFile OutFile(Filename, EC, sys::fs::OF_Text);
+  if (EC)
+    return reportError(argv0, "error opening " + Filename + ": " +
+                                  EC.message() + "\n");
+  OutFile.os() << Contents;
+  if (ErrorsPrinted == 0)
+    OutFile.keep();
+  return 0;
+}
+
 int llvm::TableGenMain(const char *argv0,
                        std::function<TableGenMainFn> MainFn) {
   RecordKeeper Records;
@@ -142,6 +171,27 @@ int llvm::TableGenMain(const char *argv0,
   if (status)
     return 1;
 
+  // Run any additional backends on the same records, so that several outputs
+  // can share a single parse of the input.
+  SmallVector<std::pair<std::string, std::string>, 0> ExtraOutStrings;
+  for (StringRef Extra : ExtraOutputs) {
+    auto [ActionName, Filename] = Extra.split('=');
+    if (ActionName.empty() || Filename.empty())
+      return reportError(argv0, "invalid -extra-output '" + Extra +
+                                    "', expected action=filename\n");
+    TableGen::Emitter::FnT ExtraFn = nullptr;
+    if (TableGen::Emitter::Action->getParser().parse(
+            *TableGen::Emitter::Action, "extra-output", ActionName, ExtraFn) ||
+        !ExtraFn)
+      return 1;
+    Records.startBackendTimer(ActionName);
+    std::string ExtraString;
+    raw_string_ostream ExtraOut(ExtraString);
+    ExtraFn(Records, ExtraOut);
+    Records.stopBackendTimer();
+    ExtraOutStrings.emplace_back(Filename.str(), std::move(ExtraString));
+  }
+
   // Always write the depfile, even if the main output hasn't changed.
   // If it's missing, Ninja considers the output dirty.  If this was below
   // the early exit below and someone deleted the .inc.d file but not the .inc
@@ -152,27 +202,12 @@ int llvm::TableGenMain(const char *argv0,
   }
 
   Records.startTimer("Write output");
-  bool WriteFile = true;
-  if (WriteIfChanged) {
-    // Only updates the real output file if there are any differences.
-    // This prevents recompilation of all the files depending on it if there
-    // aren't any.
-    if (auto ExistingOrErr =
-            MemoryBuffer::getFile(OutputFilename, /*IsText=*/true))
-      if (std::move(ExistingOrErr.get())->getBuffer() == Out.str())
-        WriteFile = false;
-  }
-  if (WriteFile) {
-    std::error_code EC;
-    ToolOutputFile OutFile(OutputFilename, EC, sys::fs::OF_Text);
-    if (EC)
-      return reportError(argv0, "error opening " + OutputFilename + ": " +
-                                    EC.message() + "\n");
-    OutFile.os() << Out.str();
-    if (ErrorsPrinted == 0)
-      OutFile.keep();
-  }
-  
+  if (int Ret = writeOutputFile(argv0, OutputFilename, Out.str()))
+    return Ret;
+  for (const auto &[Filename, Contents] : ExtraOutStrings)
+    if (int Ret = writeOutputFile(argv0, Filename, Contents))
+      return Ret;
+
   Records.stopTimer();
   Records.stopPhaseTiming();
 
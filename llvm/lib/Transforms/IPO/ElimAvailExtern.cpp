@@ -38,6 +38,8 @@ cl::opt<bool> ConvertToLocal(
 STATISTIC(NumRemovals, "Number of functions removed");
 STATISTIC(NumConversions, "Number of functions converted");
 STATISTIC(NumVariables, "Number of global variables removed");
+STATISTIC(NumRemovedWithCalls,
+          "Number of functions removed while still directly called");
 
 void deleteFunction(Function &F) {
   // This will set the linkage to external
@@ -112,6 +114,12 @@ static bool eliminateAvailableExternally(Module &M) {
     if (F.isDeclaration() || !F.hasAvailableExternallyLinkage())
       continue;
 
+    // A function that is still called was not inlined at those calls, so
+    // importing its body (e.g. for ThinLTO) did not pay off there.
+    if (AreStatisticsEnabled() &&
+        any_of(F.users(), [](const User *U) { return isa<CallBase>(U); }))
+      ++NumRemovedWithCalls;
+
     if (ConvertToLocal)
       convertToLocalCopy(M, F);
     else
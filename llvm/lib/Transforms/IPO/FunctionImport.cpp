@@ -64,7 +64,11 @@ STATISTIC(NumImportedCriticalFunctionsThinLink,
           "Number of critical functions thin link decided to import");
 STATISTIC(NumImportedGlobalVarsThinLink,
           "Number of global variables thin link decided to import");
+STATISTIC(NumImportedInstrsThinLink,
+          "Number of instructions in functions thin link decided to import");
 STATISTIC(NumImportedFunctions, "Number of functions imported in backend");
+STATISTIC(NumImportedInstrs,
+          "Number of instructions in functions imported in backend");
 STATISTIC(NumImportedGlobalVars,
           "Number of global variables imported in backend");
 STATISTIC(NumImportedModules, "Number of modules imported from");
@@ -822,6 +826,7 @@ static void computeImportForFunction(
       bool PreviouslyImported = !ILI.second;
       if (!PreviouslyImported) {
         NumImportedFunctionsThinLink++;
+        NumImportedInstrsThinLink += ResolvedCalleeSummary->instCount();
         if (IsHotCallsite)
           NumImportedHotFunctionsThinLink++;
         if (IsCriticalCallsite)
@@ -1636,6 +1641,7 @@ Expected<bool> FunctionImporter::importFunctions(
     auto &ImportGUIDs = FunctionsToImportPerModule->second;
     // Find the globals to import
     SetVector<GlobalValue *> GlobalsToImport;
+    SmallVector<GlobalValue *, 16> FunctionsToImport;
     for (Function &F : *SrcModule) {
       if (!F.hasName())
         continue;
@@ -1644,27 +1650,35 @@ Expected<bool> FunctionImporter::importFunctions(
       LLVM_DEBUG(dbgs() << (Import ? "Is" : "Not") << " importing function "
                         << GUID << " " << F.getName() << " from "
                         << SrcModule->getSourceFileName() << "\n");
-      if (Import) {
-        if (Error Err = F.materialize())
-          return std::move(Err);
-        // MemProf should match function's definition and summary,
-        // 'thinlto_src_module' is needed.
-        if (EnableImportMetadata || EnableMemProfContextDisambiguation) {
-          // Add 'thinlto_src_module' and 'thinlto_src_file' metadata for
-          // statistics and debugging.
-          F.setMetadata(
-              "thinlto_src_module",
-              MDNode::get(DestModule.getContext(),
-                          {MDString::get(DestModule.getContext(),
-                                         SrcModule->getModuleIdentifier())}));
-          F.setMetadata(
-              "thinlto_src_file",
-              MDNode::get(DestModule.getContext(),
-                          {MDString::get(DestModule.getContext(),
-                                         SrcModule->getSourceFileName())}));
-        }
-        GlobalsToImport.insert(&F);
+      if (Import)
+        FunctionsToImport.push_back(&F);
+    }
+    // Read all of the imported bodies in one go, which lets the bitcode reader
+    // visit them in stream order.
+    if (Error Err = SrcModule->materializeBatch(FunctionsToImport))
+      return std::move(Err);
+    for (GlobalValue *GV : FunctionsToImport) {
+      Function &F = *cast<Function>(GV);
+      // Counting instructions walks the whole body, so only do it for -stats.
+      if (AreStatisticsEnabled())
+        NumImportedInstrs += F.getInstructionCount();
+      // MemProf should match function's definition and summary,
+      // 'thinlto_src_module' is needed.
+      if (EnableImportMetadata || EnableMemProfContextDisambiguation) {
+        // Add 'thinlto_src_module' and 'thinlto_src_file' metadata for
+        // statistics and debugging.
+        F.setMetadata(
+            "thinlto_src_module",
+            MDNode::get(DestModule.getContext(),
+                        {MDString::get(DestModule.getContext(),
+                                       SrcModule->getModuleIdentifier())}));
+        F.setMetadata(
+            "thinlto_src_file",
+            MDNode::get(DestModule.getContext(),
+                        {MDString::get(DestModule.getContext(),
+                                       SrcModule->getSourceFileName())}));
       }
+      GlobalsToImport.insert(&F);
     }
     for (GlobalVariable &GV : SrcModule->globals()) {
       if (!GV.hasName())
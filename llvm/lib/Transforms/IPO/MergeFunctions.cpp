@@ -90,12 +90,15 @@
 
 #include "llvm/Transforms/IPO/MergeFunctions.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/IR/Argument.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/Constant.h"
 #include "llvm/IR/Constants.h"
+#include "llvm/IR/DataLayout.h"
 #include "llvm/IR/DebugInfoMetadata.h"
 #include "llvm/IR/DebugLoc.h"
 #include "llvm/IR/DerivedTypes.h"
@@ -116,6 +119,7 @@
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/Utils/FunctionComparator.h"
@@ -168,6 +172,58 @@ static cl::opt<bool>
                           cl::init(false),
                           cl::desc("Allow mergefunc to create aliases"));
 
+// Hash a type the way FunctionComparator::cmpTypes() distinguishes types:
+// pointers in address space 0 compare equal to the pointer-sized integer, and
+// aggregates and vectors are only separated by their type ID here.
+static IRHash hashTypeForMerging(Type *Ty, const DataLayout &DL) {
+  if (auto *PTy = dyn_cast<PointerType>(Ty)) {
+    if (PTy->getAddressSpace() == 0)
+      return hash_combine(Type::IntegerTyID, DL.getPointerSizeInBits(0));
+    return hash_combine(Type::PointerTyID, PTy->getAddressSpace());
+  }
+  if (auto *ITy = dyn_cast<IntegerType>(Ty))
+    return hash_combine(Type::IntegerTyID, ITy->getBitWidth());
+  return hash_combine(Ty->getTypeID());
+}
+
+// StructuralHash() only looks at opcodes, so large modules with many template
+// instantiations end up with big buckets of functions that differ only in
+// their types. This refines it with the properties FunctionComparator checks
+// before it looks at operand values: the operand count, the instruction and
+// operand types, and comparison predicates. Functions that compare equal
+// always get the same hash, so this only cuts down on comparator calls.
+static IRHash hashFunctionForMerging(const Function &F) {
+  IRHash Hash = StructuralHash(F);
+  if (F.isDeclaration())
+    return Hash;
+
+  const DataLayout &DL = F.getParent()->getDataLayout();
+  SmallVector<const BasicBlock *, 8> BBs;
+  SmallPtrSet<const BasicBlock *, 16> VisitedBBs;
+  // Walk the blocks in the same order as FunctionComparator::compare() so
+  // that the hash does not depend on the block layout.
+  BBs.push_back(&F.getEntryBlock());
+  VisitedBBs.insert(BBs[0]);
+  while (!BBs.empty()) {
+    const BasicBlock *BB = BBs.pop_back_val();
+    for (const Instruction &I : *BB) {
+      // GEPs are compared by their offsets, so their shape does not matter.
+      if (isa<GetElementPtrInst>(I))
+        continue;
+      Hash = hash_combine(Hash, I.getNumOperands(),
+                          hashTypeForMerging(I.getType(), DL));
+      for (const Use &Op : I.operands())
+        Hash = hash_combine(Hash, hashTypeForMerging(Op->getType(), DL));
+      if (const auto *Cmp = dyn_cast<CmpInst>(&I))
+        Hash = hash_combine(Hash, Cmp->getPredicate());
+    }
+    for (const BasicBlock *Succ : successors(BB))
+      if (VisitedBBs.insert(Succ).second)
+        BBs.push_back(Succ);
+  }
+  return Hash;
+}
+
 namespace {
 
 class FunctionNode {
@@ -176,7 +232,7 @@ class FunctionNode {
 
 public:
   // Note the hash is recalculated potentially multiple times, but it is cheap.
-  FunctionNode(Function *F) : F(F), Hash(StructuralHash(*F)) {}
+  FunctionNode(Function *F) : F(F), Hash(hashFunctionForMerging(*F)) {}
 
   Function *getFunc() const { return F; }
   IRHash getHash() const { return Hash; }
@@ -423,10 +479,16 @@ bool MergeFunctions::runOnModule(Module &M) {
   std::vector<std::pair<IRHash, Function *>> HashedFuncs;
   for (Function &Func : M) {
     if (isEligibleForMerging(Func)) {
-      HashedFuncs.push_back({StructuralHash(Func), &Func});
+      HashedFuncs.push_back({0, &Func});
     }
   }
 
+  // Hashing only reads the IR, so it can be done for all functions at once.
+  // Each result goes to its own slot, which keeps the order deterministic.
+  parallelFor(0, HashedFuncs.size(), [&](size_t I) {
+    HashedFuncs[I].first = hashFunctionForMerging(*HashedFuncs[I].second);
+  });
+
   llvm::stable_sort(HashedFuncs, less_first());
 
   auto S = HashedFuncs.begin();
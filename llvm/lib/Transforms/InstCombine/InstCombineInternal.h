@@ -17,6 +17,7 @@
 
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Analysis/InstructionSimplify.h"
 #include "llvm/Analysis/TargetFolder.h"
 #include "llvm/Analysis/ValueTracking.h"
@@ -78,11 +79,29 @@ public:
   bool prepareWorklist(Function &F,
                        ReversePostOrderTraversal<BasicBlock *> &RPOT);
 
-  /// Run the combiner over the entire worklist until it is empty.
+  /// Run the combiner over the entire worklist until it is empty, or until
+  /// MaxVisits instructions have been visited.
   ///
   /// \returns true if the IR is changed.
   bool run();
 
+  /// Visit counts, successful folds and time spent per opcode or intrinsic,
+  /// as collected with -instcombine-profile-visits.
+  struct VisitProfileEntry {
+    uint64_t Visits = 0;
+    uint64_t Folds = 0;
+    std::chrono::nanoseconds Time{0};
+  };
+  using VisitProfile = StringMap<VisitProfileEntry>;
+
+  /// If set, run() attributes each visit to an entry of this profile.
+  VisitProfile *Profile = nullptr;
+
+  /// Number of instructions visited in this function so far, including
+  /// earlier iterations, and the budget after which run() stops (0 = none).
+  unsigned NumVisits = 0;
+  unsigned MaxVisits = 0;
+
   // Visitation implementation - Implement instruction combining for different
   // instruction types.  The semantics are as follows:
   // Return Value:
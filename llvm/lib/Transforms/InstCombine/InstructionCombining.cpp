@@ -127,6 +127,8 @@ STATISTIC(NumSunkInst , "Number of instructions sunk");
 STATISTIC(NumExpand,    "Number of expansions");
 STATISTIC(NumFactor   , "Number of factorizations");
 STATISTIC(NumReassoc  , "Number of reassociations");
+STATISTIC(NumVisitBudgetExceeded,
+          "Number of functions that exceeded the visit budget");
 DEBUG_COUNTER(VisitCounter, "instcombine-visit",
               "Controls which instructions are visited");
 
@@ -142,6 +144,16 @@ static cl::opt<unsigned>
 MaxArraySize("instcombine-maxarray-size", cl::init(1024),
              cl::desc("Maximum array size considered when doing a combine"));
 
+static cl::opt<unsigned> MaxVisitsPerFunction(
+    "instcombine-max-visits", cl::Hidden, cl::init(0),
+    cl::desc("Stop combining a function after visiting this many "
+             "instructions, over all iterations (0 = unlimited)"));
+
+static cl::opt<bool> ProfileVisits(
+    "instcombine-profile-visits", cl::Hidden, cl::init(false),
+    cl::desc("Count visits and folds and measure the time spent per opcode "
+             "and intrinsic, and report them as analysis remarks"));
+
 // FIXME: Remove this flag when it is no longer necessary to convert
 // llvm.dbg.declare to avoid inaccurate debug info. Setting this to false
 // increases variable availability at the cost of accuracy. Variables that
@@ -4985,6 +4997,13 @@ bool InstCombinerImpl::run() {
     if (!DebugCounter::shouldExecute(VisitCounter))
       continue;
 
+    if (LLVM_UNLIKELY(MaxVisits && NumVisits >= MaxVisits)) {
+      // Stop here. Anything left on the worklist is valid, just not combined.
+      Worklist.clear();
+      break;
+    }
+    ++NumVisits;
+
     // See if we can trivially sink this instruction to its user if we can
     // prove that the successor is not executed more frequently than our block.
     // Return the UserBlock if successful.
@@ -5083,7 +5102,24 @@ bool InstCombinerImpl::run() {
     LLVM_DEBUG(raw_string_ostream SS(OrigI); I->print(SS); OrigI = SS.str(););
     LLVM_DEBUG(dbgs() << "IC: Visiting: " << OrigI << '\n');
 
-    if (Instruction *Result = visit(*I)) {
+    Instruction *Result;
+    if (LLVM_UNLIKELY(Profile)) {
+      // Compute the key before visiting, I may be erased by the fold.
+      StringRef Key = I->getOpcodeName();
+      if (auto *II = dyn_cast<IntrinsicInst>(I))
+        Key = Intrinsic::getBaseName(II->getIntrinsicID());
+      VisitProfileEntry &Entry = (*Profile)[Key];
+      auto Start = std::chrono::steady_clock::now();
+      Result = visit(*I);
+      Entry.Time += std::chrono::steady_clock::now() - Start;
+      ++Entry.Visits;
+      if (Result)
+        ++Entry.Folds;
+    } else {
+      Result = visit(*I);
+    }
+
+    if (Result) {
       ++NumCombined;
       // Should we replace the old instruction with a new one?
       if (Result != I) {
@@ -5362,6 +5398,9 @@ static bool combineInstructionsOverFunction(
   if (ShouldLowerDbgDeclare)
     MadeIRChange = LowerDbgDeclare(F);
 
+  InstCombinerImpl::VisitProfile Profile;
+  unsigned NumVisits = 0;
+
   // Iterate while there is work to do.
   unsigned Iteration = 0;
   while (true) {
@@ -5381,8 +5420,26 @@ static bool combineInstructionsOverFunction(
     InstCombinerImpl IC(Worklist, Builder, F.hasMinSize(), AA, AC, TLI, TTI, DT,
                         ORE, BFI, BPI, PSI, DL, LI);
     IC.MaxArraySizeForCombine = MaxArraySize;
+    IC.Profile = ProfileVisits ? &Profile : nullptr;
+    IC.NumVisits = NumVisits;
+    IC.MaxVisits = MaxVisitsPerFunction;
     bool MadeChangeInThisIteration = IC.prepareWorklist(F, RPOT);
     MadeChangeInThisIteration |= IC.run();
+    NumVisits = IC.NumVisits;
+    if (MaxVisitsPerFunction && NumVisits >= MaxVisitsPerFunction) {
+      LLVM_DEBUG(dbgs() << "\n\n[IC] Visit budget of " << MaxVisitsPerFunction
+                        << " exhausted on " << F.getName()
+                        << "; stopping without verifying fixpoint\n");
+      ++NumVisitBudgetExceeded;
+      ORE.emit([&]() {
+        return OptimizationRemarkMissed(DEBUG_TYPE, "VisitBudgetExceeded", &F)
+               << "stopped after visiting "
+               << ore::NV("NumVisits", NumVisits) << " instructions in "
+               << ore::NV("Iterations", Iteration) << " iterations";
+      });
+      MadeIRChange |= MadeChangeInThisIteration;
+      break;
+    }
     if (!MadeChangeInThisIteration)
       break;
 
@@ -5404,6 +5461,24 @@ static bool combineInstructionsOverFunction(
   else
     ++NumFourOrMoreIterations;
 
+  if (ProfileVisits) {
+    // Report in name order so that the output is stable.
+    SmallVector<StringRef, 0> Keys;
+    for (const auto &Entry : Profile)
+      Keys.push_back(Entry.getKey());
+    llvm::sort(Keys);
+    for (StringRef Key : Keys) {
+      const InstCombinerImpl::VisitProfileEntry &Entry = Profile[Key];
+      ORE.emit([&]() {
+        return OptimizationRemarkAnalysis(DEBUG_TYPE, "VisitProfile", &F)
+               << ore::NV("Opcode", Key) << ": "
+               << ore::NV("Visits", Entry.Visits) << " visits, "
+               << ore::NV("Folds", Entry.Folds) << " folds, "
+               << ore::NV("TimeNs", uint64_t(Entry.Time.count())) << " ns";
+      });
+    }
+  }
+
   return MadeIRChange;
 }
 
@@ -35,9 +35,11 @@
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "llvm/InitializePasses.h"
@@ -99,6 +101,12 @@ cl::opt<bool>
                              cl::desc("Enable relocating counters at runtime."),
                              cl::init(false));
 
+cl::opt<bool> ShardCounters(
+    "instrprof-shard-counters",
+    cl::desc("Update profile counters in a per-thread copy of the counters "
+             "that the runtime merges back when writing the profile"),
+    cl::init(false));
+
 cl::opt<bool> ValueProfileStaticAlloc(
     "vp-static-alloc",
     cl::desc("Do static counter allocation for value profiler"),
@@ -228,6 +236,9 @@ private:
   /// If runtime relocation is enabled, this maps functions to the load
   /// instruction that produces the profile relocation bias.
   DenseMap<const Function *, LoadInst *> FunctionToProfileBiasMap;
+  /// If counter sharding is enabled, this maps functions to the value of the
+  /// counter shard bias of the current thread.
+  DenseMap<const Function *, PHINode *> FunctionToShardBiasMap;
   std::vector<GlobalValue *> CompilerUsedVars;
   std::vector<GlobalValue *> UsedVars;
   std::vector<GlobalVariable *> ReferencedNames;
@@ -252,6 +263,13 @@ private:
   /// Returns true if relocating counters at runtime is enabled.
   bool isRuntimeCounterRelocationEnabled() const;
 
+  /// Returns true if counters are updated in per-thread shards.
+  bool isCounterShardingEnabled() const;
+
+  /// Computes the counter shard bias of the current thread at the entry of
+  /// the function, allocating the shard if the thread doesn't have one yet.
+  void createCounterShardBias(Function *F);
+
   /// Returns true if profile counter update register promotion is enabled.
   bool isCounterPromotionEnabled() const;
 
@@ -387,10 +405,10 @@ public:
       Type *Ty = LiveInValue->getType();
       IRBuilder<> Builder(InsertPos);
       if (auto *AddrInst = dyn_cast_or_null<IntToPtrInst>(Addr)) {
-        // If isRuntimeCounterRelocationEnabled() is true then the address of
-        // the store instruction is computed with two instructions in
-        // InstrProfiling::getCounterAddress(). We need to copy those
-        // instructions to this block to compute Addr correctly.
+        // If isRuntimeCounterRelocationEnabled() or isCounterShardingEnabled()
+        // is true then the address of the store instruction is computed with
+        // two instructions in InstrProfiling::getCounterAddress(). We need to
+        // copy those instructions to this block to compute Addr correctly.
         // %BiasAdd = add i64 ptrtoint <__profc_>, <__llvm_profile_counter_bias>
         // %Addr = inttoptr i64 %BiasAdd to i64*
         auto *OrigBiasInst = dyn_cast<BinaryOperator>(AddrInst->getOperand(0));
@@ -625,6 +643,9 @@ PreservedAnalyses InstrProfilingLoweringPass::run(Module &M,
 bool InstrLowerer::lowerIntrinsics(Function *F) {
   bool MadeChange = false;
   PromotionCandidates.clear();
+  // This splits the entry block, so do it before walking the instructions.
+  if (isCounterShardingEnabled())
+    createCounterShardBias(F);
   for (BasicBlock &BB : *F) {
     for (Instruction &Instr : llvm::make_early_inc_range(BB)) {
       if (auto *IPIS = dyn_cast<InstrProfIncrementInstStep>(&Instr)) {
@@ -674,6 +695,66 @@ bool InstrLowerer::isRuntimeCounterRelocationEnabled() const {
   return TT.isOSFuchsia();
 }
 
+bool InstrLowerer::isCounterShardingEnabled() const {
+  if (!ShardCounters)
+    return false;
+
+  // Relocated counters are addressed through their own bias, and the runtime
+  // only provides counter shards on top of pthreads.
+  return !isRuntimeCounterRelocationEnabled() && !TT.isOSWindows() &&
+         !TT.isNVPTX() && !TT.isAMDGPU();
+}
+
+void InstrLowerer::createCounterShardBias(Function *F) {
+  if (none_of(instructions(F), [](const Instruction &I) {
+        return isa<InstrProfIncrementInst>(I) || isa<InstrProfCoverInst>(I);
+      }))
+    return;
+
+  LLVMContext &Ctx = M.getContext();
+  Type *Int64Ty = Type::getInt64Ty(Ctx);
+  auto *BiasVar = M.getGlobalVariable(getInstrProfCounterShardBiasVarName());
+  if (!BiasVar) {
+    // Defined by the runtime, along with the function allocating the shards.
+    BiasVar = new GlobalVariable(
+        M, Int64Ty, false, GlobalValue::ExternalLinkage, nullptr,
+        getInstrProfCounterShardBiasVarName(), nullptr,
+        GlobalVariable::GeneralDynamicTLSModel);
+    BiasVar->setVisibility(GlobalVariable::HiddenVisibility);
+  }
+
+  // Split the entry block after its allocas, and move the static allocas
+  // that come later up, so that they stay in the entry block.
+  BasicBlock &Entry = F->getEntryBlock();
+  BasicBlock::iterator IP = Entry.getFirstInsertionPt();
+  while (isa<AllocaInst>(IP))
+    ++IP;
+  for (Instruction &I : make_early_inc_range(make_range(IP, Entry.end())))
+    if (auto *AI = dyn_cast<AllocaInst>(&I); AI && AI->isStaticAlloca())
+      AI->moveBefore(&*IP);
+
+  // A zero bias means that the thread doesn't have a shard yet.
+  IRBuilder<> Builder(&Entry, IP);
+  LoadInst *Bias = Builder.CreateLoad(
+      Int64Ty, Builder.CreateThreadLocalAddress(BiasVar), "pgoshard");
+  Value *IsUnset = Builder.CreateICmpEQ(Bias, Builder.getInt64(0));
+  Instruction *Term = SplitBlockAndInsertIfThen(
+      IsUnset, IP, /*Unreachable=*/false,
+      MDBuilder(Ctx).createUnlikelyBranchWeights());
+
+  IRBuilder<> InitBuilder(Term);
+  auto InitFn = M.getOrInsertFunction(getInstrProfCounterShardInitFuncName(),
+                                      FunctionType::get(Int64Ty, false));
+  Value *NewBias = InitBuilder.CreateCall(InitFn);
+
+  BasicBlock *Tail = Term->getSuccessor(0);
+  IRBuilder<> PhiBuilder(Tail, Tail->begin());
+  PHINode *Phi = PhiBuilder.CreatePHI(Int64Ty, 2, "pgoshard.bias");
+  Phi->addIncoming(Bias, &Entry);
+  Phi->addIncoming(NewBias, Term->getParent());
+  FunctionToShardBiasMap[F] = Phi;
+}
+
 bool InstrLowerer::isCounterPromotionEnabled() const {
   if (DoCounterPromotion.getNumOccurrences() > 0)
     return DoCounterPromotion;
@@ -902,11 +983,22 @@ Value *InstrLowerer::getCounterAddress(InstrProfCntrInstBase *I) {
   auto *Addr = Builder.CreateConstInBoundsGEP2_32(
       Counters->getValueType(), Counters, 0, I->getIndex()->getZExtValue());
 
+  Type *Int64Ty = Type::getInt64Ty(M.getContext());
+  Function *Fn = I->getParent()->getParent();
+  if (isCounterShardingEnabled()) {
+    // Timestamps are written once and are not merged from the shards, keep
+    // them in the counters section.
+    if (isa<InstrProfTimestampInst>(I))
+      return Addr;
+    PHINode *Bias = FunctionToShardBiasMap.lookup(Fn);
+    assert(Bias && "counter shard bias was not computed");
+    auto *Add = Builder.CreateAdd(Builder.CreatePtrToInt(Addr, Int64Ty), Bias);
+    return Builder.CreateIntToPtr(Add, Addr->getType());
+  }
+
   if (!isRuntimeCounterRelocationEnabled())
     return Addr;
 
-  Type *Int64Ty = Type::getInt64Ty(M.getContext());
-  Function *Fn = I->getParent()->getParent();
   LoadInst *&BiasLI = FunctionToProfileBiasMap[Fn];
   if (!BiasLI) {
     IRBuilder<> EntryBuilder(&Fn->getEntryBlock().front());
@@ -14,11 +14,13 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/PriorityWorklist.h"
 #include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Analysis/AssumptionCache.h"
 #include "llvm/Analysis/CodeMetrics.h"
 #include "llvm/Analysis/DependenceAnalysis.h"
 #include "llvm/Analysis/LoopAnalysisManager.h"
+#include "llvm/Analysis/LoopCacheAnalysis.h"
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/LoopNestAnalysis.h"
 #include "llvm/Analysis/LoopPass.h"
@@ -53,6 +55,9 @@ using namespace llvm;
 
 #define DEBUG_TYPE "loop-unroll-and-jam"
 
+STATISTIC(NumRejectedByCacheCost,
+          "Number of loops not unroll-and-jammed due to the cache cost model");
+
 /// @{
 /// Metadata attribute names
 static const char *const LLVMLoopUnrollAndJamFollowupAll =
@@ -85,6 +90,12 @@ static cl::opt<unsigned> PragmaUnrollAndJamThreshold(
     cl::desc("Unrolled size limit for loops with an unroll_and_jam(full) or "
              "unroll_count pragma."));
 
+static cl::opt<bool> UnrollAndJamUseCacheCost(
+    "unroll-and-jam-use-cache-cost", cl::init(false), cl::Hidden,
+    cl::desc("Only unroll-and-jam an outer loop if LoopCacheAnalysis "
+             "estimates that it carries at least as much reuse as its inner "
+             "loop."));
+
 // Returns the loop hint metadata node with the given name (for example,
 // "llvm.loop.unroll.count").  If no such metadata node exists, then nullptr is
 // returned.
@@ -279,7 +290,8 @@ static LoopUnrollResult
 tryToUnrollAndJamLoop(Loop *L, DominatorTree &DT, LoopInfo *LI,
                       ScalarEvolution &SE, const TargetTransformInfo &TTI,
                       AssumptionCache &AC, DependenceInfo &DI,
-                      OptimizationRemarkEmitter &ORE, int OptLevel) {
+                      OptimizationRemarkEmitter &ORE, int OptLevel,
+                      const CacheCost *CC) {
   TargetTransformInfo::UnrollingPreferences UP = gatherUnrollingPreferences(
       L, SE, TTI, nullptr, nullptr, ORE, OptLevel, std::nullopt, std::nullopt,
       std::nullopt, std::nullopt, std::nullopt, std::nullopt);
@@ -319,10 +331,34 @@ tryToUnrollAndJamLoop(Loop *L, DominatorTree &DT, LoopInfo *LI,
     return LoopUnrollResult::Unmodified;
   }
 
+  Loop *SubLoop = L->getSubLoops()[0];
+
+  // Jamming copies of the outer loop body into the inner loop only improves
+  // locality if references reuse data across outer loop iterations. The cache
+  // model estimates the lines touched with each loop placed innermost, so a
+  // lower cost for L than for SubLoop means L carries the larger share of the
+  // reuse. Loops forced by a pragma are left alone.
+  if (CC && !(EnableMode & TM_ForcedByUser)) {
+    CacheCostTy OuterCost = CC->getLoopCost(*L);
+    CacheCostTy InnerCost = CC->getLoopCost(*SubLoop);
+    if (OuterCost != CacheCost::InvalidCost &&
+        InnerCost != CacheCost::InvalidCost && OuterCost > InnerCost) {
+      LLVM_DEBUG(dbgs() << "  Disabled by cache cost model (outer cost "
+                        << OuterCost << ", inner cost " << InnerCost << ").\n");
+      ++NumRejectedByCacheCost;
+      ORE.emit([&]() {
+        return OptimizationRemarkMissed(DEBUG_TYPE, "NoLocalityBenefit",
+                                        L->getStartLoc(), L->getHeader())
+               << "unroll and jam not performed: cache model estimates no "
+                  "reuse across outer loop iterations";
+      });
+      return LoopUnrollResult::Unmodified;
+    }
+  }
+
   // Approximate the loop size and collect useful info
   SmallPtrSet<const Value *, 32> EphValues;
   CodeMetrics::collectEphemeralValues(L, &AC, EphValues);
-  Loop *SubLoop = L->getSubLoops()[0];
   UnrollCostEstimator InnerUCE(SubLoop, TTI, EphValues, UP.BEInsns);
   UnrollCostEstimator OuterUCE(L, TTI, EphValues, UP.BEInsns);
 
@@ -424,8 +460,12 @@ static bool tryToUnrollAndJamLoop(LoopNest &LN, DominatorTree &DT, LoopInfo &LI,
                                   const TargetTransformInfo &TTI,
                                   AssumptionCache &AC, DependenceInfo &DI,
                                   OptimizationRemarkEmitter &ORE, int OptLevel,
-                                  LPMUpdater &U) {
+                                  LPMUpdater &U,
+                                  function_ref<std::unique_ptr<CacheCost>()>
+                                      GetCacheCost) {
   bool DidSomething = false;
+  std::unique_ptr<CacheCost> CC;
+  bool CCIsStale = true;
   ArrayRef<Loop *> Loops = LN.getLoops();
   Loop *OutmostLoop = &LN.getOutermostLoop();
 
@@ -436,10 +476,18 @@ static bool tryToUnrollAndJamLoop(LoopNest &LN, DominatorTree &DT, LoopInfo &LI,
   while (!Worklist.empty()) {
     Loop *L = Worklist.pop_back_val();
     std::string LoopName = std::string(L->getName());
-    LoopUnrollResult Result =
-        tryToUnrollAndJamLoop(L, DT, &LI, SE, TTI, AC, DI, ORE, OptLevel);
-    if (Result != LoopUnrollResult::Unmodified)
+    // The costs describe the nest as it was when computed; recompute them
+    // after any loop in the nest has been transformed.
+    if (GetCacheCost && CCIsStale) {
+      CC = GetCacheCost();
+      CCIsStale = false;
+    }
+    LoopUnrollResult Result = tryToUnrollAndJamLoop(
+        L, DT, &LI, SE, TTI, AC, DI, ORE, OptLevel, CC.get());
+    if (Result != LoopUnrollResult::Unmodified) {
       DidSomething = true;
+      CCIsStale = true;
+    }
     if (L == OutmostLoop && Result == LoopUnrollResult::FullyUnrolled)
       U.markLoopAsDeleted(*L, LoopName);
   }
@@ -456,8 +504,14 @@ PreservedAnalyses LoopUnrollAndJamPass::run(LoopNest &LN,
   DependenceInfo DI(&F, &AR.AA, &AR.SE, &AR.LI);
   OptimizationRemarkEmitter ORE(&F);
 
-  if (!tryToUnrollAndJamLoop(LN, AR.DT, AR.LI, AR.SE, AR.TTI, AR.AC, DI, ORE,
-                             OptLevel, U))
+  auto GetCacheCost = [&]() {
+    return CacheCost::getCacheCost(LN.getOutermostLoop(), AR, DI);
+  };
+  if (!tryToUnrollAndJamLoop(
+          LN, AR.DT, AR.LI, AR.SE, AR.TTI, AR.AC, DI, ORE, OptLevel, U,
+          UnrollAndJamUseCacheCost
+              ? function_ref<std::unique_ptr<CacheCost>()>(GetCacheCost)
+              : nullptr))
     return PreservedAnalyses::all();
 
   auto PA = getLoopPassPreservedAnalyses();
@@ -113,6 +113,7 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <tuple>
@@ -492,6 +493,9 @@ class NewGVN {
   AliasAnalysis *AA = nullptr;
   MemorySSA *MSSA = nullptr;
   MemorySSAWalker *MSSAWalker = nullptr;
+  // Alias analysis results shared by all clobber queries while the IR is
+  // unchanged, i.e. until elimination starts.
+  mutable std::optional<BatchAAResults> BatchAA;
   AssumptionCache *AC = nullptr;
   const DataLayout &DL;
   std::unique_ptr<PredicateInfo> PredInfo;
@@ -863,6 +867,7 @@ private:
   void deleteExpression(const Expression *E) const;
   MemoryUseOrDef *getMemoryAccess(const Instruction *) const;
   MemoryPhi *getMemoryAccess(const BasicBlock *) const;
+  MemoryAccess *getClobberingMemoryAccess(MemoryAccess *) const;
   template <class T, class Range> T *getMinDFSOfRange(const Range &) const;
 
   unsigned InstrToDFSNum(const Value *V) const {
@@ -937,6 +942,12 @@ MemoryUseOrDef *NewGVN::getMemoryAccess(const Instruction *I) const {
   return Result ? Result : TempToMemory.lookup(I);
 }
 
+MemoryAccess *NewGVN::getClobberingMemoryAccess(MemoryAccess *MA) const {
+  if (BatchAA)
+    return MSSAWalker->getClobberingMemoryAccess(MA, *BatchAA);
+  return MSSAWalker->getClobberingMemoryAccess(MA);
+}
+
 // Get a MemoryPhi for a basic block. These are all real.
 MemoryPhi *NewGVN::getMemoryAccess(const BasicBlock *BB) const {
   return MSSA->getMemoryAccess(BB);
@@ -1398,7 +1409,7 @@ const Expression *NewGVN::performSymbolicStoreEvaluation(Instruction *I) const {
   // Get the expression, if any, for the RHS of the MemoryDef.
   const MemoryAccess *StoreRHS = StoreAccess->getDefiningAccess();
   if (EnableStoreRefinement)
-    StoreRHS = MSSAWalker->getClobberingMemoryAccess(StoreAccess);
+    StoreRHS = getClobberingMemoryAccess(StoreAccess);
   // If we bypassed the use-def chains, make sure we add a use.
   StoreRHS = lookupMemoryLeader(StoreRHS);
   if (StoreRHS != StoreAccess->getDefiningAccess())
@@ -1528,8 +1539,7 @@ const Expression *NewGVN::performSymbolicLoadEvaluation(Instruction *I) const {
   if (isa<UndefValue>(LoadAddressLeader))
     return createConstantExpression(PoisonValue::get(LI->getType()));
   MemoryAccess *OriginalAccess = getMemoryAccess(I);
-  MemoryAccess *DefiningAccess =
-      MSSAWalker->getClobberingMemoryAccess(OriginalAccess);
+  MemoryAccess *DefiningAccess = getClobberingMemoryAccess(OriginalAccess);
 
   if (!MSSA->isLiveOnEntryDef(DefiningAccess)) {
     if (auto *MD = dyn_cast<MemoryDef>(DefiningAccess)) {
@@ -1631,7 +1641,7 @@ NewGVN::ExprResult NewGVN::performSymbolicCallEvaluation(Instruction *I) const {
         createCallExpression(CI, TOPClass->getMemoryLeader()));
   } else if (AA->onlyReadsMemory(CI)) {
     if (auto *MA = MSSA->getMemoryAccess(CI)) {
-      auto *DefiningAccess = MSSAWalker->getClobberingMemoryAccess(MA);
+      auto *DefiningAccess = getClobberingMemoryAccess(MA);
       return ExprResult::some(createCallExpression(CI, DefiningAccess));
     } else // MSSA determined that CI does not access memory.
       return ExprResult::some(
@@ -3427,6 +3437,7 @@ bool NewGVN::runGVN() {
   bool Changed = false;
   NumFuncArgs = F.arg_size();
   MSSAWalker = MSSA->getWalker();
+  BatchAA.emplace(*AA);
   SingletonDeadExpression = new (ExpressionAllocator) DeadExpression();
 
   // Count number of instructions for sizing of hash tables, and come
@@ -3485,6 +3496,8 @@ bool NewGVN::runGVN() {
   verifyIterationSettled(F);
   verifyStoreExpressions();
 
+  // Elimination changes the IR, so cached alias results may become stale.
+  BatchAA.reset();
   Changed |= eliminateInstructions(F);
 
   // Delete all instructions marked for deletion.
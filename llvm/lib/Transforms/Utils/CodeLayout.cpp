@@ -43,6 +43,7 @@
 #include "llvm/Transforms/Utils/CodeLayout.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/xxhash.h"
 
 #include <cmath>
 #include <set>
@@ -115,6 +116,14 @@ static cl::opt<double> MaxMergeDensityRatio(
     "ext-tsp-max-merge-density-ratio", cl::ReallyHidden, cl::init(100),
     cl::desc("The maximum ratio between densities of two chains for merging"));
 
+// The number of hot chains above which chain pairs are merged using a
+// priority queue of merge gains. Below the threshold, every iteration rescans
+// all candidate pairs, which is quadratic but cheap for small instances.
+static cl::opt<unsigned> QueueMergeThreshold(
+    "ext-tsp-queue-merge-threshold", cl::ReallyHidden, cl::init(2048),
+    cl::desc("The minimum number of hot chains for which merge candidates "
+             "are kept in a priority queue"));
+
 // Algorithm-specific options for CDSort.
 static cl::opt<unsigned> CacheEntries("cdsort-cache-entries", cl::ReallyHidden,
                                       cl::desc("The size of the cache"));
@@ -737,8 +746,33 @@ private:
     }
   }
 
+  /// Return true if the size and density limits allow merging two chains.
+  bool canMergeChains(const ChainT *ChainPred, const ChainT *ChainSucc) const {
+    // Skip the merge if the combined chain violates the maximum specified
+    // size.
+    if (ChainPred->numBlocks() + ChainSucc->numBlocks() >= MaxChainSize)
+      return false;
+    // Don't merge the chains if they have vastly different densities.
+    // Skip the merge if the ratio between the densities exceeds
+    // MaxMergeDensityRatio. Smaller values of the option result in fewer
+    // merges, and hence, more chains.
+    const double ChainPredDensity = ChainPred->density();
+    const double ChainSuccDensity = ChainSucc->density();
+    assert(ChainPredDensity > 0.0 && ChainSuccDensity > 0.0 &&
+           "incorrectly computed chain densities");
+    auto [MinDensity, MaxDensity] =
+        std::minmax(ChainPredDensity, ChainSuccDensity);
+    const double Ratio = MaxDensity / MinDensity;
+    return Ratio <= MaxMergeDensityRatio;
+  }
+
   /// Merge pairs of chains while improving the ExtTSP objective.
   void mergeChainPairs() {
+    if (HotChains.size() >= QueueMergeThreshold) {
+      mergeChainPairsWithQueue();
+      return;
+    }
+
     /// Deterministically compare pairs of chains.
     auto compareChainPairs = [](const ChainT *A1, const ChainT *B1,
                                 const ChainT *A2, const ChainT *B2) {
@@ -756,22 +790,7 @@ private:
           // Ignore loop edges.
           if (Edge->isSelfEdge())
             continue;
-          // Skip the merge if the combined chain violates the maximum specified
-          // size.
-          if (ChainPred->numBlocks() + ChainSucc->numBlocks() >= MaxChainSize)
-            continue;
-          // Don't merge the chains if they have vastly different densities.
-          // Skip the merge if the ratio between the densities exceeds
-          // MaxMergeDensityRatio. Smaller values of the option result in fewer
-          // merges, and hence, more chains.
-          const double ChainPredDensity = ChainPred->density();
-          const double ChainSuccDensity = ChainSucc->density();
-          assert(ChainPredDensity > 0.0 && ChainSuccDensity > 0.0 &&
-                 "incorrectly computed chain densities");
-          auto [MinDensity, MaxDensity] =
-              std::minmax(ChainPredDensity, ChainSuccDensity);
-          const double Ratio = MaxDensity / MinDensity;
-          if (Ratio > MaxMergeDensityRatio)
+          if (!canMergeChains(ChainPred, ChainSucc))
             continue;
 
           // Compute the gain of merging the two chains.
@@ -800,6 +819,70 @@ private:
     }
   }
 
+  /// Merge pairs of chains while improving the ExtTSP objective, keeping the
+  /// candidate edges in a priority queue ordered by their merge gain.
+  ///
+  /// The gain of merging two chains only depends on the nodes of the two
+  /// chains, so after a merge only the edges adjacent to the merged chain need
+  /// to be re-evaluated. This avoids rescanning all pairs of chains on every
+  /// iteration, which does not scale to functions with thousands of blocks.
+  void mergeChainPairsWithQueue() {
+    auto GainComparator = [](ChainEdge *L, ChainEdge *R) {
+      return std::make_tuple(-L->gain(), L->srcChain()->Id, L->dstChain()->Id) <
+             std::make_tuple(-R->gain(), R->srcChain()->Id, R->dstChain()->Id);
+    };
+    std::set<ChainEdge *, decltype(GainComparator)> Queue(GainComparator);
+
+    // Evaluate both merge orders of the chains connected by Edge and record
+    // the better one on the edge. Returns the chains in that order.
+    auto evaluateEdge = [&](ChainEdge *Edge) -> std::pair<ChainT *, ChainT *> {
+      ChainT *SrcChain = Edge->srcChain();
+      ChainT *DstChain = Edge->dstChain();
+      MergeGainT Forward = getBestMergeGain(SrcChain, DstChain, Edge);
+      MergeGainT Backward = getBestMergeGain(DstChain, SrcChain, Edge);
+      if (Forward < Backward) {
+        Edge->setMergeGain(Backward);
+        return {DstChain, SrcChain};
+      }
+      Edge->setMergeGain(Forward);
+      return {SrcChain, DstChain};
+    };
+    auto pushEdge = [&](ChainEdge *Edge) {
+      // Ignore loop edges.
+      if (Edge->isSelfEdge())
+        return;
+      if (!canMergeChains(Edge->srcChain(), Edge->dstChain()))
+        return;
+      evaluateEdge(Edge);
+      if (Edge->gain() > EPS)
+        Queue.insert(Edge);
+    };
+
+    for (ChainT *Chain : HotChains)
+      for (const auto &[_, Edge] : Chain->Edges)
+        if (Edge->srcChain() == Chain)
+          pushEdge(Edge);
+
+    while (!Queue.empty()) {
+      ChainEdge *BestEdge = *Queue.begin();
+      // The cached gains are still valid, so this only recovers the order.
+      auto [BestChainPred, BestChainSucc] = evaluateEdge(BestEdge);
+      MergeGainT BestGain = BestEdge->getMergeGain();
+
+      // Remove the edges whose gains are invalidated by the merge.
+      for (const auto &[_, Edge] : BestChainPred->Edges)
+        Queue.erase(Edge);
+      for (const auto &[_, Edge] : BestChainSucc->Edges)
+        Queue.erase(Edge);
+
+      mergeChains(BestChainPred, BestChainSucc, BestGain.mergeOffset(),
+                  BestGain.mergeType());
+
+      for (const auto &[_, Edge] : BestChainPred->Edges)
+        pushEdge(Edge);
+    }
+  }
+
   /// Merge remaining nodes into chains w/o taking jump counts into
   /// consideration. This allows to maintain the original node order in the
   /// absence of profile data.
@@ -1458,6 +1541,24 @@ double codelayout::calcExtTspScore(ArrayRef<uint64_t> NodeSizes,
   return calcExtTspScore(Order, NodeSizes, NodeCounts, EdgeCounts);
 }
 
+uint64_t codelayout::getExtTspParamsHash() {
+  const uint64_t Params[] = {
+      llvm::bit_cast<uint64_t>(double(ForwardWeightCond)),
+      llvm::bit_cast<uint64_t>(double(ForwardWeightUncond)),
+      llvm::bit_cast<uint64_t>(double(BackwardWeightCond)),
+      llvm::bit_cast<uint64_t>(double(BackwardWeightUncond)),
+      llvm::bit_cast<uint64_t>(double(FallthroughWeightCond)),
+      llvm::bit_cast<uint64_t>(double(FallthroughWeightUncond)),
+      ForwardDistance,
+      BackwardDistance,
+      MaxChainSize,
+      ChainSplitThreshold,
+      llvm::bit_cast<uint64_t>(double(MaxMergeDensityRatio)),
+      QueueMergeThreshold};
+  return xxh3_64bits(ArrayRef<uint8_t>(
+      reinterpret_cast<const uint8_t *>(Params), sizeof(Params)));
+}
+
 std::vector<uint64_t> codelayout::computeCacheDirectedLayout(
     const CDSortConfig &Config, ArrayRef<uint64_t> FuncSizes,
     ArrayRef<uint64_t> FuncCounts, ArrayRef<EdgeCount> CallCounts,
@@ -18,19 +18,26 @@
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/Analysis/BranchProbabilityInfo.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
 #include "llvm/IR/Comdat.h"
 #include "llvm/IR/Constant.h"
 #include "llvm/IR/Constants.h"
+#include "llvm/IR/Dominators.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/GlobalAlias.h"
 #include "llvm/IR/GlobalObject.h"
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/InstrTypes.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/User.h"
 #include "llvm/IR/Value.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MD5.h"
@@ -49,6 +56,11 @@ using namespace llvm;
 
 #define DEBUG_TYPE "split-module"
 
+static cl::opt<bool> ProfileGuidedSplit(
+    "split-module-profile-guided", cl::Hidden, cl::init(false),
+    cl::desc("Keep callers and callees connected by hot call sites in the "
+             "same partition and balance partitions by instruction count"));
+
 namespace {
 
 using ClusterMapType = EquivalenceClasses<const GlobalValue *>;
@@ -89,6 +101,81 @@ static void addAllGlobalValueUsers(ClusterMapType &GVtoClusterMap,
   }
 }
 
+// The estimated cost of generating code for GV, which is what partitions are
+// balanced on. Without profile guidance every global counts the same.
+static uint64_t getCodeGenCost(const GlobalValue *GV) {
+  if (!ProfileGuidedSplit)
+    return 1;
+  if (const auto *F = dyn_cast<Function>(GV))
+    return std::max(1u, F->getInstructionCount());
+  return 1;
+}
+
+// With profile data, merges the clusters of callers and callees that are
+// connected by hot call sites, hottest first, as long as the merged cluster
+// stays below MaxClusterCost. Keeping such pairs together lets the code
+// generator see both sides of the call, and lets the linker lay them out
+// next to each other.
+static void clusterHotCallEdges(Module &M, ClusterMapType &GVtoClusterMap,
+                                uint64_t MaxClusterCost) {
+  ProfileSummaryInfo PSI(M);
+  if (!PSI.hasProfileSummary())
+    return;
+
+  struct HotEdge {
+    uint64_t Count;
+    const Function *Caller;
+    const Function *Callee;
+  };
+  SmallVector<HotEdge, 0> Edges;
+  for (const Function &F : M) {
+    if (F.isDeclaration() || !F.getEntryCount())
+      continue;
+    DominatorTree DT(const_cast<Function &>(F));
+    LoopInfo LI(DT);
+    BranchProbabilityInfo BPI(F, LI);
+    BlockFrequencyInfo BFI(F, BPI, LI);
+    for (const BasicBlock &BB : F) {
+      std::optional<uint64_t> Count = BFI.getBlockProfileCount(&BB);
+      if (!Count || !PSI.isHotCount(*Count))
+        continue;
+      for (const Instruction &I : BB)
+        if (const auto *CB = dyn_cast<CallBase>(&I))
+          if (const Function *Callee = CB->getCalledFunction())
+            if (!Callee->isDeclaration() && Callee != &F)
+              Edges.push_back({*Count, &F, Callee});
+    }
+  }
+
+  // Sort by decreasing count; break ties on names for determinism.
+  llvm::sort(Edges, [](const HotEdge &A, const HotEdge &B) {
+    if (A.Count != B.Count)
+      return A.Count > B.Count;
+    if (A.Caller != B.Caller)
+      return A.Caller->getName() < B.Caller->getName();
+    return A.Callee->getName() < B.Callee->getName();
+  });
+
+  DenseMap<const GlobalValue *, uint64_t> ClusterCost;
+  for (auto I = GVtoClusterMap.begin(), E = GVtoClusterMap.end(); I != E; ++I)
+    ClusterCost[GVtoClusterMap.getLeaderValue(I->getData())] +=
+        getCodeGenCost(I->getData());
+
+  for (const HotEdge &Edge : Edges) {
+    const GlobalValue *A = GVtoClusterMap.getLeaderValue(Edge.Caller);
+    const GlobalValue *B = GVtoClusterMap.getLeaderValue(Edge.Callee);
+    if (A == B)
+      continue;
+    uint64_t Cost = ClusterCost[A] + ClusterCost[B];
+    if (Cost > MaxClusterCost)
+      continue;
+    LLVM_DEBUG(dbgs() << "Hot edge (" << Edge.Count << ") "
+                      << Edge.Caller->getName() << " -> "
+                      << Edge.Callee->getName() << "\n");
+    ClusterCost[*GVtoClusterMap.unionSets(A, B)] = Cost;
+  }
+}
+
 static const GlobalObject *getGVPartitioningRoot(const GlobalValue *GV) {
   const GlobalObject *GO = GV->getAliaseeObject();
   if (const auto *GI = dyn_cast_or_null<GlobalIFunc>(GO))
@@ -109,13 +196,23 @@ static void findPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
   ClusterMapType GVtoClusterMap;
   ComdatMembersType ComdatMembers;
 
-  auto recordGVSet = [&GVtoClusterMap, &ComdatMembers](GlobalValue &GV) {
+  uint64_t TotalCost = 0;
+  auto recordGVSet = [&GVtoClusterMap, &ComdatMembers,
+                      &TotalCost](GlobalValue &GV) {
     if (GV.isDeclaration())
       return;
 
     if (!GV.hasName())
       GV.setName("__llvmsplit_unnamed");
 
+    // With profile guidance every definition is assigned to a partition
+    // explicitly, so that the balancing below sees all of the code and not
+    // only the clusters that must stay together.
+    if (ProfileGuidedSplit) {
+      GVtoClusterMap.insert(&GV);
+      TotalCost += getCodeGenCost(&GV);
+    }
+
     // Comdat groups must not be partitioned. For comdat groups that contain
     // locals, record all their members here so we can keep them together.
     // Comdat groups that only contain external globals are already handled by
@@ -151,25 +248,27 @@ static void findPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
   llvm::for_each(M.globals(), recordGVSet);
   llvm::for_each(M.aliases(), recordGVSet);
 
-  // Assigned all GVs to merged clusters while balancing number of objects in
-  // each.
-  auto CompareClusters = [](const std::pair<unsigned, unsigned> &a,
-                            const std::pair<unsigned, unsigned> &b) {
+  if (ProfileGuidedSplit && N > 1)
+    clusterHotCallEdges(M, GVtoClusterMap, divideCeil(TotalCost, N));
+
+  // Assigned all GVs to merged clusters while balancing the cost of each.
+  auto CompareClusters = [](const std::pair<unsigned, uint64_t> &a,
+                            const std::pair<unsigned, uint64_t> &b) {
     if (a.second || b.second)
       return a.second > b.second;
     else
       return a.first > b.first;
   };
 
-  std::priority_queue<std::pair<unsigned, unsigned>,
-                      std::vector<std::pair<unsigned, unsigned>>,
+  std::priority_queue<std::pair<unsigned, uint64_t>,
+                      std::vector<std::pair<unsigned, uint64_t>>,
                       decltype(CompareClusters)>
       BalancinQueue(CompareClusters);
   // Pre-populate priority queue with N slot blanks.
   for (unsigned i = 0; i < N; ++i)
     BalancinQueue.push(std::make_pair(i, 0));
 
-  using SortType = std::pair<unsigned, ClusterMapType::iterator>;
+  using SortType = std::pair<uint64_t, ClusterMapType::iterator>;
 
   SmallVector<SortType, 64> Sets;
   SmallPtrSet<const GlobalValue *, 32> Visited;
@@ -178,10 +277,13 @@ static void findPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
   // When size is the same, use leader's name.
   for (ClusterMapType::iterator I = GVtoClusterMap.begin(),
                                 E = GVtoClusterMap.end(); I != E; ++I)
-    if (I->isLeader())
-      Sets.push_back(
-          std::make_pair(std::distance(GVtoClusterMap.member_begin(I),
-                                       GVtoClusterMap.member_end()), I));
+    if (I->isLeader()) {
+      uint64_t Cost = 0;
+      for (ClusterMapType::member_iterator MI = GVtoClusterMap.member_begin(I);
+           MI != GVtoClusterMap.member_end(); ++MI)
+        Cost += getCodeGenCost(*MI);
+      Sets.push_back(std::make_pair(Cost, I));
+    }
 
   llvm::sort(Sets, [](const SortType &a, const SortType &b) {
     if (a.first == b.first)
@@ -192,7 +294,7 @@ static void findPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
 
   for (auto &I : Sets) {
     unsigned CurrentClusterID = BalancinQueue.top().first;
-    unsigned CurrentClusterSize = BalancinQueue.top().second;
+    uint64_t CurrentClusterSize = BalancinQueue.top().second;
     BalancinQueue.pop();
 
     LLVM_DEBUG(dbgs() << "Root[" << CurrentClusterID << "] cluster_size("
@@ -208,7 +310,7 @@ static void findPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
                         << ((*MI)->hasLocalLinkage() ? " l " : " e ") << "\n");
       Visited.insert(*MI);
       ClusterIDMap[*MI] = CurrentClusterID;
-      CurrentClusterSize++;
+      CurrentClusterSize += getCodeGenCost(*MI);
     }
     // Add this set size to the number of entries in this cluster.
     BalancinQueue.push(std::make_pair(CurrentClusterID, CurrentClusterSize));
@@ -7272,6 +7272,20 @@ LoopVectorizationPlanner::planInVPlanNativePath(ElementCount UserVF) {
                           << "overriding computed VF.\n");
         VF = ElementCount::getFixed(4);
       }
+
+      // The target has no vector registers wide enough for the widest type
+      // in the loop, so a vector loop would not be any better than the
+      // scalar one.
+      if (VF.isScalar() || VF.isZero()) {
+        LLVM_DEBUG(dbgs() << "LV: Not vectorizing outer loop: computed VF "
+                          << VF << " is not a vector.\n");
+        reportVectorizationFailure(
+            "Outer loop vectorization is not beneficial",
+            "the target does not provide vector registers that fit the "
+            "widest type in the outer loop",
+            "OuterLoopNotBeneficial", ORE, OrigLoop);
+        return VectorizationFactor::Disabled();
+      }
     } else if (UserVF.isScalable() && !TTI.supportsScalableVectors() &&
                !ForceTargetSupportsScalableVectors) {
       LLVM_DEBUG(dbgs() << "LV: Not vectorizing. Scalable VF requested, but "
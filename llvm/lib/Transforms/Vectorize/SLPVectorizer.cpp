@@ -108,6 +108,8 @@ using namespace slpvectorizer;
 #define DEBUG_TYPE "SLP"
 
 STATISTIC(NumVectorInstructions, "Number of vector instructions generated");
+STATISTIC(NumTreeCostCacheHits,
+          "Number of list bundles whose tree cost was reused");
 
 static cl::opt<bool>
     RunSLPVectorization("vectorize-slp", cl::init(true), cl::Hidden,
@@ -2387,6 +2389,26 @@ public:
   /// is delayed until BoUpSLP is destructed.
   void eraseInstruction(Instruction *I) {
     DeletedInstructions.insert(I);
+    clearTreeCostCache();
+  }
+
+  /// \returns the result of an earlier analysis of the tree rooted at \p VL,
+  /// if the IR did not change since: std::nullopt if there was no earlier
+  /// analysis, a nullopt cost if the tree was too small to vectorize, and the
+  /// tree cost otherwise.
+  std::optional<std::optional<InstructionCost>>
+  getCachedTreeCost(ArrayRef<Value *> VL) const {
+    auto It = TreeCostCache.find(VL);
+    if (It == TreeCostCache.end())
+      return std::nullopt;
+    ++NumTreeCostCacheHits;
+    return It->second;
+  }
+
+  /// Remember the result of analyzing the tree rooted at \p VL, see
+  /// getCachedTreeCost.
+  void cacheTreeCost(ArrayRef<Value *> VL, std::optional<InstructionCost> Cost) {
+    TreeCostCache.try_emplace(VL.copy(TreeCostCacheAllocator), Cost);
   }
 
   /// Checks if the instruction was already analyzed for being possible
@@ -3217,6 +3239,20 @@ private:
   /// previously deleted instruction.
   DenseSet<Instruction *> DeletedInstructions;
 
+  /// Results of analyzing trees rooted at a given bundle, see
+  /// getCachedTreeCost. Seeds are often tried several times, e.g. once with
+  /// only the maximal vector factor and once with all factors. The cache is
+  /// dropped whenever the IR changes, as that may change any tree's cost.
+  DenseMap<ArrayRef<Value *>, std::optional<InstructionCost>> TreeCostCache;
+  BumpPtrAllocator TreeCostCacheAllocator;
+
+  void clearTreeCostCache() {
+    if (TreeCostCache.empty())
+      return;
+    TreeCostCache.clear();
+    TreeCostCacheAllocator.Reset();
+  }
+
   /// Set of the instruction, being analyzed already for reductions.
   SmallPtrSet<Instruction *, 16> AnalyzedReductionsRoots;
 
@@ -13479,6 +13515,7 @@ Value *BoUpSLP::vectorizeTree(
     const ExtraValueToDebugLocsMap &ExternallyUsedValues,
     SmallVectorImpl<std::pair<Value *, Value *>> &ReplacedExternals,
     Instruction *ReductionRoot) {
+  clearTreeCostCache();
   // All blocks must be scheduled before any instructions are inserted.
   for (auto &BSIter : BlocksSchedules) {
     scheduleBlock(BSIter.second.get());
@@ -16217,9 +16254,21 @@ bool SLPVectorizerPass::tryToVectorizeList(ArrayRef<Value *> VL, BoUpSLP &R,
       LLVM_DEBUG(dbgs() << "SLP: Analyzing " << ActualVF << " operations "
                         << "\n");
 
+      // Don't rebuild a tree we already rejected while the IR is unchanged.
+      if (std::optional<std::optional<InstructionCost>> Cached =
+              R.getCachedTreeCost(Ops)) {
+        if (*Cached) {
+          CandidateFound = true;
+          MinCost = std::min(MinCost, **Cached);
+        }
+        continue;
+      }
+
       R.buildTree(Ops);
-      if (R.isTreeTinyAndNotFullyVectorizable())
+      if (R.isTreeTinyAndNotFullyVectorizable()) {
+        R.cacheTreeCost(Ops, std::nullopt);
         continue;
+      }
       R.reorderTopToBottom();
       R.reorderBottomToTop(
           /*IgnoreReorder=*/!isa<InsertElementInst>(Ops.front()) &&
@@ -16231,6 +16280,8 @@ bool SLPVectorizerPass::tryToVectorizeList(ArrayRef<Value *> VL, BoUpSLP &R,
       InstructionCost Cost = R.getTreeCost();
       CandidateFound = true;
       MinCost = std::min(MinCost, Cost);
+      if (!(Cost < -SLPCostThreshold))
+        R.cacheTreeCost(Ops, Cost);
 
       LLVM_DEBUG(dbgs() << "SLP: Found cost = " << Cost
                         << " for VF=" << ActualVF << "\n");
@@ -0,0 +1,18 @@
+; REQUIRES: asserts
+; RUN: llc -mtriple=aarch64-- -global-isel -global-isel-abort=2 -stats %s -o /dev/null 2>&1 | FileCheck %s
+
+; A function the IRTranslator can't handle is counted once, against the
+; IRTranslator, and falls back to SelectionDAG.
+
+; CHECK: 1 globalisel-utils - Number of GlobalISel IR translation failures
+; CHECK-NOT: globalisel-utils - Number of GlobalISel legalization failures
+; CHECK: 1 reset-machine-function - Number of functions reset
+
+define void @callbr() {
+entry:
+  callbr void asm "", "!i"() to label %a [label %b]
+a:
+  ret void
+b:
+  ret void
+}
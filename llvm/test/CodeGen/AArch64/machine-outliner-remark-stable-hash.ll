@@ -0,0 +1,70 @@
+; RUN: llc -mtriple=aarch64-- -enable-machine-outliner -outliner-remark-stable-hash -pass-remarks-output=%t1.yaml %s -o /dev/null
+; RUN: sed -e 's/@f/@g/g' %s > %t.renamed.ll
+; RUN: llc -mtriple=aarch64-- -enable-machine-outliner -outliner-remark-stable-hash -pass-remarks-output=%t2.yaml %t.renamed.ll -o /dev/null
+; RUN: FileCheck %s --input-file=%t1.yaml
+; RUN: grep StableHash %t1.yaml > %t1.hash
+; RUN: grep StableHash %t2.yaml > %t2.hash
+; RUN: diff %t1.hash %t2.hash
+; RUN: llc -mtriple=aarch64-- -enable-machine-outliner -pass-remarks-output=%t3.yaml %s -o /dev/null
+; RUN: FileCheck %s --input-file=%t3.yaml --check-prefix=NOHASH
+
+; The hash only depends on the outlined instructions, so the same sequence
+; gets the same hash in a module where the functions have other names.
+
+; CHECK:      --- !Passed
+; CHECK-NEXT: Pass:            machine-outliner
+; CHECK-NEXT: Name:            OutlinedFunction
+; CHECK:        - StableHash:      '{{[0-9]+}}'
+
+; NOHASH:     Name:            OutlinedFunction
+; NOHASH-NOT: StableHash
+
+define void @f1() #0 {
+  %1 = alloca i32, align 4
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  %5 = alloca i32, align 4
+  %6 = alloca i32, align 4
+  store volatile i32 1, ptr %1, align 4
+  store volatile i32 2, ptr %2, align 4
+  store volatile i32 3, ptr %3, align 4
+  store volatile i32 4, ptr %4, align 4
+  store volatile i32 5, ptr %5, align 4
+  store volatile i32 6, ptr %6, align 4
+  ret void
+}
+
+define void @f2() #0 {
+  %1 = alloca i32, align 4
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  %5 = alloca i32, align 4
+  %6 = alloca i32, align 4
+  store volatile i32 1, ptr %1, align 4
+  store volatile i32 2, ptr %2, align 4
+  store volatile i32 3, ptr %3, align 4
+  store volatile i32 4, ptr %4, align 4
+  store volatile i32 5, ptr %5, align 4
+  store volatile i32 6, ptr %6, align 4
+  ret void
+}
+
+define void @f3() #0 {
+  %1 = alloca i32, align 4
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  %5 = alloca i32, align 4
+  %6 = alloca i32, align 4
+  store volatile i32 1, ptr %1, align 4
+  store volatile i32 2, ptr %2, align 4
+  store volatile i32 3, ptr %3, align 4
+  store volatile i32 4, ptr %4, align 4
+  store volatile i32 5, ptr %5, align 4
+  store volatile i32 6, ptr %6, align 4
+  ret void
+}
+
+attributes #0 = { noredzone nounwind minsize }
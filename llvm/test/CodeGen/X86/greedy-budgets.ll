@@ -0,0 +1,100 @@
+; REQUIRES: asserts
+; RUN: llc -mtriple=x86_64-unknown-linux-gnu -O2 -verify-machineinstrs -stats < %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=NOBUDGET
+; RUN: llc -mtriple=x86_64-unknown-linux-gnu -O2 -verify-machineinstrs -greedy-split-budget=1 -greedy-eviction-budget=1 -stats < %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=BUDGET
+
+; Many values live across calls force the greedy allocator to evict and
+; split. With tiny budgets, the remaining spillable ranges are spilled
+; directly and the function still allocates.
+
+; NOBUDGET-NOT: due to the split budget
+; NOBUDGET-NOT: due to the eviction budget
+; BUDGET-DAG: {{[0-9]+}} regalloc - Number of live ranges not evicting due to the eviction budget
+; BUDGET-DAG: {{[0-9]+}} regalloc - Number of live ranges not split due to the split budget
+
+declare void @clobber()
+
+define i64 @pressure(ptr %p) {
+entry:
+  %a0.p = getelementptr inbounds i64, ptr %p, i64 0
+  %a0 = load volatile i64, ptr %a0.p, align 8
+  %a1.p = getelementptr inbounds i64, ptr %p, i64 1
+  %a1 = load volatile i64, ptr %a1.p, align 8
+  %a2.p = getelementptr inbounds i64, ptr %p, i64 2
+  %a2 = load volatile i64, ptr %a2.p, align 8
+  %a3.p = getelementptr inbounds i64, ptr %p, i64 3
+  %a3 = load volatile i64, ptr %a3.p, align 8
+  %a4.p = getelementptr inbounds i64, ptr %p, i64 4
+  %a4 = load volatile i64, ptr %a4.p, align 8
+  %a5.p = getelementptr inbounds i64, ptr %p, i64 5
+  %a5 = load volatile i64, ptr %a5.p, align 8
+  %a6.p = getelementptr inbounds i64, ptr %p, i64 6
+  %a6 = load volatile i64, ptr %a6.p, align 8
+  %a7.p = getelementptr inbounds i64, ptr %p, i64 7
+  %a7 = load volatile i64, ptr %a7.p, align 8
+  %a8.p = getelementptr inbounds i64, ptr %p, i64 8
+  %a8 = load volatile i64, ptr %a8.p, align 8
+  %a9.p = getelementptr inbounds i64, ptr %p, i64 9
+  %a9 = load volatile i64, ptr %a9.p, align 8
+  %a10.p = getelementptr inbounds i64, ptr %p, i64 10
+  %a10 = load volatile i64, ptr %a10.p, align 8
+  %a11.p = getelementptr inbounds i64, ptr %p, i64 11
+  %a11 = load volatile i64, ptr %a11.p, align 8
+  %a12.p = getelementptr inbounds i64, ptr %p, i64 12
+  %a12 = load volatile i64, ptr %a12.p, align 8
+  %a13.p = getelementptr inbounds i64, ptr %p, i64 13
+  %a13 = load volatile i64, ptr %a13.p, align 8
+  %a14.p = getelementptr inbounds i64, ptr %p, i64 14
+  %a14 = load volatile i64, ptr %a14.p, align 8
+  %a15.p = getelementptr inbounds i64, ptr %p, i64 15
+  %a15 = load volatile i64, ptr %a15.p, align 8
+  call void @clobber()
+  %s0 = add i64 %a0, %a1
+  %s1 = mul i64 %s0, %a2
+  %s2 = mul i64 %s1, %a3
+  %s3 = mul i64 %s2, %a4
+  %s4 = mul i64 %s3, %a5
+  %s5 = mul i64 %s4, %a6
+  %s6 = mul i64 %s5, %a7
+  %s7 = mul i64 %s6, %a8
+  %s8 = mul i64 %s7, %a9
+  %s9 = mul i64 %s8, %a10
+  %s10 = mul i64 %s9, %a11
+  %s11 = mul i64 %s10, %a12
+  %s12 = mul i64 %s11, %a13
+  %s13 = mul i64 %s12, %a14
+  %s14 = mul i64 %s13, %a15
+  call void @clobber()
+  %b0 = add i64 %s14, %a0
+  store volatile i64 %b0, ptr %a0.p, align 8
+  %b1 = add i64 %s14, %a1
+  store volatile i64 %b1, ptr %a1.p, align 8
+  %b2 = add i64 %s14, %a2
+  store volatile i64 %b2, ptr %a2.p, align 8
+  %b3 = add i64 %s14, %a3
+  store volatile i64 %b3, ptr %a3.p, align 8
+  %b4 = add i64 %s14, %a4
+  store volatile i64 %b4, ptr %a4.p, align 8
+  %b5 = add i64 %s14, %a5
+  store volatile i64 %b5, ptr %a5.p, align 8
+  %b6 = add i64 %s14, %a6
+  store volatile i64 %b6, ptr %a6.p, align 8
+  %b7 = add i64 %s14, %a7
+  store volatile i64 %b7, ptr %a7.p, align 8
+  %b8 = add i64 %s14, %a8
+  store volatile i64 %b8, ptr %a8.p, align 8
+  %b9 = add i64 %s14, %a9
+  store volatile i64 %b9, ptr %a9.p, align 8
+  %b10 = add i64 %s14, %a10
+  store volatile i64 %b10, ptr %a10.p, align 8
+  %b11 = add i64 %s14, %a11
+  store volatile i64 %b11, ptr %a11.p, align 8
+  %b12 = add i64 %s14, %a12
+  store volatile i64 %b12, ptr %a12.p, align 8
+  %b13 = add i64 %s14, %a13
+  store volatile i64 %b13, ptr %a13.p, align 8
+  %b14 = add i64 %s14, %a14
+  store volatile i64 %b14, ptr %a14.p, align 8
+  %b15 = add i64 %s14, %a15
+  store volatile i64 %b15, ptr %a15.p, align 8
+  ret i64 %s14
+}
@@ -0,0 +1,22 @@
+; RUN: opt < %s -passes=instcombine -instcombine-max-visits=1 -pass-remarks-missed=instcombine -S 2>&1 | FileCheck %s --check-prefix=BUDGET
+; RUN: opt < %s -passes=instcombine -instcombine-profile-visits -pass-remarks-analysis=instcombine -disable-output 2>&1 | FileCheck %s --check-prefix=PROFILE
+; RUN: opt < %s -passes=instcombine -S | FileCheck %s --check-prefix=FULL
+
+; With a budget of one visit, only the first add is folded.
+; BUDGET: remark: {{.*}} stopped after visiting 1 instructions in 1 iterations
+; BUDGET-LABEL: define i32 @f(
+; BUDGET-NEXT:    [[B:%.*]] = add i32 [[X:%.*]], 0
+; BUDGET-NEXT:    ret i32 [[B]]
+
+; Profile entries are reported per opcode, in name order.
+; PROFILE: remark: {{.*}} add: {{[1-9][0-9]*}} visits, {{[1-9][0-9]*}} folds, {{[0-9]+}} ns
+; PROFILE: remark: {{.*}} ret: {{[1-9][0-9]*}} visits, 0 folds, {{[0-9]+}} ns
+
+; FULL-LABEL: define i32 @f(
+; FULL-NEXT:    ret i32 [[X:%.*]]
+
+define i32 @f(i32 %x) {
+  %a = add i32 %x, 0
+  %b = add i32 %a, 0
+  ret i32 %b
+}
@@ -0,0 +1,41 @@
+; RUN: opt -passes=loop-unroll-and-jam -allow-unroll-and-jam -unroll-and-jam-count=4 -unroll-and-jam-use-cache-cost -cache-line-size=64 -pass-remarks-missed=loop-unroll-and-jam -S < %s 2>&1 | FileCheck %s --check-prefix=COST
+; RUN: opt -passes=loop-unroll-and-jam -allow-unroll-and-jam -unroll-and-jam-count=4 -S < %s | FileCheck %s --check-prefix=NOCOST
+
+target datalayout = "e-m:e-i64:64-n32:64"
+
+; A[i][j] = 0: the inner loop walks consecutive elements and the outer loop
+; reuses nothing, so the cache model rejects jamming the outer loop.
+
+; COST: remark: {{.*}}unroll and jam not performed: cache model estimates no reuse across outer loop iterations
+; COST-LABEL: define void @rows(
+; COST: store i32 0
+; COST-NOT: store i32 0
+
+; NOCOST-LABEL: define void @rows(
+; NOCOST-NOT: remark
+; NOCOST-COUNT-4: store i32 0
+
+define void @rows(ptr %A) {
+entry:
+  br label %for.outer
+
+for.outer:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %for.latch ]
+  br label %for.inner
+
+for.inner:
+  %j = phi i64 [ 0, %for.outer ], [ %j.next, %for.inner ]
+  %p = getelementptr inbounds [1024 x i32], ptr %A, i64 %i, i64 %j
+  store i32 0, ptr %p, align 4
+  %j.next = add nuw nsw i64 %j, 1
+  %inner.cond = icmp eq i64 %j.next, 1024
+  br i1 %inner.cond, label %for.latch, label %for.inner
+
+for.latch:
+  %i.next = add nuw nsw i64 %i, 1
+  %outer.cond = icmp eq i64 %i.next, 1024
+  br i1 %outer.cond, label %exit, label %for.outer
+
+exit:
+  ret void
+}
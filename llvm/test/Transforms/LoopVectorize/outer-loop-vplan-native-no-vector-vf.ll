@@ -0,0 +1,37 @@
+; RUN: opt -passes=loop-vectorize -enable-vplan-native-path -pass-remarks-analysis=loop-vectorize -S < %s 2>&1 | FileCheck %s
+
+; Without a target, the registers are 32 bits wide and cannot hold a vector of
+; i64, so the computed VF is 0 and the outer loop must be left alone.
+
+; CHECK: remark: {{.*}}loop not vectorized: the target does not provide vector registers that fit the widest type in the outer loop
+; CHECK-LABEL: define void @foo(
+; CHECK-NOT: x i64>
+; CHECK: ret void
+
+define void @foo(ptr %a, i64 %n) {
+entry:
+  br label %outer
+
+outer:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %outer.latch ]
+  %p = getelementptr inbounds i64, ptr %a, i64 %i
+  br label %inner
+
+inner:
+  %j = phi i64 [ 0, %outer ], [ %j.next, %inner ]
+  store i64 %j, ptr %p, align 8
+  %j.next = add nuw nsw i64 %j, 1
+  %inner.cond = icmp eq i64 %j.next, 8
+  br i1 %inner.cond, label %outer.latch, label %inner
+
+outer.latch:
+  %i.next = add nuw nsw i64 %i, 1
+  %outer.cond = icmp eq i64 %i.next, %n
+  br i1 %outer.cond, label %exit, label %outer, !llvm.loop !0
+
+exit:
+  ret void
+}
+
+!0 = distinct !{!0, !1}
+!1 = !{!"llvm.loop.vectorize.enable", i1 true}
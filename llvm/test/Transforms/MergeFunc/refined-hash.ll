@@ -0,0 +1,52 @@
+; RUN: opt -passes=mergefunc -S < %s | FileCheck %s
+
+; The hash refines StructuralHash with types and predicates. Functions that
+; FunctionComparator considers equal must still be merged, whatever their
+; block layout, and functions differing only in types must not be.
+
+; CHECK-LABEL: define i32 @layout_a(
+; CHECK: icmp slt i32
+; CHECK-LABEL: define i32 @layout_b(
+; CHECK-NEXT: tail call i32 @layout_a(
+; CHECK-NEXT: ret i32
+
+; CHECK-LABEL: define i32 @width_32(
+; CHECK: add i32
+; CHECK-LABEL: define i64 @width_64(
+; CHECK: add i64
+
+define i32 @layout_a(i32 %x) {
+entry:
+  %c = icmp slt i32 %x, 0
+  br i1 %c, label %neg, label %pos
+neg:
+  %n = sub i32 0, %x
+  ret i32 %n
+pos:
+  %p = mul i32 %x, 3
+  ret i32 %p
+}
+
+define i32 @layout_b(i32 %x) {
+entry:
+  %c = icmp slt i32 %x, 0
+  br i1 %c, label %neg, label %pos
+pos:
+  %p = mul i32 %x, 3
+  ret i32 %p
+neg:
+  %n = sub i32 0, %x
+  ret i32 %n
+}
+
+define i32 @width_32(i32 %x) {
+  %a = add i32 %x, 7
+  %b = xor i32 %a, 5
+  ret i32 %b
+}
+
+define i64 @width_64(i64 %x) {
+  %a = add i64 %x, 7
+  %b = xor i64 %a, 5
+  ret i64 %b
+}
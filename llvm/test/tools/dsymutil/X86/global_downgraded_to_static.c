@@ -1,5 +1,5 @@
 // REQUIRES : system-darwin
-// RUN: dsymutil -oso-prepend-path %p/.. -dump-debug-map \
+// RUN: dsymutil --linker classic -oso-prepend-path %p/.. -dump-debug-map \
 // RUN: %p/../Inputs/global_downgraded_to_static.x86_64 2>&1 | FileCheck %s
 //
 // RUN: dsymutil --linker parallel -oso-prepend-path %p/.. -dump-debug-map \
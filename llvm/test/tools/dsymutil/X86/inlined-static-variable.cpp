@@ -1,4 +1,4 @@
-// RUN: dsymutil -f -y %p/dummy-debug-map.map -oso-prepend-path \
+// RUN: dsymutil --linker classic -f -y %p/dummy-debug-map.map -oso-prepend-path \
 // RUN:   %p/../Inputs/inlined-static-variable -o - -keep-function-for-static \
 // RUN:   | llvm-dwarfdump - | FileCheck %s --implicit-check-not \
 // RUN:   "{{DW_AT_low_pc|DW_AT_high_pc|DW_AT_location|DW_TAG|NULL}}" \
@@ -16,7 +16,7 @@ EOF
      -fdisable-module-hash submodules.m -o 1.o
 */
 
-// RUN: dsymutil -f -oso-prepend-path=%p/../Inputs/submodules \
+// RUN: dsymutil --linker classic -f -oso-prepend-path=%p/../Inputs/submodules \
 // RUN:   -y %p/dummy-debug-map.map -o - \
 // RUN:     | llvm-dwarfdump -v --debug-info - | FileCheck %s
 
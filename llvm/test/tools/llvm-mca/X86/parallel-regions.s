@@ -0,0 +1,36 @@
+# REQUIRES: x86-registered-target
+## Test that simulating code regions on several threads gives the same report,
+## in the same order, as simulating them one after another. The encoding view
+## makes every job use a code emitter.
+
+# RUN: llvm-mca -mtriple=x86_64-unknown-unknown -mcpu=znver2 -iterations=10 -show-encoding -all-views -j 1 %s > %t.serial
+# RUN: llvm-mca -mtriple=x86_64-unknown-unknown -mcpu=znver2 -iterations=10 -show-encoding -all-views -j 4 %s > %t.parallel
+# RUN: diff %t.serial %t.parallel
+# RUN: FileCheck %s --input-file=%t.parallel
+
+# CHECK:      [0] Code Region - first
+# CHECK:      [1] Code Region - second
+# CHECK:      [2] Code Region - third
+# CHECK:      [3] Code Region - fourth
+
+# LLVM-MCA-BEGIN first
+addl %eax, %ebx
+imull %ecx, %edx
+# LLVM-MCA-END
+
+# LLVM-MCA-BEGIN second
+vaddps %ymm0, %ymm1, %ymm2
+vmulps %ymm2, %ymm3, %ymm4
+# LLVM-MCA-END
+
+# LLVM-MCA-BEGIN third
+movq (%rdi), %rax
+addq $42, %rax
+movq %rax, 8(%rdi)
+# LLVM-MCA-END
+
+# LLVM-MCA-BEGIN fourth
+jmp foo
+foo:
+leaq foo(%rip), %rsi
+# LLVM-MCA-END
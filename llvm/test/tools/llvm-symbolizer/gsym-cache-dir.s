@@ -0,0 +1,30 @@
+# REQUIRES: x86-registered-target
+## Test that --gsym-cache-dir keys the converted GSYM file on the object's
+## contents, not on its path or modification time.
+
+# RUN: rm -rf %t && mkdir %t && cd %t
+# RUN: llvm-mc -filetype=obj -triple=x86_64 -g %s -o a.o
+# RUN: llvm-symbolizer --obj=a.o --gsym-cache-dir=cache 0 | FileCheck %s
+# RUN: ls cache | count 1
+
+## A newer modification time alone does not create another file.
+# RUN: touch a.o
+# RUN: llvm-symbolizer --obj=a.o --gsym-cache-dir=cache 0 | FileCheck %s
+# RUN: ls cache | count 1
+
+## Different contents at the same path get their own file.
+# RUN: llvm-mc -filetype=obj -triple=x86_64 -g --defsym=EXTRA=1 %s -o a.o
+# RUN: llvm-symbolizer --obj=a.o --gsym-cache-dir=cache 0 | FileCheck %s
+# RUN: ls cache | count 2
+
+# CHECK: foo
+# CHECK-NEXT: gsym-cache-dir.s:[[#@LINE+5]]
+
+.globl foo
+.type foo,@function
+foo:
+  ret
+.ifdef EXTRA
+  nop
+.endif
+.size foo, .-foo
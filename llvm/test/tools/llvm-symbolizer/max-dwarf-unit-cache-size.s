@@ -0,0 +1,29 @@
+# REQUIRES: x86-registered-target
+## Test that --max-dwarf-unit-cache-size bounds the DWARF units kept between
+## lookups without changing the results, even when every lookup frees the
+## DIEs of the unit used before it.
+
+# RUN: llvm-mc -filetype=obj -triple=x86_64 -g %s -o %t.o
+# RUN: llvm-symbolizer --obj=%t.o 0 1 0 | FileCheck %s
+# RUN: llvm-symbolizer --obj=%t.o --max-dwarf-unit-cache-size=1 0 1 0 | FileCheck %s
+
+# CHECK:      foo
+# CHECK-NEXT: max-dwarf-unit-cache-size.s:[[#FOO:@LINE+13]]
+# CHECK-EMPTY:
+# CHECK-NEXT: bar
+# CHECK-NEXT: max-dwarf-unit-cache-size.s:[[#FOO+4]]
+# CHECK-EMPTY:
+# CHECK-NEXT: foo
+# CHECK-NEXT: max-dwarf-unit-cache-size.s:[[#FOO]]
+
+# RUN: not llvm-symbolizer --obj=%t.o --max-dwarf-unit-cache-size=x 0 2>&1 | FileCheck %s --check-prefix=ERR
+# ERR: --max-dwarf-unit-cache-size=: expected a non-negative integer, but got 'x'
+
+.type foo,@function
+foo:
+  ret
+.size foo, .-foo
+.type bar,@function
+bar:
+  ret
+.size bar, .-bar
@@ -11,7 +11,8 @@
 /// queries the debuginfod servers in the DEBUGINFOD_URLS environment
 /// variable (delimited by space (" ")) for the executable,
 /// debuginfo, or specified source file of the binary matching the
-/// given build-id.
+/// given build-id. Several build-ids can be given for executables and
+/// debuginfo, in which case they are fetched concurrently.
 ///
 //===----------------------------------------------------------------------===//
 
@@ -26,9 +27,9 @@ using namespace llvm;
 
 cl::OptionCategory DebuginfodFindCategory("llvm-debuginfod-find Options");
 
-cl::opt<std::string> InputBuildID(cl::Positional, cl::Required,
-                                  cl::desc("<input build_id>"), cl::init("-"),
-                                  cl::cat(DebuginfodFindCategory));
+cl::list<std::string> InputBuildIDs(cl::Positional, cl::OneOrMore,
+                                    cl::desc("<input build_id>..."),
+                                    cl::cat(DebuginfodFindCategory));
 
 static cl::opt<bool>
     FetchExecutable("executable", cl::init(false),
@@ -69,6 +70,8 @@ static cl::list<std::string> DebugFileDirectory(
 ExitOnError ExitOnErr;
 
 static std::string fetchDebugInfo(object::BuildIDRef BuildID);
+static std::vector<std::string>
+fetchSeveral(ArrayRef<object::BuildID> BuildIDs);
 
 int main(int argc, char **argv) {
   InitLLVM X(argc, argv);
@@ -83,38 +86,86 @@ int main(int argc, char **argv) {
       "set by these environment variables:\n"
       "DEBUGINFOD_CACHE_PATH (default set by sys::path::cache_directory)\n"
       "DEBUGINFOD_TIMEOUT (defaults to 90s)\n"
-      "DEBUGINFOD_URLS=[comma separated URLs] (defaults to empty)\n");
+      "DEBUGINFOD_URLS=[comma separated URLs] (defaults to empty)\n"
+      "DEBUGINFOD_MAX_CONNECTIONS (defaults to 8)\n");
 
   if (FetchExecutable + FetchDebuginfo + (FetchSource != "") != 1)
     helpExit();
-
-  std::string IDString;
-  if (!tryGetFromHex(InputBuildID, IDString)) {
-    errs() << "Build ID " << InputBuildID << " is not a hex string.\n";
+  if (FetchSource != "" && InputBuildIDs.size() != 1) {
+    errs() << "--source takes exactly one build ID.\n";
     exit(1);
   }
-  object::BuildID ID(IDString.begin(), IDString.end());
 
-  std::string Path;
-  if (FetchSource != "")
-    Path = ExitOnErr(getCachedOrDownloadSource(ID, FetchSource));
+  std::vector<object::BuildID> IDs;
+  for (const std::string &InputBuildID : InputBuildIDs) {
+    std::string IDString;
+    if (!tryGetFromHex(InputBuildID, IDString)) {
+      errs() << "Build ID " << InputBuildID << " is not a hex string.\n";
+      exit(1);
+    }
+    IDs.emplace_back(IDString.begin(), IDString.end());
+  }
+
+  std::vector<std::string> Paths;
+  if (IDs.size() > 1)
+    Paths = fetchSeveral(IDs);
+  else if (FetchSource != "")
+    Paths.push_back(ExitOnErr(getCachedOrDownloadSource(IDs[0], FetchSource)));
   else if (FetchExecutable)
-    Path = ExitOnErr(getCachedOrDownloadExecutable(ID));
+    Paths.push_back(ExitOnErr(getCachedOrDownloadExecutable(IDs[0])));
   else if (FetchDebuginfo)
-    Path = fetchDebugInfo(ID);
+    Paths.push_back(fetchDebugInfo(IDs[0]));
   else
     llvm_unreachable("We have already checked that exactly one of the above "
                      "conditions is true.");
 
-  if (DumpToStdout) {
-    // Print the contents of the artifact.
-    ErrorOr<std::unique_ptr<MemoryBuffer>> Buf = MemoryBuffer::getFile(
-        Path, /*IsText=*/false, /*RequiresNullTerminator=*/false);
-    ExitOnErr(errorCodeToError(Buf.getError()));
-    outs() << Buf.get()->getBuffer();
-  } else
-    // Print the path to the cached artifact file.
-    outs() << Path << "\n";
+  for (const std::string &Path : Paths) {
+    if (DumpToStdout) {
+      // Print the contents of the artifact.
+      ErrorOr<std::unique_ptr<MemoryBuffer>> Buf = MemoryBuffer::getFile(
+          Path, /*IsText=*/false, /*RequiresNullTerminator=*/false);
+      ExitOnErr(errorCodeToError(Buf.getError()));
+      outs() << Buf.get()->getBuffer();
+    } else
+      // Print the path to the cached artifact file.
+      outs() << Path << "\n";
+  }
+}
+
+// Fetch the executables or debug files of several build IDs, downloading the
+// ones that are not found locally concurrently.
+std::vector<std::string> fetchSeveral(ArrayRef<object::BuildID> BuildIDs) {
+  std::vector<std::string> Paths(BuildIDs.size());
+  std::vector<size_t> ToDownload;
+  std::vector<std::string> UrlPaths;
+  for (size_t I = 0, E = BuildIDs.size(); I != E; ++I) {
+    if (FetchDebuginfo) {
+      if (std::optional<std::string> Path =
+              object::BuildIDFetcher(DebugFileDirectory).fetch(BuildIDs[I])) {
+        Paths[I] = *Path;
+        continue;
+      }
+      UrlPaths.push_back(getDebuginfodDebuginfoUrlPath(BuildIDs[I]));
+    } else {
+      UrlPaths.push_back(getDebuginfodExecutableUrlPath(BuildIDs[I]));
+    }
+    ToDownload.push_back(I);
+  }
+
+  std::vector<Expected<std::string>> Downloaded =
+      getCachedOrDownloadArtifacts(UrlPaths);
+  for (size_t I = 0, E = ToDownload.size(); I != E; ++I) {
+    Expected<std::string> &PathOrErr = Downloaded[I];
+    if (!PathOrErr) {
+      consumeError(PathOrErr.takeError());
+      errs() << "Build ID "
+             << llvm::toHex(BuildIDs[ToDownload[I]], /*Lowercase=*/true)
+             << " could not be found.\n";
+      exit(1);
+    }
+    Paths[ToDownload[I]] = std::move(*PathOrErr);
+  }
+  return Paths;
 }
 
 // Find a debug file in local build ID directories and via debuginfod.
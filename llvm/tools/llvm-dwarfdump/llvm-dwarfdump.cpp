@@ -775,7 +775,8 @@ static bool handleBuffer(StringRef Filename, MemoryBufferRef Buffer,
     if (filterArch(*Obj)) {
       std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(
           *Obj, DWARFContext::ProcessDebugRelocations::Process, nullptr, "",
-          RecoverableErrorHandler);
+          RecoverableErrorHandler, WithColor::defaultWarningHandler,
+          /*ThreadSafe=*/Verify);
       DICtx->setParseCUTUIndexManually(ManuallyGenerateUnitIndex);
       if (!HandleObj(*Obj, *DICtx, Filename, OS))
         Result = false;
@@ -789,7 +790,8 @@ static bool handleBuffer(StringRef Filename, MemoryBufferRef Buffer,
         if (filterArch(Obj)) {
           std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(
               Obj, DWARFContext::ProcessDebugRelocations::Process, nullptr, "",
-              RecoverableErrorHandler);
+              RecoverableErrorHandler, WithColor::defaultWarningHandler,
+              /*ThreadSafe=*/Verify);
           if (!HandleObj(Obj, *DICtx, ObjName, OS))
             Result = false;
         }
@@ -39,14 +39,23 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/TargetParser/Host.h"
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <string>
 
+#ifdef __linux__
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif // __linux__
+
 namespace llvm {
 namespace exegesis {
 
@@ -269,6 +278,20 @@ static cl::list<ValidationEvent> ValidationCounters(
         "counter to validate benchmarking assumptions"),
     cl::CommaSeparated, cl::cat(BenchmarkOptions), ValidationEventOptions());
 
+static cl::list<unsigned> BenchmarkCores(
+    "benchmark-cores",
+    cl::desc("Measure on the given cores in parallel: the configurations are "
+             "split into one batch per core, and each batch is measured by a "
+             "worker process pinned to its core (Linux only)"),
+    cl::CommaSeparated, cl::cat(BenchmarkOptions));
+
+static cl::opt<double> MaxMeasurementNoise(
+    "max-measurement-noise",
+    cl::desc("Measure each configuration twice, and mark it as failed if the "
+             "two measurements differ by more than this fraction (0 disables "
+             "the check)"),
+    cl::cat(BenchmarkOptions), cl::init(0.0));
+
 static ExitOnError ExitOnErr("llvm-exegesis error: ");
 
 // Helper function that logs the error(s) and exits.
@@ -381,70 +404,90 @@ generateSnippets(const LLVMState &State, unsigned Opcode,
   return Benchmarks;
 }
 
-static void runBenchmarkConfigurations(
-    const LLVMState &State, ArrayRef<BenchmarkCode> Configurations,
+static Benchmark measureConfiguration(
+    const BenchmarkCode &Conf,
     ArrayRef<std::unique_ptr<const SnippetRepetitor>> Repetitors,
     const BenchmarkRunner &Runner) {
-  assert(!Configurations.empty() && "Don't have any configurations to run.");
-  std::optional<raw_fd_ostream> FileOstr;
-  if (BenchmarkFile != "-") {
-    int ResultFD = 0;
-    // Create output file or open existing file and truncate it, once.
-    ExitOnErr(errorCodeToError(openFileForWrite(BenchmarkFile, ResultFD,
-                                                sys::fs::CD_CreateAlways,
-                                                sys::fs::OF_TextWithCRLF)));
-    FileOstr.emplace(ResultFD, true /*shouldClose*/);
-  }
-  raw_ostream &Ostr = FileOstr ? *FileOstr : outs();
-
-  std::optional<ProgressMeter<>> Meter;
-  if (BenchmarkMeasurementsPrintProgress)
-    Meter.emplace(Configurations.size());
-
   SmallVector<unsigned, 2> MinInstructionCounts = {MinInstructions};
   if (RepetitionMode == Benchmark::MiddleHalfDuplicate ||
       RepetitionMode == Benchmark::MiddleHalfLoop)
     MinInstructionCounts.push_back(MinInstructions * 2);
 
-  for (const BenchmarkCode &Conf : Configurations) {
-    ProgressMeter<>::ProgressMeterStep MeterStep(Meter ? &*Meter : nullptr);
-    SmallVector<Benchmark, 2> AllResults;
-
-    for (const std::unique_ptr<const SnippetRepetitor> &Repetitor :
-         Repetitors) {
-      for (unsigned IterationRepetitions : MinInstructionCounts) {
-        auto RC = ExitOnErr(Runner.getRunnableConfiguration(
-            Conf, IterationRepetitions, LoopBodySize, *Repetitor));
-        std::optional<StringRef> DumpFile;
-        if (DumpObjectToDisk.getNumOccurrences())
-          DumpFile = DumpObjectToDisk;
-        auto [Err, BenchmarkResult] =
-            Runner.runConfiguration(std::move(RC), DumpFile);
-        if (Err) {
-          // Errors from executing the snippets are fine.
-          // All other errors are a framework issue and should fail.
-          if (!Err.isA<SnippetExecutionFailure>())
-            ExitOnErr(std::move(Err));
-
-          BenchmarkResult.Error = toString(std::move(Err));
-        }
-        AllResults.push_back(std::move(BenchmarkResult));
+  SmallVector<Benchmark, 2> AllResults;
+  for (const std::unique_ptr<const SnippetRepetitor> &Repetitor : Repetitors) {
+    for (unsigned IterationRepetitions : MinInstructionCounts) {
+      auto RC = ExitOnErr(Runner.getRunnableConfiguration(
+          Conf, IterationRepetitions, LoopBodySize, *Repetitor));
+      std::optional<StringRef> DumpFile;
+      if (DumpObjectToDisk.getNumOccurrences())
+        DumpFile = DumpObjectToDisk;
+      auto [Err, BenchmarkResult] =
+          Runner.runConfiguration(std::move(RC), DumpFile);
+      if (Err) {
+        // Errors from executing the snippets are fine.
+        // All other errors are a framework issue and should fail.
+        if (!Err.isA<SnippetExecutionFailure>())
+          ExitOnErr(std::move(Err));
+
+        BenchmarkResult.Error = toString(std::move(Err));
       }
+      AllResults.push_back(std::move(BenchmarkResult));
     }
+  }
 
-    Benchmark &Result = AllResults.front();
+  Benchmark &Result = AllResults.front();
 
-    // If any of our measurements failed, pretend they all have failed.
-    if (AllResults.size() > 1 &&
-        any_of(AllResults, [](const Benchmark &R) {
-          return R.Measurements.empty();
-        }))
-      Result.Measurements.clear();
+  // If any of our measurements failed, pretend they all have failed.
+  if (AllResults.size() > 1 &&
+      any_of(AllResults,
+             [](const Benchmark &R) { return R.Measurements.empty(); }))
+    Result.Measurements.clear();
 
-    std::unique_ptr<ResultAggregator> ResultAgg =
-        ResultAggregator::CreateAggregator(RepetitionMode);
-    ResultAgg->AggregateResults(Result,
-                                ArrayRef<Benchmark>(AllResults).drop_front());
+  std::unique_ptr<ResultAggregator> ResultAgg =
+      ResultAggregator::CreateAggregator(RepetitionMode);
+  ResultAgg->AggregateResults(Result,
+                              ArrayRef<Benchmark>(AllResults).drop_front());
+  return std::move(Result);
+}
+
+// Returns the largest relative difference between the per-instruction values
+// of two measurements of the same configuration.
+static double getMeasurementNoise(const Benchmark &A, const Benchmark &B) {
+  if (A.Measurements.size() != B.Measurements.size())
+    return std::numeric_limits<double>::infinity();
+  double Noise = 0.0;
+  for (const auto &[MA, MB] : zip(A.Measurements, B.Measurements)) {
+    double Max = std::max(std::abs(MA.PerInstructionValue),
+                          std::abs(MB.PerInstructionValue));
+    if (Max == 0.0)
+      continue;
+    Noise = std::max(
+        Noise, std::abs(MA.PerInstructionValue - MB.PerInstructionValue) / Max);
+  }
+  return Noise;
+}
+
+static void writeBenchmarkResults(
+    const LLVMState &State, ArrayRef<BenchmarkCode> Configurations,
+    ArrayRef<std::unique_ptr<const SnippetRepetitor>> Repetitors,
+    const BenchmarkRunner &Runner, raw_ostream &Ostr,
+    ProgressMeter<> *Meter) {
+  for (const BenchmarkCode &Conf : Configurations) {
+    ProgressMeter<>::ProgressMeterStep MeterStep(Meter);
+    Benchmark Result = measureConfiguration(Conf, Repetitors, Runner);
+
+    if (MaxMeasurementNoise > 0 && Result.Error.empty() &&
+        !Result.Measurements.empty()) {
+      Benchmark Check = measureConfiguration(Conf, Repetitors, Runner);
+      double Noise = getMeasurementNoise(Result, Check);
+      if (Noise > MaxMeasurementNoise) {
+        Result.Measurements.clear();
+        Result.Error =
+            formatv("measurements differ by {0:P}, which exceeds "
+                    "--max-measurement-noise",
+                    Noise);
+      }
+    }
 
     // With dummy counters, measurements are rather meaningless,
     // so drop them altogether.
@@ -455,6 +498,124 @@ static void runBenchmarkConfigurations(
   }
 }
 
+#ifdef __linux__
+// Splits the configurations into one contiguous batch per core in
+// BenchmarkCores, and measures each batch in a worker process pinned to its
+// core. Each worker writes its results to a temporary file; they are copied
+// to Ostr in order, so the output matches a serial run.
+static void writeBenchmarkResultsOnCores(
+    const LLVMState &State, ArrayRef<BenchmarkCode> Configurations,
+    ArrayRef<std::unique_ptr<const SnippetRepetitor>> Repetitors,
+    const BenchmarkRunner &Runner, raw_ostream &Ostr) {
+  struct Worker {
+    unsigned Core;
+    pid_t PID;
+    SmallString<128> ResultsPath;
+  };
+
+  for (unsigned Core : BenchmarkCores)
+    if (Core >= CPU_SETSIZE)
+      ExitWithError(Twine("invalid core in --benchmark-cores: ") + Twine(Core));
+
+  const size_t NumConfigurations = Configurations.size();
+  const size_t NumWorkers =
+      std::min<size_t>(BenchmarkCores.size(), NumConfigurations);
+  std::vector<Worker> Workers(NumWorkers);
+  for (size_t I = 0; I < NumWorkers; ++I) {
+    Worker &W = Workers[I];
+    W.Core = BenchmarkCores[I];
+    ExitOnErr(errorCodeToError(sys::fs::createTemporaryFile(
+        "exegesis-batch", "yaml", W.ResultsPath)));
+    const size_t Begin = I * NumConfigurations / NumWorkers;
+    const size_t End = (I + 1) * NumConfigurations / NumWorkers;
+    ArrayRef<BenchmarkCode> Batch = Configurations.slice(Begin, End - Begin);
+
+    // Don't let the worker inherit pending output.
+    outs().flush();
+    errs().flush();
+    W.PID = fork();
+    if (W.PID == -1)
+      ExitWithError(Twine("cannot create worker process: ") + strerror(errno));
+    if (W.PID != 0)
+      continue;
+
+    // We are in the worker. It shares the parent's atexit handlers and static
+    // objects, so it must leave through _exit. The error paths below and in
+    // writeBenchmarkResults call exit(); redirect them to _exit as well.
+    std::atexit([] { _exit(EXIT_FAILURE); });
+    cpu_set_t CPUs;
+    CPU_ZERO(&CPUs);
+    CPU_SET(W.Core, &CPUs);
+    if (sched_setaffinity(0, sizeof(CPUs), &CPUs) == -1)
+      ExitWithError(Twine("cannot pin worker to core ") + Twine(W.Core) +
+                    ": " + strerror(errno));
+    std::error_code EC;
+    raw_fd_ostream ResultsOstr(W.ResultsPath, EC, sys::fs::OF_TextWithCRLF);
+    ExitOnFileError(W.ResultsPath, errorCodeToError(EC));
+    writeBenchmarkResults(State, Batch, Repetitors, Runner, ResultsOstr,
+                          /*Meter=*/nullptr);
+    ResultsOstr.close();
+    ExitOnFileError(W.ResultsPath, errorCodeToError(ResultsOstr.error()));
+    _exit(EXIT_SUCCESS);
+  }
+
+  bool Failed = false;
+  for (Worker &W : Workers) {
+    int Status = 0;
+    if (waitpid(W.PID, &Status, 0) == -1 || !WIFEXITED(Status) ||
+        WEXITSTATUS(Status) != EXIT_SUCCESS) {
+      errs() << "worker on core " << W.Core << " failed\n";
+      Failed = true;
+    }
+  }
+
+  for (Worker &W : Workers) {
+    if (!Failed) {
+      auto Results = ExitOnFileError(
+          W.ResultsPath, errorOrToExpected(MemoryBuffer::getFile(
+                             W.ResultsPath, /*IsText=*/true)));
+      Ostr << Results->getBuffer();
+    }
+    sys::fs::remove(W.ResultsPath);
+  }
+  if (Failed)
+    ExitWithError("benchmarking failed on some of the --benchmark-cores");
+}
+#endif // __linux__
+
+static void runBenchmarkConfigurations(
+    const LLVMState &State, ArrayRef<BenchmarkCode> Configurations,
+    ArrayRef<std::unique_ptr<const SnippetRepetitor>> Repetitors,
+    const BenchmarkRunner &Runner) {
+  assert(!Configurations.empty() && "Don't have any configurations to run.");
+  std::optional<raw_fd_ostream> FileOstr;
+  if (BenchmarkFile != "-") {
+    int ResultFD = 0;
+    // Create output file or open existing file and truncate it, once.
+    ExitOnErr(errorCodeToError(openFileForWrite(BenchmarkFile, ResultFD,
+                                                sys::fs::CD_CreateAlways,
+                                                sys::fs::OF_TextWithCRLF)));
+    FileOstr.emplace(ResultFD, true /*shouldClose*/);
+  }
+  raw_ostream &Ostr = FileOstr ? *FileOstr : outs();
+
+  if (!BenchmarkCores.empty()) {
+#ifdef __linux__
+    writeBenchmarkResultsOnCores(State, Configurations, Repetitors, Runner,
+                                 Ostr);
+    return;
+#else
+    ExitWithError("--benchmark-cores is only supported on Linux");
+#endif
+  }
+
+  std::optional<ProgressMeter<>> Meter;
+  if (BenchmarkMeasurementsPrintProgress)
+    Meter.emplace(Configurations.size());
+  writeBenchmarkResults(State, Configurations, Repetitors, Runner, Ostr,
+                        Meter ? &*Meter : nullptr);
+}
+
 void benchmarkMain() {
   if (BenchmarkPhaseSelector == BenchmarkPhaseSelectorE::Measure &&
       !UseDummyPerfCounters) {
@@ -22,6 +22,7 @@
 #include "llvm/Support/LLVMDriver.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Regex.h"
 #include "llvm/Support/Signals.h"
@@ -310,6 +311,8 @@ static llvm::Error handleObjectFile(ObjectFile &Obj, const std::string &OutFile,
                                     OutputAggregator &Out) {
   auto ThreadCount =
       NumThreads > 0 ? NumThreads : std::thread::hardware_concurrency();
+  // GsymCreator sorts and encodes the function infos in parallel as well.
+  parallel::strategy = hardware_concurrency(ThreadCount);
 
   GsymCreator Gsym(Quiet);
 
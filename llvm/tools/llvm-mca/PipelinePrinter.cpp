@@ -18,7 +18,14 @@
 namespace llvm {
 namespace mca {
 
-void PipelinePrinter::printRegionHeader(llvm::raw_ostream &OS) const {
+void PipelinePrinter::printRegionHeader(llvm::raw_ostream &OS,
+                                        const CodeRegion &Region,
+                                        unsigned RegionIdx) {
+  // Don't print the header of this region if it is the default region, and if
+  // it doesn't have an end location.
+  if (!Region.startLoc().isValid() && !Region.endLoc().isValid())
+    return;
+
   StringRef RegionName;
   if (!Region.getDescription().empty())
     RegionName = Region.getDescription();
@@ -115,15 +122,15 @@ void PipelinePrinter::printReport(json::Object &JO) const {
   Regions->push_back(getJSONReportRegion());
 }
 
-void PipelinePrinter::printReport(llvm::raw_ostream &OS) const {
-  // Don't print the header of this region if it is the default region, and if
-  // it doesn't have an end location.
-  if (Region.startLoc().isValid() || Region.endLoc().isValid())
-    printRegionHeader(OS);
-
+void PipelinePrinter::printViews(llvm::raw_ostream &OS) const {
   for (const auto &V : Views)
     V->printView(OS);
 }
 
+void PipelinePrinter::printReport(llvm::raw_ostream &OS) const {
+  printRegionHeader(OS, Region, RegionIdx);
+  printViews(OS);
+}
+
 } // namespace mca
 } // namespace llvm
@@ -45,7 +45,6 @@ class PipelinePrinter {
   const PipelineOptions &PO;
   llvm::SmallVector<std::unique_ptr<View>, 8> Views;
 
-  void printRegionHeader(llvm::raw_ostream &OS) const;
   json::Object getJSONReportRegion() const;
   json::Object getJSONTargetInfo() const;
   json::Object getJSONSimulationParameters() const;
@@ -60,6 +59,15 @@ public:
     Views.emplace_back(std::move(V));
   }
 
+  /// Print the header of region R, numbered Idx, unless R is the default
+  /// region without explicit bounds.
+  static void printRegionHeader(llvm::raw_ostream &OS, const CodeRegion &R,
+                                unsigned Idx);
+
+  /// Print the views only. Used when regions are simulated concurrently and
+  /// their headers are printed once the regions have been numbered.
+  void printViews(llvm::raw_ostream &OS) const;
+
   void printReport(llvm::raw_ostream &OS) const;
   void printReport(json::Object &JO) const;
 };
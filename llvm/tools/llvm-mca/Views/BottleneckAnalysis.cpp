@@ -641,5 +641,24 @@ void BottleneckAnalysis::printView(raw_ostream &OS) const {
   printCriticalSequence(OS);
 }
 
+json::Value BottleneckAnalysis::toJSON() const {
+  json::Object JO({{"TotalCycles", TotalCycles},
+                   {"SeenStallCycles", SeenStallCycles},
+                   {"PressureIncreaseCycles", BPI.PressureIncreaseCycles},
+                   {"ResourcePressureCycles", BPI.ResourcePressureCycles},
+                   {"DataDependencyCycles", BPI.DataDependencyCycles},
+                   {"RegisterDependencyCycles", BPI.RegisterDependencyCycles},
+                   {"MemoryDependencyCycles", BPI.MemoryDependencyCycles}});
+
+  json::Object Resources;
+  ArrayRef<unsigned> Distribution = Tracker.getResourcePressureDistribution();
+  const MCSchedModel &SM = getSubTargetInfo().getSchedModel();
+  for (unsigned I = 0, E = Distribution.size(); I < E; ++I)
+    if (Distribution[I])
+      Resources.try_emplace(SM.getProcResource(I)->Name, Distribution[I]);
+  JO.try_emplace("ResourcePressure", std::move(Resources));
+  return JO;
+}
+
 } // namespace mca.
 } // namespace llvm
@@ -55,6 +55,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/ToolOutputFile.h"
@@ -266,6 +267,17 @@ static cl::opt<bool> DisableInstrumentManager(
              "ignores instruments.)."),
     cl::cat(ViewOptions), cl::init(false));
 
+static cl::opt<unsigned>
+    NumThreads("j", cl::desc("Number of threads used to simulate code regions "
+                             "(0 = all available threads)"),
+               cl::value_desc("N"), cl::cat(ToolOptions), cl::init(1));
+
+static cl::list<std::string> SweepMCPUs(
+    "sweep-mcpus", cl::CommaSeparated,
+    cl::desc("Simulate every code region on each of the given cpus, and print "
+             "the summary and bottleneck analysis of each region as json"),
+    cl::value_desc("cpu1,cpu2,..."), cl::cat(ToolOptions));
+
 namespace {
 
 const Target *getTarget(const char *ProgName) {
@@ -332,16 +344,356 @@ static void processViewOptions(bool IsOutOfOrder) {
 }
 
 // Returns true on success.
-static bool runPipeline(mca::Pipeline &P) {
+static bool runPipeline(mca::Pipeline &P, raw_ostream &ErrOS) {
   // Handle pipeline errors here.
   Expected<unsigned> Cycles = P.run();
   if (!Cycles) {
-    WithColor::error() << toString(Cycles.takeError());
+    WithColor::error(ErrOS) << toString(Cycles.takeError());
     return false;
   }
   return true;
 }
 
+namespace {
+
+/// The target description objects that are shared by all simulations for one
+/// cpu. Everything that is modified while simulating a region is created per
+/// region instead, so that regions can be simulated concurrently.
+struct SimulationTarget {
+  const Target &TheTarget;
+  const MCSubtargetInfo &STI;
+  const MCRegisterInfo &MRI;
+  const MCAsmInfo &MAI;
+  const MCInstrInfo &MCII;
+  const mca::InstrumentRegions &InstrumentRegions;
+  const mca::PipelineOptions &PO;
+  unsigned AssemblerDialect;
+};
+
+/// The result of simulating one code region.
+struct RegionReport {
+  // Set if the simulation failed. The reason is in Diagnostics.
+  bool Failed = false;
+  // Set if all instructions of the region were skipped.
+  bool Empty = false;
+  std::string Diagnostics;
+  std::string Text;
+  json::Object JSON;
+};
+
+} // end of anonymous namespace
+
+// Lower and simulate Region on T, and record the views in Report. Regions are
+// numbered once all of them have been simulated, so the report does not
+// include the region header.
+static void simulateRegion(const SimulationTarget &T,
+                           const mca::AnalysisRegion &Region, bool Sweep,
+                           RegionReport &Report) {
+  raw_string_ostream ErrOS(Report.Diagnostics);
+  const MCSubtargetInfo &STI = T.STI;
+  const MCSchedModel &SM = STI.getSchedModel();
+  bool IsOutOfOrder = SM.isOutOfOrder();
+
+  std::unique_ptr<MCInstPrinter> IP(T.TheTarget.createMCInstPrinter(
+      STI.getTargetTriple(), T.AssemblerDialect, T.MAI, T.MCII, T.MRI));
+  assert(IP && "Unable to create instruction printer!");
+  IP->setPrintImmHex(PrintImmHex);
+
+  std::unique_ptr<MCInstrAnalysis> MCIA(
+      T.TheTarget.createMCInstrAnalysis(&T.MCII));
+
+  std::unique_ptr<mca::InstrumentManager> IM;
+  if (!DisableInstrumentManager)
+    IM = std::unique_ptr<mca::InstrumentManager>(
+        T.TheTarget.createInstrumentManager(STI, T.MCII));
+  if (!IM)
+    IM = std::make_unique<mca::InstrumentManager>(STI, T.MCII);
+
+  std::unique_ptr<mca::InstrPostProcess> IPP;
+  if (!DisableCustomBehaviour) {
+    // TODO: It may be a good idea to separate CB and IPP so that they can
+    // be used independently of each other. What I mean by this is to add
+    // an extra command-line arg --disable-ipp so that CB and IPP can be
+    // toggled without needing to toggle both of them together.
+    IPP = std::unique_ptr<mca::InstrPostProcess>(
+        T.TheTarget.createInstrPostProcess(STI, T.MCII));
+  }
+  if (!IPP) {
+    // If the target doesn't have its own IPP implemented (or the -disable-cb
+    // flag is set) then we use the base class (which does nothing).
+    IPP = std::make_unique<mca::InstrPostProcess>(STI, T.MCII);
+  }
+
+  // Create an instruction builder.
+  mca::InstrBuilder IB(STI, T.MCII, T.MRI, MCIA.get(), *IM);
+
+  // Create a context to control ownership of the pipeline hardware.
+  mca::Context MCA(T.MRI, STI);
+
+  // Encoding may create symbols in, and report errors to, the MCContext, so
+  // every job has a context of its own.
+  MCContext Ctx(STI.getTargetTriple(), &T.MAI, &T.MRI, &STI);
+  std::unique_ptr<MCCodeEmitter> MCE(
+      T.TheTarget.createMCCodeEmitter(T.MCII, Ctx));
+  assert(MCE && "Unable to create code emitter!");
+
+  std::unique_ptr<MCAsmBackend> MAB(T.TheTarget.createMCAsmBackend(
+      STI, T.MRI, mc::InitMCTargetOptionsFromFlags()));
+  assert(MAB && "Unable to create asm backend!");
+
+  // Lower the MCInst sequence into an mca::Instruction sequence.
+  ArrayRef<MCInst> Insts = Region.getInstructions();
+
+  DenseMap<const MCInst *, SmallVector<mca::Instrument *>> InstToInstruments;
+  SmallVector<std::unique_ptr<mca::Instruction>> LoweredSequence;
+  SmallPtrSet<const MCInst *, 16> DroppedInsts;
+  for (const MCInst &MCI : Insts) {
+    SMLoc Loc = MCI.getLoc();
+    const SmallVector<mca::Instrument *> Instruments =
+        T.InstrumentRegions.getActiveInstruments(Loc);
+
+    Expected<std::unique_ptr<mca::Instruction>> Inst =
+        IB.createInstruction(MCI, Instruments);
+    if (!Inst) {
+      if (auto NewE = handleErrors(
+              Inst.takeError(),
+              [&IP, &STI, &ErrOS](const mca::InstructionError<MCInst> &IE) {
+                std::string InstructionStr;
+                raw_string_ostream SS(InstructionStr);
+                if (shouldSkip(SkipType::LACK_SCHED))
+                  WithColor::warning(ErrOS)
+                      << IE.Message
+                      << ", skipping with -skip-unsupported-instructions, "
+                         "note accuracy will be impacted:\n";
+                else
+                  WithColor::error(ErrOS)
+                      << IE.Message
+                      << ", use -skip-unsupported-instructions=lack-sched to "
+                         "ignore these on the input.\n";
+                IP->printInst(&IE.Inst, 0, "", STI, SS);
+                SS.flush();
+                WithColor::note(ErrOS)
+                    << "instruction: " << InstructionStr << '\n';
+              })) {
+        // Default case.
+        WithColor::error(ErrOS) << toString(std::move(NewE));
+      }
+      if (shouldSkip(SkipType::LACK_SCHED)) {
+        DroppedInsts.insert(&MCI);
+        continue;
+      }
+      Report.Failed = true;
+      return;
+    }
+
+    IPP->postProcessInstruction(Inst.get(), MCI);
+    InstToInstruments.insert({&MCI, Instruments});
+    LoweredSequence.emplace_back(std::move(Inst.get()));
+  }
+
+  // Drop the skipped instructions from a copy of the region, since the same
+  // region may be simulated for other cpus at the same time.
+  SmallVector<MCInst, 16> KeptInsts;
+  if (!DroppedInsts.empty()) {
+    DenseMap<const MCInst *, SmallVector<mca::Instrument *>> KeptInstruments;
+    KeptInsts.reserve(Insts.size() - DroppedInsts.size());
+    for (const MCInst &MCI : Insts) {
+      if (DroppedInsts.contains(&MCI))
+        continue;
+      KeptInsts.push_back(MCI);
+      KeptInstruments.insert({&KeptInsts.back(), InstToInstruments[&MCI]});
+    }
+    Insts = KeptInsts;
+    InstToInstruments = std::move(KeptInstruments);
+  }
+
+  // Skip empty regions.
+  if (Insts.empty()) {
+    Report.Empty = true;
+    return;
+  }
+
+  mca::CodeEmitter CE(STI, *MAB, *MCE, Insts);
+  mca::CircularSourceMgr S(LoweredSequence,
+                           PrintInstructionTables ? 1 : Iterations);
+  raw_string_ostream TextOS(Report.Text);
+
+  if (PrintInstructionTables && !Sweep) {
+    //  Create a pipeline, stages, and a printer.
+    auto P = std::make_unique<mca::Pipeline>();
+    P->appendStage(std::make_unique<mca::EntryStage>(S));
+    P->appendStage(std::make_unique<mca::InstructionTables>(SM));
+
+    mca::PipelinePrinter Printer(*P, Region, 0, STI, T.PO);
+    if (PrintJson) {
+      Printer.addView(
+          std::make_unique<mca::InstructionView>(STI, *IP, Insts));
+    }
+
+    // Create the views for this pipeline, execute, and emit a report.
+    if (PrintInstructionInfoView) {
+      Printer.addView(std::make_unique<mca::InstructionInfoView>(
+          STI, T.MCII, CE, ShowEncoding, Insts, *IP, LoweredSequence,
+          ShowBarriers, *IM, InstToInstruments));
+    }
+    Printer.addView(
+        std::make_unique<mca::ResourcePressureView>(STI, *IP, Insts));
+
+    if (!runPipeline(*P, ErrOS)) {
+      Report.Failed = true;
+      return;
+    }
+
+    if (PrintJson)
+      Printer.printReport(Report.JSON);
+    else
+      Printer.printViews(TextOS);
+    return;
+  }
+
+  // Create the CustomBehaviour object for enforcing Target Specific
+  // behaviours and dependencies that aren't expressed well enough
+  // in the tablegen. CB cannot depend on the list of MCInst or
+  // the source code (but it can depend on the list of
+  // mca::Instruction or any objects that can be reconstructed
+  // from the target information).
+  std::unique_ptr<mca::CustomBehaviour> CB;
+  if (!DisableCustomBehaviour)
+    CB = std::unique_ptr<mca::CustomBehaviour>(
+        T.TheTarget.createCustomBehaviour(STI, S, T.MCII));
+  if (!CB)
+    // If the target doesn't have its own CB implemented (or the -disable-cb
+    // flag is set) then we use the base class (which does nothing).
+    CB = std::make_unique<mca::CustomBehaviour>(STI, S, T.MCII);
+
+  // Create a basic pipeline simulating an out-of-order backend.
+  auto P = MCA.createDefaultPipeline(T.PO, S, *CB);
+
+  mca::PipelinePrinter Printer(*P, Region, 0, STI, T.PO);
+
+  // A sweep only reports the throughput summary and the bottlenecks.
+  if (Sweep) {
+    Printer.addView(
+        std::make_unique<mca::SummaryView>(SM, Insts, DispatchWidth));
+    if (IsOutOfOrder)
+      Printer.addView(std::make_unique<mca::BottleneckAnalysis>(
+          STI, *IP, Insts, S.getNumIterations()));
+    if (!runPipeline(*P, ErrOS)) {
+      Report.Failed = true;
+      return;
+    }
+    Printer.printReport(Report.JSON);
+    return;
+  }
+
+  // Targets can define their own custom Views that exist within their
+  // /lib/Target/ directory so that the View can utilize their CustomBehaviour
+  // or other backend symbols / functionality that are not already exposed
+  // through one of the MC-layer classes. These Views will be initialized
+  // using the CustomBehaviour::getViews() variants.
+  // If a target makes a custom View that does not depend on their target
+  // CB or their backend, they should put the View within
+  // /tools/llvm-mca/Views/ instead.
+  if (!DisableCustomBehaviour) {
+    std::vector<std::unique_ptr<mca::View>> CBViews =
+        CB->getStartViews(*IP, Insts);
+    for (auto &CBView : CBViews)
+      Printer.addView(std::move(CBView));
+  }
+
+  // When we output JSON, we add a view that contains the instructions
+  // and CPU resource information.
+  if (PrintJson) {
+    auto IV = std::make_unique<mca::InstructionView>(STI, *IP, Insts);
+    Printer.addView(std::move(IV));
+  }
+
+  if (PrintSummaryView)
+    Printer.addView(
+        std::make_unique<mca::SummaryView>(SM, Insts, DispatchWidth));
+
+  if (EnableBottleneckAnalysis) {
+    if (!IsOutOfOrder) {
+      WithColor::warning(ErrOS)
+          << "bottleneck analysis is not supported for in-order CPU '"
+          << STI.getCPU() << "'.\n";
+    }
+    Printer.addView(std::make_unique<mca::BottleneckAnalysis>(
+        STI, *IP, Insts, S.getNumIterations()));
+  }
+
+  if (PrintInstructionInfoView)
+    Printer.addView(std::make_unique<mca::InstructionInfoView>(
+        STI, T.MCII, CE, ShowEncoding, Insts, *IP, LoweredSequence,
+        ShowBarriers, *IM, InstToInstruments));
+
+  // Fetch custom Views that are to be placed after the InstructionInfoView.
+  // Refer to the comment paired with the CB->getStartViews(*IP, Insts); line
+  // for more info.
+  if (!DisableCustomBehaviour) {
+    std::vector<std::unique_ptr<mca::View>> CBViews =
+        CB->getPostInstrInfoViews(*IP, Insts);
+    for (auto &CBView : CBViews)
+      Printer.addView(std::move(CBView));
+  }
+
+  if (PrintDispatchStats)
+    Printer.addView(std::make_unique<mca::DispatchStatistics>());
+
+  if (PrintSchedulerStats)
+    Printer.addView(std::make_unique<mca::SchedulerStatistics>(STI));
+
+  if (PrintRetireStats)
+    Printer.addView(std::make_unique<mca::RetireControlUnitStatistics>(SM));
+
+  if (PrintRegisterFileStats)
+    Printer.addView(std::make_unique<mca::RegisterFileStatistics>(STI));
+
+  if (PrintResourcePressureView)
+    Printer.addView(
+        std::make_unique<mca::ResourcePressureView>(STI, *IP, Insts));
+
+  if (PrintTimelineView) {
+    unsigned TimelineIterations =
+        TimelineMaxIterations ? TimelineMaxIterations : 10;
+    Printer.addView(std::make_unique<mca::TimelineView>(
+        STI, *IP, Insts, std::min(TimelineIterations, S.getNumIterations()),
+        TimelineMaxCycles));
+  }
+
+  // Fetch custom Views that are to be placed after all other Views.
+  // Refer to the comment paired with the CB->getStartViews(*IP, Insts); line
+  // for more info.
+  if (!DisableCustomBehaviour) {
+    std::vector<std::unique_ptr<mca::View>> CBViews =
+        CB->getEndViews(*IP, Insts);
+    for (auto &CBView : CBViews)
+      Printer.addView(std::move(CBView));
+  }
+
+  if (!runPipeline(*P, ErrOS)) {
+    Report.Failed = true;
+    return;
+  }
+
+  if (PrintJson)
+    Printer.printReport(Report.JSON);
+  else
+    Printer.printViews(TextOS);
+}
+
+// Append the region in Report, which was printed as the first region of its
+// own report, to JO.
+static void appendJSONReport(json::Object &JO, json::Object &Report) {
+  json::Array *Regions = JO.getArray("CodeRegions");
+  if (!Regions) {
+    JO = std::move(Report);
+    return;
+  }
+  for (json::Value &Region : *Report.getArray("CodeRegions"))
+    Regions->push_back(std::move(Region));
+}
+
 int main(int argc, char **argv) {
   InitLLVM X(argc, argv);
 
@@ -435,9 +787,6 @@ int main(int argc, char **argv) {
   std::unique_ptr<MCInstrInfo> MCII(TheTarget->createMCInstrInfo());
   assert(MCII && "Unable to create instruction info!");
 
-  std::unique_ptr<MCInstrAnalysis> MCIA(
-      TheTarget->createMCInstrAnalysis(MCII.get()));
-
   // Need to initialize an MCInstPrinter as it is
   // required for initializing the MCTargetStreamer
   // which needs to happen within the CRG.parseAnalysisRegions() call below.
@@ -545,278 +894,94 @@ int main(int argc, char **argv) {
     return 1;
   }
 
-  // Set the display preference for hex vs. decimal immediates.
-  IP->setPrintImmHex(PrintImmHex);
-
   std::unique_ptr<ToolOutputFile> TOF = std::move(*OF);
 
-  const MCSchedModel &SM = STI->getSchedModel();
-
-  std::unique_ptr<mca::InstrPostProcess> IPP;
-  if (!DisableCustomBehaviour) {
-    // TODO: It may be a good idea to separate CB and IPP so that they can
-    // be used independently of each other. What I mean by this is to add
-    // an extra command-line arg --disable-ipp so that CB and IPP can be
-    // toggled without needing to toggle both of them together.
-    IPP = std::unique_ptr<mca::InstrPostProcess>(
-        TheTarget->createInstrPostProcess(*STI, *MCII));
-  }
-  if (!IPP) {
-    // If the target doesn't have its own IPP implemented (or the -disable-cb
-    // flag is set) then we use the base class (which does nothing).
-    IPP = std::make_unique<mca::InstrPostProcess>(*STI, *MCII);
-  }
-
-  // Create an instruction builder.
-  mca::InstrBuilder IB(*STI, *MCII, *MRI, MCIA.get(), *IM);
-
-  // Create a context to control ownership of the pipeline hardware.
-  mca::Context MCA(*MRI, *STI);
-
   mca::PipelineOptions PO(MicroOpQueue, DecoderThroughput, DispatchWidth,
                           RegisterFileSize, LoadQueueSize, StoreQueueSize,
                           AssumeNoAlias, EnableBottleneckAnalysis);
 
-  // Number each region in the sequence.
-  unsigned RegionIdx = 0;
-
-  std::unique_ptr<MCCodeEmitter> MCE(
-      TheTarget->createMCCodeEmitter(*MCII, ACtx));
-  assert(MCE && "Unable to create code emitter!");
-
-  std::unique_ptr<MCAsmBackend> MAB(TheTarget->createMCAsmBackend(
-      *STI, *MRI, mc::InitMCTargetOptionsFromFlags()));
-  assert(MAB && "Unable to create asm backend!");
-
-  json::Object JSONOutput;
-  int NonEmptyRegions = 0;
-  for (const std::unique_ptr<mca::AnalysisRegion> &Region : Regions) {
-    // Skip empty code regions.
-    if (Region->empty())
-      continue;
-
-    IB.clear();
-
-    // Lower the MCInst sequence into an mca::Instruction sequence.
-    ArrayRef<MCInst> Insts = Region->getInstructions();
-    mca::CodeEmitter CE(*STI, *MAB, *MCE, Insts);
-
-    IPP->resetState();
-
-    DenseMap<const MCInst *, SmallVector<mca::Instrument *>> InstToInstruments;
-    SmallVector<std::unique_ptr<mca::Instruction>> LoweredSequence;
-    SmallPtrSet<const MCInst *, 16> DroppedInsts;
-    for (const MCInst &MCI : Insts) {
-      SMLoc Loc = MCI.getLoc();
-      const SmallVector<mca::Instrument *> Instruments =
-          InstrumentRegions.getActiveInstruments(Loc);
-
-      Expected<std::unique_ptr<mca::Instruction>> Inst =
-          IB.createInstruction(MCI, Instruments);
-      if (!Inst) {
-        if (auto NewE = handleErrors(
-                Inst.takeError(),
-                [&IP, &STI](const mca::InstructionError<MCInst> &IE) {
-                  std::string InstructionStr;
-                  raw_string_ostream SS(InstructionStr);
-                  if (shouldSkip(SkipType::LACK_SCHED))
-                    WithColor::warning()
-                        << IE.Message
-                        << ", skipping with -skip-unsupported-instructions, "
-                           "note accuracy will be impacted:\n";
-                  else
-                    WithColor::error()
-                        << IE.Message
-                        << ", use -skip-unsupported-instructions=lack-sched to "
-                           "ignore these on the input.\n";
-                  IP->printInst(&IE.Inst, 0, "", *STI, SS);
-                  SS.flush();
-                  WithColor::note()
-                      << "instruction: " << InstructionStr << '\n';
-                })) {
-          // Default case.
-          WithColor::error() << toString(std::move(NewE));
-        }
-        if (shouldSkip(SkipType::LACK_SCHED)) {
-          DroppedInsts.insert(&MCI);
-          continue;
-        }
-        return 1;
-      }
-
-      IPP->postProcessInstruction(Inst.get(), MCI);
-      InstToInstruments.insert({&MCI, Instruments});
-      LoweredSequence.emplace_back(std::move(Inst.get()));
+  // In a sweep, every region is simulated on each of the requested cpus.
+  // The regions were parsed for -mcpu.
+  bool Sweep = !SweepMCPUs.empty();
+  std::vector<std::unique_ptr<MCSubtargetInfo>> SweepSTIs;
+  for (const std::string &CPU : SweepMCPUs) {
+    std::unique_ptr<MCSubtargetInfo> SweepSTI(
+        TheTarget->createMCSubtargetInfo(TripleName, CPU, FeaturesStr));
+    assert(SweepSTI && "Unable to create subtarget info!");
+    if (!SweepSTI->isCPUStringValid(CPU))
+      return 1;
+    if (!SweepSTI->getSchedModel().hasInstrSchedModel()) {
+      WithColor::error()
+          << "unable to find instruction-level scheduling information for"
+          << " target triple '" << TheTriple.normalize() << "' and cpu '"
+          << CPU << "'.\n";
+      return 1;
     }
+    SweepSTIs.push_back(std::move(SweepSTI));
+  }
 
-    Insts = Region->dropInstructions(DroppedInsts);
-
-    // Skip empty regions.
-    if (Insts.empty())
-      continue;
-    NonEmptyRegions++;
-
-    mca::CircularSourceMgr S(LoweredSequence,
-                             PrintInstructionTables ? 1 : Iterations);
-
-    if (PrintInstructionTables) {
-      //  Create a pipeline, stages, and a printer.
-      auto P = std::make_unique<mca::Pipeline>();
-      P->appendStage(std::make_unique<mca::EntryStage>(S));
-      P->appendStage(std::make_unique<mca::InstructionTables>(SM));
-
-      mca::PipelinePrinter Printer(*P, *Region, RegionIdx, *STI, PO);
-      if (PrintJson) {
-        Printer.addView(
-            std::make_unique<mca::InstructionView>(*STI, *IP, Insts));
-      }
-
-      // Create the views for this pipeline, execute, and emit a report.
-      if (PrintInstructionInfoView) {
-        Printer.addView(std::make_unique<mca::InstructionInfoView>(
-            *STI, *MCII, CE, ShowEncoding, Insts, *IP, LoweredSequence,
-            ShowBarriers, *IM, InstToInstruments));
-      }
-      Printer.addView(
-          std::make_unique<mca::ResourcePressureView>(*STI, *IP, Insts));
+  std::vector<SimulationTarget> Targets;
+  if (Sweep) {
+    for (auto &SweepSTI : SweepSTIs)
+      Targets.push_back({*TheTarget, *SweepSTI, *MRI, *MAI, *MCII,
+                         InstrumentRegions, PO, AssemblerDialect});
+  } else {
+    Targets.push_back({*TheTarget, *STI, *MRI, *MAI, *MCII,
+                       InstrumentRegions, PO, AssemblerDialect});
+  }
 
-      if (!runPipeline(*P))
+  // Simulate the regions, possibly concurrently, then print the reports in
+  // order.
+  std::vector<const mca::AnalysisRegion *> NonEmpty;
+  for (const std::unique_ptr<mca::AnalysisRegion> &Region : Regions)
+    if (!Region->empty())
+      NonEmpty.push_back(Region.get());
+
+  std::vector<RegionReport> Reports(Targets.size() * NonEmpty.size());
+  parallel::strategy = hardware_concurrency(NumThreads);
+  parallelFor(0, Reports.size(), [&](size_t I) {
+    simulateRegion(Targets[I / NonEmpty.size()], *NonEmpty[I % NonEmpty.size()],
+                   Sweep, Reports[I]);
+  });
+
+  json::Object SweepOutput;
+  for (size_t TargetIdx = 0; TargetIdx != Targets.size(); ++TargetIdx) {
+    json::Object JSONOutput;
+    // Number each region in the sequence.
+    unsigned RegionIdx = 0;
+    for (size_t I = 0; I != NonEmpty.size(); ++I) {
+      RegionReport &Report = Reports[TargetIdx * NonEmpty.size() + I];
+      errs() << Report.Diagnostics;
+      if (Report.Failed)
         return 1;
+      if (Report.Empty)
+        continue;
 
-      if (PrintJson) {
-        Printer.printReport(JSONOutput);
+      if (Sweep || PrintJson) {
+        appendJSONReport(JSONOutput, Report.JSON);
       } else {
-        Printer.printReport(TOF->os());
+        mca::PipelinePrinter::printRegionHeader(TOF->os(), *NonEmpty[I],
+                                                RegionIdx);
+        TOF->os() << Report.Text;
       }
-
       ++RegionIdx;
-      continue;
-    }
-
-    // Create the CustomBehaviour object for enforcing Target Specific
-    // behaviours and dependencies that aren't expressed well enough
-    // in the tablegen. CB cannot depend on the list of MCInst or
-    // the source code (but it can depend on the list of
-    // mca::Instruction or any objects that can be reconstructed
-    // from the target information).
-    std::unique_ptr<mca::CustomBehaviour> CB;
-    if (!DisableCustomBehaviour)
-      CB = std::unique_ptr<mca::CustomBehaviour>(
-          TheTarget->createCustomBehaviour(*STI, S, *MCII));
-    if (!CB)
-      // If the target doesn't have its own CB implemented (or the -disable-cb
-      // flag is set) then we use the base class (which does nothing).
-      CB = std::make_unique<mca::CustomBehaviour>(*STI, S, *MCII);
-
-    // Create a basic pipeline simulating an out-of-order backend.
-    auto P = MCA.createDefaultPipeline(PO, S, *CB);
-
-    mca::PipelinePrinter Printer(*P, *Region, RegionIdx, *STI, PO);
-
-    // Targets can define their own custom Views that exist within their
-    // /lib/Target/ directory so that the View can utilize their CustomBehaviour
-    // or other backend symbols / functionality that are not already exposed
-    // through one of the MC-layer classes. These Views will be initialized
-    // using the CustomBehaviour::getViews() variants.
-    // If a target makes a custom View that does not depend on their target
-    // CB or their backend, they should put the View within
-    // /tools/llvm-mca/Views/ instead.
-    if (!DisableCustomBehaviour) {
-      std::vector<std::unique_ptr<mca::View>> CBViews =
-          CB->getStartViews(*IP, Insts);
-      for (auto &CBView : CBViews)
-        Printer.addView(std::move(CBView));
-    }
-
-    // When we output JSON, we add a view that contains the instructions
-    // and CPU resource information.
-    if (PrintJson) {
-      auto IV = std::make_unique<mca::InstructionView>(*STI, *IP, Insts);
-      Printer.addView(std::move(IV));
     }
 
-    if (PrintSummaryView)
-      Printer.addView(
-          std::make_unique<mca::SummaryView>(SM, Insts, DispatchWidth));
-
-    if (EnableBottleneckAnalysis) {
-      if (!IsOutOfOrder) {
-        WithColor::warning()
-            << "bottleneck analysis is not supported for in-order CPU '" << MCPU
-            << "'.\n";
-      }
-      Printer.addView(std::make_unique<mca::BottleneckAnalysis>(
-          *STI, *IP, Insts, S.getNumIterations()));
-    }
-
-    if (PrintInstructionInfoView)
-      Printer.addView(std::make_unique<mca::InstructionInfoView>(
-          *STI, *MCII, CE, ShowEncoding, Insts, *IP, LoweredSequence,
-          ShowBarriers, *IM, InstToInstruments));
-
-    // Fetch custom Views that are to be placed after the InstructionInfoView.
-    // Refer to the comment paired with the CB->getStartViews(*IP, Insts); line
-    // for more info.
-    if (!DisableCustomBehaviour) {
-      std::vector<std::unique_ptr<mca::View>> CBViews =
-          CB->getPostInstrInfoViews(*IP, Insts);
-      for (auto &CBView : CBViews)
-        Printer.addView(std::move(CBView));
-    }
-
-    if (PrintDispatchStats)
-      Printer.addView(std::make_unique<mca::DispatchStatistics>());
-
-    if (PrintSchedulerStats)
-      Printer.addView(std::make_unique<mca::SchedulerStatistics>(*STI));
-
-    if (PrintRetireStats)
-      Printer.addView(std::make_unique<mca::RetireControlUnitStatistics>(SM));
-
-    if (PrintRegisterFileStats)
-      Printer.addView(std::make_unique<mca::RegisterFileStatistics>(*STI));
-
-    if (PrintResourcePressureView)
-      Printer.addView(
-          std::make_unique<mca::ResourcePressureView>(*STI, *IP, Insts));
-
-    if (PrintTimelineView) {
-      unsigned TimelineIterations =
-          TimelineMaxIterations ? TimelineMaxIterations : 10;
-      Printer.addView(std::make_unique<mca::TimelineView>(
-          *STI, *IP, Insts, std::min(TimelineIterations, S.getNumIterations()),
-          TimelineMaxCycles));
-    }
-
-    // Fetch custom Views that are to be placed after all other Views.
-    // Refer to the comment paired with the CB->getStartViews(*IP, Insts); line
-    // for more info.
-    if (!DisableCustomBehaviour) {
-      std::vector<std::unique_ptr<mca::View>> CBViews =
-          CB->getEndViews(*IP, Insts);
-      for (auto &CBView : CBViews)
-        Printer.addView(std::move(CBView));
-    }
-
-    if (!runPipeline(*P))
+    if (RegionIdx == 0) {
+      WithColor::error() << "no assembly instructions found.\n";
       return 1;
-
-    if (PrintJson) {
-      Printer.printReport(JSONOutput);
-    } else {
-      Printer.printReport(TOF->os());
     }
 
-    ++RegionIdx;
+    if (Sweep)
+      SweepOutput.try_emplace(Targets[TargetIdx].STI.getCPU(),
+                              std::move(JSONOutput));
+    else if (PrintJson)
+      TOF->os() << formatv("{0:2}", json::Value(std::move(JSONOutput)))
+                << "\n";
   }
 
-  if (NonEmptyRegions == 0) {
-    WithColor::error() << "no assembly instructions found.\n";
-    return 1;
-  }
-
-  if (PrintJson)
-    TOF->os() << formatv("{0:2}", json::Value(std::move(JSONOutput))) << "\n";
+  if (Sweep)
+    TOF->os() << formatv("{0:2}", json::Value(std::move(SweepOutput))) << "\n";
 
   TOF->keep();
   return 0;
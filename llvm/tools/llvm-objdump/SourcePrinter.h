@@ -159,6 +159,9 @@ public:
   SourcePrinter() = default;
   SourcePrinter(const object::ObjectFile *Obj, StringRef DefaultArch);
   virtual ~SourcePrinter() = default;
+  /// Forget the last printed source line, so that the source location of the
+  /// next instruction is printed in full.
+  void resetLineInfo() { OldLineInfo = DILineInfo(); }
   virtual void printSourceLine(formatted_raw_ostream &OS,
                                object::SectionedAddress Address,
                                StringRef ObjectFilename,
@@ -74,6 +74,7 @@
 #include "llvm/Support/GraphWriter.h"
 #include "llvm/Support/LLVMDriver.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/TargetSelect.h"
@@ -330,6 +331,7 @@ bool objdump::PrintImmHex;
 bool objdump::PrivateHeaders;
 std::vector<std::string> objdump::FilterSections;
 bool objdump::SectionHeaders;
+static unsigned NumThreads = 1;
 static bool ShowAllSymbols;
 static bool ShowLMA;
 bool objdump::PrintSource;
@@ -1123,6 +1125,22 @@ DisassemblerTarget::DisassemblerTarget(DisassemblerTarget &Other,
       Printer(Other.Printer), RegisterInfo(Other.RegisterInfo),
       AsmInfo(Other.AsmInfo), InstrInfo(Other.InstrInfo),
       ObjectFileInfo(Other.ObjectFileInfo) {}
+
+// A disassembler and a symbolizer owned by one thread, so that chunks of a
+// section can be disassembled concurrently with --num-threads.
+class DisassemblyWorker {
+public:
+  DisassemblerTarget Disassembler;
+  SourcePrinter SP;
+  LiveVariablePrinter LVP;
+
+  DisassemblyWorker(const Target *TheTarget, ObjectFile &Obj,
+                    const ObjectFile &DbgObj, SubtargetFeatures &Features)
+      : Disassembler(TheTarget, Obj, TripleName, MCPU, Features),
+        SP(&DbgObj, TheTarget->getName()),
+        LVP(*Disassembler.Context->getRegisterInfo(),
+            *Disassembler.SubtargetInfo) {}
+};
 } // namespace
 
 static uint8_t getElfSymbolType(const ObjectFile &Obj, const SymbolRef &Sym) {
@@ -1369,7 +1387,7 @@ static uint64_t dumpARMELFData(uint64_t SectionAddr, uint64_t Index,
 }
 
 static void dumpELFData(uint64_t SectionAddr, uint64_t Index, uint64_t End,
-                        ArrayRef<uint8_t> Bytes) {
+                        ArrayRef<uint8_t> Bytes, raw_ostream &OS) {
   // print out data up to 8 bytes at a time in hex and ascii
   uint8_t AsciiData[9] = {'\0'};
   uint8_t Byte;
@@ -1377,9 +1395,9 @@ static void dumpELFData(uint64_t SectionAddr, uint64_t Index, uint64_t End,
 
   for (; Index < End; ++Index) {
     if (NumBytes == 0)
-      outs() << format("%8" PRIx64 ":", SectionAddr + Index);
+      OS << format("%8" PRIx64 ":", SectionAddr + Index);
     Byte = Bytes.slice(Index)[0];
-    outs() << format(" %02x", Byte);
+    OS << format(" %02x", Byte);
     AsciiData[NumBytes] = isPrint(Byte) ? Byte : '.';
 
     uint8_t IndentOffset = 0;
@@ -1394,9 +1412,9 @@ static void dumpELFData(uint64_t SectionAddr, uint64_t Index, uint64_t End,
     }
     if (NumBytes == 8) {
       AsciiData[8] = '\0';
-      outs() << std::string(IndentOffset, ' ') << "         ";
-      outs() << reinterpret_cast<char *>(AsciiData);
-      outs() << '\n';
+      OS << std::string(IndentOffset, ' ') << "         ";
+      OS << reinterpret_cast<char *>(AsciiData);
+      OS << '\n';
       NumBytes = 0;
     }
   }
@@ -1653,12 +1671,46 @@ fetchBinaryByBuildID(const ObjectFile &Obj) {
   return std::move(*DebugBinary);
 }
 
+namespace {
+// A run of code between two points where at least one symbol is defined, as
+// selected for disassembly.
+struct DisassemblyChunk {
+  // The symbols defined at the start of the chunk are Symbols[FirstSI,
+  // LastSI) of the section.
+  size_t FirstSI;
+  size_t LastSI;
+  // Section offsets of the chunk.
+  uint64_t Start;
+  uint64_t End;
+  bool DisassembleAsELFData;
+  std::vector<bool> SymsToPrint;
+  std::vector<StringRef> SymNames;
+  // Storage for the demangled names that SymNames refers to, if any.
+  std::vector<std::string> DemangledSymNames;
+};
+
+// The state that disassembling consecutive chunks of a section reads and
+// updates.
+struct DisassemblyState {
+  DisassemblerTarget &PrimaryTarget;
+  DisassemblerTarget *DT;
+  SourcePrinter &SP;
+  LiveVariablePrinter &LVP;
+  std::vector<RelocationRef>::const_iterator RelCur;
+};
+} // namespace
+
+// The number of bytes of code that a worker disassembles as one unit with
+// --num-threads.
+static constexpr uint64_t ParallelDisassemblyGroupSize = 16 * 1024;
+
 static void
 disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
                   DisassemblerTarget &PrimaryTarget,
                   std::optional<DisassemblerTarget> &SecondaryTarget,
-                  SourcePrinter &SP, bool InlineRelocs) {
-  DisassemblerTarget *DT = &PrimaryTarget;
+                  SourcePrinter &SP,
+                  ArrayRef<std::unique_ptr<DisassemblyWorker>> Workers,
+                  bool InlineRelocs) {
   bool PrimaryIsThumb = false;
   SmallVector<std::pair<uint64_t, uint64_t>, 0> CHPECodeMap;
 
@@ -1821,7 +1873,8 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
   llvm::stable_sort(AbsoluteSymbols);
 
   std::unique_ptr<DWARFContext> DICtx;
-  LiveVariablePrinter LVP(*DT->Context->getRegisterInfo(), *DT->SubtargetInfo);
+  LiveVariablePrinter LVP(*PrimaryTarget.Context->getRegisterInfo(),
+                          *PrimaryTarget.SubtargetInfo);
 
   if (DbgVariables != DVDisabled) {
     DICtx = DWARFContext::create(DbgObj);
@@ -1865,6 +1918,7 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
       WithColor::defaultErrorHandler(std::move(E));
   }
 
+  DisassemblyState Serial{PrimaryTarget, &PrimaryTarget, SP, LVP, {}};
   for (const SectionRef &Section : ToolSectionFilter(Obj)) {
     if (FilterSections.empty() && !DisassembleAll &&
         (!Section.isText() || Section.isVirtual()))
@@ -1891,8 +1945,9 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
     std::vector<std::unique_ptr<std::string>> SynthesizedLabelNames;
     if (Obj.isELF() && Obj.getArch() == Triple::amdgcn) {
       // AMDGPU disassembler uses symbolizer for printing labels
-      addSymbolizer(*DT->Context, DT->TheTarget, TripleName, DT->DisAsm.get(),
-                    SectionAddr, Bytes, Symbols, SynthesizedLabelNames);
+      addSymbolizer(*Serial.DT->Context, Serial.DT->TheTarget, TripleName,
+                    Serial.DT->DisAsm.get(), SectionAddr, Bytes, Symbols,
+                    SynthesizedLabelNames);
     }
 
     StringRef SegmentName = getSegmentName(MachO, Section);
@@ -1920,9 +1975,6 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
         Symbols.insert(llvm::lower_bound(Symbols, Sym), Sym);
     }
 
-    SmallString<40> Comments;
-    raw_svector_ostream CommentStream(Comments);
-
     uint64_t VMAAdjustment = 0;
     if (shouldAdjustVA(Section))
       VMAAdjustment = AdjustVMA;
@@ -1931,15 +1983,13 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
     // Subtract SectionAddr from the r_offset field of a relocation to get
     // the section offset.
     uint64_t RelAdjustment = Obj.isRelocatableObject() ? 0 : SectionAddr;
-    uint64_t Size;
-    uint64_t Index;
-    bool PrintedSection = false;
     std::vector<RelocationRef> Rels = RelocMap[Section];
-    std::vector<RelocationRef>::const_iterator RelCur = Rels.begin();
     std::vector<RelocationRef>::const_iterator RelEnd = Rels.end();
 
-    // Loop over each chunk of code between two points where at least
-    // one symbol is defined.
+    // Collect each chunk of code between two points where at least one symbol
+    // is defined, and decide which of them to disassemble before printing
+    // anything, so that the chunks can be disassembled independently.
+    std::vector<DisassemblyChunk> Chunks;
     for (size_t SI = 0, SE = Symbols.size(); SI != SE;) {
       // Advance SI past all the symbols starting at the same address,
       // and make an ArrayRef of them.
@@ -2054,40 +2104,59 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
       Start -= SectionAddr;
       End -= SectionAddr;
 
-      if (!PrintedSection) {
-        PrintedSection = true;
-        outs() << "\nDisassembly of section ";
-        if (!SegmentName.empty())
-          outs() << SegmentName << ",";
-        outs() << SectionName << ":\n";
-      }
+      Chunks.push_back({FirstSI, SI, Start, End, DisassembleAsELFData,
+                        std::move(SymsToPrint), std::move(SymNamesHere),
+                        std::move(DemangledSymNamesHere)});
+    }
+    if (Chunks.empty())
+      continue;
+
+    outs() << "\nDisassembly of section ";
+    if (!SegmentName.empty())
+      outs() << SegmentName << ",";
+    outs() << SectionName << ":\n";
+
+    auto DisassembleChunk = [&](const DisassemblyChunk &Chunk,
+                                DisassemblyState &State, raw_ostream &OS) {
+      DisassemblerTarget *&DT = State.DT;
+      std::vector<RelocationRef>::const_iterator &RelCur = State.RelCur;
+      ArrayRef<SymbolInfoTy> SymbolsHere(&Symbols[Chunk.FirstSI],
+                                         Chunk.LastSI - Chunk.FirstSI);
+      ArrayRef<StringRef> SymNamesHere = Chunk.SymNames;
+      uint64_t Start = Chunk.Start;
+      uint64_t End = Chunk.End;
+      uint64_t Size;
+      uint64_t Index;
+
+      SmallString<40> Comments;
+      raw_svector_ostream CommentStream(Comments);
 
       bool PrintedLabel = false;
       for (size_t i = 0; i < SymbolsHere.size(); ++i) {
-        if (!SymsToPrint[i])
+        if (!Chunk.SymsToPrint[i])
           continue;
 
         const SymbolInfoTy &Symbol = SymbolsHere[i];
         const StringRef SymbolName = SymNamesHere[i];
 
         if (!PrintedLabel) {
-          outs() << '\n';
+          OS << '\n';
           PrintedLabel = true;
         }
         if (LeadingAddr)
-          outs() << format(Is64Bits ? "%016" PRIx64 " " : "%08" PRIx64 " ",
-                           SectionAddr + Start + VMAAdjustment);
+          OS << format(Is64Bits ? "%016" PRIx64 " " : "%08" PRIx64 " ",
+                       SectionAddr + Start + VMAAdjustment);
         if (Obj.isXCOFF() && SymbolDescription) {
-          outs() << getXCOFFSymbolDescription(Symbol, SymbolName) << ":\n";
+          OS << getXCOFFSymbolDescription(Symbol, SymbolName) << ":\n";
         } else
-          outs() << '<' << SymbolName << ">:\n";
+          OS << '<' << SymbolName << ">:\n";
       }
 
       // Don't print raw contents of a virtual section. A virtual section
       // doesn't have any contents in the file.
       if (Section.isVirtual()) {
-        outs() << "...\n";
-        continue;
+        OS << "...\n";
+        return;
       }
 
       // See if any of the symbols defined at this location triggers target-
@@ -2123,17 +2192,17 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
           do {
             StringRef Line;
             std::tie(Line, ErrMsg) = ErrMsg.split('\n');
-            outs() << DT->Context->getAsmInfo()->getCommentString()
-                   << " error decoding " << SymNamesHere[SHI] << ": " << Line
-                   << '\n';
+            OS << DT->Context->getAsmInfo()->getCommentString()
+               << " error decoding " << SymNamesHere[SHI] << ": " << Line
+               << '\n';
           } while (!ErrMsg.empty());
 
           if (Size) {
-            outs() << DT->Context->getAsmInfo()->getCommentString()
-                   << " decoding failed region as bytes\n";
+            OS << DT->Context->getAsmInfo()->getCommentString()
+               << " decoding failed region as bytes\n";
             for (uint64_t I = 0; I < Size; ++I)
-              outs() << "\t.byte\t " << format_hex(Bytes[I], 1, /*Upper=*/true)
-                     << '\n';
+              OS << "\t.byte\t " << format_hex(Bytes[I], 1, /*Upper=*/true)
+                 << '\n';
           }
         }
 
@@ -2151,10 +2220,9 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
       if (SectionAddr < StartAddress)
         Index = std::max<uint64_t>(Index, StartAddress - SectionAddr);
 
-      if (DisassembleAsELFData) {
-        dumpELFData(SectionAddr, Index, End, Bytes);
-        Index = End;
-        continue;
+      if (Chunk.DisassembleAsELFData) {
+        dumpELFData(SectionAddr, Index, End, Bytes, OS);
+        return;
       }
 
       // Skip relocations from symbols that are not dumped.
@@ -2167,17 +2235,18 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
       bool DumpARMELFData = false;
       bool DumpTracebackTableForXCOFFFunction =
           Obj.isXCOFF() && Section.isText() && TracebackTable &&
-          Symbols[SI - 1].XCOFFSymInfo.StorageMappingClass &&
-          (*Symbols[SI - 1].XCOFFSymInfo.StorageMappingClass == XCOFF::XMC_PR);
+          Symbols[Chunk.LastSI - 1].XCOFFSymInfo.StorageMappingClass &&
+          (*Symbols[Chunk.LastSI - 1].XCOFFSymInfo.StorageMappingClass ==
+           XCOFF::XMC_PR);
 
-      formatted_raw_ostream FOS(outs());
+      formatted_raw_ostream FOS(OS);
 
       std::unordered_map<uint64_t, std::string> AllLabels;
       std::unordered_map<uint64_t, std::vector<BBAddrMapLabel>> BBAddrMapLabels;
       if (SymbolizeOperands) {
         collectLocalBranchTargets(Bytes, DT->InstrAnalysis.get(),
                                   DT->DisAsm.get(), DT->InstPrinter.get(),
-                                  PrimaryTarget.SubtargetInfo.get(),
+                                  State.PrimaryTarget.SubtargetInfo.get(),
                                   SectionAddr, Index, End, AllLabels);
         collectBBAddrMapLabels(FullAddrMap, SectionAddr, Index, End,
                                BBAddrMapLabels);
@@ -2198,9 +2267,9 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
           DumpARMELFData = Kind == 'd';
           if (SecondaryTarget) {
             if (Kind == 'a') {
-              DT = PrimaryIsThumb ? &*SecondaryTarget : &PrimaryTarget;
+              DT = PrimaryIsThumb ? &*SecondaryTarget : &State.PrimaryTarget;
             } else if (Kind == 't') {
-              DT = PrimaryIsThumb ? &PrimaryTarget : &*SecondaryTarget;
+              DT = PrimaryIsThumb ? &State.PrimaryTarget : &*SecondaryTarget;
             }
           }
         } else if (!CHPECodeMap.empty()) {
@@ -2213,7 +2282,7 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
           if (It != CHPECodeMap.begin() && Address < (It - 1)->second) {
             DT = &*SecondaryTarget;
           } else {
-            DT = &PrimaryTarget;
+            DT = &State.PrimaryTarget;
             // X64 disassembler range may have left Index unaligned, so
             // make sure that it's aligned when we switch back to ARM64
             // code.
@@ -2299,8 +2368,9 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
                 ThisBytes.size(),
                 DT->DisAsm->suggestBytesToSkip(ThisBytes, ThisAddr));
 
-          LVP.update({Index, Section.getIndex()},
-                     {Index + Size, Section.getIndex()}, Index + Size != End);
+          State.LVP.update({Index, Section.getIndex()},
+                           {Index + Size, Section.getIndex()},
+                           Index + Size != End);
 
           DT->InstPrinter->setCommentStream(CommentStream);
 
@@ -2308,7 +2378,8 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
               *DT->InstPrinter, Disassembled ? &Inst : nullptr,
               Bytes.slice(Index, Size),
               {SectionAddr + Index + VMAAdjustment, Section.getIndex()}, FOS,
-              "", *DT->SubtargetInfo, &SP, Obj.getFileName(), &Rels, LVP);
+              "", *DT->SubtargetInfo, &State.SP, Obj.getFileName(), &Rels,
+              State.LVP);
 
           DT->InstPrinter->setCommentStream(llvm::nulls());
 
@@ -2365,7 +2436,9 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
                     TargetSecAddr = It->first;
                   if (It->first != TargetSecAddr)
                     break;
-                  TargetSectionSymbols.push_back(&AllSymbols[It->second]);
+                  auto SymsIt = AllSymbols.find(It->second);
+                  if (SymsIt != AllSymbols.end())
+                    TargetSectionSymbols.push_back(&SymsIt->second);
                 }
               } else {
                 TargetSectionSymbols.push_back(&Symbols);
@@ -2492,11 +2565,13 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
 
         assert(DT->Context->getAsmInfo());
         emitPostInstructionInfo(FOS, *DT->Context->getAsmInfo(),
-                                *DT->SubtargetInfo, CommentStream.str(), LVP);
+                                *DT->SubtargetInfo, CommentStream.str(),
+                                State.LVP);
         Comments.clear();
 
         if (BTF)
-          printBTFRelocation(FOS, *BTF, {Index, Section.getIndex()}, LVP);
+          printBTFRelocation(FOS, *BTF, {Index, Section.getIndex()},
+                             State.LVP);
 
         // Hexagon handles relocs in pretty printer
         if (InlineRelocs && Obj.getArch() != Triple::hexagon) {
@@ -2512,13 +2587,57 @@ disassembleObject(ObjectFile &Obj, const ObjectFile &DbgObj,
 
             printRelocation(FOS, Obj.getFileName(), *RelCur,
                             SectionAddr + RelOffset, Is64Bits);
-            LVP.printAfterOtherLine(FOS, true);
+            State.LVP.printAfterOtherLine(FOS, true);
             ++RelCur;
           }
         }
 
         Index += Size;
       }
+    };
+
+    if (Workers.empty()) {
+      Serial.RelCur = Rels.begin();
+      for (const DisassemblyChunk &Chunk : Chunks)
+        DisassembleChunk(Chunk, Serial, outs());
+      continue;
+    }
+
+    // With --num-threads, split the chunks into groups of roughly
+    // ParallelDisassemblyGroupSize bytes. Each group is disassembled by a
+    // worker into a buffer of its own, starting from fresh source line state.
+    // A bounded window of groups is processed at a time and the buffers are
+    // printed in order.
+    SmallVector<std::pair<size_t, size_t>, 0> Groups;
+    for (size_t I = 0, E = Chunks.size(); I != E;) {
+      size_t GroupBegin = I;
+      uint64_t GroupSize = 0;
+      for (; I != E && GroupSize < ParallelDisassemblyGroupSize; ++I)
+        GroupSize += Chunks[I].End - Chunks[I].Start;
+      Groups.emplace_back(GroupBegin, I);
+    }
+
+    size_t WindowSize = Workers.size() * 4;
+    for (size_t WindowBegin = 0, NumGroups = Groups.size();
+         WindowBegin < NumGroups; WindowBegin += WindowSize) {
+      size_t WindowEnd = std::min(WindowBegin + WindowSize, NumGroups);
+      std::vector<std::string> Outputs(WindowEnd - WindowBegin);
+      parallelFor(WindowBegin, WindowEnd, [&](size_t G) {
+        DisassemblyWorker &Worker = *Workers[parallel::getThreadIndex()];
+        Worker.SP.resetLineInfo();
+        auto [Begin, End] = Groups[G];
+        uint64_t GroupStart = Chunks[Begin].Start;
+        DisassemblyState State{
+            Worker.Disassembler, &Worker.Disassembler, Worker.SP, Worker.LVP,
+            partition_point(Rels, [&](const RelocationRef &Rel) {
+              return Rel.getOffset() - RelAdjustment < GroupStart;
+            })};
+        raw_string_ostream OS(Outputs[G - WindowBegin]);
+        for (size_t I = Begin; I != End; ++I)
+          DisassembleChunk(Chunks[I], State, OS);
+      });
+      for (const std::string &Output : Outputs)
+        outs() << Output;
     }
   }
   StringSet<> MissingDisasmSymbolSet =
@@ -2585,6 +2704,7 @@ static void disassembleObject(ObjectFile *Obj, bool InlineRelocs) {
   }
 
   DisassemblerTarget PrimaryTarget(TheTarget, *Obj, TripleName, MCPU, Features);
+  SubtargetFeatures PrimaryFeatures = Features;
 
   // If we have an ARM object file, we need a second disassembler, because
   // ARM CPUs have two different instruction sets: ARM mode, and Thumb mode.
@@ -2652,7 +2772,24 @@ static void disassembleObject(ObjectFile *Obj, bool InlineRelocs) {
       reportError(Obj->getFileName(),
                   "Unrecognized disassembler option: " + Opt);
 
-  disassembleObject(*Obj, *DbgObj, PrimaryTarget, SecondaryTarget, SP,
+  // Chunks of a section are disassembled independently with --num-threads.
+  // That is not done when one chunk depends on the state left behind by the
+  // previous one: switching between two disassemblers, tracking variable
+  // locations, or the AMDGPU symbolizer that is attached per section.
+  SmallVector<std::unique_ptr<DisassemblyWorker>, 0> Workers;
+  unsigned NumWorkers = parallel::strategy.compute_thread_count();
+  if (NumThreads != 1 && NumWorkers > 1 && !SecondaryTarget &&
+      DbgVariables == DVDisabled && Obj->getArch() != Triple::amdgcn) {
+    for (unsigned I = 0; I != NumWorkers; ++I) {
+      Workers.push_back(std::make_unique<DisassemblyWorker>(
+          TheTarget, *Obj, *DbgObj, PrimaryFeatures));
+      for (StringRef Opt : DisassemblerOptions)
+        Workers.back()->Disassembler.InstPrinter->applyTargetSpecificCLOption(
+            Opt);
+    }
+  }
+
+  disassembleObject(*Obj, *DbgObj, PrimaryTarget, SecondaryTarget, SP, Workers,
                     InlineRelocs);
 }
 
@@ -3564,6 +3701,10 @@ static void parseObjdumpOptions(const llvm::opt::InputArgList &InputArgs) {
 
   parseIntArg(InputArgs, OBJDUMP_debug_vars_indent_EQ, DbgIndent);
 
+  parseIntArg(InputArgs, OBJDUMP_num_threads_EQ, NumThreads);
+  if (NumThreads != 1)
+    parallel::strategy = hardware_concurrency(NumThreads);
+
   parseMachOOptions(InputArgs);
 
   // Parse -M (--disassembler-options) and deprecated
@@ -269,6 +269,11 @@ cl::opt<unsigned> NumThreads(
     cl::desc("Number of merge threads to use (default: autodetect)"));
 cl::alias NumThreadsA("j", cl::desc("Alias for --num-threads"),
                       cl::aliasopt(NumThreads));
+cl::opt<bool> ShardedMerge(
+    "sharded-merge", cl::init(false), cl::sub(MergeSubcommand),
+    cl::desc("Partition instrumentation function records across the merge "
+             "threads by function name so that only one copy of each record "
+             "is kept in memory (only meaningful for -instr)"));
 
 cl::opt<std::string> ProfileSymbolListFile(
     "prof-sym-list", cl::init(""), cl::sub(MergeSubcommand),
@@ -636,10 +641,12 @@ static void overlapInput(const std::string &BaseFilename,
   }
 }
 
-/// Load an input into a writer context.
+/// Load an input into a writer context. If \p Shards is not empty, function
+/// records are added to the shard selected by their name instead of \p WC.
 static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
                       const InstrProfCorrelator *Correlator,
-                      const StringRef ProfiledBinary, WriterContext *WC) {
+                      const StringRef ProfiledBinary, WriterContext *WC,
+                      ArrayRef<std::unique_ptr<WriterContext>> Shards = {}) {
   std::unique_lock<std::mutex> CtxGuard{WC->Lock};
 
   // Copy the filename, because llvm::ThreadPool copied the input "const
@@ -743,8 +750,15 @@ static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
     if (Remapper)
       I.Name = (*Remapper)(I.Name);
     const StringRef FuncName = I.Name;
+    // Shard locks are always taken after the context lock, never before it.
+    WriterContext *Dst = WC;
+    std::unique_lock<std::mutex> ShardGuard;
+    if (!Shards.empty()) {
+      Dst = Shards[MD5Hash(FuncName) % Shards.size()].get();
+      ShardGuard = std::unique_lock<std::mutex>(Dst->Lock);
+    }
     bool Reported = false;
-    WC->Writer.addRecord(std::move(I), Input.Weight, [&](Error E) {
+    Dst->Writer.addRecord(std::move(I), Input.Weight, [&](Error E) {
       if (Reported) {
         consumeError(std::move(E));
         return;
@@ -798,8 +812,10 @@ static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
     Dst->Errors.push_back(std::move(ErrorPair));
   Src->Errors.clear();
 
-  if (Error E = Dst->Writer.mergeProfileKind(Src->Writer.getProfileKind()))
-    exitWithError(std::move(E));
+  // Shards only receive function records and never learn the profile kind.
+  if (Src->Writer.getProfileKind() != InstrProfKind::Unknown)
+    if (Error E = Dst->Writer.mergeProfileKind(Src->Writer.getProfileKind()))
+      exitWithError(std::move(E));
 
   Dst->Writer.mergeRecordsFromWriter(std::move(Src->Writer), [&](Error E) {
     auto [ErrorCode, Msg] = InstrProfError::take(std::move(E));
@@ -937,6 +953,16 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
         OutputSparse, ErrorLock, WriterErrorCodes, TraceReservoirSize,
         MaxTraceLength));
 
+  // With -sharded-merge, function records go to a separate set of writers,
+  // one per thread, each owning the functions whose name hashes to it. The
+  // per-thread contexts then only hold the remaining profile data, and merging
+  // the shards at the end moves records without combining any counters.
+  SmallVector<std::unique_ptr<WriterContext>, 4> Shards;
+  if (ShardedMerge && NumThreads > 1)
+    for (unsigned I = 0; I < NumThreads; ++I)
+      Shards.emplace_back(std::make_unique<WriterContext>(
+          OutputSparse, ErrorLock, WriterErrorCodes));
+
   if (NumThreads == 1) {
     for (const auto &Input : Inputs)
       loadInput(Input, Remapper, Correlator.get(), ProfiledBinary,
@@ -948,7 +974,7 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
     unsigned Ctx = 0;
     for (const auto &Input : Inputs) {
       Pool.async(loadInput, Input, Remapper, Correlator.get(), ProfiledBinary,
-                 Contexts[Ctx].get());
+                 Contexts[Ctx].get(), ArrayRef(Shards));
       Ctx = (Ctx + 1) % NumThreads;
     }
     Pool.wait();
@@ -970,6 +996,13 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
       End = Mid;
       Mid /= 2;
     } while (Mid > 0);
+
+    // The shards hold disjoint sets of functions, so this is serial but
+    // linear in the number of records.
+    for (std::unique_ptr<WriterContext> &Shard : Shards) {
+      mergeWriterContexts(Contexts[0].get(), Shard.get());
+      Shard.reset();
+    }
   }
 
   // Handle deferred errors encountered during merging. If the number of errors
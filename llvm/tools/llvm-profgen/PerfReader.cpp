@@ -10,6 +10,7 @@
 #include "llvm/ADT/SmallString.h"
 #include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/ToolOutputFile.h"
 
@@ -42,6 +43,11 @@ static cl::opt<bool>
 cl::opt<bool> ShowDetailedWarning("show-detailed-warning",
                                   cl::desc("Show detailed warning message."));
 
+static cl::opt<unsigned>
+    NumThreads("num-threads", cl::init(0),
+               cl::desc("Number of threads used to unwind hybrid samples "
+                        "(default: all available cores)"));
+
 extern cl::opt<std::string> PerfTraceFilename;
 extern cl::opt<bool> ShowDisassemblyOnly;
 extern cl::opt<bool> ShowSourceLocations;
@@ -262,6 +268,32 @@ void VirtualUnwinder::recordBranchCount(const LBREntry &Branch,
   }
 }
 
+void VirtualUnwinder::merge(VirtualUnwinder &Other) {
+  for (auto &[Key, Counter] : *Other.CtxCounterMap) {
+    auto Ret = CtxCounterMap->emplace(Key, SampleCounter());
+    SampleCounter &SCounter = Ret.first->second;
+    if (Ret.second) {
+      SCounter = std::move(Counter);
+      continue;
+    }
+    for (auto &[Range, Count] : Counter.RangeCounter)
+      SCounter.RangeCounter[Range] += Count;
+    for (auto &[Branch, Count] : Counter.BranchCounter)
+      SCounter.BranchCounter[Branch] += Count;
+  }
+  Other.CtxCounterMap->clear();
+
+  UntrackedCallsites.insert(Other.UntrackedCallsites.begin(),
+                            Other.UntrackedCallsites.end());
+  NumTotalBranches += Other.NumTotalBranches;
+  NumExtCallBranch += Other.NumExtCallBranch;
+  NumMissingExternalFrame += Other.NumMissingExternalFrame;
+  NumMismatchedProEpiBranch += Other.NumMismatchedProEpiBranch;
+  NumMismatchedExtCallBranch += Other.NumMismatchedExtCallBranch;
+  NumUnpairedExtAddr += Other.NumUnpairedExtAddr;
+  NumPairedExtAddr += Other.NumPairedExtAddr;
+}
+
 bool VirtualUnwinder::unwind(const PerfSample *Sample, uint64_t Repeat) {
   // Capture initial state as starting point for unwinding.
   UnwindState State(Sample, Binary);
@@ -502,10 +534,32 @@ static std::string getContextKeyStr(ContextKey *K,
 }
 
 void HybridPerfReader::unwindSamples() {
+  // Samples are unwound independently of each other, so unwind fixed size
+  // chunks of them in parallel, each into its own counter map. The chunks are
+  // merged in order, which keeps the result independent of the thread count.
+  const size_t ChunkSize = 1024;
+  std::vector<std::pair<const PerfSample *, uint64_t>> Samples;
+  Samples.reserve(AggregatedSamples.size());
+  for (const auto &Item : AggregatedSamples)
+    Samples.emplace_back(Item.first.getPtr(), Item.second);
+
+  const size_t NumChunks = divideCeil(Samples.size(), ChunkSize);
+  std::vector<ContextSampleCounterMap> ChunkCounters(NumChunks);
+  std::vector<std::unique_ptr<VirtualUnwinder>> ChunkUnwinders(NumChunks);
+  if (NumThreads)
+    parallel::strategy = hardware_concurrency(NumThreads);
+  parallelFor(0, NumChunks, [&](size_t I) {
+    ChunkUnwinders[I] =
+        std::make_unique<VirtualUnwinder>(&ChunkCounters[I], Binary);
+    size_t End = std::min(Samples.size(), (I + 1) * ChunkSize);
+    for (size_t J = I * ChunkSize; J < End; ++J)
+      ChunkUnwinders[I]->unwind(Samples[J].first, Samples[J].second);
+  });
+
   VirtualUnwinder Unwinder(&SampleCounters, Binary);
-  for (const auto &Item : AggregatedSamples) {
-    const PerfSample *Sample = Item.first.getPtr();
-    Unwinder.unwind(Sample, Item.second);
+  for (std::unique_ptr<VirtualUnwinder> &ChunkUnwinder : ChunkUnwinders) {
+    Unwinder.merge(*ChunkUnwinder);
+    ChunkUnwinder.reset();
   }
 
   // Warn about untracked frames due to missing probes.
@@ -477,6 +477,9 @@ public:
       : CtxCounterMap(Counter), Binary(B) {}
   bool unwind(const PerfSample *Sample, uint64_t Repeat);
   std::set<uint64_t> &getUntrackedCallsites() { return UntrackedCallsites; }
+  // Move the counters and statistics collected by \p Other into this
+  // unwinder.
+  void merge(VirtualUnwinder &Other);
 
   uint64_t NumTotalBranches = 0;
   uint64_t NumExtCallBranch = 0;
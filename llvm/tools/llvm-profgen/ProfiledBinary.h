@@ -34,6 +34,7 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Transforms/IPO/SampleContextTracker.h"
 #include <map>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <string>
@@ -244,6 +245,10 @@ class ProfiledBinary {
   // Address to context location map. Used to expand the context.
   std::unordered_map<uint64_t, SampleContextFrameVector> AddressToLocStackMap;
 
+  // Guards AddressToLocStackMap and the symbolizer behind it, which are
+  // shared by the threads unwinding samples.
+  std::mutex LocStackMapLock;
+
   // Address to instruction size map. Also used for quick Address lookup.
   std::unordered_map<uint64_t, uint64_t> AddressToInstSizeMap;
 
@@ -522,6 +527,8 @@ public:
   const SampleContextFrameVector &
   getCachedFrameLocationStack(uint64_t Address,
                               bool UseProbeDiscriminator = false) {
+    // References into the map stay valid across later insertions.
+    std::lock_guard<std::mutex> Lock(LocStackMapLock);
     auto I = AddressToLocStackMap.emplace(Address, SampleContextFrameVector());
     if (I.second) {
       I.first->second = getFrameLocationStack(Address, UseProbeDiscriminator);
@@ -35,7 +35,6 @@
 #include "llvm/Support/MemoryBufferRef.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
-#include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/TargetParser/Host.h"
@@ -460,34 +459,15 @@ bool ReducerWorkItem::verify(raw_fd_ostream *OS) const {
 bool ReducerWorkItem::isReduced(const TestRunner &Test) const {
   const bool UseBitcode = Test.inputIsBitcode() || TmpFilesAsBitcode;
 
-  SmallString<128> CurrentFilepath;
-
-  // Write ReducerWorkItem to tmp file
-  int FD;
-  std::error_code EC = sys::fs::createTemporaryFile(
-      "llvm-reduce", isMIR() ? "mir" : (UseBitcode ? "bc" : "ll"), FD,
-      CurrentFilepath,
-      UseBitcode && !isMIR() ? sys::fs::OF_None : sys::fs::OF_Text);
-  if (EC) {
-    WithColor::error(errs(), Test.getToolName())
-        << "error making unique filename: " << EC.message() << '\n';
-    exit(1);
-  }
-
-  ToolOutputFile Out(CurrentFilepath, FD);
-
-  writeOutput(Out.os(), UseBitcode);
-
-  Out.os().close();
-  if (Out.os().has_error()) {
-    WithColor::error(errs(), Test.getToolName())
-        << "error emitting bitcode to file '" << CurrentFilepath
-        << "': " << Out.os().error().message() << '\n';
-    exit(1);
-  }
+  // Serialize to memory first, so the test doesn't need to run again if it
+  // already saw the same contents.
+  SmallString<0> Contents;
+  raw_svector_ostream OS(Contents);
+  writeOutput(OS, UseBitcode);
 
   // Current Chunks aren't interesting
-  return Test.run(CurrentFilepath);
+  return Test.runCached(Contents, isMIR() ? "mir" : (UseBitcode ? "bc" : "ll"),
+                        UseBitcode && !isMIR());
 }
 
 std::unique_ptr<ReducerWorkItem>
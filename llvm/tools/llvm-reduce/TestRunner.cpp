@@ -9,10 +9,22 @@
 #include "TestRunner.h"
 #include "ReducerWorkItem.h"
 #include "deltas/Utils.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
 
 using namespace llvm;
 
+extern cl::OptionCategory LLVMReduceOptions;
+
+static cl::opt<bool> CacheTestResults(
+    "cache-test-results",
+    cl::desc("Do not run the interesting-ness test again on a file it was "
+             "already run on. Requires a deterministic test."),
+    cl::init(true), cl::cat(LLVMReduceOptions));
+
 TestRunner::TestRunner(StringRef TestName,
                        const std::vector<std::string> &TestArgs,
                        std::unique_ptr<ReducerWorkItem> Program,
@@ -59,6 +71,50 @@ int TestRunner::run(StringRef Filename) const {
   return !Result;
 }
 
+bool TestRunner::runCached(StringRef Contents, StringRef Extension,
+                           bool IsBinary) const {
+  std::string Key;
+  if (CacheTestResults) {
+    std::array<uint8_t, 20> Hash = SHA1::hash(arrayRefFromStringRef(Contents));
+    Key.assign(Hash.begin(), Hash.end());
+    std::lock_guard<std::mutex> Lock(ResultCacheMutex);
+    auto It = ResultCache.find(Key);
+    if (It != ResultCache.end()) {
+      if (Verbose)
+        errs() << "Reusing the result of the interesting-ness test\n";
+      return It->second;
+    }
+  }
+
+  SmallString<128> CurrentFilepath;
+  int FD;
+  std::error_code EC = sys::fs::createTemporaryFile(
+      "llvm-reduce", Extension, FD, CurrentFilepath,
+      IsBinary ? sys::fs::OF_None : sys::fs::OF_Text);
+  if (EC) {
+    WithColor::error(errs(), ToolName)
+        << "error making unique filename: " << EC.message() << '\n';
+    exit(1);
+  }
+
+  ToolOutputFile Out(CurrentFilepath, FD);
+  Out.os() << Contents;
+  Out.os().close();
+  if (Out.os().has_error()) {
+    WithColor::error(errs(), ToolName)
+        << "error emitting bitcode to file '" << CurrentFilepath
+        << "': " << Out.os().error().message() << '\n';
+    exit(1);
+  }
+
+  bool Interesting = run(CurrentFilepath);
+  if (CacheTestResults) {
+    std::lock_guard<std::mutex> Lock(ResultCacheMutex);
+    ResultCache[Key] = Interesting;
+  }
+  return Interesting;
+}
+
 void TestRunner::writeOutput(StringRef Message) {
   std::error_code EC;
   raw_fd_ostream Out(OutputFilename, EC,
@@ -10,12 +10,15 @@
 #define LLVM_TOOLS_LLVM_REDUCE_TESTRUNNER_H
 
 #include "ReducerWorkItem.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Target/TargetMachine.h"
+#include <mutex>
+#include <optional>
 #include <vector>
 
 namespace llvm {
@@ -34,6 +37,12 @@ public:
   /// @returns 0 if test was successful, 1 if otherwise
   int run(StringRef Filename) const;
 
+  /// Runs the interesting-ness test on \p Contents, unless it was already run
+  /// on the same contents. \p Contents is written to a temporary file with
+  /// extension \p Extension before running the test.
+  /// @returns true if the contents are interesting
+  bool runCached(StringRef Contents, StringRef Extension, bool IsBinary) const;
+
   /// Returns the most reduced version of the original testcase
   ReducerWorkItem &getProgram() const { return *Program; }
 
@@ -61,6 +70,11 @@ private:
   StringRef OutputFilename;
   const bool InputIsBitcode;
   bool EmitBitcode;
+  /// Results of the interesting-ness test, keyed by the SHA1 of the tested
+  /// file. Chunks are often tested on the same module more than once, e.g.
+  /// when removing them doesn't change anything, or across passes.
+  mutable StringMap<bool> ResultCache;
+  mutable std::mutex ResultCacheMutex;
 };
 
 } // namespace llvm
@@ -29,6 +29,7 @@
 #include "llvm/Support/MemoryBufferRef.h"
 #include "llvm/Support/ThreadPool.h"
 #include <fstream>
+#include <mutex>
 
 using namespace llvm;
 
@@ -54,14 +55,10 @@ static cl::opt<unsigned> NumJobs(
 unsigned NumJobs = 1;
 #endif
 
-/// Splits Chunks in half and prints them.
+/// Splits Chunks in half into NewChunks.
 /// If unable to split (when chunk size is 1) returns false.
-static bool increaseGranularity(std::vector<Chunk> &Chunks) {
-  if (Verbose)
-    errs() << "Increasing granularity...";
-  std::vector<Chunk> NewChunks;
+static bool splitChunks(ArrayRef<Chunk> Chunks, std::vector<Chunk> &NewChunks) {
   bool SplitAny = false;
-
   for (Chunk C : Chunks) {
     if (C.End - C.Begin == 0)
       NewChunks.push_back(C);
@@ -72,6 +69,16 @@ static bool increaseGranularity(std::vector<Chunk> &Chunks) {
       SplitAny = true;
     }
   }
+  return SplitAny;
+}
+
+/// Splits Chunks in half and prints them.
+/// If unable to split (when chunk size is 1) returns false.
+static bool increaseGranularity(std::vector<Chunk> &Chunks) {
+  if (Verbose)
+    errs() << "Increasing granularity...";
+  std::vector<Chunk> NewChunks;
+  bool SplitAny = splitChunks(Chunks, NewChunks);
   if (SplitAny) {
     Chunks = NewChunks;
     if (Verbose) {
@@ -142,27 +149,67 @@ CheckChunk(const Chunk ChunkToCheckForUninterestingness,
   return Clone;
 }
 
-static SmallString<0> ProcessChunkFromSerializedBitcode(
+namespace {
+
+/// Copies of the program parsed from bitcode, each into its own LLVMContext.
+/// Tasks running in parallel take a copy and clone it in memory, rather than
+/// parsing the bitcode for every chunk. A task holds on to its copy until it
+/// is done, since the clone lives in the copy's context.
+class ProgramCopies {
+public:
+  struct Copy {
+    LLVMContext Ctx;
+    std::unique_ptr<ReducerWorkItem> Program;
+  };
+
+  ProgramCopies(StringRef BC) : BC(BC) {}
+
+  std::unique_ptr<Copy> take(const TestRunner &Test) {
+    {
+      std::lock_guard<std::mutex> Lock(CopiesMutex);
+      if (!Copies.empty())
+        return Copies.pop_back_val();
+    }
+    auto C = std::make_unique<Copy>();
+    C->Program = std::make_unique<ReducerWorkItem>();
+    MemoryBufferRef Data(BC, "<bc file>");
+    C->Program->readBitcode(Data, C->Ctx, Test.getToolName());
+    return C;
+  }
+
+  void giveBack(std::unique_ptr<Copy> C) {
+    std::lock_guard<std::mutex> Lock(CopiesMutex);
+    Copies.push_back(std::move(C));
+  }
+
+private:
+  StringRef BC;
+  std::mutex CopiesMutex;
+  SmallVector<std::unique_ptr<Copy>, 0> Copies;
+};
+
+} // end anonymous namespace
+
+static SmallString<0> ProcessChunkFromProgramCopy(
     const Chunk ChunkToCheckForUninterestingness, const TestRunner &Test,
     ReductionFunc ExtractChunksFromModule,
     const DenseSet<Chunk> &UninterestingChunks,
-    ArrayRef<Chunk> ChunksStillConsideredInteresting, StringRef OriginalBC,
+    ArrayRef<Chunk> ChunksStillConsideredInteresting, ProgramCopies &Copies,
     std::atomic<bool> &AnyReduced) {
-  LLVMContext Ctx;
-  auto CloneMMM = std::make_unique<ReducerWorkItem>();
-  MemoryBufferRef Data(OriginalBC, "<bc file>");
-  CloneMMM->readBitcode(Data, Ctx, Test.getToolName());
+  std::unique_ptr<ProgramCopies::Copy> C = Copies.take(Test);
 
   SmallString<0> Result;
   if (std::unique_ptr<ReducerWorkItem> ChunkResult =
-          CheckChunk(ChunkToCheckForUninterestingness, std::move(CloneMMM),
-                     Test, ExtractChunksFromModule, UninterestingChunks,
+          CheckChunk(ChunkToCheckForUninterestingness,
+                     C->Program->clone(Test.getTargetMachine()), Test,
+                     ExtractChunksFromModule, UninterestingChunks,
                      ChunksStillConsideredInteresting)) {
     raw_svector_ostream BCOS(Result);
     ChunkResult->writeBitcode(BCOS);
     // Communicate that the task reduced a chunk.
     AnyReduced = true;
   }
+  Copies.giveBack(std::move(C));
   return Result;
 }
 
@@ -237,6 +284,26 @@ void llvm::runDeltaPass(TestRunner &Test, ReductionFunc ExtractChunksFromModule,
       raw_svector_ostream BCOS(OriginalBC);
       Test.getProgram().writeBitcode(BCOS);
     }
+    ProgramCopies Copies(OriginalBC);
+
+    // With fewer chunks than threads, use the idle threads to test the chunks
+    // of the next granularity, assuming that nothing is reduced at this one.
+    // If that's the case, the next granularity tests the same modules first,
+    // and finds their results in the test runner's cache.
+    std::vector<Chunk> SpeculativeChunks;
+    std::atomic<bool> AnySpeculativeReduced;
+    if (NumJobs > 1 && ChunksStillConsideredInteresting.size() < NumJobs &&
+        splitChunks(ChunksStillConsideredInteresting, SpeculativeChunks)) {
+      unsigned NumSpeculativeTasks =
+          std::min<size_t>(NumJobs - ChunksStillConsideredInteresting.size(),
+                           SpeculativeChunks.size());
+      for (unsigned J = 0; J < NumSpeculativeTasks; ++J)
+        ChunkThreadPoolPtr->async(
+            ProcessChunkFromProgramCopy, *(SpeculativeChunks.rbegin() + J),
+            std::ref(Test), ExtractChunksFromModule, DenseSet<Chunk>(),
+            ArrayRef<Chunk>(SpeculativeChunks), std::ref(Copies),
+            std::ref(AnySpeculativeReduced));
+    }
 
     SharedTaskQueue TaskQueue;
     for (auto I = ChunksStillConsideredInteresting.rbegin(),
@@ -256,17 +323,17 @@ void llvm::runDeltaPass(TestRunner &Test, ReductionFunc ExtractChunksFromModule,
 
         AnyReduced = false;
         // Queue jobs to process NumInitialTasks chunks in parallel using
-        // ChunkThreadPool. When the tasks are added to the pool, parse the
-        // original module from OriginalBC with a fresh LLVMContext object. This
-        // ensures that the cloned module of each task uses an independent
-        // LLVMContext object. If a task reduces the input, serialize the result
-        // back in the corresponding Result element.
+        // ChunkThreadPool. Each task clones a copy of the original module that
+        // was parsed from OriginalBC with its own LLVMContext object. This
+        // ensures that the tasks running at the same time use independent
+        // LLVMContext objects. If a task reduces the input, serialize the
+        // result back in the corresponding Result element.
         for (unsigned J = 0; J < NumInitialTasks; ++J) {
           Chunk ChunkToCheck = *(I + J);
           TaskQueue.emplace_back(ChunkThreadPool.async(
-              ProcessChunkFromSerializedBitcode, ChunkToCheck, std::ref(Test),
+              ProcessChunkFromProgramCopy, ChunkToCheck, std::ref(Test),
               ExtractChunksFromModule, UninterestingChunks,
-              ChunksStillConsideredInteresting, OriginalBC,
+              ChunksStillConsideredInteresting, std::ref(Copies),
               std::ref(AnyReduced)));
         }
 
@@ -288,9 +355,9 @@ void llvm::runDeltaPass(TestRunner &Test, ReductionFunc ExtractChunksFromModule,
             if (!AnyReduced && I + NumScheduledTasks != E) {
               Chunk ChunkToCheck = *(I + NumScheduledTasks);
               TaskQueue.emplace_back(ChunkThreadPool.async(
-                  ProcessChunkFromSerializedBitcode, ChunkToCheck,
+                  ProcessChunkFromProgramCopy, ChunkToCheck,
                   std::ref(Test), ExtractChunksFromModule, UninterestingChunks,
-                  ChunksStillConsideredInteresting, OriginalBC,
+                  ChunksStillConsideredInteresting, std::ref(Copies),
                   std::ref(AnyReduced)));
             }
             continue;
@@ -328,6 +395,9 @@ void llvm::runDeltaPass(TestRunner &Test, ReductionFunc ExtractChunksFromModule,
       UninterestingChunks.insert(ChunkToCheckForUninterestingness);
       ReducedProgram = std::move(Result);
     }
+    // Speculative tasks may still be using the copies of the program.
+    if (NumJobs > 1)
+      ChunkThreadPoolPtr->wait();
     // Delete uninteresting chunks
     erase_if(ChunksStillConsideredInteresting,
              [&UninterestingChunks](const Chunk &C) {
@@ -12,6 +12,7 @@
 #include "llvm/Support/DataTypes.h"
 #include "gtest/gtest.h"
 #include <limits>
+#include <map>
 #include <tuple>
 using namespace llvm;
 
@@ -579,6 +580,41 @@ unsigned CountCtorCopyAndMove::Ctor = 0;
 
 } // anonymous namespace
 
+// Interleave insertions, lookups and erasures so that probe sequences run
+// across groups full of tombstones, and check against std::map.
+TEST(StringMapCustomTest, InsertEraseChurn) {
+  StringMap<unsigned> Map;
+  std::map<std::string, unsigned> Expected;
+  uint64_t State = 1;
+  auto Next = [&] {
+    State = State * 6364136223846793005ULL + 1442695040888963407ULL;
+    return unsigned(State >> 33);
+  };
+  for (unsigned I = 0; I != 20000; ++I) {
+    std::string Key = "key" + std::to_string(Next() % 700);
+    switch (Next() % 3) {
+    case 0:
+      EXPECT_EQ(Map.try_emplace(Key, I).second,
+                Expected.emplace(Key, I).second);
+      break;
+    case 1:
+      EXPECT_EQ(Map.erase(Key), Expected.erase(Key) != 0);
+      break;
+    case 2: {
+      auto It = Map.find(Key);
+      auto ExpectedIt = Expected.find(Key);
+      ASSERT_EQ(It == Map.end(), ExpectedIt == Expected.end());
+      if (It != Map.end())
+        EXPECT_EQ(It->second, ExpectedIt->second);
+      break;
+    }
+    }
+  }
+  EXPECT_EQ(Map.size(), Expected.size());
+  for (const auto &Entry : Map)
+    EXPECT_EQ(Expected.at(Entry.getKey().str()), Entry.second);
+}
+
 // Make sure creating the map with an initial size of N actually gives us enough
 // buckets to insert N items without increasing allocation size.
 TEST(StringMapCustomTest, InitialSizeTest) {
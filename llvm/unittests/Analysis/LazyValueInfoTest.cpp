@@ -0,0 +1,88 @@
+//===- LazyValueInfoTest.cpp - LazyValueInfo unit tests -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Analysis/LazyValueInfo.h"
+#include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/ConstantRange.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+
+using namespace llvm;
+
+namespace {
+
+// The range of %x narrows along a chain of blocks. Query it at the end of
+// every block, in both directions, and return the ranges found.
+static std::vector<ConstantRange> queryChain(Function &F) {
+  AssumptionCache AC(F);
+  LazyValueInfo LVI(&AC, &F.getParent()->getDataLayout());
+  Value *X = F.getArg(0);
+  std::vector<ConstantRange> Ranges;
+  for (int Pass = 0; Pass != 2; ++Pass) {
+    SmallVector<BasicBlock *, 16> Blocks;
+    for (BasicBlock &BB : F)
+      Blocks.push_back(&BB);
+    if (Pass)
+      std::reverse(Blocks.begin(), Blocks.end());
+    for (BasicBlock *BB : Blocks)
+      Ranges.push_back(LVI.getConstantRange(X, BB->getTerminator(),
+                                            /*UndefAllowed=*/false));
+  }
+  return Ranges;
+}
+
+TEST(LazyValueInfoTest, MaxCachedBlocks) {
+  LLVMContext C;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(
+      "define void @f(i32 %x) {\n"
+      "entry:\n"
+      "  %c0 = icmp ult i32 %x, 100\n"
+      "  br i1 %c0, label %b1, label %exit\n"
+      "b1:\n"
+      "  %c1 = icmp ugt i32 %x, 10\n"
+      "  br i1 %c1, label %b2, label %exit\n"
+      "b2:\n"
+      "  br label %b3\n"
+      "b3:\n"
+      "  %c3 = icmp ult i32 %x, 50\n"
+      "  br i1 %c3, label %b4, label %exit\n"
+      "b4:\n"
+      "  br label %b5\n"
+      "b5:\n"
+      "  br label %b6\n"
+      "b6:\n"
+      "  br label %exit\n"
+      "exit:\n"
+      "  ret void\n"
+      "}\n",
+      Err, C);
+  ASSERT_TRUE(M);
+  Function &F = *M->getFunction("f");
+
+  auto &MaxCachedBlocks = *static_cast<cl::opt<unsigned> *>(
+      cl::getRegisteredOptions().lookup("lvi-max-cached-blocks"));
+
+  std::vector<ConstantRange> Unbounded = queryChain(F);
+  EXPECT_EQ(Unbounded[6], ConstantRange(APInt(32, 11), APInt(32, 50)));
+
+  // Evicted blocks are recomputed on demand and give the same answers.
+  for (unsigned Max : {1u, 2u, 4u}) {
+    MaxCachedBlocks = Max;
+    EXPECT_EQ(queryChain(F), Unbounded) << "lvi-max-cached-blocks=" << Max;
+  }
+  MaxCachedBlocks = 0;
+}
+
+} // end anonymous namespace
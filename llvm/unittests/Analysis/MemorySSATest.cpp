@@ -815,6 +815,43 @@ TEST_F(MemorySSATest, WalkerReopt) {
   EXPECT_EQ(NewLoadAccess->getDefiningAccess(), LoadClobber);
 }
 
+// Test that a batch of clobber queries gives the same answers as single ones.
+TEST_F(MemorySSATest, WalkerBatchQuery) {
+  F = Function::Create(FunctionType::get(B.getVoidTy(), {}, false),
+                       GlobalValue::ExternalLinkage, "F", &M);
+  B.SetInsertPoint(BasicBlock::Create(C, "", F));
+  Type *Int8 = Type::getInt8Ty(C);
+  Value *AllocaA = B.CreateAlloca(Int8, ConstantInt::get(Int8, 1), "A");
+  Instruction *SIA = B.CreateStore(ConstantInt::get(Int8, 0), AllocaA);
+  Value *AllocaB = B.CreateAlloca(Int8, ConstantInt::get(Int8, 1), "B");
+  Instruction *SIB = B.CreateStore(ConstantInt::get(Int8, 0), AllocaB);
+  Instruction *LIA = B.CreateLoad(Int8, AllocaA);
+  Instruction *LIB = B.CreateLoad(Int8, AllocaB);
+
+  setupAnalyses();
+  MemorySSA &MSSA = *Analyses->MSSA;
+  MemorySSAWalker *Walker = Analyses->Walker;
+
+  MemoryAccess *Accesses[] = {MSSA.getMemoryAccess(LIA),
+                              MSSA.getMemoryAccess(SIB),
+                              MSSA.getMemoryAccess(LIB)};
+  SmallVector<MemoryAccess *, 4> Clobbers;
+  BatchAAResults BAA(Analyses->AA);
+  Walker->getClobberingMemoryAccesses(Accesses, Clobbers, BAA);
+  ASSERT_EQ(Clobbers.size(), 3u);
+  EXPECT_EQ(Clobbers[0], MSSA.getMemoryAccess(SIA));
+  EXPECT_TRUE(MSSA.isLiveOnEntryDef(Clobbers[1]));
+  EXPECT_EQ(Clobbers[2], MSSA.getMemoryAccess(SIB));
+
+  // The results match the single queries and are appended.
+  Walker->getClobberingMemoryAccesses(Accesses, Clobbers);
+  ASSERT_EQ(Clobbers.size(), 6u);
+  for (unsigned I = 0; I != 3; ++I) {
+    EXPECT_EQ(Clobbers[I], Clobbers[I + 3]);
+    EXPECT_EQ(Clobbers[I], Walker->getClobberingMemoryAccess(Accesses[I]));
+  }
+}
+
 // Test out MemorySSAUpdater::moveBefore
 TEST_F(MemorySSATest, MoveAboveMemoryDef) {
   F = Function::Create(FunctionType::get(B.getVoidTy(), {}, false),
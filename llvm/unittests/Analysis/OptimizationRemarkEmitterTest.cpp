@@ -0,0 +1,59 @@
+//===- OptimizationRemarkEmitterTest.cpp - ORE unit tests -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Analysis/OptimizationRemarkEmitter.h"
+#include "llvm/IR/DiagnosticInfo.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LLVMRemarkStreamer.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+TEST(OptimizationRemarkEmitterTest, BuilderOnlyCalledWhenEnabled) {
+  // The context streams remarks to OS, so it must not outlive it.
+  std::string Remarks;
+  raw_string_ostream OS(Remarks);
+  LLVMContext C;
+  Module M("ORETest", C);
+  Function *F =
+      Function::Create(FunctionType::get(Type::getVoidTy(C), false),
+                       Function::ExternalLinkage, "f", M);
+
+  ASSERT_THAT_ERROR(setupLLVMOptimizationRemarks(C, OS, "^inline$", "yaml",
+                                                 /*RemarksWithHotness=*/false),
+                    Succeeded());
+
+  OptimizationRemarkEmitter ORE(F);
+  EXPECT_TRUE(ORE.enabled("inline", DK_OptimizationRemark));
+  EXPECT_TRUE(ORE.enabled("inline", DK_OptimizationRemarkMissed));
+  EXPECT_FALSE(ORE.enabled("licm", DK_OptimizationRemark));
+  EXPECT_TRUE(OptimizationRemarkEmitter::allowExtraAnalysis(*F, "inline"));
+  EXPECT_FALSE(OptimizationRemarkEmitter::allowExtraAnalysis(*F, "licm"));
+
+  unsigned NumBuilt = 0;
+  ORE.emit("inline", [&]() {
+    ++NumBuilt;
+    return OptimizationRemark("inline", "Inlined", F);
+  });
+  ORE.emit("licm", [&]() {
+    ++NumBuilt;
+    return OptimizationRemarkMissed("licm", "Hoisted", F);
+  });
+  EXPECT_EQ(NumBuilt, 1u);
+
+  EXPECT_NE(Remarks.find("Name:            Inlined"), std::string::npos);
+  EXPECT_EQ(Remarks.find("Hoisted"), std::string::npos);
+}
+
+} // end anonymous namespace
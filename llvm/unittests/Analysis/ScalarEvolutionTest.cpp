@@ -21,6 +21,7 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/SourceMgr.h"
 #include "gtest/gtest.h"
 
@@ -1589,4 +1590,61 @@ TEST_F(ScalarEvolutionsTest, ApplyLoopGuards) {
   });
 }
 
+TEST_F(ScalarEvolutionsTest, CacheBudget) {
+  LLVMContext C;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(
+      "define void @foo(i32 %n) { "
+      "entry: "
+      "  br label %loop.a "
+      "loop.a: "
+      "  %a = phi i32 [ 0, %entry ], [ %a.next, %loop.a ] "
+      "  %a.next = add i32 %a, 1 "
+      "  %a.cmp = icmp slt i32 %a.next, %n "
+      "  br i1 %a.cmp, label %loop.a, label %loop.b "
+      "loop.b: "
+      "  %b = phi i32 [ 0, %loop.a ], [ %b.next, %loop.b ] "
+      "  %b.next = add i32 %b, 2 "
+      "  %b.cmp = icmp slt i32 %b.next, %n "
+      "  br i1 %b.cmp, label %loop.b, label %exit "
+      "exit: "
+      "  ret void "
+      "} ",
+      Err, C);
+
+  ASSERT_TRUE(M && "Could not parse module?");
+  ASSERT_TRUE(!verifyModule(*M) && "Must have been well formed!");
+
+  auto &Budget = *static_cast<cl::opt<unsigned> *>(
+      cl::getRegisteredOptions().lookup("scalar-evolution-cache-budget"));
+
+  auto ForgetLoopA = [&](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    Instruction *A = getInstructionByName(F, "a");
+    Instruction *B = getInstructionByName(F, "b");
+    SE.getSCEV(A);
+    SE.getSCEV(B);
+    SE.forgetLoop(LI.getLoopFor(A->getParent()));
+    EXPECT_EQ(SE.getExistingSCEV(A), nullptr);
+    return SE.getExistingSCEV(B) != nullptr;
+  };
+
+  // Without a budget, forgetting one loop keeps the other loop's entries.
+  runWithSE(*M, "foo", [&](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    EXPECT_TRUE(ForgetLoopA(F, LI, SE));
+  });
+
+  // Over budget, everything is dropped.
+  Budget = 1;
+  runWithSE(*M, "foo", [&](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    EXPECT_FALSE(ForgetLoopA(F, LI, SE));
+  });
+
+  // Within budget, the caches are left alone.
+  Budget = 1000;
+  runWithSE(*M, "foo", [&](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    EXPECT_TRUE(ForgetLoopA(F, LI, SE));
+  });
+  Budget = 0;
+}
+
 }  // end namespace llvm
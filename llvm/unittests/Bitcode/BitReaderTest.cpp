@@ -13,6 +13,7 @@
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/Constants.h"
+#include "llvm/IR/DebugInfoMetadata.h"
 #include "llvm/IR/InstrTypes.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
@@ -124,6 +125,88 @@ TEST(BitReaderTest, MaterializeFunctionsOutOfOrder) {
   EXPECT_FALSE(verifyModule(*M, &dbgs()));
 }
 
+// Tests that a batch of functions can be materialized in one call, in any
+// order, leaving the rest of the module lazy.
+TEST(BitReaderTest, MaterializeFunctionsBatch) {
+  SmallString<1024> Mem;
+  LLVMContext Context;
+  std::unique_ptr<Module> M = getLazyModuleFromAssembly(
+      Context, Mem, "define void @f() {\n"
+                    "  unreachable\n"
+                    "}\n"
+                    "define void @g() {\n"
+                    "  unreachable\n"
+                    "}\n"
+                    "define void @h() {\n"
+                    "  unreachable\n"
+                    "}\n"
+                    "define void @j() {\n"
+                    "  unreachable\n"
+                    "}\n");
+
+  Function *F = M->getFunction("f");
+  Function *G = M->getFunction("g");
+  Function *H = M->getFunction("h");
+  Function *J = M->getFunction("j");
+
+  // Duplicates and already materialized functions are fine.
+  ASSERT_FALSE(H->materialize());
+  ASSERT_FALSE(M->materializeBatch({J, H, F, J}));
+  EXPECT_FALSE(F->empty());
+  EXPECT_TRUE(G->empty());
+  EXPECT_FALSE(H->empty());
+  EXPECT_FALSE(J->empty());
+  EXPECT_FALSE(verifyModule(*M, &dbgs()));
+
+  ASSERT_FALSE(M->materializeBatch({G}));
+  EXPECT_FALSE(G->empty());
+  EXPECT_FALSE(verifyModule(*M, &dbgs()));
+}
+
+// Tests that the compile unit lists dropped by the IRMover when importing are
+// not loaded for a module being imported from.
+TEST(BitReaderTest, ImportingSkipsCompileUnitLists) {
+  const char *Assembly =
+      "define void @f() !dbg !6 {\n"
+      "  ret void\n"
+      "}\n"
+      "!llvm.dbg.cu = !{!0}\n"
+      "!llvm.module.flags = !{!5}\n"
+      "!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, "
+      "emissionKind: FullDebug, enums: !2, retainedTypes: !4)\n"
+      "!1 = !DIFile(filename: \"t.c\", directory: \"/\")\n"
+      "!2 = !{!3}\n"
+      "!3 = !DICompositeType(tag: DW_TAG_enumeration_type, name: \"E\", "
+      "file: !1, identifier: \"_E\")\n"
+      "!4 = !{!3}\n"
+      "!5 = !{i32 2, !\"Debug Info Version\", i32 3}\n"
+      "!6 = distinct !DISubprogram(name: \"f\", scope: !1, file: !1, "
+      "unit: !0, spFlags: DISPFlagDefinition)\n";
+
+  for (bool IsImporting : {false, true}) {
+    SmallString<1024> Mem;
+    LLVMContext Context;
+    writeModuleToBuffer(parseAssembly(Context, Assembly), Mem);
+    Expected<std::vector<BitcodeModule>> BMs =
+        getBitcodeModuleList(MemoryBufferRef(Mem.str(), "test"));
+    if (!BMs)
+      report_fatal_error("Could not read bitcode module list");
+    ASSERT_EQ(BMs->size(), 1u);
+    Expected<std::unique_ptr<Module>> MOrErr = (*BMs)[0].getLazyModule(
+        Context, /*ShouldLazyLoadMetadata=*/true, IsImporting);
+    if (!MOrErr)
+      report_fatal_error("Could not parse bitcode module");
+    std::unique_ptr<Module> M = std::move(*MOrErr);
+    ASSERT_FALSE(M->materializeMetadata());
+
+    auto *CU = cast<DICompileUnit>(
+        M->getNamedMetadata("llvm.dbg.cu")->getOperand(0));
+    EXPECT_EQ(CU->getEnumTypes().empty(), IsImporting);
+    EXPECT_EQ(CU->getRetainedTypes().empty(), IsImporting);
+    EXPECT_EQ(CU->getFilename(), "t.c");
+  }
+}
+
 TEST(BitReaderTest, MaterializeFunctionsStrictFP) {
   SmallString<1024> Mem;
 
@@ -27,6 +27,7 @@
 #include "llvm/ObjectYAML/DWARFEmitter.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/TargetParser/Triple.h"
 #include "llvm/Testing/Support/Error.h"
@@ -1463,6 +1464,67 @@ TEST(DWARFDebugInfo, TestEmptyChildren) {
   EXPECT_EQ(CUDie.begin(), CUDie.end());
 }
 
+TEST(DWARFDebugInfo, TestParallelVerifyMatchesSerial) {
+  // Every unit has an out of range DW_FORM_ref4, so each chunk of a parallel
+  // verification reports errors that must be printed in unit order.
+  std::string Yaml = "debug_abbrev:\n"
+                     "  - Table:\n"
+                     "      - Code:            0x00000001\n"
+                     "        Tag:             DW_TAG_compile_unit\n"
+                     "        Children:        DW_CHILDREN_yes\n"
+                     "        Attributes:\n"
+                     "          - Attribute:       DW_AT_name\n"
+                     "            Form:            DW_FORM_string\n"
+                     "      - Code:            0x00000002\n"
+                     "        Tag:             DW_TAG_variable\n"
+                     "        Children:        DW_CHILDREN_no\n"
+                     "        Attributes:\n"
+                     "          - Attribute:       DW_AT_type\n"
+                     "            Form:            DW_FORM_ref4\n"
+                     "debug_info:\n";
+  for (unsigned I = 0; I < 16; ++I)
+    Yaml += "  - Version:         4\n"
+            "    AddrSize:        8\n"
+            "    Entries:\n"
+            "      - AbbrCode:        0x00000001\n"
+            "        Values:\n"
+            "          - CStr:            cu" +
+            std::to_string(I) +
+            "\n"
+            "      - AbbrCode:        0x00000002\n"
+            "        Values:\n"
+            "          - Value:           0x00001000\n"
+            "      - AbbrCode:        0x00000000\n";
+
+  auto ErrOrSections = DWARFYAML::emitDebugSections(StringRef(Yaml));
+  ASSERT_TRUE((bool)ErrOrSections);
+
+  auto Verify = [&](bool ThreadSafe, std::string &Output) {
+    std::unique_ptr<DWARFContext> DwarfContext = DWARFContext::create(
+        *ErrOrSections, 8, sys::IsLittleEndianHost,
+        WithColor::defaultErrorHandler, WithColor::defaultWarningHandler,
+        ThreadSafe);
+    EXPECT_EQ(DwarfContext->getNumCompileUnits(), 16u);
+    raw_string_ostream OS(Output);
+    return DwarfContext->verify(OS);
+  };
+
+  ThreadPoolStrategy OldStrategy = parallel::strategy;
+  parallel::strategy = hardware_concurrency(4);
+  std::string Serial, Parallel;
+  EXPECT_FALSE(Verify(/*ThreadSafe=*/false, Serial));
+  EXPECT_FALSE(Verify(/*ThreadSafe=*/true, Parallel));
+  parallel::strategy = OldStrategy;
+
+  EXPECT_EQ(Serial, Parallel);
+  unsigned NumErrors = 0;
+  for (size_t Pos = Parallel.find("CU offset 0x00001000 is invalid");
+       Pos != std::string::npos;
+       Pos = Parallel.find("CU offset 0x00001000 is invalid", Pos + 1))
+    ++NumErrors;
+  EXPECT_EQ(NumErrors, 16u);
+}
+
 TEST(DWARFDebugInfo, TestAttributeIterators) {
   Triple Triple = getNormalizedDefaultTargetTriple();
   if (!isConfigurationSupported(Triple))
@@ -643,4 +643,222 @@ TEST(DWARFDie, getDeclFileSpecificationAcrossCUBoundary) {
   EXPECT_EQ(DeclFile, Ref);
 }
 
+TEST(DWARFDie, getDIEsForAddressWithBoundedUnitCache) {
+  // Two compile units with one function each. With a unit cache smaller than
+  // one unit, every lookup frees the DIEs of the other unit, so alternating
+  // lookups must re-extract them.
+  const char *yamldata = R"(
+  debug_str:
+    - ''
+    - /tmp/a.c
+    - a
+    - /tmp/b.c
+    - b
+  debug_abbrev:
+    - ID:              0
+      Table:
+        - Code:            0x00000001
+          Tag:             DW_TAG_compile_unit
+          Children:        DW_CHILDREN_yes
+          Attributes:
+            - Attribute:       DW_AT_name
+              Form:            DW_FORM_strp
+            - Attribute:       DW_AT_low_pc
+              Form:            DW_FORM_addr
+            - Attribute:       DW_AT_high_pc
+              Form:            DW_FORM_addr
+        - Code:            0x00000002
+          Tag:             DW_TAG_subprogram
+          Children:        DW_CHILDREN_no
+          Attributes:
+            - Attribute:       DW_AT_name
+              Form:            DW_FORM_strp
+            - Attribute:       DW_AT_low_pc
+              Form:            DW_FORM_addr
+            - Attribute:       DW_AT_high_pc
+              Form:            DW_FORM_addr
+  debug_info:
+    - Version:         4
+      AddrSize:        8
+      AbbrevTableID:   0
+      Entries:
+        - AbbrCode:        0x00000001
+          Values:
+            - Value:           0x0000000000000001
+            - Value:           0x0000000000001000
+            - Value:           0x0000000000002000
+        - AbbrCode:        0x00000002
+          Values:
+            - Value:           0x000000000000000A
+            - Value:           0x0000000000001000
+            - Value:           0x0000000000002000
+        - AbbrCode:        0x00000000
+    - Version:         4
+      AddrSize:        8
+      AbbrevTableID:   0
+      Entries:
+        - AbbrCode:        0x00000001
+          Values:
+            - Value:           0x000000000000000C
+            - Value:           0x0000000000002000
+            - Value:           0x0000000000003000
+        - AbbrCode:        0x00000002
+          Values:
+            - Value:           0x0000000000000015
+            - Value:           0x0000000000002000
+            - Value:           0x0000000000003000
+        - AbbrCode:        0x00000000
+  )";
+  Expected<StringMap<std::unique_ptr<MemoryBuffer>>> Sections =
+      DWARFYAML::emitDebugSections(StringRef(yamldata),
+                                   /*IsLittleEndian=*/true,
+                                   /*Is64BitAddrSize=*/true);
+  ASSERT_THAT_EXPECTED(Sections, Succeeded());
+  std::unique_ptr<DWARFContext> Ctx =
+      DWARFContext::create(*Sections, 8, /*isLittleEndian=*/true);
+  Ctx->setMaxAddressLookupUnitsSize(1);
+
+  for (int I = 0; I < 2; ++I) {
+    DWARFContext::DIEsForAddress A = Ctx->getDIEsForAddress(0x1800);
+    ASSERT_NE(A.CompileUnit, nullptr);
+    EXPECT_EQ(A.CompileUnit->getOffset(), 0u);
+    EXPECT_STREQ(A.FunctionDIE.getShortName(), "a");
+
+    DWARFContext::DIEsForAddress B = Ctx->getDIEsForAddress(0x2800);
+    ASSERT_NE(B.CompileUnit, nullptr);
+    EXPECT_NE(B.CompileUnit->getOffset(), 0u);
+    EXPECT_STREQ(B.FunctionDIE.getShortName(), "b");
+  }
+}
+
+
+TEST(DWARFDie, getInliningInfoAcrossUnitsWithBoundedUnitCache) {
+  // The function in the first unit inlines a function whose abstract origin
+  // is in the second unit. Every lookup frees the DIEs of the units that the
+  // previous one used, including the unit it reached through DW_FORM_ref_addr,
+  // which must be extracted again rather than used after being freed.
+  const char *yamldata = R"(
+  debug_str:
+    - ''
+    - /tmp/a.c
+    - a
+    - /tmp/b.c
+    - b
+    - b_inl
+  debug_abbrev:
+    - ID:              0
+      Table:
+        - Code:            0x00000001
+          Tag:             DW_TAG_compile_unit
+          Children:        DW_CHILDREN_yes
+          Attributes:
+            - Attribute:       DW_AT_name
+              Form:            DW_FORM_strp
+            - Attribute:       DW_AT_low_pc
+              Form:            DW_FORM_addr
+            - Attribute:       DW_AT_high_pc
+              Form:            DW_FORM_addr
+        - Code:            0x00000002
+          Tag:             DW_TAG_subprogram
+          Children:        DW_CHILDREN_no
+          Attributes:
+            - Attribute:       DW_AT_name
+              Form:            DW_FORM_strp
+            - Attribute:       DW_AT_low_pc
+              Form:            DW_FORM_addr
+            - Attribute:       DW_AT_high_pc
+              Form:            DW_FORM_addr
+        - Code:            0x00000003
+          Tag:             DW_TAG_subprogram
+          Children:        DW_CHILDREN_yes
+          Attributes:
+            - Attribute:       DW_AT_name
+              Form:            DW_FORM_strp
+            - Attribute:       DW_AT_low_pc
+              Form:            DW_FORM_addr
+            - Attribute:       DW_AT_high_pc
+              Form:            DW_FORM_addr
+        - Code:            0x00000004
+          Tag:             DW_TAG_inlined_subroutine
+          Children:        DW_CHILDREN_no
+          Attributes:
+            - Attribute:       DW_AT_abstract_origin
+              Form:            DW_FORM_ref_addr
+            - Attribute:       DW_AT_low_pc
+              Form:            DW_FORM_addr
+            - Attribute:       DW_AT_high_pc
+              Form:            DW_FORM_addr
+        - Code:            0x00000005
+          Tag:             DW_TAG_subprogram
+          Children:        DW_CHILDREN_no
+          Attributes:
+            - Attribute:       DW_AT_name
+              Form:            DW_FORM_strp
+  debug_info:
+    - Version:         4
+      AddrSize:        8
+      AbbrevTableID:   0
+      Entries:
+        - AbbrCode:        0x00000001
+          Values:
+            - Value:           0x0000000000000001
+            - Value:           0x0000000000001000
+            - Value:           0x0000000000002000
+        - AbbrCode:        0x00000003
+          Values:
+            - Value:           0x000000000000000A
+            - Value:           0x0000000000001000
+            - Value:           0x0000000000002000
+        - AbbrCode:        0x00000004
+          Values:
+            - Value:           0x0000000000000081
+            - Value:           0x0000000000001100
+            - Value:           0x0000000000001200
+        - AbbrCode:        0x00000000
+        - AbbrCode:        0x00000000
+    - Version:         4
+      AddrSize:        8
+      AbbrevTableID:   0
+      Entries:
+        - AbbrCode:        0x00000001
+          Values:
+            - Value:           0x000000000000000C
+            - Value:           0x0000000000002000
+            - Value:           0x0000000000003000
+        - AbbrCode:        0x00000002
+          Values:
+            - Value:           0x0000000000000015
+            - Value:           0x0000000000002000
+            - Value:           0x0000000000003000
+        - AbbrCode:        0x00000005
+          Values:
+            - Value:           0x0000000000000017
+        - AbbrCode:        0x00000000
+  )";
+  Expected<StringMap<std::unique_ptr<MemoryBuffer>>> Sections =
+      DWARFYAML::emitDebugSections(StringRef(yamldata),
+                                   /*IsLittleEndian=*/true,
+                                   /*Is64BitAddrSize=*/true);
+  ASSERT_THAT_EXPECTED(Sections, Succeeded());
+  std::unique_ptr<DWARFContext> Ctx =
+      DWARFContext::create(*Sections, 8, /*isLittleEndian=*/true);
+  Ctx->setMaxAddressLookupUnitsSize(1);
+  ASSERT_EQ(Ctx->getNumCompileUnits(), 2u);
+  // The DW_FORM_ref_addr above refers to b_inl.
+  ASSERT_EQ(Ctx->getUnitAtIndex(1)->getOffset(), 0x4cu);
+
+  DILineInfoSpecifier Spec(DILineInfoSpecifier::FileLineInfoKind::None,
+                           DINameKind::ShortName);
+  for (int I = 0; I < 3; ++I) {
+    DIInliningInfo A = Ctx->getInliningInfoForAddress({0x1150}, Spec);
+    ASSERT_EQ(A.getNumberOfFrames(), 2u);
+    EXPECT_EQ(A.getFrame(0).FunctionName, "b_inl");
+    EXPECT_EQ(A.getFrame(1).FunctionName, "a");
+
+    DIInliningInfo B = Ctx->getInliningInfoForAddress({0x2800}, Spec);
+    ASSERT_EQ(B.getNumberOfFrames(), 1u);
+    EXPECT_EQ(B.getFrame(0).FunctionName, "b");
+  }
+}
+
 } // end anonymous namespace
@@ -14,6 +14,7 @@
 #include "llvm/DebugInfo/GSYM/FileEntry.h"
 #include "llvm/DebugInfo/GSYM/FileWriter.h"
 #include "llvm/DebugInfo/GSYM/FunctionInfo.h"
+#include "llvm/DebugInfo/GSYM/GsymContext.h"
 #include "llvm/DebugInfo/GSYM/GsymCreator.h"
 #include "llvm/DebugInfo/GSYM/GsymReader.h"
 #include "llvm/DebugInfo/GSYM/Header.h"
@@ -4905,3 +4906,96 @@ TEST(GSYMTest, TestLookupsOfOverlappingAndUnequalRanges) {
   for (const auto &Line : ExpectedDumpLines)
     EXPECT_TRUE(DumpStr.find(Line) != std::string::npos);
 }
+
+TEST(GSYMTest, TestGsymContext) {
+  // Test that GsymContext answers symbolication queries with the locations
+  // from the GSYM lookups, including inlined frames.
+  GsymCreator GC;
+  FunctionInfo FI(0x1000, 0x100, GC.insertString("main"));
+  const auto ByteOrder = llvm::endianness::native;
+  FI.OptLineTable = LineTable();
+  const uint32_t MainFileIndex = GC.insertFile("/tmp/main.c");
+  const uint32_t FooFileIndex = GC.insertFile("/tmp/foo.h");
+  FI.OptLineTable->push(LineEntry(0x1000, MainFileIndex, 5));
+  FI.OptLineTable->push(LineEntry(0x1010, FooFileIndex, 10));
+  FI.OptLineTable->push(LineEntry(0x1020, MainFileIndex, 8));
+  FI.Inline = InlineInfo();
+  FI.Inline->Name = GC.insertString("inline1");
+  FI.Inline->CallFile = MainFileIndex;
+  FI.Inline->CallLine = 6;
+  FI.Inline->Ranges.insert(AddressRange(0x1010, 0x1020));
+  GC.addFunctionInfo(std::move(FI));
+  OutputAggregator Null(nullptr);
+  Error FinalizeErr = GC.finalize(Null);
+  ASSERT_FALSE(FinalizeErr);
+  SmallString<512> Str;
+  raw_svector_ostream OutStrm(Str);
+  FileWriter FW(OutStrm, ByteOrder);
+  llvm::Error Err = GC.encode(FW);
+  ASSERT_FALSE((bool)Err);
+  Expected<GsymReader> GR = GsymReader::copyBuffer(OutStrm.str());
+  ASSERT_TRUE(bool(GR));
+  GsymContext Ctx(std::make_unique<GsymReader>(std::move(*GR)));
+
+  DILineInfoSpecifier Spec(
+      DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath,
+      DINameKind::LinkageName);
+  DILineInfo LI = Ctx.getLineInfoForAddress({0x1000}, Spec);
+  EXPECT_EQ(LI.FunctionName, "main");
+  EXPECT_EQ(LI.FileName, "/tmp/main.c");
+  EXPECT_EQ(LI.Line, 5u);
+  EXPECT_EQ(LI.StartAddress, 0x1000u);
+
+  DIInliningInfo II = Ctx.getInliningInfoForAddress({0x1010}, Spec);
+  ASSERT_EQ(II.getNumberOfFrames(), 2u);
+  EXPECT_EQ(II.getFrame(0).FunctionName, "inline1");
+  EXPECT_EQ(II.getFrame(0).FileName, "/tmp/foo.h");
+  EXPECT_EQ(II.getFrame(0).Line, 10u);
+  EXPECT_EQ(II.getFrame(1).FunctionName, "main");
+  EXPECT_EQ(II.getFrame(1).FileName, "/tmp/main.c");
+  EXPECT_EQ(II.getFrame(1).Line, 6u);
+  EXPECT_EQ(II.getFrame(1).StartAddress, 0x1000u);
+
+  Spec.FLIKind = DILineInfoSpecifier::FileLineInfoKind::BaseNameOnly;
+  LI = Ctx.getLineInfoForAddress({0x1010}, Spec);
+  EXPECT_EQ(LI.FunctionName, "inline1");
+  EXPECT_EQ(LI.FileName, "foo.h");
+
+  // Addresses outside of any function produce empty results.
+  LI = Ctx.getLineInfoForAddress({0x2000}, Spec);
+  EXPECT_EQ(LI.FunctionName, DILineInfo::BadString);
+  EXPECT_EQ(Ctx.getInliningInfoForAddress({0x2000}, Spec).getNumberOfFrames(),
+            0u);
+}
+
+TEST(GSYMTest, TestGsymCreatorManyFunctions) {
+  // Test that finalizing and encoding enough function infos to need several
+  // encoding windows keeps the functions sorted and removes the symbol table
+  // entries that are duplicated by function infos with debug info.
+  GsymCreator GC;
+  constexpr uint64_t BaseAddr = 0x1000;
+  constexpr uint64_t NumFuncs = 10000;
+  const uint32_t FileIdx = GC.insertFile("/tmp/main.c");
+  // Add the functions in reverse order so finalizing has to sort them.
+  for (uint64_t I = NumFuncs; I-- > 0;) {
+    const uint64_t FuncAddr = BaseAddr + I * 0x10;
+    const uint32_t Name = GC.insertString("func" + std::to_string(I));
+    GC.addFunctionInfo(FunctionInfo(FuncAddr, 0x10, Name));
+    FunctionInfo FI(FuncAddr, 0x10, Name);
+    FI.OptLineTable = LineTable();
+    FI.OptLineTable->push(LineEntry(FuncAddr, FileIdx, I + 1));
+    GC.addFunctionInfo(std::move(FI));
+  }
+  Expected<GsymReader> GR = FinalizeEncodeAndDecode(GC);
+  ASSERT_THAT_EXPECTED(GR, Succeeded());
+  EXPECT_EQ(GR->getNumAddresses(), NumFuncs);
+  for (uint64_t I : {uint64_t(0), uint64_t(4095), uint64_t(4096),
+                     uint64_t(8193), NumFuncs - 1}) {
+    const std::string Name = "func" + std::to_string(I);
+    auto LR = GR->lookup(BaseAddr + I * 0x10 + 4);
+    ASSERT_THAT_EXPECTED(LR, Succeeded());
+    EXPECT_THAT(LR->Locations,
+                testing::ElementsAre(SourceLocation{
+                    Name, "/tmp", "main.c", static_cast<uint32_t>(I + 1), 4}));
+  }
+}
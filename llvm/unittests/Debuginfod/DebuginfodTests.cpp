@@ -7,11 +7,18 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Debuginfod/Debuginfod.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Debuginfod/HTTPClient.h"
+#include "llvm/Debuginfod/HTTPServer.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/LockFileManager.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Testing/Support/Error.h"
 #include "gtest/gtest.h"
+#include <atomic>
+#include <thread>
 
 #ifdef _WIN32
 #define setenv(name, var, ignore) _putenv_s(name, var)
@@ -67,3 +74,194 @@ TEST(DebuginfodClient, CacheMiss) {
   // A cache miss with no possible URLs should not create the cache directory.
   EXPECT_FALSE(sys::fs::exists(CacheDir));
 }
+
+// Check that fetching several artifacts at once returns the result of each of
+// them in order.
+TEST(DebuginfodClient, FetchSeveral) {
+  SmallString<32> CacheDir;
+  ASSERT_NO_ERROR(
+      sys::fs::createUniqueDirectory("debuginfod-unittest", CacheDir));
+  setenv("DEBUGINFOD_CACHE_PATH", CacheDir.c_str(),
+         /*replace=*/1);
+  // Ensure there are no urls, so that only cached artifacts are found.
+  setenv("DEBUGINFOD_URLS", "", /*replace=*/1);
+  HTTPClient::initialize();
+
+  std::vector<std::string> UrlPaths = {"/buildid/1/debuginfo",
+                                       "/buildid/2/debuginfo",
+                                       "/buildid/3/debuginfo"};
+  SmallVector<SmallString<64>, 3> CachedFilePaths;
+  for (const std::string &UrlPath : UrlPaths) {
+    SmallString<64> &CachedFilePath = CachedFilePaths.emplace_back();
+    sys::path::append(CachedFilePath, CacheDir,
+                      "llvmcache-" + getDebuginfodCacheKey(UrlPath));
+  }
+  for (unsigned I : {0, 2}) {
+    std::error_code EC;
+    raw_fd_ostream OF(CachedFilePaths[I], EC);
+    ASSERT_NO_ERROR(EC);
+    OF << "contents " << I << "\n";
+  }
+
+  std::vector<Expected<std::string>> PathsOrErr =
+      getCachedOrDownloadArtifacts(UrlPaths);
+  ASSERT_EQ(PathsOrErr.size(), 3u);
+  EXPECT_THAT_EXPECTED(PathsOrErr[0], HasValue(CachedFilePaths[0]));
+  EXPECT_THAT_EXPECTED(PathsOrErr[1], Failed<StringError>());
+  EXPECT_THAT_EXPECTED(PathsOrErr[2], HasValue(CachedFilePaths[2]));
+}
+
+#if defined(LLVM_ENABLE_HTTPLIB) && defined(LLVM_ENABLE_CURL)
+// Test the client against a local debuginfod server.
+
+// Serves Body for every artifact and counts the requests.
+class DebuginfodClientServerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    HTTPClient::initialize();
+    ASSERT_NO_ERROR(
+        sys::fs::createUniqueDirectory("debuginfod-unittest", CacheDir));
+    ASSERT_THAT_ERROR(Server.get(R"(/(.*))",
+                                 [this](HTTPServerRequest &Request) {
+                                   ++NumRequests;
+                                   // Slow the download down so that
+                                   // concurrent clients overlap.
+                                   std::this_thread::sleep_for(
+                                       std::chrono::milliseconds(50));
+                                   Request.setResponse(
+                                       {200u, "application/octet-stream",
+                                        Body});
+                                 }),
+                      Succeeded());
+    Expected<unsigned> PortOrErr = Server.bind();
+    ASSERT_THAT_EXPECTED(PortOrErr, Succeeded());
+    Url = "http://localhost:" + utostr(*PortOrErr);
+    Pool.async([&]() { EXPECT_THAT_ERROR(Server.listen(), Succeeded()); });
+  }
+  void TearDown() override {
+    Server.stop();
+    Pool.wait();
+    HTTPClient::cleanup();
+    sys::fs::remove_directories(CacheDir);
+  }
+
+  Expected<std::string> fetch(StringRef Key) {
+    StringRef Urls[] = {Url};
+    return getCachedOrDownloadArtifact(Key, "/artifact", CacheDir, Urls,
+                                       std::chrono::milliseconds(10000));
+  }
+
+  std::string readFile(StringRef Path) {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> Buf = MemoryBuffer::getFile(Path);
+    EXPECT_TRUE(bool(Buf));
+    return Buf ? (*Buf)->getBuffer().str() : "";
+  }
+
+  std::string path(StringRef Name) {
+    SmallString<64> Path(CacheDir);
+    sys::path::append(Path, Name);
+    return std::string(Path);
+  }
+
+  StringRef Body = "0123456789abcdef";
+  SmallString<32> CacheDir;
+  std::string Url;
+  std::atomic<unsigned> NumRequests = 0;
+  HTTPServer Server;
+  DefaultThreadPool Pool{hardware_concurrency(1)};
+};
+
+TEST_F(DebuginfodClientServerTest, Download) {
+  Expected<std::string> PathOrErr = fetch("key");
+  ASSERT_THAT_EXPECTED(PathOrErr, HasValue(path("llvmcache-key")));
+  EXPECT_EQ(readFile(*PathOrErr), Body);
+  // The lock and partial files are gone.
+  EXPECT_FALSE(sys::fs::exists(path("debuginfod-download-key.lock")));
+  EXPECT_FALSE(sys::fs::exists(path("debuginfod-download-key.partial")));
+}
+
+// An artifact with an empty body is stored as an empty file.
+TEST_F(DebuginfodClientServerTest, EmptyBody) {
+  Body = "";
+  Expected<std::string> PathOrErr = fetch("key");
+  ASSERT_THAT_EXPECTED(PathOrErr, HasValue(path("llvmcache-key")));
+  EXPECT_EQ(readFile(*PathOrErr), "");
+}
+
+// A partial file left over by an interrupted download is completed with a
+// range request. It is deliberately not a prefix of the body, to show that
+// only the rest of the body was appended to it.
+TEST_F(DebuginfodClientServerTest, Resume) {
+  {
+    std::error_code EC;
+    raw_fd_ostream Partial(path("debuginfod-download-key.partial"), EC);
+    ASSERT_NO_ERROR(EC);
+    Partial << "XXXX";
+  }
+  Expected<std::string> PathOrErr = fetch("key");
+  ASSERT_THAT_EXPECTED(PathOrErr, HasValue(path("llvmcache-key")));
+  EXPECT_EQ(readFile(*PathOrErr), "XXXX" + Body.drop_front(4).str());
+  EXPECT_EQ(NumRequests, 1u);
+}
+
+// While another client holds the lock, a client waits and then uses the
+// artifact that the other one stored, without downloading it again.
+TEST_F(DebuginfodClientServerTest, WaitForLock) {
+  std::optional<LockFileManager> Locker;
+  Locker.emplace(path("debuginfod-download-key"));
+  ASSERT_EQ(LockFileManager::LockFileState(*Locker),
+            LockFileManager::LFS_Owned);
+
+  DefaultThreadPool Waiter(hardware_concurrency(1));
+  std::optional<Expected<std::string>> Result;
+  Waiter.async([&] { Result.emplace(fetch("key")); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  {
+    std::error_code EC;
+    raw_fd_ostream Artifact(path("llvmcache-key"), EC);
+    ASSERT_NO_ERROR(EC);
+    Artifact << "stored by the lock owner";
+  }
+  Locker.reset();
+  Waiter.wait();
+
+  ASSERT_TRUE(Result);
+  ASSERT_THAT_EXPECTED(*Result, HasValue(path("llvmcache-key")));
+  EXPECT_EQ(readFile(**Result), "stored by the lock owner");
+  EXPECT_EQ(NumRequests, 0u);
+}
+
+// Concurrent clients of one cache directory download an artifact once.
+TEST_F(DebuginfodClientServerTest, ConcurrentDownloads) {
+  constexpr unsigned NumClients = 4;
+  std::vector<std::optional<Expected<std::string>>> Results(NumClients);
+  {
+    DefaultThreadPool Clients(hardware_concurrency(NumClients));
+    for (unsigned I = 0; I != NumClients; ++I)
+      Clients.async([&, I] { Results[I].emplace(fetch("key")); });
+    Clients.wait();
+  }
+  for (std::optional<Expected<std::string>> &Result : Results) {
+    ASSERT_TRUE(Result);
+    ASSERT_THAT_EXPECTED(*Result, HasValue(path("llvmcache-key")));
+  }
+  EXPECT_EQ(readFile(path("llvmcache-key")), Body);
+  EXPECT_EQ(NumRequests, 1u);
+}
+
+// The lock and partial files survive pruning of the cache directory.
+TEST_F(DebuginfodClientServerTest, PruneKeepsDownloadFiles) {
+  {
+    std::error_code EC;
+    raw_fd_ostream Partial(path("debuginfod-download-other.partial"), EC);
+    ASSERT_NO_ERROR(EC);
+    Partial << "XXXX";
+  }
+  setenv("DEBUGINFOD_CACHE_POLICY", "prune_interval=0s:cache_size_bytes=1",
+         /*replace=*/1);
+  Expected<std::string> PathOrErr = fetch("key");
+  setenv("DEBUGINFOD_CACHE_POLICY", "", /*replace=*/1);
+  ASSERT_THAT_EXPECTED(PathOrErr, Succeeded());
+  EXPECT_TRUE(sys::fs::exists(path("debuginfod-download-other.partial")));
+}
+#endif
@@ -0,0 +1,127 @@
+//===--- CachingIRCompilerTest.cpp - Test the on-disk object cache --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Testing/Support/Error.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+// A compiler that returns the module identifier as the "object" and counts
+// how often it is called.
+class CountingCompiler : public IRCompileLayer::IRCompiler {
+public:
+  CountingCompiler(unsigned &NumCompiles)
+      : IRCompiler(IRSymbolMapper::ManglingOptions()),
+        NumCompiles(NumCompiles) {}
+
+  Expected<std::unique_ptr<MemoryBuffer>> operator()(Module &M) override {
+    ++NumCompiles;
+    return MemoryBuffer::getMemBufferCopy(M.getModuleIdentifier());
+  }
+
+private:
+  unsigned &NumCompiles;
+};
+
+std::unique_ptr<Module> createModule(LLVMContext &Ctx, StringRef Name,
+                                     int Init) {
+  auto M = std::make_unique<Module>(Name, Ctx);
+  Type *Int32Ty = Type::getInt32Ty(Ctx);
+  new GlobalVariable(*M, Int32Ty, /*isConstant=*/false,
+                     GlobalValue::ExternalLinkage,
+                     ConstantInt::get(Int32Ty, Init), "X");
+  return M;
+}
+
+Expected<std::unique_ptr<CachingIRCompiler>>
+createCompiler(unsigned &NumCompiles, StringRef CacheDir,
+               StringRef CPU = "generic") {
+  JITTargetMachineBuilder JTMB((Triple("x86_64-unknown-linux-gnu")));
+  JTMB.setCPU(CPU.str());
+  return CachingIRCompiler::Create(
+      std::make_unique<CountingCompiler>(NumCompiles), JTMB, CacheDir);
+}
+
+TEST(CachingIRCompilerTest, ReuseAcrossCompilers) {
+  unittest::TempDir CacheDir("orc-object-cache", /*Unique=*/true);
+  LLVMContext Ctx;
+  unsigned NumCompiles = 0;
+
+  {
+    auto C = createCompiler(NumCompiles, CacheDir.path());
+    ASSERT_THAT_EXPECTED(C, Succeeded());
+    auto M = createModule(Ctx, "A", 1);
+    auto Obj = (**C)(*M);
+    ASSERT_THAT_EXPECTED(Obj, Succeeded());
+    EXPECT_EQ((*Obj)->getBuffer(), "A");
+    EXPECT_EQ(NumCompiles, 1u);
+  }
+
+  // A new compiler, as in a later run of the program, finds the object.
+  auto C = createCompiler(NumCompiles, CacheDir.path());
+  ASSERT_THAT_EXPECTED(C, Succeeded());
+  auto Obj = (**C)(*createModule(Ctx, "A", 1));
+  ASSERT_THAT_EXPECTED(Obj, Succeeded());
+  EXPECT_EQ((*Obj)->getBuffer(), "A");
+  EXPECT_EQ(NumCompiles, 1u);
+
+  // Different IR is compiled.
+  Obj = (**C)(*createModule(Ctx, "B", 2));
+  ASSERT_THAT_EXPECTED(Obj, Succeeded());
+  EXPECT_EQ((*Obj)->getBuffer(), "B");
+  EXPECT_EQ(NumCompiles, 2u);
+
+  // So is the same IR for a different CPU.
+  auto OtherCPU = createCompiler(NumCompiles, CacheDir.path(), "znver4");
+  ASSERT_THAT_EXPECTED(OtherCPU, Succeeded());
+  Obj = (**OtherCPU)(*createModule(Ctx, "A", 1));
+  ASSERT_THAT_EXPECTED(Obj, Succeeded());
+  EXPECT_EQ(NumCompiles, 3u);
+}
+
+TEST(CachingIRCompilerTest, Prefetch) {
+  unittest::TempDir CacheDir("orc-object-cache", /*Unique=*/true);
+  LLVMContext Ctx;
+  unsigned NumCompiles = 0;
+
+  {
+    auto C = createCompiler(NumCompiles, CacheDir.path());
+    ASSERT_THAT_EXPECTED(C, Succeeded());
+    ASSERT_THAT_EXPECTED((**C)(*createModule(Ctx, "A", 1)), Succeeded());
+  }
+
+  auto C = createCompiler(NumCompiles, CacheDir.path());
+  ASSERT_THAT_EXPECTED(C, Succeeded());
+  auto A = createModule(Ctx, "A", 1);
+  auto B = createModule(Ctx, "B", 2);
+  (*C)->prefetch(*A);
+  // A miss is fine to prefetch too.
+  (*C)->prefetch(*B);
+
+  auto Obj = (**C)(*A);
+  ASSERT_THAT_EXPECTED(Obj, Succeeded());
+  EXPECT_EQ((*Obj)->getBuffer(), "A");
+  EXPECT_EQ(NumCompiles, 1u);
+
+  Obj = (**C)(*B);
+  ASSERT_THAT_EXPECTED(Obj, Succeeded());
+  EXPECT_EQ((*Obj)->getBuffer(), "B");
+  EXPECT_EQ(NumCompiles, 2u);
+}
+
+} // end anonymous namespace
@@ -1,6 +1,9 @@
 #include "OrcTestCommon.h"
 #include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
 #include "llvm/ExecutionEngine/Orc/LazyReexports.h"
+#include "llvm/ExecutionEngine/Orc/Speculation.h"
+#include "llvm/Testing/Support/Error.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -9,6 +12,7 @@ using namespace llvm::orc;
 class LazyReexportsTest : public CoreAPIsBasedStandardTest {};
 
 static int dummyTarget() { return 42; }
+static int otherDummyTarget() { return 7; }
 
 TEST_F(LazyReexportsTest, BasicLocalCallThroughManagerOperation) {
   // Create a callthrough manager for the host (if possible) and verify that
@@ -70,3 +74,89 @@ TEST_F(LazyReexportsTest, BasicLocalCallThroughManagerOperation) {
       << "CallThrough should have generated exactly one 'NotifyResolved' call";
   EXPECT_EQ(Result, 42) << "Failed to call through to target";
 }
+
+TEST_F(LazyReexportsTest, RecordLazyCallTrace) {
+  // Verify that a LazyCallTraceRecorder sees each call-through target once, in
+  // the order of first call, and that the trace survives a round-trip through
+  // a file.
+
+  auto JTMB = JITTargetMachineBuilder::detectHost();
+  if (!JTMB) {
+    consumeError(JTMB.takeError());
+    GTEST_SKIP();
+  }
+
+  auto LCTM = createLocalLazyCallThroughManager(JTMB->getTargetTriple(), ES,
+                                                ExecutorAddr());
+  if (!LCTM) {
+    consumeError(LCTM.takeError());
+    GTEST_SKIP();
+  }
+
+  LazyCallTraceRecorder Recorder(**LCTM);
+
+  auto DummyTarget = ES.intern("DummyTarget");
+  auto OtherDummyTarget = ES.intern("OtherDummyTarget");
+  cantFail(JD.define(absoluteSymbols(
+      {{DummyTarget,
+        {ExecutorAddr::fromPtr(&dummyTarget), JITSymbolFlags::Exported}},
+       {OtherDummyTarget,
+        {ExecutorAddr::fromPtr(&otherDummyTarget),
+         JITSymbolFlags::Exported}}})));
+
+  auto NotifyResolved = [](ExecutorAddr) { return Error::success(); };
+  auto DummyCTT =
+      cantFail((*LCTM)->getCallThroughTrampoline(JD, DummyTarget,
+                                                 NotifyResolved))
+          .toPtr<int (*)()>();
+  auto OtherDummyCTT =
+      cantFail((*LCTM)->getCallThroughTrampoline(JD, OtherDummyTarget,
+                                                 NotifyResolved))
+          .toPtr<int (*)()>();
+
+  EXPECT_EQ(OtherDummyCTT(), 7);
+  EXPECT_EQ(DummyCTT(), 42);
+  EXPECT_EQ(OtherDummyCTT(), 7);
+
+  LazyCallTrace ExpectedTrace = {{"JD", "OtherDummyTarget"},
+                                 {"JD", "DummyTarget"}};
+  EXPECT_EQ(Recorder.getTrace(), ExpectedTrace);
+
+  unittest::TempFile TraceFile("lazy-call-trace", "txt", "",
+                               /*Unique=*/true);
+  ASSERT_THAT_ERROR(Recorder.writeToFile(TraceFile.path()), Succeeded());
+  auto Trace = readLazyCallTrace(TraceFile.path());
+  ASSERT_THAT_EXPECTED(Trace, Succeeded());
+  EXPECT_EQ(*Trace, ExpectedTrace);
+}
+
+TEST_F(LazyReexportsTest, TraceSpeculatorMaterializesInTraceOrder) {
+  // Verify that a TraceSpeculator materializes the traced symbols in trace
+  // order, and skips entries whose JITDylib or symbol does not exist.
+
+  std::vector<std::string> Materialized;
+  auto DefineTarget = [&](StringRef Name) {
+    auto Sym = ES.intern(Name);
+    cantFail(JD.define(std::make_unique<SimpleMaterializationUnit>(
+        SymbolFlagsMap({{Sym, JITSymbolFlags::Exported}}),
+        [&, Sym](std::unique_ptr<MaterializationResponsibility> R) {
+          Materialized.push_back((*Sym).str());
+          cantFail(R->notifyResolved(
+              {{Sym,
+                {ExecutorAddr::fromPtr(&dummyTarget),
+                 JITSymbolFlags::Exported}}}));
+          cantFail(R->notifyEmitted({}));
+        })));
+  };
+  DefineTarget("A");
+  DefineTarget("B");
+  DefineTarget("C");
+
+  TraceSpeculator Spec(
+      ES, {{"JD", "C"}, {"NoSuchJD", "B"}, {"JD", "A"}, {"JD", "NoSuchSym"}});
+  Spec.start();
+
+  // The test session runs tasks in place, so speculation is done by now.
+  EXPECT_EQ(Spec.getNumSpeculated(), 4U);
+  EXPECT_EQ(Materialized, std::vector<std::string>({"C", "A"}));
+}
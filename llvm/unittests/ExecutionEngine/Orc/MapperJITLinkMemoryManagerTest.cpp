@@ -173,4 +173,51 @@ TEST(MapperJITLinkMemoryManagerTest, Coalescing) {
   EXPECT_THAT_ERROR(std::move(Err4), Succeeded());
 }
 
+TEST(MapperJITLinkMemoryManagerTest, SlabInfos) {
+  auto Mapper = cantFail(InProcessMemoryMapper::Create());
+  uint64_t PageSize = Mapper->getPageSize();
+  auto MemMgr = std::make_unique<MapperJITLinkMemoryManager>(16 * 1024 * 1024,
+                                                             std::move(Mapper));
+  EXPECT_TRUE(MemMgr->getSlabInfos().empty());
+
+  auto SSA1 = jitlink::SimpleSegmentAlloc::Create(
+      *MemMgr, nullptr, {{MemProt::Read, {1024, Align(1)}}});
+  EXPECT_THAT_EXPECTED(SSA1, Succeeded());
+  auto FA1 = SSA1->finalize();
+  EXPECT_THAT_EXPECTED(FA1, Succeeded());
+
+  // Segments with different protections, some of which are protected
+  // together and some of which are left read/write.
+  auto SSA2 = jitlink::SimpleSegmentAlloc::Create(
+      *MemMgr, nullptr,
+      {{MemProt::Read, {1024, Align(1)}},
+       {MemProt::Read | MemProt::Write, {1024, Align(1)}},
+       {MemProt::Read | MemProt::Exec, {1024, Align(1)}}});
+  EXPECT_THAT_EXPECTED(SSA2, Succeeded());
+  auto RWSeg = SSA2->getSegInfo(MemProt::Read | MemProt::Write);
+  auto FA2 = SSA2->finalize();
+  EXPECT_THAT_EXPECTED(FA2, Succeeded());
+
+  // Read/write segments are still writable after finalization.
+  RWSeg.Addr.toPtr<char *>()[0] = 42;
+  EXPECT_EQ(RWSeg.Addr.toPtr<char *>()[0], 42);
+
+  auto Infos = MemMgr->getSlabInfos();
+  ASSERT_EQ(Infos.size(), 1u);
+  EXPECT_EQ(Infos[0].Range.size(), 16u * 1024 * 1024);
+  EXPECT_EQ(Infos[0].NumAllocations, 2u);
+  EXPECT_EQ(Infos[0].UsedBytes, 4 * PageSize);
+
+  auto Err1 = MemMgr->deallocate(std::move(*FA1));
+  EXPECT_THAT_ERROR(std::move(Err1), Succeeded());
+
+  Infos = MemMgr->getSlabInfos();
+  ASSERT_EQ(Infos.size(), 1u);
+  EXPECT_EQ(Infos[0].NumAllocations, 1u);
+  EXPECT_EQ(Infos[0].UsedBytes, 3 * PageSize);
+
+  auto Err2 = MemMgr->deallocate(std::move(*FA2));
+  EXPECT_THAT_ERROR(std::move(Err2), Succeeded());
+}
+
 } // namespace
@@ -9,6 +9,7 @@
 #include "llvm/ExecutionEngine/Orc/TaskDispatch.h"
 #include "gtest/gtest.h"
 
+#include <atomic>
 #include <future>
 
 using namespace llvm;
@@ -32,4 +33,63 @@ TEST(DynamicThreadPoolDispatchTest, GenericNamedTask) {
   EXPECT_TRUE(F.get());
   D->shutdown();
 }
+
+TEST(WorkStealingDispatchTest, GenericNamedTask) {
+  auto D = std::make_unique<WorkStealingTaskDispatcher>(4);
+  std::promise<bool> P;
+  auto F = P.get_future();
+  D->dispatch(makeGenericNamedTask(
+      [P = std::move(P)]() mutable { P.set_value(true); }));
+  EXPECT_TRUE(F.get());
+  D->shutdown();
+}
+
+TEST(WorkStealingDispatchTest, TasksDispatchedByTasks) {
+  // Test that shutdown waits for tasks dispatched by other tasks.
+  auto D = std::make_unique<WorkStealingTaskDispatcher>(4);
+  std::atomic<unsigned> Count{0};
+  for (unsigned I = 0; I != 16; ++I)
+    D->dispatch(makeGenericNamedTask([&]() {
+      for (unsigned J = 0; J != 16; ++J)
+        D->dispatch(makeGenericNamedTask([&]() { ++Count; }));
+    }));
+  D->shutdown();
+  EXPECT_EQ(Count, 256u);
+
+  WorkStealingTaskDispatcher::Metrics M = D->getMetrics();
+  EXPECT_EQ(M.NumDispatched, 272u);
+  EXPECT_EQ(M.QueueDepth, 0u);
+  EXPECT_GE(M.MaxQueueDepth, 1u);
+  EXPECT_GE(M.TotalQueueLatency, M.MaxQueueLatency);
+}
+
+TEST(WorkStealingDispatchTest, Priorities) {
+  // Test that queued tasks run in order of priority.
+  using Priority = WorkStealingTaskDispatcher::Priority;
+  auto D = std::make_unique<WorkStealingTaskDispatcher>(1, [](Task &T) {
+    std::string Desc;
+    raw_string_ostream OS(Desc);
+    T.printDescription(OS);
+    if (Desc == "high")
+      return Priority::High;
+    if (Desc == "low")
+      return Priority::Low;
+    return Priority::Normal;
+  });
+
+  // Keep the only worker busy while the other tasks are queued.
+  std::promise<void> Release;
+  std::shared_future<void> Released = Release.get_future().share();
+  D->dispatch(makeGenericNamedTask([Released]() { Released.wait(); }));
+
+  std::vector<std::string> Order;
+  for (const char *Desc : {"low", "normal", "high"})
+    D->dispatch(
+        makeGenericNamedTask([&Order, Desc]() { Order.push_back(Desc); }, Desc));
+  Release.set_value();
+  D->shutdown();
+
+  EXPECT_EQ(Order, (std::vector<std::string>{"high", "normal", "low"}));
+  EXPECT_GE(D->getMetrics().MaxQueueDepth, 3u);
+}
 #endif
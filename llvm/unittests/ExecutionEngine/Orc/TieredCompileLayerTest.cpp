@@ -0,0 +1,107 @@
+//===--- TieredCompileLayerTest.cpp - Test recompilation of hot code ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "OrcTestCommon.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/TieredCompileLayer.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+// foo reads an internal global, and bar calls foo from the same module, so
+// both the promotion of local symbols and intra-module calls through the
+// stubs are exercised.
+const char *TestIR = R"(
+@base = internal global i32 41
+
+define i32 @foo() {
+entry:
+  %v = load i32, ptr @base
+  %r = add i32 %v, 1
+  ret i32 %r
+}
+
+define i32 @bar() {
+entry:
+  %r = call i32 @foo()
+  ret i32 %r
+}
+)";
+
+TEST(TieredCompileLayerTest, HotFunctionMovesToTier1) {
+  OrcNativeTarget::initialize();
+
+  auto J = LLJITBuilder().create();
+  if (!J) {
+    consumeError(J.takeError());
+    GTEST_SKIP();
+  }
+
+  const Triple &TT = (*J)->getTargetTriple();
+  if (TT.getArch() != Triple::x86_64 && TT.getArch() != Triple::aarch64)
+    GTEST_SKIP();
+
+  // Both tiers use the same compiler here: the test is about the plumbing,
+  // not about the quality of the code.
+  TieredCompileLayer TL((*J)->getExecutionSession(), (*J)->getIRCompileLayer(),
+                        (*J)->getIRCompileLayer(),
+                        createLocalIndirectStubsManagerBuilder(TT),
+                        /*Threshold=*/3);
+
+  std::vector<std::pair<SymbolStringPtr, ExecutorAddr>> TierUps;
+  TL.setNotifyTierUp(
+      [&](JITDylib &JD, SymbolStringPtr Name, ExecutorAddr Addr) {
+        TierUps.push_back({Name, Addr});
+      });
+
+  auto Ctx = std::make_unique<LLVMContext>();
+  SMDiagnostic Err;
+  auto M = parseIR(MemoryBufferRef(TestIR, "test"), Err, *Ctx);
+  ASSERT_TRUE(M) << Err.getMessage();
+  M->setDataLayout((*J)->getDataLayout());
+  ASSERT_THAT_ERROR(TL.add((*J)->getMainJITDylib(),
+                           ThreadSafeModule(std::move(M), std::move(Ctx))),
+                    Succeeded());
+
+  auto FooSym = (*J)->lookup("foo");
+  ASSERT_THAT_EXPECTED(FooSym, Succeeded());
+  auto BarSym = (*J)->lookup("bar");
+  ASSERT_THAT_EXPECTED(BarSym, Succeeded());
+  auto *Foo = FooSym->toPtr<int (*)()>();
+  auto *Bar = BarSym->toPtr<int (*)()>();
+
+  // LLJIT runs tasks in place by default, so the third call to foo recompiles
+  // it before returning.
+  EXPECT_EQ(Foo(), 42);
+  EXPECT_EQ(Bar(), 42);
+  EXPECT_TRUE(TierUps.empty());
+  EXPECT_EQ(Foo(), 42);
+  ASSERT_EQ(TierUps.size(), 1U);
+  EXPECT_EQ(TierUps[0].first, (*J)->mangleAndIntern("foo"));
+
+  auto *ImplJD = (*J)->getExecutionSession().getJITDylibByName("main.tiered");
+  ASSERT_NE(ImplJD, nullptr);
+  auto Tier1Sym = (*J)->lookup(*ImplJD, "foo.tier1");
+  ASSERT_THAT_EXPECTED(Tier1Sym, Succeeded());
+  EXPECT_EQ(*Tier1Sym, TierUps[0].second);
+
+  // Calls through the stub, including the one in bar, now run tier-1 code.
+  EXPECT_EQ(Foo(), 42);
+  EXPECT_EQ(Bar(), 42);
+  EXPECT_EQ(TierUps.size(), 1U);
+}
+
+} // end anonymous namespace
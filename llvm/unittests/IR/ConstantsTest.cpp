@@ -9,6 +9,7 @@
 #include "llvm/IR/Constants.h"
 #include "llvm-c/Core.h"
 #include "llvm/AsmParser/Parser.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/IR/ConstantFold.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/InstrTypes.h"
@@ -17,6 +18,7 @@
 #include "llvm/IR/Module.h"
 #include "llvm/Support/SourceMgr.h"
 #include "gtest/gtest.h"
+#include <thread>
 
 namespace llvm {
 namespace {
@@ -802,5 +804,54 @@ TEST(ConstantsTest, BlockAddressCAPITest) {
   EXPECT_EQ(&BB, OutBB);
 }
 
+TEST(ConstantsTest, ConcurrentUniquingKeepsExistingConstants) {
+  LLVMContext Context;
+  ConstantInt *Zero = ConstantInt::get(Type::getInt32Ty(Context), 0);
+  ConstantInt *One = ConstantInt::get(Type::getInt32Ty(Context), 1);
+  ConstantInt *Big = ConstantInt::get(Type::getInt64Ty(Context), 1234);
+  ConstantFP *Half = ConstantFP::get(Context, APFloat(0.5));
+  IntegerType *I17 = IntegerType::get(Context, 17);
+  PointerType *P3 = PointerType::get(Context, 3);
+
+  EXPECT_FALSE(Context.isConcurrentUniquing());
+  Context.enableConcurrentUniquing();
+  EXPECT_TRUE(Context.isConcurrentUniquing());
+
+  EXPECT_EQ(Zero, ConstantInt::get(Type::getInt32Ty(Context), 0));
+  EXPECT_EQ(One, ConstantInt::get(Type::getInt32Ty(Context), 1));
+  EXPECT_EQ(Big, ConstantInt::get(Type::getInt64Ty(Context), 1234));
+  EXPECT_EQ(Half, ConstantFP::get(Context, APFloat(0.5)));
+  EXPECT_EQ(I17, IntegerType::get(Context, 17));
+  EXPECT_EQ(P3, PointerType::get(Context, 3));
+  EXPECT_NE(ConstantInt::get(Type::getInt32Ty(Context), 0),
+            ConstantInt::get(Type::getInt64Ty(Context), 0));
+}
+
+#if LLVM_ENABLE_THREADS
+TEST(ConstantsTest, ConcurrentUniquingFromThreads) {
+  LLVMContext Context;
+  Context.enableConcurrentUniquing();
+
+  constexpr unsigned NumThreads = 4;
+  constexpr unsigned NumValues = 512;
+  std::vector<std::vector<void *>> Results(NumThreads);
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T)
+    Threads.emplace_back([&, T] {
+      for (unsigned I = 0; I != NumValues; ++I) {
+        Results[T].push_back(
+            ConstantInt::get(IntegerType::get(Context, 16 + I % 100), I));
+        Results[T].push_back(ConstantFP::get(Context, APFloat(double(I))));
+        Results[T].push_back(PointerType::get(Context, I % 8));
+      }
+    });
+  for (std::thread &T : Threads)
+    T.join();
+
+  for (unsigned T = 1; T != NumThreads; ++T)
+    EXPECT_EQ(Results[0], Results[T]);
+}
+#endif
+
 } // end anonymous namespace
 } // end namespace llvm
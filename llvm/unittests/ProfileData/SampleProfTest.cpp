@@ -291,6 +291,20 @@ struct SampleProfTest : ::testing::Test {
         ReadBarSamples->findCallTargetMapAt(1, 0);
     ASSERT_FALSE(CTMap.getError());
 
+    // The name table contains every function with samples, including ones
+    // whose profiles have not been loaded.
+    std::vector<FunctionId> *NameTable = Reader->getNameTable();
+    if (Format != SampleProfileFormat::SPF_Text) {
+      ASSERT_TRUE(NameTable != nullptr);
+      auto HasName = [&](FunctionId Name) {
+        return any_of(*NameTable, [&](FunctionId Entry) {
+          return Entry.getHashCode() == Name.getHashCode();
+        });
+      };
+      ASSERT_TRUE(HasName(FunctionId(BazName)));
+      ASSERT_TRUE(HasName(HooName));
+    }
+
     // Because _Z3bazi is not defined in module M, expect _Z3bazi's profile
     // is not loaded when the profile is ExtBinary format because this format
     // supports loading function profiles on demand.
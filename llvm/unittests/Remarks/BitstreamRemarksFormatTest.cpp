@@ -44,5 +44,6 @@ TEST(BitstreamRemarksFormat, RecordIDs) {
   EXPECT_EQ(remarks::RECORD_REMARK_HOTNESS, 7);
   EXPECT_EQ(remarks::RECORD_REMARK_ARG_WITH_DEBUGLOC, 8);
   EXPECT_EQ(remarks::RECORD_REMARK_ARG_WITHOUT_DEBUGLOC, 9);
-  EXPECT_EQ(remarks::RECORD_LAST, 9);
+  EXPECT_EQ(remarks::RECORD_REMARK_STRTAB, 10);
+  EXPECT_EQ(remarks::RECORD_LAST, 10);
 }
@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm-c/Remarks.h"
+#include "llvm/Remarks/BitstreamRemarkSerializer.h"
 #include "llvm/Remarks/Remark.h"
 #include "llvm/Remarks/RemarkParser.h"
 #include "llvm/Remarks/RemarkSerializer.h"
@@ -341,6 +342,50 @@ TEST(BitstreamRemarks, ParsingBadMagic) {
   parseBad("KRMR", "Unknown magic number: expecting RMRK, got KRMR.");
 }
 
+TEST(BitstreamRemarks, ParsingInlineStrTab) {
+  // A separate remarks file with the strings inlined in the remark blocks can
+  // be parsed on its own, without the metadata.
+  remarks::Remark R1;
+  R1.RemarkType = remarks::Type::Missed;
+  R1.PassName = "inline";
+  R1.RemarkName = "NoDefinition";
+  R1.FunctionName = "foo";
+  R1.Args.emplace_back();
+  R1.Args.back().Key = "Callee";
+  R1.Args.back().Val = "bar";
+
+  // Reuses most of the strings of R1.
+  remarks::Remark R2;
+  R2.RemarkType = remarks::Type::Passed;
+  R2.PassName = "inline";
+  R2.RemarkName = "Inlined";
+  R2.FunctionName = "bar";
+  R2.Hotness = 5;
+  R2.Args.emplace_back();
+  R2.Args.back().Key = "Callee";
+  R2.Args.back().Val = "foo";
+
+  std::string Buf;
+  raw_string_ostream OS(Buf);
+  remarks::BitstreamRemarkSerializer S(OS, remarks::SerializerMode::Separate);
+  S.Helper.InlineStrTab = true;
+  S.emit(R1);
+  S.emit(R2);
+
+  Expected<std::unique_ptr<remarks::RemarkParser>> MaybeParser =
+      remarks::createRemarkParser(remarks::Format::Bitstream, OS.str());
+  ASSERT_FALSE(errorToBool(MaybeParser.takeError()));
+  remarks::RemarkParser &Parser = **MaybeParser;
+  for (const remarks::Remark *Want : {&R1, &R2}) {
+    auto Remark = Parser.next();
+    ASSERT_FALSE(errorToBool(Remark.takeError()));
+    EXPECT_EQ(**Remark, *Want);
+  }
+  Error E = Parser.next().takeError();
+  EXPECT_TRUE(E.isA<remarks::EndOfFileError>());
+  consumeError(std::move(E));
+}
+
 // Testing malformed bitstream is not easy. We would need to replace bytes in
 // the stream to create malformed and unknown records and blocks. There is no
 // textual format for bitstream that can be decoded, modified and encoded
@@ -7,7 +7,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Remarks/Remark.h"
+#include "llvm/Remarks/RemarkSerializer.h"
+#include "llvm/Remarks/RemarkStreamer.h"
 #include "llvm/Remarks/RemarkStringTable.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -121,3 +124,41 @@ TEST(RemarksAPI, StringTableInternalize) {
   EXPECT_EQ(StrTab.add(R.Args.back().Loc->SourceFilePath).second.data(),
             R2.Args.back().Loc->SourceFilePath.data());
 }
+
+TEST(RemarksAPI, StreamerFilters) {
+  std::string Buf;
+  raw_string_ostream OS(Buf);
+  Expected<std::unique_ptr<remarks::RemarkSerializer>> Serializer =
+      remarks::createRemarkSerializer(remarks::Format::YAML,
+                                      remarks::SerializerMode::Separate, OS);
+  ASSERT_TRUE(static_cast<bool>(Serializer));
+  remarks::RemarkStreamer RS(std::move(*Serializer));
+
+  // No filter means everything is streamed.
+  EXPECT_TRUE(RS.isEnabled("licm", remarks::Type::Analysis));
+
+  EXPECT_FALSE(errorToBool(RS.setFilter("^inline$")));
+  EXPECT_TRUE(RS.matchesFilter("inline"));
+  EXPECT_FALSE(RS.matchesFilter("licm"));
+  // The cached result is reused and stays the same.
+  EXPECT_FALSE(RS.matchesFilter("licm"));
+
+  // Changing the filter drops the cached results.
+  EXPECT_FALSE(errorToBool(RS.setFilter("licm")));
+  EXPECT_TRUE(RS.matchesFilter("licm"));
+  EXPECT_FALSE(RS.matchesFilter("inline"));
+
+  EXPECT_FALSE(errorToBool(RS.setTypeFilter("Missed, analysis")));
+  EXPECT_TRUE(RS.matchesTypeFilter(remarks::Type::Missed));
+  EXPECT_TRUE(RS.matchesTypeFilter(remarks::Type::Analysis));
+  EXPECT_FALSE(RS.matchesTypeFilter(remarks::Type::Passed));
+  EXPECT_TRUE(RS.isEnabled("licm", remarks::Type::Missed));
+  EXPECT_FALSE(RS.isEnabled("licm", remarks::Type::Passed));
+  EXPECT_FALSE(RS.isEnabled("inline", remarks::Type::Missed));
+
+  Error E = RS.setTypeFilter("missed,bogus");
+  EXPECT_EQ(toString(std::move(E)), "unknown remark type 'bogus'");
+  // A bad filter leaves the previous one in place.
+  EXPECT_TRUE(RS.matchesTypeFilter(remarks::Type::Missed));
+  EXPECT_FALSE(RS.matchesTypeFilter(remarks::Type::Passed));
+}
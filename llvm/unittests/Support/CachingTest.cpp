@@ -0,0 +1,155 @@
+//===- CachingTest.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/Caching.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Testing/Support/Error.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <mutex>
+
+using namespace llvm;
+using llvm::unittest::TempDir;
+
+namespace {
+
+// An in-memory RemoteCacheStore that counts its requests.
+class FakeStore : public RemoteCacheStore {
+public:
+  FakeStore(StringMap<std::string> &Entries) : Entries(Entries) {}
+
+  Expected<std::unique_ptr<MemoryBuffer>> fetch(StringRef Key) override {
+    ++Fetches;
+    std::lock_guard<std::mutex> Lock(Mu);
+    auto It = Entries.find(Key);
+    if (It == Entries.end())
+      return nullptr;
+    return MemoryBuffer::getMemBufferCopy(It->second, Key);
+  }
+
+  Error upload(StringRef Key, MemoryBufferRef Data) override {
+    std::lock_guard<std::mutex> Lock(Mu);
+    Entries[Key] = Data.getBuffer().str();
+    return Error::success();
+  }
+
+  static std::atomic<unsigned> Fetches;
+
+private:
+  std::mutex Mu;
+  StringMap<std::string> &Entries;
+};
+
+std::atomic<unsigned> FakeStore::Fetches;
+
+struct Added {
+  std::mutex Mu;
+  std::vector<std::string> Buffers;
+
+  AddBufferFn getFn() {
+    return [this](size_t Task, const Twine &ModuleName,
+                  std::unique_ptr<MemoryBuffer> MB) {
+      std::lock_guard<std::mutex> Lock(Mu);
+      Buffers.push_back(MB->getBuffer().str());
+    };
+  }
+};
+
+std::unique_ptr<RemoteFileCache> createCache(StringRef Dir,
+                                             StringMap<std::string> &Entries,
+                                             Added &A) {
+  Expected<std::unique_ptr<RemoteFileCache>> CacheOrErr =
+      RemoteFileCache::create("test", "test", Dir,
+                              std::make_unique<FakeStore>(Entries), A.getFn());
+  EXPECT_THAT_EXPECTED(CacheOrErr, Succeeded());
+  return CacheOrErr ? std::move(*CacheOrErr) : nullptr;
+}
+
+bool localEntryExists(StringRef Dir, StringRef Key) {
+  SmallString<64> Path;
+  sys::path::append(Path, Dir, "llvmcache-" + Key);
+  return sys::fs::exists(Path);
+}
+
+TEST(RemoteFileCacheTest, MissIsUploaded) {
+  TempDir Dir("remote_cache", /*Unique=*/true);
+  StringMap<std::string> Entries;
+  Added A;
+  std::unique_ptr<RemoteFileCache> Cache = createCache(Dir.path(), Entries, A);
+  ASSERT_TRUE(Cache);
+
+  Expected<AddStreamFn> AddStream = Cache->getCache()(0, "key", "module");
+  ASSERT_THAT_EXPECTED(AddStream, Succeeded());
+  ASSERT_TRUE(bool(*AddStream));
+  {
+    Expected<std::unique_ptr<CachedFileStream>> Stream = (*AddStream)(0, "m");
+    ASSERT_THAT_EXPECTED(Stream, Succeeded());
+    *(*Stream)->OS << "contents";
+  }
+  Cache->wait();
+
+  EXPECT_TRUE(localEntryExists(Dir.path(), "key"));
+  ASSERT_EQ(1u, A.Buffers.size());
+  EXPECT_EQ("contents", A.Buffers[0]);
+  EXPECT_EQ("contents", Entries.lookup("key"));
+}
+
+TEST(RemoteFileCacheTest, RemoteHitFillsLocalCache) {
+  TempDir Dir("remote_cache", /*Unique=*/true);
+  StringMap<std::string> Entries;
+  Entries["key"] = "remote";
+  Added A;
+  std::unique_ptr<RemoteFileCache> Cache = createCache(Dir.path(), Entries, A);
+  ASSERT_TRUE(Cache);
+  FileCache C = Cache->getCache();
+
+  FakeStore::Fetches = 0;
+  Expected<AddStreamFn> AddStream = C(0, "key", "module");
+  ASSERT_THAT_EXPECTED(AddStream, Succeeded());
+  EXPECT_FALSE(bool(*AddStream));
+  EXPECT_TRUE(localEntryExists(Dir.path(), "key"));
+
+  // The second lookup is served locally.
+  AddStream = C(1, "key", "module");
+  ASSERT_THAT_EXPECTED(AddStream, Succeeded());
+  EXPECT_FALSE(bool(*AddStream));
+  EXPECT_EQ(1u, FakeStore::Fetches);
+  ASSERT_EQ(2u, A.Buffers.size());
+  EXPECT_EQ("remote", A.Buffers[0]);
+  EXPECT_EQ("remote", A.Buffers[1]);
+}
+
+TEST(RemoteFileCacheTest, Prefetch) {
+  TempDir Dir("remote_cache", /*Unique=*/true);
+  StringMap<std::string> Entries;
+  Entries["a"] = "A";
+  Entries["b"] = "B";
+  Added A;
+  std::unique_ptr<RemoteFileCache> Cache = createCache(Dir.path(), Entries, A);
+  ASSERT_TRUE(Cache);
+
+  FakeStore::Fetches = 0;
+  Cache->prefetch({"a", "b", "missing"});
+  Expected<AddStreamFn> AddStream = Cache->getCache()(0, "a", "module");
+  ASSERT_THAT_EXPECTED(AddStream, Succeeded());
+  EXPECT_FALSE(bool(*AddStream));
+  Cache->wait();
+
+  EXPECT_TRUE(localEntryExists(Dir.path(), "b"));
+  EXPECT_FALSE(localEntryExists(Dir.path(), "missing"));
+  EXPECT_EQ(3u, FakeStore::Fetches);
+  ASSERT_EQ(1u, A.Buffers.size());
+  EXPECT_EQ("A", A.Buffers[0]);
+}
+
+} // namespace
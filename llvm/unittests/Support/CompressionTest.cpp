@@ -110,5 +110,45 @@ TEST(CompressionTest, Zstd) {
   testZstdCompression(BinaryDataStr, zstd::BestSpeedCompression);
   testZstdCompression(BinaryDataStr, zstd::DefaultCompression);
 }
+
+TEST(CompressionTest, ZstdParallel) {
+  const size_t kSize = 1024;
+  char BinaryData[kSize];
+  for (size_t i = 0; i < kSize; ++i)
+    BinaryData[i] = i & 255;
+  ArrayRef<uint8_t> Input = arrayRefFromStringRef(StringRef(BinaryData, kSize));
+
+  // Split the input into several frames.
+  SmallVector<uint8_t, 0> Compressed;
+  SmallVector<uint8_t, 0> Single;
+  zstd::compressParallel(Input, Compressed, zstd::DefaultCompression,
+                         /*EnableLdm=*/false, /*ChunkSize=*/100);
+  zstd::compress(Input, Single);
+  EXPECT_NE(Single, Compressed);
+
+  // Both the serial and the parallel decompressor accept multiple frames.
+  SmallVector<uint8_t, 0> Uncompressed;
+  Error E = zstd::decompress(Compressed, Uncompressed, kSize);
+  EXPECT_FALSE(std::move(E));
+  EXPECT_EQ(Input, ArrayRef<uint8_t>(Uncompressed));
+
+  E = zstd::decompressParallel(Compressed, Uncompressed, kSize);
+  EXPECT_FALSE(std::move(E));
+  EXPECT_EQ(Input, ArrayRef<uint8_t>(Uncompressed));
+
+  E = compression::decompress(DebugCompressionType::Zstd, Compressed,
+                              Uncompressed, kSize);
+  EXPECT_FALSE(std::move(E));
+  EXPECT_EQ(Input, ArrayRef<uint8_t>(Uncompressed));
+
+  // Decompression fails if expected length is too short.
+  E = zstd::decompressParallel(Compressed, Uncompressed, kSize - 1);
+  EXPECT_EQ("Destination buffer is too small", llvm::toString(std::move(E)));
+
+  // Small inputs still produce a single frame.
+  SmallVector<uint8_t, 0> Small;
+  zstd::compressParallel(Input, Small);
+  EXPECT_EQ(Single, Small);
+}
 #endif
 }
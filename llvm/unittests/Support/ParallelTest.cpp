@@ -107,7 +107,7 @@ TEST(Parallel, TaskGroupSequentialFor) {
 TEST(Parallel, NestedTaskGroup) {
   // This test checks:
   // 1. Root TaskGroup is in Parallel mode.
-  // 2. Nested TaskGroup is not in Parallel mode.
+  // 2. Nested TaskGroup is in Parallel mode as well.
   parallel::TaskGroup tg;
 
   tg.spawn([&]() {
@@ -116,15 +116,17 @@ TEST(Parallel, NestedTaskGroup) {
 
   tg.spawn([&]() {
     parallel::TaskGroup nestedTG;
-    EXPECT_FALSE(nestedTG.isParallel());
+    EXPECT_TRUE(nestedTG.isParallel() ||
+                (parallel::strategy.ThreadsRequested == 1));
 
     nestedTG.spawn([&]() {
       // Check that root TaskGroup is in Parallel mode.
       EXPECT_TRUE(tg.isParallel() ||
                   (parallel::strategy.ThreadsRequested == 1));
 
-      // Check that nested TaskGroup is not in Parallel mode.
-      EXPECT_FALSE(nestedTG.isParallel());
+      // Check that nested TaskGroup is in Parallel mode.
+      EXPECT_TRUE(nestedTG.isParallel() ||
+                  (parallel::strategy.ThreadsRequested == 1));
     });
   });
 }
@@ -143,9 +145,10 @@ TEST(Parallel, ParallelNestedTaskGroup) {
         EXPECT_TRUE(tg.isParallel() ||
                     (parallel::strategy.ThreadsRequested == 1));
 
-        // Check that nested TaskGroup is not in Parallel mode.
+        // Check that nested TaskGroup is in Parallel mode.
         parallel::TaskGroup nestedTG;
-        EXPECT_FALSE(nestedTG.isParallel());
+        EXPECT_TRUE(nestedTG.isParallel() ||
+                    (parallel::strategy.ThreadsRequested == 1));
         ++Count;
 
         nestedTG.spawn([&]() {
@@ -153,8 +156,9 @@ TEST(Parallel, ParallelNestedTaskGroup) {
           EXPECT_TRUE(tg.isParallel() ||
                       (parallel::strategy.ThreadsRequested == 1));
 
-          // Check that nested TaskGroup is not in Parallel mode.
-          EXPECT_FALSE(nestedTG.isParallel());
+          // Check that nested TaskGroup is in Parallel mode.
+          EXPECT_TRUE(nestedTG.isParallel() ||
+                      (parallel::strategy.ThreadsRequested == 1));
           ++Count;
         });
       });
@@ -173,6 +177,54 @@ TEST(Parallel, ParallelNestedTaskGroup) {
   }
   EXPECT_EQ(Count, 12ul);
 }
+
+TEST(Parallel, NestedParallelFor) {
+  // Nested parallel loops spawn onto the workers' own deques and must complete
+  // without the waiting tasks blocking the pool.
+  std::atomic<size_t> Count{0};
+  parallelFor(0, 64, [&](size_t) {
+    parallelFor(0, 64, [&](size_t) {
+      parallelFor(0, 16, [&](size_t) { ++Count; });
+    });
+  });
+  EXPECT_EQ(Count, 64ul * 64ul * 16ul);
+}
+
+TEST(Parallel, NestedSequentialTasks) {
+  // Sequential tasks spawned from inside a parallel task still run in order.
+  std::atomic<size_t> Count{0};
+  parallelFor(0, 8, [&](size_t) {
+    size_t Seq = 0;
+    {
+      parallel::TaskGroup tg;
+      for (size_t Idx = 0; Idx < 100; Idx++)
+        tg.spawn([&Seq, Idx]() { EXPECT_EQ(Seq++, Idx); }, true);
+    }
+    EXPECT_EQ(Seq, 100ul);
+    ++Count;
+  });
+  EXPECT_EQ(Count, 8ul);
+}
+
+TEST(Parallel, NestedSyncBehindOtherGroupTask) {
+  // A task of the inner group spawns into the outer group, which queues the
+  // outer task above the remaining inner task on the worker's deque. Waiting
+  // for the inner group must still complete when every worker does the same.
+  std::atomic<size_t> Count{0};
+  {
+    parallel::TaskGroup Outer;
+    for (size_t I = 0; I < 256; ++I)
+      Outer.spawn([&]() {
+        parallel::TaskGroup Inner;
+        Inner.spawn([&]() { ++Count; });
+        Inner.spawn([&]() {
+          Outer.spawn([&]() { ++Count; });
+          ++Count;
+        });
+      });
+  }
+  EXPECT_EQ(Count, 256ul * 3ul);
+}
 #endif
 
 #endif
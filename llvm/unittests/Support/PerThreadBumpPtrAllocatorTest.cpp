@@ -53,4 +53,27 @@ TEST(PerThreadBumpPtrAllocatorTest, ParallelAllocation) {
   EXPECT_EQ(Allocator.getNumberOfAllocators(), parallel::getThreadCount());
 }
 
+TEST(PerThreadBumpPtrAllocatorTest, PerThreadStatistics) {
+  PerThreadBumpPtrAllocator Allocator;
+
+  static size_t constexpr NumAllocations = 1000;
+
+  parallelFor(0, NumAllocations, [&](size_t Idx) {
+    Allocator.Allocate(sizeof(uint64_t), alignof(uint64_t));
+  });
+
+  size_t BytesAllocated = 0;
+  size_t TotalMemory = 0;
+  for (size_t Idx = 0; Idx < Allocator.getNumberOfAllocators(); Idx++) {
+    BytesAllocated += Allocator.getAllocator(Idx).getBytesAllocated();
+    TotalMemory += Allocator.getAllocator(Idx).getTotalMemory();
+  }
+  EXPECT_EQ(Allocator.getBytesAllocated(), BytesAllocated);
+  EXPECT_EQ(Allocator.getTotalMemory(), TotalMemory);
+
+  Allocator.Reset();
+  for (size_t Idx = 0; Idx < Allocator.getNumberOfAllocators(); Idx++)
+    EXPECT_EQ(0u, Allocator.getAllocator(Idx).getBytesAllocated());
+}
+
 } // anonymous namespace
@@ -15,6 +15,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Testing/Support/Error.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -65,6 +69,30 @@ TEST(TimeProfiler, Async_Begin_End_Smoke) {
   ASSERT_TRUE(json.find(R"("detail":"detail")") != std::string::npos);
 }
 
+TEST(TimeProfiler, Streaming_Smoke) {
+  unittest::TempDir Dir("time-trace", /*Unique=*/true);
+  SmallString<128> Path(Dir.path());
+  sys::path::append(Path, "trace.json");
+
+  setupProfiler();
+  // A tiny buffer forces the writer to keep up or drop sections.
+  ASSERT_THAT_ERROR(timeTraceProfilerStartStreaming(Path, 2), Succeeded());
+  EXPECT_TRUE(timeTraceProfilerStreaming());
+
+  { TimeTraceScope scope("event", "detail"); }
+  ASSERT_THAT_ERROR(timeTraceProfilerWrite("", ""), Succeeded());
+  EXPECT_FALSE(timeTraceProfilerStreaming());
+  timeTraceProfilerCleanup();
+
+  auto Buffer = MemoryBuffer::getFile(Path);
+  ASSERT_TRUE(bool(Buffer));
+  StringRef json = (*Buffer)->getBuffer();
+  ASSERT_TRUE(json.contains(R"("name":"event")"));
+  ASSERT_TRUE(json.contains(R"("detail":"detail")"));
+  ASSERT_TRUE(json.contains(R"("name":"Total event")"));
+  ASSERT_TRUE(json.contains("beginningOfTime"));
+}
+
 TEST(TimeProfiler, Begin_End_Disabled) {
   // Nothing should be observable here. The test is really just making sure
   // we've not got a stray nullptr deref.
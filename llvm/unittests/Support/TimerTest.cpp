@@ -7,6 +7,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/Timer.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 #if _WIN32
@@ -61,4 +63,39 @@ TEST(Timer, CheckIfTriggered) {
   EXPECT_FALSE(T1.hasTriggered());
 }
 
+TEST(Timer, PerfCounters) {
+  // The option is registered the first time a time record is taken.
+  TimeRecord::getCurrentTime();
+  auto &TrackPerfCounters = *static_cast<cl::opt<bool> *>(
+      cl::getRegisteredOptions().lookup("track-perf-counters"));
+
+  Timer T1("T1", "T1");
+  T1.startTimer();
+  SleepMS();
+  T1.stopTimer();
+  EXPECT_EQ(T1.getTotalTime().getCycles(), 0u);
+  EXPECT_EQ(T1.getTotalTime().getBranchMisses(), 0u);
+
+  // The counters may be unavailable (non-Linux hosts, no PMU, restrictive
+  // perf_event_paranoid); they then read as zero and their columns are left
+  // out of the report.
+  TrackPerfCounters = true;
+  TimerGroup TG("perf", "Perf counters");
+  Timer T2("T2", "T2", TG);
+  T2.startTimer();
+  volatile uint64_t Sum = 0;
+  for (unsigned I = 0; I != 1000000; ++I)
+    Sum += I;
+  T2.stopTimer();
+  TrackPerfCounters = false;
+  uint64_t Cycles = T2.getTotalTime().getCycles();
+
+  std::string Report;
+  raw_string_ostream OS(Report);
+  TG.print(OS);
+  EXPECT_EQ(Report.find("---Cycles---") != std::string::npos, Cycles != 0);
+  // Don't print the group again on destruction.
+  T2.clear();
+}
+
 } // end anon namespace
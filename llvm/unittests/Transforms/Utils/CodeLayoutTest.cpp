@@ -68,4 +68,32 @@ TEST(CodeLayout, BreakLoop) {
   Order = computeCacheDirectedLayout(Sizes, Counts, Edges, CallOffsets);
   EXPECT_THAT(Order, ElementsAreArray({0, 4, 1, 2, 3, 5}));
 }
+
+TEST(CodeLayout, LargeFunction) {
+  // A function large enough for chain merging to use the priority queue. Each
+  // node N jumps to N + 1 and, less frequently, to N + 2 so that no pairs are
+  // forced. The hot fall-through path should be kept intact.
+  const size_t NumNodes = 5000;
+  std::vector<uint64_t> Sizes(NumNodes, 10);
+  std::vector<uint64_t> Counts(NumNodes, 100);
+  std::vector<EdgeCount> Edges;
+  for (size_t I = 0; I + 1 < NumNodes; ++I) {
+    Edges.push_back({I, I + 1, 90});
+    if (I + 2 < NumNodes)
+      Edges.push_back({I, I + 2, 10});
+  }
+  auto Order = computeExtTspLayout(Sizes, Counts, Edges);
+  ASSERT_EQ(Order.size(), NumNodes);
+  EXPECT_EQ(Order[0], 0u);
+  std::vector<bool> Seen(NumNodes, false);
+  size_t NumFallthroughs = 0;
+  for (size_t I = 0; I < NumNodes; ++I) {
+    ASSERT_LT(Order[I], NumNodes);
+    EXPECT_FALSE(Seen[Order[I]]);
+    Seen[Order[I]] = true;
+    if (I > 0 && Order[I] == Order[I - 1] + 1)
+      ++NumFallthroughs;
+  }
+  EXPECT_GT(NumFallthroughs, NumNodes * 9 / 10);
+}
 } // namespace
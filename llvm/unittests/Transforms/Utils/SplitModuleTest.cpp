@@ -0,0 +1,111 @@
+//===- SplitModuleTest.cpp - SplitModule unit tests -----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/Utils/SplitModule.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+// The callers and callees below are connected by calls that are hot (@hot1,
+// @hot2) or cold (@cold1, @cold2). With profile guidance, the hot pair must
+// end up in the same partition.
+const char *IRString = R"IR(
+  define void @hot2() !prof !14 {
+    ret void
+  }
+
+  define void @hot1() !prof !14 {
+    call void @hot2()
+    ret void
+  }
+
+  define void @cold2() !prof !15 {
+    ret void
+  }
+
+  define void @cold1() !prof !15 {
+    call void @cold2()
+    ret void
+  }
+
+  define void @other1() !prof !15 {
+    ret void
+  }
+
+  define void @other2() !prof !15 {
+    ret void
+  }
+
+  !llvm.module.flags = !{!0}
+
+  !0 = !{i32 1, !"ProfileSummary", !1}
+  !1 = !{!2, !3, !4, !5, !6, !7, !8, !9}
+  !2 = !{!"ProfileFormat", !"InstrProf"}
+  !3 = !{!"TotalCount", i64 10000}
+  !4 = !{!"MaxCount", i64 1000}
+  !5 = !{!"MaxInternalCount", i64 1}
+  !6 = !{!"MaxFunctionCount", i64 1000}
+  !7 = !{!"NumCounts", i64 6}
+  !8 = !{!"NumFunctions", i64 6}
+  !9 = !{!"DetailedSummary", !10}
+  !10 = !{!11, !12, !13}
+  !11 = !{i32 10000, i64 1000, i32 1}
+  !12 = !{i32 999000, i64 300, i32 3}
+  !13 = !{i32 999999, i64 5, i32 10}
+  !14 = !{!"function_entry_count", i64 1000}
+  !15 = !{!"function_entry_count", i64 1}
+)IR";
+
+TEST(SplitModuleTest, ProfileGuidedKeepsHotCallsTogether) {
+  auto &Opts = cl::getRegisteredOptions();
+  auto *ProfileGuided =
+      static_cast<cl::opt<bool> *>(Opts["split-module-profile-guided"]);
+  ASSERT_NE(ProfileGuided, nullptr);
+  ProfileGuided->setValue(true);
+
+  LLVMContext C;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(IRString, Err, C);
+  ASSERT_TRUE(M);
+
+  std::vector<std::unique_ptr<Module>> Parts;
+  SplitModule(*M, 2, [&](std::unique_ptr<Module> MPart) {
+    Parts.push_back(std::move(MPart));
+  });
+  ProfileGuided->setValue(false);
+  ASSERT_EQ(Parts.size(), 2u);
+
+  auto getPartition = [&](StringRef Name) {
+    for (unsigned I = 0; I < Parts.size(); ++I)
+      if (Function *F = Parts[I]->getFunction(Name))
+        if (!F->isDeclaration())
+          return int(I);
+    return -1;
+  };
+  EXPECT_NE(getPartition("hot1"), -1);
+  EXPECT_EQ(getPartition("hot1"), getPartition("hot2"));
+
+  // Every function is defined in exactly one partition, and the partitions
+  // are balanced.
+  unsigned Defined[2] = {0, 0};
+  for (unsigned I = 0; I < 2; ++I)
+    for (Function &F : *Parts[I])
+      if (!F.isDeclaration())
+        ++Defined[I];
+  EXPECT_EQ(Defined[0] + Defined[1], 6u);
+  EXPECT_EQ(Defined[0], Defined[1]);
+}
+
+} // end anonymous namespace
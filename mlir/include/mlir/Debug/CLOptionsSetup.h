@@ -54,6 +54,15 @@ public:
   /// Get the filename to use for profiling actions.
   StringRef getProfileActionsTo() const { return profileActionsToFlag; }
 
+  /// Enable collecting per-pattern statistics, printed to stderr when the
+  /// debug handler is uninstalled.
+  DebugConfig &enablePatternProfiling(bool enabled = true) {
+    profilePatternsFlag = enabled;
+    return *this;
+  }
+  /// Return true if per-pattern statistics are collected.
+  bool isPatternProfilingEnabled() const { return profilePatternsFlag; }
+
   /// Set a location breakpoint manager to filter out action logging based on
   /// the attached IR location in the Action context. Ownership stays with the
   /// caller.
@@ -77,6 +86,9 @@ protected:
   /// Profile action execution to the given file (or "-" for stdout)
   std::string profileActionsToFlag;
 
+  /// Collect per-pattern statistics.
+  bool profilePatternsFlag = false;
+
   /// Location Breakpoints to filter the action logging.
   std::vector<tracing::BreakpointManager *> logActionLocationFilter;
 };
@@ -0,0 +1,59 @@
+//===- PatternProfiler.h - Profiling Rewrite Patterns -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_TRACING_OBSERVERS_PATTERNPROFILER_H
+#define MLIR_TRACING_OBSERVERS_PATTERNPROFILER_H
+
+#include "mlir/Debug/ExecutionContext.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <mutex>
+
+namespace mlir {
+namespace tracing {
+
+/// This class defines an observer that accumulates, for each rewrite pattern,
+/// the number of times it was attempted and applied, and the time spent in
+/// failed and successful attempts. Failed attempts only pay for the match,
+/// successful ones for the match and the rewrite. The time of a pattern
+/// excludes the pattern applications nested in it, which are accounted to
+/// their own patterns.
+struct PatternProfiler : public ExecutionContext::Observer {
+  /// The statistics collected for one pattern.
+  struct PatternStatistics {
+    uint64_t numAttempts = 0;
+    uint64_t numApplied = 0;
+    std::chrono::nanoseconds failedTime{0};
+    std::chrono::nanoseconds appliedTime{0};
+  };
+
+  void beforeExecute(const ActionActiveStack *action, Breakpoint *breakpoint,
+                     bool willExecute) override;
+  void afterExecute(const ActionActiveStack *action) override;
+
+  /// Print the statistics of all the patterns, sorted by decreasing total
+  /// time, in the same style as the `-mlir-timing` report.
+  void print(raw_ostream &os);
+
+  /// Return the statistics collected for the pattern with the given debug
+  /// name, if it was attempted.
+  const PatternStatistics *lookup(StringRef patternName);
+
+private:
+  llvm::StringMap<PatternStatistics> statistics;
+
+  /// A mutex used to guard the statistics.
+  std::mutex mutex;
+};
+
+} // namespace tracing
+} // namespace mlir
+
+#endif // MLIR_TRACING_OBSERVERS_PATTERNPROFILER_H
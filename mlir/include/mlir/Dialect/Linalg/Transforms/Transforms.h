@@ -1162,6 +1162,55 @@ packMatmulGreedily(RewriterBase &rewriter, LinalgOp linalgOp,
                    ArrayRef<int64_t> mnkPaddedSizesNextMultipleOf,
                    ArrayRef<int64_t> mnkOrder);
 
+/// Cache and vector register parameters of a target, used to derive a default
+/// tiling and packing strategy for contractions.
+struct ContractionTargetInfo {
+  int64_t l1CacheSizeInBytes = 32 * 1024;
+  int64_t l2CacheSizeInBytes = 1024 * 1024;
+  int64_t l3CacheSizeInBytes = 8 * 1024 * 1024;
+  int64_t vectorSizeInBits = 256;
+  int64_t numVectorRegisters = 16;
+
+  /// Returns the parameters specified by the data layout specs of the ops
+  /// enclosing `op`, the closest spec taking precedence. The parameters are
+  /// read from integer entries with the keys "dlti.l1_cache_size_in_bytes",
+  /// "dlti.l2_cache_size_in_bytes", "dlti.l3_cache_size_in_bytes",
+  /// "dlti.vector_size_in_bits" and "dlti.num_vector_registers". Parameters
+  /// without an entry keep their default value.
+  static ContractionTargetInfo get(Operation *op);
+};
+
+/// Tiling and packing strategy for a contraction, in the style of the
+/// analytical model used by BLIS. Sizes are given for the (m, n, k) dimensions
+/// that `packMatmulGreedily` infers.
+struct ContractionStrategy {
+  /// Sizes of the register-level micro-kernel. `mnkPackedSizes[0]` by
+  /// `mnkPackedSizes[1]` accumulators fit into the vector registers, and
+  /// `mnkPackedSizes[2]` is the depth of a micro-panel whose RHS part stays in
+  /// L1. These are the inner tile sizes of the packed layouts.
+  SmallVector<int64_t, 3> mnkPackedSizes;
+  /// Sizes of the cache-level blocks: an m by k block of the LHS fits in L2,
+  /// and a k by n block of the RHS fits in L3. Multiples of `mnkPackedSizes`.
+  SmallVector<int64_t, 3> mnkCacheTileSizes;
+};
+
+/// Computes a contraction strategy for `linalgOp` on the target described by
+/// `target`. The sizes are derived from the element type of the result and
+/// are clamped to the static loop ranges. Fails if `linalgOp` is not a
+/// contraction with an integer or float result.
+FailureOr<ContractionStrategy>
+computeContractionStrategy(LinalgOp linalgOp,
+                           const ContractionTargetInfo &target);
+
+/// Packs `linalgOp` with `packMatmulGreedily` using the micro-kernel sizes of
+/// the strategy computed for the target parameters of the enclosing data
+/// layout specs. The inner dimensions of the resulting op form a static
+/// micro-kernel that can be vectorized after tiling the outer dimensions by
+/// `mnkCacheTileSizes`, which is returned in `strategy` when provided.
+FailureOr<PackResult>
+packContractionForTarget(RewriterBase &rewriter, LinalgOp linalgOp,
+                         ContractionStrategy *strategy = nullptr);
+
 /// Rewrite tensor.from_elements to linalg.generic.
 FailureOr<Operation *>
 rewriteInDestinationPassingStyle(RewriterBase &rewriter,
@@ -1539,6 +1588,50 @@ void populateSparseTensorRewriting(RewritePatternSet &patterns);
 /// as const to allow callers to use non-const methods.
 using ControlFusionFn = std::function<bool(OpOperand *fusedOperand)>;
 
+/// Parameters of the cost model that decides whether fusing two elementwise
+/// `linalg.generic` operations is profitable.
+struct ElementwiseFusionCostModelOptions {
+  /// Number of scalar operations the target can execute in the time of one
+  /// memory access, i.e. the arithmetic intensity at which the target becomes
+  /// compute bound. Fusion avoids materializing the fused operand; it is
+  /// profitable as long as the operations recomputed because of the fusion do
+  /// not exceed this many operations per memory access saved.
+  int64_t opsPerMemoryAccess = 8;
+  /// Cost of an operation that is not a plain arithmetic operation, e.g. a
+  /// division or a math library function, relative to an addition.
+  int64_t expensiveOpCost = 8;
+  /// Maximum number of values that may be live at once in the fused body.
+  /// Every value of the vectorized body occupies one vector register.
+  int64_t maxLiveValues = 16;
+};
+
+/// Estimates of the effects of fusing the producer of `fusedOperand` into its
+/// consumer.
+struct ElementwiseFusionCost {
+  /// Cost of computing one element of the producer.
+  int64_t producerCost = 0;
+  /// Number of times every producer element is computed in the fused op, or
+  /// std::nullopt if it depends on dynamic sizes.
+  std::optional<int64_t> recomputationFactor;
+  /// Number of memory accesses saved per producer element.
+  int64_t savedMemoryAccesses = 0;
+  /// Maximum number of values live at once in the fused body.
+  int64_t maxLiveValues = 0;
+};
+
+/// Computes the cost estimates of fusing the producer of `fusedOperand`
+/// into its consumer. Expects `areElementwiseOpsFusable(fusedOperand)`.
+ElementwiseFusionCost
+estimateElementwiseFusionCost(OpOperand *fusedOperand,
+                              const ElementwiseFusionCostModelOptions &options);
+
+/// Returns a control function that only allows elementwise fusion when the
+/// cost model considers it profitable: the recomputed producer operations must
+/// be paid for by the memory accesses saved, and the fused body must fit in
+/// `options.maxLiveValues` registers.
+ControlFusionFn getElementwiseFusionCostModelControlFn(
+    const ElementwiseFusionCostModelOptions &options = {});
+
 /// Patterns for fusing linalg operation on tensors.
 
 /// Pattern to fuse `linalg.generic` -> `linalg.generic` operations
@@ -16,7 +16,9 @@
 #include <algorithm>
 #include <cassert>
 #include <cinttypes>
+#include <cstdlib>
 #include <functional>
+#include <thread>
 #include <vector>
 
 namespace mlir {
@@ -58,6 +60,50 @@ struct ElementLT final {
   const uint64_t rank;
 };
 
+namespace detail {
+
+/// COO tensors with fewer elements than this are always sorted serially.
+constexpr uint64_t kParallelSortThreshold = 1 << 16;
+
+/// Returns the number of threads used to sort large COO tensors. This is
+/// the value of the `SPARSE_TENSOR_NUM_THREADS` environment variable if
+/// it is set, and the number of hardware threads otherwise.
+inline unsigned getNumSortThreads() {
+  static const unsigned numThreads = [] {
+    if (const char *env = std::getenv("SPARSE_TENSOR_NUM_THREADS"))
+      return static_cast<unsigned>(std::max(std::atoi(env), 1));
+    return std::max(std::thread::hardware_concurrency(), 1u);
+  }();
+  return numThreads;
+}
+
+/// Invokes `fn(t, lo, hi)` for `numThreads` contiguous chunks `[lo, hi)` of
+/// `[0, n)` on separate threads, and waits for all of them to complete.
+template <typename Fn>
+void parallelChunks(unsigned numThreads, uint64_t n, Fn &&fn) {
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads - 1);
+  const uint64_t chunk = (n + numThreads - 1) / numThreads;
+  for (unsigned t = 1; t < numThreads; ++t)
+    threads.emplace_back([&fn, t, chunk, n] {
+      fn(t, std::min(t * chunk, n), std::min((t + 1) * chunk, n));
+    });
+  fn(0u, uint64_t(0), std::min(chunk, n));
+  for (std::thread &thread : threads)
+    thread.join();
+}
+
+/// Returns the number of bits needed to represent coordinates `[0, size)`.
+/// An empty range needs none.
+inline unsigned getCoordBitWidth(uint64_t size) {
+  unsigned width = 0;
+  for (uint64_t maxCrd = size ? size - 1 : 0; maxCrd; maxCrd >>= 1)
+    ++width;
+  return width;
+}
+
+} // namespace detail
+
 /// A memory-resident sparse tensor in coordinate-scheme representation
 /// (a collection of `Element`s). This data structure is used as an
 /// intermediate representation, e.g., for reading sparse tensors from
@@ -130,14 +176,100 @@ public:
   /// Sorts elements lexicographically by coordinates. If a coordinate
   /// is mapped to multiple values, then the relative order of those
   /// values is unspecified.
-  void sort() {
+  void sort() { sort(detail::getNumSortThreads()); }
+
+  /// Sorts elements like `sort()`, using `numThreads` threads if the tensor
+  /// is large enough.
+  void sort(unsigned numThreads) {
     if (isSorted)
       return;
-    std::sort(elements.begin(), elements.end(), getElementLT());
+    if (numThreads == 1 || elements.size() < detail::kParallelSortThreshold ||
+        !radixSort(numThreads))
+      std::sort(elements.begin(), elements.end(), getElementLT());
     isSorted = true;
   }
 
 private:
+  /// Sorts the elements with a parallel LSD radix sort on a key that
+  /// concatenates all coordinates, which orders the elements exactly like
+  /// `ElementLT`. Returns false, without changing the elements, if the
+  /// coordinates do not fit into a 64-bit key.
+  bool radixSort(unsigned numThreads) {
+    const uint64_t rank = getRank();
+    std::vector<unsigned> shifts(rank);
+    unsigned keyBits = 0;
+    for (uint64_t d = rank; d-- > 0;) {
+      shifts[d] = keyBits;
+      keyBits += detail::getCoordBitWidth(dimSizes[d]);
+    }
+    if (keyBits > 64)
+      return false;
+
+    // Sort (key, element index) pairs, and permute the elements afterwards.
+    struct KeyIndex {
+      uint64_t key;
+      uint64_t index;
+    };
+    const uint64_t n = elements.size();
+    std::vector<KeyIndex> keys(n), scratch(n);
+    detail::parallelChunks(numThreads, n, [&](unsigned, uint64_t lo,
+                                              uint64_t hi) {
+      for (uint64_t i = lo; i < hi; ++i) {
+        uint64_t key = 0;
+        for (uint64_t d = 0; d < rank; ++d)
+          key |= elements[i].coords[d] << shifts[d];
+        keys[i] = {key, i};
+      }
+    });
+
+    // Every pass distributes the pairs stably by one digit of the key. Each
+    // thread counts the digits in its chunk, and then scatters its chunk
+    // starting at the offsets computed from the counts of all threads.
+    constexpr unsigned kDigitBits = 8;
+    constexpr unsigned kNumBuckets = 1 << kDigitBits;
+    std::vector<uint64_t> offsets(numThreads * kNumBuckets);
+    for (unsigned shift = 0; shift < keyBits; shift += kDigitBits) {
+      std::fill(offsets.begin(), offsets.end(), 0);
+      detail::parallelChunks(
+          numThreads, n, [&](unsigned t, uint64_t lo, uint64_t hi) {
+            uint64_t *counts = &offsets[t * kNumBuckets];
+            for (uint64_t i = lo; i < hi; ++i)
+              ++counts[(keys[i].key >> shift) & (kNumBuckets - 1)];
+          });
+      // Skip the pass if all keys have the same digit.
+      bool isUniform = false;
+      uint64_t offset = 0;
+      for (unsigned b = 0; b < kNumBuckets; ++b) {
+        const uint64_t bucketStart = offset;
+        for (unsigned t = 0; t < numThreads; ++t) {
+          const uint64_t count = offsets[t * kNumBuckets + b];
+          offsets[t * kNumBuckets + b] = offset;
+          offset += count;
+        }
+        isUniform |= offset - bucketStart == n;
+      }
+      if (isUniform)
+        continue;
+      detail::parallelChunks(
+          numThreads, n, [&](unsigned t, uint64_t lo, uint64_t hi) {
+            uint64_t *next = &offsets[t * kNumBuckets];
+            for (uint64_t i = lo; i < hi; ++i)
+              scratch[next[(keys[i].key >> shift) & (kNumBuckets - 1)]++] =
+                  keys[i];
+          });
+      keys.swap(scratch);
+    }
+
+    std::vector<Element<V>> sorted(elements);
+    detail::parallelChunks(numThreads, n,
+                           [&](unsigned, uint64_t lo, uint64_t hi) {
+                             for (uint64_t i = lo; i < hi; ++i)
+                               sorted[i] = elements[keys[i].index];
+                           });
+    elements.swap(sorted);
+    return true;
+  }
+
   const std::vector<uint64_t> dimSizes; // per-dimension sizes
   std::vector<Element<V>> elements;     // all COO elements
   std::vector<uint64_t> coordinates;    // shared coordinate pool
@@ -157,6 +157,13 @@ public:
     return MutableArrayRef<char>(const_cast<char *>(data.data()), data.size());
   }
 
+  /// Return a mutable reference to the raw underlying data of this blob. If
+  /// the blob is not mutable, e.g. because it directly references a memory
+  /// mapped bytecode file, the data is first copied into a new heap allocation
+  /// with the same alignment, and the reference to the original data is
+  /// released.
+  MutableArrayRef<char> getMutableDataCopyOnWrite();
+
   /// Return if the data of this blob is mutable.
   bool isMutable() const { return dataIsMutable; }
 
@@ -208,6 +215,15 @@ public:
         alignof(T), dataIsMutable);
   }
 };
+
+inline MutableArrayRef<char> AsmResourceBlob::getMutableDataCopyOnWrite() {
+  if (!isMutable()) {
+    *this = HeapAsmResourceBlob::allocateAndCopyWithAlign(
+        data, std::max<size_t>(dataAlignment, 1));
+  }
+  return getMutableData();
+}
+
 /// This class provides a simple utility wrapper for creating "unmanaged"
 /// AsmResourceBlobs. The lifetime of the data provided to these blobs is
 /// guaranteed to persist beyond the lifetime of this reference.
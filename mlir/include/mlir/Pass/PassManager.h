@@ -418,6 +418,22 @@ public:
   /// unintentionally included in the timing results.
   void enableTiming();
 
+  //===--------------------------------------------------------------------===//
+  // Pass Memory Profiling
+
+  /// Add an instrumentation that records, for every pass, the change in the
+  /// number of operations and in the approximate number of bytes of the IR the
+  /// pass runs on, as well as the number of attribute and type storage
+  /// instances (and their bytes) newly allocated in the context. The results
+  /// are accumulated in a tree that mirrors the pass pipeline, and printed to
+  /// `os` when the pass manager is destroyed.
+  ///
+  /// Note: The attribute and type storage is tracked per context, so when
+  /// passes run concurrently, storage allocated by one pass is also attributed
+  /// to the other passes running at the same time. Disable multi-threading
+  /// for an exact attribution.
+  void enableMemoryProfiling(raw_ostream &os = llvm::errs());
+
   //===--------------------------------------------------------------------===//
   // Pass Statistics
 
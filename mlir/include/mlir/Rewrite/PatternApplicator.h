@@ -30,8 +30,9 @@ class PDLByteCodeMutableState;
 class ApplyPatternAction : public tracing::ActionImpl<ApplyPatternAction> {
 public:
   using Base = tracing::ActionImpl<ApplyPatternAction>;
-  ApplyPatternAction(ArrayRef<IRUnit> irUnits, const Pattern &pattern)
-      : Base(irUnits), pattern(pattern) {}
+  ApplyPatternAction(ArrayRef<IRUnit> irUnits, const Pattern &pattern,
+                     const bool *applied = nullptr)
+      : Base(irUnits), pattern(pattern), applied(applied) {}
   static constexpr StringLiteral tag = "apply-pattern";
   static constexpr StringLiteral desc =
       "Encapsulate the application of rewrite patterns";
@@ -40,8 +41,18 @@ public:
     os << "`" << tag << " pattern: " << pattern.getDebugName();
   }
 
+  /// Return the pattern being applied.
+  const Pattern &getPattern() const { return pattern; }
+
+  /// Return true if the pattern matched and rewrote the IR. This is only
+  /// meaningful once the action has executed.
+  bool wasApplied() const { return applied && *applied; }
+
 private:
   const Pattern &pattern;
+
+  /// Set by the application of the pattern when it succeeds.
+  const bool *applied;
 };
 
 /// This class manages the application of a group of rewrite patterns, with a
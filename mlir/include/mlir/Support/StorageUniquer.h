@@ -132,6 +132,9 @@ public:
       return allocator.identifyObject(ptr).has_value();
     }
 
+    /// Returns the number of bytes allocated by this allocator.
+    size_t getBytesAllocated() const { return allocator.getBytesAllocated(); }
+
   private:
     /// The raw allocator for type storage objects.
     llvm::BumpPtrAllocator allocator;
@@ -247,6 +250,15 @@ public:
   /// is initialized when a dialect is loaded.
   bool isParametricStorageInitialized(TypeID id);
 
+  /// Returns the number of parametric storage instances that have been created
+  /// by this uniquer.
+  uint64_t getNumParametricInstances() const;
+
+  /// Returns the number of bytes allocated for parametric storage instances by
+  /// this uniquer, including the data allocated by their construction and
+  /// mutation functions.
+  uint64_t getNumParametricBytesAllocated() const;
+
   /// Changes the mutable component of 'storage' by forwarding the trailing
   /// arguments to the 'mutate' function of the derived class.
   template <typename Storage, typename... Args>
@@ -1118,6 +1118,21 @@ struct ConversionConfig {
   // already been modified) and iterators into past IR state cannot be
   // represented at the moment.
   RewriterBase::Listener *listener = nullptr;
+
+  /// If set to "false", the conversion driver runs in "one-shot" mode: it
+  /// assumes that patterns never fail after they started modifying the IR, so
+  /// it does not snapshot ops that are modified in place and it commits
+  /// rewrites that need no further bookkeeping (op/block creations and
+  /// motions, in-place modifications) after each converted op instead of at
+  /// the end of the conversion. Unresolved materializations are still only
+  /// resolved at the end of the conversion.
+  ///
+  /// This is considerably cheaper for large inputs, but a pattern that
+  /// modifies the IR and then returns failure (or whose generated ops cannot
+  /// be legalized) is a fatal error, and so is cancelOpModification. If the conversion fails, the IR is left
+  /// in a partially converted state. Analysis conversions always require
+  /// rollback.
+  bool allowPatternRollback = true;
 };
 
 //===----------------------------------------------------------------------===//
@@ -14,6 +14,7 @@
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/OpImplementation.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/IR/Verifier.h"
 #include "mlir/IR/Visitors.h"
 #include "mlir/Support/LLVM.h"
@@ -608,9 +609,11 @@ public:
       ArrayRef<char> charData(reinterpret_cast<const char *>(data.data()),
                               data.size());
 
-      // Allocate an unmanager buffer which captures a reference to the owner.
-      // For now we just mark this as immutable, but in the future we should
-      // explore marking this as mutable when desired.
+      // Allocate an unmanaged buffer which captures a reference to the owner,
+      // keeping the (possibly memory mapped) buffer alive for as long as the
+      // blob references it. The blob is marked immutable, so users that need
+      // to modify the data go through `getMutableDataCopyOnWrite`, which
+      // copies the data out of the buffer on the first write.
       return UnmanagedAsmResourceBlob::allocateWithAlign(
           charData, alignment,
           [bufferOwnerRef = bufferOwnerRef](void *, size_t, size_t) {});
@@ -823,6 +826,17 @@ public:
   }
   Type resolveType(size_t index) { return resolveEntry(types, index, "Type"); }
 
+  /// Resolve all of the attributes and types.
+  LogicalResult resolveAll() {
+    for (size_t i = 0, e = attributes.size(); i != e; ++i)
+      if (!resolveAttribute(i))
+        return failure();
+    for (size_t i = 0, e = types.size(); i != e; ++i)
+      if (!resolveType(i))
+        return failure();
+    return success();
+  }
+
   /// Parse a reference to an attribute or type using the given reader.
   LogicalResult parseAttribute(EncodingReader &reader, Attribute &result) {
     uint64_t attrIdx;
@@ -1310,6 +1324,7 @@ LogicalResult AttrTypeReader::parseCustomEntry(Entry<T> &entry,
 /// This class is used to read a bytecode buffer and translate it into MLIR.
 class mlir::BytecodeReader::Impl {
   struct RegionReadState;
+  struct IRReadState;
   using LazyLoadableOpsInfo =
       std::list<std::pair<Operation *, RegionReadState>>;
   using LazyLoadableOpsMap =
@@ -1385,7 +1400,7 @@ private:
   LogicalResult materialize(LazyLoadableOpsMap::iterator it) {
     assert(it != lazyLoadableOpsMap.end() &&
            "materialize called on non-materializable op");
-    valueScopes.emplace_back();
+    mainReadState.valueScopes.emplace_back();
     std::vector<RegionReadState> regionStack;
     regionStack.push_back(std::move(it->getSecond()->second));
     lazyLoadableOps.erase(it->getSecond());
@@ -1414,6 +1429,11 @@ private:
   FailureOr<OperationName> parseOpName(EncodingReader &reader,
                                        std::optional<bool> &wasRegistered);
 
+  /// Load the dialect of the given operation name and build the name, if this
+  /// wasn't done yet. `reader` is used for error emission.
+  LogicalResult resolveOpName(EncodingReader &reader,
+                              BytecodeOperationName &opName);
+
   //===--------------------------------------------------------------------===//
   // Attribute/Type Section
 
@@ -1441,12 +1461,13 @@ private:
   /// struct is used to enable iterative parsing of regions.
   struct RegionReadState {
     RegionReadState(Operation *op, EncodingReader *reader,
-                    bool isIsolatedFromAbove)
-        : RegionReadState(op->getRegions(), reader, isIsolatedFromAbove) {}
+                    bool isIsolatedFromAbove, IRReadState *irState)
+        : RegionReadState(op->getRegions(), reader, isIsolatedFromAbove,
+                          irState) {}
     RegionReadState(MutableArrayRef<Region> regions, EncodingReader *reader,
-                    bool isIsolatedFromAbove)
+                    bool isIsolatedFromAbove, IRReadState *irState)
         : curRegion(regions.begin()), endRegion(regions.end()), reader(reader),
-          isIsolatedFromAbove(isIsolatedFromAbove) {}
+          irState(irState), isIsolatedFromAbove(isIsolatedFromAbove) {}
 
     /// The current regions being read.
     MutableArrayRef<Region>::iterator curRegion, endRegion;
@@ -1457,6 +1478,10 @@ private:
     EncodingReader *reader;
     std::unique_ptr<EncodingReader> owningReader;
 
+    /// The value scopes and forward references used for this region. Regions
+    /// read in parallel each have their own state.
+    IRReadState *irState;
+
     /// The number of values defined immediately within this region.
     unsigned numValues = 0;
 
@@ -1472,7 +1497,21 @@ private:
     bool isIsolatedFromAbove = false;
   };
 
+  /// An isolated region that is parsed after the enclosing IR.
+  using DeferredRegion = std::pair<Operation *, RegionReadState>;
+
   LogicalResult parseIRSection(ArrayRef<uint8_t> sectionData, Block *block);
+
+  /// Parse the given isolated regions, which were skipped while parsing the
+  /// enclosing IR, in parallel.
+  LogicalResult
+  parseIsolatedRegionsInParallel(EncodingReader &reader,
+                                 MutableArrayRef<DeferredRegion> regions);
+
+  /// Resolve every attribute, type, and operation name of the bytecode, which
+  /// are otherwise resolved on first use. Afterwards, the tables shared by
+  /// all regions are only read, and regions can be parsed concurrently.
+  LogicalResult resolveAllEntries(EncodingReader &reader);
   LogicalResult parseRegions(std::vector<RegionReadState> &regionStack,
                              RegionReadState &readState);
   FailureOr<Operation *> parseOpWithoutRegions(EncodingReader &reader,
@@ -1482,20 +1521,22 @@ private:
   LogicalResult parseRegion(RegionReadState &readState);
   LogicalResult parseBlockHeader(EncodingReader &reader,
                                  RegionReadState &readState);
-  LogicalResult parseBlockArguments(EncodingReader &reader, Block *block);
+  LogicalResult parseBlockArguments(EncodingReader &reader,
+                                    RegionReadState &readState, Block *block);
 
   //===--------------------------------------------------------------------===//
   // Value Processing
 
   /// Parse an operand reference using the given reader. Returns nullptr in the
   /// case of failure.
-  Value parseOperand(EncodingReader &reader);
+  Value parseOperand(EncodingReader &reader, IRReadState &state);
 
   /// Sequentially define the given value range.
-  LogicalResult defineValues(EncodingReader &reader, ValueRange values);
+  LogicalResult defineValues(EncodingReader &reader, IRReadState &state,
+                             ValueRange values);
 
   /// Create a value to use for a forward reference.
-  Value createForwardRef();
+  Value createForwardRef(IRReadState &state);
 
   //===--------------------------------------------------------------------===//
   // Use-list order helpers
@@ -1561,6 +1602,29 @@ private:
     SmallVector<unsigned, 4> nextValueIDs;
   };
 
+  /// The state of reading a tree of regions, i.e. everything that isn't shared
+  /// between isolated regions parsed in parallel.
+  struct IRReadState {
+    /// The current set of available IR value scopes.
+    std::vector<ValueScope> valueScopes;
+
+    /// A block containing the set of operations defined to create forward
+    /// references.
+    Block forwardRefOps;
+
+    /// A block containing previously created, and no longer used, forward
+    /// reference operations.
+    Block openForwardRefOps;
+
+    /// Worklist of values with custom use-list orders to process before the
+    /// end of the parsing.
+    DenseMap<void *, UseListOrderStorage> valueToUseListMap;
+
+    /// If set, isolated regions with their own section are not parsed
+    /// immediately but appended here.
+    std::vector<DeferredRegion> *deferredRegions = nullptr;
+  };
+
   /// The configuration of the parser.
   const ParserConfig &config;
 
@@ -1594,30 +1658,18 @@ private:
   /// The reader used to process resources within the bytecode.
   ResourceSectionReader resourceReader;
 
-  /// Worklist of values with custom use-list orders to process before the end
-  /// of the parsing.
-  DenseMap<void *, UseListOrderStorage> valueToUseListMap;
-
   /// The table of strings referenced within the bytecode file.
   StringSectionReader stringReader;
 
   /// The table of properties referenced by the operation in the bytecode file.
   PropertiesSectionReader propertiesReader;
 
-  /// The current set of available IR value scopes.
-  std::vector<ValueScope> valueScopes;
+  /// The read state of the IR parsed serially, including lazy-loaded regions.
+  IRReadState mainReadState;
 
   /// The global pre-order operation ordering.
   DenseMap<Operation *, unsigned> operationIDs;
 
-  /// A block containing the set of operations defined to create forward
-  /// references.
-  Block forwardRefOps;
-
-  /// A block containing previously created, and no longer used, forward
-  /// reference operations.
-  Block openForwardRefOps;
-
   /// An operation state used when instantiating forward references.
   OperationState forwardRefOpState;
 
@@ -1851,26 +1903,36 @@ BytecodeReader::Impl::parseOpName(EncodingReader &reader,
   if (failed(parseEntry(reader, opNames, opName, "operation name")))
     return failure();
   wasRegistered = opName->wasRegistered;
+  if (failed(resolveOpName(reader, *opName)))
+    return failure();
+  return *opName->opName;
+}
+
+LogicalResult
+BytecodeReader::Impl::resolveOpName(EncodingReader &reader,
+                                    BytecodeOperationName &opName) {
   // Check to see if this operation name has already been resolved. If we
   // haven't, load the dialect and build the operation name.
-  if (!opName->opName) {
-    // If the opName is empty, this is because we use to accept names such as
-    // `foo` without any `.` separator. We shouldn't tolerate this in textual
-    // format anymore but for now we'll be backward compatible. This can only
-    // happen with unregistered dialects.
-    if (opName->name.empty()) {
-      opName->opName.emplace(opName->dialect->name, getContext());
-    } else {
-      // Load the dialect and its version.
-      DialectReader dialectReader(attrTypeReader, stringReader, resourceReader,
-                                  dialectsMap, reader, version);
-      if (failed(opName->dialect->load(dialectReader, getContext())))
-        return failure();
-      opName->opName.emplace((opName->dialect->name + "." + opName->name).str(),
-                             getContext());
-    }
+  if (opName.opName)
+    return success();
+
+  // If the opName is empty, this is because we use to accept names such as
+  // `foo` without any `.` separator. We shouldn't tolerate this in textual
+  // format anymore but for now we'll be backward compatible. This can only
+  // happen with unregistered dialects.
+  if (opName.name.empty()) {
+    opName.opName.emplace(opName.dialect->name, getContext());
+    return success();
   }
-  return *opName->opName;
+
+  // Load the dialect and its version.
+  DialectReader dialectReader(attrTypeReader, stringReader, resourceReader,
+                              dialectsMap, reader, version);
+  if (failed(opName.dialect->load(dialectReader, getContext())))
+    return failure();
+  opName.opName.emplace((opName.dialect->name + "." + opName.name).str(),
+                        getContext());
+  return success();
 }
 
 //===----------------------------------------------------------------------===//
@@ -1949,7 +2011,7 @@ LogicalResult BytecodeReader::Impl::sortUseListOrder(Value value) {
     return success();
 
   bool hasIncomingOrder =
-      valueToUseListMap.contains(value.getAsOpaquePointer());
+      mainReadState.valueToUseListMap.contains(value.getAsOpaquePointer());
 
   // Compute the current order of the use-list with respect to the global
   // ordering. Detect if the order is already sorted while doing so.
@@ -1990,7 +2052,7 @@ LogicalResult BytecodeReader::Impl::sortUseListOrder(Value value) {
 
   // Pull the custom order info from the map.
   UseListOrderStorage customOrder =
-      valueToUseListMap.at(value.getAsOpaquePointer());
+      mainReadState.valueToUseListMap.at(value.getAsOpaquePointer());
   SmallVector<unsigned, 4> shuffle = std::move(customOrder.indices);
   uint64_t numUses =
       std::distance(value.getUses().begin(), value.getUses().end());
@@ -2073,22 +2135,35 @@ BytecodeReader::Impl::parseIRSection(ArrayRef<uint8_t> sectionData,
 
   // Parse the top-level block using a temporary module operation.
   OwningOpRef<ModuleOp> moduleOp = ModuleOp::create(fileLoc);
-  regionStack.emplace_back(*moduleOp, &reader, /*isIsolatedFromAbove=*/true);
+  regionStack.emplace_back(*moduleOp, &reader, /*isIsolatedFromAbove=*/true,
+                           &mainReadState);
   regionStack.back().curBlocks.push_back(moduleOp->getBody());
   regionStack.back().curBlock = regionStack.back().curRegion->begin();
   if (failed(parseBlockHeader(reader, regionStack.back())))
     return failure();
-  valueScopes.emplace_back();
-  valueScopes.back().push(regionStack.back());
+  mainReadState.valueScopes.emplace_back();
+  mainReadState.valueScopes.back().push(regionStack.back());
+
+  // When eagerly loading bytecode that encodes isolated regions in their own
+  // sections, these regions are skipped at first and parsed in parallel
+  // afterwards.
+  std::vector<DeferredRegion> deferredRegions;
+  if (!lazyLoading && version >= bytecode::kLazyLoading &&
+      getContext()->isMultithreadingEnabled())
+    mainReadState.deferredRegions = &deferredRegions;
 
   // Iteratively parse regions until everything has been resolved.
   while (!regionStack.empty())
     if (failed(parseRegions(regionStack, regionStack.back())))
       return failure();
-  if (!forwardRefOps.empty()) {
+  mainReadState.deferredRegions = nullptr;
+  if (!mainReadState.forwardRefOps.empty()) {
     return reader.emitError(
         "not all forward unresolved forward operand references");
   }
+  if (!deferredRegions.empty() &&
+      failed(parseIsolatedRegionsInParallel(reader, deferredRegions)))
+    return failure();
 
   // Sort use-lists according to what specified in bytecode.
   if (failed(processUseLists(*moduleOp)))
@@ -2118,6 +2193,69 @@ BytecodeReader::Impl::parseIRSection(ArrayRef<uint8_t> sectionData,
   return success();
 }
 
+LogicalResult BytecodeReader::Impl::resolveAllEntries(EncodingReader &reader) {
+  // Load all of the dialects, which may otherwise happen when a dialect asks
+  // for the version of another one.
+  DialectReader dialectReader(attrTypeReader, stringReader, resourceReader,
+                              dialectsMap, reader, version);
+  for (std::unique_ptr<BytecodeDialect> &dialect : dialects)
+    if (failed(dialect->load(dialectReader, getContext())))
+      return failure();
+  for (BytecodeOperationName &opName : opNames)
+    if (failed(resolveOpName(reader, opName)))
+      return failure();
+  return attrTypeReader.resolveAll();
+}
+
+LogicalResult BytecodeReader::Impl::parseIsolatedRegionsInParallel(
+    EncodingReader &reader, MutableArrayRef<DeferredRegion> regions) {
+  if (failed(resolveAllEntries(reader)))
+    return failure();
+
+  // Each region is parsed with its own value scopes and forward references.
+  // Use-lists only ever refer to values within the same isolated region, so
+  // their order does not depend on the order in which regions are parsed.
+  // Diagnostics are emitted in the order of the regions.
+  std::vector<DenseMap<void *, UseListOrderStorage>> useListMaps(
+      regions.size());
+  ParallelDiagnosticHandler diagHandler(getContext());
+  LogicalResult result = failableParallelForEachN(
+      getContext(), 0, regions.size(), [&](size_t index) -> LogicalResult {
+        diagHandler.setOrderIDForThread(index);
+        auto eraseOrderID = llvm::make_scope_exit(
+            [&] { diagHandler.eraseOrderIDForThread(); });
+
+        auto &[op, regionState] = regions[index];
+        IRReadState state;
+        regionState.irState = &state;
+        state.valueScopes.emplace_back();
+        std::vector<RegionReadState> regionStack;
+        regionStack.push_back(std::move(regionState));
+        while (!regionStack.empty()) {
+          if (failed(parseRegions(regionStack, regionStack.back()))) {
+            // Drop the uses of forward references before they are destroyed.
+            op->dropAllReferences();
+            return failure();
+          }
+        }
+        if (!state.forwardRefOps.empty()) {
+          op->dropAllReferences();
+          return emitError(fileLoc)
+                 << "not all forward unresolved forward operand references";
+        }
+        useListMaps[index] = std::move(state.valueToUseListMap);
+        return success();
+      });
+  if (failed(result))
+    return failure();
+
+  for (DenseMap<void *, UseListOrderStorage> &useListMap : useListMaps)
+    for (auto &it : useListMap)
+      mainReadState.valueToUseListMap.try_emplace(it.first,
+                                                  std::move(it.second));
+  return success();
+}
+
 LogicalResult
 BytecodeReader::Impl::parseRegions(std::vector<RegionReadState> &regionStack,
                                    RegionReadState &readState) {
@@ -2155,7 +2293,8 @@ BytecodeReader::Impl::parseRegions(std::vector<RegionReadState> &regionStack,
         // inner one is completed. Unless LazyLoading is activated in which case
         // nested region parsing is delayed.
         if ((*op)->getNumRegions()) {
-          RegionReadState childState(*op, &reader, isIsolatedFromAbove);
+          RegionReadState childState(*op, &reader, isIsolatedFromAbove,
+                                     readState.irState);
 
           // Isolated regions are encoded as a section in version 2 and above.
           if (version >= bytecode::kLazyLoading && isIsolatedFromAbove) {
@@ -2177,12 +2316,18 @@ BytecodeReader::Impl::parseRegions(std::vector<RegionReadState> &regionStack,
                                              std::prev(lazyLoadableOps.end()));
               continue;
             }
+
+            // If the region is parsed in parallel later, skip over it.
+            if (auto *deferredRegions = readState.irState->deferredRegions) {
+              deferredRegions->emplace_back(*op, std::move(childState));
+              continue;
+            }
           }
           regionStack.push_back(std::move(childState));
 
           // If the op is isolated from above, push a new value scope.
           if (isIsolatedFromAbove)
-            valueScopes.emplace_back();
+            readState.irState->valueScopes.emplace_back();
           return success();
         }
       }
@@ -2196,12 +2341,13 @@ BytecodeReader::Impl::parseRegions(std::vector<RegionReadState> &regionStack,
 
     // Reset the current block and any values reserved for this region.
     readState.curBlock = {};
-    valueScopes.back().pop(readState);
+    readState.irState->valueScopes.back().pop(readState);
   }
 
   // When the regions have been fully parsed, pop them off of the read stack. If
   // the regions were isolated from above, we also pop the last value scope.
   if (readState.isIsolatedFromAbove) {
+    std::vector<ValueScope> &valueScopes = readState.irState->valueScopes;
     assert(!valueScopes.empty() && "Expect a valueScope after reading region");
     valueScopes.pop_back();
   }
@@ -2286,7 +2432,7 @@ BytecodeReader::Impl::parseOpWithoutRegions(EncodingReader &reader,
       return failure();
     opState.operands.resize(numOperands);
     for (int i = 0, e = numOperands; i < e; ++i)
-      if (!(opState.operands[i] = parseOperand(reader)))
+      if (!(opState.operands[i] = parseOperand(reader, *readState.irState)))
         return failure();
   }
 
@@ -2334,7 +2480,7 @@ BytecodeReader::Impl::parseOpWithoutRegions(EncodingReader &reader,
   // do this if the current value scope is empty. That is, the op was not
   // encoded within a parent region.
   if (readState.numValues && op->getNumResults() &&
-      failed(defineValues(reader, op->getResults())))
+      failed(defineValues(reader, *readState.irState, op->getResults())))
     return failure();
 
   /// Store a map for every value that received a custom use-list order from the
@@ -2342,8 +2488,9 @@ BytecodeReader::Impl::parseOpWithoutRegions(EncodingReader &reader,
   if (resultIdxToUseListMap.has_value()) {
     for (size_t idx = 0; idx < op->getNumResults(); idx++) {
       if (resultIdxToUseListMap->contains(idx)) {
-        valueToUseListMap.try_emplace(op->getResult(idx).getAsOpaquePointer(),
-                                      resultIdxToUseListMap->at(idx));
+        readState.irState->valueToUseListMap.try_emplace(
+            op->getResult(idx).getAsOpaquePointer(),
+            resultIdxToUseListMap->at(idx));
       }
     }
   }
@@ -2378,7 +2525,7 @@ LogicalResult BytecodeReader::Impl::parseRegion(RegionReadState &readState) {
   }
 
   // Prepare the current value scope for this region.
-  valueScopes.back().push(readState);
+  readState.irState->valueScopes.back().push(readState);
 
   // Parse the entry block of the region.
   readState.curBlock = readState.curRegion->begin();
@@ -2393,7 +2540,8 @@ BytecodeReader::Impl::parseBlockHeader(EncodingReader &reader,
     return failure();
 
   // Parse the arguments of the block.
-  if (hasArgs && failed(parseBlockArguments(reader, &*readState.curBlock)))
+  if (hasArgs &&
+      failed(parseBlockArguments(reader, readState, &*readState.curBlock)))
     return failure();
 
   // Uselist orders are available since version 3 of the bytecode.
@@ -2415,15 +2563,18 @@ BytecodeReader::Impl::parseBlockHeader(EncodingReader &reader,
 
   for (size_t idx = 0; idx < blk.getNumArguments(); idx++)
     if (argIdxToUseListMap->contains(idx))
-      valueToUseListMap.try_emplace(blk.getArgument(idx).getAsOpaquePointer(),
-                                    argIdxToUseListMap->at(idx));
+      readState.irState->valueToUseListMap.try_emplace(
+          blk.getArgument(idx).getAsOpaquePointer(),
+          argIdxToUseListMap->at(idx));
 
   // We don't parse the operations of the block here, that's done elsewhere.
   return success();
 }
 
-LogicalResult BytecodeReader::Impl::parseBlockArguments(EncodingReader &reader,
-                                                        Block *block) {
+LogicalResult
+BytecodeReader::Impl::parseBlockArguments(EncodingReader &reader,
+                                          RegionReadState &readState,
+                                          Block *block) {
   // Parse the value ID for the first argument, and the number of arguments.
   uint64_t numArgs;
   if (failed(reader.parseVarInt(numArgs)))
@@ -2457,27 +2608,29 @@ LogicalResult BytecodeReader::Impl::parseBlockArguments(EncodingReader &reader,
     argLocs.push_back(argLoc);
   }
   block->addArguments(argTypes, argLocs);
-  return defineValues(reader, block->getArguments());
+  return defineValues(reader, *readState.irState, block->getArguments());
 }
 
 //===----------------------------------------------------------------------===//
 // Value Processing
 
-Value BytecodeReader::Impl::parseOperand(EncodingReader &reader) {
-  std::vector<Value> &values = valueScopes.back().values;
+Value BytecodeReader::Impl::parseOperand(EncodingReader &reader,
+                                         IRReadState &state) {
+  std::vector<Value> &values = state.valueScopes.back().values;
   Value *value = nullptr;
   if (failed(parseEntry(reader, values, value, "value")))
     return Value();
 
   // Create a new forward reference if necessary.
   if (!*value)
-    *value = createForwardRef();
+    *value = createForwardRef(state);
   return *value;
 }
 
 LogicalResult BytecodeReader::Impl::defineValues(EncodingReader &reader,
+                                                 IRReadState &state,
                                                  ValueRange newValues) {
-  ValueScope &valueScope = valueScopes.back();
+  ValueScope &valueScope = state.valueScopes.back();
   std::vector<Value> &values = valueScope.values;
 
   unsigned &valueID = valueScope.nextValueIDs.back();
@@ -2501,26 +2654,28 @@ LogicalResult BytecodeReader::Impl::defineValues(EncodingReader &reader,
       // Assert that this is a forward reference operation. Given how we compute
       // definition ids (incrementally as we parse), it shouldn't be possible
       // for the value to be defined any other way.
-      assert(forwardRefOp && forwardRefOp->getBlock() == &forwardRefOps &&
+      assert(forwardRefOp &&
+             forwardRefOp->getBlock() == &state.forwardRefOps &&
              "value index was already defined?");
 
       oldValue.replaceAllUsesWith(newValue);
-      forwardRefOp->moveBefore(&openForwardRefOps, openForwardRefOps.end());
+      forwardRefOp->moveBefore(&state.openForwardRefOps,
+                               state.openForwardRefOps.end());
     }
   }
   return success();
 }
 
-Value BytecodeReader::Impl::createForwardRef() {
+Value BytecodeReader::Impl::createForwardRef(IRReadState &state) {
   // Check for an avaliable existing operation to use. Otherwise, create a new
   // fake operation to use for the reference.
-  if (!openForwardRefOps.empty()) {
-    Operation *op = &openForwardRefOps.back();
-    op->moveBefore(&forwardRefOps, forwardRefOps.end());
+  if (!state.openForwardRefOps.empty()) {
+    Operation *op = &state.openForwardRefOps.back();
+    op->moveBefore(&state.forwardRefOps, state.forwardRefOps.end());
   } else {
-    forwardRefOps.push_back(Operation::create(forwardRefOpState));
+    state.forwardRefOps.push_back(Operation::create(forwardRefOpState));
   }
-  return forwardRefOps.back().getResult(0);
+  return state.forwardRefOps.back().getResult(0);
 }
 
 //===----------------------------------------------------------------------===//
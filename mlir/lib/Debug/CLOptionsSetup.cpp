@@ -13,6 +13,7 @@
 #include "mlir/Debug/ExecutionContext.h"
 #include "mlir/Debug/Observers/ActionLogging.h"
 #include "mlir/Debug/Observers/ActionProfiler.h"
+#include "mlir/Debug/Observers/PatternProfiler.h"
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/Support/FileUtilities.h"
 #include "llvm/Support/CommandLine.h"
@@ -37,6 +38,12 @@ struct DebugConfigCLOptions : public DebugConfig {
                  " '-' is passed"),
         cl::location(profileActionsToFlag)};
 
+    static cl::opt<bool, /*ExternalStorage=*/true> profilePatterns{
+        "profile-patterns",
+        cl::desc("Report the number of attempts and applications of each "
+                 "rewrite pattern, and the time spent in them, to stderr"),
+        cl::location(profilePatternsFlag)};
+
     static cl::list<std::string> logActionLocationFilter(
         "log-mlir-actions-filter",
         cl::desc(
@@ -79,6 +86,7 @@ public:
   Impl(MLIRContext &context, const DebugConfig &config) {
     if (config.getLogActionsTo().empty() &&
         config.getProfileActionsTo().empty() &&
+        !config.isPatternProfilingEnabled() &&
         !config.isDebuggerActionHookEnabled()) {
       if (tracing::DebugCounter::isActivated())
         context.registerActionHandler(tracing::DebugCounter());
@@ -123,6 +131,11 @@ public:
       executionContext.registerObserver(actionProfiler.get());
     }
 
+    if (config.isPatternProfilingEnabled()) {
+      patternProfiler = std::make_unique<tracing::PatternProfiler>();
+      executionContext.registerObserver(patternProfiler.get());
+    }
+
     if (config.isDebuggerActionHookEnabled()) {
       errs() << " (with Debugger hook)";
       setupDebuggerExecutionContextHook(executionContext);
@@ -131,6 +144,11 @@ public:
     context.registerActionHandler(executionContext);
   }
 
+  ~Impl() {
+    if (patternProfiler)
+      patternProfiler->print(errs());
+  }
+
 private:
   std::unique_ptr<ToolOutputFile> logActionsFile;
   tracing::ExecutionContext executionContext;
@@ -139,6 +157,7 @@ private:
       locationBreakpoints;
   std::unique_ptr<ToolOutputFile> profileActionsFile;
   std::unique_ptr<tracing::ActionProfiler> actionProfiler;
+  std::unique_ptr<tracing::PatternProfiler> patternProfiler;
 };
 
 InstallDebugHandler::InstallDebugHandler(MLIRContext &context,
@@ -0,0 +1,112 @@
+//===- PatternProfiler.cpp - Profiling Rewrite Patterns ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Debug/Observers/PatternProfiler.h"
+#include "mlir/IR/Action.h"
+#include "mlir/Rewrite/PatternApplicator.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace mlir;
+using namespace mlir::tracing;
+
+namespace {
+/// A pattern application in progress.
+struct ApplicationFrame {
+  std::chrono::steady_clock::time_point startTime;
+  /// The time spent in the pattern applications nested in this one.
+  std::chrono::nanoseconds nestedTime{0};
+};
+} // namespace
+
+/// The pattern applications in progress on this thread. Patterns may run
+/// nested rewrites, so this is a stack.
+static thread_local SmallVector<ApplicationFrame> frames;
+
+//===----------------------------------------------------------------------===//
+// PatternProfiler
+//===----------------------------------------------------------------------===//
+
+void PatternProfiler::beforeExecute(const ActionActiveStack *action,
+                                    Breakpoint *breakpoint, bool willExecute) {
+  if (willExecute && isa<ApplyPatternAction>(action->getAction()))
+    frames.push_back({std::chrono::steady_clock::now()});
+}
+
+void PatternProfiler::afterExecute(const ActionActiveStack *action) {
+  const auto *applyAction = dyn_cast<ApplyPatternAction>(&action->getAction());
+  if (!applyAction)
+    return;
+  ApplicationFrame frame = frames.pop_back_val();
+  std::chrono::nanoseconds elapsed =
+      std::chrono::steady_clock::now() - frame.startTime;
+  // Only account the time of the nested applications to their own patterns,
+  // so that no time is counted twice and the percentages add up to 100%.
+  if (!frames.empty())
+    frames.back().nestedTime += elapsed;
+  elapsed -= frame.nestedTime;
+
+  StringRef name = applyAction->getPattern().getDebugName();
+  std::lock_guard<std::mutex> guard(mutex);
+  PatternStatistics &stats = statistics[name.empty() ? "<unnamed>" : name];
+  ++stats.numAttempts;
+  if (applyAction->wasApplied()) {
+    ++stats.numApplied;
+    stats.appliedTime += elapsed;
+  } else {
+    stats.failedTime += elapsed;
+  }
+}
+
+const PatternProfiler::PatternStatistics *
+PatternProfiler::lookup(StringRef patternName) {
+  std::lock_guard<std::mutex> guard(mutex);
+  auto it = statistics.find(patternName);
+  return it == statistics.end() ? nullptr : &it->second;
+}
+
+void PatternProfiler::print(raw_ostream &os) {
+  std::lock_guard<std::mutex> guard(mutex);
+  SmallVector<const llvm::StringMapEntry<PatternStatistics> *> entries;
+  std::chrono::nanoseconds totalTime{0};
+  for (const auto &entry : statistics) {
+    entries.push_back(&entry);
+    totalTime += entry.second.failedTime + entry.second.appliedTime;
+  }
+  llvm::sort(entries, [](const auto *lhs, const auto *rhs) {
+    auto lhsTime = lhs->second.failedTime + lhs->second.appliedTime;
+    auto rhsTime = rhs->second.failedTime + rhs->second.appliedTime;
+    if (lhsTime != rhsTime)
+      return lhsTime > rhsTime;
+    return lhs->first() < rhs->first();
+  });
+
+  auto seconds = [](std::chrono::nanoseconds time) {
+    return std::chrono::duration<double>(time).count();
+  };
+  os << "===" << std::string(73, '-') << "===\n";
+  os.indent(28) << "... Pattern profile ...\n";
+  os << "===" << std::string(73, '-') << "===\n";
+  os << llvm::format("  Total Execution Time: %.4f seconds\n\n",
+                     seconds(totalTime));
+  os << "  ----Total----  ---Failed---  --Applied---  Attempts   Applied  "
+        "Name\n";
+  for (const auto *entry : entries) {
+    const PatternStatistics &stats = entry->second;
+    auto time = stats.failedTime + stats.appliedTime;
+    os << llvm::format("  %7.4f (%5.1f%%)  %12.4f  %12.4f  %8llu  %8llu  ",
+                       seconds(time),
+                       totalTime.count() ? 100.0 * time / totalTime : 0.0,
+                       seconds(stats.failedTime), seconds(stats.appliedTime),
+                       (unsigned long long)stats.numAttempts,
+                       (unsigned long long)stats.numApplied)
+       << entry->first() << "\n";
+  }
+  os.flush();
+}
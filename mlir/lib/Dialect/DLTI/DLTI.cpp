@@ -114,6 +114,12 @@ constexpr const StringLiteral
     mlir::DLTIDialect::kDataLayoutGlobalMemorySpaceKey;
 
 constexpr const StringLiteral mlir::DLTIDialect::kDataLayoutStackAlignmentKey;
+constexpr const StringLiteral mlir::DLTIDialect::kDataLayoutL1CacheSizeKey;
+constexpr const StringLiteral mlir::DLTIDialect::kDataLayoutL2CacheSizeKey;
+constexpr const StringLiteral mlir::DLTIDialect::kDataLayoutL3CacheSizeKey;
+constexpr const StringLiteral mlir::DLTIDialect::kDataLayoutVectorSizeKey;
+constexpr const StringLiteral
+    mlir::DLTIDialect::kDataLayoutNumVectorRegistersKey;
 
 namespace mlir {
 namespace impl {
@@ -370,6 +376,18 @@ public:
         entryName == DLTIDialect::kDataLayoutGlobalMemorySpaceKey ||
         entryName == DLTIDialect::kDataLayoutStackAlignmentKey)
       return success();
+    if (entryName == DLTIDialect::kDataLayoutL1CacheSizeKey ||
+        entryName == DLTIDialect::kDataLayoutL2CacheSizeKey ||
+        entryName == DLTIDialect::kDataLayoutL3CacheSizeKey ||
+        entryName == DLTIDialect::kDataLayoutVectorSizeKey ||
+        entryName == DLTIDialect::kDataLayoutNumVectorRegistersKey) {
+      auto value = llvm::dyn_cast<IntegerAttr>(entry.getValue());
+      if (value && value.getValue().isStrictlyPositive())
+        return success();
+      return emitError(loc) << "'" << entryName
+                            << "' data layout entry is expected to be a "
+                               "positive integer";
+    }
     return emitError(loc) << "unknown data layout entry name: " << entryName;
   }
 };
@@ -0,0 +1,163 @@
+//===- ContractionStrategy.cpp - Target-aware contraction tiling ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file derives default tile and pack sizes for contractions from the
+// cache and vector register parameters of the target, following the analytical
+// model of BLIS ("Analytical Modeling Is Enough for High-Performance BLIS",
+// Low et al.).
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/DLTI/DLTI.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/TypeUtilities.h"
+#include "mlir/Interfaces/DataLayoutInterfaces.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "linalg-contraction-strategy"
+#define DBGS() (llvm::dbgs() << "[" DEBUG_TYPE "]: ")
+
+using namespace mlir;
+using namespace mlir::linalg;
+
+/// Updates `value` with the integer entry for `key` in `spec`, if any.
+static void readTargetParameter(DataLayoutSpecInterface spec, StringRef key,
+                                int64_t &value) {
+  DataLayoutEntryInterface entry =
+      spec.getSpecForIdentifier(StringAttr::get(spec.getContext(), key));
+  if (!entry)
+    return;
+  if (auto intAttr = dyn_cast<IntegerAttr>(entry.getValue()))
+    if (intAttr.getInt() > 0)
+      value = intAttr.getInt();
+}
+
+ContractionTargetInfo ContractionTargetInfo::get(Operation *op) {
+  // Collect the specs from the outermost to the innermost one, so that inner
+  // specs override the outer ones.
+  SmallVector<DataLayoutSpecInterface> specs;
+  for (auto dlOp = op->getParentOfType<DataLayoutOpInterface>(); dlOp;
+       dlOp = dlOp->getParentOfType<DataLayoutOpInterface>()) {
+    if (DataLayoutSpecInterface spec = dlOp.getDataLayoutSpec())
+      specs.push_back(spec);
+  }
+
+  ContractionTargetInfo info;
+  for (DataLayoutSpecInterface spec : llvm::reverse(specs)) {
+    readTargetParameter(spec, DLTIDialect::kDataLayoutL1CacheSizeKey,
+                        info.l1CacheSizeInBytes);
+    readTargetParameter(spec, DLTIDialect::kDataLayoutL2CacheSizeKey,
+                        info.l2CacheSizeInBytes);
+    readTargetParameter(spec, DLTIDialect::kDataLayoutL3CacheSizeKey,
+                        info.l3CacheSizeInBytes);
+    readTargetParameter(spec, DLTIDialect::kDataLayoutVectorSizeKey,
+                        info.vectorSizeInBits);
+    readTargetParameter(spec, DLTIDialect::kDataLayoutNumVectorRegistersKey,
+                        info.numVectorRegisters);
+  }
+  return info;
+}
+
+/// Rounds `size` down to a multiple of `multiple`, but not below `multiple`.
+static int64_t roundDownToMultiple(int64_t size, int64_t multiple) {
+  return std::max(size / multiple, int64_t(1)) * multiple;
+}
+
+/// Clamps `size` to the static loop range `range`. Dynamic ranges do not
+/// clamp.
+static int64_t clampToRange(int64_t size, int64_t range) {
+  return ShapedType::isDynamic(range) ? size : std::min(size, range);
+}
+
+FailureOr<ContractionStrategy>
+linalg::computeContractionStrategy(LinalgOp linalgOp,
+                                   const ContractionTargetInfo &target) {
+  FailureOr<ContractionDimensions> dims = inferContractionDims(linalgOp);
+  if (failed(dims))
+    return failure();
+  if (linalgOp.getNumDpsInits() != 1)
+    return failure();
+  Type elementType =
+      getElementTypeOrSelf(linalgOp.getDpsInitOperand(0)->get().getType());
+  if (!elementType.isIntOrFloat())
+    return failure();
+
+  int64_t elementBits = std::max<int64_t>(elementType.getIntOrFloatBitWidth(),
+                                          8);
+  int64_t elementBytes = elementBits / 8;
+  int64_t lanes = std::max<int64_t>(target.vectorSizeInBits / elementBits, 1);
+
+  // Micro-kernel: the n dimension spans two vectors, and the m dimension is
+  // as large as the registers allow once the accumulators, the two RHS
+  // vectors and one broadcast LHS register are accounted for.
+  int64_t nrVectors = 2;
+  int64_t nr = nrVectors * lanes;
+  int64_t mr = std::max<int64_t>(
+      (target.numVectorRegisters - nrVectors - 1) / nrVectors, 1);
+
+  // kc: an nr-wide RHS micro-panel occupies half of L1, leaving room for the
+  // streamed LHS micro-panel and the accumulators' spills.
+  int64_t kc = roundDownToMultiple(
+      target.l1CacheSizeInBytes / 2 / (nr * elementBytes), lanes);
+  // mc: the LHS block occupies half of L2.
+  int64_t mc =
+      roundDownToMultiple(target.l2CacheSizeInBytes / 2 / (kc * elementBytes),
+                          mr);
+  // nc: the RHS block occupies half of L3.
+  int64_t nc =
+      roundDownToMultiple(target.l3CacheSizeInBytes / 2 / (kc * elementBytes),
+                          nr);
+
+  SmallVector<int64_t> loopRanges = linalgOp.getStaticLoopRanges();
+  int64_t mRange = loopRanges[dims->m.back()];
+  int64_t nRange = loopRanges[dims->n.back()];
+  int64_t kRange = loopRanges[dims->k.back()];
+
+  ContractionStrategy strategy;
+  strategy.mnkPackedSizes = {clampToRange(mr, mRange), clampToRange(nr, nRange),
+                             clampToRange(kc, kRange)};
+  strategy.mnkCacheTileSizes = {
+      clampToRange(mc, mRange), clampToRange(nc, nRange),
+      clampToRange(kc, kRange)};
+  LLVM_DEBUG({
+    DBGS() << "micro-kernel (m, n, k): ";
+    llvm::interleaveComma(strategy.mnkPackedSizes, llvm::dbgs());
+    llvm::dbgs() << "\n";
+    DBGS() << "cache tiles (m, n, k): ";
+    llvm::interleaveComma(strategy.mnkCacheTileSizes, llvm::dbgs());
+    llvm::dbgs() << "\n";
+  });
+  return strategy;
+}
+
+FailureOr<PackResult>
+linalg::packContractionForTarget(RewriterBase &rewriter, LinalgOp linalgOp,
+                                 ContractionStrategy *strategy) {
+  FailureOr<ContractionStrategy> maybeStrategy = computeContractionStrategy(
+      linalgOp, ContractionTargetInfo::get(linalgOp));
+  if (failed(maybeStrategy))
+    return rewriter.notifyMatchFailure(
+        linalgOp, "not a contraction with an integer or float result");
+
+  // Pack to {.., kk, mm} for the LHS and {.., kk, nn} for the RHS, so that the
+  // micro-kernel reads an mm-wide column of the LHS and an nn-wide row of the
+  // RHS at every step of kk.
+  SmallVector<OpFoldResult> mnkPackedSizes =
+      getAsIndexOpFoldResult(rewriter.getContext(),
+                             maybeStrategy->mnkPackedSizes);
+  FailureOr<PackResult> packResult =
+      packMatmulGreedily(rewriter, linalgOp, mnkPackedSizes,
+                         /*mnkPaddedSizesNextMultipleOf=*/{},
+                         /*mnkOrder=*/{0, 1, 2});
+  if (succeeded(packResult) && strategy)
+    *strategy = std::move(*maybeStrategy);
+  return packResult;
+}
@@ -13,6 +13,7 @@
 #include "mlir/Dialect/Linalg/Passes.h"
 
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Arith/Utils/Utils.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
@@ -1959,6 +1960,142 @@ void mlir::linalg::populateElementwiseOpsFusionPatterns(
   populateEraseUnusedOperandsAndResultsPatterns(patterns);
 }
 
+//===---------------------------------------------------------------------===//
+// Cost model for elementwise op fusion.
+//===---------------------------------------------------------------------===//
+
+/// Returns the cost of executing `op` once, relative to an addition.
+static int64_t getOpCost(Operation *op,
+                         const ElementwiseFusionCostModelOptions &options) {
+  if (op->hasTrait<OpTrait::ConstantLike>() || isa<IndexOp>(op))
+    return 0;
+  if (isa<arith::DivFOp, arith::DivSIOp, arith::DivUIOp, arith::CeilDivSIOp,
+          arith::CeilDivUIOp, arith::FloorDivSIOp, arith::RemFOp,
+          arith::RemSIOp, arith::RemUIOp>(op))
+    return options.expensiveOpCost;
+  if (isa<arith::ArithDialect>(op->getDialect()))
+    return 1;
+  return options.expensiveOpCost;
+}
+
+/// Returns the cost of computing one element of `genericOp`.
+static int64_t getBodyCost(GenericOp genericOp,
+                           const ElementwiseFusionCostModelOptions &options) {
+  int64_t cost = 0;
+  genericOp.getBody()->walk([&](Operation *op) {
+    if (!op->hasTrait<OpTrait::IsTerminator>())
+      cost += getOpCost(op, options);
+  });
+  return cost;
+}
+
+/// Returns the maximum number of values of `block` that are live at once,
+/// assuming the operations execute in order.
+static int64_t getMaxLiveValues(Block &block) {
+  DenseMap<Operation *, int64_t> opIndex;
+  for (auto [index, op] : llvm::enumerate(block))
+    opIndex[&op] = index;
+
+  // Values are live from their definition to the last operation of the block
+  // that uses them, possibly from a nested region. `numLive[i]` is the
+  // difference between the number of values live at the i-th and the i-1-th
+  // operation.
+  SmallVector<int64_t> numLive(opIndex.size() + 1, 0);
+  auto addLiveRange = [&](Value value, int64_t def) {
+    int64_t lastUse = def;
+    for (Operation *user : value.getUsers())
+      if (Operation *ancestor = block.findAncestorOpInBlock(*user))
+        lastUse = std::max(lastUse, opIndex.lookup(ancestor));
+    ++numLive[def];
+    --numLive[lastUse + 1];
+  };
+  for (BlockArgument arg : block.getArguments())
+    if (!arg.use_empty())
+      addLiveRange(arg, 0);
+  for (Operation &op : block)
+    for (Value result : op.getResults())
+      addLiveRange(result, opIndex.lookup(&op));
+
+  int64_t live = 0, maxLive = 0;
+  for (int64_t delta : numLive) {
+    live += delta;
+    maxLive = std::max(maxLive, live);
+  }
+  return maxLive;
+}
+
+ElementwiseFusionCost mlir::linalg::estimateElementwiseFusionCost(
+    OpOperand *fusedOperand, const ElementwiseFusionCostModelOptions &options) {
+  auto producerResult = cast<OpResult>(fusedOperand->get());
+  auto producer = cast<GenericOp>(producerResult.getOwner());
+  auto consumer = cast<GenericOp>(fusedOperand->getOwner());
+
+  ElementwiseFusionCost cost;
+  cost.producerCost = getBodyCost(producer, options);
+
+  // The fused op computes the producer once per iteration of the consumer, so
+  // every producer element is recomputed for each iteration of the consumer
+  // loops that do not index the fused operand.
+  AffineMap consumerIndexMap = consumer.getMatchingIndexingMap(fusedOperand);
+  SmallVector<int64_t, 4> consumerLoopRanges = consumer.getStaticLoopRanges();
+  int64_t recomputationFactor = 1;
+  for (unsigned dim = 0, e = consumer.getNumLoops(); dim < e; ++dim) {
+    if (consumerIndexMap.isFunctionOfDim(dim))
+      continue;
+    if (ShapedType::isDynamic(consumerLoopRanges[dim])) {
+      recomputationFactor = ShapedType::kDynamic;
+      break;
+    }
+    recomputationFactor *= consumerLoopRanges[dim];
+  }
+  if (!ShapedType::isDynamic(recomputationFactor))
+    cost.recomputationFactor = recomputationFactor;
+
+  // Fusion saves the read of the fused operand, and its write when the
+  // consumer is the only user of the producer result.
+  bool onlyUsedByConsumer = llvm::all_of(
+      producerResult.getUsers(), [&](Operation *user) {
+        return user == consumer.getOperation();
+      });
+  cost.savedMemoryAccesses = onlyUsedByConsumer ? 2 : 1;
+
+  // The producer body is inlined at the start of the consumer body, where the
+  // other consumer arguments are already live.
+  Block &consumerBlock = *consumer.getBlock();
+  BlockArgument fusedArg = consumer.getMatchingBlockArgument(fusedOperand);
+  int64_t numLiveConsumerArgs =
+      llvm::count_if(consumerBlock.getArguments(), [&](BlockArgument arg) {
+        return arg != fusedArg && !arg.use_empty();
+      });
+  cost.maxLiveValues =
+      std::max(getMaxLiveValues(*producer.getBlock()) + numLiveConsumerArgs,
+               getMaxLiveValues(consumerBlock));
+  return cost;
+}
+
+ControlFusionFn mlir::linalg::getElementwiseFusionCostModelControlFn(
+    const ElementwiseFusionCostModelOptions &options) {
+  return [options](OpOperand *fusedOperand) {
+    if (!areElementwiseOpsFusable(fusedOperand))
+      return false;
+    ElementwiseFusionCost cost =
+        estimateElementwiseFusionCost(fusedOperand, options);
+    if (cost.maxLiveValues > options.maxLiveValues)
+      return false;
+    // With dynamic recomputation, only fuse producers that are free to
+    // recompute.
+    if (!cost.recomputationFactor)
+      return cost.producerCost == 0;
+    // The producer is computed once per element anyway if it is kept for
+    // other users.
+    int64_t extraComputations = *cost.recomputationFactor;
+    if (cost.savedMemoryAccesses == 2)
+      extraComputations -= 1;
+    return cost.producerCost * extraComputations <=
+           options.opsPerMemoryAccess * cost.savedMemoryAccesses;
+  };
+}
+
 void mlir::linalg::populateCollapseDimensions(
     RewritePatternSet &patterns,
     const GetCollapsableDimensionsFn &controlCollapseDimensions) {
@@ -1774,10 +1774,11 @@ vectorizeDynamicLinalgOpPrecondition(linalg::LinalgOp op,
     return vectorizeDynamicConvOpPrecondition(op, flatten1DDepthwiseConv);
 
   // TODO: Masking only supports dynamic element-wise ops, linalg.generic ops,
-  // linalg.copy ops and ops that implement ContractionOpInterface for now.
+  // linalg.reduce ops, linalg.copy ops and ops that implement
+  // ContractionOpInterface for now.
   if (!isElementwise(op) &&
-      !isa<linalg::GenericOp, linalg::CopyOp, linalg::ContractionOpInterface>(
-          op.getOperation()))
+      !isa<linalg::GenericOp, linalg::ReduceOp, linalg::CopyOp,
+           linalg::ContractionOpInterface>(op.getOperation()))
     return failure();
 
   LDBG("Dynamically-shaped op meets vectorization pre-conditions\n");
@@ -1946,11 +1947,24 @@ vectorizeScalableVectorPrecondition(Operation *op,
   if (!isScalable)
     return success();
 
-  // Only element-wise and 1d depthwise conv ops supported in the presence of
-  // scalable dims.
+  // Only element-wise ops, 1d depthwise convs and reductions are supported in
+  // the presence of a scalable trailing dim.
   auto linalgOp = dyn_cast<LinalgOp>(op);
-  return success(linalgOp && (isElementwise(linalgOp) ||
-                              isa<linalg::DepthwiseConv1DNwcWcOp>(op)));
+  if (!linalgOp)
+    return failure();
+  if (isElementwise(linalgOp) || isa<linalg::DepthwiseConv1DNwcWcOp>(op))
+    return success();
+  if (linalgOp.getNumReductionLoops() == 0)
+    return failure();
+
+  // The trailing dim of a reduction may be either a parallel or the reduction
+  // dim. Masked multi-reductions are lowered to predicated reductions, which
+  // only support a single scalable dim.
+  if (llvm::count(inputScalableVecDims, true) != 1) {
+    LDBG("Reductions only support a single scalable vector dim\n");
+    return failure();
+  }
+  return success();
 }
 
 LogicalResult mlir::linalg::vectorizeOpPrecondition(
@@ -16,6 +16,7 @@
 #include <atomic>
 #include <cassert>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <mutex>
@@ -23,7 +24,7 @@
 #include <vector>
 
 #include "llvm/ADT/StringMap.h"
-#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 
 using namespace mlir::runtime;
 
@@ -38,6 +39,155 @@ namespace {
 // Forward declare class defined below.
 class RefCounted;
 
+// -------------------------------------------------------------------------- //
+// WorkStealingExecutor runs async tasks on a fixed set of worker threads.
+//
+// Every worker owns a deque of tasks. Tasks submitted from a worker thread
+// (e.g. nested `async.execute` regions spawned by `async.parallel_for`) are
+// pushed to the back of that worker's deque, and the worker pops tasks from the
+// back, so recently spawned tasks run while their data is still in cache. Idle
+// workers steal tasks from the front of the other deques. Tasks submitted from
+// outside of the executor are distributed across the deques round-robin.
+// Compared to a thread pool with a single shared queue, workers only contend
+// with each other when they steal.
+// -------------------------------------------------------------------------- //
+
+class WorkStealingExecutor;
+
+// The executor and the index of the worker running on the current thread.
+thread_local WorkStealingExecutor *currentExecutor = nullptr;
+thread_local unsigned currentWorker = 0;
+
+class WorkStealingExecutor {
+public:
+  using Task = std::function<void()>;
+
+  explicit WorkStealingExecutor(unsigned numWorkers)
+      : queues(std::max(numWorkers, 1u)) {
+    workers.reserve(queues.size());
+    for (unsigned i = 0, e = queues.size(); i < e; ++i)
+      workers.emplace_back([this, i] { workerLoop(i); });
+  }
+
+  ~WorkStealingExecutor() {
+    wait();
+    {
+      std::lock_guard<std::mutex> lock(sleepMu);
+      stopping = true;
+    }
+    sleepCv.notify_all();
+    for (std::thread &worker : workers)
+      worker.join();
+  }
+
+  WorkStealingExecutor(const WorkStealingExecutor &) = delete;
+  WorkStealingExecutor &operator=(const WorkStealingExecutor &) = delete;
+
+  unsigned getNumWorkers() const { return queues.size(); }
+
+  // Submits the task for asynchronous execution.
+  void async(Task task) {
+    numOutstanding.fetch_add(1);
+
+    unsigned index = currentExecutor == this
+                         ? currentWorker
+                         : nextQueue.fetch_add(1, std::memory_order_relaxed) %
+                               queues.size();
+    {
+      std::lock_guard<std::mutex> lock(queues[index].mu);
+      queues[index].tasks.push_back(std::move(task));
+      numQueued.fetch_add(1);
+    }
+
+    // Wake up a sleeping worker. Workers check `numQueued` while holding the
+    // sleep mutex, so taking it here guarantees the notification is not lost.
+    if (numSleeping.load() > 0) {
+      std::lock_guard<std::mutex> lock(sleepMu);
+      sleepCv.notify_one();
+    }
+  }
+
+  // Blocks until all submitted tasks, including tasks submitted by other tasks,
+  // are completed. Must not be called from a worker thread.
+  void wait() {
+    assert(currentExecutor != this && "waiting from a worker thread");
+    std::unique_lock<std::mutex> lock(doneMu);
+    doneCv.wait(lock, [this] { return numOutstanding.load() == 0; });
+  }
+
+private:
+  struct alignas(64) Queue {
+    std::mutex mu;
+    std::deque<Task> tasks;
+  };
+
+  // Pops a task from the back of the worker's own deque, or steals one from
+  // the front of another deque. Returns an empty task if all deques are empty.
+  Task popOrSteal(unsigned index) {
+    for (unsigned i = 0, e = queues.size(); i < e && numQueued.load() > 0;
+         ++i) {
+      Queue &queue = queues[(index + i) % e];
+      std::lock_guard<std::mutex> lock(queue.mu);
+      if (queue.tasks.empty())
+        continue;
+
+      Task task;
+      if (i == 0) {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      } else {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+      numQueued.fetch_sub(1);
+      return task;
+    }
+    return Task();
+  }
+
+  void workerLoop(unsigned index) {
+    currentExecutor = this;
+    currentWorker = index;
+
+    while (true) {
+      if (Task task = popOrSteal(index)) {
+        task();
+        if (numOutstanding.fetch_sub(1) == 1) {
+          std::lock_guard<std::mutex> lock(doneMu);
+          doneCv.notify_all();
+        }
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(sleepMu);
+      numSleeping.fetch_add(1);
+      sleepCv.wait(lock, [this] { return stopping || numQueued.load() > 0; });
+      numSleeping.fetch_sub(1);
+      if (stopping)
+        return;
+    }
+  }
+
+  std::vector<Queue> queues;
+  std::vector<std::thread> workers;
+  std::atomic<unsigned> nextQueue{0};
+
+  // The number of tasks in all deques.
+  std::atomic<int64_t> numQueued{0};
+  // The number of tasks submitted but not yet completed.
+  std::atomic<int64_t> numOutstanding{0};
+
+  // Idle workers sleep until new tasks are queued.
+  std::mutex sleepMu;
+  std::condition_variable sleepCv;
+  std::atomic<unsigned> numSleeping{0};
+  bool stopping = false;
+
+  // `wait` sleeps until all outstanding tasks are completed.
+  std::mutex doneMu;
+  std::condition_variable doneCv;
+};
+
 // -------------------------------------------------------------------------- //
 // AsyncRuntime orchestrates all async operations and Async runtime API is built
 // on top of the default runtime instance.
@@ -45,10 +195,12 @@ class RefCounted;
 
 class AsyncRuntime {
 public:
-  AsyncRuntime() : numRefCountedObjects(0) {}
+  AsyncRuntime()
+      : numRefCountedObjects(0),
+        executor(llvm::hardware_concurrency().compute_thread_count()) {}
 
   ~AsyncRuntime() {
-    threadPool.wait(); // wait for the completion of all async tasks
+    executor.wait(); // wait for the completion of all async tasks
     assert(getNumRefCountedObjects() == 0 &&
            "all ref counted objects must be destroyed");
   }
@@ -57,7 +209,7 @@ public:
     return numRefCountedObjects.load(std::memory_order_relaxed);
   }
 
-  llvm::ThreadPoolInterface &getThreadPool() { return threadPool; }
+  WorkStealingExecutor &getExecutor() { return executor; }
 
 private:
   friend class RefCounted;
@@ -72,7 +224,7 @@ private:
   }
 
   std::atomic<int64_t> numRefCountedObjects;
-  llvm::DefaultThreadPool threadPool;
+  WorkStealingExecutor executor;
 };
 
 // -------------------------------------------------------------------------- //
@@ -367,6 +519,9 @@ extern "C" bool mlirAsyncRuntimeIsGroupError(AsyncGroup *group) {
 }
 
 extern "C" void mlirAsyncRuntimeAwaitToken(AsyncToken *token) {
+  // The state only transitions once, so a ready token does not need the lock.
+  if (State(token->state).isAvailableOrError())
+    return;
   std::unique_lock<std::mutex> lock(token->mu);
   if (!State(token->state).isAvailableOrError())
     token->cv.wait(
@@ -374,6 +529,8 @@ extern "C" void mlirAsyncRuntimeAwaitToken(AsyncToken *token) {
 }
 
 extern "C" void mlirAsyncRuntimeAwaitValue(AsyncValue *value) {
+  if (State(value->state).isAvailableOrError())
+    return;
   std::unique_lock<std::mutex> lock(value->mu);
   if (!State(value->state).isAvailableOrError())
     value->cv.wait(
@@ -381,6 +538,8 @@ extern "C" void mlirAsyncRuntimeAwaitValue(AsyncValue *value) {
 }
 
 extern "C" void mlirAsyncRuntimeAwaitAllInGroup(AsyncGroup *group) {
+  if (group->pendingTokens == 0)
+    return;
   std::unique_lock<std::mutex> lock(group->mu);
   if (group->pendingTokens != 0)
     group->cv.wait(lock, [group] { return group->pendingTokens == 0; });
@@ -394,13 +553,19 @@ extern "C" ValueStorage mlirAsyncRuntimeGetValueStorage(AsyncValue *value) {
 
 extern "C" void mlirAsyncRuntimeExecute(CoroHandle handle, CoroResume resume) {
   auto *runtime = getDefaultAsyncRuntime();
-  runtime->getThreadPool().async([handle, resume]() { (*resume)(handle); });
+  runtime->getExecutor().async([handle, resume]() { (*resume)(handle); });
 }
 
 extern "C" void mlirAsyncRuntimeAwaitTokenAndExecute(AsyncToken *token,
                                                      CoroHandle handle,
                                                      CoroResume resume) {
   auto execute = [handle, resume]() { (*resume)(handle); };
+
+  // Resume the continuation inline without taking the lock if the token is
+  // already ready, which is the common case for fine-grained task graphs.
+  if (State(token->state).isAvailableOrError())
+    return execute();
+
   std::unique_lock<std::mutex> lock(token->mu);
   if (State(token->state).isAvailableOrError()) {
     lock.unlock();
@@ -414,6 +579,9 @@ extern "C" void mlirAsyncRuntimeAwaitValueAndExecute(AsyncValue *value,
                                                      CoroHandle handle,
                                                      CoroResume resume) {
   auto execute = [handle, resume]() { (*resume)(handle); };
+  if (State(value->state).isAvailableOrError())
+    return execute();
+
   std::unique_lock<std::mutex> lock(value->mu);
   if (State(value->state).isAvailableOrError()) {
     lock.unlock();
@@ -427,6 +595,9 @@ extern "C" void mlirAsyncRuntimeAwaitAllInGroupAndExecute(AsyncGroup *group,
                                                           CoroHandle handle,
                                                           CoroResume resume) {
   auto execute = [handle, resume]() { (*resume)(handle); };
+  if (group->pendingTokens == 0)
+    return execute();
+
   std::unique_lock<std::mutex> lock(group->mu);
   if (group->pendingTokens == 0) {
     lock.unlock();
@@ -437,7 +608,7 @@ extern "C" void mlirAsyncRuntimeAwaitAllInGroupAndExecute(AsyncGroup *group,
 }
 
 extern "C" int64_t mlirAsyncRuntimGetNumWorkerThreads() {
-  return getDefaultAsyncRuntime()->getThreadPool().getMaxConcurrency();
+  return getDefaultAsyncRuntime()->getExecutor().getNumWorkers();
 }
 
 //===----------------------------------------------------------------------===//
@@ -78,6 +78,14 @@ struct PassManagerOptions {
               "display the results in a merged list sorted by pass name"),
           clEnumValN(PassDisplayMode::Pipeline, "pipeline",
                      "display the results with a nested pipeline view"))};
+
+  //===--------------------------------------------------------------------===//
+  // Pass Memory Profiling
+  //===--------------------------------------------------------------------===//
+  llvm::cl::opt<bool> passMemoryProfile{
+      "mlir-pass-memory-profile",
+      llvm::cl::desc("Display the IR growth and the attribute and type storage "
+                     "allocated by each pass")};
 };
 } // namespace
 
@@ -143,6 +151,10 @@ LogicalResult mlir::applyPassManagerCLOptions(PassManager &pm) {
   if (options->passStatistics)
     pm.enableStatistics(options->passStatisticsDisplayMode);
 
+  // Enable memory profiling.
+  if (options->passMemoryProfile)
+    pm.enableMemoryProfiling();
+
   if (options->printModuleScope && pm.getContext()->isMultithreadingEnabled()) {
     emitError(UnknownLoc::get(pm.getContext()))
         << "IR print for module scope can't be setup on a pass-manager "
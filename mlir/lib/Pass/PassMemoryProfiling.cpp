@@ -0,0 +1,271 @@
+//===- PassMemoryProfiling.cpp --------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+#include "mlir/IR/Operation.h"
+#include "mlir/Pass/PassManager.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Threading.h"
+
+#include <mutex>
+
+using namespace mlir;
+using namespace mlir::detail;
+
+constexpr StringLiteral kMemoryProfileDescription =
+    "... Pass memory profile ...";
+
+//===----------------------------------------------------------------------===//
+// IR size estimation
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// The size of a piece of IR, and of the storage uniqued in the context.
+struct MemorySnapshot {
+  int64_t numOps = 0;
+  int64_t irBytes = 0;
+  int64_t numAttrs = 0;
+  int64_t attrBytes = 0;
+  int64_t numTypes = 0;
+  int64_t typeBytes = 0;
+
+  MemorySnapshot &operator-=(const MemorySnapshot &rhs) {
+    numOps -= rhs.numOps;
+    irBytes -= rhs.irBytes;
+    numAttrs -= rhs.numAttrs;
+    attrBytes -= rhs.attrBytes;
+    numTypes -= rhs.numTypes;
+    typeBytes -= rhs.typeBytes;
+    return *this;
+  }
+  MemorySnapshot &operator+=(const MemorySnapshot &rhs) {
+    numOps += rhs.numOps;
+    irBytes += rhs.irBytes;
+    numAttrs += rhs.numAttrs;
+    attrBytes += rhs.attrBytes;
+    numTypes += rhs.numTypes;
+    typeBytes += rhs.typeBytes;
+    return *this;
+  }
+};
+} // namespace
+
+/// Returns an estimate of the number of bytes allocated for `op` itself,
+/// excluding its regions.
+static int64_t estimateOpBytes(Operation *op) {
+  return sizeof(Operation) +
+         op->getNumResults() * sizeof(detail::OutOfLineOpResult) +
+         op->getNumOperands() * sizeof(OpOperand) +
+         op->getNumSuccessors() * sizeof(BlockOperand) +
+         op->getNumRegions() * sizeof(Region) +
+         op->getPropertiesStorageSize();
+}
+
+/// Takes a snapshot of the number of ops nested in `op`, including `op`, the
+/// approximate number of bytes allocated for them, and the storage uniqued in
+/// the context.
+static MemorySnapshot takeSnapshot(Operation *op) {
+  MemorySnapshot snapshot;
+  op->walk([&](Operation *nestedOp) {
+    ++snapshot.numOps;
+    snapshot.irBytes += estimateOpBytes(nestedOp);
+    for (Region &region : nestedOp->getRegions()) {
+      for (Block &block : region) {
+        snapshot.irBytes +=
+            sizeof(Block) +
+            block.getNumArguments() * sizeof(detail::BlockArgumentImpl);
+      }
+    }
+  });
+
+  MLIRContext *context = op->getContext();
+  StorageUniquer &attrUniquer = context->getAttributeUniquer();
+  StorageUniquer &typeUniquer = context->getTypeUniquer();
+  snapshot.numAttrs = attrUniquer.getNumParametricInstances();
+  snapshot.attrBytes = attrUniquer.getNumParametricBytesAllocated();
+  snapshot.numTypes = typeUniquer.getNumParametricInstances();
+  snapshot.typeBytes = typeUniquer.getNumParametricBytesAllocated();
+  return snapshot;
+}
+
+//===----------------------------------------------------------------------===//
+// PassMemoryProfiling
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// A node of the profile tree, which mirrors the structure of the pass
+/// pipeline. The deltas of all runs of a pass are accumulated in its node.
+struct ProfileNode {
+  std::string name;
+  uint64_t numRuns = 0;
+  MemorySnapshot delta;
+  llvm::MapVector<const void *, std::unique_ptr<ProfileNode>> children;
+
+  ProfileNode &getOrCreateChild(const void *id,
+                                function_ref<std::string()> nameFn) {
+    std::unique_ptr<ProfileNode> &child = children[id];
+    if (!child) {
+      child = std::make_unique<ProfileNode>();
+      child->name = nameFn();
+    }
+    return *child;
+  }
+};
+
+/// A pass that is currently running on some thread.
+struct ActivePass {
+  ProfileNode *node;
+  Operation *op;
+  MemorySnapshot before;
+};
+
+struct PassMemoryProfiling : public PassInstrumentation {
+  PassMemoryProfiling(raw_ostream &os) : os(os) {}
+  ~PassMemoryProfiling() override { print(); }
+
+  //===--------------------------------------------------------------------===//
+  // Pipeline
+  //===--------------------------------------------------------------------===//
+
+  void runBeforePipeline(std::optional<OperationName> name,
+                         const PipelineParentInfo &parentInfo) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &activeNodes = activeThreadNodes[llvm::get_threadid()];
+
+    // Nest the pipeline under the adaptor that spawned it, which may run on a
+    // different thread.
+    ProfileNode *parent = &root;
+    auto it = parentNodes.find(parentInfo);
+    if (it != parentNodes.end())
+      parent = it->second;
+
+    const void *id = name ? name->getAsOpaquePointer() : nullptr;
+    activeNodes.push_back(&parent->getOrCreateChild(id, [name] {
+      return ("'" + (name ? name->getStringRef() : "any") + "' Pipeline").str();
+    }));
+  }
+
+  void runAfterPipeline(std::optional<OperationName>,
+                        const PipelineParentInfo &) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &activeNodes = activeThreadNodes[llvm::get_threadid()];
+    assert(!activeNodes.empty() && "expected active pipeline");
+    activeNodes.pop_back();
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Pass
+  //===--------------------------------------------------------------------===//
+
+  void runBeforePass(Pass *pass, Operation *op) override {
+    // Walk the IR outside of the lock: passes running concurrently operate on
+    // disjoint, isolated operations.
+    MemorySnapshot before = takeSnapshot(op);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto tid = llvm::get_threadid();
+    auto &activeNodes = activeThreadNodes[tid];
+    ProfileNode *parent = activeNodes.empty() ? &root : activeNodes.back();
+    ProfileNode &node =
+        parent->getOrCreateChild(pass->getThreadingSiblingOrThis(), [pass] {
+          if (auto *adaptor = dyn_cast<OpToOpPassAdaptor>(pass))
+            return adaptor->getAdaptorName();
+          return std::string(pass->getName());
+        });
+    if (isa<OpToOpPassAdaptor>(pass))
+      parentNodes[{tid, pass}] = &node;
+    activeNodes.push_back(&node);
+    activePasses[tid].push_back({&node, op, before});
+  }
+
+  void runAfterPass(Pass *pass, Operation *op) override {
+    MemorySnapshot after = takeSnapshot(op);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto tid = llvm::get_threadid();
+    if (isa<OpToOpPassAdaptor>(pass))
+      parentNodes.erase({tid, pass});
+    auto &activeNodes = activeThreadNodes[tid];
+    assert(!activeNodes.empty() && "expected active pass");
+    activeNodes.pop_back();
+
+    auto &passes = activePasses[tid];
+    assert(!passes.empty() && passes.back().op == op && "expected active pass");
+    ActivePass active = passes.pop_back_val();
+    after -= active.before;
+    active.node->delta += after;
+    ++active.node->numRuns;
+  }
+
+  void runAfterPassFailed(Pass *pass, Operation *op) override {
+    runAfterPass(pass, op);
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Printing
+  //===--------------------------------------------------------------------===//
+
+  void print() {
+    if (root.children.empty())
+      return;
+    unsigned padding = (80 - kMemoryProfileDescription.size()) / 2;
+    os << "===" << std::string(73, '-') << "===\n";
+    os.indent(padding) << kMemoryProfileDescription << '\n';
+    os << "===" << std::string(73, '-') << "===\n";
+    os << "  ----Ops----  --IR Bytes--  ---Attributes---  -----Types------"
+          "  ----Name----\n";
+    for (auto &it : root.children)
+      printNode(*it.second, /*indent=*/0);
+    os.flush();
+  }
+
+  void printNode(const ProfileNode &node, unsigned indent) {
+    const MemorySnapshot &d = node.delta;
+    os << llvm::format("  %+11lld  %+12lld  %+6lld %+9lld  %+6lld %+9lld  ",
+                       (long long)d.numOps, (long long)d.irBytes,
+                       (long long)d.numAttrs, (long long)d.attrBytes,
+                       (long long)d.numTypes, (long long)d.typeBytes);
+    os.indent(indent) << node.name;
+    if (node.numRuns > 1)
+      os << " (" << node.numRuns << " runs)";
+    os << '\n';
+    for (auto &it : node.children)
+      printNode(*it.second, indent + 2);
+  }
+
+  /// The stream to print the profile to.
+  raw_ostream &os;
+
+  /// Guards the state below, which is updated from multiple threads.
+  std::mutex mutex;
+
+  /// The root of the profile tree.
+  ProfileNode root;
+
+  /// The nodes of the pipelines and passes that are currently active, per
+  /// thread.
+  DenseMap<uint64_t, SmallVector<ProfileNode *, 4>> activeThreadNodes;
+
+  /// The passes that are currently running, per thread.
+  DenseMap<uint64_t, SmallVector<ActivePass, 4>> activePasses;
+
+  /// The nodes of the currently running pass adaptors, used to nest pipelines
+  /// spawned on other threads.
+  DenseMap<PipelineParentInfo, ProfileNode *> parentNodes;
+};
+} // namespace
+
+//===----------------------------------------------------------------------===//
+// PassManager
+//===----------------------------------------------------------------------===//
+
+/// Add an instrumentation to profile the memory usage of passes.
+void PassManager::enableMemoryProfiling(raw_ostream &os) {
+  addInstrumentation(std::make_unique<PassMemoryProfiling>(os));
+}
@@ -229,7 +229,7 @@ LogicalResult PatternApplicator::matchAndRewrite(
           if (onFailure)
             onFailure(*bestPattern);
         },
-        {op}, *bestPattern);
+        {op}, *bestPattern, &matched);
     if (matched)
       break;
   } while (true);
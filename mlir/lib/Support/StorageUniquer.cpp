@@ -268,8 +268,16 @@ struct StorageUniquerImpl {
            "creating unregistered storage instance");
     ParametricStorageUniquer &storageUniquer = *parametricUniquers[id];
     return storageUniquer.getOrCreate(
-        threadingIsEnabled, hashValue, isEqual,
-        [&] { return ctorFn(getThreadSafeAllocator()); });
+        threadingIsEnabled, hashValue, isEqual, [&] {
+          StorageAllocator &allocator = getThreadSafeAllocator();
+          size_t bytesBefore = allocator.getBytesAllocated();
+          BaseStorage *storage = ctorFn(allocator);
+          numParametricInstances.fetch_add(1, std::memory_order_relaxed);
+          numParametricBytes.fetch_add(allocator.getBytesAllocated() -
+                                           bytesBefore,
+                                       std::memory_order_relaxed);
+          return storage;
+        });
   }
 
   /// Run a mutation function on the provided storage object in a thread-safe
@@ -281,7 +289,12 @@ struct StorageUniquerImpl {
            "mutating unregistered storage instance");
     ParametricStorageUniquer &storageUniquer = *parametricUniquers[id];
     return storageUniquer.mutate(threadingIsEnabled, storage, [&] {
-      return mutationFn(getThreadSafeAllocator());
+      StorageAllocator &allocator = getThreadSafeAllocator();
+      size_t bytesBefore = allocator.getBytesAllocated();
+      LogicalResult result = mutationFn(allocator);
+      numParametricBytes.fetch_add(allocator.getBytesAllocated() - bytesBefore,
+                                   std::memory_order_relaxed);
+      return result;
     });
   }
 
@@ -354,6 +367,13 @@ struct StorageUniquerImpl {
 
   /// Flag specifying if multi-threading is enabled within the uniquer.
   bool threadingIsEnabled = true;
+
+  /// The number of parametric instances created, and the number of bytes
+  /// allocated for them. The allocators are either thread local or only used
+  /// when multi-threading is disabled, so the number of bytes allocated by a
+  /// single construction can be computed without synchronization.
+  std::atomic<uint64_t> numParametricInstances = 0;
+  std::atomic<uint64_t> numParametricBytes = 0;
 };
 } // namespace detail
 } // namespace mlir
@@ -383,6 +403,14 @@ void StorageUniquer::registerParametricStorageTypeImpl(
       id, std::make_unique<ParametricStorageUniquer>(destructorFn));
 }
 
+uint64_t StorageUniquer::getNumParametricInstances() const {
+  return impl->numParametricInstances.load(std::memory_order_relaxed);
+}
+
+uint64_t StorageUniquer::getNumParametricBytesAllocated() const {
+  return impl->numParametricBytes.load(std::memory_order_relaxed);
+}
+
 /// Implementation for getting an instance of a derived type with default
 /// storage.
 auto StorageUniquer::getSingletonImpl(TypeID id) -> BaseStorage * {
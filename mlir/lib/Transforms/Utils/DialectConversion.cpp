@@ -568,15 +568,21 @@ private:
 };
 
 /// In-place modification of an op. This rewrite is immediately reflected in
-/// the IR. The previous state of the operation is stored in this object.
+/// the IR. The previous state of the operation is stored in this object,
+/// unless pattern rollback is disabled.
 class ModifyOperationRewrite : public OperationRewrite {
 public:
   ModifyOperationRewrite(ConversionPatternRewriterImpl &rewriterImpl,
                          Operation *op)
       : OperationRewrite(Kind::ModifyOperation, rewriterImpl, op),
-        name(op->getName()), loc(op->getLoc()), attrs(op->getAttrDictionary()),
-        operands(op->operand_begin(), op->operand_end()),
-        successors(op->successor_begin(), op->successor_end()) {
+        name(op->getName()) {
+    // Without rollback, the previous state is never restored.
+    if (!getConfig().allowPatternRollback)
+      return;
+    loc = op->getLoc();
+    attrs = op->getAttrDictionary();
+    operands.assign(op->operand_begin(), op->operand_end());
+    successors.assign(op->successor_begin(), op->successor_end());
     if (OpaqueProperties prop = op->getPropertiesStorage()) {
       // Make a copy of the properties.
       propertiesStorage = operator new(op->getPropertiesStorageSize());
@@ -611,6 +617,9 @@ public:
   }
 
   void rollback() override {
+    // No snapshot was taken: the modification is kept.
+    if (!getConfig().allowPatternRollback)
+      return;
     op->setLoc(loc);
     op->setAttrs(attrs);
     op->setOperands(operands);
@@ -804,6 +813,12 @@ struct ConversionPatternRewriterImpl : public RewriterBase::Listener {
   /// conversion process succeeds.
   void applyRewrites();
 
+  /// Commit and drop all rewrites that only need to inform the listener. This
+  /// is used when pattern rollback is disabled, so that the rewrite log does
+  /// not grow with the size of the input. Must not be called while a pattern
+  /// is being legalized, as that refers to rewrites by index.
+  void applyEagerRewrites();
+
   /// Reset the state of the rewriter to a previously saved point.
   void resetState(RewriterState state);
 
@@ -977,6 +992,10 @@ struct ConversionPatternRewriterImpl : public RewriterBase::Listener {
   /// Ordered list of block operations (creations, splits, motions).
   SmallVector<std::unique_ptr<IRRewrite>> rewrites;
 
+  /// The number of leading rewrites that were already visited by
+  /// `applyEagerRewrites` and must be kept until the end of the conversion.
+  unsigned numKeptRewrites = 0;
+
   /// A set of operations that should no longer be considered for legalization.
   /// E.g., ops that are recursively legal. Ops that were replaced/erased are
   /// tracked separately.
@@ -1201,6 +1220,28 @@ void ConversionPatternRewriterImpl::applyRewrites() {
     rewrite->cleanup(eraseRewriter);
 }
 
+void ConversionPatternRewriterImpl::applyEagerRewrites() {
+  assert(!config.allowPatternRollback &&
+         "rewrites can only be applied eagerly if rollback is disabled");
+  // Replacements, erasures, block signature conversions and materializations
+  // are still needed to finalize the conversion. Everything else is already
+  // reflected in the IR.
+  // Rewrites before `numKeptRewrites` were already scanned.
+  IRRewriter rewriter(context, config.listener);
+  auto it = std::remove_if(
+      rewrites.begin() + numKeptRewrites, rewrites.end(),
+      [&](std::unique_ptr<IRRewrite> &rewrite) {
+        if (!isa<CreateBlockRewrite, InlineBlockRewrite, MoveBlockRewrite,
+                 MoveOperationRewrite, ModifyOperationRewrite,
+                 CreateOperationRewrite>(rewrite.get()))
+          return false;
+        rewrite->commit(rewriter);
+        return true;
+      });
+  rewrites.erase(it, rewrites.end());
+  numKeptRewrites = rewrites.size();
+}
+
 //===----------------------------------------------------------------------===//
 // State Management
 
@@ -1225,6 +1266,7 @@ void ConversionPatternRewriterImpl::undoRewrites(unsigned numRewritesToKeep) {
        llvm::reverse(llvm::drop_begin(rewrites, numRewritesToKeep)))
     rewrite->rollback();
   rewrites.resize(numRewritesToKeep);
+  numKeptRewrites = std::min(numKeptRewrites, numRewritesToKeep);
 }
 
 LogicalResult ConversionPatternRewriterImpl::remapValues(
@@ -1799,6 +1841,12 @@ void ConversionPatternRewriter::finalizeOpModification(Operation *op) {
 }
 
 void ConversionPatternRewriter::cancelOpModification(Operation *op) {
+  // Without rollback, no snapshot of the op was taken, so the changes made
+  // since startOpModification cannot be undone.
+  if (!impl->config.allowPatternRollback)
+    llvm::report_fatal_error("cannot cancel the in-place modification of '" +
+                             op->getName().getStringRef() +
+                             "', pattern rollback is disabled");
 #ifndef NDEBUG
   assert(impl->pendingRootUpdates.erase(op) &&
          "operation did not have a pending in-place update");
@@ -2091,6 +2139,10 @@ OperationLegalizer::legalizeWithFold(Operation *op,
       LLVM_DEBUG(logFailure(rewriterImpl.logger,
                             "failed to legalize generated constant '{0}'",
                             createOp->getOperation()->getName()));
+      if (!config.allowPatternRollback)
+        llvm::report_fatal_error("folding produced a constant that could not "
+                                 "be legalized, but pattern rollback is "
+                                 "disabled");
       rewriterImpl.resetState(curState);
       return failure();
     }
@@ -2129,6 +2181,11 @@ OperationLegalizer::legalizeWithPattern(Operation *op,
     });
     if (config.listener)
       config.listener->notifyPatternEnd(pattern, failure());
+    if (!config.allowPatternRollback &&
+        rewriterImpl.rewrites.size() != curState.numRewrites)
+      llvm::report_fatal_error("pattern '" + pattern.getDebugName() +
+                               "' modified the IR and then failed, but pattern "
+                               "rollback is disabled");
     rewriterImpl.resetState(curState);
     appliedPatterns.erase(&pattern);
   };
@@ -2139,6 +2196,10 @@ OperationLegalizer::legalizeWithPattern(Operation *op,
     assert(rewriterImpl.pendingRootUpdates.empty() && "dangling root updates");
     auto result = legalizePatternResult(op, pattern, rewriter, curState);
     appliedPatterns.erase(&pattern);
+    if (failed(result) && !config.allowPatternRollback)
+      llvm::report_fatal_error("pattern '" + pattern.getDebugName() +
+                               "' produced IR that could not be legalized, but "
+                               "pattern rollback is disabled");
     if (failed(result))
       rewriterImpl.resetState(curState);
     if (config.listener)
@@ -2600,6 +2661,8 @@ LogicalResult OperationConverter::convert(ConversionPatternRewriter &rewriter,
 LogicalResult OperationConverter::convertOperations(ArrayRef<Operation *> ops) {
   if (ops.empty())
     return success();
+  assert((mode != OpConversionMode::Analysis || config.allowPatternRollback) &&
+         "analysis conversions require pattern rollback");
   const ConversionTarget &target = opLegalizer.getTarget();
 
   // Compute the set of operations and blocks to convert.
@@ -2621,9 +2684,12 @@ LogicalResult OperationConverter::convertOperations(ArrayRef<Operation *> ops) {
   ConversionPatternRewriter rewriter(ops.front()->getContext(), config);
   ConversionPatternRewriterImpl &rewriterImpl = rewriter.getImpl();
 
-  for (auto *op : toConvert)
+  for (auto *op : toConvert) {
     if (failed(convert(rewriter, op)))
       return rewriterImpl.undoRewrites(), failure();
+    if (!config.allowPatternRollback)
+      rewriterImpl.applyEagerRewrites();
+  }
 
   // Now that all of the operations have been converted, finalize the conversion
   // process to ensure any lingering conversion artifacts are cleaned up and
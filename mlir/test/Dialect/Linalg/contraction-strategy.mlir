@@ -0,0 +1,51 @@
+// RUN: mlir-opt %s -test-linalg-transform-patterns=test-contraction-strategy -split-input-file -verify-diagnostics
+
+// Without target parameters, the defaults are used: 256-bit vectors, 16 vector
+// registers, and 32KiB/1MiB/8MiB caches.
+
+func.func @default_target(%lhs: tensor<1024x1024xf32>, %rhs: tensor<1024x1024xf32>,
+                          %acc: tensor<1024x1024xf32>) -> tensor<1024x1024xf32> {
+  // expected-remark @below {{micro-kernel: [6, 16, 256], cache tiles: [510, 1024, 256]}}
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<1024x1024xf32>, tensor<1024x1024xf32>)
+                     outs(%acc : tensor<1024x1024xf32>) -> tensor<1024x1024xf32>
+  return %0 : tensor<1024x1024xf32>
+}
+
+// -----
+
+// The sizes are clamped to the loop ranges.
+
+func.func @small(%lhs: tensor<4x3xf32>, %rhs: tensor<3x5xf32>,
+                 %acc: tensor<4x5xf32>) -> tensor<4x5xf32> {
+  // expected-remark @below {{micro-kernel: [4, 5, 3], cache tiles: [4, 5, 3]}}
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<4x3xf32>, tensor<3x5xf32>)
+                     outs(%acc : tensor<4x5xf32>) -> tensor<4x5xf32>
+  return %0 : tensor<4x5xf32>
+}
+
+// -----
+
+// Target parameters come from the data layout: 512-bit vectors, 32 vector
+// registers and a 48KiB L1.
+
+module attributes {dlti.dl_spec = #dlti.dl_spec<
+    #dlti.dl_entry<"dlti.l1_cache_size_in_bytes", 49152 : i64>,
+    #dlti.dl_entry<"dlti.vector_size_in_bits", 512 : i64>,
+    #dlti.dl_entry<"dlti.num_vector_registers", 32 : i64>>} {
+  func.func @avx512_target(%lhs: tensor<2048x8192xf32>, %rhs: tensor<8192x4096xf32>,
+                           %acc: tensor<2048x4096xf32>) -> tensor<2048x4096xf32> {
+    // expected-remark @below {{micro-kernel: [14, 32, 192], cache tiles: [672, 4096, 192]}}
+    %0 = linalg.matmul ins(%lhs, %rhs : tensor<2048x8192xf32>, tensor<8192x4096xf32>)
+                       outs(%acc : tensor<2048x4096xf32>) -> tensor<2048x4096xf32>
+    return %0 : tensor<2048x4096xf32>
+  }
+}
+
+// -----
+
+func.func @not_a_contraction(%init: tensor<16x16xf32>) -> tensor<16x16xf32> {
+  %cst = arith.constant 0.0 : f32
+  // expected-remark @below {{no contraction strategy}}
+  %0 = linalg.fill ins(%cst : f32) outs(%init : tensor<16x16xf32>) -> tensor<16x16xf32>
+  return %0 : tensor<16x16xf32>
+}
@@ -0,0 +1,82 @@
+// RUN: mlir-opt %s -test-linalg-elementwise-fusion-patterns=fuse-generic-ops-cost-model -split-input-file | FileCheck %s
+
+#map = affine_map<(d0) -> (d0)>
+
+// A producer that is computed once per element is always worth fusing.
+
+// CHECK-LABEL: func @fuse_same_shape
+//       CHECK:   linalg.generic
+//       CHECK:     arith.addf
+//       CHECK:     arith.mulf
+//   CHECK-NOT:   linalg.generic
+func.func @fuse_same_shape(%a: tensor<16xf32>, %b: tensor<16xf32>) -> tensor<16xf32> {
+  %init = tensor.empty() : tensor<16xf32>
+  %0 = linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = ["parallel"]}
+      ins(%a, %b : tensor<16xf32>, tensor<16xf32>) outs(%init : tensor<16xf32>) {
+  ^bb0(%x: f32, %y: f32, %out: f32):
+    %1 = arith.addf %x, %y : f32
+    linalg.yield %1 : f32
+  } -> tensor<16xf32>
+  %2 = linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = ["parallel"]}
+      ins(%0, %b : tensor<16xf32>, tensor<16xf32>) outs(%init : tensor<16xf32>) {
+  ^bb0(%x: f32, %y: f32, %out: f32):
+    %3 = arith.mulf %x, %y : f32
+    linalg.yield %3 : f32
+  } -> tensor<16xf32>
+  return %2 : tensor<16xf32>
+}
+
+// -----
+
+#map = affine_map<(d0) -> (d0)>
+#bcast = affine_map<(d0, d1) -> (d1)>
+#id = affine_map<(d0, d1) -> (d0, d1)>
+
+// Broadcasting the producer recomputes each of its elements 8 times. That is
+// cheap enough for a negation, but not for an exponential.
+
+// CHECK-LABEL: func @fuse_cheap_broadcast
+//       CHECK:   linalg.generic
+//       CHECK:     arith.negf
+//       CHECK:     arith.addf
+//   CHECK-NOT:   linalg.generic
+func.func @fuse_cheap_broadcast(%a: tensor<64xf32>, %b: tensor<8x64xf32>) -> tensor<8x64xf32> {
+  %init0 = tensor.empty() : tensor<64xf32>
+  %0 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel"]}
+      ins(%a : tensor<64xf32>) outs(%init0 : tensor<64xf32>) {
+  ^bb0(%x: f32, %out: f32):
+    %1 = arith.negf %x : f32
+    linalg.yield %1 : f32
+  } -> tensor<64xf32>
+  %init1 = tensor.empty() : tensor<8x64xf32>
+  %2 = linalg.generic {indexing_maps = [#bcast, #id, #id], iterator_types = ["parallel", "parallel"]}
+      ins(%0, %b : tensor<64xf32>, tensor<8x64xf32>) outs(%init1 : tensor<8x64xf32>) {
+  ^bb0(%x: f32, %y: f32, %out: f32):
+    %3 = arith.addf %x, %y : f32
+    linalg.yield %3 : f32
+  } -> tensor<8x64xf32>
+  return %2 : tensor<8x64xf32>
+}
+
+// CHECK-LABEL: func @keep_expensive_broadcast
+//       CHECK:   linalg.generic
+//       CHECK:     math.exp
+//       CHECK:   linalg.generic
+//       CHECK:     arith.addf
+func.func @keep_expensive_broadcast(%a: tensor<64xf32>, %b: tensor<8x64xf32>) -> tensor<8x64xf32> {
+  %init0 = tensor.empty() : tensor<64xf32>
+  %0 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel"]}
+      ins(%a : tensor<64xf32>) outs(%init0 : tensor<64xf32>) {
+  ^bb0(%x: f32, %out: f32):
+    %1 = math.exp %x : f32
+    linalg.yield %1 : f32
+  } -> tensor<64xf32>
+  %init1 = tensor.empty() : tensor<8x64xf32>
+  %2 = linalg.generic {indexing_maps = [#bcast, #id, #id], iterator_types = ["parallel", "parallel"]}
+      ins(%0, %b : tensor<64xf32>, tensor<8x64xf32>) outs(%init1 : tensor<8x64xf32>) {
+  ^bb0(%x: f32, %y: f32, %out: f32):
+    %3 = arith.addf %x, %y : f32
+    linalg.yield %3 : f32
+  } -> tensor<8x64xf32>
+  return %2 : tensor<8x64xf32>
+}
@@ -113,6 +113,12 @@ struct TestLinalgElementwiseFusion
           "Test fusion of generic operations with a control function."),
       llvm::cl::init(false)};
 
+  Option<bool> fuseGenericOpsCostModel{
+      *this, "fuse-generic-ops-cost-model",
+      llvm::cl::desc("Test fusion of generic operations controlled by the "
+                     "default cost model."),
+      llvm::cl::init(false)};
+
   Option<bool> fuseWithReshapeByExpansion{
       *this, "fuse-with-reshape-by-expansion",
       llvm::cl::desc(
@@ -172,6 +178,16 @@ struct TestLinalgElementwiseFusion
       return;
     }
 
+    if (fuseGenericOpsCostModel) {
+      RewritePatternSet fusionPatterns(context);
+      linalg::populateElementwiseOpsFusionPatterns(
+          fusionPatterns, linalg::getElementwiseFusionCostModelControlFn());
+      if (failed(applyPatternsAndFoldGreedily(funcOp.getBody(),
+                                              std::move(fusionPatterns))))
+        return signalPassFailure();
+      return;
+    }
+
     if (fuseWithReshapeByExpansion) {
       RewritePatternSet fusionPatterns(context);
       linalg::populateFoldReshapeOpsByExpansionPatterns(
@@ -123,6 +123,11 @@ struct TestLinalgTransforms
       *this, "test-erase-unnecessary-inputs",
       llvm::cl::desc("Test patterns to erase unnecessary inputs"),
       llvm::cl::init(false)};
+  Option<bool> testContractionStrategy{
+      *this, "test-contraction-strategy",
+      llvm::cl::desc("Test the contraction strategy derived from the target "
+                     "parameters of the data layout"),
+      llvm::cl::init(false)};
 };
 } // namespace
 
@@ -207,6 +212,20 @@ static void applyEraseUnnecessaryInputs(func::FuncOp funcOp) {
   (void)applyPatternsAndFoldGreedily(funcOp, std::move(patterns));
 }
 
+static void applyContractionStrategy(func::FuncOp funcOp) {
+  funcOp.walk([](LinalgOp linalgOp) {
+    FailureOr<ContractionStrategy> strategy = computeContractionStrategy(
+        linalgOp, ContractionTargetInfo::get(linalgOp));
+    if (failed(strategy)) {
+      linalgOp->emitRemark("no contraction strategy");
+      return;
+    }
+    linalgOp->emitRemark("micro-kernel: [")
+        << strategy->mnkPackedSizes << "], cache tiles: ["
+        << strategy->mnkCacheTileSizes << "]";
+  });
+}
+
 /// Apply transformations specified as patterns.
 void TestLinalgTransforms::runOnOperation() {
   if (testPatterns)
@@ -231,6 +250,8 @@ void TestLinalgTransforms::runOnOperation() {
     return applyEraseUnusedOperandsAndResultsPatterns(getOperation());
   if (testEraseUnnecessaryInputs)
     return applyEraseUnnecessaryInputs(getOperation());
+  if (testContractionStrategy)
+    return applyContractionStrategy(getOperation());
 }
 
 namespace mlir {
@@ -16,7 +16,9 @@
 
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Endian.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/MemoryBufferRef.h"
+#include "llvm/Support/SourceMgr.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -89,6 +91,69 @@ TEST(Bytecode, MultiModuleWithResource) {
   checkResourceAttribute(*roundTripModule);
 }
 
+TEST(Bytecode, ResourceBlobCopyOnWrite) {
+  MLIRContext context;
+  ParserConfig parseConfig(&context);
+  OwningOpRef<Operation *> module =
+      parseSourceString<Operation *>(irWithResources, parseConfig);
+  ASSERT_TRUE(module);
+
+  // FIXME: Parsing external resources does not work on big-endian
+  // platforms currently.
+  if (llvm::endianness::native == llvm::endianness::big)
+    GTEST_SKIP();
+
+  // Write the module to an aligned buffer that is owned by a source manager.
+  std::string buffer;
+  llvm::raw_string_ostream ostream(buffer);
+  ASSERT_TRUE(succeeded(writeBytecodeToFile(module.get(), ostream)));
+  ostream.flush();
+  std::unique_ptr<llvm::WritableMemoryBuffer> memBuffer =
+      llvm::WritableMemoryBuffer::getNewUninitMemBuffer(buffer.size(),
+                                                        "bytecode");
+  llvm::copy(buffer, memBuffer->getBufferStart());
+  ArrayRef<char> bufferData(memBuffer->getBufferStart(),
+                            memBuffer->getBufferSize());
+  auto sourceMgr = std::make_shared<llvm::SourceMgr>();
+  sourceMgr->AddNewSourceBuffer(std::move(memBuffer), llvm::SMLoc());
+
+  // Parse it back in a fresh context, so that the resource is loaded from the
+  // bytecode instead of being shared with the original module.
+  MLIRContext roundTripContext;
+  ParserConfig roundTripConfig(&roundTripContext);
+  OwningOpRef<Operation *> roundTripModule =
+      parseSourceFile<Operation *>(sourceMgr, roundTripConfig);
+  ASSERT_TRUE(roundTripModule);
+
+  auto attr = dyn_cast_or_null<DenseI32ResourceElementsAttr>(
+      roundTripModule->getDiscardableAttr("bytecode.test"));
+  ASSERT_TRUE(attr);
+  AsmResourceBlob *blob = attr.getRawHandle().getBlob();
+  ASSERT_TRUE(blob);
+
+  // The blob references the bytecode buffer directly, and keeps it alive.
+  ArrayRef<char> blobData = blob->getData();
+  EXPECT_FALSE(blob->isMutable());
+  EXPECT_GE(blobData.data(), bufferData.begin());
+  EXPECT_LE(blobData.end(), bufferData.end());
+  long useCount = sourceMgr.use_count();
+  EXPECT_GT(useCount, 1);
+
+  // Writing to the blob copies the data out of the buffer, and releases the
+  // reference to it.
+  MutableArrayRef<char> mutableData = blob->getMutableDataCopyOnWrite();
+  EXPECT_TRUE(blob->isMutable());
+  EXPECT_NE(mutableData.data(), blobData.data());
+  EXPECT_EQ(ArrayRef<char>(mutableData), blobData);
+  EXPECT_EQ(sourceMgr.use_count(), useCount - 1);
+  mutableData[0] = 42;
+  EXPECT_NE(blobData[0], 42);
+  EXPECT_EQ((*attr.tryGetAsArrayRef())[0], 42);
+
+  // Subsequent writes reuse the copy.
+  EXPECT_EQ(blob->getMutableDataCopyOnWrite().data(), mutableData.data());
+}
+
 namespace {
 /// A custom operation for the purpose of showcasing how discardable attributes
 /// are handled in absence of properties.
@@ -148,3 +213,63 @@ TEST(Bytecode, OpWithoutProperties) {
   EXPECT_TRUE(OperationEquivalence::computeHash(op.get()) ==
               OperationEquivalence::computeHash(roundtripped));
 }
+
+constexpr StringLiteral isolatedRegionsSrc = R"mlir(
+module {
+  module @a {
+    %0 = "test.def"() : () -> i32
+    "test.use"(%0) {idx = 0 : i32} : (i32) -> ()
+    "test.use"(%0) {idx = 1 : i32} : (i32) -> ()
+    "test.use"(%0) {idx = 2 : i32} : (i32) -> ()
+  }
+  module @b {
+    %0 = "test.def"() : () -> i64
+    "test.use"(%0, %0) : (i64, i64) -> ()
+  }
+}
+)mlir";
+
+/// Return the value defined at the start of the first nested module.
+static Value getFirstNestedValue(Operation *op) {
+  Operation *nested = &op->getRegion(0).front().front();
+  return nested->getRegion(0).front().front().getResult(0);
+}
+
+TEST(Bytecode, ParallelIsolatedRegions) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  ParserConfig config(&context);
+  OwningOpRef<Operation *> op = parseSourceString(isolatedRegionsSrc, config);
+  ASSERT_TRUE(op);
+
+  // Give the value a use-list order that has to be encoded in the bytecode.
+  getFirstNestedValue(op.get()).shuffleUseList({2, 0, 1});
+  auto getUseOrder = [](Operation *op) {
+    SmallVector<int64_t> order;
+    for (Operation *user : getFirstNestedValue(op).getUsers())
+      order.push_back(cast<IntegerAttr>(user->getAttr("idx")).getInt());
+    return order;
+  };
+  auto print = [](Operation *op) {
+    std::string str;
+    llvm::raw_string_ostream os(str);
+    op->print(os);
+    return str;
+  };
+
+  std::string bytecode;
+  llvm::raw_string_ostream os(bytecode);
+  ASSERT_TRUE(succeeded(writeBytecodeToFile(op.get(), os)));
+
+  // The nested modules are parsed in parallel if multithreading is enabled,
+  // which must not make a difference.
+  for (bool enableThreading : {true, false}) {
+    context.disableMultithreading(!enableThreading);
+    Block block;
+    ASSERT_TRUE(succeeded(readBytecodeFile(
+        llvm::MemoryBufferRef(os.str(), "string-buffer"), &block, config)));
+    Operation *roundtripped = &block.front();
+    EXPECT_EQ(print(op.get()), print(roundtripped));
+    EXPECT_EQ(getUseOrder(op.get()), getUseOrder(roundtripped));
+  }
+}
@@ -0,0 +1,86 @@
+//===- PatternProfilerTest.cpp - Per-pattern statistics -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Debug/Observers/PatternProfiler.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Rewrite/PatternApplicator.h"
+#include "gmock/gmock.h"
+
+#include <thread>
+
+using namespace mlir;
+using namespace mlir::tracing;
+
+namespace {
+struct TestPattern : public RewritePattern {
+  TestPattern(MLIRContext *context, StringRef name = "TestPattern")
+      : RewritePattern(MatchAnyOpTypeTag(), /*benefit=*/1, context) {
+    setDebugName(name);
+  }
+  LogicalResult matchAndRewrite(Operation *op,
+                                PatternRewriter &rewriter) const override {
+    return failure();
+  }
+};
+
+TEST(PatternProfiler, CountsAttemptsAndApplications) {
+  MLIRContext context;
+  ExecutionContext executionContext;
+  PatternProfiler profiler;
+  executionContext.registerObserver(&profiler);
+  context.registerActionHandler(executionContext);
+
+  TestPattern pattern(&context);
+  for (bool applied : {false, true, false})
+    context.executeAction<ApplyPatternAction>([] {}, {}, pattern, &applied);
+
+  const PatternProfiler::PatternStatistics *stats =
+      profiler.lookup("TestPattern");
+  ASSERT_NE(stats, nullptr);
+  EXPECT_EQ(stats->numAttempts, 3u);
+  EXPECT_EQ(stats->numApplied, 1u);
+  EXPECT_EQ(profiler.lookup("OtherPattern"), nullptr);
+
+  std::string report;
+  llvm::raw_string_ostream os(report);
+  profiler.print(os);
+  EXPECT_THAT(report, testing::HasSubstr("Pattern profile"));
+  EXPECT_THAT(report, testing::HasSubstr("TestPattern"));
+}
+
+TEST(PatternProfiler, ExcludesNestedApplications) {
+  MLIRContext context;
+  ExecutionContext executionContext;
+  PatternProfiler profiler;
+  executionContext.registerObserver(&profiler);
+  context.registerActionHandler(executionContext);
+
+  TestPattern outer(&context, "Outer"), inner(&context, "Inner");
+  bool applied = true;
+  auto start = std::chrono::steady_clock::now();
+  context.executeAction<ApplyPatternAction>(
+      [&] {
+        context.executeAction<ApplyPatternAction>(
+            [] { std::this_thread::sleep_for(std::chrono::milliseconds(20)); },
+            {}, inner, &applied);
+      },
+      {}, outer, &applied);
+  std::chrono::nanoseconds wallTime = std::chrono::steady_clock::now() - start;
+
+  const PatternProfiler::PatternStatistics *outerStats =
+      profiler.lookup("Outer");
+  const PatternProfiler::PatternStatistics *innerStats =
+      profiler.lookup("Inner");
+  ASSERT_NE(outerStats, nullptr);
+  ASSERT_NE(innerStats, nullptr);
+  EXPECT_GE(innerStats->appliedTime, std::chrono::milliseconds(20));
+  EXPECT_LT(outerStats->appliedTime, innerStats->appliedTime);
+  EXPECT_LE(outerStats->appliedTime + innerStats->appliedTime, wallTime);
+}
+} // namespace
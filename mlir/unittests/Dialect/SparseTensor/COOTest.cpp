@@ -0,0 +1,74 @@
+//===- COOTest.cpp - Tests for the coordinate-scheme sparse tensor --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/ExecutionEngine/SparseTensor/COO.h"
+#include "gtest/gtest.h"
+
+using namespace mlir::sparse_tensor;
+
+namespace {
+
+/// Returns the coordinates of the elements of `coo`, in order.
+std::vector<std::vector<uint64_t>>
+getCoordinates(const SparseTensorCOO<double> &coo) {
+  std::vector<std::vector<uint64_t>> result;
+  for (const Element<double> &e : coo.getElements())
+    result.emplace_back(e.coords, e.coords + coo.getRank());
+  return result;
+}
+
+/// Fills two tensors of the given sizes with the same `n` pseudo-random
+/// elements. The coordinates of the last dimension are multiples of
+/// `lastStride`.
+void fill(SparseTensorCOO<double> &coo1, SparseTensorCOO<double> &coo2,
+          uint64_t n, uint64_t lastStride = 1) {
+  const std::vector<uint64_t> &dimSizes = coo1.getDimSizes();
+  const uint64_t rank = dimSizes.size();
+  uint64_t state = 42;
+  std::vector<uint64_t> coords(rank);
+  for (uint64_t i = 0; i < n; ++i) {
+    for (uint64_t d = 0; d < rank; ++d) {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      uint64_t size = d == rank - 1 ? dimSizes[d] / lastStride : dimSizes[d];
+      coords[d] = (state >> 33) % size * (d == rank - 1 ? lastStride : 1);
+    }
+    coo1.add(coords, i);
+    coo2.add(coords, i);
+  }
+}
+
+TEST(SparseTensorCOO, CoordBitWidth) {
+  EXPECT_EQ(detail::getCoordBitWidth(0), 0u);
+  EXPECT_EQ(detail::getCoordBitWidth(1), 0u);
+  EXPECT_EQ(detail::getCoordBitWidth(2), 1u);
+  EXPECT_EQ(detail::getCoordBitWidth(256), 8u);
+  EXPECT_EQ(detail::getCoordBitWidth(257), 9u);
+}
+
+TEST(SparseTensorCOO, ParallelSortMatchesSerialSort) {
+  // The key takes 2 + 0 + 10 + 9 bits, so it is sorted in three passes.
+  const std::vector<uint64_t> dimSizes = {3, 1, 1000, 300};
+  SparseTensorCOO<double> serial(dimSizes), parallel(dimSizes);
+  fill(serial, parallel, 2 * detail::kParallelSortThreshold);
+  serial.sort(1);
+  parallel.sort(4);
+  EXPECT_EQ(getCoordinates(serial), getCoordinates(parallel));
+}
+
+TEST(SparseTensorCOO, ParallelSortSkipsUniformDigits) {
+  // All the keys have the same lowest digit, whose pass is skipped.
+  const std::vector<uint64_t> dimSizes = {512, 1 << 16};
+  SparseTensorCOO<double> serial(dimSizes), parallel(dimSizes);
+  fill(serial, parallel, 2 * detail::kParallelSortThreshold,
+       /*lastStride=*/256);
+  serial.sort(1);
+  parallel.sort(3);
+  EXPECT_EQ(getCoordinates(serial), getCoordinates(parallel));
+}
+
+} // namespace
@@ -281,4 +281,62 @@ TEST(PassManagerTest, PassInitialization) {
   EXPECT_TRUE(succeeded(pm.run(module.get())));
 }
 
+/// Simple pass that adds a private function with a new name to the module.
+struct AddFunctionModulePass
+    : public PassWrapper<AddFunctionModulePass, OperationPass<ModuleOp>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(AddFunctionModulePass)
+
+  void runOnOperation() override {
+    ModuleOp module = getOperation();
+    OpBuilder builder = OpBuilder::atBlockEnd(module.getBody());
+    auto func = builder.create<func::FuncOp>(
+        builder.getUnknownLoc(), "memory_profile_new_function",
+        builder.getFunctionType(std::nullopt, std::nullopt));
+    func.setPrivate();
+  }
+};
+
+TEST(PassManagerTest, MemoryProfiling) {
+  MLIRContext context;
+  context.loadDialect<func::FuncDialect>();
+  OwningOpRef<ModuleOp> module(ModuleOp::create(UnknownLoc::get(&context)));
+
+  std::string profile;
+  {
+    llvm::raw_string_ostream os(profile);
+    auto pm = PassManager::on<ModuleOp>(&context);
+    pm.addPass(std::make_unique<AddFunctionModulePass>());
+    pm.addNestedPass<func::FuncOp>(std::make_unique<AddAttrFunctionPass>());
+    pm.enableMemoryProfiling(os);
+    EXPECT_TRUE(succeeded(pm.run(module.get())));
+    // The profile is printed when the pass manager is destroyed.
+    EXPECT_TRUE(profile.empty());
+  }
+
+  // Find the line of the profile that reports on the given pass.
+  auto getLine = [&](StringRef passName) {
+    SmallVector<StringRef> lines;
+    StringRef(profile).split(lines, '\n');
+    for (StringRef line : lines)
+      if (line.contains(passName))
+        return line;
+    return StringRef();
+  };
+
+  // The module pass adds one op, with a new symbol name attribute.
+  StringRef addFunction = getLine("AddFunctionModulePass");
+  ASSERT_FALSE(addFunction.empty()) << profile;
+  SmallVector<StringRef> columns;
+  addFunction.split(columns, ' ', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  ASSERT_GE(columns.size(), 7u);
+  EXPECT_EQ(columns[0], "+1");
+  EXPECT_NE(columns[2], "+0");
+
+  // The function pass only adds attributes, and is nested in the adaptor.
+  StringRef addAttr = getLine("AddAttrFunctionPass");
+  ASSERT_FALSE(addAttr.empty()) << profile;
+  EXPECT_TRUE(addAttr.ltrim().starts_with("+0 ")) << profile;
+  EXPECT_FALSE(getLine("'func.func' Pipeline").empty()) << profile;
+}
+
 } // namespace
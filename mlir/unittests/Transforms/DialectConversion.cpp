@@ -133,4 +133,87 @@ TEST(DialectConversionTest, DynamicallyLegalUnknownReturnNone) {
 
   op->destroy();
 }
+
+struct MarkConvertedPattern : public ConversionPattern {
+  MarkConvertedPattern(MLIRContext *context)
+      : ConversionPattern("foo.bar", /*benefit=*/1, context) {}
+
+  LogicalResult
+  matchAndRewrite(Operation *op, ArrayRef<Value> operands,
+                  ConversionPatternRewriter &rewriter) const override {
+    rewriter.modifyOpInPlace(
+        op, [&] { op->setAttr("converted", rewriter.getUnitAttr()); });
+    return success();
+  }
+};
+
+struct CancelModificationPattern : public ConversionPattern {
+  CancelModificationPattern(MLIRContext *context)
+      : ConversionPattern("foo.bar", /*benefit=*/1, context) {}
+
+  LogicalResult
+  matchAndRewrite(Operation *op, ArrayRef<Value> operands,
+                  ConversionPatternRewriter &rewriter) const override {
+    rewriter.startOpModification(op);
+    op->setAttr("converted", rewriter.getUnitAttr());
+    rewriter.cancelOpModification(op);
+    return failure();
+  }
+};
+
+struct CountingListener : public RewriterBase::Listener {
+  void notifyOperationModified(Operation *op) override { ++numModified; }
+  int numModified = 0;
+};
+
+TEST(DialectConversionTest, ConversionWithoutRollback) {
+  MLIRContext context;
+  ConversionTarget target(context);
+  target.addDynamicallyLegalOp<DummyOp>(
+      [](Operation *op) { return op->hasAttr("converted"); });
+
+  RewritePatternSet patterns(&context);
+  patterns.add<MarkConvertedPattern>(&context);
+  FrozenRewritePatternSet frozenPatterns(std::move(patterns));
+
+  CountingListener listener;
+  ConversionConfig config;
+  config.allowPatternRollback = false;
+  config.listener = &listener;
+
+  auto *op = createOp(&context);
+  EXPECT_TRUE(
+      succeeded(applyFullConversion(op, target, frozenPatterns, config)));
+  EXPECT_TRUE(op->hasAttr("converted"));
+  EXPECT_EQ(1, listener.numModified);
+
+  op->destroy();
+}
+
+TEST(DialectConversionTest, CancelModificationWithoutRollback) {
+  MLIRContext context;
+  ConversionTarget target(context);
+  target.addDynamicallyLegalOp<DummyOp>(
+      [](Operation *op) { return op->hasAttr("converted"); });
+
+  RewritePatternSet patterns(&context);
+  patterns.add<CancelModificationPattern>(&context);
+  FrozenRewritePatternSet frozenPatterns(std::move(patterns));
+
+  auto *op = createOp(&context);
+
+  // With rollback, the modification is undone.
+  EXPECT_TRUE(failed(applyFullConversion(op, target, frozenPatterns)));
+  EXPECT_FALSE(op->hasAttr("converted"));
+
+  // Without rollback, it could not be undone, so it is a fatal error.
+  ConversionConfig config;
+  config.allowPatternRollback = false;
+  ASSERT_DEATH(
+      (void)applyFullConversion(op, target, frozenPatterns, config),
+      "cannot cancel the in-place modification of 'foo.bar', pattern "
+      "rollback is disabled");
+
+  op->destroy();
+}
 } // namespace
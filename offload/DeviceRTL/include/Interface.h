@@ -244,6 +244,27 @@ int32_t __kmpc_nvptx_teams_reduce_nowait_v2(
     uint64_t reduce_data_size, void *reduce_data, ShuffleReductFnTy shflFct,
     InterWarpCopyFnTy cpyFct, ListGlobalFnTy lgcpyFct, ListGlobalFnTy lgredFct,
     ListGlobalFnTy glcpyFct, ListGlobalFnTy glredFct);
+
+/// Combine the value \p V of every calling thread of every team into \p
+/// *Result using warp shuffles and hardware atomics. The array versions
+/// combine the \p N elements of \p Partial element-wise into \p Result.
+/// \p *Result has to be initialized by the caller.
+#define XTEAM_REDUCE(OP, SUFFIX, TY)                                           \
+  void __kmpc_xteam_reduce_##OP##_##SUFFIX(TY *Result, TY V);                  \
+  void __kmpc_xteam_reduce_##OP##_array_##SUFFIX(TY *Result, TY *Partial,      \
+                                                 uint64_t N);
+#define XTEAM_REDUCE_ALL_OPS(SUFFIX, TY)                                       \
+  XTEAM_REDUCE(add, SUFFIX, TY)                                                \
+  XTEAM_REDUCE(min, SUFFIX, TY)                                                \
+  XTEAM_REDUCE(max, SUFFIX, TY)
+XTEAM_REDUCE_ALL_OPS(i32, int32_t)
+XTEAM_REDUCE_ALL_OPS(u32, uint32_t)
+XTEAM_REDUCE_ALL_OPS(i64, int64_t)
+XTEAM_REDUCE_ALL_OPS(u64, uint64_t)
+XTEAM_REDUCE_ALL_OPS(f32, float)
+XTEAM_REDUCE_ALL_OPS(f64, double)
+#undef XTEAM_REDUCE_ALL_OPS
+#undef XTEAM_REDUCE
 ///}
 
 /// Synchronization
@@ -164,6 +164,69 @@ uint32_t roundToWarpsize(uint32_t s) {
 
 uint32_t kmpcMin(uint32_t x, uint32_t y) { return x < y ? x : y; }
 
+/// Shuffle \p V down by \p Delta lanes within a full warp.
+template <typename Ty> Ty shuffleDown(Ty V, uint32_t Delta) {
+  static_assert(sizeof(Ty) == 4 || sizeof(Ty) == 8, "Unsupported type");
+  if constexpr (sizeof(Ty) == 4) {
+    int32_t I = utils::convertViaPun<int32_t>(V);
+    I = utils::shuffleDown(lanes::All, I, Delta, mapping::getWarpSize());
+    return utils::convertViaPun<Ty>(I);
+  } else {
+    uint32_t Lo, Hi;
+    utils::unpack(utils::convertViaPun<uint64_t>(V), Lo, Hi);
+    Lo = utils::shuffleDown(lanes::All, Lo, Delta, mapping::getWarpSize());
+    Hi = utils::shuffleDown(lanes::All, Hi, Delta, mapping::getWarpSize());
+    return utils::convertViaPun<Ty>(utils::pack(Lo, Hi));
+  }
+}
+
+template <typename Ty> struct AddOpTy {
+  static Ty combine(Ty LHS, Ty RHS) { return LHS + RHS; }
+  static void update(Ty *Addr, Ty V) {
+    atomic::add(Addr, V, atomic::relaxed);
+  }
+};
+
+template <typename Ty> struct MinOpTy {
+  static Ty combine(Ty LHS, Ty RHS) { return LHS < RHS ? LHS : RHS; }
+  static void update(Ty *Addr, Ty V) {
+    atomic::min(Addr, V, atomic::relaxed);
+  }
+};
+
+template <typename Ty> struct MaxOpTy {
+  static Ty combine(Ty LHS, Ty RHS) { return LHS > RHS ? LHS : RHS; }
+  static void update(Ty *Addr, Ty V) {
+    atomic::max(Addr, V, atomic::relaxed);
+  }
+};
+
+/// Combine the values \p V of all threads of all teams into \p *Result. A
+/// full warp first reduces its values with shuffles in a tree and only the
+/// first lane updates \p *Result with a hardware atomic, so there is no
+/// global buffer, no team counter, and no serial tail in the last team. If
+/// the warp is not full, every active lane updates \p *Result itself.
+template <typename Ty, typename OpTy> void xteamReduce(Ty *Result, Ty V) {
+  if (utils::popc(mapping::activemask()) != mapping::getWarpSize()) {
+    OpTy::update(Result, V);
+    return;
+  }
+
+  for (uint32_t Delta = mapping::getWarpSize() / 2; Delta > 0; Delta /= 2)
+    V = OpTy::combine(V, shuffleDown(V, Delta));
+
+  if (mapping::getThreadIdInWarp() == 0)
+    OpTy::update(Result, V);
+}
+
+/// Combine the \p N element arrays \p Partial of all threads of all teams
+/// element-wise into \p Result. See xteamReduce.
+template <typename Ty, typename OpTy>
+void xteamReduceArray(Ty *Result, const Ty *Partial, uint64_t N) {
+  for (uint64_t I = 0; I < N; ++I)
+    xteamReduce<Ty, OpTy>(&Result[I], Partial[I]);
+}
+
 } // namespace
 
 extern "C" {
@@ -316,4 +379,30 @@ void *__kmpc_reduction_get_fixed_buffer() {
   return state::getKernelLaunchEnvironment().ReductionBuffer;
 }
 
+#define XTEAM_REDUCE(OP, OPTY, SUFFIX, TY)                                     \
+  void __kmpc_xteam_reduce_##OP##_##SUFFIX(TY *Result, TY V) {                 \
+    xteamReduce<TY, OPTY<TY>>(Result, V);                                      \
+  }                                                                            \
+  void __kmpc_xteam_reduce_##OP##_array_##SUFFIX(TY *Result, TY *Partial,      \
+                                                 uint64_t N) {                 \
+    xteamReduceArray<TY, OPTY<TY>>(Result, Partial, N);                        \
+  }
+
+#define XTEAM_REDUCE_ALL_OPS(SUFFIX, TY)                                       \
+  XTEAM_REDUCE(add, AddOpTy, SUFFIX, TY)                                       \
+  XTEAM_REDUCE(min, MinOpTy, SUFFIX, TY)                                       \
+  XTEAM_REDUCE(max, MaxOpTy, SUFFIX, TY)
+
+extern "C" {
+XTEAM_REDUCE_ALL_OPS(i32, int32_t)
+XTEAM_REDUCE_ALL_OPS(u32, uint32_t)
+XTEAM_REDUCE_ALL_OPS(i64, int64_t)
+XTEAM_REDUCE_ALL_OPS(u64, uint64_t)
+XTEAM_REDUCE_ALL_OPS(f32, float)
+XTEAM_REDUCE_ALL_OPS(f64, double)
+}
+
+#undef XTEAM_REDUCE_ALL_OPS
+#undef XTEAM_REDUCE
+
 #pragma omp end declare target
@@ -15,26 +15,35 @@
 #include <cstddef>
 #include <cstdint>
 #include <mutex>
+#include <shared_mutex>
 
-/// Forward declaration.
+/// Forward declarations.
 template <typename Ty> struct Accessor;
+template <typename Ty> struct SharedAccessor;
 
 /// A protected object is a simple wrapper to allocate an object of type \p Ty
 /// together with a mutex that guards accesses to the object. The only way to
-/// access the object is through the "exclusive accessor" which will lock the
-/// mutex accordingly.
+/// access the object is through the "exclusive accessor" or the read-only
+/// "shared accessor" which will lock the mutex accordingly. Any number of
+/// shared accessors can coexist, but never together with an exclusive one.
 template <typename Ty> struct ProtectedObj {
   using AccessorTy = Accessor<Ty>;
+  using SharedAccessorTy = SharedAccessor<Ty>;
 
   /// Get an exclusive access Accessor object. \p DoNotGetAccess allows to
   /// create an accessor that is not owning anything based on a boolean
   /// condition.
   AccessorTy getExclusiveAccessor(bool DoNotGetAccess = false);
 
+  /// Get a read-only SharedAccessor object. \p DoNotGetAccess works as for
+  /// getExclusiveAccessor.
+  SharedAccessorTy getSharedAccessor(bool DoNotGetAccess = false);
+
 private:
   Ty Obj;
-  std::mutex Mtx;
+  std::shared_mutex Mtx;
   friend struct Accessor<Ty>;
+  friend struct SharedAccessor<Ty>;
 };
 
 /// Helper to provide transparent exclusive access to protected objects.
@@ -51,6 +60,16 @@ template <typename Ty> struct Accessor {
 
   Accessor(Accessor &Other) = delete;
 
+  /// Give up the current access, if any, and take it from \p Other.
+  Accessor &operator=(Accessor<Ty> &&Other) {
+    if (&Other != this) {
+      unlock();
+      Ptr = Other.Ptr;
+      Other.Ptr = nullptr;
+    }
+    return *this;
+  }
+
   /// If the object is still owned when the lifetime ends we give up access.
   ~Accessor() { unlock(); }
 
@@ -61,6 +80,9 @@ template <typename Ty> struct Accessor {
     Ptr = nullptr;
   }
 
+  /// Return true if the accessor currently owns the underlying object.
+  bool hasAccess() const { return Ptr != nullptr; }
+
   /// Provide transparent access to the underlying object.
   Ty &operator*() {
     assert(Ptr && "Trying to access an object through a non-owning (or "
@@ -91,6 +113,63 @@ private:
   ProtectedObj<Ty> *Ptr;
 };
 
+/// Helper to provide transparent read-only access to protected objects. Other
+/// shared accessors can access the object at the same time.
+template <typename Ty> struct SharedAccessor {
+  /// Default constructor does not own anything and cannot access anything.
+  SharedAccessor() : Ptr(nullptr) {}
+
+  /// Constructor to get shared access by locking the mutex protecting the
+  /// underlying object in shared mode.
+  SharedAccessor(ProtectedObj<Ty> &PO) : Ptr(&PO) { lock(); }
+
+  /// Constructor to get shared access by taking it from \p Other.
+  SharedAccessor(SharedAccessor<Ty> &&Other) : Ptr(Other.Ptr) {
+    Other.Ptr = nullptr;
+  }
+
+  SharedAccessor(SharedAccessor &Other) = delete;
+
+  /// If the object is still owned when the lifetime ends we give up access.
+  ~SharedAccessor() { unlock(); }
+
+  /// Give up access to the underlying object, virtually "destroying" the
+  /// accessor even if the object is still life.
+  void destroy() {
+    unlock();
+    Ptr = nullptr;
+  }
+
+  /// Provide transparent read-only access to the underlying object.
+  const Ty &operator*() const {
+    assert(Ptr && "Trying to access an object through a non-owning (or "
+                  "destroyed) accessor!");
+    return Ptr->Obj;
+  }
+  const Ty *operator->() const {
+    assert(Ptr && "Trying to access an object through a non-owning (or "
+                  "destroyed) accessor!");
+    return &Ptr->Obj;
+  }
+
+private:
+  /// Lock the underlying object in shared mode if there is one.
+  void lock() {
+    if (Ptr)
+      Ptr->Mtx.lock_shared();
+  }
+
+  /// Unlock the underlying object if there is one.
+  void unlock() {
+    if (Ptr)
+      Ptr->Mtx.unlock_shared();
+  }
+
+  /// Pointer to the underlying object or null if the accessor lost access,
+  /// e.g., after a destroy call.
+  ProtectedObj<Ty> *Ptr;
+};
+
 template <typename Ty>
 Accessor<Ty> ProtectedObj<Ty>::getExclusiveAccessor(bool DoNotGetAccess) {
   if (DoNotGetAccess)
@@ -98,4 +177,11 @@ Accessor<Ty> ProtectedObj<Ty>::getExclusiveAccessor(bool DoNotGetAccess) {
   return Accessor<Ty>(*this);
 }
 
+template <typename Ty>
+SharedAccessor<Ty> ProtectedObj<Ty>::getSharedAccessor(bool DoNotGetAccess) {
+  if (DoNotGetAccess)
+    return SharedAccessor<Ty>();
+  return SharedAccessor<Ty>(*this);
+}
+
 #endif
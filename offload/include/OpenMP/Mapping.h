@@ -260,8 +260,8 @@ public:
     return OFFLOAD_SUCCESS;
   }
 
-  /// Lock this entry for exclusive access. Ensure to get exclusive access to
-  /// HDTTMap first!
+  /// Lock this entry for exclusive access. Ensure to get (shared or exclusive)
+  /// access to HDTTMap first!
   void lock() const { Mtx.lock(); }
 
   /// Unlock this entry to allow other threads inspecting it.
@@ -269,7 +269,8 @@ public:
 
 private:
   // Mutex that needs to be held before the entry is inspected or modified. The
-  // HDTTMap mutex needs to be held before trying to lock any HDTT Entry.
+  // HDTTMap mutex needs to be held, in either mode, before trying to lock any
+  // HDTT Entry.
   mutable std::mutex Mtx;
 };
 
@@ -454,18 +455,33 @@ struct MappingInfoTy {
   using HostDataToTargetListTy =
       std::set<HostDataToTargetMapKeyTy, std::less<>>;
 
-  /// The HDTTMap is a protected object that can only be accessed by one thread
-  /// at a time.
+  /// The HDTTMap is a protected object. Lookups that do not insert or erase
+  /// entries hold it in shared mode and can run concurrently; any modification
+  /// of the map requires exclusive access. Reference counts and other entry
+  /// states are protected by the entry lock, which is only taken while the
+  /// HDTTMap is held in either mode.
   ProtectedObj<HostDataToTargetListTy> HostDataToTargetMap;
 
-  /// The type used to access the HDTT map.
+  /// The types used to access the HDTT map.
   using HDTTMapAccessorTy = decltype(HostDataToTargetMap)::AccessorTy;
+  using HDTTMapSharedAccessorTy =
+      decltype(HostDataToTargetMap)::SharedAccessorTy;
 
   /// Lookup the mapping of \p HstPtrBegin in \p HDTTMap. The accessor ensures
   /// exclusive access to the HDTT map.
   LookupResult lookupMapping(HDTTMapAccessorTy &HDTTMap, void *HstPtrBegin,
                              int64_t Size,
-                             HostDataToTargetTy *OwnedTPR = nullptr);
+                             HostDataToTargetTy *OwnedTPR = nullptr) {
+    return lookupMapping(*HDTTMap, HstPtrBegin, Size, OwnedTPR);
+  }
+
+  /// Lookup the mapping of \p HstPtrBegin in \p HDTTMap. The accessor ensures
+  /// the HDTT map is not modified while it is inspected.
+  LookupResult lookupMapping(HDTTMapSharedAccessorTy &HDTTMap,
+                             void *HstPtrBegin, int64_t Size,
+                             HostDataToTargetTy *OwnedTPR = nullptr) {
+    return lookupMapping(*HDTTMap, HstPtrBegin, Size, OwnedTPR);
+  }
 
   /// Get the target pointer based on host pointer begin and base. If the
   /// mapping already exists, the target pointer will be returned directly. In
@@ -477,6 +493,9 @@ struct MappingInfoTy {
   /// - Data allocation failed;
   /// - The user tried to do an illegal mapping;
   /// - Data transfer issue fails.
+  /// If \p HDTTMap does not own the HDTT map the lookup is first done with
+  /// shared access, and exclusive access is only acquired into \p HDTTMap if
+  /// no existing mapping can be reused.
   TargetPointerResultTy getTargetPointer(
       HDTTMapAccessorTy &HDTTMap, void *HstPtrBegin, void *HstPtrBase,
       int64_t TgtPadding, int64_t Size, map_var_info_t HstPtrName,
@@ -532,6 +551,10 @@ struct MappingInfoTy {
                      MappingInfoTy::HDTTMapAccessorTy *HDTTMapPtr);
 
 private:
+  LookupResult lookupMapping(const HostDataToTargetListTy &HDTTMap,
+                             void *HstPtrBegin, int64_t Size,
+                             HostDataToTargetTy *OwnedTPR);
+
   DeviceTy &Device;
 };
 
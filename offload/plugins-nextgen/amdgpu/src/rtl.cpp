@@ -705,12 +705,15 @@ struct AMDGPUQueueTy {
   void addUser() { ++NumUsers; }
 
   /// Push a kernel launch to the queue. The kernel launch requires an output
-  /// signal and can define an optional input signal (nullptr if none).
+  /// signal and can define an optional input signal (nullptr if none). If \p
+  /// WaitPrevious is set, the kernel packet sets the barrier bit instead, so it
+  /// starts only once all preceding packets of the queue completed.
   Error pushKernelLaunch(const AMDGPUKernelTy &Kernel, void *KernelArgs,
                          uint32_t NumThreads, uint64_t NumBlocks,
                          uint32_t GroupSize, uint64_t StackSize,
                          AMDGPUSignalTy *OutputSignal,
-                         AMDGPUSignalTy *InputSignal) {
+                         AMDGPUSignalTy *InputSignal,
+                         bool WaitPrevious = false) {
     assert(OutputSignal && "Invalid kernel output signal");
 
     // Lock the queue during the packet publishing process. Notice this blocks
@@ -751,7 +754,7 @@ struct AMDGPUQueueTy {
     Packet->completion_signal = OutputSignal->get();
 
     // Publish the packet. Do not modify the packet after this point.
-    publishKernelPacket(PacketId, Setup, Packet);
+    publishKernelPacket(PacketId, Setup, Packet, WaitPrevious);
 
     return Plugin::success();
   }
@@ -827,12 +830,16 @@ private:
 
   /// Publish the kernel packet so that the HSA runtime can start processing
   /// the kernel launch. Do not modify the packet once this function is called.
-  /// Assumes the queue lock is acquired.
+  /// If \p Barrier is set, the packet waits for all preceding packets of the
+  /// queue. Assumes the queue lock is acquired.
   void publishKernelPacket(uint64_t PacketId, uint16_t Setup,
-                           hsa_kernel_dispatch_packet_t *Packet) {
+                           hsa_kernel_dispatch_packet_t *Packet,
+                           bool Barrier) {
     uint32_t *PacketPtr = reinterpret_cast<uint32_t *>(Packet);
 
     uint16_t Header = HSA_PACKET_TYPE_KERNEL_DISPATCH << HSA_PACKET_HEADER_TYPE;
+    if (Barrier)
+      Header |= 1 << HSA_PACKET_HEADER_BARRIER;
     Header |= HSA_FENCE_SCOPE_SYSTEM << HSA_PACKET_HEADER_ACQUIRE_FENCE_SCOPE;
     Header |= HSA_FENCE_SCOPE_SYSTEM << HSA_PACKET_HEADER_RELEASE_FENCE_SCOPE;
 
@@ -1033,6 +1040,14 @@ private:
   /// Indicate to spread data transfers across all avilable SDMAs
   bool UseMultipleSdmaEngines;
 
+  /// Indicate to chain back-to-back kernel launches through the barrier bit of
+  /// their dispatch packets instead of separate barrier packets.
+  bool ChainKernelLaunches;
+
+  /// The slot of the last kernel launch on the stream, if it is still in the
+  /// current synchronization cycle. UINT32_MAX otherwise.
+  uint32_t LastKernelSlot;
+
   /// Return the current number of asychronous operations on the stream.
   uint32_t size() const { return NextSlot; }
 
@@ -1078,6 +1093,7 @@ private:
 
     // Reset the stream slots to zero.
     NextSlot = 0;
+    LastKernelSlot = UINT32_MAX;
 
     // Increase the synchronization id since the stream completed a sync cycle.
     SyncCycle += 1;
@@ -1233,10 +1249,19 @@ public:
     if (auto Err = Slots[Curr].schedReleaseBuffer(KernelArgs, MemoryManager))
       return Err;
 
+    // If the previous operation is a kernel on the same queue, the dependency
+    // can be expressed by the barrier bit of the kernel packet itself. This
+    // saves the barrier packet, and the command processor does not need to
+    // wait on a signal between the two kernels.
+    bool WaitPrevious =
+        ChainKernelLaunches && Curr > 0 && LastKernelSlot == Curr - 1;
+    LastKernelSlot = Curr;
+
     // Push the kernel with the output signal and an input signal (optional)
     return Queue->pushKernelLaunch(Kernel, KernelArgs, NumThreads, NumBlocks,
                                    GroupSize, StackSize, OutputSignal,
-                                   InputSignal);
+                                   WaitPrevious ? nullptr : InputSignal,
+                                   WaitPrevious);
   }
 
   /// Push an asynchronous memory copy between pinned memory buffers.
@@ -1859,6 +1884,8 @@ struct AMDGPUDeviceTy : public GenericDeviceTy, AMDGenericDeviceTy {
         OMPX_StreamBusyWait("LIBOMPTARGET_AMDGPU_STREAM_BUSYWAIT", 2000000),
         OMPX_UseMultipleSdmaEngines(
             "LIBOMPTARGET_AMDGPU_USE_MULTIPLE_SDMA_ENGINES", false),
+        OMPX_ChainKernelLaunches("LIBOMPTARGET_AMDGPU_CHAIN_KERNEL_LAUNCHES",
+                                 false),
         OMPX_ApuMaps("OMPX_APU_MAPS", false), AMDGPUStreamManager(*this, Agent),
         AMDGPUEventManager(*this), AMDGPUSignalManager(*this), Agent(Agent),
         HostDevice(HostDevice) {}
@@ -2772,6 +2799,8 @@ struct AMDGPUDeviceTy : public GenericDeviceTy, AMDGenericDeviceTy {
 
   bool useMultipleSdmaEngines() const { return OMPX_UseMultipleSdmaEngines; }
 
+  bool chainKernelLaunches() const { return OMPX_ChainKernelLaunches; }
+
 private:
   using AMDGPUEventRef = AMDGPUResourceRef<AMDGPUEventTy>;
   using AMDGPUEventManagerTy = GenericDeviceResourceManagerTy<AMDGPUEventRef>;
@@ -2871,6 +2900,11 @@ private:
   /// Use ROCm 5.7 interface for multiple SDMA engines
   BoolEnvar OMPX_UseMultipleSdmaEngines;
 
+  /// Envar to let consecutive kernel launches on a stream depend on each other
+  /// through the barrier bit of the dispatch packet, so that each launch needs
+  /// a single packet.
+  BoolEnvar OMPX_ChainKernelLaunches;
+
   /// Value of OMPX_APU_MAPS env var used to force
   /// automatic zero-copy behavior on non-APU GPUs.
   BoolEnvar OMPX_ApuMaps;
@@ -2988,7 +3022,9 @@ AMDGPUStreamTy::AMDGPUStreamTy(AMDGPUDeviceTy &Device)
       // Initialize the std::deque with some empty positions.
       Slots(32), NextSlot(0), SyncCycle(0), RPCServer(nullptr),
       StreamBusyWaitMicroseconds(Device.getStreamBusyWaitMicroseconds()),
-      UseMultipleSdmaEngines(Device.useMultipleSdmaEngines()) {}
+      UseMultipleSdmaEngines(Device.useMultipleSdmaEngines()),
+      ChainKernelLaunches(Device.chainKernelLaunches()),
+      LastKernelSlot(UINT32_MAX) {}
 
 /// Class implementing the AMDGPU-specific functionalities of the global
 /// handler.
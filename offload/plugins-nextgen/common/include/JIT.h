@@ -68,12 +68,23 @@ private:
   compile(const __tgt_device_image &Image, const std::string &ComputeUnitKind,
           PostProcessingFn PostProcessing);
 
-  /// Create or retrieve the object image file from the file system or via
-  /// compilation of the \p Image.
+  /// Create or retrieve the object image file from the file system, the
+  /// persistent JIT cache, or via compilation of the \p Image.
   Expected<std::unique_ptr<MemoryBuffer>>
   getOrCreateObjFile(const __tgt_device_image &Image, LLVMContext &Ctx,
                      const std::string &ComputeUnitKind);
 
+  /// Create the object image file by compiling \p Image, or the replacement
+  /// module if there is one.
+  Expected<std::unique_ptr<MemoryBuffer>>
+  createObjFile(const __tgt_device_image &Image, LLVMContext &Ctx,
+                const std::string &ComputeUnitKind);
+
+  /// Return the key of the object image file of \p Image for \p
+  /// ComputeUnitKind in the persistent JIT cache.
+  std::string getCacheKey(const __tgt_device_image &Image,
+                          const std::string &ComputeUnitKind) const;
+
   /// Run backend, which contains optimization and code generation.
   Expected<std::unique_ptr<MemoryBuffer>>
   backend(Module &M, const std::string &ComputeUnitKind, unsigned OptLevel);
@@ -116,6 +127,8 @@ private:
       StringEnvar("LIBOMPTARGET_JIT_POST_OPT_IR_MODULE");
   UInt32Envar JITOptLevel = UInt32Envar("LIBOMPTARGET_JIT_OPT_LEVEL", 3);
   BoolEnvar JITSkipOpt = BoolEnvar("LIBOMPTARGET_JIT_SKIP_OPT", false);
+  StringEnvar JITCacheDirectory = StringEnvar("LIBOMPTARGET_JIT_CACHE_DIR");
+  StringEnvar JITCachePolicy = StringEnvar("LIBOMPTARGET_JIT_CACHE_POLICY");
 };
 
 } // namespace target
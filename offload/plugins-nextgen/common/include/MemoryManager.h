@@ -13,6 +13,7 @@
 #ifndef LLVM_OPENMP_LIBOMPTARGET_PLUGINS_COMMON_MEMORYMANAGER_H
 #define LLVM_OPENMP_LIBOMPTARGET_PLUGINS_COMMON_MEMORYMANAGER_H
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <list>
@@ -93,6 +94,14 @@ class MemoryManagerTy {
     return L;
   }
 
+  /// Round \p Size up to its size class in the large block pool. Every power
+  /// of two is split into eight classes, so at most an eighth of a block is
+  /// wasted while requests of similar size still share blocks.
+  static size_t getLargeSizeClass(size_t Size) {
+    const size_t Step = std::max<size_t>(floorToPowerOfTwo(Size) >> 3, 1);
+    return (Size + Step - 1) / Step * Step;
+  }
+
   /// A structure stores the meta data of a target pointer
   struct NodeTy {
     /// Memory size
@@ -125,6 +134,14 @@ class MemoryManagerTy {
   /// The mutex for the table \p PtrToNodeTable
   std::mutex MapTableLock;
 
+  /// Released blocks larger than \p SizeThreshold, most recently released
+  /// first. Their nodes live in \p PtrToNodeTable like the small ones.
+  std::list<std::reference_wrapper<NodeTy>> LargeFreeList;
+  /// The total size of the blocks in \p LargeFreeList
+  size_t LargeFreeListSize = 0;
+  /// The mutex for \p LargeFreeList and \p LargeFreeListSize
+  std::mutex LargeFreeListLock;
+
   /// The reference to a device allocator
   DeviceAllocatorTy &DeviceAllocator;
 
@@ -133,6 +150,10 @@ class MemoryManagerTy {
   /// memory manager.
   size_t SizeThreshold = 1U << 13;
 
+  /// The maximum number of bytes kept in \p LargeFreeList. If it is zero,
+  /// allocations larger than \p SizeThreshold are not managed at all.
+  size_t LargePoolSize = 0;
+
   /// Request memory from target device
   void *allocateOnDevice(size_t Size, void *HstPtr) const {
     return DeviceAllocator.allocate(Size, HstPtr, TARGET_ALLOC_DEVICE);
@@ -141,12 +162,101 @@ class MemoryManagerTy {
   /// Deallocate data on device
   int deleteOnDevice(void *Ptr) const { return DeviceAllocator.free(Ptr); }
 
+  /// Remove the nodes of \p Blocks from the map table and deallocate them on
+  /// the device. The nodes must not be in any free list anymore.
+  int releaseBlocks(const std::vector<void *> &Blocks) {
+    if (Blocks.empty())
+      return OFFLOAD_SUCCESS;
+
+    // Erase the nodes first so that the device cannot hand out the same
+    // pointer again while the table still knows the old node.
+    {
+      std::lock_guard<std::mutex> LG(MapTableLock);
+      for (void *P : Blocks)
+        PtrToNodeTable.erase(P);
+    }
+
+    int Ret = OFFLOAD_SUCCESS;
+    for (void *P : Blocks)
+      if (deleteOnDevice(P) != OFFLOAD_SUCCESS)
+        Ret = OFFLOAD_FAIL;
+    return Ret;
+  }
+
+  /// Allocate a block larger than \p SizeThreshold. A released block of the
+  /// same size class is reused if there is one, otherwise a new block of the
+  /// full class size is allocated on the device.
+  void *allocateLarge(size_t Size, void *HstPtr) {
+    const size_t ClassSize = getLargeSizeClass(Size);
+
+    {
+      std::lock_guard<std::mutex> LG(LargeFreeListLock);
+      for (auto Itr = LargeFreeList.begin(); Itr != LargeFreeList.end();
+           ++Itr) {
+        NodeTy &N = *Itr;
+        if (N.Size != ClassSize)
+          continue;
+        LargeFreeList.erase(Itr);
+        LargeFreeListSize -= ClassSize;
+        DP("Reuse large block " DPxMOD " of size %zu for size %zu.\n",
+           DPxPTR(N.Ptr), ClassSize, Size);
+        return N.Ptr;
+      }
+    }
+
+    DP("Cannot find a large block of size %zu. Allocate on device.\n",
+       ClassSize);
+    void *TgtPtr = allocateOrFreeAndAllocateOnDevice(ClassSize, HstPtr);
+    if (TgtPtr == nullptr)
+      return nullptr;
+
+    std::lock_guard<std::mutex> Guard(MapTableLock);
+    PtrToNodeTable.emplace(TgtPtr, NodeTy(ClassSize, TgtPtr));
+    return TgtPtr;
+  }
+
+  /// Put the large block \p N back into \p LargeFreeList. If the pool grows
+  /// beyond \p LargePoolSize, the least recently released blocks are trimmed
+  /// and returned to the device.
+  int freeLarge(NodeTy &N) {
+    std::vector<void *> TrimList;
+    {
+      std::lock_guard<std::mutex> LG(LargeFreeListLock);
+      LargeFreeList.push_front(N);
+      LargeFreeListSize += N.Size;
+      while (LargeFreeListSize > LargePoolSize) {
+        NodeTy &Victim = LargeFreeList.back();
+        LargeFreeList.pop_back();
+        LargeFreeListSize -= Victim.Size;
+        TrimList.push_back(Victim.Ptr);
+      }
+    }
+
+    if (!TrimList.empty())
+      DP("Trim %zu large blocks from the pool.\n", TrimList.size());
+
+    return releaseBlocks(TrimList);
+  }
+
   /// This function is called when it tries to allocate memory on device but the
   /// device returns out of memory. It will first free all memory in the
   /// FreeList and try to allocate again.
   void *freeAndAllocate(size_t Size, void *HstPtr) {
     std::vector<void *> RemoveList;
 
+    // Deallocate all blocks in the large block pool
+    {
+      std::vector<void *> LargeList;
+      {
+        std::lock_guard<std::mutex> LG(LargeFreeListLock);
+        for (const NodeTy &N : LargeFreeList)
+          LargeList.push_back(N.Ptr);
+        LargeFreeList.clear();
+        LargeFreeListSize = 0;
+      }
+      releaseBlocks(LargeList);
+    }
+
     // Deallocate all memory in FreeList
     for (int I = 0; I < NumBuckets; ++I) {
       FreeListTy &List = FreeLists[I];
@@ -194,10 +304,12 @@ class MemoryManagerTy {
 
 public:
   /// Constructor. If \p Threshold is non-zero, then the default threshold will
-  /// be overwritten by \p Threshold.
-  MemoryManagerTy(DeviceAllocatorTy &DeviceAllocator, size_t Threshold = 0)
+  /// be overwritten by \p Threshold. Up to \p PoolSize bytes of released
+  /// allocations larger than the threshold are kept for reuse.
+  MemoryManagerTy(DeviceAllocatorTy &DeviceAllocator, size_t Threshold = 0,
+                  size_t PoolSize = 0)
       : FreeLists(NumBuckets), FreeListLocks(NumBuckets),
-        DeviceAllocator(DeviceAllocator) {
+        DeviceAllocator(DeviceAllocator), LargePoolSize(PoolSize) {
     if (Threshold)
       SizeThreshold = Threshold;
   }
@@ -222,8 +334,11 @@ public:
     DP("MemoryManagerTy::allocate: size %zu with host pointer " DPxMOD ".\n",
        Size, DPxPTR(HstPtr));
 
-    // If the size is greater than the threshold, allocate it directly from
-    // device.
+    // If the size is greater than the threshold, allocate it from the large
+    // block pool, or directly from device if there is no pool.
+    if (Size > SizeThreshold && LargePoolSize)
+      return allocateLarge(Size, HstPtr);
+
     if (Size > SizeThreshold) {
       DP("%zu is greater than the threshold %zu. Allocate it directly from "
          "device\n",
@@ -304,6 +419,10 @@ public:
       return deleteOnDevice(TgtPtr);
     }
 
+    // Large blocks go back to the large block pool
+    if (P->Size > SizeThreshold)
+      return freeLarge(*P);
+
     // Insert the node to the free list
     const int B = findBucket(P->Size);
 
@@ -337,6 +456,16 @@ public:
 
     return std::make_pair(Threshold, true);
   }
+
+  /// Get the size of the large block pool in bytes from the environment
+  /// variable \p LIBOMPTARGET_MEMORY_MANAGER_POOL_SIZE , which is given in MB.
+  /// Returns 0, i.e., no pool, if the user doesn't specify anything.
+  static size_t getLargePoolSizeFromEnv() {
+    static UInt32Envar MemoryManagerPoolSize(
+        "LIBOMPTARGET_MEMORY_MANAGER_POOL_SIZE", 0);
+
+    return size_t(MemoryManagerPoolSize.get()) << 20;
+  }
 };
 
 // GCC still cannot handle the static data member like Clang so we still need
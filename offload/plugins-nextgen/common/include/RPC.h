@@ -16,6 +16,8 @@
 #ifndef OPENMP_LIBOMPTARGET_PLUGINS_NEXTGEN_COMMON_RPC_H
 #define OPENMP_LIBOMPTARGET_PLUGINS_NEXTGEN_COMMON_RPC_H
 
+#include "Shared/EnvironmentVar.h"
+
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/Support/Error.h"
 
@@ -62,6 +64,10 @@ public:
 private:
   /// Array from this device's identifier to its attached devices.
   llvm::SmallVector<uintptr_t> Handles;
+
+  /// Number of threads handling the RPC server of each device in the
+  /// background, in addition to the calls to runServer.
+  UInt32Envar NumWorkers = UInt32Envar("LIBOMPTARGET_RPC_NUM_WORKERS", 0);
 };
 
 } // namespace llvm::omp::target
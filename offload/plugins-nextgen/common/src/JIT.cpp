@@ -17,8 +17,10 @@
 #include "omptarget.h"
 
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/CodeGen/CommandFlags.h"
 #include "llvm/CodeGen/MachineModuleInfo.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/LLVMRemarkStreamer.h"
 #include "llvm/IR/LegacyPassManager.h"
@@ -28,11 +30,16 @@
 #include "llvm/Object/IRObjectFile.h"
 #include "llvm/Passes/OptimizationLevel.h"
 #include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Caching.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/VCSRevision.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
@@ -257,6 +264,116 @@ JITEngine::getOrCreateObjFile(const __tgt_device_image &Image, LLVMContext &Ctx,
     return std::move(*MBOrErr);
   }
 
+  // Look for the object in the persistent cache first. The cache is bypassed
+  // if the module is replaced or the IR is dumped, as both expect the module
+  // to be compiled. Failing to use the cache is not fatal, the image is then
+  // compiled as if no cache was set up.
+  AddStreamFn AddStream;
+  if (JITCacheDirectory.isPresent() && !ReplacementModuleFileName.isPresent() &&
+      !PreOptIRModuleFileName.isPresent() &&
+      !PostOptIRModuleFileName.isPresent()) {
+    std::unique_ptr<MemoryBuffer> CachedMB;
+    auto CacheOrErr = localCache(
+        "JIT", "omp-jit", JITCacheDirectory.get(),
+        [&](size_t, const Twine &, std::unique_ptr<MemoryBuffer> MB) {
+          CachedMB = std::move(MB);
+        });
+    std::string Key = getCacheKey(Image, ComputeUnitKind);
+    Expected<AddStreamFn> AddStreamOrErr =
+        CacheOrErr ? (*CacheOrErr)(/*Task=*/0, Key, ComputeUnitKind)
+                   : Expected<AddStreamFn>(CacheOrErr.takeError());
+    if (!AddStreamOrErr) {
+      DP("Not using JIT cache %s: %s\n", JITCacheDirectory.get().c_str(),
+         toString(AddStreamOrErr.takeError()).c_str());
+    } else if (CachedMB) {
+      DP("Found JIT image for %s in cache %s\n", ComputeUnitKind.c_str(),
+         JITCacheDirectory.get().c_str());
+      return std::move(CachedMB);
+    } else {
+      AddStream = std::move(*AddStreamOrErr);
+    }
+  }
+
+  auto ObjMBOrErr = createObjFile(Image, Ctx, ComputeUnitKind);
+  if (!ObjMBOrErr || !AddStream)
+    return ObjMBOrErr;
+
+  // Install the new object in the cache. The stream writes to a temporary file
+  // that is atomically renamed once the stream is destroyed, so concurrent
+  // processes only ever see complete entries.
+  {
+    auto StreamOrErr = AddStream(/*Task=*/0, ComputeUnitKind);
+    if (!StreamOrErr) {
+      DP("Could not store JIT image in cache %s: %s\n",
+         JITCacheDirectory.get().c_str(),
+         toString(StreamOrErr.takeError()).c_str());
+      return ObjMBOrErr;
+    }
+    *(*StreamOrErr)->OS << (*ObjMBOrErr)->getBuffer();
+  }
+
+  auto PolicyOrErr = parseCachePruningPolicy(JITCachePolicy.get());
+  if (!PolicyOrErr) {
+    DP("Not pruning JIT cache %s: %s\n", JITCacheDirectory.get().c_str(),
+       toString(PolicyOrErr.takeError()).c_str());
+    return ObjMBOrErr;
+  }
+  pruneCache(JITCacheDirectory.get(), *PolicyOrErr);
+
+  return ObjMBOrErr;
+}
+
+std::string JITEngine::getCacheKey(const __tgt_device_image &Image,
+                                   const std::string &ComputeUnitKind) const {
+  // Everything that changes the generated object is part of the key, starting
+  // with the compiler revision, as the backend changes between builds.
+  SHA1 Hasher;
+  auto AddString = [&](StringRef Str) {
+    Hasher.update(Str);
+    Hasher.update(ArrayRef<uint8_t>{0});
+  };
+  auto AddUnsigned = [&](unsigned I) {
+    uint8_t Data[4];
+    support::endian::write32le(Data, I);
+    Hasher.update(Data);
+  };
+  AddString(LLVM_VERSION_STRING);
+#ifdef LLVM_REVISION
+  AddString(LLVM_REVISION);
+#endif
+
+  // The target machine, see createTargetMachine. The relocation and code
+  // models come from the module, which is hashed below.
+  AddString(TT.str());
+  AddString(ComputeUnitKind);
+  SubtargetFeatures Features;
+  Features.getDefaultSubtargetFeatures(TT);
+  AddString(Features.getString());
+  TargetOptions Options = codegen::InitTargetOptionsFromCodeGenFlags(TT);
+  AddUnsigned(Options.FunctionSections);
+  AddUnsigned(Options.DataSections);
+  AddUnsigned(Options.UnsafeFPMath);
+  AddUnsigned(Options.NoInfsFPMath);
+  AddUnsigned(Options.NoNaNsFPMath);
+  AddUnsigned(Options.NoSignedZerosFPMath);
+  AddUnsigned(static_cast<unsigned>(Options.AllowFPOpFusion));
+  AddUnsigned(static_cast<unsigned>(Options.FloatABIType));
+  AddUnsigned(static_cast<unsigned>(Options.ExceptionModel));
+  AddUnsigned(static_cast<unsigned>(Options.DebuggerTuning));
+
+  // The JIT options.
+  AddUnsigned(JITOptLevel);
+  AddUnsigned(JITSkipOpt);
+
+  Hasher.update(
+      StringRef(reinterpret_cast<const char *>(Image.ImageStart),
+                target::getPtrDiff(Image.ImageEnd, Image.ImageStart)));
+  return toHex(Hasher.result());
+}
+
+Expected<std::unique_ptr<MemoryBuffer>>
+JITEngine::createObjFile(const __tgt_device_image &Image, LLVMContext &Ctx,
+                         const std::string &ComputeUnitKind) {
   Module *Mod = nullptr;
   // Check if the user replaces the module at runtime or we read it from the
   // image.
@@ -793,7 +793,8 @@ Error GenericDeviceTy::init(GenericPluginTy &Plugin) {
   // Enable the memory manager if required.
   auto [ThresholdMM, EnableMM] = MemoryManagerTy::getSizeThresholdFromEnv();
   if (EnableMM)
-    MemoryManager = new MemoryManagerTy(*this, ThresholdMM);
+    MemoryManager = new MemoryManagerTy(
+        *this, ThresholdMM, MemoryManagerTy::getLargePoolSizeFromEnv());
 
   return Plugin::success();
 }
@@ -105,6 +105,14 @@ Error RPCServerTy::initDevice(plugin::GenericDeviceTy &Device,
                                    rpc_get_client_size(), nullptr))
     return Err;
   Handles[Device.getDeviceId()] = RPCDevice.handle;
+
+  // Handle the requests in the background as well, once all the callbacks are
+  // registered. The allocation callbacks above are thread safe.
+  if (NumWorkers > 0)
+    if (rpc_status_t Err = rpc_server_start_workers(RPCDevice, NumWorkers))
+      return plugin::Plugin::error(
+          "Failed to start RPC server workers for device %d: %d",
+          Device.getDeviceId(), Err);
 #endif
   return Error::success();
 }
@@ -18,8 +18,8 @@
 /// Dump a table of all the host-target pointer pairs on failure
 void dumpTargetPointerMappings(const ident_t *Loc, DeviceTy &Device,
                                bool toStdOut) {
-  MappingInfoTy::HDTTMapAccessorTy HDTTMap =
-      Device.getMappingInfo().HostDataToTargetMap.getExclusiveAccessor();
+  MappingInfoTy::HDTTMapSharedAccessorTy HDTTMap =
+      Device.getMappingInfo().HostDataToTargetMap.getSharedAccessor();
   if (HDTTMap->empty()) {
     DUMP_INFO(toStdOut, OMP_INFOTYPE_ALL, Device.DeviceID,
               "OpenMP Host-Device pointer mappings table empty\n");
@@ -128,9 +128,10 @@ int MappingInfoTy::disassociatePtr(void *HstPtrBegin) {
   return OFFLOAD_FAIL;
 }
 
-LookupResult MappingInfoTy::lookupMapping(HDTTMapAccessorTy &HDTTMap,
-                                          void *HstPtrBegin, int64_t Size,
-                                          HostDataToTargetTy *OwnedTPR) {
+LookupResult
+MappingInfoTy::lookupMapping(const HostDataToTargetListTy &HDTTMap,
+                             void *HstPtrBegin, int64_t Size,
+                             HostDataToTargetTy *OwnedTPR) {
 
   uintptr_t HP = (uintptr_t)HstPtrBegin;
   LookupResult LR;
@@ -138,16 +139,16 @@ LookupResult MappingInfoTy::lookupMapping(HDTTMapAccessorTy &HDTTMap,
   DP("Looking up mapping(HstPtrBegin=" DPxMOD ", Size=%" PRId64 ")...\n",
      DPxPTR(HP), Size);
 
-  if (HDTTMap->empty())
+  if (HDTTMap.empty())
     return LR;
 
-  auto Upper = HDTTMap->upper_bound(HP);
+  auto Upper = HDTTMap.upper_bound(HP);
 
   if (Size == 0) {
     // specification v5.1 Pointer Initialization for Device Data Environments
     // upper_bound satisfies
     //   std::prev(upper)->HDTT.HstPtrBegin <= hp < upper->HDTT.HstPtrBegin
-    if (Upper != HDTTMap->begin()) {
+    if (Upper != HDTTMap.begin()) {
       LR.TPR.setEntry(std::prev(Upper)->HDTT, OwnedTPR);
       // the left side of extended address range is satisified.
       // hp >= LR.TPR.getEntry()->HstPtrBegin || hp >=
@@ -156,7 +157,7 @@ LookupResult MappingInfoTy::lookupMapping(HDTTMapAccessorTy &HDTTMap,
                              HP < LR.TPR.getEntry()->HstPtrBase;
     }
 
-    if (!LR.Flags.IsContained && Upper != HDTTMap->end()) {
+    if (!LR.Flags.IsContained && Upper != HDTTMap.end()) {
       LR.TPR.setEntry(Upper->HDTT, OwnedTPR);
       // the right side of extended address range is satisified.
       // hp < LR.TPR.getEntry()->HstPtrEnd || hp < LR.TPR.getEntry()->HstPtrBase
@@ -164,7 +165,7 @@ LookupResult MappingInfoTy::lookupMapping(HDTTMapAccessorTy &HDTTMap,
     }
   } else {
     // check the left bin
-    if (Upper != HDTTMap->begin()) {
+    if (Upper != HDTTMap.begin()) {
       LR.TPR.setEntry(std::prev(Upper)->HDTT, OwnedTPR);
       // Is it contained?
       LR.Flags.IsContained = HP >= LR.TPR.getEntry()->HstPtrBegin &&
@@ -177,7 +178,7 @@ LookupResult MappingInfoTy::lookupMapping(HDTTMapAccessorTy &HDTTMap,
 
     // check the right bin
     if (!(LR.Flags.IsContained || LR.Flags.ExtendsAfter) &&
-        Upper != HDTTMap->end()) {
+        Upper != HDTTMap.end()) {
       LR.TPR.setEntry(Upper->HDTT, OwnedTPR);
       // Does it extend into an already mapped region?
       LR.Flags.ExtendsBefore = HP < LR.TPR.getEntry()->HstPtrBegin &&
@@ -207,7 +208,27 @@ TargetPointerResultTy MappingInfoTy::getTargetPointer(
     bool HasCloseModifier, bool HasPresentModifier, bool HasHoldModifier,
     AsyncInfoTy &AsyncInfo, HostDataToTargetTy *OwnedTPR, bool ReleaseHDTTMap) {
 
-  LookupResult LR = lookupMapping(HDTTMap, HstPtrBegin, Size, OwnedTPR);
+  LookupResult LR;
+  if (!HDTTMap.hasAccess()) {
+    // Most maps refer to data that is already present. Look for it with shared
+    // access first so that threads mapping existing data do not serialize. The
+    // entry lock taken by the lookup protects the reference counts once the
+    // shared access is given up; entries are only erased with exclusive
+    // access and after their lock was acquired.
+    HDTTMapSharedAccessorTy SharedHDTTMap =
+        HostDataToTargetMap.getSharedAccessor();
+    LR = lookupMapping(SharedHDTTMap, HstPtrBegin, Size, OwnedTPR);
+    if (!LR.Flags.IsContained &&
+        !((LR.Flags.ExtendsBefore || LR.Flags.ExtendsAfter) && IsImplicit)) {
+      // The map might need to be modified. Drop the entry and the shared
+      // access before we wait for exclusive access and look again.
+      LR = LookupResult();
+      SharedHDTTMap.destroy();
+      HDTTMap = HostDataToTargetMap.getExclusiveAccessor();
+    }
+  }
+  if (HDTTMap.hasAccess())
+    LR = lookupMapping(HDTTMap, HstPtrBegin, Size, OwnedTPR);
   LR.TPR.Flags.IsPresent = true;
 
   // Release the mapping table lock only after the entry is locked by
@@ -374,7 +395,9 @@ TargetPointerResultTy MappingInfoTy::getTargetPointer(
 TargetPointerResultTy MappingInfoTy::getTgtPtrBegin(
     void *HstPtrBegin, int64_t Size, bool UpdateRefCount, bool UseHoldRefCount,
     bool MustContain, bool ForceDelete, bool FromDataEnd) {
-  HDTTMapAccessorTy HDTTMap = HostDataToTargetMap.getExclusiveAccessor();
+  // The map itself is not modified here. Reference counts are updated under
+  // the entry lock, which is taken during the lookup.
+  HDTTMapSharedAccessorTy HDTTMap = HostDataToTargetMap.getSharedAccessor();
 
   LookupResult LR = lookupMapping(HDTTMap, HstPtrBegin, Size);
 
@@ -526,10 +549,11 @@ void MappingInfoTy::printCopyInfo(
     void *TgtPtrBegin, void *HstPtrBegin, int64_t Size, bool H2D,
     HostDataToTargetTy *Entry, MappingInfoTy::HDTTMapAccessorTy *HDTTMapPtr) {
   auto HDTTMap =
-      HostDataToTargetMap.getExclusiveAccessor(!!Entry || !!HDTTMapPtr);
+      HostDataToTargetMap.getSharedAccessor(!!Entry || !!HDTTMapPtr);
   LookupResult LR;
   if (!Entry) {
-    LR = lookupMapping(HDTTMapPtr ? *HDTTMapPtr : HDTTMap, HstPtrBegin, Size);
+    LR = HDTTMapPtr ? lookupMapping(*HDTTMapPtr, HstPtrBegin, Size)
+                    : lookupMapping(HDTTMap, HstPtrBegin, Size);
     Entry = LR.TPR.getEntry();
   }
   printCopyInfoImpl(Device.DeviceID, H2D, HstPtrBegin, TgtPtrBegin, Size,
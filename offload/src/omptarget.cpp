@@ -618,8 +618,13 @@ int targetDataBegin(ident_t *Loc, DeviceTy &Device, int32_t ArgNum,
     bool UpdateRef =
         !(ArgTypes[I] & OMP_TGT_MAPTYPE_MEMBER_OF) && !(FromMapper && I == 0);
 
+    // Only pointer-and-object entries need exclusive access to the HDTT map
+    // up front, as the pointer entry must stay locked while the pointee is
+    // mapped. Otherwise getTargetPointer will look for existing mappings with
+    // shared access and only acquire exclusive access if needed.
     MappingInfoTy::HDTTMapAccessorTy HDTTMap =
-        Device.getMappingInfo().HostDataToTargetMap.getExclusiveAccessor();
+        Device.getMappingInfo().HostDataToTargetMap.getExclusiveAccessor(
+            /*DoNotGetAccess=*/!(ArgTypes[I] & OMP_TGT_MAPTYPE_PTR_AND_OBJ));
     if (ArgTypes[I] & OMP_TGT_MAPTYPE_PTR_AND_OBJ) {
       DP("Has a pointer entry: \n");
       // Base is address of pointer.
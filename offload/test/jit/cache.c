@@ -0,0 +1,50 @@
+// clang-format off
+//
+// RUN: %libomptarget-compileopt-generic -fopenmp-target-jit
+// RUN: rm -rf %t.cache
+// RUN: env LIBOMPTARGET_JIT_CACHE_DIR=%t.cache %libomptarget-run-generic \
+// RUN:   | %fcheck-generic
+// RUN: ls %t.cache | %fcheck-plain-generic %s --check-prefix=FILES
+// RUN: env LIBOMPTARGET_JIT_CACHE_DIR=%t.cache %libomptarget-run-generic \
+// RUN:   | %fcheck-generic
+// RUN: env LIBOMPTARGET_JIT_CACHE_DIR=%t.cache LIBOMPTARGET_JIT_OPT_LEVEL=1 \
+// RUN:   %libomptarget-run-generic | %fcheck-generic
+// RUN: ls %t.cache | %fcheck-plain-generic %s --check-prefix=FILES2
+// RUN: env LIBOMPTARGET_JIT_CACHE_DIR=%t.cache \
+// RUN:   LIBOMPTARGET_JIT_CACHE_POLICY=bogus %libomptarget-run-generic \
+// RUN:   | %fcheck-generic
+// RUN: rm -rf %t.file && touch %t.file
+// RUN: env LIBOMPTARGET_JIT_CACHE_DIR=%t.file/cache \
+// RUN:   %libomptarget-run-generic | %fcheck-generic
+//
+// clang-format on
+
+// UNSUPPORTED: aarch64-unknown-linux-gnu
+// UNSUPPORTED: aarch64-unknown-linux-gnu-LTO
+// UNSUPPORTED: x86_64-pc-linux-gnu
+// UNSUPPORTED: x86_64-pc-linux-gnu-LTO
+// UNSUPPORTED: s390x-ibm-linux-gnu
+// UNSUPPORTED: s390x-ibm-linux-gnu-LTO
+
+// The JITed image is stored in the cache on the first run and reused by the
+// second one. Changing the JIT options creates a new entry. An invalid pruning
+// policy or a cache directory that cannot be created does not prevent the image
+// from being compiled.
+//
+// FILES: llvmcache-{{[0-9a-f]+$}}
+// FILES-NOT: llvmcache-
+//
+// FILES2-COUNT-2: llvmcache-{{[0-9a-f]+$}}
+// FILES2-NOT: llvmcache-
+
+#include <stdio.h>
+
+int main() {
+  int N = 0;
+#pragma omp target map(tofrom : N)
+  N += 42;
+
+  // CHECK: N = 42
+  printf("N = %d\n", N);
+  return 0;
+}
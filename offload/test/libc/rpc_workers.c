@@ -0,0 +1,34 @@
+// RUN: %libomptarget-compile-generic
+// RUN: env LIBOMPTARGET_RPC_NUM_WORKERS=4 %libomptarget-run-generic \
+// RUN:   | %fcheck-generic
+
+// REQUIRES: libc
+
+// Handle the RPC requests of many teams with background workers, while the
+// target regions also run the server from the main thread.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#pragma omp declare target to(stdout)
+#pragma omp declare target to(malloc)
+#pragma omp declare target to(free)
+
+int main() {
+  int sum = 0;
+#pragma omp target teams num_teams(64) reduction(+ : sum) map(tofrom : sum)
+#pragma omp parallel num_threads(32) reduction(+ : sum)
+  {
+    int *ptr = (int *)malloc(sizeof(int));
+    *ptr = 1;
+    sum += *ptr;
+    free(ptr);
+  }
+
+  // CHECK: 2048
+  printf("%d\n", sum);
+
+  // CHECK-COUNT-8: PASS
+#pragma omp target teams num_teams(8)
+  { fputs("PASS\n", stdout); }
+}
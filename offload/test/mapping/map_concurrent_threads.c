@@ -0,0 +1,54 @@
+// RUN: %libomptarget-compile-run-and-check-generic
+
+// Many host threads map the same data and their own data at the same time.
+// Reference counts must stay exact so that the shared data is only unmapped
+// once every thread is done with it.
+
+#include <omp.h>
+#include <stdio.h>
+
+#define NUM_THREADS 16
+#define ITERS 200
+#define N 64
+
+int main() {
+  int Device = omp_get_default_device();
+  int Shared[N];
+  int Failed = 0;
+
+  for (int I = 0; I < N; ++I)
+    Shared[I] = I;
+
+#pragma omp target enter data map(to : Shared)
+
+#pragma omp parallel num_threads(NUM_THREADS) reduction(+ : Failed)
+  {
+    int Private[N];
+    for (int It = 0; It < ITERS; ++It) {
+      int Sum = 0;
+      for (int I = 0; I < N; ++I)
+        Private[I] = It;
+#pragma omp target enter data map(to : Shared)
+#pragma omp target map(to : Private) map(tofrom : Sum)
+      for (int I = 0; I < N; ++I)
+        Sum += Shared[I] + Private[I];
+#pragma omp target exit data map(release : Shared)
+      if (Sum != N * (N - 1) / 2 + N * It)
+        ++Failed;
+      if (omp_target_is_present(Private, Device))
+        ++Failed;
+    }
+  }
+
+  // CHECK: Shared present: 1
+  printf("Shared present: %d\n", omp_target_is_present(Shared, Device));
+
+#pragma omp target exit data map(release : Shared)
+
+  // CHECK: Shared present: 0
+  printf("Shared present: %d\n", omp_target_is_present(Shared, Device));
+
+  // CHECK: Failed: 0
+  printf("Failed: %d\n", Failed);
+  return 0;
+}
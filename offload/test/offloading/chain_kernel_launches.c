@@ -0,0 +1,40 @@
+// RUN: %libomptarget-compile-generic && \
+// RUN: env LIBOMPTARGET_AMDGPU_CHAIN_KERNEL_LAUNCHES=1 \
+// RUN: %libomptarget-run-generic | %fcheck-generic
+// REQUIRES: amdgcn-amd-amdhsa
+
+// Back-to-back kernels on the same stream must still execute in order when
+// they are chained through the barrier bit of their dispatch packets.
+
+#include <stdio.h>
+
+#define N 1024
+#define STEPS 500
+
+int main() {
+  int A[N];
+  for (int I = 0; I < N; ++I)
+    A[I] = 0;
+
+#pragma omp target data map(tofrom : A)
+  {
+    for (int S = 0; S < STEPS; ++S) {
+#pragma omp target teams distribute parallel for nowait depend(inout : A)
+      for (int I = 0; I < N; ++I)
+        A[I] = A[I] * 3 % 1000003 + S;
+    }
+#pragma omp taskwait
+  }
+
+  int Expected = 0;
+  for (int S = 0; S < STEPS; ++S)
+    Expected = Expected * 3 % 1000003 + S;
+
+  int Errors = 0;
+  for (int I = 0; I < N; ++I)
+    Errors += A[I] != Expected;
+
+  // CHECK: Errors: 0
+  printf("Errors: %d\n", Errors);
+  return 0;
+}
@@ -0,0 +1,49 @@
+// RUN: %libomptarget-compilexx-generic
+// RUN: env LIBOMPTARGET_MEMORY_MANAGER_POOL_SIZE=64 \
+// RUN:   %libomptarget-run-generic | %fcheck-generic
+// RUN: env LIBOMPTARGET_MEMORY_MANAGER_POOL_SIZE=1 \
+// RUN:   %libomptarget-run-generic | %fcheck-generic
+
+// UNSUPPORTED: amdgcn-amd-amdhsa
+// UNSUPPORTED: x86_64-pc-linux-gnu
+// UNSUPPORTED: x86_64-pc-linux-gnu-LTO
+
+#include <omp.h>
+
+#include <cassert>
+#include <iostream>
+
+// Repeatedly allocate buffers above the memory manager threshold whose sizes
+// fall into the same and into neighbouring size classes. Reused blocks must
+// not alias live allocations.
+int main(int argc, char *argv[]) {
+  int Device = omp_get_default_device();
+
+#pragma omp parallel for
+  for (int I = 0; I < 8; ++I) {
+    for (int Step = 0; Step < 32; ++Step) {
+      int N = (1 << 16) + Step * 1000 + I;
+      int *A = (int *)omp_target_alloc(N * sizeof(int), Device);
+      int *B = (int *)omp_target_alloc(N * sizeof(int), Device);
+      assert(A && B && A != B);
+#pragma omp target teams distribute parallel for is_device_ptr(A, B)
+      for (int J = 0; J < N; ++J) {
+        A[J] = I + Step;
+        B[J] = -(I + Step);
+      }
+      int Sum = 0;
+#pragma omp target teams distribute parallel for is_device_ptr(A, B)          \
+    reduction(+ : Sum)
+      for (int J = 0; J < N; ++J)
+        Sum += A[J] + B[J];
+      assert(Sum == 0);
+      omp_target_free(B, Device);
+      omp_target_free(A, Device);
+    }
+  }
+
+  std::cout << "PASS\n";
+  return 0;
+}
+
+// CHECK: PASS
@@ -0,0 +1,58 @@
+// RUN: %libomptarget-compile-run-and-check-generic
+// RUN: %libomptarget-compileopt-run-and-check-generic
+
+// Cross-team reductions through the atomic based runtime entry points, for a
+// scalar and for an array, with partial warps at the end of the iteration
+// space.
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define N 1000003
+#define M 8
+
+#pragma omp declare target
+void __kmpc_xteam_reduce_add_f64(double *Result, double V);
+void __kmpc_xteam_reduce_max_i32(int32_t *Result, int32_t V);
+void __kmpc_xteam_reduce_add_array_i64(int64_t *Result, int64_t *Partial,
+                                       uint64_t N);
+#pragma omp end declare target
+
+int main() {
+  double Sum = 0;
+  int32_t Max = 0;
+  int64_t Hist[M] = {0};
+
+#pragma omp target teams distribute parallel for map(tofrom : Sum, Max, Hist)
+  for (int I = 0; I < N; ++I) {
+    int64_t Partial[M] = {0};
+    Partial[I % M] = 1;
+#if defined(__AMDGPU__) || defined(__NVPTX__)
+    __kmpc_xteam_reduce_add_f64(&Sum, 0.5);
+    __kmpc_xteam_reduce_max_i32(&Max, I);
+    __kmpc_xteam_reduce_add_array_i64(Hist, Partial, M);
+#else
+#pragma omp atomic
+    Sum += 0.5;
+#pragma omp critical
+    {
+      if (I > Max)
+        Max = I;
+      for (int J = 0; J < M; ++J)
+        Hist[J] += Partial[J];
+    }
+#endif
+  }
+
+  int64_t Total = 0;
+  for (int J = 0; J < M; ++J)
+    Total += Hist[J];
+
+  // CHECK: Sum = 500001.5
+  printf("Sum = %.1f\n", Sum);
+  // CHECK: Max = 1000002
+  printf("Max = %d\n", Max);
+  // CHECK: Total = 1000003
+  printf("Total = %ld\n", (long)Total);
+  return 0;
+}
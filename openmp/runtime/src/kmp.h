@@ -1117,6 +1117,8 @@ typedef struct kmp_allocator_t {
   kmp_uint64 pool_size;
   kmp_uint64 pool_used;
   bool pinned;
+  omp_alloctrait_value_t partition;
+  bool numa; // the runtime places the memory on NUMA nodes per partition
 } kmp_allocator_t;
 
 extern omp_allocator_handle_t __kmpc_init_allocator(int gtid,
@@ -1148,6 +1150,8 @@ extern void ___kmpc_free(int gtid, void *ptr, omp_allocator_handle_t al);
 
 extern void __kmp_init_memkind();
 extern void __kmp_fini_memkind();
+extern void __kmp_init_numa_mem();
+extern void __kmp_fini_numa_mem();
 extern void __kmp_init_target_mem();
 
 /* ------------------------------------------------------------------------ */
@@ -1265,6 +1269,7 @@ extern kmp_uint64 __kmp_ticks_per_usec;
 #define KMP_BLOCKTIME_INTERVAL(team, tid)                                      \
   ((kmp_uint64)KMP_BLOCKTIME(team, tid) * __kmp_ticks_per_usec)
 #define KMP_BLOCKING(goal, count) ((goal) > KMP_NOW())
+#define KMP_NOW_FROM_USEC(usec) ((kmp_uint64)(usec) * __kmp_ticks_per_usec)
 #else
 // System time is retrieved sporadically while blocking.
 extern kmp_uint64 __kmp_now_nsec();
@@ -1272,9 +1277,14 @@ extern kmp_uint64 __kmp_now_nsec();
 #define KMP_BLOCKTIME_INTERVAL(team, tid)                                      \
   ((kmp_uint64)KMP_BLOCKTIME(team, tid) * (kmp_uint64)KMP_NSEC_PER_USEC)
 #define KMP_BLOCKING(goal, count) ((count) % 1000 != 0 || (goal) > KMP_NOW())
+#define KMP_NOW_FROM_USEC(usec) ((kmp_uint64)(usec) * KMP_NSEC_PER_USEC)
 #endif
 #endif // KMP_USE_MONITOR
 
+#define KMP_WAIT_SITES 8 // per-thread wait history slots, power of 2
+#define KMP_DEFAULT_ADAPTIVE_WAIT_LATENCY 50 // usec
+#define KMP_MAX_ADAPTIVE_WAIT_LATENCY 100000 // usec
+
 #define KMP_MIN_STATSCOLS 40
 #define KMP_MAX_STATSCOLS 4096
 #define KMP_DEFAULT_STATSCOLS 80
@@ -2561,17 +2571,29 @@ struct kmp_dephash_entry {
   kmp_depnode_list_t *last_set;
   kmp_depnode_list_t *prev_set;
   kmp_uint8 last_flag;
+  kmp_uint8 dirty; /* changed since the last omp_all_memory dependence */
   kmp_lock_t *mtx_lock; /* is referenced by depnodes w/mutexinoutset dep */
-  kmp_dephash_entry_t *next_in_bucket;
+  kmp_dephash_entry_t *next_dirty;
 };
 
+// Storage for the entries of a dependence hash and their depnode lists; it
+// is only released with the whole hash.
+typedef struct kmp_dephash_chunk {
+  struct kmp_dephash_chunk *next;
+  size_t used; /* bytes of the chunk already handed out */
+} kmp_dephash_chunk_t;
+
+// Only accessed by the thread executing the task owning the hash.
 typedef struct kmp_dephash {
-  kmp_dephash_entry_t **buckets;
-  size_t size;
+  kmp_dephash_entry_t **slots; /* open addressing, NULL if the slot is free */
+  size_t size; /* number of slots, a power of 2 */
   kmp_depnode_t *last_all;
-  size_t generation;
+  /* Entries not in the dirty list have no depnodes of their own: they depend
+     on last_all only */
+  kmp_dephash_entry_t *dirty;
+  kmp_dephash_chunk_t *chunks;
+  kmp_depnode_list_t *free_list; /* depnode list items to reuse */
   kmp_uint32 nelements;
-  kmp_uint32 nconflicts;
 } kmp_dephash_t;
 
 typedef struct kmp_task_affinity_info {
@@ -2793,14 +2815,31 @@ struct kmp_taskdata { /* aligned during dynamic allocation       */
 // Make sure padding above worked
 KMP_BUILD_ASSERT(sizeof(kmp_taskdata_t) % sizeof(void *) == 0);
 
+// Storage of a lock-free task deque. The size is kept along with the slots so
+// that a thief never indexes a buffer with the mask of another one.
+typedef struct kmp_task_deque_buf {
+  kmp_uint32 size; // Number of slots, a power of 2
+  struct kmp_task_deque_buf *retired; // Smaller buffer this one replaced
+  std::atomic<kmp_taskdata_t *> slots[1]; // size slots, allocated inline
+} kmp_task_deque_buf_t;
+
 // Data for task team but per thread
 typedef struct kmp_base_thread_data {
   kmp_info_p *td_thr; // Pointer back to thread info
+  // Deque of tasks encountered by td_thr, dynamically allocated. This is a
+  // Chase-Lev work-stealing deque: td_thr pushes and pops tasks at the tail
+  // without locking, and thieves take them from the head with a CAS. Head and
+  // tail are free-running counters, masked with the buffer size for indexing.
+  std::atomic<kmp_task_deque_buf_t *> td_own_deque;
+  std::atomic<kmp_uint32> td_own_head; // Next task to steal
+  std::atomic<kmp_uint32> td_own_tail; // Next free slot
+  // Deque of tasks given to td_thr by other threads (proxy tasks completions,
+  // hidden helper tasks), which may push concurrently, so it is protected by
+  // td_deque_lock. Deques of priority tasks only use these fields.
   // Used only in __kmp_execute_tasks_template, maybe not avail until task is
   // queued?
   kmp_bootstrap_lock_t td_deque_lock; // Lock for accessing deque
-  kmp_taskdata_t *
-      *td_deque; // Deque of tasks encountered by td_thr, dynamically allocated
+  kmp_taskdata_t **td_deque; // Deque of given tasks, dynamically allocated
   kmp_int32 td_deque_size; // Size of deck
   kmp_uint32 td_deque_head; // Head of deque (will wrap)
   kmp_uint32 td_deque_tail; // Tail of deque (will wrap)
@@ -2920,6 +2959,48 @@ typedef struct kmp_cg_root {
   struct kmp_cg_root *up; // pointer to higher level CG root in list
 } kmp_cg_root_t;
 
+// Lightweight runtime counters, enabled with KMP_RUNTIME_COUNTERS. Unlike the
+// KMP_STATS_ENABLED instrumentation they are compiled into every build. Each
+// thread only updates its own copy, so the hot paths pay a predictable branch
+// when the counters are off and a plain add when they are on.
+enum kmp_rt_counter_id {
+  rtc_barriers, // barriers the thread took part in
+  rtc_barrier_ticks, // time spent in those barriers
+  rtc_steals, // tasks stolen from other threads
+  rtc_failed_steals, // steal attempts that found no task
+  rtc_spin_waits, // waits that completed while spinning
+  rtc_sleep_waits, // waits that suspended the thread at least once
+  rtc_sleep_ticks, // time spent suspended
+  rtc_dispatch_chunks, // chunks handed out by dynamically scheduled loops
+  rtc_last
+};
+
+typedef struct kmp_rt_counters {
+  kmp_uint64 values[rtc_last];
+} kmp_rt_counters_t;
+
+extern int __kmp_rt_counters_enabled;
+extern char *__kmp_rt_counters_file;
+
+#define KMP_RT_COUNTERS_ENABLED() UNLIKELY(__kmp_rt_counters_enabled)
+#define KMP_RT_COUNTER_ADD(thr, id, n)                                         \
+  do {                                                                         \
+    if (KMP_RT_COUNTERS_ENABLED())                                             \
+      (thr)->th.th_rt_counters.values[id] += (n);                              \
+  } while (0)
+#define KMP_RT_COUNTER_INC(thr, id) KMP_RT_COUNTER_ADD(thr, id, 1)
+// Time stamps for the *_ticks counters; only read when the counters are on.
+#if KMP_OS_UNIX && (KMP_ARCH_X86 || KMP_ARCH_X86_64)
+extern kmp_uint64 __kmp_ticks_per_usec;
+#define KMP_RT_COUNTER_NOW() __kmp_hardware_timestamp()
+#define KMP_RT_COUNTER_TICKS_PER_USEC() __kmp_ticks_per_usec
+#else
+#define KMP_RT_COUNTER_NOW() __kmp_now_nsec()
+#define KMP_RT_COUNTER_TICKS_PER_USEC() ((kmp_uint64)KMP_NSEC_PER_USEC)
+#endif
+#define KMP_RT_COUNTER_START()                                                 \
+  (KMP_RT_COUNTERS_ENABLED() ? KMP_RT_COUNTER_NOW() : 0)
+
 // OpenMP thread data structures
 
 typedef struct KMP_ALIGN_CACHE kmp_base_info {
@@ -3063,6 +3144,12 @@ typedef struct KMP_ALIGN_CACHE kmp_base_info {
   std::atomic<bool> th_blocking;
 #endif
   kmp_cg_root_t *th_cg_roots; // list of cg_roots associated with this thread
+  kmp_rt_counters_t th_rt_counters; // KMP_RUNTIME_COUNTERS, owner writes only
+#if !KMP_USE_MONITOR
+  // KMP_ADAPTIVE_WAIT: moving average of the recent waits on each wait site,
+  // in KMP_NOW() units; 0 means no history yet. See __kmp_wait_site().
+  kmp_uint64 th_wait_predicted[KMP_WAIT_SITES];
+#endif
 } kmp_base_info_t;
 
 typedef union KMP_ALIGN_CACHE kmp_info {
@@ -3464,6 +3551,10 @@ extern int __kmp_dflt_blocktime; /* number of microseconds to wait before
                                     blocking (env setting) */
 extern char __kmp_blocktime_units; /* 'm' or 'u' to note units specified */
 extern bool __kmp_wpolicy_passive; /* explicitly set passive wait policy */
+#if !KMP_USE_MONITOR
+extern int __kmp_adaptive_wait; /* KMP_ADAPTIVE_WAIT: learn spin budgets */
+extern int __kmp_adaptive_wait_latency; /* wake-up cost in microseconds */
+#endif
 
 // Convert raw blocktime from ms to us if needed.
 static inline void __kmp_aux_convert_blocktime(int *bt) {
@@ -3874,6 +3965,8 @@ extern void __kmp_release_64(kmp_flag_64<> *flag);
 extern void __kmp_infinite_loop(void);
 
 extern void __kmp_cleanup(void);
+extern void __kmp_rt_counters_accumulate(kmp_info_t *thread);
+extern void __kmp_rt_counters_print(void);
 
 #if KMP_HANDLE_SIGNALS
 extern int __kmp_handle_signals;
@@ -4147,6 +4240,7 @@ extern void __kmp_tasking_barrier(kmp_team_t *team, kmp_info_t *thread,
 
 extern int __kmp_is_address_mapped(void *addr);
 extern kmp_uint64 __kmp_hardware_timestamp(void);
+extern kmp_uint64 __kmp_now_nsec();
 
 #if KMP_OS_UNIX
 extern int __kmp_read_from_file(char const *path, char const *format, ...);
@@ -14,6 +14,11 @@
 #include "kmp_io.h"
 #include "kmp_wrapper_malloc.h"
 
+#if KMP_OS_LINUX
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
 // Disable bget when it is not used
 #if KMP_USE_BGET
 
@@ -1376,6 +1381,224 @@ void __kmp_init_target_mem() {
   *(void **)(&kmp_target_unlock_mem) = KMP_DLSYM("llvm_omp_target_unlock_mem");
 }
 
+/* NUMA placement of the memory of allocators with a partition trait. Memory
+   is mapped per allocation and bound to nodes with the mbind system call, so
+   libnuma is not needed. Blocks freed by nearest allocators are cached per
+   node. */
+#if KMP_OS_LINUX
+// from linux/mempolicy.h
+#define KMP_MPOL_PREFERRED 1
+#define KMP_MPOL_INTERLEAVE 3
+#define KMP_MPOL_F_MEMS_ALLOWED (1 << 2)
+
+#define KMP_NUMA_MAX_NODES 64
+#define KMP_NUMA_MASK_BITS 1024
+// Cached blocks have a power of 2 number of pages, up to 2^11 pages
+#define KMP_NUMA_CACHE_CLASSES 12
+#define KMP_NUMA_CACHE_DEPTH 8
+
+typedef struct kmp_numa_cache {
+  kmp_bootstrap_lock_t lock;
+  void *blocks[KMP_NUMA_CACHE_CLASSES]; // linked through their first word
+  int nblocks[KMP_NUMA_CACHE_CLASSES];
+} kmp_numa_cache_t;
+
+static int __kmp_numa_nnodes; // 0 if NUMA placement is not available
+static int __kmp_numa_nodes[KMP_NUMA_MAX_NODES]; // ids of the allowed nodes
+static size_t __kmp_numa_page_size;
+static kmp_numa_cache_t *__kmp_numa_caches; // one per allowed node
+#endif
+
+// How the block of an allocation was mapped, if not a node index
+enum { KMP_NUMA_UNMAPPED = -2, KMP_NUMA_SPREAD = -1 };
+
+void __kmp_init_numa_mem() {
+#if KMP_OS_LINUX
+  unsigned long mask[KMP_NUMA_MASK_BITS / (8 * sizeof(unsigned long))];
+  __kmp_numa_nnodes = 0;
+  if (syscall(__NR_get_mempolicy, NULL, mask, KMP_NUMA_MASK_BITS, NULL,
+              KMP_MPOL_F_MEMS_ALLOWED) != 0)
+    return;
+  int nnodes = 0;
+  for (int i = 0; i < KMP_NUMA_MASK_BITS && nnodes < KMP_NUMA_MAX_NODES; ++i)
+    if (mask[i / (8 * sizeof(unsigned long))] &
+        (1UL << (i % (8 * sizeof(unsigned long)))))
+      __kmp_numa_nodes[nnodes++] = i;
+  if (nnodes < 2) // nothing to place
+    return;
+  __kmp_numa_page_size = (size_t)sysconf(_SC_PAGESIZE);
+  __kmp_numa_caches =
+      (kmp_numa_cache_t *)__kmp_allocate(nnodes * sizeof(kmp_numa_cache_t));
+  for (int i = 0; i < nnodes; ++i)
+    __kmp_init_bootstrap_lock(&__kmp_numa_caches[i].lock);
+  __kmp_numa_nnodes = nnodes;
+  KE_TRACE(25, ("__kmp_init_numa_mem: %d NUMA nodes\n", nnodes));
+#endif
+}
+
+#if KMP_OS_LINUX
+// Returns the size of the block mapped for size bytes, and its cache class or
+// -1 if it is not cached
+static size_t __kmp_numa_block_size(size_t size, int *cls) {
+  size_t npages = (size + __kmp_numa_page_size - 1) / __kmp_numa_page_size;
+  int c = 0;
+  while (c < KMP_NUMA_CACHE_CLASSES && ((size_t)1 << c) < npages)
+    ++c;
+  if (c == KMP_NUMA_CACHE_CLASSES) {
+    *cls = -1;
+    return npages * __kmp_numa_page_size;
+  }
+  *cls = c;
+  return __kmp_numa_page_size << c;
+}
+
+static void __kmp_numa_bind(void *addr, size_t len, int mode, int node) {
+  unsigned long mask[KMP_NUMA_MASK_BITS / (8 * sizeof(unsigned long))] = {0};
+  if (node >= 0) {
+    int id = __kmp_numa_nodes[node];
+    mask[id / (8 * sizeof(unsigned long))] |=
+        1UL << (id % (8 * sizeof(unsigned long)));
+  } else {
+    for (int i = 0; i < __kmp_numa_nnodes; ++i) {
+      int id = __kmp_numa_nodes[i];
+      mask[id / (8 * sizeof(unsigned long))] |=
+          1UL << (id % (8 * sizeof(unsigned long)));
+    }
+  }
+  // The memory stays usable with the default policy if this fails
+  syscall(__NR_mbind, addr, len, mode, mask, KMP_NUMA_MASK_BITS, 0);
+}
+
+// Returns the index of the node of the CPU the calling thread runs on, which
+// is the node of its place partition when threads are bound
+static int __kmp_numa_current_node() {
+  unsigned cpu, node;
+  if (syscall(__NR_getcpu, &cpu, &node, NULL) == 0)
+    for (int i = 0; i < __kmp_numa_nnodes; ++i)
+      if (__kmp_numa_nodes[i] == (int)node)
+        return i;
+  return 0;
+}
+
+// Maps size bytes placed according to the partition of al; *numa receives
+// the node index for nearest allocators, KMP_NUMA_SPREAD otherwise
+static void *__kmp_numa_alloc(kmp_allocator_t *al, size_t size, int *numa) {
+  int cls;
+  size_t len = __kmp_numa_block_size(size, &cls);
+  void *ptr;
+  if (al->partition == omp_atv_nearest) {
+    int node = __kmp_numa_current_node();
+    *numa = node;
+    if (cls >= 0) {
+      kmp_numa_cache_t *cache = &__kmp_numa_caches[node];
+      __kmp_acquire_bootstrap_lock(&cache->lock);
+      ptr = cache->blocks[cls];
+      if (ptr) {
+        cache->blocks[cls] = *(void **)ptr;
+        cache->nblocks[cls]--;
+      }
+      __kmp_release_bootstrap_lock(&cache->lock);
+      if (ptr)
+        return ptr;
+    }
+    ptr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+               -1, 0);
+    if (ptr == MAP_FAILED)
+      return NULL;
+    __kmp_numa_bind(ptr, len, KMP_MPOL_PREFERRED, node);
+    return ptr;
+  }
+  *numa = KMP_NUMA_SPREAD;
+  ptr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+             -1, 0);
+  if (ptr == MAP_FAILED)
+    return NULL;
+  if (al->partition == omp_atv_interleaved) {
+    __kmp_numa_bind(ptr, len, KMP_MPOL_INTERLEAVE, -1);
+  } else { // omp_atv_blocked: one contiguous block per node
+    size_t npages = len / __kmp_numa_page_size;
+    size_t block = (npages + __kmp_numa_nnodes - 1) / __kmp_numa_nnodes *
+                   __kmp_numa_page_size;
+    for (int i = 0; i < __kmp_numa_nnodes && i * block < len; ++i)
+      __kmp_numa_bind((char *)ptr + i * block,
+                      KMP_MIN(block, len - i * block), KMP_MPOL_PREFERRED, i);
+  }
+  return ptr;
+}
+
+static void __kmp_numa_free(void *ptr, size_t size, int numa) {
+  int cls;
+  size_t len = __kmp_numa_block_size(size, &cls);
+  if (numa >= 0 && cls >= 0) {
+    kmp_numa_cache_t *cache = &__kmp_numa_caches[numa];
+    bool cached = false;
+    __kmp_acquire_bootstrap_lock(&cache->lock);
+    if (cache->nblocks[cls] < KMP_NUMA_CACHE_DEPTH) {
+      *(void **)ptr = cache->blocks[cls];
+      cache->blocks[cls] = ptr;
+      cache->nblocks[cls]++;
+      cached = true;
+    }
+    __kmp_release_bootstrap_lock(&cache->lock);
+    if (cached)
+      return;
+  }
+  munmap(ptr, len);
+}
+#endif
+
+void __kmp_fini_numa_mem() {
+#if KMP_OS_LINUX
+  if (!__kmp_numa_nnodes)
+    return;
+  for (int i = 0; i < __kmp_numa_nnodes; ++i) {
+    kmp_numa_cache_t *cache = &__kmp_numa_caches[i];
+    for (int c = 0; c < KMP_NUMA_CACHE_CLASSES; ++c) {
+      void *next;
+      for (void *ptr = cache->blocks[c]; ptr; ptr = next) {
+        next = *(void **)ptr;
+        munmap(ptr, __kmp_numa_page_size << c);
+      }
+    }
+    __kmp_destroy_bootstrap_lock(&cache->lock);
+  }
+  __kmp_free(__kmp_numa_caches);
+  __kmp_numa_caches = NULL;
+  __kmp_numa_nnodes = 0;
+#endif
+}
+
+// Memory of custom allocators, placed on NUMA nodes if requested
+static void *__kmp_custom_alloc(int gtid, kmp_allocator_t *al, size_t size,
+                                int *numa) {
+  *numa = KMP_NUMA_UNMAPPED;
+#if KMP_OS_LINUX
+  if (al->numa) {
+    void *ptr = __kmp_numa_alloc(al, size, numa);
+    if (ptr)
+      return ptr;
+    *numa = KMP_NUMA_UNMAPPED;
+  }
+#endif
+  if (__kmp_memkind_available)
+    return kmp_mk_alloc(*al->memkind, size);
+  return __kmp_thread_malloc(__kmp_thread_from_gtid(gtid), size);
+}
+
+static void __kmp_custom_free(int gtid, kmp_allocator_t *al, void *ptr,
+                              size_t size, int numa) {
+#if KMP_OS_LINUX
+  if (numa != KMP_NUMA_UNMAPPED) {
+    __kmp_numa_free(ptr, size, numa);
+    return;
+  }
+#endif
+  if (__kmp_memkind_available)
+    kmp_mk_free(*al->memkind, ptr);
+  else
+    __kmp_thread_free(__kmp_thread_from_gtid(gtid), ptr);
+}
+
 omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
                                              int ntraits,
                                              omp_alloctrait_t traits[]) {
@@ -1412,7 +1635,7 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
       al->fb_data = RCAST(kmp_allocator_t *, traits[i].value);
       break;
     case omp_atk_partition:
-      al->memkind = RCAST(void **, traits[i].value);
+      al->partition = (omp_alloctrait_value_t)traits[i].value;
       break;
     default:
       KMP_ASSERT2(0, "Unexpected allocator trait");
@@ -1430,7 +1653,7 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
   if (__kmp_memkind_available) {
     // Let's use memkind library if available
     if (ms == omp_high_bw_mem_space) {
-      if (al->memkind == (void *)omp_atv_interleaved && mk_hbw_interleave) {
+      if (al->partition == omp_atv_interleaved && mk_hbw_interleave) {
         al->memkind = mk_hbw_interleave;
       } else if (mk_hbw_preferred) {
         // AC: do not try to use MEMKIND_HBW for now, because memkind library
@@ -1456,10 +1679,11 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
         return omp_null_allocator;
       }
     } else {
-      if (al->memkind == (void *)omp_atv_interleaved && mk_interleave) {
+      if (al->partition == omp_atv_interleaved && mk_interleave) {
         al->memkind = mk_interleave;
       } else {
         al->memkind = mk_default;
+        al->numa = ms == omp_default_mem_space;
       }
     }
   } else if (KMP_IS_TARGET_MEM_SPACE(ms) && !__kmp_target_mem_available) {
@@ -1471,7 +1695,16 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
       __kmp_free(al);
       return omp_null_allocator;
     }
+    al->numa = ms == omp_default_mem_space;
   }
+#if KMP_OS_LINUX
+  al->numa = al->numa && __kmp_numa_nnodes &&
+             (al->partition == omp_atv_nearest ||
+              al->partition == omp_atv_blocked ||
+              al->partition == omp_atv_interleaved);
+#else
+  al->numa = false;
+#endif
   return (omp_allocator_handle_t)al;
 }
 
@@ -1496,6 +1729,7 @@ typedef struct kmp_mem_desc { // Memory block descriptor
   size_t size_orig; // Original size requested
   void *ptr_align; // Pointer to aligned memory, returned
   kmp_allocator_t *allocator; // allocator
+  int numa; // NUMA mapping of the block, see __kmp_custom_alloc
 } kmp_mem_desc_t;
 static int alignment = sizeof(void *); // align to pointer size by default
 
@@ -1569,6 +1803,7 @@ void *__kmp_alloc(int gtid, size_t algn, size_t size,
     align = algn; // max of allocator trait, parameter and sizeof(void*)
   desc.size_orig = size;
   desc.size_a = size + sz_desc + align;
+  desc.numa = KMP_NUMA_UNMAPPED;
   bool is_pinned = false;
   if (allocator > kmp_max_mem_alloc)
     is_pinned = al->pinned;
@@ -1642,7 +1877,7 @@ void *__kmp_alloc(int gtid, size_t algn, size_t size,
         } // else ptr == NULL;
       } else {
         // pool has enough space
-        ptr = kmp_mk_alloc(*al->memkind, desc.size_a);
+        ptr = __kmp_custom_alloc(gtid, al, desc.size_a, &desc.numa);
         if (ptr == NULL) {
           if (al->fb == omp_atv_default_mem_fb) {
             al = (kmp_allocator_t *)omp_default_mem_alloc;
@@ -1661,7 +1896,7 @@ void *__kmp_alloc(int gtid, size_t algn, size_t size,
       }
     } else {
       // custom allocator, pool size not requested
-      ptr = kmp_mk_alloc(*al->memkind, desc.size_a);
+      ptr = __kmp_custom_alloc(gtid, al, desc.size_a, &desc.numa);
       if (ptr == NULL) {
         if (al->fb == omp_atv_default_mem_fb) {
           al = (kmp_allocator_t *)omp_default_mem_alloc;
@@ -1723,14 +1958,14 @@ void *__kmp_alloc(int gtid, size_t algn, size_t size,
       } // else ptr == NULL;
     } else {
       // pool has enough space
-      ptr = __kmp_thread_malloc(__kmp_thread_from_gtid(gtid), desc.size_a);
+      ptr = __kmp_custom_alloc(gtid, al, desc.size_a, &desc.numa);
       if (ptr == NULL && al->fb == omp_atv_abort_fb) {
         KMP_ASSERT(0); // abort fallback requested
       } // no sense to look for another fallback because of same internal alloc
     }
   } else {
     // custom allocator, pool size not requested
-    ptr = __kmp_thread_malloc(__kmp_thread_from_gtid(gtid), desc.size_a);
+    ptr = __kmp_custom_alloc(gtid, al, desc.size_a, &desc.numa);
     if (ptr == NULL && al->fb == omp_atv_abort_fb) {
       KMP_ASSERT(0); // abort fallback requested
     } // no sense to look for another fallback because of same internal alloc
@@ -1881,7 +2116,7 @@ void ___kmpc_free(int gtid, void *ptr, omp_allocator_handle_t allocator) {
         (void)used; // to suppress compiler warning
         KMP_DEBUG_ASSERT(used >= desc.size_a);
       }
-      kmp_mk_free(*al->memkind, desc.ptr_alloc);
+      __kmp_custom_free(gtid, al, desc.ptr_alloc, desc.size_a, desc.numa);
     }
   } else {
     if (oal > kmp_max_mem_alloc && al->pool_size > 0) {
@@ -1890,7 +2125,10 @@ void ___kmpc_free(int gtid, void *ptr, omp_allocator_handle_t allocator) {
       (void)used; // to suppress compiler warning
       KMP_DEBUG_ASSERT(used >= desc.size_a);
     }
-    __kmp_thread_free(__kmp_thread_from_gtid(gtid), desc.ptr_alloc);
+    if (oal > kmp_max_mem_alloc)
+      __kmp_custom_free(gtid, al, desc.ptr_alloc, desc.size_a, desc.numa);
+    else
+      __kmp_thread_free(__kmp_thread_from_gtid(gtid), desc.ptr_alloc);
   }
 }
 
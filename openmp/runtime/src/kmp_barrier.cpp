@@ -1810,6 +1810,7 @@ static int __kmp_barrier_template(enum barrier_type bt, int gtid, int is_split,
 #endif
 
   if (!team->t.t_serialized) {
+    kmp_uint64 rtc_start = KMP_RT_COUNTER_START();
 #if USE_ITT_BUILD
     // This value will be used in itt notify events below.
     void *itt_sync_obj = NULL;
@@ -2024,6 +2025,9 @@ static int __kmp_barrier_template(enum barrier_type bt, int gtid, int is_split,
     if (__itt_sync_create_ptr || KMP_ITT_DEBUG)
       __kmp_itt_barrier_finished(gtid, itt_sync_obj);
 #endif /* USE_ITT_BUILD */
+    KMP_RT_COUNTER_INC(this_thr, rtc_barriers);
+    KMP_RT_COUNTER_ADD(this_thr, rtc_barrier_ticks,
+                       KMP_RT_COUNTER_NOW() - rtc_start);
   } else { // Team is serialized.
     status = 0;
     if (__kmp_tasking_mode != tskm_immediate_exec) {
@@ -2163,6 +2167,7 @@ void __kmp_join_barrier(int gtid) {
   kmp_info_t *this_thr = __kmp_threads[gtid];
   kmp_team_t *team;
   int tid;
+  kmp_uint64 rtc_start = KMP_RT_COUNTER_START();
 #ifdef KMP_DEBUG
   int team_id;
 #endif /* KMP_DEBUG */
@@ -2383,6 +2388,10 @@ void __kmp_join_barrier(int gtid) {
   }
 #endif /* KMP_DEBUG */
 
+  KMP_RT_COUNTER_INC(this_thr, rtc_barriers);
+  KMP_RT_COUNTER_ADD(this_thr, rtc_barrier_ticks,
+                     KMP_RT_COUNTER_NOW() - rtc_start);
+
   // TODO now, mark worker threads as done so they may be disbanded
   KMP_MB(); // Flush all pending memory write invalidates.
   KA_TRACE(10,
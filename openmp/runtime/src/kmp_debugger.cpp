@@ -212,6 +212,14 @@ kmp_omp_struct_info_t __kmp_omp_debug_struct_info = {
     offset_and_size_of(kmp_base_thread_data_t, td_deque_tail),
     offset_and_size_of(kmp_base_thread_data_t, td_deque_ntasks),
     offset_and_size_of(kmp_base_thread_data_t, td_deque_last_stolen),
+    offset_and_size_of(kmp_base_thread_data_t, td_own_deque),
+    offset_and_size_of(kmp_base_thread_data_t, td_own_head),
+    offset_and_size_of(kmp_base_thread_data_t, td_own_tail),
+
+    // task_deque_buf_t.
+    offset_and_size_of(kmp_task_deque_buf_t, size),
+    offset_and_size_of(kmp_task_deque_buf_t, retired),
+    offset_and_size_of(kmp_task_deque_buf_t, slots),
 
     // The last field.
     KMP_OMP_VERSION,
@@ -2439,6 +2439,8 @@ static int __kmp_dispatch_next(ident_t *loc, int gtid, kmp_int32 *p_last,
     __kmp_str_free(&buff);
   }
 #endif
+  if (status)
+    KMP_RT_COUNTER_INC(th, rtc_dispatch_chunks);
 #if INCLUDE_SSC_MARKS
   SSC_MARK_DISPATCH_NEXT();
 #endif
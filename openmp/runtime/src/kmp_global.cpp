@@ -158,6 +158,10 @@ kmp_hier_sched_env_t __kmp_hier_scheds = {0, 0, NULL, NULL, NULL};
 int __kmp_dflt_blocktime = KMP_DEFAULT_BLOCKTIME; // in microseconds
 char __kmp_blocktime_units = 'm'; // Units specified in KMP_BLOCKTIME
 bool __kmp_wpolicy_passive = false;
+#if !KMP_USE_MONITOR
+int __kmp_adaptive_wait = FALSE;
+int __kmp_adaptive_wait_latency = KMP_DEFAULT_ADAPTIVE_WAIT_LATENCY;
+#endif
 #if KMP_USE_MONITOR
 int __kmp_monitor_wakeups = KMP_MIN_MONITOR_WAKEUPS;
 int __kmp_bt_intervals = KMP_INTERVALS_FROM_BLOCKTIME(KMP_DEFAULT_BLOCKTIME,
@@ -417,6 +421,10 @@ int __kmp_need_register_atfork =
     TRUE; /* At initialization, call pthread_atfork to install fork handler */
 int __kmp_need_register_atfork_specified = TRUE;
 
+/* Lightweight runtime counters (KMP_RUNTIME_COUNTERS) */
+int __kmp_rt_counters_enabled = FALSE;
+char *__kmp_rt_counters_file = NULL; /* NULL means stderr */
+
 int __kmp_env_stksize = FALSE; /* KMP_STACKSIZE specified? */
 int __kmp_env_blocktime = FALSE; /* KMP_BLOCKTIME specified? */
 int __kmp_env_checks = FALSE; /* KMP_CHECKS specified?    */
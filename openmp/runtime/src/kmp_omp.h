@@ -23,7 +23,7 @@
    Before we release this to a customer, please don't change this value.  After
    it is released and stable, then any new updates to the structures or data
    structure traversal algorithms need to change this value. */
-#define KMP_OMP_VERSION 9
+#define KMP_OMP_VERSION 10
 
 typedef struct {
   kmp_int32 offset;
@@ -224,6 +224,14 @@ typedef struct {
   offset_and_size_t hd_deque_tail;
   offset_and_size_t hd_deque_ntasks;
   offset_and_size_t hd_deque_last_stolen;
+  offset_and_size_t hd_own_deque;
+  offset_and_size_t hd_own_head;
+  offset_and_size_t hd_own_tail;
+
+  /* kmp_task_deque_buf_t */
+  offset_and_size_t db_size;
+  offset_and_size_t db_retired;
+  offset_and_size_t db_slots;
 
   // The last field of stable version.
   kmp_uint64 last_field;
@@ -562,9 +562,13 @@ static void __kmp_print_team_storage_map(const char *header, kmp_team_t *team,
 
 static void __kmp_init_allocator() {
   __kmp_init_memkind();
+  __kmp_init_numa_mem();
   __kmp_init_target_mem();
 }
-static void __kmp_fini_allocator() { __kmp_fini_memkind(); }
+static void __kmp_fini_allocator() {
+  __kmp_fini_numa_mem();
+  __kmp_fini_memkind();
+}
 
 /* ------------------------------------------------------------------------ */
 
@@ -6104,6 +6108,103 @@ void __kmp_internal_end_atexit(void) {
 #endif
 }
 
+// Counters of threads that have already been reaped, indexed by gtid. Only
+// accessed under __kmp_forkjoin_lock or during library shutdown.
+static kmp_rt_counters_t *__kmp_rt_counters_reaped = NULL;
+static int __kmp_rt_counters_reaped_size = 0;
+
+void __kmp_rt_counters_accumulate(kmp_info_t *thread) {
+  int gtid = thread->th.th_info.ds.ds_gtid;
+  if (!__kmp_rt_counters_enabled || gtid < 0)
+    return;
+  if (gtid >= __kmp_rt_counters_reaped_size) {
+    int size = __kmp_rt_counters_reaped_size ? __kmp_rt_counters_reaped_size
+                                             : 32;
+    while (size <= gtid)
+      size *= 2;
+    kmp_rt_counters_t *counters = (kmp_rt_counters_t *)KMP_INTERNAL_REALLOC(
+        __kmp_rt_counters_reaped, size * sizeof(kmp_rt_counters_t));
+    if (counters == NULL)
+      return; // The counters are diagnostic only; drop this thread's values.
+    memset(counters + __kmp_rt_counters_reaped_size, 0,
+           (size - __kmp_rt_counters_reaped_size) * sizeof(kmp_rt_counters_t));
+    __kmp_rt_counters_reaped = counters;
+    __kmp_rt_counters_reaped_size = size;
+  }
+  for (int i = 0; i < rtc_last; ++i)
+    __kmp_rt_counters_reaped[gtid].values[i] +=
+        thread->th.th_rt_counters.values[i];
+}
+
+// Print one line per gtid that counted anything plus a total line. Threads
+// that are still alive (e.g. an active root at exit) are read directly.
+void __kmp_rt_counters_print(void) {
+  if (!__kmp_rt_counters_enabled ||
+      (__kmp_threads == NULL && __kmp_rt_counters_reaped == NULL))
+    return;
+
+  kmp_safe_raii_file_t file;
+  if (__kmp_rt_counters_file) {
+    char buffer[256];
+    __kmp_expand_file_name(buffer, sizeof(buffer), __kmp_rt_counters_file);
+    if (file.try_open(buffer, "w"))
+      file.set_stderr();
+  } else {
+    file.set_stderr();
+  }
+
+  kmp_uint64 tpus = KMP_RT_COUNTER_TICKS_PER_USEC();
+  if (tpus == 0)
+    tpus = 1;
+  fprintf(file, "OMP runtime counters (times in usec):\n");
+  fprintf(file, "%6s %10s %12s %10s %10s %10s %10s %12s %12s\n", "gtid",
+          "barriers", "barrier-us", "steals", "no-steal", "spin-wait",
+          "sleep-wait", "sleep-us", "chunks");
+
+  kmp_rt_counters_t total;
+  memset(&total, 0, sizeof(total));
+  int n = KMP_MAX(__kmp_threads_capacity, __kmp_rt_counters_reaped_size);
+  for (int gtid = 0; gtid < n; ++gtid) {
+    kmp_rt_counters_t c;
+    memset(&c, 0, sizeof(c));
+    bool any = false;
+    if (gtid < __kmp_rt_counters_reaped_size)
+      c = __kmp_rt_counters_reaped[gtid];
+    if (__kmp_threads && gtid < __kmp_threads_capacity && __kmp_threads[gtid])
+      for (int i = 0; i < rtc_last; ++i)
+        c.values[i] += __kmp_threads[gtid]->th.th_rt_counters.values[i];
+    for (int i = 0; i < rtc_last; ++i) {
+      any |= c.values[i] != 0;
+      total.values[i] += c.values[i];
+    }
+    if (!any)
+      continue;
+    fprintf(file,
+            "%6d %10" KMP_UINT64_SPEC " %12" KMP_UINT64_SPEC
+            " %10" KMP_UINT64_SPEC " %10" KMP_UINT64_SPEC
+            " %10" KMP_UINT64_SPEC " %10" KMP_UINT64_SPEC
+            " %12" KMP_UINT64_SPEC " %12" KMP_UINT64_SPEC "\n",
+            gtid, c.values[rtc_barriers], c.values[rtc_barrier_ticks] / tpus,
+            c.values[rtc_steals], c.values[rtc_failed_steals],
+            c.values[rtc_spin_waits], c.values[rtc_sleep_waits],
+            c.values[rtc_sleep_ticks] / tpus, c.values[rtc_dispatch_chunks]);
+  }
+  fprintf(file,
+          "%6s %10" KMP_UINT64_SPEC " %12" KMP_UINT64_SPEC
+          " %10" KMP_UINT64_SPEC " %10" KMP_UINT64_SPEC " %10" KMP_UINT64_SPEC
+          " %10" KMP_UINT64_SPEC " %12" KMP_UINT64_SPEC
+          " %12" KMP_UINT64_SPEC "\n",
+          "total", total.values[rtc_barriers],
+          total.values[rtc_barrier_ticks] / tpus, total.values[rtc_steals],
+          total.values[rtc_failed_steals], total.values[rtc_spin_waits],
+          total.values[rtc_sleep_waits], total.values[rtc_sleep_ticks] / tpus,
+          total.values[rtc_dispatch_chunks]);
+
+  KMP_INTERNAL_FREE(__kmp_rt_counters_reaped);
+  __kmp_rt_counters_reaped = NULL;
+  __kmp_rt_counters_reaped_size = 0;
+}
+
 static void __kmp_reap_thread(kmp_info_t *thread, int is_root) {
   // It is assumed __kmp_forkjoin_lock is acquired.
 
@@ -6153,6 +6254,8 @@ static void __kmp_reap_thread(kmp_info_t *thread, int is_root) {
     }
   }
 
+  __kmp_rt_counters_accumulate(thread);
+
   __kmp_free_implicit_task(thread);
 
 // Free the fast memory for tasking
@@ -8165,6 +8268,8 @@ void __kmp_cleanup(void) {
 
   KA_TRACE(10, ("__kmp_cleanup: enter\n"));
 
+  __kmp_rt_counters_print();
+
   if (TCR_4(__kmp_init_parallel)) {
 #if KMP_HANDLE_SIGNALS
     __kmp_remove_signals();
@@ -667,6 +667,34 @@ static void __kmp_stg_print_use_yield(kmp_str_buf_t *buffer, char const *name,
   __kmp_stg_print_int(buffer, name, __kmp_use_yield);
 } // __kmp_stg_print_use_yield
 
+#if !KMP_USE_MONITOR
+// -----------------------------------------------------------------------------
+// KMP_ADAPTIVE_WAIT, KMP_ADAPTIVE_WAIT_LATENCY
+
+static void __kmp_stg_parse_adaptive_wait(char const *name, char const *value,
+                                          void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_adaptive_wait);
+} // __kmp_stg_parse_adaptive_wait
+
+static void __kmp_stg_print_adaptive_wait(kmp_str_buf_t *buffer,
+                                          char const *name, void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_adaptive_wait);
+} // __kmp_stg_print_adaptive_wait
+
+static void __kmp_stg_parse_adaptive_wait_latency(char const *name,
+                                                  char const *value,
+                                                  void *data) {
+  __kmp_stg_parse_int(name, value, 1, KMP_MAX_ADAPTIVE_WAIT_LATENCY,
+                      &__kmp_adaptive_wait_latency);
+} // __kmp_stg_parse_adaptive_wait_latency
+
+static void __kmp_stg_print_adaptive_wait_latency(kmp_str_buf_t *buffer,
+                                                  char const *name,
+                                                  void *data) {
+  __kmp_stg_print_int(buffer, name, __kmp_adaptive_wait_latency);
+} // __kmp_stg_print_adaptive_wait_latency
+#endif // !KMP_USE_MONITOR
+
 // -----------------------------------------------------------------------------
 // KMP_BLOCKTIME
 
@@ -1893,6 +1921,31 @@ static void __kmp_stg_print_cpuinfo_file(kmp_str_buf_t *buffer,
 #endif
 } //__kmp_stg_print_cpuinfo_file
 
+// -----------------------------------------------------------------------------
+// KMP_RUNTIME_COUNTERS, KMP_RUNTIME_COUNTERS_FILE
+
+static void __kmp_stg_parse_rt_counters(char const *name, char const *value,
+                                        void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_rt_counters_enabled);
+} // __kmp_stg_parse_rt_counters
+
+static void __kmp_stg_print_rt_counters(kmp_str_buf_t *buffer,
+                                        char const *name, void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_rt_counters_enabled);
+} // __kmp_stg_print_rt_counters
+
+static void __kmp_stg_parse_rt_counters_file(char const *name,
+                                             char const *value, void *data) {
+  __kmp_stg_parse_str(name, value, &__kmp_rt_counters_file);
+} // __kmp_stg_parse_rt_counters_file
+
+static void __kmp_stg_print_rt_counters_file(kmp_str_buf_t *buffer,
+                                             char const *name, void *data) {
+  __kmp_stg_print_str(buffer, name,
+                      __kmp_rt_counters_file ? __kmp_rt_counters_file
+                                             : "stderr");
+} // __kmp_stg_print_rt_counters_file
+
 // -----------------------------------------------------------------------------
 // KMP_FORCE_REDUCTION, KMP_DETERMINISTIC_REDUCTION
 
@@ -5512,6 +5565,12 @@ static kmp_setting_t __kmp_stg_table[] = {
      NULL, 0, 0},
     {"KMP_USE_YIELD", __kmp_stg_parse_use_yield, __kmp_stg_print_use_yield,
      NULL, 0, 0},
+#if !KMP_USE_MONITOR
+    {"KMP_ADAPTIVE_WAIT", __kmp_stg_parse_adaptive_wait,
+     __kmp_stg_print_adaptive_wait, NULL, 0, 0},
+    {"KMP_ADAPTIVE_WAIT_LATENCY", __kmp_stg_parse_adaptive_wait_latency,
+     __kmp_stg_print_adaptive_wait_latency, NULL, 0, 0},
+#endif
     {"KMP_DUPLICATE_LIB_OK", __kmp_stg_parse_duplicate_lib_ok,
      __kmp_stg_print_duplicate_lib_ok, NULL, 0, 0},
     {"KMP_LIBRARY", __kmp_stg_parse_wait_policy, __kmp_stg_print_wait_policy,
@@ -5743,6 +5802,10 @@ static kmp_setting_t __kmp_stg_table[] = {
 #endif
     {"KMP_ENABLE_TASK_THROTTLING", __kmp_stg_parse_task_throttling,
      __kmp_stg_print_task_throttling, NULL, 0, 0},
+    {"KMP_RUNTIME_COUNTERS", __kmp_stg_parse_rt_counters,
+     __kmp_stg_print_rt_counters, NULL, 0, 0},
+    {"KMP_RUNTIME_COUNTERS_FILE", __kmp_stg_parse_rt_counters_file,
+     __kmp_stg_print_rt_counters_file, NULL, 0, 0},
 
     {"OMP_DISPLAY_ENV", __kmp_stg_parse_omp_display_env,
      __kmp_stg_print_omp_display_env, NULL, 0, 0},
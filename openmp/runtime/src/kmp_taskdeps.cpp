@@ -55,26 +55,48 @@ static inline kmp_depnode_t *__kmp_node_ref(kmp_depnode_t *node) {
   return node;
 }
 
-enum { KMP_DEPHASH_OTHER_SIZE = 97, KMP_DEPHASH_MASTER_SIZE = 997 };
+enum { KMP_DEPHASH_OTHER_SIZE = 128, KMP_DEPHASH_MASTER_SIZE = 1024 };
 
-size_t sizes[] = {997, 2003, 4001, 8191, 16001, 32003, 64007, 131071, 270029};
-const size_t MAX_GEN = 8;
+// Entries and depnode list items are carved out of chunks filling the 16
+// cache line blocks of the fast memory allocator
+#define KMP_DEPHASH_CHUNK_SIZE 2048
 
 static inline size_t __kmp_dephash_hash(kmp_intptr_t addr, size_t hsize) {
-  // TODO alternate to try: set = (((Addr64)(addrUsefulBits * 9.618)) %
-  // m_num_sets );
-  return ((addr >> 6) ^ (addr >> 2)) % hsize;
+  // mix the high bits into the low ones, dependence addresses are often
+  // aligned to large powers of 2
+  kmp_uint64 h = (kmp_uint64)addr;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return (size_t)h & (hsize - 1);
+}
+
+static void *__kmp_dephash_alloc(kmp_info_t *thread, kmp_dephash_t *h,
+                                 size_t size) {
+  KMP_DEBUG_ASSERT(size % sizeof(void *) == 0);
+  kmp_dephash_chunk_t *chunk = h->chunks;
+  if (!chunk || chunk->used + size > KMP_DEPHASH_CHUNK_SIZE) {
+#if USE_FAST_MEMORY
+    chunk = (kmp_dephash_chunk_t *)__kmp_fast_allocate(thread,
+                                                       KMP_DEPHASH_CHUNK_SIZE);
+#else
+    chunk = (kmp_dephash_chunk_t *)__kmp_thread_malloc(thread,
+                                                       KMP_DEPHASH_CHUNK_SIZE);
+#endif
+    chunk->next = h->chunks;
+    chunk->used = sizeof(kmp_dephash_chunk_t);
+    h->chunks = chunk;
+  }
+  void *ptr = (char *)chunk + chunk->used;
+  chunk->used += size;
+  return ptr;
 }
 
 static kmp_dephash_t *__kmp_dephash_extend(kmp_info_t *thread,
                                            kmp_dephash_t *current_dephash) {
   kmp_dephash_t *h;
 
-  size_t gen = current_dephash->generation + 1;
-  if (gen >= MAX_GEN)
-    return current_dephash;
-  size_t new_size = sizes[gen];
-
+  size_t new_size = current_dephash->size * 2;
   size_t size_to_allocate =
       new_size * sizeof(kmp_dephash_entry_t *) + sizeof(kmp_dephash_t);
 
@@ -84,32 +106,25 @@ static kmp_dephash_t *__kmp_dephash_extend(kmp_info_t *thread,
   h = (kmp_dephash_t *)__kmp_thread_malloc(thread, size_to_allocate);
 #endif
 
+  *h = *current_dephash;
   h->size = new_size;
-  h->nelements = current_dephash->nelements;
-  h->buckets = (kmp_dephash_entry **)(h + 1);
-  h->generation = gen;
-  h->nconflicts = 0;
-  h->last_all = current_dephash->last_all;
+  h->slots = (kmp_dephash_entry_t **)(h + 1);
 
-  // make sure buckets are properly initialized
+  // make sure slots are properly initialized
   for (size_t i = 0; i < new_size; i++) {
-    h->buckets[i] = NULL;
+    h->slots[i] = NULL;
   }
 
   // insert existing elements in the new table
+  size_t mask = new_size - 1;
   for (size_t i = 0; i < current_dephash->size; i++) {
-    kmp_dephash_entry_t *next, *entry;
-    for (entry = current_dephash->buckets[i]; entry; entry = next) {
-      next = entry->next_in_bucket;
-      // Compute the new hash using the new size, and insert the entry in
-      // the new bucket.
-      size_t new_bucket = __kmp_dephash_hash(entry->addr, h->size);
-      entry->next_in_bucket = h->buckets[new_bucket];
-      if (entry->next_in_bucket) {
-        h->nconflicts++;
-      }
-      h->buckets[new_bucket] = entry;
-    }
+    kmp_dephash_entry_t *entry = current_dephash->slots[i];
+    if (!entry)
+      continue;
+    size_t slot = __kmp_dephash_hash(entry->addr, new_size);
+    while (h->slots[slot])
+      slot = (slot + 1) & mask;
+    h->slots[slot] = entry;
   }
 
   // Free old hash table
@@ -142,14 +157,15 @@ static kmp_dephash_t *__kmp_dephash_create(kmp_info_t *thread,
 #endif
   h->size = h_size;
 
-  h->generation = 0;
   h->nelements = 0;
-  h->nconflicts = 0;
-  h->buckets = (kmp_dephash_entry **)(h + 1);
+  h->slots = (kmp_dephash_entry_t **)(h + 1);
   h->last_all = NULL;
+  h->dirty = NULL;
+  h->chunks = NULL;
+  h->free_list = NULL;
 
   for (size_t i = 0; i < h_size; i++)
-    h->buckets[i] = 0;
+    h->slots[i] = NULL;
 
   return h;
 }
@@ -158,40 +174,40 @@ static kmp_dephash_entry *__kmp_dephash_find(kmp_info_t *thread,
                                              kmp_dephash_t **hash,
                                              kmp_intptr_t addr) {
   kmp_dephash_t *h = *hash;
-  if (h->nelements != 0 && h->nconflicts / h->size >= 1) {
+  // keep the table at most half full so that the probe sequences stay short
+  if (2 * (h->nelements + 1) > h->size) {
     *hash = __kmp_dephash_extend(thread, h);
     h = *hash;
   }
-  size_t bucket = __kmp_dephash_hash(addr, h->size);
+  size_t mask = h->size - 1;
+  size_t slot = __kmp_dephash_hash(addr, h->size);
 
   kmp_dephash_entry_t *entry;
-  for (entry = h->buckets[bucket]; entry; entry = entry->next_in_bucket)
-    if (entry->addr == addr)
-      break;
+  while ((entry = h->slots[slot]) && entry->addr != addr)
+    slot = (slot + 1) & mask;
 
   if (entry == NULL) {
-// create entry. This is only done by one thread so no locking required
-#if USE_FAST_MEMORY
-    entry = (kmp_dephash_entry_t *)__kmp_fast_allocate(
-        thread, sizeof(kmp_dephash_entry_t));
-#else
-    entry = (kmp_dephash_entry_t *)__kmp_thread_malloc(
-        thread, sizeof(kmp_dephash_entry_t));
-#endif
+    // create entry. This is only done by one thread so no locking required
+    entry = (kmp_dephash_entry_t *)__kmp_dephash_alloc(
+        thread, h, sizeof(kmp_dephash_entry_t));
     entry->addr = addr;
-    if (!h->last_all) // no predecessor task with omp_all_memory dependence
-      entry->last_out = NULL;
-    else // else link the omp_all_memory depnode to the new entry
-      entry->last_out = __kmp_node_ref(h->last_all);
+    entry->last_out = NULL;
     entry->last_set = NULL;
     entry->prev_set = NULL;
     entry->last_flag = 0;
+    entry->dirty = 0;
     entry->mtx_lock = NULL;
-    entry->next_in_bucket = h->buckets[bucket];
-    h->buckets[bucket] = entry;
+    h->slots[slot] = entry;
     h->nelements++;
-    if (entry->next_in_bucket)
-      h->nconflicts++;
+  }
+  if (!entry->dirty) {
+    // the entry was not used since the last omp_all_memory dependence, link
+    // its depnode to the entry if any
+    if (h->last_all)
+      entry->last_out = __kmp_node_ref(h->last_all);
+    entry->dirty = 1;
+    entry->next_dirty = h->dirty;
+    h->dirty = entry;
   }
   return entry;
 }
@@ -215,6 +231,44 @@ static kmp_depnode_list_t *__kmp_add_node(kmp_info_t *thread,
   return new_head;
 }
 
+// Same as __kmp_add_node for the depnode lists of the entries of h
+static kmp_depnode_list_t *__kmp_dephash_add_node(kmp_info_t *thread,
+                                                  kmp_dephash_t *h,
+                                                  kmp_depnode_list_t *list,
+                                                  kmp_depnode_t *node) {
+  kmp_depnode_list_t *new_head = h->free_list;
+
+  if (new_head)
+    h->free_list = new_head->next;
+  else
+    new_head = (kmp_depnode_list_t *)__kmp_dephash_alloc(
+        thread, h, sizeof(kmp_depnode_list_t));
+
+  new_head->node = __kmp_node_ref(node);
+  new_head->next = list;
+
+  return new_head;
+}
+
+// Removes the depnodes of completed tasks from a depnode list of an entry of
+// h, so that they are not walked again by every following task
+static kmp_depnode_list_t *__kmp_dephash_prune(kmp_info_t *thread,
+                                               kmp_dephash_t *h,
+                                               kmp_depnode_list_t *list) {
+  kmp_depnode_list_t **prev = &list;
+  while (kmp_depnode_list_t *p = *prev) {
+    if (p->node->dn.task) {
+      prev = &p->next;
+      continue;
+    }
+    *prev = p->next;
+    __kmp_node_deref(thread, p->node);
+    p->next = h->free_list;
+    h->free_list = p;
+  }
+  return list;
+}
+
 static inline void __kmp_track_dependence(kmp_int32 gtid, kmp_depnode_t *source,
                                           kmp_depnode_t *sink,
                                           kmp_task_t *sink_task) {
@@ -412,36 +466,33 @@ __kmp_process_dep_all(kmp_int32 gtid, kmp_depnode_t *node, kmp_dephash_t *h,
     h->last_all = NULL;
   }
 
-  // process all regular dependences
-  for (size_t i = 0; i < h->size; i++) {
-    kmp_dephash_entry_t *info = h->buckets[i];
-    if (!info) // skip empty slots in dephash
-      continue;
-    for (; info; info = info->next_in_bucket) {
-      // for each entry the omp_all_memory works as OUT dependence
-      kmp_depnode_t *last_out = info->last_out;
-      kmp_depnode_list_t *last_set = info->last_set;
-      kmp_depnode_list_t *prev_set = info->prev_set;
-      if (last_set) {
-        npredecessors +=
-            __kmp_depnode_link_successor(gtid, thread, task, node, last_set);
-        __kmp_depnode_list_free(thread, last_set);
-        __kmp_depnode_list_free(thread, prev_set);
-        info->last_set = NULL;
-        info->prev_set = NULL;
-        info->last_flag = 0; // no sets in this dephash entry
-      } else {
-        npredecessors +=
-            __kmp_depnode_link_successor(gtid, thread, task, node, last_out);
-      }
-      __kmp_node_deref(thread, last_out);
-      if (!dep_barrier) {
-        info->last_out = __kmp_node_ref(node);
-      } else {
-        info->last_out = NULL;
-      }
+  // process the entries used since the previous omp_all_memory dependence,
+  // the other ones only depend on it
+  kmp_dephash_entry_t *next;
+  for (kmp_dephash_entry_t *info = h->dirty; info; info = next) {
+    next = info->next_dirty;
+    // for each entry the omp_all_memory works as OUT dependence
+    kmp_depnode_t *last_out = info->last_out;
+    kmp_depnode_list_t *last_set = info->last_set;
+    kmp_depnode_list_t *prev_set = info->prev_set;
+    if (last_set) {
+      npredecessors +=
+          __kmp_depnode_link_successor(gtid, thread, task, node, last_set);
+      __kmp_depnode_list_free(thread, h, last_set);
+      __kmp_depnode_list_free(thread, h, prev_set);
+      info->last_set = NULL;
+      info->prev_set = NULL;
+      info->last_flag = 0; // no sets in this dephash entry
+    } else {
+      npredecessors +=
+          __kmp_depnode_link_successor(gtid, thread, task, node, last_out);
     }
+    __kmp_node_deref(thread, last_out);
+    // the entry now depends on h->last_all only
+    info->last_out = NULL;
+    info->dirty = 0;
   }
+  h->dirty = NULL;
   KA_TRACE(30, ("__kmp_process_dep_all: T#%d found %d predecessors\n", gtid,
                 npredecessors));
   return npredecessors;
@@ -466,6 +517,7 @@ __kmp_process_deps(kmp_int32 gtid, kmp_depnode_t *node, kmp_dephash_t **hash,
 
     kmp_dephash_entry_t *info =
         __kmp_dephash_find(thread, hash, dep->base_addr);
+    kmp_dephash_t *h = *hash;
     kmp_depnode_t *last_out = info->last_out;
     kmp_depnode_list_t *last_set = info->last_set;
     kmp_depnode_list_t *prev_set = info->prev_set;
@@ -474,8 +526,8 @@ __kmp_process_deps(kmp_int32 gtid, kmp_depnode_t *node, kmp_dephash_t **hash,
       if (last_set) {
         npredecessors +=
             __kmp_depnode_link_successor(gtid, thread, task, node, last_set);
-        __kmp_depnode_list_free(thread, last_set);
-        __kmp_depnode_list_free(thread, prev_set);
+        __kmp_depnode_list_free(thread, h, last_set);
+        __kmp_depnode_list_free(thread, h, prev_set);
         info->last_set = NULL;
         info->prev_set = NULL;
         info->last_flag = 0; // no sets in this dephash entry
@@ -499,13 +551,14 @@ __kmp_process_deps(kmp_int32 gtid, kmp_depnode_t *node, kmp_dephash_t **hash,
         npredecessors +=
             __kmp_depnode_link_successor(gtid, thread, task, node, last_out);
         // link node as successor of all nodes in the prev_set if any
+        prev_set = info->prev_set = __kmp_dephash_prune(thread, h, prev_set);
         npredecessors +=
             __kmp_depnode_link_successor(gtid, thread, task, node, prev_set);
         if (dep_barrier) {
           // clean last_out and prev_set if any; don't touch last_set
           __kmp_node_deref(thread, last_out);
           info->last_out = NULL;
-          __kmp_depnode_list_free(thread, prev_set);
+          __kmp_depnode_list_free(thread, h, prev_set);
           info->prev_set = NULL;
         }
       } else { // last_set is of different dep kind, make it prev_set
@@ -516,7 +569,7 @@ __kmp_process_deps(kmp_int32 gtid, kmp_depnode_t *node, kmp_dephash_t **hash,
         __kmp_node_deref(thread, last_out);
         info->last_out = NULL;
         // clean prev_set if any
-        __kmp_depnode_list_free(thread, prev_set);
+        __kmp_depnode_list_free(thread, h, prev_set);
         if (!dep_barrier) {
           // move last_set to prev_set, new last_set will be allocated
           info->prev_set = last_set;
@@ -530,7 +583,8 @@ __kmp_process_deps(kmp_int32 gtid, kmp_depnode_t *node, kmp_dephash_t **hash,
       // 0 if last_set is empty, unchanged otherwise
       if (!dep_barrier) {
         info->last_flag = dep->flag; // store dep kind of the last_set
-        info->last_set = __kmp_add_node(thread, info->last_set, node);
+        info->last_set =
+            __kmp_dephash_add_node(thread, h, info->last_set, node);
       }
       // check if we are processing MTX dependency
       if (dep->flag == KMP_DEP_MTX) {
@@ -37,45 +37,50 @@ static inline void __kmp_node_deref(kmp_info_t *thread, kmp_depnode_t *node) {
   }
 }
 
-static inline void __kmp_depnode_list_free(kmp_info_t *thread,
+// Returns the items of a depnode list of an entry of h to the free list of h
+static inline void __kmp_depnode_list_free(kmp_info_t *thread, kmp_dephash_t *h,
                                            kmp_depnode_list *list) {
-  kmp_depnode_list *next;
+  kmp_depnode_list *last = NULL;
 
-  for (; list; list = next) {
-    next = list->next;
-
-    __kmp_node_deref(thread, list->node);
-#if USE_FAST_MEMORY
-    __kmp_fast_free(thread, list);
-#else
-    __kmp_thread_free(thread, list);
-#endif
+  for (kmp_depnode_list *p = list; p; p = p->next) {
+    __kmp_node_deref(thread, p->node);
+    last = p;
+  }
+  if (last) {
+    last->next = h->free_list;
+    h->free_list = list;
   }
 }
 
 static inline void __kmp_dephash_free_entries(kmp_info_t *thread,
                                               kmp_dephash_t *h) {
   for (size_t i = 0; i < h->size; i++) {
-    if (h->buckets[i]) {
-      kmp_dephash_entry_t *next;
-      for (kmp_dephash_entry_t *entry = h->buckets[i]; entry; entry = next) {
-        next = entry->next_in_bucket;
-        __kmp_depnode_list_free(thread, entry->last_set);
-        __kmp_depnode_list_free(thread, entry->prev_set);
-        __kmp_node_deref(thread, entry->last_out);
-        if (entry->mtx_lock) {
-          __kmp_destroy_lock(entry->mtx_lock);
-          __kmp_free(entry->mtx_lock);
-        }
+    kmp_dephash_entry_t *entry = h->slots[i];
+    if (!entry)
+      continue;
+    __kmp_depnode_list_free(thread, h, entry->last_set);
+    __kmp_depnode_list_free(thread, h, entry->prev_set);
+    __kmp_node_deref(thread, entry->last_out);
+    if (entry->mtx_lock) {
+      __kmp_destroy_lock(entry->mtx_lock);
+      __kmp_free(entry->mtx_lock);
+    }
+    h->slots[i] = NULL;
+  }
+  // the entries and the depnode list items live in the chunks
+  kmp_dephash_chunk_t *next;
+  for (kmp_dephash_chunk_t *chunk = h->chunks; chunk; chunk = next) {
+    next = chunk->next;
 #if USE_FAST_MEMORY
-        __kmp_fast_free(thread, entry);
+    __kmp_fast_free(thread, chunk);
 #else
-        __kmp_thread_free(thread, entry);
+    __kmp_thread_free(thread, chunk);
 #endif
-      }
-      h->buckets[i] = 0;
-    }
   }
+  h->chunks = NULL;
+  h->free_list = NULL;
+  h->dirty = NULL;
+  h->nelements = 0;
   __kmp_node_deref(thread, h->last_all);
   h->last_all = NULL;
 }
@@ -335,6 +335,95 @@ static void __kmp_realloc_task_deque(kmp_info_t *thread,
   thread_data->td.td_deque_size = new_size;
 }
 
+// __kmp_push_given_task:
+// Pushes a task into the deque of tasks given to a thread, growing it if it is
+// full. Any thread may call this.
+static void __kmp_push_given_task(kmp_info_t *thread,
+                                  kmp_thread_data_t *thread_data,
+                                  kmp_taskdata_t *taskdata) {
+  __kmp_acquire_bootstrap_lock(&thread_data->td.td_deque_lock);
+  if (TCR_4(thread_data->td.td_deque_ntasks) >=
+      TASK_DEQUE_SIZE(thread_data->td)) {
+    __kmp_realloc_task_deque(thread, thread_data);
+  }
+  thread_data->td.td_deque[thread_data->td.td_deque_tail] = taskdata;
+  // Wrap index.
+  thread_data->td.td_deque_tail =
+      (thread_data->td.td_deque_tail + 1) & TASK_DEQUE_MASK(thread_data->td);
+  TCW_4(thread_data->td.td_deque_ntasks,
+        TCR_4(thread_data->td.td_deque_ntasks) + 1); // Adjust task count
+  __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
+}
+
+// __kmp_own_deque_ntasks:
+// Returns the number of tasks in the lock-free deque of a thread. The deque
+// may change concurrently, so this is only a hint.
+static inline kmp_int32
+__kmp_own_deque_ntasks(kmp_thread_data_t *thread_data) {
+  kmp_uint32 head = KMP_ATOMIC_LD_ACQ(&thread_data->td.td_own_head);
+  kmp_uint32 tail = KMP_ATOMIC_LD_ACQ(&thread_data->td.td_own_tail);
+  kmp_int32 ntasks = (kmp_int32)(tail - head);
+  // The owner transiently moves the tail below the head when popping from an
+  // empty deque.
+  return ntasks > 0 ? ntasks : 0;
+}
+
+// __kmp_deque_ntasks:
+// Returns the number of tasks in both deques of a thread, as a hint.
+static inline kmp_int32 __kmp_deque_ntasks(kmp_thread_data_t *thread_data) {
+  return __kmp_own_deque_ntasks(thread_data) +
+         TCR_4(thread_data->td.td_deque_ntasks);
+}
+
+static kmp_task_deque_buf_t *__kmp_alloc_task_deque_buf(kmp_uint32 size) {
+  kmp_task_deque_buf_t *buf = (kmp_task_deque_buf_t *)__kmp_allocate(
+      sizeof(kmp_task_deque_buf_t) + (size - 1) * sizeof(buf->slots[0]));
+  buf->size = size;
+  return buf;
+}
+
+// __kmp_grow_own_task_deque:
+// Replaces the buffer of a thread's lock-free deque by one twice as large,
+// copying the tasks between head and tail to the same positions. Only the
+// owner of the deque may call this. Thieves may still be reading the old
+// buffer, so it is only freed along with the deque.
+static kmp_task_deque_buf_t *
+__kmp_grow_own_task_deque(kmp_info_t *thread, kmp_thread_data_t *thread_data,
+                          kmp_uint32 head, kmp_uint32 tail) {
+  kmp_task_deque_buf_t *buf = KMP_ATOMIC_LD_RLX(&thread_data->td.td_own_deque);
+  kmp_task_deque_buf_t *new_buf = __kmp_alloc_task_deque_buf(2 * buf->size);
+
+  KE_TRACE(10, ("__kmp_grow_own_task_deque: T#%d reallocating deque[from %u "
+                "to %u] for thread_data %p\n",
+                __kmp_gtid_from_thread(thread), buf->size, new_buf->size,
+                thread_data));
+
+  for (kmp_uint32 i = head; i != tail; ++i) {
+    kmp_taskdata_t *taskdata =
+        KMP_ATOMIC_LD_RLX(&buf->slots[i & (buf->size - 1)]);
+    KMP_ATOMIC_ST_RLX(&new_buf->slots[i & (new_buf->size - 1)], taskdata);
+  }
+  new_buf->retired = buf;
+  KMP_ATOMIC_ST_REL(&thread_data->td.td_own_deque, new_buf);
+  return new_buf;
+}
+
+// __kmp_push_own_task:
+// Pushes a task at the tail of the calling thread's lock-free deque, growing
+// the deque if it is full.
+static void __kmp_push_own_task(kmp_info_t *thread,
+                                kmp_thread_data_t *thread_data,
+                                kmp_taskdata_t *taskdata) {
+  kmp_uint32 tail = KMP_ATOMIC_LD_RLX(&thread_data->td.td_own_tail);
+  kmp_uint32 head = KMP_ATOMIC_LD_ACQ(&thread_data->td.td_own_head);
+  kmp_task_deque_buf_t *buf = KMP_ATOMIC_LD_RLX(&thread_data->td.td_own_deque);
+  if (tail - head >= buf->size)
+    buf = __kmp_grow_own_task_deque(thread, thread_data, head, tail);
+  KMP_ATOMIC_ST_RLX(&buf->slots[tail & (buf->size - 1)], taskdata);
+  // Publish the task to the thieves.
+  KMP_ATOMIC_ST_REL(&thread_data->td.td_own_tail, tail + 1);
+}
+
 static kmp_task_pri_t *__kmp_alloc_task_pri_list() {
   kmp_task_pri_t *l = (kmp_task_pri_t *)__kmp_allocate(sizeof(kmp_task_pri_t));
   kmp_thread_data_t *thread_data = &l->td;
@@ -541,66 +630,28 @@ static kmp_int32 __kmp_push_task(kmp_int32 gtid, kmp_task_t *task) {
     __kmp_alloc_task_deque(thread, thread_data);
   }
 
-  int locked = 0;
-  // Check if deque is full
-  if (TCR_4(thread_data->td.td_deque_ntasks) >=
-      TASK_DEQUE_SIZE(thread_data->td)) {
-    if (__kmp_enable_task_throttling &&
-        __kmp_task_is_allowed(gtid, __kmp_task_stealing_constraint, taskdata,
-                              thread->th.th_current_task)) {
-      KA_TRACE(20, ("__kmp_push_task: T#%d deque is full; returning "
-                    "TASK_NOT_PUSHED for task %p\n",
-                    gtid, taskdata));
-      return TASK_NOT_PUSHED;
-    } else {
-      __kmp_acquire_bootstrap_lock(&thread_data->td.td_deque_lock);
-      locked = 1;
-      if (TCR_4(thread_data->td.td_deque_ntasks) >=
-          TASK_DEQUE_SIZE(thread_data->td)) {
-        // expand deque to push the task which is not allowed to execute
-        __kmp_realloc_task_deque(thread, thread_data);
-      }
-    }
-  }
-  // Lock the deque for the task push operation
-  if (!locked) {
-    __kmp_acquire_bootstrap_lock(&thread_data->td.td_deque_lock);
-    // Need to recheck as we can get a proxy task from thread outside of OpenMP
-    if (TCR_4(thread_data->td.td_deque_ntasks) >=
-        TASK_DEQUE_SIZE(thread_data->td)) {
-      if (__kmp_enable_task_throttling &&
-          __kmp_task_is_allowed(gtid, __kmp_task_stealing_constraint, taskdata,
-                                thread->th.th_current_task)) {
-        __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
-        KA_TRACE(20, ("__kmp_push_task: T#%d deque is full on 2nd check; "
-                      "returning TASK_NOT_PUSHED for task %p\n",
-                      gtid, taskdata));
-        return TASK_NOT_PUSHED;
-      } else {
-        // expand deque to push the task which is not allowed to execute
-        __kmp_realloc_task_deque(thread, thread_data);
-      }
-    }
+  // Check if deque is full. Only the calling thread pushes into its own deque,
+  // so no lock is needed.
+  if (__kmp_own_deque_ntasks(thread_data) >=
+          (kmp_int32)KMP_ATOMIC_LD_RLX(&thread_data->td.td_own_deque)->size &&
+      __kmp_enable_task_throttling &&
+      __kmp_task_is_allowed(gtid, __kmp_task_stealing_constraint, taskdata,
+                            thread->th.th_current_task)) {
+    KA_TRACE(20, ("__kmp_push_task: T#%d deque is full; returning "
+                  "TASK_NOT_PUSHED for task %p\n",
+                  gtid, taskdata));
+    return TASK_NOT_PUSHED;
   }
-  // Must have room since no thread can add tasks but calling thread
-  KMP_DEBUG_ASSERT(TCR_4(thread_data->td.td_deque_ntasks) <
-                   TASK_DEQUE_SIZE(thread_data->td));
 
-  thread_data->td.td_deque[thread_data->td.td_deque_tail] =
-      taskdata; // Push taskdata
-  // Wrap index.
-  thread_data->td.td_deque_tail =
-      (thread_data->td.td_deque_tail + 1) & TASK_DEQUE_MASK(thread_data->td);
-  TCW_4(thread_data->td.td_deque_ntasks,
-        TCR_4(thread_data->td.td_deque_ntasks) + 1); // Adjust task count
+  // Push taskdata, expanding the deque if it is full of tasks which are not
+  // allowed to execute.
+  __kmp_push_own_task(thread, thread_data, taskdata);
   KMP_FSYNC_RELEASING(thread->th.th_current_task); // releasing self
   KMP_FSYNC_RELEASING(taskdata); // releasing child
   KA_TRACE(20, ("__kmp_push_task: T#%d returning TASK_SUCCESSFULLY_PUSHED: "
-                "task=%p ntasks=%d head=%u tail=%u\n",
-                gtid, taskdata, thread_data->td.td_deque_ntasks,
-                thread_data->td.td_deque_head, thread_data->td.td_deque_tail));
-
-  __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
+                "task=%p head=%u tail=%u\n",
+                gtid, taskdata, KMP_ATOMIC_LD_RLX(&thread_data->td.td_own_head),
+                KMP_ATOMIC_LD_RLX(&thread_data->td.td_own_tail)));
 
   return TASK_SUCCESSFULLY_PUSHED;
 }
@@ -3145,28 +3196,22 @@ static kmp_task_t *__kmp_get_priority_task(kmp_int32 gtid,
   return task;
 }
 
-// __kmp_remove_my_task: remove a task from my own deque
-static kmp_task_t *__kmp_remove_my_task(kmp_info_t *thread, kmp_int32 gtid,
-                                        kmp_task_team_t *task_team,
-                                        kmp_int32 is_constrained) {
+// __kmp_remove_given_task: remove a task given by another thread from my own
+// deque
+static kmp_task_t *__kmp_remove_given_task(kmp_info_t *thread, kmp_int32 gtid,
+                                           kmp_thread_data_t *thread_data,
+                                           kmp_int32 is_constrained) {
   kmp_task_t *task;
   kmp_taskdata_t *taskdata;
-  kmp_thread_data_t *thread_data;
   kmp_uint32 tail;
 
-  KMP_DEBUG_ASSERT(__kmp_tasking_mode != tskm_immediate_exec);
-  KMP_DEBUG_ASSERT(task_team->tt.tt_threads_data !=
-                   NULL); // Caller should check this condition
-
-  thread_data = &task_team->tt.tt_threads_data[__kmp_tid_from_gtid(gtid)];
-
-  KA_TRACE(10, ("__kmp_remove_my_task(enter): T#%d ntasks=%d head=%u tail=%u\n",
+  KA_TRACE(10, ("__kmp_remove_given_task(enter): T#%d ntasks=%d head=%u tail=%u\n",
                 gtid, thread_data->td.td_deque_ntasks,
                 thread_data->td.td_deque_head, thread_data->td.td_deque_tail));
 
   if (TCR_4(thread_data->td.td_deque_ntasks) == 0) {
     KA_TRACE(10,
-             ("__kmp_remove_my_task(exit #1): T#%d No tasks to remove: "
+             ("__kmp_remove_given_task(exit #1): T#%d No tasks to remove: "
               "ntasks=%d head=%u tail=%u\n",
               gtid, thread_data->td.td_deque_ntasks,
               thread_data->td.td_deque_head, thread_data->td.td_deque_tail));
@@ -3178,7 +3223,7 @@ static kmp_task_t *__kmp_remove_my_task(kmp_info_t *thread, kmp_int32 gtid,
   if (TCR_4(thread_data->td.td_deque_ntasks) == 0) {
     __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
     KA_TRACE(10,
-             ("__kmp_remove_my_task(exit #2): T#%d No tasks to remove: "
+             ("__kmp_remove_given_task(exit #2): T#%d No tasks to remove: "
               "ntasks=%d head=%u tail=%u\n",
               gtid, thread_data->td.td_deque_ntasks,
               thread_data->td.td_deque_head, thread_data->td.td_deque_tail));
@@ -3194,7 +3239,7 @@ static kmp_task_t *__kmp_remove_my_task(kmp_info_t *thread, kmp_int32 gtid,
     // The TSC does not allow to steal victim task
     __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
     KA_TRACE(10,
-             ("__kmp_remove_my_task(exit #3): T#%d TSC blocks tail task: "
+             ("__kmp_remove_given_task(exit #3): T#%d TSC blocks tail task: "
               "ntasks=%d head=%u tail=%u\n",
               gtid, thread_data->td.td_deque_ntasks,
               thread_data->td.td_deque_head, thread_data->td.td_deque_tail));
@@ -3206,7 +3251,7 @@ static kmp_task_t *__kmp_remove_my_task(kmp_info_t *thread, kmp_int32 gtid,
 
   __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
 
-  KA_TRACE(10, ("__kmp_remove_my_task(exit #4): T#%d task %p removed: "
+  KA_TRACE(10, ("__kmp_remove_given_task(exit #4): T#%d task %p removed: "
                 "ntasks=%d head=%u tail=%u\n",
                 gtid, taskdata, thread_data->td.td_deque_ntasks,
                 thread_data->td.td_deque_head, thread_data->td.td_deque_tail));
@@ -3215,14 +3260,95 @@ static kmp_task_t *__kmp_remove_my_task(kmp_info_t *thread, kmp_int32 gtid,
   return task;
 }
 
-// __kmp_steal_task: remove a task from another thread's deque
-// Assume that calling thread has already checked existence of
-// task_team thread_data before calling this routine.
-static kmp_task_t *__kmp_steal_task(kmp_int32 victim_tid, kmp_int32 gtid,
-                                    kmp_task_team_t *task_team,
-                                    std::atomic<kmp_int32> *unfinished_threads,
-                                    int *thread_finished,
-                                    kmp_int32 is_constrained) {
+// __kmp_remove_my_task: remove a task from my own deque
+static kmp_task_t *__kmp_remove_my_task(kmp_info_t *thread, kmp_int32 gtid,
+                                        kmp_task_team_t *task_team,
+                                        kmp_int32 is_constrained) {
+  kmp_task_t *task;
+  kmp_taskdata_t *taskdata;
+  kmp_thread_data_t *thread_data;
+  kmp_task_deque_buf_t *buf;
+  kmp_uint32 head, tail;
+
+  KMP_DEBUG_ASSERT(__kmp_tasking_mode != tskm_immediate_exec);
+  KMP_DEBUG_ASSERT(task_team->tt.tt_threads_data !=
+                   NULL); // Caller should check this condition
+
+  thread_data = &task_team->tt.tt_threads_data[__kmp_tid_from_gtid(gtid)];
+
+  tail = KMP_ATOMIC_LD_RLX(&thread_data->td.td_own_tail);
+  KA_TRACE(10, ("__kmp_remove_my_task(enter): T#%d head=%u tail=%u\n", gtid,
+                KMP_ATOMIC_LD_RLX(&thread_data->td.td_own_head), tail));
+
+  if (tail == KMP_ATOMIC_LD_RLX(&thread_data->td.td_own_head)) {
+    KA_TRACE(10, ("__kmp_remove_my_task(exit #1): T#%d No tasks to remove\n",
+                  gtid));
+    return __kmp_remove_given_task(thread, gtid, thread_data, is_constrained);
+  }
+
+  // Reserve the tail task before looking at the head: the thieves do it the
+  // other way around, so at most the last task can be claimed by both sides.
+  tail--;
+  buf = KMP_ATOMIC_LD_RLX(&thread_data->td.td_own_deque);
+  KMP_ATOMIC_ST_RLX(&thread_data->td.td_own_tail, tail);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  head = KMP_ATOMIC_LD_RLX(&thread_data->td.td_own_head);
+
+  if ((kmp_int32)(tail - head) < 0) {
+    // The thieves emptied the deque.
+    KMP_ATOMIC_ST_RLX(&thread_data->td.td_own_tail, tail + 1);
+    KA_TRACE(10, ("__kmp_remove_my_task(exit #2): T#%d No tasks to remove\n",
+                  gtid));
+    return __kmp_remove_given_task(thread, gtid, thread_data, is_constrained);
+  }
+
+  taskdata = KMP_ATOMIC_LD_RLX(&buf->slots[tail & (buf->size - 1)]);
+  if (tail == head) {
+    // This is the last task; race with the thieves for it.
+    bool won = thread_data->td.td_own_head.compare_exchange_strong(
+        head, head + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    KMP_ATOMIC_ST_RLX(&thread_data->td.td_own_tail, tail + 1);
+    if (!won) {
+      KA_TRACE(10, ("__kmp_remove_my_task(exit #3): T#%d last task stolen\n",
+                    gtid));
+      return __kmp_remove_given_task(thread, gtid, thread_data,
+                                     is_constrained);
+    }
+    if (!__kmp_task_is_allowed(gtid, is_constrained, taskdata,
+                               thread->th.th_current_task)) {
+      // The TSC does not allow to execute the task, put it back
+      __kmp_push_own_task(thread, thread_data, taskdata);
+      KA_TRACE(10, ("__kmp_remove_my_task(exit #4): T#%d TSC blocks tail "
+                    "task\n",
+                    gtid));
+      return NULL;
+    }
+  } else if (!__kmp_task_is_allowed(gtid, is_constrained, taskdata,
+                                    thread->th.th_current_task)) {
+    // The TSC does not allow to execute the task, leave it in the deque
+    KMP_ATOMIC_ST_REL(&thread_data->td.td_own_tail, tail + 1);
+    KA_TRACE(10,
+             ("__kmp_remove_my_task(exit #4): T#%d TSC blocks tail task\n",
+              gtid));
+    return NULL;
+  }
+
+  KA_TRACE(10, ("__kmp_remove_my_task(exit #5): T#%d task %p removed: "
+                "head=%u tail=%u\n",
+                gtid, taskdata, KMP_ATOMIC_LD_RLX(&thread_data->td.td_own_head),
+                KMP_ATOMIC_LD_RLX(&thread_data->td.td_own_tail)));
+
+  task = KMP_TASKDATA_TO_TASK(taskdata);
+  return task;
+}
+
+// __kmp_steal_given_task: remove a task from the deque of tasks given to
+// another thread
+static kmp_task_t *
+__kmp_steal_given_task(kmp_int32 victim_tid, kmp_int32 gtid,
+                       kmp_task_team_t *task_team,
+                       std::atomic<kmp_int32> *unfinished_threads,
+                       int *thread_finished, kmp_int32 is_constrained) {
   kmp_task_t *task;
   kmp_taskdata_t *taskdata;
   kmp_taskdata_t *current;
@@ -3241,14 +3367,14 @@ static kmp_task_t *__kmp_steal_task(kmp_int32 victim_tid, kmp_int32 gtid,
   victim_thr = victim_td->td.td_thr;
   (void)victim_thr; // Use in TRACE messages which aren't always enabled.
 
-  KA_TRACE(10, ("__kmp_steal_task(enter): T#%d try to steal from T#%d: "
+  KA_TRACE(10, ("__kmp_steal_given_task(enter): T#%d try to steal from T#%d: "
                 "task_team=%p ntasks=%d head=%u tail=%u\n",
                 gtid, __kmp_gtid_from_thread(victim_thr), task_team,
                 victim_td->td.td_deque_ntasks, victim_td->td.td_deque_head,
                 victim_td->td.td_deque_tail));
 
   if (TCR_4(victim_td->td.td_deque_ntasks) == 0) {
-    KA_TRACE(10, ("__kmp_steal_task(exit #1): T#%d could not steal from T#%d: "
+    KA_TRACE(10, ("__kmp_steal_given_task(exit #1): T#%d could not steal from T#%d: "
                   "task_team=%p ntasks=%d head=%u tail=%u\n",
                   gtid, __kmp_gtid_from_thread(victim_thr), task_team,
                   victim_td->td.td_deque_ntasks, victim_td->td.td_deque_head,
@@ -3262,7 +3388,7 @@ static kmp_task_t *__kmp_steal_task(kmp_int32 victim_tid, kmp_int32 gtid,
   // Check again after we acquire the lock
   if (ntasks == 0) {
     __kmp_release_bootstrap_lock(&victim_td->td.td_deque_lock);
-    KA_TRACE(10, ("__kmp_steal_task(exit #2): T#%d could not steal from T#%d: "
+    KA_TRACE(10, ("__kmp_steal_given_task(exit #2): T#%d could not steal from T#%d: "
                   "task_team=%p ntasks=%d head=%u tail=%u\n",
                   gtid, __kmp_gtid_from_thread(victim_thr), task_team, ntasks,
                   victim_td->td.td_deque_head, victim_td->td.td_deque_tail));
@@ -3280,7 +3406,7 @@ static kmp_task_t *__kmp_steal_task(kmp_int32 victim_tid, kmp_int32 gtid,
     if (!task_team->tt.tt_untied_task_encountered) {
       // The TSC does not allow to steal victim task
       __kmp_release_bootstrap_lock(&victim_td->td.td_deque_lock);
-      KA_TRACE(10, ("__kmp_steal_task(exit #3): T#%d could not steal from "
+      KA_TRACE(10, ("__kmp_steal_given_task(exit #3): T#%d could not steal from "
                     "T#%d: task_team=%p ntasks=%d head=%u tail=%u\n",
                     gtid, __kmp_gtid_from_thread(victim_thr), task_team, ntasks,
                     victim_td->td.td_deque_head, victim_td->td.td_deque_tail));
@@ -3302,7 +3428,7 @@ static kmp_task_t *__kmp_steal_task(kmp_int32 victim_tid, kmp_int32 gtid,
     if (taskdata == NULL) {
       // No appropriate candidate to steal found
       __kmp_release_bootstrap_lock(&victim_td->td.td_deque_lock);
-      KA_TRACE(10, ("__kmp_steal_task(exit #4): T#%d could not steal from "
+      KA_TRACE(10, ("__kmp_steal_given_task(exit #4): T#%d could not steal from "
                     "T#%d: task_team=%p ntasks=%d head=%u tail=%u\n",
                     gtid, __kmp_gtid_from_thread(victim_thr), task_team, ntasks,
                     victim_td->td.td_deque_head, victim_td->td.td_deque_tail));
@@ -3340,7 +3466,7 @@ static kmp_task_t *__kmp_steal_task(kmp_int32 victim_tid, kmp_int32 gtid,
 
   KMP_COUNT_BLOCK(TASK_stolen);
   KA_TRACE(10,
-           ("__kmp_steal_task(exit #5): T#%d stole task %p from T#%d: "
+           ("__kmp_steal_given_task(exit #5): T#%d stole task %p from T#%d: "
             "task_team=%p ntasks=%d head=%u tail=%u\n",
             gtid, taskdata, __kmp_gtid_from_thread(victim_thr), task_team,
             ntasks, victim_td->td.td_deque_head, victim_td->td.td_deque_tail));
@@ -3349,6 +3475,101 @@ static kmp_task_t *__kmp_steal_task(kmp_int32 victim_tid, kmp_int32 gtid,
   return task;
 }
 
+// __kmp_steal_task: remove a task from another thread's deque
+// Assume that calling thread has already checked existence of
+// task_team thread_data before calling this routine.
+static kmp_task_t *__kmp_steal_task(kmp_int32 victim_tid, kmp_int32 gtid,
+                                    kmp_task_team_t *task_team,
+                                    std::atomic<kmp_int32> *unfinished_threads,
+                                    int *thread_finished,
+                                    kmp_int32 is_constrained) {
+  kmp_task_t *task;
+  kmp_taskdata_t *taskdata;
+  kmp_taskdata_t *current;
+  kmp_thread_data_t *victim_td, *threads_data;
+  kmp_task_deque_buf_t *buf;
+  kmp_uint32 head, tail;
+  kmp_info_t *victim_thr;
+
+  KMP_DEBUG_ASSERT(__kmp_tasking_mode != tskm_immediate_exec);
+
+  threads_data = task_team->tt.tt_threads_data;
+  KMP_DEBUG_ASSERT(threads_data != NULL); // Caller should check this condition
+  KMP_DEBUG_ASSERT(victim_tid >= 0);
+  KMP_DEBUG_ASSERT(victim_tid < task_team->tt.tt_nproc);
+
+  victim_td = &threads_data[victim_tid];
+  victim_thr = victim_td->td.td_thr;
+  (void)victim_thr; // Use in TRACE messages which aren't always enabled.
+
+  KA_TRACE(10, ("__kmp_steal_task(enter): T#%d try to steal from T#%d: "
+                "task_team=%p head=%u tail=%u\n",
+                gtid, __kmp_gtid_from_thread(victim_thr), task_team,
+                KMP_ATOMIC_LD_RLX(&victim_td->td.td_own_head),
+                KMP_ATOMIC_LD_RLX(&victim_td->td.td_own_tail)));
+
+  if (__kmp_own_deque_ntasks(victim_td) == 0) {
+    return __kmp_steal_given_task(victim_tid, gtid, task_team,
+                                  unfinished_threads, thread_finished,
+                                  is_constrained);
+  }
+
+  if (*thread_finished) {
+    // We need to un-mark this thread as a finished thread before a task can be
+    // taken, or else other threads (starting with the primary thread victim)
+    // might be prematurely released from the barrier!!! If no task is taken,
+    // the thread is marked as finished again once it runs out of tasks.
+#if KMP_DEBUG
+    kmp_int32 count =
+#endif
+        KMP_ATOMIC_INC(unfinished_threads);
+    KA_TRACE(
+        20,
+        ("__kmp_steal_task: T#%d inc unfinished_threads to %d: task_team=%p\n",
+         gtid, count + 1, task_team));
+    *thread_finished = FALSE;
+  }
+
+  do {
+    head = KMP_ATOMIC_LD_ACQ(&victim_td->td.td_own_head);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    tail = KMP_ATOMIC_LD_ACQ(&victim_td->td.td_own_tail);
+    if ((kmp_int32)(tail - head) <= 0) {
+      // The deque was emptied by the owner or by other thieves.
+      return __kmp_steal_given_task(victim_tid, gtid, task_team,
+                                    unfinished_threads, thread_finished,
+                                    is_constrained);
+    }
+    buf = KMP_ATOMIC_LD_ACQ(&victim_td->td.td_own_deque);
+    taskdata = KMP_ATOMIC_LD_RLX(&buf->slots[head & (buf->size - 1)]);
+    // On failure, another thread took the task first; retry with the next one.
+  } while (!victim_td->td.td_own_head.compare_exchange_strong(
+      head, head + 1, std::memory_order_seq_cst, std::memory_order_relaxed));
+
+  current = __kmp_threads[gtid]->th.th_current_task;
+  if (!__kmp_task_is_allowed(gtid, is_constrained, taskdata, current)) {
+    // The TSC does not allow to steal the task. It cannot be put back into the
+    // lock-free deque, which only its owner pushes into, so move it to the
+    // victim's deque of given tasks, where the thieves can search past it.
+    __kmp_push_given_task(victim_thr, victim_td, taskdata);
+    KA_TRACE(10, ("__kmp_steal_task(exit #2): T#%d moved task %p of T#%d to "
+                  "its given tasks\n",
+                  gtid, taskdata, __kmp_gtid_from_thread(victim_thr)));
+    return __kmp_steal_given_task(victim_tid, gtid, task_team,
+                                  unfinished_threads, thread_finished,
+                                  is_constrained);
+  }
+
+  KMP_COUNT_BLOCK(TASK_stolen);
+  KA_TRACE(10, ("__kmp_steal_task(exit #3): T#%d stole task %p from T#%d: "
+                "task_team=%p head=%u tail=%u\n",
+                gtid, taskdata, __kmp_gtid_from_thread(victim_thr), task_team,
+                head + 1, tail));
+
+  task = KMP_TASKDATA_TO_TASK(taskdata);
+  return task;
+}
+
 // __kmp_execute_tasks_template: Choose and execute tasks until either the
 // condition is statisfied (return true) or there are none left (return false).
 //
@@ -3455,6 +3676,7 @@ static inline int __kmp_execute_tasks_template(
           task =
               __kmp_steal_task(victim_tid, gtid, task_team, unfinished_threads,
                                thread_finished, is_constrained);
+          KMP_RT_COUNTER_INC(thread, task ? rtc_steals : rtc_failed_steals);
         }
         if (task != NULL) { // set last stolen to victim
           if (threads_data[tid].td.td_deque_last_stolen != victim_tid) {
@@ -3506,7 +3728,7 @@ static inline int __kmp_execute_tasks_template(
       KMP_YIELD(__kmp_library == library_throughput); // Yield before next task
       // If execution of a stolen task results in more tasks being placed on our
       // run queue, reset use_own_tasks
-      if (!use_own_tasks && TCR_4(threads_data[tid].td.td_deque_ntasks) != 0) {
+      if (!use_own_tasks && __kmp_deque_ntasks(&threads_data[tid]) != 0) {
         KA_TRACE(20, ("__kmp_execute_tasks_template: T#%d stolen task spawned "
                       "other tasks, restart\n",
                       gtid));
@@ -3758,6 +3980,7 @@ static void __kmp_alloc_task_deque(kmp_info_t *thread,
                                    kmp_thread_data_t *thread_data) {
   __kmp_init_bootstrap_lock(&thread_data->td.td_deque_lock);
   KMP_DEBUG_ASSERT(thread_data->td.td_deque == NULL);
+  KMP_DEBUG_ASSERT(KMP_ATOMIC_LD_RLX(&thread_data->td.td_own_deque) == NULL);
 
   // Initialize last stolen task field to "none"
   thread_data->td.td_deque_last_stolen = -1;
@@ -3776,6 +3999,8 @@ static void __kmp_alloc_task_deque(kmp_info_t *thread,
   thread_data->td.td_deque = (kmp_taskdata_t **)__kmp_allocate(
       INITIAL_TASK_DEQUE_SIZE * sizeof(kmp_taskdata_t *));
   thread_data->td.td_deque_size = INITIAL_TASK_DEQUE_SIZE;
+  KMP_ATOMIC_ST_REL(&thread_data->td.td_own_deque,
+                    __kmp_alloc_task_deque_buf(INITIAL_TASK_DEQUE_SIZE));
 }
 
 // __kmp_free_task_deque:
@@ -3788,6 +4013,17 @@ static void __kmp_free_task_deque(kmp_thread_data_t *thread_data) {
     __kmp_free(thread_data->td.td_deque);
     thread_data->td.td_deque = NULL;
     __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
+
+    // Free the buffer of the lock-free deque along with the ones it replaced.
+    kmp_task_deque_buf_t *buf = KMP_ATOMIC_LD_RLX(&thread_data->td.td_own_deque);
+    while (buf != NULL) {
+      kmp_task_deque_buf_t *retired = buf->retired;
+      __kmp_free(buf);
+      buf = retired;
+    }
+    KMP_ATOMIC_ST_RLX(&thread_data->td.td_own_deque, nullptr);
+    KMP_ATOMIC_ST_RLX(&thread_data->td.td_own_head, 0u);
+    KMP_ATOMIC_ST_RLX(&thread_data->td.td_own_tail, 0u);
   }
 
 #ifdef BUILD_TIED_TASK_STACK
@@ -4341,11 +4577,11 @@ void __kmp_tasking_barrier(kmp_team_t *team, kmp_info_t *thread, int gtid) {
 #endif /* USE_ITT_BUILD */
 }
 
-// __kmp_give_task puts a task into a given thread queue if:
+// __kmp_give_task puts a task into the queue of tasks given to a thread if:
 //  - the queue for that thread was created
 //  - there's space in that queue
-// Because of this, __kmp_push_task needs to check if there's space after
-// getting the lock
+// Only the owner pushes into its lock-free deque, so given tasks go to a
+// separate deque protected by a lock.
 static bool __kmp_give_task(kmp_info_t *thread, kmp_int32 tid, kmp_task_t *task,
                             kmp_int32 pass) {
   kmp_taskdata_t *taskdata = KMP_TASK_TO_TASKDATA(task);
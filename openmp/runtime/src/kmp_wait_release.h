@@ -355,6 +355,53 @@ static void __ompt_implicit_task_end(kmp_info_t *this_thr,
 }
 #endif
 
+#if !KMP_USE_MONITOR
+// KMP_ADAPTIVE_WAIT keeps, per thread, the average duration of recent waits on
+// each wait site. A site is the flag waited on: barrier flags live at fixed
+// addresses, so a given barrier keeps hitting the same history slot, and the
+// rare unrelated flags that share a slot only blur its average.
+static inline kmp_uint64 *__kmp_wait_site(kmp_info_t *th, volatile void *loc) {
+  kmp_uintptr_t key = (kmp_uintptr_t)loc >> 3;
+  key ^= (key >> 5) ^ (key >> 11);
+  return &th->th.th_wait_predicted[key & (KMP_WAIT_SITES - 1)];
+}
+
+// Fold a finished wait into the site average with a weight of 1/4.
+static inline void __kmp_wait_site_update(kmp_uint64 *site,
+                                          kmp_uint64 sample) {
+  kmp_uint64 avg = *site ? *site - (*site >> 2) + (sample >> 2) : sample;
+  *site = avg ? avg : 1;
+}
+
+// Pick the spin budget of an adaptive wait from the expected wait at its site,
+// relative to the cost of waking up a sleeping thread:
+//  - short waits (up to the wake-up cost) pause-spin for twice that cost;
+//  - medium waits (up to 16 times the cost) pause-spin for the cost, then
+//    yield until twice the expected wait has passed;
+//  - long waits spin for a quarter of the cost, then sleep (or mwait).
+// Sites without history keep the blocktime, which also caps every budget.
+static inline void __kmp_adaptive_wait_goals(kmp_uint64 predicted,
+                                             kmp_uint64 interval,
+                                             kmp_uint64 now,
+                                             kmp_uint64 *hibernate_goal,
+                                             kmp_uint64 *yield_goal) {
+  kmp_uint64 wake = KMP_NOW_FROM_USEC(__kmp_adaptive_wait_latency);
+  kmp_uint64 budget = interval;
+  *yield_goal = 0;
+  if (predicted == 0) {
+    // No history yet.
+  } else if (predicted <= wake) {
+    budget = 2 * wake;
+  } else if (predicted <= 16 * wake) {
+    budget = 2 * predicted;
+    *yield_goal = now + wake;
+  } else {
+    budget = wake / 4;
+  }
+  *hibernate_goal = now + KMP_MIN(budget, interval);
+}
+#endif // !KMP_USE_MONITOR
+
 /* Spin wait loop that first does pause/yield, then sleep. A thread that calls
    __kmp_wait_*  must make certain that another thread calls __kmp_release
    to wake it back up to prevent deadlocks!
@@ -374,10 +421,14 @@ __kmp_wait_template(kmp_info_t *this_thr,
 #if !KMP_USE_MONITOR
   kmp_uint64 poll_count;
   kmp_uint64 hibernate_goal;
+  kmp_uint64 *wait_site = NULL; // KMP_ADAPTIVE_WAIT history slot
+  kmp_uint64 wait_start = 0;
+  kmp_uint64 yield_goal = 0;
 #else
   kmp_uint32 hibernate;
 #endif
   kmp_uint64 time;
+  bool slept = false;
 
   KMP_FSYNC_SPIN_INIT(spin, NULL);
   if (flag->done_check()) {
@@ -478,6 +529,13 @@ final_spin=FALSE)
 
   KMP_INIT_YIELD(spins); // Setup for waiting
   KMP_INIT_BACKOFF(time);
+#if !KMP_USE_MONITOR
+  if (Sleepable && __kmp_adaptive_wait &&
+      __kmp_dflt_blocktime != KMP_MAX_BLOCKTIME) {
+    wait_site = __kmp_wait_site(this_thr, flag->get());
+    wait_start = KMP_NOW();
+  }
+#endif
 
   if (__kmp_dflt_blocktime != KMP_MAX_BLOCKTIME ||
       __kmp_pause_status == kmp_soft_paused) {
@@ -512,6 +570,9 @@ final_spin=FALSE)
     if (__kmp_pause_status == kmp_soft_paused) {
       // Force immediate suspend
       hibernate_goal = KMP_NOW();
+    } else if (wait_site) {
+      __kmp_adaptive_wait_goals(*wait_site, this_thr->th.th_team_bt_intervals,
+                                wait_start, &hibernate_goal, &yield_goal);
     } else
       hibernate_goal = KMP_NOW() + this_thr->th.th_team_bt_intervals;
     poll_count = 0;
@@ -566,6 +627,11 @@ final_spin=FALSE)
     // If we are oversubscribed, or have waited a bit (and
     // KMP_LIBRARY=throughput), then yield
     KMP_YIELD_OVERSUB_ELSE_SPIN(spins, time);
+#if !KMP_USE_MONITOR
+    // Past the spin phase of a medium adaptive wait, let other threads run.
+    if (yield_goal && KMP_NOW() >= yield_goal)
+      KMP_YIELD(TRUE);
+#endif
 
 #if KMP_STATS_ENABLED
     // Check if thread has been signalled to idle state
@@ -626,6 +692,8 @@ final_spin=FALSE)
     if (!Sleepable)
       continue;
 
+    kmp_uint64 rtc_start = KMP_RT_COUNTER_START();
+    slept = true;
 #if KMP_HAVE_MWAIT || KMP_HAVE_UMWAIT
     if (__kmp_mwait_enabled || __kmp_umwait_enabled) {
       KF_TRACE(50, ("__kmp_wait_sleep: T#%d using monitor/mwait\n", th_gtid));
@@ -645,6 +713,8 @@ final_spin=FALSE)
 #if KMP_HAVE_MWAIT || KMP_HAVE_UMWAIT
     }
 #endif
+    KMP_RT_COUNTER_ADD(this_thr, rtc_sleep_ticks,
+                       KMP_RT_COUNTER_NOW() - rtc_start);
 
     if (TCR_4(__kmp_global.g.g_done)) {
       if (__kmp_global.g.g_abort)
@@ -684,6 +754,11 @@ final_spin=FALSE)
   if (final_spin)
     KMP_ATOMIC_ST_REL(&this_thr->th.th_blocking, false);
 #endif
+#if !KMP_USE_MONITOR
+  if (wait_site)
+    __kmp_wait_site_update(wait_site, KMP_NOW() - wait_start);
+#endif
+  KMP_RT_COUNTER_INC(this_thr, slept ? rtc_sleep_waits : rtc_spin_waits);
   KMP_FSYNC_SPIN_ACQUIRED(CCAST(void *, spin));
   if (Cancellable) {
     kmp_team_t *team = this_thr->th.th_team;
@@ -0,0 +1,64 @@
+// RUN: %libomp-compile-and-run
+
+// Allocators with a partition trait; on NUMA systems their memory is placed
+// on the nodes by the runtime.
+
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#define NSIZES 4
+
+int main() {
+  omp_alloctrait_value_t partitions[] = {omp_atv_environment, omp_atv_nearest,
+                                         omp_atv_blocked, omp_atv_interleaved};
+  size_t sizes[NSIZES] = {16, 4096, 100000, 20 * 1024 * 1024};
+  int err = 0;
+  int k;
+  for (k = 0; k < 4; ++k) {
+    omp_alloctrait_t at[2];
+    omp_allocator_handle_t a;
+    at[0].key = omp_atk_partition;
+    at[0].value = partitions[k];
+    at[1].key = omp_atk_alignment;
+    at[1].value = 64;
+    a = omp_init_allocator(omp_default_mem_space, 2, at);
+    if (a == omp_null_allocator) {
+      printf("failed: no allocator for partition %d\n", (int)partitions[k]);
+      return 1;
+    }
+#pragma omp parallel num_threads(4) reduction(+ : err)
+    {
+      int i, j;
+      // twice, to reuse the blocks freed the first time
+      for (j = 0; j < 2; ++j) {
+        char *p[NSIZES];
+        for (i = 0; i < NSIZES; ++i) {
+          p[i] = (char *)omp_alloc(sizes[i], a);
+          if (p[i] == NULL || ((size_t)p[i] & 63) != 0) {
+            err++;
+            continue;
+          }
+          memset(p[i], i + 1, sizes[i]);
+        }
+        for (i = 0; i < NSIZES; ++i) {
+          if (p[i] == NULL)
+            continue;
+          if (p[i][0] != i + 1 || p[i][sizes[i] - 1] != i + 1)
+            err++;
+          p[i] = (char *)omp_realloc(p[i], sizes[i] / 2 + 1, a, a);
+          if (p[i] == NULL || p[i][sizes[i] / 2] != i + 1)
+            err++;
+          omp_free(p[i], a);
+        }
+      }
+    }
+    omp_destroy_allocator(a);
+  }
+  if (err) {
+    printf("failed: %d errors\n", err);
+    return 1;
+  }
+  printf("passed\n");
+  return 0;
+}
@@ -0,0 +1,40 @@
+// RUN: %libomp-compile
+// RUN: env KMP_ADAPTIVE_WAIT=1 KMP_SETTINGS=1 %libomp-run 2>&1 | FileCheck %s
+// RUN: env KMP_ADAPTIVE_WAIT=1 KMP_ADAPTIVE_WAIT_LATENCY=1 %libomp-run
+// RUN: env KMP_ADAPTIVE_WAIT=1 KMP_BLOCKTIME=0 %libomp-run
+// RUN: env KMP_ADAPTIVE_WAIT=1 KMP_BLOCKTIME=infinite %libomp-run
+
+// Waits of very different lengths at the same barriers must all complete,
+// whatever spin budget the history of the barrier suggests.
+
+// CHECK: KMP_ADAPTIVE_WAIT=true
+// CHECK: KMP_ADAPTIVE_WAIT_LATENCY=50
+#include <stdio.h>
+#include <stdlib.h>
+#include "omp_testsuite.h"
+#include "omp_my_sleep.h"
+
+int main() {
+  int r, count = 0;
+  for (r = 0; r < 40; ++r) {
+    // Alternate bursts of short waits with a few long ones.
+    int delay_ms = (r % 10 == 9) ? 20 : 0;
+#pragma omp parallel reduction(+ : count)
+    {
+      int i;
+      for (i = 0; i < 20; ++i) {
+        if (omp_get_thread_num() == 0 && delay_ms)
+          my_sleep(delay_ms / 1000.0);
+#pragma omp barrier
+      }
+      count++;
+    }
+    if (delay_ms)
+      my_sleep(delay_ms / 1000.0); // workers wait in the fork barrier
+  }
+  if (count != 40 * omp_get_max_threads()) {
+    printf("failed: count = %d\n", count);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,32 @@
+// RUN: %libomp-compile
+// RUN: env KMP_RUNTIME_COUNTERS=1 OMP_NUM_THREADS=4 %libomp-run 2>&1 \
+// RUN:   | FileCheck %s
+// RUN: env OMP_NUM_THREADS=4 %libomp-run 2>&1 | FileCheck %s --check-prefix=OFF
+// RUN: env KMP_RUNTIME_COUNTERS=1 KMP_RUNTIME_COUNTERS_FILE=%t.counters \
+// RUN:   OMP_NUM_THREADS=4 %libomp-run && FileCheck %s < %t.counters
+
+// CHECK: OMP runtime counters (times in usec):
+// CHECK-NEXT: gtid barriers barrier-us steals no-steal spin-wait sleep-wait
+// CHECK-SAME: sleep-us chunks
+// CHECK: {{^ +0 +[1-9][0-9]* }}
+// CHECK: {{^ +total +[1-9][0-9]* +[0-9]+ +[0-9]+ +[0-9]+ +[0-9]+ +[0-9]+ +[0-9]+ +[1-9][0-9]*$}}
+
+// OFF-NOT: OMP runtime counters
+#include <stdio.h>
+#include <stdlib.h>
+
+int main() {
+  int i, sum = 0;
+#pragma omp parallel
+  {
+#pragma omp for schedule(dynamic, 1) reduction(+ : sum)
+    for (i = 0; i < 1000; i++)
+      sum += i;
+#pragma omp barrier
+  }
+  if (sum != 999 * 1000 / 2) {
+    printf("failed: sum = %d\n", sum);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,116 @@
+// RUN: %libomp-compile-and-run
+
+// Stresses the dependence hash of a task with many addresses, interleaved
+// omp_all_memory dependences and large inoutset sets; it also serves as a
+// microbenchmark of dependence tracking, e.g. when run under time with
+// -DNUM_DEPS=1000000.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+
+#include "kmp_task_deps.h"
+
+#ifndef NUM_DEPS
+#define NUM_DEPS 100000
+#endif
+// number of inout tasks between two omp_all_memory tasks
+#define ALL_PERIOD 1000
+#define NUM_SET 1000
+#define DEP_ALL_MEM 0x80
+
+static int *data;
+static int set_data;
+static int ndone = 0; // number of completed inout tasks
+static int nset = 0; // number of completed inoutset tasks
+static int err = 0;
+
+static int inout_task(int gtid, kmp_task_t *task) {
+  int i = task->f_priv;
+  if (data[i] != 0) {
+#pragma omp atomic
+    err++;
+  }
+  data[i] = 1;
+#pragma omp atomic
+  ndone++;
+  return 0;
+}
+
+static int all_task(int gtid, kmp_task_t *task) {
+  int n;
+#pragma omp atomic read
+  n = ndone;
+  // all the previous tasks are complete, none of the following one started
+  if (n != task->f_priv) {
+    printf("Error: %d tasks done before omp_all_memory task, expected %d\n", n,
+           task->f_priv);
+#pragma omp atomic
+    err++;
+  }
+  return 0;
+}
+
+static int in_task(int gtid, kmp_task_t *task) {
+  if (data[task->f_priv] != 1) {
+#pragma omp atomic
+    err++;
+  }
+  return 0;
+}
+
+static int set_task(int gtid, kmp_task_t *task) {
+#pragma omp atomic
+  nset++;
+  return 0;
+}
+
+static int set_in_task(int gtid, kmp_task_t *task) {
+  int n;
+#pragma omp atomic read
+  n = nset;
+  if (n != NUM_SET) {
+#pragma omp atomic
+    err++;
+  }
+  return 0;
+}
+
+static void create_task(int gtid, entry_t entry, int priv, size_t addr,
+                        unsigned char flags) {
+  dep d = {addr, sizeof(int), flags};
+  kmp_task_t *task =
+      __kmpc_omp_task_alloc(&loc, gtid, TIED, sizeof(kmp_task_t), 0, entry);
+  task->f_priv = priv;
+  __kmpc_omp_task_with_deps(&loc, gtid, task, 1, &d, 0, 0);
+}
+
+int main(void) {
+  data = (int *)calloc(NUM_DEPS, sizeof(int));
+  double time = omp_get_wtime();
+#pragma omp parallel
+#pragma omp single
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int i;
+    for (i = 0; i < NUM_DEPS; i++) {
+      if (i % ALL_PERIOD == 0)
+        create_task(gtid, all_task, i, 0, DEP_ALL_MEM);
+      create_task(gtid, inout_task, i, (size_t)&data[i], 3); // inout
+    }
+    for (i = 0; i < NUM_DEPS; i++)
+      create_task(gtid, in_task, i, (size_t)&data[i], 1); // in
+    for (i = 0; i < NUM_SET; i++)
+      create_task(gtid, set_task, i, (size_t)&set_data, 8); // inoutset
+    for (i = 0; i < NUM_SET; i++)
+      create_task(gtid, set_in_task, i, (size_t)&set_data, 1); // in
+  }
+  time = omp_get_wtime() - time;
+  free(data);
+  if (err == 0 && ndone == NUM_DEPS && nset == NUM_SET) {
+    printf("passed (%g s)\n", time);
+    return 0;
+  }
+  printf("failed: %d errors\n", err);
+  return 1;
+}
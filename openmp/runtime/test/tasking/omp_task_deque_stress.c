@@ -0,0 +1,88 @@
+// RUN: %libomp-compile && env KMP_ENABLE_TASK_THROTTLING=0 %libomp-run
+// RUN: %libomp-compile && env KMP_ENABLE_TASK_THROTTLING=1 %libomp-run
+
+#include <stdio.h>
+#include <omp.h>
+#include "omp_my_sleep.h"
+
+/**
+ * Stress the per-thread task deques of the runtime.
+ * Without task throttling, the deques have to grow well past their initial
+ * size (256 tasks) while the other threads keep stealing from them.
+ * In the first part, one thread creates all tasks and the others steal them
+ * while they wait in the barrier.
+ * In the second part, every thread creates tasks and then waits for them in a
+ * taskwait. Under the task scheduling constraint, a thread waiting in a tied
+ * task may not run the tasks it steals from the others, so those are handed
+ * back to their creator.
+ * Every task must run exactly once.
+ */
+
+#define NUM_THREADS 4
+#define NUM_TASKS 20000
+#define NUM_CHILDREN 2000
+
+int executed[NUM_TASKS];
+int executed_children[NUM_THREADS][NUM_CHILDREN];
+
+static void work(int *counter) {
+  int i;
+  volatile int x = 0;
+  for (i = 0; i < 100; i++)
+    x += i;
+#pragma omp atomic
+  (*counter)++;
+}
+
+int main() {
+  int i, j, errors = 0;
+
+  #pragma omp parallel num_threads(NUM_THREADS)
+  #pragma omp single
+  {
+    for (i = 0; i < NUM_TASKS; i++) {
+      #pragma omp task firstprivate(i)
+      work(&executed[i]);
+    }
+  }
+
+  #pragma omp parallel num_threads(NUM_THREADS)
+  {
+    int tid = omp_get_thread_num();
+    int k;
+    // Let all threads start creating tasks at the same time.
+    #pragma omp barrier
+    for (k = 0; k < NUM_CHILDREN; k++) {
+      #pragma omp task firstprivate(k)
+      {
+        if (k % 100 == 0)
+          my_sleep(0.001);
+        work(&executed_children[tid][k]);
+      }
+    }
+    #pragma omp taskwait
+  }
+
+  for (i = 0; i < NUM_TASKS; i++) {
+    if (executed[i] != 1) {
+      fprintf(stderr, "task %d executed %d times\n", i, executed[i]);
+      errors++;
+    }
+  }
+  for (i = 0; i < NUM_THREADS; i++) {
+    for (j = 0; j < NUM_CHILDREN; j++) {
+      if (executed_children[i][j] != 1) {
+        fprintf(stderr, "task %d of thread %d executed %d times\n", j, i,
+                executed_children[i][j]);
+        errors++;
+      }
+    }
+  }
+
+  if (errors) {
+    printf("failed\n");
+    return 1;
+  }
+  printf("passed\n");
+  return 0;
+}
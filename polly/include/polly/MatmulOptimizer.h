@@ -44,6 +44,10 @@ class Dependences;
 /// parameters. In particular, reused elements of the matrix B are
 /// successively multiplied by specific elements of the matrix A.
 ///
+/// With -polly-tc-opt, tensor contractions are handled the same way, after
+/// choosing one index of each of their bundles of free and contracted indices
+/// as the matrix multiplication indices; their packing is not implemented.
+///
 /// Refs.:
 /// [1] - Analytical Modeling is Enough for High Performance BLIS
 /// Tze Meng Low, Francisco D Igual, Tyler M Smith, Enrique S Quintana-Orti
@@ -62,6 +62,10 @@ class ScopBuilder final {
   // The Scop
   std::unique_ptr<Scop> scop;
 
+  /// Whether the Scop was dismissed because its polyhedral description is too
+  /// complex.
+  bool TooComplex = false;
+
   /// Collection to hold taken assumptions.
   ///
   /// There are two reasons why we want to record assumptions first before we
@@ -778,6 +782,11 @@ public:
   /// @return Give up the ownership of the scop object or static control part
   ///         for the region
   std::unique_ptr<Scop> getScop() { return std::move(scop); }
+
+  /// Return whether the Scop was dismissed because its polyhedral description
+  /// exceeded the complexity limits. Smaller parts of its region may still be
+  /// modeled.
+  bool isTooComplex() const { return TooComplex; }
 };
 } // end namespace polly
 
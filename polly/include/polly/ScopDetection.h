@@ -531,6 +531,16 @@ public:
   /// @return Return true if R is the maximum Region in a Scop, false otherwise.
   bool isMaxRegionInScop(const Region &R, bool Verify = true);
 
+  /// Replace the SCoP @p R by the maximal profitable SCoPs nested in it.
+  ///
+  /// This is used when the polyhedral description of @p R turns out to be too
+  /// complex to build, such that at least parts of it can be optimized.
+  ///
+  /// @param R The region of a valid SCoP.
+  ///
+  /// @return The regions of the new SCoPs.
+  SmallVector<const Region *, 4> splitScop(const Region &R);
+
   /// Return the detection context for @p R, nullptr if @p R was invalid.
   DetectionContext *getDetectionContext(const Region *R) const;
 
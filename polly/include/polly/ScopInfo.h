@@ -1678,6 +1678,9 @@ private:
   /// Flag to remember if the SCoP contained an error block or not.
   bool HasErrorBlock = false;
 
+  /// Flag to remember if the SCoP was invalidated for being too complex.
+  bool IsTooComplex = false;
+
   /// Max loop depth.
   unsigned MaxLoopDepth = 0;
 
@@ -2454,6 +2457,10 @@ public:
   /// Notify SCoP that it contains an error block
   void notifyErrorBlock() { HasErrorBlock = true; }
 
+  /// Return true if the SCoP was invalidated because its polyhedral
+  /// description exceeded the complexity limits.
+  bool isTooComplex() const { return IsTooComplex; }
+
   /// Return true if the underlying region has a single exiting block.
   bool hasSingleExitEdge() const { return HasSingleExitEdge; }
 
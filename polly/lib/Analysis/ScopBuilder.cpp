@@ -54,6 +54,7 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cassert>
 
@@ -3663,14 +3664,32 @@ ScopBuilder::ScopBuilder(Region *R, AssumptionCache &AC, AAResults &AA,
   ORE.emit(OptimizationRemarkAnalysis(DEBUG_TYPE, "ScopEntry", Beg, P.first)
            << Msg);
 
+  TimeRecord StartTime = TimeRecord::getCurrentTime(/*Start=*/true);
   buildScop(*R, AC);
+  TimeRecord BuildTime = TimeRecord::getCurrentTime(/*Start=*/false);
+  BuildTime -= StartTime;
 
   POLLY_DEBUG(dbgs() << *scop);
 
+  // Report what modeling the region cost, so that the regions that are not
+  // worth the compile time can be identified.
+  ORE.emit([&]() {
+    return OptimizationRemarkAnalysis(DEBUG_TYPE, "ScopBuildCost", Beg,
+                                      P.first)
+           << "SCoP with " << ore::NV("NumStmts", scop->getSize())
+           << " statements and "
+           << ore::NV("MaxLoopDepth", scop->getMaxLoopDepth())
+           << " nested loops modeled in "
+           << ore::NV("Milliseconds",
+                      static_cast<uint64_t>(BuildTime.getWallTime() * 1000))
+           << " ms";
+  });
+
   if (!scop->hasFeasibleRuntimeContext()) {
     InfeasibleScops++;
     Msg = "SCoP ends here but was dismissed.";
     POLLY_DEBUG(dbgs() << "SCoP detected but dismissed\n");
+    TooComplex = scop->isTooComplex();
     RecordedAssumptions.clear();
     scop.reset();
   } else {
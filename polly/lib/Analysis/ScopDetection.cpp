@@ -437,6 +437,43 @@ bool ScopDetection::isMaxRegionInScop(const Region &R, bool Verify) {
   return true;
 }
 
+SmallVector<const Region *, 4> ScopDetection::splitScop(const Region &R) {
+  assert(ValidRegions.count(&R) && "Only a valid SCoP can be split");
+  removeCachedResults(R);
+
+  // Regions found by findScops are appended to ValidRegions, after the ones of
+  // the other SCoPs which are not nested in R.
+  unsigned NumOtherRegions = ValidRegions.size();
+  for (auto &SubRegion : const_cast<Region &>(R))
+    findScops(*SubRegion);
+
+  SmallVector<const Region *, 4> SubScops;
+  BBPair RPair = getBBPairForRegion(&R);
+  for (const Region *SubR :
+       ValidRegions.getArrayRef().drop_front(NumOtherRegions)) {
+    // An expanded region may cover the whole of R again.
+    if (getBBPairForRegion(SubR) == RPair)
+      continue;
+    DetectionContext *DC = getDetectionContext(SubR);
+    if (DC && !DC->Log.hasErrors() && !isProfitableRegion(*DC))
+      continue;
+    SubScops.push_back(SubR);
+  }
+
+  // Drop the regions that are not worth a SCoP of their own.
+  SmallVector<const Region *, 4> Dropped;
+  for (const Region *SubR :
+       ValidRegions.getArrayRef().drop_front(NumOtherRegions))
+    if (!is_contained(SubScops, SubR))
+      Dropped.push_back(SubR);
+  for (const Region *SubR : Dropped)
+    removeCachedResults(*SubR);
+
+  POLLY_DEBUG(dbgs() << "Split too complex SCoP " << R.getNameStr() << " into "
+                     << SubScops.size() << " sub-SCoPs\n");
+  return SubScops;
+}
+
 std::string ScopDetection::regionIsInvalidBecause(const Region *R) const {
   // Get the first error we found. Even in keep-going mode, this is the first
   // reason that caused the candidate to be rejected.
@@ -114,6 +114,7 @@ STATISTIC(NumPHIWritesInLoops,
 STATISTIC(NumSingletonWrites, "Number of singleton writes after ScopInfo");
 STATISTIC(NumSingletonWritesInLoops,
           "Number of singleton writes nested in affine loops after ScopInfo");
+STATISTIC(NumSplitScops, "Number of too complex SCoPs split into sub-SCoPs");
 
 unsigned const polly::MaxDisjunctsInDomain = 20;
 
@@ -164,6 +165,12 @@ static cl::opt<bool> PollyPrintInstructions(
     "polly-print-instructions", cl::desc("Output instructions per ScopStmt"),
     cl::Hidden, cl::Optional, cl::init(false), cl::cat(PollyCategory));
 
+static cl::opt<bool> PollySplitComplexScops(
+    "polly-split-complex-scops",
+    cl::desc("Model the maximal sub-SCoPs of a SCoP whose polyhedral "
+             "description is too complex, instead of dropping it"),
+    cl::Hidden, cl::init(false), cl::cat(PollyCategory));
+
 static cl::list<std::string> IslArgs("polly-isl-arg",
                                      cl::value_desc("argument"),
                                      cl::desc("Option passed to ISL"),
@@ -2044,6 +2051,8 @@ void Scop::intersectDefinedBehavior(isl::set Set, AssumptionSign Sign) {
 
 void Scop::invalidate(AssumptionKind Kind, DebugLoc Loc, BasicBlock *BB) {
   POLLY_DEBUG(dbgs() << "Invalidate SCoP because of reason " << Kind << "\n");
+  if (Kind == COMPLEXITY)
+    IsTooComplex = true;
   addAssumption(Kind, isl::set::empty(getParamSpace()), Loc, AS_ASSUMPTION, BB);
 }
 
@@ -2703,15 +2712,25 @@ void ScopInfo::recompute() {
   RegionToScopMap.clear();
   /// Create polyhedral description of scops for all the valid regions of a
   /// function.
-  for (auto &It : SD) {
-    Region *R = const_cast<Region *>(It);
+  SmallVector<const Region *, 8> Worklist(SD.begin(), SD.end());
+  for (unsigned I = 0; I < Worklist.size(); ++I) {
+    Region *R = const_cast<Region *>(Worklist[I]);
     if (!SD.isMaxRegionInScop(*R))
       continue;
 
     ScopBuilder SB(R, AC, AA, DL, DT, LI, SD, SE, ORE);
     std::unique_ptr<Scop> S = SB.getScop();
-    if (!S)
+    if (!S) {
+      // Rather than losing the whole region, model the parts of it that are
+      // simple enough; they are split again if still too complex.
+      if (PollySplitComplexScops && SB.isTooComplex()) {
+        auto SubScops = SD.splitScop(*R);
+        if (!SubScops.empty())
+          NumSplitScops++;
+        Worklist.append(SubScops.begin(), SubScops.end());
+      }
       continue;
+    }
 #if !defined(NDEBUG) || defined(LLVM_ENABLE_STATS)
     ScopDetection::LoopStats Stats =
         ScopDetection::countBeneficialLoops(&S->getRegion(), SE, LI, 0);
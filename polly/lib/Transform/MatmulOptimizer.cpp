@@ -1818,19 +1818,127 @@ static bool isTCPattern(isl::schedule_node Node, const Dependences *D,
   return false;
 }
 
+/// Get the index of @p IndexSet that comes last in @p Dimensions.
+///
+/// @param Dimensions The input dimensions that index a tensor, from its first
+///                   to its last dimension.
+/// @param IndexSet   The input dimensions to choose from.
+/// @return The chosen input dimension or -1, if none of @p Dimensions is
+///         contained in @p IndexSet.
+static int getInnermostIndex(ArrayRef<int> Dimensions,
+                             const SmallDenseSet<int> &IndexSet) {
+  for (int Dim : reverse(Dimensions))
+    if (IndexSet.count(Dim))
+      return Dim;
+  return -1;
+}
+
+/// Reorder the dimensions of the band node @p Node.
+///
+/// @param Node  The band node to be modified.
+/// @param Order The dimension of @p Node that becomes each dimension of the
+///              new band node.
+/// @return The modified schedule node.
+static isl::schedule_node reorderBandNodeDimensions(isl::schedule_node Node,
+                                                    ArrayRef<int> Order) {
+  assert(isl_schedule_node_get_type(Node.get()) == isl_schedule_node_band);
+  auto PartialSchedule =
+      isl::manage(isl_schedule_node_band_get_partial_schedule(Node.get()));
+  auto NewPartialSchedule = PartialSchedule;
+  for (unsigned Pos = 0; Pos < Order.size(); Pos++)
+    NewPartialSchedule = NewPartialSchedule.set_union_pw_aff(
+        Pos, PartialSchedule.at(Order[Pos]));
+  Node = isl::manage(isl_schedule_node_delete(Node.release()));
+  return Node.insert_partial_schedule(NewPartialSchedule);
+}
+
+/// Apply the BLIS-like tiling to a TC-like kernel.
+///
+/// The TC-like kernel is logically handled as a matrix multiplication [1]:
+/// for each of the bundles I, J, and P, one index is chosen to play the role
+/// of the matrix multiplication indices i, j, and k, and the loops of
+/// the remaining indices become outer loops. The indices i and j are the
+/// innermost free indices of the tensor C, which gives unit-stride accesses
+/// to C in the micro-kernel. The index k is the innermost index of P, such that
+/// the order of the reduction, i.e., the order of the loops of P, is
+/// preserved. The loops of i, j, and k are then tiled as in the optimization of
+/// the matrix multiplication, using the micro-kernel and macro-kernel
+/// parameters derived from the cache and vector register information of
+/// the target.
+///
+/// The packing transformation is not applied, since it is only available for
+/// two-dimensional operands.
+///
+/// @param Node The band node to be optimized. The node is required to
+///             successfully pass isTCPattern.
+/// @param TTI  Target Transform Info.
+/// @param TCI  Parameters of the tensor contraction operands.
+/// @return The transformed schedule node or a null node if the optimization
+///         cannot be applied.
+static isl::schedule_node optimizeTCPattern(isl::schedule_node Node,
+                                            const TargetTransformInfo *TTI,
+                                            TCInfoTy &TCI) {
+  assert(TTI && "The target transform info should be provided.");
+
+  // The band node should describe all the loops of the statement, such that
+  // they can be reordered.
+  int DimOutNum = isl_schedule_node_band_n_member(Node.get());
+  if (Node.get_schedule_depth().release() != 0 ||
+      DimOutNum != static_cast<int>(TCI.DimensionSizes.size()))
+    return {};
+
+  MatMulInfoTy MMI;
+  MMI.A = TCI.A;
+  MMI.B = TCI.B;
+  MMI.ReadFromC = TCI.ReadFromC;
+  MMI.WriteToC = TCI.WriteToC;
+  MMI.i = getInnermostIndex(TCI.CDimensions, TCI.I);
+  MMI.j = getInnermostIndex(TCI.CDimensions, TCI.J);
+  MMI.k = *std::max_element(TCI.P.begin(), TCI.P.end());
+  if (MMI.i < 0 || MMI.j < 0)
+    return {};
+
+  // Move the loops of i, j, and k innermost and split them into a band node of
+  // their own.
+  SmallVector<int> Order;
+  for (int Dim = 0; Dim < DimOutNum; Dim++)
+    if (Dim != MMI.i && Dim != MMI.j && Dim != MMI.k)
+      Order.push_back(Dim);
+  Order.append({MMI.i, MMI.j, MMI.k});
+  Node = getBandNodeWithOriginDimOrder(Node);
+  Node = reorderBandNodeDimensions(Node, Order);
+  if (DimOutNum > 3) {
+    Node = isl::manage(isl_schedule_node_band_split(Node.release(),
+                                                    DimOutNum - 3));
+    Node = Node.child(0);
+  }
+
+  auto MicroKernelParams = getMicroKernelParams(TTI, MMI);
+  auto MacroKernelParams = getMacroKernelParams(TTI, MicroKernelParams, MMI);
+  Node = createMacroKernel(Node, MacroKernelParams);
+  Node = createMicroKernel(Node, MicroKernelParams);
+  if (MacroKernelParams.Mc == 1 || MacroKernelParams.Nc == 1 ||
+      MacroKernelParams.Kc == 1)
+    return Node;
+  Node = markLoopVectorizerDisabled(Node.parent()).child(0);
+  return isolateAndUnrollMatMulInnerLoops(Node, MicroKernelParams);
+}
+
 } // namespace
 
 isl::schedule_node
 polly::tryOptimizeMatMulPattern(isl::schedule_node Node,
                                 const llvm::TargetTransformInfo *TTI,
                                 const Dependences *D) {
-  TCInfoTy TCI;
-  if (PMBasedTCOpts && isTCPattern(Node, D, TCI))
-    POLLY_DEBUG(dbgs() << "The tensor contraction pattern was detected\n");
   MatMulInfoTy MMI;
   if (PMBasedMMMOpts && isMatrMultPattern(Node, D, MMI)) {
     POLLY_DEBUG(dbgs() << "The matrix multiplication pattern was detected\n");
     return optimizeMatMulPattern(Node, TTI, MMI);
   }
+  TCInfoTy TCI;
+  if (PMBasedTCOpts && isTCPattern(Node, D, TCI)) {
+    POLLY_DEBUG(dbgs() << "The tensor contraction pattern was detected\n");
+    return optimizeTCPattern(Node, TTI, TCI);
+  }
   return {};
 }
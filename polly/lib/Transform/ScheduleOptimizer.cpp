@@ -125,6 +125,13 @@ static cl::opt<bool> FirstLevelTiling("polly-tiling",
                                       cl::desc("Enable loop tiling"),
                                       cl::init(true), cl::cat(PollyCategory));
 
+static cl::opt<bool> Wavefront(
+    "polly-wavefront",
+    cl::desc("Skew the tile loops of bands without outer parallelism into a "
+             "wavefront, so that all tiles of a wavefront can run in parallel "
+             "(requires -polly-tiling)"),
+    cl::Hidden, cl::init(false), cl::cat(PollyCategory));
+
 static cl::opt<int> FirstLevelDefaultTileSize(
     "polly-default-tile-size",
     cl::desc("The default tile size (if not enough were provided by"
@@ -219,6 +226,7 @@ THREE_STATISTICS(NumFilters, "Number of filter nodes");
 THREE_STATISTICS(NumExtension, "Number of extension nodes");
 
 STATISTIC(FirstLevelTileOpts, "Number of first level tiling applied");
+STATISTIC(WavefrontOpts, "Number of wavefront skewings applied");
 STATISTIC(SecondLevelTileOpts, "Number of second level tiling applied");
 STATISTIC(RegisterTileOpts, "Number of register tiling applied");
 STATISTIC(PrevectOpts, "Number of strip-mining for prevectorization applied");
@@ -372,6 +380,31 @@ private:
   /// @param Node The schedule node to (possibly) optimize.
   static isl::schedule_node applyTileBandOpt(isl::schedule_node Node);
 
+  /// Skew the two outermost members of a band into a wavefront.
+  ///
+  /// A band whose outermost members are both sequential has no parallel loop
+  /// at its top, even though independent iterations exist on its
+  /// anti-diagonals. If the band is permutable, the dependence distances are
+  /// non-negative in all its members, so replacing the outermost member by the
+  /// sum of the two outermost ones carries every dependence that is not
+  /// carried by the inner members, and leaves the second member parallel:
+  ///
+  /// | for (t0 = 0; t0 < N; t0++)
+  /// |   for (t1 = 0; t1 < M; t1++)
+  /// |     S(t0, t1);
+  ///
+  /// | After transformation:
+  /// |
+  /// | for (w = 0; w < N + M - 1; w++)
+  /// |   for (t1 = max(0, w - N + 1); t1 <= min(w, M - 1); t1++) // parallel
+  /// |     S(w - t1, t1);
+  ///
+  /// Applied to the tile loops, this runs all the tiles of a wavefront in
+  /// parallel, while the point loops keep their locality.
+  ///
+  /// @param Node The band node to (possibly) skew.
+  static isl::schedule_node applyWavefront(isl::schedule_node Node);
+
   /// Apply prevectorization on the bands in the schedule tree.
   ///
   /// @param Node The schedule node to (possibly) prevectorize.
@@ -515,6 +548,11 @@ ScheduleTreeOptimizer::applyTileBandOpt(isl::schedule_node Node) {
     Node = tileNode(Node, "1st level tiling", FirstLevelTileSizes,
                     FirstLevelDefaultTileSize);
     FirstLevelTileOpts++;
+
+    // The tile band is the grandparent of the point band, below the "Tiles"
+    // mark and above the "Points" mark.
+    if (Wavefront)
+      Node = applyWavefront(Node.parent().parent()).child(0).child(0);
   }
 
   if (SecondLevelTiling) {
@@ -532,6 +570,38 @@ ScheduleTreeOptimizer::applyTileBandOpt(isl::schedule_node Node) {
   return Node;
 }
 
+isl::schedule_node
+ScheduleTreeOptimizer::applyWavefront(isl::schedule_node Node) {
+  auto Band = Node.as<isl::schedule_node_band>();
+  if (!Band.permutable() || unsignedFromIslSize(Band.n_member()) < 2)
+    return Node;
+
+  // Nothing to gain if one of the two outermost loops is parallel already.
+  if (Band.member_get_coincident(0) || Band.member_get_coincident(1))
+    return Node;
+
+  isl::multi_union_pw_aff PartialSchedule = Band.get_partial_schedule();
+  isl::union_pw_aff Outer = PartialSchedule.at(0).add(PartialSchedule.at(1));
+  PartialSchedule = PartialSchedule.set_at(0, Outer);
+
+  // Deleting the band drops its member properties; carry over those of the
+  // inner members, which the skewing does not affect.
+  unsigned Dims = unsignedFromIslSize(Band.n_member());
+  SmallVector<bool, 4> Coincident;
+  for (unsigned i = 0; i < Dims; i++)
+    Coincident.push_back(Band.member_get_coincident(i).release());
+  Coincident[1] = true;
+
+  Node = isl::manage(isl_schedule_node_delete(Node.release()));
+  Band = Node.insert_partial_schedule(PartialSchedule)
+             .as<isl::schedule_node_band>();
+  Band = Band.set_permutable(true);
+  for (unsigned i = 0; i < Dims; i++)
+    Band = Band.member_set_coincident(i, Coincident[i]);
+  WavefrontOpts++;
+  return Band;
+}
+
 isl::schedule_node
 ScheduleTreeOptimizer::applyPrevectBandOpt(isl::schedule_node Node) {
   auto Space = isl::manage(isl_schedule_node_band_get_space(Node.get()));